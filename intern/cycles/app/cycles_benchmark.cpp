@@ -0,0 +1,406 @@
+/*
+ * Copyright 2011-2017 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Benchmark
+ *
+ * Renders a list of XML scenes with fixed seeds and sample counts, and writes
+ * timings of the scene update, BVH build, kernel loading and every sample
+ * together with memory peaks as JSON, to compare performance across builds.
+ *
+ * Timings of the scene update are attributed from the progress status, so
+ * they are only as fine grained as the status messages of the managers. */
+
+#include <stdio.h>
+
+#include "render/camera.h"
+#include "device/device.h"
+#include "render/integrator.h"
+#include "render/scene.h"
+#include "render/session.h"
+
+#include "util/util_args.h"
+#include "util/util_foreach.h"
+#include "util/util_function.h"
+#include "util/util_guarded_allocator.h"
+#include "util/util_logging.h"
+#include "util/util_path.h"
+#include "util/util_progress.h"
+#include "util/util_string.h"
+#include "util/util_time.h"
+#include "util/util_version.h"
+
+#include "app/cycles_xml.h"
+
+CCL_NAMESPACE_BEGIN
+
+struct Options {
+	vector<string> filepaths;
+	string output_path;
+	int width, height;
+	int seed;
+	int repeat;
+	bool quiet;
+	SceneParams scene_params;
+	SessionParams session_params;
+} options;
+
+/* Timings of a single render. */
+struct BenchmarkRun {
+	string filepath;
+	int width, height;
+
+	double load_time;
+	double kernel_time;
+	double sync_time;
+	double bvh_time;
+	double render_time;
+	vector<double> sample_times;
+
+	size_t device_mem_peak;
+	size_t host_mem_peak;
+};
+
+/* Progress state, updated from the progress callback. */
+static struct {
+	Progress *progress;
+	int samples;
+
+	string status;
+	double status_time;
+
+	int sample;
+	double sample_time;
+
+	BenchmarkRun *run;
+} state;
+
+static bool status_is_update(const string& status)
+{
+	return status.find("BVH") != string::npos ||
+	       string_startswith(status, "Loading") ||
+	       string_startswith(status, "Updating");
+}
+
+static void benchmark_progress_update()
+{
+	string status, substatus;
+	state.progress->get_status(status, substatus);
+
+	const double time = time_dt();
+	const double elapsed = time - state.status_time;
+
+	/* Attribute the time since the last update to the previous status. */
+	if(state.status.find("BVH") != string::npos)
+		state.run->bvh_time += elapsed;
+	else if(string_startswith(state.status, "Loading"))
+		state.run->kernel_time += elapsed;
+	else if(string_startswith(state.status, "Updating"))
+		state.run->sync_time += elapsed;
+
+	/* Samples start counting once the scene is updated. */
+	if(state.status.empty() || status_is_update(state.status))
+		state.sample_time = time;
+
+	state.status = (substatus.find("BVH") != string::npos)? substatus: status;
+	state.status_time = time;
+
+	/* Progressive rendering finishes a full image sample at a time. */
+	int sample = (int)(state.progress->get_progress() * state.samples + 0.5f);
+	while(state.sample < sample && state.sample < state.samples) {
+		state.run->sample_times.push_back(time - state.sample_time);
+		state.sample_time = time;
+		state.sample++;
+	}
+
+	if(!options.quiet) {
+		printf("\r%-80s", string_printf("%s %s", status.c_str(), substatus.c_str()).substr(0, 80).c_str());
+		fflush(stdout);
+	}
+}
+
+static bool benchmark_run(const string& filepath, BenchmarkRun& run)
+{
+	run.filepath = filepath;
+	run.load_time = 0.0;
+	run.kernel_time = 0.0;
+	run.sync_time = 0.0;
+	run.bvh_time = 0.0;
+	run.render_time = 0.0;
+	run.sample_times.clear();
+
+	/* Load scene. */
+	double load_start = time_dt();
+
+	Scene *scene = new Scene(options.scene_params, options.session_params.device);
+	xml_read_file(scene, filepath.c_str());
+
+	if(!(options.width == 0 || options.height == 0)) {
+		scene->camera->width = options.width;
+		scene->camera->height = options.height;
+	}
+	scene->camera->compute_auto_viewplane();
+
+	/* Fixed seed for reproducible noise and adaptive behavior. */
+	scene->integrator->seed = options.seed;
+	scene->integrator->tag_update(scene);
+
+	run.width = scene->camera->width;
+	run.height = scene->camera->height;
+	run.load_time = time_dt() - load_start;
+
+	/* Render. */
+	Session *session = new Session(options.session_params);
+
+	BufferParams buffer_params;
+	buffer_params.width = run.width;
+	buffer_params.height = run.height;
+	buffer_params.full_width = run.width;
+	buffer_params.full_height = run.height;
+
+	state.progress = &session->progress;
+	state.samples = options.session_params.samples;
+	state.status = "";
+	state.status_time = time_dt();
+	state.sample = 0;
+	state.sample_time = state.status_time;
+	state.run = &run;
+
+	session->progress.set_update_callback(function_bind(&benchmark_progress_update));
+	session->reset(buffer_params, options.session_params.samples);
+	session->scene = scene;
+
+	session->start();
+	session->wait();
+
+	double total_time;
+	session->progress.get_time(total_time, run.render_time);
+
+	bool success = !session->progress.get_error();
+	if(!success) {
+		fprintf(stderr, "\n%s: %s\n",
+		        filepath.c_str(),
+		        session->progress.get_error_message().c_str());
+	}
+
+	run.device_mem_peak = session->stats.mem_peak;
+	run.host_mem_peak = util_guarded_get_mem_peak();
+
+	/* Deleting the session deletes the scene with it. */
+	delete session;
+
+	if(!options.quiet)
+		printf("\n");
+
+	return success;
+}
+
+static string json_string(const string& str)
+{
+	string result = "\"";
+	foreach(char c, str) {
+		if(c == '"' || c == '\\')
+			result += '\\';
+		result += c;
+	}
+	return result + "\"";
+}
+
+static string json_run(const BenchmarkRun& run)
+{
+	string samples;
+	foreach(double t, run.sample_times)
+		samples += string_printf("%s%.6f", samples.empty()? "": ", ", t);
+
+	double time_per_sample = run.sample_times.empty()? 0.0:
+	                         run.render_time / run.sample_times.size();
+
+	return string_printf(
+	        "    {\n"
+	        "      \"file\": %s,\n"
+	        "      \"width\": %d,\n"
+	        "      \"height\": %d,\n"
+	        "      \"load_time\": %.6f,\n"
+	        "      \"kernel_load_time\": %.6f,\n"
+	        "      \"sync_time\": %.6f,\n"
+	        "      \"bvh_time\": %.6f,\n"
+	        "      \"render_time\": %.6f,\n"
+	        "      \"time_per_sample\": %.6f,\n"
+	        "      \"sample_times\": [%s],\n"
+	        "      \"device_memory_peak\": %llu,\n"
+	        "      \"host_memory_peak\": %llu\n"
+	        "    }",
+	        json_string(run.filepath).c_str(),
+	        run.width, run.height,
+	        run.load_time,
+	        run.kernel_time,
+	        run.sync_time,
+	        run.bvh_time,
+	        run.render_time,
+	        time_per_sample,
+	        samples.c_str(),
+	        (unsigned long long)run.device_mem_peak,
+	        (unsigned long long)run.host_mem_peak);
+}
+
+static bool benchmark_write(const vector<BenchmarkRun>& runs)
+{
+	string runs_json;
+	foreach(const BenchmarkRun& run, runs)
+		runs_json += (runs_json.empty()? "": ",\n") + json_run(run);
+
+	string json = string_printf(
+	        "{\n"
+	        "  \"version\": %s,\n"
+	        "  \"device\": %s,\n"
+	        "  \"threads\": %d,\n"
+	        "  \"samples\": %d,\n"
+	        "  \"seed\": %d,\n"
+	        "  \"runs\": [\n%s\n  ]\n"
+	        "}\n",
+	        json_string(CYCLES_VERSION_STRING).c_str(),
+	        json_string(options.session_params.device.description).c_str(),
+	        options.session_params.threads,
+	        options.session_params.samples,
+	        options.seed,
+	        runs_json.c_str());
+
+	if(options.output_path.empty()) {
+		printf("%s", json.c_str());
+		return true;
+	}
+
+	return path_write_text(options.output_path, json);
+}
+
+static int files_parse(int argc, const char *argv[])
+{
+	for(int i = 0; i < argc; i++)
+		options.filepaths.push_back(argv[i]);
+
+	return 0;
+}
+
+static void options_parse(int argc, const char **argv)
+{
+	options.width = 0;
+	options.height = 0;
+	options.seed = 0;
+	options.repeat = 1;
+	options.quiet = false;
+	options.session_params.samples = 16;
+
+	string devicename = "CPU";
+	string device_names = "";
+	foreach(DeviceType type, Device::available_types()) {
+		if(device_names != "")
+			device_names += ", ";
+
+		device_names += Device::string_from_type(type);
+	}
+
+	ArgParse ap;
+	bool help = false, version = false;
+
+	ap.options ("Usage: cycles_benchmark [options] file.xml ...",
+		"%*", files_parse, "",
+		"--device %s", &devicename, ("Devices to use: " + device_names).c_str(),
+		"--samples %d", &options.session_params.samples, "Number of samples to render each scene with",
+		"--seed %d", &options.seed, "Seed of the sampling pattern",
+		"--repeat %d", &options.repeat, "Number of times to render each scene",
+		"--threads %d", &options.session_params.threads, "CPU Rendering Threads",
+		"--width  %d", &options.width, "Override the image width in pixels",
+		"--height %d", &options.height, "Override the image height in pixels",
+		"--output %s", &options.output_path, "File path to write the JSON results to, instead of standard output",
+		"--quiet", &options.quiet, "Don't print progress messages",
+		"--help", &help, "Print help message",
+		"--version", &version, "Print version number",
+		NULL);
+
+	if(ap.parse(argc, argv) < 0) {
+		fprintf(stderr, "%s\n", ap.geterror().c_str());
+		ap.usage();
+		exit(EXIT_FAILURE);
+	}
+
+	if(version) {
+		printf("%s\n", CYCLES_VERSION_STRING);
+		exit(EXIT_SUCCESS);
+	}
+	else if(help || options.filepaths.empty()) {
+		ap.usage();
+		exit(EXIT_SUCCESS);
+	}
+
+	if(options.session_params.samples <= 0 || options.session_params.samples == INT_MAX) {
+		fprintf(stderr, "Invalid number of samples: %d\n", options.session_params.samples);
+		exit(EXIT_FAILURE);
+	}
+
+	/* Keep standard output clean when the results are written to it. */
+	if(options.output_path.empty())
+		options.quiet = true;
+
+	/* Find matching device. */
+	DeviceType device_type = Device::type_from_string(devicename.c_str());
+	bool device_available = false;
+
+	foreach(DeviceInfo& device, Device::available_devices()) {
+		if(device_type == device.type) {
+			options.session_params.device = device;
+			device_available = true;
+			break;
+		}
+	}
+
+	if(!device_available) {
+		fprintf(stderr, "Unknown device: %s\n", devicename.c_str());
+		exit(EXIT_FAILURE);
+	}
+
+	/* Render a full image sample at a time, so every sample can be timed. */
+	options.session_params.background = true;
+	options.session_params.progressive = true;
+	options.session_params.start_resolution = INT_MAX;
+}
+
+CCL_NAMESPACE_END
+
+using namespace ccl;
+
+int main(int argc, const char **argv)
+{
+	util_logging_init(argv[0]);
+	path_init();
+	options_parse(argc, argv);
+
+	vector<BenchmarkRun> runs;
+	bool success = true;
+
+	foreach(const string& filepath, options.filepaths) {
+		for(int i = 0; i < options.repeat; i++) {
+			BenchmarkRun run;
+			success &= benchmark_run(filepath, run);
+			runs.push_back(run);
+		}
+	}
+
+	if(!benchmark_write(runs)) {
+		fprintf(stderr, "Failed to write %s\n", options.output_path.c_str());
+		success = false;
+	}
+
+	return (success)? EXIT_SUCCESS: EXIT_FAILURE;
+}
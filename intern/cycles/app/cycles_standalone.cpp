@@ -18,6 +18,7 @@
 
 #include "render/buffers.h"
 #include "render/camera.h"
+#include "render/denoising.h"
 #include "device/device.h"
 #include "render/scene.h"
 #include "render/session.h"
@@ -46,11 +47,15 @@ struct Options {
 	Session *session;
 	Scene *scene;
 	string filepath;
+	vector<string> filepaths;
 	int width, height;
 	SceneParams scene_params;
 	SessionParams session_params;
 	bool quiet;
 	bool show_help, interactive, pause;
+	bool denoise;
+	int denoise_radius;
+	float denoise_strength;
 } options;
 
 static void session_print(const string& str)
@@ -86,6 +91,17 @@ static void session_print_status()
 	session_print(status);
 }
 
+static void denoise_print_status(Progress *progress)
+{
+	string status, substatus;
+	progress->get_status(status, substatus);
+
+	if(substatus != "")
+		status += ": " + substatus;
+
+	session_print(status);
+}
+
 static BufferParams& session_buffer_params()
 {
 	static BufferParams buffer_params;
@@ -317,12 +333,57 @@ static void keyboard(unsigned char key)
 
 static int files_parse(int argc, const char *argv[])
 {
-	if(argc > 0)
-		options.filepath = argv[0];
+	for(int i = 0; i < argc; i++) {
+		if(options.filepath == "")
+			options.filepath = argv[i];
+		options.filepaths.push_back(argv[i]);
+	}
 
 	return 0;
 }
 
+static void denoise_run()
+{
+	Denoiser denoiser(options.session_params.device);
+
+	denoiser.samples = options.session_params.samples;
+	if(options.denoise_radius > 0)
+		denoiser.radius = options.denoise_radius;
+	if(options.denoise_strength >= 0.0f)
+		denoiser.strength = options.denoise_strength;
+	denoiser.tile_size = options.session_params.tile_size;
+
+	/* Output next to the input, unless a single output file is given. */
+	foreach(const string& filepath, options.filepaths) {
+		string output;
+
+		if(options.filepaths.size() == 1 && options.session_params.output_path != "") {
+			output = options.session_params.output_path;
+		}
+		else {
+			string filename = path_filename(filepath);
+			size_t ext = filename.rfind('.');
+			if(ext != string::npos)
+				filename = filename.substr(0, ext);
+			output = path_join(path_dirname(filepath), filename + "_denoised.exr");
+		}
+
+		denoiser.input.push_back(filepath);
+		denoiser.output.push_back(output);
+	}
+
+	if(!options.quiet)
+		denoiser.progress.set_update_callback(function_bind(&denoise_print_status, &denoiser.progress));
+
+	if(!denoiser.run()) {
+		fprintf(stderr, "\n%s\n", denoiser.error.c_str());
+		exit(EXIT_FAILURE);
+	}
+
+	if(!options.quiet)
+		printf("\n");
+}
+
 static void options_parse(int argc, const char **argv)
 {
 	options.width = 0;
@@ -330,6 +391,9 @@ static void options_parse(int argc, const char **argv)
 	options.filepath = "";
 	options.session = NULL;
 	options.quiet = false;
+	options.denoise = false;
+	options.denoise_radius = 0;
+	options.denoise_strength = -1.0f;
 
 	/* device names */
 	string device_names = "";
@@ -373,6 +437,9 @@ static void options_parse(int argc, const char **argv)
 		"--height %d", &options.height, "Window height in pixel",
 		"--tile-width %d", &options.session_params.tile_size.x, "Tile width in pixels",
 		"--tile-height %d", &options.session_params.tile_size.y, "Tile height in pixels",
+		"--denoise", &options.denoise, "Denoise multilayer EXR files with denoising data passes, instead of rendering",
+		"--denoise-radius %d", &options.denoise_radius, "Radius of the denoising filter in pixels",
+		"--denoise-strength %f", &options.denoise_strength, "Strength of the denoising filter",
 		"--list-devices", &list, "List information about all available devices",
 #ifdef WITH_CYCLES_LOGGING
 		"--debug", &debug, "Enable debug logging",
@@ -465,6 +532,17 @@ static void options_parse(int argc, const char **argv)
 		exit(EXIT_FAILURE);
 	}
 
+	/* denoise existing images instead of rendering */
+	if(options.denoise) {
+		if(options.session_params.samples == INT_MAX) {
+			fprintf(stderr, "Number of samples the images were rendered with must be given to denoise\n");
+			exit(EXIT_FAILURE);
+		}
+
+		denoise_run();
+		exit(EXIT_SUCCESS);
+	}
+
 	/* For smoother Viewport */
 	options.session_params.start_resolution = 64;
 
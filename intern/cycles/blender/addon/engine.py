@@ -209,6 +209,15 @@ def system_info():
     import _cycles
     return _cycles.system_info()
 
+
+def kernel_stats(engine):
+    """Work counters of the last render, only available in debug builds"""
+    import _cycles
+    session = getattr(engine, "session", None)
+    if session is None or not _cycles.with_cycles_debug:
+        return {}
+    return _cycles.kernel_stats(session)
+
 def register_passes(engine, scene, srl):
     engine.register_pass(scene, srl, "Combined", 4, "RGBA", 'COLOR')
 
@@ -241,6 +250,7 @@ def register_passes(engine, scene, srl):
     if crl.pass_debug_bvh_traversed_instances: engine.register_pass(scene, srl, "Debug BVH Traversed Instances", 1, "X", 'VALUE')
     if crl.pass_debug_bvh_intersections:       engine.register_pass(scene, srl, "Debug BVH Intersections",       1, "X", 'VALUE')
     if crl.pass_debug_ray_bounces:             engine.register_pass(scene, srl, "Debug Ray Bounces",             1, "X", 'VALUE')
+    if crl.pass_debug_shader_nodes:            engine.register_pass(scene, srl, "Debug Shader Nodes",            1, "X", 'VALUE')
 
     cscene = scene.cycles
     if crl.use_denoising and crl.denoising_store_passes and not cscene.use_progressive_refine:
@@ -190,6 +190,25 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
                 min=0, max=2147483647,
                 default=32,
                 )
+        cls.use_adaptive_sampling = BoolProperty(
+                name="Adaptive Sampling",
+                description="Stop sampling pixels and tiles once their noise is below the threshold, "
+                            "in final renders on the CPU (not used together with denoising)",
+                default=False,
+                )
+        cls.adaptive_threshold = FloatProperty(
+                name="Adaptive Threshold",
+                description="Noise level at which a pixel stops being sampled, lower values give less noise",
+                min=0.0001, max=1.0,
+                default=0.01,
+                precision=4,
+                )
+        cls.adaptive_min_samples = IntProperty(
+                name="Adaptive Min Samples",
+                description="Number of samples every pixel receives before its noise is tested",
+                min=2, max=4096,
+                default=16,
+                )
         cls.preview_pause = BoolProperty(
                 name="Pause Preview",
                 description="Pause all viewport preview renders",
@@ -284,6 +303,12 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
                 min=0.0, max=1.0,
                 default=0.01,
                 )
+        cls.use_light_tree = BoolProperty(
+                name="Light Tree",
+                description="Pick lights based on their distance and orientation to the shading point, "
+                            "reducing noise in scenes with many lamps or emissive meshes",
+                default=False,
+                )
 
         cls.caustics_reflective = BoolProperty(
                 name="Reflective Caustics",
@@ -386,6 +411,13 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
                 min=0, max=16,
                 default=12,
                 )
+        cls.max_subdivision_triangles = IntProperty(
+                name="Max Triangles",
+                description="Maximum number of triangles per mesh for adaptive subdivision, the dicing rate is "
+                            "increased for meshes that would produce more (0 for unlimited)",
+                min=0,
+                default=0,
+                )
 
         cls.film_exposure = FloatProperty(
                 name="Exposure",
@@ -470,6 +502,15 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
                 default=64,
                 )
 
+        cls.preview_reprojection_samples = IntProperty(
+                name="Reprojection Samples",
+                description="Number of samples after a viewport camera change that reuse "
+                            "the previous image reprojected into the new view, "
+                            "0 to disable (CPU only)",
+                min=0, max=1024,
+                default=0,
+                )
+
         cls.debug_reset_timeout = FloatProperty(
                 name="Reset timeout",
                 description="",
@@ -505,6 +546,23 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
                 description="Use special type BVH optimized for hair (uses more ram but renders faster)",
                 default=True,
                 )
+        cls.debug_use_bvh_quantized_nodes = BoolProperty(
+                name="Use Compressed BVH",
+                description="Store BVH nodes with quantized bounds (uses less ram but renders slower)",
+                default=False,
+                )
+        cls.use_bvh_cache = BoolProperty(
+                name="Cache BVH",
+                description="Store BVH of final renders on disk and reuse it for unchanged geometry "
+                            "in the following renders (uses disk space but speeds up repeated renders)",
+                default=False,
+                )
+        cls.use_half_float_textures = BoolProperty(
+                name="Half Float Textures",
+                description="Store float image textures with half precision (uses less ram, "
+                            "values outside of the half float range are clamped)",
+                default=False,
+                )
         cls.debug_bvh_time_steps = IntProperty(
                 name="BVH Time Steps",
                 description="Split BVH primitives by this number of time steps to speed up render time in cost of memory",
@@ -642,6 +700,7 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         cls.debug_use_cpu_sse3 = BoolProperty(name="SSE3", default=True)
         cls.debug_use_cpu_sse2 = BoolProperty(name="SSE2", default=True)
         cls.debug_use_qbvh = BoolProperty(name="QBVH", default=True)
+        cls.debug_use_bvh8 = BoolProperty(name="BVH8", default=False)
         cls.debug_use_cpu_split_kernel = BoolProperty(name="Split Kernel", default=False)
 
         cls.debug_use_cuda_adaptive_compile = BoolProperty(name="Adaptive Compile", default=False)
@@ -1188,6 +1247,12 @@ class CyclesRenderLayerSettings(bpy.types.PropertyGroup):
                 default=False,
                 update=update_render_passes,
                 )
+        cls.pass_debug_shader_nodes = BoolProperty(
+                name="Debug Shader Nodes",
+                description="Store Debug Shader Nodes pass, with the number of SVM nodes executed per sample",
+                default=False,
+                update=update_render_passes,
+                )
 
         cls.use_denoising = BoolProperty(
                 name="Use Denoising",
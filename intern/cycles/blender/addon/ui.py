@@ -173,6 +173,7 @@ class CyclesRender_PT_sampling(CyclesButtonsPanel, Panel):
         sub.prop(cscene, "sample_clamp_direct")
         sub.prop(cscene, "sample_clamp_indirect")
         sub.prop(cscene, "light_sampling_threshold")
+        sub.prop(cscene, "use_light_tree")
 
         if cscene.progressive == 'PATH' or use_branched_path(context) is False:
             col = split.column()
@@ -206,6 +207,13 @@ class CyclesRender_PT_sampling(CyclesButtonsPanel, Panel):
 
         layout.row().prop(cscene, "sampling_pattern", text="Pattern")
 
+        row = layout.row(align=True)
+        row.prop(cscene, "use_adaptive_sampling", text="Adaptive")
+        sub = row.row(align=True)
+        sub.active = cscene.use_adaptive_sampling
+        sub.prop(cscene, "adaptive_threshold", text="Threshold")
+        sub.prop(cscene, "adaptive_min_samples", text="Min Samples")
+
         for rl in scene.render.layers:
             if rl.samples > 0:
                 layout.separator()
@@ -244,6 +252,7 @@ class CyclesRender_PT_geometry(CyclesButtonsPanel, Panel):
             sub.prop(cscene, "preview_dicing_rate", text="Preview")
             sub.separator()
             sub.prop(cscene, "max_subdivisions")
+            sub.prop(cscene, "max_subdivision_triangles")
         else:
             row = layout.row()
             row.label("Volume Sampling:")
@@ -416,17 +425,25 @@ class CyclesRender_PT_performance(CyclesButtonsPanel, Panel):
         col.prop(cscene, "debug_bvh_type", text="")
         col.separator()
         col.prop(cscene, "preview_start_resolution")
+        col.prop(cscene, "preview_reprojection_samples")
 
         col.separator()
 
         col.label(text="Final Render:")
-        col.prop(rd, "use_persistent_data", text="Persistent Images")
+        col.prop(rd, "use_persistent_data", text="Persistent Data")
+
+        col.separator()
+
+        col.label(text="Textures:")
+        col.prop(cscene, "use_half_float_textures")
 
         col.separator()
 
         col.label(text="Acceleration structure:")
         col.prop(cscene, "debug_use_spatial_splits")
         col.prop(cscene, "debug_use_hair_bvh")
+        col.prop(cscene, "debug_use_bvh_quantized_nodes")
+        col.prop(cscene, "use_bvh_cache")
 
         row = col.row()
         row.active = not cscene.debug_use_spatial_splits
@@ -541,6 +558,7 @@ class CyclesRender_PT_layer_passes(CyclesButtonsPanel, Panel):
             col.prop(crl, "pass_debug_bvh_traversed_instances")
             col.prop(crl, "pass_debug_bvh_intersections")
             col.prop(crl, "pass_debug_ray_bounces")
+            col.prop(crl, "pass_debug_shader_nodes")
 
 
 class CyclesRender_PT_views(CyclesButtonsPanel, Panel):
@@ -1573,6 +1591,7 @@ class CyclesRender_PT_debug(CyclesButtonsPanel, Panel):
         row.prop(cscene, "debug_use_cpu_avx", toggle=True)
         row.prop(cscene, "debug_use_cpu_avx2", toggle=True)
         col.prop(cscene, "debug_use_qbvh")
+        col.prop(cscene, "debug_use_bvh8")
         col.prop(cscene, "debug_use_cpu_split_kernel")
 
         col = layout.column()
@@ -564,12 +564,7 @@ static void ExportCurveSegments(Scene *scene, Mesh *mesh, ParticleCurveData *CDa
 	if(mesh->num_curves())
 		return;
 
-	Attribute *attr_intercept = NULL;
-
-	if(mesh->need_attribute(scene, ATTR_STD_CURVE_INTERCEPT))
-		attr_intercept = mesh->curve_attributes.add(ATTR_STD_CURVE_INTERCEPT);
-
-	/* compute and reserve size of arrays */
+	/* compute size of arrays */
 	for(int sys = 0; sys < CData->psys_firstcurve.size(); sys++) {
 		for(int curve = CData->psys_firstcurve[sys]; curve < CData->psys_firstcurve[sys] + CData->psys_curvenum[sys]; curve++) {
 			if(CData->curve_keynum[curve] <= 1 || CData->curve_length[curve] == 0.0f)
@@ -580,11 +575,26 @@ static void ExportCurveSegments(Scene *scene, Mesh *mesh, ParticleCurveData *CDa
 		}
 	}
 
-	if(num_curves > 0) {
-		VLOG(1) << "Exporting curve segments for mesh " << mesh->name;
-	}
+	if(num_curves == 0)
+		return;
+
+	VLOG(1) << "Exporting " << num_curves << " curve segments with "
+	        << num_keys << " keys for mesh " << mesh->name;
 
-	mesh->reserve_curves(mesh->num_curves() + num_curves, mesh->curve_keys.size() + num_keys);
+	/* Allocate all arrays at once and fill them in place, pushing keys one by
+	 * one is slow for grooms with millions of child strands and reallocating
+	 * the attribute buffers doubles peak memory. */
+	mesh->resize_curves(num_curves, num_keys);
+
+	float3 *curve_keys = mesh->curve_keys.data();
+	float *curve_radius = mesh->curve_radius.data();
+	int *curve_first_key = mesh->curve_first_key.data();
+	int *curve_shader = mesh->curve_shader.data();
+
+	float *intercept = NULL;
+
+	if(mesh->need_attribute(scene, ATTR_STD_CURVE_INTERCEPT))
+		intercept = mesh->curve_attributes.add(ATTR_STD_CURVE_INTERCEPT)->data_float();
 
 	num_keys = 0;
 	num_curves = 0;
@@ -595,34 +605,27 @@ static void ExportCurveSegments(Scene *scene, Mesh *mesh, ParticleCurveData *CDa
 			if(CData->curve_keynum[curve] <= 1 || CData->curve_length[curve] == 0.0f)
 				continue;
 
-			size_t num_curve_keys = 0;
+			curve_first_key[num_curves] = num_keys;
+			curve_shader[num_curves] = CData->psys_shader[sys];
 
 			for(int curvekey = CData->curve_firstkey[curve]; curvekey < CData->curve_firstkey[curve] + CData->curve_keynum[curve]; curvekey++) {
-				float3 ickey_loc = CData->curvekey_co[curvekey];
 				float time = CData->curvekey_time[curvekey]/CData->curve_length[curve];
 				float radius = shaperadius(CData->psys_shape[sys], CData->psys_rootradius[sys], CData->psys_tipradius[sys], time);
 
 				if(CData->psys_closetip[sys] && (curvekey == CData->curve_firstkey[curve] + CData->curve_keynum[curve] - 1))
 					radius = 0.0f;
 
-				mesh->add_curve_key(ickey_loc, radius);
-				if(attr_intercept)
-					attr_intercept->add(time);
+				curve_keys[num_keys] = CData->curvekey_co[curvekey];
+				curve_radius[num_keys] = radius;
+				if(intercept)
+					intercept[num_keys] = time;
 
-				num_curve_keys++;
+				num_keys++;
 			}
 
-			mesh->add_curve(num_keys, CData->psys_shader[sys]);
-			num_keys += num_curve_keys;
 			num_curves++;
 		}
 	}
-
-	/* check allocation */
-	if((mesh->curve_keys.size() != num_keys) || (mesh->num_curves() != num_curves)) {
-		VLOG(1) << "Allocation failed, clearing data";
-		mesh->clear();
-	}
 }
 
 static void ExportCurveSegmentsMotion(Mesh *mesh, ParticleCurveData *CData, int time_index)
@@ -946,6 +949,11 @@ void BlenderSync::sync_curves(Mesh *mesh,
 			ExportCurveSegmentsMotion(mesh, &CData, time_index);
 		else
 			ExportCurveSegments(scene, mesh, &CData);
+
+		/* keys are copied into the mesh now, free them early to reduce the
+		 * peak memory usage while attributes are exported */
+		CData.curvekey_co.clear();
+		CData.curvekey_time.clear();
 	}
 
 	/* generated coordinates from first key. we should ideally get this from
@@ -30,6 +30,7 @@
 #include "util/util_foreach.h"
 #include "util/util_logging.h"
 #include "util/util_math.h"
+#include "util/util_task.h"
 
 #include "mikktspace.h"
 
@@ -326,6 +327,207 @@ static void create_mesh_volume_attributes(Scene *scene,
 		create_mesh_volume_attribute(b_ob, mesh, scene->image_manager, ATTR_STD_VOLUME_VELOCITY, frame);
 }
 
+/* Create Volume Bounds
+ *
+ * Replace the box of smoke domains by a closed mesh enclosing only the blocks
+ * of voxels that contain smoke, so ray marching skips empty space since rays
+ * only enter the volume where it can have density. */
+
+#define VOLUME_BOUNDS_BLOCK_SIZE 8
+
+static void create_mesh_volume_bounds(Scene *scene,
+                                      BL::Object& b_ob,
+                                      BL::Mesh& b_mesh,
+                                      Mesh *mesh)
+{
+	BL::SmokeDomainSettings b_domain = object_smoke_domain_find(b_ob);
+
+	if(!b_domain || mesh->num_triangles() == 0)
+		return;
+
+	/* Only volume shaders may be affected by changing the geometry, and only
+	 * if emptiness is defined by the density and flame grids. Heat and
+	 * velocity can be non-zero outside of the smoke. */
+	foreach(Shader *shader, mesh->used_shaders) {
+		if(shader->has_surface || !shader->has_volume)
+			return;
+	}
+
+	if(!mesh->need_attribute(scene, ATTR_STD_VOLUME_DENSITY) ||
+	   mesh->need_attribute(scene, ATTR_STD_VOLUME_HEAT) ||
+	   mesh->need_attribute(scene, ATTR_STD_VOLUME_VELOCITY))
+	{
+		return;
+	}
+
+	float3 loc, size;
+	mesh_texture_space(b_mesh, loc, size);
+
+	if(size.x == 0.0f || size.y == 0.0f || size.z == 0.0f)
+		return;
+
+	int3 resolution = get_int3(b_domain.domain_resolution());
+	int amplify = (b_domain.use_high_resolution())? b_domain.amplify() + 1: 1;
+	const int width = resolution.x * amplify;
+	const int height = resolution.y * amplify;
+	const int depth = resolution.z * amplify;
+	const size_t num_voxels = ((size_t)width) * height * depth;
+
+	if(num_voxels == 0)
+		return;
+
+	/* Fetch grids. */
+	int length;
+	vector<float> density(num_voxels);
+	SmokeDomainSettings_density_grid_get_length(&b_domain.ptr, &length);
+	if(length != num_voxels)
+		return;
+	SmokeDomainSettings_density_grid_get(&b_domain.ptr, &density[0]);
+
+	vector<float> flame;
+	if(mesh->need_attribute(scene, ATTR_STD_VOLUME_FLAME)) {
+		flame.resize(num_voxels);
+		SmokeDomainSettings_flame_grid_get_length(&b_domain.ptr, &length);
+		if(length != num_voxels)
+			return;
+		SmokeDomainSettings_flame_grid_get(&b_domain.ptr, &flame[0]);
+	}
+
+	/* Mark occupied blocks. Voxels are dilated by one so the linear
+	 * interpolation around them stays inside the bounds. */
+	const int block = VOLUME_BOUNDS_BLOCK_SIZE;
+	const int3 num_blocks = make_int3(divide_up(width, block),
+	                                  divide_up(height, block),
+	                                  divide_up(depth, block));
+	const size_t total_blocks = ((size_t)num_blocks.x) * num_blocks.y * num_blocks.z;
+	vector<bool> occupied(total_blocks, false);
+	size_t num_occupied = 0;
+
+	for(int z = 0; z < depth; z++) {
+		for(int y = 0; y < height; y++) {
+			for(int x = 0; x < width; x++) {
+				const size_t index = x + width*((size_t)y + height*(size_t)z);
+
+				if(density[index] <= 0.0f && (flame.empty() || flame[index] <= 0.0f))
+					continue;
+
+				for(int bz = max(z-1, 0)/block; bz <= min(z+1, depth-1)/block; bz++) {
+					for(int by = max(y-1, 0)/block; by <= min(y+1, height-1)/block; by++) {
+						for(int bx = max(x-1, 0)/block; bx <= min(x+1, width-1)/block; bx++) {
+							const size_t b = bx + num_blocks.x*((size_t)by + num_blocks.y*(size_t)bz);
+							if(!occupied[b]) {
+								occupied[b] = true;
+								num_occupied++;
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	/* Not worth it if the smoke fills most of the domain. */
+	if(num_occupied > total_blocks*3/4)
+		return;
+
+	VLOG(1) << "Volume bounds for " << b_ob.name() << " use "
+	        << num_occupied << " of " << total_blocks << " blocks";
+
+	/* Find faces between occupied and empty blocks, oriented outwards. Block
+	 * corners are shared so the mesh is closed. */
+	const int3 num_corners = make_int3(num_blocks.x + 1, num_blocks.y + 1, num_blocks.z + 1);
+	vector<int> corner_vert(((size_t)num_corners.x) * num_corners.y * num_corners.z, -1);
+	const float3 voxel_size = make_float3(1.0f/width, 1.0f/height, 1.0f/depth);
+	vector<float3> verts;
+	vector<int> quads;
+
+	for(int bz = 0; bz < num_blocks.z; bz++) {
+		for(int by = 0; by < num_blocks.y; by++) {
+			for(int bx = 0; bx < num_blocks.x; bx++) {
+				const int3 b = make_int3(bx, by, bz);
+
+				if(!occupied[bx + num_blocks.x*((size_t)by + num_blocks.y*(size_t)bz)])
+					continue;
+
+				for(int axis = 0; axis < 3; axis++) {
+					for(int side = -1; side <= 1; side += 2) {
+						int3 n = b;
+						n[axis] += side;
+
+						if(n[axis] >= 0 && n[axis] < num_blocks[axis] &&
+						   occupied[n.x + num_blocks.x*((size_t)n.y + num_blocks.y*(size_t)n.z)])
+						{
+							continue;
+						}
+
+						const int u = (axis + 1) % 3;
+						const int v = (axis + 2) % 3;
+						int3 c[4] = {b, b, b, b};
+						if(side > 0) {
+							c[0][axis] += 1; c[1][axis] += 1;
+							c[2][axis] += 1; c[3][axis] += 1;
+						}
+						c[1][u] += 1;
+						c[2][u] += 1; c[2][v] += 1;
+						c[3][v] += 1;
+
+						int vi[4];
+						for(int i = 0; i < 4; i++) {
+							int& vert = corner_vert[c[i].x + num_corners.x*((size_t)c[i].y + num_corners.y*(size_t)c[i].z)];
+							if(vert == -1) {
+								/* Corner in texture space, to object space. */
+								float3 co = make_float3(min(c[i].x*block*voxel_size.x, 1.0f),
+								                        min(c[i].y*block*voxel_size.y, 1.0f),
+								                        min(c[i].z*block*voxel_size.z, 1.0f));
+								vert = verts.size();
+								verts.push_back((co + loc) / size);
+							}
+							vi[i] = vert;
+						}
+
+						if(side > 0) {
+							quads.push_back(vi[0]); quads.push_back(vi[1]);
+							quads.push_back(vi[2]); quads.push_back(vi[3]);
+						}
+						else {
+							quads.push_back(vi[0]); quads.push_back(vi[3]);
+							quads.push_back(vi[2]); quads.push_back(vi[1]);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	/* Replace the domain box, keeping the transform to the texture space
+	 * which the volume attribute lookups are done in. */
+	const int shader = mesh->shader[0];
+	const size_t num_quads = quads.size() / 4;
+
+	mesh->verts.clear();
+	mesh->triangles.clear();
+	mesh->shader.clear();
+	mesh->smooth.clear();
+	mesh->attributes.clear();
+
+	mesh->reserve_mesh(verts.size(), num_quads*2);
+
+	float3 *P = mesh->verts.resize(verts.size());
+	for(size_t i = 0; i < verts.size(); i++)
+		P[i] = verts[i];
+
+	for(size_t i = 0; i < num_quads; i++) {
+		const int *q = &quads[i*4];
+		mesh->add_triangle(q[0], q[1], q[2], shader, false);
+		mesh->add_triangle(q[0], q[2], q[3], shader, false);
+	}
+
+	if(mesh->need_attribute(scene, ATTR_STD_GENERATED_TRANSFORM)) {
+		Attribute *attr = mesh->attributes.add(ATTR_STD_GENERATED_TRANSFORM);
+		*attr->data_transform() = transform_translate(-loc)*transform_scale(size);
+	}
+}
+
 /* Create vertex color attributes. */
 static void attr_create_vertex_color(Scene *scene,
                                      Mesh *mesh,
@@ -737,16 +939,18 @@ static void create_mesh(Scene *scene,
 	mesh->reserve_mesh(numverts, numtris);
 	mesh->reserve_subd_faces(numfaces, numngons, numcorners);
 
-	/* create vertex coordinates and normals */
-	for(b_mesh.vertices.begin(v); v != b_mesh.vertices.end(); ++v)
-		mesh->add_vertex(get_float3(v->co()));
+	/* create vertex coordinates and normals, in a single pass over the
+	 * Blender vertices writing straight into the final arrays */
+	float3 *P = mesh->verts.resize(numverts);
 
 	AttributeSet& attributes = (subdivision)? mesh->subd_attributes: mesh->attributes;
 	Attribute *attr_N = attributes.add(ATTR_STD_VERTEX_NORMAL);
 	float3 *N = attr_N->data_float3();
 
-	for(b_mesh.vertices.begin(v); v != b_mesh.vertices.end(); ++v, ++N)
+	for(b_mesh.vertices.begin(v); v != b_mesh.vertices.end(); ++v, ++P, ++N) {
+		*P = get_float3(v->co());
 		*N = get_float3(v->normal());
+	}
 	N = attr_N->data_float3();
 
 	/* create generated coordinates from undeformed coordinates */
@@ -856,7 +1060,8 @@ static void create_subd_mesh(Scene *scene,
                              BL::Mesh& b_mesh,
                              const vector<Shader*>& used_shaders,
                              float dicing_rate,
-                             int max_subdivisions)
+                             int max_subdivisions,
+                             int max_subdivision_triangles)
 {
 	BL::SubsurfModifier subsurf_mod(b_ob.modifiers[b_ob.modifiers.length()-1]);
 	bool subdivide_uvs = subsurf_mod.use_subsurf_uv();
@@ -896,6 +1101,7 @@ static void create_subd_mesh(Scene *scene,
 
 	sdparams.dicing_rate = max(0.1f, RNA_float_get(&cobj, "dicing_rate") * dicing_rate);
 	sdparams.max_level = max_subdivisions;
+	sdparams.max_triangles = max_subdivision_triangles;
 
 	scene->camera->update();
 	sdparams.camera = scene->camera;
@@ -1018,12 +1224,18 @@ Mesh *BlenderSync::sync_mesh(BL::Object& b_ob,
 	mesh_synced.insert(mesh);
 
 	/* create derived mesh */
-	array<int> oldtriangle = mesh->triangles;
+	MeshSync *mesh_sync = new MeshSync(mesh, b_ob);
+
+	/* the mesh is cleared below anyway, so take over the old arrays to
+	 * compare against instead of copying them */
+	mesh_sync->oldtriangle.steal_data(mesh->triangles);
 
 	/* compares curve_keys rather than strands in order to handle quick hair
 	 * adjustments in dynamic BVH - other methods could probably do this better*/
-	array<float3> oldcurve_keys = mesh->curve_keys;
-	array<float> oldcurve_radius = mesh->curve_radius;
+	mesh_sync->oldcurve_keys.steal_data(mesh->curve_keys);
+	mesh_sync->oldcurve_radius.steal_data(mesh->curve_radius);
+	mesh_sync->use_surfaces = render_layer.use_surfaces && !hide_tris;
+	mesh_sync->can_free_caches = can_free_caches;
 
 	mesh->clear();
 	mesh->used_shaders = used_shaders;
@@ -1058,36 +1270,76 @@ Mesh *BlenderSync::sync_mesh(BL::Object& b_ob,
 		                                 !preview,
 		                                 need_undeformed,
 		                                 mesh->subdivision_type);
+		mesh_sync->b_mesh = b_mesh;
 
-		if(b_mesh) {
-			if(render_layer.use_surfaces && !hide_tris) {
-				if(mesh->subdivision_type != Mesh::SUBDIVISION_NONE)
-					create_subd_mesh(scene, mesh, b_ob, b_mesh, used_shaders,
-					                 dicing_rate, max_subdivisions);
-				else
-					create_mesh(scene, mesh, b_mesh, used_shaders, false);
-
-				create_mesh_volume_attributes(scene, b_ob, mesh, b_scene.frame_current());
+		if(b_mesh && mesh_sync->use_surfaces) {
+			if(mesh->subdivision_type != Mesh::SUBDIVISION_NONE) {
+				create_subd_mesh(scene, mesh, b_ob, b_mesh, used_shaders,
+				                 dicing_rate, max_subdivisions,
+				                 max_subdivision_triangles);
+			}
+			else if(mesh_sync_pool) {
+				/* only reads the derived mesh and writes to this mesh, so it
+				 * is safe to run along with the sync of other objects */
+				mesh_sync_pool->push(function_bind(&create_mesh, scene, mesh, b_mesh, used_shaders, false, true));
+			}
+			else {
+				create_mesh(scene, mesh, b_mesh, used_shaders, false);
 			}
+		}
+	}
+	mesh->geometry_flags = requested_geometry_flags;
 
-			if(render_layer.use_hair && mesh->subdivision_type == Mesh::SUBDIVISION_NONE)
-				sync_curves(mesh, b_mesh, b_ob, false);
+	if(mesh_sync_pool) {
+		/* tag already so objects using this mesh get updated, the rebuild
+		 * test is done once the mesh is converted */
+		mesh->tag_update(scene, false);
+		mesh_sync_pending.push_back(mesh_sync);
 
-			if(can_free_caches) {
-				b_ob.cache_release();
-			}
+		/* limit the number of derived meshes alive at the same time */
+		if(mesh_sync_pending.size() >= (size_t)TaskScheduler::num_threads()*4) {
+			sync_mesh_finish_pending();
+		}
+	}
+	else {
+		sync_mesh_finish(mesh_sync);
+	}
+
+	return mesh;
+}
+
+void BlenderSync::sync_mesh_finish(MeshSync *mesh_sync)
+{
+	Mesh *mesh = mesh_sync->mesh;
+	BL::Object& b_ob = mesh_sync->b_ob;
+	BL::Mesh& b_mesh = mesh_sync->b_mesh;
+
+	if(b_mesh) {
+		if(mesh_sync->use_surfaces) {
+			if(mesh->subdivision_type == Mesh::SUBDIVISION_NONE)
+				create_mesh_volume_bounds(scene, b_ob, b_mesh, mesh);
+			create_mesh_volume_attributes(scene, b_ob, mesh, b_scene.frame_current());
+		}
 
-			/* free derived mesh */
-			b_data.meshes.remove(b_mesh, false);
+		if(render_layer.use_hair && mesh->subdivision_type == Mesh::SUBDIVISION_NONE)
+			sync_curves(mesh, b_mesh, b_ob, false);
+
+		if(mesh_sync->can_free_caches) {
+			b_ob.cache_release();
 		}
+
+		/* free derived mesh */
+		b_data.meshes.remove(b_mesh, false);
 	}
-	mesh->geometry_flags = requested_geometry_flags;
 
 	/* fluid motion */
 	sync_mesh_fluid_motion(b_ob, scene, mesh);
 
 	/* tag update */
 	bool rebuild = false;
+	const array<int>& oldtriangle = mesh_sync->oldtriangle;
+	const array<float3>& oldcurve_keys = mesh_sync->oldcurve_keys;
+	const array<float>& oldcurve_radius = mesh_sync->oldcurve_radius;
 
 	if(oldtriangle.size() != mesh->triangles.size())
 		rebuild = true;
@@ -1112,7 +1364,19 @@ Mesh *BlenderSync::sync_mesh(BL::Object& b_ob,
 
 	mesh->tag_update(scene, rebuild);
 
-	return mesh;
+	delete mesh_sync;
+}
+
+void BlenderSync::sync_mesh_finish_pending()
+{
+	if(mesh_sync_pool) {
+		mesh_sync_pool->wait_work();
+	}
+
+	foreach(MeshSync *mesh_sync, mesh_sync_pending) {
+		sync_mesh_finish(mesh_sync);
+	}
+	mesh_sync_pending.clear();
 }
 
 void BlenderSync::sync_mesh_motion(BL::Object& b_ob,
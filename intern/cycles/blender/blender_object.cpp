@@ -32,6 +32,7 @@
 #include "util/util_foreach.h"
 #include "util/util_hash.h"
 #include "util/util_logging.h"
+#include "util/util_task.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -509,6 +510,12 @@ void BlenderSync::sync_objects(float motion_time)
 	/* initialize culling */
 	BlenderObjectCulling culling(scene, b_scene);
 
+	/* convert meshes in parallel while objects are being synced */
+	TaskPool mesh_pool;
+	if(!motion) {
+		mesh_sync_pool = &mesh_pool;
+	}
+
 	/* object loop */
 	bool cancel = false;
 	bool use_portal = false;
@@ -542,6 +549,10 @@ void BlenderSync::sync_objects(float motion_time)
 
 	progress.set_sync_status("");
 
+	/* finish converted meshes, also frees the derived meshes when cancelled */
+	sync_mesh_finish_pending();
+	mesh_sync_pool = NULL;
+
 	if(!cancel && !motion) {
 		sync_background_light(use_portal);
 
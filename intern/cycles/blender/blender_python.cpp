@@ -67,6 +67,7 @@ bool debug_flags_sync_from_scene(BL::Scene b_scene)
 	flags.cpu.sse3 = get_boolean(cscene, "debug_use_cpu_sse3");
 	flags.cpu.sse2 = get_boolean(cscene, "debug_use_cpu_sse2");
 	flags.cpu.qbvh = get_boolean(cscene, "debug_use_qbvh");
+	flags.cpu.bvh8 = get_boolean(cscene, "debug_use_bvh8");
 	flags.cpu.split_kernel = get_boolean(cscene, "debug_use_cpu_split_kernel");
 	/* Synchronize CUDA flags. */
 	flags.cuda.adaptive_compile = get_boolean(cscene, "debug_use_cuda_adaptive_compile");
@@ -602,6 +603,24 @@ static PyObject *system_info_func(PyObject * /*self*/, PyObject * /*value*/)
 	return PyUnicode_FromString(system_info.c_str());
 }
 
+#ifdef WITH_CYCLES_DEBUG
+static PyObject *kernel_stats_func(PyObject * /*self*/, PyObject *value)
+{
+	BlenderSession *session = (BlenderSession*)PyLong_AsVoidPtr(value);
+	const KernelStats& stats = session->session->stats.kernel;
+
+	return Py_BuildValue("{s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K}",
+	                     "paths", (unsigned long long)stats.num_paths,
+	                     "rays", (unsigned long long)stats.num_rays,
+	                     "shadow_rays", (unsigned long long)stats.num_shadow_rays,
+	                     "bvh_traversed_nodes", (unsigned long long)stats.num_bvh_traversed_nodes,
+	                     "bvh_traversed_instances", (unsigned long long)stats.num_bvh_traversed_instances,
+	                     "bvh_intersections", (unsigned long long)stats.num_bvh_intersections,
+	                     "shader_evals", (unsigned long long)stats.num_shader_evals,
+	                     "light_samples", (unsigned long long)stats.num_light_samples);
+}
+#endif
+
 #ifdef WITH_OPENCL
 static PyObject *opencl_disable_func(PyObject * /*self*/, PyObject * /*value*/)
 {
@@ -768,6 +787,9 @@ static PyMethodDef methods[] = {
 	/* Debugging routines */
 	{"debug_flags_update", debug_flags_update_func, METH_VARARGS, ""},
 	{"debug_flags_reset", debug_flags_reset_func, METH_NOARGS, ""},
+#ifdef WITH_CYCLES_DEBUG
+	{"kernel_stats", kernel_stats_func, METH_O, ""},
+#endif
 
 	/* Resumable render */
 	{"set_resumable_chunk", set_resumable_chunk_func, METH_VARARGS, ""},
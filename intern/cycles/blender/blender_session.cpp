@@ -199,7 +199,7 @@ void BlenderSession::reset_session(BL::BlendData& b_data_, BL::Scene& b_scene_)
 		 * them rather than trying to distinguish which settings need to be updated
 		 */
 
-		delete session;
+		free_session();
 
 		create_session();
 
@@ -207,7 +207,6 @@ void BlenderSession::reset_session(BL::BlendData& b_data_, BL::Scene& b_scene_)
 	}
 
 	session->progress.reset();
-	scene->reset();
 
 	session->tile_manager.set_tile_order(session_params.tile_order);
 
@@ -216,8 +215,9 @@ void BlenderSession::reset_session(BL::BlendData& b_data_, BL::Scene& b_scene_)
 	 */
 	session->stats.mem_peak = session->stats.mem_used;
 
-	/* sync object should be re-created */
-	sync = new BlenderSync(b_engine, b_data, b_depsgraph, b_scene, scene, !background, session->progress, is_cpu);
+	/* keep the scene synced for the previous frame, so shaders, images and
+	 * BVHs of data which is not animated are reused */
+	sync->reset(b_data, b_scene);
 
 	/* for final render we will do full data sync per render layer, only
 	 * do some basic syncing here, no objects or materials for speed */
@@ -430,6 +430,14 @@ void BlenderSession::render()
 		session->params.denoising_feature_strength = get_float(crl, "denoising_feature_strength");
 		session->params.denoising_relative_pca = get_boolean(crl, "denoising_relative_pca");
 
+		/* Converged pixels are scaled at the end of their tile, this doesn't work with
+		 * tiles rendered in several passes nor with the denoising variance passes. */
+		PointerRNA cscene = RNA_pointer_get(&b_scene.ptr, "cycles");
+		bool use_adaptive_sampling = !session_params.progressive_refine && !use_denoising &&
+		                             get_boolean(cscene, "use_adaptive_sampling");
+		buffer_params.adaptive_aux_pass = use_adaptive_sampling;
+		scene->film->use_adaptive_sampling = use_adaptive_sampling;
+
 		scene->film->pass_alpha_threshold = b_layer_iter->pass_alpha_threshold();
 		scene->film->tag_passes_update(scene, passes);
 		scene->film->tag_update(scene);
@@ -662,11 +670,6 @@ void BlenderSession::do_write_update_render_result(BL::RenderResult& b_rr,
                                                    bool do_update_only)
 {
 	RenderBuffers *buffers = rtile.buffers;
-
-	/* copy data from device */
-	if(!buffers->copy_from_device())
-		return;
-
 	BufferParams& params = buffers->params;
 	float exposure = scene->film->exposure;
 
@@ -679,6 +682,22 @@ void BlenderSession::do_write_update_render_result(BL::RenderResult& b_rr,
 		sample -= range_start_sample;
 	}
 
+	/* progressive refine updates happen in between samples while devices
+	 * are idle, convert the combined pass there instead of transferring
+	 * the full buffer with all passes for every tile */
+	if(do_update_only && session->params.progressive_refine) {
+		BL::RenderPass b_combined_pass(b_rlay.passes.find_by_name("Combined", b_rview_name.c_str()));
+		if(buffers->get_combined_rect_from_device(sample, &pixels[0])) {
+			b_combined_pass.rect(&pixels[0]);
+			b_engine.update_result(b_rr);
+			return;
+		}
+	}
+
+	/* copy data from device */
+	if(!buffers->copy_from_device())
+		return;
+
 	if(!do_update_only) {
 		/* copy each pass */
 		BL::RenderLayer::passes_iterator b_iter;
@@ -60,6 +60,7 @@ BlenderSync::BlenderSync(BL::RenderEngine& b_engine,
   mesh_map(&scene->meshes),
   light_map(&scene->lights),
   particle_system_map(&scene->particle_systems),
+  mesh_sync_pool(NULL),
   world_map(NULL),
   world_recalc(false),
   scene(scene),
@@ -68,11 +69,13 @@ BlenderSync::BlenderSync(BL::RenderEngine& b_engine,
   is_cpu(is_cpu),
   dicing_rate(1.0f),
   max_subdivisions(12),
+  max_subdivision_triangles(0),
   progress(progress)
 {
 	PointerRNA cscene = RNA_pointer_get(&b_scene.ptr, "cycles");
 	dicing_rate = preview ? RNA_float_get(&cscene, "preview_dicing_rate") : RNA_float_get(&cscene, "dicing_rate");
 	max_subdivisions = RNA_int_get(&cscene, "max_subdivisions");
+	max_subdivision_triangles = RNA_int_get(&cscene, "max_subdivision_triangles");
 }
 
 BlenderSync::~BlenderSync()
@@ -125,6 +128,13 @@ bool BlenderSync::sync_recalc()
 			max_subdivisions = updated_max_subdivisions;
 			dicing_prop_changed = true;
 		}
+
+		int updated_max_subdivision_triangles = RNA_int_get(&cscene, "max_subdivision_triangles");
+
+		if(max_subdivision_triangles != updated_max_subdivision_triangles) {
+			max_subdivision_triangles = updated_max_subdivision_triangles;
+			dicing_prop_changed = true;
+		}
 	}
 
 	BL::BlendData::objects_iterator b_ob;
@@ -193,6 +203,63 @@ bool BlenderSync::sync_recalc()
 	return recalc;
 }
 
+static bool id_is_animated(BL::ID& b_id, BL::NodeTree b_ntree)
+{
+	BL::AnimData b_adt(RNA_pointer_get(&b_id.ptr, "animation_data"));
+
+	/* node tree animation holds keyframed node socket values */
+	return b_adt || (b_ntree && b_ntree.animation_data());
+}
+
+void BlenderSync::reset(BL::BlendData& b_data, BL::Scene& b_scene)
+{
+	/* Keep the data synced for the previous frame of a final render with
+	 * persistent data, and tag only what may differ for the new frame. The
+	 * recalc flags do not cover everything changing on frame change, so
+	 * animated data is tagged as well. */
+	this->b_data = b_data;
+	this->b_scene = b_scene;
+
+	sync_recalc();
+
+	BL::BlendData::materials_iterator b_mat;
+	for(b_data.materials.begin(b_mat); b_mat != b_data.materials.end(); ++b_mat) {
+		if(id_is_animated(*b_mat, b_mat->node_tree()))
+			shader_map.set_recalc(*b_mat);
+	}
+
+	BL::BlendData::lamps_iterator b_lamp;
+	for(b_data.lamps.begin(b_lamp); b_lamp != b_data.lamps.end(); ++b_lamp) {
+		if(id_is_animated(*b_lamp, b_lamp->node_tree()))
+			shader_map.set_recalc(*b_lamp);
+	}
+
+	BL::World b_world = b_scene.world();
+	if(b_world && id_is_animated(b_world, b_world.node_tree()))
+		world_recalc = true;
+
+	/* object syncing only compares transforms and flags, so it is cheap to
+	 * tag all of them, while meshes are only synced again when they are
+	 * evaluated from modifiers or shape keys, or animated themselves */
+	BL::BlendData::objects_iterator b_ob;
+	for(b_data.objects.begin(b_ob); b_ob != b_data.objects.end(); ++b_ob) {
+		object_map.set_recalc(*b_ob);
+		light_map.set_recalc(*b_ob);
+
+		if(object_is_mesh(*b_ob)) {
+			BL::ID b_ob_data = b_ob->data();
+
+			if(BKE_object_is_modified(*b_ob))
+				mesh_map.set_recalc(*b_ob);
+			else if(id_is_animated(b_ob_data, BL::NodeTree(PointerRNA_NULL)))
+				mesh_map.set_recalc(b_ob_data);
+		}
+
+		if(b_ob->particle_systems.length())
+			particle_system_map.set_recalc(*b_ob);
+	}
+}
+
 void BlenderSync::sync_data(BL::RenderSettings& b_render,
                             BL::SpaceView3D& b_v3d,
                             BL::Object& b_override,
@@ -294,6 +361,10 @@ void BlenderSync::sync_integrator()
 	integrator->sample_all_lights_direct = get_boolean(cscene, "sample_all_lights_direct");
 	integrator->sample_all_lights_indirect = get_boolean(cscene, "sample_all_lights_indirect");
 	integrator->light_sampling_threshold = get_float(cscene, "light_sampling_threshold");
+	integrator->use_light_tree = get_boolean(cscene, "use_light_tree");
+
+	integrator->adaptive_threshold = get_float(cscene, "adaptive_threshold");
+	integrator->adaptive_min_samples = get_int(cscene, "adaptive_min_samples");
 
 	int diffuse_samples = get_int(cscene, "diffuse_samples");
 	int glossy_samples = get_int(cscene, "glossy_samples");
@@ -334,8 +405,12 @@ void BlenderSync::sync_integrator()
 		integrator->ao_bounces = 0;
 	}
 
-	if(integrator->modified(previntegrator))
+	if(integrator->modified(previntegrator)) {
+		/* The light tree is built along with the light distribution. */
+		if(integrator->use_light_tree != previntegrator.use_light_tree)
+			scene->light_manager->tag_update(scene);
 		integrator->tag_update(scene);
+	}
 }
 
 /* Film */
@@ -505,6 +580,7 @@ PassType BlenderSync::get_pass_type(BL::RenderPass& b_pass)
 	MAP_PASS("Debug BVH Traversed Instances", PASS_BVH_TRAVERSED_INSTANCES);
 	MAP_PASS("Debug BVH Intersections", PASS_BVH_INTERSECTIONS);
 	MAP_PASS("Debug Ray Bounces", PASS_RAY_BOUNCES);
+	MAP_PASS("Debug Shader Nodes", PASS_SHADER_NODES);
 #endif
 #undef MAP_PASS
 
@@ -591,6 +667,10 @@ array<Pass> BlenderSync::sync_render_passes(BL::RenderLayer& b_rlay,
 		b_engine.add_pass("Debug Ray Bounces", 1, "X", b_srlay.name().c_str());
 		Pass::add(PASS_RAY_BOUNCES, passes);
 	}
+	if(get_boolean(crp, "pass_debug_shader_nodes")) {
+		b_engine.add_pass("Debug Shader Nodes", 1, "X", b_srlay.name().c_str());
+		Pass::add(PASS_SHADER_NODES, passes);
+	}
 #endif
 
 	return passes;
@@ -612,8 +692,18 @@ SceneParams BlenderSync::get_scene_params(BL::Scene& b_scene,
 	else if(shadingsystem == 1)
 		params.shadingsystem = SHADINGSYSTEM_OSL;
 	
-	if(background)
+	if(background && params.shadingsystem != SHADINGSYSTEM_OSL)
+		params.persistent_data = r.use_persistent_data();
+	else
+		params.persistent_data = false;
+
+	if(background && !params.persistent_data)
 		params.bvh_type = SceneParams::BVH_STATIC;
+	else if(background)
+		/* Keep a BVH per mesh with persistent data, so frames where only
+		 * object transforms change rebuild just the top level BVH over the
+		 * object bounds instead of the whole flattened scene. */
+		params.bvh_type = SceneParams::BVH_DYNAMIC;
 	else
 		params.bvh_type = (SceneParams::BVHType)get_enum(
 		        cscene,
@@ -623,12 +713,9 @@ SceneParams BlenderSync::get_scene_params(BL::Scene& b_scene,
 
 	params.use_bvh_spatial_split = RNA_boolean_get(&cscene, "debug_use_spatial_splits");
 	params.use_bvh_unaligned_nodes = RNA_boolean_get(&cscene, "debug_use_hair_bvh");
+	params.use_bvh_quantized_nodes = RNA_boolean_get(&cscene, "debug_use_bvh_quantized_nodes");
 	params.num_bvh_time_steps = RNA_int_get(&cscene, "debug_bvh_time_steps");
-
-	if(background && params.shadingsystem != SHADINGSYSTEM_OSL)
-		params.persistent_data = r.use_persistent_data();
-	else
-		params.persistent_data = false;
+	params.use_bvh_cache = background && RNA_boolean_get(&cscene, "use_bvh_cache");
 
 	int texture_limit;
 	if(background) {
@@ -643,15 +730,23 @@ SceneParams BlenderSync::get_scene_params(BL::Scene& b_scene,
 	else {
 		params.texture_limit = 0;
 	}
+	params.use_half_float_textures = RNA_boolean_get(&cscene, "use_half_float_textures");
 
 #if !(defined(__GNUC__) && (defined(i386) || defined(_M_IX86)))
 	if(is_cpu) {
 		params.use_qbvh = DebugFlags().cpu.qbvh && system_cpu_support_sse2();
+#ifdef WITH_CYCLES_OPTIMIZED_KERNEL_AVX2
+		/* BVH8 is only traversed by the AVX2 kernel. */
+		params.use_bvh8 = params.use_qbvh &&
+		                  DebugFlags().cpu.bvh8 &&
+		                  system_cpu_support_avx2();
+#endif
 	}
 	else
 #endif
 	{
 		params.use_qbvh = false;
+		params.use_bvh8 = false;
 	}
 
 	return params;
@@ -792,7 +887,11 @@ SessionParams BlenderSync::get_session_params(BL::RenderEngine& b_engine,
 		params.tile_order = TILE_BOTTOM_TO_TOP;
 	}
 
+	/* split tiles can't be written into the tiled EXR of save buffers */
+	params.split_tiles = background && !b_scene.render().use_save_buffers();
+
 	params.start_resolution = get_int(cscene, "preview_start_resolution");
+	params.reprojection_samples = (background)? 0: get_int(cscene, "preview_reprojection_samples");
 
 	/* other parameters */
 	if(b_scene.render().threads_mode() == BL::RenderSettings::threads_mode_FIXED)
@@ -47,6 +47,7 @@ class SceneLayer;
 class Shader;
 class ShaderGraph;
 class ShaderNode;
+class TaskPool;
 
 class BlenderSync {
 public:
@@ -62,6 +63,7 @@ public:
 
 	/* sync */
 	bool sync_recalc();
+	void reset(BL::BlendData& b_data, BL::Scene& b_scene);
 	void sync_data(BL::RenderSettings& b_render,
 	               BL::SpaceView3D& b_v3d,
 	               BL::Object& b_override,
@@ -116,11 +118,31 @@ private:
 	void sync_shaders();
 	void sync_curve_settings();
 
+	/* Mesh sync state kept until the derived mesh is converted, which can
+	 * happen in mesh_sync_pool while further objects are being synced. */
+	struct MeshSync {
+		MeshSync(Mesh *mesh, BL::Object& b_ob)
+		: mesh(mesh), b_ob(b_ob), b_mesh(PointerRNA_NULL),
+		  use_surfaces(false), can_free_caches(false) {}
+
+		Mesh *mesh;
+		BL::Object b_ob;
+		BL::Mesh b_mesh;
+		bool use_surfaces;
+		bool can_free_caches;
+
+		array<int> oldtriangle;
+		array<float3> oldcurve_keys;
+		array<float> oldcurve_radius;
+	};
+
 	void sync_nodes(Shader *shader, BL::ShaderNodeTree& b_ntree);
 	Mesh *sync_mesh(BL::Object& b_ob,
 	                BL::Object& b_ob_instance,
 	                bool object_updated,
 	                bool hide_tris);
+	void sync_mesh_finish(MeshSync *mesh_sync);
+	void sync_mesh_finish_pending();
 	void sync_curves(Mesh *mesh,
 	                 BL::Mesh& b_mesh,
 	                 BL::Object& b_ob,
@@ -175,6 +197,8 @@ private:
 	id_map<ParticleSystemKey, ParticleSystem> particle_system_map;
 	set<Mesh*> mesh_synced;
 	set<Mesh*> mesh_motion_synced;
+	TaskPool *mesh_sync_pool;
+	vector<MeshSync*> mesh_sync_pending;
 	set<float> motion_times;
 	void *world_map;
 	bool world_recalc;
@@ -186,6 +210,7 @@ private:
 
 	float dicing_rate;
 	int max_subdivisions;
+	int max_subdivision_triangles;
 
 	struct RenderLayerInfo {
 		RenderLayerInfo()
@@ -22,7 +22,9 @@
 
 #include "bvh/bvh2.h"
 #include "bvh/bvh4.h"
+#include "bvh/bvh8.h"
 #include "bvh/bvh_build.h"
+#include "bvh/bvh_cache.h"
 #include "bvh/bvh_node.h"
 
 #include "util/util_foreach.h"
@@ -45,13 +47,15 @@ int BVHStackEntry::encodeIdx() const
 /* BVH */
 
 BVH::BVH(const BVHParams& params_, const vector<Object*>& objects_)
-: params(params_), objects(objects_)
+: params(params_), objects(objects_), refit_sah_reference(0.0f)
 {
 }
 
 BVH *BVH::create(const BVHParams& params, const vector<Object*>& objects)
 {
-	if(params.use_qbvh)
+	if(params.use_bvh8)
+		return new BVH8(params, objects);
+	else if(params.use_qbvh)
 		return new BVH4(params, objects);
 	else
 		return new BVH2(params, objects);
@@ -61,6 +65,20 @@ BVH *BVH::create(const BVHParams& params, const vector<Object*>& objects)
 
 void BVH::build(Progress& progress)
 {
+	/* reuse BVH from a previous render of the same geometry */
+	string cache_key;
+
+	if(params.use_cache) {
+		progress.set_substatus("Loading cached BVH");
+
+		cache_key = bvh_cache_key(params, objects);
+
+		if(bvh_cache_read(cache_key, pack)) {
+			refit_sah_reference = 0.0f;
+			return;
+		}
+	}
+
 	progress.set_substatus("Building BVH");
 
 	/* build nodes */
@@ -93,19 +111,35 @@ void BVH::build(Progress& progress)
 
 	/* free build nodes */
 	root->deleteSubtree();
+
+	refit_sah_reference = 0.0f;
+
+	if(params.use_cache) {
+		bvh_cache_write(cache_key, pack);
+	}
 }
 
 /* Refitting */
 
-void BVH::refit(Progress& progress)
+/* Update the node bounds for the new primitive positions, keeping the topology.
+ * Returns false when the tree got too loose for the deformation and should be
+ * rebuilt, see BVHParams::refit_max_sah_ratio. */
+bool BVH::refit(Progress& progress)
 {
 	progress.set_substatus("Packing BVH primitives");
 	pack_primitives();
 
-	if(progress.get_cancel()) return;
+	if(progress.get_cancel()) return true;
 
 	progress.set_substatus("Refitting BVH nodes");
-	refit_nodes();
+	float sah = refit_nodes();
+
+	if(refit_sah_reference == 0.0f) {
+		refit_sah_reference = sah;
+		return true;
+	}
+
+	return sah <= refit_sah_reference * params.refit_max_sah_ratio;
 }
 
 /* Triangles */
@@ -184,6 +218,7 @@ void BVH::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
 	 * top level BVH, adjusting indexes and offsets where appropriate.
 	 */
 	const bool use_qbvh = params.use_qbvh;
+	const bool use_bvh8 = params.use_bvh8;
 
 	/* Adjust primitive index to point to the triangle in the global array, for
 	 * meshes with transform applied and already in the top level BVH.
@@ -359,12 +394,24 @@ void BVH::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
 
 			for(size_t i = 0, j = 0; i < bvh_nodes_size; j++) {
 				size_t nsize, nsize_bbox;
-				if(bvh_nodes[i].x & PATH_RAY_NODE_UNALIGNED) {
+				if(use_bvh8) {
+					/* Aligned node with two int4 of child indices,
+					 * see BVH8::pack_aligned_node().
+					 */
+					nsize = BVH_ONODE_SIZE;
+					nsize_bbox = 13;
+				}
+				else if(bvh_nodes[i].x & PATH_RAY_NODE_UNALIGNED) {
 					nsize = use_qbvh
 					            ? BVH_UNALIGNED_QNODE_SIZE
 					            : BVH_UNALIGNED_NODE_SIZE;
 					nsize_bbox = (use_qbvh)? 13: 0;
 				}
+				else if(use_qbvh && bvh_nodes[i].w != 0) {
+					/* Quantized aligned node, see BVH4::pack_quantized_node(). */
+					nsize = BVH_QUANTIZED_QNODE_SIZE;
+					nsize_bbox = 4;
+				}
 				else {
 					nsize = (use_qbvh)? BVH_QNODE_SIZE: BVH_NODE_SIZE;
 					nsize_bbox = (use_qbvh)? 7: 0;
@@ -380,13 +427,24 @@ void BVH::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
 				data.z += (data.z < 0)? -noffset_leaf: noffset;
 				data.w += (data.w < 0)? -noffset_leaf: noffset;
 
-				if(use_qbvh) {
+				if(use_qbvh || use_bvh8) {
 					data.x += (data.x < 0)? -noffset_leaf: noffset;
 					data.y += (data.y < 0)? -noffset_leaf: noffset;
 				}
 
 				pack_nodes[pack_nodes_offset + nsize_bbox] = data;
 
+				if(use_bvh8) {
+					/* Second half of the child indices. */
+					++nsize_bbox;
+					data = bvh_nodes[i + nsize_bbox];
+					data.x += (data.x < 0)? -noffset_leaf: noffset;
+					data.y += (data.y < 0)? -noffset_leaf: noffset;
+					data.z += (data.z < 0)? -noffset_leaf: noffset;
+					data.w += (data.w < 0)? -noffset_leaf: noffset;
+					pack_nodes[pack_nodes_offset + nsize_bbox] = data;
+				}
+
 				/* Usually this copies nothing, but we better
 				 * be prepared for possible node size extension.
 				 */
@@ -36,6 +36,9 @@ class Progress;
 #define BVH_ALIGN     4096
 #define TRI_NODE_SIZE 3
 
+/* Subtrees above this depth are refitted in parallel. */
+#define BVH_REFIT_TASK_DEPTH 3
+
 /* Packed BVH
  *
  * BVH stored as it will be used for traversal on the rendering device. */
@@ -82,11 +85,15 @@ public:
 	BVHParams params;
 	vector<Object*> objects;
 
+	/* SAH cost of the first refit after the build, reference for the
+	 * quality of the following refits. Zero until then. */
+	float refit_sah_reference;
+
 	static BVH *create(const BVHParams& params, const vector<Object*>& objects);
 	virtual ~BVH() {}
 
 	void build(Progress& progress);
-	void refit(Progress& progress);
+	bool refit(Progress& progress);
 
 protected:
 	BVH(const BVHParams& params, const vector<Object*>& objects);
@@ -100,7 +107,7 @@ protected:
 
 	/* for subclasses to implement */
 	virtual void pack_nodes(const BVHNode *root) = 0;
-	virtual void refit_nodes() = 0;
+	virtual float refit_nodes() = 0;
 };
 
 /* Pack Utility */
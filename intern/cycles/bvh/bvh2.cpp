@@ -23,6 +23,8 @@
 #include "bvh/bvh_node.h"
 #include "bvh/bvh_unaligned.h"
 
+#include "util/util_task.h"
+
 CCL_NAMESPACE_BEGIN
 
 static bool node_bvh_is_unaligned(const BVHNode *node)
@@ -235,16 +237,27 @@ void BVH2::pack_nodes(const BVHNode *root)
 	pack.root_index = (root->is_leaf())? -1: 0;
 }
 
-void BVH2::refit_nodes()
+/* Returns the SAH cost of the refitted tree. */
+float BVH2::refit_nodes()
 {
 	assert(!params.top_level);
 
 	BoundBox bbox = BoundBox::empty;
 	uint visibility = 0;
-	refit_node(0, (pack.root_index == -1)? true: false, bbox, visibility);
+	float sah = 0.0f;
+	refit_node(0, (pack.root_index == -1)? true: false, bbox, visibility, sah, 0);
+
+	return sah / bbox.safe_area();
+}
+
+void BVH2::refit_node_task(int idx, bool leaf, BoundBox *bbox, uint *visibility, float *sah, int depth)
+{
+	refit_node(idx, leaf, *bbox, *visibility, *sah, depth);
 }
 
-void BVH2::refit_node(int idx, bool leaf, BoundBox& bbox, uint& visibility)
+/* Bounds of the node are grown into bbox, its SAH cost (not normalized by the
+ * root area) is added to sah. */
+void BVH2::refit_node(int idx, bool leaf, BoundBox& bbox, uint& visibility, float& sah, int depth)
 {
 	if(leaf) {
 		assert(idx + BVH_NODE_LEAF_SIZE <= pack.leaf_nodes.size());
@@ -323,6 +336,8 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox& bbox, uint& visibility)
 		leaf_data[0].z = __uint_as_float(visibility);
 		leaf_data[0].w = __uint_as_float(data[0].w);
 		memcpy(&pack.leaf_nodes[idx], leaf_data, sizeof(float4)*BVH_NODE_LEAF_SIZE);
+
+		sah += bbox.safe_area() * params.primitive_cost(c1 - c0);
 	}
 	else {
 		assert(idx + BVH_NODE_SIZE <= pack.nodes.size());
@@ -334,9 +349,23 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox& bbox, uint& visibility)
 		/* refit inner node, set bbox from children */
 		BoundBox bbox0 = BoundBox::empty, bbox1 = BoundBox::empty;
 		uint visibility0 = 0, visibility1 = 0;
-
-		refit_node((c0 < 0)? -c0-1: c0, (c0 < 0), bbox0, visibility0);
-		refit_node((c1 < 0)? -c1-1: c1, (c1 < 0), bbox1, visibility1);
+		float sah0 = 0.0f, sah1 = 0.0f;
+
+		if(depth < BVH_REFIT_TASK_DEPTH) {
+			/* Children write to separate nodes, refit them in parallel. */
+			TaskPool pool;
+			pool.push(function_bind(&BVH2::refit_node_task, this,
+			                        (c0 < 0)? -c0-1: c0, (c0 < 0),
+			                        &bbox0, &visibility0, &sah0, depth + 1));
+			pool.push(function_bind(&BVH2::refit_node_task, this,
+			                        (c1 < 0)? -c1-1: c1, (c1 < 0),
+			                        &bbox1, &visibility1, &sah1, depth + 1));
+			pool.wait_work();
+		}
+		else {
+			refit_node((c0 < 0)? -c0-1: c0, (c0 < 0), bbox0, visibility0, sah0, depth + 1);
+			refit_node((c1 < 0)? -c1-1: c1, (c1 < 0), bbox1, visibility1, sah1, depth + 1);
+		}
 
 		if(is_unaligned) {
 			Transform aligned_space = transform_identity();
@@ -358,6 +387,7 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox& bbox, uint& visibility)
 		bbox.grow(bbox0);
 		bbox.grow(bbox1);
 		visibility = visibility0|visibility1;
+		sah += sah0 + sah1 + bbox.safe_area() * params.node_cost(2);
 	}
 }
 
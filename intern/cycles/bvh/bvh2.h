@@ -78,8 +78,9 @@ protected:
 	                         uint visibility0, uint visibility1);
 
 	/* refit */
-	void refit_nodes();
-	void refit_node(int idx, bool leaf, BoundBox& bbox, uint& visibility);
+	float refit_nodes();
+	void refit_node(int idx, bool leaf, BoundBox& bbox, uint& visibility, float& sah, int depth);
+	void refit_node_task(int idx, bool leaf, BoundBox *bbox, uint *visibility, float *sah, int depth);
 };
 
 CCL_NAMESPACE_END
@@ -23,6 +23,8 @@
 #include "bvh/bvh_node.h"
 #include "bvh/bvh_unaligned.h"
 
+#include "util/util_task.h"
+
 CCL_NAMESPACE_BEGIN
 
 /* Can we avoid this somehow or make more generic?
@@ -135,6 +137,11 @@ void BVH4::pack_aligned_node(int idx,
                              const float time_to,
                              const int num)
 {
+	if(params.use_quantized_nodes) {
+		pack_quantized_node(idx, bounds, child, visibility, time_from, time_to, num);
+		return;
+	}
+
 	float4 data[BVH_QNODE_SIZE];
 	memset(data, 0, sizeof(data));
 
@@ -175,6 +182,124 @@ void BVH4::pack_aligned_node(int idx,
 	memcpy(&pack.nodes[idx], data, sizeof(float4)*BVH_QNODE_SIZE);
 }
 
+/* Quantized aligned node layout:
+ *
+ *   [0] visibility, time_from, time_to, biased exponents of the scale
+ *   [1] origin of the quantization grid, the node bounds minimum
+ *   [2] min x, max x, min y, max y of all four children, one byte each
+ *   [3] min z, max z, unused
+ *   [4] child indices
+ *
+ * The scale is a power of two, so the kernel reconstructs a plane as
+ * origin + q*scale with a single rounding, exactly as done here. Minimum
+ * planes are rounded down and maximum planes up, so child bounds only grow.
+ */
+
+static float quantize_scale(const float extent, uint *biased_exponent)
+{
+	int exponent;
+	frexpf(max(extent, FLT_MIN) / 255.0f, &exponent);
+	float scale = ldexpf(1.0f, exponent);
+	/* Guard against rounding, 255 steps have to cover the whole extent. */
+	while(scale * 255.0f < extent) {
+		scale *= 2.0f;
+		exponent++;
+	}
+	*biased_exponent = (uint)clamp(exponent + 127, 1, 254);
+	return __uint_as_float(*biased_exponent << 23);
+}
+
+static uint quantize_plane(const float value,
+                          const float origin,
+                          const float scale,
+                          const bool round_up)
+{
+	int q = (int)floorf((value - origin) / scale);
+	q = clamp(q, 0, 255);
+	if(round_up) {
+		while(q < 255 && origin + q*scale < value) {
+			q++;
+		}
+	}
+	else {
+		while(q > 0 && origin + q*scale > value) {
+			q--;
+		}
+	}
+	return (uint)q;
+}
+
+void BVH4::pack_quantized_node(int idx,
+                               const BoundBox *bounds,
+                               const int *child,
+                               const uint visibility,
+                               const float time_from,
+                               const float time_to,
+                               const int num)
+{
+	float4 data[BVH_QUANTIZED_QNODE_SIZE];
+	memset(data, 0, sizeof(data));
+
+	BoundBox node_bounds = BoundBox::empty;
+	for(int i = 0; i < num; i++) {
+		node_bounds.grow(bounds[i]);
+	}
+	const float3 origin = node_bounds.min;
+	const float3 extent = node_bounds.max - node_bounds.min;
+
+	uint exponent_x, exponent_y, exponent_z;
+	const float3 scale = make_float3(quantize_scale(extent.x, &exponent_x),
+	                                 quantize_scale(extent.y, &exponent_y),
+	                                 quantize_scale(extent.z, &exponent_z));
+
+	data[0].x = __uint_as_float(visibility & ~PATH_RAY_NODE_UNALIGNED);
+	data[0].y = time_from;
+	data[0].z = time_to;
+	/* Exponents are never zero, which also tags the node as quantized. */
+	data[0].w = __uint_as_float(exponent_x | (exponent_y << 8) | (exponent_z << 16));
+
+	data[1] = make_float4(origin.x, origin.y, origin.z, 0.0f);
+
+	uint planes[6] = {0};
+	for(int i = 0; i < num; i++) {
+		const uint shift = i * 8;
+		planes[0] |= quantize_plane(bounds[i].min.x, origin.x, scale.x, false) << shift;
+		planes[1] |= quantize_plane(bounds[i].max.x, origin.x, scale.x, true) << shift;
+		planes[2] |= quantize_plane(bounds[i].min.y, origin.y, scale.y, false) << shift;
+		planes[3] |= quantize_plane(bounds[i].max.y, origin.y, scale.y, true) << shift;
+		planes[4] |= quantize_plane(bounds[i].min.z, origin.z, scale.z, false) << shift;
+		planes[5] |= quantize_plane(bounds[i].max.z, origin.z, scale.z, true) << shift;
+
+		data[4][i] = __int_as_float(child[i]);
+	}
+
+	for(int i = num; i < 4; i++) {
+		/* Empty box with min above max, never recorded as intersection. */
+		const uint shift = i * 8;
+		planes[0] |= 255u << shift;
+		planes[2] |= 255u << shift;
+		planes[4] |= 255u << shift;
+
+		data[4][i] = __int_as_float(0);
+	}
+
+	data[2] = make_float4(__uint_as_float(planes[0]),
+	                      __uint_as_float(planes[1]),
+	                      __uint_as_float(planes[2]),
+	                      __uint_as_float(planes[3]));
+	data[3] = make_float4(__uint_as_float(planes[4]),
+	                      __uint_as_float(planes[5]),
+	                      0.0f,
+	                      0.0f);
+
+	memcpy(&pack.nodes[idx], data, sizeof(float4)*BVH_QUANTIZED_QNODE_SIZE);
+}
+
+int BVH4::aligned_node_size() const
+{
+	return (params.use_quantized_nodes)? BVH_QUANTIZED_QNODE_SIZE: BVH_QNODE_SIZE;
+}
+
 void BVH4::pack_unaligned_inner(const BVHStackEntry& e,
                                 const BVHStackEntry *en,
                                 int num)
@@ -278,10 +403,10 @@ void BVH4::pack_nodes(const BVHNode *root)
 		const size_t num_unaligned_nodes =
 		        root->getSubtreeSize(BVH_STAT_UNALIGNED_INNER_QNODE_COUNT);
 		node_size = (num_unaligned_nodes * BVH_UNALIGNED_QNODE_SIZE) +
-		            (num_inner_nodes - num_unaligned_nodes) * BVH_QNODE_SIZE;
+		            (num_inner_nodes - num_unaligned_nodes) * aligned_node_size();
 	}
 	else {
-		node_size = num_inner_nodes * BVH_QNODE_SIZE;
+		node_size = num_inner_nodes * aligned_node_size();
 	}
 	/* Resize arrays. */
 	pack.nodes.clear();
@@ -306,7 +431,7 @@ void BVH4::pack_nodes(const BVHNode *root)
 		stack.push_back(BVHStackEntry(root, nextNodeIdx));
 		nextNodeIdx += node_qbvh_is_unaligned(root)
 		                       ? BVH_UNALIGNED_QNODE_SIZE
-		                       : BVH_QNODE_SIZE;
+		                       : aligned_node_size();
 	}
 
 	while(stack.size()) {
@@ -350,7 +475,7 @@ void BVH4::pack_nodes(const BVHNode *root)
 					idx = nextNodeIdx;
 					nextNodeIdx += node_qbvh_is_unaligned(nodes[i])
 					                       ? BVH_UNALIGNED_QNODE_SIZE
-					                       : BVH_QNODE_SIZE;
+					                       : aligned_node_size();
 				}
 				stack.push_back(BVHStackEntry(nodes[i], idx));
 			}
@@ -363,16 +488,27 @@ void BVH4::pack_nodes(const BVHNode *root)
 	pack.root_index = (root->is_leaf())? -1: 0;
 }
 
-void BVH4::refit_nodes()
+/* Returns the SAH cost of the refitted tree. */
+float BVH4::refit_nodes()
 {
 	assert(!params.top_level);
 
 	BoundBox bbox = BoundBox::empty;
 	uint visibility = 0;
-	refit_node(0, (pack.root_index == -1)? true: false, bbox, visibility);
+	float sah = 0.0f;
+	refit_node(0, (pack.root_index == -1)? true: false, bbox, visibility, sah, 0);
+
+	return sah / bbox.safe_area();
+}
+
+void BVH4::refit_node_task(int idx, bool leaf, BoundBox *bbox, uint *visibility, float *sah, int depth)
+{
+	refit_node(idx, leaf, *bbox, *visibility, *sah, depth);
 }
 
-void BVH4::refit_node(int idx, bool leaf, BoundBox& bbox, uint& visibility)
+/* Bounds of the node are grown into bbox, its SAH cost (not normalized by the
+ * root area) is added to sah. */
+void BVH4::refit_node(int idx, bool leaf, BoundBox& bbox, uint& visibility, float& sah, int depth)
 {
 	if(leaf) {
 		int4 *data = &pack.leaf_nodes[idx];
@@ -458,6 +594,8 @@ void BVH4::refit_node(int idx, bool leaf, BoundBox& bbox, uint& visibility)
 		leaf_data[0].z = __uint_as_float(visibility);
 		leaf_data[0].w = __uint_as_float(c.w);
 		memcpy(&pack.leaf_nodes[idx], leaf_data, sizeof(float4)*BVH_QNODE_LEAF_SIZE);
+
+		sah += bbox.safe_area() * params.primitive_cost(c.y - c.x);
 	}
 	else {
 		int4 *data = &pack.nodes[idx];
@@ -466,6 +604,10 @@ void BVH4::refit_node(int idx, bool leaf, BoundBox& bbox, uint& visibility)
 		if(is_unaligned) {
 			c = data[13];
 		}
+		else if(data[0].w != 0) {
+			/* Quantized node. */
+			c = data[4];
+		}
 		else {
 			c = data[7];
 		}
@@ -475,17 +617,41 @@ void BVH4::refit_node(int idx, bool leaf, BoundBox& bbox, uint& visibility)
 		                          BoundBox::empty,
 		                          BoundBox::empty};
 		uint child_visibility[4] = {0};
+		float child_sah[4] = {0.0f};
 		int num_nodes = 0;
 
+		if(depth < BVH_REFIT_TASK_DEPTH) {
+			/* Children write to separate nodes, refit them in parallel. */
+			TaskPool pool;
+			for(int i = 0; i < 4; ++i) {
+				if(c[i] != 0) {
+					pool.push(function_bind(&BVH4::refit_node_task, this,
+					                        (c[i] < 0)? -c[i]-1: c[i], (c[i] < 0),
+					                        &child_bbox[i], &child_visibility[i],
+					                        &child_sah[i], depth + 1));
+				}
+			}
+			pool.wait_work();
+		}
+		else {
+			for(int i = 0; i < 4; ++i) {
+				if(c[i] != 0) {
+					refit_node((c[i] < 0)? -c[i]-1: c[i], (c[i] < 0),
+					           child_bbox[i], child_visibility[i],
+					           child_sah[i], depth + 1);
+				}
+			}
+		}
+
 		for(int i = 0; i < 4; ++i) {
 			if(c[i] != 0) {
-				refit_node((c[i] < 0)? -c[i]-1: c[i], (c[i] < 0),
-				           child_bbox[i], child_visibility[i]);
 				++num_nodes;
 				bbox.grow(child_bbox[i]);
 				visibility |= child_visibility[i];
+				sah += child_sah[i];
 			}
 		}
+		sah += bbox.safe_area() * params.node_cost(num_nodes);
 
 		if(is_unaligned) {
 			Transform aligned_space[4] = {transform_identity(),
@@ -37,6 +37,7 @@ class Progress;
 #define BVH_QNODE_SIZE           8
 #define BVH_QNODE_LEAF_SIZE      1
 #define BVH_UNALIGNED_QNODE_SIZE 14
+#define BVH_QUANTIZED_QNODE_SIZE 5
 
 /* BVH4
  *
@@ -64,6 +65,16 @@ protected:
 	                       const float time_from,
 	                       const float time_to,
 	                       const int num);
+	void pack_quantized_node(int idx,
+	                         const BoundBox *bounds,
+	                         const int *child,
+	                         const uint visibility,
+	                         const float time_from,
+	                         const float time_to,
+	                         const int num);
+
+	/* Size of aligned inner nodes, depends on use_quantized_nodes. */
+	int aligned_node_size() const;
 
 	void pack_unaligned_inner(const BVHStackEntry& e,
 	                          const BVHStackEntry *en,
@@ -78,8 +89,9 @@ protected:
 	                         const int num);
 
 	/* refit */
-	void refit_nodes();
-	void refit_node(int idx, bool leaf, BoundBox& bbox, uint& visibility);
+	float refit_nodes();
+	void refit_node(int idx, bool leaf, BoundBox& bbox, uint& visibility, float& sah, int depth);
+	void refit_node_task(int idx, bool leaf, BoundBox *bbox, uint *visibility, float *sah, int depth);
 };
 
 CCL_NAMESPACE_END
@@ -0,0 +1,421 @@
+/*
+ * Adapted from code copyright 2009-2010 NVIDIA Corporation
+ * Modifications Copyright 2011-2017, Blender Foundation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bvh/bvh8.h"
+
+#include "render/mesh.h"
+#include "render/object.h"
+
+#include "bvh/bvh_node.h"
+
+#include "util/util_task.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Collapse the binary tree into up to eight children per node, by opening the
+ * inner child with the largest surface area until there are eight children or
+ * only leaves are left.
+ */
+static int obvh_collect_children(const BVHNode *node, const BVHNode *children[8])
+{
+	int num_children = 2;
+	children[0] = node->get_child(0);
+	children[1] = node->get_child(1);
+	while(num_children < 8) {
+		int best_child = -1;
+		float best_area = -FLT_MAX;
+		for(int i = 0; i < num_children; ++i) {
+			if(!children[i]->is_leaf()) {
+				const float area = children[i]->bounds.safe_area();
+				if(area > best_area) {
+					best_child = i;
+					best_area = area;
+				}
+			}
+		}
+		if(best_child == -1) {
+			break;
+		}
+		const BVHNode *child = children[best_child];
+		children[best_child] = child->get_child(0);
+		children[num_children++] = child->get_child(1);
+	}
+	return num_children;
+}
+
+static size_t obvh_count_inner_nodes(const BVHNode *node)
+{
+	if(node->is_leaf()) {
+		return 0;
+	}
+	const BVHNode *children[8];
+	const int num_children = obvh_collect_children(node, children);
+	size_t num_nodes = 1;
+	for(int i = 0; i < num_children; ++i) {
+		num_nodes += obvh_count_inner_nodes(children[i]);
+	}
+	return num_nodes;
+}
+
+BVH8::BVH8(const BVHParams& params_, const vector<Object*>& objects_)
+: BVH(params_, objects_)
+{
+	params.use_bvh8 = true;
+	/* Hair falls back to axis-aligned boxes. */
+	params.use_unaligned_nodes = false;
+	params.use_quantized_nodes = false;
+}
+
+void BVH8::pack_leaf(const BVHStackEntry& e, const LeafNode *leaf)
+{
+	float4 data[BVH_ONODE_LEAF_SIZE];
+	memset(data, 0, sizeof(data));
+	if(leaf->num_triangles() == 1 && pack.prim_index[leaf->lo] == -1) {
+		/* object */
+		data[0].x = __int_as_float(~(leaf->lo));
+		data[0].y = __int_as_float(0);
+	}
+	else {
+		/* triangle */
+		data[0].x = __int_as_float(leaf->lo);
+		data[0].y = __int_as_float(leaf->hi);
+	}
+	data[0].z = __uint_as_float(leaf->visibility);
+	if(leaf->num_triangles() != 0) {
+		data[0].w = __uint_as_float(pack.prim_type[leaf->lo]);
+	}
+
+	memcpy(&pack.leaf_nodes[e.idx], data, sizeof(float4)*BVH_ONODE_LEAF_SIZE);
+}
+
+void BVH8::pack_inner(const BVHStackEntry& e,
+                      const BVHStackEntry *en,
+                      int num)
+{
+	BoundBox bounds[8];
+	int child[8];
+	for(int i = 0; i < num; ++i) {
+		bounds[i] = en[i].node->bounds;
+		child[i] = en[i].encodeIdx();
+	}
+	pack_aligned_node(e.idx,
+	                  bounds,
+	                  child,
+	                  e.node->visibility,
+	                  e.node->time_from,
+	                  e.node->time_to,
+	                  num);
+}
+
+/* Aligned node layout:
+ *
+ *   [0]       visibility, time_from, time_to
+ *   [1..12]   min x, max x, min y, max y, min z, max z, each plane takes two
+ *             float4, the first for children 0-3 and the second for 4-7
+ *   [13..14]  child indices
+ *
+ * So the kernel fetches any plane of all children with one AVX load.
+ */
+void BVH8::pack_aligned_node(int idx,
+                             const BoundBox *bounds,
+                             const int *child,
+                             const uint visibility,
+                             const float time_from,
+                             const float time_to,
+                             const int num)
+{
+	float4 data[BVH_ONODE_SIZE];
+	memset(data, 0, sizeof(data));
+
+	data[0].x = __uint_as_float(visibility & ~PATH_RAY_NODE_UNALIGNED);
+	data[0].y = time_from;
+	data[0].z = time_to;
+
+	for(int i = 0; i < num; i++) {
+		float3 bb_min = bounds[i].min;
+		float3 bb_max = bounds[i].max;
+		const int half = i / 4, j = i % 4;
+
+		data[1 + half][j] = bb_min.x;
+		data[3 + half][j] = bb_max.x;
+		data[5 + half][j] = bb_min.y;
+		data[7 + half][j] = bb_max.y;
+		data[9 + half][j] = bb_min.z;
+		data[11 + half][j] = bb_max.z;
+
+		data[13 + half][j] = __int_as_float(child[i]);
+	}
+
+	for(int i = num; i < 8; i++) {
+		/* We store BB which would never be recorded as intersection
+		 * so kernel might safely assume there are always 8 child nodes.
+		 */
+		const int half = i / 4, j = i % 4;
+
+		data[1 + half][j] = FLT_MAX;
+		data[3 + half][j] = -FLT_MAX;
+
+		data[5 + half][j] = FLT_MAX;
+		data[7 + half][j] = -FLT_MAX;
+
+		data[9 + half][j] = FLT_MAX;
+		data[11 + half][j] = -FLT_MAX;
+
+		data[13 + half][j] = __int_as_float(0);
+	}
+
+	memcpy(&pack.nodes[idx], data, sizeof(float4)*BVH_ONODE_SIZE);
+}
+
+/* Octo SIMD Nodes */
+
+void BVH8::pack_nodes(const BVHNode *root)
+{
+	/* Calculate size of the arrays required. */
+	const size_t num_leaf_nodes = root->getSubtreeSize(BVH_STAT_LEAF_COUNT);
+	const size_t num_inner_nodes = obvh_count_inner_nodes(root);
+	const size_t node_size = num_inner_nodes * BVH_ONODE_SIZE;
+	/* Resize arrays. */
+	pack.nodes.clear();
+	pack.leaf_nodes.clear();
+	/* For top level BVH, first merge existing BVH's so we know the offsets. */
+	if(params.top_level) {
+		pack_instances(node_size, num_leaf_nodes*BVH_ONODE_LEAF_SIZE);
+	}
+	else {
+		pack.nodes.resize(node_size);
+		pack.leaf_nodes.resize(num_leaf_nodes*BVH_ONODE_LEAF_SIZE);
+	}
+
+	int nextNodeIdx = 0, nextLeafNodeIdx = 0;
+
+	vector<BVHStackEntry> stack;
+	stack.reserve(BVHParams::MAX_DEPTH*8);
+	if(root->is_leaf()) {
+		stack.push_back(BVHStackEntry(root, nextLeafNodeIdx++));
+	}
+	else {
+		stack.push_back(BVHStackEntry(root, nextNodeIdx));
+		nextNodeIdx += BVH_ONODE_SIZE;
+	}
+
+	while(stack.size()) {
+		BVHStackEntry e = stack.back();
+		stack.pop_back();
+
+		if(e.node->is_leaf()) {
+			/* leaf node */
+			const LeafNode *leaf = reinterpret_cast<const LeafNode*>(e.node);
+			pack_leaf(e, leaf);
+		}
+		else {
+			/* Inner node. */
+			const BVHNode *nodes[8];
+			const int numnodes = obvh_collect_children(e.node, nodes);
+			/* Push entries on the stack. */
+			for(int i = 0; i < numnodes; ++i) {
+				int idx;
+				if(nodes[i]->is_leaf()) {
+					idx = nextLeafNodeIdx++;
+				}
+				else {
+					idx = nextNodeIdx;
+					nextNodeIdx += BVH_ONODE_SIZE;
+				}
+				stack.push_back(BVHStackEntry(nodes[i], idx));
+			}
+			/* Set node. */
+			pack_inner(e, &stack[stack.size()-numnodes], numnodes);
+		}
+	}
+	assert(node_size == nextNodeIdx);
+	/* Root index to start traversal at, to handle case of single leaf node. */
+	pack.root_index = (root->is_leaf())? -1: 0;
+}
+
+/* Returns the SAH cost of the refitted tree. */
+float BVH8::refit_nodes()
+{
+	assert(!params.top_level);
+
+	BoundBox bbox = BoundBox::empty;
+	uint visibility = 0;
+	float sah = 0.0f;
+	refit_node(0, (pack.root_index == -1)? true: false, bbox, visibility, sah, 0);
+
+	return sah / bbox.safe_area();
+}
+
+void BVH8::refit_node_task(int idx, bool leaf, BoundBox *bbox, uint *visibility, float *sah, int depth)
+{
+	refit_node(idx, leaf, *bbox, *visibility, *sah, depth);
+}
+
+/* Bounds of the node are grown into bbox, its SAH cost (not normalized by the
+ * root area) is added to sah. */
+void BVH8::refit_node(int idx, bool leaf, BoundBox& bbox, uint& visibility, float& sah, int depth)
+{
+	if(leaf) {
+		int4 *data = &pack.leaf_nodes[idx];
+		int4 c = data[0];
+		/* Refit leaf node. */
+		for(int prim = c.x; prim < c.y; prim++) {
+			int pidx = pack.prim_index[prim];
+			int tob = pack.prim_object[prim];
+			Object *ob = objects[tob];
+
+			if(pidx == -1) {
+				/* Object instance. */
+				bbox.grow(ob->bounds);
+			}
+			else {
+				/* Primitives. */
+				const Mesh *mesh = ob->mesh;
+
+				if(pack.prim_type[prim] & PRIMITIVE_ALL_CURVE) {
+					/* Curves. */
+					int str_offset = (params.top_level)? mesh->curve_offset: 0;
+					Mesh::Curve curve = mesh->get_curve(pidx - str_offset);
+					int k = PRIMITIVE_UNPACK_SEGMENT(pack.prim_type[prim]);
+
+					curve.bounds_grow(k, &mesh->curve_keys[0], &mesh->curve_radius[0], bbox);
+
+					visibility |= PATH_RAY_CURVE;
+
+					/* Motion curves. */
+					if(mesh->use_motion_blur) {
+						Attribute *attr = mesh->curve_attributes.find(ATTR_STD_MOTION_VERTEX_POSITION);
+
+						if(attr) {
+							size_t mesh_size = mesh->curve_keys.size();
+							size_t steps = mesh->motion_steps - 1;
+							float3 *key_steps = attr->data_float3();
+
+							for(size_t i = 0; i < steps; i++)
+								curve.bounds_grow(k, key_steps + i*mesh_size, &mesh->curve_radius[0], bbox);
+						}
+					}
+				}
+				else {
+					/* Triangles. */
+					int tri_offset = (params.top_level)? mesh->tri_offset: 0;
+					Mesh::Triangle triangle = mesh->get_triangle(pidx - tri_offset);
+					const float3 *vpos = &mesh->verts[0];
+
+					triangle.bounds_grow(vpos, bbox);
+
+					/* Motion triangles. */
+					if(mesh->use_motion_blur) {
+						Attribute *attr = mesh->attributes.find(ATTR_STD_MOTION_VERTEX_POSITION);
+
+						if(attr) {
+							size_t mesh_size = mesh->verts.size();
+							size_t steps = mesh->motion_steps - 1;
+							float3 *vert_steps = attr->data_float3();
+
+							for(size_t i = 0; i < steps; i++)
+								triangle.bounds_grow(vert_steps + i*mesh_size, bbox);
+						}
+					}
+				}
+			}
+
+			visibility |= ob->visibility;
+		}
+
+		/* TODO(sergey): This is actually a copy of pack_leaf(),
+		 * but this chunk of code only knows actual data and has
+		 * no idea about BVHNode.
+		 *
+		 * Would be nice to de-duplicate code, but trying to make
+		 * making code more general ends up in much nastier code
+		 * in my opinion so far.
+		 *
+		 * Same applies to the inner nodes case below.
+		 */
+		float4 leaf_data[BVH_ONODE_LEAF_SIZE];
+		leaf_data[0].x = __int_as_float(c.x);
+		leaf_data[0].y = __int_as_float(c.y);
+		leaf_data[0].z = __uint_as_float(visibility);
+		leaf_data[0].w = __uint_as_float(c.w);
+		memcpy(&pack.leaf_nodes[idx], leaf_data, sizeof(float4)*BVH_ONODE_LEAF_SIZE);
+
+		sah += bbox.safe_area() * params.primitive_cost(c.y - c.x);
+	}
+	else {
+		int4 *data = &pack.nodes[idx];
+		int c[8];
+		for(int i = 0; i < 8; ++i) {
+			c[i] = data[13 + i/4][i%4];
+		}
+		/* Refit inner node, set bbox from children. */
+		BoundBox child_bbox[8] = {BoundBox::empty,
+		                          BoundBox::empty,
+		                          BoundBox::empty,
+		                          BoundBox::empty,
+		                          BoundBox::empty,
+		                          BoundBox::empty,
+		                          BoundBox::empty,
+		                          BoundBox::empty};
+		uint child_visibility[8] = {0};
+		float child_sah[8] = {0.0f};
+		int num_nodes = 0;
+
+		if(depth < BVH_REFIT_TASK_DEPTH) {
+			/* Children write to separate nodes, refit them in parallel. */
+			TaskPool pool;
+			for(int i = 0; i < 8; ++i) {
+				if(c[i] != 0) {
+					pool.push(function_bind(&BVH8::refit_node_task, this,
+					                        (c[i] < 0)? -c[i]-1: c[i], (c[i] < 0),
+					                        &child_bbox[i], &child_visibility[i],
+					                        &child_sah[i], depth + 1));
+				}
+			}
+			pool.wait_work();
+		}
+		else {
+			for(int i = 0; i < 8; ++i) {
+				if(c[i] != 0) {
+					refit_node((c[i] < 0)? -c[i]-1: c[i], (c[i] < 0),
+					           child_bbox[i], child_visibility[i],
+					           child_sah[i], depth + 1);
+				}
+			}
+		}
+
+		for(int i = 0; i < 8; ++i) {
+			if(c[i] != 0) {
+				++num_nodes;
+				bbox.grow(child_bbox[i]);
+				visibility |= child_visibility[i];
+				sah += child_sah[i];
+			}
+		}
+		sah += bbox.safe_area() * params.node_cost(num_nodes);
+
+		pack_aligned_node(idx,
+		                  child_bbox,
+		                  c,
+		                  visibility,
+		                  0.0f,
+		                  1.0f,
+		                  8);
+	}
+}
+
+CCL_NAMESPACE_END
@@ -23,7 +23,9 @@
 
 #include "util/util_algorithm.h"
 #include "util/util_boundbox.h"
+#include "util/util_task.h"
 #include "util/util_types.h"
+#include "util/util_vector.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -39,6 +41,13 @@ template<size_t src> __forceinline float extract(const int4& b)
 template<size_t dst> __forceinline const float4 insert(const float4& a, const float b)
 { float4 r = a; r[dst] = b; return r; }
 
+static void split_copy_chunk(BVHReference *dst, const BVHReference *src, size_t size)
+{
+	for(size_t i = 0; i < size; i++) {
+		dst[i] = src[i];
+	}
+}
+
 __forceinline int get_best_dimension(const float4& bestSAH)
 {
 	// return (int)__bsf(movemask(reduce_min(bestSAH) == bestSAH));
@@ -82,57 +91,40 @@ BVHObjectBinning::BVHObjectBinning(const BVHRange& job,
 	num_bins = min(size_t(MAX_BINS), size_t(4.0f + 0.05f*size()));
 	scale = rcp(cent_bounds_.size()) * make_float3((float)num_bins);
 
-	/* initialize binning counter and bounds */
-	BoundBox bin_bounds[MAX_BINS][4];	/* bounds for every bin in every dimension */
-	int4 bin_count[MAX_BINS];			/* number of primitives mapped to bin */
+	/* map geometry to bins */
+	BinData bins;
 
-	for(size_t i = 0; i < num_bins; i++) {
-		bin_count[i] = make_int4(0);
-		bin_bounds[i][0] = bin_bounds[i][1] = bin_bounds[i][2] = BoundBox::empty;
+	if(size() < PARALLEL_SIZE) {
+		bin_range(prims, start(), end(), &bins);
 	}
-
-	/* map geometry to bins, unrolled once */
-	{
-		ssize_t i;
-
-		for(i = 0; i < ssize_t(size()) - 1; i += 2) {
-			prefetch_L2(&prims[start() + i + 8]);
-
-			/* map even and odd primitive to bin */
-			const BVHReference& prim0 = prims[start() + i + 0];
-			const BVHReference& prim1 = prims[start() + i + 1];
-
-			BoundBox bounds0 = get_prim_bounds(prim0);
-			BoundBox bounds1 = get_prim_bounds(prim1);
-
-			int4 bin0 = get_bin(bounds0);
-			int4 bin1 = get_bin(bounds1);
-
-			/* increase bounds for bins for even primitive */
-			int b00 = (int)extract<0>(bin0); bin_count[b00][0]++; bin_bounds[b00][0].grow(bounds0);
-			int b01 = (int)extract<1>(bin0); bin_count[b01][1]++; bin_bounds[b01][1].grow(bounds0);
-			int b02 = (int)extract<2>(bin0); bin_count[b02][2]++; bin_bounds[b02][2].grow(bounds0);
-
-			/* increase bounds of bins for odd primitive */
-			int b10 = (int)extract<0>(bin1); bin_count[b10][0]++; bin_bounds[b10][0].grow(bounds1);
-			int b11 = (int)extract<1>(bin1); bin_count[b11][1]++; bin_bounds[b11][1].grow(bounds1);
-			int b12 = (int)extract<2>(bin1); bin_count[b12][2]++; bin_bounds[b12][2].grow(bounds1);
+	else {
+		const size_t num_chunks = (size() + PARALLEL_CHUNK_SIZE - 1) / PARALLEL_CHUNK_SIZE;
+		vector<BinData> chunk_bins(num_chunks);
+		TaskPool pool;
+
+		for(size_t c = 0; c < num_chunks; c++) {
+			const size_t chunk_start = start() + c*PARALLEL_CHUNK_SIZE;
+			const size_t chunk_end = min(chunk_start + PARALLEL_CHUNK_SIZE, (size_t)end());
+			pool.push(function_bind(&BVHObjectBinning::bin_range, this,
+			                        prims, chunk_start, chunk_end, &chunk_bins[c]));
 		}
-
-		/* for uneven number of primitives */
-		if(i < ssize_t(size())) {
-			/* map primitive to bin */
-			const BVHReference& prim0 = prims[start() + i];
-			BoundBox bounds0 = get_prim_bounds(prim0);
-			int4 bin0 = get_bin(bounds0);
-
-			/* increase bounds of bins */
-			int b00 = (int)extract<0>(bin0); bin_count[b00][0]++; bin_bounds[b00][0].grow(bounds0);
-			int b01 = (int)extract<1>(bin0); bin_count[b01][1]++; bin_bounds[b01][1].grow(bounds0);
-			int b02 = (int)extract<2>(bin0); bin_count[b02][2]++; bin_bounds[b02][2].grow(bounds0);
+		pool.wait_work();
+
+		/* merge bins of all chunks */
+		bins = chunk_bins[0];
+		for(size_t c = 1; c < num_chunks; c++) {
+			for(size_t i = 0; i < num_bins; i++) {
+				bins.count[i] = bins.count[i] + chunk_bins[c].count[i];
+				for(int d = 0; d < 3; d++) {
+					bins.bounds[i][d].grow(chunk_bins[c].bounds[i][d]);
+				}
+			}
 		}
 	}
 
+	BoundBox (&bin_bounds)[MAX_BINS][4] = bins.bounds;
+	const int4 *bin_count = bins.count;
+
 	/* sweep from right to left and compute parallel prefix of merged bounds */
 	float4 r_area[MAX_BINS];	/* area of bounds of primitives on the right */
 	float4 r_count[MAX_BINS];	/* number of primitives on the right */
@@ -188,6 +180,63 @@ BVHObjectBinning::BVHObjectBinning(const BVHRange& job,
 	leafSAH = bounds_.half_area() * blocks(size());
 }
 
+void BVHObjectBinning::bin_range(const BVHReference *prims,
+                                 size_t begin,
+                                 size_t end,
+                                 BinData *data) const
+{
+	/* initialize binning counter and bounds */
+	BoundBox (&bin_bounds)[MAX_BINS][4] = data->bounds;	/* bounds for every bin in every dimension */
+	int4 *bin_count = data->count;						/* number of primitives mapped to bin */
+
+	for(size_t i = 0; i < num_bins; i++) {
+		bin_count[i] = make_int4(0);
+		bin_bounds[i][0] = bin_bounds[i][1] = bin_bounds[i][2] = BoundBox::empty;
+	}
+
+	/* map geometry to bins, unrolled once */
+	{
+		ssize_t i;
+
+		for(i = begin; i < ssize_t(end) - 1; i += 2) {
+			prefetch_L2(&prims[i + 8]);
+
+			/* map even and odd primitive to bin */
+			const BVHReference& prim0 = prims[i + 0];
+			const BVHReference& prim1 = prims[i + 1];
+
+			BoundBox bounds0 = get_prim_bounds(prim0);
+			BoundBox bounds1 = get_prim_bounds(prim1);
+
+			int4 bin0 = get_bin(bounds0);
+			int4 bin1 = get_bin(bounds1);
+
+			/* increase bounds for bins for even primitive */
+			int b00 = (int)extract<0>(bin0); bin_count[b00][0]++; bin_bounds[b00][0].grow(bounds0);
+			int b01 = (int)extract<1>(bin0); bin_count[b01][1]++; bin_bounds[b01][1].grow(bounds0);
+			int b02 = (int)extract<2>(bin0); bin_count[b02][2]++; bin_bounds[b02][2].grow(bounds0);
+
+			/* increase bounds of bins for odd primitive */
+			int b10 = (int)extract<0>(bin1); bin_count[b10][0]++; bin_bounds[b10][0].grow(bounds1);
+			int b11 = (int)extract<1>(bin1); bin_count[b11][1]++; bin_bounds[b11][1].grow(bounds1);
+			int b12 = (int)extract<2>(bin1); bin_count[b12][2]++; bin_bounds[b12][2].grow(bounds1);
+		}
+
+		/* for uneven number of primitives */
+		if(i < ssize_t(end)) {
+			/* map primitive to bin */
+			const BVHReference& prim0 = prims[i];
+			BoundBox bounds0 = get_prim_bounds(prim0);
+			int4 bin0 = get_bin(bounds0);
+
+			/* increase bounds of bins */
+			int b00 = (int)extract<0>(bin0); bin_count[b00][0]++; bin_bounds[b00][0].grow(bounds0);
+			int b01 = (int)extract<1>(bin0); bin_count[b01][1]++; bin_bounds[b01][1].grow(bounds0);
+			int b02 = (int)extract<2>(bin0); bin_count[b02][2]++; bin_bounds[b02][2].grow(bounds0);
+		}
+	}
+}
+
 void BVHObjectBinning::split(BVHReference* prims,
                              BVHObjectBinning& left_o,
                              BVHObjectBinning& right_o) const
@@ -199,34 +248,41 @@ void BVHObjectBinning::split(BVHReference* prims,
 	BoundBox lcent_bounds = BoundBox::empty;
 	BoundBox rcent_bounds = BoundBox::empty;
 
-	ssize_t l = 0, r = N-1;
-
-	while(l <= r) {
-		prefetch_L2(&prims[start() + l + 8]);
-		prefetch_L2(&prims[start() + r - 8]);
-
-		BVHReference prim = prims[start() + l];
-		BoundBox unaligned_bounds = get_prim_bounds(prim);
-		float3 unaligned_center = unaligned_bounds.center2();
-		float3 center = prim.bounds().center2();
-
-		if(get_bin(unaligned_center)[dim] < pos) {
-			lgeom_bounds.grow(prim.bounds());
-			lcent_bounds.grow(center);
-			l++;
-		}
-		else {
-			rgeom_bounds.grow(prim.bounds());
-			rcent_bounds.grow(center);
-			swap(prims[start()+l],prims[start()+r]);
-			r--;
+	if(N >= PARALLEL_SIZE) {
+		if(split_parallel(prims, left_o, right_o)) {
+			return;
 		}
 	}
-	/* finish */
-	if(l != 0 && N-1-r != 0) {
-		right_o = BVHObjectBinning(BVHRange(rgeom_bounds, rcent_bounds, start() + l, N-1-r), prims);
-		left_o  = BVHObjectBinning(BVHRange(lgeom_bounds, lcent_bounds, start(), l), prims);
-		return;
+	else {
+		ssize_t l = 0, r = N-1;
+
+		while(l <= r) {
+			prefetch_L2(&prims[start() + l + 8]);
+			prefetch_L2(&prims[start() + r - 8]);
+
+			BVHReference prim = prims[start() + l];
+			BoundBox unaligned_bounds = get_prim_bounds(prim);
+			float3 unaligned_center = unaligned_bounds.center2();
+			float3 center = prim.bounds().center2();
+
+			if(get_bin(unaligned_center)[dim] < pos) {
+				lgeom_bounds.grow(prim.bounds());
+				lcent_bounds.grow(center);
+				l++;
+			}
+			else {
+				rgeom_bounds.grow(prim.bounds());
+				rcent_bounds.grow(center);
+				swap(prims[start()+l],prims[start()+r]);
+				r--;
+			}
+		}
+		/* finish */
+		if(l != 0 && N-1-r != 0) {
+			right_o = BVHObjectBinning(BVHRange(rgeom_bounds, rcent_bounds, start() + l, N-1-r), prims);
+			left_o  = BVHObjectBinning(BVHRange(lgeom_bounds, lcent_bounds, start(), l), prims);
+			return;
+		}
 	}
 
 	/* object medium split if we did not make progress, can happen when all
@@ -250,5 +306,131 @@ void BVHObjectBinning::split(BVHReference* prims,
 	left_o  = BVHObjectBinning(BVHRange(lgeom_bounds, lcent_bounds, start(), N/2), prims);
 }
 
-CCL_NAMESPACE_END
+/* Parallel split, classifies the primitives of every chunk and then scatters
+ * them to their side through a temporary copy. Unlike the in place swapping of
+ * the serial split the relative order of primitives on each side is kept.
+ * Returns false when all primitives end up on one side. */
+bool BVHObjectBinning::split_parallel(BVHReference *prims,
+                                      BVHObjectBinning& left_o,
+                                      BVHObjectBinning& right_o) const
+{
+	const size_t N = size();
+	const size_t num_chunks = (N + PARALLEL_CHUNK_SIZE - 1) / PARALLEL_CHUNK_SIZE;
+	vector<SplitChunk> chunks(num_chunks);
+	vector<uchar> side(N);
+
+	TaskPool pool;
+	for(size_t c = 0; c < num_chunks; c++) {
+		const size_t chunk_start = start() + c*PARALLEL_CHUNK_SIZE;
+		const size_t chunk_end = min(chunk_start + PARALLEL_CHUNK_SIZE, (size_t)end());
+		pool.push(function_bind(&BVHObjectBinning::split_classify, this,
+		                        prims, chunk_start, chunk_end,
+		                        &side[chunk_start - start()], &chunks[c]));
+	}
+	pool.wait_work();
 
+	/* prefix sum of the chunk sizes on each side */
+	size_t num_left = 0;
+	for(size_t c = 0; c < num_chunks; c++) {
+		chunks[c].left_offset = num_left;
+		num_left += chunks[c].num_left;
+	}
+
+	if(num_left == 0 || num_left == N) {
+		return false;
+	}
+
+	BoundBox lgeom_bounds = BoundBox::empty;
+	BoundBox rgeom_bounds = BoundBox::empty;
+	BoundBox lcent_bounds = BoundBox::empty;
+	BoundBox rcent_bounds = BoundBox::empty;
+
+	size_t num_right = 0;
+	for(size_t c = 0; c < num_chunks; c++) {
+		const size_t chunk_size = min((size_t)PARALLEL_CHUNK_SIZE, N - c*PARALLEL_CHUNK_SIZE);
+		chunks[c].right_offset = num_left + num_right;
+		num_right += chunk_size - chunks[c].num_left;
+
+		lgeom_bounds.grow(chunks[c].lgeom_bounds);
+		rgeom_bounds.grow(chunks[c].rgeom_bounds);
+		lcent_bounds.grow(chunks[c].lcent_bounds);
+		rcent_bounds.grow(chunks[c].rcent_bounds);
+	}
+
+	vector<BVHReference> sorted(N);
+	for(size_t c = 0; c < num_chunks; c++) {
+		const size_t chunk_start = start() + c*PARALLEL_CHUNK_SIZE;
+		const size_t chunk_end = min(chunk_start + PARALLEL_CHUNK_SIZE, (size_t)end());
+		pool.push(function_bind(&BVHObjectBinning::split_scatter, this,
+		                        prims, chunk_start, chunk_end,
+		                        &side[chunk_start - start()], &chunks[c], &sorted[0]));
+	}
+	pool.wait_work();
+
+	for(size_t c = 0; c < num_chunks; c++) {
+		const size_t chunk_offset = c*PARALLEL_CHUNK_SIZE;
+		const size_t chunk_size = min((size_t)PARALLEL_CHUNK_SIZE, N - chunk_offset);
+		pool.push(function_bind(&split_copy_chunk,
+		                        prims + start() + chunk_offset,
+		                        &sorted[chunk_offset],
+		                        chunk_size));
+	}
+	pool.wait_work();
+
+	right_o = BVHObjectBinning(BVHRange(rgeom_bounds, rcent_bounds, start() + num_left, N - num_left), prims);
+	left_o  = BVHObjectBinning(BVHRange(lgeom_bounds, lcent_bounds, start(), num_left), prims);
+
+	return true;
+}
+
+void BVHObjectBinning::split_classify(const BVHReference *prims,
+                                      size_t begin,
+                                      size_t end,
+                                      uchar *side,
+                                      SplitChunk *chunk) const
+{
+	chunk->lgeom_bounds = chunk->rgeom_bounds = BoundBox::empty;
+	chunk->lcent_bounds = chunk->rcent_bounds = BoundBox::empty;
+	chunk->num_left = 0;
+
+	for(size_t i = begin; i < end; i++) {
+		const BVHReference& prim = prims[i];
+		BoundBox unaligned_bounds = get_prim_bounds(prim);
+		float3 unaligned_center = unaligned_bounds.center2();
+		float3 center = prim.bounds().center2();
+
+		if(get_bin(unaligned_center)[dim] < pos) {
+			chunk->lgeom_bounds.grow(prim.bounds());
+			chunk->lcent_bounds.grow(center);
+			chunk->num_left++;
+			side[i - begin] = 0;
+		}
+		else {
+			chunk->rgeom_bounds.grow(prim.bounds());
+			chunk->rcent_bounds.grow(center);
+			side[i - begin] = 1;
+		}
+	}
+}
+
+void BVHObjectBinning::split_scatter(const BVHReference *prims,
+                                     size_t begin,
+                                     size_t end,
+                                     const uchar *side,
+                                     const SplitChunk *chunk,
+                                     BVHReference *dst) const
+{
+	size_t l = chunk->left_offset;
+	size_t r = chunk->right_offset;
+
+	for(size_t i = begin; i < end; i++) {
+		if(side[i - begin] == 0) {
+			dst[l++] = prims[i];
+		}
+		else {
+			dst[r++] = prims[i];
+		}
+	}
+}
+
+CCL_NAMESPACE_END
@@ -27,12 +27,16 @@ CCL_NAMESPACE_BEGIN
 
 class BVHBuild;
 
-/* Single threaded object binner. Finds the split with the best SAH heuristic
+/* Object binner. Finds the split with the best SAH heuristic
  * by testing for each dimension multiple partitionings for regular spaced
  * partition locations. A partitioning for a partition location is computed,
  * by putting primitives whose centroid is on the left and right of the split
  * location to different sets. The SAH is evaluated by computing the number of
- * blocks occupied by the primitives in the partitions. */
+ * blocks occupied by the primitives in the partitions.
+ *
+ * Large ranges, found at the top levels of the tree where the build is not
+ * yet split into threaded subtrees, are binned and partitioned in parallel
+ * over fixed size chunks of primitives. */
 
 class BVHObjectBinning : public BVHRange
 {
@@ -69,6 +73,45 @@ protected:
 	enum { MAX_BINS = 32 };
 	enum { LOG_BLOCK_SIZE = 2 };
 
+	/* Ranges at least this big are binned and split in parallel. Chunks have
+	 * a fixed size so the resulting tree does not depend on the thread count. */
+	enum { PARALLEL_SIZE = 65536 };
+	enum { PARALLEL_CHUNK_SIZE = 16384 };
+
+	/* Per bin bounds and primitive count in every dimension. */
+	struct BinData {
+		BoundBox bounds[MAX_BINS][4];
+		int4 count[MAX_BINS];
+	};
+
+	/* Partitioning of one chunk during a parallel split. */
+	struct SplitChunk {
+		BoundBox lgeom_bounds, rgeom_bounds;
+		BoundBox lcent_bounds, rcent_bounds;
+		size_t num_left;
+		size_t left_offset, right_offset;
+	};
+
+	void bin_range(const BVHReference *prims,
+	               size_t begin,
+	               size_t end,
+	               BinData *data) const;
+
+	bool split_parallel(BVHReference *prims,
+	                    BVHObjectBinning& left_o,
+	                    BVHObjectBinning& right_o) const;
+	void split_classify(const BVHReference *prims,
+	                    size_t begin,
+	                    size_t end,
+	                    uchar *side,
+	                    SplitChunk *chunk) const;
+	void split_scatter(const BVHReference *prims,
+	                   size_t begin,
+	                   size_t end,
+	                   const uchar *side,
+	                   const SplitChunk *chunk,
+	                   BVHReference *dst) const;
+
 	/* computes the bin numbers for each dimension for a box. */
 	__forceinline int4 get_bin(const BoundBox& box) const
 	{
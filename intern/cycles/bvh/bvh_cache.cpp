@@ -0,0 +1,281 @@
+/*
+ * Copyright 2011-2017 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bvh/bvh_cache.h"
+
+#include "bvh/bvh.h"
+#include "bvh/bvh_params.h"
+
+#include "render/attribute.h"
+#include "render/mesh.h"
+#include "render/object.h"
+
+#include "util/util_foreach.h"
+#include "util/util_logging.h"
+#include "util/util_md5.h"
+#include "util/util_path.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Bump when the packed layout or anything the build depends on changes. */
+#define BVH_CACHE_VERSION 1
+
+static const char bvh_cache_magic[8] = {'C', 'Y', 'C', 'L', 'B', 'V', 'H', '\0'};
+
+/* Key */
+
+template<typename T>
+static void bvh_cache_hash(MD5Hash& md5, const T& value)
+{
+	md5.append((const uint8_t*)&value, sizeof(T));
+}
+
+static void bvh_cache_hash_data(MD5Hash& md5, const void *data, size_t size)
+{
+	bvh_cache_hash(md5, size);
+
+	/* MD5Hash takes int sizes */
+	const uint8_t *bytes = (const uint8_t*)data;
+	while(size > 0) {
+		int chunk = (int)min(size, (size_t)(1 << 30));
+		md5.append(bytes, chunk);
+		bytes += chunk;
+		size -= chunk;
+	}
+}
+
+template<typename T>
+static void bvh_cache_hash_array(MD5Hash& md5, const array<T>& data)
+{
+	bvh_cache_hash_data(md5, data.data(), data.size()*sizeof(T));
+}
+
+static void bvh_cache_hash_mesh(MD5Hash& md5, const Mesh *mesh)
+{
+	bvh_cache_hash_array(md5, mesh->verts);
+	bvh_cache_hash_array(md5, mesh->triangles);
+	bvh_cache_hash_array(md5, mesh->curve_keys);
+	bvh_cache_hash_array(md5, mesh->curve_radius);
+	bvh_cache_hash_array(md5, mesh->curve_first_key);
+
+	bvh_cache_hash(md5, mesh->transform_applied);
+	bvh_cache_hash(md5, mesh->use_motion_blur);
+	bvh_cache_hash(md5, mesh->motion_steps);
+	bvh_cache_hash(md5, mesh->is_instanced());
+
+	bvh_cache_hash(md5, mesh->tri_offset);
+	bvh_cache_hash(md5, mesh->vert_offset);
+	bvh_cache_hash(md5, mesh->curve_offset);
+	bvh_cache_hash(md5, mesh->curvekey_offset);
+
+	const Attribute *attr_mP = mesh->attributes.find(ATTR_STD_MOTION_VERTEX_POSITION);
+	const Attribute *attr_mK = mesh->curve_attributes.find(ATTR_STD_MOTION_VERTEX_POSITION);
+
+	bvh_cache_hash_data(md5, attr_mP? attr_mP->data(): NULL, attr_mP? attr_mP->buffer.size(): 0);
+	bvh_cache_hash_data(md5, attr_mK? attr_mK->data(): NULL, attr_mK? attr_mK->buffer.size(): 0);
+}
+
+string bvh_cache_key(const BVHParams& params, const vector<Object*>& objects)
+{
+	MD5Hash md5;
+
+	bvh_cache_hash(md5, BVH_CACHE_VERSION);
+
+	bvh_cache_hash(md5, params.use_spatial_split);
+	bvh_cache_hash(md5, params.spatial_split_alpha);
+	bvh_cache_hash(md5, params.unaligned_split_threshold);
+	bvh_cache_hash(md5, params.sah_node_cost);
+	bvh_cache_hash(md5, params.sah_primitive_cost);
+	bvh_cache_hash(md5, params.min_leaf_size);
+	bvh_cache_hash(md5, params.max_triangle_leaf_size);
+	bvh_cache_hash(md5, params.max_motion_triangle_leaf_size);
+	bvh_cache_hash(md5, params.max_curve_leaf_size);
+	bvh_cache_hash(md5, params.max_motion_curve_leaf_size);
+	bvh_cache_hash(md5, params.top_level);
+	bvh_cache_hash(md5, params.use_qbvh);
+	bvh_cache_hash(md5, params.use_quantized_nodes);
+	bvh_cache_hash(md5, params.use_bvh8);
+	bvh_cache_hash(md5, params.primitive_mask);
+	bvh_cache_hash(md5, params.use_unaligned_nodes);
+	bvh_cache_hash(md5, params.num_motion_curve_steps);
+	bvh_cache_hash(md5, params.num_motion_triangle_steps);
+
+	bvh_cache_hash(md5, objects.size());
+
+	foreach(const Object *ob, objects) {
+		bvh_cache_hash(md5, ob->tfm);
+		bvh_cache_hash(md5, ob->motion);
+		bvh_cache_hash(md5, ob->use_motion);
+		bvh_cache_hash(md5, ob->visibility);
+		bvh_cache_hash(md5, ob->bounds.min);
+		bvh_cache_hash(md5, ob->bounds.max);
+
+		bvh_cache_hash_mesh(md5, ob->mesh);
+	}
+
+	return md5.get_hex();
+}
+
+/* Read and Write */
+
+static string bvh_cache_filepath(const string& key)
+{
+	return path_cache_get(path_join("bvh", key + ".bin"));
+}
+
+template<typename T>
+static void bvh_cache_write_value(vector<uint8_t>& data, const T& value)
+{
+	const uint8_t *bytes = (const uint8_t*)&value;
+	data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+template<typename T>
+static void bvh_cache_write_array(vector<uint8_t>& data, const array<T>& values)
+{
+	bvh_cache_write_value(data, (uint64_t)values.size());
+
+	if(values.size()) {
+		const uint8_t *bytes = (const uint8_t*)values.data();
+		data.insert(data.end(), bytes, bytes + values.size()*sizeof(T));
+	}
+}
+
+template<typename T>
+static bool bvh_cache_read_value(const vector<uint8_t>& data, size_t& offset, T& value)
+{
+	if(offset + sizeof(T) > data.size()) {
+		return false;
+	}
+
+	memcpy(&value, &data[offset], sizeof(T));
+	offset += sizeof(T);
+	return true;
+}
+
+template<typename T>
+static bool bvh_cache_read_array(const vector<uint8_t>& data, size_t& offset, array<T>& values)
+{
+	uint64_t size;
+	if(!bvh_cache_read_value(data, offset, size) ||
+	   size > (data.size() - offset)/sizeof(T))
+	{
+		return false;
+	}
+
+	values.resize(size);
+	if(size) {
+		memcpy(values.data(), &data[offset], size*sizeof(T));
+		offset += size*sizeof(T);
+	}
+	return true;
+}
+
+bool bvh_cache_read(const string& key, PackedBVH& pack)
+{
+	string filepath = bvh_cache_filepath(key);
+	vector<uint8_t> data;
+
+	if(!path_exists(filepath) || !path_read_binary(filepath, data)) {
+		return false;
+	}
+
+	/* files written partially or by another build fail these checks and
+	 * are simply built again */
+	size_t offset = 0;
+	char magic[sizeof(bvh_cache_magic)];
+	uint64_t file_size;
+
+	if(!bvh_cache_read_value(data, offset, magic) ||
+	   memcmp(magic, bvh_cache_magic, sizeof(magic)) != 0 ||
+	   !bvh_cache_read_value(data, offset, file_size) ||
+	   file_size != data.size())
+	{
+		VLOG(1) << "Ignoring invalid BVH cache file " << filepath << ".";
+		return false;
+	}
+
+	PackedBVH cached;
+
+	if(!bvh_cache_read_value(data, offset, cached.root_index) ||
+	   !bvh_cache_read_array(data, offset, cached.nodes) ||
+	   !bvh_cache_read_array(data, offset, cached.leaf_nodes) ||
+	   !bvh_cache_read_array(data, offset, cached.object_node) ||
+	   !bvh_cache_read_array(data, offset, cached.prim_tri_index) ||
+	   !bvh_cache_read_array(data, offset, cached.prim_tri_verts) ||
+	   !bvh_cache_read_array(data, offset, cached.prim_type) ||
+	   !bvh_cache_read_array(data, offset, cached.prim_visibility) ||
+	   !bvh_cache_read_array(data, offset, cached.prim_index) ||
+	   !bvh_cache_read_array(data, offset, cached.prim_object) ||
+	   !bvh_cache_read_array(data, offset, cached.prim_time))
+	{
+		VLOG(1) << "Ignoring truncated BVH cache file " << filepath << ".";
+		return false;
+	}
+
+	pack.root_index = cached.root_index;
+	pack.nodes.steal_data(cached.nodes);
+	pack.leaf_nodes.steal_data(cached.leaf_nodes);
+	pack.object_node.steal_data(cached.object_node);
+	pack.prim_tri_index.steal_data(cached.prim_tri_index);
+	pack.prim_tri_verts.steal_data(cached.prim_tri_verts);
+	pack.prim_type.steal_data(cached.prim_type);
+	pack.prim_visibility.steal_data(cached.prim_visibility);
+	pack.prim_index.steal_data(cached.prim_index);
+	pack.prim_object.steal_data(cached.prim_object);
+	pack.prim_time.steal_data(cached.prim_time);
+
+	VLOG(1) << "Loaded BVH from cache file " << filepath << ".";
+
+	return true;
+}
+
+bool bvh_cache_write(const string& key, const PackedBVH& pack)
+{
+	vector<uint8_t> data;
+
+	data.insert(data.end(), bvh_cache_magic, bvh_cache_magic + sizeof(bvh_cache_magic));
+	size_t file_size_offset = data.size();
+	bvh_cache_write_value(data, (uint64_t)0);
+
+	bvh_cache_write_value(data, pack.root_index);
+	bvh_cache_write_array(data, pack.nodes);
+	bvh_cache_write_array(data, pack.leaf_nodes);
+	bvh_cache_write_array(data, pack.object_node);
+	bvh_cache_write_array(data, pack.prim_tri_index);
+	bvh_cache_write_array(data, pack.prim_tri_verts);
+	bvh_cache_write_array(data, pack.prim_type);
+	bvh_cache_write_array(data, pack.prim_visibility);
+	bvh_cache_write_array(data, pack.prim_index);
+	bvh_cache_write_array(data, pack.prim_object);
+	bvh_cache_write_array(data, pack.prim_time);
+
+	uint64_t file_size = data.size();
+	memcpy(&data[file_size_offset], &file_size, sizeof(file_size));
+
+	string filepath = bvh_cache_filepath(key);
+
+	if(!path_write_binary(filepath, data)) {
+		VLOG(1) << "Failed to write BVH cache file " << filepath << ".";
+		return false;
+	}
+
+	VLOG(1) << "Written BVH to cache file " << filepath << ".";
+
+	return true;
+}
+
+CCL_NAMESPACE_END
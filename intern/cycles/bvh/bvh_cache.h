@@ -0,0 +1,41 @@
+/*
+ * Copyright 2011-2017 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __BVH_CACHE_H__
+#define __BVH_CACHE_H__
+
+#include "util/util_string.h"
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+class BVHParams;
+class Object;
+struct PackedBVH;
+
+/* BVH Cache
+ *
+ * Packed BVHs stored on disk, so renders of geometry which did not change
+ * since a previous render skip the build. Entries are keyed by a hash of the
+ * build parameters and of all object and mesh data read by the build. */
+
+string bvh_cache_key(const BVHParams& params, const vector<Object*>& objects);
+bool bvh_cache_read(const string& key, PackedBVH& pack);
+bool bvh_cache_write(const string& key, const PackedBVH& pack);
+
+CCL_NAMESPACE_END
+
+#endif /* __BVH_CACHE_H__ */
@@ -40,6 +40,9 @@ public:
 	float sah_node_cost;
 	float sah_primitive_cost;
 
+	/* Refitted BVH is rebuilt when its SAH cost grows past this ratio */
+	float refit_max_sah_ratio;
+
 	/* number of primitives in leaf */
 	int min_leaf_size;
 	int max_triangle_leaf_size;
@@ -53,6 +56,14 @@ public:
 	/* QBVH */
 	bool use_qbvh;
 
+	/* Store the child bounds of QBVH aligned nodes with 8 bits per plane,
+	 * relative to the node bounds. Smaller nodes for slightly looser bounds.
+	 */
+	bool use_quantized_nodes;
+
+	/* BVH8, 8-wide nodes for AVX2 traversal, with aligned nodes only. */
+	bool use_bvh8;
+
 	/* Mask of primitives to be included into the BVH. */
 	int primitive_mask;
 
@@ -72,6 +83,10 @@ public:
 	/* Same as above, but for triangle primitives. */
 	int num_motion_triangle_steps;
 
+	/* Store built BVHs on disk and reuse them when the same geometry is
+	 * built again, see bvh_cache.h. */
+	bool use_cache;
+
 	/* fixed parameters */
 	enum {
 		MAX_DEPTH = 64,
@@ -91,6 +106,8 @@ public:
 		sah_node_cost = 1.0f;
 		sah_primitive_cost = 1.0f;
 
+		refit_max_sah_ratio = 1.5f;
+
 		min_leaf_size = 1;
 		max_triangle_leaf_size = 8;
 		max_motion_triangle_leaf_size = 8;
@@ -99,12 +116,16 @@ public:
 
 		top_level = false;
 		use_qbvh = false;
+		use_quantized_nodes = false;
+		use_bvh8 = false;
 		use_unaligned_nodes = false;
 
 		primitive_mask = PRIMITIVE_ALL;
 
 		num_motion_curve_steps = 0;
 		num_motion_triangle_steps = 0;
+
+		use_cache = false;
 	}
 
 	/* SAH costs */
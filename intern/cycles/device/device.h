@@ -130,6 +130,12 @@ public:
 	/* Denoising features. */
 	bool use_denoising;
 
+	/* Use ambient occlusion, from the world settings, passes or shaders. */
+	bool use_ao;
+
+	/* Use multiple importance sampling of the background. */
+	bool use_background_light;
+
 	DeviceRequestedFeatures()
 	{
 		/* TODO(sergey): Find more meaningful defaults. */
@@ -149,6 +155,8 @@ public:
 		use_shadow_tricks = false;
 		use_principled = false;
 		use_denoising = false;
+		use_ao = false;
+		use_background_light = false;
 	}
 
 	bool modified(const DeviceRequestedFeatures& requested_features)
@@ -168,7 +176,9 @@ public:
 		         use_transparent == requested_features.use_transparent &&
 		         use_shadow_tricks == requested_features.use_shadow_tricks &&
 		         use_principled == requested_features.use_principled &&
-		         use_denoising == requested_features.use_denoising);
+		         use_denoising == requested_features.use_denoising &&
+		         use_ao == requested_features.use_ao &&
+		         use_background_light == requested_features.use_background_light);
 	}
 
 	/* Convert the requested features structure to a build options,
@@ -221,6 +231,12 @@ public:
 		if(!use_denoising) {
 			build_options += " -D__NO_DENOISING__";
 		}
+		if(!use_ao) {
+			build_options += " -D__NO_AO__";
+		}
+		if(!use_background_light) {
+			build_options += " -D__NO_BACKGROUND_MIS__";
+		}
 		return build_options;
 	}
 };
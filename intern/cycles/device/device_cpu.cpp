@@ -171,6 +171,8 @@ public:
 	DeviceRequestedFeatures requested_features;
 
 	KernelFunctions<void(*)(KernelGlobals *, float *, unsigned int *, int, int, int, int, int)>   path_trace_kernel;
+	KernelFunctions<bool(*)(KernelGlobals *, float *, int, int, int, int, int)>                   adaptive_stopping_kernel;
+	KernelFunctions<void(*)(KernelGlobals *, float *, int, int, int, int, int)>                   adaptive_adjust_samples_kernel;
 	KernelFunctions<void(*)(KernelGlobals *, uchar4 *, float *, float, int, int, int, int)>       convert_to_half_float_kernel;
 	KernelFunctions<void(*)(KernelGlobals *, uchar4 *, float *, float, int, int, int, int)>       convert_to_byte_kernel;
 	KernelFunctions<void(*)(KernelGlobals *, uint4 *, float4 *, float*, int, int, int, int, int)> shader_kernel;
@@ -207,6 +209,8 @@ public:
 	: Device(info, stats, background),
 #define REGISTER_KERNEL(name) name ## _kernel(KERNEL_FUNCTIONS(name))
 	  REGISTER_KERNEL(path_trace),
+	  REGISTER_KERNEL(adaptive_stopping),
+	  REGISTER_KERNEL(adaptive_adjust_samples),
 	  REGISTER_KERNEL(convert_to_half_float),
 	  REGISTER_KERNEL(convert_to_byte),
 	  REGISTER_KERNEL(shader),
@@ -613,6 +617,24 @@ public:
 		return true;
 	}
 
+	bool adaptive_sampling_converged(RenderTile &tile, KernelGlobals *kg)
+	{
+		float *render_buffer = (float*)tile.buffer;
+		bool converged = true;
+
+		for(int y = tile.y; y < tile.y + tile.h; y++) {
+			for(int x = tile.x; x < tile.x + tile.w; x++) {
+				if(!adaptive_stopping_kernel()(kg, render_buffer, tile.sample,
+				                               x, y, tile.offset, tile.stride))
+				{
+					converged = false;
+				}
+			}
+		}
+
+		return converged;
+	}
+
 	void path_trace(DeviceTask &task, RenderTile &tile, KernelGlobals *kg)
 	{
 		float *render_buffer = (float*)tile.buffer;
@@ -620,6 +642,11 @@ public:
 		int start_sample = tile.start_sample;
 		int end_sample = tile.start_sample + tile.num_samples;
 
+		const KernelData &data = kg->__data;
+		const int pass_stride = data.film.pass_stride;
+		const int pass_adaptive_aux = data.film.pass_adaptive_aux;
+		bool tile_converged = false;
+
 		for(int sample = start_sample; sample < end_sample; sample++) {
 			if(task.get_cancel() || task_pool.canceled()) {
 				if(task.need_finish_queue == false)
@@ -628,6 +655,14 @@ public:
 
 			for(int y = tile.y; y < tile.y + tile.h; y++) {
 				for(int x = tile.x; x < tile.x + tile.w; x++) {
+					/* Skip converged pixels, see kernel_adaptive_stopping. */
+					if(pass_adaptive_aux) {
+						int index = tile.offset + x + y*tile.stride;
+						if(render_buffer[index*pass_stride + pass_adaptive_aux + 3] != 0.0f) {
+							continue;
+						}
+					}
+
 					path_trace_kernel()(kg, render_buffer, rng_state,
 					                    sample, x, y, tile.offset, tile.stride);
 				}
@@ -636,6 +671,31 @@ public:
 			tile.sample = sample + 1;
 
 			task.update_progress(&tile, tile.w*tile.h);
+
+			if(pass_adaptive_aux &&
+			   tile.sample >= data.integrator.adaptive_min_samples &&
+			   (tile.sample % data.integrator.adaptive_step) == 0 &&
+			   adaptive_sampling_converged(tile, kg))
+			{
+				/* Other threads pick up the remaining tiles sooner. */
+				task.update_progress(&tile, tile.w*tile.h*(end_sample - tile.sample));
+				tile_converged = true;
+				break;
+			}
+		}
+
+		if(pass_adaptive_aux) {
+			/* Pixels that stopped early are scaled to the sample count of the tile. */
+			if(tile_converged) {
+				tile.sample = end_sample;
+			}
+
+			for(int y = tile.y; y < tile.y + tile.h; y++) {
+				for(int x = tile.x; x < tile.x + tile.w; x++) {
+					adaptive_adjust_samples_kernel()(kg, render_buffer, tile.sample,
+					                                 x, y, tile.offset, tile.stride);
+				}
+			}
 		}
 	}
 
@@ -708,6 +768,11 @@ public:
 				else {
 					path_trace(task, tile, kg);
 				}
+
+#ifdef __KERNEL_DEBUG__
+				stats.kernel.add(kg->stats);
+				kg->stats.reset();
+#endif
 			}
 			else if(tile.task == RenderTile::DENOISE) {
 				denoise(task, tile);
@@ -953,7 +1018,12 @@ int2 CPUSplitKernel::split_kernel_local_size()
 }
 
 int2 CPUSplitKernel::split_kernel_global_size(device_memory& /*kg*/, device_memory& /*data*/, DeviceTask * /*task*/) {
-	return make_int2(1, 1);
+	/* Every thread runs its own split kernel, so this is the number of rays
+	 * each thread traces as one stream. Large enough for shader sorting to
+	 * group rays hitting the same shader, small enough to stay in cache.
+	 */
+	VLOG(1) << "Global size: (32, 32).";
+	return make_int2(32, 32);
 }
 
 uint64_t CPUSplitKernel::state_buffer_size(device_memory& kernel_globals, device_memory& /*data*/, size_t num_threads) {
@@ -57,7 +57,7 @@ public:
 	}
 
 	NetworkDevice(DeviceInfo& info, Stats &stats, const char *address)
-	: Device(info, stats, true), socket(io_service)
+	: Device(info, stats, true), socket(io_service), data_cache(false)
 	{
 		error_func = NetworkError();
 		stringstream portstr;
@@ -77,6 +77,8 @@ public:
 
 		if(error)
 			error_func.network_error(error.message());
+		else
+			socket.set_option(tcp::no_delay(true));
 
 		mem_counter = 0;
 	}
@@ -113,8 +115,8 @@ public:
 		RPCSend snd(socket, &error_func, "mem_copy_to");
 
 		snd.add(mem);
+		add_data(snd, (void*)mem.data_pointer, mem.memory_size());
 		snd.write();
-		snd.write_buffer((void*)mem.data_pointer, mem.memory_size());
 	}
 
 	void mem_copy_from(device_memory& mem, int y, int w, int h, int elem)
@@ -170,8 +172,8 @@ public:
 
 		snd.add(name_string);
 		snd.add(size);
+		snd.add_buffer(host, size);
 		snd.write();
-		snd.write_buffer(host, size);
 	}
 
 	void tex_alloc(const char *name,
@@ -195,8 +197,8 @@ public:
 		snd.add(mem);
 		snd.add(interpolation);
 		snd.add(extension);
+		add_data(snd, (void*)mem.data_pointer, mem.memory_size());
 		snd.write();
-		snd.write_buffer((void*)mem.data_pointer, mem.memory_size());
 	}
 
 	void tex_free(device_memory& mem)
@@ -327,7 +329,29 @@ public:
 	}
 
 private:
+	/* Add data to upload, or only its hash when the server has it cached. */
+	void add_data(RPCSend& snd, const void *data, size_t size)
+	{
+		if(NetworkDataCache::use_cache(size)) {
+			string hash = network_data_hash(data, size);
+			bool cached = (data_cache.find(hash) != NULL);
+
+			snd.add(hash);
+			snd.add(cached);
+
+			if(cached) {
+				VLOG(2) << "Buffer " << string_human_readable_size(size) << " cached on server.";
+				return;
+			}
+
+			data_cache.insert(hash, data, size);
+		}
+
+		snd.add_buffer(data, size);
+	}
+
 	NetworkError error_func;
+	NetworkDataCache data_cache;
 };
 
 Device *device_network_create(DeviceInfo& info, Stats &stats, const char *address)
@@ -360,7 +384,7 @@ public:
 	bool have_error() { return error_func.have_error(); }
 
 	DeviceServer(Device *device_, tcp::socket& socket_)
-	: device(device_), socket(socket_), stop(false), blocked_waiting(false)
+	: device(device_), socket(socket_), stop(false), blocked_waiting(false), data_cache(true)
 	{
 		error_func = NetworkError();
 	}
@@ -496,7 +520,6 @@ protected:
 			network_device_memory mem;
 
 			rcv.read(mem);
-			lock.unlock();
 
 			device_ptr client_pointer = mem.device_pointer;
 
@@ -508,7 +531,8 @@ protected:
 			mem.data_pointer = (device_ptr)&data_v[0];
 
 			/* copy data from network into memory buffer */
-			rcv.read_buffer((uint8_t*)mem.data_pointer, data_size);
+			read_data(rcv, (uint8_t*)mem.data_pointer, data_size);
+			lock.unlock();
 
 			/* translate the client pointer to a real device pointer */
 			mem.device_pointer = device_ptr_from_client_pointer(client_pointer);
@@ -538,8 +562,8 @@ protected:
 			size_t data_size = mem.memory_size();
 
 			RPCSend snd(socket, &error_func, "mem_copy_from");
+			snd.add_buffer((uint8_t*)mem.data_pointer, data_size);
 			snd.write();
-			snd.write_buffer((uint8_t*)mem.data_pointer, data_size);
 			lock.unlock();
 		}
 		else if(rcv.name == "mem_zero") {
@@ -594,7 +618,6 @@ protected:
 			rcv.read(mem);
 			rcv.read(interpolation);
 			rcv.read(extension_type);
-			lock.unlock();
 
 			client_pointer = mem.device_pointer;
 
@@ -607,7 +630,8 @@ protected:
 			else
 				mem.data_pointer = 0;
 
-			rcv.read_buffer((uint8_t*)mem.data_pointer, data_size);
+			read_data(rcv, (uint8_t*)mem.data_pointer, data_size);
+			lock.unlock();
 
 			device->tex_alloc(name.c_str(), mem, interpolation, extension_type);
 
@@ -714,6 +738,35 @@ protected:
 		}
 	}
 
+	/* Read uploaded data, from the cache when the client only sent its hash. */
+	void read_data(RPCReceive& rcv, void *data, size_t size)
+	{
+		if(NetworkDataCache::use_cache(size)) {
+			string hash;
+			bool cached;
+
+			rcv.read(hash);
+			rcv.read(cached);
+
+			if(cached) {
+				const vector<char> *cached_data = data_cache.find(hash);
+
+				if(cached_data && cached_data->size() == size)
+					memcpy(data, &(*cached_data)[0], size);
+				else
+					network_error("Network receive error: uploaded data not in cache");
+
+				return;
+			}
+
+			rcv.read_buffer(data, size);
+			data_cache.insert(hash, data, size);
+		}
+		else {
+			rcv.read_buffer(data, size);
+		}
+	}
+
 	bool task_acquire_tile(Device *device, RenderTile& tile)
 	{
 		thread_scoped_lock acquire_lock(acquire_mutex);
@@ -826,6 +879,9 @@ protected:
 
 	bool stop;
 	bool blocked_waiting;
+
+	/* recently uploaded data, in sync with the client cache */
+	NetworkDataCache data_cache;
 private:
 	NetworkError error_func;
 
@@ -846,6 +902,7 @@ void Device::server_run()
 
 			tcp::socket socket(io_service);
 			acceptor.accept(socket);
+			socket.set_option(tcp::no_delay(true));
 
 			string remote_address = socket.remote_endpoint().address().to_string();
 			printf("Connected to remote client at: %s\n", remote_address.c_str());
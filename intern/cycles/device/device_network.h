@@ -33,11 +33,15 @@
 #include <sstream>
 #include <deque>
 
+#include <zlib.h>
+
 #include "render/buffers.h"
 
 #include "util/util_foreach.h"
 #include "util/util_list.h"
+#include "util/util_logging.h"
 #include "util/util_map.h"
+#include "util/util_md5.h"
 #include "util/util_string.h"
 
 CCL_NAMESPACE_BEGIN
@@ -63,6 +67,97 @@ typedef boost::archive::binary_oarchive o_archive;
 typedef boost::archive::binary_iarchive i_archive;
 #endif
 
+/* Data transfers
+ *
+ * Buffers above a minimum size are deflated before sending. Uploaded buffers
+ * are also identified by the hash of their content, and the server keeps a
+ * copy of recently uploaded data so unchanged buffers, as with interactive
+ * scene updates, are not sent again. Client and server apply the same LRU
+ * policy to the same sequence of uploads, so the client knows which data the
+ * server still has without a round trip. */
+
+static const size_t NETWORK_COMPRESS_MIN_SIZE = 4096;
+static const size_t NETWORK_CACHE_MIN_SIZE = 65536;
+static const size_t NETWORK_CACHE_SIZE = 512*1024*1024;
+
+static inline string network_data_hash(const void *data, size_t size)
+{
+	MD5Hash md5;
+	const uint8_t *bytes = (const uint8_t*)data;
+
+	/* Hash in chunks, MD5Hash takes int sizes. */
+	while(size > 0) {
+		int chunk = (int)min(size, (size_t)(1 << 30));
+		md5.append(bytes, chunk);
+		bytes += chunk;
+		size -= chunk;
+	}
+
+	return md5.get_hex();
+}
+
+class NetworkDataCache {
+public:
+	explicit NetworkDataCache(bool store_data_)
+	: store_data(store_data_), total_size(0)
+	{
+	}
+
+	static bool use_cache(size_t size)
+	{
+		return size >= NETWORK_CACHE_MIN_SIZE && size <= NETWORK_CACHE_SIZE;
+	}
+
+	/* Find data and mark it as most recently used, NULL if not cached. Only
+	 * the server stores the data itself, for the client the result is empty. */
+	const vector<char> *find(const string& hash)
+	{
+		map<string, Entry>::iterator it = entries.find(hash);
+		if(it == entries.end()) {
+			return NULL;
+		}
+
+		lru.splice(lru.end(), lru, it->second.lru_it);
+		return &it->second.data;
+	}
+
+	void insert(const string& hash, const void *data, size_t size)
+	{
+		if(entries.find(hash) != entries.end()) {
+			return;
+		}
+
+		/* Evict least recently used data. */
+		while(total_size + size > NETWORK_CACHE_SIZE && !lru.empty()) {
+			map<string, Entry>::iterator it = entries.find(lru.front());
+			total_size -= it->second.size;
+			entries.erase(it);
+			lru.pop_front();
+		}
+
+		Entry& entry = entries[hash];
+		entry.size = size;
+		entry.lru_it = lru.insert(lru.end(), hash);
+		if(store_data) {
+			entry.data.assign((const char*)data, (const char*)data + size);
+		}
+
+		total_size += size;
+	}
+
+private:
+	struct Entry {
+		size_t size;
+		vector<char> data;
+		list<string>::iterator lru_it;
+	};
+
+	bool store_data;
+	size_t total_size;
+	map<string, Entry> entries;
+	list<string> lru;
+};
+
 /* Serialization of device memory */
 
 class network_device_memory : public device_memory
@@ -108,7 +203,7 @@ public:
 	{
 		archive & name_;
 		error_func = e;
-		fprintf(stderr, "rpc send %s\n", name.c_str());
+		VLOG(3) << "RPC send " << name << ".";
 	}
 
 	~RPCSend()
@@ -145,6 +240,43 @@ public:
 		archive & tile.buffer & tile.rng_state;
 	}
 
+	/* Add buffer to be sent after the archive, read on the other side with
+	 * RPCReceive::read_buffer() in the same order. The buffer must stay valid
+	 * until write(). */
+	void add_buffer(const void *buffer, size_t size)
+	{
+		RPCBuffer rpc_buffer;
+		rpc_buffer.data = buffer;
+		rpc_buffer.size = size;
+
+		if(size >= NETWORK_COMPRESS_MIN_SIZE) {
+			uLongf compressed_size = compressBound(size);
+			rpc_buffer.compressed.resize(compressed_size);
+
+			if(compress2((Bytef*)&rpc_buffer.compressed[0], &compressed_size,
+			             (const Bytef*)buffer, size, Z_BEST_SPEED) == Z_OK &&
+			   compressed_size < size)
+			{
+				rpc_buffer.compressed.resize(compressed_size);
+				rpc_buffer.data = &rpc_buffer.compressed[0];
+				rpc_buffer.size = compressed_size;
+			}
+			else {
+				rpc_buffer.compressed.clear();
+			}
+		}
+
+		bool compressed = !rpc_buffer.compressed.empty();
+		size_t transfer_size = rpc_buffer.size;
+		archive & compressed & transfer_size;
+
+		buffers.push_back(rpc_buffer);
+		if(compressed) {
+			/* Vector was copied, point to the copy. */
+			buffers.back().data = &buffers.back().compressed[0];
+		}
+	}
+
 	void write()
 	{
 		boost::system::error_code error;
@@ -152,46 +284,45 @@ public:
 		/* get string from stream */
 		string archive_str = archive_stream.str();
 
-		/* first send fixed size header with size of following data */
+		/* fixed size header with size of following data */
 		ostringstream header_stream;
 		header_stream << setw(8) << hex << archive_str.size();
 		string header_str = header_stream.str();
 
-		boost::asio::write(socket,
-			boost::asio::buffer(header_str),
-			boost::asio::transfer_all(), error);
+		/* send header, archive and buffers in a single write, so small
+		 * messages are not split over multiple packets */
+		vector<boost::asio::const_buffer> asio_buffers;
+		asio_buffers.push_back(boost::asio::buffer(header_str));
+		asio_buffers.push_back(boost::asio::buffer(archive_str));
 
-		if(error.value())
-			error_func->network_error(error.message());
+		foreach(const RPCBuffer& rpc_buffer, buffers) {
+			if(rpc_buffer.size) {
+				asio_buffers.push_back(boost::asio::buffer(rpc_buffer.data, rpc_buffer.size));
+			}
+		}
 
-		/* then send actual data */
 		boost::asio::write(socket,
-			boost::asio::buffer(archive_str),
+			asio_buffers,
 			boost::asio::transfer_all(), error);
-		
+
 		if(error.value())
 			error_func->network_error(error.message());
 
 		sent = true;
 	}
 
-	void write_buffer(void *buffer, size_t size)
-	{
-		boost::system::error_code error;
-
-		boost::asio::write(socket,
-			boost::asio::buffer(buffer, size),
-			boost::asio::transfer_all(), error);
-		
-		if(error.value())
-			error_func->network_error(error.message());
-	}
-
 protected:
+	struct RPCBuffer {
+		const void *data;
+		size_t size;
+		vector<char> compressed;
+	};
+
 	string name;
 	tcp::socket& socket;
 	ostringstream archive_stream;
 	o_archive archive;
+	list<RPCBuffer> buffers;
 	bool sent;
 	NetworkError *error_func;
 };
@@ -237,7 +368,7 @@ public:
 					archive = new i_archive(*archive_stream);
 
 					*archive & name;
-					fprintf(stderr, "rpc receive %s\n", name.c_str());
+					VLOG(3) << "RPC receive " << name << ".";
 				}
 				else {
 					error_func->network_error("Network receive error: data size doesn't match header");
@@ -271,17 +402,53 @@ public:
 		*archive & data;
 	}
 
+	/* Read buffer sent with RPCSend::add_buffer(), after all archive data
+	 * before it was read. */
 	void read_buffer(void *buffer, size_t size)
 	{
+		bool compressed;
+		size_t transfer_size;
+		*archive & compressed & transfer_size;
+
+		vector<char> compressed_data;
+		void *transfer_buffer = buffer;
+
+		if(compressed) {
+			compressed_data.resize(transfer_size);
+			transfer_buffer = &compressed_data[0];
+		}
+		else if(transfer_size != size) {
+			error_func->network_error("Network receive error: buffer size doesn't match expected size");
+			return;
+		}
+
+		if(transfer_size == 0) {
+			return;
+		}
+
 		boost::system::error_code error;
-		size_t len = boost::asio::read(socket, boost::asio::buffer(buffer, size), error);
+		size_t len = boost::asio::read(socket, boost::asio::buffer(transfer_buffer, transfer_size), error);
 
 		if(error.value()) {
 			error_func->network_error(error.message());
+			return;
 		}
 
-		if(len != size)
-			cout << "Network receive error: buffer size doesn't match expected size\n";
+		if(len != transfer_size) {
+			error_func->network_error("Network receive error: buffer size doesn't match expected size");
+			return;
+		}
+
+		if(compressed) {
+			uLongf uncompressed_size = size;
+
+			if(uncompress((Bytef*)buffer, &uncompressed_size,
+			              (const Bytef*)&compressed_data[0], transfer_size) != Z_OK ||
+			   uncompressed_size != size)
+			{
+				error_func->network_error("Network receive error: failed to decompress buffer");
+			}
+		}
 	}
 
 	void read(DeviceTask& task)
@@ -34,6 +34,11 @@ CCL_NAMESPACE_BEGIN
 #  include "kernel/bvh/qbvh_nodes.h"
 #endif
 
+/* Common OBVH functions. */
+#ifdef __OBVH__
+#  include "kernel/bvh/obvh_nodes.h"
+#endif
+
 /* Regular BVH traversal */
 
 #include "kernel/bvh/bvh_nodes.h"
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2011-2017, Blender Foundation.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Aligned nodes intersection AVX code is adopted from Embree,
+ */
+
+/* Octo BVH nodes, see BVH8::pack_aligned_node() for the layout.
+ *
+ * Stack items and near/far plane offsets are shared with QBVH, a plane of all
+ * eight children takes two float4, so offsets are doubled when fetching.
+ */
+
+/* Sort stack items from begin to end, with the closest item at end, which is
+ * the top of the stack.
+ */
+ccl_device_inline void obvh_stack_sort(QBVHStackItem *begin,
+                                       QBVHStackItem *end)
+{
+	for(QBVHStackItem *s = begin + 1; s <= end; ++s) {
+		QBVHStackItem item = *s;
+		QBVHStackItem *t = s;
+		while(t > begin && (t - 1)->dist < item.dist) {
+			*t = *(t - 1);
+			--t;
+		}
+		*t = item;
+	}
+}
+
+/* Axis-aligned nodes intersection */
+
+ccl_device_inline int obvh_aligned_node_intersect(KernelGlobals *ccl_restrict kg,
+                                                  const avxf& isect_near,
+                                                  const avxf& isect_far,
+                                                  const avx3f& org_idir,
+                                                  const avx3f& idir,
+                                                  const int near_x,
+                                                  const int near_y,
+                                                  const int near_z,
+                                                  const int far_x,
+                                                  const int far_y,
+                                                  const int far_z,
+                                                  const int node_addr,
+                                                  avxf *ccl_restrict dist)
+{
+	const int offset = node_addr + 1;
+	const avxf tnear_x = msub(kernel_tex_fetch_avxf(__bvh_nodes, offset+2*near_x), idir.x, org_idir.x);
+	const avxf tnear_y = msub(kernel_tex_fetch_avxf(__bvh_nodes, offset+2*near_y), idir.y, org_idir.y);
+	const avxf tnear_z = msub(kernel_tex_fetch_avxf(__bvh_nodes, offset+2*near_z), idir.z, org_idir.z);
+	const avxf tfar_x = msub(kernel_tex_fetch_avxf(__bvh_nodes, offset+2*far_x), idir.x, org_idir.x);
+	const avxf tfar_y = msub(kernel_tex_fetch_avxf(__bvh_nodes, offset+2*far_y), idir.y, org_idir.y);
+	const avxf tfar_z = msub(kernel_tex_fetch_avxf(__bvh_nodes, offset+2*far_z), idir.z, org_idir.z);
+
+	const avxf tnear = max(max(tnear_x, tnear_y), max(tnear_z, isect_near));
+	const avxf tfar = min(min(tfar_x, tfar_y), min(tfar_z, isect_far));
+	const avxf vmask = tnear <= tfar;
+	*dist = tnear;
+	return movemask(vmask);
+}
+
+ccl_device_inline int obvh_aligned_node_intersect_robust(
+        KernelGlobals *ccl_restrict kg,
+        const avxf& isect_near,
+        const avxf& isect_far,
+        const avx3f& P_idir,
+        const avx3f& idir,
+        const int near_x,
+        const int near_y,
+        const int near_z,
+        const int far_x,
+        const int far_y,
+        const int far_z,
+        const int node_addr,
+        const float difl,
+        avxf *ccl_restrict dist)
+{
+	const int offset = node_addr + 1;
+	const avxf tnear_x = msub(kernel_tex_fetch_avxf(__bvh_nodes, offset+2*near_x), idir.x, P_idir.x);
+	const avxf tnear_y = msub(kernel_tex_fetch_avxf(__bvh_nodes, offset+2*near_y), idir.y, P_idir.y);
+	const avxf tnear_z = msub(kernel_tex_fetch_avxf(__bvh_nodes, offset+2*near_z), idir.z, P_idir.z);
+	const avxf tfar_x = msub(kernel_tex_fetch_avxf(__bvh_nodes, offset+2*far_x), idir.x, P_idir.x);
+	const avxf tfar_y = msub(kernel_tex_fetch_avxf(__bvh_nodes, offset+2*far_y), idir.y, P_idir.y);
+	const avxf tfar_z = msub(kernel_tex_fetch_avxf(__bvh_nodes, offset+2*far_z), idir.z, P_idir.z);
+
+	const float round_down = 1.0f - difl;
+	const float round_up = 1.0f + difl;
+	const avxf tnear = max(max(tnear_x, tnear_y), max(tnear_z, isect_near));
+	const avxf tfar = min(min(tfar_x, tfar_y), min(tfar_z, isect_far));
+	const avxf vmask = round_down*tnear <= round_up*tfar;
+	*dist = tnear;
+	return movemask(vmask);
+}
@@ -83,6 +83,151 @@ ccl_device_inline void qbvh_stack_sort(QBVHStackItem *ccl_restrict s1,
 	if(s3->dist < s2->dist) { qbvh_item_swap(s3, s2); }
 }
 
+/* Quantized axis-aligned nodes, see BVH4::pack_quantized_node() for the layout */
+
+ccl_device_inline bool qbvh_node_is_quantized(const float4 inodes)
+{
+	return __float_as_uint(inodes.w) != 0;
+}
+
+/* Offset of the child indices in an aligned node. */
+ccl_device_inline int qbvh_aligned_node_children_offset(const float4 inodes)
+{
+	return qbvh_node_is_quantized(inodes)? 4: 7;
+}
+
+/* Dequantize one plane of the four children, stored one byte per child. */
+ccl_device_inline ssef qbvh_dequantize_plane(const uint q,
+                                             const float origin,
+                                             const float scale)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i q16 = _mm_unpacklo_epi8(_mm_cvtsi32_si128((int)q), zero);
+	const ssef qf = ssef(_mm_unpacklo_epi16(q16, zero));
+	/* The product is exact, so this matches the packing with or without FMA. */
+	return madd(qf, ssef(scale), ssef(origin));
+}
+
+ccl_device_inline void qbvh_quantized_node_planes(KernelGlobals *ccl_restrict kg,
+                                                  const int node_addr,
+                                                  ssef planes[6])
+{
+	const float4 header = kernel_tex_fetch(__bvh_nodes, node_addr);
+	const float4 origin = kernel_tex_fetch(__bvh_nodes, node_addr+1);
+	const float4 qxy = kernel_tex_fetch(__bvh_nodes, node_addr+2);
+	const float4 qz = kernel_tex_fetch(__bvh_nodes, node_addr+3);
+
+	const uint exponents = __float_as_uint(header.w);
+	const float scale_x = __uint_as_float((exponents & 0xff) << 23);
+	const float scale_y = __uint_as_float(((exponents >> 8) & 0xff) << 23);
+	const float scale_z = __uint_as_float(((exponents >> 16) & 0xff) << 23);
+
+	planes[0] = qbvh_dequantize_plane(__float_as_uint(qxy.x), origin.x, scale_x);
+	planes[1] = qbvh_dequantize_plane(__float_as_uint(qxy.y), origin.x, scale_x);
+	planes[2] = qbvh_dequantize_plane(__float_as_uint(qxy.z), origin.y, scale_y);
+	planes[3] = qbvh_dequantize_plane(__float_as_uint(qxy.w), origin.y, scale_y);
+	planes[4] = qbvh_dequantize_plane(__float_as_uint(qz.x), origin.z, scale_z);
+	planes[5] = qbvh_dequantize_plane(__float_as_uint(qz.y), origin.z, scale_z);
+}
+
+ccl_device_inline int qbvh_quantized_node_intersect(KernelGlobals *ccl_restrict kg,
+                                                    const ssef& isect_near,
+                                                    const ssef& isect_far,
+#ifdef __KERNEL_AVX2__
+                                                    const sse3f& org_idir,
+#else
+                                                    const sse3f& org,
+#endif
+                                                    const sse3f& idir,
+                                                    const int near_x,
+                                                    const int near_y,
+                                                    const int near_z,
+                                                    const int far_x,
+                                                    const int far_y,
+                                                    const int far_z,
+                                                    const int node_addr,
+                                                    ssef *ccl_restrict dist)
+{
+	ssef planes[6];
+	qbvh_quantized_node_planes(kg, node_addr, planes);
+#ifdef __KERNEL_AVX2__
+	const ssef tnear_x = msub(planes[near_x], idir.x, org_idir.x);
+	const ssef tnear_y = msub(planes[near_y], idir.y, org_idir.y);
+	const ssef tnear_z = msub(planes[near_z], idir.z, org_idir.z);
+	const ssef tfar_x = msub(planes[far_x], idir.x, org_idir.x);
+	const ssef tfar_y = msub(planes[far_y], idir.y, org_idir.y);
+	const ssef tfar_z = msub(planes[far_z], idir.z, org_idir.z);
+#else
+	const ssef tnear_x = (planes[near_x] - org.x) * idir.x;
+	const ssef tnear_y = (planes[near_y] - org.y) * idir.y;
+	const ssef tnear_z = (planes[near_z] - org.z) * idir.z;
+	const ssef tfar_x = (planes[far_x] - org.x) * idir.x;
+	const ssef tfar_y = (planes[far_y] - org.y) * idir.y;
+	const ssef tfar_z = (planes[far_z] - org.z) * idir.z;
+#endif
+
+#ifdef __KERNEL_SSE41__
+	const ssef tnear = maxi(maxi(tnear_x, tnear_y), maxi(tnear_z, isect_near));
+	const ssef tfar = mini(mini(tfar_x, tfar_y), mini(tfar_z, isect_far));
+	const sseb vmask = cast(tnear) > cast(tfar);
+	int mask = (int)movemask(vmask)^0xf;
+#else
+	const ssef tnear = max4(tnear_x, tnear_y, tnear_z, isect_near);
+	const ssef tfar = min4(tfar_x, tfar_y, tfar_z, isect_far);
+	const sseb vmask = tnear <= tfar;
+	int mask = (int)movemask(vmask);
+#endif
+	*dist = tnear;
+	return mask;
+}
+
+ccl_device_inline int qbvh_quantized_node_intersect_robust(
+        KernelGlobals *ccl_restrict kg,
+        const ssef& isect_near,
+        const ssef& isect_far,
+#ifdef __KERNEL_AVX2__
+        const sse3f& P_idir,
+#else
+        const sse3f& P,
+#endif
+        const sse3f& idir,
+        const int near_x,
+        const int near_y,
+        const int near_z,
+        const int far_x,
+        const int far_y,
+        const int far_z,
+        const int node_addr,
+        const float difl,
+        ssef *ccl_restrict dist)
+{
+	ssef planes[6];
+	qbvh_quantized_node_planes(kg, node_addr, planes);
+#ifdef __KERNEL_AVX2__
+	const ssef tnear_x = msub(planes[near_x], idir.x, P_idir.x);
+	const ssef tnear_y = msub(planes[near_y], idir.y, P_idir.y);
+	const ssef tnear_z = msub(planes[near_z], idir.z, P_idir.z);
+	const ssef tfar_x = msub(planes[far_x], idir.x, P_idir.x);
+	const ssef tfar_y = msub(planes[far_y], idir.y, P_idir.y);
+	const ssef tfar_z = msub(planes[far_z], idir.z, P_idir.z);
+#else
+	const ssef tnear_x = (planes[near_x] - P.x) * idir.x;
+	const ssef tnear_y = (planes[near_y] - P.y) * idir.y;
+	const ssef tnear_z = (planes[near_z] - P.z) * idir.z;
+	const ssef tfar_x = (planes[far_x] - P.x) * idir.x;
+	const ssef tfar_y = (planes[far_y] - P.y) * idir.y;
+	const ssef tfar_z = (planes[far_z] - P.z) * idir.z;
+#endif
+
+	const float round_down = 1.0f - difl;
+	const float round_up = 1.0f + difl;
+	const ssef tnear = max4(tnear_x, tnear_y, tnear_z, isect_near);
+	const ssef tfar = min4(tfar_x, tfar_y, tfar_z, isect_far);
+	const sseb vmask = round_down*tnear <= round_up*tfar;
+	*dist = tnear;
+	return (int)movemask(vmask);
+}
+
 /* Axis-aligned nodes intersection */
 
 ccl_device_inline int qbvh_aligned_node_intersect(KernelGlobals *ccl_restrict kg,
@@ -103,6 +248,22 @@ ccl_device_inline int qbvh_aligned_node_intersect(KernelGlobals *ccl_restrict kg
                                                   const int node_addr,
                                                   ssef *ccl_restrict dist)
 {
+	if(qbvh_node_is_quantized(kernel_tex_fetch(__bvh_nodes, node_addr))) {
+		return qbvh_quantized_node_intersect(kg,
+		                                     isect_near,
+		                                     isect_far,
+#ifdef __KERNEL_AVX2__
+		                                     org_idir,
+#else
+		                                     org,
+#endif
+		                                     idir,
+		                                     near_x, near_y, near_z,
+		                                     far_x, far_y, far_z,
+		                                     node_addr,
+		                                     dist);
+	}
+
 	const int offset = node_addr + 1;
 #ifdef __KERNEL_AVX2__
 	const ssef tnear_x = msub(kernel_tex_fetch_ssef(__bvh_nodes, offset+near_x), idir.x, org_idir.x);
@@ -155,6 +316,23 @@ ccl_device_inline int qbvh_aligned_node_intersect_robust(
         const float difl,
         ssef *ccl_restrict dist)
 {
+	if(qbvh_node_is_quantized(kernel_tex_fetch(__bvh_nodes, node_addr))) {
+		return qbvh_quantized_node_intersect_robust(kg,
+		                                            isect_near,
+		                                            isect_far,
+#ifdef __KERNEL_AVX2__
+		                                            P_idir,
+#else
+		                                            P,
+#endif
+		                                            idir,
+		                                            near_x, near_y, near_z,
+		                                            far_x, far_y, far_z,
+		                                            node_addr,
+		                                            difl,
+		                                            dist);
+	}
+
 	const int offset = node_addr + 1;
 #ifdef __KERNEL_AVX2__
 	const ssef tnear_x = msub(kernel_tex_fetch_ssef(__bvh_nodes, offset+near_x), idir.x, P_idir.x);
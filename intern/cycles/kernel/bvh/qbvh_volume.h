@@ -135,7 +135,8 @@ ccl_device bool BVH_FUNCTION_FULL_NAME(QBVH)(KernelGlobals *kg,
 					else
 #endif
 					{
-						cnodes = kernel_tex_fetch(__bvh_nodes, node_addr+7);
+						cnodes = kernel_tex_fetch(__bvh_nodes,
+						                          node_addr+qbvh_aligned_node_children_offset(inodes));
 					}
 
 					/* One child is hit, continue with that child. */
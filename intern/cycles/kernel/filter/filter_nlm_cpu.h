@@ -16,6 +16,17 @@
 
 CCL_NAMESPACE_BEGIN
 
+/* Sum of the row over the box filter window of pixel x, clipped to the rect. */
+ccl_device_inline float kernel_filter_nlm_window_sum(const float *ccl_restrict row,
+                                                     int x, int rect_x, int rect_z, int f)
+{
+	float sum = 0.0f;
+	for(int x1 = max(rect_x, x-f); x1 < min(rect_z, x+f+1); x1++) {
+		sum += row[x1];
+	}
+	return sum;
+}
+
 ccl_device_inline void kernel_filter_nlm_calc_difference(int dx, int dy,
                                                          const float *ccl_restrict weight_image,
                                                          const float *ccl_restrict variance_image,
@@ -26,20 +37,34 @@ ccl_device_inline void kernel_filter_nlm_calc_difference(int dx, int dy,
                                                          float a,
                                                          float k_2)
 {
+	/* Channels are accumulated row by row, so the inner loop has no
+	 * branches or strided accesses and is vectorized by the compiler. */
+	const int numChannels = channel_offset? 3 : 1;
+	const int q_ofs = dy*w + dx;
+
 	for(int y = rect.y; y < rect.w; y++) {
+		float *ccl_restrict out_row = difference_image + y*w;
+
 		for(int x = rect.x; x < rect.z; x++) {
-			float diff = 0.0f;
-			int numChannels = channel_offset? 3 : 1;
-			for(int c = 0; c < numChannels; c++) {
-				float cdiff = weight_image[c*channel_offset + y*w+x] - weight_image[c*channel_offset + (y+dy)*w+(x+dx)];
-				float pvar = variance_image[c*channel_offset + y*w+x];
-				float qvar = variance_image[c*channel_offset + (y+dy)*w+(x+dx)];
-				diff += (cdiff*cdiff - a*(pvar + min(pvar, qvar))) / (1e-8f + k_2*(pvar+qvar));
+			out_row[x] = 0.0f;
+		}
+
+		for(int c = 0; c < numChannels; c++) {
+			const float *ccl_restrict p_weight = weight_image + c*channel_offset + y*w;
+			const float *ccl_restrict p_var = variance_image + c*channel_offset + y*w;
+
+			for(int x = rect.x; x < rect.z; x++) {
+				float cdiff = p_weight[x] - p_weight[x + q_ofs];
+				float pvar = p_var[x];
+				float qvar = p_var[x + q_ofs];
+				out_row[x] += (cdiff*cdiff - a*(pvar + min(pvar, qvar))) / (1e-8f + k_2*(pvar+qvar));
 			}
-			if(numChannels > 1) {
-				diff *= 1.0f/numChannels;
+		}
+
+		if(numChannels > 1) {
+			for(int x = rect.x; x < rect.z; x++) {
+				out_row[x] *= 1.0f/numChannels;
 			}
-			difference_image[y*w+x] = diff;
 		}
 	}
 }
@@ -54,23 +79,59 @@ ccl_device_inline void kernel_filter_nlm_blur(const float *ccl_restrict differen
 	int aligned_lowx = (rect.x & ~(3));
 	int aligned_highx = ((rect.z + 3) & ~(3));
 #endif
+	/* Vertical box filter as a running sum: each row adds the row entering
+	 * the window and subtracts the one leaving it, instead of summing all
+	 * 2f+1 rows again. Rows are normalized once all sums are done. */
 	for(int y = rect.y; y < rect.w; y++) {
-		const int low = max(rect.y, y-f);
-		const int high = min(rect.w, y+f+1);
-		for(int x = rect.x; x < rect.z; x++) {
-			out_image[y*w+x] = 0.0f;
-		}
-		for(int y1 = low; y1 < high; y1++) {
+		float *out_row = out_image + y*w;
+
+		if(y == rect.y) {
 #ifdef __KERNEL_SSE3__
-			for(int x = aligned_lowx; x < aligned_highx; x+=4) {
-				_mm_store_ps(out_image + y*w+x, _mm_add_ps(_mm_load_ps(out_image + y*w+x), _mm_load_ps(difference_image + y1*w+x)));
-			}
+			for(int x = aligned_lowx; x < aligned_highx; x++) {
 #else
 			for(int x = rect.x; x < rect.z; x++) {
-				out_image[y*w+x] += difference_image[y1*w+x];
+#endif
+				out_row[x] = 0.0f;
 			}
+			for(int y1 = rect.y; y1 < min(rect.w, y+f+1); y1++) {
+				const float *diff_row = difference_image + y1*w;
+#ifdef __KERNEL_SSE3__
+				for(int x = aligned_lowx; x < aligned_highx; x+=4) {
+					_mm_store_ps(out_row + x, _mm_add_ps(_mm_load_ps(out_row + x), _mm_load_ps(diff_row + x)));
+				}
+#else
+				for(int x = rect.x; x < rect.z; x++) {
+					out_row[x] += diff_row[x];
+				}
 #endif
+			}
+			continue;
 		}
+
+		const float *prev_row = out_row - w;
+		const float *add_row = (y+f < rect.w)? difference_image + (y+f)*w: NULL;
+		const float *sub_row = (y-f-1 >= rect.y)? difference_image + (y-f-1)*w: NULL;
+
+#ifdef __KERNEL_SSE3__
+		for(int x = aligned_lowx; x < aligned_highx; x+=4) {
+			__m128 sum = _mm_load_ps(prev_row + x);
+			if(add_row) sum = _mm_add_ps(sum, _mm_load_ps(add_row + x));
+			if(sub_row) sum = _mm_sub_ps(sum, _mm_load_ps(sub_row + x));
+			_mm_store_ps(out_row + x, sum);
+		}
+#else
+		for(int x = rect.x; x < rect.z; x++) {
+			float sum = prev_row[x];
+			if(add_row) sum += add_row[x];
+			if(sub_row) sum -= sub_row[x];
+			out_row[x] = sum;
+		}
+#endif
+	}
+
+	for(int y = rect.y; y < rect.w; y++) {
+		const int low = max(rect.y, y-f);
+		const int high = min(rect.w, y+f+1);
 		for(int x = rect.x; x < rect.z; x++) {
 			out_image[y*w+x] *= 1.0f/(high - low);
 		}
@@ -83,25 +144,19 @@ ccl_device_inline void kernel_filter_nlm_calc_weight(const float *ccl_restrict d
                                                      int w,
                                                      int f)
 {
+	/* Horizontal box filter as a running sum along each row. */
 	for(int y = rect.y; y < rect.w; y++) {
+		const float *diff_row = difference_image + y*w;
+		float *out_row = out_image + y*w;
+		float sum = kernel_filter_nlm_window_sum(diff_row, rect.x-1, rect.x, rect.z, f);
+
 		for(int x = rect.x; x < rect.z; x++) {
-			out_image[y*w+x] = 0.0f;
-		}
-	}
-	for(int dx = -f; dx <= f; dx++) {
-		int pos_dx = max(0, dx);
-		int neg_dx = min(0, dx);
-		for(int y = rect.y; y < rect.w; y++) {
-			for(int x = rect.x-neg_dx; x < rect.z-pos_dx; x++) {
-				out_image[y*w+x] += difference_image[y*w+dx+x];
-			}
-		}
-	}
-	for(int y = rect.y; y < rect.w; y++) {
-		for(int x = rect.x; x < rect.z; x++) {
+			if(x+f < rect.z) sum += diff_row[x+f];
+			if(x-f-1 >= rect.x) sum -= diff_row[x-f-1];
+
 			const int low = max(rect.x, x-f);
 			const int high = min(rect.z, x+f+1);
-			out_image[y*w+x] = fast_expf(-max(out_image[y*w+x] * (1.0f/(high - low)), 0.0f));
+			out_row[x] = fast_expf(-max(sum * (1.0f/(high - low)), 0.0f));
 		}
 	}
 }
@@ -116,13 +171,15 @@ ccl_device_inline void kernel_filter_nlm_update_output(int dx, int dy,
                                                        int f)
 {
 	for(int y = rect.y; y < rect.w; y++) {
+		const float *diff_row = difference_image + y*w;
+		float sum = kernel_filter_nlm_window_sum(diff_row, rect.x-1, rect.x, rect.z, f);
+
 		for(int x = rect.x; x < rect.z; x++) {
+			if(x+f < rect.z) sum += diff_row[x+f];
+			if(x-f-1 >= rect.x) sum -= diff_row[x-f-1];
+
 			const int low = max(rect.x, x-f);
 			const int high = min(rect.z, x+f+1);
-			float sum = 0.0f;
-			for(int x1 = low; x1 < high; x1++) {
-				sum += difference_image[y*w+x1];
-			}
 			float weight = sum * (1.0f/(high - low));
 			accum_image[y*w+x] += weight;
 			out_image[y*w+x] += weight*image[(y+dy)*w+(x+dx)];
@@ -145,14 +202,17 @@ ccl_device_inline void kernel_filter_nlm_construct_gramian(int dx, int dy,
 	/* fy and fy are in filter-window-relative coordinates, while x and y are in feature-window-relative coordinates. */
 	for(int fy = max(0, rect.y-filter_rect.y); fy < min(filter_rect.w, rect.w-filter_rect.y); fy++) {
 		int y = fy + filter_rect.y;
-		for(int fx = max(0, rect.x-filter_rect.x); fx < min(filter_rect.z, rect.z-filter_rect.x); fx++) {
+		const float *diff_row = difference_image + y*w;
+		const int fx_start = max(0, rect.x-filter_rect.x);
+		float sum = kernel_filter_nlm_window_sum(diff_row, fx_start + filter_rect.x - 1, rect.x, rect.z, f);
+
+		for(int fx = fx_start; fx < min(filter_rect.z, rect.z-filter_rect.x); fx++) {
 			int x = fx + filter_rect.x;
+			if(x+f < rect.z) sum += diff_row[x+f];
+			if(x-f-1 >= rect.x) sum -= diff_row[x-f-1];
+
 			const int low = max(rect.x, x-f);
 			const int high = min(rect.z, x+f+1);
-			float sum = 0.0f;
-			for(int x1 = low; x1 < high; x1++) {
-				sum += difference_image[y*w+x1];
-			}
 			float weight = sum * (1.0f/(high - low));
 
 			int storage_ofs = fy*filter_rect.z + fx;
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2011-2017 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+CCL_NAMESPACE_BEGIN
+
+/* Adaptive Sampling
+ *
+ * The auxiliary pass holds the sum of the odd samples only, comparing its
+ * average to the average of all samples gives an estimate of the pixel noise.
+ * Its last component stores the number of samples the pixel converged at,
+ * zero while it is still sampled. */
+
+ccl_device bool kernel_adaptive_stopping(KernelGlobals *kg, ccl_global float *buffer, int sample)
+{
+	ccl_global float *aux = buffer + kernel_data.film.pass_adaptive_aux;
+
+	if(aux[3] != 0.0f) {
+		return true;
+	}
+	else if(sample < 2) {
+		return false;
+	}
+
+	/* Samples 1, 3, 5 ... are in the auxiliary pass. */
+	const float inv_sample = 1.0f / (float)sample;
+	const float inv_half_sample = 1.0f / (float)(sample / 2);
+
+	const float3 I = make_float3(buffer[0], buffer[1], buffer[2]) * inv_sample;
+	const float3 A = make_float3(aux[0], aux[1], aux[2]) * inv_half_sample;
+
+	/* The per pixel error of "A hierarchical automatic stopping condition
+	 * for Monte Carlo global illumination", relative to the square root of
+	 * the intensity so dark areas are not over-sampled. */
+	const float error = (fabsf(I.x - A.x) + fabsf(I.y - A.y) + fabsf(I.z - A.z)) /
+	                    sqrtf(max(I.x + I.y + I.z, 1e-4f));
+
+	if(error < kernel_data.integrator.adaptive_threshold) {
+		aux[3] = (float)sample;
+		return true;
+	}
+
+	return false;
+}
+
+/* Scale the passes of a pixel that converged before the end of its tile,
+ * as if it had received all the \a sample samples. Film conversion divides
+ * every pixel by the same sample count. */
+ccl_device void kernel_adaptive_adjust_samples(KernelGlobals *kg, ccl_global float *buffer, int sample)
+{
+	ccl_global float *aux = buffer + kernel_data.film.pass_adaptive_aux;
+
+	if(aux[3] == 0.0f || aux[3] == (float)sample) {
+		return;
+	}
+
+	const float sample_multiplier = (float)sample / aux[3];
+	const int pass_end = (kernel_data.film.pass_denoising_data)?
+	                     kernel_data.film.pass_denoising_data:
+	                     kernel_data.film.pass_adaptive_aux;
+	const int flag = kernel_data.film.pass_flag;
+
+	for(int i = 0; i < pass_end; i++) {
+		/* These passes are not accumulated over samples. */
+		if(((flag & PASS_DEPTH) && i == kernel_data.film.pass_depth) ||
+		   ((flag & PASS_OBJECT_ID) && i == kernel_data.film.pass_object_id) ||
+		   ((flag & PASS_MATERIAL_ID) && i == kernel_data.film.pass_material_id))
+		{
+			continue;
+		}
+		buffer[i] *= sample_multiplier;
+	}
+
+	aux[3] = (float)sample;
+}
+
+CCL_NAMESPACE_END
@@ -51,6 +51,17 @@ ccl_device_inline void kernel_write_debug_passes(KernelGlobals *kg,
 		                        sample,
 		                        debug_data->num_ray_bounces);
 	}
+	if(flag & PASS_SHADER_NODES) {
+		kernel_write_pass_float(buffer + kernel_data.film.pass_shader_nodes,
+		                        sample,
+		                        state->num_shader_nodes);
+	}
+
+	kernel_stats_add(kg, num_paths, 1);
+	kernel_stats_add(kg, num_rays, debug_data->num_ray_bounces);
+	kernel_stats_add(kg, num_bvh_traversed_nodes, debug_data->num_bvh_traversed_nodes);
+	kernel_stats_add(kg, num_bvh_traversed_instances, debug_data->num_bvh_traversed_instances);
+	kernel_stats_add(kg, num_bvh_intersections, debug_data->num_bvh_intersections);
 }
 
 CCL_NAMESPACE_END
@@ -100,6 +100,8 @@ ccl_device_noinline bool direct_emission(KernelGlobals *kg,
 	if(ls->pdf == 0.0f)
 		return false;
 
+	kernel_stats_add(kg, num_light_samples, 1);
+
 	/* todo: implement */
 	differential3 dD = differential3_zero();
 
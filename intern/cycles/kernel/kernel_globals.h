@@ -20,6 +20,7 @@
 #define __KERNEL_GLOBALS_H__
 
 #ifdef __KERNEL_CPU__
+#  include "util/util_stats.h"
 #  include "util/util_vector.h"
 #endif
 
@@ -78,10 +79,23 @@ typedef struct KernelGlobals {
 
 	int2 global_size;
 	int2 global_id;
+
+#  ifdef __KERNEL_DEBUG__
+	/* Work counters, added to the device statistics after every tile. */
+	KernelStats stats;
+#  endif
 } KernelGlobals;
 
 #endif  /* __KERNEL_CPU__ */
 
+/* Kernel work counters, see KernelStats. */
+
+#if defined(__KERNEL_CPU__) && defined(__KERNEL_DEBUG__)
+#  define kernel_stats_add(kg, counter, value) ((kg)->stats.counter += (value))
+#else
+#  define kernel_stats_add(kg, counter, value)
+#endif
+
 /* For CUDA, constant memory textures must be globals, so we can't put them
  * into a struct. As a result we don't actually use this struct and use actual
  * globals and simply pass along a NULL pointer everywhere, which we hope gets
@@ -848,6 +848,104 @@ ccl_device int light_distribution_sample(KernelGlobals *kg, float randt)
 	return clamp(first-1, 0, kernel_data.integrator.num_distribution-1);
 }
 
+/* Light Tree
+ *
+ * Binary tree over the local emitters at the start of the distribution, see
+ * LightManager::device_update_distribution(). Children are picked based on an
+ * estimate of their contribution to the shading point, within a leaf emitters
+ * are picked proportional to their area like the flat distribution does. */
+
+ccl_device float light_tree_node_importance(KernelGlobals *kg, int node, float3 P)
+{
+	float4 data0 = kernel_tex_fetch(__light_tree_nodes, node*LIGHT_TREE_NODE_SIZE + 0);
+	float4 data1 = kernel_tex_fetch(__light_tree_nodes, node*LIGHT_TREE_NODE_SIZE + 1);
+
+	float3 bbox_min = make_float3(data0.x, data0.y, data0.z);
+	float3 bbox_max = make_float3(data1.x, data1.y, data1.z);
+	float energy = data0.w;
+	float theta_o = data1.w;
+
+	float3 center = 0.5f*(bbox_min + bbox_max);
+	float radius2 = 0.25f*len_squared(bbox_max - bbox_min);
+	float dist2 = len_squared(P - center);
+
+	/* bound the angle between the emission directions of the node and the
+	 * shading point, nothing is culled when the point is inside the bounds */
+	float cos_theta = 1.0f;
+
+	if(theta_o < M_PI_F && dist2 > radius2) {
+		float4 data2 = kernel_tex_fetch(__light_tree_nodes, node*LIGHT_TREE_NODE_SIZE + 2);
+		float3 axis = make_float3(data2.x, data2.y, data2.z);
+		float dist = sqrtf(dist2);
+
+		float theta = safe_acosf(dot(axis, (P - center)/dist));
+		float theta_u = safe_asinf(sqrtf(radius2)/dist);
+		float theta_min = max(theta - theta_o - theta_u, 0.0f);
+
+		if(theta_min >= M_PI_2_F)
+			return 0.0f;
+
+		cos_theta = cosf(theta_min);
+	}
+
+	return energy*cos_theta/max(max(dist2, radius2), 1e-8f);
+}
+
+/* Returns the index of the sampled emitter, tree_factor is the ratio of its
+ * selection probability to the one of the flat distribution. */
+ccl_device int light_tree_sample(KernelGlobals *kg, float3 P, float randt, float *tree_factor)
+{
+	int node = 0;
+	float pdf = 1.0f;
+
+	while(true) {
+		float4 data3 = kernel_tex_fetch(__light_tree_nodes, node*LIGHT_TREE_NODE_SIZE + 3);
+		int right = __float_as_int(data3.x);
+
+		if(right == -1) {
+			int first = __float_as_int(data3.y);
+			int num = __float_as_int(data3.z);
+			float energy = kernel_tex_fetch(__light_tree_nodes, node*LIGHT_TREE_NODE_SIZE + 0).w;
+			float cdf_first = kernel_tex_fetch(__light_distribution, first).x;
+			float cdf_last = kernel_tex_fetch(__light_distribution, first + num).x;
+
+			/* energies are relative to the root, which holds all local emitters */
+			*tree_factor = pdf/energy;
+
+			int index = light_distribution_sample(kg, cdf_first + randt*(cdf_last - cdf_first));
+			return clamp(index, first, first + num - 1);
+		}
+
+		int left = node + 1;
+		float importance_left = light_tree_node_importance(kg, left, P);
+		float importance_right = light_tree_node_importance(kg, right, P);
+		float prob_left;
+
+		if(importance_left + importance_right > 0.0f) {
+			prob_left = importance_left/(importance_left + importance_right);
+		}
+		else {
+			float energy_left = kernel_tex_fetch(__light_tree_nodes, left*LIGHT_TREE_NODE_SIZE + 0).w;
+			float energy_right = kernel_tex_fetch(__light_tree_nodes, right*LIGHT_TREE_NODE_SIZE + 0).w;
+			prob_left = energy_left/(energy_left + energy_right);
+		}
+
+		/* reuse the random number for the next level */
+		if(randt < prob_left) {
+			randt = randt/prob_left;
+			pdf *= prob_left;
+			node = left;
+		}
+		else {
+			randt = (randt - prob_left)/(1.0f - prob_left);
+			pdf *= 1.0f - prob_left;
+			node = right;
+		}
+
+		randt = min(randt, 1.0f - 1e-6f);
+	}
+}
+
 /* Generic Light */
 
 ccl_device bool light_select_reached_max_bounces(KernelGlobals *kg, int index, int bounce)
@@ -866,7 +964,18 @@ ccl_device_noinline bool light_sample(KernelGlobals *kg,
                                       LightSample *ls)
 {
 	/* sample index */
-	int index = light_distribution_sample(kg, randt);
+	int index;
+	float tree_factor = 1.0f;
+
+	if(kernel_data.integrator.use_light_tree && randt < kernel_data.integrator.light_tree_pdf) {
+		/* Only the selection probability changes, it is folded into eval_fac
+		 * so MIS keeps using the flat distribution pdf which is also what
+		 * indirect emission evaluates. */
+		index = light_tree_sample(kg, P, randt/kernel_data.integrator.light_tree_pdf, &tree_factor);
+	}
+	else {
+		index = light_distribution_sample(kg, randt);
+	}
 
 	/* fetch light data */
 	float4 l = kernel_tex_fetch(__light_distribution, index);
@@ -881,6 +990,7 @@ ccl_device_noinline bool light_sample(KernelGlobals *kg,
 		ls->D = normalize_len(ls->P - P, &ls->t);
 		ls->pdf = triangle_light_pdf(kg, ls->Ng, -ls->D, ls->t);
 		ls->shader |= shader_flag;
+		ls->eval_fac /= tree_factor;
 		return (ls->pdf > 0.0f);
 	}
 	else {
@@ -890,7 +1000,12 @@ ccl_device_noinline bool light_sample(KernelGlobals *kg,
 			return false;
 		}
 
-		return lamp_light_sample(kg, lamp, randu, randv, P, ls);
+		if(!lamp_light_sample(kg, lamp, randu, randv, P, ls)) {
+			return false;
+		}
+
+		ls->eval_fac /= tree_factor;
+		return true;
 	}
 }
 
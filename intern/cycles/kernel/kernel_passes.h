@@ -333,6 +333,30 @@ ccl_device_inline void kernel_write_light_passes(KernelGlobals *kg, ccl_global f
 #endif
 }
 
+/* Sum of the odd samples for adaptive sampling, see kernel_adaptive_stopping. */
+ccl_device_inline void kernel_write_adaptive_aux(KernelGlobals *kg, ccl_global float *buffer,
+	int sample, float3 L_sum)
+{
+	if(kernel_data.film.pass_adaptive_aux == 0) {
+		return;
+	}
+
+	ccl_global float *aux = buffer + kernel_data.film.pass_adaptive_aux;
+
+	if(sample == 0) {
+		/* Also resets the convergence sample count. */
+		kernel_write_pass_float(aux + 0, sample, 0.0f);
+		kernel_write_pass_float(aux + 1, sample, 0.0f);
+		kernel_write_pass_float(aux + 2, sample, 0.0f);
+		kernel_write_pass_float(aux + 3, sample, 0.0f);
+	}
+	else if(sample & 1) {
+		kernel_write_pass_float(aux + 0, sample, L_sum.x);
+		kernel_write_pass_float(aux + 1, sample, L_sum.y);
+		kernel_write_pass_float(aux + 2, sample, L_sum.z);
+	}
+}
+
 ccl_device_inline void kernel_write_result(KernelGlobals *kg, ccl_global float *buffer,
 	int sample, PathRadiance *L, float alpha, bool is_shadow_catcher)
 {
@@ -349,6 +373,7 @@ ccl_device_inline void kernel_write_result(KernelGlobals *kg, ccl_global float *
 		}
 
 		kernel_write_pass_float4(buffer, sample, make_float4(L_sum.x, L_sum.y, L_sum.z, alpha));
+		kernel_write_adaptive_aux(kg, buffer, sample, L_sum);
 
 		kernel_write_light_passes(kg, buffer, L, sample);
 
@@ -392,6 +417,7 @@ ccl_device_inline void kernel_write_result(KernelGlobals *kg, ccl_global float *
 	}
 	else {
 		kernel_write_pass_float4(buffer, sample, make_float4(0.0f, 0.0f, 0.0f, 0.0f));
+		kernel_write_adaptive_aux(kg, buffer, sample, make_float3(0.0f, 0.0f, 0.0f));
 
 #ifdef __DENOISING_FEATURES__
 		if(kernel_data.film.pass_denoising_data) {
@@ -29,6 +29,10 @@ ccl_device_inline void path_state_init(KernelGlobals *kg,
 	state->sample = sample;
 	state->num_samples = kernel_data.integrator.aa_samples;
 
+#ifdef __KERNEL_DEBUG__
+	state->num_shader_nodes = 0;
+#endif
+
 	state->bounce = 0;
 	state->diffuse_bounce = 0;
 	state->glossy_bounce = 0;
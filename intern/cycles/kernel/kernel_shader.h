@@ -870,6 +870,8 @@ ccl_device void shader_eval_surface(KernelGlobals *kg, ShaderData *sd, RNG *rng,
 	sd->num_closure_extra = 0;
 	sd->randb_closure = randb;
 
+	kernel_stats_add(kg, num_shader_evals, 1);
+
 #ifdef __OSL__
 	if(kg->osl)
 		OSLShader::eval_surface(kg, sd, state, path_flag, ctx);
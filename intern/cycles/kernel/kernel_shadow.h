@@ -421,6 +421,7 @@ ccl_device_inline bool shadow_blocked(KernelGlobals *kg,
 	if(ray->t == 0.0f) {
 		return false;
 	}
+	kernel_stats_add(kg, num_shadow_rays, 1);
 #ifdef __SHADOW_TRICKS__
 	const int skip_object = state->catcher_object;
 #else
@@ -38,6 +38,7 @@ CCL_NAMESPACE_BEGIN
 #define OBJECT_SIZE 		12
 #define OBJECT_VECTOR_SIZE	6
 #define LIGHT_SIZE		11
+#define LIGHT_TREE_NODE_SIZE	4
 #define FILTER_TABLE_SIZE	1024
 #define RAMP_TABLE_SIZE		256
 #define SHUTTER_TABLE_SIZE		256
@@ -81,6 +82,9 @@ CCL_NAMESPACE_BEGIN
 #  ifdef __KERNEL_SSE2__
 #    define __QBVH__
 #  endif
+#  ifdef __KERNEL_AVX2__
+#    define __OBVH__
+#  endif
 #  define __KERNEL_SHADING__
 #  define __KERNEL_ADV_SHADING__
 #  define __BRANCHED_PATH__
@@ -241,6 +245,12 @@ CCL_NAMESPACE_BEGIN
 #ifdef __NO_DENOISING__
 #  undef __DENOISING_FEATURES__
 #endif
+#ifdef __NO_AO__
+#  undef __AO__
+#endif
+#ifdef __NO_BACKGROUND_MIS__
+#  undef __BACKGROUND_MIS__
+#endif
 
 /* Random Numbers */
 
@@ -398,6 +408,7 @@ typedef enum PassType {
 	PASS_BVH_TRAVERSED_INSTANCES = (1 << 27),
 	PASS_BVH_INTERSECTIONS = (1 << 28),
 	PASS_RAY_BOUNCES = (1 << 29),
+	PASS_SHADER_NODES = (1 << 30),
 #endif
 } PassType;
 
@@ -1031,6 +1042,11 @@ typedef struct PathState {
 #ifdef __SHADOW_TRICKS__
 	int catcher_object;
 #endif
+
+#ifdef __KERNEL_DEBUG__
+	/* SVM nodes executed for all shader evaluations along the path. */
+	int num_shader_nodes;
+#endif
 } PathState;
 
 /* Subsurface */
@@ -1184,7 +1200,7 @@ typedef struct KernelFilm {
 	int pass_shadow;
 	float pass_shadow_scale;
 	int filter_table_offset;
-	int pass_pad2;
+	int pass_adaptive_aux;
 
 	int pass_mist;
 	float mist_start;
@@ -1201,6 +1217,8 @@ typedef struct KernelFilm {
 	int pass_bvh_traversed_instances;
 	int pass_bvh_intersections;
 	int pass_ray_bounces;
+	int pass_shader_nodes;
+	int pad1, pad2, pad3;
 #endif
 } KernelFilm;
 static_assert_align(KernelFilm, 16);
@@ -1288,7 +1306,15 @@ typedef struct KernelIntegrator {
 	float light_inv_rr_threshold;
 
 	int start_sample;
-	int pad1;
+
+	/* adaptive sampling */
+	int adaptive_min_samples;
+	float adaptive_threshold;
+	int adaptive_step;
+
+	/* light tree */
+	int use_light_tree;
+	float light_tree_pdf;
 } KernelIntegrator;
 static_assert_align(KernelIntegrator, 16);
 
@@ -1301,7 +1327,7 @@ typedef struct KernelBVH {
 	int have_instancing;
 	int use_qbvh;
 	int use_bvh_steps;
-	int pad1;
+	int use_bvh8;
 } KernelBVH;
 static_assert_align(KernelBVH, 16);
 
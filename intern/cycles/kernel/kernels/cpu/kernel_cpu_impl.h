@@ -32,6 +32,7 @@
 
 #    include "kernel/kernels/cpu/kernel_cpu_image.h"
 #    include "kernel/kernel_film.h"
+#    include "kernel/kernel_adaptive_sampling.h"
 #    include "kernel/kernel_path.h"
 #    include "kernel/kernel_path_branched.h"
 #    include "kernel/kernel_bake.h"
@@ -102,6 +103,39 @@ void KERNEL_FUNCTION_FULL_NAME(path_trace)(KernelGlobals *kg,
 #endif /* KERNEL_STUB */
 }
 
+/* Adaptive Sampling */
+
+bool KERNEL_FUNCTION_FULL_NAME(adaptive_stopping)(KernelGlobals *kg,
+                                                  float *buffer,
+                                                  int sample,
+                                                  int x, int y,
+                                                  int offset,
+                                                  int stride)
+{
+#ifdef KERNEL_STUB
+	STUB_ASSERT(KERNEL_ARCH, adaptive_stopping);
+	return false;
+#else
+	int index = offset + x + y*stride;
+	return kernel_adaptive_stopping(kg, buffer + index*kernel_data.film.pass_stride, sample);
+#endif /* KERNEL_STUB */
+}
+
+void KERNEL_FUNCTION_FULL_NAME(adaptive_adjust_samples)(KernelGlobals *kg,
+                                                        float *buffer,
+                                                        int sample,
+                                                        int x, int y,
+                                                        int offset,
+                                                        int stride)
+{
+#ifdef KERNEL_STUB
+	STUB_ASSERT(KERNEL_ARCH, adaptive_adjust_samples);
+#else
+	int index = offset + x + y*stride;
+	kernel_adaptive_adjust_samples(kg, buffer + index*kernel_data.film.pass_stride, sample);
+#endif /* KERNEL_STUB */
+}
+
 /* Film */
 
 void KERNEL_FUNCTION_FULL_NAME(convert_to_byte)(KernelGlobals *kg,
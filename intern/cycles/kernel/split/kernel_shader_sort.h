@@ -16,6 +16,50 @@
 
 CCL_NAMESPACE_BEGIN
 
+#ifdef __KERNEL_CPU__
+/* Order of two items in the sorted block, by shader and then by position in
+ * the queue so rays with the same shader keep their order.
+ */
+ccl_device_inline bool shader_sort_less(const uint *value, ushort a, ushort b)
+{
+	return (value[a] < value[b]) || (value[a] == value[b] && a < b);
+}
+
+ccl_device_inline void shader_sort_sift_down(const uint *value,
+                                             ushort *index,
+                                             uint root,
+                                             uint size)
+{
+	for(uint child = 2*root + 1; child < size; child = 2*root + 1) {
+		if(child + 1 < size && shader_sort_less(value, index[child], index[child + 1])) {
+			child++;
+		}
+		if(!shader_sort_less(value, index[root], index[child])) {
+			break;
+		}
+		ushort tmp = index[root];
+		index[root] = index[child];
+		index[child] = tmp;
+		root = child;
+	}
+}
+
+/* In-place heap sort of the first size indices, the CPU split kernel handles
+ * a whole block in a single work item so there is nothing to parallelize.
+ */
+ccl_device void shader_sort_indices(const uint *value, ushort *index, uint size)
+{
+	for(uint i = size/2; i > 0; i--) {
+		shader_sort_sift_down(value, index, i - 1, size);
+	}
+	for(uint end = size; end > 1; end--) {
+		ushort tmp = index[0];
+		index[0] = index[end - 1];
+		index[end - 1] = tmp;
+		shader_sort_sift_down(value, index, 0, end - 1);
+	}
+}
+#endif  /* __KERNEL_CPU__ */
 
 ccl_device void kernel_shader_sort(KernelGlobals *kg,
                                    ccl_local_param ShaderSortLocals *locals)
@@ -55,7 +99,6 @@ ccl_device void kernel_shader_sort(KernelGlobals *kg,
 	}
 	ccl_barrier(CCL_LOCAL_MEM_FENCE);
 
-	/* skip sorting for cpu split kernel */
 #  ifdef __KERNEL_OPENCL__
 
 	/* bitonic sort */
@@ -78,6 +121,11 @@ ccl_device void kernel_shader_sort(KernelGlobals *kg,
 			}
 		}
 	}
+#  else
+	/* Sort rays of the CPU split kernel stream, so shader evaluation runs
+	 * rays with the same shader back to back.
+	 */
+	shader_sort_indices(local_value, local_index, min((int)(qsize - offset), SHADER_SORT_BLOCK_SIZE));
 #  endif /* __KERNEL_OPENCL__ */
 
 	/* copy to destination */
@@ -197,6 +197,10 @@ ccl_device_noinline void svm_eval_nodes(KernelGlobals *kg, ShaderData *sd, ccl_a
 	while(1) {
 		uint4 node = read_node(kg, &offset);
 
+#ifdef __KERNEL_DEBUG__
+		state->num_shader_nodes++;
+#endif
+
 		switch(node.x) {
 #if NODES_GROUP(NODE_GROUP_LEVEL_0)
 			case NODE_SHADER_JUMP: {
@@ -137,44 +137,58 @@ bool BakeManager::bake(Device *device, DeviceScene *dscene, Scene *scene, Progre
 
 	int num_samples = is_aa_pass(shader_type)? scene->integrator->aa_samples : 1;
 
-	/* calculate the total pixel samples for the progress bar */
-	total_pixel_samples = 0;
-	for(size_t shader_offset = 0; shader_offset < num_pixels; shader_offset += m_shader_limit) {
-		size_t shader_size = (size_t)fminf(num_pixels - shader_offset, m_shader_limit);
-		total_pixel_samples += shader_size * num_samples;
+	/* only bake pixels covered by a primitive, texture atlases and lightmaps
+	 * have large empty areas between islands which would otherwise take the
+	 * same device memory and transfers as the baked pixels */
+	vector<size_t> valid_pixels;
+	valid_pixels.reserve(num_pixels);
+
+	for(size_t i = 0; i < num_pixels; i++) {
+		if(bake_data->is_valid(i))
+			valid_pixels.push_back(i);
 	}
+
+	const size_t num_valid_pixels = valid_pixels.size();
+
+	/* calculate the total pixel samples for the progress bar */
+	total_pixel_samples = num_valid_pixels * num_samples;
 	progress.reset_sample();
 	progress.set_total_pixel_samples(total_pixel_samples);
 
-	for(size_t shader_offset = 0; shader_offset < num_pixels; shader_offset += m_shader_limit) {
-		size_t shader_size = (size_t)fminf(num_pixels - shader_offset, m_shader_limit);
+	if(num_valid_pixels == 0) {
+		m_is_baking = false;
+		return true;
+	}
 
-		/* setup input for device task */
-		device_vector<uint4> d_input;
-		uint4 *d_input_data = d_input.resize(shader_size * 2);
-		size_t d_input_size = 0;
+	/* device buffers are allocated once and reused for all chunks */
+	const size_t max_shader_size = min(num_valid_pixels, m_shader_limit);
 
-		for(size_t i = shader_offset; i < (shader_offset + shader_size); i++) {
-			d_input_data[d_input_size++] = bake_data->data(i);
-			d_input_data[d_input_size++] = bake_data->differentials(i);
-		}
+	device_vector<uint4> d_input;
+	uint4 *d_input_data = d_input.resize(max_shader_size * 2);
+	device_vector<float4> d_output;
+	d_output.resize(max_shader_size);
 
-		if(d_input_size == 0) {
-			m_is_baking = false;
-			return false;
-		}
+	/* needs to be up to data for attribute access */
+	device->const_copy_to("__data", &dscene->data, sizeof(dscene->data));
 
-		/* run device task */
-		device_vector<float4> d_output;
-		d_output.resize(shader_size);
+	device->mem_alloc("bake_input", d_input, MEM_READ_ONLY);
+	device->mem_alloc("bake_output", d_output, MEM_READ_WRITE);
+
+	bool success = true;
+
+	for(size_t shader_offset = 0; shader_offset < num_valid_pixels; shader_offset += max_shader_size) {
+		size_t shader_size = min(num_valid_pixels - shader_offset, max_shader_size);
 
-		/* needs to be up to data for attribute access */
-		device->const_copy_to("__data", &dscene->data, sizeof(dscene->data));
+		/* setup input for device task */
+		for(size_t i = 0; i < shader_size; i++) {
+			size_t pixel = valid_pixels[shader_offset + i];
+			d_input_data[i * 2] = bake_data->data(pixel);
+			d_input_data[i * 2 + 1] = bake_data->differentials(pixel);
+		}
 
-		device->mem_alloc("bake_input", d_input, MEM_READ_ONLY);
 		device->mem_copy_to(d_input);
-		device->mem_alloc("bake_output", d_output, MEM_READ_WRITE);
 
+		/* run device task */
 		DeviceTask task(DeviceTask::SHADER);
 		task.shader_input = d_input.device_pointer;
 		task.shader_output = d_output.device_pointer;
@@ -182,7 +196,7 @@ bool BakeManager::bake(Device *device, DeviceScene *dscene, Scene *scene, Progre
 		task.shader_filter = pass_filter;
 		task.shader_x = 0;
 		task.offset = shader_offset;
-		task.shader_w = d_output.size();
+		task.shader_w = shader_size;
 		task.num_samples = num_samples;
 		task.get_cancel = function_bind(&Progress::get_cancel, &progress);
 		task.update_progress_sample = function_bind(&Progress::add_samples_update, &progress, _1, _2);
@@ -191,36 +205,30 @@ bool BakeManager::bake(Device *device, DeviceScene *dscene, Scene *scene, Progre
 		device->task_wait();
 
 		if(progress.get_cancel()) {
-			device->mem_free(d_input);
-			device->mem_free(d_output);
-			m_is_baking = false;
-			return false;
+			success = false;
+			break;
 		}
 
-		device->mem_copy_from(d_output, 0, 1, d_output.size(), sizeof(float4));
-		device->mem_free(d_input);
-		device->mem_free(d_output);
+		device->mem_copy_from(d_output, 0, 1, shader_size, sizeof(float4));
 
 		/* read result */
-		int k = 0;
+		float4 *output = (float4*)d_output.data_pointer;
 
-		float4 *offset = (float4*)d_output.data_pointer;
+		for(size_t i = 0; i < shader_size; i++) {
+			size_t index = valid_pixels[shader_offset + i] * 4;
+			float4 out = output[i];
 
-		size_t depth = 4;
-		for(size_t i=shader_offset; i < (shader_offset + shader_size); i++) {
-			size_t index = i * depth;
-			float4 out = offset[k++];
-
-			if(bake_data->is_valid(i)) {
-				for(size_t j=0; j < 4; j++) {
-					result[index + j] = out[j];
-				}
+			for(size_t j = 0; j < 4; j++) {
+				result[index + j] = out[j];
 			}
 		}
 	}
 
+	device->mem_free(d_input);
+	device->mem_free(d_output);
+
 	m_is_baking = false;
-	return true;
+	return success;
 }
 
 void BakeManager::device_update(Device * /*device*/,
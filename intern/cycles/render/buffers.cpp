@@ -21,6 +21,7 @@
 
 #include "util/util_debug.h"
 #include "util/util_foreach.h"
+#include "util/util_half.h"
 #include "util/util_hash.h"
 #include "util/util_image.h"
 #include "util/util_math.h"
@@ -44,6 +45,7 @@ BufferParams::BufferParams()
 
 	denoising_data_pass = false;
 	denoising_clean_pass = false;
+	adaptive_aux_pass = false;
 
 	Pass::add(PASS_COMBINED, passes);
 }
@@ -77,6 +79,10 @@ int BufferParams::get_passes_size()
 		if(denoising_clean_pass) size += DENOISING_PASS_SIZE_CLEAN;
 	}
 
+	if(adaptive_aux_pass) {
+		size += 4;
+	}
+
 	return align_up(size, 4);
 }
 
@@ -170,6 +176,53 @@ bool RenderBuffers::copy_from_device(Device *from_device)
 	return true;
 }
 
+/* Get the combined pass as needed for progressive updates, converted to half
+ * float on the device so only a fraction of the buffer with all its passes is
+ * transferred. Only useful for discrete devices, and the device must not be
+ * busy rendering since the conversion is a device task. */
+bool RenderBuffers::get_combined_rect_from_device(int sample, float *pixels)
+{
+	if(!buffer.device_pointer || device->info.type == DEVICE_CPU)
+		return false;
+
+	device_vector<half4> rgba_half;
+	rgba_half.resize(params.width, params.height);
+	device->mem_alloc("rgba_half", rgba_half, MEM_WRITE_ONLY);
+
+	DeviceTask task(DeviceTask::FILM_CONVERT);
+	task.x = params.full_x;
+	task.y = params.full_y;
+	task.w = params.width;
+	task.h = params.height;
+	task.rgba_half = rgba_half.device_pointer;
+	task.buffer = buffer.device_pointer;
+	task.sample = sample - 1;
+	params.get_offset_stride(task.offset, task.stride);
+
+	device->task_add(task);
+	device->task_wait();
+
+	device->mem_copy_from(rgba_half, 0, params.width, params.height, sizeof(half4));
+
+	int size = params.width*params.height;
+	half4 *in = (half4*)rgba_half.data_pointer;
+
+	for(int i = 0; i < size; i++, in++, pixels += 4) {
+		float4 f = half4_to_float4(*in);
+
+		pixels[0] = f.x;
+		pixels[1] = f.y;
+		pixels[2] = f.z;
+
+		/* clamp since alpha might be > 1.0 due to russian roulette */
+		pixels[3] = saturate(f.w);
+	}
+
+	device->mem_free(rgba_half);
+
+	return true;
+}
+
 bool RenderBuffers::get_denoising_pass_rect(int offset, float exposure, int sample, int components, float *pixels)
 {
 	float scale = 1.0f/sample;
@@ -245,7 +298,8 @@ bool RenderBuffers::get_pass_rect(PassType type, float exposure, int sample, int
 			else if(type == PASS_BVH_TRAVERSED_NODES ||
 			        type == PASS_BVH_TRAVERSED_INSTANCES ||
 			        type == PASS_BVH_INTERSECTIONS ||
-			        type == PASS_RAY_BOUNCES)
+			        type == PASS_RAY_BOUNCES ||
+			        type == PASS_SHADER_NODES)
 			{
 				for(int i = 0; i < size; i++, in += pass_stride, pixels++) {
 					float f = *in;
@@ -54,6 +54,8 @@ public:
 	bool denoising_data_pass;
 	/* If only some light path types should be denoised, an additional pass is needed. */
 	bool denoising_clean_pass;
+	/* Convergence estimate of adaptive sampling, see kernel_adaptive_sampling.h. */
+	bool adaptive_aux_pass;
 
 	/* functions */
 	BufferParams();
@@ -85,6 +87,7 @@ public:
 	void reset(Device *device, BufferParams& params);
 
 	bool copy_from_device(Device *from_device = NULL);
+	bool get_combined_rect_from_device(int sample, float *pixels);
 	bool get_pass_rect(PassType type, float exposure, int sample, int components, float *pixels);
 	bool get_denoising_pass_rect(int offset, float exposure, int sample, int components, float *pixels);
 
@@ -16,6 +16,7 @@
 
 #include "render/constant_fold.h"
 #include "render/graph.h"
+#include "render/nodes.h"
 
 #include "util/util_foreach.h"
 #include "util/util_logging.h"
@@ -354,6 +355,89 @@ void ConstantFolder::fold_math(NodeMath type, bool clamp) const
 		default:
 			break;
 	}
+
+	/* Fuse with the math node before it, unless folded already. */
+	if(!output->links.empty()) {
+		fuse_math(type);
+	}
+}
+
+/* Decompose a math node into X + k or X * k, with X the only linked input
+ * and k constant. Clamping nodes are not linear, so they are skipped. */
+static bool math_node_linear(ShaderNode *node, bool additive, ShaderInput **x_in, float *k)
+{
+	if(node->type != MathNode::node_type) {
+		return false;
+	}
+
+	MathNode *math = static_cast<MathNode*>(node);
+	ShaderInput *value1_in = math->input("Value1");
+	ShaderInput *value2_in = math->input("Value2");
+
+	if(math->use_clamp || (value1_in->link != NULL) == (value2_in->link != NULL)) {
+		return false;
+	}
+
+	switch(math->type) {
+		case NODE_MATH_ADD:
+			if(!additive) return false;
+			*x_in = (value1_in->link)? value1_in: value2_in;
+			*k = (value1_in->link)? math->value2: math->value1;
+			return true;
+		case NODE_MATH_SUBTRACT:
+			if(!additive || !value1_in->link) return false;
+			*x_in = value1_in;
+			*k = -math->value2;
+			return true;
+		case NODE_MATH_MULTIPLY:
+			if(additive) return false;
+			*x_in = (value1_in->link)? value1_in: value2_in;
+			*k = (value1_in->link)? math->value2: math->value1;
+			return true;
+		case NODE_MATH_DIVIDE:
+			if(additive || !value1_in->link || math->value2 == 0.0f) return false;
+			*x_in = value1_in;
+			*k = 1.0f / math->value2;
+			return true;
+		default:
+			return false;
+	}
+}
+
+void ConstantFolder::fuse_math(NodeMath type) const
+{
+	const bool additive = (type == NODE_MATH_ADD || type == NODE_MATH_SUBTRACT);
+
+	/* (X + a) + b == X + (a + b), (X * a) * b == X * (a * b) */
+	ShaderInput *x_in, *inner_x_in;
+	float k, inner_k;
+
+	if(!math_node_linear(node, additive, &x_in, &k)) {
+		return;
+	}
+
+	ShaderOutput *inner_out = x_in->link;
+	ShaderNode *inner = inner_out->parent;
+
+	/* The inner node stays when it has other users, fusing would then only
+	 * add work. */
+	if(inner_out->links.size() != 1 ||
+	   !math_node_linear(inner, additive, &inner_x_in, &inner_k))
+	{
+		return;
+	}
+
+	VLOG(1) << "Fusing " << inner->name << " into " << node->name << ".";
+
+	MathNode *math = static_cast<MathNode*>(node);
+	ShaderOutput *new_x = inner_x_in->link;
+
+	math->type = (additive)? NODE_MATH_ADD: NODE_MATH_MULTIPLY;
+
+	graph->disconnect(math->input("Value1"));
+	graph->disconnect(math->input("Value2"));
+	graph->connect(new_x, math->input("Value1"));
+	math->value2 = (additive)? inner_k + k: inner_k * k;
 }
 
 void ConstantFolder::fold_vector_math(NodeVectorMath type) const
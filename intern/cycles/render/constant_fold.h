@@ -63,6 +63,9 @@ public:
 	void fold_mix(NodeMix type, bool clamp) const;
 	void fold_math(NodeMath type, bool clamp) const;
 	void fold_vector_math(NodeVectorMath type) const;
+
+	/* Fuse math node with a preceding one into a single node. */
+	void fuse_math(NodeMath type) const;
 };
 
 CCL_NAMESPACE_END
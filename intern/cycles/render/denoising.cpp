@@ -0,0 +1,426 @@
+/*
+ * Copyright 2011-2017 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "render/denoising.h"
+
+#include "kernel/kernel_types.h"
+
+#include "util/util_foreach.h"
+#include "util/util_image.h"
+#include "util/util_logging.h"
+#include "util/util_map.h"
+#include "util/util_path.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Passes as written by the Blender render engine, with the offset of the
+ * pass in the denoising data and the channel names in their order. */
+
+typedef struct DenoisingPassInfo {
+	const char *name;
+	int offset;
+	const char *channels;
+} DenoisingPassInfo;
+
+static const DenoisingPassInfo denoising_passes[] = {
+	{"Denoising Normal",          DENOISING_PASS_NORMAL,     "XYZ"},
+	{"Denoising Normal Variance", DENOISING_PASS_NORMAL_VAR, "XYZ"},
+	{"Denoising Albedo",          DENOISING_PASS_ALBEDO,     "RGB"},
+	{"Denoising Albedo Variance", DENOISING_PASS_ALBEDO_VAR, "RGB"},
+	{"Denoising Depth",           DENOISING_PASS_DEPTH,      "Z"},
+	{"Denoising Depth Variance",  DENOISING_PASS_DEPTH_VAR,  "Z"},
+	{"Denoising Shadow A",        DENOISING_PASS_SHADOW_A,   "XYV"},
+	{"Denoising Shadow B",        DENOISING_PASS_SHADOW_B,   "XYV"},
+	{"Denoising Image",           DENOISING_PASS_COLOR,      "RGB"},
+	{"Denoising Image Variance",  DENOISING_PASS_COLOR_VAR,  "RGB"},
+};
+
+/* Mapping of the file channels of one render layer to the render buffer. */
+typedef struct DenoisingLayer {
+	/* Pairs of file channel and offset in the render buffer pixel. */
+	vector<pair<int, int> > channels;
+	/* File channels of the combined pass RGB, -1 if missing. */
+	int combined[3];
+
+	DenoisingLayer()
+	{
+		combined[0] = combined[1] = combined[2] = -1;
+	}
+} DenoisingLayer;
+
+/* Split "Layer.Pass.Channel" channel names, layer names may contain dots. */
+static bool split_channel_name(const string& name, string& layer, string& pass, string& channel)
+{
+	size_t channel_dot = name.rfind('.');
+	if(channel_dot == string::npos || channel_dot == 0) {
+		return false;
+	}
+
+	size_t pass_dot = name.rfind('.', channel_dot - 1);
+	if(pass_dot == string::npos) {
+		return false;
+	}
+
+	layer = name.substr(0, pass_dot);
+	pass = name.substr(pass_dot + 1, channel_dot - pass_dot - 1);
+	channel = name.substr(channel_dot + 1);
+	return true;
+}
+
+static void find_layers(const ImageSpec& spec,
+                        int denoising_offset,
+                        map<string, DenoisingLayer>& layers)
+{
+	map<string, int> num_channels;
+
+	for(int i = 0; i < spec.nchannels; i++) {
+		string layer, pass, channel;
+		if(!split_channel_name(spec.channelnames[i], layer, pass, channel) || channel.size() != 1) {
+			continue;
+		}
+
+		DenoisingLayer& dlayer = layers[layer];
+
+		if(pass == "Combined") {
+			static const char *combined_channels = "RGB";
+			const char *combined = strchr(combined_channels, channel[0]);
+			if(combined) {
+				int offset = (int)(combined - combined_channels);
+				dlayer.combined[offset] = i;
+				dlayer.channels.push_back(std::make_pair(i, offset));
+			}
+			continue;
+		}
+
+		for(int j = 0; j < sizeof(denoising_passes)/sizeof(*denoising_passes); j++) {
+			const DenoisingPassInfo& info = denoising_passes[j];
+			const char *component = strchr(info.channels, channel[0]);
+
+			if(pass == info.name && component) {
+				int offset = denoising_offset + info.offset + (int)(component - info.channels);
+				dlayer.channels.push_back(std::make_pair(i, offset));
+				num_channels[layer]++;
+			}
+		}
+	}
+
+	/* Only keep layers with all passes needed for denoising. */
+	int num_needed = 0;
+	for(int j = 0; j < sizeof(denoising_passes)/sizeof(*denoising_passes); j++) {
+		num_needed += strlen(denoising_passes[j].channels);
+	}
+
+	map<string, DenoisingLayer>::iterator it = layers.begin();
+	while(it != layers.end()) {
+		DenoisingLayer& dlayer = it->second;
+
+		if(num_channels[it->first] != num_needed ||
+		   dlayer.combined[0] == -1 ||
+		   dlayer.combined[1] == -1 ||
+		   dlayer.combined[2] == -1)
+		{
+			layers.erase(it++);
+		}
+		else {
+			++it;
+		}
+	}
+}
+
+/* Denoiser */
+
+Denoiser::Denoiser(DeviceInfo& device_info)
+{
+	samples = 0;
+
+	radius = 8;
+	strength = 0.5f;
+	feature_strength = 0.5f;
+	relative_pca = false;
+
+	tile_size = make_int2(64, 64);
+
+	buffers = NULL;
+
+	device = Device::create(device_info, stats, true);
+}
+
+Denoiser::~Denoiser()
+{
+	delete device;
+}
+
+bool Denoiser::run()
+{
+	assert(input.size() == output.size());
+
+	if(samples < 1) {
+		error = "Number of samples must be given to denoise";
+		return false;
+	}
+
+	if(!device) {
+		error = "Failed to create denoising device";
+		return false;
+	}
+
+	DeviceRequestedFeatures requested_features;
+	requested_features.use_denoising = true;
+
+	if(!device->load_kernels(requested_features)) {
+		error = "Failed to load denoising kernels: " + device->error_message();
+		return false;
+	}
+
+	for(int i = 0; i < input.size(); i++) {
+		progress.set_status(string_printf("Denoising frame %d/%d", i + 1, (int)input.size()),
+		                    path_filename(input[i]));
+
+		if(!denoise_frame(input[i], output[i])) {
+			return false;
+		}
+
+		if(progress.get_cancel()) {
+			error = "Cancelled";
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool Denoiser::denoise_frame(const string& in_filepath, const string& out_filepath)
+{
+	/* Read the whole image, all layers are written out again. */
+	ImageInput *in = ImageInput::open(in_filepath);
+	if(!in) {
+		error = "Failed to open image file " + in_filepath;
+		return false;
+	}
+
+	ImageSpec spec = in->spec();
+	const int width = spec.width, height = spec.height;
+	const int num_channels = spec.nchannels;
+
+	vector<float> pixels((size_t)width*height*num_channels);
+
+	if(!in->read_image(TypeDesc::FLOAT, &pixels[0])) {
+		error = "Failed to read image file " + in_filepath + ": " + in->geterror();
+		in->close();
+		delete in;
+		return false;
+	}
+
+	in->close();
+	delete in;
+
+	BufferParams params;
+	params.width = params.full_width = width;
+	params.height = params.full_height = height;
+	params.add_pass(PASS_COMBINED);
+	params.denoising_data_pass = true;
+
+	map<string, DenoisingLayer> layers;
+	find_layers(spec, params.get_denoising_offset(), layers);
+
+	if(layers.empty()) {
+		error = "No render layer with denoising data passes found in " + in_filepath;
+		return false;
+	}
+
+	RenderBuffers render_buffers(device);
+	render_buffers.reset(device, params);
+
+	const int pass_stride = params.get_passes_size();
+	const size_t num_pixels = (size_t)width*height;
+
+	for(map<string, DenoisingLayer>::iterator it = layers.begin(); it != layers.end(); it++) {
+		DenoisingLayer& dlayer = it->second;
+
+		VLOG(1) << "Denoising render layer " << it->first << " of " << in_filepath << ".";
+
+		/* The stored passes are averages over all samples, while the
+		 * render buffers hold sums. */
+		float *buffer = (float*)render_buffers.buffer.data_pointer;
+		memset(buffer, 0, render_buffers.buffer.memory_size());
+
+		for(size_t i = 0; i < num_pixels; i++) {
+			const float *in_pixel = &pixels[i*num_channels];
+			float *buffer_pixel = buffer + i*pass_stride;
+
+			for(size_t c = 0; c < dlayer.channels.size(); c++) {
+				buffer_pixel[dlayer.channels[c].second] = in_pixel[dlayer.channels[c].first] * samples;
+			}
+		}
+
+		device->mem_copy_to(render_buffers.buffer);
+
+		denoise_buffers(&render_buffers);
+
+		if(!device->error_message().empty()) {
+			error = "Failed to denoise " + in_filepath + ": " + device->error_message();
+			return false;
+		}
+
+		render_buffers.copy_from_device();
+
+		/* Denoised color replaces the combined pass. */
+		const float inv_samples = 1.0f/samples;
+
+		for(size_t i = 0; i < num_pixels; i++) {
+			float *out_pixel = &pixels[i*num_channels];
+			const float *buffer_pixel = buffer + i*pass_stride;
+
+			for(int c = 0; c < 3; c++) {
+				out_pixel[dlayer.combined[c]] = buffer_pixel[c] * inv_samples;
+			}
+		}
+	}
+
+	/* Write image with the same channels, as float. */
+	ImageOutput *out = ImageOutput::create(out_filepath);
+	if(!out) {
+		error = "Failed to create image file " + out_filepath;
+		return false;
+	}
+
+	spec.set_format(TypeDesc::FLOAT);
+
+	if(!out->open(out_filepath, spec) || !out->write_image(TypeDesc::FLOAT, &pixels[0])) {
+		error = "Failed to write image file " + out_filepath + ": " + out->geterror();
+		delete out;
+		return false;
+	}
+
+	out->close();
+	delete out;
+
+	return true;
+}
+
+void Denoiser::denoise_buffers(RenderBuffers *render_buffers)
+{
+	buffers = render_buffers;
+
+	/* Denoise in tiles, so all device threads are used. */
+	tiles.clear();
+	for(int y = 0; y < buffers->params.height; y += tile_size.y) {
+		for(int x = 0; x < buffers->params.width; x += tile_size.x) {
+			tiles.push_back(make_int4(x, y,
+			                          min(tile_size.x, buffers->params.width - x),
+			                          min(tile_size.y, buffers->params.height - y)));
+		}
+	}
+
+	DeviceTask task(DeviceTask::RENDER);
+	task.acquire_tile = function_bind(&Denoiser::acquire_tile, this, _1, _2);
+	task.release_tile = function_bind(&Denoiser::release_tile, this, _1);
+	task.map_neighbor_tiles = function_bind(&Denoiser::map_neighbor_tiles, this, _1, _2);
+	task.unmap_neighbor_tiles = function_bind(&Denoiser::unmap_neighbor_tiles, this, _1, _2);
+	task.get_cancel = function_bind(&Progress::get_cancel, &this->progress);
+	task.update_tile_sample = function_bind(&Denoiser::release_tile, this, _1);
+	task.update_progress_sample = function_bind(&Progress::add_samples, &this->progress, _1, _2);
+	task.need_finish_queue = false;
+	task.requested_tile_size = tile_size;
+	task.passes_size = buffers->params.get_passes_size();
+
+	task.denoising_radius = radius;
+	task.denoising_strength = strength;
+	task.denoising_feature_strength = feature_strength;
+	task.denoising_relative_pca = relative_pca;
+	task.pass_stride = buffers->params.get_passes_size();
+	task.pass_denoising_data = buffers->params.get_denoising_offset();
+	task.pass_denoising_clean = -1;
+
+	device->task_add(task);
+	device->task_wait();
+
+	buffers = NULL;
+}
+
+bool Denoiser::acquire_tile(Device * /*device*/, RenderTile& rtile)
+{
+	thread_scoped_lock tiles_lock(tiles_mutex);
+
+	if(tiles.empty() || progress.get_cancel()) {
+		return false;
+	}
+
+	int4 rect = tiles.front();
+	tiles.pop_front();
+
+	rtile.task = RenderTile::DENOISE;
+	rtile.x = rect.x;
+	rtile.y = rect.y;
+	rtile.w = rect.z;
+	rtile.h = rect.w;
+	rtile.start_sample = 0;
+	rtile.num_samples = samples;
+	rtile.sample = samples;
+	rtile.resolution = 1;
+	rtile.tile_index = 0;
+	rtile.buffers = buffers;
+	rtile.buffer = buffers->buffer.device_pointer;
+	rtile.rng_state = 0;
+	buffers->params.get_offset_stride(rtile.offset, rtile.stride);
+
+	return true;
+}
+
+void Denoiser::release_tile(RenderTile& /*rtile*/)
+{
+}
+
+void Denoiser::map_neighbor_tiles(RenderTile *tiles, Device *tile_device)
+{
+	/* All tiles share the render buffers of the whole image, neighbors
+	 * outside of it are empty as in Session::map_neighbor_tiles(). */
+	const int width = buffers->params.width, height = buffers->params.height;
+
+	for(int dy = -1, i = 0; dy <= 1; dy++) {
+		for(int dx = -1; dx <= 1; dx++, i++) {
+			int px = tiles[4].x + dx*tile_size.x;
+			int py = tiles[4].y + dy*tile_size.y;
+
+			if(px >= 0 && py >= 0 && px < width && py < height) {
+				tiles[i].buffer = buffers->buffer.device_pointer;
+				tiles[i].buffers = buffers;
+				tiles[i].x = px;
+				tiles[i].y = py;
+				tiles[i].w = min(tile_size.x, width - px);
+				tiles[i].h = min(tile_size.y, height - py);
+
+				buffers->params.get_offset_stride(tiles[i].offset, tiles[i].stride);
+			}
+			else {
+				tiles[i].buffer = (device_ptr)NULL;
+				tiles[i].buffers = NULL;
+				tiles[i].x = clamp(px, 0, width);
+				tiles[i].y = clamp(py, 0, height);
+				tiles[i].w = tiles[i].h = 0;
+			}
+		}
+	}
+
+	device->map_neighbor_tiles(tile_device, tiles);
+}
+
+void Denoiser::unmap_neighbor_tiles(RenderTile *tiles, Device *tile_device)
+{
+	device->unmap_neighbor_tiles(tile_device, tiles);
+}
+
+CCL_NAMESPACE_END
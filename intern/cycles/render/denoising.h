@@ -0,0 +1,91 @@
+/*
+ * Copyright 2011-2017 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __DENOISING_H__
+#define __DENOISING_H__
+
+#include "device/device.h"
+
+#include "render/buffers.h"
+
+#include "util/util_list.h"
+#include "util/util_progress.h"
+#include "util/util_string.h"
+#include "util/util_thread.h"
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Denoiser
+ *
+ * Denoises multilayer EXR images rendered with the denoising data passes
+ * stored, outside of a render session. Every render layer which has all
+ * denoising passes gets its combined pass replaced by the denoised result,
+ * all other channels are written unchanged. */
+
+class Denoiser {
+public:
+	explicit Denoiser(DeviceInfo& device_info);
+	~Denoiser();
+
+	/* Denoise all input frames, returns false and sets error on failure. */
+	bool run();
+
+	/* Error message after running, in case of failure. */
+	string error;
+
+	/* Sequential list of frame filepaths to denoise, and the filepaths to
+	 * write the results to. Both lists must have the same length. */
+	vector<string> input;
+	vector<string> output;
+
+	/* Number of samples the frames were rendered with, the stored passes
+	 * are averages and the sample count is needed to recover variances. */
+	int samples;
+
+	/* Filter parameters, see SessionParams. */
+	int radius;
+	float strength;
+	float feature_strength;
+	bool relative_pca;
+
+	/* Size of the tiles denoised in parallel. */
+	int2 tile_size;
+
+	Progress progress;
+
+protected:
+	bool denoise_frame(const string& in_filepath, const string& out_filepath);
+	void denoise_buffers(RenderBuffers *buffers);
+
+	/* Device callbacks */
+	bool acquire_tile(Device *device, RenderTile& tile);
+	void release_tile(RenderTile& tile);
+	void map_neighbor_tiles(RenderTile *tiles, Device *tile_device);
+	void unmap_neighbor_tiles(RenderTile *tiles, Device *tile_device);
+
+	Stats stats;
+	Device *device;
+
+	/* State of the image being denoised. */
+	RenderBuffers *buffers;
+	list<int4> tiles;
+	thread_mutex tiles_mutex;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __DENOISING_H__ */
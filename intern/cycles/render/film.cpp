@@ -158,6 +158,7 @@ void Pass::add(PassType type, array<Pass>& passes)
 		case PASS_BVH_TRAVERSED_INSTANCES:
 		case PASS_BVH_INTERSECTIONS:
 		case PASS_RAY_BOUNCES:
+		case PASS_SHADER_NODES:
 			pass.components = 1;
 			pass.exposure = false;
 			break;
@@ -283,6 +284,8 @@ NODE_DEFINE(Film)
 	SOCKET_BOOLEAN(denoising_clean_pass, "Generate Denoising Clean Pass", false);
 	SOCKET_INT(denoising_flags, "Denoising Flags", 0);
 
+	SOCKET_BOOLEAN(use_adaptive_sampling, "Use Adaptive Sampling", false);
+
 	return type;
 }
 
@@ -432,6 +435,9 @@ void Film::device_update(Device *device, DeviceScene *dscene, Scene *scene)
 			case PASS_RAY_BOUNCES:
 				kfilm->pass_ray_bounces = kfilm->pass_stride;
 				break;
+			case PASS_SHADER_NODES:
+				kfilm->pass_shader_nodes = kfilm->pass_stride;
+				break;
 #endif
 
 			case PASS_NONE:
@@ -455,6 +461,12 @@ void Film::device_update(Device *device, DeviceScene *dscene, Scene *scene)
 		}
 	}
 
+	kfilm->pass_adaptive_aux = 0;
+	if(use_adaptive_sampling) {
+		kfilm->pass_adaptive_aux = kfilm->pass_stride;
+		kfilm->pass_stride += 4;
+	}
+
 	kfilm->pass_stride = align_up(kfilm->pass_stride, 4);
 	kfilm->pass_alpha_threshold = pass_alpha_threshold;
 
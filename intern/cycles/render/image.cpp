@@ -40,6 +40,25 @@ static bool isfinite(half /*value*/)
 	return false;
 }
 
+/* Float files read into half storage overflow to infinity, clamp those to
+ * the largest half value and zero NaN. Nothing to do for other storage.
+ */
+static void clamp_half_pixels(uchar * /*pixels*/, size_t /*num_values*/)
+{
+}
+static void clamp_half_pixels(float * /*pixels*/, size_t /*num_values*/)
+{
+}
+static void clamp_half_pixels(half *pixels, size_t num_values)
+{
+	for(size_t i = 0; i < num_values; ++i) {
+		if((pixels[i] & 0x7c00) == 0x7c00) {
+			/* Infinity keeps its sign, NaN becomes zero. */
+			pixels[i] = (pixels[i] & 0x03ff)? 0: (pixels[i] & 0x8000) | 0x7bff;
+		}
+	}
+}
+
 ImageManager::ImageManager(const DeviceInfo& info)
 {
 	need_update = true;
@@ -62,6 +81,7 @@ ImageManager::ImageManager(const DeviceInfo& info)
 	max_num_images = TEX_NUM_MAX;
 	has_half_images = true;
 	cuda_fermi_limits = false;
+	half_float_images = false;
 
 	if(device_type == DEVICE_CUDA) {
 		if(!info.has_bindless_textures) {
@@ -92,6 +112,11 @@ void ImageManager::set_pack_images(bool pack_images_)
 	pack_images = pack_images_;
 }
 
+void ImageManager::set_half_float_images(bool half_float_images_)
+{
+	half_float_images = half_float_images_;
+}
+
 void ImageManager::set_osl_texture_system(void *texture_system)
 {
 	osl_texture_system = texture_system;
@@ -276,6 +301,10 @@ int ImageManager::add_image(const string& filename,
 	size_t slot;
 	bool builtin_free_cache;
 
+	/* Images from a previous update may still be loading in the background
+	 * in case it was cancelled, wait before modifying the slots. */
+	load_pool.wait_work();
+
 	ImageDataType type = get_image_metadata(filename, builtin_data, is_linear, builtin_free_cache);
 
 	thread_scoped_lock device_lock(device_mutex);
@@ -283,6 +312,18 @@ int ImageManager::add_image(const string& filename,
 	/* Check whether it's a float texture. */
 	is_float = (type == IMAGE_DATA_TYPE_FLOAT || type == IMAGE_DATA_TYPE_FLOAT4);
 
+	/* Convert float images to half on load. Builtin images are excluded,
+	 * as they are only available as float or byte pixels.
+	 */
+	if(half_float_images && has_half_images && !builtin_data) {
+		if(type == IMAGE_DATA_TYPE_FLOAT4) {
+			type = IMAGE_DATA_TYPE_HALF4;
+		}
+		else if(type == IMAGE_DATA_TYPE_FLOAT) {
+			type = IMAGE_DATA_TYPE_HALF;
+		}
+	}
+
 	/* No single channel and half textures on CUDA (Fermi) and no half on OpenCL, use available slots */
 	if(!has_half_images) {
 		if(type == IMAGE_DATA_TYPE_HALF4) {
@@ -432,6 +473,8 @@ void ImageManager::tag_reload_image(const string& filename,
                                     ExtensionType extension,
                                     bool use_alpha)
 {
+	load_pool.wait_work();
+
 	for(size_t type = 0; type < IMAGE_DATA_NUM_TYPES; type++) {
 		for(size_t slot = 0; slot < images[type].size(); slot++) {
 			if(images[type][slot] && image_equals(images[type][slot],
@@ -450,6 +493,7 @@ void ImageManager::tag_reload_image(const string& filename,
 
 bool ImageManager::file_load_image_generic(Image *img,
                                            ImageInput **in,
+                                           int texture_limit,
                                            int &width,
                                            int &height,
                                            int &depth,
@@ -482,6 +526,27 @@ bool ImageManager::file_load_image_generic(Image *img,
 			return false;
 		}
 
+		/* For mipmapped files, such as tiled .tx files, read the largest MIP
+		 * level within the texture limit instead of the full resolution image,
+		 * so the full resolution is never read from disk or held in memory.
+		 */
+		if(texture_limit > 0) {
+			ImageSpec level_spec;
+			int miplevel = 0;
+			while(max(spec.width, spec.height) > texture_limit &&
+			      (*in)->seek_subimage(0, miplevel + 1, level_spec))
+			{
+				spec = level_spec;
+				miplevel++;
+			}
+			if(miplevel > 0) {
+				/* A failed seek may leave the input at any level. */
+				(*in)->seek_subimage(0, miplevel, spec);
+				VLOG(1) << "Using MIP level " << miplevel
+				        << " of " << img->filename << ".";
+			}
+		}
+
 		width = spec.width;
 		height = spec.height;
 		depth = spec.depth;
@@ -521,7 +586,7 @@ bool ImageManager::file_load_image(Image *img,
 	const StorageType alpha_one = (FileFormat == TypeDesc::UINT8)? 255 : 1;
 	ImageInput *in = NULL;
 	int width, height, depth, components;
-	if(!file_load_image_generic(img, &in, width, height, depth, components)) {
+	if(!file_load_image_generic(img, &in, texture_limit, width, height, depth, components)) {
 		return false;
 	}
 	/* Read RGBA pixels. */
@@ -667,6 +732,9 @@ bool ImageManager::file_load_image(Image *img,
 			}
 		}
 	}
+	else if(FileFormat == TypeDesc::HALF) {
+		clamp_half_pixels(pixels, num_pixels * (is_rgba ? 4 : 1));
+	}
 	/* Scale image down if needed. */
 	if(pixels_storage.size() > 0) {
 		float scale_factor = 1.0f;
@@ -698,7 +766,8 @@ void ImageManager::device_load_image(Device *device,
                                      Scene *scene,
                                      ImageDataType type,
                                      int slot,
-                                     Progress *progress)
+                                     Progress *progress,
+                                     bool alloc_device)
 {
 	if(progress->get_cancel())
 		return;
@@ -742,7 +811,7 @@ void ImageManager::device_load_image(Device *device,
 			pixels[3] = TEX_IMAGE_MISSING_A;
 		}
 
-		if(!pack_images) {
+		if(!pack_images && alloc_device) {
 			thread_scoped_lock device_lock(device_mutex);
 			device->tex_alloc(name.c_str(),
 			                  tex_img,
@@ -771,7 +840,7 @@ void ImageManager::device_load_image(Device *device,
 			pixels[0] = TEX_IMAGE_MISSING_R;
 		}
 
-		if(!pack_images) {
+		if(!pack_images && alloc_device) {
 			thread_scoped_lock device_lock(device_mutex);
 			device->tex_alloc(name.c_str(),
 			                  tex_img,
@@ -803,7 +872,7 @@ void ImageManager::device_load_image(Device *device,
 			pixels[3] = (TEX_IMAGE_MISSING_A * 255);
 		}
 
-		if(!pack_images) {
+		if(!pack_images && alloc_device) {
 			thread_scoped_lock device_lock(device_mutex);
 			device->tex_alloc(name.c_str(),
 			                  tex_img,
@@ -831,7 +900,7 @@ void ImageManager::device_load_image(Device *device,
 			pixels[0] = (TEX_IMAGE_MISSING_R * 255);
 		}
 
-		if(!pack_images) {
+		if(!pack_images && alloc_device) {
 			thread_scoped_lock device_lock(device_mutex);
 			device->tex_alloc(name.c_str(),
 			                  tex_img,
@@ -862,7 +931,7 @@ void ImageManager::device_load_image(Device *device,
 			pixels[3] = TEX_IMAGE_MISSING_A;
 		}
 
-		if(!pack_images) {
+		if(!pack_images && alloc_device) {
 			thread_scoped_lock device_lock(device_mutex);
 			device->tex_alloc(name.c_str(),
 			                  tex_img,
@@ -890,7 +959,7 @@ void ImageManager::device_load_image(Device *device,
 			pixels[0] = TEX_IMAGE_MISSING_R;
 		}
 
-		if(!pack_images) {
+		if(!pack_images && alloc_device) {
 			thread_scoped_lock device_lock(device_mutex);
 			device->tex_alloc(name.c_str(),
 			                  tex_img,
@@ -1022,6 +1091,9 @@ void ImageManager::device_update(Device *device,
 	/* Make sure arrays are proper size. */
 	device_prepare_update(dscene);
 
+	/* Finish images that started loading in the background. */
+	device_load_wait(device, dscene);
+
 	TaskPool pool;
 	for(int type = 0; type < IMAGE_DATA_NUM_TYPES; type++) {
 		for(size_t slot = 0; slot < images[type].size(); slot++) {
@@ -1040,7 +1112,8 @@ void ImageManager::device_update(Device *device,
 					                        scene,
 					                        (ImageDataType)type,
 					                        slot,
-					                        &progress));
+					                        &progress,
+					                        true));
 			}
 		}
 	}
@@ -1053,6 +1126,116 @@ void ImageManager::device_update(Device *device,
 	need_update = false;
 }
 
+void ImageManager::device_load_begin(Device *device,
+                                     DeviceScene *dscene,
+                                     Scene *scene,
+                                     Progress& progress)
+{
+	if(!need_update || !load_pending.empty()) {
+		return;
+	}
+
+	device_prepare_update(dscene);
+
+	for(int type = 0; type < IMAGE_DATA_NUM_TYPES; type++) {
+		for(size_t slot = 0; slot < images[type].size(); slot++) {
+			Image *img = images[type][slot];
+
+			if(!img || img->users == 0 || !img->need_load)
+				continue;
+			if(osl_texture_system && !img->builtin_data)
+				continue;
+
+			/* Free the previous device copy here, so the background task
+			 * only touches host memory. */
+			device_memory *tex_img = device_image_memory(dscene, (ImageDataType)type, slot);
+			if(tex_img && tex_img->device_pointer) {
+				thread_scoped_lock device_lock(device_mutex);
+				device->tex_free(*tex_img);
+			}
+
+			load_pending.push_back(type_index_to_flattened_slot(slot, (ImageDataType)type));
+			load_pool.push(function_bind(&ImageManager::device_load_image,
+			                             this,
+			                             device,
+			                             dscene,
+			                             scene,
+			                             (ImageDataType)type,
+			                             slot,
+			                             &progress,
+			                             false));
+		}
+	}
+}
+
+void ImageManager::device_load_wait(Device *device, DeviceScene *dscene)
+{
+	if(load_pending.empty()) {
+		return;
+	}
+
+	load_pool.wait_work();
+
+	if(!pack_images) {
+		foreach(int flat_slot, load_pending) {
+			ImageDataType type;
+			int slot = flattened_slot_to_type_index(flat_slot, &type);
+
+			/* Loading was cancelled before this image was reached. */
+			if(images[type][slot]->need_load)
+				continue;
+
+			device_alloc_image(device, dscene, type, slot);
+		}
+	}
+
+	load_pending.clear();
+}
+
+device_memory *ImageManager::device_image_memory(DeviceScene *dscene,
+                                                 ImageDataType type,
+                                                 int slot)
+{
+	switch(type) {
+		case IMAGE_DATA_TYPE_FLOAT4:
+			return (slot < dscene->tex_float4_image.size())? dscene->tex_float4_image[slot]: NULL;
+		case IMAGE_DATA_TYPE_BYTE4:
+			return (slot < dscene->tex_byte4_image.size())? dscene->tex_byte4_image[slot]: NULL;
+		case IMAGE_DATA_TYPE_HALF4:
+			return (slot < dscene->tex_half4_image.size())? dscene->tex_half4_image[slot]: NULL;
+		case IMAGE_DATA_TYPE_FLOAT:
+			return (slot < dscene->tex_float_image.size())? dscene->tex_float_image[slot]: NULL;
+		case IMAGE_DATA_TYPE_BYTE:
+			return (slot < dscene->tex_byte_image.size())? dscene->tex_byte_image[slot]: NULL;
+		case IMAGE_DATA_TYPE_HALF:
+			return (slot < dscene->tex_half_image.size())? dscene->tex_half_image[slot]: NULL;
+		default:
+			return NULL;
+	}
+}
+
+void ImageManager::device_alloc_image(Device *device,
+                                      DeviceScene *dscene,
+                                      ImageDataType type,
+                                      int slot)
+{
+	device_memory *tex_img = device_image_memory(dscene, type, slot);
+
+	if(!tex_img) {
+		return;
+	}
+
+	Image *img = images[type][slot];
+	int flat_slot = type_index_to_flattened_slot(slot, type);
+	string name = string_printf("__tex_image_%s_%03d", name_from_type(type).c_str(), flat_slot);
+
+	thread_scoped_lock device_lock(device_mutex);
+	device->tex_alloc(name.c_str(),
+	                  *tex_img,
+	                  img->interpolation,
+	                  img->extension);
+}
+
 void ImageManager::device_update_slot(Device *device,
                                       DeviceScene *dscene,
                                       Scene *scene,
@@ -1226,6 +1409,9 @@ void ImageManager::device_free_builtin(Device *device, DeviceScene *dscene)
 
 void ImageManager::device_free(Device *device, DeviceScene *dscene)
 {
+	load_pool.cancel();
+	load_pending.clear();
+
 	for(int type = 0; type < IMAGE_DATA_NUM_TYPES; type++) {
 		for(size_t slot = 0; slot < images[type].size(); slot++) {
 			device_free_image(device, dscene, (ImageDataType)type, slot);
@@ -22,6 +22,7 @@
 
 #include "util/util_image.h"
 #include "util/util_string.h"
+#include "util/util_task.h"
 #include "util/util_thread.h"
 #include "util/util_vector.h"
 
@@ -63,6 +64,13 @@ public:
 	                                 bool& builtin_free_cache);
 
 	void device_prepare_update(DeviceScene *dscene);
+	/* Start loading images from files in the background, so it overlaps with
+	 * updating other parts of the scene. Copying to the device happens in
+	 * device_update(), which waits for loading to finish. */
+	void device_load_begin(Device *device,
+	                       DeviceScene *dscene,
+	                       Scene *scene,
+	                       Progress& progress);
 	void device_update(Device *device,
 	                   DeviceScene *dscene,
 	                   Scene *scene,
@@ -77,6 +85,7 @@ public:
 
 	void set_osl_texture_system(void *texture_system);
 	void set_pack_images(bool pack_images_);
+	void set_half_float_images(bool half_float_images_);
 	bool set_animation_frame_update(int frame);
 
 	bool need_update;
@@ -124,6 +133,8 @@ private:
 	int max_num_images;
 	bool has_half_images;
 	bool cuda_fermi_limits;
+	/* Store float images from files in half float slots. */
+	bool half_float_images;
 
 	thread_mutex device_mutex;
 	int animation_frame;
@@ -132,8 +143,15 @@ private:
 	void *osl_texture_system;
 	bool pack_images;
 
+	/* Images being loaded in the background, as flattened slots, still to
+	 * be copied to the device. */
+	TaskPool load_pool;
+	vector<int> load_pending;
+	void device_load_wait(Device *device, DeviceScene *dscene);
+
 	bool file_load_image_generic(Image *img,
 	                             ImageInput **in,
+	                             int texture_limit,
 	                             int &width,
 	                             int &height,
 	                             int &depth,
@@ -159,7 +177,15 @@ private:
 	                       Scene *scene,
 	                       ImageDataType type,
 	                       int slot,
-	                       Progress *progess);
+	                       Progress *progess,
+	                       bool alloc_device = true);
+	device_memory *device_image_memory(DeviceScene *dscene,
+	                                   ImageDataType type,
+	                                   int slot);
+	void device_alloc_image(Device *device,
+	                        DeviceScene *dscene,
+	                        ImageDataType type,
+	                        int slot);
 	void device_free_image(Device *device,
 	                       DeviceScene *dscene,
 	                       ImageDataType type,
@@ -63,10 +63,13 @@ NODE_DEFINE(Integrator)
 	SOCKET_INT(subsurface_samples, "Subsurface Samples", 1);
 	SOCKET_INT(volume_samples, "Volume Samples", 1);
 	SOCKET_INT(start_sample, "Start Sample", 0);
+	SOCKET_FLOAT(adaptive_threshold, "Adaptive Threshold", 0.01f);
+	SOCKET_INT(adaptive_min_samples, "Adaptive Min Samples", 16);
 
 	SOCKET_BOOLEAN(sample_all_lights_direct, "Sample All Lights Direct", true);
 	SOCKET_BOOLEAN(sample_all_lights_indirect, "Sample All Lights Indirect", true);
 	SOCKET_FLOAT(light_sampling_threshold, "Light Sampling Threshold", 0.05f);
+	SOCKET_BOOLEAN(use_light_tree, "Use Light Tree", false);
 
 	static NodeEnum method_enum;
 	method_enum.insert("path", PATH);
@@ -160,6 +163,11 @@ void Integrator::device_update(Device *device, DeviceScene *dscene, Scene *scene
 	kintegrator->volume_samples = volume_samples;
 	kintegrator->start_sample = start_sample;
 
+	/* Convergence is tested every few samples, the estimate needs at least two samples. */
+	kintegrator->adaptive_threshold = adaptive_threshold;
+	kintegrator->adaptive_min_samples = max(adaptive_min_samples, 2);
+	kintegrator->adaptive_step = 4;
+
 	if(method == BRANCHED_PATH) {
 		kintegrator->sample_all_lights_direct = sample_all_lights_direct;
 		kintegrator->sample_all_lights_indirect = sample_all_lights_indirect;
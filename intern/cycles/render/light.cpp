@@ -24,6 +24,8 @@
 #include "render/scene.h"
 #include "render/shader.h"
 
+#include "util/util_algorithm.h"
+#include "util/util_boundbox.h"
 #include "util/util_foreach.h"
 #include "util/util_progress.h"
 #include "util/util_logging.h"
@@ -249,6 +251,121 @@ bool LightManager::object_usable_as_light(Object *object) {
 	return false;
 }
 
+/* Light Tree */
+
+#define LIGHT_TREE_LEAF_SIZE 4
+
+/* Bounds of the directions an emitter emits light into, as a cone around axis. */
+struct LightTreeCone {
+	float3 axis;
+	float theta;
+
+	LightTreeCone()
+	: axis(make_float3(0.0f, 0.0f, 1.0f)), theta(M_PI_F) {}
+
+	LightTreeCone(const float3& axis, float theta)
+	: axis(axis), theta(theta) {}
+
+	void grow(const LightTreeCone& other)
+	{
+		const LightTreeCone *a = this, *b = &other;
+		if(a->theta < b->theta) {
+			swap(a, b);
+		}
+
+		float theta_d = safe_acosf(dot(a->axis, b->axis));
+		if(min(theta_d + b->theta, M_PI_F) <= a->theta) {
+			*this = *a;
+			return;
+		}
+
+		float theta_o = 0.5f*(a->theta + theta_d + b->theta);
+		float3 ortho = b->axis - a->axis*dot(a->axis, b->axis);
+		if(theta_o >= M_PI_F || len_squared(ortho) == 0.0f) {
+			*this = LightTreeCone();
+			return;
+		}
+
+		/* rotate the axis of the wider cone towards the other one */
+		float theta_r = theta_o - a->theta;
+		float3 new_axis = normalize(a->axis*cosf(theta_r) + normalize(ortho)*sinf(theta_r));
+		axis = new_axis;
+		theta = theta_o;
+	}
+};
+
+struct LightTreeEmitter {
+	float4 distribution;
+	float energy;
+	BoundBox bounds;
+	LightTreeCone cone;
+
+	LightTreeEmitter(const float4& distribution, float energy,
+	                 const BoundBox& bounds, const LightTreeCone& cone)
+	: distribution(distribution), energy(energy), bounds(bounds), cone(cone) {}
+};
+
+struct LightTreeEmitterCompare {
+	int dim;
+
+	explicit LightTreeEmitterCompare(int dim) : dim(dim) {}
+
+	bool operator()(const LightTreeEmitter& a, const LightTreeEmitter& b) const
+	{
+		return a.bounds.center()[dim] < b.bounds.center()[dim];
+	}
+};
+
+/* Build the subtree over emitters [start, end) in depth first order, the left
+ * child of a node directly follows it. Emitters are reordered so every leaf
+ * covers a contiguous range. */
+static int light_tree_build(vector<LightTreeEmitter>& emitters,
+                            int start, int end,
+                            vector<float4>& nodes)
+{
+	BoundBox bounds = BoundBox::empty;
+	BoundBox centroid_bounds = BoundBox::empty;
+	LightTreeCone cone = emitters[start].cone;
+	float energy = 0.0f;
+
+	for(int i = start; i < end; i++) {
+		bounds.grow(emitters[i].bounds);
+		centroid_bounds.grow(emitters[i].bounds.center());
+		cone.grow(emitters[i].cone);
+		energy += emitters[i].energy;
+	}
+
+	int node = nodes.size()/LIGHT_TREE_NODE_SIZE;
+	nodes.resize(nodes.size() + LIGHT_TREE_NODE_SIZE);
+
+	nodes[node*LIGHT_TREE_NODE_SIZE + 0] = make_float4(bounds.min.x, bounds.min.y, bounds.min.z, energy);
+	nodes[node*LIGHT_TREE_NODE_SIZE + 1] = make_float4(bounds.max.x, bounds.max.y, bounds.max.z, cone.theta);
+	nodes[node*LIGHT_TREE_NODE_SIZE + 2] = make_float4(cone.axis.x, cone.axis.y, cone.axis.z, 0.0f);
+
+	float3 size = centroid_bounds.size();
+	if(end - start <= LIGHT_TREE_LEAF_SIZE || max3(size) == 0.0f) {
+		nodes[node*LIGHT_TREE_NODE_SIZE + 3] = make_float4(__int_as_float(-1),
+		                                                   __int_as_float(start),
+		                                                   __int_as_float(end - start),
+		                                                   0.0f);
+		return node;
+	}
+
+	/* median split along the largest extent of the centroids */
+	int dim = (size.x >= size.y && size.x >= size.z)? 0: (size.y >= size.z)? 1: 2;
+	int mid = (start + end)/2;
+	nth_element(emitters.begin() + start,
+	            emitters.begin() + mid,
+	            emitters.begin() + end,
+	            LightTreeEmitterCompare(dim));
+
+	light_tree_build(emitters, start, mid, nodes);
+	int right = light_tree_build(emitters, mid, end, nodes);
+
+	nodes[node*LIGHT_TREE_NODE_SIZE + 3] = make_float4(__int_as_float(right), 0.0f, 0.0f, 0.0f);
+	return node;
+}
+
 void LightManager::device_update_distribution(Device *device, DeviceScene *dscene, Scene *scene, Progress& progress)
 {
 	progress.set_status("Updating Lights", "Computing distribution");
@@ -298,6 +415,10 @@ void LightManager::device_update_distribution(Device *device, DeviceScene *dscen
 	float4 *distribution = dscene->light_distribution.resize(num_distribution + 1);
 	float totarea = 0.0f;
 
+	/* local emitters to build the light tree over */
+	bool use_light_tree = scene->integrator->use_light_tree;
+	vector<LightTreeEmitter> emitters;
+
 	/* triangles */
 	size_t offset = 0;
 	int j = 0;
@@ -358,7 +479,17 @@ void LightManager::device_update_distribution(Device *device, DeviceScene *dscen
 					p3 = transform_point(&tfm, p3);
 				}
 
-				totarea += triangle_area(p1, p2, p3);
+				float area = triangle_area(p1, p2, p3);
+				totarea += area;
+
+				if(use_light_tree) {
+					/* emission is two sided, so directions are unbounded */
+					BoundBox bounds = BoundBox::empty;
+					bounds.grow(p1);
+					bounds.grow(p2);
+					bounds.grow(p3);
+					emitters.push_back(LightTreeEmitter(distribution[offset - 1], area, bounds, LightTreeCone()));
+				}
 			}
 		}
 
@@ -371,26 +502,85 @@ void LightManager::device_update_distribution(Device *device, DeviceScene *dscen
 	float lightarea = (totarea > 0.0f) ? totarea / num_lights : 1.0f;
 	bool use_lamp_mis = false;
 
+	/* lamps at infinity are stored after all local emitters, so the light
+	 * tree only covers the start of the distribution */
 	int light_index = 0;
-	foreach(Light *light, scene->lights) {
-		if(!light->is_enabled)
-			continue;
+	for(int infinite = 0; infinite < 2; infinite++) {
+		light_index = 0;
+		foreach(Light *light, scene->lights) {
+			if(!light->is_enabled)
+				continue;
+
+			bool is_infinite = (light->type == LIGHT_DISTANT || light->type == LIGHT_BACKGROUND);
+			if(is_infinite != (infinite == 1)) {
+				light_index++;
+				continue;
+			}
 
-		distribution[offset].x = totarea;
-		distribution[offset].y = __int_as_float(~light_index);
-		distribution[offset].z = 1.0f;
-		distribution[offset].w = light->size;
-		totarea += lightarea;
+			distribution[offset].x = totarea;
+			distribution[offset].y = __int_as_float(~light_index);
+			distribution[offset].z = 1.0f;
+			distribution[offset].w = light->size;
+			totarea += lightarea;
+
+			if(light->size > 0.0f && light->use_mis)
+				use_lamp_mis = true;
+			if(light->type == LIGHT_BACKGROUND) {
+				num_background_lights++;
+				background_mis = light->use_mis;
+			}
 
-		if(light->size > 0.0f && light->use_mis)
-			use_lamp_mis = true;
-		if(light->type == LIGHT_BACKGROUND) {
-			num_background_lights++;
-			background_mis = light->use_mis;
+			if(use_light_tree && !is_infinite) {
+				BoundBox bounds = BoundBox::empty;
+				LightTreeCone cone;
+
+				if(light->type == LIGHT_AREA) {
+					float3 axisu = light->axisu*(light->sizeu*light->size);
+					float3 axisv = light->axisv*(light->sizev*light->size);
+					bounds.grow(light->co + 0.5f*(axisu + axisv));
+					bounds.grow(light->co + 0.5f*(axisu - axisv));
+					bounds.grow(light->co - 0.5f*(axisu + axisv));
+					bounds.grow(light->co - 0.5f*(axisu - axisv));
+					cone = LightTreeCone(safe_normalize(light->dir), M_PI_2_F);
+				}
+				else {
+					bounds.grow(light->co, light->size);
+					if(light->type == LIGHT_SPOT) {
+						cone = LightTreeCone(safe_normalize(light->dir), light->spot_angle*0.5f);
+					}
+				}
+
+				emitters.push_back(LightTreeEmitter(distribution[offset], lightarea, bounds, cone));
+			}
+
+			light_index++;
+			offset++;
 		}
+	}
 
-		light_index++;
-		offset++;
+	/* build the light tree and store the local emitters in its leaf order */
+	vector<float4> tree_nodes;
+
+	if(use_light_tree && emitters.size() > 1 && totarea > 0.0f) {
+		light_tree_build(emitters, 0, emitters.size(), tree_nodes);
+
+		float localarea = 0.0f;
+		for(size_t i = 0; i < emitters.size(); i++) {
+			distribution[i] = emitters[i].distribution;
+			distribution[i].x = localarea;
+			localarea += emitters[i].energy;
+		}
+
+		/* energies relative to the root */
+		for(size_t i = 0; i < tree_nodes.size(); i += LIGHT_TREE_NODE_SIZE) {
+			tree_nodes[i].w /= localarea;
+		}
+
+		VLOG(1) << "Light tree built over " << emitters.size() << " emitters with "
+		        << tree_nodes.size()/LIGHT_TREE_NODE_SIZE << " nodes.";
+	}
+	else {
+		use_light_tree = false;
 	}
 
 	/* normalize cumulative distribution functions */
@@ -453,6 +643,20 @@ void LightManager::device_update_distribution(Device *device, DeviceScene *dscen
 		/* CDF */
 		device->tex_alloc("__light_distribution", dscene->light_distribution);
 
+		/* Light tree */
+		if(use_light_tree) {
+			float4 *nodes = dscene->light_tree_nodes.resize(tree_nodes.size());
+			memcpy(nodes, &tree_nodes[0], sizeof(float4)*tree_nodes.size());
+			device->tex_alloc("__light_tree_nodes", dscene->light_tree_nodes);
+
+			kintegrator->use_light_tree = true;
+			kintegrator->light_tree_pdf = distribution[emitters.size()].x;
+		}
+		else {
+			kintegrator->use_light_tree = false;
+			kintegrator->light_tree_pdf = 0.0f;
+		}
+
 		/* Portals */
 		if(num_portals > 0) {
 			kintegrator->portal_offset = light_index;
@@ -477,6 +681,8 @@ void LightManager::device_update_distribution(Device *device, DeviceScene *dscen
 		kintegrator->num_portals = 0;
 		kintegrator->portal_offset = 0;
 		kintegrator->portal_pdf = 0.0f;
+		kintegrator->use_light_tree = false;
+		kintegrator->light_tree_pdf = 0.0f;
 
 		kfilm->pass_shadow_scale = 1.0f;
 	}
@@ -850,11 +1056,13 @@ void LightManager::device_free(Device *device, DeviceScene *dscene)
 {
 	device->tex_free(dscene->light_distribution);
 	device->tex_free(dscene->light_data);
+	device->tex_free(dscene->light_tree_nodes);
 	device->tex_free(dscene->light_background_marginal_cdf);
 	device->tex_free(dscene->light_background_conditional_cdf);
 
 	dscene->light_distribution.clear();
 	dscene->light_data.clear();
+	dscene->light_tree_nodes.clear();
 	dscene->light_background_marginal_cdf.clear();
 	dscene->light_background_conditional_cdf.clear();
 }
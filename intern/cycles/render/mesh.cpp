@@ -909,8 +909,7 @@ void Mesh::pack_normals(Scene *scene, uint *tri_shader, float4 *vnormal)
 	}
 }
 
-void Mesh::pack_verts(const vector<uint>& tri_prim_index,
-                      uint4 *tri_vindex,
+void Mesh::pack_verts(uint4 *tri_vindex,
                       uint *tri_patch,
                       float2 *tri_patch_uv,
                       size_t vert_offset,
@@ -930,10 +929,12 @@ void Mesh::pack_verts(const vector<uint>& tri_prim_index,
 
 	for(size_t i = 0; i < triangles_size; i++) {
 		Triangle t = get_triangle(i);
+		/* index into the primitive triangle array is filled in afterwards,
+		 * see MeshManager::device_update_mesh() */
 		tri_vindex[i] = make_uint4(t.v[0] + vert_offset,
 		                           t.v[1] + vert_offset,
 		                           t.v[2] + vert_offset,
-		                           tri_prim_index[i + tri_offset]);
+		                           0);
 
 		tri_patch[i] = (!subd_faces.size()) ? -1 : (triangle_patch[i]*8 + patch_offset);
 	}
@@ -1040,21 +1041,28 @@ void Mesh::compute_bvh(DeviceScene *dscene,
 		vector<Object*> objects;
 		objects.push_back(&object);
 
-		if(bvh && !need_update_rebuild) {
+		bool rebuild = (bvh == NULL || need_update_rebuild);
+
+		if(!rebuild) {
 			progress->set_status(msg, "Refitting BVH");
 			bvh->objects = objects;
-			bvh->refit(*progress);
+			/* Large deformations degrade the refitted tree, rebuild it then. */
+			rebuild = !bvh->refit(*progress);
 		}
-		else {
+
+		if(rebuild) {
 			progress->set_status(msg, "Building BVH");
 
 			BVHParams bparams;
 			bparams.use_spatial_split = params->use_bvh_spatial_split;
 			bparams.use_qbvh = params->use_qbvh;
+			bparams.use_quantized_nodes = params->use_bvh_quantized_nodes;
+			bparams.use_bvh8 = params->use_bvh8;
 			bparams.use_unaligned_nodes = dscene->data.bvh.have_curves &&
 			                              params->use_bvh_unaligned_nodes;
 			bparams.num_motion_triangle_steps = params->num_bvh_time_steps;
 			bparams.num_motion_curve_steps = params->num_bvh_time_steps;
+			bparams.use_cache = params->use_bvh_cache;
 
 			delete bvh;
 			bvh = BVH::create(bparams, objects);
@@ -1704,29 +1712,6 @@ void MeshManager::device_update_mesh(Device *device,
 		}
 	}
 
-	/* Create mapping from triangle to primitive triangle array. */
-	vector<uint> tri_prim_index(tri_size);
-	if(for_displacement) {
-		/* For displacement kernels we do some trickery to make them believe
-		 * we've got all required data ready. However, that data is different
-		 * from final render kernels since we don't have BVH yet, so can't
-		 * really use same semantic of arrays.
-		 */
-		foreach(Mesh *mesh, scene->meshes) {
-			for(size_t i = 0; i < mesh->num_triangles(); ++i) {
-				tri_prim_index[i + mesh->tri_offset] = 3 * (i + mesh->tri_offset);
-			}
-		}
-	}
-	else {
-		PackedBVH& pack = bvh->pack;
-		for(size_t i = 0; i < pack.prim_index.size(); ++i) {
-			if((pack.prim_type[i] & PRIMITIVE_ALL_TRIANGLE) != 0) {
-				tri_prim_index[pack.prim_index[i]] = pack.prim_tri_index[i];
-			}
-		}
-	}
-
 	/* Fill in all the arrays. */
 	if(tri_size != 0) {
 		/* normals */
@@ -1742,8 +1727,7 @@ void MeshManager::device_update_mesh(Device *device,
 			mesh->pack_normals(scene,
 			                   &tri_shader[mesh->tri_offset],
 			                   &vnormal[mesh->vert_offset]);
-			mesh->pack_verts(tri_prim_index,
-			                 &tri_vindex[mesh->tri_offset],
+			mesh->pack_verts(&tri_vindex[mesh->tri_offset],
 			                 &tri_patch[mesh->tri_offset],
 			                 &tri_patch_uv[mesh->vert_offset],
 			                 mesh->vert_offset,
@@ -1751,6 +1735,27 @@ void MeshManager::device_update_mesh(Device *device,
 			if(progress.get_cancel()) return;
 		}
 
+		/* Mapping from triangle to primitive triangle array, written in
+		 * place rather than through a temporary array of all triangles. */
+		if(for_displacement) {
+			/* For displacement kernels we do some trickery to make them believe
+			 * we've got all required data ready. However, that data is different
+			 * from final render kernels since we don't have BVH yet, so can't
+			 * really use same semantic of arrays.
+			 */
+			for(size_t i = 0; i < tri_size; ++i) {
+				tri_vindex[i].w = 3 * i;
+			}
+		}
+		else {
+			PackedBVH& pack = bvh->pack;
+			for(size_t i = 0; i < pack.prim_index.size(); ++i) {
+				if((pack.prim_type[i] & PRIMITIVE_ALL_TRIANGLE) != 0) {
+					tri_vindex[pack.prim_index[i]].w = pack.prim_tri_index[i];
+				}
+			}
+		}
+
 		/* vertex coordinates */
 		progress.set_status("Updating Mesh", "Copying Mesh to device");
 
@@ -1814,17 +1819,21 @@ void MeshManager::device_update_bvh(Device *device, DeviceScene *dscene, Scene *
 	/* bvh build */
 	progress.set_status("Updating Scene BVH", "Building");
 
-	VLOG(1) << (scene->params.use_qbvh ? "Using QBVH optimization structure"
-	                                   : "Using regular BVH optimization structure");
+	VLOG(1) << (scene->params.use_bvh8 ? "Using BVH8 optimization structure"
+	            : scene->params.use_qbvh ? "Using QBVH optimization structure"
+	                                     : "Using regular BVH optimization structure");
 
 	BVHParams bparams;
 	bparams.top_level = true;
 	bparams.use_qbvh = scene->params.use_qbvh;
+	bparams.use_quantized_nodes = scene->params.use_bvh_quantized_nodes;
+	bparams.use_bvh8 = scene->params.use_bvh8;
 	bparams.use_spatial_split = scene->params.use_bvh_spatial_split;
 	bparams.use_unaligned_nodes = dscene->data.bvh.have_curves &&
 	                              scene->params.use_bvh_unaligned_nodes;
 	bparams.num_motion_triangle_steps = scene->params.num_bvh_time_steps;
 	bparams.num_motion_curve_steps = scene->params.num_bvh_time_steps;
+	bparams.use_cache = scene->params.use_bvh_cache;
 
 	delete bvh;
 	bvh = BVH::create(bparams, scene->objects);
@@ -1879,7 +1888,8 @@ void MeshManager::device_update_bvh(Device *device, DeviceScene *dscene, Scene *
 	}
 
 	dscene->data.bvh.root = pack.root_index;
-	dscene->data.bvh.use_qbvh = scene->params.use_qbvh;
+	dscene->data.bvh.use_qbvh = scene->params.use_qbvh && !scene->params.use_bvh8;
+	dscene->data.bvh.use_bvh8 = scene->params.use_bvh8;
 	dscene->data.bvh.use_bvh_steps = (scene->params.num_bvh_time_steps != 0);
 }
 
@@ -273,8 +273,7 @@ public:
 	void add_undisplaced();
 
 	void pack_normals(Scene *scene, uint *shader, float4 *vnormal);
-	void pack_verts(const vector<uint>& tri_prim_index,
-	                uint4 *tri_vindex,
+	void pack_verts(uint4 *tri_vindex,
 	                uint *tri_patch,
 	                float2 *tri_patch_uv,
 	                size_t vert_offset,
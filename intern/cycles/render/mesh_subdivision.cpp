@@ -24,6 +24,7 @@
 
 #include "util/util_foreach.h"
 #include "util/util_algorithm.h"
+#include "util/util_logging.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -333,40 +334,23 @@ struct OsdPatch : Patch {
 	BoundBox bound() { return BoundBox::empty; }
 };
 
-#endif
+#else
 
-void Mesh::tessellate(DiagSplit *split)
-{
-#ifdef WITH_OPENSUBDIV
-	OsdData osd_data;
-	bool need_packed_patch_table = false;
+class OsdData;
 
-	if(subdivision_type == SUBDIVISION_CATMULL_CLARK) {
-		if(subd_faces.size()) {
-			osd_data.build_from_mesh(this);
-		}
-	}
-	else
 #endif
-	{
-		/* force linear subdivision if OpenSubdiv is unavailable to avoid
-		 * falling into catmull-clark code paths by accident
-		 */
-		subdivision_type = SUBDIVISION_LINEAR;
-
-		/* force disable attribute subdivision for same reason as above */
-		foreach(Attribute& attr, subd_attributes.attributes) {
-			attr.flags &= ~ATTR_SUBDIVIDED;
-		}
-	}
 
-	int num_faces = subd_faces.size();
+/* Split and dice all faces, or only estimate the number of triangles when
+ * the split is counting. */
+static void tessellate_faces(Mesh *mesh, DiagSplit *split, OsdData *osd_data)
+{
+	int num_faces = mesh->subd_faces.size();
 
-	Attribute *attr_vN = subd_attributes.find(ATTR_STD_VERTEX_NORMAL);
+	Attribute *attr_vN = mesh->subd_attributes.find(ATTR_STD_VERTEX_NORMAL);
 	float3* vN = attr_vN->data_float3();
 
 	for(int f = 0; f < num_faces; f++) {
-		SubdFace& face = subd_faces[f];
+		Mesh::SubdFace& face = mesh->subd_faces[f];
 
 		if(face.is_quad()) {
 			/* quad */
@@ -374,9 +358,9 @@ void Mesh::tessellate(DiagSplit *split)
 
 			LinearQuadPatch quad_patch;
 #ifdef WITH_OPENSUBDIV
-			OsdPatch osd_patch(&osd_data);
+			OsdPatch osd_patch(osd_data);
 
-			if(subdivision_type == SUBDIVISION_CATMULL_CLARK) {
+			if(mesh->subdivision_type == Mesh::SUBDIVISION_CATMULL_CLARK) {
 				osd_patch.patch_index = face.ptex_offset;
 
 				subpatch.patch = &osd_patch;
@@ -390,16 +374,16 @@ void Mesh::tessellate(DiagSplit *split)
 				quad_patch.patch_index = face.ptex_offset;
 
 				for(int i = 0; i < 4; i++) {
-					hull[i] = verts[subd_face_corners[face.start_corner+i]];
+					hull[i] = mesh->verts[mesh->subd_face_corners[face.start_corner+i]];
 				}
 
 				if(face.smooth) {
 					for(int i = 0; i < 4; i++) {
-						normals[i] = vN[subd_face_corners[face.start_corner+i]];
+						normals[i] = vN[mesh->subd_face_corners[face.start_corner+i]];
 					}
 				}
 				else {
-					float3 N = face.normal(this);
+					float3 N = face.normal(mesh);
 					for(int i = 0; i < 4; i++) {
 						normals[i] = N;
 					}
@@ -443,8 +427,8 @@ void Mesh::tessellate(DiagSplit *split)
 		else {
 			/* ngon */
 #ifdef WITH_OPENSUBDIV
-			if(subdivision_type == SUBDIVISION_CATMULL_CLARK) {
-				OsdPatch patch(&osd_data);
+			if(mesh->subdivision_type == Mesh::SUBDIVISION_CATMULL_CLARK) {
+				OsdPatch patch(osd_data);
 
 				patch.shader = face.shader;
 
@@ -462,8 +446,8 @@ void Mesh::tessellate(DiagSplit *split)
 
 				float inv_num_corners = 1.0f/float(face.num_corners);
 				for(int corner = 0; corner < face.num_corners; corner++) {
-					center_vert += verts[subd_face_corners[face.start_corner + corner]] * inv_num_corners;
-					center_normal += vN[subd_face_corners[face.start_corner + corner]] * inv_num_corners;
+					center_vert += mesh->verts[mesh->subd_face_corners[face.start_corner + corner]] * inv_num_corners;
+					center_normal += vN[mesh->subd_face_corners[face.start_corner + corner]] * inv_num_corners;
 				}
 
 				for(int corner = 0; corner < face.num_corners; corner++) {
@@ -475,25 +459,25 @@ void Mesh::tessellate(DiagSplit *split)
 
 					patch.shader = face.shader;
 
-					hull[0] = verts[subd_face_corners[face.start_corner + mod(corner + 0, face.num_corners)]];
-					hull[1] = verts[subd_face_corners[face.start_corner + mod(corner + 1, face.num_corners)]];
-					hull[2] = verts[subd_face_corners[face.start_corner + mod(corner - 1, face.num_corners)]];
+					hull[0] = mesh->verts[mesh->subd_face_corners[face.start_corner + mod(corner + 0, face.num_corners)]];
+					hull[1] = mesh->verts[mesh->subd_face_corners[face.start_corner + mod(corner + 1, face.num_corners)]];
+					hull[2] = mesh->verts[mesh->subd_face_corners[face.start_corner + mod(corner - 1, face.num_corners)]];
 					hull[3] = center_vert;
 
 					hull[1] = (hull[1] + hull[0]) * 0.5;
 					hull[2] = (hull[2] + hull[0]) * 0.5;
 
 					if(face.smooth) {
-						normals[0] = vN[subd_face_corners[face.start_corner + mod(corner + 0, face.num_corners)]];
-						normals[1] = vN[subd_face_corners[face.start_corner + mod(corner + 1, face.num_corners)]];
-						normals[2] = vN[subd_face_corners[face.start_corner + mod(corner - 1, face.num_corners)]];
+						normals[0] = vN[mesh->subd_face_corners[face.start_corner + mod(corner + 0, face.num_corners)]];
+						normals[1] = vN[mesh->subd_face_corners[face.start_corner + mod(corner + 1, face.num_corners)]];
+						normals[2] = vN[mesh->subd_face_corners[face.start_corner + mod(corner - 1, face.num_corners)]];
 						normals[3] = center_normal;
 
 						normals[1] = (normals[1] + normals[0]) * 0.5;
 						normals[2] = (normals[2] + normals[0]) * 0.5;
 					}
 					else {
-						float3 N = face.normal(this);
+						float3 N = face.normal(mesh);
 						for(int i = 0; i < 4; i++) {
 							normals[i] = N;
 						}
@@ -504,6 +488,65 @@ void Mesh::tessellate(DiagSplit *split)
 			}
 		}
 	}
+}
+
+void Mesh::tessellate(DiagSplit *split)
+{
+#ifdef WITH_OPENSUBDIV
+	OsdData osd_data;
+	bool need_packed_patch_table = false;
+
+	if(subdivision_type == SUBDIVISION_CATMULL_CLARK) {
+		if(subd_faces.size()) {
+			osd_data.build_from_mesh(this);
+		}
+	}
+	else
+#endif
+	{
+		/* force linear subdivision if OpenSubdiv is unavailable to avoid
+		 * falling into catmull-clark code paths by accident
+		 */
+		subdivision_type = SUBDIVISION_LINEAR;
+
+		/* force disable attribute subdivision for same reason as above */
+		foreach(Attribute& attr, subd_attributes.attributes) {
+			attr.flags &= ~ATTR_SUBDIVIDED;
+		}
+	}
+
+#ifdef WITH_OPENSUBDIV
+	OsdData *osd_data_ptr = &osd_data;
+#else
+	OsdData *osd_data_ptr = NULL;
+#endif
+
+	int num_faces = subd_faces.size();
+
+	/* With a triangle budget, estimate the number of triangles first and
+	 * dice coarser while it is exceeded. Patches far from the camera get
+	 * coarser as well, since the dicing rate is in raster space. */
+	if(split->params.max_triangles > 0) {
+		for(int i = 0; i < 4; i++) {
+			split->count_only = true;
+			split->num_triangles = 0;
+			tessellate_faces(this, split, osd_data_ptr);
+			split->count_only = false;
+
+			if(split->num_triangles <= (size_t)split->params.max_triangles) {
+				break;
+			}
+
+			float scale = sqrtf((float)split->num_triangles / (float)split->params.max_triangles);
+			split->params.dicing_rate *= max(scale, 1.1f);
+
+			VLOG(1) << "Mesh " << name << " exceeds subdivision triangle budget with "
+			        << split->num_triangles << " triangles, dicing rate increased to "
+			        << split->params.dicing_rate << ".";
+		}
+	}
+
+	tessellate_faces(this, split, osd_data_ptr);
 
 	/* interpolate center points for attributes */
 	foreach(Attribute& attr, subd_attributes.attributes) {
@@ -0,0 +1,218 @@
+/*
+ * Copyright 2011-2017 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "render/reprojection.h"
+#include "render/camera.h"
+
+#include "util/util_half.h"
+#include "util/util_math.h"
+
+CCL_NAMESPACE_BEGIN
+
+static float4 byte_to_float4(uchar4 c)
+{
+	return make_float4(c.x, c.y, c.z, c.w) * (1.0f/255.0f);
+}
+
+static uchar4 float4_to_byte(float4 f)
+{
+	return make_uchar4((uchar)(saturate(f.x)*255.0f + 0.5f),
+	                   (uchar)(saturate(f.y)*255.0f + 0.5f),
+	                   (uchar)(saturate(f.z)*255.0f + 0.5f),
+	                   (uchar)(saturate(f.w)*255.0f + 0.5f));
+}
+
+Reprojection::Reprojection(int num_samples_)
+: num_samples(num_samples_)
+{
+	displayed.valid = false;
+	source.valid = false;
+	warped_width = warped_height = 0;
+	warped_x = warped_y = 0;
+	warped_valid = false;
+}
+
+void Reprojection::tonemapped(Camera *cam, const BufferParams& layout)
+{
+	displayed.width = layout.width;
+	displayed.height = layout.height;
+	displayed.full_x = layout.full_x;
+	displayed.full_y = layout.full_y;
+	displayed.full_width = layout.full_width;
+	displayed.rastertocamera = cam->rastertocamera;
+	displayed.cameratoworld = cam->cameratoworld;
+	displayed.farclip = cam->farclip;
+	/* Depth of other camera types does not map back to a point this way. */
+	displayed.valid = (cam->type == CAMERA_PERSPECTIVE);
+}
+
+void Reprojection::store(RenderBuffers *buffers, DisplayBuffer *display)
+{
+	/* Nothing new was displayed since the last reset, keep the stored
+	 * image, the render buffers may already hold samples of the new view. */
+	if(!displayed.valid)
+		return;
+
+	displayed.valid = false;
+	source.valid = false;
+	warped_valid = false;
+
+	int size = displayed.width*displayed.height;
+
+	if(size == 0 ||
+	   display->draw_width != displayed.width ||
+	   display->draw_height != displayed.height)
+	{
+		return;
+	}
+
+	/* The depth pass is packed with the stride of the displayed layout. */
+	source_depth.resize(buffers->params.width*buffers->params.height);
+	if(!buffers->get_pass_rect(PASS_DEPTH, 1.0f, 1, 1, source_depth.data()))
+		return;
+	source_depth.resize(size);
+
+	source_color.resize(size);
+	if(display->half_float) {
+		half4 *in = (half4*)display->rgba_half.data_pointer;
+
+		for(int i = 0; i < size; i++)
+			source_color[i] = half4_to_float4(in[i]);
+	}
+	else {
+		uchar4 *in = (uchar4*)display->rgba_byte.data_pointer;
+
+		for(int i = 0; i < size; i++)
+			source_color[i] = byte_to_float4(in[i]);
+	}
+
+	source = displayed;
+	source.valid = true;
+}
+
+void Reprojection::clear()
+{
+	source.valid = false;
+	warped_valid = false;
+}
+
+void Reprojection::splat(Camera *cam, const BufferParams& layout)
+{
+	warped_width = layout.width;
+	warped_height = layout.height;
+	warped_x = layout.full_x;
+	warped_y = layout.full_y;
+	warped_valid = true;
+
+	int size = warped_width*warped_height;
+	warped_color.resize(size);
+	warped_depth.resize(size);
+
+	for(int i = 0; i < size; i++) {
+		warped_color[i] = make_float4(0.0f, 0.0f, 0.0f, 0.0f);
+		warped_depth[i] = FLT_MAX;
+	}
+
+	if(cam->type != CAMERA_PERSPECTIVE)
+		return;
+
+	float3 source_P = transform_get_column(&source.cameratoworld, 3);
+	float3 P = transform_get_column(&cam->cameratoworld, 3);
+	float3 D = transform_get_column(&cam->cameratoworld, 2);
+
+	/* Splat every source pixel over the area it covers in the new layout,
+	 * to avoid cracks when the new layout has a finer resolution. */
+	int footprint = max((int)ceilf((float)layout.full_width / (float)source.full_width), 1);
+
+	for(int y = 0; y < source.height; y++) {
+		for(int x = 0; x < source.width; x++) {
+			int index = y*source.width + x;
+			float3 raster = make_float3((float)(source.full_x + x) + 0.5f,
+			                            (float)(source.full_y + y) + 0.5f,
+			                            0.0f);
+			float3 Pcamera = transform_perspective(&source.rastertocamera, raster);
+			float3 dir = normalize(transform_direction(&source.cameratoworld, Pcamera));
+
+			/* Background pixels have no depth, reproject them at the clip
+			 * distance so rotations keep them in place. */
+			float depth = source_depth[index];
+			float3 Pworld = source_P + dir*((depth < 1e10f)? depth: source.farclip);
+
+			if(dot(Pworld - P, D) <= 0.0f)
+				continue;
+
+			float distance = len(Pworld - P);
+			float3 new_raster = transform_perspective(&cam->worldtoraster, Pworld);
+			int nx = (int)floorf(new_raster.x) - warped_x - footprint/2;
+			int ny = (int)floorf(new_raster.y) - warped_y - footprint/2;
+
+			for(int j = max(ny, 0); j < min(ny + footprint, warped_height); j++) {
+				for(int i = max(nx, 0); i < min(nx + footprint, warped_width); i++) {
+					int new_index = j*warped_width + i;
+
+					if(distance < warped_depth[new_index]) {
+						warped_depth[new_index] = distance;
+						warped_color[new_index] = source_color[index];
+					}
+				}
+			}
+		}
+	}
+}
+
+void Reprojection::blend(DisplayBuffer *display, Camera *cam, const BufferParams& layout, int sample)
+{
+	if(!source.valid || sample + 1 >= num_samples)
+		return;
+
+	if(!warped_valid ||
+	   warped_width != layout.width || warped_height != layout.height ||
+	   warped_x != layout.full_x || warped_y != layout.full_y)
+	{
+		splat(cam, layout);
+	}
+
+	/* Fade the warped image out as new samples come in. */
+	float weight = 1.0f - (float)(sample + 1) / (float)num_samples;
+	int size = warped_width*warped_height;
+
+	if(display->half_float) {
+		half4 *out = (half4*)display->rgba_half.data_pointer;
+
+		for(int i = 0; i < size; i++) {
+			if(warped_depth[i] == FLT_MAX)
+				continue;
+
+			float4 color = half4_to_float4(out[i]);
+			color += (warped_color[i] - color)*weight;
+			float4_store_half(&out[i].x, color, 1.0f);
+		}
+	}
+	else {
+		uchar4 *out = (uchar4*)display->rgba_byte.data_pointer;
+
+		for(int i = 0; i < size; i++) {
+			if(warped_depth[i] == FLT_MAX)
+				continue;
+
+			float4 color = byte_to_float4(out[i]);
+			color += (warped_color[i] - color)*weight;
+			out[i] = float4_to_byte(color);
+		}
+	}
+}
+
+CCL_NAMESPACE_END
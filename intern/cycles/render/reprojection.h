@@ -0,0 +1,88 @@
+/*
+ * Copyright 2011-2017 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __REPROJECTION_H__
+#define __REPROJECTION_H__
+
+#include "render/buffers.h"
+
+#include "util/util_transform.h"
+#include "util/util_types.h"
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+class Camera;
+
+/* Reprojection
+ *
+ * Keeps the last displayed viewport image together with its depth pass, and
+ * after a camera-only change warps it into the new view. The first samples
+ * rendered for the new view are blended with the warped image, so navigating
+ * shows a useful image immediately instead of restarting from noise.
+ *
+ * Only used for interactive CPU rendering, where the display and render
+ * buffers live in host memory. */
+
+class Reprojection {
+public:
+	explicit Reprojection(int num_samples);
+
+	/* Remember the camera and layout of the image that was just displayed. */
+	void tonemapped(Camera *cam, const BufferParams& layout);
+
+	/* Copy the displayed image and its depth before the buffers are reset. */
+	void store(RenderBuffers *buffers, DisplayBuffer *display);
+
+	/* Discard the stored image, when more than the camera changed. */
+	void clear();
+
+	/* Blend the warped image into the display, after converting \a sample. */
+	void blend(DisplayBuffer *display, Camera *cam, const BufferParams& layout, int sample);
+
+	/* Number of samples to blend the warped image with. */
+	int num_samples;
+
+protected:
+	struct View {
+		int width, height;
+		int full_x, full_y, full_width;
+		Transform rastertocamera;
+		Transform cameratoworld;
+		float farclip;
+		bool valid;
+	};
+
+	void splat(Camera *cam, const BufferParams& layout);
+
+	/* Camera of the displayed image. */
+	View displayed;
+
+	/* Stored image, in display space, and its camera distance. */
+	View source;
+	array<float4> source_color;
+	array<float> source_depth;
+
+	/* Stored image warped into the current layout, holes have FLT_MAX depth. */
+	int warped_width, warped_height, warped_x, warped_y;
+	array<float4> warped_color;
+	array<float> warped_depth;
+	bool warped_valid;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __REPROJECTION_H__ */
@@ -55,6 +55,7 @@ Scene::Scene(const SceneParams& params_, const DeviceInfo& device_info_)
 	object_manager = new ObjectManager();
 	integrator = new Integrator();
 	image_manager = new ImageManager(device_info_);
+	image_manager->set_half_float_images(params.use_half_float_textures);
 	particle_system_manager = new ParticleSystemManager();
 	curve_system_manager = new CurveSystemManager();
 	bake_manager = new BakeManager();
@@ -156,6 +157,10 @@ void Scene::device_update(Device *device_, Progress& progress)
 
 	if(progress.get_cancel() || device->have_error()) return;
 
+	/* All images are known once shaders are compiled, load them from files
+	 * while objects and meshes are updated and BVHs are built. */
+	image_manager->device_load_begin(device, &dscene, this, progress);
+
 	progress.set_status("Updating Background");
 	background->device_update(device, &dscene, this);
 
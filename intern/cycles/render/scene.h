@@ -96,6 +96,7 @@ public:
 	/* lights */
 	device_vector<float4> light_distribution;
 	device_vector<float4> light_data;
+	device_vector<float4> light_tree_nodes;
 	device_vector<float2> light_background_marginal_cdf;
 	device_vector<float2> light_background_conditional_cdf;
 
@@ -146,8 +147,12 @@ public:
 	bool use_bvh_unaligned_nodes;
 	int num_bvh_time_steps;
 	bool use_qbvh;
+	bool use_bvh8;
+	bool use_bvh_quantized_nodes;
 	bool persistent_data;
+	bool use_bvh_cache;
 	int texture_limit;
+	bool use_half_float_textures;
 
 	SceneParams()
 	{
@@ -157,8 +162,12 @@ public:
 		use_bvh_unaligned_nodes = true;
 		num_bvh_time_steps = 0;
 		use_qbvh = false;
+		use_bvh8 = false;
+		use_bvh_quantized_nodes = false;
 		persistent_data = false;
+		use_bvh_cache = false;
 		texture_limit = 0;
+		use_half_float_textures = false;
 	}
 
 	bool modified(const SceneParams& params)
@@ -168,8 +177,12 @@ public:
 		&& use_bvh_unaligned_nodes == params.use_bvh_unaligned_nodes
 		&& num_bvh_time_steps == params.num_bvh_time_steps
 		&& use_qbvh == params.use_qbvh
+		&& use_bvh8 == params.use_bvh8
+		&& use_bvh_quantized_nodes == params.use_bvh_quantized_nodes
 		&& persistent_data == params.persistent_data
-		&& texture_limit == params.texture_limit); }
+		&& use_bvh_cache == params.use_bvh_cache
+		&& texture_limit == params.texture_limit
+		&& use_half_float_textures == params.use_half_float_textures); }
 };
 
 /* Scene */
@@ -17,13 +17,17 @@
 #include <string.h>
 #include <limits.h>
 
+#include "render/background.h"
 #include "render/buffers.h"
 #include "render/camera.h"
 #include "device/device.h"
 #include "render/graph.h"
+#include "render/film.h"
 #include "render/integrator.h"
+#include "render/light.h"
 #include "render/mesh.h"
 #include "render/object.h"
+#include "render/reprojection.h"
 #include "render/scene.h"
 #include "render/session.h"
 #include "render/bake.h"
@@ -55,6 +59,8 @@ Session::Session(const SessionParams& params_)
 
 	device = Device::create(params.device, stats, params.background);
 
+	tile_manager.split_tiles = params.split_tiles;
+
 	if(params.background && params.output_path.empty()) {
 		buffers = NULL;
 		display = NULL;
@@ -64,6 +70,11 @@ Session::Session(const SessionParams& params_)
 		display = new DisplayBuffer(device, params.display_buffer_linear);
 	}
 
+	if(!params.background && !device_use_gl && params.reprojection_samples > 0)
+		reprojection = new Reprojection(params.reprojection_samples);
+	else
+		reprojection = NULL;
+
 	session_thread = NULL;
 	scene = NULL;
 
@@ -118,6 +129,7 @@ Session::~Session()
 		delete rtile.buffers;
 	tile_manager.free_device();
 
+	delete reprojection;
 	delete buffers;
 	delete display;
 	delete scene;
@@ -723,6 +735,10 @@ DeviceRequestedFeatures Session::get_requested_device_features()
 	requested_features.use_integrator_branched = (scene->integrator->method == Integrator::BRANCHED_PATH);
 	requested_features.use_transparent &= scene->integrator->transparent_shadows;
 	requested_features.use_denoising = params.use_denoising;
+	requested_features.use_ao |= scene->background->ao_factor != 0.0f ||
+	                             Pass::contains(scene->film->passes, PASS_AO) ||
+	                             requested_features.use_baking;
+	requested_features.use_background_light = scene->light_manager->has_background_light(scene);
 
 	return requested_features;
 }
@@ -773,11 +789,16 @@ void Session::run()
 	if(!progress.get_cancel()) {
 		/* reset number of rendered samples */
 		progress.reset_sample();
+		stats.kernel.reset();
 
 		if(device_use_gl)
 			run_gpu();
 		else
 			run_cpu();
+
+#ifdef WITH_CYCLES_DEBUG
+		VLOG(1) << "Kernel statistics:\n" << stats.kernel.full_report();
+#endif
 	}
 
 	/* progress update */
@@ -789,6 +810,8 @@ void Session::run()
 
 bool Session::draw(BufferParams& buffer_params, DeviceDrawParams &draw_params)
 {
+	add_reprojection_passes(buffer_params);
+
 	if(device_use_gl)
 		return draw_gpu(buffer_params, draw_params);
 	else
@@ -797,6 +820,9 @@ bool Session::draw(BufferParams& buffer_params, DeviceDrawParams &draw_params)
 
 void Session::reset_(BufferParams& buffer_params, int samples)
 {
+	if(reprojection && buffers)
+		reprojection->store(buffers, display);
+
 	if(buffers) {
 		if(buffer_params.modified(buffers->params)) {
 			gpu_draw_ready = false;
@@ -818,6 +844,8 @@ void Session::reset_(BufferParams& buffer_params, int samples)
 
 void Session::reset(BufferParams& buffer_params, int samples)
 {
+	add_reprojection_passes(buffer_params);
+
 	if(device_use_gl)
 		reset_gpu(buffer_params, samples);
 	else
@@ -871,6 +899,12 @@ void Session::wait()
 	session_thread = NULL;
 }
 
+void Session::add_reprojection_passes(BufferParams& buffer_params)
+{
+	if(reprojection)
+		Pass::add(PASS_DEPTH, buffer_params.passes);
+}
+
 void Session::update_scene()
 {
 	thread_scoped_lock scene_lock(scene->mutex);
@@ -906,6 +940,22 @@ void Session::update_scene()
 		}
 	}
 
+	/* the depth pass is needed to reproject the image into a new view, any
+	 * change other than the camera makes the previous image unusable */
+	if(reprojection) {
+		Film *film = scene->film;
+
+		if(!Pass::contains(film->passes, PASS_DEPTH)) {
+			array<Pass> passes = film->passes;
+			Pass::add(PASS_DEPTH, passes);
+			film->tag_passes_update(scene, passes);
+			film->tag_update(scene);
+		}
+
+		if(scene->need_data_update())
+			reprojection->clear();
+	}
+
 	/* update scene */
 	if(scene->need_update()) {
 		load_kernels(false);
@@ -1022,6 +1072,11 @@ void Session::tonemap(int sample)
 		device->task_add(task);
 		device->task_wait();
 
+		if(reprojection) {
+			reprojection->blend(display, scene->camera, tile_manager.state.buffer, sample);
+			reprojection->tonemapped(scene->camera, tile_manager.state.buffer);
+		}
+
 		/* set display to new size */
 		display->draw_set(task.w, task.h);
 	}
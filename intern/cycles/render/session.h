@@ -36,6 +36,7 @@ class DeviceRequestedFeatures;
 class DisplayBuffer;
 class Progress;
 class RenderBuffers;
+class Reprojection;
 class Scene;
 
 /* Session Parameters */
@@ -52,6 +53,7 @@ public:
 	int samples;
 	int2 tile_size;
 	TileOrder tile_order;
+	bool split_tiles;
 	int start_resolution;
 	int threads;
 
@@ -63,6 +65,11 @@ public:
 	float denoising_feature_strength;
 	bool denoising_relative_pca;
 
+	/* Number of samples after a camera-only change in the viewport that get
+	 * the previous image reprojected into the new view blended in, zero
+	 * disables reprojection. */
+	int reprojection_samples;
+
 	double cancel_timeout;
 	double reset_timeout;
 	double text_timeout;
@@ -89,6 +96,8 @@ public:
 		denoising_feature_strength = 0.0f;
 		denoising_relative_pca = false;
 
+		reprojection_samples = 0;
+
 		display_buffer_linear = false;
 
 		cancel_timeout = 0.1;
@@ -98,6 +107,7 @@ public:
 
 		shadingsystem = SHADINGSYSTEM_SVM;
 		tile_order = TILE_CENTER;
+		split_tiles = false;
 	}
 
 	bool modified(const SessionParams& params)
@@ -112,11 +122,13 @@ public:
 		&& start_resolution == params.start_resolution
 		&& threads == params.threads
 		&& display_buffer_linear == params.display_buffer_linear
+		&& reprojection_samples == params.reprojection_samples
 		&& cancel_timeout == params.cancel_timeout
 		&& reset_timeout == params.reset_timeout
 		&& text_timeout == params.text_timeout
 		&& progressive_update_timeout == params.progressive_update_timeout
 		&& tile_order == params.tile_order
+		&& split_tiles == params.split_tiles
 		&& shadingsystem == params.shadingsystem); }
 
 };
@@ -220,6 +232,10 @@ protected:
 
 	vector<RenderTile> render_tiles;
 
+	/* reuse of the previous image after camera changes, CPU viewport only */
+	Reprojection *reprojection;
+	void add_reprojection_passes(BufferParams& params);
+
 	DeviceRequestedFeatures get_requested_device_features();
 
 	/* ** Split kernel routines ** */
@@ -598,6 +598,9 @@ void ShaderManager::get_requested_graph_features(ShaderGraph *graph,
 		if(node->has_surface_transparent()) {
 			requested_features->use_transparent = true;
 		}
+		if(node->get_closure_type() == CLOSURE_AMBIENT_OCCLUSION_ID) {
+			requested_features->use_ao = true;
+		}
 	}
 }
 
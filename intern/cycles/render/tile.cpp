@@ -99,6 +99,7 @@ TileManager::TileManager(bool progressive_, int num_samples_, int2 tile_size_, i
 	preserve_tile_device = preserve_tile_device_;
 	background = background_;
 	schedule_denoising = false;
+	split_tiles = false;
 
 	range_start_sample = 0;
 	range_num_samples = -1;
@@ -144,6 +145,7 @@ void TileManager::reset(BufferParams& params_, int num_samples_)
 	state.buffer = BufferParams();
 	state.sample = range_start_sample - 1;
 	state.num_tiles = 0;
+	state.num_rendering_tiles = 0;
 	state.num_samples = 0;
 	state.resolution_divider = get_divider(params.width, params.height, start_resolution);
 	state.render_tiles.clear();
@@ -348,6 +350,13 @@ void TileManager::set_tiles()
 	int image_h = max(1, params.height/resolution);
 
 	state.num_tiles = gen_tiles(!background);
+	state.num_rendering_tiles = 0;
+
+	/* Tiles being rendered are referenced by pointer, so splitting must not
+	 * reallocate the tile array. */
+	if(split_tiles) {
+		state.tiles.reserve(state.tiles.size()*4 + 64);
+	}
 
 	state.buffer.width = image_w;
 	state.buffer.height = image_h;
@@ -400,6 +409,8 @@ bool TileManager::finish_tile(int index, bool &delete_tile)
 	switch(state.tiles[index].state) {
 		case Tile::RENDER:
 		{
+			state.num_rendering_tiles--;
+
 			if(!schedule_denoising) {
 				state.tiles[index].state = Tile::DONE;
 				delete_tile = true;
@@ -443,6 +454,41 @@ bool TileManager::finish_tile(int index, bool &delete_tile)
 	}
 }
 
+bool TileManager::split_tile(int index, list<int>& tile_list)
+{
+	/* Tiles smaller than this are not worth the per tile overhead. */
+	const int min_size = 16;
+
+	if(state.tiles[index].w < 2*min_size ||
+	   state.tiles[index].h < 2*min_size ||
+	   state.tiles.size() + 3 > state.tiles.capacity())
+	{
+		return false;
+	}
+
+	Tile& tile = state.tiles[index];
+	int w = tile.w/2, h = tile.h/2;
+
+	/* Queue in reverse so the pieces are handed out in order. */
+	for(int i = 3; i > 0; i--) {
+		int x = (i & 1)? tile.x + w: tile.x;
+		int y = (i & 2)? tile.y + h: tile.y;
+		int idx = state.tiles.size();
+
+		state.tiles.push_back(Tile(idx, x, y,
+		                           (i & 1)? tile.w - w: w,
+		                           (i & 2)? tile.h - h: h,
+		                           tile.device, Tile::RENDER));
+		tile_list.push_front(idx);
+	}
+
+	tile.w = w;
+	tile.h = h;
+	state.num_tiles += 3;
+
+	return true;
+}
+
 bool TileManager::next_tile(Tile* &tile, int device)
 {
 	int logical_device = preserve_tile_device? device: 0;
@@ -462,6 +508,17 @@ bool TileManager::next_tile(Tile* &tile, int device)
 
 	int idx = state.render_tiles[logical_device].front();
 	state.render_tiles[logical_device].pop_front();
+
+	/* Near the end of the frame, hand out smaller pieces so the last tiles
+	 * are spread over all devices. Not possible with progressive refine or
+	 * denoising, which rely on the tile grid. */
+	if(split_tiles && !progressive && !preserve_tile_device && !schedule_denoising &&
+	   state.render_tiles[logical_device].size() < state.num_rendering_tiles + 1)
+	{
+		split_tile(idx, state.render_tiles[logical_device]);
+	}
+
+	state.num_rendering_tiles++;
 	tile = &state.tiles[idx];
 	return true;
 }
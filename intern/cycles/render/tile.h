@@ -83,6 +83,9 @@ public:
 		 * Each list in each vector is for one logical device. */
 		vector<list<int> > render_tiles;
 		vector<list<int> > denoising_tiles;
+
+		/* Number of tiles handed out for rendering and not finished yet. */
+		int num_rendering_tiles;
 	} state;
 
 	int num_samples;
@@ -114,6 +117,11 @@ public:
 
 	/* Schedule tiles for denoising after they've been rendered. */
 	bool schedule_denoising;
+
+	/* Split tiles near the end of the frame, when fewer tiles are left than
+	 * are being rendered, so devices finishing early take over part of the
+	 * remaining work instead of waiting for the slowest device. */
+	bool split_tiles;
 protected:
 
 	void set_tiles();
@@ -146,6 +154,9 @@ protected:
 	/* Generate tile list, return number of tiles. */
 	int gen_tiles(bool sliced);
 
+	/* Split tile into quarters, keeping the first and queueing the others. */
+	bool split_tile(int index, list<int>& tile_list);
+
 	int get_neighbor_index(int index, int neighbor);
 	bool check_neighbor_state(int index, Tile::State state);
 };
@@ -39,6 +39,8 @@ struct SubdParams {
 	int split_threshold;
 	float dicing_rate;
 	int max_level;
+	/* Maximum number of triangles per mesh, 0 for unlimited. */
+	int max_triangles;
 	Camera *camera;
 	Transform objecttoworld;
 
@@ -51,6 +53,7 @@ struct SubdParams {
 		split_threshold = 1;
 		dicing_rate = 1.0f;
 		max_level = 12;
+		max_triangles = 0;
 		camera = NULL;
 	}
 
@@ -30,7 +30,7 @@ CCL_NAMESPACE_BEGIN
 /* DiagSplit */
 
 DiagSplit::DiagSplit(const SubdParams& params_)
-: params(params_)
+: params(params_), count_only(false), num_triangles(0)
 {
 }
 
@@ -240,6 +240,21 @@ void DiagSplit::split_quad(Patch *patch, QuadDice::SubPatch *subpatch)
 
 	split(sub_split, ef_split);
 
+	if(count_only) {
+		/* Same grid size as QuadDice::dice(), plus stitching of the sides. */
+		for(size_t i = 0; i < subpatches_quad.size(); i++) {
+			QuadDice::EdgeFactors& ef = edgefactors_quad[i];
+			size_t Mu = max(max(ef.tu0, ef.tu1), 2);
+			size_t Mv = max(max(ef.tv0, ef.tv1), 2);
+
+			num_triangles += 2*Mu*Mv;
+		}
+
+		subpatches_quad.clear();
+		edgefactors_quad.clear();
+		return;
+	}
+
 	QuadDice dice(params);
 
 	for(size_t i = 0; i < subpatches_quad.size(); i++) {
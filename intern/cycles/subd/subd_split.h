@@ -41,6 +41,10 @@ public:
 
 	SubdParams params;
 
+	/* Only estimate the number of triangles instead of dicing. */
+	bool count_only;
+	size_t num_triangles;
+
 	explicit DiagSplit(const SubdParams& params);
 
 	float3 to_world(Patch *patch, float2 uv);
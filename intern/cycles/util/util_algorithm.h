@@ -22,6 +22,7 @@
 CCL_NAMESPACE_BEGIN
 
 using std::sort;
+using std::nth_element;
 using std::swap;
 using std::max;
 using std::min;
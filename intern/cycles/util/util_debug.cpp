@@ -30,6 +30,7 @@ DebugFlags::CPU::CPU()
     sse3(true),
     sse2(true),
     qbvh(true),
+    bvh8(false),
     split_kernel(false)
 {
 	reset();
@@ -56,6 +57,7 @@ void DebugFlags::CPU::reset()
 #undef CHECK_CPU_FLAGS
 
 	qbvh = true;
+	bvh8 = false;
 	split_kernel = false;
 }
 
@@ -142,6 +144,7 @@ std::ostream& operator <<(std::ostream &os,
 	   << "  SSE3   : " << string_from_bool(debug_flags.cpu.sse3)  << "\n"
 	   << "  SSE2   : " << string_from_bool(debug_flags.cpu.sse2)  << "\n"
 	   << "  QBVH   : " << string_from_bool(debug_flags.cpu.qbvh)  << "\n"
+	   << "  BVH8   : " << string_from_bool(debug_flags.cpu.bvh8)  << "\n"
 	   << "  Split  : " << string_from_bool(debug_flags.cpu.split_kernel) << "\n";
 
 	os << "CUDA flags:\n"
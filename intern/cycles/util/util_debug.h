@@ -47,6 +47,9 @@ public:
 		/* Whether QBVH usage is allowed or not. */
 		bool qbvh;
 
+		/* Whether 8-wide BVH is used instead of QBVH, requires AVX2. */
+		bool bvh8;
+
 		/* Whether split kernel is used */
 		bool split_kernel;
 	};
@@ -18,9 +18,82 @@
 #define __UTIL_STATS_H__
 
 #include "util/util_atomic.h"
+#include "util/util_string.h"
 
 CCL_NAMESPACE_BEGIN
 
+/* Counters of work done by the render kernels. These are only collected in
+ * debug builds, per thread in KernelGlobals for CPU devices, and added to the
+ * render statistics after every tile. */
+
+struct KernelStats {
+	KernelStats()
+	{
+		reset();
+	}
+
+	void reset()
+	{
+		num_paths = 0;
+		num_rays = 0;
+		num_shadow_rays = 0;
+		num_bvh_traversed_nodes = 0;
+		num_bvh_traversed_instances = 0;
+		num_bvh_intersections = 0;
+		num_shader_evals = 0;
+		num_light_samples = 0;
+	}
+
+	/* Thread safe, for adding per thread counters. */
+	void add(const KernelStats& other)
+	{
+		atomic_add_and_fetch_uint64(&num_paths, other.num_paths);
+		atomic_add_and_fetch_uint64(&num_rays, other.num_rays);
+		atomic_add_and_fetch_uint64(&num_shadow_rays, other.num_shadow_rays);
+		atomic_add_and_fetch_uint64(&num_bvh_traversed_nodes, other.num_bvh_traversed_nodes);
+		atomic_add_and_fetch_uint64(&num_bvh_traversed_instances, other.num_bvh_traversed_instances);
+		atomic_add_and_fetch_uint64(&num_bvh_intersections, other.num_bvh_intersections);
+		atomic_add_and_fetch_uint64(&num_shader_evals, other.num_shader_evals);
+		atomic_add_and_fetch_uint64(&num_light_samples, other.num_light_samples);
+	}
+
+	string full_report() const
+	{
+		const double inv_paths = (num_paths)? 1.0 / num_paths: 0.0;
+
+		return string_printf(
+		        "  Paths:                       %llu\n"
+		        "  Rays:                        %llu (%.2f per path)\n"
+		        "  Shadow rays:                 %llu (%.2f per path)\n"
+		        "  BVH traversed nodes:         %llu\n"
+		        "  BVH traversed instances:     %llu\n"
+		        "  BVH intersections:           %llu\n"
+		        "  Shader evaluations:          %llu (%.2f per path)\n"
+		        "  Light samples:               %llu (%.2f per path)\n",
+		        (unsigned long long)num_paths,
+		        (unsigned long long)num_rays, num_rays * inv_paths,
+		        (unsigned long long)num_shadow_rays, num_shadow_rays * inv_paths,
+		        (unsigned long long)num_bvh_traversed_nodes,
+		        (unsigned long long)num_bvh_traversed_instances,
+		        (unsigned long long)num_bvh_intersections,
+		        (unsigned long long)num_shader_evals, num_shader_evals * inv_paths,
+		        (unsigned long long)num_light_samples, num_light_samples * inv_paths);
+	}
+
+	/* Camera paths, and all rays traced along them including the camera ray. */
+	uint64_t num_paths;
+	uint64_t num_rays;
+	uint64_t num_shadow_rays;
+
+	/* BVH traversal of camera rays. */
+	uint64_t num_bvh_traversed_nodes;
+	uint64_t num_bvh_traversed_instances;
+	uint64_t num_bvh_intersections;
+
+	uint64_t num_shader_evals;
+	uint64_t num_light_samples;
+};
+
 class Stats {
 public:
 	enum static_init_t { static_init = 0 };
@@ -40,6 +113,8 @@ public:
 
 	size_t mem_used;
 	size_t mem_peak;
+
+	KernelStats kernel;
 };
 
 CCL_NAMESPACE_END
@@ -41,6 +41,12 @@ unsigned GWN_vertbuf_size_get(const Gwn_VertBuf*);
 void GWN_vertbuf_data_alloc(Gwn_VertBuf*, unsigned v_ct);
 void GWN_vertbuf_data_resize(Gwn_VertBuf*, unsigned v_ct);
 
+// Rewrite the contents of a buffer that may already be in VRAM, keeping its vertex count and
+// GL buffer (so batches and VAOs using it stay valid).
+// Fill 'data' between begin and end, end sends it with glBufferSubData (needs a GL context).
+void GWN_vertbuf_data_update_begin(Gwn_VertBuf*);
+void GWN_vertbuf_data_update_end(Gwn_VertBuf*);
+
 // The most important set_attrib variant is the untyped one. Get it right first.
 // It takes a void* so the app developer is responsible for matching their app data types
 // to the vertex attribute's type and component count. They're in control of both, so this
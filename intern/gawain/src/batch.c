@@ -106,8 +106,12 @@ static void Batch_update_program_bindings(Gwn_Batch* batch)
 	{
 	// disable all as a precaution
 	// why are we not using prev_attrib_enabled_bits?? see immediate.c
+	// (instanced draws leave a divisor on the VAO, reset it too)
 	for (unsigned a_idx = 0; a_idx < GWN_VERT_ATTR_MAX_LEN; ++a_idx)
+		{
 		glDisableVertexAttribArray(a_idx);
+		glVertexAttribDivisor(a_idx, 0);
+		}
 
 	for (int v = 0; v < GWN_BATCH_VBO_MAX_LEN; ++v)
 		{
@@ -329,6 +333,14 @@ void GWN_batch_draw_stupid(Gwn_Batch* batch)
 void GWN_batch_draw_stupid_instanced(Gwn_Batch* batch, unsigned int instance_vbo, int instance_count,
                                  int attrib_nbr, int attrib_stride, int attrib_size[16], int attrib_loc[16])
 	{
+	GWN_batch_draw_stupid_instanced_ex(batch, instance_vbo, 0, instance_count,
+	                                   attrib_nbr, attrib_stride, attrib_size, attrib_loc);
+	}
+
+// draw instances [instance_first, instance_first + instance_count) of instance_vbo
+void GWN_batch_draw_stupid_instanced_ex(Gwn_Batch* batch, unsigned int instance_vbo, int instance_first, int instance_count,
+                                    int attrib_nbr, int attrib_stride, int attrib_size[16], int attrib_loc[16])
+	{
 	if (batch->vao_id)
 		glBindVertexArray(batch->vao_id);
 	else
@@ -338,7 +350,7 @@ void GWN_batch_draw_stupid_instanced(Gwn_Batch* batch, unsigned int instance_vbo
 		Batch_update_program_bindings(batch);
 
 	glBindBuffer(GL_ARRAY_BUFFER, instance_vbo);
-	int ptr_ofs = 0;
+	int ptr_ofs = attrib_stride * instance_first;
 	for (int i = 0; i < attrib_nbr; ++i)
 		{
 		int size = attrib_size[i];
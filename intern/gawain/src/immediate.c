@@ -21,6 +21,13 @@
 extern void gpuBindMatrices(const Gwn_ShaderInterface*);
 extern bool gpuMatricesDirty(void);
 
+// size of internal buffer -- make this adjustable?
+#define IMM_BUFFER_SIZE (4 * 1024 * 1024)
+
+// the persistent ring buffer is split in segments, each one is fenced when the next one is entered
+#define IMM_RING_SEGMENT_CT 4
+#define IMM_RING_SEGMENT_SIZE (IMM_BUFFER_SIZE / IMM_RING_SEGMENT_CT)
+
 typedef struct {
 	// TODO: organize this struct by frequency of change (run-time)
 
@@ -45,6 +52,11 @@ typedef struct {
 
 	GLuint vbo_id;
 	GLuint vao_id;
+
+	// persistent mapped ring buffer (ARB_buffer_storage), NULL when using the map/orphan path
+	GLubyte* ring_data;
+	unsigned ring_used_bits; // segments written to since they were last fenced
+	GLsync ring_fences[IMM_RING_SEGMENT_CT]; // GPU is done reading a segment once its fence signals
 	
 	GLuint bound_program;
 	const Gwn_ShaderInterface* shader_interface;
@@ -52,9 +64,6 @@ typedef struct {
 	uint16_t prev_enabled_attrib_bits; // <-- only affects this VAO, so we're ok
 } Immediate;
 
-// size of internal buffer -- make this adjustable?
-#define IMM_BUFFER_SIZE (4 * 1024 * 1024)
-
 static bool initialized = false;
 static Immediate imm;
 
@@ -68,7 +77,17 @@ void immInit(void)
 
 	imm.vbo_id = GWN_buf_id_alloc();
 	glBindBuffer(GL_ARRAY_BUFFER, imm.vbo_id);
-	glBufferData(GL_ARRAY_BUFFER, IMM_BUFFER_SIZE, NULL, GL_DYNAMIC_DRAW);
+
+	if (GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage)
+		{
+		// map once & write directly to the buffer, fences tell us when a segment can be reused
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(GL_ARRAY_BUFFER, IMM_BUFFER_SIZE, NULL, flags);
+		imm.ring_data = glMapBufferRange(GL_ARRAY_BUFFER, 0, IMM_BUFFER_SIZE, flags);
+		}
+
+	if (imm.ring_data == NULL)
+		glBufferData(GL_ARRAY_BUFFER, IMM_BUFFER_SIZE, NULL, GL_DYNAMIC_DRAW);
 
 	imm.prim_type = GWN_PRIM_NONE;
 	imm.strict_vertex_ct = true;
@@ -106,6 +125,20 @@ void immDeactivate(void)
 void immDestroy(void)
 	{
 	immDeactivate();
+
+	if (imm.ring_data)
+		{
+		for (unsigned i = 0; i < IMM_RING_SEGMENT_CT; ++i)
+			{
+			if (imm.ring_fences[i])
+				glDeleteSync(imm.ring_fences[i]);
+			}
+
+		glBindBuffer(GL_ARRAY_BUFFER, imm.vbo_id);
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		}
+
 	GWN_buf_id_free(imm.vbo_id);
 	initialized = false;
 	}
@@ -173,6 +206,53 @@ static bool vertex_count_makes_sense_for_primitive(unsigned vertex_ct, Gwn_PrimT
 	}
 #endif
 
+// make the persistent ring buffer range [offset, offset + bytes) safe to write
+static void imm_ring_segments_acquire(unsigned offset, unsigned bytes)
+	{
+	const unsigned first = offset / IMM_RING_SEGMENT_SIZE;
+	const unsigned last = (offset + bytes - 1) / IMM_RING_SEGMENT_SIZE;
+	unsigned range_bits = 0;
+	for (unsigned i = first; i <= last; ++i)
+		range_bits |= 1 << i;
+
+	if ((range_bits & ~imm.ring_used_bits) == 0)
+		return; // still writing to segments we own
+
+	// segments we're leaving get fenced after all draws that read them
+	for (unsigned i = 0; i < IMM_RING_SEGMENT_CT; ++i)
+		{
+		const unsigned mask = 1 << i;
+		if ((imm.ring_used_bits & mask) && !(range_bits & mask))
+			{
+#if TRUST_NO_ONE
+			assert(imm.ring_fences[i] == NULL);
+#endif
+			imm.ring_fences[i] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			imm.ring_used_bits &= ~mask;
+			}
+		}
+
+	// segments we're entering may still be read by the GPU from the previous lap
+	for (unsigned i = first; i <= last; ++i)
+		{
+		const unsigned mask = 1 << i;
+		if (imm.ring_used_bits & mask)
+			continue;
+
+		if (imm.ring_fences[i])
+			{
+			GLenum result = glClientWaitSync(imm.ring_fences[i], 0, 0);
+			while (result == GL_TIMEOUT_EXPIRED)
+				result = glClientWaitSync(imm.ring_fences[i], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1ms
+
+			glDeleteSync(imm.ring_fences[i]);
+			imm.ring_fences[i] = NULL;
+			}
+
+		imm.ring_used_bits |= mask;
+		}
+	}
+
 void immBegin(Gwn_PrimType prim_type, unsigned vertex_ct)
 	{
 #if TRUST_NO_ONE
@@ -201,6 +281,11 @@ void immBegin(Gwn_PrimType prim_type, unsigned vertex_ct)
 	const unsigned pre_padding = padding(imm.buffer_offset, imm.vertex_format.stride); // might waste a little space, but it's safe
 	if ((bytes_needed + pre_padding) <= available_bytes)
 		imm.buffer_offset += pre_padding;
+	else if (imm.ring_data)
+		{
+		// wrap around, segments get reused once their fences have signaled
+		imm.buffer_offset = 0;
+		}
 	else
 		{
 		// orphan this buffer & start with a fresh one
@@ -231,8 +316,14 @@ void immBegin(Gwn_PrimType prim_type, unsigned vertex_ct)
 
 //	printf("mapping %u to %u\n", imm.buffer_offset, imm.buffer_offset + bytes_needed - 1);
 
-	imm.buffer_data = glMapBufferRange(GL_ARRAY_BUFFER, imm.buffer_offset, bytes_needed,
-	                                   GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | (imm.strict_vertex_ct ? 0 : GL_MAP_FLUSH_EXPLICIT_BIT));
+	if (imm.ring_data)
+		{
+		imm_ring_segments_acquire(imm.buffer_offset, bytes_needed);
+		imm.buffer_data = imm.ring_data + imm.buffer_offset;
+		}
+	else
+		imm.buffer_data = glMapBufferRange(GL_ARRAY_BUFFER, imm.buffer_offset, bytes_needed,
+		                                   GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | (imm.strict_vertex_ct ? 0 : GL_MAP_FLUSH_EXPLICIT_BIT));
 
 #if TRUST_NO_ONE
 	assert(imm.buffer_data != NULL);
@@ -385,7 +476,8 @@ void immEnd(void)
 
 		// tell OpenGL what range was modified so it doesn't copy the whole mapped range
 		// printf("flushing %u to %u\n", imm.buffer_offset, imm.buffer_offset + buffer_bytes_used - 1);
-		glFlushMappedBufferRange(GL_ARRAY_BUFFER, 0, buffer_bytes_used);
+		if (imm.ring_data == NULL)
+			glFlushMappedBufferRange(GL_ARRAY_BUFFER, 0, buffer_bytes_used);
 		}
 
 #if IMM_BATCH_COMBO
@@ -403,7 +495,8 @@ void immEnd(void)
 	else
 #endif
 		{
-		glUnmapBuffer(GL_ARRAY_BUFFER);
+		if (imm.ring_data == NULL) // coherent mapping, nothing to flush
+			glUnmapBuffer(GL_ARRAY_BUFFER);
 
 		if (imm.vertex_ct > 0)
 			{
@@ -117,6 +117,37 @@ void GWN_vertbuf_data_resize(Gwn_VertBuf* verts, unsigned v_ct)
 	// extra space will be reclaimed, and never sent to VRAM (see VertexBuffer_prime)
 	}
 
+void GWN_vertbuf_data_update_begin(Gwn_VertBuf* verts)
+	{
+#if TRUST_NO_ONE
+	assert(verts->vertex_ct != 0); // has already been allocated
+#endif
+
+	// After being sent to VRAM the main memory copy may be gone.
+	if (verts->data == NULL)
+		verts->data = malloc(GWN_vertbuf_size_get(verts));
+	}
+
+void GWN_vertbuf_data_update_end(Gwn_VertBuf* verts)
+	{
+#if TRUST_NO_ONE
+	assert(verts->data != NULL); // update_begin was called
+#endif
+
+	// Not in VRAM yet, the data is sent when first used.
+	if (verts->vbo_id == 0)
+		return;
+
+	glBindBuffer(GL_ARRAY_BUFFER, verts->vbo_id);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, GWN_vertbuf_size_get(verts), verts->data);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+#if KEEP_SINGLE_COPY
+	free(verts->data);
+	verts->data = NULL;
+#endif
+	}
+
 void GWN_vertbuf_attr_set(Gwn_VertBuf* verts, unsigned a_idx, unsigned v_idx, const void* data)
 	{
 	const Gwn_VertFormat* format = &verts->format;
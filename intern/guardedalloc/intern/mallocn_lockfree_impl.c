@@ -62,13 +62,18 @@ static void (*thread_unlock_callback)(void) = NULL;
 enum {
 	MEMHEAD_MMAP_FLAG = 1,
 	MEMHEAD_ALIGN_FLAG = 2,
+	/* Blocks are never both mapped and aligned, use the combination for small blocks. */
+	MEMHEAD_SMALL_FLAG = MEMHEAD_MMAP_FLAG | MEMHEAD_ALIGN_FLAG,
 };
 
+#define MEMHEAD_FLAGS(memhead) ((memhead)->len & (size_t) (MEMHEAD_MMAP_FLAG | MEMHEAD_ALIGN_FLAG))
+
 #define MEMHEAD_FROM_PTR(ptr) (((MemHead*) ptr) - 1)
 #define PTR_FROM_MEMHEAD(memhead) (memhead + 1)
 #define MEMHEAD_ALIGNED_FROM_PTR(ptr) (((MemHeadAligned*) ptr) - 1)
-#define MEMHEAD_IS_MMAP(memhead) ((memhead)->len & (size_t) MEMHEAD_MMAP_FLAG)
-#define MEMHEAD_IS_ALIGNED(memhead) ((memhead)->len & (size_t) MEMHEAD_ALIGN_FLAG)
+#define MEMHEAD_IS_MMAP(memhead) (MEMHEAD_FLAGS(memhead) == (size_t) MEMHEAD_MMAP_FLAG)
+#define MEMHEAD_IS_ALIGNED(memhead) (MEMHEAD_FLAGS(memhead) == (size_t) MEMHEAD_ALIGN_FLAG)
+#define MEMHEAD_IS_SMALL(memhead) (MEMHEAD_FLAGS(memhead) == (size_t) MEMHEAD_SMALL_FLAG)
 
 /* Uncomment this to have proper peak counter. */
 #define USE_ATOMIC_MAX
@@ -105,6 +110,192 @@ static void print_error(const char *str, ...)
 	}
 }
 
+/* -------------------------------------------------------------------- */
+/* Small blocks
+ *
+ * Allocations of up to SMALL_BLOCK_MAX_SIZE bytes (including the MemHead) use fixed size
+ * blocks kept in free lists of each thread, so threads allocating at once don't serialize
+ * in the system allocator. Blocks go back and forth between the thread caches and global
+ * free lists in batches, new blocks are carved from slabs which are never freed.
+ *
+ * Disabled on Windows (no thread exit callback to give the cached blocks back),
+ * and with address sanitizer, which can't check these blocks.
+ */
+
+#if !defined(WIN32) && !defined(__SANITIZE_ADDRESS__)
+#  define USE_SMALL_BLOCKS
+#endif
+
+#ifdef USE_SMALL_BLOCKS
+
+#include <pthread.h>
+
+#define SMALL_BLOCK_CLASS_SIZE 16
+#define SMALL_BLOCK_NUM_CLASSES 16
+#define SMALL_BLOCK_MAX_SIZE (SMALL_BLOCK_CLASS_SIZE * SMALL_BLOCK_NUM_CLASSES)
+/* Number of blocks moved between a thread cache and the global free list at once. */
+#define SMALL_BLOCK_BATCH 32
+#define SMALL_BLOCK_SLAB_SIZE (64 * 1024)
+
+#define SMALL_BLOCK_CLASS(len) (((len) + sizeof(MemHead) - 1) / SMALL_BLOCK_CLASS_SIZE)
+#define SMALL_BLOCK_SIZE(block_class) (((block_class) + 1) * SMALL_BLOCK_CLASS_SIZE)
+
+typedef struct SmallBlock {
+	struct SmallBlock *next;
+	/* Only used by the first block of batches in the global free lists. */
+	struct SmallBlock *next_batch;
+} SmallBlock;
+
+typedef struct SmallBlockCache {
+	SmallBlock *free[SMALL_BLOCK_NUM_CLASSES];
+	unsigned int totfree[SMALL_BLOCK_NUM_CLASSES];
+	bool is_registered;
+} SmallBlockCache;
+
+static struct {
+	SmallBlock *batches[SMALL_BLOCK_NUM_CLASSES];
+	unsigned int lock[SMALL_BLOCK_NUM_CLASSES];
+	size_t slab_in_use;
+	pthread_key_t cache_key;
+	pthread_once_t cache_key_once;
+} small_blocks = {.cache_key_once = PTHREAD_ONCE_INIT};
+
+static __thread SmallBlockCache small_block_cache;
+
+MEM_INLINE void small_block_lock(const size_t block_class)
+{
+	while (atomic_cas_u(&small_blocks.lock[block_class], 0, 1) != 0) {
+		/* pass */
+	}
+}
+
+MEM_INLINE void small_block_unlock(const size_t block_class)
+{
+	atomic_cas_u(&small_blocks.lock[block_class], 1, 0);
+}
+
+/* Give the first \a tot blocks of the thread cache back to the global free list. */
+static void small_block_cache_return(SmallBlockCache *cache, const size_t block_class, unsigned int tot)
+{
+	SmallBlock *first = cache->free[block_class], *last = first;
+	unsigned int i;
+
+	for (i = 1; i < tot; i++) {
+		last = last->next;
+	}
+	cache->free[block_class] = last->next;
+	cache->totfree[block_class] -= tot;
+	last->next = NULL;
+
+	small_block_lock(block_class);
+	first->next_batch = small_blocks.batches[block_class];
+	small_blocks.batches[block_class] = first;
+	small_block_unlock(block_class);
+}
+
+static void small_block_cache_free_all(void *cache_v)
+{
+	SmallBlockCache *cache = cache_v;
+	size_t block_class;
+
+	for (block_class = 0; block_class < SMALL_BLOCK_NUM_CLASSES; block_class++) {
+		if (cache->totfree[block_class] != 0) {
+			small_block_cache_return(cache, block_class, cache->totfree[block_class]);
+		}
+	}
+}
+
+static void small_block_cache_key_create(void)
+{
+	pthread_key_create(&small_blocks.cache_key, small_block_cache_free_all);
+}
+
+static bool small_block_cache_refill(SmallBlockCache *cache, const size_t block_class)
+{
+	SmallBlock *batch;
+	unsigned int tot = 0;
+
+	if (UNLIKELY(!cache->is_registered)) {
+		/* give the cached blocks back when the thread exits */
+		pthread_once(&small_blocks.cache_key_once, small_block_cache_key_create);
+		pthread_setspecific(small_blocks.cache_key, cache);
+		cache->is_registered = true;
+	}
+
+	small_block_lock(block_class);
+	batch = small_blocks.batches[block_class];
+	if (batch) {
+		small_blocks.batches[block_class] = batch->next_batch;
+	}
+	small_block_unlock(block_class);
+
+	if (batch) {
+		SmallBlock *block;
+		for (block = batch; block; block = block->next) {
+			tot++;
+		}
+	}
+	else {
+		/* carve all the blocks of a new slab */
+		const size_t block_size = SMALL_BLOCK_SIZE(block_class);
+		char *slab = malloc(SMALL_BLOCK_SLAB_SIZE);
+		size_t i;
+
+		if (UNLIKELY(slab == NULL)) {
+			return false;
+		}
+		atomic_add_and_fetch_z(&small_blocks.slab_in_use, SMALL_BLOCK_SLAB_SIZE);
+
+		batch = NULL;
+		for (i = SMALL_BLOCK_SLAB_SIZE / block_size; i--; tot++) {
+			SmallBlock *block = (SmallBlock *)(slab + i * block_size);
+			block->next = batch;
+			batch = block;
+		}
+	}
+
+	cache->free[block_class] = batch;
+	cache->totfree[block_class] = tot;
+	return true;
+}
+
+static MemHead *small_block_alloc(const size_t len)
+{
+	const size_t block_class = SMALL_BLOCK_CLASS(len);
+	SmallBlockCache *cache = &small_block_cache;
+	SmallBlock *block;
+
+	if (UNLIKELY(cache->free[block_class] == NULL)) {
+		if (!small_block_cache_refill(cache, block_class)) {
+			return NULL;
+		}
+	}
+
+	block = cache->free[block_class];
+	cache->free[block_class] = block->next;
+	cache->totfree[block_class]--;
+
+	return (MemHead *)block;
+}
+
+static void small_block_free(MemHead *memh, const size_t len)
+{
+	const size_t block_class = SMALL_BLOCK_CLASS(len);
+	SmallBlockCache *cache = &small_block_cache;
+	SmallBlock *block = (SmallBlock *)memh;
+
+	block->next = cache->free[block_class];
+	cache->free[block_class] = block;
+	cache->totfree[block_class]++;
+
+	/* keep a batch for the following allocations, give the rest back */
+	if (UNLIKELY(cache->totfree[block_class] >= SMALL_BLOCK_BATCH * 2)) {
+		small_block_cache_return(cache, block_class, SMALL_BLOCK_BATCH);
+	}
+}
+
+#endif  /* USE_SMALL_BLOCKS */
+
 #if defined(WIN32)
 static void mem_lock_thread(void)
 {
@@ -145,6 +336,16 @@ void MEM_lockfree_freeN(void *vmemh)
 	atomic_sub_and_fetch_u(&totblock, 1);
 	atomic_sub_and_fetch_z(&mem_in_use, len);
 
+#ifdef USE_SMALL_BLOCKS
+	if (MEMHEAD_IS_SMALL(memh)) {
+		if (UNLIKELY(malloc_debug_memset && len)) {
+			memset(memh + 1, 255, len);
+		}
+		small_block_free(memh, len);
+		return;
+	}
+#endif
+
 	if (MEMHEAD_IS_MMAP(memh)) {
 		atomic_sub_and_fetch_z(&mmap_in_use, len);
 #if defined(WIN32)
@@ -283,6 +484,21 @@ void *MEM_lockfree_callocN(size_t len, const char *str)
 
 	len = SIZET_ALIGN_4(len);
 
+#ifdef USE_SMALL_BLOCKS
+	if (len + sizeof(MemHead) <= SMALL_BLOCK_MAX_SIZE) {
+		memh = small_block_alloc(len);
+		if (LIKELY(memh)) {
+			memset(memh + 1, 0, len);
+			memh->len = len | (size_t) MEMHEAD_SMALL_FLAG;
+			atomic_add_and_fetch_u(&totblock, 1);
+			atomic_add_and_fetch_z(&mem_in_use, len);
+			update_maximum(&peak_mem, mem_in_use);
+
+			return PTR_FROM_MEMHEAD(memh);
+		}
+	}
+#endif
+
 	memh = (MemHead *)calloc(1, len + sizeof(MemHead));
 
 	if (LIKELY(memh)) {
@@ -304,14 +520,27 @@ void *MEM_lockfree_mallocN(size_t len, const char *str)
 
 	len = SIZET_ALIGN_4(len);
 
-	memh = (MemHead *)malloc(len + sizeof(MemHead));
+#ifdef USE_SMALL_BLOCKS
+	if (len + sizeof(MemHead) <= SMALL_BLOCK_MAX_SIZE) {
+		memh = small_block_alloc(len);
+		if (LIKELY(memh)) {
+			memh->len = len | (size_t) MEMHEAD_SMALL_FLAG;
+		}
+	}
+	else
+#endif
+	{
+		memh = (MemHead *)malloc(len + sizeof(MemHead));
+		if (LIKELY(memh)) {
+			memh->len = len;
+		}
+	}
 
 	if (LIKELY(memh)) {
 		if (UNLIKELY(malloc_debug_memset && len)) {
 			memset(memh + 1, 255, len);
 		}
 
-		memh->len = len;
 		atomic_add_and_fetch_u(&totblock, 1);
 		atomic_add_and_fetch_z(&mem_in_use, len);
 		update_maximum(&peak_mem, mem_in_use);
@@ -431,6 +660,10 @@ void MEM_lockfree_printmemlist_stats(void)
 	       (double)mem_in_use / (double)(1024 * 1024));
 	printf("peak memory len: %.3f MB\n",
 	       (double)peak_mem / (double)(1024 * 1024));
+#ifdef USE_SMALL_BLOCKS
+	printf("small blocks memory: %.3f MB\n",
+	       (double)small_blocks.slab_in_use / (double)(1024 * 1024));
+#endif
 	printf("\nFor more detailed per-block statistics run Blender with memory debugging command line argument.\n");
 
 #ifdef HAVE_MALLOC_STATS
@@ -60,6 +60,8 @@
  * \endcode
  */
 
+#include <algorithm>
+#include <climits>
 #include <list>
 #include <queue>
 #include <vector>
@@ -83,6 +85,8 @@ public:
 	explicit MEM_CacheLimiterHandle(T * data_,MEM_CacheLimiter<T> *parent_) :
 		data(data_),
 		refcount(0),
+		size(0),
+		last_used(0),
 		parent(parent_)
 	{ }
 
@@ -134,6 +138,8 @@ private:
 	T * data;
 	int refcount;
 	int pos;
+	size_t size;       /* size when last inserted or touched, see get_memory_in_use() */
+	size_t last_used;  /* value of the use counter of the parent on last access */
 	MEM_CacheLimiter<T> * parent;
 };
 
@@ -145,7 +151,11 @@ public:
 	typedef bool   (*MEM_CacheLimiter_ItemDestroyable_Func) (void *item);
 
 	MEM_CacheLimiter(MEM_CacheLimiter_DataSize_Func data_size_func)
-		: data_size_func(data_size_func) {
+		: memory_in_use(0),
+		  use_counter(0),
+		  data_size_func(data_size_func),
+		  item_priority_func(NULL),
+		  item_destroyable_func(NULL) {
 	}
 
 	~MEM_CacheLimiter() {
@@ -156,31 +166,33 @@ public:
 	}
 
 	MEM_CacheLimiterHandle<T> *insert(T * elem) {
-		queue.push_back(new MEM_CacheLimiterHandle<T>(elem, this));
-		queue.back()->pos = queue.size() - 1;
-		return queue.back();
+		MEM_CacheElementPtr handle = new MEM_CacheLimiterHandle<T>(elem, this);
+		queue.push_back(handle);
+		handle->pos = queue.size() - 1;
+		handle->last_used = ++use_counter;
+		update_size(handle);
+		return handle;
 	}
 
 	void unmanage(MEM_CacheLimiterHandle<T> *handle) {
+		/* Order in the queue doesn't matter, recency is tracked by last_used. */
 		int pos = handle->pos;
+		memory_in_use -= handle->size;
 		queue[pos] = queue.back();
 		queue[pos]->pos = pos;
 		queue.pop_back();
 		delete handle;
 	}
 
+	/* The sizes of the elements are stored when they are inserted or touched,
+	 * so this doesn't have to visit every element of every cache. Elements
+	 * can grow without being touched, the exact size is computed again when
+	 * the limit seems to be exceeded. */
 	size_t get_memory_in_use() {
-		size_t size = 0;
 		if (data_size_func) {
-			int i;
-			for (i = 0; i < queue.size(); i++) {
-				size += data_size_func(queue[i]->get()->get_data());
-			}
-		}
-		else {
-			size = MEM_get_memory_in_use();
+			return memory_in_use;
 		}
-		return size;
+		return MEM_get_memory_in_use();
 	}
 
 	void enforce_limits() {
@@ -202,14 +214,26 @@ public:
 			return;
 		}
 
-		while (!queue.empty() && mem_in_use > max) {
-			MEM_CacheElementPtr elem = get_least_priority_destroyable_element();
+		if (data_size_func) {
+			update_all_sizes();
+			mem_in_use = memory_in_use;
+
+			if (mem_in_use <= max) {
+				return;
+			}
+		}
 
-			if (!elem)
-				break;
+		/* Priorities don't change while destroying elements, so sort the
+		 * candidates once instead of searching the whole queue for every
+		 * element that is destroyed. */
+		std::vector<MEM_CachePriorityPair> candidates;
+		get_destroyable_elements_by_priority(candidates);
+
+		for (size_t i = 0; i < candidates.size() && mem_in_use > max; i++) {
+			MEM_CacheElementPtr elem = candidates[i].second;
 
 			if (data_size_func) {
-				cur_size = data_size_func(elem->get()->get_data());
+				cur_size = elem->size;
 			}
 			else {
 				cur_size = mem_in_use;
@@ -227,17 +251,8 @@ public:
 	}
 
 	void touch(MEM_CacheLimiterHandle<T> * handle) {
-		/* If we're using custom priority callback re-arranging the queue
-		 * doesn't make much sense because we'll iterate it all to get
-		 * least priority element anyway.
-		 */
-		if (item_priority_func == NULL) {
-			queue[handle->pos] = queue.back();
-			queue[handle->pos]->pos = handle->pos;
-			queue.pop_back();
-			queue.push_back(handle);
-			handle->pos = queue.size() - 1;
-		}
+		handle->last_used = ++use_counter;
+		update_size(handle);
 	}
 
 	void set_item_priority_func(MEM_CacheLimiter_ItemPriority_Func item_priority_func) {
@@ -252,6 +267,7 @@ private:
 	typedef MEM_CacheLimiterHandle<T> *MEM_CacheElementPtr;
 	typedef std::vector<MEM_CacheElementPtr, MEM_Allocator<MEM_CacheElementPtr> > MEM_CacheQueue;
 	typedef typename MEM_CacheQueue::iterator iterator;
+	typedef std::pair<int, MEM_CacheElementPtr> MEM_CachePriorityPair;
 
 	/* Check whether element can be destroyed when enforcing cache limits */
 	bool can_destroy_element(MEM_CacheElementPtr &elem) {
@@ -266,48 +282,58 @@ private:
 		return true;
 	}
 
-	MEM_CacheElementPtr get_least_priority_destroyable_element(void) {
-		if (queue.empty())
-			return NULL;
-
-		MEM_CacheElementPtr best_match_elem = NULL;
+	void update_size(MEM_CacheElementPtr elem) {
+		if (data_size_func) {
+			size_t size = elem->get() ? data_size_func(elem->get()->get_data()) : 0;
+			memory_in_use += size - elem->size;
+			elem->size = size;
+		}
+	}
 
-		if (!item_priority_func) {
-			for (iterator it = queue.begin(); it != queue.end(); it++) {
-				MEM_CacheElementPtr elem = *it;
-				if (!can_destroy_element(elem))
-					continue;
-				best_match_elem = elem;
-				break;
-			}
+	void update_all_sizes(void) {
+		memory_in_use = 0;
+		for (size_t i = 0; i < queue.size(); i++) {
+			MEM_CacheElementPtr elem = queue[i];
+			elem->size = elem->get() ? data_size_func(elem->get()->get_data()) : 0;
+			memory_in_use += elem->size;
 		}
-		else {
-			int best_match_priority = 0;
-			int i;
+	}
 
-			for (i = 0; i < queue.size(); i++) {
-				MEM_CacheElementPtr elem = queue[i];
+	/* Elements of equal priority are destroyed least recently used first. */
+	static bool priority_less(const MEM_CachePriorityPair& a, const MEM_CachePriorityPair& b) {
+		if (a.first != b.first)
+			return a.first < b.first;
+		return a.second->last_used < b.second->last_used;
+	}
 
-				if (!can_destroy_element(elem))
-					continue;
+	/* Destroyable elements, ordered from the least to the most important one. */
+	void get_destroyable_elements_by_priority(std::vector<MEM_CachePriorityPair>& r_elems) {
+		r_elems.reserve(queue.size());
 
-				/* by default 0 means highest priority element */
-				/* casting a size type to int is questionable,
-				   but unlikely to cause problems */
-				int priority = -((int)(queue.size()) - i - 1);
-				priority = item_priority_func(elem->get()->get_data(), priority);
+		for (size_t i = 0; i < queue.size(); i++) {
+			MEM_CacheElementPtr elem = queue[i];
 
-				if (priority < best_match_priority || best_match_elem == NULL) {
-					best_match_priority = priority;
-					best_match_elem = elem;
-				}
+			if (!can_destroy_element(elem))
+				continue;
+
+			/* by default 0 means highest priority element, older elements
+			 * of all caches get lower priorities */
+			size_t age = use_counter - elem->last_used;
+			int priority = -(int)std::min(age, (size_t)INT_MAX);
+
+			if (item_priority_func) {
+				priority = item_priority_func(elem->get()->get_data(), priority);
 			}
+
+			r_elems.push_back(MEM_CachePriorityPair(priority, elem));
 		}
 
-		return best_match_elem;
+		std::sort(r_elems.begin(), r_elems.end(), priority_less);
 	}
 
 	MEM_CacheQueue queue;
+	size_t memory_in_use;
+	size_t use_counter;
 	MEM_CacheLimiter_DataSize_Func data_size_func;
 	MEM_CacheLimiter_ItemPriority_Func item_priority_func;
 	MEM_CacheLimiter_ItemDestroyable_Func item_destroyable_func;
@@ -29,6 +29,8 @@
 
 #include <openvdb/tools/ValueTransformer.h>  /* for tools::foreach */
 
+#include <algorithm>
+
 namespace internal {
 
 openvdb::Mat4R convertMatrix(const float mat[4][4])
@@ -72,6 +74,51 @@ public:
 	}
 };
 
+/* Scatter the values of a vector grid into three dense scalar arrays. Each value
+ * (voxel or tile) writes its own part of the arrays, so values can be processed
+ * in parallel. */
+class SplitVectorGrid {
+	float *m_data_x, *m_data_y, *m_data_z;
+	openvdb::math::CoordBBox m_bbox;
+	int m_res[2];
+
+public:
+	SplitVectorGrid(float *data_x, float *data_y, float *data_z, const int res[3])
+	    : m_data_x(data_x)
+	    , m_data_y(data_y)
+	    , m_data_z(data_z)
+	    , m_bbox(openvdb::Coord(0), openvdb::Coord(res[0] - 1, res[1] - 1, res[2] - 1))
+	{
+		m_res[0] = res[0];
+		m_res[1] = res[1];
+	}
+
+	void operator()(const openvdb::Vec3SGrid::ValueAllCIter &it) const
+	{
+		using namespace openvdb;
+
+		math::CoordBBox bbox = it.getBoundingBox();
+		bbox.intersect(m_bbox);
+
+		if (bbox.empty()) {
+			return;
+		}
+
+		const math::Vec3s value = *it;
+
+		for (int z = bbox.min().z(); z <= bbox.max().z(); ++z) {
+			for (int y = bbox.min().y(); y <= bbox.max().y(); ++y) {
+				size_t index = ((size_t)z * m_res[1] + y) * m_res[0] + bbox.min().x();
+				for (int x = bbox.min().x(); x <= bbox.max().x(); ++x, ++index) {
+					m_data_x[index] = value.x();
+					m_data_y[index] = value.y();
+					m_data_z[index] = value.z();
+				}
+			}
+		}
+	}
+};
+
 openvdb::GridBase *OpenVDB_export_vector_grid(
         OpenVDBWriter *writer,
         const openvdb::Name &name,
@@ -148,21 +195,17 @@ void OpenVDB_import_grid_vector(
 	}
 
 	Vec3SGrid::Ptr vgrid = gridPtrCast<Vec3SGrid>(reader->getGrid(name));
-	Vec3SGrid::ConstAccessor acc = vgrid->getConstAccessor();
-	math::Coord xyz;
-	int &x = xyz[0], &y = xyz[1], &z = xyz[2];
-
-	size_t index = 0;
-	for (z = 0; z < res[2]; ++z) {
-		for (y = 0; y < res[1]; ++y) {
-			for (x = 0; x < res[0]; ++x, ++index) {
-				math::Vec3s value = acc.getValue(xyz);
-				(*data_x)[index] = value.x();
-				(*data_y)[index] = value.y();
-				(*data_z)[index] = value.z();
-			}
-		}
-	}
+
+	/* Voxels outside of any node of the tree have the background value. */
+	const size_t num_voxels = (size_t)res[0] * res[1] * res[2];
+	const math::Vec3s background = vgrid->background();
+	std::fill(*data_x, *data_x + num_voxels, background.x());
+	std::fill(*data_y, *data_y + num_voxels, background.y());
+	std::fill(*data_z, *data_z + num_voxels, background.z());
+
+	/* Only visit the stored voxels and tiles, in parallel, rather than looking up every voxel. */
+	SplitVectorGrid op(*data_x, *data_y, *data_z, res);
+	tools::foreach(vgrid->cbeginValueAll(), op, true, true);
 }
 
 }  /* namespace internal */
@@ -94,19 +94,11 @@ void OpenVDB_import_grid(
 	}
 
 	typename GridType::Ptr grid = gridPtrCast<GridType>(reader->getGrid(name));
-	typename GridType::ConstAccessor acc = grid->getConstAccessor();
-
-	math::Coord xyz;
-	int &x = xyz[0], &y = xyz[1], &z = xyz[2];
-
-	size_t index = 0;
-	for (z = 0; z < res[2]; ++z) {
-		for (y = 0; y < res[1]; ++y) {
-			for (x = 0; x < res[0]; ++x, ++index) {
-				(*data)[index] = acc.getValue(xyz);
-			}
-		}
-	}
+
+	/* Copy node by node and in parallel, rather than looking up every voxel. */
+	math::CoordBBox bbox(Coord(0), Coord(res[0] - 1, res[1] - 1, res[2] - 1));
+	tools::Dense<T, tools::LayoutXYZ> dense_grid(bbox, *data);
+	tools::copyToDense(*grid, dense_grid);
 }
 
 openvdb::GridBase *OpenVDB_export_vector_grid(
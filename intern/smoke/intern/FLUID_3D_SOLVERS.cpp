@@ -169,7 +169,7 @@ void FLUID_3D::solvePressurePre(float* field, float* b, unsigned char* skip)
 {
 	int x, y, z;
 	size_t index;
-	float *_q, *_Precond, *_h, *_residual, *_direction;
+	float *_q, *_Precond, *_h, *_residual, *_direction, *_Acenter;
 
 	// i = 0
 	int i = 0;
@@ -179,12 +179,14 @@ void FLUID_3D::solvePressurePre(float* field, float* b, unsigned char* skip)
 	_q            = new float[_totalCells]; // set 0
 	_h			  = new float[_totalCells]; // set 0
 	_Precond	  = new float[_totalCells]; // set 0
+	_Acenter	  = new float[_totalCells]; // set 0
 
 	memset(_residual, 0, sizeof(float)*_xRes*_yRes*_zRes);
 	memset(_q, 0, sizeof(float)*_xRes*_yRes*_zRes);
 	memset(_direction, 0, sizeof(float)*_xRes*_yRes*_zRes);
 	memset(_h, 0, sizeof(float)*_xRes*_yRes*_zRes);
 	memset(_Precond, 0, sizeof(float)*_xRes*_yRes*_zRes);
+	memset(_Acenter, 0, sizeof(float)*_xRes*_yRes*_zRes);
 
 	float deltaNew = 0.0f;
 
@@ -219,6 +221,9 @@ void FLUID_3D::solvePressurePre(float* field, float* b, unsigned char* skip)
 			_residual[index] = 0.0f;
 			}
 
+			// the stencil doesn't change during the iterations
+			_Acenter[index] = Acenter;
+
 			// P^-1
 			if(Acenter < 1.0f)
 				_Precond[index] = 0.0;
@@ -248,18 +253,9 @@ void FLUID_3D::solvePressurePre(float* field, float* b, unsigned char* skip)
         for (x = 1; x < _xRes - 1; x++, index++)
         {
           // if the cell is a variable
-          float Acenter = 0.0f;
           if (!skip[index])
           {
-            // set the matrix to the Poisson stencil in order
-            if (!skip[index + 1]) Acenter += 1.0f;
-            if (!skip[index - 1]) Acenter += 1.0f;
-            if (!skip[index + _xRes]) Acenter += 1.0f;
-            if (!skip[index - _xRes]) Acenter += 1.0f;
-            if (!skip[index + _slabSize]) Acenter += 1.0f;
-            if (!skip[index - _slabSize]) Acenter += 1.0f;
-
-			_q[index] = Acenter * _direction[index] +  
+			_q[index] = _Acenter[index] * _direction[index] +  
             _direction[index - 1] * (skip[index - 1] ? 0.0f : -1.0f) +
             _direction[index + 1] * (skip[index + 1] ? 0.0f : -1.0f) +
             _direction[index - _xRes] * (skip[index - _xRes] ? 0.0f : -1.0f) +
@@ -322,6 +318,7 @@ void FLUID_3D::solvePressurePre(float* field, float* b, unsigned char* skip)
 
 	if (_h) delete[] _h;
 	if (_Precond) delete[] _Precond;
+	if (_Acenter) delete[] _Acenter;
 	if (_residual) delete[] _residual;
 	if (_direction) delete[] _direction;
 	if (_q)       delete[] _q;
@@ -1105,12 +1105,17 @@ class DATA_PT_modifiers(ModifierButtonsPanel, Panel):
         col.prop(md, "narrowness", slider=True)
 
     def REMESH(self, layout, ob, md):
+        layout.prop(md, "mode")
+
+        if md.mode == 'VOXEL':
+            layout.prop(md, "voxel_size")
+            layout.prop(md, "use_smooth_shade")
+            return
+
         if not bpy.app.build_options.mod_remesh:
             layout.label("Built without Remesh modifier")
             return
 
-        layout.prop(md, "mode")
-
         row = layout.row()
         row.prop(md, "octree_depth")
         row.prop(md, "scale")
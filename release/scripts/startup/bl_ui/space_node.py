@@ -184,6 +184,11 @@ class NODE_MT_view(Menu):
         layout.operator("node.view_selected")
         layout.operator("node.view_all")
 
+        if context.space_data.tree_type == 'CompositorNodeTree':
+            layout.separator()
+
+            layout.prop(context.space_data, "show_statistics")
+
         if context.space_data.show_backdrop:
             layout.separator()
 
@@ -425,6 +430,7 @@ class NODE_PT_quality(bpy.types.Panel):
         col = layout.column()
         col.prop(tree, "use_opencl")
         col.prop(tree, "use_groupnode_buffer")
+        col.prop(tree, "use_half_cache")
         col.prop(tree, "use_two_pass")
         col.prop(tree, "use_viewer_border")
 
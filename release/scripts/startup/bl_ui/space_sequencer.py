@@ -1111,6 +1111,29 @@ class SEQUENCER_PT_preview(SequencerButtonsPanel_Output, Panel):
         row.prop(render, "use_sequencer_gl_textured_solid")
 
 
+class SEQUENCER_PT_cache(SequencerButtonsPanel_Output, Panel):
+    bl_label = "Disk Cache"
+    bl_options = {'DEFAULT_CLOSED'}
+
+    @classmethod
+    def poll(cls, context):
+        return cls.has_preview(context) and context.scene.sequence_editor
+
+    def draw_header(self, context):
+        sequencer = context.scene.sequence_editor
+
+        self.layout.prop(sequencer, "use_cache_disk", text="")
+
+    def draw(self, context):
+        layout = self.layout
+
+        sequencer = context.scene.sequence_editor
+
+        col = layout.column()
+        col.active = sequencer.use_cache_disk
+        col.prop(sequencer, "cache_directory", text="Directory")
+
+
 class SEQUENCER_PT_view(SequencerButtonsPanel_Output, Panel):
     bl_label = "View Settings"
 
@@ -1286,6 +1309,7 @@ classes = (
     SEQUENCER_PT_filter,
     SEQUENCER_PT_proxy,
     SEQUENCER_PT_preview,
+    SEQUENCER_PT_cache,
     SEQUENCER_PT_view,
     SEQUENCER_PT_view_safe_areas,
     SEQUENCER_PT_modifiers,
@@ -533,6 +533,7 @@ class USERPREF_PT_system(Panel):
         if sys.platform == "linux" and system.multi_sample != 'NONE':
             col.label(text="Might fail for Mesh editing selection!")
             col.separator()
+        col.prop(system, "viewport_aa_samples")
         col.prop(system, "use_region_overlap")
 
         col.separator()
@@ -546,6 +547,7 @@ class USERPREF_PT_system(Panel):
         col.prop(system, "gl_texture_limit", text="Limit Size")
         col.prop(system, "texture_time_out", text="Time Out")
         col.prop(system, "texture_collection_rate", text="Collection Rate")
+        col.prop(system, "texture_memory_limit", text="Memory Limit")
 
         col.separator()
 
@@ -555,8 +557,7 @@ class USERPREF_PT_system(Panel):
         col.separator()
 
         col.label(text="Sequencer/Clip Editor:")
-        # currently disabled in the code
-        # col.prop(system, "prefetch_frames")
+        col.prop(system, "prefetch_frames")
         col.prop(system, "memory_cache_limit")
 
         # 3. Column
@@ -1051,6 +1052,7 @@ class USERPREF_PT_file(Panel):
         col.label(text="Save & Load:")
         col.prop(paths, "use_relative_paths")
         col.prop(paths, "use_file_compression")
+        col.prop(paths, "use_save_background")
         col.prop(paths, "use_load_ui")
         col.prop(paths, "use_filter_files")
         col.prop(paths, "show_hidden_files_datablocks")
@@ -44,6 +44,7 @@ extern "C" {
 #include "DNA_space_types.h"  /* for FILE_MAX */
 
 #include "BLI_string.h"
+#include "BLI_task.h"
 
 #ifdef WIN32
 /* needed for MSCV because of snprintf from BLI_string */
@@ -244,6 +245,12 @@ void AbcExporter::getFrameSet(unsigned int nr_of_samples,
 	}
 }
 
+static void shape_writer_convert_cb(void *userdata, const int index)
+{
+	std::vector<AbcObjectWriter *> &shapes = *static_cast<std::vector<AbcObjectWriter *> *>(userdata);
+	shapes[index]->convert();
+}
+
 void AbcExporter::operator()(Main *bmain, float &progress, bool &was_canceled)
 {
 	std::string scene_name;
@@ -326,6 +333,16 @@ void AbcExporter::operator()(Main *bmain, float &progress, bool &was_canceled)
 		setCurrentFrame(bmain, frame);
 
 		if (shape_frames.count(frame) != 0) {
+			/* Evaluating objects is not thread safe, but converting their data is. Samples
+			 * are written in a fixed order afterwards, so the archive is the same as when
+			 * exporting serially. */
+			for (int i = 0, e = m_shapes.size(); i != e; ++i) {
+				m_shapes[i]->evaluate();
+			}
+
+			const int num_shapes = m_shapes.size();
+			BLI_task_parallel_range(0, num_shapes, &m_shapes, shape_writer_convert_cb, num_shapes > 1);
+
 			for (int i = 0, e = m_shapes.size(); i != e; ++i) {
 				m_shapes[i]->write();
 			}
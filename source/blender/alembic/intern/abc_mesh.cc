@@ -92,6 +92,7 @@ using Alembic::AbcGeom::OV2fGeomParam;
 using Alembic::AbcGeom::OV3fGeomParam;
 
 using Alembic::AbcGeom::kFacevaryingScope;
+using Alembic::AbcGeom::kHeterogenousTopology;
 using Alembic::AbcGeom::kVaryingScope;
 using Alembic::AbcGeom::kVertexScope;
 using Alembic::AbcGeom::kWrapExisting;
@@ -297,6 +298,8 @@ AbcMeshWriter::AbcMeshWriter(EvaluationContext *eval_ctx,
 	m_is_animated = isAnimated();
 	m_subsurf_mod = NULL;
 	m_is_subd = false;
+	m_dm = NULL;
+	m_smooth_normal = false;
 
 	/* If the object is static, use the default static time sampling. */
 	if (!m_is_animated) {
@@ -330,6 +333,10 @@ AbcMeshWriter::AbcMeshWriter(EvaluationContext *eval_ctx,
 
 AbcMeshWriter::~AbcMeshWriter()
 {
+	if (m_dm) {
+		freeMesh(m_dm);
+	}
+
 	if (m_subsurf_mod) {
 		m_subsurf_mod->mode &= ~eModifierMode_DisableTemporary;
 	}
@@ -358,16 +365,59 @@ bool AbcMeshWriter::isAnimated() const
 	return me->adt != NULL;
 }
 
+bool AbcMeshWriter::useSubDSchema() const
+{
+	return m_settings.use_subdiv_schema && m_subdiv_schema.valid();
+}
+
+void AbcMeshWriter::evaluate()
+{
+	/* We have already stored a sample for this object. */
+	if (!m_first_frame && !m_is_animated)
+		return;
+
+	if (m_dm == NULL) {
+		m_dm = getFinalMesh();
+	}
+}
+
+void AbcMeshWriter::convert()
+{
+	if (m_dm == NULL)
+		return;
+
+	m_smooth_normal = false;
+
+	get_vertices(m_dm, m_points);
+	get_topology(m_dm, m_poly_verts, m_loop_counts, m_smooth_normal);
+
+	if (m_settings.export_normals && !useSubDSchema()) {
+		if (m_smooth_normal) {
+			get_loop_normals(m_dm, m_normals);
+		}
+		else {
+			get_vertex_normals(m_dm, m_normals);
+		}
+	}
+}
+
 void AbcMeshWriter::do_write()
 {
 	/* We have already stored a sample for this object. */
 	if (!m_first_frame && !m_is_animated)
 		return;
 
-	DerivedMesh *dm = getFinalMesh();
+	/* Not prepared in advance by the exporter. */
+	if (m_dm == NULL) {
+		evaluate();
+		convert();
+	}
+
+	DerivedMesh *dm = m_dm;
+	m_dm = NULL;
 
 	try {
-		if (m_settings.use_subdiv_schema && m_subdiv_schema.valid()) {
+		if (useSubDSchema()) {
 			writeSubD(dm);
 		}
 		else {
@@ -384,21 +434,13 @@ void AbcMeshWriter::do_write()
 
 void AbcMeshWriter::writeMesh(DerivedMesh *dm)
 {
-	std::vector<Imath::V3f> points, normals;
-	std::vector<int32_t> poly_verts, loop_counts;
-
-	bool smooth_normal = false;
-
-	get_vertices(dm, points);
-	get_topology(dm, poly_verts, loop_counts, smooth_normal);
-
 	if (m_first_frame && m_settings.export_face_sets) {
 		writeFaceSets(dm, m_mesh_schema);
 	}
 
-	m_mesh_sample = OPolyMeshSchema::Sample(V3fArraySample(points),
-	                                        Int32ArraySample(poly_verts),
-	                                        Int32ArraySample(loop_counts));
+	m_mesh_sample = OPolyMeshSchema::Sample(V3fArraySample(m_points),
+	                                        Int32ArraySample(m_poly_verts),
+	                                        Int32ArraySample(m_loop_counts));
 
 	UVSample sample;
 	if (m_first_frame && m_settings.export_uvs) {
@@ -418,17 +460,10 @@ void AbcMeshWriter::writeMesh(DerivedMesh *dm)
 	}
 
 	if (m_settings.export_normals) {
-		if (smooth_normal) {
-			get_loop_normals(dm, normals);
-		}
-		else {
-			get_vertex_normals(dm, normals);
-		}
-
 		ON3fGeomParam::Sample normals_sample;
-		if (!normals.empty()) {
-			normals_sample.setScope((smooth_normal) ? kFacevaryingScope : kVertexScope);
-			normals_sample.setVals(V3fArraySample(normals));
+		if (!m_normals.empty()) {
+			normals_sample.setScope((m_smooth_normal) ? kFacevaryingScope : kVertexScope);
+			normals_sample.setVals(V3fArraySample(m_normals));
 		}
 
 		m_mesh_sample.setNormals(normals_sample);
@@ -451,23 +486,17 @@ void AbcMeshWriter::writeMesh(DerivedMesh *dm)
 void AbcMeshWriter::writeSubD(DerivedMesh *dm)
 {
 	std::vector<float> crease_sharpness;
-	std::vector<Imath::V3f> points;
-	std::vector<int32_t> poly_verts, loop_counts;
 	std::vector<int32_t> crease_indices, crease_lengths;
 
-	bool smooth_normal = false;
-
-	get_vertices(dm, points);
-	get_topology(dm, poly_verts, loop_counts, smooth_normal);
 	get_creases(dm, crease_indices, crease_lengths, crease_sharpness);
 
 	if (m_first_frame && m_settings.export_face_sets) {
 		writeFaceSets(dm, m_subdiv_schema);
 	}
 
-	m_subdiv_sample = OSubDSchema::Sample(V3fArraySample(points),
-	                                      Int32ArraySample(poly_verts),
-	                                      Int32ArraySample(loop_counts));
+	m_subdiv_sample = OSubDSchema::Sample(V3fArraySample(m_points),
+	                                      Int32ArraySample(m_poly_verts),
+	                                      Int32ArraySample(m_loop_counts));
 
 	UVSample sample;
 	if (m_first_frame && m_settings.export_uvs) {
@@ -770,7 +799,8 @@ void read_mverts(MVert *mverts, const P3fArraySamplePtr &positions, const N3fArr
 	}
 }
 
-static void read_mpolys(CDStreamConfig &config, const AbcMeshData &mesh_data)
+/* When the topology is already in place, only the UVs of the faces are read. */
+static void read_mpolys(CDStreamConfig &config, const AbcMeshData &mesh_data, const bool read_topology)
 {
 	MPoly *mpolys = config.mpoly;
 	MLoop *mloops = config.mloop;
@@ -783,6 +813,11 @@ static void read_mpolys(CDStreamConfig &config, const AbcMeshData &mesh_data)
 	const N3fArraySamplePtr &normals = mesh_data.face_normals;
 
 	const bool do_uvs = (mloopuvs && uvs && uvs_indices) && (uvs_indices->size() == face_indices->size());
+
+	if (!read_topology && !do_uvs) {
+		return;
+	}
+
 	unsigned int loop_index = 0;
 	unsigned int rev_loop_index = 0;
 	unsigned int uv_index = 0;
@@ -790,20 +825,24 @@ static void read_mpolys(CDStreamConfig &config, const AbcMeshData &mesh_data)
 	for (int i = 0; i < face_counts->size(); ++i) {
 		const int face_size = (*face_counts)[i];
 
-		MPoly &poly = mpolys[i];
-		poly.loopstart = loop_index;
-		poly.totloop = face_size;
+		if (read_topology) {
+			MPoly &poly = mpolys[i];
+			poly.loopstart = loop_index;
+			poly.totloop = face_size;
 
-		if (normals != NULL) {
-			poly.flag |= ME_SMOOTH;
+			if (normals != NULL) {
+				poly.flag |= ME_SMOOTH;
+			}
 		}
 
 		/* NOTE: Alembic data is stored in the reverse order. */
 		rev_loop_index = loop_index + (face_size - 1);
 
 		for (int f = 0; f < face_size; ++f, ++loop_index, --rev_loop_index) {
-			MLoop &loop = mloops[rev_loop_index];
-			loop.v = (*face_indices)[loop_index];
+			if (read_topology) {
+				MLoop &loop = mloops[rev_loop_index];
+				loop.v = (*face_indices)[loop_index];
+			}
 
 			if (do_uvs) {
 				MLoopUV &loopuv = mloopuvs[rev_loop_index];
@@ -971,7 +1010,10 @@ static void read_mesh_sample(ImportSettings *settings,
 	}
 
 	if ((settings->read_flag & MOD_MESHSEQ_READ_POLY) != 0) {
-		read_mpolys(config, abc_mesh_data);
+		read_mpolys(config, abc_mesh_data, true);
+	}
+	else if ((settings->read_flag & MOD_MESHSEQ_READ_UV) != 0) {
+		read_mpolys(config, abc_mesh_data, false);
 	}
 
 	if ((settings->read_flag & (MOD_MESHSEQ_READ_UV | MOD_MESHSEQ_READ_COLOR)) != 0) {
@@ -1100,6 +1142,10 @@ DerivedMesh *AbcMeshReader::read_derivedmesh(DerivedMesh *dm,
 				           " mesh. Only vertices will be read!";
 			}
 		}
+		else if (m_schema.getTopologyVariance() != kHeterogenousTopology) {
+			/* The faces are the same on every frame, so the mesh already has them. */
+			settings.read_flag &= ~MOD_MESHSEQ_READ_POLY;
+		}
 	}
 
 	CDStreamConfig config = get_config(new_dm ? new_dm : dm);
@@ -1222,7 +1268,10 @@ static void read_subd_sample(ImportSettings *settings,
 	}
 
 	if ((settings->read_flag & MOD_MESHSEQ_READ_POLY) != 0) {
-		read_mpolys(config, abc_mesh_data);
+		read_mpolys(config, abc_mesh_data, true);
+	}
+	else if ((settings->read_flag & MOD_MESHSEQ_READ_UV) != 0) {
+		read_mpolys(config, abc_mesh_data, false);
 	}
 
 	if ((settings->read_flag & (MOD_MESHSEQ_READ_UV | MOD_MESHSEQ_READ_COLOR)) != 0) {
@@ -1353,6 +1402,10 @@ DerivedMesh *AbcSubDReader::read_derivedmesh(DerivedMesh *dm,
 				           " mesh. Only vertices will be read!";
 			}
 		}
+		else if (m_schema.getTopologyVariance() != kHeterogenousTopology) {
+			/* The faces are the same on every frame, so the mesh already has them. */
+			settings.read_flag &= ~MOD_MESHSEQ_READ_POLY;
+		}
 	}
 
 	/* Only read point data when streaming meshes, unless we need to create new ones. */
@@ -49,6 +49,12 @@ class AbcMeshWriter : public AbcObjectWriter {
 	bool m_is_liquid;
 	bool m_is_subd;
 
+	/* Evaluated mesh and converted arrays of the next sample, between evaluate() and write(). */
+	DerivedMesh *m_dm;
+	std::vector<Imath::V3f> m_points, m_normals;
+	std::vector<int32_t> m_poly_verts, m_loop_counts;
+	bool m_smooth_normal;
+
 public:
 	AbcMeshWriter(EvaluationContext *eval_ctx,
 	              Scene *scene,
@@ -59,9 +65,14 @@ public:
 
 	~AbcMeshWriter();
 
+	virtual void evaluate();
+	virtual void convert();
+
 private:
 	virtual void do_write();
 
+	bool useSubDSchema() const;
+
 	bool isAnimated() const;
 
 	void writeMesh(DerivedMesh *dm);
@@ -70,6 +70,12 @@ public:
 
 	virtual Imath::Box3d bounds();
 
+	/* Optional steps before write(), to prepare the next sample. evaluate() is called from
+	 * the exporting thread. convert() can run in parallel with other writers, so it must
+	 * not access the archive or any Blender data shared with other objects. */
+	virtual void evaluate() {}
+	virtual void convert() {}
+
 	void write();
 
 private:
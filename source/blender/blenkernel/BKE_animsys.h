@@ -173,8 +173,17 @@ void BKE_animsys_evaluate_all_animation(struct Main *main, struct Scene *scene,
 
 /* TODO(sergey): This is mainly a temp public function. */
 struct FCurve;
+struct PathResolvedRNA;
+struct RNAPathCache;
 bool BKE_animsys_execute_fcurve(struct PointerRNA *ptr, struct AnimMapper *remap, struct FCurve *fcu, float curval);
 
+/* Cached RNA path resolution, see RNAPathCache */
+bool BKE_animsys_rna_path_cache_lookup(const struct RNAPathCache *cache, const struct PointerRNA *owner,
+                                       struct PathResolvedRNA *r_result);
+void BKE_animsys_rna_path_cache_store(struct RNAPathCache *cache, const struct PointerRNA *owner,
+                                      const struct PathResolvedRNA *result);
+void BKE_animsys_rna_path_cache_invalidate(void);
+
 /* ------------ Specialized API --------------- */
 /* There are a few special tools which require these following functions. They are NOT to be used
  * for standard animation evaluation UNDER ANY CIRCUMSTANCES! 
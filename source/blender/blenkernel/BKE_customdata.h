@@ -43,6 +43,7 @@ extern "C" {
 
 #include "DNA_customdata_types.h"
 
+struct BLI_HashMurmur2A;
 struct BMesh;
 struct ID;
 struct CustomData;
@@ -343,6 +344,7 @@ void CustomData_set_layer_stencil_index(struct CustomData *data, int type, int n
 void CustomData_set_layer_flag(struct CustomData *data, int type, int flag);
 
 void CustomData_bmesh_set_default(struct CustomData *data, void **block);
+void CustomData_bmesh_alloc_block(struct CustomData *data, void **block);
 void CustomData_bmesh_free_block(struct CustomData *data, void **block);
 void CustomData_bmesh_free_block_data(struct CustomData *data, void *block);
 
@@ -364,6 +366,8 @@ int CustomData_sizeof(int type);
 /* get the name of a layer type */
 const char *CustomData_layertype_name(int type);
 bool        CustomData_layertype_is_singleton(int type);
+
+bool CustomData_hash_add(const struct CustomData *data, int totelem, struct BLI_HashMurmur2A *mm2);
 int         CustomData_layertype_layers_max(const int type);
 
 /* make sure the name of layer at index is unique */
@@ -30,6 +30,7 @@
 struct Scene;
 struct SceneLayer;
 struct EvaluationContext;
+struct TaskPool;
 
 /* Actual surface point	*/
 typedef struct PaintSurfaceData {
@@ -87,7 +88,8 @@ struct DynamicPaintSurface *get_activeSurface(struct DynamicPaintCanvasSettings
 /* image sequence baking */
 int dynamicPaint_createUVSurface(struct Scene *scene, struct DynamicPaintSurface *surface, float *progress, short *do_update);
 int dynamicPaint_calculateFrame(struct DynamicPaintSurface *surface, struct EvaluationContext *eval_ctx, struct Scene *scene, struct Object *cObject, int frame);
-void dynamicPaint_outputSurfaceImage(struct DynamicPaintSurface *surface, char *filename, short output_layer);
+void dynamicPaint_outputSurfaceImage(
+        struct DynamicPaintSurface *surface, char *filename, short output_layer, struct TaskPool *save_pool);
 
 /* PaintPoint state */
 #define DPAINT_PAINT_NONE -1
@@ -191,6 +191,7 @@ struct ImBuf *BKE_sequencer_give_ibuf_threaded(const SeqRenderData *context, flo
 struct ImBuf *BKE_sequencer_give_ibuf_direct(const SeqRenderData *context, float cfra, struct Sequence *seq);
 struct ImBuf *BKE_sequencer_give_ibuf_seqbase(const SeqRenderData *context, float cfra, int chan_shown, struct ListBase *seqbasep);
 void BKE_sequencer_give_ibuf_prefetch_request(const SeqRenderData *context, float cfra, int chan_shown);
+void BKE_sequencer_prefetch_stop(void);
 
 /* **********************************************************************
  * sequencer.c
@@ -251,6 +252,7 @@ bool BKE_sequencer_input_have_to_preprocess(const SeqRenderData *context, struct
 
 void BKE_sequencer_proxy_rebuild_context(struct Main *bmain, struct Scene *scene, struct Sequence *seq, struct GSet *file_list, ListBase *queue);
 void BKE_sequencer_proxy_rebuild(struct SeqIndexBuildContext *context, short *stop, short *do_update, float *progress);
+bool BKE_sequencer_proxy_rebuild_supports_threads(struct SeqIndexBuildContext *context);
 void BKE_sequencer_proxy_rebuild_finish(struct SeqIndexBuildContext *context, bool stop);
 
 void BKE_sequencer_proxy_set(struct Sequence *seq, bool value);
@@ -287,6 +289,10 @@ void BKE_sequencer_preprocessed_cache_put(const SeqRenderData *context, struct S
 void BKE_sequencer_preprocessed_cache_cleanup(void);
 void BKE_sequencer_preprocessed_cache_cleanup_sequence(struct Sequence *seq);
 
+/* final frames of the strip stack stored on disk, when enabled for the editing */
+struct ImBuf *BKE_sequencer_disk_cache_get(const SeqRenderData *context, struct ListBase *seqbasep, float cfra, int chanshown);
+void BKE_sequencer_disk_cache_put(const SeqRenderData *context, struct ListBase *seqbasep, float cfra, int chanshown, struct ImBuf *ibuf);
+
 /* **********************************************************************
  * seqeffects.c
  *
@@ -304,6 +304,8 @@ CCGSubSurf *ccgSubSurf_new(CCGMeshIFC *ifc, int subdivLevels, CCGAllocatorIFC *a
 		ss->tempVerts = NULL;
 		ss->tempEdges = NULL;
 
+		ss->topologyHash = 0;
+
 #ifdef WITH_OPENSUBDIV
 		ss->osd_evaluator = NULL;
 		ss->osd_mesh = NULL;
@@ -405,6 +407,7 @@ CCGError ccgSubSurf_setSubdivisionLevels(CCGSubSurf *ss, int subdivisionLevels)
 	else if (subdivisionLevels != ss->subdivLevels) {
 		ss->numGrids = 0;
 		ss->subdivLevels = subdivisionLevels;
+		ss->topologyHash = 0;
 		ccg_ehash_free(ss->vMap, (EHEntryFreeFP) _vert_free, ss);
 		ccg_ehash_free(ss->eMap, (EHEntryFreeFP) _edge_free, ss);
 		ccg_ehash_free(ss->fMap, (EHEntryFreeFP) _face_free, ss);
@@ -416,6 +419,16 @@ CCGError ccgSubSurf_setSubdivisionLevels(CCGSubSurf *ss, int subdivisionLevels)
 	return eCCGError_None;
 }
 
+void ccgSubSurf_setTopologyHash(CCGSubSurf *ss, unsigned int topologyHash)
+{
+	ss->topologyHash = topologyHash;
+}
+
+unsigned int ccgSubSurf_getTopologyHash(const CCGSubSurf *ss)
+{
+	return ss->topologyHash;
+}
+
 void ccgSubSurf_getUseAgeCounts(CCGSubSurf *ss, int *useAgeCounts_r, int *vertUserOffset_r, int *edgeUserOffset_r, int *faceUserOffset_r)
 {
 	*useAgeCounts_r = ss->useAgeCounts;
@@ -113,6 +113,9 @@ void		ccgSubSurf_setAllocMask				(CCGSubSurf *ss, int allocMask, int maskOffset)
 
 void		ccgSubSurf_setNumLayers				(CCGSubSurf *ss, int numLayers);
 
+void		ccgSubSurf_setTopologyHash			(CCGSubSurf *ss, unsigned int topologyHash);
+unsigned int	ccgSubSurf_getTopologyHash		(const CCGSubSurf *ss);
+
 /***/
 
 int			ccgSubSurf_getNumVerts				(const CCGSubSurf *ss);
@@ -207,6 +207,10 @@ struct CCGSubSurf {
 	CCGVert **tempVerts;
 	CCGEdge **tempEdges;
 
+	/* Hash of the topology the maps were last fully synced from, zero when
+	 * unknown. Allows callers to only re-sync vertex coordinates. */
+	unsigned int topologyHash;
+
 #ifdef WITH_OPENSUBDIV
 	/* Skip grids means no CCG geometry is created and subsurf is possible
 	 * to be completely done on GPU.
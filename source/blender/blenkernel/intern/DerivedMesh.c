@@ -46,6 +46,7 @@
 #include "BLI_array.h"
 #include "BLI_blenlib.h"
 #include "BLI_bitmap.h"
+#include "BLI_hash_mm2a.h"
 #include "BLI_math.h"
 #include "BLI_utildefines.h"
 #include "BLI_linklist.h"
@@ -1724,6 +1725,259 @@ static void dm_ensure_display_normals(DerivedMesh *dm)
 	}
 }
 
+/* Modifier stack cache
+ *
+ * Keeps an intermediate result of the modifier stack between evaluations, so that after
+ * changing a modifier the stack only runs again from the last unchanged constructive one,
+ * instead of from the original mesh.
+ *
+ * Every leading modifier gets a hash of its settings and of all its inputs: the mesh, the
+ * object transform and vertex groups, the preceding modifiers and the data masks. Hashing
+ * stops at the first modifier with inputs that can't be hashed, like time dependent and
+ * simulation modifiers, or ones referencing other data than meshes and empties. */
+
+typedef struct ModifierStackCache {
+	/* hash of the stack up to and including each of the leading hashable modifiers */
+	unsigned int *hashes;
+	int hashes_num;
+
+	/* result after modifier dm_index, with the orco meshes evaluated along with it */
+	DerivedMesh *dm, *orcodm, *clothorcodm;
+	int dm_index;
+} ModifierStackCache;
+
+typedef struct ModifierCacheLinkData {
+	BLI_HashMurmur2A *mm2;
+	bool is_hashable;
+} ModifierCacheLinkData;
+
+static void modifier_stack_cache_clear_result(ModifierStackCache *cache)
+{
+	if (cache->dm) {
+		cache->dm->release(cache->dm);
+		cache->dm = NULL;
+	}
+	if (cache->orcodm) {
+		cache->orcodm->release(cache->orcodm);
+		cache->orcodm = NULL;
+	}
+	if (cache->clothorcodm) {
+		cache->clothorcodm->release(cache->clothorcodm);
+		cache->clothorcodm = NULL;
+	}
+	cache->dm_index = -1;
+}
+
+void DM_free_modifier_cache(Object *ob)
+{
+	ModifierStackCache *cache = ob->modifier_cache;
+
+	if (cache) {
+		modifier_stack_cache_clear_result(cache);
+		MEM_SAFE_FREE(cache->hashes);
+		MEM_freeN(cache);
+		ob->modifier_cache = NULL;
+	}
+}
+
+static bool modifier_stack_cache_hash_dm(DerivedMesh *dm, BLI_HashMurmur2A *mm2)
+{
+	if (dm->type != DM_TYPE_CDDM) {
+		return false;
+	}
+
+	return (CustomData_hash_add(&dm->vertData, dm->numVertData, mm2) &&
+	        CustomData_hash_add(&dm->edgeData, dm->numEdgeData, mm2) &&
+	        CustomData_hash_add(&dm->loopData, dm->numLoopData, mm2) &&
+	        CustomData_hash_add(&dm->polyData, dm->numPolyData, mm2));
+}
+
+static void modifier_stack_cache_hash_id_link(void *userData, Object *UNUSED(ob), ID **idpoin, int UNUSED(cb_flag))
+{
+	ModifierCacheLinkData *data = userData;
+	ID *id = *idpoin;
+	Object *link_ob;
+
+	if (id == NULL) {
+		return;
+	}
+
+	if (GS(id->name) == ID_OB) {
+		link_ob = (Object *)id;
+
+		BLI_hash_mm2a_add(data->mm2, (const unsigned char *)&link_ob, sizeof(link_ob));
+		BLI_hash_mm2a_add(data->mm2, (const unsigned char *)link_ob->obmat, sizeof(link_ob->obmat));
+
+		if (link_ob->type == OB_EMPTY) {
+			return;
+		}
+		/* other objects are evaluated first, so their result is known here */
+		else if (link_ob->type == OB_MESH && link_ob->derivedFinal &&
+		         modifier_stack_cache_hash_dm(link_ob->derivedFinal, data->mm2))
+		{
+			return;
+		}
+	}
+
+	data->is_hashable = false;
+}
+
+static bool modifier_stack_cache_hash_modifier(Object *ob, ModifierData *md, CustomDataMask mask, BLI_HashMurmur2A *mm2)
+{
+	const ModifierTypeInfo *mti = modifierType_getInfo(md->type);
+	ModifierCacheLinkData data = {mm2, true};
+
+	if ((mti->flags & eModifierTypeFlag_UsesPointCache) ||
+	    (mti->dependsOnTime && mti->dependsOnTime(md)) ||
+	    ELEM(md->type, eModifierType_ShapeKey, eModifierType_Multires, eModifierType_DynamicPaint,
+	         eModifierType_ParticleSystem, eModifierType_Explode))
+	{
+		return false;
+	}
+
+	BLI_hash_mm2a_add_int(mm2, md->type);
+	BLI_hash_mm2a_add_int(mm2, md->mode & ~eModifierMode_Expanded);
+	BLI_hash_mm2a_add(mm2, (const unsigned char *)&mask, sizeof(mask));
+	/* settings of the modifier type, following the common ModifierData */
+	BLI_hash_mm2a_add(mm2, (const unsigned char *)md + sizeof(ModifierData), mti->structSize - sizeof(ModifierData));
+
+	if (mti->foreachIDLink) {
+		mti->foreachIDLink(md, ob, modifier_stack_cache_hash_id_link, &data);
+	}
+	else if (mti->foreachObjectLink) {
+		mti->foreachObjectLink(md, ob, (ObjectWalkFunc)modifier_stack_cache_hash_id_link, &data);
+	}
+
+	return data.is_hashable;
+}
+
+static bool modifier_stack_cache_hash_mesh(
+        Scene *scene, Object *ob, Mesh *me, CustomDataMask dataMask, int flag, const bool need_mapping,
+        unsigned int *r_hash)
+{
+	BLI_HashMurmur2A mm2;
+	bDeformGroup *dg;
+
+	BLI_hash_mm2a_init(&mm2, 0);
+
+	BLI_hash_mm2a_add(&mm2, (const unsigned char *)&dataMask, sizeof(dataMask));
+	BLI_hash_mm2a_add_int(&mm2, flag);
+	BLI_hash_mm2a_add_int(&mm2, need_mapping);
+	BLI_hash_mm2a_add_int(&mm2, (scene->r.mode & R_SIMPLIFY) ? scene->r.simplify_subsurf : -1);
+	BLI_hash_mm2a_add(&mm2, (const unsigned char *)ob->obmat, sizeof(ob->obmat));
+	for (dg = ob->defbase.first; dg; dg = dg->next) {
+		BLI_hash_mm2a_add(&mm2, (const unsigned char *)dg->name, strlen(dg->name));
+	}
+
+	BLI_hash_mm2a_add_int(&mm2, me->totvert);
+	BLI_hash_mm2a_add_int(&mm2, me->totedge);
+	BLI_hash_mm2a_add_int(&mm2, me->totface);
+	BLI_hash_mm2a_add_int(&mm2, me->totloop);
+	BLI_hash_mm2a_add_int(&mm2, me->totpoly);
+
+	if (!CustomData_hash_add(&me->vdata, me->totvert, &mm2) ||
+	    !CustomData_hash_add(&me->edata, me->totedge, &mm2) ||
+	    !CustomData_hash_add(&me->fdata, me->totface, &mm2) ||
+	    !CustomData_hash_add(&me->ldata, me->totloop, &mm2) ||
+	    !CustomData_hash_add(&me->pdata, me->totpoly, &mm2))
+	{
+		return false;
+	}
+
+	*r_hash = BLI_hash_mm2a_end(&mm2);
+	return true;
+}
+
+/**
+ * Hash the leading modifiers and compare with the previous evaluation.
+ *
+ * \return the index of the modifier to continue after with the stored result, or -1.
+ * \param r_store_index: the modifier to store the result after, or -1.
+ */
+static int modifier_stack_cache_begin(
+        Scene *scene, Object *ob, Mesh *me, ModifierData *firstmd, CDMaskLink *datamasks,
+        CustomDataMask dataMask, int flag, const int required_mode, const bool need_mapping,
+        int *r_store_index)
+{
+	ModifierStackCache *cache = ob->modifier_cache;
+	ModifierData *md;
+	CDMaskLink *curr;
+	unsigned int *hashes;
+	unsigned int hash;
+	int hashes_num = 0, md_num = 0, changed_index, i;
+
+	for (md = firstmd; md; md = md->next) {
+		md_num++;
+	}
+
+	hashes = MEM_mallocN(sizeof(*hashes) * max_ii(md_num, 1), __func__);
+
+	if (modifier_stack_cache_hash_mesh(scene, ob, me, dataMask, flag, need_mapping, &hash)) {
+		for (md = firstmd, curr = datamasks; md; md = md->next, curr = curr->next) {
+			BLI_HashMurmur2A mm2;
+
+			BLI_hash_mm2a_init(&mm2, hash);
+			if (!modifier_stack_cache_hash_modifier(ob, md, curr->mask, &mm2)) {
+				break;
+			}
+			hash = BLI_hash_mm2a_end(&mm2);
+			hashes[hashes_num++] = hash;
+		}
+	}
+
+	if (cache == NULL) {
+		cache = ob->modifier_cache = MEM_callocN(sizeof(*cache), __func__);
+		cache->dm_index = -1;
+	}
+
+	/* first modifier with different inputs than in the previous evaluation */
+	for (changed_index = 0; changed_index < min_ii(hashes_num, cache->hashes_num); changed_index++) {
+		if (hashes[changed_index] != cache->hashes[changed_index]) {
+			break;
+		}
+	}
+
+	if (cache->dm_index >= changed_index) {
+		modifier_stack_cache_clear_result(cache);
+	}
+
+	/* Store the result of the last constructive modifier before the change, changes are
+	 * usually repeated to the same modifier while tweaking it. */
+	*r_store_index = -1;
+	for (md = firstmd, i = 0; md && i < changed_index; md = md->next, i++) {
+		const ModifierTypeInfo *mti = modifierType_getInfo(md->type);
+
+		if (mti->type != eModifierTypeType_OnlyDeform &&
+		    modifier_isEnabled(scene, md, required_mode) &&
+		    !(need_mapping && !modifier_supportsMapping(md)))
+		{
+			*r_store_index = i;
+		}
+	}
+	if (*r_store_index <= cache->dm_index) {
+		*r_store_index = -1;
+	}
+
+	MEM_SAFE_FREE(cache->hashes);
+	cache->hashes = hashes;
+	cache->hashes_num = hashes_num;
+
+	return cache->dm_index;
+}
+
+static void modifier_stack_cache_store(
+        Object *ob, const int index, DerivedMesh *dm, DerivedMesh *orcodm, DerivedMesh *clothorcodm)
+{
+	ModifierStackCache *cache = ob->modifier_cache;
+
+	modifier_stack_cache_clear_result(cache);
+
+	cache->dm = CDDM_copy(dm);
+	cache->orcodm = orcodm ? CDDM_copy(orcodm) : NULL;
+	cache->clothorcodm = clothorcodm ? CDDM_copy(clothorcodm) : NULL;
+	cache->dm_index = index;
+}
+
 /**
  * new value for useDeform -1  (hack for the gameengine):
  *
@@ -1771,6 +2025,11 @@ static void mesh_calc_modifiers(
 	const bool do_loop_normals = (me->flag & ME_AUTOSMOOTH) != 0;
 	const float loop_normals_split_angle = me->smoothresh;
 
+	/* Only the evaluation stored in the object keeps intermediate results. */
+	const bool use_stack_cache = (useCache && !useRenderParams && useDeform > 0 && index == -1 &&
+	                              !inputVertexCos && !build_shapekey_layers && !sculpt_mode && !do_init_wmcol);
+	int stack_cache_restart = -1, stack_cache_store = -1, md_index = 0;
+
 	VirtualModifierData virtualModifierData;
 
 	ModifierApplyFlag app_flags = useRenderParams ? MOD_APPLY_RENDER : 0;
@@ -1796,8 +2055,6 @@ static void mesh_calc_modifiers(
 
 	md = firstmd;
 
-	modifiers_clearErrors(ob);
-
 	if (do_mod_wmcol || do_mod_mcol) {
 		/* Find the last active modifier generating a preview, or NULL if none. */
 		/* XXX Currently, DPaint modifier just ignores this.
@@ -1816,6 +2073,30 @@ static void mesh_calc_modifiers(
 	datamasks = modifiers_calcDataMasks(scene, ob, md, dataMask, required_mode, previewmd, previewmask);
 	curr = datamasks;
 
+	if (use_stack_cache) {
+		stack_cache_restart = modifier_stack_cache_begin(
+		        scene, ob, me, firstmd, datamasks, dataMask, app_flags, required_mode, need_mapping,
+		        &stack_cache_store);
+	}
+	else if (useCache) {
+		DM_free_modifier_cache(ob);
+	}
+
+	if (stack_cache_restart == -1) {
+		modifiers_clearErrors(ob);
+	}
+	else {
+		/* modifiers before the stored result are skipped and keep their errors */
+		for (md = firstmd; md; md = md->next, md_index++) {
+			if (md_index > stack_cache_restart && md->error) {
+				MEM_freeN(md->error);
+				md->error = NULL;
+			}
+		}
+		md = firstmd;
+		md_index = 0;
+	}
+
 	if (r_deform) {
 		*r_deform = NULL;
 	}
@@ -1826,7 +2107,7 @@ static void mesh_calc_modifiers(
 			deformedVerts = inputVertexCos;
 		
 		/* Apply all leading deforming modifiers */
-		for (; md; md = md->next, curr = curr->next) {
+		for (; md; md = md->next, curr = curr->next, md_index++) {
 			const ModifierTypeInfo *mti = modifierType_getInfo(md->type);
 
 			md->scene = scene;
@@ -1885,7 +2166,25 @@ static void mesh_calc_modifiers(
 	orcodm = NULL;
 	clothorcodm = NULL;
 
-	for (; md; md = md->next, curr = curr->next) {
+	if (stack_cache_restart != -1) {
+		ModifierStackCache *cache = ob->modifier_cache;
+
+		/* continue from the stored result, the leading deform modifiers were still
+		 * applied above for the deform result */
+		if (deformedVerts && deformedVerts != inputVertexCos)
+			MEM_freeN(deformedVerts);
+		deformedVerts = NULL;
+
+		dm = CDDM_copy(cache->dm);
+		orcodm = cache->orcodm ? CDDM_copy(cache->orcodm) : NULL;
+		clothorcodm = cache->clothorcodm ? CDDM_copy(cache->clothorcodm) : NULL;
+
+		for (; md && md_index <= stack_cache_restart; md = md->next, curr = curr->next, md_index++) {
+			md->scene = scene;
+		}
+	}
+
+	for (; md; md = md->next, curr = curr->next, md_index++) {
 		const ModifierTypeInfo *mti = modifierType_getInfo(md->type);
 
 		md->scene = scene;
@@ -2127,6 +2426,10 @@ static void mesh_calc_modifiers(
 			}
 
 			dm->deformedOnly = false;
+
+			if (md_index == stack_cache_store && !deformedVerts && dm->type == DM_TYPE_CDDM) {
+				modifier_stack_cache_store(ob, md_index, dm, orcodm, clothorcodm);
+			}
 		}
 
 		isPrevDeform = (mti->type == eModifierTypeType_OnlyDeform);
@@ -42,6 +42,7 @@
 #include "BLI_blenlib.h"
 #include "BLI_alloca.h"
 #include "BLI_dynstr.h"
+#include "BLI_ghash.h"
 #include "BLI_listbase.h"
 #include "BLI_string_utils.h"
 
@@ -75,6 +76,8 @@
 
 #include "nla_private.h"
 
+#include "atomic_ops.h"
+
 /* ***************************************** */
 /* AnimData API */
 
@@ -1427,17 +1430,75 @@ static bool animsys_remap_path(AnimMapper *UNUSED(remap), char *path, char **dst
 	return false;
 }
 
+/* Cached RNA path resolution ------------------------ */
+
+/* Resolved paths point directly into the data, so everything which may free or move
+ * animated data is covered by invalidating all caches at once: tagging IDs or relations
+ * for an update and rebuilding the dependency graph. Playback does neither, so paths are
+ * only resolved once there. */
+static unsigned int rna_path_cache_generation = 1;
+
+bool BKE_animsys_rna_path_cache_lookup(const RNAPathCache *cache, const PointerRNA *owner, PathResolvedRNA *r_result)
+{
+	if ((cache->generation != (int)rna_path_cache_generation) ||
+	    (cache->owner_id != owner->id.data) ||
+	    (cache->owner_data != owner->data))
+	{
+		return false;
+	}
+
+	r_result->ptr.id.data = cache->id;
+	r_result->ptr.type = cache->type;
+	r_result->ptr.data = cache->data;
+	r_result->prop = cache->prop;
+	r_result->prop_index = cache->index;
+
+	return true;
+}
+
+void BKE_animsys_rna_path_cache_store(RNAPathCache *cache, const PointerRNA *owner, const PathResolvedRNA *result)
+{
+	cache->owner_id = owner->id.data;
+	cache->owner_data = owner->data;
+	cache->id = result->ptr.id.data;
+	cache->type = result->ptr.type;
+	cache->data = result->ptr.data;
+	cache->prop = result->prop;
+	cache->index = result->prop_index;
+	cache->generation = (int)rna_path_cache_generation;
+}
+
+void BKE_animsys_rna_path_cache_invalidate(void)
+{
+	/* 0 is reserved for caches which were never filled */
+	if (atomic_add_and_fetch_u(&rna_path_cache_generation, 1) == 0) {
+		atomic_add_and_fetch_u(&rna_path_cache_generation, 1);
+	}
+}
+
+/* Writing to RNA Settings --------------------------- */
+
+/* Resolve the setting to write to. When 'cache' is given the path is only resolved the
+ * first time, it must then only be used by one thread at a time. */
 static bool animsys_store_rna_setting(
         PointerRNA *ptr, AnimMapper *remap,
         /* typically 'fcu->rna_path', 'fcu->array_index' */
         const char *rna_path, const int array_index,
-        PathResolvedRNA *r_result)
+        RNAPathCache *cache, PathResolvedRNA *r_result)
 {
 	bool success = false;
 
 	char *path = NULL;
 	bool free_path;
 
+	/* remapped paths differ between uses, so are never cached */
+	if (remap) {
+		cache = NULL;
+	}
+	else if (cache && BKE_animsys_rna_path_cache_lookup(cache, ptr, r_result)) {
+		return true;
+	}
+
 	/* get path, remapped as appropriate to work in its new environment */
 	free_path = animsys_remap_path(remap, (char *)rna_path, &path);
 
@@ -1458,6 +1519,10 @@ static bool animsys_store_rna_setting(
 				else {
 					r_result->prop_index = array_len ? array_index : -1;
 					success = true;
+
+					if (cache) {
+						BKE_animsys_rna_path_cache_store(cache, ptr, r_result);
+					}
 				}
 			}
 		}
@@ -1613,7 +1678,7 @@ bool BKE_animsys_execute_fcurve(PointerRNA *ptr, AnimMapper *remap, FCurve *fcu,
 	PathResolvedRNA anim_rna;
 	bool ok = false;
 
-	if (animsys_store_rna_setting(ptr, remap, fcu->rna_path, fcu->array_index, &anim_rna)) {
+	if (animsys_store_rna_setting(ptr, remap, fcu->rna_path, fcu->array_index, NULL, &anim_rna)) {
 		ok = animsys_write_rna_setting(&anim_rna, curval);
 	}
 
@@ -1623,8 +1688,9 @@ bool BKE_animsys_execute_fcurve(PointerRNA *ptr, AnimMapper *remap, FCurve *fcu,
 
 /* Evaluate all the F-Curves in the given list 
  * This performs a set of standard checks. If extra checks are required, separate code should be used
+ * Resolved paths are only cached with 'use_cache', when the curves can't be evaluated from other threads.
  */
-static void animsys_evaluate_fcurves(PointerRNA *ptr, ListBase *list, AnimMapper *remap, float ctime)
+static void animsys_evaluate_fcurves(PointerRNA *ptr, ListBase *list, AnimMapper *remap, float ctime, bool use_cache)
 {
 	FCurve *fcu;
 	
@@ -1635,7 +1701,9 @@ static void animsys_evaluate_fcurves(PointerRNA *ptr, ListBase *list, AnimMapper
 			/* check if this curve should be skipped */
 			if ((fcu->flag & (FCURVE_MUTED | FCURVE_DISABLED)) == 0) {
 				PathResolvedRNA anim_rna;
-				if (animsys_store_rna_setting(ptr, remap, fcu->rna_path, fcu->array_index, &anim_rna)) {
+				if (animsys_store_rna_setting(ptr, remap, fcu->rna_path, fcu->array_index,
+				                              use_cache ? &fcu->rna_cache : NULL, &anim_rna))
+				{
 					const float curval = calculate_fcurve(&anim_rna, fcu, ctime);
 					animsys_write_rna_setting(&anim_rna, curval);
 				}
@@ -1669,7 +1737,7 @@ static void animsys_evaluate_drivers(PointerRNA *ptr, AnimData *adt, float ctime
 				 *       new to only be done when drivers only changed */
 
 				PathResolvedRNA anim_rna;
-				if (animsys_store_rna_setting(ptr, NULL, fcu->rna_path, fcu->array_index, &anim_rna)) {
+				if (animsys_store_rna_setting(ptr, NULL, fcu->rna_path, fcu->array_index, &fcu->rna_cache, &anim_rna)) {
 					const float curval = calculate_fcurve(&anim_rna, fcu, ctime);
 					ok = animsys_write_rna_setting(&anim_rna, curval);
 				}
@@ -1721,6 +1789,10 @@ static void action_idcode_patch_check(ID *id, bAction *act)
 
 /* ----------------------------------------- */
 
+/* Actions used by several users (other IDs, NLA strips, constraints) may be evaluated
+ * from multiple threads at once, so their curves can't cache anything. */
+#define ACTION_USE_RNA_PATH_CACHE(act) ((act)->id.us <= 1)
+
 /* Evaluate Action Group */
 void animsys_evaluate_action_group(PointerRNA *ptr, bAction *act, bActionGroup *agrp, AnimMapper *remap, float ctime)
 {
@@ -1741,7 +1813,9 @@ void animsys_evaluate_action_group(PointerRNA *ptr, bAction *act, bActionGroup *
 		/* check if this curve should be skipped */
 		if ((fcu->flag & (FCURVE_MUTED | FCURVE_DISABLED)) == 0) {
 			PathResolvedRNA anim_rna;
-			if (animsys_store_rna_setting(ptr, remap, fcu->rna_path, fcu->array_index, &anim_rna)) {
+			if (animsys_store_rna_setting(ptr, remap, fcu->rna_path, fcu->array_index,
+			                              ACTION_USE_RNA_PATH_CACHE(act) ? &fcu->rna_cache : NULL, &anim_rna))
+			{
 				const float curval = calculate_fcurve(&anim_rna, fcu, ctime);
 				animsys_write_rna_setting(&anim_rna, curval);
 			}
@@ -1759,7 +1833,7 @@ void animsys_evaluate_action(PointerRNA *ptr, bAction *act, AnimMapper *remap, f
 	action_idcode_patch_check(ptr->id.data, act);
 	
 	/* calculate then execute each curve */
-	animsys_evaluate_fcurves(ptr, &act->curves, remap, ctime);
+	animsys_evaluate_fcurves(ptr, &act->curves, remap, ctime, ACTION_USE_RNA_PATH_CACHE(act));
 }
 
 /* ***************************************** */
@@ -1798,7 +1872,7 @@ static void nlastrip_evaluate_controls(NlaStrip *strip, float ctime)
 		RNA_pointer_create(NULL, &RNA_NlaStrip, strip, &strip_ptr);
 		
 		/* execute these settings as per normal */
-		animsys_evaluate_fcurves(&strip_ptr, &strip->fcurves, NULL, ctime);
+		animsys_evaluate_fcurves(&strip_ptr, &strip->fcurves, NULL, ctime, true);
 	}
 	
 	/* analytically generate values for influence and time (if applicable)
@@ -1937,30 +2011,67 @@ NlaEvalStrip *nlastrips_ctime_get_strip(ListBase *list, ListBase *strips, short
 
 /* ---------------------- */
 
+/* channels are identified by the property they affect
+ * - comparing the PointerRNA's is done by comparing the pointers
+ *   to the actual struct the property resides in, since that all the
+ *   other data stored in PointerRNA cannot allow us to definitively
+ *   identify the data
+ */
+static unsigned int nlaevalchan_hash(const void *key)
+{
+	const NlaEvalChannel *nec = key;
+	size_t hash = BLI_ghashutil_ptrhash(nec->ptr.data);
+
+	hash = BLI_ghashutil_combine_hash(hash, BLI_ghashutil_ptrhash(nec->prop));
+	hash = BLI_ghashutil_combine_hash(hash, BLI_ghashutil_uinthash((unsigned int)nec->index));
+
+	return (unsigned int)hash;
+}
+
+static bool nlaevalchan_cmp(const void *a, const void *b)
+{
+	const NlaEvalChannel *nec_a = a;
+	const NlaEvalChannel *nec_b = b;
+
+	/* false means equal */
+	return !((nec_a->ptr.data == nec_b->ptr.data) && (nec_a->prop == nec_b->prop) && (nec_a->index == nec_b->index));
+}
+
+/* add a channel to the set, which must not contain a channel for the same property yet */
+static void nlaevalchan_add(NlaEvalChannels *channels, NlaEvalChannel *nec)
+{
+	if (channels->hash == NULL)
+		channels->hash = BLI_ghash_new(nlaevalchan_hash, nlaevalchan_cmp, __func__);
+
+	BLI_addtail(&channels->list, nec);
+	BLI_ghash_insert(channels->hash, nec, nec);
+}
+
+static void nlaevalchan_free_all(NlaEvalChannels *channels)
+{
+	if (channels->hash) {
+		BLI_ghash_free(channels->hash, NULL, NULL);
+		channels->hash = NULL;
+	}
+	BLI_freelistN(&channels->list);
+}
+
 /* find an NlaEvalChannel that matches the given criteria 
  *	- ptr and prop are the RNA data to find a match for
  */
-static NlaEvalChannel *nlaevalchan_find_match(ListBase *channels, PointerRNA *ptr, PropertyRNA *prop, int array_index)
+static NlaEvalChannel *nlaevalchan_find_match(NlaEvalChannels *channels, PointerRNA *ptr, PropertyRNA *prop, int array_index)
 {
-	NlaEvalChannel *nec;
+	NlaEvalChannel key;
 	
 	/* sanity check */
-	if (channels == NULL)
+	if (ELEM(NULL, channels, channels->hash))
 		return NULL;
 	
-	/* loop through existing channels, checking for a channel which affects the same property */
-	for (nec = channels->first; nec; nec = nec->next) {
-		/* - comparing the PointerRNA's is done by comparing the pointers
-		 *   to the actual struct the property resides in, since that all the
-		 *   other data stored in PointerRNA cannot allow us to definitively 
-		 *	identify the data 
-		 */
-		if ((nec->ptr.data == ptr->data) && (nec->prop == prop) && (nec->index == array_index))
-			return nec;
-	}
+	key.ptr.data = ptr->data;
+	key.prop = prop;
+	key.index = array_index;
 	
-	/* not found */
-	return NULL;
+	return BLI_ghash_lookup(channels->hash, &key);
 }
 
 /* initialise default value for NlaEvalChannel, so that it doesn't blend things wrong */
@@ -2002,7 +2113,7 @@ static void nlaevalchan_value_init(NlaEvalChannel *nec)
 }
 
 /* verify that an appropriate NlaEvalChannel for this F-Curve exists */
-static NlaEvalChannel *nlaevalchan_verify(PointerRNA *ptr, ListBase *channels, NlaEvalStrip *nes, FCurve *fcu, bool *newChan)
+static NlaEvalChannel *nlaevalchan_verify(PointerRNA *ptr, NlaEvalChannels *channels, NlaEvalStrip *nes, FCurve *fcu, bool *newChan)
 {
 	NlaEvalChannel *nec;
 	NlaStrip *strip = nes->strip;
@@ -2036,13 +2147,14 @@ static NlaEvalChannel *nlaevalchan_verify(PointerRNA *ptr, ListBase *channels, N
 	/* allocate a new struct for this if none found */
 	if (nec == NULL) {
 		nec = MEM_callocN(sizeof(NlaEvalChannel), "NlaEvalChannel");
-		BLI_addtail(channels, nec);
 		
 		/* store property links for writing to the property later */
 		nec->ptr = new_ptr;
 		nec->prop = prop;
 		nec->index = fcu->array_index;
 		
+		nlaevalchan_add(channels, nec);
+		
 		/* initialise value using default value of property [#35856] */
 		nlaevalchan_value_init(nec);
 		*newChan = true;
@@ -2109,16 +2221,16 @@ static void nlaevalchan_accumulate(NlaEvalChannel *nec, NlaEvalStrip *nes, float
 }
 
 /* accumulate the results of a temporary buffer with the results of the full-buffer */
-static void nlaevalchan_buffers_accumulate(ListBase *channels, ListBase *tmp_buffer, NlaEvalStrip *nes)
+static void nlaevalchan_buffers_accumulate(NlaEvalChannels *channels, NlaEvalChannels *tmp_buffer, NlaEvalStrip *nes)
 {
 	NlaEvalChannel *nec, *necn, *necd;
 	
 	/* optimize - abort if no channels */
-	if (BLI_listbase_is_empty(tmp_buffer))
+	if (BLI_listbase_is_empty(&tmp_buffer->list))
 		return;
 	
 	/* accumulate results in tmp_channels buffer to the accumulation buffer */
-	for (nec = tmp_buffer->first; nec; nec = necn) {
+	for (nec = tmp_buffer->list.first; nec; nec = necn) {
 		/* get pointer to next channel in case we remove the current channel from the temp-buffer */
 		necn = nec->next;
 		
@@ -2131,13 +2243,13 @@ static void nlaevalchan_buffers_accumulate(ListBase *channels, ListBase *tmp_buf
 		if (necd)
 			nlaevalchan_accumulate(necd, nes, 0, nec->value);
 		else {
-			BLI_remlink(tmp_buffer, nec);
-			BLI_addtail(channels, nec);
+			BLI_remlink(&tmp_buffer->list, nec);
+			nlaevalchan_add(channels, nec);
 		}
 	}
 	
 	/* free temp-channels that haven't been assimilated into the buffer */
-	BLI_freelistN(tmp_buffer);
+	nlaevalchan_free_all(tmp_buffer);
 }
 
 /* ---------------------- */
@@ -2198,7 +2310,7 @@ static void nlaeval_fmodifiers_split_stacks(ListBase *list1, ListBase *list2)
 /* ---------------------- */
 
 /* evaluate action-clip strip */
-static void nlastrip_evaluate_actionclip(PointerRNA *ptr, ListBase *channels, ListBase *modifiers, NlaEvalStrip *nes)
+static void nlastrip_evaluate_actionclip(PointerRNA *ptr, NlaEvalChannels *channels, ListBase *modifiers, NlaEvalStrip *nes)
 {
 	FModifierStackStorage *storage;
 	ListBase tmp_modifiers = {NULL, NULL};
@@ -2263,9 +2375,9 @@ static void nlastrip_evaluate_actionclip(PointerRNA *ptr, ListBase *channels, Li
 }
 
 /* evaluate transition strip */
-static void nlastrip_evaluate_transition(PointerRNA *ptr, ListBase *channels, ListBase *modifiers, NlaEvalStrip *nes)
+static void nlastrip_evaluate_transition(PointerRNA *ptr, NlaEvalChannels *channels, ListBase *modifiers, NlaEvalStrip *nes)
 {
-	ListBase tmp_channels = {NULL, NULL};
+	NlaEvalChannels tmp_channels = {{NULL, NULL}, NULL};
 	ListBase tmp_modifiers = {NULL, NULL};
 	NlaEvalStrip tmp_nes;
 	NlaStrip *s1, *s2;
@@ -2319,7 +2431,7 @@ static void nlastrip_evaluate_transition(PointerRNA *ptr, ListBase *channels, Li
 }
 
 /* evaluate meta-strip */
-static void nlastrip_evaluate_meta(PointerRNA *ptr, ListBase *channels, ListBase *modifiers, NlaEvalStrip *nes)
+static void nlastrip_evaluate_meta(PointerRNA *ptr, NlaEvalChannels *channels, ListBase *modifiers, NlaEvalStrip *nes)
 {
 	ListBase tmp_modifiers = {NULL, NULL};
 	NlaStrip *strip = nes->strip;
@@ -2356,7 +2468,7 @@ static void nlastrip_evaluate_meta(PointerRNA *ptr, ListBase *channels, ListBase
 }
 
 /* evaluates the given evaluation strip */
-void nlastrip_evaluate(PointerRNA *ptr, ListBase *channels, ListBase *modifiers, NlaEvalStrip *nes)
+void nlastrip_evaluate(PointerRNA *ptr, NlaEvalChannels *channels, ListBase *modifiers, NlaEvalStrip *nes)
 {
 	NlaStrip *strip = nes->strip;
 	
@@ -2389,7 +2501,7 @@ void nlastrip_evaluate(PointerRNA *ptr, ListBase *channels, ListBase *modifiers,
 }
 
 /* write the accumulated settings to */
-void nladata_flush_channels(ListBase *channels)
+void nladata_flush_channels(NlaEvalChannels *channels)
 {
 	NlaEvalChannel *nec;
 	
@@ -2398,7 +2510,7 @@ void nladata_flush_channels(ListBase *channels)
 		return;
 	
 	/* for each channel with accumulated values, write its value on the property it affects */
-	for (nec = channels->first; nec; nec = nec->next) {
+	for (nec = channels->list.first; nec; nec = nec->next) {
 		PointerRNA *ptr = &nec->ptr;
 		PropertyRNA *prop = nec->prop;
 		int array_index = nec->index;
@@ -2443,7 +2555,7 @@ void nladata_flush_channels(ListBase *channels)
  *
  * \param[out] echannels Evaluation channels with calculated values
  */
-static void animsys_evaluate_nla(ListBase *echannels, PointerRNA *ptr, AnimData *adt, float ctime)
+static void animsys_evaluate_nla(NlaEvalChannels *echannels, PointerRNA *ptr, AnimData *adt, float ctime)
 {
 	NlaTrack *nlt;
 	short track_index = 0;
@@ -2565,7 +2677,7 @@ static void animsys_evaluate_nla(ListBase *echannels, PointerRNA *ptr, AnimData
  */
 static void animsys_calculate_nla(PointerRNA *ptr, AnimData *adt, float ctime)
 {
-	ListBase echannels = {NULL, NULL};
+	NlaEvalChannels echannels = {{NULL, NULL}, NULL};
 
 	/* TODO: need to zero out all channels used, otherwise we have problems with threadsafety
 	 * and also when the user jumps between different times instead of moving sequentially... */
@@ -2577,7 +2689,7 @@ static void animsys_calculate_nla(PointerRNA *ptr, AnimData *adt, float ctime)
 	nladata_flush_channels(&echannels);
 	
 	/* free temp data */
-	BLI_freelistN(&echannels);
+	nlaevalchan_free_all(&echannels);
 }
 
 /* ***************************************** */ 
@@ -2604,7 +2716,7 @@ static void animsys_evaluate_overrides(PointerRNA *ptr, AnimData *adt)
 	/* for each override, simply execute... */
 	for (aor = adt->overrides.first; aor; aor = aor->next) {
 		PathResolvedRNA anim_rna;
-		if (animsys_store_rna_setting(ptr, NULL, aor->rna_path, aor->array_index, &anim_rna)) {
+		if (animsys_store_rna_setting(ptr, NULL, aor->rna_path, aor->array_index, NULL, &anim_rna)) {
 			animsys_write_rna_setting(&anim_rna, aor->value);
 		}
 	}
@@ -2887,7 +2999,7 @@ void BKE_animsys_eval_driver(EvaluationContext *eval_ctx,
 			//printf("\told val = %f\n", fcu->curval);
 
 			PathResolvedRNA anim_rna;
-			if (animsys_store_rna_setting(&id_ptr, NULL, fcu->rna_path, fcu->array_index, &anim_rna)) {
+			if (animsys_store_rna_setting(&id_ptr, NULL, fcu->rna_path, fcu->array_index, &fcu->rna_cache, &anim_rna)) {
 				const float curval = calculate_fcurve(&anim_rna, fcu, eval_ctx->ctime);
 				ok = animsys_write_rna_setting(&anim_rna, curval);
 			}
@@ -648,8 +648,8 @@ static void cloth_to_object (Object *ob,  ClothModifierData *clmd, float (*verte
 
 		for (i = 0; i < cloth->mvert_num; i++) {
 			copy_v3_v3 (vertexCos[i], cloth->verts[i].x);
-			mul_m4_v3(ob->imat, vertexCos[i]);	/* cloth is in global coords */
 		}
+		mul_m4_v3_array(ob->imat, vertexCos, (int)cloth->mvert_num);	/* cloth is in global coords */
 	}
 }
 
@@ -675,6 +675,35 @@ static int cloth_bvh_objcollisions_resolve ( ClothModifierData * clmd, Collision
 	return ret;
 }
 
+/* Reject self collision pairs from their topology only. This doesn't depend on the
+ * vertex positions, so it runs once inside the threaded overlap query. */
+static bool cloth_bvh_selfcollision_overlap_cb(void *userdata, int index_a, int index_b, int UNUSED(thread))
+{
+	ClothModifierData *clmd = userdata;
+	Cloth *cloth = clmd->clothObject;
+	const ClothVertex *verts = cloth->verts;
+
+	if (clmd->sim_parms->flags & CLOTH_SIMSETTINGS_FLAG_GOAL) {
+		if ((verts[index_a].flags & CLOTH_VERT_FLAG_PINNED) &&
+		    (verts[index_b].flags & CLOTH_VERT_FLAG_PINNED))
+		{
+			return false;
+		}
+	}
+
+	if ((verts[index_a].flags & CLOTH_VERT_FLAG_NOSELFCOLL) ||
+	    (verts[index_b].flags & CLOTH_VERT_FLAG_NOSELFCOLL))
+	{
+		return false;
+	}
+
+	if (BLI_edgeset_haskey(cloth->edgeset, index_a, index_b)) {
+		return false;
+	}
+
+	return true;
+}
+
 // cloth - object collisions
 int cloth_bvh_objcollision(Object *ob, ClothModifierData *clmd, float step, float dt )
 {
@@ -686,6 +715,9 @@ int cloth_bvh_objcollision(Object *ob, ClothModifierData *clmd, float step, floa
 	int ret = 0, ret2 = 0;
 	Object **collobjs = NULL;
 	unsigned int numcollobj = 0;
+	BVHTreeOverlap *self_overlap = NULL;
+	unsigned int self_result = 0;
+	bool self_overlap_done = false;
 
 	if ((clmd->sim_parms->flags & CLOTH_SIMSETTINGS_FLAG_COLLOBJ) || cloth_bvh==NULL)
 		return 0;
@@ -787,8 +819,6 @@ int cloth_bvh_objcollision(Object *ob, ClothModifierData *clmd, float step, floa
 		if ( clmd->coll_parms->flags & CLOTH_COLLSETTINGS_FLAG_SELF ) {
 			for (l = 0; l < (unsigned int)clmd->coll_parms->self_loop_count; l++) {
 				/* TODO: add coll quality rounds again */
-				BVHTreeOverlap *overlap = NULL;
-				unsigned int result = 0;
 	
 				// collisions = 1;
 				verts = cloth->verts; // needed for openMP
@@ -799,42 +829,30 @@ int cloth_bvh_objcollision(Object *ob, ClothModifierData *clmd, float step, floa
 				verts = cloth->verts;
 	
 				if ( cloth->bvhselftree ) {
-					// search for overlapping collision pairs
-					overlap = BLI_bvhtree_overlap(cloth->bvhselftree, cloth->bvhselftree, &result, NULL, NULL);
+					/* The self tree is only updated once above, so the overlapping pairs stay
+					 * the same for all loops and rounds, search them once and reuse them. */
+					if (!self_overlap_done) {
+						// search for overlapping collision pairs
+						self_overlap = BLI_bvhtree_overlap(cloth->bvhselftree, cloth->bvhselftree, &self_result,
+						                                   cloth_bvh_selfcollision_overlap_cb, clmd);
+						self_overlap_done = true;
+					}
 	
 	// #pragma omp parallel for private(k, i, j) schedule(static)
-					for ( k = 0; k < result; k++ ) {
+					for ( k = 0; k < self_result; k++ ) {
 						float temp[3];
 						float length = 0;
 						float mindistance;
 	
-						i = overlap[k].indexA;
-						j = overlap[k].indexB;
+						i = self_overlap[k].indexA;
+						j = self_overlap[k].indexB;
 	
 						mindistance = clmd->coll_parms->selfepsilon* ( cloth->verts[i].avg_spring_len + cloth->verts[j].avg_spring_len );
 	
-						if ( clmd->sim_parms->flags & CLOTH_SIMSETTINGS_FLAG_GOAL ) {
-							if ( ( cloth->verts [i].flags & CLOTH_VERT_FLAG_PINNED ) &&
-							     ( cloth->verts [j].flags & CLOTH_VERT_FLAG_PINNED ) )
-							{
-								continue;
-							}
-						}
-
-						if ((cloth->verts[i].flags & CLOTH_VERT_FLAG_NOSELFCOLL) ||
-						    (cloth->verts[j].flags & CLOTH_VERT_FLAG_NOSELFCOLL))
-						{
-							continue;
-						}
-	
 						sub_v3_v3v3(temp, verts[i].tx, verts[j].tx);
 	
 						if ( ( ABS ( temp[0] ) > mindistance ) || ( ABS ( temp[1] ) > mindistance ) || ( ABS ( temp[2] ) > mindistance ) ) continue;
 	
-						if (BLI_edgeset_haskey(cloth->edgeset, i, j)) {
-							continue;
-						}
-	
 						length = normalize_v3(temp );
 	
 						if ( length < mindistance ) {
@@ -861,10 +879,6 @@ int cloth_bvh_objcollision(Object *ob, ClothModifierData *clmd, float step, floa
 							// check for approximated time collisions
 						}
 					}
-	
-					if ( overlap )
-						MEM_freeN ( overlap );
-	
 				}
 			}
 			////////////////////////////////////////////////////////////
@@ -884,6 +898,9 @@ int cloth_bvh_objcollision(Object *ob, ClothModifierData *clmd, float step, floa
 	}
 	while ( ret2 && ( clmd->coll_parms->loop_count>rounds ) );
 	
+	if (self_overlap)
+		MEM_freeN(self_overlap);
+
 	if (collobjs)
 		MEM_freeN(collobjs);
 
@@ -41,6 +41,7 @@
 #include "DNA_ID.h"
 
 #include "BLI_utildefines.h"
+#include "BLI_hash_mm2a.h"
 #include "BLI_path_util.h"
 #include "BLI_string.h"
 #include "BLI_string_utils.h"
@@ -2808,7 +2809,7 @@ void CustomData_bmesh_free_block_data(CustomData *data, void *block)
 		memset(block, 0, data->totsize);
 }
 
-static void CustomData_bmesh_alloc_block(CustomData *data, void **block)
+void CustomData_bmesh_alloc_block(CustomData *data, void **block)
 {
 
 	if (*block)
@@ -3343,6 +3344,51 @@ const char *CustomData_layertype_name(int type)
 }
 
 
+/**
+ * Add the content of all layers to \a mm2, to detect changes of the data.
+ * Deform weights are hashed including the weights they reference, other
+ * layers that reference memory can't be hashed and make this return false.
+ */
+bool CustomData_hash_add(const CustomData *data, int totelem, BLI_HashMurmur2A *mm2)
+{
+	int i, j;
+
+	BLI_hash_mm2a_add_int(mm2, data->totlayer);
+
+	for (i = 0; i < data->totlayer; i++) {
+		const CustomDataLayer *layer = &data->layers[i];
+		const LayerTypeInfo *typeInfo = layerType_getInfo(layer->type);
+
+		BLI_hash_mm2a_add_int(mm2, layer->type);
+		BLI_hash_mm2a_add_int(mm2, layer->active);
+		BLI_hash_mm2a_add_int(mm2, layer->active_rnd);
+		BLI_hash_mm2a_add(mm2, (const unsigned char *)layer->name, strlen(layer->name));
+
+		if (layer->data == NULL) {
+			continue;
+		}
+
+		if (layer->type == CD_MDEFORMVERT) {
+			const MDeformVert *dvert = layer->data;
+
+			for (j = 0; j < totelem; j++, dvert++) {
+				BLI_hash_mm2a_add_int(mm2, dvert->totweight);
+				if (dvert->dw) {
+					BLI_hash_mm2a_add(mm2, (const unsigned char *)dvert->dw, sizeof(*dvert->dw) * dvert->totweight);
+				}
+			}
+		}
+		else if (typeInfo->free) {
+			return false;
+		}
+		else {
+			BLI_hash_mm2a_add(mm2, layer->data, (size_t)typeInfo->size * totelem);
+		}
+	}
+
+	return true;
+}
+
 /**
  * Can only ever be one of these.
  */
@@ -622,15 +622,13 @@ static void grid_bound_insert_cb_ex(void *userdata, void *userdata_chunk, const
 	boundInsert(grid_bound, bData->realCoord[bData->s_pos[i]].v);
 }
 
-static void grid_bound_insert_finalize(void *userdata, void *userdata_chunk)
+static void grid_bound_insert_reduce(void *UNUSED(userdata), void *__restrict chunk_join, void *__restrict chunk)
 {
-	PaintBakeData *bData = userdata;
-	VolumeGrid *grid = bData->grid;
+	Bounds3D *join = chunk_join;
+	Bounds3D *grid_bound = chunk;
 
-	Bounds3D *grid_bound = userdata_chunk;
-
-	boundInsert(&grid->grid_bounds, grid_bound->min);
-	boundInsert(&grid->grid_bounds, grid_bound->max);
+	boundInsert(join, grid_bound->min);
+	boundInsert(join, grid_bound->max);
 }
 
 static void grid_cell_points_cb_ex(void *userdata, void *userdata_chunk, const int i, const int UNUSED(thread_id))
@@ -652,17 +650,18 @@ static void grid_cell_points_cb_ex(void *userdata, void *userdata_chunk, const i
 	s_num[temp_t_index[i]]++;
 }
 
-static void grid_cell_points_finalize(void *userdata, void *userdata_chunk)
+static void grid_cell_points_reduce(void *userdata, void *__restrict chunk_join, void *__restrict chunk)
 {
 	PaintBakeData *bData = userdata;
 	VolumeGrid *grid = bData->grid;
 	const int grid_cells = grid->dim[0] * grid->dim[1] * grid->dim[2];
 
-	int *s_num = userdata_chunk;
+	int *join_s_num = chunk_join;
+	int *s_num = chunk;
 
 	/* calculate grid indexes */
 	for (int i = 0; i < grid_cells; i++) {
-		grid->s_num[i] += s_num[i];
+		join_s_num[i] += s_num[i];
 	}
 }
 
@@ -711,9 +710,9 @@ static void surfaceGenerateGrid(struct DynamicPaintSurface *surface)
 		/* calculate canvas dimensions */
 		/* Important to init correctly our ref grid_bound... */
 		boundInsert(&grid->grid_bounds, bData->realCoord[bData->s_pos[0]].v);
-		BLI_task_parallel_range_finalize(
+		BLI_task_parallel_range_reduce(
 		            0, sData->total_points, bData, &grid->grid_bounds, sizeof(grid->grid_bounds),
-		            grid_bound_insert_cb_ex, grid_bound_insert_finalize, sData->total_points > 1000, false);
+		            grid_bound_insert_cb_ex, grid_bound_insert_reduce, sData->total_points > 1000, false);
 
 		/* get dimensions */
 		sub_v3_v3v3(dim, grid->grid_bounds.max, grid->grid_bounds.min);
@@ -763,9 +762,9 @@ static void surfaceGenerateGrid(struct DynamicPaintSurface *surface)
 
 		if (!error) {
 			/* calculate number of points withing each cell */
-			BLI_task_parallel_range_finalize(
+			BLI_task_parallel_range_reduce(
 			            0, sData->total_points, bData, grid->s_num, sizeof(*grid->s_num) * grid_cells,
-			            grid_cell_points_cb_ex, grid_cell_points_finalize, sData->total_points > 1000, false);
+			            grid_cell_points_cb_ex, grid_cell_points_reduce, sData->total_points > 1000, false);
 
 			/* calculate grid indexes (not needed for first cell, which is zero). */
 			for (i = 1; i < grid_cells; i++) {
@@ -3084,7 +3083,26 @@ static void dynamic_paint_output_surface_image_wetmap_cb(void *userdata, const i
 	ibuf->rect_float[pos + 3] = 1.0f;
 }
 
-void dynamicPaint_outputSurfaceImage(DynamicPaintSurface *surface, char *filename, short output_layer)
+typedef struct DynamicPaintSaveImageTask {
+	ImBuf *ibuf;
+	char filepath[FILE_MAX];
+} DynamicPaintSaveImageTask;
+
+static void dynamic_paint_save_image_task(TaskPool *__restrict UNUSED(pool), void *taskdata, int UNUSED(threadid))
+{
+	DynamicPaintSaveImageTask *task = taskdata;
+
+	IMB_saveiff(task->ibuf, task->filepath, IB_rectfloat);
+	IMB_freeImBuf(task->ibuf);
+}
+
+/**
+ * Write the surface of the current frame to an image file.
+ *
+ * \param save_pool: When given, the image is only filled in here and written to disk by a task in this pool,
+ * which takes ownership of the image. This way compressing and writing can overlap with computing the next frame.
+ */
+void dynamicPaint_outputSurfaceImage(DynamicPaintSurface *surface, char *filename, short output_layer, TaskPool *save_pool)
 {
 	ImBuf *ibuf = NULL;
 	PaintSurfaceData *sData = surface->data;
@@ -3177,8 +3195,16 @@ void dynamicPaint_outputSurfaceImage(DynamicPaintSurface *surface, char *filenam
 	}
 
 	/* Save image */
-	IMB_saveiff(ibuf, output_file, IB_rectfloat);
-	IMB_freeImBuf(ibuf);
+	if (save_pool) {
+		DynamicPaintSaveImageTask *task = MEM_mallocN(sizeof(*task), __func__);
+		task->ibuf = ibuf;
+		BLI_strncpy(task->filepath, output_file, sizeof(task->filepath));
+		BLI_task_pool_push(save_pool, dynamic_paint_save_image_task, task, true, TASK_PRIORITY_LOW);
+	}
+	else {
+		IMB_saveiff(ibuf, output_file, IB_rectfloat);
+		IMB_freeImBuf(ibuf);
+	}
 }
 
 
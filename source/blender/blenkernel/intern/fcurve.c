@@ -43,9 +43,11 @@
 #include "DNA_constraint_types.h"
 #include "DNA_object_types.h"
 
+#include "BLI_alloca.h"
 #include "BLI_blenlib.h"
 #include "BLI_math.h"
 #include "BLI_easing.h"
+#include "BLI_simple_expr.h"
 #include "BLI_threads.h"
 #include "BLI_string_utils.h"
 #include "BLI_utildefines.h"
@@ -146,6 +148,7 @@ FCurve *copy_fcurve(const FCurve *fcu)
 	
 	/* copy rna-path */
 	fcu_d->rna_path = MEM_dupallocN(fcu_d->rna_path);
+	memset(&fcu_d->rna_cache, 0, sizeof(fcu_d->rna_cache));
 	
 	/* copy driver */
 	fcu_d->driver = fcurve_copy_driver(fcu_d->driver);
@@ -1056,6 +1059,24 @@ static ID *dtar_id_ensure_proxy_from(ID *id)
 	return id;
 }
 
+/* Resolve the RNA path of the target, reusing the result of earlier evaluations when still valid */
+static bool dtar_resolve_path(DriverTarget *dtar, PointerRNA *id_ptr, PointerRNA *r_ptr, PropertyRNA **r_prop, int *r_index)
+{
+	PathResolvedRNA result;
+
+	if (BKE_animsys_rna_path_cache_lookup(&dtar->rna_cache, id_ptr, &result) == false) {
+		if (!RNA_path_resolve_property_full(id_ptr, dtar->rna_path, &result.ptr, &result.prop, &result.prop_index)) {
+			return false;
+		}
+		BKE_animsys_rna_path_cache_store(&dtar->rna_cache, id_ptr, &result);
+	}
+
+	*r_ptr = result.ptr;
+	*r_prop = result.prop;
+	*r_index = result.prop_index;
+	return true;
+}
+
 /* Helper function to obtain a value using RNA from the specified source (for evaluating drivers) */
 static float dtar_get_prop_val(ChannelDriver *driver, DriverTarget *dtar)
 {
@@ -1086,7 +1107,7 @@ static float dtar_get_prop_val(ChannelDriver *driver, DriverTarget *dtar)
 	RNA_id_pointer_create(id, &id_ptr);
 	
 	/* get property to read from, and get value as appropriate */
-	if (RNA_path_resolve_property_full(&id_ptr, dtar->rna_path, &ptr, &prop, &index)) {
+	if (dtar_resolve_path(dtar, &id_ptr, &ptr, &prop, &index)) {
 		if (RNA_property_array_check(prop)) {
 			/* array */
 			if ((index >= 0) && (index < RNA_property_array_length(&ptr, prop))) {
@@ -1190,7 +1211,7 @@ bool driver_get_variable_property(
 		ptr = PointerRNA_NULL;
 		prop = NULL; /* ok */
 	}
-	else if (RNA_path_resolve_property_full(&id_ptr, dtar->rna_path, &ptr, &prop, &index)) {
+	else if (dtar_resolve_path(dtar, &id_ptr, &ptr, &prop, &index)) {
 		/* ok */
 	}
 	else {
@@ -1625,11 +1646,8 @@ void driver_free_variable_ex(ChannelDriver *driver, DriverVar *dvar)
 	/* remove and free the driver variable */
 	driver_free_variable(&driver->variables, dvar);
 	
-#ifdef WITH_PYTHON
 	/* since driver variables are cached, the expression needs re-compiling too */
-	if (driver->type == DRIVER_TYPE_PYTHON)
-		driver->flag |= DRIVER_FLAG_RENAMEVAR;
-#endif
+	driver_invalidate_expression(driver, false, true);
 }
 
 /* Copy driver variables from src_vars list to dst_vars list */
@@ -1645,6 +1663,7 @@ void driver_variables_copy(ListBase *dst_vars, const ListBase *src_vars)
 			/* make a copy of target's rna path if available */
 			if (dtar->rna_path)
 				dtar->rna_path = MEM_dupallocN(dtar->rna_path);
+			memset(&dtar->rna_cache, 0, sizeof(dtar->rna_cache));
 		}
 		DRIVER_TARGETS_LOOPER_END
 	}
@@ -1766,11 +1785,8 @@ DriverVar *driver_add_new_variable(ChannelDriver *driver)
 	/* set the default type to 'single prop' */
 	driver_change_variable_type(dvar, DVAR_TYPE_SINGLE_PROP);
 	
-#ifdef WITH_PYTHON
 	/* since driver variables are cached, the expression needs re-compiling too */
-	if (driver->type == DRIVER_TYPE_PYTHON)
-		driver->flag |= DRIVER_FLAG_RENAMEVAR;
-#endif
+	driver_invalidate_expression(driver, false, true);
 	
 	/* return the target */
 	return dvar;
@@ -1799,6 +1815,8 @@ void fcurve_free_driver(FCurve *fcu)
 		BPY_DECREF(driver->expr_comp);
 #endif
 
+	BLI_simple_expr_free(driver->expr_simple);
+
 	/* free driver itself, then set F-Curve's point to this to NULL (as the curve may still be used) */
 	MEM_freeN(driver);
 	fcu->driver = NULL;
@@ -1816,6 +1834,7 @@ ChannelDriver *fcurve_copy_driver(const ChannelDriver *driver)
 	/* copy all data */
 	ndriver = MEM_dupallocN(driver);
 	ndriver->expr_comp = NULL;
+	ndriver->expr_simple = NULL;
 	
 	/* copy variables */
 	BLI_listbase_clear(&ndriver->variables); /* to get rid of refs to non-copied data (that's still used on original) */ 
@@ -1850,6 +1869,101 @@ float driver_get_variable_value(ChannelDriver *driver, DriverVar *dvar)
 	return dvar->curval;
 }
 
+/* Tag the driver expression for parsing again, after it or the names of its variables changed */
+void driver_invalidate_expression(ChannelDriver *driver, bool expr_changed, bool varname_changed)
+{
+	if (expr_changed || varname_changed) {
+		BLI_simple_expr_free(driver->expr_simple);
+		driver->expr_simple = NULL;
+	}
+
+	if (expr_changed) {
+		driver->flag |= DRIVER_FLAG_RECOMPILE;
+	}
+
+	if (varname_changed) {
+		driver->flag |= DRIVER_FLAG_RENAMEVAR;
+	}
+}
+
+/* Only variables Python gets a plain number for can be used by simple expressions */
+static bool driver_variable_is_number(ChannelDriver *driver, DriverVar *dvar)
+{
+	if (dvar->type == DVAR_TYPE_SINGLE_PROP) {
+		PointerRNA ptr;
+		PropertyRNA *prop;
+		int index;
+
+		/* Python gets zero for paths which don't resolve */
+		if (!driver_get_variable_property(driver, &dvar->targets[0], &ptr, &prop, &index)) {
+			return true;
+		}
+
+		/* Python gets the data itself, or whole arrays */
+		if (prop == NULL) {
+			return false;
+		}
+		else if (RNA_property_array_check(prop)) {
+			return (index >= 0) && (index < RNA_property_array_length(&ptr, prop)) &&
+			       ELEM(RNA_property_type(prop), PROP_BOOLEAN, PROP_INT, PROP_FLOAT);
+		}
+		else {
+			return (index == -1) &&
+			       ELEM(RNA_property_type(prop), PROP_BOOLEAN, PROP_INT, PROP_FLOAT, PROP_ENUM);
+		}
+	}
+
+	return true;
+}
+
+/* Evaluate the expression of a Python driver without Python, for the subset of expressions
+ * supported by BLI_simple_expr.h, returns false when Python has to be used instead.
+ * Nothing is executed, so this is done even when script auto-execution is disabled. */
+static bool driver_evaluate_simple_expr(ChannelDriver *driver, const float evaltime, float *r_result)
+{
+	const int vars_len = BLI_listbase_count(&driver->variables);
+	const int params_len = vars_len + 1;
+	int i;
+
+	/* parse the expression once, unsupported expressions are stored as invalid */
+	if (driver->expr_simple == NULL) {
+		const char **names = BLI_array_alloca(names, params_len);
+
+		/* variables are evaluated as locals, so they take precedence over 'frame' */
+		names[0] = "frame";
+		i = 1;
+		for (DriverVar *dvar = driver->variables.first; dvar; dvar = dvar->next) {
+			names[i++] = dvar->name;
+		}
+
+		driver->expr_simple = BLI_simple_expr_parse(driver->expression, params_len, names);
+	}
+
+	if (!BLI_simple_expr_is_valid(driver->expr_simple)) {
+		return false;
+	}
+
+	double *params = BLI_array_alloca(params, params_len);
+
+	params[0] = (double)evaltime;
+	i = 1;
+	for (DriverVar *dvar = driver->variables.first; dvar; dvar = dvar->next) {
+		if (!driver_variable_is_number(driver, dvar)) {
+			return false;
+		}
+		params[i++] = (double)driver_get_variable_value(driver, dvar);
+	}
+
+	double result;
+	if (BLI_simple_expr_evaluate(driver->expr_simple, params, params_len, &result) != SIMPLE_EXPR_SUCCESS) {
+		/* leave reporting the error to Python */
+		return false;
+	}
+
+	*r_result = (float)result;
+	return true;
+}
+
 /* Evaluate an Channel-Driver to get a 'time' value to use instead of "evaltime"
  *	- "evaltime" is the frame at which F-Curve is being evaluated
  *  - has to return a float value
@@ -1927,14 +2041,17 @@ float evaluate_driver(PathResolvedRNA *anim_rna, ChannelDriver *driver, const fl
 		}
 		case DRIVER_TYPE_PYTHON: /* expression */
 		{
-#ifdef WITH_PYTHON
 			/* check for empty or invalid expression */
 			if ( (driver->expression[0] == '\0') ||
 			     (driver->flag & DRIVER_FLAG_INVALID) )
 			{
 				driver->curval = 0.0f;
 			}
+			else if (driver_evaluate_simple_expr(driver, evaltime, &driver->curval)) {
+				/* simple expressions don't need Python, nor its lock */
+			}
 			else {
+#ifdef WITH_PYTHON
 				/* this evaluates the expression using Python, and returns its result:
 				 *  - on errors it reports, then returns 0.0f
 				 */
@@ -1943,10 +2060,10 @@ float evaluate_driver(PathResolvedRNA *anim_rna, ChannelDriver *driver, const fl
 				driver->curval = BPY_driver_exec(anim_rna, driver, evaltime);
 
 				BLI_mutex_unlock(&python_driver_lock);
-			}
 #else /* WITH_PYTHON*/
-			UNUSED_VARS(anim_rna, evaltime);
+				UNUSED_VARS(anim_rna);
 #endif /* WITH_PYTHON*/
+			}
 			break;
 		}
 		default:
@@ -2140,6 +2257,45 @@ static void berekenx(float *f, float *o, int b)
 /* -------------------------- */
 
 /* Calculate F-Curve value for 'evaltime' using BezTriple keyframes */
+/* Find the keyframe ending the segment evaltime lies in, for evaltime between the first and
+ * last keyframes, with the same result as binarysearch_bezt_index_ex(). Playback evaluates
+ * curves at increasing times, so the segment found last time and the one after it are tried
+ * before falling back to a binary search. */
+static int fcurve_bezt_find_segment(FCurve *fcu, BezTriple *bezts, float evaltime, float threshold, bool *r_exact)
+{
+	const int totvert = (int)fcu->totvert;
+	int a = fcu->last_segment;
+
+	for (int i = 0; i < 2; i++, a++) {
+		if ((a <= 0) || (a >= totvert)) {
+			continue;
+		}
+
+		/* the hint is only valid if the previous keyframe isn't close enough to be hit */
+		if (!(evaltime - bezts[a - 1].vec[1][0] > threshold)) {
+			continue;
+		}
+
+		if (bezts[a].vec[1][0] - evaltime > threshold) {
+			*r_exact = false;
+			fcu->last_segment = a;
+			return a;
+		}
+		else if (IS_EQT(evaltime, bezts[a].vec[1][0], threshold) &&
+		         ((a == totvert - 1) || (bezts[a + 1].vec[1][0] - evaltime > threshold)))
+		{
+			*r_exact = true;
+			fcu->last_segment = a;
+			return a;
+		}
+	}
+
+	a = binarysearch_bezt_index_ex(bezts, evaltime, totvert, threshold, r_exact);
+	fcu->last_segment = a;
+
+	return a;
+}
+
 static float fcurve_eval_keyframes(FCurve *fcu, BezTriple *bezts, float evaltime)
 {
 	const float eps = 1.e-8f;
@@ -2271,7 +2427,7 @@ static float fcurve_eval_keyframes(FCurve *fcu, BezTriple *bezts, float evaltime
 		 *    - 0.00001 is too fine     -> Weird errors, like selecting the wrong keyframe range (see T39207), occur.
 		 *                                 This lower bound was established in b888a32eee8147b028464336ad2404d8155c64dd
 		 */
-		a = binarysearch_bezt_index_ex(bezts, evaltime, fcu->totvert, 0.0001, &exact);
+		a = (unsigned int)fcurve_bezt_find_segment(fcu, bezts, evaltime, 0.0001f, &exact);
 		if (G.debug & G_DEBUG) printf("eval fcurve '%s' - %f => %u/%u, %d\n", fcu->rna_path, evaltime, a, fcu->totvert, exact);
 		
 		if (exact) {
@@ -63,6 +63,7 @@
 #include "BLI_blenlib.h"
 #include "BLI_math_vector.h"
 #include "BLI_mempool.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_timecode.h"  /* for stamp timecode format */
 #include "BLI_utildefines.h"
@@ -101,6 +102,9 @@
 
 static SpinLock image_spin;
 
+static void image_async_load_cancel(Image *ima);
+static void image_async_load_exit(void);
+
 /* prototypes */
 static int image_num_files(struct Image *ima);
 static ImBuf *image_acquire_ibuf(Image *ima, ImageUser *iuser, void **r_lock);
@@ -182,6 +186,7 @@ void BKE_images_init(void)
 
 void BKE_images_exit(void)
 {
+	image_async_load_exit();
 	BLI_spin_end(&image_spin);
 }
 
@@ -306,6 +311,8 @@ static void image_free_anims(Image *ima)
  */
 void BKE_image_free_buffers(Image *ima)
 {
+	image_async_load_cancel(ima);
+
 	image_free_cached_frames(ima);
 
 	image_free_anims(ima);
@@ -4123,6 +4130,227 @@ bool BKE_image_has_ibuf(Image *ima, ImageUser *iuser)
 	return ibuf != NULL;
 }
 
+/* ******** Asynchronous loading ********  */
+
+/* Single file images are decoded on background threads while drawing, so the
+ * interface doesn't stall on reading and decoding large files. Only the
+ * decoded image buffer is assigned to the image under the image lock. */
+
+typedef struct ImageAsyncLoad {
+	struct ImageAsyncLoad *next, *prev;
+	Image *ima;  /* NULL when the image buffers were freed while loading */
+	char filepath[FILE_MAX];
+	char colorspace[64];
+	int flag;
+	bool finished;
+} ImageAsyncLoad;
+
+/* Lock order is image_spin first, then image_async_lock. */
+static ThreadMutex image_async_lock = BLI_MUTEX_INITIALIZER;
+static ListBase image_async_loads = {NULL, NULL};
+static TaskPool *image_async_pool = NULL;
+
+static ImageAsyncLoad *image_async_load_find(Image *ima)
+{
+	ImageAsyncLoad *load;
+
+	for (load = image_async_loads.first; load; load = load->next) {
+		if (load->ima == ima) {
+			return load;
+		}
+	}
+
+	return NULL;
+}
+
+static void image_async_load_task(TaskPool * __restrict UNUSED(pool), void *taskdata, int UNUSED(threadid))
+{
+	ImageAsyncLoad *load = taskdata;
+	ImBuf *ibuf = IMB_loadiffname(load->filepath, load->flag, load->colorspace);
+
+	BLI_spin_lock(&image_spin);
+	BLI_mutex_lock(&image_async_lock);
+
+	if (load->ima == NULL) {
+		/* image buffers were freed meanwhile, the result is outdated */
+		BLI_remlink(&image_async_loads, load);
+		MEM_freeN(load);
+	}
+	else {
+		Image *ima = load->ima;
+		ImBuf *ibuf_cached = image_get_cached_ibuf_for_index_frame(ima, IMA_NO_INDEX, 0);
+
+		if (ibuf_cached) {
+			/* loaded from another thread meanwhile */
+			IMB_freeImBuf(ibuf_cached);
+		}
+		else if (ibuf == NULL) {
+			ima->ok = 0;
+		}
+#ifdef WITH_OPENEXR
+		else if (ibuf->ftype == IMB_FTYPE_OPENEXR && ibuf->userdata) {
+			/* same as load_image_single */
+			if (IMB_exr_has_singlelayer_multiview(ibuf->userdata)) {
+				image_create_multiview(ima, ibuf, 0);
+			}
+			else if (IMB_exr_has_multilayer(ibuf->userdata)) {
+				image_create_multilayer(ima, ibuf, 0);
+				ima->type = IMA_TYPE_MULTILAYER;
+			}
+		}
+#endif
+		else {
+			image_initialize_after_load(ima, ibuf);
+			detectBitmapFont(ibuf);
+			image_assign_ibuf(ima, ibuf, IMA_NO_INDEX, 0);
+		}
+
+		load->finished = true;
+	}
+
+	BLI_mutex_unlock(&image_async_lock);
+	BLI_spin_unlock(&image_spin);
+
+	/* the image cache holds its own reference */
+	if (ibuf) {
+		IMB_freeImBuf(ibuf);
+	}
+}
+
+static void image_async_load_cancel(Image *ima)
+{
+	ImageAsyncLoad *load, *load_next;
+
+	BLI_mutex_lock(&image_async_lock);
+
+	for (load = image_async_loads.first; load; load = load_next) {
+		load_next = load->next;
+
+		if (load->ima == ima) {
+			if (load->finished) {
+				BLI_remlink(&image_async_loads, load);
+				MEM_freeN(load);
+			}
+			else {
+				/* freed by the task */
+				load->ima = NULL;
+			}
+		}
+	}
+
+	BLI_mutex_unlock(&image_async_lock);
+}
+
+static void image_async_load_exit(void)
+{
+	if (image_async_pool) {
+		BLI_task_pool_work_and_wait(image_async_pool);
+		BLI_task_pool_free(image_async_pool);
+		image_async_pool = NULL;
+	}
+
+	BLI_freelistN(&image_async_loads);
+}
+
+/* Start loading the image on a background thread if it isn't loaded yet.
+ *
+ * Returns true while the image is being loaded, acquiring the image buffer
+ * would block until then. Returns false when the image buffer can be acquired,
+ * which still loads it synchronously for images that can't be loaded in the
+ * background (packed, multiview, sequences, movies, generated images...).
+ *
+ * Only to be called from the main thread. */
+bool BKE_image_load_async(Image *ima, ImageUser *iuser)
+{
+	ImageAsyncLoad *load;
+	ImBuf *ibuf;
+	bool is_loading;
+
+	/* quick reject tests */
+	if (!image_quick_test(ima, iuser))
+		return false;
+
+	if (ima->source != IMA_SRC_FILE || ima->type != IMA_TYPE_IMAGE ||
+	    BKE_image_is_multiview(ima) || BKE_image_has_packedfile(ima) || (G.fileflags & G_AUTOPACK))
+	{
+		return false;
+	}
+
+	/* image_spin can't be locked while holding image_async_lock */
+	BLI_mutex_lock(&image_async_lock);
+	load = image_async_load_find(ima);
+	is_loading = load && !load->finished;
+	BLI_mutex_unlock(&image_async_lock);
+
+	if (load) {
+		return is_loading;
+	}
+
+	BLI_spin_lock(&image_spin);
+	ibuf = image_get_cached_ibuf_for_index_frame(ima, IMA_NO_INDEX, 0);
+	if (ibuf) {
+		IMB_freeImBuf(ibuf);
+	}
+	BLI_spin_unlock(&image_spin);
+
+	if (ibuf) {
+		return false;
+	}
+
+	load = MEM_callocN(sizeof(ImageAsyncLoad), "ImageAsyncLoad");
+	load->ima = ima;
+	load->flag = IB_rect | IB_multilayer | IB_metadata | imbuf_alpha_flags_for_image(ima);
+	BLI_strncpy(load->colorspace, ima->colorspace_settings.name, sizeof(load->colorspace));
+
+	{
+		ImageUser iuser_t;
+
+		if (iuser)
+			iuser_t = *iuser;
+		else
+			iuser_t.framenr = ima->lastframe;
+
+		iuser_t.view = 0;
+
+		BKE_image_user_file_path(&iuser_t, ima, load->filepath);
+	}
+
+	if (image_async_pool == NULL) {
+		image_async_pool = BLI_task_pool_create(BLI_task_scheduler_get(), NULL);
+	}
+
+	BLI_mutex_lock(&image_async_lock);
+	BLI_addtail(&image_async_loads, load);
+	BLI_mutex_unlock(&image_async_lock);
+
+	BLI_task_pool_push(image_async_pool, image_async_load_task, load, false, TASK_PRIORITY_LOW);
+
+	return true;
+}
+
+/* Returns an image that finished loading in the background since the last
+ * call, or NULL. Its GPU textures and displays need to be updated. */
+Image *BKE_image_async_load_pop_finished(void)
+{
+	ImageAsyncLoad *load;
+	Image *ima = NULL;
+
+	BLI_mutex_lock(&image_async_lock);
+
+	for (load = image_async_loads.first; load; load = load->next) {
+		if (load->finished) {
+			ima = load->ima;
+			BLI_remlink(&image_async_loads, load);
+			MEM_freeN(load);
+			break;
+		}
+	}
+
+	BLI_mutex_unlock(&image_async_lock);
+
+	return ima;
+}
+
 /* ******** Pool for image buffers ********  */
 
 typedef struct ImagePoolEntry {
@@ -40,6 +40,7 @@
 #include "BLI_listbase.h"
 #include "BLI_bitmap.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
@@ -337,6 +338,9 @@ typedef struct LatticeDeformData {
 	Object *object;
 	float *latticedata;
 	float latmat[4][4];
+	/* Lattice vertex group influence, looked up once for all deformed points. */
+	MDeformVert *dvert;
+	int defgrp_index;
 } LatticeDeformData;
 
 LatticeDeformData *init_latt_deform(Object *oblatt, Object *ob)
@@ -399,6 +403,12 @@ LatticeDeformData *init_latt_deform(Object *oblatt, Object *ob)
 	lattice_deform_data->object = oblatt;
 	copy_m4_m4(lattice_deform_data->latmat, latmat);
 
+	lattice_deform_data->dvert = BKE_lattice_deform_verts_get(oblatt);
+	lattice_deform_data->defgrp_index = -1;
+	if (lt->vgroup[0] && lattice_deform_data->dvert) {
+		lattice_deform_data->defgrp_index = defgroup_name_index(oblatt, lt->vgroup);
+	}
+
 	return lattice_deform_data;
 }
 
@@ -412,16 +422,15 @@ void calc_latt_deform(LatticeDeformData *lattice_deform_data, float co[3], float
 	int ui, vi, wi, uu, vv, ww;
 
 	/* vgroup influence */
-	int defgrp_index = -1;
+	const int defgrp_index = lattice_deform_data->defgrp_index;
 	float co_prev[3], weight_blend = 0.0f;
-	MDeformVert *dvert = BKE_lattice_deform_verts_get(ob);
+	MDeformVert *dvert = lattice_deform_data->dvert;
 
 
 	if (lt->editlatt) lt = lt->editlatt->latt;
 	if (lattice_deform_data->latticedata == NULL) return;
 
-	if (lt->vgroup[0] && dvert) {
-		defgrp_index = defgroup_name_index(ob, lt->vgroup);
+	if (defgrp_index != -1) {
 		copy_v3_v3(co_prev, co);
 	}
 
@@ -790,28 +799,20 @@ void curve_deform_verts(
 		}
 	}
 	else {
-		if (cu->flag & CU_DEFORM_BOUNDS_OFF) {
-			for (a = 0; a < numVerts; a++) {
-				mul_m4_v3(cd.curvespace, vertexCos[a]);
-				calc_curve_deform(eval_ctx, scene, cuOb, vertexCos[a], defaxis, &cd, NULL);
-				mul_m4_v3(cd.objectspace, vertexCos[a]);
-			}
-		}
-		else {
+		mul_m4_v3_array(cd.curvespace, vertexCos, numVerts);
+
+		if ((cu->flag & CU_DEFORM_BOUNDS_OFF) == 0) {
 			/* set mesh min max bounds */
 			INIT_MINMAX(cd.dmin, cd.dmax);
-				
-			for (a = 0; a < numVerts; a++) {
-				mul_m4_v3(cd.curvespace, vertexCos[a]);
-				minmax_v3v3_v3(cd.dmin, cd.dmax, vertexCos[a]);
-			}
-	
-			for (a = 0; a < numVerts; a++) {
-				/* already in 'cd.curvespace', prev for loop */
-				calc_curve_deform(eval_ctx, scene, cuOb, vertexCos[a], defaxis, &cd, NULL);
-				mul_m4_v3(cd.objectspace, vertexCos[a]);
-			}
+			minmax_v3v3_v3_array(cd.dmin, cd.dmax, (const float (*)[3])vertexCos, numVerts);
 		}
+
+		for (a = 0; a < numVerts; a++) {
+			/* already in 'cd.curvespace', transformed above */
+			calc_curve_deform(eval_ctx, scene, cuOb, vertexCos[a], defaxis, &cd, NULL);
+		}
+
+		mul_m4_v3_array(cd.objectspace, vertexCos, numVerts);
 	}
 }
 
@@ -850,11 +851,37 @@ void curve_deform_vector(struct EvaluationContext *eval_ctx, Scene *scene, Objec
 
 }
 
+typedef struct LatticeDeformUserdata {
+	LatticeDeformData *lattice_deform_data;
+	float (*vertexCos)[3];
+	MDeformVert *dvert;
+	int defgrp_index;
+	float fac;
+} LatticeDeformUserdata;
+
+static void lattice_deform_vert_task(void *userdata, const int index)
+{
+	const LatticeDeformUserdata *data = userdata;
+
+	if (data->dvert) {
+		const float weight = defvert_find_weight(&data->dvert[index], data->defgrp_index);
+
+		if (weight > 0.0f) {
+			calc_latt_deform(data->lattice_deform_data, data->vertexCos[index], weight * data->fac);
+		}
+	}
+	else {
+		calc_latt_deform(data->lattice_deform_data, data->vertexCos[index], data->fac);
+	}
+}
+
 void lattice_deform_verts(Object *laOb, Object *target, DerivedMesh *dm,
                           float (*vertexCos)[3], int numVerts, const char *vgroup, float fac)
 {
 	LatticeDeformData *lattice_deform_data;
-	int a;
+	LatticeDeformUserdata data;
+	MDeformVert *dvert = NULL;
+	int defgrp_index = -1;
 	bool use_vgroups;
 
 	if (laOb->type != OB_LATTICE)
@@ -882,27 +909,28 @@ void lattice_deform_verts(Object *laOb, Object *target, DerivedMesh *dm,
 	
 	if (vgroup && vgroup[0] && use_vgroups) {
 		Mesh *me = target->data;
-		const int defgrp_index = defgroup_name_index(target, vgroup);
-		float weight;
 
-		if (defgrp_index >= 0 && (me->dvert || dm)) {
-			MDeformVert *dvert = me->dvert;
-			
-			for (a = 0; a < numVerts; a++, dvert++) {
-				if (dm) dvert = dm->getVertData(dm, a, CD_MDEFORMVERT);
-
-				weight = defvert_find_weight(dvert, defgrp_index);
+		defgrp_index = defgroup_name_index(target, vgroup);
 
-				if (weight > 0.0f)
-					calc_latt_deform(lattice_deform_data, vertexCos[a], weight * fac);
-			}
+		if (defgrp_index >= 0) {
+			dvert = dm ? dm->getVertDataArray(dm, CD_MDEFORMVERT) : me->dvert;
 		}
-	}
-	else {
-		for (a = 0; a < numVerts; a++) {
-			calc_latt_deform(lattice_deform_data, vertexCos[a], fac);
+
+		/* Vertex group not found, nothing to deform. */
+		if (dvert == NULL) {
+			end_latt_deform(lattice_deform_data);
+			return;
 		}
 	}
+
+	data.lattice_deform_data = lattice_deform_data;
+	data.vertexCos = vertexCos;
+	data.dvert = dvert;
+	data.defgrp_index = defgrp_index;
+	data.fac = fac;
+
+	BLI_task_parallel_range(0, numVerts, &data, lattice_deform_vert_task, numVerts > 1000);
+
 	end_latt_deform(lattice_deform_data);
 }
 
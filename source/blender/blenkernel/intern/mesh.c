@@ -540,11 +540,18 @@ Mesh *BKE_mesh_add(Main *bmain, const char *name)
 	return me;
 }
 
-Mesh *BKE_mesh_copy(Main *bmain, const Mesh *me)
+/**
+ * \param reference_customdata: Geometry layers of the copy point to the arrays of \a me
+ * instead of duplicating them, the arrays are never freed by the copy.
+ * Code which needs to modify such copy is to use #CustomData_duplicate_referenced_layer() first.
+ * The copy must not outlive geometry arrays of \a me.
+ */
+Mesh *BKE_mesh_copy_ex(Main *bmain, const Mesh *me, const bool reference_customdata)
 {
 	Mesh *men;
 	int a;
 	const int do_tessface = ((me->totface != 0) && (me->totpoly == 0)); /* only do tessface if we have no polys */
+	const int cd_alloctype = reference_customdata ? CD_REFERENCE : CD_DUPLICATE;
 	
 	men = BKE_libblock_copy(bmain, &me->id);
 	
@@ -554,12 +561,12 @@ Mesh *BKE_mesh_copy(Main *bmain, const Mesh *me)
 	}
 	id_us_plus((ID *)men->texcomesh);
 
-	CustomData_copy(&me->vdata, &men->vdata, CD_MASK_MESH, CD_DUPLICATE, men->totvert);
-	CustomData_copy(&me->edata, &men->edata, CD_MASK_MESH, CD_DUPLICATE, men->totedge);
-	CustomData_copy(&me->ldata, &men->ldata, CD_MASK_MESH, CD_DUPLICATE, men->totloop);
-	CustomData_copy(&me->pdata, &men->pdata, CD_MASK_MESH, CD_DUPLICATE, men->totpoly);
+	CustomData_copy(&me->vdata, &men->vdata, CD_MASK_MESH, cd_alloctype, men->totvert);
+	CustomData_copy(&me->edata, &men->edata, CD_MASK_MESH, cd_alloctype, men->totedge);
+	CustomData_copy(&me->ldata, &men->ldata, CD_MASK_MESH, cd_alloctype, men->totloop);
+	CustomData_copy(&me->pdata, &men->pdata, CD_MASK_MESH, cd_alloctype, men->totpoly);
 	if (do_tessface) {
-		CustomData_copy(&me->fdata, &men->fdata, CD_MASK_MESH, CD_DUPLICATE, men->totface);
+		CustomData_copy(&me->fdata, &men->fdata, CD_MASK_MESH, cd_alloctype, men->totface);
 	}
 	else {
 		mesh_tessface_clear_intern(men, false);
@@ -583,6 +590,11 @@ Mesh *BKE_mesh_copy(Main *bmain, const Mesh *me)
 	return men;
 }
 
+Mesh *BKE_mesh_copy(Main *bmain, const Mesh *me)
+{
+	return BKE_mesh_copy_ex(bmain, me, false);
+}
+
 BMesh *BKE_mesh_to_bmesh(
         Mesh *me, Object *ob,
         const bool add_key_index, const struct BMeshCreateParams *params)
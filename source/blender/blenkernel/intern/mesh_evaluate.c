@@ -284,11 +284,13 @@ void BKE_mesh_calc_normals_poly(
 
 	BLI_task_parallel_range(0, numPolys, &data, mesh_calc_normals_poly_accum_task_cb, (numPolys > BKE_MESH_OMP_LIMIT));
 
+	normalize_v3_array(vnors, numVerts);
+
 	for (i = 0; i < numVerts; i++) {
 		MVert *mv = &mverts[i];
 		float *no = vnors[i];
 
-		if (UNLIKELY(normalize_v3(no) == 0.0f)) {
+		if (UNLIKELY(is_zero_v3(no))) {
 			/* following Mesh convention; we use vertex coordinate itself for normal in this case */
 			normalize_v3_v3(no, mv->co);
 		}
@@ -1218,6 +1220,90 @@ static void loop_split_generator(TaskPool *pool, LoopSplitTaskDataCommon *common
  * Compute split normals, i.e. vertex normals associated with each poly (hence 'loop normals').
  * Useful to materialize sharp edges (or non-smooth faces) without actually modifying the geometry (splitting edges).
  */
+typedef struct LoopSplitEdgeTagData {
+	float (*loopnors)[3];
+	const MVert *mverts;
+	const MEdge *medges;
+	const MLoop *mloops;
+	const MPoly *mpolys;
+	const float (*polynors)[3];
+	int (*edge_to_loops)[2];
+	/* Number of loops using each edge. */
+	uint *edge_users;
+	int *loop_to_poly;
+	bool check_angle;
+	float split_angle;
+} LoopSplitEdgeTagData;
+
+/* Store the first two loops using each edge, the order is sorted out per edge afterwards. */
+static void loop_split_edge_users_task_cb(void *userdata, const int mp_index)
+{
+	LoopSplitEdgeTagData *data = userdata;
+	const MPoly *mp = &data->mpolys[mp_index];
+	const int ml_index_end = mp->loopstart + mp->totloop;
+
+	for (int ml_index = mp->loopstart; ml_index < ml_index_end; ml_index++) {
+		const MLoop *ml = &data->mloops[ml_index];
+		const uint user = atomic_fetch_and_add_uint32(&data->edge_users[ml->e], 1);
+
+		if (user < 2) {
+			data->edge_to_loops[ml->e][user] = ml_index;
+		}
+
+		data->loop_to_poly[ml_index] = mp_index;
+
+		/* Pre-populate all loop normals as if their verts were all-smooth, this way we don't have to compute
+		 * those later!
+		 */
+		normal_short_to_float_v3(data->loopnors[ml_index], data->mverts[ml->v].no);
+	}
+}
+
+static void loop_split_edge_tag_task_cb(void *userdata, const int me_index)
+{
+	LoopSplitEdgeTagData *data = userdata;
+	int *e2l = data->edge_to_loops[me_index];
+	const uint users = data->edge_users[me_index];
+
+	if (users == 0) {
+		/* Lose edges always have both values set to 0. */
+		return;
+	}
+
+	if (users == 1) {
+		/* Only one loop, unset, or sharp if its face is flat. */
+		e2l[1] = (data->mpolys[data->loop_to_poly[e2l[0]]].flag & ME_SMOOTH) ? INDEX_UNSET : INDEX_INVALID;
+		return;
+	}
+
+	/* Keep the loops in a stable order, independent of the threads. */
+	if (e2l[0] > e2l[1]) {
+		SWAP(int, e2l[0], e2l[1]);
+	}
+
+	if (users > 2) {
+		/* More than two loops using this edge, tag as sharp. */
+		e2l[1] = INDEX_INVALID;
+	}
+	else {
+		/* An edge is sharp if it is tagged as such, or one of its faces is not smooth,
+		 * or both poly have opposed (flipped) normals, i.e. both loops on the same edge share the same vertex,
+		 * or angle between both its polys' normals is above split_angle value.
+		 */
+		const int mp_index_a = data->loop_to_poly[e2l[0]];
+		const int mp_index_b = data->loop_to_poly[e2l[1]];
+
+		if (!(data->mpolys[mp_index_a].flag & ME_SMOOTH) || !(data->mpolys[mp_index_b].flag & ME_SMOOTH) ||
+		    (data->medges[me_index].flag & ME_SHARP) ||
+		    data->mloops[e2l[0]].v == data->mloops[e2l[1]].v ||
+		    (data->check_angle &&
+		     dot_v3v3(data->polynors[mp_index_a], data->polynors[mp_index_b]) < data->split_angle))
+		{
+			e2l[1] = INDEX_INVALID;
+		}
+	}
+}
+
 void BKE_mesh_normals_loop_split(
         const MVert *mverts, const int UNUSED(numVerts), MEdge *medges, const int numEdges,
         MLoop *mloops, float (*r_loopnors)[3], const int numLoops,
@@ -1271,9 +1357,6 @@ void BKE_mesh_normals_loop_split(
 	/* Simple mapping from a loop to its polygon index. */
 	int *loop_to_poly = r_loop_to_poly ? r_loop_to_poly : MEM_mallocN(sizeof(*loop_to_poly) * (size_t)numLoops, __func__);
 
-	MPoly *mp;
-	int mp_index;
-
 	/* When using custom loop normals, disable the angle feature! */
 	const bool check_angle = (split_angle < (float)M_PI) && (clnors_data == NULL);
 
@@ -1295,55 +1378,28 @@ void BKE_mesh_normals_loop_split(
 		BKE_lnor_spacearr_init(r_lnors_spacearr, numLoops);
 	}
 
-	/* This first loop check which edges are actually smooth, and compute edge vectors. */
-	for (mp = mpolys, mp_index = 0; mp_index < numPolys; mp++, mp_index++) {
-		MLoop *ml_curr;
-		int *e2l;
-		int ml_curr_index = mp->loopstart;
-		const int ml_last_index = (ml_curr_index + mp->totloop) - 1;
-
-		ml_curr = &mloops[ml_curr_index];
-
-		for (; ml_curr_index <= ml_last_index; ml_curr++, ml_curr_index++) {
-			e2l = edge_to_loops[ml_curr->e];
+	/* First find which edges are actually smooth, and pre-populate loop normals. */
+	{
+		LoopSplitEdgeTagData tag_data = {
+		    .loopnors = r_loopnors,
+		    .mverts = mverts,
+		    .medges = medges,
+		    .mloops = mloops,
+		    .mpolys = mpolys,
+		    .polynors = polynors,
+		    .edge_to_loops = edge_to_loops,
+		    .edge_users = MEM_callocN(sizeof(*tag_data.edge_users) * (size_t)numEdges, __func__),
+		    .loop_to_poly = loop_to_poly,
+		    .check_angle = check_angle,
+		    .split_angle = split_angle,
+		};
 
-			loop_to_poly[ml_curr_index] = mp_index;
+		BLI_task_parallel_range(
+		        0, numPolys, &tag_data, loop_split_edge_users_task_cb, (numPolys > BKE_MESH_OMP_LIMIT));
+		BLI_task_parallel_range(
+		        0, numEdges, &tag_data, loop_split_edge_tag_task_cb, (numEdges > BKE_MESH_OMP_LIMIT));
 
-			/* Pre-populate all loop normals as if their verts were all-smooth, this way we don't have to compute
-			 * those later!
-			 */
-			normal_short_to_float_v3(r_loopnors[ml_curr_index], mverts[ml_curr->v].no);
-
-			/* Check whether current edge might be smooth or sharp */
-			if ((e2l[0] | e2l[1]) == 0) {
-				/* 'Empty' edge until now, set e2l[0] (and e2l[1] to INDEX_UNSET to tag it as unset). */
-				e2l[0] = ml_curr_index;
-				/* We have to check this here too, else we might miss some flat faces!!! */
-				e2l[1] = (mp->flag & ME_SMOOTH) ? INDEX_UNSET : INDEX_INVALID;
-			}
-			else if (e2l[1] == INDEX_UNSET) {
-				/* Second loop using this edge, time to test its sharpness.
-				 * An edge is sharp if it is tagged as such, or its face is not smooth,
-				 * or both poly have opposed (flipped) normals, i.e. both loops on the same edge share the same vertex,
-				 * or angle between both its polys' normals is above split_angle value.
-				 */
-				if (!(mp->flag & ME_SMOOTH) || (medges[ml_curr->e].flag & ME_SHARP) ||
-				    ml_curr->v == mloops[e2l[0]].v ||
-				    (check_angle && dot_v3v3(polynors[loop_to_poly[e2l[0]]], polynors[mp_index]) < split_angle))
-				{
-					/* Note: we are sure that loop != 0 here ;) */
-					e2l[1] = INDEX_INVALID;
-				}
-				else {
-					e2l[1] = ml_curr_index;
-				}
-			}
-			else if (!IS_EDGE_SHARP(e2l)) {
-				/* More than two loops using this edge, tag as sharp if not yet done. */
-				e2l[1] = INDEX_INVALID;
-			}
-			/* Else, edge is already 'disqualified' (i.e. sharp)! */
-		}
+		MEM_freeN(tag_data.edge_users);
 	}
 
 	/* Init data common to all tasks. */
@@ -2628,134 +2684,218 @@ int BKE_mesh_recalc_tessellation(
 
 }
 
-/**
- * Calculate tessellation into #MLoopTri which exist only for this purpose.
- */
-void BKE_mesh_recalc_looptri(
-        const MLoop *mloop, const MPoly *mpoly,
-        const MVert *mvert,
-        int totloop, int totpoly,
-        MLoopTri *mlooptri)
+/* Number of polygons tessellated by one task. */
+#define LOOPTRI_TASK_BLOCK_SIZE 1024
+
+/* Tessellate a single polygon into \a mlt, returns the number of triangles. */
+static unsigned int mesh_recalc_looptri__single_poly(
+        const MLoop *mloop, const MPoly *mp, const MVert *mvert,
+        const int poly_index, MLoopTri *mlt, MemArena **pa_memarena)
 {
 	/* use this to avoid locking pthread for _every_ polygon
 	 * and calling the fill function */
 
 #define USE_TESSFACE_SPEEDUP
 
-	const MPoly *mp;
 	const MLoop *ml;
-	MLoopTri *mlt;
-	MemArena *arena = NULL;
-	int poly_index, mlooptri_index;
+	const unsigned int mp_loopstart = (unsigned int)mp->loopstart;
+	const unsigned int mp_totloop = (unsigned int)mp->totloop;
+	unsigned int l1, l2, l3;
 	unsigned int j;
 
-	mlooptri_index = 0;
-	mp = mpoly;
-	for (poly_index = 0; poly_index < totpoly; poly_index++, mp++) {
-		const unsigned int mp_loopstart = (unsigned int)mp->loopstart;
-		const unsigned int mp_totloop = (unsigned int)mp->totloop;
-		unsigned int l1, l2, l3;
-		if (mp_totloop < 3) {
-			/* do nothing */
-		}
+	if (mp_totloop < 3) {
+		/* do nothing */
+		return 0;
+	}
 
 #ifdef USE_TESSFACE_SPEEDUP
 
 #define ML_TO_MLT(i1, i2, i3)  { \
-			mlt = &mlooptri[mlooptri_index]; \
-			l1 = mp_loopstart + i1; \
-			l2 = mp_loopstart + i2; \
-			l3 = mp_loopstart + i3; \
-			ARRAY_SET_ITEMS(mlt->tri, l1, l2, l3); \
-			mlt->poly = (unsigned int)poly_index; \
-		} ((void)0)
+		l1 = mp_loopstart + i1; \
+		l2 = mp_loopstart + i2; \
+		l3 = mp_loopstart + i3; \
+		ARRAY_SET_ITEMS(mlt->tri, l1, l2, l3); \
+		mlt->poly = (unsigned int)poly_index; \
+	} ((void)0)
 
-		else if (mp_totloop == 3) {
-			ML_TO_MLT(0, 1, 2);
-			mlooptri_index++;
-		}
-		else if (mp_totloop == 4) {
-			ML_TO_MLT(0, 1, 2);
-			mlooptri_index++;
-			ML_TO_MLT(0, 2, 3);
-			mlooptri_index++;
-		}
+	else if (mp_totloop == 3) {
+		ML_TO_MLT(0, 1, 2);
+	}
+	else if (mp_totloop == 4) {
+		ML_TO_MLT(0, 1, 2);
+		mlt++;
+		ML_TO_MLT(0, 2, 3);
+	}
 #endif /* USE_TESSFACE_SPEEDUP */
-		else {
-			const float *co_curr, *co_prev;
+	else {
+		const float *co_curr, *co_prev;
 
-			float normal[3];
+		float normal[3];
 
-			float axis_mat[3][3];
-			float (*projverts)[2];
-			unsigned int (*tris)[3];
+		float axis_mat[3][3];
+		float (*projverts)[2];
+		unsigned int (*tris)[3];
 
-			const unsigned int totfilltri = mp_totloop - 2;
+		const unsigned int totfilltri = mp_totloop - 2;
+		MemArena *arena = *pa_memarena;
 
-			if (UNLIKELY(arena == NULL)) {
-				arena = BLI_memarena_new(BLI_MEMARENA_STD_BUFSIZE, __func__);
-			}
+		if (UNLIKELY(arena == NULL)) {
+			arena = *pa_memarena = BLI_memarena_new(BLI_MEMARENA_STD_BUFSIZE, __func__);
+		}
 
-			tris = BLI_memarena_alloc(arena, sizeof(*tris) * (size_t)totfilltri);
-			projverts = BLI_memarena_alloc(arena, sizeof(*projverts) * (size_t)mp_totloop);
+		tris = BLI_memarena_alloc(arena, sizeof(*tris) * (size_t)totfilltri);
+		projverts = BLI_memarena_alloc(arena, sizeof(*projverts) * (size_t)mp_totloop);
 
-			zero_v3(normal);
+		zero_v3(normal);
 
-			/* calc normal, flipped: to get a positive 2d cross product */
-			ml = mloop + mp_loopstart;
-			co_prev = mvert[ml[mp_totloop - 1].v].co;
-			for (j = 0; j < mp_totloop; j++, ml++) {
-				co_curr = mvert[ml->v].co;
-				add_newell_cross_v3_v3v3(normal, co_prev, co_curr);
-				co_prev = co_curr;
-			}
-			if (UNLIKELY(normalize_v3(normal) == 0.0f)) {
-				normal[2] = 1.0f;
-			}
+		/* calc normal, flipped: to get a positive 2d cross product */
+		ml = mloop + mp_loopstart;
+		co_prev = mvert[ml[mp_totloop - 1].v].co;
+		for (j = 0; j < mp_totloop; j++, ml++) {
+			co_curr = mvert[ml->v].co;
+			add_newell_cross_v3_v3v3(normal, co_prev, co_curr);
+			co_prev = co_curr;
+		}
+		if (UNLIKELY(normalize_v3(normal) == 0.0f)) {
+			normal[2] = 1.0f;
+		}
 
-			/* project verts to 2d */
-			axis_dominant_v3_to_m3_negate(axis_mat, normal);
+		/* project verts to 2d */
+		axis_dominant_v3_to_m3_negate(axis_mat, normal);
 
-			ml = mloop + mp_loopstart;
-			for (j = 0; j < mp_totloop; j++, ml++) {
-				mul_v2_m3v3(projverts[j], axis_mat, mvert[ml->v].co);
-			}
+		ml = mloop + mp_loopstart;
+		for (j = 0; j < mp_totloop; j++, ml++) {
+			mul_v2_m3v3(projverts[j], axis_mat, mvert[ml->v].co);
+		}
 
-			BLI_polyfill_calc_arena((const float (*)[2])projverts, mp_totloop, 1, tris, arena);
+		BLI_polyfill_calc_arena((const float (*)[2])projverts, mp_totloop, 1, tris, arena);
 
-			/* apply fill */
-			for (j = 0; j < totfilltri; j++) {
-				unsigned int *tri = tris[j];
+		/* apply fill */
+		for (j = 0; j < totfilltri; j++, mlt++) {
+			unsigned int *tri = tris[j];
 
-				mlt = &mlooptri[mlooptri_index];
+			/* set loop indices, transformed to vert indices later */
+			l1 = mp_loopstart + tri[0];
+			l2 = mp_loopstart + tri[1];
+			l3 = mp_loopstart + tri[2];
 
-				/* set loop indices, transformed to vert indices later */
-				l1 = mp_loopstart + tri[0];
-				l2 = mp_loopstart + tri[1];
-				l3 = mp_loopstart + tri[2];
+			ARRAY_SET_ITEMS(mlt->tri, l1, l2, l3);
+			mlt->poly = (unsigned int)poly_index;
+		}
 
-				ARRAY_SET_ITEMS(mlt->tri, l1, l2, l3);
-				mlt->poly = (unsigned int)poly_index;
+		BLI_memarena_clear(arena);
+	}
 
-				mlooptri_index++;
-			}
+	return mp_totloop - 2;
 
-			BLI_memarena_clear(arena);
+#undef USE_TESSFACE_SPEEDUP
+#undef ML_TO_MLT
+}
+
+typedef struct LoopTriTaskData {
+	const MLoop *mloop;
+	const MPoly *mpoly;
+	const MVert *mvert;
+	int totpoly;
+	MLoopTri *mlooptri;
+	/* Number of triangles per block of polygons, then the offset of the block. */
+	int *block_tottri;
+} LoopTriTaskData;
+
+typedef struct LoopTriTaskDataChunk {
+	MemArena *arena;
+} LoopTriTaskDataChunk;
+
+static void mesh_recalc_looptri_count_task_cb(void *userdata, const int block)
+{
+	LoopTriTaskData *data = userdata;
+	const int poly_end = min_ii((block + 1) * LOOPTRI_TASK_BLOCK_SIZE, data->totpoly);
+	int tottri = 0;
+
+	for (int poly_index = block * LOOPTRI_TASK_BLOCK_SIZE; poly_index < poly_end; poly_index++) {
+		const int totloop = data->mpoly[poly_index].totloop;
+		if (totloop >= 3) {
+			tottri += totloop - 2;
 		}
 	}
+	data->block_tottri[block] = tottri;
+}
 
-	if (arena) {
-		BLI_memarena_free(arena);
-		arena = NULL;
+static void mesh_recalc_looptri_fill_task_cb(
+        void *userdata, void *userdata_chunk, const int block, const int UNUSED(threadid))
+{
+	LoopTriTaskData *data = userdata;
+	LoopTriTaskDataChunk *chunk = userdata_chunk;
+	const int poly_end = min_ii((block + 1) * LOOPTRI_TASK_BLOCK_SIZE, data->totpoly);
+	MLoopTri *mlt = &data->mlooptri[data->block_tottri[block]];
+
+	for (int poly_index = block * LOOPTRI_TASK_BLOCK_SIZE; poly_index < poly_end; poly_index++) {
+		mlt += mesh_recalc_looptri__single_poly(
+		        data->mloop, &data->mpoly[poly_index], data->mvert, poly_index, mlt, &chunk->arena);
 	}
+}
 
-	BLI_assert(mlooptri_index == poly_to_tri_count(totpoly, totloop));
-	UNUSED_VARS_NDEBUG(totloop);
+static void mesh_recalc_looptri_finalize_cb(void *UNUSED(userdata), void *userdata_chunk)
+{
+	LoopTriTaskDataChunk *chunk = userdata_chunk;
 
-#undef USE_TESSFACE_SPEEDUP
-#undef ML_TO_MLT
+	if (chunk->arena) {
+		BLI_memarena_free(chunk->arena);
+	}
 }
 
+/**
+ * Calculate tessellation into #MLoopTri which exist only for this purpose.
+ *
+ * Polygons are tessellated in parallel, in blocks of #LOOPTRI_TASK_BLOCK_SIZE.
+ * Each block gets its offset in \a mlooptri from a count of its triangles first,
+ * so the order of the triangles is the same as when tessellating serially.
+ */
+void BKE_mesh_recalc_looptri(
+        const MLoop *mloop, const MPoly *mpoly,
+        const MVert *mvert,
+        int totloop, int totpoly,
+        MLoopTri *mlooptri)
+{
+	const int blocks_num = (totpoly + LOOPTRI_TASK_BLOCK_SIZE - 1) / LOOPTRI_TASK_BLOCK_SIZE;
+	const bool use_threading = (totpoly > BKE_MESH_OMP_LIMIT);
+	LoopTriTaskData data = {
+	    .mloop = mloop,
+	    .mpoly = mpoly,
+	    .mvert = mvert,
+	    .totpoly = totpoly,
+	    .mlooptri = mlooptri,
+	};
+	LoopTriTaskDataChunk chunk = {NULL};
+	int block, tottri = 0;
+
+	if (blocks_num == 0) {
+		return;
+	}
+
+	data.block_tottri = MEM_mallocN(sizeof(*data.block_tottri) * (size_t)blocks_num, __func__);
+
+	BLI_task_parallel_range(0, blocks_num, &data, mesh_recalc_looptri_count_task_cb, use_threading);
+
+	for (block = 0; block < blocks_num; block++) {
+		const int block_tottri = data.block_tottri[block];
+		data.block_tottri[block] = tottri;
+		tottri += block_tottri;
+	}
+
+	BLI_task_parallel_range_finalize(
+	        0, blocks_num, &data, &chunk, sizeof(chunk),
+	        mesh_recalc_looptri_fill_task_cb, mesh_recalc_looptri_finalize_cb,
+	        use_threading, false);
+
+	MEM_freeN(data.block_tottri);
+
+	BLI_assert(tottri == poly_to_tri_count(totpoly, totloop));
+	UNUSED_VARS_NDEBUG(totloop);
+}
+
+#undef LOOPTRI_TASK_BLOCK_SIZE
+
 /* -------------------------------------------------------------------- */
 
 
@@ -224,6 +224,7 @@ void BKE_object_free_modifiers(Object *ob)
 
 	/* modifiers may have stored data in the DM cache */
 	BKE_object_free_derived_caches(ob);
+	DM_free_modifier_cache(ob);
 }
 
 void BKE_object_modifier_hook_reset(Object *ob, HookModifierData *hmd)
@@ -494,6 +495,8 @@ void BKE_object_free(Object *ob)
 		ob->curve_cache = NULL;
 	}
 
+	DM_free_modifier_cache(ob);
+
 	BKE_previewimg_free(&ob->preview);
 
 	/* don't free, let the base free it */
@@ -1218,6 +1221,7 @@ Object *BKE_object_copy_ex(Main *bmain, const Object *ob, bool copy_caches)
 	
 	/* Copy runtime surve data. */
 	obn->curve_cache = NULL;
+	obn->modifier_cache = NULL;
 
 	BKE_id_copy_ensure_local(bmain, &ob->id, &obn->id);
 
@@ -36,6 +36,7 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_listbase.h"
+#include "BLI_mempool.h"
 #include "BLI_string_utf8.h"
 
 #include "BLI_math.h"
@@ -85,6 +86,7 @@ typedef struct DupliContext {
 
 	/* result containers */
 	ListBase *duplilist; /* legacy doubly-linked list */
+	BLI_mempool *dupli_pool; /* storage of the duplilist items */
 } DupliContext;
 
 typedef struct DupliGenerator {
@@ -114,6 +116,7 @@ static void init_context(DupliContext *r_ctx, EvaluationContext *eval_ctx, Scene
 	r_ctx->gen = get_dupli_generator(r_ctx);
 
 	r_ctx->duplilist = NULL;
+	r_ctx->dupli_pool = NULL;
 }
 
 /* create sub-context for recursive duplis */
@@ -148,7 +151,7 @@ static DupliObject *make_dupli(const DupliContext *ctx,
 
 	/* add a DupliObject instance to the result container */
 	if (ctx->duplilist) {
-		dob = MEM_callocN(sizeof(DupliObject), "dupli object");
+		dob = BLI_mempool_calloc(ctx->dupli_pool);
 		BLI_addtail(ctx->duplilist, dob);
 	}
 	else {
@@ -1215,18 +1218,31 @@ static const DupliGenerator *get_dupli_generator(const DupliContext *ctx)
 
 /* ---- ListBase dupli container implementation ---- */
 
+/* Number of DupliObject allocated at once, large instance counts would otherwise
+ * spend most of their time allocating individual items. */
+#define DUPLI_POOL_CHUNK_SIZE 128
+
+/* The list owns a pool its items are allocated from, so it can only be freed as a whole
+ * with free_object_duplilist. Callers only see the ListBase, which must come first. */
+typedef struct DupliList {
+	ListBase list;
+	BLI_mempool *pool;
+} DupliList;
+
 /* Returns a list of DupliObject */
 ListBase *object_duplilist_ex(EvaluationContext *eval_ctx, Scene *scene, Object *ob, bool update)
 {
-	ListBase *duplilist = MEM_callocN(sizeof(ListBase), "duplilist");
+	DupliList *duplilist = MEM_callocN(sizeof(DupliList), "duplilist");
 	DupliContext ctx;
 	init_context(&ctx, eval_ctx, scene, ob, NULL, update);
 	if (ctx.gen) {
-		ctx.duplilist = duplilist;
+		duplilist->pool = BLI_mempool_create(sizeof(DupliObject), 0, DUPLI_POOL_CHUNK_SIZE, BLI_MEMPOOL_NOP);
+		ctx.duplilist = &duplilist->list;
+		ctx.dupli_pool = duplilist->pool;
 		ctx.gen->make_duplis(&ctx);
 	}
 
-	return duplilist;
+	return &duplilist->list;
 }
 
 /* note: previously updating was always done, this is why it defaults to be on
@@ -1238,8 +1254,12 @@ ListBase *object_duplilist(EvaluationContext *eval_ctx, Scene *sce, Object *ob)
 
 void free_object_duplilist(ListBase *lb)
 {
-	BLI_freelistN(lb);
-	MEM_freeN(lb);
+	DupliList *duplilist = (DupliList *)lb;
+
+	if (duplilist->pool) {
+		BLI_mempool_destroy(duplilist->pool);
+	}
+	MEM_freeN(duplilist);
 }
 
 int count_duplilist(Object *ob)
@@ -173,12 +173,17 @@ static float gaussRand(RNG *rng)
 /**
  * Some useful functions
  */
-MINLINE float catrom(float p0, float p1, float p2, float p3, float f)
+/* Catmull-Rom weights of the four points around f, computed once so they can be
+ * shared between all the fields sampled at the same position. */
+MINLINE void catrom_weights(float w[4], float f)
 {
-	return 0.5f * ((2.0f * p1) +
-	               (-p0 + p2) * f +
-	               (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * f * f +
-	               (-p0 + 3.0f * p1 - 3.0f * p2 + p3) * f * f * f);
+	const float f2 = f * f;
+	const float f3 = f2 * f;
+
+	w[0] = 0.5f * (-f + 2.0f * f2 - f3);
+	w[1] = 0.5f * (2.0f - 5.0f * f2 + 3.0f * f3);
+	w[2] = 0.5f * (f + 4.0f * f2 - 3.0f * f3);
+	w[3] = 0.5f * (-f2 + f3);
 }
 
 MINLINE float omega(float k, float depth)
@@ -373,6 +378,7 @@ void BKE_ocean_eval_uv_catrom(struct Ocean *oc, struct OceanResult *ocr, float u
 	int i0, i1, i2, i3, j0, j1, j2, j3;
 	float frac_x, frac_z;
 	float uu, vv;
+	float wx[4], wz[4];
 
 	/* first wrap the texture so 0 <= (u, v) < 1 */
 	u = fmod(u, 1.0f);
@@ -411,15 +417,14 @@ void BKE_ocean_eval_uv_catrom(struct Ocean *oc, struct OceanResult *ocr, float u
 	j0 = j0 <   0 ? j0 + oc->_N : j0;
 	j3 = j3 >= oc->_N ? j3 - oc->_N : j3;
 
-#define INTERP(m) catrom(catrom(m[i0 * oc->_N + j0], m[i1 * oc->_N + j0], \
-                                m[i2 * oc->_N + j0], m[i3 * oc->_N + j0], frac_x), \
-                         catrom(m[i0 * oc->_N + j1], m[i1 * oc->_N + j1], \
-                                m[i2 * oc->_N + j1], m[i3 * oc->_N + j1], frac_x), \
-                         catrom(m[i0 * oc->_N + j2], m[i1 * oc->_N + j2], \
-                                m[i2 * oc->_N + j2], m[i3 * oc->_N + j2], frac_x), \
-                         catrom(m[i0 * oc->_N + j3], m[i1 * oc->_N + j3], \
-                                m[i2 * oc->_N + j3], m[i3 * oc->_N + j3], frac_x), \
-                         frac_z)
+	/* the weights are the same for every field, only compute them once */
+	catrom_weights(wx, frac_x);
+	catrom_weights(wz, frac_z);
+
+#define INTERP_ROW(m, j) (wx[0] * m[i0 * oc->_N + j] + wx[1] * m[i1 * oc->_N + j] + \
+                          wx[2] * m[i2 * oc->_N + j] + wx[3] * m[i3 * oc->_N + j])
+#define INTERP(m) (wz[0] * INTERP_ROW(m, j0) + wz[1] * INTERP_ROW(m, j1) + \
+                   wz[2] * INTERP_ROW(m, j2) + wz[3] * INTERP_ROW(m, j3))
 
 	{
 		if (oc->_do_disp_y) {
@@ -444,6 +449,7 @@ void BKE_ocean_eval_uv_catrom(struct Ocean *oc, struct OceanResult *ocr, float u
 		}
 	}
 #undef INTERP
+#undef INTERP_ROW
 
 	BLI_rw_mutex_unlock(&oc->oceanmutex);
 
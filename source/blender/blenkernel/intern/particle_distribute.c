@@ -792,6 +792,37 @@ static void distribute_invalid(Scene *scene, ParticleSystem *psys, int from)
 	}
 }
 
+typedef struct DistributeFaceAreaData {
+	const MFace *mface;
+	const MVert *mvert;
+	const float (*orco)[3];
+	float *element_weight;
+} DistributeFaceAreaData;
+
+static void distribute_face_area_cb(void *userdata, const int i)
+{
+	DistributeFaceAreaData *data = userdata;
+	const MFace *mf = &data->mface[i];
+	const float *co1, *co2, *co3, *co4 = NULL;
+
+	if (data->orco) {
+		co1 = data->orco[mf->v1];
+		co2 = data->orco[mf->v2];
+		co3 = data->orco[mf->v3];
+		if (mf->v4)
+			co4 = data->orco[mf->v4];
+	}
+	else {
+		co1 = data->mvert[mf->v1].co;
+		co2 = data->mvert[mf->v2].co;
+		co3 = data->mvert[mf->v3].co;
+		if (mf->v4)
+			co4 = data->mvert[mf->v4].co;
+	}
+
+	data->element_weight[i] = mf->v4 ? area_quad_v3(co1, co2, co3, co4) : area_tri_v3(co1, co2, co3);
+}
+
 /* Creates a distribution of coordinates on a DerivedMesh	*/
 /* This is to denote functionality that does not yet work with mesh - only derived mesh */
 static int psys_thread_context_init_distribute(ParticleThreadContext *ctx, ParticleSimulationData *sim, int from)
@@ -951,46 +982,36 @@ static int psys_thread_context_init_distribute(ParticleThreadContext *ctx, Parti
 
 	/* Calculate weights from face areas */
 	if ((part->flag&PART_EDISTR || children) && from != PART_FROM_VERT) {
-		MVert *v1, *v2, *v3, *v4;
-		float totarea=0.f, co1[3], co2[3], co3[3], co4[3];
+		float totarea=0.f;
 		float (*orcodata)[3];
+		float (*orco_tfm)[3] = NULL;
 		
 		orcodata= dm->getVertDataArray(dm, CD_ORCO);
 
-		for (i=0; i<totelem; i++) {
-			MFace *mf=dm->getTessFaceData(dm,i,CD_MFACE);
-
-			if (orcodata) {
-				copy_v3_v3(co1, orcodata[mf->v1]);
-				copy_v3_v3(co2, orcodata[mf->v2]);
-				copy_v3_v3(co3, orcodata[mf->v3]);
-				BKE_mesh_orco_verts_transform((Mesh*)ob->data, &co1, 1, 1);
-				BKE_mesh_orco_verts_transform((Mesh*)ob->data, &co2, 1, 1);
-				BKE_mesh_orco_verts_transform((Mesh*)ob->data, &co3, 1, 1);
-				if (mf->v4) {
-					copy_v3_v3(co4, orcodata[mf->v4]);
-					BKE_mesh_orco_verts_transform((Mesh*)ob->data, &co4, 1, 1);
-				}
-			}
-			else {
-				v1= (MVert*)dm->getVertData(dm,mf->v1,CD_MVERT);
-				v2= (MVert*)dm->getVertData(dm,mf->v2,CD_MVERT);
-				v3= (MVert*)dm->getVertData(dm,mf->v3,CD_MVERT);
-				copy_v3_v3(co1, v1->co);
-				copy_v3_v3(co2, v2->co);
-				copy_v3_v3(co3, v3->co);
-				if (mf->v4) {
-					v4= (MVert*)dm->getVertData(dm,mf->v4,CD_MVERT);
-					copy_v3_v3(co4, v4->co);
-				}
-			}
+		/* transform all coordinates at once, instead of every face corner separately */
+		if (orcodata) {
+			orco_tfm = MEM_dupallocN(orcodata);
+			BKE_mesh_orco_verts_transform((Mesh*)ob->data, orco_tfm, dm->getNumVerts(dm), 1);
+		}
+
+		/* face areas don't depend on each other, the sums below stay in order */
+		DistributeFaceAreaData area_data = {
+			.mface = dm->getTessFaceArray(dm),
+			.mvert = dm->getVertArray(dm),
+			.orco = (const float (*)[3])orco_tfm,
+			.element_weight = element_weight,
+		};
+		BLI_task_parallel_range(0, totelem, &area_data, distribute_face_area_cb, totelem > 1000);
 
-			cur = mf->v4 ? area_quad_v3(co1, co2, co3, co4) : area_tri_v3(co1, co2, co3);
+		if (orco_tfm)
+			MEM_freeN(orco_tfm);
+
+		for (i=0; i<totelem; i++) {
+			cur = element_weight[i];
 			
 			if (cur > maxweight)
 				maxweight = cur;
 
-			element_weight[i] = cur;
 			totarea += cur;
 		}
 
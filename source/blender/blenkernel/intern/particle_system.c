@@ -440,6 +440,7 @@ void psys_thread_context_init(ParticleThreadContext *ctx, ParticleSimulationData
 }
 
 #define MAX_PARTICLES_PER_TASK 256 /* XXX arbitrary - maybe use at least number of points instead for better balancing? */
+#define MIN_PARTICLES_PER_TASK 16
 
 BLI_INLINE int ceil_ii(int a, int b)
 {
@@ -449,9 +450,19 @@ BLI_INLINE int ceil_ii(int a, int b)
 void psys_tasks_create(ParticleThreadContext *ctx, int startpart, int endpart, ParticleTask **r_tasks, int *r_numtasks)
 {
 	ParticleTask *tasks;
+	const int numthreads = BLI_task_scheduler_num_threads(BLI_task_scheduler_get());
 	int numtasks = ceil_ii((endpart - startpart), MAX_PARTICLES_PER_TASK);
 	float particles_per_task = (float)(endpart - startpart) / (float)numtasks, p, pnext;
 	int i;
+
+	/* Split small ranges further so every thread gets a part. Tasks skip the random
+	 * numbers of preceding particles, so results don't depend on the split. Few but
+	 * expensive particles, like virtual parents with child modifiers, would otherwise
+	 * run on a single thread. */
+	if (numtasks < numthreads) {
+		numtasks = max_ii(numtasks, min_ii(numthreads, ceil_ii((endpart - startpart), MIN_PARTICLES_PER_TASK)));
+		particles_per_task = (float)(endpart - startpart) / (float)numtasks;
+	}
 	
 	tasks = MEM_callocN(sizeof(ParticleTask) * numtasks, "ParticleThread");
 	*r_numtasks = numtasks;
@@ -463,7 +474,8 @@ void psys_tasks_create(ParticleThreadContext *ctx, int startpart, int endpart, P
 		
 		tasks[i].ctx = ctx;
 		tasks[i].begin = (int)p;
-		tasks[i].end = min_ii((int)pnext, endpart);
+		/* don't lose the last particles to float rounding */
+		tasks[i].end = (i == numtasks - 1) ? endpart : min_ii((int)pnext, endpart);
 	}
 }
 
@@ -3372,6 +3384,31 @@ typedef struct DynamicStepSolverTaskData {
 	SpinLock spin;
 } DynamicStepSolverTaskData;
 
+static void dynamics_step_newton_task_cb_ex(
+        void *userdata, void *UNUSED(userdata_chunk), const int p, const int UNUSED(thread_id))
+{
+	DynamicStepSolverTaskData *data = userdata;
+	ParticleSimulationData *sim = data->sim;
+	ParticleSystem *psys = sim->psys;
+	ParticleSettings *part = psys->part;
+
+	ParticleData *pa;
+
+	if ((pa = psys->particles + p)->state.time <= 0.0f) {
+		return;
+	}
+
+	/* do global forces & effectors */
+	basic_integrate(sim, p, pa->state.time, data->cfra);
+
+	/* deflection */
+	if (sim->colliders)
+		collision_check(sim, p, pa->state.time, data->cfra);
+
+	/* rotations */
+	basic_rotate(part, pa, pa->state.time, data->timestep);
+}
+
 static void dynamics_step_sph_ddr_task_cb_ex(
         void *userdata, void *userdata_chunk, const int p, const int UNUSED(thread_id))
 {
@@ -3594,17 +3631,14 @@ static void dynamics_step(ParticleSimulationData *sim, float cfra)
 	switch (part->phystype) {
 		case PART_PHYS_NEWTON:
 		{
-			LOOP_DYNAMIC_PARTICLES {
-				/* do global forces & effectors */
-				basic_integrate(sim, p, pa->state.time, cfra);
-	
-				/* deflection */
-				if (sim->colliders)
-					collision_check(sim, p, pa->state.time, cfra);
+			/* particles don't interact, so they can be integrated in parallel like fluid particles */
+			DynamicStepSolverTaskData task_data = {
+			    .sim = sim, .cfra = cfra, .timestep = timestep, .dtime = dtime,
+			};
 
-				/* rotations */
-				basic_rotate(part, pa, pa->state.time, timestep);
-			}
+			BLI_task_parallel_range_ex(
+			            0, psys->totpart, &task_data, NULL, 0,
+			            dynamics_step_newton_task_cb_ex, psys->totpart > 100, true);
 			break;
 		}
 		case PART_PHYS_BOIDS:
@@ -56,8 +56,6 @@
 
 #define STACK_FIXED_DEPTH   100
 
-#define PBVH_THREADED_LIMIT 4
-
 typedef struct PBVHStack {
 	PBVHNode *node;
 	bool revisiting;
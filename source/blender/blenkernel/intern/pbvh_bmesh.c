@@ -30,6 +30,7 @@
 #include "BLI_heap.h"
 #include "BLI_math.h"
 #include "BLI_memarena.h"
+#include "BLI_task.h"
 
 #include "BKE_ccg.h"
 #include "BKE_DerivedMesh.h"
@@ -917,59 +918,132 @@ static void short_edge_queue_edge_add(
 	}
 }
 
-static void long_edge_queue_face_add(
-        EdgeQueueContext *eq_ctx,
-        BMFace *f)
+/* Return true if the face faces the view (when used) and intersects the sphere,
+ * this only reads the mesh so it's safe to call from multiple threads. */
+static bool edge_queue_face_test(const EdgeQueue *q, BMFace *f)
 {
 #ifdef USE_EDGEQUEUE_FRONTFACE
-	if (eq_ctx->q->use_view_normal) {
-		if (dot_v3v3(f->no, eq_ctx->q->view_normal) < 0.0f) {
-			return;
+	if (q->use_view_normal) {
+		if (dot_v3v3(f->no, q->view_normal) < 0.0f) {
+			return false;
 		}
 	}
 #endif
 
-	if (edge_queue_tri_in_sphere(eq_ctx->q, f)) {
-		/* Check each edge of the face */
-		BMLoop *l_first = BM_FACE_FIRST_LOOP(f);
-		BMLoop *l_iter = l_first;
-		do {
+	return edge_queue_tri_in_sphere(q, f);
+}
+
+/* Faces passing #edge_queue_face_test */
+static void long_edge_queue_face_add(
+        EdgeQueueContext *eq_ctx,
+        BMFace *f)
+{
+	/* Check each edge of the face */
+	BMLoop *l_first = BM_FACE_FIRST_LOOP(f);
+	BMLoop *l_iter = l_first;
+	do {
 #ifdef USE_EDGEQUEUE_EVEN_SUBDIV
-			const float len_sq = BM_edge_calc_length_squared(l_iter->e);
-			if (len_sq > eq_ctx->q->limit_len_squared) {
-				long_edge_queue_edge_add_recursive(
-				        eq_ctx, l_iter->radial_next, l_iter,
-				        len_sq, eq_ctx->q->limit_len);
-			}
+		const float len_sq = BM_edge_calc_length_squared(l_iter->e);
+		if (len_sq > eq_ctx->q->limit_len_squared) {
+			long_edge_queue_edge_add_recursive(
+			        eq_ctx, l_iter->radial_next, l_iter,
+			        len_sq, eq_ctx->q->limit_len);
+		}
 #else
-			long_edge_queue_edge_add(eq_ctx, l_iter->e);
+		long_edge_queue_edge_add(eq_ctx, l_iter->e);
 #endif
-		} while ((l_iter = l_iter->next) != l_first);
-	}
+	} while ((l_iter = l_iter->next) != l_first);
 }
 
+/* Faces passing #edge_queue_face_test */
 static void short_edge_queue_face_add(
         EdgeQueueContext *eq_ctx,
         BMFace *f)
 {
-#ifdef USE_EDGEQUEUE_FRONTFACE
-	if (eq_ctx->q->use_view_normal) {
-		if (dot_v3v3(f->no, eq_ctx->q->view_normal) < 0.0f) {
-			return;
+	BMLoop *l_iter;
+	BMLoop *l_first;
+
+	/* Check each edge of the face */
+	l_iter = l_first = BM_FACE_FIRST_LOOP(f);
+	do {
+		short_edge_queue_edge_add(eq_ctx, l_iter->e);
+	} while ((l_iter = l_iter->next) != l_first);
+}
+
+typedef struct EdgeQueueFaces {
+	const EdgeQueue *q;
+	PBVHNode **nodes;
+	int nodes_len;
+
+	/* Faces of each node passing #edge_queue_face_test, in the order of 'node->bm_faces' */
+	BMFace ***node_faces;
+	int *node_faces_len;
+} EdgeQueueFaces;
+
+static void edge_queue_faces_task_cb(void *userdata, const int n)
+{
+	EdgeQueueFaces *data = userdata;
+	PBVHNode *node = data->nodes[n];
+	const int faces_max = BLI_gset_size(node->bm_faces);
+	BMFace **faces = NULL;
+	int faces_len = 0;
+
+	if (faces_max != 0) {
+		GSetIterator gs_iter;
+
+		faces = MEM_mallocN(sizeof(*faces) * (size_t)faces_max, __func__);
+
+		/* Check each face */
+		GSET_ITER (gs_iter, node->bm_faces) {
+			BMFace *f = BLI_gsetIterator_getKey(&gs_iter);
+			if (edge_queue_face_test(data->q, f)) {
+				faces[faces_len++] = f;
+			}
 		}
 	}
-#endif
 
-	if (edge_queue_tri_in_sphere(eq_ctx->q, f)) {
-		BMLoop *l_iter;
-		BMLoop *l_first;
+	data->node_faces[n] = faces;
+	data->node_faces_len[n] = faces_len;
+}
+
+/* Find the faces to add to the queue from all leaf nodes marked for topology update.
+ *
+ * Testing the faces is done in parallel, adding their edges must be done afterwards,
+ * since it tags edges and adds them to the heap. */
+static void edge_queue_faces_init(EdgeQueueFaces *data, const EdgeQueue *q, PBVH *bvh)
+{
+	data->q = q;
+	data->nodes = MEM_mallocN(sizeof(*data->nodes) * (size_t)max_ii(bvh->totnode, 1), __func__);
+	data->nodes_len = 0;
 
-		/* Check each edge of the face */
-		l_iter = l_first = BM_FACE_FIRST_LOOP(f);
-		do {
-			short_edge_queue_edge_add(eq_ctx, l_iter->e);
-		} while ((l_iter = l_iter->next) != l_first);
+	for (int n = 0; n < bvh->totnode; n++) {
+		PBVHNode *node = &bvh->nodes[n];
+
+		/* Check leaf nodes marked for topology update */
+		if ((node->flag & PBVH_Leaf) &&
+		    (node->flag & PBVH_UpdateTopology) &&
+		    !(node->flag & PBVH_FullyHidden))
+		{
+			data->nodes[data->nodes_len++] = node;
+		}
 	}
+
+	data->node_faces = MEM_mallocN(sizeof(*data->node_faces) * (size_t)max_ii(data->nodes_len, 1), __func__);
+	data->node_faces_len = MEM_mallocN(sizeof(*data->node_faces_len) * (size_t)max_ii(data->nodes_len, 1), __func__);
+
+	BLI_task_parallel_range(
+	        0, data->nodes_len, data, edge_queue_faces_task_cb,
+	        data->nodes_len > PBVH_THREADED_LIMIT);
+}
+
+static void edge_queue_faces_free(EdgeQueueFaces *data)
+{
+	for (int n = 0; n < data->nodes_len; n++) {
+		MEM_SAFE_FREE(data->node_faces[n]);
+	}
+	MEM_freeN(data->node_faces);
+	MEM_freeN(data->node_faces_len);
+	MEM_freeN(data->nodes);
 }
 
 /* Create a priority queue containing vertex pairs connected by a long
@@ -1005,24 +1079,16 @@ static void long_edge_queue_create(
 	pbvh_bmesh_edge_tag_verify(bvh);
 #endif
 
-	for (int n = 0; n < bvh->totnode; n++) {
-		PBVHNode *node = &bvh->nodes[n];
-
-		/* Check leaf nodes marked for topology update */
-		if ((node->flag & PBVH_Leaf) &&
-		    (node->flag & PBVH_UpdateTopology) &&
-		    !(node->flag & PBVH_FullyHidden))
-		{
-			GSetIterator gs_iter;
+	EdgeQueueFaces faces_data;
+	edge_queue_faces_init(&faces_data, eq_ctx->q, bvh);
 
-			/* Check each face */
-			GSET_ITER (gs_iter, node->bm_faces) {
-				BMFace *f = BLI_gsetIterator_getKey(&gs_iter);
-
-				long_edge_queue_face_add(eq_ctx, f);
-			}
+	for (int n = 0; n < faces_data.nodes_len; n++) {
+		for (int i = 0; i < faces_data.node_faces_len[n]; i++) {
+			long_edge_queue_face_add(eq_ctx, faces_data.node_faces[n][i]);
 		}
 	}
+
+	edge_queue_faces_free(&faces_data);
 }
 
 /* Create a priority queue containing vertex pairs connected by a
@@ -1054,24 +1120,16 @@ static void short_edge_queue_create(
 	UNUSED_VARS(view_normal);
 #endif
 
-	for (int n = 0; n < bvh->totnode; n++) {
-		PBVHNode *node = &bvh->nodes[n];
-
-		/* Check leaf nodes marked for topology update */
-		if ((node->flag & PBVH_Leaf) &&
-		    (node->flag & PBVH_UpdateTopology) &&
-		    !(node->flag & PBVH_FullyHidden))
-		{
-			GSetIterator gs_iter;
+	EdgeQueueFaces faces_data;
+	edge_queue_faces_init(&faces_data, eq_ctx->q, bvh);
 
-			/* Check each face */
-			GSET_ITER (gs_iter, node->bm_faces) {
-				BMFace *f = BLI_gsetIterator_getKey(&gs_iter);
-
-				short_edge_queue_face_add(eq_ctx, f);
-			}
+	for (int n = 0; n < faces_data.nodes_len; n++) {
+		for (int i = 0; i < faces_data.node_faces_len[n]; i++) {
+			short_edge_queue_face_add(eq_ctx, faces_data.node_faces[n][i]);
 		}
 	}
+
+	edge_queue_faces_free(&faces_data);
 }
 
 /*************************** Topology update **************************/
@@ -1555,20 +1613,59 @@ bool BKE_pbvh_bmesh_node_raycast_detail(
 }
 
 
+typedef struct PBVHBMeshNormalsData {
+	PBVHNode **nodes;
+} PBVHBMeshNormalsData;
+
+static void pbvh_bmesh_normals_update_faces_task_cb(void *userdata, const int n)
+{
+	PBVHBMeshNormalsData *data = userdata;
+	PBVHNode *node = data->nodes[n];
+
+	if (node->flag & PBVH_UpdateNormals) {
+		GSetIterator gs_iter;
+
+		GSET_ITER (gs_iter, node->bm_faces) {
+			BM_face_normal_update(BLI_gsetIterator_getKey(&gs_iter));
+		}
+	}
+}
+
+static void pbvh_bmesh_normals_update_verts_task_cb(void *userdata, const int n)
+{
+	PBVHBMeshNormalsData *data = userdata;
+	PBVHNode *node = data->nodes[n];
+
+	if (node->flag & PBVH_UpdateNormals) {
+		GSetIterator gs_iter;
+
+		/* unique verts are only owned by this node, so this is safe to do in parallel */
+		GSET_ITER (gs_iter, node->bm_unique_verts) {
+			BM_vert_normal_update(BLI_gsetIterator_getKey(&gs_iter));
+		}
+	}
+}
+
 void pbvh_bmesh_normals_update(PBVHNode **nodes, int totnode)
 {
+	PBVHBMeshNormalsData data = {
+	    .nodes = nodes,
+	};
+
+	/* faces are owned by a single node, vertex normals need all face normals to be updated first */
+	BLI_task_parallel_range(
+	        0, totnode, &data, pbvh_bmesh_normals_update_faces_task_cb,
+	        totnode > PBVH_THREADED_LIMIT);
+	BLI_task_parallel_range(
+	        0, totnode, &data, pbvh_bmesh_normals_update_verts_task_cb,
+	        totnode > PBVH_THREADED_LIMIT);
+
 	for (int n = 0; n < totnode; n++) {
 		PBVHNode *node = nodes[n];
 
 		if (node->flag & PBVH_UpdateNormals) {
 			GSetIterator gs_iter;
 
-			GSET_ITER (gs_iter, node->bm_faces) {
-				BM_face_normal_update(BLI_gsetIterator_getKey(&gs_iter));
-			}
-			GSET_ITER (gs_iter, node->bm_unique_verts) {
-				BM_vert_normal_update(BLI_gsetIterator_getKey(&gs_iter));
-			}
 			/* This should be unneeded normally */
 			GSET_ITER (gs_iter, node->bm_other_verts) {
 				BM_vert_normal_update(BLI_gsetIterator_getKey(&gs_iter));
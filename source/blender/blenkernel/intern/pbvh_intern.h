@@ -173,6 +173,9 @@ struct PBVH {
 	struct BMLog *bm_log;
 };
 
+/* minimum number of nodes to handle in parallel */
+#define PBVH_THREADED_LIMIT 4
+
 /* pbvh.c */
 void BB_reset(BB *bb);
 void BB_expand(BB *bb, const float co[3]);
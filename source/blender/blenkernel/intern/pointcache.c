@@ -2021,28 +2021,82 @@ static int ptcache_file_write(PTCacheFile *pf, const void *f, unsigned int tot,
 {
 	return (fwrite(f, size, tot, pf->fp) == tot);
 }
-static int ptcache_file_data_read(PTCacheFile *pf)
+static unsigned int ptcache_file_point_size(PTCacheFile *pf)
 {
+	unsigned int size = 0;
 	int i;
 
 	for (i=0; i<BPHYS_TOT_DATA; i++) {
-		if ((pf->data_types & (1<<i)) && !ptcache_file_read(pf, pf->cur[i], 1, ptcache_data_size[i]))
-			return 0;
+		if (pf->data_types & (1<<i))
+			size += ptcache_data_size[i];
 	}
-	
-	return 1;
+
+	return size;
 }
-static int ptcache_file_data_write(PTCacheFile *pf)
-{		
+/* Uncompressed files store the data of each point interleaved. Points are converted
+ * from/to the separate arrays of pm in a single buffer, instead of reading or writing
+ * every data type of every point with a separate call. */
+static int ptcache_file_points_read(PTCacheFile *pf, PTCacheMem *pm)
+{
+	const unsigned int point_size = ptcache_file_point_size(pf);
+	unsigned char *buffer, *bp;
+	unsigned int p;
 	int i;
 
-	for (i=0; i<BPHYS_TOT_DATA; i++) {
-		if ((pf->data_types & (1<<i)) && !ptcache_file_write(pf, pf->cur[i], 1, ptcache_data_size[i]))
-			return 0;
+	if (point_size == 0 || pm->totpoint == 0)
+		return 1;
+
+	buffer = MEM_mallocN((size_t)point_size * pm->totpoint, "pointcache_read_buffer");
+
+	if (!ptcache_file_read(pf, buffer, pm->totpoint, point_size)) {
+		MEM_freeN(buffer);
+		return 0;
 	}
-	
+
+	bp = buffer;
+	for (p=0; p<pm->totpoint; p++) {
+		for (i=0; i<BPHYS_TOT_DATA; i++) {
+			if (pf->data_types & (1<<i)) {
+				if (pm->data[i])
+					memcpy((unsigned char *)pm->data[i] + (size_t)p * ptcache_data_size[i], bp, ptcache_data_size[i]);
+				bp += ptcache_data_size[i];
+			}
+		}
+	}
+
+	MEM_freeN(buffer);
+
 	return 1;
 }
+static int ptcache_file_points_write(PTCacheFile *pf, PTCacheMem *pm)
+{
+	const unsigned int point_size = ptcache_file_point_size(pf);
+	unsigned char *buffer, *bp;
+	unsigned int p;
+	int i, ret;
+
+	if (point_size == 0 || pm->totpoint == 0)
+		return 1;
+
+	buffer = MEM_callocN((size_t)point_size * pm->totpoint, "pointcache_write_buffer");
+
+	bp = buffer;
+	for (p=0; p<pm->totpoint; p++) {
+		for (i=0; i<BPHYS_TOT_DATA; i++) {
+			if (pf->data_types & (1<<i)) {
+				if (pm->data[i])
+					memcpy(bp, (unsigned char *)pm->data[i] + (size_t)p * ptcache_data_size[i], ptcache_data_size[i]);
+				bp += ptcache_data_size[i];
+			}
+		}
+	}
+
+	ret = ptcache_file_write(pf, buffer, pm->totpoint, point_size);
+
+	MEM_freeN(buffer);
+
+	return ret;
+}
 static int ptcache_file_header_begin_read(PTCacheFile *pf)
 {
 	unsigned int typeflag=0;
@@ -2193,17 +2247,6 @@ static void ptcache_data_free(PTCacheMem *pm)
 			MEM_freeN(data[i]);
 	}
 }
-static void ptcache_data_copy(void *from[], void *to[])
-{
-	int i;
-	for (i=0; i<BPHYS_TOT_DATA; i++) {
-	/* note, durian file 03.4b_comp crashes if to[i] is not tested
-	 * its NULL, not sure if this should be fixed elsewhere but for now its needed */
-		if (from[i] && to[i])
-			memcpy(to[i], from[i], ptcache_data_size[i]);
-	}
-}
-
 static void ptcache_extra_free(PTCacheMem *pm)
 {
 	PTCacheExtra *extra = pm->extradata.first;
@@ -2314,17 +2357,8 @@ static PTCacheMem *ptcache_disk_frame_to_mem(PTCacheID *pid, int cfra)
 			}
 		}
 		else {
-			BKE_ptcache_mem_pointers_init(pm);
-			ptcache_file_pointers_init(pf);
-
-			for (i=0; i<pm->totpoint; i++) {
-				if (!ptcache_file_data_read(pf)) {
-					error = 1;
-					break;
-				}
-				ptcache_data_copy(pf->cur, pm->cur);
-				BKE_ptcache_mem_pointers_incr(pm);
-			}
+			if (!ptcache_file_points_read(pf, pm))
+				error = 1;
 		}
 	}
 
@@ -2404,17 +2438,8 @@ static int ptcache_mem_frame_to_disk(PTCacheID *pid, PTCacheMem *pm)
 			}
 		}
 		else {
-			BKE_ptcache_mem_pointers_init(pm);
-			ptcache_file_pointers_init(pf);
-
-			for (i=0; i<pm->totpoint; i++) {
-				ptcache_data_copy(pm->cur, pf->cur);
-				if (!ptcache_file_data_write(pf)) {
-					error = 1;
-					break;
-				}
-				BKE_ptcache_mem_pointers_incr(pm);
-			}
+			if (!ptcache_file_points_write(pf, pm))
+				error = 1;
 		}
 	}
 
@@ -1226,7 +1226,31 @@ static void rigidbody_update_sim_world(Scene *scene, RigidBodyWorld *rbw)
 	rigidbody_update_ob_array(rbw);
 }
 
-static void rigidbody_update_sim_ob(struct EvaluationContext *eval_ctx, Scene *scene, RigidBodyWorld *rbw, Object *ob, RigidBodyOb *rbo)
+/* Effectors acting on the simulation objects, shared by all objects on the same layers.
+ * Collecting them per object is quadratic in the number of objects in the scene. */
+typedef struct RigidBodyEffectors {
+	ListBase *effectors;
+	unsigned int lay;
+	bool is_init;
+} RigidBodyEffectors;
+
+static ListBase *rigidbody_effectors_get(
+        struct EvaluationContext *eval_ctx, Scene *scene, RigidBodyWorld *rbw, Object *ob, RigidBodyEffectors *cache)
+{
+	/* only effectors of a group are filtered by the layers of the object, never by the object itself,
+	 * since the object is not a force field */
+	if (!cache->is_init || (rbw->effector_weights->group && cache->lay != ob->lay)) {
+		pdEndEffectors(&cache->effectors);
+		cache->effectors = pdInitEffectors(eval_ctx, scene, ob, NULL, rbw->effector_weights, true);
+		cache->lay = ob->lay;
+		cache->is_init = true;
+	}
+
+	return cache->effectors;
+}
+
+static void rigidbody_update_sim_ob(struct EvaluationContext *eval_ctx, Scene *scene, RigidBodyWorld *rbw, Object *ob, RigidBodyOb *rbo,
+                                    RigidBodyEffectors *effectors_cache)
 {
 	float loc[3];
 	float rot[4];
@@ -1274,7 +1298,7 @@ static void rigidbody_update_sim_ob(struct EvaluationContext *eval_ctx, Scene *s
 		ListBase *effectors;
 
 		/* get effectors present in the group specified by effector_weights */
-		effectors = pdInitEffectors(eval_ctx, scene, ob, NULL, effector_weights, true);
+		effectors = rigidbody_effectors_get(eval_ctx, scene, rbw, ob, effectors_cache);
 		if (effectors) {
 			float eff_force[3] = {0.0f, 0.0f, 0.0f};
 			float eff_loc[3], eff_vel[3];
@@ -1299,9 +1323,6 @@ static void rigidbody_update_sim_ob(struct EvaluationContext *eval_ctx, Scene *s
 		}
 		else if (G.f & G_DEBUG)
 			printf("\tno forces to apply to '%s'\n", ob->id.name + 2);
-
-		/* cleanup */
-		pdEndEffectors(&effectors);
 	}
 	/* NOTE: passive objects don't need to be updated since they don't move */
 
@@ -1318,6 +1339,7 @@ static void rigidbody_update_sim_ob(struct EvaluationContext *eval_ctx, Scene *s
 static void rigidbody_update_simulation(struct EvaluationContext *eval_ctx, Scene *scene, RigidBodyWorld *rbw, bool rebuild)
 {
 	GroupObject *go;
+	RigidBodyEffectors effectors_cache = {NULL};
 
 	/* update world */
 	if (rebuild)
@@ -1386,10 +1408,12 @@ static void rigidbody_update_simulation(struct EvaluationContext *eval_ctx, Scen
 			}
 
 			/* update simulation object... */
-			rigidbody_update_sim_ob(eval_ctx, scene, rbw, ob, rbo);
+			rigidbody_update_sim_ob(eval_ctx, scene, rbw, ob, rbo, &effectors_cache);
 		}
 	}
-	
+
+	pdEndEffectors(&effectors_cache.effectors);
+
 	/* update constraints */
 	if (rbw->constraints == NULL) /* no constraints, move on */
 		return;
@@ -27,20 +27,35 @@
  */
 
 #include <stddef.h>
+#include <string.h>
+
+#include "zlib.h"
 
 #include "BLI_sys_types.h"  /* for intptr_t */
 
 #include "MEM_guardedalloc.h"
 
+#include "DNA_action_types.h"
+#include "DNA_anim_types.h"
+#include "DNA_curve_types.h"
 #include "DNA_sequence_types.h"
 #include "DNA_scene_types.h"
 
+#include "IMB_colormanagement.h"
 #include "IMB_moviecache.h"
 #include "IMB_imbuf.h"
 #include "IMB_imbuf_types.h"
 
+#include "BLI_fileops.h"
+#include "BLI_hash_mm2a.h"
 #include "BLI_listbase.h"
+#include "BLI_path_util.h"
+#include "BLI_string.h"
+#include "BLI_utildefines.h"
 
+#include "BKE_appdir.h"
+#include "BKE_global.h"
+#include "BKE_main.h"
 #include "BKE_sequencer.h"
 #include "BKE_scene.h"
 
@@ -123,6 +138,8 @@ static bool seqcache_hashcmp(const void *a_, const void *b_)
 
 void BKE_sequencer_cache_destruct(void)
 {
+	BKE_sequencer_prefetch_stop();
+
 	if (moviecache)
 		IMB_moviecache_free(moviecache);
 
@@ -131,6 +148,8 @@ void BKE_sequencer_cache_destruct(void)
 
 void BKE_sequencer_cache_cleanup(void)
 {
+	BKE_sequencer_prefetch_stop();
+
 	if (moviecache) {
 		IMB_moviecache_free(moviecache);
 		moviecache = IMB_moviecache_create("seqcache", sizeof(SeqCacheKey), seqcache_hashhash, seqcache_hashcmp);
@@ -149,6 +168,8 @@ static bool seqcache_key_check_seq(ImBuf *UNUSED(ibuf), void *userkey, void *use
 
 void BKE_sequencer_cache_cleanup_sequence(Sequence *seq)
 {
+	BKE_sequencer_prefetch_stop();
+
 	if (moviecache)
 		IMB_moviecache_cleanup(moviecache, seqcache_key_check_seq, seq);
 }
@@ -219,7 +240,8 @@ ImBuf *BKE_sequencer_preprocessed_cache_get(const SeqRenderData *context, Sequen
 {
 	SeqPreprocessCacheElem *elem;
 
-	if (!preprocess_cache)
+	/* also keeps proxy building, which may run on several threads, off the shared cache */
+	if (!preprocess_cache || context->skip_cache)
 		return NULL;
 
 	if (preprocess_cache->cfra != cfra)
@@ -246,6 +268,9 @@ void BKE_sequencer_preprocessed_cache_put(const SeqRenderData *context, Sequence
 {
 	SeqPreprocessCacheElem *elem;
 
+	if (context->skip_cache)
+		return;
+
 	if (!preprocess_cache) {
 		preprocess_cache = MEM_callocN(sizeof(SeqPreprocessCache), "sequencer preprocessed cache");
 	}
@@ -285,3 +310,361 @@ void BKE_sequencer_preprocessed_cache_cleanup_sequence(Sequence *seq)
 		}
 	}
 }
+
+/* ********************** disk cache ********************** */
+
+/* The final frame of the strip stack can also be stored on disk, so frames
+ * viewed in an earlier session don't have to be rendered again. Files are
+ * named after a hash of everything the frame is rendered from: the render
+ * settings, the strips shown at the frame with the time stamps of their source
+ * files, and the sequencer animation. Frames depending on data which can't be
+ * hashed reliably (scene, clip and mask strips, modifiers, drivers) are not
+ * stored. */
+
+#define SEQ_DISK_CACHE_VERSION 1
+
+typedef struct SeqDiskCacheHeader {
+	char magic[4];
+	int version;
+	int x, y;
+	int planes;
+	int is_float;
+	char colorspace[64];
+} SeqDiskCacheHeader;
+
+typedef struct SeqDiskCacheHash {
+	BLI_HashMurmur2A mm2[2];
+} SeqDiskCacheHash;
+
+static void disk_cache_hash_add(SeqDiskCacheHash *hash, const void *data, size_t len)
+{
+	BLI_hash_mm2a_add(&hash->mm2[0], data, len);
+	BLI_hash_mm2a_add(&hash->mm2[1], data, len);
+}
+
+static void disk_cache_hash_add_string(SeqDiskCacheHash *hash, const char *str)
+{
+	disk_cache_hash_add(hash, str, strlen(str) + 1);
+}
+
+static void disk_cache_hash_add_file(SeqDiskCacheHash *hash, const char *dir, const char *file)
+{
+	char path[FILE_MAX];
+	BLI_stat_t st;
+
+	BLI_join_dirfile(path, sizeof(path), dir, file);
+	BLI_path_abs(path, G.main->name);
+
+	disk_cache_hash_add_string(hash, path);
+
+	if (BLI_stat(path, &st) == 0) {
+		const int64_t stamp[2] = {(int64_t)st.st_mtime, (int64_t)st.st_size};
+		disk_cache_hash_add(hash, stamp, sizeof(stamp));
+	}
+}
+
+static bool disk_cache_hash_anim(SeqDiskCacheHash *hash, AnimData *adt)
+{
+	FCurve *fcu;
+
+	if (adt->drivers.first || adt->nla_tracks.first) {
+		return false;
+	}
+
+	if (adt->action == NULL) {
+		return true;
+	}
+
+	for (fcu = adt->action->curves.first; fcu; fcu = fcu->next) {
+		const int values[3] = {fcu->array_index, fcu->extend, fcu->flag & FCURVE_MUTED};
+		int i;
+
+		if (fcu->rna_path == NULL || !STRPREFIX(fcu->rna_path, "sequence_editor")) {
+			continue;
+		}
+
+		if (fcu->modifiers.first) {
+			return false;
+		}
+
+		disk_cache_hash_add_string(hash, fcu->rna_path);
+		disk_cache_hash_add(hash, values, sizeof(values));
+
+		/* Only hash what affects evaluation, not the selection state. */
+		for (i = 0; i < fcu->totvert; i++) {
+			const BezTriple *bezt = &fcu->bezt[i];
+			const float params[3] = {bezt->back, bezt->amplitude, bezt->period};
+
+			disk_cache_hash_add(hash, bezt->vec, sizeof(bezt->vec));
+			disk_cache_hash_add(hash, &bezt->ipo, sizeof(bezt->ipo));
+			disk_cache_hash_add(hash, &bezt->easing, sizeof(bezt->easing));
+			disk_cache_hash_add(hash, params, sizeof(params));
+		}
+
+		if (fcu->fpt) {
+			for (i = 0; i < fcu->totvert; i++) {
+				disk_cache_hash_add(hash, fcu->fpt[i].vec, sizeof(fcu->fpt[i].vec));
+			}
+		}
+	}
+
+	return true;
+}
+
+static bool disk_cache_hash_seq(SeqDiskCacheHash *hash, Sequence *seq, float cfra)
+{
+	Strip *strip = seq->strip;
+	Sequence *iseq;
+	const int values[] = {
+	    seq->flag & ~(SEQ_ALLSEL | SEQ_OVERLAP), seq->type, seq->len, seq->start,
+	    seq->startofs, seq->endofs, seq->startstill, seq->endstill, seq->machine,
+	    seq->anim_preseek, seq->streamindex, seq->multicam_source,
+	    seq->anim_startofs, seq->anim_endofs, seq->blend_mode, seq->alpha_mode};
+	const float fvalues[] = {
+	    seq->sat, seq->mul, seq->effect_fader, seq->speed_fader, seq->blend_opacity, seq->strobe};
+
+	if (ELEM(seq->type, SEQ_TYPE_SCENE, SEQ_TYPE_MOVIECLIP, SEQ_TYPE_MASK) ||
+	    (seq->flag & SEQ_USE_VIEWS) || seq->modifiers.first)
+	{
+		return false;
+	}
+
+	disk_cache_hash_add_string(hash, seq->name);
+	disk_cache_hash_add(hash, values, sizeof(values));
+	disk_cache_hash_add(hash, fvalues, sizeof(fvalues));
+
+	if (strip) {
+		const int still[2] = {strip->startstill, strip->endstill};
+
+		disk_cache_hash_add(hash, still, sizeof(still));
+		disk_cache_hash_add_string(hash, strip->colorspace_settings.name);
+
+		if (strip->crop) {
+			disk_cache_hash_add(hash, strip->crop, sizeof(*strip->crop));
+		}
+		if (strip->transform) {
+			disk_cache_hash_add(hash, strip->transform, sizeof(*strip->transform));
+		}
+		if (strip->proxy) {
+			disk_cache_hash_add(hash, &strip->proxy->tc, sizeof(strip->proxy->tc));
+		}
+
+		if (seq->type == SEQ_TYPE_IMAGE && strip->stripdata) {
+			StripElem *s_elem = BKE_sequencer_give_stripelem(seq, cfra);
+			int i;
+
+			for (i = 0; i < seq->len; i++) {
+				disk_cache_hash_add_string(hash, strip->stripdata[i].name);
+			}
+
+			if (s_elem) {
+				disk_cache_hash_add_file(hash, strip->dir, s_elem->name);
+			}
+		}
+		else if (seq->type == SEQ_TYPE_MOVIE && strip->stripdata) {
+			disk_cache_hash_add_file(hash, strip->dir, strip->stripdata->name);
+		}
+	}
+
+	if (seq->effectdata) {
+		if (seq->type == SEQ_TYPE_SPEED) {
+			SpeedControlVars *speed = seq->effectdata;
+			const int speed_values[2] = {(int)(speed->globalSpeed * 1000.0f), speed->flags};
+
+			disk_cache_hash_add(hash, speed_values, sizeof(speed_values));
+		}
+		else {
+			disk_cache_hash_add(hash, seq->effectdata, MEM_allocN_len(seq->effectdata));
+		}
+	}
+
+	if (seq->seq1 && !disk_cache_hash_seq(hash, seq->seq1, cfra)) return false;
+	if (seq->seq2 && !disk_cache_hash_seq(hash, seq->seq2, cfra)) return false;
+	if (seq->seq3 && !disk_cache_hash_seq(hash, seq->seq3, cfra)) return false;
+
+	for (iseq = seq->seqbase.first; iseq; iseq = iseq->next) {
+		if (!disk_cache_hash_seq(hash, iseq, cfra)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static bool disk_cache_get_path(const SeqRenderData *context, ListBase *seqbasep, float cfra, int chanshown,
+                                char r_path[FILE_MAX])
+{
+	Scene *scene = context->scene;
+	Editing *ed = scene->ed;
+	SeqDiskCacheHash hash;
+	Sequence *seq;
+	char dir[FILE_MAX], name[64];
+	const int values[] = {
+	    context->rectx, context->recty, context->preview_render_size, context->motion_blur_samples,
+	    context->view_id, scene->r.views_format, chanshown};
+	const float fvalues[] = {context->motion_blur_shutter, cfra};
+
+	if (ed == NULL || (ed->cache_flag & SEQ_CACHE_DISK) == 0 || context->skip_cache || context->is_proxy_render) {
+		return false;
+	}
+
+	BLI_hash_mm2a_init(&hash.mm2[0], 0);
+	BLI_hash_mm2a_init(&hash.mm2[1], 0x9747b28c);
+
+	disk_cache_hash_add(&hash, values, sizeof(values));
+	disk_cache_hash_add(&hash, fvalues, sizeof(fvalues));
+	disk_cache_hash_add_string(&hash, scene->sequencer_colorspace_settings.name);
+
+	if (scene->adt && !disk_cache_hash_anim(&hash, scene->adt)) {
+		return false;
+	}
+
+	for (seq = seqbasep->first; seq; seq = seq->next) {
+		if (seq->startdisp <= cfra && seq->enddisp > cfra) {
+			if (!disk_cache_hash_seq(&hash, seq, cfra)) {
+				return false;
+			}
+		}
+	}
+
+	if (ed->cache_dir[0]) {
+		BLI_strncpy(dir, ed->cache_dir, sizeof(dir));
+		BLI_path_abs(dir, G.main->name);
+	}
+	else if (G.main->name[0]) {
+		BLI_strncpy(dir, "//sequencer_cache", sizeof(dir));
+		BLI_path_abs(dir, G.main->name);
+	}
+	else {
+		BLI_join_dirfile(dir, sizeof(dir), BKE_tempdir_base(), "sequencer_cache");
+	}
+
+	BLI_snprintf(name, sizeof(name), "%08x%08x.bseqcache",
+	             BLI_hash_mm2a_end(&hash.mm2[0]), BLI_hash_mm2a_end(&hash.mm2[1]));
+	BLI_join_dirfile(r_path, FILE_MAX, dir, name);
+
+	return true;
+}
+
+struct ImBuf *BKE_sequencer_disk_cache_get(const SeqRenderData *context, ListBase *seqbasep, float cfra, int chanshown)
+{
+	SeqDiskCacheHeader header;
+	char path[FILE_MAX];
+	ImBuf *ibuf;
+	gzFile file;
+	size_t size;
+
+	if (!disk_cache_get_path(context, seqbasep, cfra, chanshown, path) || !BLI_exists(path)) {
+		return NULL;
+	}
+
+	file = BLI_gzopen(path, "rb");
+	if (file == NULL) {
+		return NULL;
+	}
+
+	if (gzread(file, &header, sizeof(header)) != sizeof(header) ||
+	    memcmp(header.magic, "BSQC", 4) != 0 ||
+	    header.version != SEQ_DISK_CACHE_VERSION ||
+	    header.x != context->rectx || header.y != context->recty)
+	{
+		gzclose(file);
+		return NULL;
+	}
+
+	header.colorspace[sizeof(header.colorspace) - 1] = '\0';
+
+	ibuf = IMB_allocImBuf(header.x, header.y, header.planes, header.is_float ? IB_rectfloat : IB_rect);
+	if (ibuf == NULL) {
+		gzclose(file);
+		return NULL;
+	}
+
+	if (header.is_float) {
+		size = sizeof(float) * 4 * (size_t)header.x * (size_t)header.y;
+		if ((size_t)gzread(file, ibuf->rect_float, size) != size) {
+			IMB_freeImBuf(ibuf);
+			ibuf = NULL;
+		}
+	}
+	else {
+		size = sizeof(unsigned int) * (size_t)header.x * (size_t)header.y;
+		if ((size_t)gzread(file, ibuf->rect, size) != size) {
+			IMB_freeImBuf(ibuf);
+			ibuf = NULL;
+		}
+	}
+
+	gzclose(file);
+
+	if (ibuf) {
+		if (header.is_float) {
+			IMB_colormanagement_assign_float_colorspace(ibuf, header.colorspace);
+		}
+		else {
+			IMB_colormanagement_assign_rect_colorspace(ibuf, header.colorspace);
+		}
+	}
+
+	return ibuf;
+}
+
+void BKE_sequencer_disk_cache_put(const SeqRenderData *context, ListBase *seqbasep, float cfra, int chanshown,
+                                  ImBuf *ibuf)
+{
+	SeqDiskCacheHeader header = {{0}};
+	char path[FILE_MAX], path_temp[FILE_MAX];
+	const char *colorspace;
+	gzFile file;
+	size_t size;
+	bool ok;
+
+	if (ibuf == NULL || (ibuf->rect == NULL && ibuf->rect_float == NULL) ||
+	    (ibuf->rect_float && ibuf->channels != 4))
+	{
+		return;
+	}
+
+	if (!disk_cache_get_path(context, seqbasep, cfra, chanshown, path) || BLI_exists(path)) {
+		return;
+	}
+
+	memcpy(header.magic, "BSQC", 4);
+	header.version = SEQ_DISK_CACHE_VERSION;
+	header.x = ibuf->x;
+	header.y = ibuf->y;
+	header.planes = ibuf->planes;
+	header.is_float = (ibuf->rect_float != NULL);
+
+	colorspace = header.is_float ? IMB_colormanagement_get_float_colorspace(ibuf) :
+	                               IMB_colormanagement_get_rect_colorspace(ibuf);
+	BLI_strncpy(header.colorspace, colorspace, sizeof(header.colorspace));
+
+	/* Write to a temporary file first, readers never see partial frames. */
+	BLI_make_existing_file(path);
+	BLI_snprintf(path_temp, sizeof(path_temp), "%s@", path);
+
+	file = BLI_gzopen(path_temp, "wb1");
+	if (file == NULL) {
+		return;
+	}
+
+	if (header.is_float) {
+		size = sizeof(float) * 4 * (size_t)ibuf->x * (size_t)ibuf->y;
+		ok = (gzwrite(file, &header, sizeof(header)) == sizeof(header) &&
+		      (size_t)gzwrite(file, ibuf->rect_float, size) == size);
+	}
+	else {
+		size = sizeof(unsigned int) * (size_t)ibuf->x * (size_t)ibuf->y;
+		ok = (gzwrite(file, &header, sizeof(header)) == sizeof(header) &&
+		      (size_t)gzwrite(file, ibuf->rect, size) == size);
+	}
+
+	if (gzclose(file) != Z_OK) {
+		ok = false;
+	}
+
+	if (!ok || BLI_rename(path_temp, path) != 0) {
+		BLI_delete(path_temp, false, false);
+	}
+}
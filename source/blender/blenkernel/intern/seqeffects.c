@@ -1570,24 +1570,23 @@ static void copy_wipe_effect(Sequence *dst, Sequence *src)
 	dst->effectdata = MEM_dupallocN(src->effectdata);
 }
 
-static void do_wipe_effect_byte(Sequence *seq, float facf0, float UNUSED(facf1),  int x, int y, unsigned char *rect1,
+static void do_wipe_effect_byte(Sequence *seq, float facf0, float UNUSED(facf1), int width, int height,
+                                int start_line, int total_lines, unsigned char *rect1,
                                 unsigned char *rect2, unsigned char *out)
 {
 	WipeZone wipezone;
 	WipeVars *wipe = (WipeVars *)seq->effectdata;
-	int xo, yo;
+	int x, y;
 	unsigned char *cp1, *cp2, *rt;
 
-	precalc_wipe_zone(&wipezone, wipe, x, y);
+	precalc_wipe_zone(&wipezone, wipe, width, height);
 
 	cp1 = rect1;
 	cp2 = rect2;
 	rt = out;
 
-	xo = x;
-	yo = y;
-	for (y = 0; y < yo; y++) {
-		for (x = 0; x < xo; x++) {
+	for (y = start_line; y < start_line + total_lines; y++) {
+		for (x = 0; x < width; x++) {
 			float check = check_zone(&wipezone, x, y, seq, facf0);
 			if (check) {
 				if (cp1) {
@@ -1636,24 +1635,23 @@ static void do_wipe_effect_byte(Sequence *seq, float facf0, float UNUSED(facf1),
 	}
 }
 
-static void do_wipe_effect_float(Sequence *seq, float facf0, float UNUSED(facf1), int x, int y, float *rect1,
+static void do_wipe_effect_float(Sequence *seq, float facf0, float UNUSED(facf1), int width, int height,
+                                 int start_line, int total_lines, float *rect1,
                                  float *rect2, float *out)
 {
 	WipeZone wipezone;
 	WipeVars *wipe = (WipeVars *)seq->effectdata;
-	int xo, yo;
+	int x, y;
 	float *rt1, *rt2, *rt;
 
-	precalc_wipe_zone(&wipezone, wipe, x, y);
+	precalc_wipe_zone(&wipezone, wipe, width, height);
 
 	rt1 = rect1;
 	rt2 = rect2;
 	rt = out;
 
-	xo = x;
-	yo = y;
-	for (y = 0; y < yo; y++) {
-		for (x = 0; x < xo; x++) {
+	for (y = start_line; y < start_line + total_lines; y++) {
+		for (x = 0; x < width; x++) {
 			float check = check_zone(&wipezone, x, y, seq, facf0);
 			if (check) {
 				if (rt1) {
@@ -1695,21 +1693,26 @@ static void do_wipe_effect_float(Sequence *seq, float facf0, float UNUSED(facf1)
 	}
 }
 
-static ImBuf *do_wipe_effect(const SeqRenderData *context, Sequence *seq, float UNUSED(cfra), float facf0, float facf1,
-                             ImBuf *ibuf1, ImBuf *ibuf2, ImBuf *ibuf3)
+static void do_wipe_effect(const SeqRenderData *context, Sequence *seq, float UNUSED(cfra), float facf0, float facf1,
+                           ImBuf *ibuf1, ImBuf *ibuf2, ImBuf *UNUSED(ibuf3),
+                           int start_line, int total_lines, ImBuf *out)
 {
-	ImBuf *out = prepare_effect_imbufs(context, ibuf1, ibuf2, ibuf3);
-
 	if (out->rect_float) {
-		do_wipe_effect_float(seq, facf0, facf1, context->rectx, context->recty, ibuf1->rect_float,
-		                     ibuf2->rect_float, out->rect_float);
+		float *rect1 = NULL, *rect2 = NULL, *rect_out = NULL;
+
+		slice_get_float_buffers(context, ibuf1, ibuf2, NULL, out, start_line, &rect1, &rect2, NULL, &rect_out);
+
+		do_wipe_effect_float(seq, facf0, facf1, context->rectx, context->recty, start_line, total_lines,
+		                     rect1, rect2, rect_out);
 	}
 	else {
-		do_wipe_effect_byte(seq, facf0, facf1, context->rectx, context->recty, (unsigned char *) ibuf1->rect,
-		                    (unsigned char *) ibuf2->rect, (unsigned char *) out->rect);
-	}
+		unsigned char *rect1 = NULL, *rect2 = NULL, *rect_out = NULL;
 
-	return out;
+		slice_get_byte_buffers(context, ibuf1, ibuf2, NULL, out, start_line, &rect1, &rect2, NULL, &rect_out);
+
+		do_wipe_effect_byte(seq, facf0, facf1, context->rectx, context->recty, start_line, total_lines,
+		                    rect1, rect2, rect_out);
+	}
 }
 
 /*********************** Transform *************************/
@@ -1754,8 +1757,9 @@ static void copy_transform_effect(Sequence *dst, Sequence *src)
 	dst->effectdata = MEM_dupallocN(src->effectdata);
 }
 
-static void transform_image(int x, int y, ImBuf *ibuf1, ImBuf *out,  float scale_x, float scale_y,
-                            float translate_x, float translate_y, float rotate, int interpolation)
+static void transform_image(int x, int y, int start_line, int total_lines, ImBuf *ibuf1, ImBuf *out,
+                            float scale_x, float scale_y, float translate_x, float translate_y,
+                            float rotate, int interpolation)
 {
 	int xo, yo, xi, yi;
 	float xt, yt, xr, yr;
@@ -1768,7 +1772,7 @@ static void transform_image(int x, int y, ImBuf *ibuf1, ImBuf *out,  float scale
 	s = sinf(rotate);
 	c = cosf(rotate);
 
-	for (yi = 0; yi < yo; yi++) {
+	for (yi = start_line; yi < start_line + total_lines; yi++) {
 		for (xi = 0; xi < xo; xi++) {
 			/* translate point */
 			xt = xi - translate_x;
@@ -1802,7 +1806,8 @@ static void transform_image(int x, int y, ImBuf *ibuf1, ImBuf *out,  float scale
 	}
 }
 
-static void do_transform(Scene *scene, Sequence *seq, float UNUSED(facf0), int x, int y,  ImBuf *ibuf1, ImBuf *out)
+static void do_transform(Scene *scene, Sequence *seq, float UNUSED(facf0), int x, int y,
+                         int start_line, int total_lines, ImBuf *ibuf1, ImBuf *out)
 {
 	TransformVars *transform = (TransformVars *) seq->effectdata;
 	float scale_x, scale_y, translate_x, translate_y, rotate_radians;
@@ -1831,79 +1836,38 @@ static void do_transform(Scene *scene, Sequence *seq, float UNUSED(facf0), int x
 	/* Rotate */
 	rotate_radians = DEG2RADF(transform->rotIni);
 
-	transform_image(x, y, ibuf1, out, scale_x, scale_y, translate_x, translate_y, rotate_radians, transform->interpolation);
+	transform_image(x, y, start_line, total_lines, ibuf1, out, scale_x, scale_y, translate_x, translate_y,
+	                rotate_radians, transform->interpolation);
 }
 
 
-static ImBuf *do_transform_effect(const SeqRenderData *context, Sequence *seq, float UNUSED(cfra), float facf0,
-                                  float UNUSED(facf1), ImBuf *ibuf1, ImBuf *ibuf2, ImBuf *ibuf3)
+static void do_transform_effect(const SeqRenderData *context, Sequence *seq, float UNUSED(cfra), float facf0,
+                                float UNUSED(facf1), ImBuf *ibuf1, ImBuf *UNUSED(ibuf2), ImBuf *UNUSED(ibuf3),
+                                int start_line, int total_lines, ImBuf *out)
 {
-	ImBuf *out = prepare_effect_imbufs(context, ibuf1, ibuf2, ibuf3);
-
-	do_transform(context->scene, seq, facf0, context->rectx, context->recty, ibuf1, out);
-
-	return out;
+	do_transform(context->scene, seq, facf0, context->rectx, context->recty, start_line, total_lines, ibuf1, out);
 }
 
 /*********************** Glow *************************/
 
-static void RVBlurBitmap2_float(float *map, int width, int height, float blur, int quality)
-/*	MUUUCCH better than the previous blur. */
-/*	We do the blurring in two passes which is a whole lot faster. */
-/*	I changed the math arount to implement an actual Gaussian */
-/*	distribution. */
-/* */
-/*	Watch out though, it tends to misbehaven with large blur values on */
-/*	a small bitmap.  Avoid avoid avoid. */
-/*=============================== */
-{
-	float *temp = NULL, *swap;
-	float *filter = NULL;
-	int x, y, i, fx, fy;
-	int index, ix, halfWidth;
-	float fval, k, curColor[3], curColor2[3], weight = 0;
-
-	/* If we're not really blurring, bail out */
-	if (blur <= 0)
-		return;
-
-	/* Allocate memory for the tempmap and the blur filter matrix */
-	temp = MEM_mallocN((width * height * 4 * sizeof(float)), "blurbitmaptemp");
-	if (!temp)
-		return;
-
-	/* Allocate memory for the filter elements */
-	halfWidth = ((quality + 1) * blur);
-	filter = (float *)MEM_mallocN(sizeof(float) * halfWidth * 2, "blurbitmapfilter");
-	if (!filter) {
-		MEM_freeN(temp);
-		return;
-	}
-
-	/* Apparently we're calculating a bell curve based on the standard deviation (or radius)
-	 * This code is based on an example posted to comp.graphics.algorithms by
-	 * Blancmange (bmange@airdmhor.gen.nz)
-	 */
-
-	k = -1.0f / (2.0f * (float)M_PI * blur * blur);
+typedef struct GlowBlurData {
+	const float *map;
+	float *temp;
+	const float *filter;
+	int width, height;
+	int halfWidth;
+} GlowBlurData;
 
-	for (ix = 0; ix < halfWidth; ix++) {
-		weight = (float)exp(k * (ix * ix));
-		filter[halfWidth - ix] = weight;
-		filter[halfWidth + ix] = weight;
-	}
-	filter[0] = weight;
-
-	/* Normalize the array */
-	fval = 0;
-	for (ix = 0; ix < halfWidth * 2; ix++)
-		fval += filter[ix];
-
-	for (ix = 0; ix < halfWidth * 2; ix++)
-		filter[ix] /= fval;
+static void glow_blur_rows(void *data_v, int start_line, int total_lines)
+{
+	GlowBlurData *data = (GlowBlurData *)data_v;
+	const float *map = data->map, *filter = data->filter;
+	float *temp = data->temp;
+	int width = data->width, halfWidth = data->halfWidth;
+	int x, y, i, fx, index;
+	float curColor[3], curColor2[3];
 
-	/* Blur the rows */
-	for (y = 0; y < height; y++) {
+	for (y = start_line; y < start_line + total_lines; y++) {
 		/* Do the left & right strips */
 		for (x = 0; x < halfWidth; x++) {
 			index = (x + y * width) * 4;
@@ -1949,12 +1913,18 @@ static void RVBlurBitmap2_float(float *map, int width, int height, float blur, i
 			temp[index + GlowB] = curColor[2];
 		}
 	}
+}
 
-	/* Swap buffers */
-	swap = temp; temp = map; map = swap;
+static void glow_blur_columns(void *data_v, int start_line, int total_lines)
+{
+	GlowBlurData *data = (GlowBlurData *)data_v;
+	const float *map = data->map, *filter = data->filter;
+	float *temp = data->temp;
+	int width = data->width, height = data->height, halfWidth = data->halfWidth;
+	int x, y, i, fy, index;
+	float curColor[3], curColor2[3];
 
-	/* Blur the columns */
-	for (x = 0; x < width; x++) {
+	for (x = start_line; x < start_line + total_lines; x++) {
 		/* Do the top & bottom strips */
 		for (y = 0; y < halfWidth; y++) {
 			index = (x + y * width) * 4;
@@ -1999,9 +1969,77 @@ static void RVBlurBitmap2_float(float *map, int width, int height, float blur, i
 			temp[index + GlowB] = curColor[2];
 		}
 	}
+}
+
+static void RVBlurBitmap2_float(float *map, int width, int height, float blur, int quality)
+/*	MUUUCCH better than the previous blur. */
+/*	We do the blurring in two passes which is a whole lot faster. */
+/*	I changed the math arount to implement an actual Gaussian */
+/*	distribution. */
+/* */
+/*	Watch out though, it tends to misbehaven with large blur values on */
+/*	a small bitmap.  Avoid avoid avoid. */
+/*=============================== */
+{
+	GlowBlurData data;
+	float *temp = NULL;
+	float *filter = NULL;
+	int ix, halfWidth;
+	float fval, k, weight = 0;
+
+	/* If we're not really blurring, bail out */
+	if (blur <= 0)
+		return;
+
+	/* Allocate memory for the tempmap and the blur filter matrix */
+	temp = MEM_mallocN((width * height * 4 * sizeof(float)), "blurbitmaptemp");
+	if (!temp)
+		return;
+
+	/* Allocate memory for the filter elements */
+	halfWidth = ((quality + 1) * blur);
+	filter = (float *)MEM_mallocN(sizeof(float) * halfWidth * 2, "blurbitmapfilter");
+	if (!filter) {
+		MEM_freeN(temp);
+		return;
+	}
+
+	/* Apparently we're calculating a bell curve based on the standard deviation (or radius)
+	 * This code is based on an example posted to comp.graphics.algorithms by
+	 * Blancmange (bmange@airdmhor.gen.nz)
+	 */
+
+	k = -1.0f / (2.0f * (float)M_PI * blur * blur);
+
+	for (ix = 0; ix < halfWidth; ix++) {
+		weight = (float)exp(k * (ix * ix));
+		filter[halfWidth - ix] = weight;
+		filter[halfWidth + ix] = weight;
+	}
+	filter[0] = weight;
 
-	/* Swap buffers */
-	swap = temp; temp = map; /* map = swap; */ /* UNUSED */
+	/* Normalize the array */
+	fval = 0;
+	for (ix = 0; ix < halfWidth * 2; ix++)
+		fval += filter[ix];
+
+	for (ix = 0; ix < halfWidth * 2; ix++)
+		filter[ix] /= fval;
+
+	data.filter = filter;
+	data.width = width;
+	data.height = height;
+	data.halfWidth = halfWidth;
+
+	/* Blur the rows */
+	data.map = map;
+	data.temp = temp;
+	IMB_processor_apply_threaded_scanlines(height, glow_blur_rows, &data);
+
+	/* Blur the columns, back into the map */
+	data.map = temp;
+	data.temp = map;
+	IMB_processor_apply_threaded_scanlines(width, glow_blur_columns, &data);
 
 	/* Tidy up	 */
 	MEM_freeN(filter);
@@ -3373,7 +3411,8 @@ static struct SeqEffectHandle get_sequence_effect_impl(int seq_type)
 			rval.copy = copy_wipe_effect;
 			rval.early_out = early_out_fade;
 			rval.get_default_fac = get_default_fac_fade;
-			rval.execute = do_wipe_effect;
+			rval.multithreaded = true;
+			rval.execute_slice = do_wipe_effect;
 			break;
 		case SEQ_TYPE_GLOW:
 			rval.init = init_glow_effect;
@@ -3387,7 +3426,8 @@ static struct SeqEffectHandle get_sequence_effect_impl(int seq_type)
 			rval.num_inputs = num_inputs_transform;
 			rval.free = free_transform_effect;
 			rval.copy = copy_transform_effect;
-			rval.execute = do_transform_effect;
+			rval.multithreaded = true;
+			rval.execute_slice = do_transform_effect;
 			break;
 		case SEQ_TYPE_SPEED:
 			rval.init = init_speed_effect;
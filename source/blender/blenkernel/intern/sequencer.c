@@ -1803,27 +1803,12 @@ static ImBuf *seq_proxy_fetch(const SeqRenderData *context, Sequence *seq, int c
 	}
 }
 
-static void seq_proxy_build_frame(
-        const SeqRenderData *context, SeqRenderState *state,
-        Sequence *seq, int cfra,
-        int proxy_render_size, const bool overwrite)
+static void seq_proxy_write_frame(Sequence *seq, ImBuf *ibuf_tmp, int proxy_render_size, const char *name)
 {
-	char name[PROXY_MAXFILE];
 	int quality;
 	int rectx, recty;
 	int ok;
-	ImBuf *ibuf_tmp, *ibuf;
-	Editing *ed = context->scene->ed;
-
-	if (!seq_proxy_get_fname(ed, seq, cfra, proxy_render_size, name, context->view_id)) {
-		return;
-	}
-
-	if (!overwrite && BLI_exists(name)) {
-		return;
-	}
-
-	ibuf_tmp = seq_render_strip(context, state, seq, cfra);
+	ImBuf *ibuf;
 
 	rectx = (proxy_render_size * ibuf_tmp->x) / 100;
 	recty = (proxy_render_size * ibuf_tmp->y) / 100;
@@ -1831,11 +1816,11 @@ static void seq_proxy_build_frame(
 	if (ibuf_tmp->x != rectx || ibuf_tmp->y != recty) {
 		ibuf = IMB_dupImBuf(ibuf_tmp);
 		IMB_metadata_copy(ibuf, ibuf_tmp);
-		IMB_freeImBuf(ibuf_tmp);
 		IMB_scalefastImBuf(ibuf, (short)rectx, (short)recty);
 	}
 	else {
 		ibuf = ibuf_tmp;
+		IMB_refImBuf(ibuf);
 	}
 
 	/* depth = 32 is intentionally left in, otherwise ALPHA channels
@@ -1858,6 +1843,49 @@ static void seq_proxy_build_frame(
 	IMB_freeImBuf(ibuf);
 }
 
+static void seq_proxy_build_frame(
+        const SeqRenderData *context, SeqRenderState *state,
+        Sequence *seq, int cfra,
+        int size_flags, const bool overwrite)
+{
+	const int proxy_sizes[4] = {IMB_PROXY_25, IMB_PROXY_50, IMB_PROXY_75, IMB_PROXY_100};
+	const int proxy_render_sizes[4] = {25, 50, 75, 100};
+	char names[4][PROXY_MAXFILE];
+	bool build[4];
+	int i, build_count = 0;
+	ImBuf *ibuf_tmp;
+	Editing *ed = context->scene->ed;
+
+	for (i = 0; i < 4; i++) {
+		build[i] = (size_flags & proxy_sizes[i]) &&
+		           seq_proxy_get_fname(ed, seq, cfra, proxy_render_sizes[i], names[i], context->view_id) &&
+		           (overwrite || !BLI_exists(names[i]));
+
+		if (build[i]) {
+			build_count++;
+		}
+	}
+
+	if (build_count == 0) {
+		return;
+	}
+
+	/* Render the strip once, and scale it down for every proxy size. */
+	ibuf_tmp = seq_render_strip(context, state, seq, cfra);
+
+	if (ibuf_tmp == NULL) {
+		return;
+	}
+
+	for (i = 0; i < 4; i++) {
+		if (build[i]) {
+			seq_proxy_write_frame(seq, ibuf_tmp, proxy_render_sizes[i], names[i]);
+		}
+	}
+
+	IMB_freeImBuf(ibuf_tmp);
+}
+
 /**
  * Returns whether the file this context would read from even exist,
  * if not, don't create the context
@@ -2032,18 +2060,7 @@ void BKE_sequencer_proxy_rebuild(SeqIndexBuildContext *context, short *stop, sho
 	sequencer_state_init(&state);
 
 	for (cfra = seq->startdisp + seq->startstill;  cfra < seq->enddisp - seq->endstill; cfra++) {
-		if (context->size_flags & IMB_PROXY_25) {
-			seq_proxy_build_frame(&render_context, &state, seq, cfra, 25, overwrite);
-		}
-		if (context->size_flags & IMB_PROXY_50) {
-			seq_proxy_build_frame(&render_context, &state, seq, cfra, 50, overwrite);
-		}
-		if (context->size_flags & IMB_PROXY_75) {
-			seq_proxy_build_frame(&render_context, &state, seq, cfra, 75, overwrite);
-		}
-		if (context->size_flags & IMB_PROXY_100) {
-			seq_proxy_build_frame(&render_context, &state, seq, cfra, 100, overwrite);
-		}
+		seq_proxy_build_frame(&render_context, &state, seq, cfra, context->size_flags, overwrite);
 
 		*progress = (float) (cfra - seq->startdisp - seq->startstill) / (seq->enddisp - seq->endstill - seq->startdisp - seq->startstill);
 		*do_update = true;
@@ -2053,6 +2070,13 @@ void BKE_sequencer_proxy_rebuild(SeqIndexBuildContext *context, short *stop, sho
 	}
 }
 
+/* Movie and image strips build their proxies from their own copy of the strip,
+ * without touching shared state, so several of them can be built at once. */
+bool BKE_sequencer_proxy_rebuild_supports_threads(SeqIndexBuildContext *context)
+{
+	return ELEM(context->seq->type, SEQ_TYPE_MOVIE, SEQ_TYPE_IMAGE);
+}
+
 void BKE_sequencer_proxy_rebuild_finish(SeqIndexBuildContext *context, bool stop)
 {
 	if (context->index_context) {
@@ -3848,6 +3872,42 @@ static ImBuf *seq_render_strip_stack(
 	return out;
 }
 
+/* Render the strip stack through the disk cache. The memory cache is still
+ * checked first, reading a frame from disk is much slower. */
+static ImBuf *seq_render_strip_stack_disk_cached(
+        const SeqRenderData *context, SeqRenderState *state, ListBase *seqbasep,
+        float cfra, int chanshown)
+{
+	Sequence *seq_arr[MAXSEQ + 1];
+	int count;
+	ImBuf *out;
+
+	count = get_shown_sequences(seqbasep, cfra, chanshown, (Sequence **)&seq_arr);
+
+	if (count == 0) {
+		return NULL;
+	}
+
+	out = BKE_sequencer_cache_get(context, seq_arr[count - 1], cfra, SEQ_STRIPELEM_IBUF_COMP);
+
+	if (out) {
+		return out;
+	}
+
+	out = BKE_sequencer_disk_cache_get(context, seqbasep, cfra, chanshown);
+
+	if (out) {
+		BKE_sequencer_cache_put(context, seq_arr[count - 1], cfra, SEQ_STRIPELEM_IBUF_COMP, out);
+		return out;
+	}
+
+	out = seq_render_strip_stack(context, state, seqbasep, cfra, chanshown);
+
+	BKE_sequencer_disk_cache_put(context, seqbasep, cfra, chanshown, out);
+
+	return out;
+}
+
 /*
  * returned ImBuf is refed!
  * you have to free after usage!
@@ -3872,6 +3932,10 @@ ImBuf *BKE_sequencer_give_ibuf(const SeqRenderData *context, float cfra, int cha
 	SeqRenderState state;
 	sequencer_state_init(&state);
 
+	if (ed->cache_flag & SEQ_CACHE_DISK) {
+		return seq_render_strip_stack_disk_cached(context, &state, seqbasep, cfra, chanshown);
+	}
+
 	return seq_render_strip_stack(context, &state, seqbasep, cfra, chanshown);
 }
 
@@ -3889,159 +3953,171 @@ ImBuf *BKE_sequencer_give_ibuf_direct(const SeqRenderData *context, float cfra,
 	SeqRenderState state;
 	sequencer_state_init(&state);
 
+	BKE_sequencer_prefetch_stop();
+
 	return seq_render_strip(context, &state, seq, cfra);
 }
 
 /* *********************** threading api ******************* */
 
-static ListBase running_threads;
+/* Frames ahead of playback are rendered by a single prefetch thread, the
+ * results end up in the sequencer cache where the main thread picks them up.
+ * Rendering itself is not thread safe, so the prefetch thread and the main
+ * thread take turns through seq_render_lock. */
+
+typedef struct PrefetchQueueElem {
+	struct PrefetchQueueElem *next, *prev;
+
+	SeqRenderData context;
+	float cfra;
+	int chanshown;
+} PrefetchQueueElem;
+
 static ListBase prefetch_wait;
-static ListBase prefetch_done;
 
 static pthread_mutex_t queue_lock          = PTHREAD_MUTEX_INITIALIZER;
-static pthread_mutex_t wakeup_lock         = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t wakeup_cond          = PTHREAD_COND_INITIALIZER;
+static pthread_mutex_t seq_render_lock     = PTHREAD_MUTEX_INITIALIZER;
 
-//static pthread_mutex_t prefetch_ready_lock = PTHREAD_MUTEX_INITIALIZER;
-//static pthread_cond_t  prefetch_ready_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t prefetch_thread;
+static bool prefetch_running = false;
+static volatile bool seq_thread_shutdown = false;
 
-static pthread_mutex_t frame_done_lock     = PTHREAD_MUTEX_INITIALIZER;
-static pthread_cond_t frame_done_cond      = PTHREAD_COND_INITIALIZER;
+static bool prefetch_is_supported(Scene *scene)
+{
+	Editing *ed = scene->ed;
+	Sequence *seq;
+	bool supported = true;
 
-static volatile bool seq_thread_shutdown = true; 
-static volatile int seq_last_given_monoton_cfra = 0;
-static int monoton_cfra = 0;
+	/* Strips are not animated for the prefetched frames. */
+	if (scene->adt && (scene->adt->action || scene->adt->drivers.first)) {
+		return false;
+	}
 
-typedef struct PrefetchThread {
-	struct PrefetchThread *next, *prev;
-	
-	Scene *scene;
-	struct PrefetchQueueElem *current;
-	pthread_t pthread;
-	int running;
-	
-} PrefetchThread;
+	SEQ_BEGIN (ed, seq)
+	{
+		if (ELEM(seq->type, SEQ_TYPE_SCENE, SEQ_TYPE_TEXT, SEQ_TYPE_MOVIECLIP)) {
+			supported = false;
+		}
+	}
+	SEQ_END
 
-typedef struct PrefetchQueueElem {
-	struct PrefetchQueueElem *next, *prev;
-	
-	int rectx;
-	int recty;
-	float cfra;
-	int chanshown;
-	int preview_render_size;
+	return supported;
+}
 
-	int monoton_cfra;
+static void *seq_prefetch_thread(void *UNUSED(data))
+{
+	pthread_mutex_lock(&queue_lock);
 
-	ImBuf *ibuf;
-} PrefetchQueueElem;
+	while (!seq_thread_shutdown) {
+		PrefetchQueueElem *e = BLI_pophead(&prefetch_wait);
 
-void BKE_sequencer_give_ibuf_prefetch_request(const SeqRenderData *context, float cfra, int chanshown)
+		if (e == NULL) {
+			pthread_cond_wait(&wakeup_cond, &queue_lock);
+			continue;
+		}
+
+		pthread_mutex_unlock(&queue_lock);
+
+		pthread_mutex_lock(&seq_render_lock);
+		if (!seq_thread_shutdown) {
+			ImBuf *ibuf = BKE_sequencer_give_ibuf(&e->context, e->cfra, e->chanshown);
+
+			if (ibuf) {
+				IMB_freeImBuf(ibuf);
+			}
+		}
+		pthread_mutex_unlock(&seq_render_lock);
+
+		MEM_freeN(e);
+
+		pthread_mutex_lock(&queue_lock);
+	}
+
+	pthread_mutex_unlock(&queue_lock);
+
+	return NULL;
+}
+
+void BKE_sequencer_prefetch_stop(void)
 {
-	PrefetchQueueElem *e;
-	if (seq_thread_shutdown) {
+	if (!prefetch_running || pthread_equal(pthread_self(), prefetch_thread)) {
 		return;
 	}
 
-	e = MEM_callocN(sizeof(PrefetchQueueElem), "prefetch_queue_elem");
-	e->rectx = context->rectx;
-	e->recty = context->recty;
-	e->cfra = cfra;
-	e->chanshown = chanshown;
-	e->preview_render_size = context->preview_render_size;
-	e->monoton_cfra = monoton_cfra++;
-
 	pthread_mutex_lock(&queue_lock);
-	BLI_addtail(&prefetch_wait, e);
-	pthread_mutex_unlock(&queue_lock);
-	
-	pthread_mutex_lock(&wakeup_lock);
+	seq_thread_shutdown = true;
+	BLI_freelistN(&prefetch_wait);
 	pthread_cond_signal(&wakeup_cond);
-	pthread_mutex_unlock(&wakeup_lock);
+	pthread_mutex_unlock(&queue_lock);
+
+	pthread_join(prefetch_thread, NULL);
+
+	prefetch_running = false;
+	seq_thread_shutdown = false;
 }
 
-ImBuf *BKE_sequencer_give_ibuf_threaded(const SeqRenderData *context, float cfra, int chanshown)
+void BKE_sequencer_give_ibuf_prefetch_request(const SeqRenderData *context, float cfra, int chanshown)
 {
-	PrefetchQueueElem *e = NULL;
-	bool found_something = false;
+	PrefetchQueueElem *e;
 
-	if (seq_thread_shutdown) {
-		return BKE_sequencer_give_ibuf(context, cfra, chanshown);
+	if (context->skip_cache || context->is_proxy_render || context->scene->ed == NULL) {
+		return;
 	}
 
-	while (!e) {
-		bool success = false;
-		pthread_mutex_lock(&queue_lock);
-
-		for (e = prefetch_done.first; e; e = e->next) {
-			if (cfra == e->cfra &&
-			    chanshown == e->chanshown &&
-			    context->rectx == e->rectx &&
-			    context->recty == e->recty &&
-			    context->preview_render_size == e->preview_render_size)
-			{
-				success = true;
-				found_something = true;
-				break;
-			}
+	if (!prefetch_running) {
+		if (!prefetch_is_supported(context->scene)) {
+			return;
 		}
-
-		if (!e) {
-			for (e = prefetch_wait.first; e; e = e->next) {
-				if (cfra == e->cfra &&
-				    chanshown == e->chanshown &&
-				    context->rectx == e->rectx &&
-				    context->recty == e->recty &&
-				    context->preview_render_size == e->preview_render_size)
-				{
-					found_something = true;
-					break;
-				}
-			}
+		if (pthread_create(&prefetch_thread, NULL, seq_prefetch_thread, NULL) != 0) {
+			return;
 		}
+		prefetch_running = true;
+	}
 
-		if (!e) {
-			PrefetchThread *tslot;
+	pthread_mutex_lock(&queue_lock);
 
-			for (tslot = running_threads.first;
-			     tslot;
-			     tslot = tslot->next)
-			{
-				if (tslot->current &&
-				    cfra == tslot->current->cfra &&
-				    chanshown == tslot->current->chanshown &&
-				    context->rectx == tslot->current->rectx &&
-				    context->recty == tslot->current->recty &&
-				    context->preview_render_size == tslot->current->preview_render_size)
-				{
-					found_something = true;
-					break;
-				}
-			}
+	for (e = prefetch_wait.first; e; e = e->next) {
+		if (cfra == e->cfra &&
+		    chanshown == e->chanshown &&
+		    memcmp(context, &e->context, sizeof(SeqRenderData)) == 0)
+		{
+			break;
 		}
+	}
 
-		/* e->ibuf is unrefed by render thread on next round. */
+	if (e == NULL) {
+		e = MEM_callocN(sizeof(PrefetchQueueElem), "prefetch_queue_elem");
+		e->context = *context;
+		e->cfra = cfra;
+		e->chanshown = chanshown;
 
-		if (e) {
-			seq_last_given_monoton_cfra = e->monoton_cfra;
-		}
+		BLI_addtail(&prefetch_wait, e);
+		pthread_cond_signal(&wakeup_cond);
+	}
 
-		pthread_mutex_unlock(&queue_lock);
+	pthread_mutex_unlock(&queue_lock);
+}
 
-		if (!success) {
-			e = NULL;
+ImBuf *BKE_sequencer_give_ibuf_threaded(const SeqRenderData *context, float cfra, int chanshown)
+{
+	ImBuf *ibuf;
 
-			if (!found_something) {
-				fprintf(stderr, "SEQ-THREAD: Requested frame not in queue ???\n");
-				break;
-			}
-			pthread_mutex_lock(&frame_done_lock);
-			pthread_cond_wait(&frame_done_cond, &frame_done_lock);
-			pthread_mutex_unlock(&frame_done_lock);
-		}
+	if (!prefetch_running) {
+		return BKE_sequencer_give_ibuf(context, cfra, chanshown);
 	}
-	
-	return e ? e->ibuf : NULL;
+
+	/* Requests are queued again for every drawn frame, drop the stale ones so
+	 * the prefetch thread does not fall behind playback. */
+	pthread_mutex_lock(&queue_lock);
+	BLI_freelistN(&prefetch_wait);
+	pthread_mutex_unlock(&queue_lock);
+
+	pthread_mutex_lock(&seq_render_lock);
+	ibuf = BKE_sequencer_give_ibuf(context, cfra, chanshown);
+	pthread_mutex_unlock(&seq_render_lock);
+
+	return ibuf;
 }
 
 /* check whether sequence cur depends on seq */
@@ -4093,6 +4169,8 @@ static void sequence_invalidate_cache(Scene *scene, Sequence *seq, bool invalida
 {
 	Editing *ed = scene->ed;
 
+	BKE_sequencer_prefetch_stop();
+
 	/* invalidate cache for current sequence */
 	if (invalidate_self) {
 		/* Animation structure holds some buffers inside,
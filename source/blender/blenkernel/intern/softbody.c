@@ -3261,9 +3261,9 @@ static void softbody_to_object(Object *ob, float (*vertexCos)[3], int numVerts,
 
 		for (a=0; a<numVerts; a++, bp++) {
 			copy_v3_v3(vertexCos[a], bp->pos);
-			if (local==0)
-				mul_m4_v3(ob->imat, vertexCos[a]);	/* softbody is in global coords, baked optionally not */
 		}
+		if (local==0)
+			mul_m4_v3_array(ob->imat, vertexCos, numVerts);	/* softbody is in global coords, baked optionally not */
 	}
 }
 
@@ -54,6 +54,7 @@
 #include "BLI_bitmap.h"
 #include "BLI_blenlib.h"
 #include "BLI_edgehash.h"
+#include "BLI_hash_mm2a.h"
 #include "BLI_math.h"
 #include "BLI_memarena.h"
 #include "BLI_threads.h"
@@ -801,6 +802,9 @@ static void ss_sync_from_derivedmesh(CCGSubSurf *ss,
 	UNUSED_VARS(use_subdiv_uvs);
 #endif
 
+	/* Callers which know the topology set the hash again after syncing. */
+	ccgSubSurf_setTopologyHash(ss, 0);
+
 #ifdef WITH_OPENSUBDIV
 	/* Reset all related descriptors if actual mesh topology changed or if
 	 * other evaluation-related settings changed.
@@ -818,6 +822,78 @@ static void ss_sync_from_derivedmesh(CCGSubSurf *ss,
 	}
 }
 
+/* Hash everything a full sync stores besides vertex coordinates: connectivity,
+ * creases and original indices. Never returns zero, which means unknown. */
+static unsigned int ss_topology_hash_from_derivedmesh(DerivedMesh *dm, int levels, int use_flat_subdiv)
+{
+	BLI_HashMurmur2A mm2;
+	MEdge *medge = dm->getEdgeArray(dm);
+	MLoop *mloop = dm->getLoopArray(dm);
+	MPoly *mpoly = dm->getPolyArray(dm);
+	const int totvert = dm->getNumVerts(dm);
+	const int totedge = dm->getNumEdges(dm);
+	const int totloop = dm->getNumLoops(dm);
+	const int totpoly = dm->getNumPolys(dm);
+	const int *index;
+	unsigned int hash;
+	int i;
+
+	BLI_hash_mm2a_init(&mm2, 0);
+	BLI_hash_mm2a_add_int(&mm2, levels);
+	BLI_hash_mm2a_add_int(&mm2, use_flat_subdiv);
+	BLI_hash_mm2a_add_int(&mm2, totvert);
+	BLI_hash_mm2a_add_int(&mm2, totedge);
+	BLI_hash_mm2a_add_int(&mm2, totloop);
+	BLI_hash_mm2a_add_int(&mm2, totpoly);
+
+	for (i = 0; i < totedge; i++) {
+		BLI_hash_mm2a_add_int(&mm2, medge[i].v1);
+		BLI_hash_mm2a_add_int(&mm2, medge[i].v2);
+		if (!use_flat_subdiv) {
+			BLI_hash_mm2a_add_int(&mm2, medge[i].crease);
+		}
+	}
+	for (i = 0; i < totloop; i++) {
+		BLI_hash_mm2a_add_int(&mm2, mloop[i].v);
+	}
+	for (i = 0; i < totpoly; i++) {
+		BLI_hash_mm2a_add_int(&mm2, mpoly[i].loopstart);
+		BLI_hash_mm2a_add_int(&mm2, mpoly[i].totloop);
+	}
+
+	if ((index = dm->getVertDataArray(dm, CD_ORIGINDEX))) {
+		BLI_hash_mm2a_add(&mm2, (const unsigned char *)index, sizeof(*index) * totvert);
+	}
+	if ((index = dm->getEdgeDataArray(dm, CD_ORIGINDEX))) {
+		BLI_hash_mm2a_add(&mm2, (const unsigned char *)index, sizeof(*index) * totedge);
+	}
+	if ((index = dm->getPolyDataArray(dm, CD_ORIGINDEX))) {
+		BLI_hash_mm2a_add(&mm2, (const unsigned char *)index, sizeof(*index) * totpoly);
+	}
+
+	hash = BLI_hash_mm2a_end(&mm2);
+	return hash ? hash : 1;
+}
+
+/* Only update the vertex coordinates of an already synced subsurf, the
+ * partial sync then re-evaluates the faces around the moved vertices. */
+static void ss_sync_ccg_coords_from_derivedmesh(CCGSubSurf *ss,
+                                                DerivedMesh *dm,
+                                                float (*vertexCos)[3])
+{
+	MVert *mvert = dm->getVertArray(dm);
+	int totvert = dm->getNumVerts(dm);
+	int i;
+
+	ccgSubSurf_initPartialSync(ss);
+
+	for (i = 0; i < totvert; i++) {
+		ccgSubSurf_syncVert(ss, SET_INT_IN_POINTER(i), vertexCos ? vertexCos[i] : mvert[i].co, 0, NULL);
+	}
+
+	ccgSubSurf_processSync(ss);
+}
+
 /***/
 
 static int ccgDM_getVertMapIndex(CCGSubSurf *ss, CCGVert *v)
@@ -4878,8 +4954,24 @@ struct DerivedMesh *subsurf_make_derived_from_derived(
 		else {
 			CCGFlags ccg_flags = useSimple | CCG_USE_ARENA | CCG_CALC_NORMALS;
 			CCGSubSurf *prevSS = NULL;
+			unsigned int topology_hash = 0;
+
+			/* Deforming-only animation keeps the topology, in which case the
+			 * cached subsurf is kept and only its vertex coordinates are
+			 * synced. Paint masks change the vertex data layout. */
+			if ((flags & SUBSURF_IS_FINAL_CALC) &&
+			    (flags & SUBSURF_ALLOC_PAINT_MASK) == 0 &&
+			    !use_gpu_backend)
+			{
+				topology_hash = ss_topology_hash_from_derivedmesh(dm, levels, useSimple);
+			}
 
-			if (smd->mCache && (flags & SUBSURF_IS_FINAL_CALC)) {
+			if (smd->mCache && topology_hash != 0 &&
+			    ccgSubSurf_getTopologyHash(smd->mCache) == topology_hash)
+			{
+				prevSS = smd->mCache;
+			}
+			else if (smd->mCache && (flags & SUBSURF_IS_FINAL_CALC)) {
 #ifdef WITH_OPENSUBDIV
 				/* With OpenSubdiv enabled we always tries to re-use previos
 				 * subsurf structure in order to save computation time since
@@ -4909,7 +5001,13 @@ struct DerivedMesh *subsurf_make_derived_from_derived(
 #ifdef WITH_OPENSUBDIV
 			ccgSubSurf_setSkipGrids(ss, use_gpu_backend);
 #endif
-			ss_sync_from_derivedmesh(ss, dm, vertCos, useSimple, useSubsurfUv);
+			if (topology_hash != 0 && ccgSubSurf_getTopologyHash(ss) == topology_hash) {
+				ss_sync_ccg_coords_from_derivedmesh(ss, dm, vertCos);
+			}
+			else {
+				ss_sync_from_derivedmesh(ss, dm, vertCos, useSimple, useSubsurfUv);
+				ccgSubSurf_setTopologyHash(ss, topology_hash);
+			}
 
 			result = getCCGDerivedMesh(ss, drawInteriorEdges, useSubsurfUv, dm, use_gpu_backend);
 
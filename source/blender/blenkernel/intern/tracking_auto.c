@@ -38,6 +38,7 @@
 
 #include "BLI_utildefines.h"
 #include "BLI_listbase.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_math.h"
 
@@ -379,84 +380,109 @@ AutoTrackContext *BKE_autotrack_context_new(MovieClip *clip,
 	return context;
 }
 
-bool BKE_autotrack_context_step(AutoTrackContext *context)
+typedef struct AutoTrackStepData {
+	AutoTrackContext *context;
+	int frame_delta;
+	bool ok;
+} AutoTrackStepData;
+
+static void autotrack_context_step_cb(void *__restrict userdata,
+                                      const int track)
 {
-	int frame_delta = context->backwards ? -1 : 1;
-	bool ok = false;
-	int track;
-
-#pragma omp parallel for if (context->num_tracks > 1)
-	for (track = 0; track < context->num_tracks; ++track) {
-		AutoTrackOptions *options = &context->options[track];
-		if (options->is_failed) {
-			continue;
-		}
-		libmv_Marker libmv_current_marker,
-		             libmv_reference_marker,
-		             libmv_tracked_marker;
-		libmv_TrackRegionResult libmv_result;
-		int frame = BKE_movieclip_remap_scene_to_clip_frame(
-			context->clips[options->clip_index],
-			context->user.framenr);
-		bool has_marker;
-
-		BLI_spin_lock(&context->spin_lock);
-		has_marker = libmv_autoTrackGetMarker(context->autotrack,
-		                                      options->clip_index,
-		                                      frame,
-		                                      options->track_index,
-		                                      &libmv_current_marker);
-		BLI_spin_unlock(&context->spin_lock);
-
-		if (has_marker) {
-			if (!tracking_check_marker_margin(&libmv_current_marker,
-			                                  options->track->margin,
-			                                  context->frame_width,
-			                                  context->frame_height))
-			{
-				continue;
-			}
+	AutoTrackStepData *data = userdata;
+	AutoTrackContext *context = data->context;
+	const int frame_delta = data->frame_delta;
 
-			libmv_tracked_marker = libmv_current_marker;
-			libmv_tracked_marker.frame = frame + frame_delta;
+	AutoTrackOptions *options = &context->options[track];
+	if (options->is_failed) {
+		return;
+	}
+	libmv_Marker libmv_current_marker,
+	             libmv_reference_marker,
+	             libmv_tracked_marker;
+	libmv_TrackRegionResult libmv_result;
+	int frame = BKE_movieclip_remap_scene_to_clip_frame(
+		context->clips[options->clip_index],
+		context->user.framenr);
+	bool has_marker;
 
-			if (options->use_keyframe_match) {
-				libmv_tracked_marker.reference_frame =
-					libmv_current_marker.reference_frame;
-				libmv_autoTrackGetMarker(context->autotrack,
-			                             options->clip_index,
-			                             libmv_tracked_marker.reference_frame,
-			                             options->track_index,
-			                             &libmv_reference_marker);
-			}
-			else {
-				libmv_tracked_marker.reference_frame = frame;
-				libmv_reference_marker = libmv_current_marker;
-			}
+	BLI_spin_lock(&context->spin_lock);
+	has_marker = libmv_autoTrackGetMarker(context->autotrack,
+	                                      options->clip_index,
+	                                      frame,
+	                                      options->track_index,
+	                                      &libmv_current_marker);
+	BLI_spin_unlock(&context->spin_lock);
 
-			if (libmv_autoTrackMarker(context->autotrack,
-			                          &options->track_region_options,
-			                          &libmv_tracked_marker,
-			                          &libmv_result))
-			{
-				BLI_spin_lock(&context->spin_lock);
-				libmv_autoTrackAddMarker(context->autotrack,
-				                         &libmv_tracked_marker);
-				BLI_spin_unlock(&context->spin_lock);
-			}
-			else {
-				options->is_failed = true;
-				options->failed_frame = frame + frame_delta;
-			}
-			ok = true;
+	if (has_marker) {
+		if (!tracking_check_marker_margin(&libmv_current_marker,
+		                                  options->track->margin,
+		                                  context->frame_width,
+		                                  context->frame_height))
+		{
+			return;
+		}
+
+		libmv_tracked_marker = libmv_current_marker;
+		libmv_tracked_marker.frame = frame + frame_delta;
+
+		if (options->use_keyframe_match) {
+			libmv_tracked_marker.reference_frame =
+				libmv_current_marker.reference_frame;
+			/* Other tracks add markers concurrently, so guard the lookup. */
+			BLI_spin_lock(&context->spin_lock);
+			libmv_autoTrackGetMarker(context->autotrack,
+			                         options->clip_index,
+			                         libmv_tracked_marker.reference_frame,
+			                         options->track_index,
+			                         &libmv_reference_marker);
+			BLI_spin_unlock(&context->spin_lock);
+		}
+		else {
+			libmv_tracked_marker.reference_frame = frame;
+			libmv_reference_marker = libmv_current_marker;
+		}
+
+		if (libmv_autoTrackMarker(context->autotrack,
+		                          &options->track_region_options,
+		                          &libmv_tracked_marker,
+		                          &libmv_result))
+		{
+			BLI_spin_lock(&context->spin_lock);
+			libmv_autoTrackAddMarker(context->autotrack,
+			                         &libmv_tracked_marker);
+			BLI_spin_unlock(&context->spin_lock);
+		}
+		else {
+			options->is_failed = true;
+			options->failed_frame = frame + frame_delta;
 		}
+
+		/* Only ever set to true, so the concurrent writes are harmless. */
+		data->ok = true;
 	}
+}
+
+bool BKE_autotrack_context_step(AutoTrackContext *context)
+{
+	AutoTrackStepData data;
+
+	data.context = context;
+	data.frame_delta = context->backwards ? -1 : 1;
+	data.ok = false;
+
+	/* Tracks are independent within a frame, shared autotrack state is
+	 * guarded by the spin lock. */
+	BLI_task_parallel_range(0, context->num_tracks,
+	                        &data,
+	                        autotrack_context_step_cb,
+	                        context->num_tracks > 1);
 
 	BLI_spin_lock(&context->spin_lock);
-	context->user.framenr += frame_delta;
+	context->user.framenr += data.frame_delta;
 	BLI_spin_unlock(&context->spin_lock);
 
-	return ok;
+	return data.ok;
 }
 
 void BKE_autotrack_context_sync(AutoTrackContext *context)
@@ -31,6 +31,7 @@
 #include <stdio.h>
 
 #include <stdlib.h>
+#include <pthread.h>
 
 #include <libavformat/avformat.h>
 #include <libavcodec/avcodec.h>
@@ -43,6 +44,7 @@
 #include "DNA_scene_types.h"
 
 #include "BLI_blenlib.h"
+#include "BLI_threads.h"
 
 #ifdef WITH_AUDASPACE
 #  include AUD_DEVICE_H
@@ -97,10 +99,35 @@ typedef struct FFMpegContext {
 #ifdef WITH_AUDASPACE
 	AUD_Device *audio_mixdown_device;
 #endif
+
+	/* Frames are converted to the codec pixel format and encoded on a
+	 * separate thread, so rendering of the next frame doesn't wait for it. */
+	pthread_t encode_thread;
+	ThreadMutex encode_lock;
+	ThreadCondition encode_cond;
+	ListBase encode_queue;
+	int encode_queue_len;
+	bool encode_running;
+	bool encode_stop;
+	bool encode_error;
+	bool encode_autosplit;
 } FFMpegContext;
 
+/* Frame waiting to be encoded, in BGR32 and already flipped. */
+typedef struct FFMpegQueueFrame {
+	struct FFMpegQueueFrame *next, *prev;
+	AVFrame *frame;
+	int mode;
+	int cfra;
+	double audio_pts;
+} FFMpegQueueFrame;
+
 #define FFMPEG_AUTOSPLIT_SIZE 2000000000
 
+/* Maximum number of frames waiting for the encoder, rendering blocks when
+ * the queue is full so memory usage stays bounded. */
+#define FFMPEG_QUEUE_SIZE 4
+
 #define PRINT if (G.debug & G_DEBUG_FFMPEG) printf
 
 static void ffmpeg_dict_set_int(AVDictionary **dict, const char *key, int value);
@@ -310,7 +337,7 @@ static const char **get_file_extensions(int format)
 }
 
 /* Write a frame to the output file */
-static int write_video_frame(FFMpegContext *context, RenderData *rd, int cfra, AVFrame *frame, ReportList *reports)
+static int write_video_frame(FFMpegContext *context, int mode, int cfra, AVFrame *frame)
 {
 	int got_output;
 	int ret, success = 1;
@@ -321,8 +348,8 @@ static int write_video_frame(FFMpegContext *context, RenderData *rd, int cfra, A
 
 	frame->pts = cfra;
 
-	if (rd->mode & R_FIELDS) {
-		frame->top_field_first = ((rd->mode & R_ODDFIELD) != 0);
+	if (mode & R_FIELDS) {
+		frame->top_field_first = ((mode & R_ODDFIELD) != 0);
 	}
 
 	ret = avcodec_encode_video2(c, &packet, frame, &got_output);
@@ -351,61 +378,34 @@ static int write_video_frame(FFMpegContext *context, RenderData *rd, int cfra, A
 		success = 0;
 	}
 
-	if (!success)
-		BKE_report(reports, RPT_ERROR, "Error writing frame");
-
 	return success;
 }
 
-/* read and encode a frame of audio from the buffer */
-static AVFrame *generate_video_frame(FFMpegContext *context, uint8_t *pixels, ReportList *reports)
-{
-	uint8_t *rendered_frame;
+typedef struct FlipFrameData {
+	const uint8_t *src;
+	uint8_t *dst;
+	int width, height;
+} FlipFrameData;
 
-	AVCodecContext *c = context->video_stream->codec;
-	int width = c->width;
-	int height = c->height;
-	AVFrame *rgb_frame;
-
-	if (c->pix_fmt != AV_PIX_FMT_BGR32) {
-		rgb_frame = alloc_picture(AV_PIX_FMT_BGR32, width, height);
-		if (!rgb_frame) {
-			BKE_report(reports, RPT_ERROR, "Could not allocate temporary frame");
-			return NULL;
-		}
-	}
-	else {
-		rgb_frame = context->current_frame;
-	}
-
-	rendered_frame = pixels;
+static void flip_frame_scanlines(void *data_v, int start_scanline, int num_scanlines)
+{
+	FlipFrameData *data = data_v;
+	const int width = data->width;
+	const int height = data->height;
+	int y;
 
 	/* Do RGBA-conversion and flipping in one step depending
 	 * on CPU-Endianess */
 
-	if (ENDIAN_ORDER == L_ENDIAN) {
-		int y;
-		for (y = 0; y < height; y++) {
-			uint8_t *target = rgb_frame->data[0] + width * 4 * (height - y - 1);
-			uint8_t *src = rendered_frame + width * 4 * y;
-			uint8_t *end = src + width * 4;
-			while (src != end) {
-				target[3] = src[3];
-				target[2] = src[2];
-				target[1] = src[1];
-				target[0] = src[0];
+	for (y = start_scanline; y < start_scanline + num_scanlines; y++) {
+		uint8_t *target = data->dst + width * 4 * (height - y - 1);
+		const uint8_t *src = data->src + width * 4 * y;
+		const uint8_t *end = src + width * 4;
 
-				target += 4;
-				src += 4;
-			}
+		if (ENDIAN_ORDER == L_ENDIAN) {
+			memcpy(target, src, width * 4);
 		}
-	}
-	else {
-		int y;
-		for (y = 0; y < height; y++) {
-			uint8_t *target = rgb_frame->data[0] + width * 4 * (height - y - 1);
-			uint8_t *src = rendered_frame + width * 4 * y;
-			uint8_t *end = src + width * 4;
+		else {
 			while (src != end) {
 				target[3] = src[0];
 				target[2] = src[1];
@@ -417,17 +417,53 @@ static AVFrame *generate_video_frame(FFMpegContext *context, uint8_t *pixels, Re
 			}
 		}
 	}
+}
 
-	if (c->pix_fmt != AV_PIX_FMT_BGR32) {
-		sws_scale(context->img_convert_ctx, (const uint8_t *const *) rgb_frame->data,
-		          rgb_frame->linesize, 0, c->height,
-		          context->current_frame->data, context->current_frame->linesize);
-		delete_picture(rgb_frame);
+/* Copy the rendered pixels into a new BGR32 frame, the conversion to the
+ * codec pixel format happens on the encoder thread. */
+static AVFrame *generate_video_frame(FFMpegContext *context, uint8_t *pixels, ReportList *reports)
+{
+	AVCodecContext *c = context->video_stream->codec;
+	int width = c->width;
+	int height = c->height;
+	AVFrame *rgb_frame;
+	FlipFrameData data;
+
+	rgb_frame = alloc_picture(AV_PIX_FMT_BGR32, width, height);
+	if (!rgb_frame) {
+		BKE_report(reports, RPT_ERROR, "Could not allocate temporary frame");
+		return NULL;
+	}
+
+	data.src = pixels;
+	data.dst = rgb_frame->data[0];
+	data.width = width;
+	data.height = height;
+	IMB_processor_apply_threaded_scanlines(height, flip_frame_scanlines, &data);
+
+	rgb_frame->format = AV_PIX_FMT_BGR32;
+	rgb_frame->width = width;
+	rgb_frame->height = height;
+
+	return rgb_frame;
+}
+
+/* Convert a BGR32 frame to the codec pixel format, on the encoder thread. */
+static AVFrame *convert_video_frame(FFMpegContext *context, AVFrame *rgb_frame)
+{
+	AVCodecContext *c = context->video_stream->codec;
+
+	if (c->pix_fmt == AV_PIX_FMT_BGR32) {
+		return rgb_frame;
 	}
 
-	context->current_frame->format = AV_PIX_FMT_BGR32;
-	context->current_frame->width = width;
-	context->current_frame->height = height;
+	sws_scale(context->img_convert_ctx, (const uint8_t *const *) rgb_frame->data,
+	          rgb_frame->linesize, 0, c->height,
+	          context->current_frame->data, context->current_frame->linesize);
+
+	context->current_frame->format = c->pix_fmt;
+	context->current_frame->width = c->width;
+	context->current_frame->height = c->height;
 
 	return context->current_frame;
 }
@@ -1167,6 +1203,8 @@ int BKE_ffmpeg_start(void *context_v, struct Scene *scene, RenderData *rd, int r
 
 	context->ffmpeg_autosplit_count = 0;
 	context->ffmpeg_preview = preview;
+	context->encode_error = false;
+	context->encode_autosplit = false;
 
 	success = start_ffmpeg_impl(context, rd, rectx, recty, suffix, reports);
 #ifdef WITH_AUDASPACE
@@ -1223,11 +1261,133 @@ static void write_audio_frames(FFMpegContext *context, double to_pts)
 }
 #endif
 
+/* Encode a queued frame, returns false on failure. */
+static bool ffmpeg_encode_frame(FFMpegContext *context, FFMpegQueueFrame *qframe)
+{
+	AVFrame *avframe = convert_video_frame(context, qframe->frame);
+	bool success = write_video_frame(context, qframe->mode, qframe->cfra, avframe);
+
+#ifdef WITH_AUDASPACE
+	write_audio_frames(context, qframe->audio_pts);
+#endif
+
+	return success;
+}
+
+static void *ffmpeg_encode_thread(void *context_v)
+{
+	FFMpegContext *context = context_v;
+	FFMpegQueueFrame *qframe;
+
+	BLI_mutex_lock(&context->encode_lock);
+
+	while (true) {
+		bool success, autosplit;
+
+		while (!context->encode_stop && BLI_listbase_is_empty(&context->encode_queue)) {
+			BLI_condition_wait(&context->encode_cond, &context->encode_lock);
+		}
+
+		/* Remaining frames are still encoded when stopping. */
+		qframe = BLI_pophead(&context->encode_queue);
+		if (qframe == NULL) {
+			break;
+		}
+		context->encode_queue_len--;
+		BLI_condition_notify_all(&context->encode_cond);
+
+		/* Once encoding failed, the remaining frames are dropped. */
+		if (context->encode_error) {
+			delete_picture(qframe->frame);
+			MEM_freeN(qframe);
+			continue;
+		}
+
+		BLI_mutex_unlock(&context->encode_lock);
+
+		success = ffmpeg_encode_frame(context, qframe);
+		autosplit = (context->ffmpeg_autosplit && avio_tell(context->outfile->pb) > FFMPEG_AUTOSPLIT_SIZE);
+
+		delete_picture(qframe->frame);
+		MEM_freeN(qframe);
+
+		BLI_mutex_lock(&context->encode_lock);
+
+		if (!success) {
+			context->encode_error = true;
+		}
+		/* The file is split by the render thread, before the next frame. */
+		if (autosplit) {
+			context->encode_autosplit = true;
+		}
+	}
+
+	BLI_mutex_unlock(&context->encode_lock);
+
+	return NULL;
+}
+
+/* Queue a frame for the encoder thread, blocks while the queue is full.
+ * Returns false when encoding of an earlier frame failed. */
+static bool ffmpeg_encode_push(FFMpegContext *context, FFMpegQueueFrame *qframe)
+{
+	bool success;
+
+	if (!context->encode_running) {
+		context->encode_stop = false;
+
+		if (pthread_create(&context->encode_thread, NULL, ffmpeg_encode_thread, context) != 0) {
+			success = ffmpeg_encode_frame(context, qframe);
+			delete_picture(qframe->frame);
+			MEM_freeN(qframe);
+			return success;
+		}
+
+		context->encode_running = true;
+	}
+
+	BLI_mutex_lock(&context->encode_lock);
+
+	while (context->encode_queue_len >= FFMPEG_QUEUE_SIZE) {
+		BLI_condition_wait(&context->encode_cond, &context->encode_lock);
+	}
+
+	BLI_addtail(&context->encode_queue, qframe);
+	context->encode_queue_len++;
+	BLI_condition_notify_all(&context->encode_cond);
+
+	success = !context->encode_error;
+
+	BLI_mutex_unlock(&context->encode_lock);
+
+	return success;
+}
+
+/* Wait for all queued frames to be encoded and stop the encoder thread. */
+static void ffmpeg_encode_thread_end(FFMpegContext *context)
+{
+	if (!context->encode_running) {
+		return;
+	}
+
+	BLI_mutex_lock(&context->encode_lock);
+	context->encode_stop = true;
+	BLI_condition_notify_all(&context->encode_cond);
+	BLI_mutex_unlock(&context->encode_lock);
+
+	pthread_join(context->encode_thread, NULL);
+
+	context->encode_running = false;
+	context->encode_stop = false;
+}
+
 int BKE_ffmpeg_append(void *context_v, RenderData *rd, int start_frame, int frame, int *pixels,
                       int rectx, int recty, const char *suffix, ReportList *reports)
 {
 	FFMpegContext *context = context_v;
+	FFMpegQueueFrame *qframe;
 	AVFrame *avframe;
+	double audio_pts = (frame - start_frame) / (((double)rd->frs_sec) / (double)rd->frs_sec_base);
 	int success = 1;
 
 	PRINT("Writing frame %i, render width=%d, render height=%d\n", frame, rectx, recty);
@@ -1236,21 +1396,44 @@ int BKE_ffmpeg_append(void *context_v, RenderData *rd, int start_frame, int fram
 //	write_audio_frames(frame / (((double)rd->frs_sec) / rd->frs_sec_base));
 
 	if (context->video_stream) {
-		avframe = generate_video_frame(context, (unsigned char *) pixels, reports);
-		success = (avframe && write_video_frame(context, rd, frame - start_frame, avframe, reports));
-
-		if (context->ffmpeg_autosplit) {
-			if (avio_tell(context->outfile->pb) > FFMPEG_AUTOSPLIT_SIZE) {
-				end_ffmpeg_impl(context, true);
-				context->ffmpeg_autosplit_count++;
-				success &= start_ffmpeg_impl(context, rd, rectx, recty, suffix, reports);
+		bool autosplit;
+
+		BLI_mutex_lock(&context->encode_lock);
+		autosplit = context->encode_autosplit;
+		BLI_mutex_unlock(&context->encode_lock);
+
+		if (autosplit) {
+			ffmpeg_encode_thread_end(context);
+			end_ffmpeg_impl(context, true);
+			context->ffmpeg_autosplit_count++;
+			context->encode_autosplit = false;
+			success &= start_ffmpeg_impl(context, rd, rectx, recty, suffix, reports);
+		}
+
+		avframe = (success) ? generate_video_frame(context, (unsigned char *) pixels, reports) : NULL;
+
+		if (avframe) {
+			qframe = MEM_callocN(sizeof(FFMpegQueueFrame), "FFMpegQueueFrame");
+			qframe->frame = avframe;
+			qframe->mode = rd->mode;
+			qframe->cfra = frame - start_frame;
+			qframe->audio_pts = audio_pts;
+
+			if (!ffmpeg_encode_push(context, qframe)) {
+				BKE_report(reports, RPT_ERROR, "Error writing frame");
+				success = 0;
 			}
 		}
+		else {
+			success = 0;
+		}
 	}
-
+	else {
 #ifdef WITH_AUDASPACE
-	write_audio_frames(context, (frame - start_frame) / (((double)rd->frs_sec) / (double)rd->frs_sec_base));
+		write_audio_frames(context, audio_pts);
 #endif
+	}
+
 	return success;
 }
 
@@ -1258,6 +1441,9 @@ static void end_ffmpeg_impl(FFMpegContext *context, int is_autosplit)
 {
 	PRINT("Closing ffmpeg...\n");
 
+	/* Encode the frames still in the queue. */
+	ffmpeg_encode_thread_end(context);
+
 #if 0
 	if (context->audio_stream) { /* SEE UPPER */
 		write_audio_frames(context);
@@ -1734,6 +1920,9 @@ void *BKE_ffmpeg_context_create(void)
 	context->ffmpeg_autosplit_count = 0;
 	context->ffmpeg_preview = false;
 
+	BLI_mutex_init(&context->encode_lock);
+	BLI_condition_init(&context->encode_cond);
+
 	return context;
 }
 
@@ -1741,6 +1930,9 @@ void BKE_ffmpeg_context_free(void *context_v)
 {
 	FFMpegContext *context = context_v;
 	if (context) {
+		ffmpeg_encode_thread_end(context);
+		BLI_condition_end(&context->encode_cond);
+		BLI_mutex_end(&context->encode_lock);
 		MEM_freeN(context);
 	}
 }
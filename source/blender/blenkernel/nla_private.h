@@ -73,6 +73,12 @@ typedef struct NlaEvalChannel {
 	float value;            /* value of this channel */
 } NlaEvalChannel;
 
+/* set of channels that NLA strips accumulate their results into */
+typedef struct NlaEvalChannels {
+	ListBase list;          /* NlaEvalChannel, in the order they were first used */
+	struct GHash *hash;     /* NlaEvalChannel -> itself, for looking up the channel of a property */
+} NlaEvalChannels;
+
 /* --------------- NLA Functions (not to be used as a proper API) ----------------------- */
 
 /* convert from strip time <-> global time */
@@ -82,7 +88,7 @@ float nlastrip_get_frame(NlaStrip *strip, float cframe, short mode);
 /* these functions are only defined here to avoid problems with the order in which they get defined... */
 
 NlaEvalStrip *nlastrips_ctime_get_strip(ListBase *list, ListBase *strips, short index, float ctime);
-void nlastrip_evaluate(PointerRNA *ptr, ListBase *channels, ListBase *modifiers, NlaEvalStrip *nes);
-void nladata_flush_channels(ListBase *channels);
+void nlastrip_evaluate(PointerRNA *ptr, NlaEvalChannels *channels, ListBase *modifiers, NlaEvalStrip *nes);
+void nladata_flush_channels(NlaEvalChannels *channels);
 
 #endif  /* __NLA_PRIVATE_H__ */
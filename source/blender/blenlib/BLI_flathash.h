@@ -0,0 +1,150 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+#ifndef __BLI_FLATHASH_H__
+#define __BLI_FLATHASH_H__
+
+/** \file BLI_flathash.h
+ *  \ingroup bli
+ *
+ * Open addressing alternative to #GHash and #GSet, using the same callbacks.
+ */
+
+#include "BLI_ghash.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct FlatHash FlatHash;
+
+typedef struct FlatHashIterator {
+	FlatHash *fh;
+	/* Key of the current slot, value (when stored) is the next pointer. */
+	void **slot;
+	unsigned int index;
+} FlatHashIterator;
+
+FlatHash *BLI_flathash_new_ex(GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info,
+                              const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+FlatHash *BLI_flathash_new(GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+void   BLI_flathash_free(FlatHash *fh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp);
+void   BLI_flathash_reserve(FlatHash *fh, const unsigned int nentries_reserve);
+void   BLI_flathash_insert(FlatHash *fh, void *key, void *val);
+bool   BLI_flathash_reinsert(FlatHash *fh, void *key, void *val,
+                             GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp);
+void  *BLI_flathash_lookup(FlatHash *fh, const void *key) ATTR_WARN_UNUSED_RESULT;
+void  *BLI_flathash_lookup_default(FlatHash *fh, const void *key, void *val_default) ATTR_WARN_UNUSED_RESULT;
+void **BLI_flathash_lookup_p(FlatHash *fh, const void *key) ATTR_WARN_UNUSED_RESULT;
+bool   BLI_flathash_ensure_p(FlatHash *fh, void *key, void ***r_val) ATTR_WARN_UNUSED_RESULT;
+bool   BLI_flathash_remove(FlatHash *fh, const void *key, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp);
+void   BLI_flathash_clear(FlatHash *fh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp);
+bool   BLI_flathash_haskey(FlatHash *fh, const void *key) ATTR_WARN_UNUSED_RESULT;
+unsigned int BLI_flathash_size(FlatHash *fh) ATTR_WARN_UNUSED_RESULT;
+
+FlatHash *BLI_flathash_ptr_new_ex(const char *info, const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+FlatHash *BLI_flathash_ptr_new(const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+FlatHash *BLI_flathash_str_new_ex(const char *info, const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+FlatHash *BLI_flathash_str_new(const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+FlatHash *BLI_flathash_int_new_ex(const char *info, const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+FlatHash *BLI_flathash_int_new(const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+
+/* *** */
+
+void BLI_flathashIterator_init(FlatHashIterator *fhi, FlatHash *fh);
+void BLI_flathashIterator_step(FlatHashIterator *fhi);
+
+BLI_INLINE void  *BLI_flathashIterator_getKey(FlatHashIterator *fhi)     { return fhi->slot[0]; }
+BLI_INLINE void  *BLI_flathashIterator_getValue(FlatHashIterator *fhi)   { return fhi->slot[1]; }
+BLI_INLINE void **BLI_flathashIterator_getValue_p(FlatHashIterator *fhi) { return &fhi->slot[1]; }
+BLI_INLINE bool   BLI_flathashIterator_done(FlatHashIterator *fhi)       { return fhi->slot == NULL; }
+
+#define FLATHASH_ITER(fh_iter_, flathash_) \
+	for (BLI_flathashIterator_init(&fh_iter_, flathash_); \
+	     BLI_flathashIterator_done(&fh_iter_) == false; \
+	     BLI_flathashIterator_step(&fh_iter_))
+
+#define FLATHASH_FOREACH_BEGIN(type, var, what) \
+	do { \
+		FlatHashIterator fh_iter##var; \
+		FLATHASH_ITER(fh_iter##var, what) { \
+			type var = (type)(BLI_flathashIterator_getValue(&fh_iter##var)); \
+
+#define FLATHASH_FOREACH_END() \
+		} \
+	} while(0)
+
+/* *** */
+
+typedef struct FlatSet FlatSet;
+
+/* so we can cast but compiler sees as different */
+typedef struct FlatSetIterator {
+	FlatHashIterator _fhi;
+} FlatSetIterator;
+
+FlatSet *BLI_flatset_new_ex(GSetHashFP hashfp, GSetCmpFP cmpfp, const char *info,
+                            const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+FlatSet *BLI_flatset_new(GSetHashFP hashfp, GSetCmpFP cmpfp, const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+void   BLI_flatset_free(FlatSet *fs, GSetKeyFreeFP keyfreefp);
+void   BLI_flatset_reserve(FlatSet *fs, const unsigned int nentries_reserve);
+void   BLI_flatset_insert(FlatSet *fs, void *key);
+bool   BLI_flatset_add(FlatSet *fs, void *key);
+bool   BLI_flatset_haskey(FlatSet *fs, const void *key) ATTR_WARN_UNUSED_RESULT;
+bool   BLI_flatset_remove(FlatSet *fs, const void *key, GSetKeyFreeFP keyfreefp);
+void   BLI_flatset_clear(FlatSet *fs, GSetKeyFreeFP keyfreefp);
+unsigned int BLI_flatset_size(FlatSet *fs) ATTR_WARN_UNUSED_RESULT;
+
+FlatSet *BLI_flatset_ptr_new_ex(const char *info, const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+FlatSet *BLI_flatset_ptr_new(const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+FlatSet *BLI_flatset_str_new_ex(const char *info, const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+FlatSet *BLI_flatset_str_new(const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+
+/* rely on inline api for now */
+BLI_INLINE void BLI_flatsetIterator_init(FlatSetIterator *fsi, FlatSet *fs) { BLI_flathashIterator_init((FlatHashIterator *)fsi, (FlatHash *)fs); }
+BLI_INLINE void *BLI_flatsetIterator_getKey(FlatSetIterator *fsi) { return BLI_flathashIterator_getKey((FlatHashIterator *)fsi); }
+BLI_INLINE void BLI_flatsetIterator_step(FlatSetIterator *fsi) { BLI_flathashIterator_step((FlatHashIterator *)fsi); }
+BLI_INLINE bool BLI_flatsetIterator_done(FlatSetIterator *fsi) { return BLI_flathashIterator_done((FlatHashIterator *)fsi); }
+
+#define FLATSET_ITER(fs_iter_, flatset_) \
+	for (BLI_flatsetIterator_init(&fs_iter_, flatset_); \
+	     BLI_flatsetIterator_done(&fs_iter_) == false; \
+	     BLI_flatsetIterator_step(&fs_iter_))
+
+#define FLATSET_FOREACH_BEGIN(type, var, what) \
+	do { \
+		FlatSetIterator fs_iter##var; \
+		FLATSET_ITER(fs_iter##var, what) { \
+			type var = (type)(BLI_flatsetIterator_getKey(&fs_iter##var));
+
+#define FLATSET_FOREACH_END() \
+		} \
+	} while(0)
+
+/* For testing, debugging only */
+#ifdef GHASH_INTERNAL_API
+double BLI_flathash_calc_quality_ex(FlatHash *fh, double *r_load, double *r_prop_tombstones, int *r_longest_probe);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BLI_FLATHASH_H__ */
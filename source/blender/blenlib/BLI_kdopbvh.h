@@ -155,6 +155,19 @@ void BLI_bvhtree_ray_cast_all(
         BVHTree *tree, const float co[3], const float dir[3], float radius, float hit_dist,
         BVHTree_RayCastCallback callback, void *userdata);
 
+/* batched queries, run in parallel (callbacks must be thread safe) */
+void BLI_bvhtree_find_nearest_array(
+        BVHTree *tree, const float (*co)[3], const int co_len, BVHTreeNearest *r_nearest,
+        BVHTree_NearestPointCallback callback, void *userdata);
+
+void BLI_bvhtree_ray_cast_array_ex(
+        BVHTree *tree, const float (*co)[3], const float (*dir)[3], const int ray_len, float radius,
+        BVHTreeRayHit *r_hit, BVHTree_RayCastCallback callback, void *userdata,
+        int flag);
+void BLI_bvhtree_ray_cast_array(
+        BVHTree *tree, const float (*co)[3], const float (*dir)[3], const int ray_len, float radius,
+        BVHTreeRayHit *r_hit, BVHTree_RayCastCallback callback, void *userdata);
+
 float BLI_bvhtree_bb_raycast(const float bv[6], const float light_start[3], const float light_end[3], float pos[3]);
 
 /* range query */
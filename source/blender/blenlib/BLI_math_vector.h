@@ -368,6 +368,10 @@ void copy_vn_ushort(unsigned short *array_tar, const int size, const unsigned sh
 void copy_vn_uchar(unsigned char *array_tar, const int size, const unsigned char val);
 void copy_vn_fl(float *array_tar, const int size, const float val);
 
+void normalize_v3_array(float (*vec_arr)[3], const int vec_num);
+void dot_v3v3_array(float *r_dot, const float (*vec_a)[3], const float (*vec_b)[3], const int vec_num);
+void cross_v3_v3v3_array(float (*r_arr)[3], const float (*vec_a)[3], const float (*vec_b)[3], const int vec_num);
+
 void add_vn_vn_d(double *array_tar, const double *array_src, const int size);
 void add_vn_vnvn_d(double *array_tar, const double *array_src_a, const double *array_src_b, const int size);
 void mul_vn_db(double *array_tar, const int size, const double f);
@@ -41,8 +41,10 @@ extern "C"
 
 struct BLI_mempool;
 struct BLI_mempool_chunk;
+struct BLI_mempool_threadcache;
 
 typedef struct BLI_mempool BLI_mempool;
+typedef struct BLI_mempool_threadcache BLI_mempool_threadcache;
 
 BLI_mempool *BLI_mempool_create(unsigned int esize, unsigned int totelem,
                                 unsigned int pchunk, unsigned int flag) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
@@ -61,6 +63,13 @@ void      **BLI_mempool_as_tableN(BLI_mempool *pool, const char *allocstr) ATTR_
 void        BLI_mempool_as_array(BLI_mempool *pool, void *data) ATTR_NONNULL(1, 2);
 void       *BLI_mempool_as_arrayN(BLI_mempool *pool, const char *allocstr) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1, 2);
 
+/* thread caches, see BLI_MEMPOOL_ALLOW_THREADS */
+BLI_mempool_threadcache *BLI_mempool_threadcache_create(BLI_mempool *pool) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1);
+void        *BLI_mempool_threadcache_alloc(BLI_mempool_threadcache *cache) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1);
+void        *BLI_mempool_threadcache_calloc(BLI_mempool_threadcache *cache) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1);
+void         BLI_mempool_threadcache_free(BLI_mempool_threadcache *cache, void *addr) ATTR_NONNULL(1, 2);
+void         BLI_mempool_threadcache_destroy(BLI_mempool_threadcache *cache) ATTR_NONNULL(1);
+
 #ifndef NDEBUG
 void        BLI_mempool_set_memory_debug(void);
 #endif
@@ -82,6 +91,11 @@ enum {
 	 * \note order of iteration is only assured to be the order of allocation when no chunks have been freed.
 	 */
 	BLI_MEMPOOL_ALLOW_ITER = (1 << 0),
+	/** allow allocating and freeing from multiple threads using #BLI_mempool_threadcache.
+	 *
+	 * \note elements are moved between thread caches and the pool in batches of a chunk size.
+	 */
+	BLI_MEMPOOL_ALLOW_THREADS = (1 << 1),
 };
 
 void  BLI_mempool_iternew(BLI_mempool *pool, BLI_mempool_iter *iter) ATTR_NONNULL();
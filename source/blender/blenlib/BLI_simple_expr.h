@@ -0,0 +1,69 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2017 Blender Foundation.
+ * All rights reserved.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+#ifndef __BLI_SIMPLE_EXPR_H__
+#define __BLI_SIMPLE_EXPR_H__
+
+/** \file BLI_simple_expr.h
+ *  \ingroup bli
+ *
+ * Evaluator for a subset of Python expressions, which only deal with double
+ * precision numbers, running without the Python interpreter (and thread-safe):
+ *
+ * - Literals: decimal numbers, True, False, pi and e.
+ * - Named parameters, passed in on evaluation.
+ * - Operators: + - * / ** == != < <= > >= and or not, and 'x if cond else y'.
+ * - Functions: the common math module functions, abs, min and max.
+ *
+ * Anything else, including chained comparisons, fails to parse. Results which
+ * are not finite are reported as errors, so callers can take a slower path
+ * which reports them properly.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct SimpleExprParsed SimpleExprParsed;
+
+typedef enum eSimpleExpr_EvalStatus {
+	SIMPLE_EXPR_SUCCESS = 0,
+	/* division by zero, math domain error or overflow */
+	SIMPLE_EXPR_MATH_ERROR,
+	/* the expression failed to parse, or the wrong number of parameters was passed */
+	SIMPLE_EXPR_INVALID,
+} eSimpleExpr_EvalStatus;
+
+SimpleExprParsed *BLI_simple_expr_parse(const char *expression, int param_names_len, const char **param_names);
+void BLI_simple_expr_free(SimpleExprParsed *expr);
+
+bool BLI_simple_expr_is_valid(const SimpleExprParsed *expr);
+
+eSimpleExpr_EvalStatus BLI_simple_expr_evaluate(
+        const SimpleExprParsed *expr, const double *params, int params_len, double *r_result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BLI_SIMPLE_EXPR_H__ */
@@ -37,8 +37,10 @@ extern "C" {
 
 /* Task Scheduler
  * 
- * Central scheduler that holds running threads ready to execute tasks. A single
- * queue holds the task from all pools.
+ * Central scheduler that holds running threads ready to execute tasks. A global
+ * queue holds the tasks pushed from outside of worker threads, tasks pushed
+ * from a worker thread go to its own work-stealing queue, from which other
+ * threads steal when they run out of work.
  *
  * Init/exit must be called before/after any task pools are created/freed, and
  * must be called from the main threads. All other scheduler and pool functions
@@ -117,6 +119,7 @@ void BLI_task_pool_delayed_push_end(TaskPool *pool, int thread_id);
 typedef void (*TaskParallelRangeFunc)(void *userdata, const int iter);
 typedef void (*TaskParallelRangeFuncEx)(void *userdata, void *userdata_chunk, const int iter, const int thread_id);
 typedef void (*TaskParallelRangeFuncFinalize)(void *userdata, void *userdata_chunk);
+typedef void (*TaskParallelRangeFuncReduce)(void *userdata, void *__restrict chunk_join, void *__restrict chunk);
 void BLI_task_parallel_range_ex(
         int start, int stop,
         void *userdata,
@@ -141,6 +144,16 @@ void BLI_task_parallel_range_finalize(
         const bool use_threading,
         const bool use_dynamic_scheduling);
 
+void BLI_task_parallel_range_reduce(
+        int start, int stop,
+        void *userdata,
+        void *userdata_chunk,
+        const size_t userdata_chunk_size,
+        TaskParallelRangeFuncEx func_ex,
+        TaskParallelRangeFuncReduce func_reduce,
+        const bool use_threading,
+        const bool use_dynamic_scheduling);
+
 typedef void (*TaskParallelListbaseFunc)(void *userdata,
                                          struct Link *iter,
                                          int index);
@@ -0,0 +1,829 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file blender/blenlib/intern/BLI_flathash.c
+ *  \ingroup bli
+ *
+ * A general (pointer -> pointer) open addressing hash table.
+ *
+ * Unlike #GHash, entries are stored inline in a single flat array, so there is
+ * no per-entry allocation and lookups do not need to chase bucket chains.
+ *
+ * Every slot has a control byte which is either empty, deleted (tombstone) or
+ * holds 7 bits of the key hash. Lookup compares a whole group of control bytes
+ * at once (using SSE2 when available), and only calls the compare callback for
+ * slots where those hash bits match.
+ *
+ * The number of slots is a power of two, groups are probed using triangular
+ * numbers which visits every group once. The table is kept at most 7/8 full,
+ * so there is always an empty slot which terminates the probing.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_sys_types.h"  /* for intptr_t support */
+#include "BLI_utildefines.h"
+
+#define GHASH_INTERNAL_API
+#include "BLI_flathash.h"
+#include "BLI_strict_flags.h"
+
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
+#define FLATHASH_GROUP_WIDTH 16
+#define FLATHASH_CAPACITY_MIN FLATHASH_GROUP_WIDTH
+
+/* Control bytes, full slots store 7 bits of the hash (always positive). */
+#define FLATHASH_CTRL_EMPTY   ((signed char)-128)
+#define FLATHASH_CTRL_DELETED ((signed char)-2)
+
+#define FLATHASH_H2(_hash) ((signed char)((_hash) & 0x7f))
+
+/* Maximum number of entries for the given capacity. */
+#define FLATHASH_LIMIT_GROW(_capacity) ((_capacity) - ((_capacity) / 8))
+
+/***/
+
+struct FlatHash {
+	GHashHashFP hashfp;
+	GHashCmpFP cmpfp;
+
+	/* Key (and value) pointers, stride of slots is #FlatHash.stride. */
+	void **slots;
+	/* Capacity + #FLATHASH_GROUP_WIDTH control bytes, the last ones are a copy
+	 * of the first group, so groups can be loaded from any position. */
+	signed char *ctrl;
+
+	unsigned int capacity;
+	unsigned int capacity_shift;
+	/* Number of empty slots which can be filled before the table is to grow. */
+	unsigned int growth_left;
+	unsigned int nentries;
+	/* 1 for sets (keys only), 2 for hashes. */
+	unsigned int stride;
+};
+
+
+/* -------------------------------------------------------------------- */
+/** \name Internal Group Utility API
+ *
+ * Find matching control bytes of a group, as a bit-mask where every bit is
+ * an offset from the beginning of the group.
+ * \{ */
+
+BLI_INLINE unsigned int flathash_mask_lowest(const unsigned int mask)
+{
+	BLI_assert(mask != 0);
+#if defined(__GNUC__)
+	return (unsigned int)__builtin_ctz(mask);
+#else
+	unsigned int i = 0;
+	while ((mask & (1u << i)) == 0) {
+		i++;
+	}
+	return i;
+#endif
+}
+
+#ifdef __SSE2__
+
+BLI_INLINE unsigned int flathash_group_match(const signed char *group, const signed char h2)
+{
+	const __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+	return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8((char)h2), ctrl));
+}
+
+BLI_INLINE unsigned int flathash_group_match_empty(const signed char *group)
+{
+	const __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+	return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8((char)FLATHASH_CTRL_EMPTY), ctrl));
+}
+
+/* Both empty and deleted control bytes are negative. */
+BLI_INLINE unsigned int flathash_group_match_empty_or_deleted(const signed char *group)
+{
+	const __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+	return (unsigned int)_mm_movemask_epi8(ctrl);
+}
+
+#else  /* __SSE2__ */
+
+BLI_INLINE unsigned int flathash_group_match(const signed char *group, const signed char h2)
+{
+	unsigned int mask = 0, i;
+	for (i = 0; i < FLATHASH_GROUP_WIDTH; i++) {
+		if (group[i] == h2) {
+			mask |= (1u << i);
+		}
+	}
+	return mask;
+}
+
+BLI_INLINE unsigned int flathash_group_match_empty(const signed char *group)
+{
+	return flathash_group_match(group, FLATHASH_CTRL_EMPTY);
+}
+
+BLI_INLINE unsigned int flathash_group_match_empty_or_deleted(const signed char *group)
+{
+	unsigned int mask = 0, i;
+	for (i = 0; i < FLATHASH_GROUP_WIDTH; i++) {
+		if (group[i] < 0) {
+			mask |= (1u << i);
+		}
+	}
+	return mask;
+}
+
+#endif  /* __SSE2__ */
+
+/** \} */
+
+
+/* -------------------------------------------------------------------- */
+/** \name Internal Utility API
+ * \{ */
+
+/**
+ * Position of the first probed group, uses high bits of the multiplied hash,
+ * low bits are used for the control byte.
+ */
+BLI_INLINE unsigned int flathash_probe_start(FlatHash *fh, const unsigned int hash)
+{
+	return (hash * 2654435769u) >> fh->capacity_shift;
+}
+
+BLI_INLINE void **flathash_slot(FlatHash *fh, const unsigned int index)
+{
+	return &fh->slots[(size_t)index * fh->stride];
+}
+
+BLI_INLINE void flathash_ctrl_set(FlatHash *fh, const unsigned int index, const signed char ctrl)
+{
+	fh->ctrl[index] = ctrl;
+	/* Keep the copy of the first group in sync. */
+	if (index < FLATHASH_GROUP_WIDTH - 1) {
+		fh->ctrl[fh->capacity + index] = ctrl;
+	}
+}
+
+/**
+ * Smallest power of two capacity which can store \a nentries.
+ */
+static unsigned int flathash_capacity_for(const unsigned int nentries)
+{
+	unsigned int capacity = FLATHASH_CAPACITY_MIN;
+	while (FLATHASH_LIMIT_GROW(capacity) < nentries) {
+		capacity *= 2;
+	}
+	return capacity;
+}
+
+/**
+ * Allocate empty storage of given \a capacity, existing storage is not freed.
+ */
+static void flathash_storage_alloc(FlatHash *fh, const unsigned int capacity)
+{
+	const size_t slots_size = sizeof(*fh->slots) * (size_t)capacity * fh->stride;
+	unsigned int shift = 32;
+	unsigned int i;
+
+	BLI_assert((capacity & (capacity - 1)) == 0 && capacity >= FLATHASH_CAPACITY_MIN);
+
+	/* Slots and control bytes are in a single allocation. */
+	fh->slots = MEM_mallocN(slots_size + capacity + FLATHASH_GROUP_WIDTH, __func__);
+	fh->ctrl = (signed char *)((char *)fh->slots + slots_size);
+	memset(fh->ctrl, FLATHASH_CTRL_EMPTY, capacity + FLATHASH_GROUP_WIDTH);
+
+	for (i = capacity; i > 1; i >>= 1) {
+		shift--;
+	}
+	fh->capacity = capacity;
+	fh->capacity_shift = shift;
+	fh->growth_left = FLATHASH_LIMIT_GROW(capacity) - fh->nentries;
+}
+
+/**
+ * Index of the first empty or deleted slot in the probe sequence of the hash.
+ */
+static unsigned int flathash_find_free_index(FlatHash *fh, const unsigned int hash)
+{
+	const unsigned int mask = fh->capacity - 1;
+	unsigned int pos = flathash_probe_start(fh, hash);
+	unsigned int stride = 0;
+
+	for (;;) {
+		const unsigned int match = flathash_group_match_empty_or_deleted(&fh->ctrl[pos]);
+		if (match != 0) {
+			return (pos + flathash_mask_lowest(match)) & mask;
+		}
+		stride += FLATHASH_GROUP_WIDTH;
+		pos = (pos + stride) & mask;
+	}
+}
+
+/**
+ * Rebuild the table so it can hold \a nentries_reserve entries, also gets rid of tombstones.
+ */
+static void flathash_rehash(FlatHash *fh, const unsigned int nentries_reserve)
+{
+	void **slots_old = fh->slots;
+	const signed char *ctrl_old = fh->ctrl;
+	const unsigned int capacity_old = fh->capacity;
+	unsigned int capacity = flathash_capacity_for(nentries_reserve);
+	unsigned int i;
+
+	/* Grow rather than only purging tombstones when we would be close to the limit again. */
+	if ((uint64_t)nentries_reserve * 32 > (uint64_t)capacity_old * 25) {
+		capacity = MAX2(capacity, capacity_old * 2);
+	}
+	else {
+		capacity = MAX2(capacity, capacity_old);
+	}
+
+	flathash_storage_alloc(fh, capacity);
+
+	for (i = 0; i < capacity_old; i++) {
+		if (ctrl_old[i] >= 0) {
+			void **slot_old = &slots_old[(size_t)i * fh->stride];
+			const unsigned int hash = fh->hashfp(slot_old[0]);
+			const unsigned int index = flathash_find_free_index(fh, hash);
+			flathash_ctrl_set(fh, index, FLATHASH_H2(hash));
+			memcpy(flathash_slot(fh, index), slot_old, sizeof(*slot_old) * fh->stride);
+		}
+	}
+	fh->growth_left = FLATHASH_LIMIT_GROW(capacity) - fh->nentries;
+
+	MEM_freeN(slots_old);
+}
+
+/**
+ * Internal lookup function, takes a hash argument to avoid calling the hash callback multiple times.
+ */
+static void **flathash_lookup_slot_ex(FlatHash *fh, const void *key, const unsigned int hash)
+{
+	const signed char h2 = FLATHASH_H2(hash);
+	const unsigned int mask = fh->capacity - 1;
+	unsigned int pos = flathash_probe_start(fh, hash);
+	unsigned int stride = 0;
+
+	for (;;) {
+		const signed char *group = &fh->ctrl[pos];
+		unsigned int match = flathash_group_match(group, h2);
+		while (match != 0) {
+			void **slot = flathash_slot(fh, (pos + flathash_mask_lowest(match)) & mask);
+			if (fh->cmpfp(key, slot[0]) == false) {
+				return slot;
+			}
+			match &= match - 1;
+		}
+		if (flathash_group_match_empty(group) != 0) {
+			return NULL;
+		}
+		stride += FLATHASH_GROUP_WIDTH;
+		pos = (pos + stride) & mask;
+	}
+}
+
+BLI_INLINE void **flathash_lookup_slot(FlatHash *fh, const void *key)
+{
+	return flathash_lookup_slot_ex(fh, key, fh->hashfp(key));
+}
+
+/**
+ * Insert the key without checking for duplicates, returns its slot.
+ */
+static void **flathash_insert_ex(FlatHash *fh, void *key, const unsigned int hash)
+{
+	unsigned int index = flathash_find_free_index(fh, hash);
+	void **slot;
+
+	if (UNLIKELY(fh->growth_left == 0 && fh->ctrl[index] == FLATHASH_CTRL_EMPTY)) {
+		flathash_rehash(fh, fh->nentries + 1);
+		index = flathash_find_free_index(fh, hash);
+	}
+	if (fh->ctrl[index] == FLATHASH_CTRL_EMPTY) {
+		fh->growth_left--;
+	}
+	flathash_ctrl_set(fh, index, FLATHASH_H2(hash));
+	fh->nentries++;
+
+	slot = flathash_slot(fh, index);
+	slot[0] = key;
+	return slot;
+}
+
+static void flathash_free_slots(FlatHash *fh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	unsigned int i;
+
+	BLI_assert(keyfreefp || valfreefp);
+	BLI_assert(!valfreefp || fh->stride == 2);
+
+	for (i = 0; i < fh->capacity; i++) {
+		if (fh->ctrl[i] >= 0) {
+			void **slot = flathash_slot(fh, i);
+			if (keyfreefp) {
+				keyfreefp(slot[0]);
+			}
+			if (valfreefp) {
+				valfreefp(slot[1]);
+			}
+		}
+	}
+}
+
+static FlatHash *flathash_new(GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info,
+                              const unsigned int nentries_reserve, const unsigned int stride)
+{
+	FlatHash *fh = MEM_mallocN(sizeof(*fh), info);
+
+	fh->hashfp = hashfp;
+	fh->cmpfp = cmpfp;
+	fh->nentries = 0;
+	fh->stride = stride;
+	flathash_storage_alloc(fh, flathash_capacity_for(nentries_reserve));
+
+	return fh;
+}
+
+static bool flathash_remove_slot(FlatHash *fh, const void *key,
+                                 GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	void **slot = flathash_lookup_slot(fh, key);
+	unsigned int index;
+
+	if (slot == NULL) {
+		return false;
+	}
+	if (keyfreefp) {
+		keyfreefp(slot[0]);
+	}
+	if (valfreefp) {
+		valfreefp(slot[1]);
+	}
+	index = (unsigned int)((size_t)(slot - fh->slots) / fh->stride);
+	/* Deleted slot keeps the probe sequences passing through it going,
+	 * it's reused by insertion and purged when the table is rebuilt. */
+	flathash_ctrl_set(fh, index, FLATHASH_CTRL_DELETED);
+	fh->nentries--;
+	return true;
+}
+
+static void flathash_clear(FlatHash *fh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	if (keyfreefp || valfreefp) {
+		flathash_free_slots(fh, keyfreefp, valfreefp);
+	}
+	memset(fh->ctrl, FLATHASH_CTRL_EMPTY, fh->capacity + FLATHASH_GROUP_WIDTH);
+	fh->nentries = 0;
+	fh->growth_left = FLATHASH_LIMIT_GROW(fh->capacity);
+}
+
+/** \} */
+
+
+/* -------------------------------------------------------------------- */
+/** \name FlatHash Public API
+ * \{ */
+
+/**
+ * Creates a new, empty FlatHash.
+ *
+ * \param hashfp  Hash callback.
+ * \param cmpfp  Comparison callback.
+ * \param info  Identifier string for the FlatHash.
+ * \param nentries_reserve  Optionally reserve the number of members that the hash will hold.
+ * Use this to avoid resizing buckets if the size is known or can be closely approximated.
+ * \return  An empty FlatHash.
+ */
+FlatHash *BLI_flathash_new_ex(GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info,
+                              const unsigned int nentries_reserve)
+{
+	return flathash_new(hashfp, cmpfp, info, nentries_reserve, 2);
+}
+
+/**
+ * Wraps #BLI_flathash_new_ex with zero entries reserved.
+ */
+FlatHash *BLI_flathash_new(GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info)
+{
+	return BLI_flathash_new_ex(hashfp, cmpfp, info, 0);
+}
+
+/**
+ * Frees the FlatHash and its members.
+ *
+ * \param fh  The FlatHash to free.
+ * \param keyfreefp  Optional callback to free the key.
+ * \param valfreefp  Optional callback to free the value.
+ */
+void BLI_flathash_free(FlatHash *fh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	if (keyfreefp || valfreefp) {
+		flathash_free_slots(fh, keyfreefp, valfreefp);
+	}
+	MEM_freeN(fh->slots);
+	MEM_freeN(fh);
+}
+
+/**
+ * Reserve given amount of entries (resize \a fh accordingly if needed).
+ */
+void BLI_flathash_reserve(FlatHash *fh, const unsigned int nentries_reserve)
+{
+	if (flathash_capacity_for(nentries_reserve) > fh->capacity) {
+		flathash_rehash(fh, nentries_reserve);
+	}
+}
+
+/**
+ * \return size of the FlatHash.
+ */
+unsigned int BLI_flathash_size(FlatHash *fh)
+{
+	return fh->nentries;
+}
+
+/**
+ * Insert a key/value pair into the \a fh.
+ *
+ * \note Duplicates are not checked,
+ * the caller is expected to ensure elements are unique.
+ */
+void BLI_flathash_insert(FlatHash *fh, void *key, void *val)
+{
+	void **slot;
+	BLI_assert(BLI_flathash_haskey(fh, key) == false);
+	slot = flathash_insert_ex(fh, key, fh->hashfp(key));
+	slot[1] = val;
+}
+
+/**
+ * Inserts a new value to a key that may already be in the hash.
+ *
+ * \returns true if a new key has been added.
+ */
+bool BLI_flathash_reinsert(FlatHash *fh, void *key, void *val,
+                           GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	const unsigned int hash = fh->hashfp(key);
+	void **slot = flathash_lookup_slot_ex(fh, key, hash);
+
+	if (slot != NULL) {
+		if (keyfreefp) {
+			keyfreefp(slot[0]);
+		}
+		if (valfreefp) {
+			valfreefp(slot[1]);
+		}
+		slot[0] = key;
+		slot[1] = val;
+		return false;
+	}
+	slot = flathash_insert_ex(fh, key, hash);
+	slot[1] = val;
+	return true;
+}
+
+/**
+ * Lookup the value of \a key in \a fh.
+ *
+ * \note When NULL is a valid value, use #BLI_flathash_lookup_p to differentiate a missing key
+ * from a key with a NULL value.
+ */
+void *BLI_flathash_lookup(FlatHash *fh, const void *key)
+{
+	void **slot = flathash_lookup_slot(fh, key);
+	BLI_assert(fh->stride == 2);
+	return slot ? slot[1] : NULL;
+}
+
+/**
+ * A version of #BLI_flathash_lookup which accepts a fallback argument.
+ */
+void *BLI_flathash_lookup_default(FlatHash *fh, const void *key, void *val_default)
+{
+	void **slot = flathash_lookup_slot(fh, key);
+	BLI_assert(fh->stride == 2);
+	return slot ? slot[1] : val_default;
+}
+
+/**
+ * Lookup a pointer to the value of \a key in \a fh.
+ *
+ * \note The pointer is only valid until the next insertion.
+ */
+void **BLI_flathash_lookup_p(FlatHash *fh, const void *key)
+{
+	void **slot = flathash_lookup_slot(fh, key);
+	BLI_assert(fh->stride == 2);
+	return slot ? &slot[1] : NULL;
+}
+
+/**
+ * Ensure \a key is exists in \a fh.
+ *
+ * \param r_val: The pointer to the value, only valid until the next insertion.
+ * \returns true when the value didn't need to be added
+ * (when false, the caller _must_ initialize the value).
+ */
+bool BLI_flathash_ensure_p(FlatHash *fh, void *key, void ***r_val)
+{
+	const unsigned int hash = fh->hashfp(key);
+	void **slot = flathash_lookup_slot_ex(fh, key, hash);
+	const bool haskey = (slot != NULL);
+
+	if (!haskey) {
+		slot = flathash_insert_ex(fh, key, hash);
+	}
+	*r_val = &slot[1];
+	return haskey;
+}
+
+/**
+ * Remove \a key from \a fh, or return false if the key wasn't found.
+ *
+ * \param keyfreefp  Optional callback to free the key.
+ * \param valfreefp  Optional callback to free the value.
+ * \return true if \a key was removed from \a fh.
+ */
+bool BLI_flathash_remove(FlatHash *fh, const void *key, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	return flathash_remove_slot(fh, key, keyfreefp, valfreefp);
+}
+
+/**
+ * Reset \a fh clearing all entries, the storage is kept allocated.
+ *
+ * \param keyfreefp  Optional callback to free the key.
+ * \param valfreefp  Optional callback to free the value.
+ */
+void BLI_flathash_clear(FlatHash *fh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	flathash_clear(fh, keyfreefp, valfreefp);
+}
+
+/**
+ * \return true if the \a key is in \a fh.
+ */
+bool BLI_flathash_haskey(FlatHash *fh, const void *key)
+{
+	return (flathash_lookup_slot(fh, key) != NULL);
+}
+
+FlatHash *BLI_flathash_ptr_new_ex(const char *info, const unsigned int nentries_reserve)
+{
+	return BLI_flathash_new_ex(BLI_ghashutil_ptrhash, BLI_ghashutil_ptrcmp, info, nentries_reserve);
+}
+FlatHash *BLI_flathash_ptr_new(const char *info)
+{
+	return BLI_flathash_ptr_new_ex(info, 0);
+}
+
+FlatHash *BLI_flathash_str_new_ex(const char *info, const unsigned int nentries_reserve)
+{
+	return BLI_flathash_new_ex(BLI_ghashutil_strhash_p, BLI_ghashutil_strcmp, info, nentries_reserve);
+}
+FlatHash *BLI_flathash_str_new(const char *info)
+{
+	return BLI_flathash_str_new_ex(info, 0);
+}
+
+FlatHash *BLI_flathash_int_new_ex(const char *info, const unsigned int nentries_reserve)
+{
+	return BLI_flathash_new_ex(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, info, nentries_reserve);
+}
+FlatHash *BLI_flathash_int_new(const char *info)
+{
+	return BLI_flathash_int_new_ex(info, 0);
+}
+
+/** \} */
+
+
+/* -------------------------------------------------------------------- */
+/** \name FlatHash Iterator API
+ *
+ * \note The iterator is invalidated by insertion, removing the current entry is fine.
+ * \{ */
+
+static void flathash_iterator_seek(FlatHashIterator *fhi, unsigned int index)
+{
+	FlatHash *fh = fhi->fh;
+
+	while (index < fh->capacity) {
+		/* Skip a group of empty or deleted slots at once. */
+		const unsigned int match = ~flathash_group_match_empty_or_deleted(&fh->ctrl[index]) &
+		                           ((1u << FLATHASH_GROUP_WIDTH) - 1);
+		if (match != 0) {
+			index += flathash_mask_lowest(match);
+			/* Bits past the capacity are from the copy of the first group. */
+			if (index < fh->capacity) {
+				fhi->index = index;
+				fhi->slot = flathash_slot(fh, index);
+				return;
+			}
+			break;
+		}
+		index += FLATHASH_GROUP_WIDTH;
+	}
+	fhi->index = fh->capacity;
+	fhi->slot = NULL;
+}
+
+/**
+ * Init an already allocated FlatHashIterator. The hash table must not
+ * be mutated while the iterator is in use, and the iterator will
+ * step exactly BLI_flathash_size(fh) times before becoming done.
+ *
+ * \param fhi  The FlatHashIterator to initialize.
+ * \param fh  The FlatHash to iterate over.
+ */
+void BLI_flathashIterator_init(FlatHashIterator *fhi, FlatHash *fh)
+{
+	fhi->fh = fh;
+	flathash_iterator_seek(fhi, 0);
+}
+
+/**
+ * Steps the iterator to the next index.
+ *
+ * \param fhi  The iterator.
+ */
+void BLI_flathashIterator_step(FlatHashIterator *fhi)
+{
+	if (fhi->slot != NULL) {
+		flathash_iterator_seek(fhi, fhi->index + 1);
+	}
+}
+
+/** \} */
+
+
+/* -------------------------------------------------------------------- */
+/** \name FlatSet Public API
+ *
+ * Use ghash API to give 'set' functionality
+ * \{ */
+
+FlatSet *BLI_flatset_new_ex(GSetHashFP hashfp, GSetCmpFP cmpfp, const char *info,
+                            const unsigned int nentries_reserve)
+{
+	return (FlatSet *)flathash_new(hashfp, cmpfp, info, nentries_reserve, 1);
+}
+
+FlatSet *BLI_flatset_new(GSetHashFP hashfp, GSetCmpFP cmpfp, const char *info)
+{
+	return BLI_flatset_new_ex(hashfp, cmpfp, info, 0);
+}
+
+void BLI_flatset_free(FlatSet *fs, GSetKeyFreeFP keyfreefp)
+{
+	BLI_flathash_free((FlatHash *)fs, keyfreefp, NULL);
+}
+
+void BLI_flatset_reserve(FlatSet *fs, const unsigned int nentries_reserve)
+{
+	BLI_flathash_reserve((FlatHash *)fs, nentries_reserve);
+}
+
+unsigned int BLI_flatset_size(FlatSet *fs)
+{
+	return ((FlatHash *)fs)->nentries;
+}
+
+/**
+ * Adds the key to the set (no checks for unique keys!).
+ * Matching #BLI_flathash_insert
+ */
+void BLI_flatset_insert(FlatSet *fs, void *key)
+{
+	FlatHash *fh = (FlatHash *)fs;
+	BLI_assert(BLI_flatset_haskey(fs, key) == false);
+	flathash_insert_ex(fh, key, fh->hashfp(key));
+}
+
+/**
+ * A version of BLI_flatset_insert which checks first if the key is in the set.
+ * \returns true if a new key has been added.
+ */
+bool BLI_flatset_add(FlatSet *fs, void *key)
+{
+	FlatHash *fh = (FlatHash *)fs;
+	const unsigned int hash = fh->hashfp(key);
+
+	if (flathash_lookup_slot_ex(fh, key, hash) != NULL) {
+		return false;
+	}
+	flathash_insert_ex(fh, key, hash);
+	return true;
+}
+
+bool BLI_flatset_haskey(FlatSet *fs, const void *key)
+{
+	return (flathash_lookup_slot((FlatHash *)fs, key) != NULL);
+}
+
+bool BLI_flatset_remove(FlatSet *fs, const void *key, GSetKeyFreeFP keyfreefp)
+{
+	return flathash_remove_slot((FlatHash *)fs, key, keyfreefp, NULL);
+}
+
+void BLI_flatset_clear(FlatSet *fs, GSetKeyFreeFP keyfreefp)
+{
+	flathash_clear((FlatHash *)fs, keyfreefp, NULL);
+}
+
+FlatSet *BLI_flatset_ptr_new_ex(const char *info, const unsigned int nentries_reserve)
+{
+	return BLI_flatset_new_ex(BLI_ghashutil_ptrhash, BLI_ghashutil_ptrcmp, info, nentries_reserve);
+}
+FlatSet *BLI_flatset_ptr_new(const char *info)
+{
+	return BLI_flatset_ptr_new_ex(info, 0);
+}
+
+FlatSet *BLI_flatset_str_new_ex(const char *info, const unsigned int nentries_reserve)
+{
+	return BLI_flatset_new_ex(BLI_ghashutil_strhash_p, BLI_ghashutil_strcmp, info, nentries_reserve);
+}
+FlatSet *BLI_flatset_str_new(const char *info)
+{
+	return BLI_flatset_str_new_ex(info, 0);
+}
+
+/** \} */
+
+
+/* -------------------------------------------------------------------- */
+/** \name Debugging & Introspection
+ * \{ */
+
+/**
+ * Measure how well the hash function performs.
+ *
+ * \return the average number of groups probed to find an entry (1.0 is perfect).
+ */
+double BLI_flathash_calc_quality_ex(FlatHash *fh, double *r_load, double *r_prop_tombstones, int *r_longest_probe)
+{
+	const unsigned int mask = fh->capacity - 1;
+	unsigned int num_tombstones = 0;
+	unsigned int longest_probe = 0;
+	uint64_t sum_probes = 0;
+	unsigned int i;
+
+	for (i = 0; i < fh->capacity; i++) {
+		if (fh->ctrl[i] == FLATHASH_CTRL_DELETED) {
+			num_tombstones++;
+		}
+		else if (fh->ctrl[i] >= 0) {
+			const unsigned int hash = fh->hashfp(flathash_slot(fh, i)[0]);
+			unsigned int pos = flathash_probe_start(fh, hash);
+			unsigned int stride = 0;
+			unsigned int num_probes = 1;
+			while (((i - pos) & mask) >= FLATHASH_GROUP_WIDTH) {
+				stride += FLATHASH_GROUP_WIDTH;
+				pos = (pos + stride) & mask;
+				num_probes++;
+			}
+			sum_probes += num_probes;
+			longest_probe = MAX2(longest_probe, num_probes);
+		}
+	}
+
+	if (r_load) {
+		*r_load = (double)fh->nentries / (double)fh->capacity;
+	}
+	if (r_prop_tombstones) {
+		*r_prop_tombstones = (double)num_tombstones / (double)fh->capacity;
+	}
+	if (r_longest_probe) {
+		*r_longest_probe = (int)longest_probe;
+	}
+	return fh->nentries ? (double)sum_probes / (double)fh->nentries : 0.0;
+}
+
+/** \} */
@@ -80,6 +80,10 @@
 #  define KDOPBVH_THREAD_LEAF_THRESHOLD 1024
 #endif
 
+/* Number of leafs handled by a single task when computing the bounds of a large branch,
+ * only branches with more leafs get their bounds computed in parallel. */
+#define KDOPBVH_REFIT_LEAFS_PER_TASK 4096
+
 
 /* -------------------------------------------------------------------- */
 
@@ -500,18 +504,12 @@ static void create_kdop_hull(const BVHTree *tree, BVHNode *node, const float *co
 	}
 }
 
-/**
- * \note depends on the fact that the BVH's for each face is already build
- */
-static void refit_kdop_hull(const BVHTree *tree, BVHNode *node, int start, int end)
+static void refit_kdop_hull_range(const BVHTree *tree, float *bv, int start, int end)
 {
 	float newmin, newmax;
-	float *bv = node->bv;
 	int j;
 	axis_t axis_iter;
 
-	node_minmax_init(tree, node);
-
 	for (j = start; j < end; j++) {
 		/* for all Axes. */
 		for (axis_iter = tree->start_axis; axis_iter < tree->stop_axis; axis_iter++) {
@@ -524,7 +522,69 @@ static void refit_kdop_hull(const BVHTree *tree, BVHNode *node, int start, int e
 				bv[(2 * axis_iter) + 1] = newmax;
 		}
 	}
+}
 
+typedef struct BVHRefitData {
+	const BVHTree *tree;
+	int start, end;
+} BVHRefitData;
+
+static void refit_kdop_hull_task_cb(void *userdata, void *userdata_chunk, const int block, const int UNUSED(thread_id))
+{
+	const BVHRefitData *data = userdata;
+	const int start = data->start + block * KDOPBVH_REFIT_LEAFS_PER_TASK;
+	const int end = min_ii(start + KDOPBVH_REFIT_LEAFS_PER_TASK, data->end);
+
+	refit_kdop_hull_range(data->tree, userdata_chunk, start, end);
+}
+
+static void refit_kdop_hull_reduce_cb(void *userdata, void *__restrict chunk_join, void *__restrict chunk)
+{
+	const BVHRefitData *data = userdata;
+	float *bv_join = chunk_join;
+	const float *bv = chunk;
+	axis_t axis_iter;
+
+	for (axis_iter = data->tree->start_axis; axis_iter < data->tree->stop_axis; axis_iter++) {
+		bv_join[(2 * axis_iter)] = min_ff(bv_join[(2 * axis_iter)], bv[(2 * axis_iter)]);
+		bv_join[(2 * axis_iter) + 1] = max_ff(bv_join[(2 * axis_iter) + 1], bv[(2 * axis_iter) + 1]);
+	}
+}
+
+/**
+ * \note depends on the fact that the BVH's for each face is already build
+ */
+static void refit_kdop_hull(const BVHTree *tree, BVHNode *node, int start, int end)
+{
+	const int num_blocks = (end - start + KDOPBVH_REFIT_LEAFS_PER_TASK - 1) / KDOPBVH_REFIT_LEAFS_PER_TASK;
+
+	node_minmax_init(tree, node);
+
+	if (num_blocks > 1) {
+		/* Top levels of the tree only have a few branches to build,
+		 * get the bounds of their (many) leafs in parallel instead. */
+		BVHRefitData data = {.tree = tree, .start = start, .end = end};
+		float bv[13 * 2];  /* max 13 axis */
+		axis_t axis_iter;
+
+		for (axis_iter = tree->start_axis; axis_iter < tree->stop_axis; axis_iter++) {
+			bv[(2 * axis_iter)] = node->bv[(2 * axis_iter)];
+			bv[(2 * axis_iter) + 1] = node->bv[(2 * axis_iter) + 1];
+		}
+
+		BLI_task_parallel_range_reduce(
+		        0, num_blocks, &data, bv, sizeof(bv),
+		        refit_kdop_hull_task_cb, refit_kdop_hull_reduce_cb,
+		        true, false);
+
+		for (axis_iter = tree->start_axis; axis_iter < tree->stop_axis; axis_iter++) {
+			node->bv[(2 * axis_iter)] = bv[(2 * axis_iter)];
+			node->bv[(2 * axis_iter) + 1] = bv[(2 * axis_iter) + 1];
+		}
+	}
+	else {
+		refit_kdop_hull_range(tree, node->bv, start, end);
+	}
 }
 
 /**
@@ -1124,6 +1184,17 @@ bool BLI_bvhtree_update_node(BVHTree *tree, int index, const float co[3], const
 	return true;
 }
 
+typedef struct BVHUpdateTreeData {
+	BVHTree *tree;
+	BVHNode **branches;
+} BVHUpdateTreeData;
+
+static void bvhtree_update_tree_task_cb(void *userdata, const int j)
+{
+	BVHUpdateTreeData *data = userdata;
+	node_join(data->tree, data->branches[j]);
+}
+
 /* call BLI_bvhtree_update_node() first for every node/point/triangle */
 void BLI_bvhtree_update_tree(BVHTree *tree)
 {
@@ -1134,6 +1205,26 @@ void BLI_bvhtree_update_tree(BVHTree *tree)
 	BVHNode **root  = tree->nodes + tree->totleaf;
 	BVHNode **index = tree->nodes + tree->totleaf + tree->totbranch - 1;
 
+	if (tree->totbranch > KDOPBVH_THREAD_LEAF_THRESHOLD) {
+		/* Branches of a level only depend on the levels below it,
+		 * so join each level in parallel, starting with the deepest one. */
+		BVHUpdateTreeData data = {.tree = tree, .branches = root - 1};  /* Implicit trees use 1-based indexs */
+		const int tree_offset = 2 - tree->tree_type;
+		int level_first[32];
+		int i, depth;
+
+		for (i = 1, depth = 0; i <= tree->totbranch; i = i * tree->tree_type + tree_offset, depth++) {
+			level_first[depth] = i;
+		}
+
+		for (i = tree->totbranch + 1; depth--; i = level_first[depth]) {
+			BLI_task_parallel_range(
+			        level_first[depth], i, &data, bvhtree_update_tree_task_cb,
+			        i - level_first[depth] > KDOPBVH_THREAD_LEAF_THRESHOLD);
+		}
+		return;
+	}
+
 	for (; index >= root; index--)
 		node_join(tree, *index);
 }
@@ -1911,6 +2002,186 @@ void BLI_bvhtree_ray_cast_all(
 }
 
 
+/* -------------------------------------------------------------------- */
+
+/** \name BLI_bvhtree_find_nearest_array / BLI_bvhtree_ray_cast_array
+ *
+ * Run many queries at once, in parallel.
+ * Queries are sorted along a Morton curve first, so the ones handled by a task are close to each other
+ * and traverse mostly the same nodes of the tree.
+ *
+ * \note The callbacks are called from multiple threads and must be thread safe.
+ * \{ */
+
+typedef struct BVHQueryOrder {
+	unsigned int code;
+	int index;
+} BVHQueryOrder;
+
+/* Spread the lower 10 bits of \a x so there are two zero bits between each of them. */
+static unsigned int morton_spread_bits(unsigned int x)
+{
+	x &= 0x3ff;
+	x = (x | (x << 16)) & 0x030000ff;
+	x = (x | (x << 8)) & 0x0300f00f;
+	x = (x | (x << 4)) & 0x030c30c3;
+	x = (x | (x << 2)) & 0x09249249;
+	return x;
+}
+
+static int bvh_query_order_cmp(const void *a_v, const void *b_v)
+{
+	const BVHQueryOrder *a = a_v, *b = b_v;
+
+	if (a->code < b->code) return -1;
+	if (a->code > b->code) return  1;
+	return (a->index > b->index) - (a->index < b->index);
+}
+
+/**
+ * Return the order in which to run the queries at the \a co coordinates (using a 512^3 grid),
+ * the octant of the \a dir directions (when given) is used to group rays going the same way.
+ */
+static BVHQueryOrder *bvh_query_order_create(const float (*co)[3], const float (*dir)[3], const int len)
+{
+	BVHQueryOrder *order = MEM_mallocN(sizeof(*order) * (size_t)len, __func__);
+	float min[3], max[3], scale[3];
+	int i, axis;
+
+	INIT_MINMAX(min, max);
+	for (i = 0; i < len; i++) {
+		minmax_v3v3_v3(min, max, co[i]);
+	}
+	for (axis = 0; axis < 3; axis++) {
+		const float size = max[axis] - min[axis];
+		scale[axis] = (size > FLT_EPSILON) ? 511.0f / size : 0.0f;
+	}
+
+	for (i = 0; i < len; i++) {
+		unsigned int code = 0;
+		for (axis = 0; axis < 3; axis++) {
+			const unsigned int cell = (unsigned int)((co[i][axis] - min[axis]) * scale[axis]);
+			code |= morton_spread_bits(cell) << axis;
+		}
+		if (dir) {
+			code |= (unsigned int)((dir[i][0] < 0.0f) | ((dir[i][1] < 0.0f) << 1) | ((dir[i][2] < 0.0f) << 2)) << 27;
+		}
+		order[i].code = code;
+		order[i].index = i;
+	}
+
+	qsort(order, (size_t)len, sizeof(*order), bvh_query_order_cmp);
+
+	return order;
+}
+
+typedef struct BVHNearestArrayData {
+	BVHTree *tree;
+	const float (*co)[3];
+	BVHTreeNearest *nearest;
+	const BVHQueryOrder *order;
+
+	BVHTree_NearestPointCallback callback;
+	void *userdata;
+} BVHNearestArrayData;
+
+static void bvhtree_find_nearest_array_task_cb(void *userdata, const int i)
+{
+	const BVHNearestArrayData *data = userdata;
+	const int index = data->order ? data->order[i].index : i;
+
+	BLI_bvhtree_find_nearest(data->tree, data->co[index], &data->nearest[index], data->callback, data->userdata);
+}
+
+/**
+ * Find the nearest node of each of the \a co_len \a co coordinates.
+ *
+ * \param r_nearest: Array of \a co_len items, each initialized as for #BLI_bvhtree_find_nearest
+ * (\a index to -1 and \a dist_sq to the maximum square distance to search), receives the results.
+ */
+void BLI_bvhtree_find_nearest_array(
+        BVHTree *tree, const float (*co)[3], const int co_len, BVHTreeNearest *r_nearest,
+        BVHTree_NearestPointCallback callback, void *userdata)
+{
+	const bool use_threading = co_len > KDOPBVH_THREAD_LEAF_THRESHOLD;
+	BVHNearestArrayData data = {
+		.tree = tree, .co = co, .nearest = r_nearest, .order = NULL,
+		.callback = callback, .userdata = userdata,
+	};
+
+	if (use_threading) {
+		data.order = bvh_query_order_create(co, NULL, co_len);
+	}
+
+	BLI_task_parallel_range(0, co_len, &data, bvhtree_find_nearest_array_task_cb, use_threading);
+
+	if (data.order) {
+		MEM_freeN((void *)data.order);
+	}
+}
+
+typedef struct BVHRayCastArrayData {
+	BVHTree *tree;
+	const float (*co)[3];
+	const float (*dir)[3];
+	float radius;
+	BVHTreeRayHit *hit;
+	const BVHQueryOrder *order;
+
+	BVHTree_RayCastCallback callback;
+	void *userdata;
+	int flag;
+} BVHRayCastArrayData;
+
+static void bvhtree_ray_cast_array_task_cb(void *userdata, const int i)
+{
+	const BVHRayCastArrayData *data = userdata;
+	const int index = data->order ? data->order[i].index : i;
+
+	BLI_bvhtree_ray_cast_ex(
+	        data->tree, data->co[index], data->dir[index], data->radius, &data->hit[index],
+	        data->callback, data->userdata, data->flag);
+}
+
+/**
+ * Cast \a ray_len rays, from the \a co coordinates along the (normalized) \a dir directions.
+ *
+ * \param r_hit: Array of \a ray_len items, each initialized as for #BLI_bvhtree_ray_cast_ex
+ * (\a index to -1 and \a dist to the maximum distance), receives the results.
+ */
+void BLI_bvhtree_ray_cast_array_ex(
+        BVHTree *tree, const float (*co)[3], const float (*dir)[3], const int ray_len, float radius,
+        BVHTreeRayHit *r_hit, BVHTree_RayCastCallback callback, void *userdata,
+        int flag)
+{
+	const bool use_threading = ray_len > KDOPBVH_THREAD_LEAF_THRESHOLD;
+	BVHRayCastArrayData data = {
+		.tree = tree, .co = co, .dir = dir, .radius = radius, .hit = r_hit, .order = NULL,
+		.callback = callback, .userdata = userdata, .flag = flag,
+	};
+
+	if (use_threading) {
+		data.order = bvh_query_order_create(co, dir, ray_len);
+	}
+
+	BLI_task_parallel_range(0, ray_len, &data, bvhtree_ray_cast_array_task_cb, use_threading);
+
+	if (data.order) {
+		MEM_freeN((void *)data.order);
+	}
+}
+
+void BLI_bvhtree_ray_cast_array(
+        BVHTree *tree, const float (*co)[3], const float (*dir)[3], const int ray_len, float radius,
+        BVHTreeRayHit *r_hit, BVHTree_RayCastCallback callback, void *userdata)
+{
+	BLI_bvhtree_ray_cast_array_ex(
+	        tree, co, dir, ray_len, radius, r_hit, callback, userdata, BVH_RAYCAST_DEFAULT);
+}
+
+/** \} */
+
+
 /* -------------------------------------------------------------------- */
 
 /** \name BLI_bvhtree_range_query
@@ -29,6 +29,7 @@
 
 #include "BLI_math.h"
 #include "BLI_kdtree.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 #include "BLI_strict_flags.h"
 
@@ -61,6 +62,11 @@ struct KDTree {
 
 #define KD_NODE_UNSET ((unsigned int)-1)
 
+/* Subtrees with more nodes than this are balanced in their own task. */
+#define KD_BALANCE_THREAD_THRESHOLD 8192
+/* Minimum number of queries to run batched queries in parallel. */
+#define KD_QUERY_THREAD_THRESHOLD 1024
+
 /**
  * Creates or free a kdtree
  */
@@ -113,17 +119,14 @@ void BLI_kdtree_insert(KDTree *tree, int index, const float co[3])
 #endif
 }
 
-static unsigned int kdtree_balance(KDTreeNode *nodes, unsigned int totnode, unsigned int axis, const unsigned int ofs)
+/**
+ * Partition the nodes around their median along \a axis, returns the median.
+ */
+static unsigned int kdtree_balance_median(KDTreeNode *nodes, unsigned int totnode, unsigned int axis)
 {
-	KDTreeNode *node;
 	float co;
 	unsigned int left, right, median, i, j;
 
-	if (totnode <= 0)
-		return KD_NODE_UNSET;
-	else if (totnode == 1)
-		return 0 + ofs;
-	
 	/* quicksort style sorting around median */
 	left = 0;
 	right = totnode - 1;
@@ -151,9 +154,25 @@ static unsigned int kdtree_balance(KDTreeNode *nodes, unsigned int totnode, unsi
 			left = i + 1;
 	}
 
+	nodes[median].d = axis;
+
+	return median;
+}
+
+static unsigned int kdtree_balance(KDTreeNode *nodes, unsigned int totnode, unsigned int axis, const unsigned int ofs)
+{
+	KDTreeNode *node;
+	unsigned int median;
+
+	if (totnode <= 0)
+		return KD_NODE_UNSET;
+	else if (totnode == 1)
+		return 0 + ofs;
+
+	median = kdtree_balance_median(nodes, totnode, axis);
+
 	/* set node and sort subnodes */
 	node = &nodes[median];
-	node->d = axis;
 	axis = (axis + 1) % 3;
 	node->left = kdtree_balance(nodes, median, axis, ofs);
 	node->right = kdtree_balance(nodes + median + 1, (totnode - (median + 1)), axis, (median + 1) + ofs);
@@ -161,9 +180,119 @@ static unsigned int kdtree_balance(KDTreeNode *nodes, unsigned int totnode, unsi
 	return median + ofs;
 }
 
+typedef struct KDTreeBalanceTask {
+	unsigned int totnode, axis, ofs;
+} KDTreeBalanceTask;
+
+static void kdtree_balance_task_run(TaskPool *__restrict pool, void *taskdata, int threadid);
+
+static void kdtree_balance_task_push(
+        TaskPool *pool, unsigned int totnode, unsigned int axis, const unsigned int ofs, int threadid)
+{
+	KDTreeBalanceTask *task = MEM_mallocN(sizeof(*task), __func__);
+
+	task->totnode = totnode;
+	task->axis = axis;
+	task->ofs = ofs;
+
+	if (threadid == -1) {
+		BLI_task_pool_push(pool, kdtree_balance_task_run, task, true, TASK_PRIORITY_HIGH);
+	}
+	else {
+		BLI_task_pool_push_from_thread(pool, kdtree_balance_task_run, task, true, TASK_PRIORITY_HIGH, threadid);
+	}
+}
+
+/**
+ * Same as #kdtree_balance, large subtrees being balanced from other tasks of the \a pool.
+ *
+ * \note The root of a subtree only depends on its number of nodes,
+ * so parents can be linked to their children before those are balanced.
+ */
+static unsigned int kdtree_balance_parallel(
+        TaskPool *pool, KDTreeNode *nodes, unsigned int totnode, unsigned int axis, const unsigned int ofs,
+        int threadid)
+{
+	KDTreeNode *node;
+	unsigned int median, totnode_right;
+
+	if (totnode <= KD_BALANCE_THREAD_THRESHOLD) {
+		return kdtree_balance(nodes, totnode, axis, ofs);
+	}
+
+	median = kdtree_balance_median(nodes, totnode, axis);
+	totnode_right = totnode - (median + 1);
+
+	node = &nodes[median];
+	axis = (axis + 1) % 3;
+	node->left = (median / 2) + ofs;
+	node->right = (totnode_right / 2) + (median + 1) + ofs;
+
+	kdtree_balance_task_push(pool, median, axis, ofs, threadid);
+	kdtree_balance_parallel(pool, nodes + median + 1, totnode_right, axis, (median + 1) + ofs, threadid);
+
+	return median + ofs;
+}
+
+static void kdtree_balance_task_run(TaskPool *__restrict pool, void *taskdata, int threadid)
+{
+	KDTreeNode *nodes = BLI_task_pool_userdata(pool);
+	const KDTreeBalanceTask *task = taskdata;
+
+	kdtree_balance_parallel(pool, nodes + task->ofs, task->totnode, task->axis, task->ofs, threadid);
+}
+
+/**
+ * Store the nodes in breadth-first order,
+ * so the top levels of the tree visited by every query share the same cache lines.
+ */
+static void kdtree_reorder_breadth_first(KDTree *tree)
+{
+	KDTreeNode *nodes = tree->nodes;
+	KDTreeNode *nodes_new;
+	unsigned int head, tail;
+
+	if (tree->root == KD_NODE_UNSET) {
+		return;
+	}
+
+	/* the new array is used as the queue of nodes to visit, keep its size for further insertions */
+	nodes_new = MEM_mallocN(MEM_allocN_len(nodes), "KDTreeNode");
+	nodes_new[0] = nodes[tree->root];
+	for (head = 0, tail = 1; head < tail; head++) {
+		KDTreeNode *node = &nodes_new[head];
+		if (node->left != KD_NODE_UNSET) {
+			nodes_new[tail] = nodes[node->left];
+			node->left = tail++;
+		}
+		if (node->right != KD_NODE_UNSET) {
+			nodes_new[tail] = nodes[node->right];
+			node->right = tail++;
+		}
+	}
+	BLI_assert(tail == tree->totnode);
+
+	MEM_freeN(nodes);
+	tree->nodes = nodes_new;
+	tree->root = 0;
+}
+
 void BLI_kdtree_balance(KDTree *tree)
 {
-	tree->root = kdtree_balance(tree->nodes, tree->totnode, 0, 0);
+	if (tree->totnode > KD_BALANCE_THREAD_THRESHOLD) {
+		TaskScheduler *scheduler = BLI_task_scheduler_get();
+		TaskPool *pool = BLI_task_pool_create(scheduler, tree->nodes);
+
+		tree->root = kdtree_balance_parallel(pool, tree->nodes, tree->totnode, 0, 0, -1);
+
+		BLI_task_pool_work_and_wait(pool);
+		BLI_task_pool_free(pool);
+	}
+	else {
+		tree->root = kdtree_balance(tree->nodes, tree->totnode, 0, 0);
+	}
+
+	kdtree_reorder_breadth_first(tree);
 
 #ifdef DEBUG
 	tree->is_balanced = true;
@@ -674,3 +803,117 @@ finally:
 	if (stack != defaultstack)
 		MEM_freeN(stack);
 }
+
+/* -------------------------------------------------------------------- */
+
+/** \name Batched Queries
+ *
+ * Run the queries for many coordinates at once, in parallel.
+ * \{ */
+
+typedef struct KDTreeQueryArrayData {
+	const KDTree *tree;
+	const float (*co)[3];
+	KDTreeNearest *nearest;
+	int *found;
+	unsigned int n;
+
+	float range;
+	bool (*search_cb)(void *user_data, int co_index, int index, const float co[3], float dist_sq);
+	void *user_data;
+} KDTreeQueryArrayData;
+
+static void kdtree_find_nearest_array_task_cb(void *userdata, const int i)
+{
+	const KDTreeQueryArrayData *data = userdata;
+	KDTreeNearest *nearest = &data->nearest[i];
+
+	if (BLI_kdtree_find_nearest(data->tree, data->co[i], nearest) == -1) {
+		nearest->index = -1;
+	}
+}
+
+/**
+ * Find the nearest point of each of the \a co_len \a co coordinates.
+ *
+ * \param r_nearest: Array of \a co_len items, the index is set to -1 when nothing is found.
+ */
+void BLI_kdtree_find_nearest_array(
+        const KDTree *tree, const float (*co)[3], const int co_len,
+        KDTreeNearest *r_nearest)
+{
+	KDTreeQueryArrayData data = {.tree = tree, .co = co, .nearest = r_nearest};
+
+	BLI_task_parallel_range(
+	        0, co_len, &data, kdtree_find_nearest_array_task_cb,
+	        co_len > KD_QUERY_THREAD_THRESHOLD);
+}
+
+static void kdtree_find_nearest_n_array_task_cb(void *userdata, const int i)
+{
+	const KDTreeQueryArrayData *data = userdata;
+
+	data->found[i] = BLI_kdtree_find_nearest_n(
+	        data->tree, data->co[i], &data->nearest[(size_t)i * data->n], data->n);
+}
+
+/**
+ * Find the \a n nearest points of each of the \a co_len \a co coordinates.
+ *
+ * \param r_nearest: Array of \a co_len * \a n items, the results of \a co[i] start at \a r_nearest[i * n].
+ * \param r_found: Array of \a co_len items, receives the number of points found for each coordinate.
+ */
+void BLI_kdtree_find_nearest_n_array(
+        const KDTree *tree, const float (*co)[3], const int co_len,
+        KDTreeNearest *r_nearest, int *r_found, unsigned int n)
+{
+	KDTreeQueryArrayData data = {.tree = tree, .co = co, .nearest = r_nearest, .found = r_found, .n = n};
+
+	BLI_task_parallel_range(
+	        0, co_len, &data, kdtree_find_nearest_n_array_task_cb,
+	        co_len > KD_QUERY_THREAD_THRESHOLD);
+}
+
+typedef struct KDTreeRangeSearchArrayData {
+	const KDTreeQueryArrayData *data;
+	int co_index;
+} KDTreeRangeSearchArrayData;
+
+static bool kdtree_range_search_array_search_cb(void *user_data, int index, const float co[3], float dist_sq)
+{
+	const KDTreeRangeSearchArrayData *search_data = user_data;
+	const KDTreeQueryArrayData *data = search_data->data;
+
+	return data->search_cb(data->user_data, search_data->co_index, index, co, dist_sq);
+}
+
+static void kdtree_range_search_array_task_cb(void *userdata, const int i)
+{
+	KDTreeRangeSearchArrayData search_data = {.data = userdata, .co_index = i};
+
+	BLI_kdtree_range_search_cb(
+	        search_data.data->tree, search_data.data->co[i], search_data.data->range,
+	        kdtree_range_search_array_search_cb, &search_data);
+}
+
+/**
+ * A version of #BLI_kdtree_range_search_cb for each of the \a co_len \a co coordinates.
+ *
+ * \param search_cb: Called from multiple threads at once for every node found in \a range
+ * of the \a co_index coordinate, false return value ends the search for this coordinate.
+ */
+void BLI_kdtree_range_search_array_cb(
+        const KDTree *tree, const float (*co)[3], const int co_len, float range,
+        bool (*search_cb)(void *user_data, int co_index, int index, const float co[3], float dist_sq), void *user_data)
+{
+	KDTreeQueryArrayData data = {
+	    .tree = tree, .co = co, .range = range,
+	    .search_cb = search_cb, .user_data = user_data,
+	};
+
+	BLI_task_parallel_range(
+	        0, co_len, &data, kdtree_range_search_array_task_cb,
+	        co_len > KD_QUERY_THREAD_THRESHOLD);
+}
+
+/** \} */
@@ -36,11 +36,15 @@
  * - Freeing chunks.
  * - Iterating over allocated chunks
  *   (optionally when using the #BLI_MEMPOOL_ALLOW_ITER flag).
+ * - Allocating from multiple threads using per-thread caches
+ *   (optionally when using the #BLI_MEMPOOL_ALLOW_THREADS flag).
  */
 
 #include <string.h>
 #include <stdlib.h>
 
+#include "atomic_ops.h"
+
 #include "BLI_utildefines.h"
 
 #include "BLI_mempool.h" /* own include */
@@ -139,6 +143,20 @@ struct BLI_mempool {
 #ifdef USE_TOTALLOC
 	unsigned int totalloc;          /* number of elements allocated in total */
 #endif
+	/* protects the pool when used by thread caches, see #BLI_MEMPOOL_ALLOW_THREADS.
+	 * a plain atomic spin-lock, makesdna links the pool without the threading code */
+	uint32_t lock;
+};
+
+/**
+ * Per-thread cache of free elements, elements are moved between the cache
+ * and the pool in batches, so the pool lock is only taken once per batch.
+ */
+struct BLI_mempool_threadcache {
+	BLI_mempool *pool;
+	BLI_freenode *free;         /* free element list, owned by this thread. */
+	unsigned int totfree;       /* number of elements in free list */
+	unsigned int batch;         /* number of elements moved from/to the pool at once */
 };
 
 #define MEMPOOL_ELEM_SIZE_MIN (sizeof(void *) * 2)
@@ -289,6 +307,49 @@ static void mempool_chunk_free_all(BLI_mempool_chunk *mpchunk)
 	}
 }
 
+/**
+ * Free all the chunks except the first, re-initializing its free list.
+ * Only to be used when no element is in use.
+ */
+static void mempool_free_unused_chunks(BLI_mempool *pool)
+{
+	const unsigned int esize = pool->esize;
+	BLI_freenode *curnode;
+	unsigned int j;
+	BLI_mempool_chunk *first;
+
+	BLI_assert(pool->totused == 0);
+
+	first = pool->chunks;
+	mempool_chunk_free_all(first->next);
+	first->next = NULL;
+	pool->chunk_tail = first;
+
+#ifdef USE_TOTALLOC
+	pool->totalloc = pool->pchunk;
+#endif
+
+	/* temp alloc so valgrind doesn't complain when setting free'd blocks 'next' */
+#ifdef WITH_MEM_VALGRIND
+	VALGRIND_MEMPOOL_ALLOC(pool, CHUNK_DATA(first), pool->csize);
+#endif
+
+	curnode = CHUNK_DATA(first);
+	pool->free = curnode;
+
+	j = pool->pchunk;
+	while (j--) {
+		curnode->next = NODE_STEP_NEXT(curnode);
+		curnode = curnode->next;
+	}
+	curnode = NODE_STEP_PREV(curnode);
+	curnode->next = NULL; /* terminate the list */
+
+#ifdef WITH_MEM_VALGRIND
+	VALGRIND_MEMPOOL_FREE(pool, CHUNK_DATA(first));
+#endif
+}
+
 BLI_mempool *BLI_mempool_create(unsigned int esize, unsigned int totelem,
                                 unsigned int pchunk, unsigned int flag)
 {
@@ -335,6 +396,10 @@ BLI_mempool *BLI_mempool_create(unsigned int esize, unsigned int totelem,
 #endif
 	pool->totused = 0;
 
+	if (flag & BLI_MEMPOOL_ALLOW_THREADS) {
+		pool->lock = 0;
+	}
+
 	if (totelem) {
 		/* allocate the actual chunks */
 		for (i = 0; i < maxchunks; i++) {
@@ -436,42 +501,194 @@ void BLI_mempool_free(BLI_mempool *pool, void *addr)
 	if (UNLIKELY(pool->totused == 0) &&
 	    (pool->chunks->next))
 	{
-		const unsigned int esize = pool->esize;
-		BLI_freenode *curnode;
-		unsigned int j;
-		BLI_mempool_chunk *first;
+		mempool_free_unused_chunks(pool);
+	}
+}
 
-		first = pool->chunks;
-		mempool_chunk_free_all(first->next);
-		first->next = NULL;
-		pool->chunk_tail = first;
+/* -------------------------------------------------------------------- */
+/** \name Thread Cache API
+ *
+ * Allows allocating and freeing elements from multiple threads at once,
+ * each thread uses its own cache. The pool must only be accessed through
+ * thread caches while any of them is used from a thread other than the main one.
+ * \{ */
 
-#ifdef USE_TOTALLOC
-		pool->totalloc = pool->pchunk;
-#endif
+/**
+ * Create a cache for a pool created with #BLI_MEMPOOL_ALLOW_THREADS,
+ * to be used from a single thread.
+ */
+BLI_mempool_threadcache *BLI_mempool_threadcache_create(BLI_mempool *pool)
+{
+	BLI_mempool_threadcache *cache;
+
+	BLI_assert(pool->flag & BLI_MEMPOOL_ALLOW_THREADS);
+
+	cache = MEM_mallocN(sizeof(*cache), "memory pool thread cache");
+	cache->pool = pool;
+	cache->free = NULL;
+	cache->totfree = 0;
+	cache->batch = pool->pchunk;
+
+	return cache;
+}
+
+/**
+ * Move a batch of free elements from the pool to the cache, allocating a new chunk when needed.
+ */
+static void mempool_lock(BLI_mempool *pool)
+{
+	while (atomic_cas_uint32(&pool->lock, 0, 1) != 0) {
+		/* pass */
+	}
+}
+
+static void mempool_unlock(BLI_mempool *pool)
+{
+	atomic_cas_uint32(&pool->lock, 1, 0);
+}
+
+static void mempool_threadcache_refill(BLI_mempool_threadcache *cache)
+{
+	BLI_mempool *pool = cache->pool;
+	BLI_freenode *first, *last;
+	unsigned int tot = 1;
+
+	mempool_lock(pool);
+
+	if (pool->free == NULL) {
+		/* take the whole chunk, no need to walk its elements */
+		BLI_mempool_chunk *mpchunk = mempool_chunk_alloc(pool);
+		mempool_chunk_add(pool, mpchunk, NULL);
+		first = pool->free;
+		pool->free = NULL;
+		tot = pool->pchunk;
+	}
+	else {
+		first = last = pool->free;
+		while (tot < cache->batch && last->next) {
+			last = last->next;
+			tot++;
+		}
+		pool->free = last->next;
+		last->next = NULL;
+	}
+	pool->totused += tot;
+
+	mempool_unlock(pool);
+
+	cache->free = first;
+	cache->totfree = tot;
+}
+
+/**
+ * Return  tot elements from the beginning of the free list of the cache to the pool.
+ */
+static void mempool_threadcache_return(BLI_mempool_threadcache *cache, unsigned int tot)
+{
+	BLI_mempool *pool = cache->pool;
+	BLI_freenode *first = cache->free, *last = first;
+	unsigned int i;
+
+	BLI_assert(tot != 0 && tot <= cache->totfree);
+
+	for (i = 1; i < tot; i++) {
+		last = last->next;
+	}
+	cache->free = last->next;
+	cache->totfree -= tot;
+
+	mempool_lock(pool);
+
+	last->next = pool->free;
+	pool->free = first;
+	pool->totused -= tot;
+
+	/* nothing is in use; free all the chunks except the first */
+	if (UNLIKELY(pool->totused == 0) &&
+	    (pool->chunks->next))
+	{
+		mempool_free_unused_chunks(pool);
+	}
+
+	mempool_unlock(pool);
+}
+
+void *BLI_mempool_threadcache_alloc(BLI_mempool_threadcache *cache)
+{
+	BLI_freenode *free_pop;
+
+	if (UNLIKELY(cache->free == NULL)) {
+		mempool_threadcache_refill(cache);
+	}
+
+	free_pop = cache->free;
+
+	if (cache->pool->flag & BLI_MEMPOOL_ALLOW_ITER) {
+		free_pop->freeword = USEDWORD;
+	}
+
+	cache->free = free_pop->next;
+	cache->totfree--;
 
-		/* temp alloc so valgrind doesn't complain when setting free'd blocks 'next' */
 #ifdef WITH_MEM_VALGRIND
-		VALGRIND_MEMPOOL_ALLOC(pool, CHUNK_DATA(first), pool->csize);
+	VALGRIND_MEMPOOL_ALLOC(cache->pool, free_pop, cache->pool->esize);
 #endif
 
-		curnode = CHUNK_DATA(first);
-		pool->free = curnode;
+	return (void *)free_pop;
+}
 
-		j = pool->pchunk;
-		while (j--) {
-			curnode->next = NODE_STEP_NEXT(curnode);
-			curnode = curnode->next;
-		}
-		curnode = NODE_STEP_PREV(curnode);
-		curnode->next = NULL; /* terminate the list */
+void *BLI_mempool_threadcache_calloc(BLI_mempool_threadcache *cache)
+{
+	void *retval = BLI_mempool_threadcache_alloc(cache);
+	memset(retval, 0, (size_t)cache->pool->esize);
+	return retval;
+}
+
+/**
+ * Free an element allocated from any cache of the pool (or the pool itself).
+ */
+void BLI_mempool_threadcache_free(BLI_mempool_threadcache *cache, void *addr)
+{
+	BLI_freenode *newhead = addr;
+
+	if (cache->pool->flag & BLI_MEMPOOL_ALLOW_ITER) {
+#ifndef NDEBUG
+		/* this will detect double free's */
+		BLI_assert(newhead->freeword != FREEWORD);
+#endif
+		newhead->freeword = FREEWORD;
+	}
+
+	newhead->next = cache->free;
+	cache->free = newhead;
+	cache->totfree++;
 
 #ifdef WITH_MEM_VALGRIND
-		VALGRIND_MEMPOOL_FREE(pool, CHUNK_DATA(first));
+	VALGRIND_MEMPOOL_FREE(cache->pool, addr);
 #endif
+
+	/* keep a batch for the following allocations, return the rest */
+	if (UNLIKELY(cache->totfree >= cache->batch * 2)) {
+		mempool_threadcache_return(cache, cache->batch);
 	}
 }
 
+/**
+ * Return all free elements of the cache to the pool and free the cache.
+ */
+void BLI_mempool_threadcache_destroy(BLI_mempool_threadcache *cache)
+{
+	if (cache->totfree != 0) {
+		mempool_threadcache_return(cache, cache->totfree);
+	}
+	MEM_freeN(cache);
+}
+
+/** \} */
+
+/**
+ * \note Elements kept by thread caches for further allocations are counted as used.
+ */
 int BLI_mempool_count(BLI_mempool *pool)
 {
 	return (int)pool->totused;
@@ -112,6 +112,7 @@
 
 #include "BLI_listbase.h"
 #include "BLI_mempool.h"
+#include "BLI_task.h"
 
 #include "BLI_strict_flags.h"
 
@@ -167,6 +168,14 @@
 #  define BCHUNK_HASH_LEN 4
 #endif
 
+#ifdef USE_HASH_TABLE_ACCUMULATE
+/* Hash and accumulate large arrays in parallel, the results are identical to the single threaded code.
+ * Blocks of this many elements are handled by each task.
+ */
+#  define USE_HASH_TABLE_THREADED
+#  define BCHUNK_HASH_THREAD_BLOCK_LEN 16384
+#endif
+
 /* Calculate the key once and reuse it
  */
 #define USE_HASH_TABLE_KEY_CACHE
@@ -783,7 +792,7 @@ static uint hash_data(const uchar *key, size_t n)
 
 
 #ifdef USE_HASH_TABLE_ACCUMULATE
-static void hash_array_from_data(
+static void hash_array_from_data_serial(
         const BArrayInfo *info, const uchar *data_slice, const size_t data_slice_len,
         hash_key *hash_array)
 {
@@ -800,6 +809,53 @@ static void hash_array_from_data(
 	}
 }
 
+#ifdef USE_HASH_TABLE_THREADED
+
+typedef struct HashArrayFromDataTask {
+	const BArrayInfo *info;
+	const uchar *data_slice;
+	size_t data_slice_len;
+	hash_key *hash_array;
+} HashArrayFromDataTask;
+
+static void hash_array_from_data_task_cb(void *userdata, const int block)
+{
+	const HashArrayFromDataTask *data = userdata;
+	const size_t chunk_stride = data->info->chunk_stride;
+	const size_t i_start = (size_t)block * BCHUNK_HASH_THREAD_BLOCK_LEN;
+	const size_t i_step_start = i_start * chunk_stride;
+	const size_t i_step_end = MIN2(i_step_start + (BCHUNK_HASH_THREAD_BLOCK_LEN * chunk_stride), data->data_slice_len);
+
+	hash_array_from_data_serial(
+	        data->info, &data->data_slice[i_step_start], i_step_end - i_step_start,
+	        &data->hash_array[i_start]);
+}
+
+#endif  /* USE_HASH_TABLE_THREADED */
+
+static void hash_array_from_data(
+        const BArrayInfo *info, const uchar *data_slice, const size_t data_slice_len,
+        hash_key *hash_array)
+{
+#ifdef USE_HASH_TABLE_THREADED
+	const size_t hash_array_len = (data_slice_len + (info->chunk_stride - 1)) / info->chunk_stride;
+	if (hash_array_len >= BCHUNK_HASH_THREAD_BLOCK_LEN * 2) {
+		HashArrayFromDataTask data = {
+			.info = info,
+			.data_slice = data_slice,
+			.data_slice_len = data_slice_len,
+			.hash_array = hash_array,
+		};
+		const int blocks_len = (int)((hash_array_len + (BCHUNK_HASH_THREAD_BLOCK_LEN - 1)) /
+		                             BCHUNK_HASH_THREAD_BLOCK_LEN);
+		BLI_task_parallel_range(0, blocks_len, &data, hash_array_from_data_task_cb, true);
+		return;
+	}
+#endif
+
+	hash_array_from_data_serial(info, data_slice, data_slice_len, hash_array);
+}
+
 /*
  * Similar to hash_array_from_data,
  * but able to step into the next chunk if we run-out of data.
@@ -828,6 +884,67 @@ static void hash_array_from_cref(
 	BLI_assert(i == hash_array_len);
 }
 
+#ifdef USE_HASH_TABLE_THREADED
+
+typedef struct HashAccumTask {
+	hash_key *hash_array_src;
+	hash_key *hash_array_dst;
+	size_t hash_array_search_len;
+	size_t hash_offset;
+} HashAccumTask;
+
+static void hash_accum_task_cb(void *userdata, const int block)
+{
+	const HashAccumTask *data = userdata;
+	const hash_key *src = data->hash_array_src;
+	hash_key *dst = data->hash_array_dst;
+	const size_t hash_offset = data->hash_offset;
+	const size_t i_start = (size_t)block * BCHUNK_HASH_THREAD_BLOCK_LEN;
+	const size_t i_end = MIN2(i_start + BCHUNK_HASH_THREAD_BLOCK_LEN, data->hash_array_search_len);
+
+	for (size_t i = i_start; i < i_end; i++) {
+		dst[i] = src[i] + (src[i + hash_offset]) * ((src[i] & 0xff) + 1);
+	}
+}
+
+/**
+ * Threaded version of #hash_accum.
+ *
+ * The single threaded loop reads values ahead of the one it writes,
+ * so each step reads from one buffer and writes into another to give the same result.
+ * Values past \a hash_array_search_len are never written, so they only need to be copied once.
+ */
+static void hash_accum_threaded(
+        hash_key *hash_array, const size_t hash_array_len,
+        const size_t hash_array_search_len, size_t iter_steps)
+{
+	hash_key *hash_array_tmp = MEM_mallocN(sizeof(*hash_array_tmp) * hash_array_len, __func__);
+	memcpy(&hash_array_tmp[hash_array_search_len], &hash_array[hash_array_search_len],
+	       sizeof(*hash_array_tmp) * (hash_array_len - hash_array_search_len));
+
+	HashAccumTask data = {
+		.hash_array_src = hash_array,
+		.hash_array_dst = hash_array_tmp,
+		.hash_array_search_len = hash_array_search_len,
+	};
+	const int blocks_len = (int)((hash_array_search_len + (BCHUNK_HASH_THREAD_BLOCK_LEN - 1)) /
+	                             BCHUNK_HASH_THREAD_BLOCK_LEN);
+
+	while (iter_steps != 0) {
+		data.hash_offset = iter_steps;
+		BLI_task_parallel_range(0, blocks_len, &data, hash_accum_task_cb, true);
+		SWAP(hash_key *, data.hash_array_src, data.hash_array_dst);
+		iter_steps -= 1;
+	}
+
+	if (data.hash_array_src != hash_array) {
+		memcpy(hash_array, data.hash_array_src, sizeof(*hash_array) * hash_array_search_len);
+	}
+	MEM_freeN(hash_array_tmp);
+}
+
+#endif  /* USE_HASH_TABLE_THREADED */
+
 static void hash_accum(hash_key *hash_array, const size_t hash_array_len, size_t iter_steps)
 {
 	/* _very_ unlikely, can happen if you select a chunk-size of 1 for example. */
@@ -836,6 +953,14 @@ static void hash_accum(hash_key *hash_array, const size_t hash_array_len, size_t
 	}
 
 	const size_t hash_array_search_len = hash_array_len - iter_steps;
+
+#ifdef USE_HASH_TABLE_THREADED
+	if (hash_array_search_len >= BCHUNK_HASH_THREAD_BLOCK_LEN * 2) {
+		hash_accum_threaded(hash_array, hash_array_len, hash_array_search_len, iter_steps);
+		return;
+	}
+#endif
+
 	while (iter_steps != 0) {
 		const size_t hash_offset = iter_steps;
 		for (uint i = 0; i < hash_array_search_len; i++) {
@@ -421,6 +421,35 @@ MALWAYS_INLINE __m128 _bli_math_blend_sse(const __m128 mask,
 	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
 }
 
+/* Load 4 packed 3D vectors, one register per axis. */
+MALWAYS_INLINE void _bli_math_load_v3_x4(const float (*v)[3],
+                                         __m128 *r_x, __m128 *r_y, __m128 *r_z)
+{
+	/* x0 y0 z0 x1, y1 z1 x2 y2, z2 x3 y3 z3 */
+	const __m128 a = _mm_loadu_ps(v[0]);
+	const __m128 b = _mm_loadu_ps(&v[1][1]);
+	const __m128 c = _mm_loadu_ps(&v[2][2]);
+	const __m128 xy = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));
+	const __m128 yz = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1));
+	*r_x = _mm_shuffle_ps(a, xy, _MM_SHUFFLE(2, 0, 3, 0));
+	*r_y = _mm_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+	*r_z = _mm_shuffle_ps(yz, c, _MM_SHUFFLE(3, 0, 3, 1));
+}
+
+/* Store 4 packed 3D vectors, the inverse of #_bli_math_load_v3_x4. */
+MALWAYS_INLINE void _bli_math_store_v3_x4(float (*r)[3],
+                                          const __m128 x, const __m128 y, const __m128 z)
+{
+	const __m128 xy_lo = _mm_unpacklo_ps(x, y);
+	const __m128 xy_hi = _mm_unpackhi_ps(x, y);
+	const __m128 zx = _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0));
+	const __m128 yz = _mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1));
+	const __m128 zxy = _mm_shuffle_ps(z, xy_hi, _MM_SHUFFLE(3, 2, 3, 2));
+	_mm_storeu_ps(r[0], _mm_shuffle_ps(xy_lo, zx, _MM_SHUFFLE(2, 0, 1, 0)));
+	_mm_storeu_ps(&r[1][1], _mm_shuffle_ps(yz, xy_hi, _MM_SHUFFLE(1, 0, 2, 0)));
+	_mm_storeu_ps(&r[2][2], _mm_shuffle_ps(zxy, zxy, _MM_SHUFFLE(1, 3, 2, 0)));
+}
+
 #endif  /* __SSE2__ */
 
 #endif /* __MATH_BASE_INLINE_C__ */
@@ -559,6 +559,64 @@ void mul_v3_mat3_m4v3(float r[3], const float mat[4][4], const float vec[3])
 	r[2] = x * mat[0][2] + y * mat[1][2] + mat[2][2] * vec[2];
 }
 
+/* Batch versions of the functions above, handling 4 vectors at once where SSE2 is available.
+ * Results match calling the single vector functions on each item,
+ * \a r_arr may be the same array as \a vec_arr. */
+
+BLI_INLINE void mul_v3_m4v3_array_impl(
+        float (*r_arr)[3], const float mat[4][4], const float (*vec_arr)[3], const int vec_num,
+        const bool use_translation)
+{
+	int i = 0;
+#ifdef __SSE2__
+	/* Each matrix element splat across a register, indexed by output axis. */
+	const __m128 col[3][4] = {
+		{_mm_set1_ps(mat[0][0]), _mm_set1_ps(mat[1][0]), _mm_set1_ps(mat[2][0]), _mm_set1_ps(mat[3][0])},
+		{_mm_set1_ps(mat[0][1]), _mm_set1_ps(mat[1][1]), _mm_set1_ps(mat[2][1]), _mm_set1_ps(mat[3][1])},
+		{_mm_set1_ps(mat[0][2]), _mm_set1_ps(mat[1][2]), _mm_set1_ps(mat[2][2]), _mm_set1_ps(mat[3][2])},
+	};
+	for (; i + 4 <= vec_num; i += 4) {
+		__m128 x, y, z, r[3];
+		_bli_math_load_v3_x4(&vec_arr[i], &x, &y, &z);
+		for (int j = 0; j < 3; j++) {
+			r[j] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, col[j][0]), _mm_mul_ps(y, col[j][1])), _mm_mul_ps(col[j][2], z));
+			if (use_translation) {
+				r[j] = _mm_add_ps(r[j], col[j][3]);
+			}
+		}
+		_bli_math_store_v3_x4(&r_arr[i], r[0], r[1], r[2]);
+	}
+#endif
+	for (; i < vec_num; i++) {
+		if (use_translation) {
+			mul_v3_m4v3(r_arr[i], mat, vec_arr[i]);
+		}
+		else {
+			mul_v3_mat3_m4v3(r_arr[i], mat, vec_arr[i]);
+		}
+	}
+}
+
+void mul_v3_m4v3_array(float (*r_arr)[3], const float mat[4][4], const float (*vec_arr)[3], const int vec_num)
+{
+	mul_v3_m4v3_array_impl(r_arr, mat, vec_arr, vec_num, true);
+}
+
+void mul_m4_v3_array(const float mat[4][4], float (*vec_arr)[3], const int vec_num)
+{
+	mul_v3_m4v3_array_impl(vec_arr, mat, (const float (*)[3])vec_arr, vec_num, true);
+}
+
+void mul_v3_mat3_m4v3_array(float (*r_arr)[3], const float mat[4][4], const float (*vec_arr)[3], const int vec_num)
+{
+	mul_v3_m4v3_array_impl(r_arr, mat, vec_arr, vec_num, false);
+}
+
+void mul_mat3_m4_v3_array(const float mat[4][4], float (*vec_arr)[3], const int vec_num)
+{
+	mul_v3_m4v3_array_impl(vec_arr, mat, (const float (*)[3])vec_arr, vec_num, false);
+}
+
 void mul_project_m4_v3(const float mat[4][4], float vec[3])
 {
 	/* absolute value to not flip the frustum upside down behind the camera */
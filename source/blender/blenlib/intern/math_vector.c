@@ -1230,6 +1230,78 @@ void copy_vn_fl(float *array_tar, const int size, const float val)
 	}
 }
 
+/** \name Batch versions of 3D vector functions.
+ *
+ * Operate on arrays of packed vectors, handling 4 vectors at once where SSE2 is available.
+ * Results match calling the single vector functions on each item.
+ * \{ */
+
+void normalize_v3_array(float (*vec_arr)[3], const int vec_num)
+{
+	int i = 0;
+#ifdef __SSE2__
+	const __m128 eps = _mm_set1_ps(1.0e-35f);
+	const __m128 one = _mm_set1_ps(1.0f);
+	for (; i + 4 <= vec_num; i += 4) {
+		__m128 x, y, z;
+		_bli_math_load_v3_x4(&vec_arr[i], &x, &y, &z);
+		const __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+		/* zero length vectors become NAN here, then get masked to zero (as #normalize_v3 does). */
+		const __m128 mask = _mm_cmpgt_ps(d, eps);
+		const __m128 mul = _mm_div_ps(one, _mm_sqrt_ps(d));
+		_bli_math_store_v3_x4(
+		        &vec_arr[i],
+		        _mm_and_ps(mask, _mm_mul_ps(x, mul)),
+		        _mm_and_ps(mask, _mm_mul_ps(y, mul)),
+		        _mm_and_ps(mask, _mm_mul_ps(z, mul)));
+	}
+#endif
+	for (; i < vec_num; i++) {
+		normalize_v3(vec_arr[i]);
+	}
+}
+
+void dot_v3v3_array(float *r_dot, const float (*vec_a)[3], const float (*vec_b)[3], const int vec_num)
+{
+	int i = 0;
+#ifdef __SSE2__
+	for (; i + 4 <= vec_num; i += 4) {
+		__m128 ax, ay, az, bx, by, bz;
+		_bli_math_load_v3_x4(&vec_a[i], &ax, &ay, &az);
+		_bli_math_load_v3_x4(&vec_b[i], &bx, &by, &bz);
+		_mm_storeu_ps(&r_dot[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz)));
+	}
+#endif
+	for (; i < vec_num; i++) {
+		r_dot[i] = dot_v3v3(vec_a[i], vec_b[i]);
+	}
+}
+
+/**
+ * \note \a r_arr must not overlap \a vec_a or \a vec_b.
+ */
+void cross_v3_v3v3_array(float (*r_arr)[3], const float (*vec_a)[3], const float (*vec_b)[3], const int vec_num)
+{
+	int i = 0;
+#ifdef __SSE2__
+	for (; i + 4 <= vec_num; i += 4) {
+		__m128 ax, ay, az, bx, by, bz;
+		_bli_math_load_v3_x4(&vec_a[i], &ax, &ay, &az);
+		_bli_math_load_v3_x4(&vec_b[i], &bx, &by, &bz);
+		_bli_math_store_v3_x4(
+		        &r_arr[i],
+		        _mm_sub_ps(_mm_mul_ps(ay, bz), _mm_mul_ps(az, by)),
+		        _mm_sub_ps(_mm_mul_ps(az, bx), _mm_mul_ps(ax, bz)),
+		        _mm_sub_ps(_mm_mul_ps(ax, by), _mm_mul_ps(ay, bx)));
+	}
+#endif
+	for (; i < vec_num; i++) {
+		cross_v3_v3v3(r_arr[i], vec_a[i], vec_b[i]);
+	}
+}
+
+/** \} */
+
 /** \name Double precision versions 'db'.
  * \{ */
 
@@ -0,0 +1,889 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2017 Blender Foundation.
+ * All rights reserved.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file blender/blenlib/intern/simple_expr.c
+ *  \ingroup bli
+ *
+ * Parses an expression into a list of instructions for a small stack machine,
+ * which is then evaluated without any allocations. The parser is a recursive
+ * descent parser following the Python grammar, see BLI_simple_expr.h for the
+ * supported subset.
+ */
+
+#include <ctype.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_alloca.h"
+#include "BLI_math_base.h"
+#include "BLI_simple_expr.h"  /* own include */
+#include "BLI_utildefines.h"
+
+/* -------------------------------------------------------------------- */
+/** \name Internal Types
+ * \{ */
+
+typedef enum eOpCode {
+	/* push constant: ( -> dval) */
+	OPCODE_CONST,
+	/* push parameter: ( -> params[ival]) */
+	OPCODE_PARAMETER,
+	/* function with one argument: (a -> func1(a)) */
+	OPCODE_FUNC1,
+	/* function with two arguments: (a b -> func2(a, b)) */
+	OPCODE_FUNC2,
+	/* minimum or maximum of the last 'count' values: (a b ... -> min(a, b, ...)) */
+	OPCODE_MIN,
+	OPCODE_MAX,
+	/* unconditional jump */
+	OPCODE_JMP,
+	/* jump if the condition is false, dropping the value before it as well:
+	 * (a cond -> a), or (a cond -> ) and jump */
+	OPCODE_JMP_ELSE,
+	/* jump if true, leaving the value for 'or': (a -> a) and jump, or (a -> ) */
+	OPCODE_JMP_OR,
+	/* jump if false, leaving the value for 'and': (a -> a) and jump, or (a -> ) */
+	OPCODE_JMP_AND,
+} eOpCode;
+
+typedef double (*UnaryOpFunc)(double);
+typedef double (*BinaryOpFunc)(double, double);
+
+typedef struct ExprOp {
+	eOpCode opcode;
+
+	/* number of instructions to skip for jumps, number of arguments for min and max */
+	int count;
+
+	union {
+		int ival;
+		double dval;
+		UnaryOpFunc func1;
+		BinaryOpFunc func2;
+	} arg;
+} ExprOp;
+
+struct SimpleExprParsed {
+	int ops_count;
+	ExprOp *ops;
+
+	/* size of the evaluation stack needed */
+	int max_stack;
+
+	/* number of parameters the expression was parsed with */
+	int param_names_len;
+};
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Public API
+ * \{ */
+
+void BLI_simple_expr_free(SimpleExprParsed *expr)
+{
+	if (expr != NULL) {
+		MEM_SAFE_FREE(expr->ops);
+		MEM_freeN(expr);
+	}
+}
+
+bool BLI_simple_expr_is_valid(const SimpleExprParsed *expr)
+{
+	return expr != NULL && expr->ops_count > 0;
+}
+
+eSimpleExpr_EvalStatus BLI_simple_expr_evaluate(
+        const SimpleExprParsed *expr, const double *params, int params_len, double *r_result)
+{
+	*r_result = 0.0;
+
+	if (!BLI_simple_expr_is_valid(expr) || (params_len != expr->param_names_len)) {
+		return SIMPLE_EXPR_INVALID;
+	}
+
+	double *stack = BLI_array_alloca(stack, expr->max_stack);
+	int sp = 0;
+
+	for (int pc = 0; pc < expr->ops_count; pc++) {
+		const ExprOp *op = &expr->ops[pc];
+
+		switch (op->opcode) {
+			case OPCODE_CONST:
+				stack[sp++] = op->arg.dval;
+				break;
+			case OPCODE_PARAMETER:
+				stack[sp++] = params[op->arg.ival];
+				break;
+			case OPCODE_FUNC1:
+				stack[sp - 1] = op->arg.func1(stack[sp - 1]);
+				break;
+			case OPCODE_FUNC2:
+				stack[sp - 2] = op->arg.func2(stack[sp - 2], stack[sp - 1]);
+				sp--;
+				break;
+			case OPCODE_MIN:
+			case OPCODE_MAX:
+			{
+				double value = stack[sp - op->count];
+
+				for (int i = op->count - 1; i > 0; i--) {
+					const double arg = stack[sp - i];
+
+					if ((op->opcode == OPCODE_MIN) ? (arg < value) : (arg > value)) {
+						value = arg;
+					}
+				}
+
+				sp -= op->count - 1;
+				stack[sp - 1] = value;
+				break;
+			}
+			case OPCODE_JMP:
+				pc += op->count;
+				break;
+			case OPCODE_JMP_ELSE:
+				if (stack[--sp] == 0.0) {
+					sp--;
+					pc += op->count;
+				}
+				break;
+			case OPCODE_JMP_OR:
+			case OPCODE_JMP_AND:
+				if ((stack[sp - 1] != 0.0) == (op->opcode == OPCODE_JMP_OR)) {
+					pc += op->count;
+				}
+				else {
+					sp--;
+				}
+				break;
+		}
+
+		/* Python raises errors for these, or returns values which aren't numbers */
+		if ((sp > 0) && !isfinite(stack[sp - 1])) {
+			return SIMPLE_EXPR_MATH_ERROR;
+		}
+	}
+
+	BLI_assert(sp == 1);
+	*r_result = stack[0];
+	return SIMPLE_EXPR_SUCCESS;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Operators and Builtins
+ * \{ */
+
+static double op_negate(double arg)
+{
+	return -arg;
+}
+
+static double op_not(double arg)
+{
+	return (arg != 0.0) ? 0.0 : 1.0;
+}
+
+static double op_add(double a, double b)
+{
+	return a + b;
+}
+
+static double op_sub(double a, double b)
+{
+	return a - b;
+}
+
+static double op_mul(double a, double b)
+{
+	return a * b;
+}
+
+static double op_div(double a, double b)
+{
+	return a / b;
+}
+
+static double op_eq(double a, double b)
+{
+	return (a == b) ? 1.0 : 0.0;
+}
+
+static double op_ne(double a, double b)
+{
+	return (a != b) ? 1.0 : 0.0;
+}
+
+static double op_lt(double a, double b)
+{
+	return (a < b) ? 1.0 : 0.0;
+}
+
+static double op_le(double a, double b)
+{
+	return (a <= b) ? 1.0 : 0.0;
+}
+
+static double op_gt(double a, double b)
+{
+	return (a > b) ? 1.0 : 0.0;
+}
+
+static double op_ge(double a, double b)
+{
+	return (a >= b) ? 1.0 : 0.0;
+}
+
+static double op_radians(double arg)
+{
+	return arg * M_PI / 180.0;
+}
+
+static double op_degrees(double arg)
+{
+	return arg * 180.0 / M_PI;
+}
+
+static double op_log_base(double a, double b)
+{
+	return log(a) / log(b);
+}
+
+typedef struct BuiltinConstDef {
+	const char *name;
+	double value;
+} BuiltinConstDef;
+
+static const BuiltinConstDef builtin_consts[] = {
+	{"pi", M_PI},
+	{"e", M_E},
+	{NULL, 0.0},
+};
+
+typedef struct BuiltinOpDef {
+	const char *name;
+	eOpCode opcode;
+	/* number of arguments, 0 for any number of at least two */
+	int args;
+	UnaryOpFunc func1;
+	BinaryOpFunc func2;
+} BuiltinOpDef;
+
+static const BuiltinOpDef builtin_ops[] = {
+	{"radians", OPCODE_FUNC1, 1, op_radians, NULL},
+	{"degrees", OPCODE_FUNC1, 1, op_degrees, NULL},
+	{"abs", OPCODE_FUNC1, 1, fabs, NULL},
+	{"fabs", OPCODE_FUNC1, 1, fabs, NULL},
+	{"floor", OPCODE_FUNC1, 1, floor, NULL},
+	{"ceil", OPCODE_FUNC1, 1, ceil, NULL},
+	{"trunc", OPCODE_FUNC1, 1, trunc, NULL},
+	{"sin", OPCODE_FUNC1, 1, sin, NULL},
+	{"cos", OPCODE_FUNC1, 1, cos, NULL},
+	{"tan", OPCODE_FUNC1, 1, tan, NULL},
+	{"asin", OPCODE_FUNC1, 1, asin, NULL},
+	{"acos", OPCODE_FUNC1, 1, acos, NULL},
+	{"atan", OPCODE_FUNC1, 1, atan, NULL},
+	{"atan2", OPCODE_FUNC2, 2, NULL, atan2},
+	{"sinh", OPCODE_FUNC1, 1, sinh, NULL},
+	{"cosh", OPCODE_FUNC1, 1, cosh, NULL},
+	{"tanh", OPCODE_FUNC1, 1, tanh, NULL},
+	{"exp", OPCODE_FUNC1, 1, exp, NULL},
+	{"log", OPCODE_FUNC1, 1, log, NULL},
+	{"log", OPCODE_FUNC2, 2, NULL, op_log_base},
+	{"log10", OPCODE_FUNC1, 1, log10, NULL},
+	{"sqrt", OPCODE_FUNC1, 1, sqrt, NULL},
+	{"pow", OPCODE_FUNC2, 2, NULL, pow},
+	{"fmod", OPCODE_FUNC2, 2, NULL, fmod},
+	{"hypot", OPCODE_FUNC2, 2, NULL, hypot},
+	{"min", OPCODE_MIN, 0, NULL, NULL},
+	{"max", OPCODE_MAX, 0, NULL, NULL},
+	{NULL, OPCODE_CONST, 0, NULL, NULL},
+};
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Expression Parser
+ * \{ */
+
+enum {
+	TOKEN_EOF = 0,
+	/* single character tokens use the character itself */
+	TOKEN_NUMBER = 256,
+	TOKEN_ID,
+	TOKEN_POW,
+	TOKEN_EQ,
+	TOKEN_NE,
+	TOKEN_LE,
+	TOKEN_GE,
+	TOKEN_AND,
+	TOKEN_OR,
+	TOKEN_NOT,
+	TOKEN_IF,
+	TOKEN_ELSE,
+	TOKEN_TRUE,
+	TOKEN_FALSE,
+};
+
+typedef struct KeywordTokenDef {
+	const char *name;
+	short token;
+} KeywordTokenDef;
+
+static const KeywordTokenDef keyword_list[] = {
+	{"and", TOKEN_AND},
+	{"or", TOKEN_OR},
+	{"not", TOKEN_NOT},
+	{"if", TOKEN_IF},
+	{"else", TOKEN_ELSE},
+	{"True", TOKEN_TRUE},
+	{"False", TOKEN_FALSE},
+	{NULL, TOKEN_EOF},
+};
+
+static const KeywordTokenDef operator_list[] = {
+	{"**", TOKEN_POW},
+	{"==", TOKEN_EQ},
+	{"!=", TOKEN_NE},
+	{"<=", TOKEN_LE},
+	{">=", TOKEN_GE},
+	{NULL, TOKEN_EOF},
+};
+
+typedef struct ExprParseState {
+	int param_names_len;
+	const char **param_names;
+
+	/* position in the expression */
+	const char *cur;
+
+	/* current token */
+	short token;
+	char *tokenbuf;
+	double tokenval;
+
+	/* instructions emitted so far */
+	int ops_count, max_ops;
+	ExprOp *ops;
+
+	/* evaluation stack depth at the current instruction */
+	int stack_ptr, max_stack;
+} ExprParseState;
+
+/* Append an instruction, which changes the stack depth by 'stack_delta'. Returns its index. */
+static int parse_add_op(ExprParseState *state, eOpCode code, int stack_delta)
+{
+	state->stack_ptr += stack_delta;
+	CLAMP_MIN(state->max_stack, state->stack_ptr);
+
+	if (state->ops_count >= state->max_ops) {
+		state->max_ops *= 2;
+		state->ops = MEM_reallocN(state->ops, sizeof(ExprOp) * (size_t)state->max_ops);
+	}
+
+	ExprOp *op = &state->ops[state->ops_count];
+	memset(op, 0, sizeof(*op));
+	op->opcode = code;
+
+	return state->ops_count++;
+}
+
+static void parse_add_func1(ExprParseState *state, UnaryOpFunc func)
+{
+	state->ops[parse_add_op(state, OPCODE_FUNC1, 0)].arg.func1 = func;
+}
+
+static void parse_add_func2(ExprParseState *state, BinaryOpFunc func)
+{
+	state->ops[parse_add_op(state, OPCODE_FUNC2, -1)].arg.func2 = func;
+}
+
+/* Make the jump instruction at 'jump' skip to the end of the instructions emitted so far. */
+static void parse_set_jump(ExprParseState *state, int jump)
+{
+	state->ops[jump].count = state->ops_count - jump - 1;
+}
+
+static bool is_identifier_char(char ch)
+{
+	return isalnum((unsigned char)ch) || ch == '_';
+}
+
+static bool parse_next_token(ExprParseState *state)
+{
+	/* skip white space */
+	while (ELEM(*state->cur, ' ', '\t')) {
+		state->cur++;
+	}
+
+	/* end of expression */
+	if (*state->cur == '\0') {
+		state->token = TOKEN_EOF;
+		return true;
+	}
+
+	/* decimal numbers */
+	if (isdigit((unsigned char)state->cur[0]) ||
+	    (state->cur[0] == '.' && isdigit((unsigned char)state->cur[1])))
+	{
+		const char *start = state->cur;
+		bool is_int = true;
+
+		while (isdigit((unsigned char)*state->cur)) {
+			state->cur++;
+		}
+
+		if (*state->cur == '.') {
+			is_int = false;
+			state->cur++;
+
+			while (isdigit((unsigned char)*state->cur)) {
+				state->cur++;
+			}
+		}
+
+		if (ELEM(*state->cur, 'e', 'E')) {
+			const char *exponent = state->cur + 1;
+
+			if (ELEM(*exponent, '+', '-')) {
+				exponent++;
+			}
+			if (!isdigit((unsigned char)*exponent)) {
+				return false;
+			}
+
+			is_int = false;
+			state->cur = exponent;
+
+			while (isdigit((unsigned char)*state->cur)) {
+				state->cur++;
+			}
+		}
+
+		/* no complex, hexadecimal or other literals */
+		if (is_identifier_char(*state->cur) || *state->cur == '.') {
+			return false;
+		}
+
+		/* Python only allows leading zeros in integers which are zero */
+		if (is_int && start[0] == '0') {
+			for (const char *ch = start; ch < state->cur; ch++) {
+				if (*ch != '0') {
+					return false;
+				}
+			}
+		}
+
+		const size_t len = (size_t)(state->cur - start);
+		memcpy(state->tokenbuf, start, len);
+		state->tokenbuf[len] = '\0';
+
+		state->token = TOKEN_NUMBER;
+		state->tokenval = strtod(state->tokenbuf, NULL);
+		return true;
+	}
+
+	/* operators of two characters */
+	for (int i = 0; operator_list[i].name; i++) {
+		if (STREQLEN(state->cur, operator_list[i].name, 2)) {
+			state->token = operator_list[i].token;
+			state->cur += 2;
+			return true;
+		}
+	}
+
+	/* operators of one character */
+	if (strchr("+-*/()<>,", *state->cur) != NULL) {
+		state->token = *state->cur++;
+		return true;
+	}
+
+	/* identifiers and keywords, only ASCII */
+	if (isalpha((unsigned char)*state->cur) || *state->cur == '_') {
+		char *out = state->tokenbuf;
+
+		while (is_identifier_char(*state->cur)) {
+			*out++ = *state->cur++;
+		}
+		*out = '\0';
+
+		state->token = TOKEN_ID;
+
+		for (int i = 0; keyword_list[i].name; i++) {
+			if (STREQ(state->tokenbuf, keyword_list[i].name)) {
+				state->token = keyword_list[i].token;
+				break;
+			}
+		}
+
+		return true;
+	}
+
+	/* anything else is not supported */
+	return false;
+}
+
+static bool parse_expr(ExprParseState *state);
+static bool parse_unary(ExprParseState *state);
+
+static bool parse_function_args(ExprParseState *state, int *r_args)
+{
+	if (!parse_next_token(state) || state->token != '(' || !parse_next_token(state)) {
+		return false;
+	}
+
+	int args = 0;
+
+	while (true) {
+		if (!parse_expr(state)) {
+			return false;
+		}
+
+		args++;
+
+		if (state->token == ',') {
+			if (!parse_next_token(state)) {
+				return false;
+			}
+		}
+		else if (state->token == ')') {
+			break;
+		}
+		else {
+			return false;
+		}
+	}
+
+	*r_args = args;
+	return parse_next_token(state);
+}
+
+static bool parse_atom(ExprParseState *state)
+{
+	switch (state->token) {
+		case '(':
+			return parse_next_token(state) &&
+			       parse_expr(state) &&
+			       state->token == ')' &&
+			       parse_next_token(state);
+
+		case TOKEN_NUMBER:
+			state->ops[parse_add_op(state, OPCODE_CONST, 1)].arg.dval = state->tokenval;
+			return parse_next_token(state);
+
+		case TOKEN_TRUE:
+		case TOKEN_FALSE:
+			state->ops[parse_add_op(state, OPCODE_CONST, 1)].arg.dval = (state->token == TOKEN_TRUE) ? 1.0 : 0.0;
+			return parse_next_token(state);
+
+		case TOKEN_ID:
+		{
+			/* parameters, the last one of the same name wins like in a dictionary */
+			for (int i = state->param_names_len - 1; i >= 0; i--) {
+				if (STREQ(state->tokenbuf, state->param_names[i])) {
+					state->ops[parse_add_op(state, OPCODE_PARAMETER, 1)].arg.ival = i;
+					return parse_next_token(state);
+				}
+			}
+
+			/* constants */
+			for (int i = 0; builtin_consts[i].name; i++) {
+				if (STREQ(state->tokenbuf, builtin_consts[i].name)) {
+					state->ops[parse_add_op(state, OPCODE_CONST, 1)].arg.dval = builtin_consts[i].value;
+					return parse_next_token(state);
+				}
+			}
+
+			/* functions */
+			for (int i = 0; builtin_ops[i].name; i++) {
+				if (STREQ(state->tokenbuf, builtin_ops[i].name)) {
+					int args;
+
+					if (!parse_function_args(state, &args)) {
+						return false;
+					}
+
+					for (int j = i; builtin_ops[j].name && STREQ(builtin_ops[j].name, builtin_ops[i].name); j++) {
+						const BuiltinOpDef *def = &builtin_ops[j];
+
+						if (def->args == 0 ? (args >= 2) : (args == def->args)) {
+							int op = parse_add_op(state, def->opcode, 1 - args);
+
+							if (def->opcode == OPCODE_FUNC1) {
+								state->ops[op].arg.func1 = def->func1;
+							}
+							else if (def->opcode == OPCODE_FUNC2) {
+								state->ops[op].arg.func2 = def->func2;
+							}
+							else {
+								state->ops[op].count = args;
+							}
+							return true;
+						}
+					}
+
+					return false;
+				}
+			}
+
+			return false;
+		}
+
+		default:
+			return false;
+	}
+}
+
+/* power: atom ['**' unary] */
+static bool parse_power(ExprParseState *state)
+{
+	if (!parse_atom(state)) {
+		return false;
+	}
+
+	if (state->token == TOKEN_POW) {
+		if (!parse_next_token(state) || !parse_unary(state)) {
+			return false;
+		}
+		parse_add_func2(state, pow);
+	}
+
+	return true;
+}
+
+/* unary: ('+' | '-') unary | power */
+static bool parse_unary(ExprParseState *state)
+{
+	if (state->token == '-') {
+		if (!parse_next_token(state) || !parse_unary(state)) {
+			return false;
+		}
+		parse_add_func1(state, op_negate);
+		return true;
+	}
+	else if (state->token == '+') {
+		return parse_next_token(state) && parse_unary(state);
+	}
+
+	return parse_power(state);
+}
+
+/* mul: unary (('*' | '/') unary)* */
+static bool parse_mul(ExprParseState *state)
+{
+	if (!parse_unary(state)) {
+		return false;
+	}
+
+	while (ELEM(state->token, '*', '/')) {
+		BinaryOpFunc func = (state->token == '*') ? op_mul : op_div;
+
+		if (!parse_next_token(state) || !parse_unary(state)) {
+			return false;
+		}
+		parse_add_func2(state, func);
+	}
+
+	return true;
+}
+
+/* add: mul (('+' | '-') mul)* */
+static bool parse_add(ExprParseState *state)
+{
+	if (!parse_mul(state)) {
+		return false;
+	}
+
+	while (ELEM(state->token, '+', '-')) {
+		BinaryOpFunc func = (state->token == '+') ? op_add : op_sub;
+
+		if (!parse_next_token(state) || !parse_mul(state)) {
+			return false;
+		}
+		parse_add_func2(state, func);
+	}
+
+	return true;
+}
+
+static BinaryOpFunc parse_get_cmp_func(short token)
+{
+	switch (token) {
+		case TOKEN_EQ: return op_eq;
+		case TOKEN_NE: return op_ne;
+		case '<': return op_lt;
+		case TOKEN_LE: return op_le;
+		case '>': return op_gt;
+		case TOKEN_GE: return op_ge;
+		default: return NULL;
+	}
+}
+
+/* cmp: add [cmp_op add], chained comparisons are not supported */
+static bool parse_cmp(ExprParseState *state)
+{
+	if (!parse_add(state)) {
+		return false;
+	}
+
+	BinaryOpFunc func = parse_get_cmp_func(state->token);
+
+	if (func) {
+		if (!parse_next_token(state) || !parse_add(state)) {
+			return false;
+		}
+		parse_add_func2(state, func);
+
+		if (parse_get_cmp_func(state->token)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* not: 'not' not | cmp */
+static bool parse_not(ExprParseState *state)
+{
+	if (state->token == TOKEN_NOT) {
+		if (!parse_next_token(state) || !parse_not(state)) {
+			return false;
+		}
+		parse_add_func1(state, op_not);
+		return true;
+	}
+
+	return parse_cmp(state);
+}
+
+/* and: not ('and' not)* */
+static bool parse_and(ExprParseState *state)
+{
+	if (!parse_not(state)) {
+		return false;
+	}
+
+	while (state->token == TOKEN_AND) {
+		int jump = parse_add_op(state, OPCODE_JMP_AND, -1);
+
+		if (!parse_next_token(state) || !parse_not(state)) {
+			return false;
+		}
+		parse_set_jump(state, jump);
+	}
+
+	return true;
+}
+
+/* or: and ('or' and)* */
+static bool parse_or(ExprParseState *state)
+{
+	if (!parse_and(state)) {
+		return false;
+	}
+
+	while (state->token == TOKEN_OR) {
+		int jump = parse_add_op(state, OPCODE_JMP_OR, -1);
+
+		if (!parse_next_token(state) || !parse_and(state)) {
+			return false;
+		}
+		parse_set_jump(state, jump);
+	}
+
+	return true;
+}
+
+/* expr: or ['if' or 'else' expr]
+ *
+ * The value is computed before the condition, as the parser only makes a single
+ * pass, so it is evaluated even when not used. */
+static bool parse_expr(ExprParseState *state)
+{
+	if (!parse_or(state)) {
+		return false;
+	}
+
+	if (state->token == TOKEN_IF) {
+		if (!parse_next_token(state) || !parse_or(state) || state->token != TOKEN_ELSE) {
+			return false;
+		}
+
+		int jump_else = parse_add_op(state, OPCODE_JMP_ELSE, -1);
+		int jump_end = parse_add_op(state, OPCODE_JMP, 0);
+
+		/* the else branch starts with both the condition and the value removed */
+		parse_set_jump(state, jump_else);
+		state->stack_ptr--;
+
+		if (!parse_next_token(state) || !parse_expr(state)) {
+			return false;
+		}
+
+		parse_set_jump(state, jump_end);
+	}
+
+	return true;
+}
+
+/* Parse the expression, with the given names for the parameters passed on evaluation.
+ * Doesn't return NULL when parsing fails, so the result can be stored to not parse again. */
+SimpleExprParsed *BLI_simple_expr_parse(const char *expression, int param_names_len, const char **param_names)
+{
+	ExprParseState state;
+	memset(&state, 0, sizeof(state));
+
+	state.cur = expression;
+	state.param_names_len = param_names_len;
+	state.param_names = param_names;
+
+	state.tokenbuf = MEM_mallocN(strlen(expression) + 1, __func__);
+
+	state.max_ops = 16;
+	state.ops = MEM_mallocN(sizeof(ExprOp) * (size_t)state.max_ops, __func__);
+
+	SimpleExprParsed *expr = MEM_callocN(sizeof(SimpleExprParsed), "SimpleExprParsed");
+	expr->param_names_len = param_names_len;
+
+	if (parse_next_token(&state) && parse_expr(&state) && state.token == TOKEN_EOF) {
+		BLI_assert(state.stack_ptr == 1);
+
+		expr->ops_count = state.ops_count;
+		expr->ops = state.ops;
+		expr->max_stack = state.max_stack;
+	}
+	else {
+		MEM_freeN(state.ops);
+	}
+
+	MEM_freeN(state.tokenbuf);
+
+	return expr;
+}
+
+/** \} */
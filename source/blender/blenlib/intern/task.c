@@ -35,6 +35,8 @@
 #include "BLI_task.h"
 #include "BLI_threads.h"
 
+#include "PIL_time.h"
+
 #include "atomic_ops.h"
 
 /* Define this to enable some detailed statistic print. */
@@ -203,6 +205,23 @@ struct TaskPool {
 #endif
 };
 
+/* Per-thread work-stealing queue.
+ *
+ * Tasks pushed from a worker thread are put to its own queue instead of the
+ * global scheduler queue. The owner thread pops tasks from the tail (LIFO, so
+ * most recently spawned tasks which are likely still hot in the cache are
+ * handled first), other threads steal from the head (FIFO, which tends to
+ * give them older and bigger pieces of work).
+ *
+ * The lock is only contended when some thread is stealing, unlike the global
+ * queue mutex which is taken by every push and pop.
+ */
+typedef struct TaskDeque {
+	ListBase tasks;
+	volatile int num_tasks;
+	SpinLock lock;
+} TaskDeque;
+
 struct TaskScheduler {
 	pthread_t *threads;
 	struct TaskThread *task_threads;
@@ -213,6 +232,14 @@ struct TaskScheduler {
 	ThreadMutex queue_mutex;
 	ThreadCondition queue_cond;
 
+	/* Total number of tasks in all per-thread deques, and number of worker
+	 * threads which are sleeping on the queue condition. Used to wake up
+	 * workers when a task is pushed to a deque, without taking the queue
+	 * mutex when nobody is sleeping.
+	 */
+	unsigned int num_deque_tasks;
+	unsigned int num_sleeping_threads;
+
 	volatile bool do_exit;
 
 	/* NOTE: In pthread's TLS we store the whole TaskThread structure. */
@@ -223,6 +250,7 @@ typedef struct TaskThread {
 	TaskScheduler *scheduler;
 	int id;
 	TaskThreadLocalStorage tls;
+	TaskDeque deque;
 } TaskThread;
 
 /* Helper */
@@ -351,54 +379,237 @@ static void task_pool_num_increase(TaskPool *pool, size_t new)
 	BLI_mutex_unlock(&pool->num_mutex);
 }
 
-static bool task_scheduler_thread_wait_pop(TaskScheduler *scheduler, Task **task)
+/* Work-stealing queues */
+
+BLI_INLINE bool task_scheduler_use_deques(TaskScheduler *scheduler)
 {
-	bool found_task = false;
-	BLI_mutex_lock(&scheduler->queue_mutex);
+	/* With a single background thread there is nobody to steal work from, and
+	 * tasks of non-background pools must not be picked up by that thread.
+	 */
+	return !scheduler->background_thread_only;
+}
 
-	while (!scheduler->queue.first && !scheduler->do_exit)
-		BLI_condition_wait(&scheduler->queue_cond, &scheduler->queue_mutex);
+static void task_deque_init(TaskDeque *deque)
+{
+	BLI_listbase_clear(&deque->tasks);
+	deque->num_tasks = 0;
+	BLI_spin_init(&deque->lock);
+}
 
-	do {
-		Task *current_task;
-
-		/* Assuming we can only have a void queue in 'exit' case here seems logical (we should only be here after
-		 * our worker thread has been woken up from a condition_wait(), which only happens after a new task was
-		 * added to the queue), but it is wrong.
-		 * Waiting on condition may wake up the thread even if condition is not signaled (spurious wake-ups), and some
-		 * race condition may also empty the queue **after** condition has been signaled, but **before** awoken thread
-		 * reaches this point...
+static void task_deque_free(TaskDeque *deque)
+{
+	Task *task;
+	for (task = deque->tasks.first; task; task = task->next) {
+		task_data_free(task, 0);
+	}
+	BLI_freelistN(&deque->tasks);
+	BLI_spin_end(&deque->lock);
+}
+
+static void task_deque_push(TaskScheduler *scheduler, TaskDeque *deque, Task *task)
+{
+	task_pool_num_increase(task->pool, 1);
+
+	BLI_spin_lock(&deque->lock);
+	BLI_addtail(&deque->tasks, task);
+	deque->num_tasks++;
+	BLI_spin_unlock(&deque->lock);
+
+	/* NOTE: Order of atomic operations here and in the worker's sleep code is
+	 * important: either the worker sees the new task count before going to
+	 * sleep, or we see it's sleeping and wake it up.
+	 */
+	atomic_add_and_fetch_u(&scheduler->num_deque_tasks, 1);
+	if (atomic_add_and_fetch_u(&scheduler->num_sleeping_threads, 0) != 0) {
+		BLI_mutex_lock(&scheduler->queue_mutex);
+		BLI_condition_notify_one(&scheduler->queue_cond);
+		BLI_mutex_unlock(&scheduler->queue_mutex);
+	}
+}
+
+static void task_deque_push_all(TaskScheduler *scheduler,
+                                TaskDeque *deque,
+                                TaskPool *pool,
+                                Task **tasks,
+                                int num_tasks)
+{
+	if (num_tasks == 0) {
+		return;
+	}
+
+	task_pool_num_increase(pool, num_tasks);
+
+	BLI_spin_lock(&deque->lock);
+	for (int i = 0; i < num_tasks; i++) {
+		BLI_addtail(&deque->tasks, tasks[i]);
+	}
+	deque->num_tasks += num_tasks;
+	BLI_spin_unlock(&deque->lock);
+
+	atomic_add_and_fetch_u(&scheduler->num_deque_tasks, num_tasks);
+	if (atomic_add_and_fetch_u(&scheduler->num_sleeping_threads, 0) != 0) {
+		BLI_mutex_lock(&scheduler->queue_mutex);
+		BLI_condition_notify_all(&scheduler->queue_cond);
+		BLI_mutex_unlock(&scheduler->queue_mutex);
+	}
+}
+
+/* Pop task from the tail (owner thread) or the head (stealing thread) of the
+ * deque. If pool is not NULL only tasks from this pool are considered.
+ */
+static Task *task_deque_pop(TaskScheduler *scheduler,
+                            TaskDeque *deque,
+                            TaskPool *pool,
+                            const bool from_tail)
+{
+	Task *task;
+
+	if (deque->num_tasks == 0) {
+		return NULL;
+	}
+
+	BLI_spin_lock(&deque->lock);
+	for (task = from_tail ? deque->tasks.last : deque->tasks.first;
+	     task != NULL;
+	     task = from_tail ? task->prev : task->next)
+	{
+		if (pool == NULL || task->pool == pool) {
+			BLI_remlink(&deque->tasks, task);
+			deque->num_tasks--;
+			break;
+		}
+	}
+	BLI_spin_unlock(&deque->lock);
+
+	if (task != NULL) {
+		atomic_sub_and_fetch_u(&scheduler->num_deque_tasks, 1);
+	}
+
+	return task;
+}
+
+static Task *task_scheduler_steal(TaskScheduler *scheduler,
+                                  const int thread_id,
+                                  TaskPool *pool)
+{
+	const int num_deques = scheduler->num_threads + 1;
+	for (int i = 1; i < num_deques; i++) {
+		/* Start from the next thread, so stealing threads spread over victims. */
+		const int victim_id = (thread_id + i) % num_deques;
+		Task *task = task_deque_pop(scheduler,
+		                            &scheduler->task_threads[victim_id].deque,
+		                            pool,
+		                            false);
+		if (task != NULL) {
+			return task;
+		}
+	}
+	return NULL;
+}
+
+static void task_deque_clear(TaskScheduler *scheduler,
+                             TaskDeque *deque,
+                             TaskPool *pool,
+                             size_t *r_done)
+{
+	Task *task, *nexttask;
+	int done = 0;
+
+	if (deque->num_tasks == 0) {
+		return;
+	}
+
+	BLI_spin_lock(&deque->lock);
+	for (task = deque->tasks.first; task; task = nexttask) {
+		nexttask = task->next;
+		if (task->pool == pool) {
+			task_data_free(task, pool->thread_id);
+			BLI_freelinkN(&deque->tasks, task);
+			done++;
+		}
+	}
+	deque->num_tasks -= done;
+	BLI_spin_unlock(&deque->lock);
+
+	if (done != 0) {
+		atomic_sub_and_fetch_u(&scheduler->num_deque_tasks, done);
+		*r_done += done;
+	}
+}
+
+/* Global queue */
+
+static Task *task_scheduler_queue_pop_locked(TaskScheduler *scheduler)
+{
+	Task *task;
+	for (task = scheduler->queue.first; task != NULL; task = task->next) {
+		TaskPool *pool = task->pool;
+
+		if (scheduler->background_thread_only && !pool->run_in_background) {
+			continue;
+		}
+
+		BLI_remlink(&scheduler->queue, task);
+		return task;
+	}
+	return NULL;
+}
+
+static bool task_scheduler_thread_wait_pop(TaskScheduler *scheduler, TaskThread *thread, Task **task)
+{
+	const bool use_deques = task_scheduler_use_deques(scheduler);
+
+	while (true) {
+		/* Own deque first, it doesn't need any global locks. */
+		if (use_deques) {
+			*task = task_deque_pop(scheduler, &thread->deque, NULL, true);
+			if (*task != NULL) {
+				return true;
+			}
+		}
+
+		BLI_mutex_lock(&scheduler->queue_mutex);
+
+		/* Waiting on condition may wake up the thread even if condition is not
+		 * signaled (spurious wake-ups), and some race condition may also empty
+		 * the queue **after** condition has been signaled, but **before**
+		 * awoken thread reaches this point...
 		 * See http://stackoverflow.com/questions/8594591
 		 *
-		 * So we only abort here if do_exit is set.
+		 * So we only abort here if do_exit is set, and otherwise just go
+		 * through all the queues again.
 		 */
 		if (scheduler->do_exit) {
 			BLI_mutex_unlock(&scheduler->queue_mutex);
 			return false;
 		}
 
-		for (current_task = scheduler->queue.first;
-		     current_task != NULL;
-		     current_task = current_task->next)
-		{
-			TaskPool *pool = current_task->pool;
+		*task = task_scheduler_queue_pop_locked(scheduler);
+		if (*task != NULL) {
+			BLI_mutex_unlock(&scheduler->queue_mutex);
+			return true;
+		}
 
-			if (scheduler->background_thread_only && !pool->run_in_background) {
-				continue;
+		if (use_deques && atomic_add_and_fetch_u(&scheduler->num_deque_tasks, 0) != 0) {
+			BLI_mutex_unlock(&scheduler->queue_mutex);
+			*task = task_scheduler_steal(scheduler, thread->id, NULL);
+			if (*task != NULL) {
+				return true;
 			}
-
-			*task = current_task;
-			found_task = true;
-			BLI_remlink(&scheduler->queue, *task);
-			break;
+			continue;
 		}
-		if (!found_task)
-			BLI_condition_wait(&scheduler->queue_cond, &scheduler->queue_mutex);
-	} while (!found_task);
 
-	BLI_mutex_unlock(&scheduler->queue_mutex);
+		/* Nothing to do, go to sleep. See task_deque_push() for why the
+		 * deque counter is checked again after we are marked as sleeping.
+		 */
+		atomic_add_and_fetch_u(&scheduler->num_sleeping_threads, 1);
+		if (!use_deques || atomic_add_and_fetch_u(&scheduler->num_deque_tasks, 0) == 0) {
+			BLI_condition_wait(&scheduler->queue_cond, &scheduler->queue_mutex);
+		}
+		atomic_sub_and_fetch_u(&scheduler->num_sleeping_threads, 1);
 
-	return true;
+		BLI_mutex_unlock(&scheduler->queue_mutex);
+	}
 }
 
 BLI_INLINE void handle_local_queue(TaskThreadLocalStorage *tls,
@@ -432,7 +643,7 @@ static void *task_scheduler_thread_run(void *thread_p)
 	pthread_setspecific(scheduler->tls_id_key, thread);
 
 	/* keep popping off tasks */
-	while (task_scheduler_thread_wait_pop(scheduler, &task)) {
+	while (task_scheduler_thread_wait_pop(scheduler, thread, &task)) {
 		TaskPool *pool = task->pool;
 
 		/* run task */
@@ -484,6 +695,7 @@ TaskScheduler *BLI_task_scheduler_create(int num_threads)
 
 	/* Initialize TLS for main thread. */
 	initialize_task_tls(&scheduler->task_threads[0].tls);
+	task_deque_init(&scheduler->task_threads[0].deque);
 
 	pthread_key_create(&scheduler->tls_id_key, NULL);
 
@@ -499,6 +711,7 @@ TaskScheduler *BLI_task_scheduler_create(int num_threads)
 			thread->scheduler = scheduler;
 			thread->id = i + 1;
 			initialize_task_tls(&thread->tls);
+			task_deque_init(&thread->deque);
 
 			if (pthread_create(&scheduler->threads[i], NULL, task_scheduler_thread_run, thread) != 0) {
 				fprintf(stderr, "TaskScheduler failed to launch thread %d/%d\n", i, num_threads);
@@ -538,6 +751,7 @@ void BLI_task_scheduler_free(TaskScheduler *scheduler)
 		for (int i = 0; i < scheduler->num_threads + 1; ++i) {
 			TaskThreadLocalStorage *tls = &scheduler->task_threads[i].tls;
 			free_task_tls(tls);
+			task_deque_free(&scheduler->task_threads[i].deque);
 		}
 
 		MEM_freeN(scheduler->task_threads);
@@ -590,7 +804,8 @@ static void task_scheduler_push_all(TaskScheduler *scheduler,
 
 	BLI_mutex_lock(&scheduler->queue_mutex);
 
-	for (int i = 0; i < num_tasks; i++) {
+	/* Keep the order in which tasks were pushed. */
+	for (int i = num_tasks - 1; i >= 0; i--) {
 		BLI_addhead(&scheduler->queue, tasks[i]);
 	}
 
@@ -619,6 +834,13 @@ static void task_scheduler_clear(TaskScheduler *scheduler, TaskPool *pool)
 
 	BLI_mutex_unlock(&scheduler->queue_mutex);
 
+	/* free all tasks from this pool from the work-stealing queues */
+	if (task_scheduler_use_deques(scheduler)) {
+		for (int i = 0; i < scheduler->num_threads + 1; i++) {
+			task_deque_clear(scheduler, &scheduler->task_threads[i].deque, pool, &done);
+		}
+	}
+
 	/* notify done */
 	task_pool_num_decrease(pool, done);
 }
@@ -770,6 +992,23 @@ BLI_INLINE bool task_can_use_local_queues(TaskPool *pool, int thread_id)
 	return (thread_id != -1 && (thread_id != pool->thread_id || pool->do_work));
 }
 
+/* Worker threads can always push to their own work-stealing queue, even for
+ * pools which are not being worked on yet: other threads will steal from it
+ * and the worker will pick the tasks up when it waits for the pool. This is
+ * what makes nested pools (such as parallel ranges used from inside of other
+ * tasks) push their work next to the caller instead of the global queue.
+ */
+BLI_INLINE bool task_can_use_deque(TaskPool *pool, int thread_id)
+{
+	return (thread_id > 0 && task_scheduler_use_deques(pool->scheduler));
+}
+
+BLI_INLINE bool task_can_use_delayed_push(TaskPool *pool, int thread_id)
+{
+	return task_can_use_local_queues(pool, thread_id) ||
+	       task_can_use_deque(pool, thread_id);
+}
+
 static void task_pool_push(
         TaskPool *pool, TaskRunFunction run, void *taskdata,
         bool free_taskdata, TaskFreeFunction freedata, TaskPriority priority,
@@ -789,7 +1028,12 @@ static void task_pool_push(
 	 * activated by work_and_wait().
 	 */
 	if (pool->is_suspended) {
-		BLI_addhead(&pool->suspended_queue, task);
+		if (priority == TASK_PRIORITY_HIGH) {
+			BLI_addhead(&pool->suspended_queue, task);
+		}
+		else {
+			BLI_addtail(&pool->suspended_queue, task);
+		}
 		atomic_fetch_and_add_z(&pool->num_suspended, 1);
 		return;
 	}
@@ -805,9 +1049,13 @@ static void task_pool_push(
 			tls->num_local_queue++;
 			return;
 		}
+	}
+	if (task_can_use_delayed_push(pool, thread_id)) {
+		ASSERT_THREAD_ID(pool->scheduler, thread_id);
+		TaskThreadLocalStorage *tls = get_task_tls(pool, thread_id);
 		/* If we are in the delayed tasks push mode, we push tasks to a
 		 * temporary local queue first without any locks, and then move them
-		 * to global execution queue with a single lock.
+		 * to execution queue with a single lock.
 		 */
 		if (tls->do_delayed_push && tls->num_delayed_queue < DELAYED_QUEUE_SIZE) {
 			tls->delayed_queue[tls->num_delayed_queue] = task;
@@ -815,6 +1063,16 @@ static void task_pool_push(
 			return;
 		}
 	}
+	/* Tasks pushed from a worker thread go to its own work-stealing queue,
+	 * where they are picked up by this thread with no global lock, or stolen
+	 * by idle threads.
+	 */
+	if (task_can_use_deque(pool, thread_id)) {
+		ASSERT_THREAD_ID(pool->scheduler, thread_id);
+		TaskScheduler *scheduler = pool->scheduler;
+		task_deque_push(scheduler, &scheduler->task_threads[thread_id].deque, task);
+		return;
+	}
 	/* Do push to a global execution ppol, slowest possible method,
 	 * causes quite reasonable amount of threading overhead.
 	 */
@@ -869,21 +1127,36 @@ void BLI_task_pool_work_and_wait(TaskPool *pool)
 
 		BLI_mutex_unlock(&pool->num_mutex);
 
-		BLI_mutex_lock(&scheduler->queue_mutex);
-
 		/* find task from this pool. if we get a task from another pool,
 		 * we can get into deadlock */
 
-		for (task = scheduler->queue.first; task; task = task->next) {
-			if (task->pool == pool) {
-				work_task = task;
-				found_task = true;
-				BLI_remlink(&scheduler->queue, task);
-				break;
+		if (task_scheduler_use_deques(scheduler)) {
+			if (pool->thread_id != 0) {
+				work_task = task_deque_pop(scheduler,
+				                           &scheduler->task_threads[pool->thread_id].deque,
+				                           pool,
+				                           true);
+			}
+			if (work_task == NULL) {
+				work_task = task_scheduler_steal(scheduler, pool->thread_id, pool);
 			}
 		}
 
-		BLI_mutex_unlock(&scheduler->queue_mutex);
+		if (work_task == NULL) {
+			BLI_mutex_lock(&scheduler->queue_mutex);
+
+			for (task = scheduler->queue.first; task; task = task->next) {
+				if (task->pool == pool) {
+					work_task = task;
+					BLI_remlink(&scheduler->queue, task);
+					break;
+				}
+			}
+
+			BLI_mutex_unlock(&scheduler->queue_mutex);
+		}
+
+		found_task = (work_task != NULL);
 
 		/* if found task, do it, otherwise wait until other tasks are done */
 		if (found_task) {
@@ -893,7 +1166,7 @@ void BLI_task_pool_work_and_wait(TaskPool *pool)
 			BLI_assert(!tls->do_delayed_push);
 
 			/* delete task */
-			task_free(pool, task, pool->thread_id);
+			task_free(pool, work_task, pool->thread_id);
 
 			/* Handle all tasks from local queue. */
 			handle_local_queue(tls, pool->thread_id);
@@ -947,7 +1220,7 @@ ThreadMutex *BLI_task_pool_user_mutex(TaskPool *pool)
 
 void BLI_task_pool_delayed_push_begin(TaskPool *pool, int thread_id)
 {
-	if (task_can_use_local_queues(pool, thread_id)) {
+	if (task_can_use_delayed_push(pool, thread_id)) {
 		ASSERT_THREAD_ID(pool->scheduler, thread_id);
 		TaskThreadLocalStorage *tls = get_task_tls(pool, thread_id);
 		tls->do_delayed_push = true;
@@ -956,14 +1229,24 @@ void BLI_task_pool_delayed_push_begin(TaskPool *pool, int thread_id)
 
 void BLI_task_pool_delayed_push_end(TaskPool *pool, int thread_id)
 {
-	if (task_can_use_local_queues(pool, thread_id)) {
+	if (task_can_use_delayed_push(pool, thread_id)) {
 		ASSERT_THREAD_ID(pool->scheduler, thread_id);
 		TaskThreadLocalStorage *tls = get_task_tls(pool, thread_id);
 		BLI_assert(tls->do_delayed_push);
-		task_scheduler_push_all(pool->scheduler,
-		                        pool,
-		                        tls->delayed_queue,
-		                        tls->num_delayed_queue);
+		if (task_can_use_deque(pool, thread_id)) {
+			TaskScheduler *scheduler = pool->scheduler;
+			task_deque_push_all(scheduler,
+			                    &scheduler->task_threads[thread_id].deque,
+			                    pool,
+			                    tls->delayed_queue,
+			                    tls->num_delayed_queue);
+		}
+		else {
+			task_scheduler_push_all(pool->scheduler,
+			                        pool,
+			                        tls->delayed_queue,
+			                        tls->num_delayed_queue);
+		}
 		tls->do_delayed_push = false;
 		tls->num_delayed_queue = 0;
 	}
@@ -988,6 +1271,32 @@ void BLI_task_pool_delayed_push_end(TaskPool *pool, int thread_id)
 #define MALLOCA(_size) ((_size) <= 8192) ? alloca((_size)) : MEM_mallocN((_size), __func__)
 #define MALLOCA_FREE(_mem, _size) if (((_mem) != NULL) && ((_size) > 8192)) MEM_freeN((_mem))
 
+/* Adaptive scheduling.
+ *
+ * With dynamic scheduling the calling thread first runs iterations on its own
+ * (in batches of growing size) for up to PARALLEL_PROBE_TIME seconds. Loops
+ * which are finished in that time are not worth waking up worker threads.
+ * Otherwise measured per-iteration cost gives the smallest chunk which is
+ * worth scheduling (about PARALLEL_CHUNK_TIME seconds of work), and the rest
+ * of the range is handed out guided style: big chunks first, getting smaller
+ * as less work remains, so no single thread gets stuck with a big last chunk.
+ */
+#define PARALLEL_PROBE_TIME 50e-6
+#define PARALLEL_CHUNK_TIME 20e-6
+#define PARALLEL_MAX_CHUNK_SIZE 4096
+
+BLI_INLINE int parallel_chunk_size_from_cost(const double probe_time, const int probe_count)
+{
+	if (probe_time <= 0.0) {
+		return PARALLEL_MAX_CHUNK_SIZE;
+	}
+	const double chunk_size = PARALLEL_CHUNK_TIME * (double)probe_count / probe_time;
+	if (chunk_size >= (double)PARALLEL_MAX_CHUNK_SIZE) {
+		return PARALLEL_MAX_CHUNK_SIZE;
+	}
+	return max_ii(1, (int)chunk_size);
+}
+
 typedef struct ParallelRangeState {
 	int start, stop;
 	void *userdata;
@@ -997,12 +1306,47 @@ typedef struct ParallelRangeState {
 
 	int iter;
 	int chunk_size;
+
+	/* Guided scheduling: chunk_size is the minimum, remaining iterations
+	 * are divided by this to get the actual chunk size.
+	 */
+	bool use_guided_scheduling;
+	int guided_divider;
 } ParallelRangeState;
 
+BLI_INLINE bool parallel_range_next_iter_get_guided(
+        ParallelRangeState * __restrict state,
+        int * __restrict iter, int * __restrict count)
+{
+	int previter, chunk_size;
+
+	do {
+		uint32_t uval = atomic_add_and_fetch_uint32((uint32_t *)(&state->iter), 0);
+		previter = *(int32_t *)&uval;
+		if (previter >= state->stop) {
+			return false;
+		}
+		const int remaining = state->stop - previter;
+		chunk_size = max_ii(state->chunk_size, remaining / state->guided_divider);
+		chunk_size = min_ii(chunk_size, remaining);
+	} while (atomic_cas_uint32((uint32_t *)(&state->iter),
+	                           (uint32_t)previter,
+	                           (uint32_t)(previter + chunk_size)) != (uint32_t)previter);
+
+	*iter = previter;
+	*count = chunk_size;
+
+	return true;
+}
+
 BLI_INLINE bool parallel_range_next_iter_get(
         ParallelRangeState * __restrict state,
         int * __restrict iter, int * __restrict count)
 {
+	if (state->use_guided_scheduling) {
+		return parallel_range_next_iter_get_guided(state, iter, count);
+	}
+
 	uint32_t uval = atomic_fetch_and_add_uint32((uint32_t *)(&state->iter), state->chunk_size);
 	int previter = *(int32_t *)&uval;
 
@@ -1012,6 +1356,54 @@ BLI_INLINE bool parallel_range_next_iter_get(
 	return (previter < state->stop);
 }
 
+BLI_INLINE void parallel_range_run_iters(
+        const ParallelRangeState * __restrict state,
+        void *userdata_chunk,
+        const int iter, const int count,
+        const int threadid)
+{
+	int i;
+
+	if (state->func_ex) {
+		for (i = 0; i < count; ++i) {
+			state->func_ex(state->userdata, userdata_chunk, iter + i, threadid);
+		}
+	}
+	else {
+		for (i = 0; i < count; ++i) {
+			state->func(state->userdata, iter + i);
+		}
+	}
+}
+
+/* Run first iterations of the range from the calling thread, measuring their cost.
+ * Returns number of iterations done.
+ */
+static int parallel_range_probe(
+        const ParallelRangeState * __restrict state,
+        void *userdata_chunk,
+        const int threadid,
+        double *r_probe_time)
+{
+	const double start_time = PIL_check_seconds_timer();
+	int iter = state->start;
+	int batch = 1;
+
+	*r_probe_time = 0.0;
+	while (iter < state->stop) {
+		const int count = min_ii(batch, state->stop - iter);
+		parallel_range_run_iters(state, userdata_chunk, iter, count, threadid);
+		iter += count;
+		*r_probe_time = PIL_check_seconds_timer() - start_time;
+		if (*r_probe_time > PARALLEL_PROBE_TIME) {
+			break;
+		}
+		batch *= 2;
+	}
+
+	return iter - state->start;
+}
+
 static void parallel_range_func(
         TaskPool * __restrict pool,
         void *userdata_chunk,
@@ -1021,18 +1413,69 @@ static void parallel_range_func(
 	int iter, count;
 
 	while (parallel_range_next_iter_get(state, &iter, &count)) {
-		int i;
+		parallel_range_run_iters(state, userdata_chunk, iter, count, threadid);
+	}
+}
 
-		if (state->func_ex) {
-			for (i = 0; i < count; ++i) {
-				state->func_ex(state->userdata, userdata_chunk, iter + i, threadid);
-			}
+typedef struct ParallelReduceState {
+	void *userdata;
+	TaskParallelRangeFuncReduce func_reduce;
+	void **chunks;
+	int stride;
+} ParallelReduceState;
+
+static void parallel_reduce_func(
+        TaskPool * __restrict pool,
+        void *taskdata,
+        int UNUSED(threadid))
+{
+	ParallelReduceState * __restrict state = BLI_task_pool_userdata(pool);
+	const int i = GET_INT_FROM_POINTER(taskdata);
+
+	state->func_reduce(state->userdata, state->chunks[i], state->chunks[i + state->stride]);
+}
+
+/**
+ * Combine chunks pairwise in a tree, so it takes log2(num_chunks) steps with
+ * all pairs of a step reduced in parallel. Result ends up in the first chunk.
+ */
+static void parallel_reduce_chunks(
+        TaskScheduler *task_scheduler,
+        void *userdata,
+        TaskParallelRangeFuncReduce func_reduce,
+        void **chunks,
+        const int num_chunks)
+{
+	ParallelReduceState state;
+	TaskPool *task_pool = NULL;
+
+	state.userdata = userdata;
+	state.func_reduce = func_reduce;
+	state.chunks = chunks;
+
+	for (state.stride = 1; state.stride < num_chunks; state.stride *= 2) {
+		const int num_pairs = (num_chunks - state.stride + (2 * state.stride - 1)) / (2 * state.stride);
+
+		if (num_pairs == 1) {
+			func_reduce(userdata, chunks[0], chunks[state.stride]);
+			continue;
 		}
-		else {
-			for (i = 0; i < count; ++i) {
-				state->func(state->userdata, iter + i);
-			}
+
+		if (task_pool == NULL) {
+			task_pool = BLI_task_pool_create(task_scheduler, &state);
 		}
+		for (int i = 0; i + state.stride < num_chunks; i += 2 * state.stride) {
+			BLI_task_pool_push_from_thread(task_pool,
+			                               parallel_reduce_func,
+			                               SET_INT_IN_POINTER(i), false,
+			                               TASK_PRIORITY_HIGH,
+			                               task_pool->thread_id);
+		}
+		BLI_task_pool_work_and_wait(task_pool);
+	}
+
+	if (task_pool != NULL) {
+		BLI_task_pool_free(task_pool);
 	}
 }
 
@@ -1049,6 +1492,7 @@ static void task_parallel_range_ex(
         TaskParallelRangeFunc func,
         TaskParallelRangeFuncEx func_ex,
         TaskParallelRangeFuncFinalize func_finalize,
+        TaskParallelRangeFuncReduce func_reduce,
         const bool use_threading,
         const bool use_dynamic_scheduling)
 {
@@ -1059,6 +1503,8 @@ static void task_parallel_range_ex(
 
 	void *userdata_chunk_local = NULL;
 	void *userdata_chunk_array = NULL;
+	void *userdata_chunk_probe = NULL;
+	size_t userdata_chunk_array_size = 0;
 	const bool use_userdata_chunk = (func_ex != NULL) && (userdata_chunk_size != 0) && (userdata_chunk != NULL);
 
 	if (start == stop) {
@@ -1070,13 +1516,18 @@ static void task_parallel_range_ex(
 		BLI_assert(func_ex != NULL && func == NULL);
 		BLI_assert(userdata_chunk != NULL);
 	}
+	BLI_assert(func_reduce == NULL || (use_userdata_chunk && func_finalize == NULL));
 
 	/* If it's not enough data to be crunched, don't bother with tasks at all,
 	 * do everything from the main thread.
 	 */
 	if (!use_threading) {
 		if (func_ex) {
-			if (use_userdata_chunk) {
+			if (func_reduce) {
+				/* Accumulate directly into the result. */
+				userdata_chunk_local = userdata_chunk;
+			}
+			else if (use_userdata_chunk) {
 				userdata_chunk_local = MALLOCA(userdata_chunk_size);
 				memcpy(userdata_chunk_local, userdata_chunk, userdata_chunk_size);
 			}
@@ -1089,7 +1540,9 @@ static void task_parallel_range_ex(
 				func_finalize(userdata, userdata_chunk_local);
 			}
 
-			MALLOCA_FREE(userdata_chunk_local, userdata_chunk_size);
+			if (!func_reduce) {
+				MALLOCA_FREE(userdata_chunk_local, userdata_chunk_size);
+			}
 		}
 		else {
 			for (i = start; i < stop; ++i) {
@@ -1101,7 +1554,6 @@ static void task_parallel_range_ex(
 	}
 
 	task_scheduler = BLI_task_scheduler_get();
-	task_pool = BLI_task_pool_create(task_scheduler, &state);
 	num_threads = BLI_task_scheduler_num_threads(task_scheduler);
 
 	/* The idea here is to prevent creating task for each of the loop iterations
@@ -1116,20 +1568,46 @@ static void task_parallel_range_ex(
 	state.func = func;
 	state.func_ex = func_ex;
 	state.iter = start;
-	if (use_dynamic_scheduling) {
-		state.chunk_size = 32;
-	}
-	else {
+	state.use_guided_scheduling = use_dynamic_scheduling;
+	state.guided_divider = num_tasks;
+	if (!use_dynamic_scheduling) {
 		state.chunk_size = max_ii(1, (stop - start) / (num_tasks));
 	}
 
-	num_tasks = min_ii(num_tasks, (stop - start) / state.chunk_size);
-	atomic_fetch_and_add_uint32((uint32_t *)(&state.iter), 0);
-
 	if (use_userdata_chunk) {
-		userdata_chunk_array = MALLOCA(userdata_chunk_size * num_tasks);
+		/* Extra chunk for the iterations done by the calling thread while probing. */
+		userdata_chunk_array_size = userdata_chunk_size * (num_tasks + 1);
+		userdata_chunk_array = MALLOCA(userdata_chunk_array_size);
+		if (use_dynamic_scheduling) {
+			userdata_chunk_probe = (char *)userdata_chunk_array + (userdata_chunk_size * num_tasks);
+			memcpy(userdata_chunk_probe, userdata_chunk, userdata_chunk_size);
+		}
+	}
+
+	task_pool = BLI_task_pool_create(task_scheduler, &state);
+
+	if (use_dynamic_scheduling) {
+		double probe_time;
+		const int probe_count = parallel_range_probe(
+		        &state, userdata_chunk_probe, task_pool->thread_id, &probe_time);
+
+		state.iter = start + probe_count;
+		state.chunk_size = parallel_chunk_size_from_cost(probe_time, probe_count);
+
+		if (state.iter == stop) {
+			/* Cheap loop, all done from the calling thread already. */
+			num_tasks = 0;
+		}
 	}
 
+	num_tasks = min_ii(num_tasks, max_ii(1, (stop - state.iter) / state.chunk_size));
+	atomic_fetch_and_add_uint32((uint32_t *)(&state.iter), 0);
+
+	/* When called from a worker thread (nested parallelism) tasks are pushed
+	 * to its work-stealing queue, and this thread will execute them in
+	 * BLI_task_pool_work_and_wait() unless they are stolen by idle threads.
+	 * No new threads are involved, so no oversubscription.
+	 */
 	for (i = 0; i < num_tasks; i++) {
 		if (use_userdata_chunk) {
 			userdata_chunk_local = (char *)userdata_chunk_array + (userdata_chunk_size * i);
@@ -1147,13 +1625,29 @@ static void task_parallel_range_ex(
 	BLI_task_pool_free(task_pool);
 
 	if (use_userdata_chunk) {
+		if (func_reduce) {
+			void **chunks = MALLOCA(sizeof(void *) * (num_tasks + 1));
+			int num_chunks = 0;
+			for (i = 0; i < num_tasks; i++) {
+				chunks[num_chunks++] = (char *)userdata_chunk_array + (userdata_chunk_size * i);
+			}
+			if (userdata_chunk_probe != NULL) {
+				chunks[num_chunks++] = userdata_chunk_probe;
+			}
+			parallel_reduce_chunks(task_scheduler, userdata, func_reduce, chunks, num_chunks);
+			memcpy(userdata_chunk, chunks[0], userdata_chunk_size);
+			MALLOCA_FREE(chunks, sizeof(void *) * (num_tasks + 1));
+		}
 		if (func_finalize) {
 			for (i = 0; i < num_tasks; i++) {
 				userdata_chunk_local = (char *)userdata_chunk_array + (userdata_chunk_size * i);
 				func_finalize(userdata, userdata_chunk_local);
 			}
+			if (userdata_chunk_probe != NULL) {
+				func_finalize(userdata, userdata_chunk_probe);
+			}
 		}
-		MALLOCA_FREE(userdata_chunk_array, userdata_chunk_size * num_tasks);
+		MALLOCA_FREE(userdata_chunk_array, userdata_chunk_array_size);
 	}
 }
 
@@ -1169,8 +1663,14 @@ static void task_parallel_range_ex(
  * \param func_ex Callback function (advanced version).
  * \param use_threading If \a true, actually split-execute loop in threads, else just do a sequential forloop
  *                      (allows caller to use any kind of test to switch on parallelization or not).
- * \param use_dynamic_scheduling If \a true, the whole range is divided in a lot of small chunks (of size 32 currently),
- *                               otherwise whole range is split in a few big chunks (num_threads * 2 chunks currently).
+ * \param use_dynamic_scheduling If \a true, chunk size is chosen adaptively: the cost of first iterations is
+ *                               measured from the calling thread (cheap loops are entirely done there), the rest
+ *                               is split in chunks getting smaller as the loop proceeds (guided scheduling).
+ *                               Otherwise whole range is split in a few big chunks (num_threads * 2 chunks currently).
+ *
+ * \note Can be used from inside of tasks (for example from depsgraph evaluation): work is then pushed to the
+ *       calling worker's own queue, and the calling thread executes it while waiting, other idle threads
+ *       steal from it.
  */
 void BLI_task_parallel_range_ex(
         int start, int stop,
@@ -1182,7 +1682,7 @@ void BLI_task_parallel_range_ex(
         const bool use_dynamic_scheduling)
 {
 	task_parallel_range_ex(
-	            start, stop, userdata, userdata_chunk, userdata_chunk_size, NULL, func_ex, NULL,
+	            start, stop, userdata, userdata_chunk, userdata_chunk_size, NULL, func_ex, NULL, NULL,
 	            use_threading, use_dynamic_scheduling);
 }
 
@@ -1203,7 +1703,7 @@ void BLI_task_parallel_range(
         TaskParallelRangeFunc func,
         const bool use_threading)
 {
-	task_parallel_range_ex(start, stop, userdata, NULL, 0, func, NULL, NULL, use_threading, false);
+	task_parallel_range_ex(start, stop, userdata, NULL, 0, func, NULL, NULL, NULL, use_threading, false);
 }
 
 /**
@@ -1221,8 +1721,8 @@ void BLI_task_parallel_range(
  * useful to finalize accumulative tasks.
  * \param use_threading If \a true, actually split-execute loop in threads, else just do a sequential forloop
  *                      (allows caller to use any kind of test to switch on parallelization or not).
- * \param use_dynamic_scheduling If \a true, the whole range is divided in a lot of small chunks (of size 32 currently),
- *                               otherwise whole range is split in a few big chunks (num_threads * 2 chunks currently).
+ * \param use_dynamic_scheduling If \a true, chunk size is chosen adaptively, see #BLI_task_parallel_range_ex.
+ *                               Otherwise whole range is split in a few big chunks (num_threads * 2 chunks currently).
  */
 void BLI_task_parallel_range_finalize(
         int start, int stop,
@@ -1235,7 +1735,36 @@ void BLI_task_parallel_range_finalize(
         const bool use_dynamic_scheduling)
 {
 	task_parallel_range_ex(
-	            start, stop, userdata, userdata_chunk, userdata_chunk_size, NULL, func_ex, func_finalize,
+	            start, stop, userdata, userdata_chunk, userdata_chunk_size, NULL, func_ex, func_finalize, NULL,
+	            use_threading, use_dynamic_scheduling);
+}
+
+/**
+ * Parallel reduction: each chunk of the loop accumulates into its own copy of \a userdata_chunk,
+ * copies are then combined pairwise in a tree (log2 of number of chunks steps, each step done in parallel),
+ * and the result is written back to \a userdata_chunk.
+ *
+ * Unlike #BLI_task_parallel_range_finalize no serial merge of all chunks happens on the calling thread,
+ * which matters for big accumulators (histograms, per-cell counters, etc.).
+ *
+ * \param userdata_chunk Initial value of the accumulator (must be an identity value for \a func_reduce,
+ *                       e.g. zero for sums, since each chunk starts from a copy of it), receives the result.
+ * \param func_reduce Callback function combining \a chunk into \a chunk_join, may be called from any thread.
+ *
+ * See #BLI_task_parallel_range_ex for the other parameters.
+ */
+void BLI_task_parallel_range_reduce(
+        int start, int stop,
+        void *userdata,
+        void *userdata_chunk,
+        const size_t userdata_chunk_size,
+        TaskParallelRangeFuncEx func_ex,
+        TaskParallelRangeFuncReduce func_reduce,
+        const bool use_threading,
+        const bool use_dynamic_scheduling)
+{
+	task_parallel_range_ex(
+	            start, stop, userdata, userdata_chunk, userdata_chunk_size, NULL, func_ex, NULL, func_reduce,
 	            use_threading, use_dynamic_scheduling);
 }
 
@@ -1290,6 +1819,36 @@ static void parallel_listbase_func(
 	}
 }
 
+/* Same as parallel_range_probe(), returns first link which is not handled yet. */
+static Link *parallel_listbase_probe(
+        struct ListBase *listbase,
+        void *userdata,
+        TaskParallelListbaseFunc func,
+        int *r_probe_count,
+        double *r_probe_time)
+{
+	const double start_time = PIL_check_seconds_timer();
+	Link *link = listbase->first;
+	int index = 0;
+	int batch = 1;
+
+	*r_probe_time = 0.0;
+	while (link != NULL) {
+		for (int i = 0; i < batch && link != NULL; i++, index++) {
+			func(userdata, link, index);
+			link = link->next;
+		}
+		*r_probe_time = PIL_check_seconds_timer() - start_time;
+		if (*r_probe_time > PARALLEL_PROBE_TIME) {
+			break;
+		}
+		batch *= 2;
+	}
+
+	*r_probe_count = index;
+	return link;
+}
+
 /**
  * This function allows to parallelize for loops over ListBase items.
  *
@@ -1300,6 +1859,8 @@ static void parallel_listbase_func(
  *                      (allows caller to use any kind of test to switch on parallelization or not).
  *
  * \note There is no static scheduling here, since it would need another full loop over items to count them...
+ *       Chunk size is chosen from the measured cost of the first items, which are handled by the calling thread.
+ *       Short lists are entirely handled by the calling thread.
  */
 void BLI_task_parallel_listbase(
         struct ListBase *listbase,
@@ -1310,7 +1871,9 @@ void BLI_task_parallel_listbase(
 	TaskScheduler *task_scheduler;
 	TaskPool *task_pool;
 	ParallelListState state;
-	int i, num_threads, num_tasks;
+	Link *first_link;
+	int i, num_threads, num_tasks, probe_count;
+	double probe_time;
 
 	if (BLI_listbase_is_empty(listbase)) {
 		return;
@@ -1324,6 +1887,11 @@ void BLI_task_parallel_listbase(
 		return;
 	}
 
+	first_link = parallel_listbase_probe(listbase, userdata, func, &probe_count, &probe_time);
+	if (first_link == NULL) {
+		return;
+	}
+
 	task_scheduler = BLI_task_scheduler_get();
 	task_pool = BLI_task_pool_create(task_scheduler, &state);
 	num_threads = BLI_task_scheduler_num_threads(task_scheduler);
@@ -1334,11 +1902,11 @@ void BLI_task_parallel_listbase(
 	 */
 	num_tasks = num_threads * 2;
 
-	state.index = 0;
-	state.link = listbase->first;
+	state.index = probe_count;
+	state.link = first_link;
 	state.userdata = userdata;
 	state.func = func;
-	state.chunk_size = 32;
+	state.chunk_size = parallel_chunk_size_from_cost(probe_time, probe_count);
 	BLI_spin_init(&state.lock);
 
 	for (i = 0; i < num_tasks; i++) {
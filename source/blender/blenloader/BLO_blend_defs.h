@@ -73,6 +73,11 @@ enum {
 	 * Terminate reading (no data).
 	 */
 	ENDB = BLEND_MAKE_ID('E', 'N', 'D', 'B'),
+	/**
+	 * Table of #BlendBlockHash, one for each block of the file.
+	 * Optionally written after #ENDB, so readers that stop at the end of the file ignore it.
+	 */
+	HASH = BLEND_MAKE_ID('H', 'A', 'S', 'H'),
 };
 
 #define BLEN_THUMB_MEMSIZE_FILE(_x, _y) (sizeof(int) * (size_t)(2 + (_x) * (_y)))
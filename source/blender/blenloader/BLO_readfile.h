@@ -32,6 +32,8 @@
  *  \brief external readfile function prototypes.
  */
 
+#include "BLI_sys_types.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -111,6 +113,23 @@ struct LinkNode *BLO_blendhandle_get_previews(BlendHandle *bh, int ofblocktype,
 struct LinkNode *BLO_blendhandle_get_linkable_groups(BlendHandle *bh);
 struct LinkNode *BLO_blendhandle_get_appendable_groups(BlendHandle *bh);
 
+/**
+ * Content hash of one block, as stored in the optional #HASH table written after #ENDB
+ * (see #G_FILE_BLOCK_HASH).
+ */
+typedef struct BlendBlockHash {
+	/* Position of the block header in the uncompressed file. */
+	uint64_t offset;
+	/* Old address of the block, as found in the #BHead. */
+	uint64_t old;
+	int code, len;
+	int SDNAnr, nr;
+	/* MD5 of the block data (not including the header). */
+	unsigned char digest[16];
+} BlendBlockHash;
+
+BlendBlockHash *BLO_blendhandle_get_block_hashes(BlendHandle *bh, int *r_tot);
+
 void BLO_blendhandle_close(BlendHandle *bh);
 
 /***/
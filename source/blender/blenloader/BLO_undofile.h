@@ -38,6 +38,8 @@ typedef struct {
 	
 	char *buf;
 	unsigned int ident, size;
+	/* Key of the ID this chunk was written for (0 when not part of an ID), see #memfile_write_id_begin. */
+	unsigned int id_key;
 	
 } MemFileChunk;
 
@@ -46,8 +48,22 @@ typedef struct MemFile {
 	unsigned int size;
 } MemFile;
 
+typedef struct MemFileWriteData {
+	MemFile *written_memfile;
+	/* Previous memfile (can be NULL), identical chunks share their buffer with it. */
+	MemFile *reference_memfile;
+	MemFileChunk *reference_current_chunk;
+	/* Maps ID keys to their first chunk in the reference memfile. */
+	struct GHash *id_key_mapping;
+	unsigned int current_id_key;
+} MemFileWriteData;
+
 /* actually only used writefile.c */
-extern void memfile_chunk_add(MemFile *compare, MemFile *current, const char *buf, unsigned int size);
+extern void memfile_write_init(MemFileWriteData *mem_data, MemFile *written_memfile, MemFile *reference_memfile);
+extern void memfile_write_finalize(MemFileWriteData *mem_data);
+extern void memfile_write_id_begin(MemFileWriteData *mem_data, const unsigned int id_key);
+extern void memfile_write_id_end(MemFileWriteData *mem_data);
+extern void memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, unsigned int size);
 
 /* exports */
 extern void BLO_memfile_free(MemFile *memfile);
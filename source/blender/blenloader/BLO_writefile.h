@@ -44,5 +44,12 @@ extern bool BLO_write_file(
 extern bool BLO_write_file_mem(
         struct Main *mainvar, struct MemFile *compare, struct MemFile *current, int write_flags);
 
+/* background saving */
+extern bool BLO_write_file_to_memfile(
+        struct Main *mainvar, const char *filepath, int write_flags,
+        struct MemFile *memfile, const struct BlendThumbnail *thumb);
+extern bool BLO_memfile_write_file(
+        struct MemFile *memfile, const char *filepath, int write_flags, struct ReportList *reports);
+
 #endif
 
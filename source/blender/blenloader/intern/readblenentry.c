@@ -214,7 +214,7 @@ LinkNode *BLO_blendhandle_get_previews(BlendHandle *bh, int ofblocktype, int *to
 							size_t len = new_prv->w[0] * new_prv->h[0] * sizeof(unsigned int);
 							new_prv->rect[0] = MEM_callocN(len, __func__);
 							bhead = blo_nextbhead(fd, bhead);
-							rect = (unsigned int *)(bhead + 1);
+							rect = (unsigned int *)blo_bhead_data(bhead);
 							BLI_assert(len == bhead->len);
 							memcpy(new_prv->rect[0], rect, len);
 						}
@@ -231,7 +231,7 @@ LinkNode *BLO_blendhandle_get_previews(BlendHandle *bh, int ofblocktype, int *to
 							size_t len = new_prv->w[1] * new_prv->h[1] * sizeof(unsigned int);
 							new_prv->rect[1] = MEM_callocN(len, __func__);
 							bhead = blo_nextbhead(fd, bhead);
-							rect = (unsigned int *)(bhead + 1);
+							rect = (unsigned int *)blo_bhead_data(bhead);
 							BLI_assert(len == bhead->len);
 							memcpy(new_prv->rect[1], rect, len);
 						}
@@ -295,6 +295,20 @@ LinkNode *BLO_blendhandle_get_linkable_groups(BlendHandle *bh)
 	return names;
 }		
 
+/**
+ * Gets the content hashes of the blocks in the file, when it was saved with them (see #G_FILE_BLOCK_HASH).
+ *
+ * \param bh The blendhandle to access.
+ * \param r_tot The length of the returned array.
+ * \return A MEM_mallocN'd array of #BlendBlockHash ordered as the blocks in the file, or NULL.
+ */
+BlendBlockHash *BLO_blendhandle_get_block_hashes(BlendHandle *bh, int *r_tot)
+{
+	FileData *fd = (FileData *) bh;
+
+	return blo_read_block_hashes(fd, r_tot);
+}
+
 /**
  * Close and free a blendhandle. The handle becomes invalid after this call.
  *
@@ -32,6 +32,14 @@
 
 #include "zlib.h"
 
+#ifdef WITH_LZO
+#  ifdef WITH_SYSTEM_LZO
+#    include <lzo/lzo1x.h>
+#  else
+#    include "minilzo.h"
+#  endif
+#endif
+
 #include <limits.h>
 #include <stdio.h> // for printf fopen fwrite fclose sprintf FILE
 #include <stdlib.h> // for getenv atoi
@@ -45,6 +53,8 @@
 #include "BLI_utildefines.h"
 #ifndef WIN32
 #  include <unistd.h> // for read close
+#  include <sys/mman.h> // for mmap
+#  include <sys/stat.h> // for fstat
 #else
 #  include <io.h> // for open close read
 #  include "winsock2.h"
@@ -118,10 +128,13 @@
 #include "BLI_math.h"
 #include "BLI_threads.h"
 #include "BLI_mempool.h"
+#include "BLI_task.h"
+#include "BLI_hash_md5.h"
 
 #include "BLT_translation.h"
 
 #include "BKE_action.h"
+#include "BKE_appdir.h"
 #include "BKE_armature.h"
 #include "BKE_brush.h"
 #include "BKE_cachefile.h"
@@ -231,6 +244,23 @@
 /* Use GHash for restoring pointers by name */
 #define USE_GHASH_RESTORE_POINTER
 
+/* Memory map uncompressed files, block data is referenced from the mapping instead of being read
+ * into each BHeadN, it's only copied when creating the data-blocks.
+ * Not used on Windows where mmap is only emulated. */
+#ifndef WIN32
+#  define USE_BHEAD_MMAP
+#endif
+
+/* Reconstruct the data-blocks belonging to an ID in parallel before they're direct-linked,
+ * only used when there is enough data for the threads to pay off. */
+#define USE_READ_DATA_THREADED
+#define READ_DATA_THREADED_MIN_LEN (1 << 18)
+
+/* Cache the offsets of all blocks that aren't DATA, so opening a memory mapped file
+ * (a library to link from for e.g.) doesn't have to read every block to find the ID's,
+ * the DATA blocks are only read when the ID they belong to is. */
+#define USE_BHEAD_INDEX
+
 /***/
 
 typedef struct OldNew {
@@ -242,10 +272,15 @@ typedef struct OldNew {
 typedef struct OldNewMap {
 	OldNew *entries;
 	int nentries, entriessize;
-	bool sorted;
+	/* Open addressing table of indices into \a entries (-1 for unused slots),
+	 * always twice the size of \a entriessize so the load factor stays below 0.5. */
+	int *map;
+	int map_size_exp;
 	int lasthit;
 } OldNewMap;
 
+#define OLDNEWMAP_DEFAULT_SIZE_EXP 10
+
 
 /* local prototypes */
 static void *read_struct(FileData *fd, BHead *bh, const char *blockname);
@@ -285,31 +320,62 @@ static const char *library_parent_filepath(Library *lib)
 	return lib->parent ? lib->parent->filepath : "<direct>";
 }
 
-static OldNewMap *oldnewmap_new(void) 
+/* Slots come from the high bits of a multiplicative hash,
+ * the low bits of old addresses are mostly zero because of alignment. */
+BLI_INLINE unsigned int oldnewmap_hash_slot(const OldNewMap *onm, const void *addr)
 {
-	OldNewMap *onm= MEM_callocN(sizeof(*onm), "OldNewMap");
-	
-	onm->entriessize = 1024;
-	onm->entries = MEM_mallocN(sizeof(*onm->entries)*onm->entriessize, "OldNewMap.entries");
-	
-	return onm;
+	return (unsigned int)(((uint64_t)(uintptr_t)addr * 0x9E3779B97F4A7C15ull) >> (64 - onm->map_size_exp));
 }
 
-static int verg_oldnewmap(const void *v1, const void *v2)
+#define OLDNEWMAP_MAP_MASK(onm) ((1u << (onm)->map_size_exp) - 1)
+
+/* Entries with the same old address replace each other in the map, the last one inserted wins. */
+static void oldnewmap_map_insert_index(OldNewMap *onm, const int index)
 {
-	const struct OldNew *x1=v1, *x2=v2;
-	
-	if (x1->old > x2->old) return 1;
-	else if (x1->old < x2->old) return -1;
-	return 0;
+	const void *addr = onm->entries[index].old;
+	const unsigned int mask = OLDNEWMAP_MAP_MASK(onm);
+	unsigned int slot = oldnewmap_hash_slot(onm, addr);
+
+	for (;; slot = (slot + 1) & mask) {
+		const int index_slot = onm->map[slot];
+		if (index_slot == -1 || onm->entries[index_slot].old == addr) {
+			onm->map[slot] = index;
+			return;
+		}
+	}
 }
 
+static void oldnewmap_map_realloc(OldNewMap *onm)
+{
+	const size_t map_size = (size_t)1 << onm->map_size_exp;
+	int i;
 
-static void oldnewmap_sort(FileData *fd) 
+	if (onm->map) {
+		MEM_freeN(onm->map);
+	}
+	onm->map = MEM_mallocN(sizeof(*onm->map) * map_size, "OldNewMap.map");
+	memset(onm->map, 0xff, sizeof(*onm->map) * map_size);
+
+	for (i = 0; i < onm->nentries; i++) {
+		oldnewmap_map_insert_index(onm, i);
+	}
+}
+
+static void oldnewmap_init_data(OldNewMap *onm)
 {
-	BLI_assert(fd->libmap->sorted == false);
-	qsort(fd->libmap->entries, fd->libmap->nentries, sizeof(OldNew), verg_oldnewmap);
-	fd->libmap->sorted = 1;
+	onm->entriessize = 1 << OLDNEWMAP_DEFAULT_SIZE_EXP;
+	onm->entries = MEM_mallocN(sizeof(*onm->entries) * onm->entriessize, "OldNewMap.entries");
+	onm->map_size_exp = OLDNEWMAP_DEFAULT_SIZE_EXP + 1;
+	oldnewmap_map_realloc(onm);
+}
+
+static OldNewMap *oldnewmap_new(void) 
+{
+	OldNewMap *onm= MEM_callocN(sizeof(*onm), "OldNewMap");
+	
+	oldnewmap_init_data(onm);
+	
+	return onm;
 }
 
 /* nr is zero for data, and ID code for libdata */
@@ -322,12 +388,15 @@ static void oldnewmap_insert(OldNewMap *onm, const void *oldaddr, void *newaddr,
 	if (UNLIKELY(onm->nentries == onm->entriessize)) {
 		onm->entriessize *= 2;
 		onm->entries = MEM_reallocN(onm->entries, sizeof(*onm->entries) * onm->entriessize);
+		onm->map_size_exp += 1;
+		oldnewmap_map_realloc(onm);
 	}
 
-	entry = &onm->entries[onm->nentries++];
+	entry = &onm->entries[onm->nentries];
 	entry->old = oldaddr;
 	entry->newp = newaddr;
 	entry->nr = nr;
+	oldnewmap_map_insert_index(onm, onm->nentries++);
 }
 
 void blo_do_versions_oldnewmap_insert(OldNewMap *onm, const void *oldaddr, void *newaddr, int nr)
@@ -336,53 +405,22 @@ void blo_do_versions_oldnewmap_insert(OldNewMap *onm, const void *oldaddr, void
 }
 
 /**
- * Do a full search (no state).
- *
- * \param lasthit: Use as a reference position to avoid a full search
- * from either end of the array, giving more efficient lookups.
+ * Hash lookup (no state), returns the index of the entry or -1.
  *
- * \note This would seem an ideal case for hash or btree lookups.
- * However the data is written in-order, using the \a lasthit will normally avoid calling this function.
- * Creating a btree/hash structure adds overhead for the common-case to optimize the corner-case
- * (since most entries will never be retrieved).
- * So just keep full lookups as a fall-back.
+ * \note Data is written in-order, so checking the entry after the last hit
+ * (see #oldnewmap_lookup_and_inc) remains the common case, this handles the rest.
  */
-static int oldnewmap_lookup_entry_full(const OldNewMap *onm, const void *addr, int lasthit)
+static int oldnewmap_lookup_entry_full(const OldNewMap *onm, const void *addr)
 {
-	const int nentries = onm->nentries;
-	const OldNew *entries = onm->entries;
-	int i;
-
-	/* search relative to lasthit where possible */
-	if (lasthit >= 0 && lasthit < nentries) {
+	const unsigned int mask = OLDNEWMAP_MAP_MASK(onm);
+	unsigned int slot = oldnewmap_hash_slot(onm, addr);
 
-		/* search forwards */
-		i = lasthit;
-		while (++i != nentries) {
-			if (entries[i].old == addr) {
-				return i;
-			}
-		}
-
-		/* search backwards */
-		i = lasthit + 1;
-		while (i--) {
-			if (entries[i].old == addr) {
-				return i;
-			}
+	for (;; slot = (slot + 1) & mask) {
+		const int index = onm->map[slot];
+		if (index == -1 || onm->entries[index].old == addr) {
+			return index;
 		}
 	}
-	else {
-		/* search backwards (full) */
-		i = nentries;
-		while (i--) {
-			if (entries[i].old == addr) {
-				return i;
-			}
-		}
-	}
-
-	return -1;
 }
 
 static void *oldnewmap_lookup_and_inc(OldNewMap *onm, const void *addr, bool increase_users)
@@ -401,7 +439,7 @@ static void *oldnewmap_lookup_and_inc(OldNewMap *onm, const void *addr, bool inc
 		}
 	}
 	
-	i = oldnewmap_lookup_entry_full(onm, addr, onm->lasthit);
+	i = oldnewmap_lookup_entry_full(onm, addr);
 	if (i != -1) {
 		OldNew *entry = &onm->entries[i];
 		BLI_assert(entry->old == addr);
@@ -417,32 +455,19 @@ static void *oldnewmap_lookup_and_inc(OldNewMap *onm, const void *addr, bool inc
 /* for libdata, nr has ID code, no increment */
 static void *oldnewmap_liblookup(OldNewMap *onm, const void *addr, const void *lib)
 {
+	int i;
+
 	if (addr == NULL) {
 		return NULL;
 	}
 
-	/* lasthit works fine for non-libdata, linking there is done in same sequence as writing */
-	if (onm->sorted) {
-		const OldNew entry_s = {.old = addr};
-		OldNew *entry = bsearch(&entry_s, onm->entries, onm->nentries, sizeof(OldNew), verg_oldnewmap);
-		if (entry) {
-			ID *id = entry->newp;
-
-			if (id && (!lib || id->lib)) {
-				return id;
-			}
-		}
-	}
-	else {
-		/* note, this can be a bottle neck when loading some files */
-		const int i = oldnewmap_lookup_entry_full(onm, addr, -1);
-		if (i != -1) {
-			OldNew *entry = &onm->entries[i];
-			ID *id = entry->newp;
-			BLI_assert(entry->old == addr);
-			if (id && (!lib || id->lib)) {
-				return id;
-			}
+	i = oldnewmap_lookup_entry_full(onm, addr);
+	if (i != -1) {
+		OldNew *entry = &onm->entries[i];
+		ID *id = entry->newp;
+		BLI_assert(entry->old == addr);
+		if (id && (!lib || id->lib)) {
+			return id;
 		}
 	}
 
@@ -466,14 +491,28 @@ static void oldnewmap_clear(OldNewMap *onm)
 {
 	onm->nentries = 0;
 	onm->lasthit = 0;
+
+	/* The data map is cleared for every ID, don't keep clearing a large table
+	 * because one ID had many data-blocks. */
+	if (onm->entriessize > (1 << OLDNEWMAP_DEFAULT_SIZE_EXP)) {
+		MEM_freeN(onm->entries);
+		oldnewmap_init_data(onm);
+	}
+	else {
+		memset(onm->map, 0xff, sizeof(*onm->map) * ((size_t)1 << onm->map_size_exp));
+	}
 }
 
 static void oldnewmap_free(OldNewMap *onm) 
 {
 	MEM_freeN(onm->entries);
+	MEM_freeN(onm->map);
 	MEM_freeN(onm);
 }
 
+#undef OLDNEWMAP_MAP_MASK
+#undef OLDNEWMAP_DEFAULT_SIZE_EXP
+
 /***/
 
 static void read_libraries(FileData *basefd, ListBase *mainlist);
@@ -559,11 +598,17 @@ void blo_split_main(ListBase *mainlist, Main *main)
 	MEM_freeN(lib_main_array);
 }
 
+#ifdef USE_BHEAD_INDEX
+static BHead *blo_nextbhead_indexed(FileData *fd, BHead *thisblock);
+#else
+#  define blo_nextbhead_indexed blo_nextbhead
+#endif
+
 static void read_file_version(FileData *fd, Main *main)
 {
 	BHead *bhead;
 	
-	for (bhead= blo_firstbhead(fd); bhead; bhead= blo_nextbhead(fd, bhead)) {
+	for (bhead= blo_firstbhead(fd); bhead; bhead= blo_nextbhead_indexed(fd, bhead)) {
 		if (bhead->code == GLOB) {
 			FileGlobal *fg= read_struct(fd, bhead, "Global");
 			if (fg) {
@@ -592,7 +637,7 @@ static void read_file_bhead_idname_map_create(FileData *fd)
 	int code_prev = ENDB;
 	unsigned int reserve = 0;
 
-	for (bhead = blo_firstbhead(fd); bhead; bhead = blo_nextbhead(fd, bhead)) {
+	for (bhead = blo_firstbhead(fd); bhead; bhead = blo_nextbhead_indexed(fd, bhead)) {
 		if (code_prev != bhead->code) {
 			code_prev = bhead->code;
 			is_link = BKE_idcode_is_valid(code_prev) ? BKE_idcode_is_linkable(code_prev) : false;
@@ -607,7 +652,7 @@ static void read_file_bhead_idname_map_create(FileData *fd)
 
 	fd->bhead_idname_hash = BLI_ghash_str_new_ex(__func__, reserve);
 
-	for (bhead = blo_firstbhead(fd); bhead; bhead = blo_nextbhead(fd, bhead)) {
+	for (bhead = blo_firstbhead(fd); bhead; bhead = blo_nextbhead_indexed(fd, bhead)) {
 		if (code_prev != bhead->code) {
 			code_prev = bhead->code;
 			is_link = BKE_idcode_is_valid(code_prev) ? BKE_idcode_is_linkable(code_prev) : false;
@@ -736,6 +781,7 @@ static BHeadN *get_bhead(FileData *fd)
 	
 	if (fd) {
 		if (!fd->eof) {
+			const size_t offset = fd->mmap_seek;
 			/* initializing to zero isn't strictly needed but shuts valgrind up
 			 * since uninitialized memory gets compared */
 			BHead8 bhead8 = {0};
@@ -798,10 +844,26 @@ static BHeadN *get_bhead(FileData *fd)
 			/* bhead now contains the (converted) bhead structure. Now read
 			 * the associated data and put everything in a BHeadN (creative naming !)
 			 */
-			if (!fd->eof) {
+			/* reference the data in-place, unless it's modified by switching endian. */
+			if (!fd->eof && (fd->flags & FD_FLAGS_USE_MMAP) && !(fd->flags & FD_FLAGS_SWITCH_ENDIAN)) {
+				if ((size_t)bhead.len <= fd->mmap_size - fd->mmap_seek) {
+					new_bhead = MEM_mallocN(sizeof(BHeadN), "new_bhead");
+					new_bhead->next = new_bhead->prev = NULL;
+					new_bhead->data = fd->mmap_data + fd->mmap_seek;
+					new_bhead->offset = offset;
+					new_bhead->bhead = bhead;
+					fd->mmap_seek += (size_t)bhead.len;
+				}
+				else {
+					fd->eof = 1;
+				}
+			}
+			else if (!fd->eof) {
 				new_bhead = MEM_mallocN(sizeof(BHeadN) + bhead.len, "new_bhead");
 				if (new_bhead) {
 					new_bhead->next = new_bhead->prev = NULL;
+					new_bhead->data = new_bhead + 1;
+					new_bhead->offset = offset;
 					new_bhead->bhead = bhead;
 					
 					readsize = fd->read(fd, new_bhead + 1, bhead.len);
@@ -829,6 +891,50 @@ static BHeadN *get_bhead(FileData *fd)
 	return(new_bhead);
 }
 
+#ifdef USE_BHEAD_INDEX
+/**
+ * Read the block following \a bheadn in the file, when it's not been read yet
+ * it's inserted in the list of blocks which stays sorted by offset.
+ */
+static BHeadN *get_bhead_sparse_next(FileData *fd, BHeadN *bheadn)
+{
+	const size_t offset_next = (size_t)((char *)bheadn->data - fd->mmap_data) + (size_t)bheadn->bhead.len;
+	BHeadN *new_bhead = bheadn->next;
+
+	if (bheadn->bhead.code == ENDB) {
+		return NULL;
+	}
+
+	if (new_bhead && (new_bhead->offset == offset_next)) {
+		return new_bhead;
+	}
+
+	fd->mmap_seek = offset_next;
+	new_bhead = get_bhead(fd);
+	if (new_bhead) {
+		BLI_remlink(&fd->listbase, new_bhead);
+		BLI_insertlinkafter(&fd->listbase, bheadn, new_bhead);
+	}
+
+	return new_bhead;
+}
+
+/**
+ * Same as #blo_nextbhead, except that when only indexed blocks are read,
+ * the DATA blocks that haven't been read are skipped.
+ * Use when looking for blocks that aren't DATA.
+ */
+static BHead *blo_nextbhead_indexed(FileData *fd, BHead *thisblock)
+{
+	if (fd->flags & FD_FLAGS_BHEAD_SPARSE) {
+		BHeadN *bheadn = (BHeadN *)POINTER_OFFSET(thisblock, -offsetof(BHeadN, bhead));
+		bheadn = bheadn->next;
+		return (bheadn) ? &bheadn->bhead : NULL;
+	}
+	return blo_nextbhead(fd, thisblock);
+}
+#endif  /* USE_BHEAD_INDEX */
+
 BHead *blo_firstbhead(FileData *fd)
 {
 	BHeadN *new_bhead;
@@ -849,6 +955,10 @@ BHead *blo_firstbhead(FileData *fd)
 	return(bhead);
 }
 
+/**
+ * \note When only indexed blocks are read (see: USE_BHEAD_INDEX), this is the previous block that has been read,
+ * which is fine for finding library blocks since they're always indexed.
+ */
 BHead *blo_prevbhead(FileData *UNUSED(fd), BHead *thisblock)
 {
 	BHeadN *bheadn = (BHeadN *)POINTER_OFFSET(thisblock, -offsetof(BHeadN, bhead));
@@ -867,10 +977,19 @@ BHead *blo_nextbhead(FileData *fd, BHead *thisblock)
 		 * We calculate the BHeadN pointer from the BHead pointer below */
 		new_bhead = (BHeadN *)POINTER_OFFSET(thisblock, -offsetof(BHeadN, bhead));
 		
-		/* get the next BHeadN. If it doesn't exist we read in the next one */
-		new_bhead = new_bhead->next;
-		if (new_bhead == NULL) {
-			new_bhead = get_bhead(fd);
+#ifdef USE_BHEAD_INDEX
+		if (fd->flags & FD_FLAGS_BHEAD_SPARSE) {
+			new_bhead = get_bhead_sparse_next(fd, new_bhead);
+		}
+		else
+#endif
+		{
+			/* get the next BHeadN. If it doesn't exist we read in the next one,
+			 * nothing after ENDB is part of the file data (see #blo_read_block_hashes). */
+			new_bhead = new_bhead->next;
+			if ((new_bhead == NULL) && (thisblock->code != ENDB)) {
+				new_bhead = get_bhead(fd);
+			}
 		}
 	}
 	
@@ -883,10 +1002,84 @@ BHead *blo_nextbhead(FileData *fd, BHead *thisblock)
 	return(bhead);
 }
 
+/**
+ * Read the optional table of block hashes stored after #ENDB (see #G_FILE_BLOCK_HASH).
+ *
+ * \return An array of \a r_tot hashes, owned by the caller, or NULL when the file has none.
+ */
+BlendBlockHash *blo_read_block_hashes(FileData *fd, int *r_tot)
+{
+	BlendBlockHash *table = NULL;
+	BHead *bhead;
+	BHeadN *bheadn;
+
+	*r_tot = 0;
+
+	for (bhead = blo_firstbhead(fd); bhead; bhead = blo_nextbhead(fd, bhead)) {
+		if (bhead->code == ENDB) {
+			break;
+		}
+	}
+
+	if ((bhead == NULL) || fd->eof) {
+		return NULL;
+	}
+
+	bheadn = (BHeadN *)POINTER_OFFSET(bhead, -offsetof(BHeadN, bhead));
+	BLI_assert(bheadn->next == NULL);
+
+	if (fd->flags & FD_FLAGS_USE_MMAP) {
+		fd->mmap_seek = (size_t)((char *)bheadn->data - fd->mmap_data);
+	}
+	/* Otherwise the stream is already past ENDB (it's always the last block read). */
+
+	bheadn = get_bhead(fd);
+	if (bheadn == NULL) {
+		return NULL;
+	}
+
+	if ((bheadn->bhead.code == HASH) &&
+	    (bheadn->bhead.nr > 0) &&
+	    ((size_t)bheadn->bhead.len == sizeof(*table) * (size_t)bheadn->bhead.nr))
+	{
+		const int tot = bheadn->bhead.nr;
+		table = MEM_mallocN(sizeof(*table) * (size_t)tot, __func__);
+		memcpy(table, bheadn->data, sizeof(*table) * (size_t)tot);
+
+		if (fd->flags & FD_FLAGS_SWITCH_ENDIAN) {
+			BlendBlockHash *bbh = table;
+			for (int i = 0; i < tot; i++, bbh++) {
+				BLI_endian_switch_uint64(&bbh->offset);
+				BLI_endian_switch_uint64(&bbh->old);
+				BLI_endian_switch_int32(&bbh->code);
+				BLI_endian_switch_int32(&bbh->len);
+				BLI_endian_switch_int32(&bbh->SDNAnr);
+				BLI_endian_switch_int32(&bbh->nr);
+			}
+		}
+		*r_tot = tot;
+	}
+
+	/* Keep the list of blocks ending with ENDB. */
+	BLI_remlink(&fd->listbase, bheadn);
+	MEM_freeN(bheadn);
+
+	return table;
+}
+
+/**
+ * \return the data stored after \a bhead in the file.
+ */
+void *blo_bhead_data(BHead *bhead)
+{
+	BHeadN *bheadn = (BHeadN *)POINTER_OFFSET(bhead, -offsetof(BHeadN, bhead));
+	return bheadn->data;
+}
+
 /* Warning! Caller's responsability to ensure given bhead **is** and ID one! */
 const char *bhead_id_name(const FileData *fd, const BHead *bhead)
 {
-	return (const char *)POINTER_OFFSET(bhead, sizeof(*bhead) + fd->id_name_offs);
+	return (const char *)POINTER_OFFSET(blo_bhead_data((BHead *)bhead), fd->id_name_offs);
 }
 
 static void decode_blender_header(FileData *fd)
@@ -936,14 +1129,17 @@ static bool read_file_dna(FileData *fd, const char **r_error_message)
 {
 	BHead *bhead;
 	
-	for (bhead = blo_firstbhead(fd); bhead; bhead = blo_nextbhead(fd, bhead)) {
+	for (bhead = blo_firstbhead(fd); bhead; bhead = blo_nextbhead_indexed(fd, bhead)) {
 		if (bhead->code == DNA1) {
 			const bool do_endian_swap = (fd->flags & FD_FLAGS_SWITCH_ENDIAN) != 0;
 			
-			fd->filesdna = DNA_sdna_from_data(&bhead[1], bhead->len, do_endian_swap, true, r_error_message);
+			fd->filesdna = DNA_sdna_from_data(blo_bhead_data(bhead), bhead->len, do_endian_swap, true, r_error_message);
 			if (fd->filesdna) {
 				fd->compflags = DNA_struct_get_compareflags(fd->filesdna, fd->memsdna);
-				/* used to retrieve ID names from (bhead+1) */
+				if (fd->compflags) {
+					fd->reconstruct_info = DNA_reconstruct_info_create(fd->filesdna, fd->memsdna, fd->compflags);
+				}
+				/* used to retrieve ID names from the block data */
 				fd->id_name_offs = DNA_elem_offset(fd->filesdna, "ID", "char", "name[]");
 
 				return true;
@@ -969,7 +1165,7 @@ static int *read_file_thumbnail(FileData *fd)
 	for (bhead = blo_firstbhead(fd); bhead; bhead = blo_nextbhead(fd, bhead)) {
 		if (bhead->code == TEST) {
 			const bool do_endian_swap = (fd->flags & FD_FLAGS_SWITCH_ENDIAN) != 0;
-			int *data = (int *)(bhead + 1);
+			int *data = blo_bhead_data(bhead);
 
 			if (bhead->len < (2 * sizeof(int))) {
 				break;
@@ -1035,6 +1231,17 @@ static int fd_read_from_memory(FileData *filedata, void *buffer, unsigned int si
 	return (readsize);
 }
 
+static int fd_read_from_mmap(FileData *filedata, void *buffer, unsigned int size)
+{
+	/* don't read more bytes then there are available in the mapping */
+	const size_t readsize = MIN2((size_t)size, filedata->mmap_size - filedata->mmap_seek);
+
+	memcpy(buffer, filedata->mmap_data + filedata->mmap_seek, readsize);
+	filedata->mmap_seek += readsize;
+
+	return (int)readsize;
+}
+
 static int fd_read_from_memfile(FileData *filedata, void *buffer, unsigned int size)
 {
 	static unsigned int seek = (1<<30);	/* the current position */
@@ -1110,12 +1317,220 @@ static FileData *filedata_new(void)
 	return fd;
 }
 
+#ifdef USE_BHEAD_INDEX
+
+/* -------------------------------------------------------------------- */
+/** \name Block Index
+ *
+ * A cache of the offsets of the first block and all blocks that aren't DATA,
+ * used to only read the blocks that are accessed, see #get_bhead_sparse_next.
+ *
+ * Stored in the user data-files directory by hashing the file path,
+ * so libraries don't need to be writable. The index is validated
+ * by the size and modification time of the file.
+ * It's written in native byte order since it's only a local cache.
+ * \{ */
+
+#define BHEAD_INDEX_MAGIC "BLENDIDX"
+#define BHEAD_INDEX_DIR "library_index"
+
+typedef struct BHeadIndexHeader {
+	char magic[8];
+	uint64_t file_size;
+	int64_t file_mtime;
+	/* size of the file data, which differs from the file size when it's compressed */
+	uint64_t data_size;
+	uint32_t offsets_len, _pad;
+	/* uint64_t offsets[offsets_len] follow */
+} BHeadIndexHeader;
+
+static bool blo_bhead_index_use(const FileData *fd)
+{
+	return ((fd->flags & FD_FLAGS_USE_MMAP) && (fd->flags & FD_FLAGS_SWITCH_ENDIAN) == 0 && fd->relabase[0]);
+}
+
+static bool blo_bhead_index_filepath(const char *filepath, const bool create, char r_index_path[FILE_MAX])
+{
+	const char *dir = create ?
+	        BKE_appdir_folder_id_create(BLENDER_USER_DATAFILES, BHEAD_INDEX_DIR) :
+	        BKE_appdir_folder_id(BLENDER_USER_DATAFILES, BHEAD_INDEX_DIR);
+	char digest[16], digest_hex[33];
+
+	if (dir == NULL) {
+		return false;
+	}
+
+	BLI_hash_md5_buffer(filepath, strlen(filepath), digest);
+	BLI_hash_md5_to_hexdigest(digest, digest_hex);
+	BLI_join_dirfile(r_index_path, FILE_MAX, dir, digest_hex);
+	return true;
+}
+
+static void blo_bhead_index_header_init(const FileData *fd, const BLI_stat_t *st, BHeadIndexHeader *header)
+{
+	memset(header, 0, sizeof(*header));
+	memcpy(header->magic, BHEAD_INDEX_MAGIC, sizeof(header->magic));
+	header->file_size = (uint64_t)st->st_size;
+	header->file_mtime = (int64_t)st->st_mtime;
+	header->data_size = (uint64_t)fd->mmap_size;
+}
+
+/**
+ * Read the indexed blocks, on failure the blocks are read sequentially as usual.
+ */
+static bool blo_bhead_index_apply(FileData *fd, const uint64_t *offsets, const uint offsets_len)
+{
+	const size_t seek_first = fd->mmap_seek;
+	BHeadN *bheadn = NULL;
+	uint i;
+
+	BLI_assert(BLI_listbase_is_empty(&fd->listbase));
+
+	if (offsets[0] == (uint64_t)seek_first) {
+		for (i = 0; i < offsets_len; i++) {
+			if ((offsets[i] >= (uint64_t)fd->mmap_size) || (i != 0 && offsets[i] <= offsets[i - 1])) {
+				break;
+			}
+			fd->mmap_seek = (size_t)offsets[i];
+			bheadn = get_bhead(fd);
+			if ((bheadn == NULL) || (i != 0 && bheadn->bhead.code == DATA)) {
+				break;
+			}
+		}
+
+		if ((i == offsets_len) && (bheadn->bhead.code == ENDB)) {
+			fd->flags |= FD_FLAGS_BHEAD_SPARSE;
+			return true;
+		}
+	}
+
+	BLI_freelistN(&fd->listbase);
+	fd->mmap_seek = seek_first;
+	fd->eof = 0;
+	return false;
+}
+
+static bool blo_bhead_index_read(FileData *fd)
+{
+	char index_path[FILE_MAX];
+	BHeadIndexHeader header, header_test;
+	BLI_stat_t st;
+	bool ok = false;
+	int file;
+
+	if (!blo_bhead_index_filepath(fd->relabase, false, index_path) ||
+	    (BLI_stat(fd->relabase, &st) == -1))
+	{
+		return false;
+	}
+
+	file = BLI_open(index_path, O_BINARY | O_RDONLY, 0);
+	if (file == -1) {
+		return false;
+	}
+
+	blo_bhead_index_header_init(fd, &st, &header_test);
+
+	if ((read(file, &header, sizeof(header)) == sizeof(header)) &&
+	    STREQLEN(header.magic, header_test.magic, sizeof(header.magic)) &&
+	    (header.file_size == header_test.file_size) &&
+	    (header.file_mtime == header_test.file_mtime) &&
+	    (header.data_size == header_test.data_size) &&
+	    /* every block has at least a header */
+	    (header.offsets_len != 0) && (header.offsets_len <= fd->mmap_size / 8))
+	{
+		const size_t offsets_size = sizeof(uint64_t) * header.offsets_len;
+		uint64_t *offsets = MEM_mallocN(offsets_size, __func__);
+
+		if (read(file, offsets, offsets_size) == (int)offsets_size) {
+			ok = blo_bhead_index_apply(fd, offsets, header.offsets_len);
+		}
+		MEM_freeN(offsets);
+	}
+
+	close(file);
+
+	return ok;
+}
+
+/**
+ * Write the index when it wasn't used to read the file, reading the remaining blocks.
+ */
+static void blo_bhead_index_write(FileData *fd)
+{
+	char index_path[FILE_MAX], index_path_temp[FILE_MAX];
+	BHeadIndexHeader header;
+	BHead *bhead, *bhead_last = NULL;
+	uint64_t *offsets;
+	uint offsets_len = 0;
+	BLI_stat_t st;
+	int file;
+
+	if (!blo_bhead_index_use(fd) || (fd->flags & FD_FLAGS_BHEAD_SPARSE)) {
+		return;
+	}
+
+	for (bhead = blo_firstbhead(fd); bhead; bhead = blo_nextbhead(fd, bhead)) {
+		if ((bhead_last == NULL) || (bhead->code != DATA)) {
+			offsets_len++;
+		}
+		bhead_last = bhead;
+	}
+
+	if ((bhead_last == NULL) || (bhead_last->code != ENDB) ||
+	    (BLI_stat(fd->relabase, &st) == -1) ||
+	    !blo_bhead_index_filepath(fd->relabase, true, index_path))
+	{
+		return;
+	}
+
+	BLI_snprintf(index_path_temp, sizeof(index_path_temp), "%s@", index_path);
+	file = BLI_open(index_path_temp, O_BINARY | O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (file == -1) {
+		return;
+	}
+
+	blo_bhead_index_header_init(fd, &st, &header);
+	header.offsets_len = offsets_len;
+
+	offsets = MEM_mallocN(sizeof(uint64_t) * offsets_len, __func__);
+	offsets_len = 0;
+	for (bhead = blo_firstbhead(fd); bhead; bhead = blo_nextbhead(fd, bhead)) {
+		if ((offsets_len == 0) || (bhead->code != DATA)) {
+			BHeadN *bheadn = (BHeadN *)POINTER_OFFSET(bhead, -offsetof(BHeadN, bhead));
+			offsets[offsets_len++] = (uint64_t)bheadn->offset;
+		}
+	}
+
+	if ((write(file, &header, sizeof(header)) == sizeof(header)) &&
+	    (write(file, offsets, sizeof(uint64_t) * offsets_len) == (int)(sizeof(uint64_t) * offsets_len)))
+	{
+		close(file);
+		BLI_rename(index_path_temp, index_path);
+	}
+	else {
+		close(file);
+		BLI_delete(index_path_temp, false, false);
+	}
+
+	MEM_freeN(offsets);
+}
+
+/** \} */
+
+#endif  /* USE_BHEAD_INDEX */
+
 static FileData *blo_decode_and_check(FileData *fd, ReportList *reports)
 {
 	decode_blender_header(fd);
 	
 	if (fd->flags & FD_FLAGS_FILE_OK) {
 		const char *error_message = NULL;
+#ifdef USE_BHEAD_INDEX
+		if (blo_bhead_index_use(fd)) {
+			blo_bhead_index_read(fd);
+		}
+#endif
 		if (read_file_dna(fd, &error_message) == false) {
 			BKE_reportf(reports, RPT_ERROR,
 			            "Failed to read blend file '%s': %s",
@@ -1133,10 +1548,376 @@ static FileData *blo_decode_and_check(FileData *fd, ReportList *reports)
 	return fd;
 }
 
+#ifdef USE_BHEAD_MMAP
+/**
+ * Memory map an uncompressed file,
+ * \return NULL for compressed files or when mapping fails, the file is then read through zlib.
+ */
+static FileData *blo_filedata_from_mmap(const char *filepath)
+{
+	FileData *fd = NULL;
+	const int file = BLI_open(filepath, O_BINARY | O_RDONLY, 0);
+	struct stat st;
+	unsigned char magic[2];
+
+	if (file == -1) {
+		return NULL;
+	}
+
+	if ((fstat(file, &st) == 0) &&
+	    (st.st_size >= SIZEOFBLENDERHEADER) &&
+	    (read(file, magic, sizeof(magic)) == sizeof(magic)) &&
+	    /* gzip compressed files are read by zlib */
+	    !(magic[0] == 0x1f && magic[1] == 0x8b))
+	{
+		/* private (copy on write) mapping, since endian switching writes into the data */
+		void *data = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+		if (data != MAP_FAILED) {
+			fd = filedata_new();
+			fd->mmap_data = data;
+			fd->mmap_size = (size_t)st.st_size;
+			fd->read = fd_read_from_mmap;
+			fd->flags |= FD_FLAGS_USE_MMAP;
+		}
+	}
+
+	/* the mapping stays valid after closing */
+	close(file);
+
+	return fd;
+}
+#endif
+
+#ifdef WITH_LZO
+
+/* -------------------------------------------------------------------- */
+/** \name Fast Compressed Files
+ *
+ * See #BLEND_FRAMES_MAGIC for the file layout.
+ * \{ */
+
+#ifdef WIN32
+#  define BLO_LSEEK _lseeki64
+#else
+#  define BLO_LSEEK lseek
+#endif
+
+static bool blo_frames_read_at(int file, int64_t offset, void *buf, size_t len)
+{
+	char *buf_iter = buf;
+
+	if (BLO_LSEEK(file, offset, SEEK_SET) != offset) {
+		return false;
+	}
+
+	/* read in chunks, a single read can't be larger than an int on all systems */
+	while (len) {
+		const unsigned int chunk = (unsigned int)MIN2(len, (size_t)(1 << 30));
+		if (read(file, buf_iter, chunk) != (int)chunk) {
+			return false;
+		}
+		buf_iter += chunk;
+		len -= chunk;
+	}
+	return true;
+}
+
+static bool blo_frame_decompress(const BlendFrame *frame, const char *in, char *out)
+{
+	lzo_uint out_len = frame->size_raw;
+
+	if (frame->size == frame->size_raw) {
+		memcpy(out, in, frame->size);
+		return true;
+	}
+
+	return ((lzo1x_decompress_safe(
+	             (const unsigned char *)in, frame->size, (unsigned char *)out, &out_len, NULL) == LZO_E_OK) &&
+	        (out_len == frame->size_raw));
+}
+
+/**
+ * Read the frame index into \a fd, validating all frames are within the file.
+ */
+static bool blo_frames_read_index(FileData *fd, int file)
+{
+	BlendFramesFooter footer;
+	const int64_t file_size = BLO_LSEEK(file, 0, SEEK_END);
+	size_t offset_raw = 0;
+	unsigned int i;
+
+	if ((file_size < (int64_t)(BLEND_FRAMES_MAGIC_LEN + sizeof(footer))) ||
+	    !blo_frames_read_at(file, file_size - (int64_t)sizeof(footer), &footer, sizeof(footer)) ||
+	    !STREQLEN(footer.magic, BLEND_FRAMES_MAGIC, BLEND_FRAMES_MAGIC_LEN))
+	{
+		return false;
+	}
+
+	if (ENDIAN_ORDER == B_ENDIAN) {
+		BLI_endian_switch_uint64(&footer.index_offset);
+		BLI_endian_switch_uint32(&footer.frames_len);
+	}
+
+	if ((footer.frames_len == 0) ||
+	    (footer.index_offset + (uint64_t)footer.frames_len * sizeof(BlendFrame) + sizeof(footer) != (uint64_t)file_size))
+	{
+		return false;
+	}
+
+	fd->frames_len = footer.frames_len;
+	fd->frames = MEM_mallocN(sizeof(*fd->frames) * fd->frames_len, __func__);
+	fd->frames_offset_raw = MEM_mallocN(sizeof(*fd->frames_offset_raw) * (fd->frames_len + 1), __func__);
+
+	if (!blo_frames_read_at(file, (int64_t)footer.index_offset, fd->frames, sizeof(*fd->frames) * fd->frames_len)) {
+		return false;
+	}
+
+	for (i = 0; i < fd->frames_len; i++) {
+		BlendFrame *frame = &fd->frames[i];
+		if (ENDIAN_ORDER == B_ENDIAN) {
+			BLI_endian_switch_uint64(&frame->offset);
+			BLI_endian_switch_uint32(&frame->size);
+			BLI_endian_switch_uint32(&frame->size_raw);
+		}
+		if ((frame->size_raw > BLEND_FRAMES_FRAME_SIZE) ||
+		    (frame->size > frame->size_raw) ||
+		    (frame->offset < BLEND_FRAMES_MAGIC_LEN) ||
+		    (frame->offset + frame->size > footer.index_offset))
+		{
+			return false;
+		}
+		fd->frames_offset_raw[i] = offset_raw;
+		offset_raw += frame->size_raw;
+	}
+	fd->frames_offset_raw[fd->frames_len] = offset_raw;
+
+	return true;
+}
+
+typedef struct FramesDecodeTask {
+	const BlendFrame *frames;
+	const size_t *frames_offset_raw;
+	const char *data;
+	char *data_raw;
+	bool *frames_ok;
+} FramesDecodeTask;
+
+static void frames_decode_task_cb(void *userdata, void *UNUSED(userdata_chunk), const int i, const int UNUSED(thread_id))
+{
+	FramesDecodeTask *task = userdata;
+	const BlendFrame *frame = &task->frames[i];
+
+	/* compressed data is read starting at the first frame */
+	task->frames_ok[i] = blo_frame_decompress(
+	        frame, task->data + (frame->offset - BLEND_FRAMES_MAGIC_LEN), task->data_raw + task->frames_offset_raw[i]);
+}
+
+/**
+ * Decompress all frames (in parallel), the result is read like a memory mapped file.
+ */
+static bool blo_frames_decode_all(FileData *fd, int file)
+{
+	FramesDecodeTask task;
+	const BlendFrame *frame_last = &fd->frames[fd->frames_len - 1];
+	const size_t data_len = (size_t)(frame_last->offset + frame_last->size) - BLEND_FRAMES_MAGIC_LEN;
+	char *data = MEM_mallocN(data_len, __func__);
+	bool ok = true;
+	unsigned int i;
+
+	if (!blo_frames_read_at(file, BLEND_FRAMES_MAGIC_LEN, data, data_len)) {
+		MEM_freeN(data);
+		return false;
+	}
+
+	task.frames = fd->frames;
+	task.frames_offset_raw = fd->frames_offset_raw;
+	task.data = data;
+	task.data_raw = MEM_mallocN(fd->frames_offset_raw[fd->frames_len], __func__);
+	task.frames_ok = MEM_mallocN(sizeof(*task.frames_ok) * fd->frames_len, __func__);
+
+	BLI_task_parallel_range_ex(0, (int)fd->frames_len, &task, NULL, 0, frames_decode_task_cb, fd->frames_len > 1, false);
+
+	for (i = 0; i < fd->frames_len; i++) {
+		ok &= task.frames_ok[i];
+	}
+
+	MEM_freeN(task.frames_ok);
+	MEM_freeN(data);
+
+	fd->mmap_data = task.data_raw;
+	fd->mmap_size = fd->frames_offset_raw[fd->frames_len];
+	fd->read = fd_read_from_mmap;
+	fd->flags |= FD_FLAGS_USE_MMAP | FD_FLAGS_MMAP_IS_ALLOC;
+
+	return ok;
+}
+
+/* Load a single frame into #FileData.frame_buf. */
+static bool blo_frames_load(FileData *fd, const int frame_index)
+{
+	const BlendFrame *frame = &fd->frames[frame_index];
+	/* the compressed data is never larger than a frame, read it into the second half */
+	char *buf_in = fd->frame_buf + BLEND_FRAMES_FRAME_SIZE;
+
+	fd->frame_loaded = -1;
+
+	if (!blo_frames_read_at(fd->filedes, (int64_t)frame->offset, buf_in, frame->size) ||
+	    !blo_frame_decompress(frame, buf_in, fd->frame_buf))
+	{
+		return false;
+	}
+
+	fd->frame_loaded = frame_index;
+	return true;
+}
+
+/* Find the frame containing \a offset_raw (in the uncompressed stream), -1 when out of range. */
+static int blo_frames_find(const FileData *fd, const size_t offset_raw)
+{
+	unsigned int min = 0, max = fd->frames_len;
+
+	if (offset_raw >= fd->frames_offset_raw[fd->frames_len]) {
+		return -1;
+	}
+
+	while (max - min > 1) {
+		const unsigned int mid = (min + max) / 2;
+		if (fd->frames_offset_raw[mid] <= offset_raw) {
+			min = mid;
+		}
+		else {
+			max = mid;
+		}
+	}
+	return (int)min;
+}
+
+/* Read on demand, only decompressing the frames that are accessed. */
+static int fd_read_from_frames(FileData *filedata, void *buffer, unsigned int size)
+{
+	size_t totread = 0;
+
+	while (totread < size) {
+		int frame_index = filedata->frame_loaded;
+		size_t frame_seek, readsize;
+
+		if ((frame_index == -1) ||
+		    (filedata->frames_seek <  filedata->frames_offset_raw[frame_index]) ||
+		    (filedata->frames_seek >= filedata->frames_offset_raw[frame_index + 1]))
+		{
+			frame_index = blo_frames_find(filedata, filedata->frames_seek);
+			if (frame_index == -1) {
+				break;
+			}
+			if (!blo_frames_load(filedata, frame_index)) {
+				return EOF;
+			}
+		}
+
+		frame_seek = filedata->frames_seek - filedata->frames_offset_raw[frame_index];
+		readsize = MIN2((size_t)size - totread, (size_t)filedata->frames[frame_index].size_raw - frame_seek);
+
+		memcpy(POINTER_OFFSET(buffer, totread), filedata->frame_buf + frame_seek, readsize);
+		filedata->frames_seek += readsize;
+		totread += readsize;
+	}
+
+	return (int)totread;
+}
+
+/**
+ * Open a fast compressed file.
+ *
+ * \param decode_all: Decompress the whole file up-front (using threads),
+ * otherwise frames are read and decompressed on demand (for light access, e.g. thumbnails).
+ * \param r_is_frames: Set when the file uses this format, so failing to read it can be reported.
+ */
+static FileData *blo_filedata_from_frames(const char *filepath, const bool decode_all, bool *r_is_frames)
+{
+	FileData *fd;
+	const int file = BLI_open(filepath, O_BINARY | O_RDONLY, 0);
+	char magic[BLEND_FRAMES_MAGIC_LEN];
+
+	*r_is_frames = false;
+
+	if (file == -1) {
+		return NULL;
+	}
+
+	if ((read(file, magic, sizeof(magic)) != sizeof(magic)) ||
+	    !STREQLEN(magic, BLEND_FRAMES_MAGIC, BLEND_FRAMES_MAGIC_LEN))
+	{
+		close(file);
+		return NULL;
+	}
+
+	*r_is_frames = true;
+
+	fd = filedata_new();
+
+	if (blo_frames_read_index(fd, file)) {
+		if (decode_all) {
+			const bool ok = blo_frames_decode_all(fd, file);
+			close(file);
+			if (ok) {
+				return fd;
+			}
+		}
+		else {
+			fd->filedes = file;
+			fd->frame_buf = MEM_mallocN(BLEND_FRAMES_FRAME_SIZE * 2, __func__);
+			fd->frame_loaded = -1;
+			fd->read = fd_read_from_frames;
+			return fd;
+		}
+	}
+	else {
+		close(file);
+	}
+
+	blo_freefiledata(fd);
+	return NULL;
+}
+
+#undef BLO_LSEEK
+
+/** \} */
+
+#endif  /* WITH_LZO */
+
 /* cannot be called with relative paths anymore! */
 /* on each new library added, it now checks for the current FileData and expands relativeness */
 FileData *blo_openblenderfile(const char *filepath, ReportList *reports)
 {
+#ifdef WITH_LZO
+	{
+		bool is_frames;
+		FileData *fd = blo_filedata_from_frames(filepath, true, &is_frames);
+		if (fd) {
+			/* needed for library_append and read_libraries */
+			BLI_strncpy(fd->relabase, filepath, sizeof(fd->relabase));
+
+			return blo_decode_and_check(fd, reports);
+		}
+		else if (is_frames) {
+			BKE_reportf(reports, RPT_ERROR, "Failed to read blend file '%s', compressed data is corrupt", filepath);
+			return NULL;
+		}
+	}
+#endif
+
+#ifdef USE_BHEAD_MMAP
+	{
+		FileData *fd = blo_filedata_from_mmap(filepath);
+		if (fd) {
+			/* needed for library_append and read_libraries */
+			BLI_strncpy(fd->relabase, filepath, sizeof(fd->relabase));
+
+			return blo_decode_and_check(fd, reports);
+		}
+	}
+#endif
+
 	gzFile gzfile;
 	errno = 0;
 	gzfile = BLI_gzopen(filepath, "rb");
@@ -1164,15 +1945,30 @@ FileData *blo_openblenderfile(const char *filepath, ReportList *reports)
  */
 static FileData *blo_openblenderfile_minimal(const char *filepath)
 {
+	FileData *fd = NULL;
 	gzFile gzfile;
-	errno = 0;
-	gzfile = BLI_gzopen(filepath, "rb");
 
-	if (gzfile != (gzFile)Z_NULL) {
-		FileData *fd = filedata_new();
-		fd->gzfiledes = gzfile;
-		fd->read = fd_read_gzip_from_file;
+#ifdef WITH_LZO
+	{
+		bool is_frames;
+		fd = blo_filedata_from_frames(filepath, false, &is_frames);
+		if (is_frames && (fd == NULL)) {
+			return NULL;
+		}
+	}
+#endif
+
+	if (fd == NULL) {
+		errno = 0;
+		gzfile = BLI_gzopen(filepath, "rb");
+		if (gzfile != (gzFile)Z_NULL) {
+			fd = filedata_new();
+			fd->gzfiledes = gzfile;
+			fd->read = fd_read_gzip_from_file;
+		}
+	}
 
+	if (fd) {
 		decode_blender_header(fd);
 
 		if (fd->flags & FD_FLAGS_FILE_OK) {
@@ -1293,12 +2089,36 @@ void blo_freefiledata(FileData *fd)
 			MEM_freeN((void *)fd->buffer);
 			fd->buffer = NULL;
 		}
+
+		if (fd->mmap_data) {
+			if (fd->flags & FD_FLAGS_MMAP_IS_ALLOC) {
+				MEM_freeN(fd->mmap_data);
+			}
+#ifdef USE_BHEAD_MMAP
+			else {
+				munmap(fd->mmap_data, fd->mmap_size);
+			}
+#endif
+			fd->mmap_data = NULL;
+		}
+
+		if (fd->frames) {
+			MEM_freeN(fd->frames);
+		}
+		if (fd->frames_offset_raw) {
+			MEM_freeN(fd->frames_offset_raw);
+		}
+		if (fd->frame_buf) {
+			MEM_freeN(fd->frame_buf);
+		}
 		
 		// Free all BHeadN data blocks
 		BLI_freelistN(&fd->listbase);
 
 		if (fd->filesdna)
 			DNA_sdna_free(fd->filesdna);
+		if (fd->reconstruct_info)
+			DNA_reconstruct_info_free(fd->reconstruct_info);
 		if (fd->compflags)
 			MEM_freeN((void *)fd->compflags);
 		
@@ -1551,9 +2371,6 @@ static void *newlibadr_real_us(FileData *fd, const void *lib, const void *adr)	/
 static void change_idid_adr_fd(FileData *fd, const void *old, void *new)
 {
 	int i;
-	
-	/* use a binary search if we have a sorted libmap, for now it's not needed. */
-	BLI_assert(fd->libmap->sorted == false);
 
 	for (i = 0; i < fd->libmap->nentries; i++) {
 		OldNew *entry = &fd->libmap->entries[i];
@@ -1874,7 +2691,7 @@ static void switch_endian_structs(const struct SDNA *filesdna, BHead *bhead)
 	int blocksize, nblocks;
 	char *data;
 	
-	data = (char *)(bhead+1);
+	data = blo_bhead_data(bhead);
 	blocksize = filesdna->typelens[ filesdna->structs[bhead->SDNAnr][0] ];
 	
 	nblocks = bhead->nr;
@@ -1896,12 +2713,12 @@ static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
 		
 		if (fd->compflags[bh->SDNAnr] != SDNA_CMP_REMOVED) {
 			if (fd->compflags[bh->SDNAnr] == SDNA_CMP_NOT_EQUAL) {
-				temp = DNA_struct_reconstruct(fd->memsdna, fd->filesdna, fd->compflags, bh->SDNAnr, bh->nr, (bh+1));
+				temp = DNA_struct_reconstruct(fd->reconstruct_info, bh->SDNAnr, bh->nr, blo_bhead_data(bh));
 			}
 			else {
 				/* SDNA_CMP_EQUAL */
 				temp = MEM_mallocN(bh->len, blockname);
-				memcpy(temp, (bh+1), bh->len);
+				memcpy(temp, blo_bhead_data(bh), bh->len);
 			}
 		}
 	}
@@ -2518,6 +3335,10 @@ static void direct_link_fcurves(FileData *fd, ListBase *list)
 		 */
 		fcu->flag &= ~FCURVE_DISABLED;
 		
+		/* runtime caches */
+		fcu->last_segment = 0;
+		memset(&fcu->rna_cache, 0, sizeof(fcu->rna_cache));
+		
 		/* driver */
 		fcu->driver= newdataadr(fd, fcu->driver);
 		if (fcu->driver) {
@@ -2526,6 +3347,7 @@ static void direct_link_fcurves(FileData *fd, ListBase *list)
 			
 			/* compiled expression data will need to be regenerated (old pointer may still be set here) */
 			driver->expr_comp = NULL;
+			driver->expr_simple = NULL;
 			
 			/* give the driver a fresh chance - the operating environment may be different now 
 			 * (addons, etc. may be different) so the driver namespace may be sane now [#32155]
@@ -2542,6 +3364,7 @@ static void direct_link_fcurves(FileData *fd, ListBase *list)
 						dtar->rna_path = newdataadr(fd, dtar->rna_path);
 					else
 						dtar->rna_path = NULL;
+					memset(&dtar->rna_cache, 0, sizeof(dtar->rna_cache));
 				}
 				DRIVER_TARGETS_LOOPER_END
 			}
@@ -5676,6 +6499,7 @@ static void direct_link_object(FileData *fd, Object *ob)
 
 	/* Runtime curve data  */
 	ob->curve_cache = NULL;
+	ob->modifier_cache = NULL;
 
 	/* in case this value changes in future, clamp else we get undefined behavior */
 	CLAMP(ob->rotmode, ROT_MODE_MIN, ROT_MODE_MAX);
@@ -8310,9 +9134,79 @@ static const char *dataname(short id_code)
 	
 }
 
+#ifdef USE_READ_DATA_THREADED
+typedef struct ReadDataTask {
+	FileData *fd;
+	BHead **bheads;
+	void **data;
+	const char *allocname;
+} ReadDataTask;
+
+static void read_data_task_cb(void *userdata, void *UNUSED(userdata_chunk), const int i, const int UNUSED(thread_id))
+{
+	ReadDataTask *task = userdata;
+	task->data[i] = read_struct(task->fd, task->bheads[i], task->allocname);
+}
+
+/**
+ * Threaded version of #read_data_into_oldnewmap,
+ * returns false when there is too little data, leaving \a r_bhead untouched.
+ *
+ * \note Only #read_struct runs in threads (endian switching and DNA reconstruction each work on their own block),
+ * entries are still added to the data map in file order since lookups rely on it.
+ */
+static bool read_data_into_oldnewmap_threaded(FileData *fd, BHead **r_bhead, const char *allocname)
+{
+	ReadDataTask task;
+	BHead *bhead = *r_bhead, *bhead_iter;
+	size_t data_len = 0;
+	int bheads_len = 0;
+	int i;
+
+	for (bhead_iter = bhead; bhead_iter && bhead_iter->code == DATA; bhead_iter = blo_nextbhead(fd, bhead_iter)) {
+		data_len += (size_t)bhead_iter->len;
+		bheads_len++;
+	}
+
+	if (bheads_len < 2 || data_len < READ_DATA_THREADED_MIN_LEN) {
+		return false;
+	}
+
+	task.fd = fd;
+	task.bheads = MEM_mallocN(sizeof(*task.bheads) * (size_t)bheads_len, __func__);
+	task.data = MEM_mallocN(sizeof(*task.data) * (size_t)bheads_len, __func__);
+	task.allocname = allocname;
+
+	for (i = 0; i < bheads_len; i++, bhead = blo_nextbhead(fd, bhead)) {
+		task.bheads[i] = bhead;
+	}
+
+	/* Block sizes vary a lot (a single mesh layer vs. many small structs). */
+	BLI_task_parallel_range_ex(0, bheads_len, &task, NULL, 0, read_data_task_cb, true, true);
+
+	for (i = 0; i < bheads_len; i++) {
+		if (task.data[i]) {
+			oldnewmap_insert(fd->datamap, task.bheads[i]->old, task.data[i], 0);
+		}
+	}
+
+	MEM_freeN(task.bheads);
+	MEM_freeN(task.data);
+
+	*r_bhead = bhead;
+	return true;
+}
+#endif  /* USE_READ_DATA_THREADED */
+
 static BHead *read_data_into_oldnewmap(FileData *fd, BHead *bhead, const char *allocname)
 {
 	bhead = blo_nextbhead(fd, bhead);
+
+#ifdef USE_READ_DATA_THREADED
+	if (read_data_into_oldnewmap_threaded(fd, &bhead, allocname)) {
+		return bhead;
+	}
+#endif
 	
 	while (bhead && bhead->code==DATA) {
 		void *data;
@@ -8708,8 +9602,6 @@ static void do_versions_after_linking(Main *main)
 
 static void lib_link_all(FileData *fd, Main *main)
 {
-	oldnewmap_sort(fd);
-	
 	/* No load UI for undo memfiles */
 	if (fd->memfile == NULL) {
 		lib_link_windowmanager(fd, main);
@@ -8967,17 +9859,24 @@ static void sort_bhead_old_map(FileData *fd)
 	struct BHeadSort *bhs;
 	int tot = 0;
 	
-	for (bhead = blo_firstbhead(fd); bhead; bhead = blo_nextbhead(fd, bhead))
-		tot++;
+	/* only ID's are looked up by their old address (see expand_doit_library), skip DATA blocks */
+	for (bhead = blo_firstbhead(fd); bhead; bhead = blo_nextbhead_indexed(fd, bhead)) {
+		if (bhead->code != DATA) {
+			tot++;
+		}
+	}
 	
 	fd->tot_bheadmap = tot;
 	if (tot == 0) return;
 	
 	bhs = fd->bheadmap = MEM_mallocN(tot * sizeof(struct BHeadSort), "BHeadSort");
 	
-	for (bhead = blo_firstbhead(fd); bhead; bhead = blo_nextbhead(fd, bhead), bhs++) {
-		bhs->bhead = bhead;
-		bhs->old = bhead->old;
+	for (bhead = blo_firstbhead(fd); bhead; bhead = blo_nextbhead_indexed(fd, bhead)) {
+		if (bhead->code != DATA) {
+			bhs->bhead = bhead;
+			bhs->old = bhead->old;
+			bhs++;
+		}
 	}
 	
 	qsort(fd->bheadmap, tot, sizeof(struct BHeadSort), verg_bheadsort);
@@ -10502,6 +11401,9 @@ static Main *library_link_begin(Main *mainvar, FileData **fd, const char *filepa
 	/* needed for do_version */
 	mainl->versionfile = (*fd)->fileversion;
 	read_file_version(*fd, mainl);
+#ifdef USE_BHEAD_INDEX
+	blo_bhead_index_write(*fd);
+#endif
 #ifdef USE_GHASH_BHEAD
 	read_file_bhead_idname_map_create(*fd);
 #endif
@@ -10762,6 +11664,9 @@ static void read_libraries(FileData *basefd, ListBase *mainlist)
 						
 						/* subversion */
 						read_file_version(fd, mainptr);
+#ifdef USE_BHEAD_INDEX
+						blo_bhead_index_write(fd);
+#endif
 #ifdef USE_GHASH_BHEAD
 						read_file_bhead_idname_map_create(fd);
 #endif
@@ -38,6 +38,7 @@
 #include "DNA_space_types.h"
 #include "DNA_windowmanager_types.h"  /* for ReportType */
 
+struct BlendBlockHash;
 struct OldNewMap;
 struct MemFile;
 struct ReportList;
@@ -64,6 +65,20 @@ typedef struct FileData {
 	int filedes;
 	gzFile gzfiledes;
 
+	// variables needed for reading from a memory mapped file (see: USE_BHEAD_MMAP)
+	// or from decompressed frames (see: FD_FLAGS_MMAP_IS_ALLOC)
+	char *mmap_data;
+	size_t mmap_size;
+	size_t mmap_seek;
+
+	// variables needed for reading frames on demand (see: BLEND_FRAMES_MAGIC)
+	struct BlendFrame *frames;
+	size_t *frames_offset_raw;
+	unsigned int frames_len;
+	int frame_loaded;
+	char *frame_buf;
+	size_t frames_seek;
+
 	// now only in use for library appending
 	char relabase[FILE_MAX];
 	
@@ -78,6 +93,7 @@ typedef struct FileData {
 	struct SDNA *filesdna;
 	const struct SDNA *memsdna;
 	const char *compflags;  /* array of eSDNA_StructCompare */
+	struct DNA_ReconstructInfo *reconstruct_info;  /* planned conversion of the structs that differ */
 	
 	int fileversion;
 	int id_name_offs;       /* used to retrieve ID names from (bhead+1) */
@@ -111,6 +127,11 @@ typedef struct FileData {
 
 typedef struct BHeadN {
 	struct BHeadN *next, *prev;
+	/* The block data, directly after this struct or pointing into the memory mapped file,
+	 * use #blo_bhead_data to access it. */
+	void *data;
+	/* Position of the block header in #FileData.mmap_data, only set when using the mapping. */
+	size_t offset;
 	struct BHead bhead;
 } BHeadN;
 
@@ -122,8 +143,41 @@ enum {
 	FD_FLAGS_FILE_OK               = 1 << 3,
 	FD_FLAGS_NOT_MY_BUFFER         = 1 << 4,
 	FD_FLAGS_NOT_MY_LIBMAP         = 1 << 5,  /* XXX Unused in practice (checked once but never set). */
+	FD_FLAGS_USE_MMAP              = 1 << 6,  /* Block data is referenced from #FileData.mmap_data. */
+	FD_FLAGS_MMAP_IS_ALLOC         = 1 << 7,  /* #FileData.mmap_data is allocated, not a file mapping. */
+	FD_FLAGS_BHEAD_SPARSE          = 1 << 8,  /* Only indexed blocks are read, see: USE_BHEAD_INDEX. */
 };
 
+/**
+ * Fast compressed files (see: #G_FILE_COMPRESS_FAST), the file is split into frames
+ * which are compressed independently, so they can be decompressed in parallel
+ * or looked up from their offset in the uncompressed stream:
+ *
+ * - #BLEND_FRAMES_MAGIC.
+ * - The frames, at most #BLEND_FRAMES_FRAME_SIZE bytes each once decompressed,
+ *   a frame is stored as-is when compression doesn't make it smaller (size == size_raw).
+ * - A #BlendFrame for each frame.
+ * - #BlendFramesFooter.
+ *
+ * Integers are stored little endian.
+ */
+#define BLEND_FRAMES_MAGIC "BLENDLZO"
+#define BLEND_FRAMES_MAGIC_LEN 8
+#define BLEND_FRAMES_FRAME_SIZE (1 << 20)
+
+typedef struct BlendFrame {
+	uint64_t offset;  /* in the file */
+	uint32_t size;
+	uint32_t size_raw;
+} BlendFrame;
+
+typedef struct BlendFramesFooter {
+	uint64_t index_offset;
+	uint32_t frames_len;
+	uint32_t _pad;
+	char magic[BLEND_FRAMES_MAGIC_LEN];
+} BlendFramesFooter;
+
 #define SIZEOFBLENDERHEADER 12
 
 /***/
@@ -153,6 +207,9 @@ void blo_freefiledata(FileData *fd);
 BHead *blo_firstbhead(FileData *fd);
 BHead *blo_nextbhead(FileData *fd, BHead *thisblock);
 BHead *blo_prevbhead(FileData *fd, BHead *thisblock);
+void  *blo_bhead_data(BHead *bhead);
+
+struct BlendBlockHash *blo_read_block_hashes(FileData *fd, int *r_tot);
 
 const char *bhead_id_name(const FileData *fd, const BHead *bhead);
 
@@ -40,6 +40,7 @@
 #include "DNA_listBase.h"
 
 #include "BLI_blenlib.h"
+#include "BLI_ghash.h"
 
 #include "BLO_undofile.h"
 
@@ -62,43 +63,111 @@ void BLO_memfile_free(MemFile *memfile)
 /* result is that 'first' is being freed */
 void BLO_memfile_merge(MemFile *first, MemFile *second)
 {
+	/* Chunks of 'second' don't necessarily share the buffer of the chunk at the same position in 'first',
+	 * since they're matched by ID (see #memfile_write_id_begin), look the buffers up instead. */
+	GHash *buf_map = BLI_ghash_ptr_new_ex(__func__, BLI_listbase_count(&second->chunks));
 	MemFileChunk *fc, *sc;
 	
-	fc = first->chunks.first;
-	sc = second->chunks.first;
-	while (fc || sc) {
-		if (fc && sc) {
-			if (sc->ident) {
+	for (sc = second->chunks.first; sc; sc = sc->next) {
+		if (sc->ident) {
+			void **val_p;
+			if (!BLI_ghash_ensure_p(buf_map, sc->buf, &val_p)) {
+				*val_p = sc;
+			}
+		}
+	}
+	
+	for (fc = first->chunks.first; fc; fc = fc->next) {
+		if (fc->ident == 0) {
+			sc = BLI_ghash_lookup(buf_map, fc->buf);
+			if (sc) {
+				/* 'second' takes ownership of the buffer */
 				sc->ident = 0;
 				fc->ident = 1;
 			}
 		}
-		if (fc) fc = fc->next;
-		if (sc) sc = sc->next;
 	}
 	
+	BLI_ghash_free(buf_map, NULL, NULL);
+	
 	BLO_memfile_free(first);
 }
 
-void memfile_chunk_add(MemFile *compare, MemFile *current, const char *buf, unsigned int size)
+/**
+ * Initialize writing to \a written_memfile,
+ * chunks identical to the ones of \a reference_memfile share their buffer.
+ */
+void memfile_write_init(MemFileWriteData *mem_data, MemFile *written_memfile, MemFile *reference_memfile)
 {
-	static MemFileChunk *compchunk = NULL;
-	MemFileChunk *curchunk;
-	
-	/* this function inits when compare != NULL or when current == NULL  */
-	if (compare) {
-		compchunk = compare->chunks.first;
-		return;
+	mem_data->written_memfile = written_memfile;
+	mem_data->reference_memfile = reference_memfile;
+	mem_data->reference_current_chunk = reference_memfile ? reference_memfile->chunks.first : NULL;
+	mem_data->id_key_mapping = NULL;
+	mem_data->current_id_key = 0;
+
+	if (reference_memfile) {
+		MemFileChunk *chunk;
+
+		mem_data->id_key_mapping = BLI_ghash_int_new(__func__);
+		for (chunk = reference_memfile->chunks.first; chunk; chunk = chunk->next) {
+			if (chunk->id_key != 0) {
+				void **val_p;
+				if (!BLI_ghash_ensure_p(mem_data->id_key_mapping, SET_UINT_IN_POINTER(chunk->id_key), &val_p)) {
+					*val_p = chunk;
+				}
+			}
+		}
+	}
+}
+
+void memfile_write_finalize(MemFileWriteData *mem_data)
+{
+	if (mem_data->id_key_mapping) {
+		BLI_ghash_free(mem_data->id_key_mapping, NULL, NULL);
+		mem_data->id_key_mapping = NULL;
 	}
-	if (current == NULL) {
-		compchunk = NULL;
-		return;
+}
+
+/**
+ * Following chunks belong to the ID with \a id_key,
+ * they're compared with the chunks of the same ID in the reference memfile,
+ * so the ID's that are added, removed or change size don't cause the ID's after them to be duplicated.
+ *
+ * The key only needs to be stable between undo pushes,
+ * a collision or a different ID with the same key only means the chunks don't match.
+ */
+void memfile_write_id_begin(MemFileWriteData *mem_data, const unsigned int id_key)
+{
+	mem_data->current_id_key = id_key;
+
+	if ((mem_data->id_key_mapping != NULL) &&
+	    ((mem_data->reference_current_chunk == NULL) ||
+	     (mem_data->reference_current_chunk->id_key != id_key)))
+	{
+		MemFileChunk *chunk = BLI_ghash_lookup(mem_data->id_key_mapping, SET_UINT_IN_POINTER(id_key));
+		/* otherwise it's a new ID, keep comparing with the current chunk */
+		if (chunk) {
+			mem_data->reference_current_chunk = chunk;
+		}
 	}
+}
+
+void memfile_write_id_end(MemFileWriteData *mem_data)
+{
+	mem_data->current_id_key = 0;
+}
+
+void memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, unsigned int size)
+{
+	MemFile *current = mem_data->written_memfile;
+	MemFileChunk *compchunk = mem_data->reference_current_chunk;
+	MemFileChunk *curchunk;
 	
 	curchunk = MEM_mallocN(sizeof(MemFileChunk), "MemFileChunk");
 	curchunk->size = size;
 	curchunk->buf = NULL;
 	curchunk->ident = 0;
+	curchunk->id_key = mem_data->current_id_key;
 	BLI_addtail(&current->chunks, curchunk);
 	
 	/* we compare compchunk with buf */
@@ -109,7 +178,7 @@ void memfile_chunk_add(MemFile *compare, MemFile *current, const char *buf, unsi
 				curchunk->ident = 1;
 			}
 		}
-		compchunk = compchunk->next;
+		mem_data->reference_current_chunk = compchunk->next;
 	}
 	
 	/* not equal... */
@@ -37,6 +37,7 @@
 #include "DNA_layer_types.h"
 #include "DNA_material_types.h"
 #include "DNA_mesh_types.h"
+#include "DNA_modifier_types.h"
 #include "DNA_scene_types.h"
 #include "DNA_screen_types.h"
 #include "DNA_view3d_types.h"
@@ -458,5 +459,15 @@ void blo_do_versions_280(FileData *fd, Library *UNUSED(lib), Main *main)
 				printf("You need to connect Eevee Metallic and Specular shader nodes to new material output nodes.\n");
 			}
 		}
+
+		if (!DNA_struct_elem_find(fd->filesdna, "RemeshModifierData", "float", "voxel_size")) {
+			for (Object *ob = main->object.first; ob; ob = ob->id.next) {
+				for (ModifierData *md = ob->modifiers.first; md; md = md->next) {
+					if (md->type == eModifierType_Remesh) {
+						((RemeshModifierData *)md)->voxel_size = 0.1f;
+					}
+				}
+			}
+		}
 	}
 }
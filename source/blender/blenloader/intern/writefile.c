@@ -89,6 +89,14 @@
 #include <string.h>
 #include <stdlib.h>
 
+#ifdef WITH_LZO
+#  ifdef WITH_SYSTEM_LZO
+#    include <lzo/lzo1x.h>
+#  else
+#    include "minilzo.h"
+#  endif
+#endif
+
 #ifdef WIN32
 #  include <zlib.h>  /* odd include order-issue */
 #  include "winsock2.h"
@@ -159,8 +167,12 @@
 #include "MEM_guardedalloc.h" // MEM_freeN
 #include "BLI_bitmap.h"
 #include "BLI_blenlib.h"
+#include "BLI_ghash.h"
 #include "BLI_linklist.h"
 #include "BLI_mempool.h"
+#include "BLI_task.h"
+#include "BLI_endian_switch.h"
+#include "BLI_hash_md5.h"
 
 #include "BKE_action.h"
 #include "BKE_blender_version.h"
@@ -211,6 +223,10 @@
 typedef enum {
 	WW_WRAP_NONE = 1,
 	WW_WRAP_ZLIB,
+#ifdef WITH_LZO
+	WW_WRAP_FRAMES,
+#endif
+	WW_WRAP_MEMFILE,
 } eWriteWrapType;
 
 typedef struct WriteWrap WriteWrap;
@@ -224,6 +240,8 @@ struct WriteWrap {
 	union {
 		int file_handle;
 		gzFile gz_handle;
+		struct WriteWrapFrames *frames;
+		MemFile *memfile;
 	} _user_data;
 };
 
@@ -251,7 +269,21 @@ static bool ww_close_none(WriteWrap *ww)
 }
 static size_t ww_write_none(WriteWrap *ww, const char *buf, size_t buf_len)
 {
-	return write(FILE_HANDLE(ww), buf, buf_len);
+	/* large arrays are passed in directly (see #mywrite), write() may not take them at once */
+	size_t written = 0;
+
+	while (written < buf_len) {
+		const ssize_t len = write(FILE_HANDLE(ww), buf + written, buf_len - written);
+		if (len <= 0) {
+			if (len == -1 && errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+		written += (size_t)len;
+	}
+
+	return written;
 }
 #undef FILE_HANDLE
 
@@ -283,6 +315,211 @@ static size_t ww_write_zlib(WriteWrap *ww, const char *buf, size_t buf_len)
 }
 #undef FILE_HANDLE
 
+#ifdef WITH_LZO
+/* frames (see: BLEND_FRAMES_MAGIC) */
+#define FRAMES_HANDLE(ww) \
+	(ww)->_user_data.frames
+
+#define LZO_OUT_LEN(size)     ((size) + (size) / 16 + 64 + 3)
+
+/* Number of frames compressed in parallel before they're written. */
+#define FRAMES_BATCH_LEN 16
+
+typedef struct WriteWrapFrames {
+	int file_handle;
+	uint64_t file_offset;
+
+	/* Uncompressed data for the next batch of frames. */
+	char *buf;
+	size_t buf_used;
+
+	BlendFrame *frames;
+	unsigned int frames_len, frames_alloc;
+} WriteWrapFrames;
+
+typedef struct FramesCompressTask {
+	const char *buf;
+	size_t buf_len;
+	/* LZO_OUT_LEN(BLEND_FRAMES_FRAME_SIZE) for each frame. */
+	char *buf_out;
+	BlendFrame *frames;
+} FramesCompressTask;
+
+static void frames_compress_task_cb(void *userdata, void *UNUSED(userdata_chunk), const int i, const int UNUSED(thread_id))
+{
+	FramesCompressTask *task = userdata;
+	const size_t offset = (size_t)i * BLEND_FRAMES_FRAME_SIZE;
+	const lzo_uint in_len = (lzo_uint)MIN2(task->buf_len - offset, BLEND_FRAMES_FRAME_SIZE);
+	lzo_uint out_len = LZO_OUT_LEN(BLEND_FRAMES_FRAME_SIZE);
+	char *out = task->buf_out + (size_t)i * LZO_OUT_LEN(BLEND_FRAMES_FRAME_SIZE);
+	void *wrkmem = MEM_mallocN(LZO1X_1_MEM_COMPRESS, __func__);
+	BlendFrame *frame = &task->frames[i];
+
+	frame->size_raw = (uint32_t)in_len;
+
+	if ((lzo1x_1_compress(
+	         (const unsigned char *)task->buf + offset, in_len, (unsigned char *)out, &out_len, wrkmem) == LZO_E_OK) &&
+	    (out_len < in_len))
+	{
+		frame->size = (uint32_t)out_len;
+	}
+	else {
+		/* store as-is, the reader detects this by the sizes matching */
+		memcpy(out, task->buf + offset, in_len);
+		frame->size = (uint32_t)in_len;
+	}
+
+	MEM_freeN(wrkmem);
+}
+
+static bool ww_write_frames_raw(WriteWrapFrames *wwf, const void *buf, size_t buf_len)
+{
+	if ((size_t)write(wwf->file_handle, buf, buf_len) != buf_len) {
+		return false;
+	}
+	wwf->file_offset += buf_len;
+	return true;
+}
+
+/* Compress the pending frames in parallel and write them in order. */
+static bool ww_frames_flush(WriteWrapFrames *wwf)
+{
+	FramesCompressTask task;
+	const unsigned int frames_len = (unsigned int)((wwf->buf_used + BLEND_FRAMES_FRAME_SIZE - 1) / BLEND_FRAMES_FRAME_SIZE);
+	bool ok = true;
+	unsigned int i;
+
+	if (frames_len == 0) {
+		return true;
+	}
+
+	if (wwf->frames_len + frames_len > wwf->frames_alloc) {
+		wwf->frames_alloc = (wwf->frames_len + frames_len) * 2;
+		wwf->frames = MEM_reallocN(wwf->frames, sizeof(*wwf->frames) * wwf->frames_alloc);
+	}
+
+	task.buf = wwf->buf;
+	task.buf_len = wwf->buf_used;
+	task.buf_out = MEM_mallocN((size_t)frames_len * LZO_OUT_LEN(BLEND_FRAMES_FRAME_SIZE), __func__);
+	task.frames = &wwf->frames[wwf->frames_len];
+
+	BLI_task_parallel_range_ex(0, (int)frames_len, &task, NULL, 0, frames_compress_task_cb, frames_len > 1, false);
+
+	for (i = 0; i < frames_len && ok; i++) {
+		BlendFrame *frame = &task.frames[i];
+		frame->offset = wwf->file_offset;
+		ok = ww_write_frames_raw(wwf, task.buf_out + (size_t)i * LZO_OUT_LEN(BLEND_FRAMES_FRAME_SIZE), frame->size);
+	}
+
+	MEM_freeN(task.buf_out);
+
+	wwf->frames_len += frames_len;
+	wwf->buf_used = 0;
+
+	return ok;
+}
+
+static bool ww_open_frames(WriteWrap *ww, const char *filepath)
+{
+	WriteWrapFrames *wwf;
+	int file;
+
+	file = BLI_open(filepath, O_BINARY + O_WRONLY + O_CREAT + O_TRUNC, 0666);
+
+	if (file == -1) {
+		return false;
+	}
+
+	wwf = MEM_callocN(sizeof(*wwf), __func__);
+	wwf->file_handle = file;
+	wwf->buf = MEM_mallocN(BLEND_FRAMES_FRAME_SIZE * FRAMES_BATCH_LEN, __func__);
+	FRAMES_HANDLE(ww) = wwf;
+
+	return ww_write_frames_raw(wwf, BLEND_FRAMES_MAGIC, BLEND_FRAMES_MAGIC_LEN);
+}
+static bool ww_close_frames(WriteWrap *ww)
+{
+	WriteWrapFrames *wwf = FRAMES_HANDLE(ww);
+	BlendFramesFooter footer = {0};
+	bool ok = ww_frames_flush(wwf);
+
+	footer.index_offset = wwf->file_offset;
+	footer.frames_len = wwf->frames_len;
+	memcpy(footer.magic, BLEND_FRAMES_MAGIC, BLEND_FRAMES_MAGIC_LEN);
+
+	if (ENDIAN_ORDER == B_ENDIAN) {
+		unsigned int i;
+		for (i = 0; i < wwf->frames_len; i++) {
+			BLI_endian_switch_uint64(&wwf->frames[i].offset);
+			BLI_endian_switch_uint32(&wwf->frames[i].size);
+			BLI_endian_switch_uint32(&wwf->frames[i].size_raw);
+		}
+		BLI_endian_switch_uint64(&footer.index_offset);
+		BLI_endian_switch_uint32(&footer.frames_len);
+	}
+
+	ok = ok &&
+	     ww_write_frames_raw(wwf, wwf->frames, sizeof(*wwf->frames) * wwf->frames_len) &&
+	     ww_write_frames_raw(wwf, &footer, sizeof(footer));
+
+	if (close(wwf->file_handle) == -1) {
+		ok = false;
+	}
+
+	MEM_SAFE_FREE(wwf->frames);
+	MEM_freeN(wwf->buf);
+	MEM_freeN(wwf);
+
+	return ok;
+}
+static size_t ww_write_frames(WriteWrap *ww, const char *buf, size_t buf_len)
+{
+	WriteWrapFrames *wwf = FRAMES_HANDLE(ww);
+	const size_t batch_size = BLEND_FRAMES_FRAME_SIZE * FRAMES_BATCH_LEN;
+	size_t buf_done = 0;
+
+	while (buf_done < buf_len) {
+		const size_t len = MIN2(buf_len - buf_done, batch_size - wwf->buf_used);
+		memcpy(wwf->buf + wwf->buf_used, buf + buf_done, len);
+		wwf->buf_used += len;
+		buf_done += len;
+
+		if (wwf->buf_used == batch_size) {
+			if (!ww_frames_flush(wwf)) {
+				return 0;
+			}
+		}
+	}
+
+	return buf_len;
+}
+#undef FRAMES_BATCH_LEN
+#undef LZO_OUT_LEN
+#undef FRAMES_HANDLE
+#endif  /* WITH_LZO */
+
+/* memfile (in memory, for writing from a thread later on) */
+#define MEMFILE_HANDLE(ww) \
+	(ww)->_user_data.memfile
+
+static bool ww_open_memfile(WriteWrap *UNUSED(ww), const char *UNUSED(filepath))
+{
+	return true;
+}
+static bool ww_close_memfile(WriteWrap *UNUSED(ww))
+{
+	return true;
+}
+static size_t ww_write_memfile(WriteWrap *ww, const char *buf, size_t buf_len)
+{
+	/* no reference memfile, chunks are only added */
+	MemFileWriteData mem_data;
+	memfile_write_init(&mem_data, MEMFILE_HANDLE(ww), NULL);
+	memfile_chunk_add(&mem_data, buf, (unsigned int)buf_len);
+	memfile_write_finalize(&mem_data);
+	return buf_len;
+}
+
 /* --- end compression types --- */
 
 static void ww_handle_init(eWriteWrapType ww_type, WriteWrap *r_ww)
@@ -297,6 +534,22 @@ static void ww_handle_init(eWriteWrapType ww_type, WriteWrap *r_ww)
 			r_ww->write = ww_write_zlib;
 			break;
 		}
+#ifdef WITH_LZO
+		case WW_WRAP_FRAMES:
+		{
+			r_ww->open  = ww_open_frames;
+			r_ww->close = ww_close_frames;
+			r_ww->write = ww_write_frames;
+			break;
+		}
+#endif
+		case WW_WRAP_MEMFILE:
+		{
+			r_ww->open  = ww_open_memfile;
+			r_ww->close = ww_close_memfile;
+			r_ww->write = ww_write_memfile;
+			break;
+		}
 		default:
 		{
 			r_ww->open  = ww_open_none;
@@ -315,7 +568,9 @@ typedef struct {
 	const struct SDNA *sdna;
 
 	unsigned char *buf;
-	MemFile *compare, *current;
+	/* Set for undo, chunks are written to the memfile through 'mem'. */
+	MemFile *current;
+	MemFileWriteData mem;
 
 	int tot, count;
 	bool error;
@@ -325,6 +580,13 @@ typedef struct {
 	 * Will be NULL for UNDO. */
 	WriteWrap *ww;
 
+	/* Content hash of every block written, see #G_FILE_BLOCK_HASH. */
+	struct {
+		bool use;
+		BlendBlockHash *table;
+		int len, len_alloc;
+	} block_hash;
+
 #ifdef USE_BMESH_SAVE_AS_COMPAT
 	bool use_mesh_compat; /* option to save with older mesh format */
 #endif
@@ -355,7 +617,7 @@ static void writedata_do_write(WriteData *wd, const void *mem, int memlen)
 
 	/* memory based save */
 	if (wd->current) {
-		memfile_chunk_add(NULL, wd->current, mem, memlen);
+		memfile_chunk_add(&wd->mem, mem, memlen);
 	}
 	else {
 		if (wd->ww->write(wd->ww, mem, memlen) != memlen) {
@@ -366,6 +628,7 @@ static void writedata_do_write(WriteData *wd, const void *mem, int memlen)
 
 static void writedata_free(WriteData *wd)
 {
+	MEM_SAFE_FREE(wd->block_hash.table);
 	MEM_freeN(wd->buf);
 	MEM_freeN(wd);
 }
@@ -411,6 +674,13 @@ static void mywrite(WriteData *wd, const void *adr, int len)
 			wd->count = 0;
 		}
 
+		/* Only undo needs the pieces to de-duplicate memory,
+		 * files get the data directly without copying it or splitting it into many writes. */
+		if (wd->current == NULL) {
+			writedata_do_write(wd, adr, len);
+			return;
+		}
+
 		do {
 			int writelen = MIN2(len, MYWRITE_MAX_CHUNK);
 			writedata_do_write(wd, adr, writelen);
@@ -432,6 +702,26 @@ static void mywrite(WriteData *wd, const void *adr, int len)
 	wd->count += len;
 }
 
+/**
+ * Start writing an ID, for undo the ID is written to its own chunks
+ * so they can be compared with the chunks of the same ID in the previous undo step.
+ */
+static void mywrite_id_begin(WriteData *wd, ID *id)
+{
+	if (wd->current) {
+		mywrite_flush(wd);
+		memfile_write_id_begin(&wd->mem, BLI_ghashutil_strhash_p(id->name));
+	}
+}
+
+static void mywrite_id_end(WriteData *wd, ID *UNUSED(id))
+{
+	if (wd->current) {
+		mywrite_flush(wd);
+		memfile_write_id_end(&wd->mem);
+	}
+}
+
 /**
  * BeGiN initializer for mywrite
  * \param ww: File write wrapper.
@@ -447,10 +737,10 @@ static WriteData *bgnwrite(WriteWrap *ww, MemFile *compare, MemFile *current)
 		return NULL;
 	}
 
-	wd->compare = compare;
 	wd->current = current;
-	/* this inits comparing */
-	memfile_chunk_add(compare, NULL, NULL, 0);
+	if (current) {
+		memfile_write_init(&wd->mem, current, compare);
+	}
 
 	return wd;
 }
@@ -468,6 +758,10 @@ static bool endwrite(WriteData *wd)
 		wd->count = 0;
 	}
 
+	if (wd->current) {
+		memfile_write_finalize(&wd->mem);
+	}
+
 	const bool err = wd->error;
 	writedata_free(wd);
 
@@ -476,6 +770,59 @@ static bool endwrite(WriteData *wd)
 
 /* ********** WRITE FILE ****************** */
 
+/** \name Block Hashes
+ *
+ * Optional table with an MD5 of the data of every block, written after #ENDB as a #HASH block.
+ * This lets tools compare files (or versions of a library) block by block without parsing them.
+ *
+ * \note Blocks containing pointers hash differently between sessions,
+ * since the pointers are written as-is.
+ * \{ */
+
+static void writedata_block_hash_add(WriteData *wd, const BHead *bh, const void *data)
+{
+	BlendBlockHash *bbh;
+
+	if (wd->block_hash.len == wd->block_hash.len_alloc) {
+		wd->block_hash.len_alloc = wd->block_hash.len_alloc ? (wd->block_hash.len_alloc * 2) : 1024;
+		wd->block_hash.table = MEM_reallocN(
+		        wd->block_hash.table, sizeof(*wd->block_hash.table) * (size_t)wd->block_hash.len_alloc);
+	}
+
+	bbh = &wd->block_hash.table[wd->block_hash.len++];
+	/* The header is written next, so the current size is its offset. */
+	bbh->offset = (uint64_t)(unsigned int)wd->tot;
+	bbh->old = (uint64_t)(uintptr_t)bh->old;
+	bbh->code = bh->code;
+	bbh->len = bh->len;
+	bbh->SDNAnr = bh->SDNAnr;
+	bbh->nr = bh->nr;
+	BLI_hash_md5_buffer(data, (size_t)bh->len, bbh->digest);
+}
+
+/**
+ * Write the table after #ENDB, readers that don't know about it stop before reaching it.
+ */
+static void writedata_block_hash_write(WriteData *wd)
+{
+	BHead bh = {0};
+
+	bh.code = HASH;
+	bh.len = (int)sizeof(*wd->block_hash.table) * wd->block_hash.len;
+	bh.nr = wd->block_hash.len;
+
+	mywrite(wd, &bh, sizeof(BHead));
+	if (bh.len) {
+		mywrite(wd, wd->block_hash.table, bh.len);
+	}
+
+	MEM_SAFE_FREE(wd->block_hash.table);
+	wd->block_hash.len = wd->block_hash.len_alloc = 0;
+	wd->block_hash.use = false;
+}
+
+/** \} */
+
 static void writestruct_at_address_nr(
         WriteData *wd, int filecode, const int struct_nr, int nr,
         const void *adr, const void *data)
@@ -503,6 +850,10 @@ static void writestruct_at_address_nr(
 		return;
 	}
 
+	if (wd->block_hash.use) {
+		writedata_block_hash_add(wd, &bh, data);
+	}
+
 	mywrite(wd, &bh, sizeof(BHead));
 	mywrite(wd, data, bh.len);
 }
@@ -556,6 +907,10 @@ static void writedata(WriteData *wd, int filecode, int len, const void *adr)  /*
 	bh.SDNAnr = 0;
 	bh.len    = len;
 
+	if (wd->block_hash.use) {
+		writedata_block_hash_add(wd, &bh, adr);
+	}
+
 	mywrite(wd, &bh, sizeof(BHead));
 	mywrite(wd, adr, len);
 }
@@ -3913,6 +4268,9 @@ static bool write_file_handle(
 	wd->use_mesh_compat = (write_flags & G_FILE_MESH_COMPAT) != 0;
 #endif
 
+	/* Hashes are only useful for files on disk. */
+	wd->block_hash.use = (current == NULL) && (write_flags & G_FILE_BLOCK_HASH);
+
 #ifdef USE_NODE_COMPAT_CUSTOMNODES
 	/* don't write compatibility data on undo */
 	if (!current) {
@@ -3946,6 +4304,8 @@ static bool write_file_handle(
 		}
 
 		for (; id; id = id->next) {
+			mywrite_id_begin(wd, id);
+
 			switch ((ID_Type)GS(id->name)) {
 				case ID_WM:
 					write_windowmanager(wd, (wmWindowManager *)id);
@@ -4061,6 +4421,8 @@ static bool write_file_handle(
 					BLI_assert(0);
 					break;
 			}
+
+			mywrite_id_end(wd, id);
 		}
 
 		mywrite_flush(wd);
@@ -4098,6 +4460,10 @@ static bool write_file_handle(
 	bhead.code = ENDB;
 	mywrite(wd, &bhead, sizeof(BHead));
 
+	if (wd->block_hash.use) {
+		writedata_block_hash_write(wd);
+	}
+
 	blo_join_main(&mainlist);
 
 	return endwrite(wd);
@@ -4145,37 +4511,27 @@ static bool do_history(const char *name, ReportList *reports)
 	return 0;
 }
 
+static eWriteWrapType write_file_wrap_type(const int write_flags)
+{
+	if (write_flags & G_FILE_COMPRESS) {
+#ifdef WITH_LZO
+		return (write_flags & G_FILE_COMPRESS_FAST) ? WW_WRAP_FRAMES : WW_WRAP_ZLIB;
+#else
+		return WW_WRAP_ZLIB;
+#endif
+	}
+	return WW_WRAP_NONE;
+}
+
 /**
- * \return Success.
+ * Remap paths relative to \a filepath (when #G_FILE_RELATIVE_REMAP is set),
+ * \return A backup of the paths to restore with #write_file_paths_restore (or NULL).
  */
-bool BLO_write_file(
-        Main *mainvar, const char *filepath, int write_flags,
-        ReportList *reports, const BlendThumbnail *thumb)
+static void *write_file_paths_remap(Main *mainvar, const char *filepath, int *r_write_flags)
 {
-	char tempname[FILE_MAX + 1];
-	eWriteWrapType ww_type;
-	WriteWrap ww;
-
-	/* path backup/restore */
 	void     *path_list_backup = NULL;
 	const int path_list_flag = (BKE_BPATH_TRAVERSE_SKIP_LIBRARY | BKE_BPATH_TRAVERSE_SKIP_MULTIFILE);
-
-	/* open temporary file, so we preserve the original in case we crash */
-	BLI_snprintf(tempname, sizeof(tempname), "%s@", filepath);
-
-	if (write_flags & G_FILE_COMPRESS) {
-		ww_type = WW_WRAP_ZLIB;
-	}
-	else {
-		ww_type = WW_WRAP_NONE;
-	}
-
-	ww_handle_init(ww_type, &ww);
-
-	if (ww.open(&ww, tempname) == false) {
-		BKE_reportf(reports, RPT_ERROR, "Cannot open file %s for writing: %s", tempname, strerror(errno));
-		return 0;
-	}
+	int write_flags = *r_write_flags;
 
 	/* check if we need to backup and restore paths */
 	if (UNLIKELY((write_flags & G_FILE_RELATIVE_REMAP) && (G_FILE_SAVE_COPY & write_flags))) {
@@ -4212,23 +4568,25 @@ bool BLO_write_file(
 		BKE_bpath_relative_convert(mainvar, filepath, NULL);
 	}
 
-	/* actual file writing */
-	const bool err = write_file_handle(mainvar, &ww, NULL, NULL, write_flags, thumb);
+	*r_write_flags = write_flags;
+	return path_list_backup;
+}
 
-	ww.close(&ww);
+static void write_file_paths_restore(Main *mainvar, void *path_list_backup)
+{
+	const int path_list_flag = (BKE_BPATH_TRAVERSE_SKIP_LIBRARY | BKE_BPATH_TRAVERSE_SKIP_MULTIFILE);
 
 	if (UNLIKELY(path_list_backup)) {
 		BKE_bpath_list_restore(mainvar, path_list_flag, path_list_backup);
 		BKE_bpath_list_free(path_list_backup);
 	}
+}
 
-	if (err) {
-		BKE_report(reports, RPT_ERROR, strerror(errno));
-		remove(tempname);
-
-		return 0;
-	}
-
+/**
+ * Move the temporary file written for \a filepath in place, making version backups first.
+ */
+static bool write_file_finish(const char *tempname, const char *filepath, const int write_flags, ReportList *reports)
+{
 	/* file save to temporary file was successful */
 	/* now do reverse file history (move .blend1 -> .blend2, .blend -> .blend1) */
 	if (write_flags & G_FILE_HISTORY) {
@@ -4247,6 +4605,110 @@ bool BLO_write_file(
 	return 1;
 }
 
+/**
+ * \return Success.
+ */
+bool BLO_write_file(
+        Main *mainvar, const char *filepath, int write_flags,
+        ReportList *reports, const BlendThumbnail *thumb)
+{
+	char tempname[FILE_MAX + 1];
+	WriteWrap ww;
+
+	/* path backup/restore */
+	void *path_list_backup;
+
+	/* open temporary file, so we preserve the original in case we crash */
+	BLI_snprintf(tempname, sizeof(tempname), "%s@", filepath);
+
+	ww_handle_init(write_file_wrap_type(write_flags), &ww);
+
+	if (ww.open(&ww, tempname) == false) {
+		BKE_reportf(reports, RPT_ERROR, "Cannot open file %s for writing: %s", tempname, strerror(errno));
+		return 0;
+	}
+
+	path_list_backup = write_file_paths_remap(mainvar, filepath, &write_flags);
+
+	/* actual file writing */
+	const bool err = write_file_handle(mainvar, &ww, NULL, NULL, write_flags, thumb);
+
+	ww.close(&ww);
+
+	write_file_paths_restore(mainvar, path_list_backup);
+
+	if (err) {
+		BKE_report(reports, RPT_ERROR, strerror(errno));
+		remove(tempname);
+
+		return 0;
+	}
+
+	return write_file_finish(tempname, filepath, write_flags, reports);
+}
+
+/**
+ * Write \a mainvar into \a memfile, the same data as #BLO_write_file would write to \a filepath
+ * (not undo data), #BLO_memfile_write_file can then write it to disk from another thread.
+ *
+ * \return Success.
+ */
+bool BLO_write_file_to_memfile(
+        Main *mainvar, const char *filepath, int write_flags,
+        MemFile *memfile, const BlendThumbnail *thumb)
+{
+	WriteWrap ww;
+	void *path_list_backup;
+
+	ww_handle_init(WW_WRAP_MEMFILE, &ww);
+	MEMFILE_HANDLE(&ww) = memfile;
+
+	path_list_backup = write_file_paths_remap(mainvar, filepath, &write_flags);
+
+	const bool err = write_file_handle(mainvar, &ww, NULL, NULL, write_flags, thumb);
+
+	write_file_paths_restore(mainvar, path_list_backup);
+
+	return (err == 0);
+}
+
+/**
+ * Write a \a memfile created by #BLO_write_file_to_memfile to disk,
+ * compressed according to \a write_flags, making version backups (#G_FILE_HISTORY).
+ *
+ * \note Doesn't access any Blender data, so it's safe to use from a job.
+ * \return Success.
+ */
+bool BLO_memfile_write_file(MemFile *memfile, const char *filepath, int write_flags, ReportList *reports)
+{
+	char tempname[FILE_MAX + 1];
+	WriteWrap ww;
+	MemFileChunk *chunk;
+	bool err = false;
+
+	BLI_snprintf(tempname, sizeof(tempname), "%s@", filepath);
+
+	ww_handle_init(write_file_wrap_type(write_flags), &ww);
+
+	if (ww.open(&ww, tempname) == false) {
+		BKE_reportf(reports, RPT_ERROR, "Cannot open file %s for writing: %s", tempname, strerror(errno));
+		return 0;
+	}
+
+	for (chunk = memfile->chunks.first; chunk && !err; chunk = chunk->next) {
+		err = (ww.write(&ww, (const char *)chunk->buf, chunk->size) != chunk->size);
+	}
+
+	if ((ww.close(&ww) == false) || err) {
+		BKE_report(reports, RPT_ERROR, strerror(errno));
+		remove(tempname);
+
+		return 0;
+	}
+
+	return write_file_finish(tempname, filepath, write_flags, reports);
+}
+
 /**
  * \return Success.
  */
@@ -35,6 +35,7 @@
 #include "BLI_listbase.h"
 #include "BLI_math.h"
 #include "BLI_stack.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_cdderivedmesh.h"
@@ -408,56 +409,158 @@ static void bm_mesh_verts_calc_normals(
 	}
 }
 
+typedef struct BMNormalsUpdateData {
+	BMesh *bm;
+	float (*edgevec)[3];
+} BMNormalsUpdateData;
+
+static void bm_mesh_normals_update_faces_task(void *userdata, const int index)
+{
+	const BMNormalsUpdateData *data = userdata;
+
+	BM_face_normal_update(data->bm->ftable[index]);
+}
+
+static void bm_mesh_normals_update_edges_task(void *userdata, const int index)
+{
+	const BMNormalsUpdateData *data = userdata;
+	const BMEdge *e = data->bm->etable[index];
+
+	/* the edge vector will not be needed when the edge has no radial */
+	if (e->l) {
+		sub_v3_v3v3(data->edgevec[index], e->v2->co, e->v1->co);
+		normalize_v3(data->edgevec[index]);
+	}
+}
+
+/* Gathers the weighted face normals around each vertex, so vertices can be done in parallel. */
+static void bm_mesh_normals_update_verts_task(void *userdata, const int index)
+{
+	const BMNormalsUpdateData *data = userdata;
+	const float (*edgevec)[3] = (const float (*)[3])data->edgevec;
+	BMVert *v = data->bm->vtable[index];
+
+	zero_v3(v->no);
+
+	if (v->e) {
+		const BMEdge *e_iter = v->e;
+		do {
+			if (e_iter->l) {
+				const BMLoop *l_iter = e_iter->l;
+				do {
+					if (l_iter->v == v) {
+						/* calculate the dot product of the two edges that
+						 * meet at the loop's vertex */
+						const float *e1diff = edgevec[BM_elem_index_get(l_iter->prev->e)];
+						const float *e2diff = edgevec[BM_elem_index_get(l_iter->e)];
+						float dotprod = dot_v3v3(e1diff, e2diff);
+
+						/* edge vectors are calculated from e->v1 to e->v2, so
+						 * adjust the dot product if one but not both loops
+						 * actually runs from from e->v2 to e->v1 */
+						if ((l_iter->prev->e->v1 == l_iter->prev->v) ^ (l_iter->e->v1 == l_iter->v)) {
+							dotprod = -dotprod;
+						}
+
+						/* accumulate weighted face normal into the vertex's normal */
+						madd_v3_v3fl(v->no, l_iter->f->no, saacos(-dotprod));
+					}
+				} while ((l_iter = l_iter->radial_next) != e_iter->l);
+			}
+		} while ((e_iter = BM_DISK_EDGE_NEXT(e_iter, v)) != v->e);
+	}
+
+	if (UNLIKELY(normalize_v3(v->no) == 0.0f)) {
+		normalize_v3_v3(v->no, v->co);
+	}
+}
+
 /**
  * \brief BMesh Compute Normals
  *
  * Updates the normals of a mesh.
+ *
+ * Runs over the element tables in parallel: face normals and edge vectors first,
+ * then every vertex gathers the normals of the faces around it.
  */
 void BM_mesh_normals_update(BMesh *bm)
 {
-	float (*edgevec)[3] = MEM_mallocN(sizeof(*edgevec) * bm->totedge, __func__);
+	BMNormalsUpdateData data;
 
-#pragma omp parallel sections if (bm->totvert + bm->totedge + bm->totface >= BM_OMP_LIMIT)
-	{
-#pragma omp section
-		{
-			/* calculate all face normals */
-			BMIter fiter;
-			BMFace *f;
-			int i;
-
-			BM_ITER_MESH_INDEX (f, &fiter, bm, BM_FACES_OF_MESH, i) {
-				BM_elem_index_set(f, i); /* set_inline */
-				BM_face_normal_update(f);
+	BM_mesh_elem_index_ensure(bm, BM_VERT | BM_EDGE | BM_FACE);
+	BM_mesh_elem_table_ensure(bm, BM_VERT | BM_EDGE | BM_FACE);
+
+	data.bm = bm;
+	data.edgevec = MEM_mallocN(sizeof(*data.edgevec) * bm->totedge, __func__);
+
+	BLI_task_parallel_range(0, bm->totface, &data, bm_mesh_normals_update_faces_task, bm->totface >= BM_OMP_LIMIT);
+
+	/* Compute normalized direction vectors for each edge.
+	 * Directions will be used for calculating the weights of the face normals on the vertex normals.
+	 */
+	BLI_task_parallel_range(0, bm->totedge, &data, bm_mesh_normals_update_edges_task, bm->totedge >= BM_OMP_LIMIT);
+
+	/* Add weighted face normals to vertices, and normalize vert normals. */
+	BLI_task_parallel_range(0, bm->totvert, &data, bm_mesh_normals_update_verts_task, bm->totvert >= BM_OMP_LIMIT);
+
+	MEM_freeN(data.edgevec);
+}
+
+/**
+ * \brief BMesh Compute Normals of Tagged Vertices
+ *
+ * Updates the normals of faces using vertices with \a hflag set, and the vertex normals of those faces.
+ * The rest of the mesh is left untouched, so this is much faster than #BM_mesh_normals_update
+ * when only a small part of a large mesh moved.
+ */
+void BM_mesh_normals_update_tagged(BMesh *bm, const char hflag)
+{
+	BMIter viter, fiter;
+	BMVert *v;
+	BMFace *f;
+	BMLoop *l_iter, *l_first;
+
+	BLI_LINKSTACK_DECLARE(faces, BMFace *);
+	BLI_LINKSTACK_DECLARE(verts, BMVert *);
+
+	BLI_LINKSTACK_INIT(faces);
+	BLI_LINKSTACK_INIT(verts);
+
+	/* update the normals of all faces using a tagged vertex first,
+	 * the vertex normals depend on them */
+	BM_ITER_MESH (v, &viter, bm, BM_VERTS_OF_MESH) {
+		if (BM_elem_flag_test(v, hflag)) {
+			BM_ITER_ELEM (f, &fiter, v, BM_FACES_OF_VERT) {
+				if (!BM_ELEM_API_FLAG_TEST(f, _FLAG_WALK)) {
+					BM_ELEM_API_FLAG_ENABLE(f, _FLAG_WALK);
+					BM_face_normal_update(f);
+					BLI_LINKSTACK_PUSH(faces, f);
+				}
 			}
-			bm->elem_index_dirty &= ~BM_FACE;
 		}
-#pragma omp section
-		{
-			/* Zero out vertex normals */
-			BMIter viter;
-			BMVert *v;
-			int i;
-
-			BM_ITER_MESH_INDEX (v, &viter, bm, BM_VERTS_OF_MESH, i) {
-				BM_elem_index_set(v, i); /* set_inline */
-				zero_v3(v->no);
+	}
+
+	/* faces of these vertices which aren't in the stack didn't move, their normals are still valid */
+	while ((f = BLI_LINKSTACK_POP(faces))) {
+		BM_ELEM_API_FLAG_DISABLE(f, _FLAG_WALK);
+
+		l_iter = l_first = BM_FACE_FIRST_LOOP(f);
+		do {
+			v = l_iter->v;
+			if (!BM_ELEM_API_FLAG_TEST(v, _FLAG_WALK)) {
+				BM_ELEM_API_FLAG_ENABLE(v, _FLAG_WALK);
+				BM_vert_normal_update(v);
+				BLI_LINKSTACK_PUSH(verts, v);
 			}
-			bm->elem_index_dirty &= ~BM_VERT;
-		}
-#pragma omp section
-		{
-			/* Compute normalized direction vectors for each edge.
-			 * Directions will be used for calculating the weights of the face normals on the vertex normals.
-			 */
-			bm_mesh_edges_calc_vectors(bm, edgevec, NULL);
-		}
+		} while ((l_iter = l_iter->next) != l_first);
 	}
-	/* end omp */
 
-	/* Add weighted face normals to vertices, and normalize vert normals. */
-	bm_mesh_verts_calc_normals(bm, (const float(*)[3])edgevec, NULL, NULL, NULL);
-	MEM_freeN(edgevec);
+	while ((v = BLI_LINKSTACK_POP(verts))) {
+		BM_ELEM_API_FLAG_DISABLE(v, _FLAG_WALK);
+	}
+
+	BLI_LINKSTACK_FREE(faces);
+	BLI_LINKSTACK_FREE(verts);
 }
 
 /**
@@ -30,6 +30,7 @@
 
 #include "BLI_math.h"
 #include "BLI_alloca.h"
+#include "BLI_kdtree.h"
 #include "BLI_stackdefines.h"
 #include "BLI_stack.h"
 
@@ -580,18 +581,100 @@ void bmo_collapse_uvs_exec(BMesh *bm, BMOperator *op)
 
 }
 
+/* Vertices within the merge distance of a vertex, later in the sorted order. */
+typedef struct FindDoublesData {
+	int *doubles_len;
+	int *doubles_offset;
+	int *doubles;
+} FindDoublesData;
+
+static bool bmesh_find_doubles_count_cb(
+        void *user_data, int co_index, int index, const float UNUSED(co[3]), float UNUSED(dist_sq))
+{
+	FindDoublesData *data = user_data;
+
+	/* only the thread searching 'co_index' writes to it */
+	if (index > co_index) {
+		data->doubles_len[co_index]++;
+	}
+	return true;
+}
+
+static bool bmesh_find_doubles_fill_cb(
+        void *user_data, int co_index, int index, const float UNUSED(co[3]), float UNUSED(dist_sq))
+{
+	FindDoublesData *data = user_data;
+
+	if (index > co_index) {
+		data->doubles[data->doubles_offset[co_index] + data->doubles_len[co_index]++] = index;
+	}
+	return true;
+}
+
+static int cmp_int(const void *a, const void *b)
+{
+	const int i1 = *(const int *)a, i2 = *(const int *)b;
+
+	if      (i1 > i2) return  1;
+	else if (i1 < i2) return -1;
+	else return 0;
+}
+
+/**
+ * Finds the vertices within \a dist of every vertex later in \a verts order,
+ * using a KD-tree searched in parallel, instead of comparing against the following vertices until they're
+ * too far apart in the sorted order, which is quadratic when many vertices have similar sort values.
+ */
+static void bmesh_find_doubles_search(BMVert **verts, const int verts_len, const float dist, FindDoublesData *data)
+{
+	KDTree *tree = BLI_kdtree_new((unsigned int)verts_len);
+	float (*cos)[3] = MEM_mallocN(sizeof(*cos) * (size_t)verts_len, __func__);
+	int i, doubles_tot = 0;
+
+	for (i = 0; i < verts_len; i++) {
+		copy_v3_v3(cos[i], verts[i]->co);
+		BLI_kdtree_insert(tree, i, cos[i]);
+	}
+	BLI_kdtree_balance(tree);
+
+	data->doubles_len = MEM_callocN(sizeof(*data->doubles_len) * (size_t)verts_len, __func__);
+	data->doubles_offset = MEM_mallocN(sizeof(*data->doubles_offset) * (size_t)verts_len, __func__);
+
+	BLI_kdtree_range_search_array_cb(tree, (const float (*)[3])cos, verts_len, dist, bmesh_find_doubles_count_cb, data);
+
+	for (i = 0; i < verts_len; i++) {
+		data->doubles_offset[i] = doubles_tot;
+		doubles_tot += data->doubles_len[i];
+		data->doubles_len[i] = 0;
+	}
+
+	data->doubles = MEM_mallocN(sizeof(*data->doubles) * (size_t)max_ii(doubles_tot, 1), __func__);
+
+	BLI_kdtree_range_search_array_cb(tree, (const float (*)[3])cos, verts_len, dist, bmesh_find_doubles_fill_cb, data);
+
+	/* match the order of the sorted vertices */
+	for (i = 0; i < verts_len; i++) {
+		if (data->doubles_len[i] > 1) {
+			qsort(&data->doubles[data->doubles_offset[i]], (size_t)data->doubles_len[i], sizeof(int), cmp_int);
+		}
+	}
+
+	MEM_freeN(cos);
+	BLI_kdtree_free(tree);
+}
+
 static void bmesh_find_doubles_common(
         BMesh *bm, BMOperator *op,
         BMOperator *optarget, BMOpSlot *optarget_slot)
 {
 	BMVert  **verts;
 	int       verts_len;
+	FindDoublesData data;
 
 	int i, j, keepvert = 0;
 
 	const float dist  = BMO_slot_float_get(op->slots_in, "dist");
 	const float dist_sq = dist * dist;
-	const float dist3 = ((float)M_SQRT3 + 0.00005f) * dist;   /* Just above sqrt(3) */
 
 	/* Test whether keep_verts arg exists and is non-empty */
 	if (BMO_slot_exists(op->slots_in, "keep_verts")) {
@@ -610,50 +693,50 @@ static void bmesh_find_doubles_common(
 		BMO_slot_buffer_flag_enable(bm, op->slots_in, "keep_verts", BM_VERT, VERT_KEEP);
 	}
 
+	/* the distance queries run in parallel, picking the targets below depends on the order */
+	bmesh_find_doubles_search(verts, verts_len, dist, &data);
+
 	for (i = 0; i < verts_len; i++) {
 		BMVert *v_check = verts[i];
+		const int *doubles = &data.doubles[data.doubles_offset[i]];
 
 		if (BMO_vert_flag_test(bm, v_check, VERT_DOUBLE | VERT_TARGET)) {
 			continue;
 		}
 
-		for (j = i + 1; j < verts_len; j++) {
-			BMVert *v_other = verts[j];
+		for (j = 0; j < data.doubles_len[i]; j++) {
+			BMVert *v_other = verts[doubles[j]];
 
 			/* a match has already been found, (we could check which is best, for now don't) */
 			if (BMO_vert_flag_test(bm, v_other, VERT_DOUBLE | VERT_TARGET)) {
 				continue;
 			}
 
-			/* Compare sort values of the verts using 3x tolerance (allowing for the tolerance
-			 * on each of the three axes). This avoids the more expensive length comparison
-			 * for most vertex pairs. */
-			if ((v_other->co[0] + v_other->co[1] + v_other->co[2]) -
-			    (v_check->co[0] + v_check->co[1] + v_check->co[2]) > dist3)
-			{
-				break;
-			}
-
 			if (keepvert) {
 				if (BMO_vert_flag_test(bm, v_other, VERT_KEEP) == BMO_vert_flag_test(bm, v_check, VERT_KEEP))
 					continue;
 			}
 
-			if (compare_len_squared_v3v3(v_check->co, v_other->co, dist_sq)) {
+			/* the target was swapped for a keep vertex, which may be further away */
+			if ((v_check != verts[i]) && !compare_len_squared_v3v3(v_check->co, v_other->co, dist_sq)) {
+				continue;
+			}
 
-				/* If one vert is marked as keep, make sure it will be the target */
-				if (BMO_vert_flag_test(bm, v_other, VERT_KEEP)) {
-					SWAP(BMVert *, v_check, v_other);
-				}
+			/* If one vert is marked as keep, make sure it will be the target */
+			if (BMO_vert_flag_test(bm, v_other, VERT_KEEP)) {
+				SWAP(BMVert *, v_check, v_other);
+			}
 
-				BMO_vert_flag_enable(bm, v_other, VERT_DOUBLE);
-				BMO_vert_flag_enable(bm, v_check, VERT_TARGET);
+			BMO_vert_flag_enable(bm, v_other, VERT_DOUBLE);
+			BMO_vert_flag_enable(bm, v_check, VERT_TARGET);
 
-				BMO_slot_map_elem_insert(optarget, optarget_slot, v_other, v_check);
-			}
+			BMO_slot_map_elem_insert(optarget, optarget_slot, v_other, v_check);
 		}
 	}
 
+	MEM_freeN(data.doubles_len);
+	MEM_freeN(data.doubles_offset);
+	MEM_freeN(data.doubles);
 	MEM_freeN(verts);
 }
 
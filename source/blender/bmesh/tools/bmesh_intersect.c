@@ -965,6 +965,59 @@ static int isect_bvhtree_point_v3(
 	return num_isect;
 }
 
+struct OverlapData {
+	BMLoop *(*looptris)[3];
+	float eps_margin;
+};
+
+/* Return true when every vertex of \a t_b is further than \a eps_margin
+ * from the plane of \a t_a, on the same side. */
+static bool isect_tri_tri_plane_separated(BMLoop **t_a, BMLoop **t_b, const float eps_margin)
+{
+	float nor[3], plane[4];
+	float side[3];
+	uint i;
+
+	normal_tri_v3(nor, t_a[0]->v->co, t_a[1]->v->co, t_a[2]->v->co);
+	plane_from_point_normal_v3(plane, t_a[0]->v->co, nor);
+
+	for (i = 0; i < 3; i++) {
+		side[i] = plane_point_side_v3(plane, t_b[i]->v->co);
+	}
+
+	return ((side[0] > eps_margin && side[1] > eps_margin && side[2] > eps_margin) ||
+	        (side[0] < -eps_margin && side[1] < -eps_margin && side[2] < -eps_margin));
+}
+
+/**
+ * Reject triangle pairs which #bm_isect_tri_tri would skip anyway,
+ * so the (single threaded) intersection only runs on candidate pairs.
+ * Only reads the mesh, this runs from the threads of #BLI_bvhtree_overlap.
+ */
+static bool bm_isect_overlap_cb(void *userdata, int index_a, int index_b, int UNUSED(thread))
+{
+	struct OverlapData *data = userdata;
+	BMLoop **t_a = data->looptris[index_a];
+	BMLoop **t_b = data->looptris[index_b];
+
+	/* triangles sharing a vertex are never intersected */
+	if (ELEM(t_a[0]->v, t_b[0]->v, t_b[1]->v, t_b[2]->v) ||
+	    ELEM(t_a[1]->v, t_b[0]->v, t_b[1]->v, t_b[2]->v) ||
+	    ELEM(t_a[2]->v, t_b[0]->v, t_b[1]->v, t_b[2]->v))
+	{
+		return false;
+	}
+
+	/* all intersection tests use a smaller epsilon than the margin */
+	if (isect_tri_tri_plane_separated(t_a, t_b, data->eps_margin) ||
+	    isect_tri_tri_plane_separated(t_b, t_a, data->eps_margin))
+	{
+		return false;
+	}
+
+	return true;
+}
+
 #endif  /* USE_BVH */
 
 /**
@@ -1104,7 +1157,13 @@ bool BM_mesh_intersect(
 		tree_b = tree_a;
 	}
 
-	overlap = BLI_bvhtree_overlap(tree_b, tree_a, &tree_overlap_tot, NULL, NULL);
+	{
+		struct OverlapData overlap_data = {
+			looptris,
+			s.epsilon.eps_margin,
+		};
+		overlap = BLI_bvhtree_overlap(tree_b, tree_a, &tree_overlap_tot, bm_isect_overlap_cb, &overlap_data);
+	}
 
 	if (overlap) {
 		uint i;
@@ -37,6 +37,7 @@
 #include "BLI_heap.h"
 #include "BLI_edgehash.h"
 #include "BLI_linklist.h"
+#include "BLI_task.h"
 
 /* only for defines */
 #include "BLI_polyfill2d.h"
@@ -47,31 +48,25 @@
 #include "bmesh_triangulate.h"  /* own include */
 
 /**
- * a version of #BM_face_triangulate that maps to #BMOpSlot
+ * a version of #BM_face_triangulate_from_tris that maps to #BMOpSlot
  */
 static void bm_face_triangulate_mapping(
         BMesh *bm, BMFace *face,
-        const int quad_method, const int ngon_method,
+        BMLoop **loops, const uint (*tris)[3],
         const bool use_tag,
-        BMOperator *op, BMOpSlot *slot_facemap_out, BMOpSlot *slot_facemap_double_out,
-
-        MemArena *pf_arena,
-        /* use for MOD_TRIANGULATE_NGON_BEAUTY only! */
-        struct Heap *pf_heap, struct EdgeHash *pf_ehash)
+        BMOperator *op, BMOpSlot *slot_facemap_out, BMOpSlot *slot_facemap_double_out)
 {
 	int faces_array_tot = face->len - 3;
 	BMFace  **faces_array = BLI_array_alloca(faces_array, faces_array_tot);
 	LinkNode *faces_double = NULL;
 	BLI_assert(face->len > 3);
 
-	BM_face_triangulate(
-	        bm, face,
+	BM_face_triangulate_from_tris(
+	        bm, face, loops, tris,
 	        faces_array, &faces_array_tot,
 	        NULL, NULL,
 	        &faces_double,
-	        quad_method, ngon_method, use_tag,
-	        pf_arena,
-	        pf_heap, pf_ehash);
+	        use_tag);
 
 	if (faces_array_tot) {
 		int i;
@@ -89,59 +84,136 @@ static void bm_face_triangulate_mapping(
 	}
 }
 
+typedef struct TriangulateData {
+	BMFace **faces;
+	/* offset of every face into 'loops' and 'tris', the faces lengths summed */
+	int *faces_offset;
+	BMLoop **loops;
+	uint (*tris)[3];
+	int quad_method;
+	int ngon_method;
+} TriangulateData;
+
+typedef struct TriangulateDataChunk {
+	MemArena *pf_arena;
+	Heap *pf_heap;
+	EdgeHash *pf_ehash;
+} TriangulateDataChunk;
+
+static void bm_mesh_triangulate_calc_task(
+        void *userdata, void *userdata_chunk, const int index, const int UNUSED(threadid))
+{
+	const TriangulateData *data = userdata;
+	TriangulateDataChunk *chunk = userdata_chunk;
+	const int offset = data->faces_offset[index];
+
+	if (chunk->pf_arena == NULL) {
+		chunk->pf_arena = BLI_memarena_new(BLI_POLYFILL_ARENA_SIZE, __func__);
+		if (data->ngon_method == MOD_TRIANGULATE_NGON_BEAUTY) {
+			chunk->pf_heap = BLI_heap_new_ex(BLI_POLYFILL_ALLOC_NGON_RESERVE);
+			chunk->pf_ehash = BLI_edgehash_new_ex(__func__, BLI_POLYFILL_ALLOC_NGON_RESERVE);
+		}
+	}
 
+	BM_face_triangulate_calc(
+	        data->faces[index], &data->loops[offset], &data->tris[offset],
+	        data->quad_method, data->ngon_method,
+	        chunk->pf_arena, chunk->pf_heap, chunk->pf_ehash);
+}
+
+static void bm_mesh_triangulate_calc_finalize(void *UNUSED(userdata), void *userdata_chunk)
+{
+	TriangulateDataChunk *chunk = userdata_chunk;
+
+	if (chunk->pf_arena) {
+		BLI_memarena_free(chunk->pf_arena);
+	}
+	if (chunk->pf_heap) {
+		BLI_heap_free(chunk->pf_heap, NULL);
+	}
+	if (chunk->pf_ehash) {
+		BLI_edgehash_free(chunk->pf_ehash, NULL);
+	}
+}
+
+/**
+ * Triangulates all faces (or only the tagged ones).
+ *
+ * The triangles are calculated for all faces in parallel first,
+ * then the faces are split, which has to be done one face at a time.
+ */
 void BM_mesh_triangulate(
         BMesh *bm, const int quad_method, const int ngon_method, const bool tag_only,
         BMOperator *op, BMOpSlot *slot_facemap_out, BMOpSlot *slot_facemap_double_out)
 {
 	BMIter iter;
 	BMFace *face;
-	MemArena *pf_arena;
-	Heap *pf_heap;
-	EdgeHash *pf_ehash;
-
-	pf_arena = BLI_memarena_new(BLI_POLYFILL_ARENA_SIZE, __func__);
+	TriangulateData data;
+	TriangulateDataChunk chunk = {NULL};
+	int faces_len = 0, loops_len = 0;
+	int i;
+
+	BM_ITER_MESH (face, &iter, bm, BM_FACES_OF_MESH) {
+		if (face->len > 3) {
+			if (tag_only == false || BM_elem_flag_test(face, BM_ELEM_TAG)) {
+				faces_len++;
+				loops_len += face->len;
+			}
+		}
+	}
 
-	if (ngon_method == MOD_TRIANGULATE_NGON_BEAUTY) {
-		pf_heap = BLI_heap_new_ex(BLI_POLYFILL_ALLOC_NGON_RESERVE);
-		pf_ehash = BLI_edgehash_new_ex(__func__, BLI_POLYFILL_ALLOC_NGON_RESERVE);
+	if (faces_len == 0) {
+		return;
 	}
-	else {
-		pf_heap = NULL;
-		pf_ehash = NULL;
+
+	data.faces = MEM_mallocN(sizeof(*data.faces) * (size_t)faces_len, __func__);
+	data.faces_offset = MEM_mallocN(sizeof(*data.faces_offset) * (size_t)faces_len, __func__);
+	data.loops = MEM_mallocN(sizeof(*data.loops) * (size_t)loops_len, __func__);
+	data.tris = MEM_mallocN(sizeof(*data.tris) * (size_t)loops_len, __func__);
+	data.quad_method = quad_method;
+	data.ngon_method = ngon_method;
+
+	i = 0;
+	loops_len = 0;
+	BM_ITER_MESH (face, &iter, bm, BM_FACES_OF_MESH) {
+		if (face->len > 3) {
+			if (tag_only == false || BM_elem_flag_test(face, BM_ELEM_TAG)) {
+				data.faces[i] = face;
+				data.faces_offset[i] = loops_len;
+				loops_len += face->len;
+				i++;
+			}
+		}
 	}
 
+	BLI_task_parallel_range_finalize(
+	        0, faces_len, &data, &chunk, sizeof(chunk),
+	        bm_mesh_triangulate_calc_task, bm_mesh_triangulate_calc_finalize,
+	        faces_len >= BM_OMP_LIMIT, false);
+
 	if (slot_facemap_out) {
 		/* same as below but call: bm_face_triangulate_mapping() */
-		BM_ITER_MESH (face, &iter, bm, BM_FACES_OF_MESH) {
-			if (face->len > 3) {
-				if (tag_only == false || BM_elem_flag_test(face, BM_ELEM_TAG)) {
-					bm_face_triangulate_mapping(
-					        bm, face,
-					        quad_method, ngon_method, tag_only,
-					        op, slot_facemap_out, slot_facemap_double_out,
-					        pf_arena,
-					        pf_heap, pf_ehash);
-				}
-			}
+		for (i = 0; i < faces_len; i++) {
+			const int offset = data.faces_offset[i];
+			bm_face_triangulate_mapping(
+			        bm, data.faces[i],
+			        &data.loops[offset], (const uint (*)[3])&data.tris[offset],
+			        tag_only,
+			        op, slot_facemap_out, slot_facemap_double_out);
 		}
 	}
 	else {
 		LinkNode *faces_double = NULL;
 
-		BM_ITER_MESH (face, &iter, bm, BM_FACES_OF_MESH) {
-			if (face->len > 3) {
-				if (tag_only == false || BM_elem_flag_test(face, BM_ELEM_TAG)) {
-					BM_face_triangulate(
-					        bm, face,
-					        NULL, NULL,
-					        NULL, NULL,
-					        &faces_double,
-					        quad_method, ngon_method, tag_only,
-					        pf_arena,
-					        pf_heap, pf_ehash);
-				}
-			}
+		for (i = 0; i < faces_len; i++) {
+			const int offset = data.faces_offset[i];
+			BM_face_triangulate_from_tris(
+			        bm, data.faces[i],
+			        &data.loops[offset], (const uint (*)[3])&data.tris[offset],
+			        NULL, NULL,
+			        NULL, NULL,
+			        &faces_double,
+			        tag_only);
 		}
 
 		while (faces_double) {
@@ -152,10 +224,8 @@ void BM_mesh_triangulate(
 		}
 	}
 
-	BLI_memarena_free(pf_arena);
-
-	if (ngon_method == MOD_TRIANGULATE_NGON_BEAUTY) {
-		BLI_heap_free(pf_heap, NULL);
-		BLI_edgehash_free(pf_ehash, NULL);
-	}
+	MEM_freeN(data.faces);
+	MEM_freeN(data.faces_offset);
+	MEM_freeN(data.loops);
+	MEM_freeN(data.tris);
 }
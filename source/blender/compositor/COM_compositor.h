@@ -86,11 +86,12 @@ extern "C" {
  * All NodeOperation has a setting for their render-priority, but only for output NodeOperation these have effect.
  * In ExecutionSystem.execute all priorities are checked. For every priority the ExecutionGroup's are check if the
  * priority do match.
- * When match the ExecutionGroup will be executed (this happens in serial)
+ * When match the ExecutionGroup will be executed. ExecutionGroup's are interleaved, chunks needed by a higher priority are
+ * taken first by the threads and lower priorities only get chunks scheduled when the higher ones can't keep all threads busy.
  *
  * @see ExecutionSystem.execute control of the Render priority
  * @see NodeOperation.getRenderPriority receive the render priority
- * @see ExecutionGroup.execute the main loop to execute a whole ExecutionGroup
+ * @see ExecutionGroup.executeNextChunks the main loop to execute a whole ExecutionGroup
  *
  * @section order Chunk order
  *
@@ -109,7 +110,7 @@ extern "C" {
  *  - [@ref ChunkExecutionState.COM_ES_SCHEDULED]: All dependencies are met, chunk is scheduled, but not finished
  *  - [@ref ChunkExecutionState.COM_ES_EXECUTED]: Chunk is finished
  *
- * @see ExecutionGroup.execute
+ * @see ExecutionGroup.beginExecute
  * @see ViewerOperation.getChunkOrder
  * @see OrderOfChunks
  *
@@ -154,7 +155,7 @@ extern "C" {
  * +-------------------------+        | (B)            |                           | (A)            |
  *            O                       +----------------+                           +----------------+
  *            O                                |                                            |
- *            O       ExecutionGroup.execute   |                                            |
+ *            O  ExecutionGroup.beginExecute   |                                            |
  *            O------------------------------->O                                            |
  *            .                                O                                            |
  *            .                                O-------\                                    |
@@ -206,7 +207,8 @@ extern "C" {
  *
  * </pre>
  *
- * @see ExecutionGroup.execute Execute a complete ExecutionGroup. Halts until finished or breaked by user
+ * @see ExecutionGroup.executeNextChunks Schedule the next chunks of an output ExecutionGroup,
+ * output groups are interleaved by priority until finished or breaked by user
  * @see ExecutionGroup.scheduleChunkWhenPossible Tries to schedule a single chunk,
  * checks if all input data is available. Can trigger dependent chunks to be calculated
  * @see ExecutionGroup.scheduleAreaWhenPossible Tries to schedule an area. This can be multiple chunks
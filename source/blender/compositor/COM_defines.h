@@ -109,6 +109,12 @@ typedef enum OrderOfChunks {
 #define COM_NUM_CHANNELS_VECTOR 3
 #define COM_NUM_CHANNELS_COLOR 4
 
+/**
+ * @brief maximum number of pixels of a row calculated at once
+ * @see SocketReader.executeRowSampled
+ */
+#define COM_ROW_PIXELS 64
+
 #define COM_BLUR_BOKEH_PIXELS 512
 
 #endif  /* __COM_DEFINES_H__ */
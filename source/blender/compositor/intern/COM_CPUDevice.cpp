@@ -22,6 +22,8 @@
 
 #include "COM_CPUDevice.h"
 
+#include "PIL_time.h"
+
 CPUDevice::CPUDevice(int thread_id)
   : Device(),
     m_thread_id(thread_id)
@@ -32,12 +34,14 @@ void CPUDevice::execute(WorkPackage *work)
 {
 	const unsigned int chunkNumber = work->getChunkNumber();
 	ExecutionGroup *executionGroup = work->getExecutionGroup();
+	const double start = PIL_check_seconds_timer();
 	rcti rect;
 
 	executionGroup->determineChunkRect(&rect, chunkNumber);
 
 	executionGroup->getOutputOperation()->executeRegion(&rect, chunkNumber);
 
+	executionGroup->addExecutionTime(PIL_check_seconds_timer() - start);
 	executionGroup->finalizeChunkExecution(chunkNumber, NULL);
 }
 
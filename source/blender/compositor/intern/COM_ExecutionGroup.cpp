@@ -61,8 +61,11 @@ ExecutionGroup::ExecutionGroup()
 	this->m_openCL = false;
 	this->m_singleThreaded = false;
 	this->m_chunksFinished = 0;
+	this->m_executionTime = 0.0f;
 	BLI_rcti_init(&this->m_viewerBorder, 0, 0, 0, 0);
 	this->m_executionStartTime = 0;
+	this->m_chunkOrder = NULL;
+	this->m_chunkOrderStart = 0;
 }
 
 CompositorPriority ExecutionGroup::getRenderPriotrity()
@@ -93,7 +96,8 @@ bool ExecutionGroup::addOperation(NodeOperation *operation)
 	
 	if (!operation->isReadBufferOperation() && !operation->isWriteBufferOperation()) {
 		m_complex = operation->isComplex();
-		m_openCL = operation->isOpenCL();
+		/* the group can only be scheduled on a device when all of its operations can */
+		m_openCL = operation->isOpenCL() && (!m_initialized || m_openCL);
 		m_singleThreaded = operation->isSingleThreaded();
 		m_initialized = true;
 	}
@@ -181,21 +185,23 @@ void ExecutionGroup::determineNumberOfChunks()
 /**
  * this method is called for the top execution groups. containing the compositor node or the preview node or the viewer node)
  */
-void ExecutionGroup::execute(ExecutionSystem *graph)
+bool ExecutionGroup::beginExecute(ExecutionSystem *graph)
 {
 	const CompositorContext &context = graph->getContext();
 	const bNodeTree *bTree = context.getbNodeTree();
-	if (this->m_width == 0 || this->m_height == 0) {return; } /// @note: break out... no pixels to calculate.
-	if (bTree->test_break && bTree->test_break(bTree->tbh)) {return; } /// @note: early break out for blur and preview nodes
-	if (this->m_numberOfChunks == 0) {return; } /// @note: early break out
+	if (this->m_width == 0 || this->m_height == 0) {return false; } /// @note: break out... no pixels to calculate.
+	if (bTree->test_break && bTree->test_break(bTree->tbh)) {return false; } /// @note: early break out for blur and preview nodes
+	if (this->m_numberOfChunks == 0) {return false; } /// @note: early break out
 	unsigned int chunkNumber;
 
 	this->m_executionStartTime = PIL_check_seconds_timer();
 
 	this->m_chunksFinished = 0;
 	this->m_bTree = bTree;
+	this->m_chunkOrderStart = 0;
 	unsigned int index;
 	unsigned int *chunkOrder = (unsigned int *)MEM_mallocN(sizeof(unsigned int) * this->m_numberOfChunks, __func__);
+	this->m_chunkOrder = chunkOrder;
 
 	for (chunkNumber = 0; chunkNumber < this->m_numberOfChunks; chunkNumber++) {
 		chunkOrder[chunkNumber] = chunkNumber;
@@ -304,50 +310,51 @@ void ExecutionGroup::execute(ExecutionSystem *graph)
 	DebugInfo::execution_group_started(this);
 	DebugInfo::graphviz(graph);
 
-	bool breaked = false;
-	bool finished = false;
-	unsigned int startIndex = 0;
-	const int maxNumberEvaluated = BLI_system_thread_count() * 2;
+	return true;
+}
 
-	while (!finished && !breaked) {
-		bool startEvaluated = false;
-		finished = true;
-		int numberEvaluated = 0;
-
-		for (index = startIndex; index < this->m_numberOfChunks && numberEvaluated < maxNumberEvaluated; index++) {
-			chunkNumber = chunkOrder[index];
-			int yChunk = chunkNumber / this->m_numberOfXChunks;
-			int xChunk = chunkNumber - (yChunk * this->m_numberOfXChunks);
-			const ChunkExecutionState state = this->m_chunkExecutionStates[chunkNumber];
-			if (state == COM_ES_NOT_SCHEDULED) {
-				scheduleChunkWhenPossible(graph, xChunk, yChunk);
-				finished = false;
-				startEvaluated = true;
-				numberEvaluated++;
-
-				if (bTree->update_draw)
-					bTree->update_draw(bTree->udh);
-			}
-			else if (state == COM_ES_SCHEDULED) {
-				finished = false;
-				startEvaluated = true;
-				numberEvaluated++;
-			}
-			else if (state == COM_ES_EXECUTED && !startEvaluated) {
-				startIndex = index + 1;
-			}
+bool ExecutionGroup::executeNextChunks(ExecutionSystem *graph)
+{
+	const CompositorPriority priority = this->getRenderPriotrity();
+	const int maxNumberEvaluated = BLI_system_thread_count() * 2;
+	bool startEvaluated = false;
+	bool finished = true;
+	int numberEvaluated = 0;
+
+	for (unsigned int index = this->m_chunkOrderStart; index < this->m_numberOfChunks && numberEvaluated < maxNumberEvaluated; index++) {
+		const unsigned int chunkNumber = this->m_chunkOrder[index];
+		int yChunk = chunkNumber / this->m_numberOfXChunks;
+		int xChunk = chunkNumber - (yChunk * this->m_numberOfXChunks);
+		const ChunkExecutionState state = this->m_chunkExecutionStates[chunkNumber];
+		if (state == COM_ES_NOT_SCHEDULED) {
+			scheduleChunkWhenPossible(graph, xChunk, yChunk, priority);
+			finished = false;
+			startEvaluated = true;
+			numberEvaluated++;
+
+			if (this->m_bTree->update_draw)
+				this->m_bTree->update_draw(this->m_bTree->udh);
 		}
-
-		WorkScheduler::finish();
-
-		if (bTree->test_break && bTree->test_break(bTree->tbh)) {
-			breaked = true;
+		else if (state == COM_ES_SCHEDULED) {
+			finished = false;
+			startEvaluated = true;
+			numberEvaluated++;
+		}
+		else if (state == COM_ES_EXECUTED && !startEvaluated) {
+			this->m_chunkOrderStart = index + 1;
 		}
 	}
+
+	return finished;
+}
+
+void ExecutionGroup::endExecute(ExecutionSystem *graph)
+{
 	DebugInfo::execution_group_finished(this);
 	DebugInfo::graphviz(graph);
 
-	MEM_freeN(chunkOrder);
+	MEM_freeN(this->m_chunkOrder);
+	this->m_chunkOrder = NULL;
 }
 
 MemoryBuffer **ExecutionGroup::getInputBuffersOpenCL(int chunkNumber)
@@ -378,6 +385,11 @@ MemoryBuffer *ExecutionGroup::constructConsolidatedMemoryBuffer(MemoryProxy *mem
 	return result;
 }
 
+void ExecutionGroup::addExecutionTime(float seconds)
+{
+	atomic_add_and_fetch_fl(&this->m_executionTime, seconds);
+}
+
 void ExecutionGroup::finalizeChunkExecution(int chunkNumber, MemoryBuffer **memoryBuffers)
 {
 	if (this->m_chunkExecutionStates[chunkNumber] == COM_ES_SCHEDULED)
@@ -448,10 +460,10 @@ MemoryBuffer *ExecutionGroup::allocateOutputBuffer(int /*chunkNumber*/,
 }
 
 
-bool ExecutionGroup::scheduleAreaWhenPossible(ExecutionSystem *graph, rcti *area)
+bool ExecutionGroup::scheduleAreaWhenPossible(ExecutionSystem *graph, rcti *area, CompositorPriority priority)
 {
 	if (this->m_singleThreaded) {
-		return scheduleChunkWhenPossible(graph, 0, 0);
+		return scheduleChunkWhenPossible(graph, 0, 0, priority);
 	}
 	// find all chunks inside the rect
 	// determine minxchunk, minychunk, maxxchunk, maxychunk where x and y are chunknumbers
@@ -473,7 +485,7 @@ bool ExecutionGroup::scheduleAreaWhenPossible(ExecutionSystem *graph, rcti *area
 	bool result = true;
 	for (indexx = minxchunk; indexx < maxxchunk; indexx++) {
 		for (indexy = minychunk; indexy < maxychunk; indexy++) {
-			if (!scheduleChunkWhenPossible(graph, indexx, indexy)) {
+			if (!scheduleChunkWhenPossible(graph, indexx, indexy, priority)) {
 				result = false;
 			}
 		}
@@ -482,17 +494,17 @@ bool ExecutionGroup::scheduleAreaWhenPossible(ExecutionSystem *graph, rcti *area
 	return result;
 }
 
-bool ExecutionGroup::scheduleChunk(unsigned int chunkNumber)
+bool ExecutionGroup::scheduleChunk(unsigned int chunkNumber, CompositorPriority priority)
 {
 	if (this->m_chunkExecutionStates[chunkNumber] == COM_ES_NOT_SCHEDULED) {
 		this->m_chunkExecutionStates[chunkNumber] = COM_ES_SCHEDULED;
-		WorkScheduler::schedule(this, chunkNumber);
+		WorkScheduler::schedule(this, chunkNumber, priority);
 		return true;
 	}
 	return false;
 }
 
-bool ExecutionGroup::scheduleChunkWhenPossible(ExecutionSystem *graph, int xChunk, int yChunk)
+bool ExecutionGroup::scheduleChunkWhenPossible(ExecutionSystem *graph, int xChunk, int yChunk, CompositorPriority priority)
 {
 	if (xChunk < 0 || xChunk >= (int)this->m_numberOfXChunks) {
 		return true;
@@ -529,7 +541,7 @@ bool ExecutionGroup::scheduleChunkWhenPossible(ExecutionSystem *graph, int xChun
 		ExecutionGroup *group = memoryProxy->getExecutor();
 
 		if (group != NULL) {
-			if (!group->scheduleAreaWhenPossible(graph, &area)) {
+			if (!group->scheduleAreaWhenPossible(graph, &area, priority)) {
 				canBeExecuted = false;
 			}
 		}
@@ -539,12 +551,33 @@ bool ExecutionGroup::scheduleChunkWhenPossible(ExecutionSystem *graph, int xChun
 	}
 
 	if (canBeExecuted) {
-		scheduleChunk(chunkNumber);
+		graph->getMemoryPlanner()->acquireBuffers(this);
+		scheduleChunk(chunkNumber, priority);
 	}
 
 	return false;
 }
 
+void ExecutionGroup::setExecuted()
+{
+	for (unsigned int index = 0; index < this->m_numberOfChunks; index++) {
+		this->m_chunkExecutionStates[index] = COM_ES_EXECUTED;
+	}
+}
+
+bool ExecutionGroup::isExecuted() const
+{
+	if (this->m_numberOfChunks == 0) {
+		return false;
+	}
+	for (unsigned int index = 0; index < this->m_numberOfChunks; index++) {
+		if (this->m_chunkExecutionStates[index] != COM_ES_EXECUTED) {
+			return false;
+		}
+	}
+	return true;
+}
+
 void ExecutionGroup::determineDependingAreaOfInterest(rcti *input, ReadBufferOperation *readOperation, rcti *output)
 {
 	this->getOutputOperation()->determineDependingAreaOfInterest(input, readOperation, output);
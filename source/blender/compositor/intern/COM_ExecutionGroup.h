@@ -147,6 +147,11 @@ private:
 	 * @brief total number of chunks that have been calculated for this ExecutionGroup
 	 */
 	unsigned int m_chunksFinished;
+
+	/**
+	 * @brief total time in seconds the devices spent on the chunks of this ExecutionGroup
+	 */
+	float m_executionTime;
 	
 	/**
 	 * @brief the chunkExecutionStates holds per chunk the execution state. this state can be
@@ -178,6 +183,17 @@ private:
 	 */
 	double m_executionStartTime;
 
+	/**
+	 * @brief order in which the chunks of an output ExecutionGroup are scheduled
+	 * @see beginExecute
+	 */
+	unsigned int *m_chunkOrder;
+
+	/**
+	 * @brief index in m_chunkOrder before which all chunks have been executed
+	 */
+	unsigned int m_chunkOrderStart;
+
 	// methods
 	/**
 	 * @brief check whether parameter operation can be added to the execution group
@@ -213,11 +229,12 @@ private:
 	 * @param graph
 	 * @param xChunk
 	 * @param yChunk
+	 * @param priority priority of the output ExecutionGroup the chunk is needed for
 	 * @return [true:false]
 	 * true: package(s) are scheduled
 	 * false: scheduling is deferred (depending workpackages are scheduled)
 	 */
-	bool scheduleChunkWhenPossible(ExecutionSystem *graph, int xChunk, int yChunk);
+	bool scheduleChunkWhenPossible(ExecutionSystem *graph, int xChunk, int yChunk, CompositorPriority priority);
 
 	/**
 	 * @brief try to schedule a specific area.
@@ -225,17 +242,19 @@ private:
 	 * @note This method is called from other ExecutionGroup's.
 	 * @param graph
 	 * @param rect
+	 * @param priority priority of the output ExecutionGroup the area is needed for
 	 * @return [true:false]
 	 * true: package(s) are scheduled
 	 * false: scheduling is deferred (depending workpackages are scheduled)
 	 */
-	bool scheduleAreaWhenPossible(ExecutionSystem *graph, rcti *rect);
+	bool scheduleAreaWhenPossible(ExecutionSystem *graph, rcti *rect, CompositorPriority priority);
 
 	/**
 	 * @brief add a chunk to the WorkScheduler.
 	 * @param chunknumber
+	 * @param priority
 	 */
-	bool scheduleChunk(unsigned int chunkNumber);
+	bool scheduleChunk(unsigned int chunkNumber, CompositorPriority priority);
 	
 	/**
 	 * @brief determine the area of interest of a certain input area
@@ -309,6 +328,9 @@ public:
 	 * @return NodeOperation *output operation
 	 */
 	NodeOperation *getOutputOperation() const;
+
+	unsigned int getNumberOfOperations() const { return this->m_operations.size(); }
+	NodeOperation *getOperation(unsigned int index) const { return this->m_operations[index]; }
 	
 	/**
 	 * @brief compose multiple chunks into a single chunk
@@ -352,6 +374,14 @@ public:
 	 * @param memorybuffers
 	 */
 	void finalizeChunkExecution(int chunkNumber, MemoryBuffer **memoryBuffers);
+
+	/**
+	 * @brief add the time a device spent on a chunk, for the statistics of the nodes
+	 * @param seconds
+	 */
+	void addExecutionTime(float seconds);
+	float getExecutionTime() const { return this->m_executionTime; }
+	unsigned int getNumberOfFinishedChunks() const { return this->m_chunksFinished; }
 	
 	/**
 	 * @brief deinitExecution is called just after execution the whole graph.
@@ -361,20 +391,44 @@ public:
 	
 	
 	/**
-	 * @brief schedule an ExecutionGroup
-	 * @note this method will return when all chunks have been calculated, or the execution has breaked (by user)
+	 * @brief start executing an output ExecutionGroup
 	 *
-	 * first the order of the chunks will be determined. This is determined by finding the ViewerOperation and get the relevant information from it.
+	 * the order of the chunks will be determined. This is determined by finding the ViewerOperation and get the relevant information from it.
 	 *   - ChunkOrdering
 	 *   - CenterX
 	 *   - CenterY
 	 *
-	 * After determining the order of the chunks the chunks will be scheduled
-	 *
 	 * @see ViewerOperation
 	 * @param system
+	 * @return false when there is nothing to calculate, executeNextChunks and endExecute must not be called
+	 */
+	bool beginExecute(ExecutionSystem *system);
+
+	/**
+	 * @brief schedule the next chunks in order, with the priority of this ExecutionGroup
+	 * @note a limited number of chunks is kept scheduled at once, so other output groups can be interleaved.
+	 * this method is called repeatedly by the ExecutionSystem until it returns true or the execution has breaked (by user)
+	 * @param system
+	 * @return true when all chunks have been calculated
+	 */
+	bool executeNextChunks(ExecutionSystem *system);
+
+	/**
+	 * @brief finish executing an output ExecutionGroup
+	 * @param system
+	 */
+	void endExecute(ExecutionSystem *system);
+
+	/**
+	 * @brief mark all chunks as executed, so they will not be scheduled
+	 * @note used when the output buffer has been restored from the ResultCache
+	 */
+	void setExecuted();
+
+	/**
+	 * @brief check if all chunks of this ExecutionGroup have been executed
 	 */
-	void execute(ExecutionSystem *system);
+	bool isExecuted() const;
 	
 	/**
 	 * @brief this method determines the MemoryProxy's where this execution group depends on.
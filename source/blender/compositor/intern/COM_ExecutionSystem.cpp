@@ -20,6 +20,8 @@
  *		Monique Dewanchand
  */
 
+#include <algorithm>
+
 #include "COM_ExecutionSystem.h"
 
 #include "PIL_time.h"
@@ -36,12 +38,26 @@ extern "C" {
 #include "COM_ExecutionGroup.h"
 #include "COM_WorkScheduler.h"
 #include "COM_ReadBufferOperation.h"
+#include "COM_WriteBufferOperation.h"
+#include "COM_ResultCache.h"
 #include "COM_Debug.h"
 
 #ifdef WITH_CXX_GUARDEDALLOC
 #include "MEM_guardedalloc.h"
 #endif
 
+static void reset_node_statistics(bNodeTree *ntree)
+{
+	for (bNode *node = (bNode *)ntree->nodes.first; node; node = node->next) {
+		node->exec_time = 0.0f;
+		node->exec_memory = 0.0f;
+		node->exec_chunks = 0;
+		if (node->type == NODE_GROUP && node->id) {
+			reset_node_statistics((bNodeTree *)node->id);
+		}
+	}
+}
+
 ExecutionSystem::ExecutionSystem(RenderData *rd, Scene *scene, bNodeTree *editingtree, bool rendering, bool fastcalculation,
                                  const ColorManagedViewSettings *viewSettings, const ColorManagedDisplaySettings *displaySettings,
                                  const char *viewName)
@@ -65,6 +81,8 @@ ExecutionSystem::ExecutionSystem(RenderData *rd, Scene *scene, bNodeTree *editin
 	this->m_context.setViewSettings(viewSettings);
 	this->m_context.setDisplaySettings(displaySettings);
 
+	reset_node_statistics(editingtree);
+
 	{
 		NodeOperationBuilder builder(&m_context, editingtree);
 		builder.convertToOperations(this);
@@ -173,18 +191,38 @@ void ExecutionSystem::execute()
 		executionGroup->setChunksize(this->m_context.getChunksize());
 		executionGroup->initExecution();
 	}
+	this->m_memoryPlanner.plan(this->m_groups);
+
+	/* while editing, reuse the results of groups that didn't change since the last execution.
+	 * rendering can change the render layers in ways the node tree doesn't show */
+	CacheKeys cacheKeys;
+	const bool use_cache = !this->m_context.isRendering();
+	if (use_cache) {
+		restoreCachedResults(cacheKeys);
+	}
+	else {
+		ResultCache::clear();
+	}
 
 	WorkScheduler::start(this->m_context);
 
-	executeGroups(COM_PRIORITY_HIGH);
+	vector<ExecutionGroup *> executionGroups;
+	this->findOutputExecutionGroup(&executionGroups, COM_PRIORITY_HIGH);
 	if (!this->getContext().isFastCalculation()) {
-		executeGroups(COM_PRIORITY_MEDIUM);
-		executeGroups(COM_PRIORITY_LOW);
+		this->findOutputExecutionGroup(&executionGroups, COM_PRIORITY_MEDIUM);
+		this->findOutputExecutionGroup(&executionGroups, COM_PRIORITY_LOW);
 	}
+	executeGroups(executionGroups, use_cache ? &cacheKeys : NULL);
 
 	WorkScheduler::finish();
 	WorkScheduler::stop();
 
+	if (use_cache) {
+		storeCachedResults(cacheKeys);
+	}
+	this->m_memoryPlanner.releaseAll();
+	updateNodeStatistics();
+
 	editingtree->stats_draw(editingtree->sdh, IFACE_("Compositing | De-initializing execution"));
 	for (index = 0; index < this->m_operations.size(); index++) {
 		NodeOperation *operation = this->m_operations[index];
@@ -196,15 +234,232 @@ void ExecutionSystem::execute()
 	}
 }
 
-void ExecutionSystem::executeGroups(CompositorPriority priority)
+void ExecutionSystem::updateNodeStatistics()
+{
+	for (unsigned int index = 0; index < this->m_groups.size(); index++) {
+		ExecutionGroup *group = this->m_groups[index];
+		const unsigned int chunks = group->getNumberOfFinishedChunks();
+		if (chunks == 0) {
+			continue;
+		}
+
+		vector<bNode *> nodes;
+		for (unsigned int i = 0; i < group->getNumberOfOperations(); i++) {
+			NodeOperation *operation = group->getOperation(i);
+			bNode *node = operation->getEditorNode();
+			/* read buffers belong to the group that writes them */
+			if (node && !operation->isReadBufferOperation() &&
+			    std::find(nodes.begin(), nodes.end(), node) == nodes.end())
+			{
+				nodes.push_back(node);
+			}
+		}
+		if (nodes.empty()) {
+			continue;
+		}
+
+		const float time = group->getExecutionTime() / nodes.size();
+		for (vector<bNode *>::iterator it = nodes.begin(); it != nodes.end(); ++it) {
+			(*it)->exec_time += time;
+			(*it)->exec_chunks += chunks;
+		}
+
+		NodeOperation *output = group->getOutputOperation();
+		if (output->isWriteBufferOperation() && output->getEditorNode()) {
+			MemoryBuffer *buffer = ((WriteBufferOperation *)output)->getMemoryProxy()->getBuffer();
+			output->getEditorNode()->exec_memory += buffer->getAllocationSize() / (1024.0f * 1024.0f);
+		}
+	}
+}
+
+static uint64_t cache_context_key(const CompositorContext &context)
+{
+	const RenderData *rd = context.getRenderData();
+	const bNodeTree *ntree = context.getbNodeTree();
+	const Scene *scene = context.getScene();
+	const CompositorQuality quality = context.getQuality();
+	const bool fastCalculation = context.isFastCalculation();
+	const char *viewName = context.getViewName();
+	const bool halfCache = context.isHalfCacheEnabled();
+
+	uint64_t key = ResultCache::hash(0, &ntree, sizeof(ntree));
+	key = ResultCache::hash(key, &scene, sizeof(scene));
+	key = ResultCache::hash(key, &quality, sizeof(quality));
+	key = ResultCache::hash(key, &fastCalculation, sizeof(fastCalculation));
+	key = ResultCache::hash(key, &halfCache, sizeof(halfCache));
+	if (viewName) {
+		key = ResultCache::hash(key, viewName, strlen(viewName));
+	}
+	key = ResultCache::hash(key, &rd->cfra, sizeof(rd->cfra));
+	key = ResultCache::hash(key, &rd->subframe, sizeof(rd->subframe));
+	key = ResultCache::hash(key, &rd->xsch, sizeof(rd->xsch));
+	key = ResultCache::hash(key, &rd->ysch, sizeof(rd->ysch));
+	key = ResultCache::hash(key, &rd->size, sizeof(rd->size));
+	key = ResultCache::hash(key, &rd->mode, sizeof(rd->mode));
+	key = ResultCache::hash(key, &rd->border, sizeof(rd->border));
+	return key;
+}
+
+uint64_t ExecutionSystem::determineCacheKey(NodeOperation *operation, CacheKeys &keys)
+{
+	CacheKeys::const_iterator it = keys.find(operation);
+	if (it != keys.end()) {
+		return it->second;
+	}
+
+	uint64_t key = operation->getCacheHash();
+	if (operation->isReadBufferOperation()) {
+		ReadBufferOperation *readOperation = (ReadBufferOperation *)operation;
+		key = ResultCache::combine(key, determineCacheKey(readOperation->getMemoryProxy()->getWriteBufferOperation(), keys));
+	}
+	else if (operation->isSetOperation() && key != 0) {
+		/* constants added for unconnected inputs and resolution conversions are not created by a node */
+		float value[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+		operation->readSampled(value, 0.0f, 0.0f, COM_PS_NEAREST);
+		key = ResultCache::hash(key, value, sizeof(value));
+	}
+	for (unsigned int index = 0; index < operation->getNumberOfInputSockets() && key != 0; index++) {
+		NodeOperationInput *input = operation->getInputSocket(index);
+		if (input->isConnected()) {
+			key = ResultCache::combine(key, determineCacheKey(&input->getLink()->getOperation(), keys));
+		}
+	}
+	if (key != 0) {
+		unsigned int resolution[2] = {operation->getWidth(), operation->getHeight()};
+		key = ResultCache::hash(key, resolution, sizeof(resolution));
+	}
+
+	keys[operation] = key;
+	return key;
+}
+
+void ExecutionSystem::restoreCachedResults(CacheKeys &keys)
+{
+	const uint64_t contextKey = cache_context_key(this->m_context);
+
+	ResultCache::beginExecution();
+	for (unsigned int index = 0; index < this->m_groups.size(); index++) {
+		ExecutionGroup *executionGroup = this->m_groups[index];
+		NodeOperation *operation = executionGroup->getOutputOperation();
+		if (!operation->isWriteBufferOperation()) {
+			continue;
+		}
+
+		const uint64_t key = ResultCache::combine(contextKey, determineCacheKey(operation, keys));
+		if (key == 0 || !ResultCache::contains(key)) {
+			continue;
+		}
+
+		MemoryProxy *memoryProxy = ((WriteBufferOperation *)operation)->getMemoryProxy();
+		this->m_memoryPlanner.acquireBuffer(memoryProxy);
+		if (ResultCache::restore(key, memoryProxy->getBuffer())) {
+			executionGroup->setExecuted();
+		}
+		else {
+			this->m_memoryPlanner.release(memoryProxy);
+		}
+	}
+}
+
+void ExecutionSystem::storeCachedResult(ExecutionGroup *executionGroup, uint64_t contextKey, CacheKeys &keys)
+{
+	NodeOperation *operation = executionGroup->getOutputOperation();
+	if (!operation->isWriteBufferOperation() || !executionGroup->isExecuted()) {
+		return;
+	}
+
+	MemoryProxy *memoryProxy = ((WriteBufferOperation *)operation)->getMemoryProxy();
+	if (!memoryProxy->getBuffer()->isAllocated()) {
+		return;
+	}
+
+	const uint64_t key = ResultCache::combine(contextKey, determineCacheKey(operation, keys));
+	if (key != 0) {
+		ResultCache::store(key, memoryProxy, this->m_context.isHalfCacheEnabled());
+	}
+}
+
+void ExecutionSystem::storeCachedResults(CacheKeys &keys)
 {
+	const bNodeTree *editingtree = this->m_context.getbNodeTree();
+	const uint64_t contextKey = cache_context_key(this->m_context);
+
+	/* chunks are finalized as executed when breaking, their buffers are incomplete */
+	if (!editingtree->test_break(editingtree->tbh)) {
+		for (unsigned int index = 0; index < this->m_groups.size(); index++) {
+			storeCachedResult(this->m_groups[index], contextKey, keys);
+		}
+	}
+	ResultCache::endExecution();
+}
+
+/* only called when not breaked, so the executed groups are completely calculated */
+void ExecutionSystem::releaseUnusedBuffers(CacheKeys *cacheKeys)
+{
+	vector<MemoryProxy *> memoryProxies;
+	this->m_memoryPlanner.determineUnusedBuffers(&memoryProxies);
+	if (memoryProxies.empty()) {
+		return;
+	}
+
+	const uint64_t contextKey = cacheKeys ? cache_context_key(this->m_context) : 0;
+	for (unsigned int index = 0; index < memoryProxies.size(); index++) {
+		MemoryProxy *memoryProxy = memoryProxies[index];
+		if (cacheKeys) {
+			storeCachedResult(memoryProxy->getExecutor(), contextKey, *cacheKeys);
+		}
+		this->m_memoryPlanner.release(memoryProxy);
+	}
+}
+
+void ExecutionSystem::executeGroups(const vector<ExecutionGroup *> &executionGroups, CacheKeys *cacheKeys)
+{
+	const bNodeTree *editingtree = this->m_context.getbNodeTree();
 	unsigned int index;
-	vector<ExecutionGroup *> executionGroups;
-	this->findOutputExecutionGroup(&executionGroups, priority);
+	vector<ExecutionGroup *> startedGroups;
+	vector<ExecutionGroup *> pendingGroups;
 
 	for (index = 0; index < executionGroups.size(); index++) {
 		ExecutionGroup *group = executionGroups[index];
-		group->execute(this);
+		if (group->beginExecute(this)) {
+			startedGroups.push_back(group);
+		}
+	}
+	pendingGroups = startedGroups;
+	this->m_memoryPlanner.setActiveOutputs(startedGroups);
+
+	/* interleave the output groups, ordered from high to low priority. groups of the highest pending
+	 * priority always schedule their next chunks, lower priorities only when the threads would run out
+	 * of work, for example while the viewer waits for chunks of a single threaded group */
+	bool breaked = false;
+	while (!pendingGroups.empty() && !breaked) {
+		const CompositorPriority priority = pendingGroups[0]->getRenderPriotrity();
+		index = 0;
+		while (index < pendingGroups.size()) {
+			ExecutionGroup *group = pendingGroups[index];
+			if (group->getRenderPriotrity() != priority && !WorkScheduler::needsWork()) {
+				break;
+			}
+			if (group->executeNextChunks(this)) {
+				pendingGroups.erase(pendingGroups.begin() + index);
+			}
+			else {
+				index++;
+			}
+		}
+
+		WorkScheduler::finish();
+
+		if (editingtree->test_break && editingtree->test_break(editingtree->tbh)) {
+			breaked = true;
+		}
+		else {
+			releaseUnusedBuffers(cacheKeys);
+		}
+	}
+
+	for (index = 0; index < startedGroups.size(); index++) {
+		startedGroups[index]->endExecute(this);
 	}
 }
 
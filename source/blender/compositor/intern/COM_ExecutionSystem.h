@@ -30,8 +30,11 @@ class ExecutionGroup;
 #include "COM_Node.h"
 #include "BKE_text.h"
 #include "COM_ExecutionGroup.h"
+#include "COM_MemoryPlanner.h"
 #include "COM_NodeOperation.h"
 
+#include <map>
+
 /**
  * @page execution Execution model
  * In order to get to an efficient model for execution, several steps are being done. these steps are explained below.
@@ -131,6 +134,11 @@ private:
 	 */
 	Groups m_groups;
 
+	/**
+	 * @brief allocates and frees the buffers of the write buffers during execution
+	 */
+	MemoryPlanner m_memoryPlanner;
+
 private: //methods
 	/**
 	 * find all execution group with output nodes
@@ -174,8 +182,53 @@ public:
 	 */
 	const CompositorContext &getContext() const { return this->m_context; }
 
+	/**
+	 * @brief get the planner of the memory of the write buffers
+	 */
+	MemoryPlanner *getMemoryPlanner() { return &this->m_memoryPlanner; }
+
 private:
-	void executeGroups(CompositorPriority priority);
+	typedef std::map<NodeOperation *, uint64_t> CacheKeys;
+
+	/**
+	 * @brief execute output groups, interleaved by their priority
+	 * @param executionGroups the groups ordered from high to low priority
+	 * @param cacheKeys keys of the results to store in the ResultCache before their buffers are freed, or NULL
+	 */
+	void executeGroups(const vector<ExecutionGroup *> &executionGroups, CacheKeys *cacheKeys);
+
+	/**
+	 * @brief free the buffers that will not be read anymore
+	 */
+	void releaseUnusedBuffers(CacheKeys *cacheKeys);
+
+	/**
+	 * @brief determine the key of the result of an operation in the ResultCache
+	 * @note combines the operation with the keys of all operations it reads from, 0 when not cachable
+	 */
+	uint64_t determineCacheKey(NodeOperation *operation, CacheKeys &keys);
+
+	/**
+	 * @brief copy cached buffers into the write buffers and mark their groups as executed
+	 */
+	void restoreCachedResults(CacheKeys &keys);
+
+	/**
+	 * @brief store the completely calculated write buffer of a group in the ResultCache
+	 */
+	void storeCachedResult(ExecutionGroup *executionGroup, uint64_t contextKey, CacheKeys &keys);
+
+	/**
+	 * @brief store the completely calculated write buffers that are still allocated in the ResultCache
+	 */
+	void storeCachedResults(CacheKeys &keys);
+
+	/**
+	 * @brief store the time, memory and chunks of the executed groups in the nodes they were converted from
+	 * @note the time of a group is shared equally by the nodes of its operations,
+	 * the memory of a buffer is counted for the node that writes it
+	 */
+	void updateNodeStatistics();
 
 	/* allow the DebugInfo class to look at internals */
 	friend class DebugInfo;
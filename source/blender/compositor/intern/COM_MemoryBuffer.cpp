@@ -62,8 +62,8 @@ MemoryBuffer::MemoryBuffer(MemoryProxy *memoryProxy, unsigned int chunkNumber, r
 	this->m_memoryProxy = memoryProxy;
 	this->m_chunkNumber = chunkNumber;
 	this->m_num_channels = determine_num_channels(memoryProxy->getDataType());
-	this->m_buffer = (float *)MEM_mallocN_aligned(sizeof(float) * determineBufferSize() * this->m_num_channels, 16, "COM_MemoryBuffer");
-	this->m_state = COM_MB_ALLOCATED;
+	this->m_buffer = NULL;
+	this->m_state = COM_MB_UNALLOCATED;
 	this->m_datatype = memoryProxy->getDataType();
 }
 
@@ -142,6 +142,21 @@ float MemoryBuffer::getMaximumValue(rcti *rect)
 	}
 }
 
+void MemoryBuffer::assignBuffer(float *buffer)
+{
+	BLI_assert(this->m_buffer == NULL);
+	this->m_buffer = buffer;
+	this->m_state = COM_MB_ALLOCATED;
+}
+
+float *MemoryBuffer::releaseBuffer()
+{
+	float *buffer = this->m_buffer;
+	this->m_buffer = NULL;
+	this->m_state = COM_MB_UNALLOCATED;
+	return buffer;
+}
+
 MemoryBuffer::~MemoryBuffer()
 {
 	if (this->m_buffer) {
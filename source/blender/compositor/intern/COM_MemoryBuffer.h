@@ -39,6 +39,8 @@ extern "C" {
  * @ingroup Memory
  */
 typedef enum MemoryBufferState {
+	/** @brief buffer of a MemoryProxy, the memory is assigned by the MemoryPlanner when it is needed */
+	COM_MB_UNALLOCATED = 0,
 	/** @brief memory has been allocated on creator device and CPU machine, but kernel has not been executed */
 	COM_MB_ALLOCATED = 1,
 	/** @brief memory is available for use, content has been created */
@@ -104,6 +106,7 @@ private:
 public:
 	/**
 	 * @brief construct new MemoryBuffer for a chunk
+	 * @note the memory is not allocated, see assignBuffer
 	 */
 	MemoryBuffer(MemoryProxy *memoryProxy, unsigned int chunkNumber, rcti *rect);
 	
@@ -310,6 +313,28 @@ public:
 	
 	float getMaximumValue();
 	float getMaximumValue(rcti *rect);
+
+	/**
+	 * @brief the number of bytes needed for the data of this MemoryBuffer
+	 */
+	size_t getAllocationSize() { return sizeof(float) * determineBufferSize() * this->m_num_channels; }
+
+	/**
+	 * @brief is the memory of this MemoryBuffer available
+	 */
+	bool isAllocated() const { return this->m_buffer != NULL; }
+
+	/**
+	 * @brief use memory of at least getAllocationSize bytes, allocated with MEM_mallocN_aligned.
+	 * the MemoryBuffer owns the memory until it is released again
+	 */
+	void assignBuffer(float *buffer);
+
+	/**
+	 * @brief give up the memory of this MemoryBuffer so it can be reused
+	 * @return the memory, the caller is responsible for freeing it
+	 */
+	float *releaseBuffer();
 private:
 	unsigned int determineBufferSize();
 
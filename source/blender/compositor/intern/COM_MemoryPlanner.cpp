@@ -0,0 +1,188 @@
+/*
+ * Copyright 2017, Blender Foundation.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include <algorithm>
+
+#include "COM_MemoryPlanner.h"
+#include "COM_MemoryBuffer.h"
+#include "COM_ReadBufferOperation.h"
+#include "COM_WriteBufferOperation.h"
+
+#include "MEM_guardedalloc.h"
+
+/* released memory up to this much bigger than needed is reused */
+#define COM_MEMORY_PLANNER_REUSE_FACTOR 1.25
+
+MemoryPlanner::MemoryPlanner()
+{
+}
+
+MemoryPlanner::~MemoryPlanner()
+{
+	releaseAll();
+}
+
+static MemoryProxy *get_output_memory_proxy(ExecutionGroup *group)
+{
+	NodeOperation *operation = group->getOutputOperation();
+	if (operation->isWriteBufferOperation()) {
+		return ((WriteBufferOperation *)operation)->getMemoryProxy();
+	}
+	return NULL;
+}
+
+void MemoryPlanner::plan(const std::vector<ExecutionGroup *> &groups)
+{
+	m_readers.clear();
+	for (unsigned int index = 0; index < groups.size(); index++) {
+		ExecutionGroup *group = groups[index];
+		std::vector<MemoryProxy *> memoryProxies;
+		group->determineDependingMemoryProxies(&memoryProxies);
+
+		for (unsigned int proxyIndex = 0; proxyIndex < memoryProxies.size(); proxyIndex++) {
+			std::vector<ExecutionGroup *> &readers = m_readers[memoryProxies[proxyIndex]];
+			if (std::find(readers.begin(), readers.end(), group) == readers.end()) {
+				readers.push_back(group);
+			}
+		}
+	}
+}
+
+void MemoryPlanner::setActiveOutputs(const std::vector<ExecutionGroup *> &groups)
+{
+	m_activeOutputs.clear();
+	m_activeOutputs.insert(groups.begin(), groups.end());
+}
+
+void MemoryPlanner::acquire(MemoryProxy *memoryProxy)
+{
+	MemoryBuffer *buffer = memoryProxy->getBuffer();
+	if (buffer == NULL || buffer->isAllocated()) {
+		return;
+	}
+
+	const size_t size = buffer->getAllocationSize();
+	FreeBuffers::iterator it = m_freeBuffers.lower_bound(size);
+	float *memory;
+	size_t memorySize;
+
+	if (it != m_freeBuffers.end() && it->first <= size * COM_MEMORY_PLANNER_REUSE_FACTOR) {
+		memory = it->second;
+		memorySize = it->first;
+		m_freeBuffers.erase(it);
+	}
+	else {
+		/* nothing fits, don't keep the released memory around next to the new allocation */
+		freeUnusedMemory();
+		memory = (float *)MEM_mallocN_aligned(size, 16, "COM_MemoryBuffer");
+		memorySize = size;
+	}
+
+	buffer->assignBuffer(memory);
+	m_allocations[memoryProxy] = memorySize;
+}
+
+void MemoryPlanner::acquireBuffers(ExecutionGroup *group)
+{
+	MemoryProxy *outputProxy = get_output_memory_proxy(group);
+	if (outputProxy) {
+		acquire(outputProxy);
+	}
+
+	std::vector<MemoryProxy *> memoryProxies;
+	group->determineDependingMemoryProxies(&memoryProxies);
+	for (unsigned int index = 0; index < memoryProxies.size(); index++) {
+		acquire(memoryProxies[index]);
+	}
+}
+
+bool MemoryPlanner::isDone(ExecutionGroup *group, std::map<ExecutionGroup *, bool> &done)
+{
+	std::map<ExecutionGroup *, bool>::const_iterator it = done.find(group);
+	if (it != done.end()) {
+		return it->second;
+	}
+
+	bool result;
+	if (group->isExecuted()) {
+		result = true;
+	}
+	else if (group->isOutputExecutionGroup()) {
+		result = (m_activeOutputs.find(group) == m_activeOutputs.end());
+	}
+	else {
+		/* chunks of other groups are only scheduled for the groups reading them */
+		result = true;
+		MemoryProxy *outputProxy = get_output_memory_proxy(group);
+		if (outputProxy) {
+			const std::vector<ExecutionGroup *> &readers = m_readers[outputProxy];
+			for (unsigned int index = 0; index < readers.size() && result; index++) {
+				result = isDone(readers[index], done);
+			}
+		}
+	}
+
+	done[group] = result;
+	return result;
+}
+
+void MemoryPlanner::determineUnusedBuffers(std::vector<MemoryProxy *> *result)
+{
+	std::map<ExecutionGroup *, bool> done;
+	for (Allocations::const_iterator it = m_allocations.begin(); it != m_allocations.end(); ++it) {
+		MemoryProxy *memoryProxy = it->first;
+		const std::vector<ExecutionGroup *> &readers = m_readers[memoryProxy];
+		bool unused = true;
+		for (unsigned int index = 0; index < readers.size() && unused; index++) {
+			unused = isDone(readers[index], done);
+		}
+		if (unused) {
+			result->push_back(memoryProxy);
+		}
+	}
+}
+
+void MemoryPlanner::release(MemoryProxy *memoryProxy)
+{
+	Allocations::iterator it = m_allocations.find(memoryProxy);
+	if (it == m_allocations.end()) {
+		return;
+	}
+
+	float *memory = memoryProxy->getBuffer()->releaseBuffer();
+	m_freeBuffers.insert(std::pair<size_t, float *>(it->second, memory));
+	m_allocations.erase(it);
+}
+
+void MemoryPlanner::freeUnusedMemory()
+{
+	for (FreeBuffers::iterator it = m_freeBuffers.begin(); it != m_freeBuffers.end(); ++it) {
+		MEM_freeN(it->second);
+	}
+	m_freeBuffers.clear();
+}
+
+void MemoryPlanner::releaseAll()
+{
+	while (!m_allocations.empty()) {
+		release(m_allocations.begin()->first);
+	}
+	freeUnusedMemory();
+}
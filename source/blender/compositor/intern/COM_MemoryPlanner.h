@@ -0,0 +1,120 @@
+/*
+ * Copyright 2017, Blender Foundation.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef _COM_MemoryPlanner_h
+#define _COM_MemoryPlanner_h
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "COM_ExecutionGroup.h"
+#include "COM_MemoryProxy.h"
+
+/**
+ * @brief Decides when the buffers of the MemoryProxy's are allocated and freed during an execution.
+ *
+ * The buffer of a MemoryProxy is allocated when the first chunk that writes or reads it is scheduled, and is
+ * released as soon as every ExecutionGroup reading it is done. A group is done when all its chunks are executed,
+ * or when nothing that reads the group itself will schedule any more of its chunks.
+ * For example a glare node needing its whole input lets the buffers before its input be freed once that input
+ * is calculated, instead of keeping every intermediate image of the tree alive until the end.
+ *
+ * Released memory is reused for buffers of the same or a slightly smaller size, the other released memory is
+ * freed before new memory is allocated so the peak memory usage stays low.
+ * @note the planner is only used from the main thread, when no chunks are being executed.
+ * @see ExecutionSystem.executeGroups
+ * @ingroup Memory
+ */
+class MemoryPlanner {
+private:
+	typedef std::multimap<size_t, float *> FreeBuffers;
+	typedef std::map<MemoryProxy *, size_t> Allocations;
+	typedef std::map<MemoryProxy *, std::vector<ExecutionGroup *> > Readers;
+
+	/**
+	 * @brief the groups reading each MemoryProxy
+	 */
+	Readers m_readers;
+
+	/**
+	 * @brief output groups that are being executed, the others will not schedule chunks
+	 */
+	std::set<ExecutionGroup *> m_activeOutputs;
+
+	/**
+	 * @brief MemoryProxy's with memory assigned, and the size of that memory
+	 */
+	Allocations m_allocations;
+
+	/**
+	 * @brief released memory that isn't reused yet, by its size
+	 */
+	FreeBuffers m_freeBuffers;
+
+	bool isDone(ExecutionGroup *group, std::map<ExecutionGroup *, bool> &done);
+	void acquire(MemoryProxy *memoryProxy);
+	void freeUnusedMemory();
+
+public:
+	MemoryPlanner();
+	~MemoryPlanner();
+
+	/**
+	 * @brief determine the readers of the MemoryProxy's, after the groups are initialized
+	 */
+	void plan(const std::vector<ExecutionGroup *> &groups);
+
+	/**
+	 * @brief set the output groups that are going to be executed
+	 */
+	void setActiveOutputs(const std::vector<ExecutionGroup *> &groups);
+
+	/**
+	 * @brief make sure the buffers written and read by a chunk of the group are allocated
+	 */
+	void acquireBuffers(ExecutionGroup *group);
+
+	/**
+	 * @brief make sure the buffer of a MemoryProxy is allocated, for example to restore a cached result
+	 */
+	void acquireBuffer(MemoryProxy *memoryProxy) { acquire(memoryProxy); }
+
+	/**
+	 * @brief find the allocated MemoryProxy's that will not be read anymore
+	 */
+	void determineUnusedBuffers(std::vector<MemoryProxy *> *result);
+
+	/**
+	 * @brief release the buffer of a MemoryProxy, its memory can be reused by other buffers
+	 */
+	void release(MemoryProxy *memoryProxy);
+
+	/**
+	 * @brief release and free all memory
+	 */
+	void releaseAll();
+
+#ifdef WITH_CXX_GUARDEDALLOC
+	MEM_CXX_CLASS_ALLOC_FUNCS("COM:MemoryPlanner")
+#endif
+};
+
+#endif
@@ -27,6 +27,7 @@ MemoryProxy::MemoryProxy(DataType datatype)
 {
 	this->m_writeBufferOperation = NULL;
 	this->m_executor = NULL;
+	this->m_buffer = NULL;
 	this->m_datatype = datatype;
 }
 
@@ -95,7 +95,8 @@ public:
 	WriteBufferOperation *getWriteBufferOperation() { return this->m_writeBufferOperation; }
 
 	/**
-	 * @brief allocate memory of size width x height
+	 * @brief create the buffer of size width x height
+	 * @note its memory is assigned by the MemoryPlanner when the buffer is needed
 	 */
 	void allocate(unsigned int width, unsigned int height);
 
@@ -101,7 +101,8 @@ private:
 
 	/**
 	 * @brief can this operation be scheduled on an OpenCL device.
-	 * @note Only applicable if complex is True
+	 * @note complex operations are executed on their own, others as part of a chain
+	 * @see OpenCLDevice.COM_clAttachInputToKernelParameter
 	 */
 	bool m_openCL;
 
@@ -125,6 +126,19 @@ private:
 	 * @brief set to truth when resolution for this operation is set
 	 */
 	bool m_isResolutionSet;
+
+	/**
+	 * @brief hash of the node settings this operation was created from
+	 * @note 0 when the result of this operation can't be cached
+	 * @see ResultCache
+	 */
+	uint64_t m_cacheHash;
+
+	/**
+	 * @brief the node of the editor this operation was converted from, used for statistics
+	 * @note NULL for operations that were added for the execution, like conversions
+	 */
+	bNode *m_editorNode;
 	
 public:
 	virtual ~NodeOperation();
@@ -166,6 +180,12 @@ public:
 	virtual int isSingleThreaded() { return false; }
 
 	void setbNodeTree(const bNodeTree *tree) { this->m_btree = tree; }
+
+	void setCacheHash(uint64_t hash) { this->m_cacheHash = hash; }
+	uint64_t getCacheHash() const { return this->m_cacheHash; }
+
+	void setEditorNode(bNode *node) { this->m_editorNode = node; }
+	bNode *getEditorNode() const { return this->m_editorNode; }
 	virtual void initExecution();
 	
 	/**
@@ -37,6 +37,7 @@ extern "C" {
 #include "COM_SetColorOperation.h"
 #include "COM_SocketProxyOperation.h"
 #include "COM_ReadBufferOperation.h"
+#include "COM_ResultCache.h"
 #include "COM_WriteBufferOperation.h"
 #include "COM_ViewerOperation.h"
 
@@ -45,6 +46,7 @@ extern "C" {
 NodeOperationBuilder::NodeOperationBuilder(const CompositorContext *context, bNodeTree *b_nodetree) :
     m_context(context),
     m_current_node(NULL),
+    m_current_node_operations(0),
     m_active_viewer(NULL)
 {
 	m_graph.from_bNodeTree(*context, b_nodetree);
@@ -63,6 +65,7 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
 		Node *node = (Node *)m_graph.nodes()[index];
 		
 		m_current_node = node;
+		m_current_node_operations = 0;
 		
 		DebugInfo::node_to_operations(node);
 		node->convertToOperations(converter, *m_context);
@@ -112,6 +115,9 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
 	/* surround complex ops with read/write buffer */
 	add_complex_operation_buffers();
 	
+	/* separate chains of OpenCL operations from the others */
+	add_opencl_operation_buffers();
+	
 	/* links not available from here on */
 	/* XXX make m_links a local variable to avoid confusion! */
 	m_links.clear();
@@ -130,6 +136,14 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
 
 void NodeOperationBuilder::addOperation(NodeOperation *operation)
 {
+	if (m_current_node) {
+		operation->setCacheHash(ResultCache::hashNodeOperation(m_current_node->getbNode(),
+		                                                       m_current_node_operations++, operation));
+		operation->setEditorNode(m_current_node->getbNode());
+	}
+	else {
+		operation->setCacheHash(ResultCache::hashOperation(operation));
+	}
 	m_operations.push_back(operation);
 }
 
@@ -479,6 +493,7 @@ void NodeOperationBuilder::add_input_buffers(NodeOperation * /*operation*/,
 	if (!writeoperation) {
 		writeoperation = new WriteBufferOperation(output->getDataType());
 		writeoperation->setbNodeTree(m_context->getbNodeTree());
+		writeoperation->setEditorNode(output->getOperation().getEditorNode());
 		addOperation(writeoperation);
 		
 		addLink(output, writeoperation->getInputSocket(0));
@@ -522,6 +537,7 @@ void NodeOperationBuilder::add_output_buffers(NodeOperation *operation, NodeOper
 	if (!writeOperation) {
 		writeOperation = new WriteBufferOperation(operation->getOutputSocket()->getDataType());
 		writeOperation->setbNodeTree(m_context->getbNodeTree());
+		writeOperation->setEditorNode(operation->getEditorNode());
 		addOperation(writeOperation);
 		
 		addLink(output, writeOperation->getInputSocket(0));
@@ -545,6 +561,31 @@ void NodeOperationBuilder::add_output_buffers(NodeOperation *operation, NodeOper
 	}
 }
 
+void NodeOperationBuilder::add_opencl_operation_buffers()
+{
+	if (!m_context->getHasActiveOpenCLDevices())
+		return;
+	
+	/* buffer every link between an OpenCL and a CPU operation, so the chains of
+	 * OpenCL operations end up in execution groups of their own that run on the device.
+	 * note: links get cached first, since adding buffers modifies m_links
+	 */
+	Links links = m_links;
+	for (Links::const_iterator it = links.begin(); it != links.end(); ++it) {
+		const Link &link = *it;
+		NodeOperation &from = link.from()->getOperation();
+		NodeOperation &to = link.to()->getOperation();
+		
+		/* buffer operations are group boundaries already,
+		 * constants are read directly by the OpenCL operations */
+		if (from.isReadBufferOperation() || to.isWriteBufferOperation() || from.isSetOperation())
+			continue;
+		
+		if (from.isOpenCL() != to.isOpenCL())
+			add_input_buffers(&to, link.to());
+	}
+}
+
 void NodeOperationBuilder::add_complex_operation_buffers()
 {
 	/* note: complex ops and get cached here first, since adding operations
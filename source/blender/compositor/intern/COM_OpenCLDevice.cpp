@@ -23,6 +23,8 @@
 #include "COM_OpenCLDevice.h"
 #include "COM_WorkScheduler.h"
 
+#include "PIL_time.h"
+
 typedef enum COM_VendorID  {NVIDIA = 0x10DE, AMD = 0x1002} COM_VendorID;
 const cl_image_format IMAGE_FORMAT_COLOR = {
 	CL_RGBA,
@@ -64,6 +66,7 @@ void OpenCLDevice::execute(WorkPackage *work)
 {
 	const unsigned int chunkNumber = work->getChunkNumber();
 	ExecutionGroup *executionGroup = work->getExecutionGroup();
+	const double start = PIL_check_seconds_timer();
 	rcti rect;
 
 	executionGroup->determineChunkRect(&rect, chunkNumber);
@@ -75,6 +78,7 @@ void OpenCLDevice::execute(WorkPackage *work)
 
 	delete outputBuffer;
 	
+	executionGroup->addExecutionTime(PIL_check_seconds_timer() - start);
 	executionGroup->finalizeChunkExecution(chunkNumber, inputBuffers);
 }
 cl_mem OpenCLDevice::COM_clAttachMemoryBufferToKernelParameter(cl_kernel kernel, int parameterIndex, int offsetIndex,
@@ -124,6 +128,54 @@ cl_mem OpenCLDevice::COM_clAttachMemoryBufferToKernelParameter(cl_kernel kernel,
 	return clBuffer;
 }
 
+cl_mem OpenCLDevice::COM_clAttachInputToKernelParameter(cl_kernel kernel, int parameterIndex, int offsetIndex,
+                                                        list<cl_mem> *cleanup, list<cl_kernel> *clKernelsToCleanUp,
+                                                        MemoryBuffer **inputMemoryBuffers, MemoryBuffer *outputMemoryBuffer,
+                                                        SocketReader *reader)
+{
+	NodeOperation *operation = (NodeOperation *)reader;
+	cl_int error;
+	cl_mem clBuffer;
+
+	if (operation->isReadBufferOperation()) {
+		return COM_clAttachMemoryBufferToKernelParameter(kernel, parameterIndex, offsetIndex, cleanup,
+		                                                 inputMemoryBuffers, (ReadBufferOperation *)operation);
+	}
+	else if (operation->isSetOperation()) {
+		/* the sampler clamps to the edge, so a single pixel is read everywhere */
+		float color[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+		operation->readSampled(color, 0.0f, 0.0f, COM_PS_NEAREST);
+		clBuffer = clCreateImage2D(this->m_context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, &IMAGE_FORMAT_COLOR,
+		                           1, 1, 0, color, &error);
+	}
+	else {
+		/* the input is part of the chain, execute it into an image that stays on the device */
+		clBuffer = clCreateImage2D(this->m_context, CL_MEM_READ_WRITE, &IMAGE_FORMAT_COLOR,
+		                           outputMemoryBuffer->getWidth(), outputMemoryBuffer->getHeight(), 0, NULL, &error);
+		if (error == CL_SUCCESS) {
+			operation->executeOpenCL(this, outputMemoryBuffer, clBuffer, inputMemoryBuffers, cleanup, clKernelsToCleanUp);
+		}
+	}
+
+	if (error != CL_SUCCESS) { printf("CLERROR[%d]: %s\n", error, clewErrorString(error));  }
+	if (error == CL_SUCCESS) cleanup->push_back(clBuffer);
+
+	error = clSetKernelArg(kernel, parameterIndex, sizeof(cl_mem), &clBuffer);
+	if (error != CL_SUCCESS) { printf("CLERROR[%d]: %s\n", error, clewErrorString(error));  }
+
+	if (operation->isSetOperation()) {
+		if (offsetIndex != -1) {
+			cl_int2 offset = {{0, 0}};
+			error = clSetKernelArg(kernel, offsetIndex, sizeof(cl_int2), &offset);
+			if (error != CL_SUCCESS) { printf("CLERROR[%d]: %s\n", error, clewErrorString(error));  }
+		}
+	}
+	else {
+		COM_clAttachMemoryBufferOffsetToKernelParameter(kernel, offsetIndex, outputMemoryBuffer);
+	}
+	return clBuffer;
+}
+
 void OpenCLDevice::COM_clAttachMemoryBufferOffsetToKernelParameter(cl_kernel kernel, int offsetIndex, MemoryBuffer *memoryBuffer)
 {
 	if (offsetIndex != -1) {
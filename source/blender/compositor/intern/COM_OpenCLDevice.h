@@ -106,6 +106,16 @@ public:
 
 	cl_mem COM_clAttachMemoryBufferToKernelParameter(cl_kernel kernel, int parameterIndex, int offsetIndex, list<cl_mem> *cleanup, MemoryBuffer **inputMemoryBuffers, SocketReader *reader);
 	cl_mem COM_clAttachMemoryBufferToKernelParameter(cl_kernel kernel, int parameterIndex, int offsetIndex, list<cl_mem> *cleanup, MemoryBuffer **inputMemoryBuffers, ReadBufferOperation *reader);
+	/**
+	 * @brief attach the result of an input of a chain of OpenCL operations to a kernel
+	 * Buffered inputs are uploaded, constants become a single pixel and all other
+	 * operations are executed into an image on the device, so the intermediate
+	 * results of the chain don't travel back to host memory.
+	 */
+	cl_mem COM_clAttachInputToKernelParameter(cl_kernel kernel, int parameterIndex, int offsetIndex,
+	                                          list<cl_mem> *cleanup, list<cl_kernel> *clKernelsToCleanUp,
+	                                          MemoryBuffer **inputMemoryBuffers, MemoryBuffer *outputMemoryBuffer,
+	                                          SocketReader *reader);
 	void COM_clAttachMemoryBufferOffsetToKernelParameter(cl_kernel kernel, int offsetIndex, MemoryBuffer *memoryBuffers);
 	void COM_clAttachOutputMemoryBufferToKernelParameter(cl_kernel kernel, int parameterIndex, cl_mem clOutputMemoryBuffer);
 	void COM_clAttachSizeToKernelParameter(cl_kernel kernel, int offsetIndex, NodeOperation *operation);
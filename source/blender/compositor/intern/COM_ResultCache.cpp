@@ -0,0 +1,258 @@
+/*
+ * Copyright 2017, Blender Foundation.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include <typeinfo>
+#include <string.h>
+
+#include "COM_ResultCache.h"
+#include "COM_NodeOperation.h"
+
+extern "C" {
+#include "DNA_ID.h"
+#include "DNA_node_types.h"
+#include "MEM_guardedalloc.h"
+}
+
+ResultCache::Entries ResultCache::s_entries;
+unsigned int ResultCache::s_generation = 0;
+
+uint64_t ResultCache::hash(uint64_t hash, const void *data, size_t size)
+{
+	/* FNV-1a */
+	const unsigned char *bytes = (const unsigned char *)data;
+	for (size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return (hash == 0) ? 1 : hash;
+}
+
+uint64_t ResultCache::combine(uint64_t hash, uint64_t other)
+{
+	if (hash == 0 || other == 0) {
+		return 0;
+	}
+	return ResultCache::hash(hash, &other, sizeof(other));
+}
+
+uint64_t ResultCache::hashOperation(NodeOperation *operation)
+{
+	const char *name = typeid(*operation).name();
+	return hash(14695981039346656037ULL, name, strlen(name));
+}
+
+static uint64_t hash_allocated(uint64_t hash, const void *data)
+{
+	if (data == NULL) {
+		return hash;
+	}
+	return ResultCache::hash(hash, data, MEM_allocN_len(data));
+}
+
+uint64_t ResultCache::hashNodeOperation(bNode *node, int index, NodeOperation *operation)
+{
+	uint64_t result = hash(hashOperation(operation), &index, sizeof(index));
+	if (node == NULL) {
+		return result;
+	}
+
+	/* images, movie clips, masks and textures can change without the node tree being edited,
+	 * render results of the scene are handled by clearing the cache when rendering */
+	if (node->id && GS(node->id->name) != ID_SCE) {
+		return 0;
+	}
+
+	result = hash(result, &node->type, sizeof(node->type));
+	result = hash(result, &node->id, sizeof(node->id));
+	result = hash(result, &node->custom1, sizeof(node->custom1));
+	result = hash(result, &node->custom2, sizeof(node->custom2));
+	result = hash(result, &node->custom3, sizeof(node->custom3));
+	result = hash(result, &node->custom4, sizeof(node->custom4));
+	/* curve mappings keep a timestamp of their last change in the storage */
+	result = hash_allocated(result, node->storage);
+
+	/* nodes read unconnected inputs directly, value and color nodes store their value in the output */
+	for (bNodeSocket *sock = (bNodeSocket *)node->inputs.first; sock; sock = sock->next) {
+		result = hash_allocated(result, sock->default_value);
+	}
+	for (bNodeSocket *sock = (bNodeSocket *)node->outputs.first; sock; sock = sock->next) {
+		result = hash_allocated(result, sock->default_value);
+	}
+	return result;
+}
+
+static unsigned short float_to_half(float value)
+{
+	union { float f; unsigned int i; } bits;
+	bits.f = value;
+
+	const unsigned short sign = (bits.i >> 16) & 0x8000;
+	const int exponent = (int)((bits.i >> 23) & 0xff) - 127 + 15;
+	unsigned int mantissa = bits.i & 0x7fffff;
+	unsigned int half, rest, halfway;
+
+	if (((bits.i >> 23) & 0xff) == 0xff) {
+		/* infinity and nan */
+		return sign | 0x7c00 | (mantissa ? 0x200 : 0);
+	}
+	else if (exponent >= 31) {
+		return sign | 0x7c00;
+	}
+	else if (exponent <= 0) {
+		/* denormal, or too small */
+		if (exponent < -10) {
+			return sign;
+		}
+		const int shift = 14 - exponent;
+		mantissa |= 0x800000;
+		half = mantissa >> shift;
+		rest = mantissa & ((1u << shift) - 1);
+		halfway = 1u << (shift - 1);
+	}
+	else {
+		half = ((unsigned int)exponent << 10) | (mantissa >> 13);
+		rest = mantissa & 0x1fff;
+		halfway = 0x1000;
+	}
+
+	/* round to nearest even, a carry into the exponent rounds up to the next power of two or infinity */
+	if (rest > halfway || (rest == halfway && (half & 1))) {
+		half++;
+	}
+	return sign | (unsigned short)half;
+}
+
+static float half_to_float(unsigned short half)
+{
+	union { float f; unsigned int i; } bits;
+	const unsigned int sign = (unsigned int)(half & 0x8000) << 16;
+	const unsigned int exponent = (half >> 10) & 0x1f;
+	const unsigned int mantissa = half & 0x3ff;
+
+	if (exponent == 0x1f) {
+		bits.i = sign | 0x7f800000 | (mantissa << 13);
+	}
+	else if (exponent != 0) {
+		bits.i = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+	}
+	else {
+		/* denormal, times 2^-24 */
+		bits.f = mantissa * (1.0f / 16777216.0f);
+		bits.i |= sign;
+	}
+	return bits.f;
+}
+
+void ResultCache::freeEntry(Entry &entry)
+{
+	if (entry.buffer) {
+		delete entry.buffer;
+	}
+	if (entry.halfs) {
+		MEM_freeN(entry.halfs);
+	}
+}
+
+void ResultCache::beginExecution()
+{
+	s_generation++;
+}
+
+void ResultCache::endExecution()
+{
+	Entries::iterator it = s_entries.begin();
+	while (it != s_entries.end()) {
+		if (it->second.generation + 1 < s_generation) {
+			freeEntry(it->second);
+			s_entries.erase(it++);
+		}
+		else {
+			++it;
+		}
+	}
+}
+
+bool ResultCache::restore(uint64_t key, MemoryBuffer *buffer)
+{
+	Entries::iterator it = s_entries.find(key);
+	if (it == s_entries.end()) {
+		return false;
+	}
+
+	Entry &entry = it->second;
+	if (!BLI_rcti_compare(&entry.rect, buffer->getRect()) ||
+	    entry.num_channels != buffer->get_num_channels())
+	{
+		return false;
+	}
+
+	if (entry.buffer) {
+		buffer->copyContentFrom(entry.buffer);
+	}
+	else {
+		const size_t size = buffer->getAllocationSize() / sizeof(float);
+		float *values = buffer->getBuffer();
+		for (size_t i = 0; i < size; i++) {
+			values[i] = half_to_float(entry.halfs[i]);
+		}
+	}
+	entry.generation = s_generation;
+	return true;
+}
+
+void ResultCache::store(uint64_t key, MemoryProxy *memoryProxy, bool use_half)
+{
+	Entries::iterator it = s_entries.find(key);
+	if (it != s_entries.end()) {
+		it->second.generation = s_generation;
+		return;
+	}
+
+	MemoryBuffer *buffer = memoryProxy->getBuffer();
+	Entry entry;
+	entry.rect = *buffer->getRect();
+	entry.num_channels = buffer->get_num_channels();
+	entry.generation = s_generation;
+
+	/* values and vectors are often depths and coordinates, which need the precision */
+	if (use_half && memoryProxy->getDataType() == COM_DT_COLOR) {
+		const size_t size = buffer->getAllocationSize() / sizeof(float);
+		const float *values = buffer->getBuffer();
+		entry.buffer = NULL;
+		entry.halfs = (unsigned short *)MEM_mallocN(sizeof(unsigned short) * size, "COM_ResultCache halfs");
+		for (size_t i = 0; i < size; i++) {
+			entry.halfs[i] = float_to_half(values[i]);
+		}
+	}
+	else {
+		entry.buffer = new MemoryBuffer(memoryProxy->getDataType(), buffer->getRect());
+		entry.buffer->copyContentFrom(buffer);
+		entry.halfs = NULL;
+	}
+	s_entries[key] = entry;
+}
+
+void ResultCache::clear()
+{
+	for (Entries::iterator it = s_entries.begin(); it != s_entries.end(); ++it) {
+		freeEntry(it->second);
+	}
+	s_entries.clear();
+}
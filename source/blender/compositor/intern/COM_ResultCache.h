@@ -0,0 +1,125 @@
+/*
+ * Copyright 2017, Blender Foundation.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef _COM_ResultCache_h
+#define _COM_ResultCache_h
+
+#include <map>
+
+#include "BLI_sys_types.h"
+
+#include "COM_MemoryBuffer.h"
+#include "COM_MemoryProxy.h"
+
+struct bNode;
+class NodeOperation;
+
+/**
+ * @brief Cache of the buffers written by WriteBufferOperation's, kept between executions.
+ *
+ * When editing, nodes upstream of the edited node produce the same results as in the previous execution.
+ * Every WriteBufferOperation gets a key from its own settings and the keys of everything it reads,
+ * execution groups of which the key is found get their buffer copied from the cache and are not executed,
+ * so only the part of the tree downstream of a change is calculated again.
+ *
+ * A key of 0 means that the result can not be cached, for example when it depends on an image which can
+ * change without the node tree being edited.
+ *
+ * Buffers that were not used by the last two executions are freed, the second one counts so the fast
+ * and the full pass of two-pass compositing don't evict each other.
+ *
+ * Color buffers can be stored as half floats to use half the memory, at the cost of precision.
+ * @note the cache is only used while editing, and is accessed with the compositor mutex locked.
+ * @see ExecutionSystem.execute
+ * @ingroup Execution
+ */
+class ResultCache {
+private:
+	struct Entry {
+		/* values of the buffer, either as floats or as half floats */
+		MemoryBuffer *buffer;
+		unsigned short *halfs;
+		rcti rect;
+		unsigned int num_channels;
+		unsigned int generation;
+	};
+	typedef std::map<uint64_t, Entry> Entries;
+
+	static Entries s_entries;
+	static unsigned int s_generation;
+
+	static void freeEntry(Entry &entry);
+
+public:
+	/**
+	 * @brief combine a hash with arbitrary data, never returns 0
+	 */
+	static uint64_t hash(uint64_t hash, const void *data, size_t size);
+
+	/**
+	 * @brief combine two hashes, 0 is propagated so uncachable results stay uncachable
+	 */
+	static uint64_t combine(uint64_t hash, uint64_t other);
+
+	/**
+	 * @brief hash of a NodeOperation created without a node, only depends on its class
+	 */
+	static uint64_t hashOperation(NodeOperation *operation);
+
+	/**
+	 * @brief hash of the index'th NodeOperation created for a node
+	 * @return 0 when the node depends on data outside of the node tree
+	 */
+	static uint64_t hashNodeOperation(bNode *node, int index, NodeOperation *operation);
+
+	/**
+	 * @brief start a new execution, entries used from now on are kept
+	 */
+	static void beginExecution();
+
+	/**
+	 * @brief free the entries that were not used by this and the previous execution
+	 */
+	static void endExecution();
+
+	/**
+	 * @brief is a buffer with this key cached
+	 */
+	static bool contains(uint64_t key) { return s_entries.find(key) != s_entries.end(); }
+
+	/**
+	 * @brief copy the cached buffer with this key into buffer
+	 * @return true when the buffer was found and copied
+	 */
+	static bool restore(uint64_t key, MemoryBuffer *buffer);
+
+	/**
+	 * @brief store a copy of the completely calculated buffer of a MemoryProxy
+	 * @param use_half store color buffers as half floats
+	 */
+	static void store(uint64_t key, MemoryProxy *memoryProxy, bool use_half);
+
+	/**
+	 * @brief free all cached buffers
+	 */
+	static void clear();
+};
+
+#endif
@@ -95,6 +95,22 @@ protected:
 	                                  float /*x*/, float /*y*/,
 	                                  float /*dx*/[2], float /*dy*/[2]) {}
 
+	/**
+	 * @brief calculate a row of pixels with nearest sampling
+	 * @note this method is called for non-complex. operations which only need
+	 * the pixel at the same position of their inputs override it with a loop
+	 * over whole rows, instead of a virtual call per pixel per operation.
+	 * @param output is a float[4 * width] array to store the result, a pixel per 4 floats
+	 * @param x the x-coordinate of the first pixel to calculate in image space
+	 * @param y the y-coordinate of the row to calculate in image space
+	 * @param width the number of pixels to calculate, at most COM_ROW_PIXELS
+	 */
+	virtual void executeRowSampled(float *output, int x, int y, int width) {
+		for (int i = 0; i < width; i++) {
+			executePixelSampled(&output[i * 4], x + i, y, COM_PS_NEAREST);
+		}
+	}
+
 public:
 	inline void readSampled(float result[4], float x, float y, PixelSampler sampler) {
 		executePixelSampled(result, x, y, sampler);
@@ -105,6 +121,9 @@ public:
 	inline void readFiltered(float result[4], float x, float y, float dx[2], float dy[2]) {
 		executePixelFiltered(result, x, y, dx, dy);
 	}
+	inline void readRow(float *result, int x, int y, int width) {
+		executeRowSampled(result, x, y, width);
+	}
 
 	virtual void *initializeTileData(rcti * /*rect*/) { return 0; }
 	virtual void deinitializeTileData(rcti * /*rect*/, void * /*data*/) {}
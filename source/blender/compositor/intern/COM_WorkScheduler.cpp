@@ -21,6 +21,7 @@
  */
 
 #include <list>
+#include <queue>
 #include <stdio.h>
 
 #include "COM_compositor.h"
@@ -59,6 +60,28 @@ static ListBase g_cputhreads;
 static bool g_cpuInitialized = false;
 /// @brief all scheduled work for the cpu
 static ThreadQueue *g_cpuqueue;
+
+/**
+ * @brief work for the cpu in the order it will be taken by the threads
+ * every push in g_cpuqueue adds a package here, when a thread pops from g_cpuqueue it takes the package with the
+ * highest priority. within a priority the scheduling order is kept, so the chunks around the hotspot of the viewer
+ * are calculated first and neighbouring chunks are calculated at the same time.
+ */
+struct CPUPackage {
+	WorkPackage *package;
+	CompositorPriority priority;
+	unsigned int order;
+
+	bool operator<(const CPUPackage &other) const
+	{
+		if (priority != other.priority)
+			return priority < other.priority;
+		return order > other.order;
+	}
+};
+static std::priority_queue<CPUPackage> g_cpupackages;
+static ThreadMutex g_cpupackages_mutex = BLI_MUTEX_INITIALIZER;
+static unsigned int g_cpupackages_order = 0;
 static ThreadQueue *g_gpuqueue;
 #ifdef COM_OPENCL_ENABLED
 static cl_context g_context;
@@ -79,10 +102,18 @@ static bool g_openclInitialized = false;
 void *WorkScheduler::thread_execute_cpu(void *data)
 {
 	CPUDevice *device = (CPUDevice *)data;
-	WorkPackage *work;
 	BLI_thread_local_set(g_thread_device, device);
-	while ((work = (WorkPackage *)BLI_thread_queue_pop(g_cpuqueue))) {
-		device->execute(work);
+	while (BLI_thread_queue_pop(g_cpuqueue)) {
+		BLI_mutex_lock(&g_cpupackages_mutex);
+		WorkPackage *work = g_cpupackages.top().package;
+		g_cpupackages.pop();
+		BLI_mutex_unlock(&g_cpupackages_mutex);
+
+		/* skip stale work when the execution is breaked, for example by a new edit,
+		 * instead of starting every chunk that is still queued */
+		if (!work->getExecutionGroup()->getOutputOperation()->isBreaked()) {
+			device->execute(work);
+		}
 		delete work;
 	}
 	
@@ -101,14 +132,30 @@ void *WorkScheduler::thread_execute_gpu(void *data)
 	
 	return NULL;
 }
+
+void WorkScheduler::push_cpu(WorkPackage *package, CompositorPriority priority)
+{
+	CPUPackage entry;
+	entry.package = package;
+	entry.priority = priority;
+
+	BLI_mutex_lock(&g_cpupackages_mutex);
+	entry.order = g_cpupackages_order++;
+	g_cpupackages.push(entry);
+	BLI_mutex_unlock(&g_cpupackages_mutex);
+
+	/* the queue is only used to wake up the threads and wait for them, the package pushed is not used */
+	BLI_thread_queue_push(g_cpuqueue, package);
+}
 #endif
 
 
 
-void WorkScheduler::schedule(ExecutionGroup *group, int chunkNumber)
+void WorkScheduler::schedule(ExecutionGroup *group, int chunkNumber, CompositorPriority priority)
 {
 	WorkPackage *package = new WorkPackage(group, chunkNumber);
 #if COM_CURRENT_THREADING_MODEL == COM_TM_NOTHREAD
+	(void)priority;
 	CPUDevice device(0);
 	device.execute(package);
 	delete package;
@@ -118,14 +165,26 @@ void WorkScheduler::schedule(ExecutionGroup *group, int chunkNumber)
 		BLI_thread_queue_push(g_gpuqueue, package);
 	}
 	else {
-		BLI_thread_queue_push(g_cpuqueue, package);
+		push_cpu(package, priority);
 	}
 #else
-	BLI_thread_queue_push(g_cpuqueue, package);
+	push_cpu(package, priority);
 #endif
 #endif
 }
 
+bool WorkScheduler::needsWork()
+{
+#if COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
+	BLI_mutex_lock(&g_cpupackages_mutex);
+	const bool result = g_cpupackages.size() < g_cpudevices.size();
+	BLI_mutex_unlock(&g_cpupackages_mutex);
+	return result;
+#else
+	return true;
+#endif
+}
+
 void WorkScheduler::start(CompositorContext &context)
 {
 #if COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
@@ -175,6 +234,10 @@ void WorkScheduler::stop()
 	BLI_end_threads(&g_cputhreads);
 	BLI_thread_queue_free(g_cpuqueue);
 	g_cpuqueue = NULL;
+	while (!g_cpupackages.empty()) {
+		delete g_cpupackages.top().package;
+		g_cpupackages.pop();
+	}
 #ifdef COM_OPENCL_ENABLED
 	if (g_openclActive) {
 		BLI_thread_queue_nowait(g_gpuqueue);
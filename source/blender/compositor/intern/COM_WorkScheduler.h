@@ -53,6 +53,11 @@ class WorkScheduler {
 	 * inside this loop new work is queried and being executed
 	 */
 	static void *thread_execute_gpu(void *data);
+
+	/**
+	 * @brief add a package to the work of the cpudevices
+	 */
+	static void push_cpu(WorkPackage *package, CompositorPriority priority);
 #endif	
 public:
 	/**
@@ -60,11 +65,18 @@ public:
 	 * An execution group schedules a chunk in the WorkScheduler
 	 * when ExecutionGroup.isOpenCL is set the work will be handled by a OpenCLDevice
 	 * otherwise the work is scheduled for an CPUDevice
-	 * @see ExecutionGroup.execute
+	 * @see ExecutionGroup.executeNextChunks
 	 * @param group the execution group
 	 * @param chunkNumber the number of the chunk in the group to be executed
+	 * @param priority the chunks with the highest priority are executed first
+	 */
+	static void schedule(ExecutionGroup *group, int chunkNumber, CompositorPriority priority);
+
+	/**
+	 * @brief are less chunks waiting for the cpu than there are cpudevices
+	 * @note used to schedule lower priority work only when the threads will run out of work
 	 */
-	static void schedule(ExecutionGroup *group, int chunkNumber);
+	static bool needsWork();
 
 	/**
 	 * @brief initialize the WorkScheduler
@@ -33,6 +33,7 @@ extern "C" {
 #include "COM_compositor.h"
 #include "COM_ExecutionSystem.h"
 #include "COM_WorkScheduler.h"
+#include "COM_ResultCache.h"
 #include "clew.h"
 #include "COM_MovieDistortionOperation.h"
 
@@ -103,6 +104,7 @@ void COM_deinitialize()
 {
 	if (is_compositorMutex_init) {
 		BLI_mutex_lock(&s_compositorMutex);
+		ResultCache::clear();
 		WorkScheduler::deinitialize();
 		is_compositorMutex_init = false;
 		BLI_mutex_unlock(&s_compositorMutex);
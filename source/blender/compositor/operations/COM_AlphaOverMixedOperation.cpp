@@ -55,3 +55,37 @@ void AlphaOverMixedOperation::executePixelSampled(float output[4], float x, floa
 	}
 }
 
+void AlphaOverMixedOperation::executeRowSampled(float *output, int x, int y, int width)
+{
+	float inputValue[COM_ROW_PIXELS * 4];
+	float inputOverColor[COM_ROW_PIXELS * 4];
+
+	/* the first color is read into the output and blended in place */
+	this->m_inputValueOperation->readRow(inputValue, x, y, width);
+	this->m_inputColor1Operation->readRow(output, x, y, width);
+	this->m_inputColor2Operation->readRow(inputOverColor, x, y, width);
+
+	for (int i = 0; i < width; i++) {
+		const float value = inputValue[i * 4];
+		const float *over = &inputOverColor[i * 4];
+		float *out = &output[i * 4];
+
+		if (over[3] <= 0.0f) {
+			/* keep the first color */
+			continue;
+		}
+		else if (value == 1.0f && over[3] >= 1.0f) {
+			copy_v4_v4(out, over);
+		}
+		else {
+			float addfac = 1.0f - this->m_x + over[3] * this->m_x;
+			float premul = value * addfac;
+			float mul = 1.0f - value * over[3];
+
+			out[0] = (mul * out[0]) + premul * over[0];
+			out[1] = (mul * out[1]) + premul * over[1];
+			out[2] = (mul * out[2]) + premul * over[2];
+			out[3] = (mul * out[3]) + value * over[3];
+		}
+	}
+}
@@ -42,6 +42,7 @@ public:
 	 * the inner loop of this program
 	 */
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRowSampled(float *output, int x, int y, int width);
 	
 	void setX(float x) { this->m_x = x; }
 };
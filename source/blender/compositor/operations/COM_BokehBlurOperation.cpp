@@ -22,12 +22,17 @@
 
 #include "COM_BokehBlurOperation.h"
 #include "BLI_math.h"
+#include "COM_FHTConvolution.h"
 #include "COM_OpenCLDevice.h"
 
 extern "C" {
 #  include "RE_pipeline.h"
 }
 
+/* radius in samples from which the image is convolved at once with the Fast Hartley Transform,
+ * below it sampling the bokeh for every pixel is faster */
+#define COM_BOKEH_BLUR_FHT_RADIUS 16
+
 BokehBlurOperation::BokehBlurOperation() : NodeOperation()
 {
 	this->addInputSocket(COM_DT_COLOR);
@@ -43,6 +48,8 @@ BokehBlurOperation::BokehBlurOperation() : NodeOperation()
 	this->m_inputProgram = NULL;
 	this->m_inputBokehProgram = NULL;
 	this->m_inputBoundingBoxReader = NULL;
+	this->m_useConvolution = false;
+	this->m_convolved = NULL;
 
 	this->m_extend_bounds = false;
 }
@@ -54,10 +61,82 @@ void *BokehBlurOperation::initializeTileData(rcti * /*rect*/)
 		updateSize();
 	}
 	void *buffer = getInputOperation(0)->initializeTileData(NULL);
+	if (this->m_useConvolution && this->m_convolved == NULL) {
+		const float max_dim = max(this->getWidth(), this->getHeight());
+		const int pixelSize = this->m_size * max_dim / 100.0f;
+		this->m_convolved = createConvolved((MemoryBuffer *)buffer, pixelSize);
+	}
 	unlockMutex();
 	return buffer;
 }
 
+MemoryBuffer *BokehBlurOperation::createConvolved(MemoryBuffer *inputBuffer, int pixelSize)
+{
+	const int width = inputBuffer->getWidth();
+	const int height = inputBuffer->getHeight();
+	const int kernelSize = 2 * pixelSize + 1;
+	const float m = this->m_bokehDimension / pixelSize;
+	float bokeh[4];
+	rcti kernelRect;
+	BLI_rcti_init(&kernelRect, 0, kernelSize, 0, kernelSize);
+
+	/* the bokeh samples executePixel takes at offsets -pixelSize to pixelSize - 1, mirrored for
+	 * the convolution, which is centered at pixelSize. weights is the summed area table of them,
+	 * to normalize by the weights of the samples inside the image like executePixel does */
+	MemoryBuffer *kernel = new MemoryBuffer(COM_DT_COLOR, &kernelRect);
+	MemoryBuffer *weights = new MemoryBuffer(COM_DT_COLOR, &kernelRect);
+	float *kernelBuffer = kernel->getBuffer();
+	float *weightsBuffer = weights->getBuffer();
+	memset(kernelBuffer, 0, sizeof(float) * kernelSize * kernelSize * COM_NUM_CHANNELS_COLOR);
+	memset(weightsBuffer, 0, sizeof(float) * kernelSize * kernelSize * COM_NUM_CHANNELS_COLOR);
+
+	for (int dy = -pixelSize; dy < pixelSize; dy++) {
+		for (int dx = -pixelSize; dx < pixelSize; dx++) {
+			float u = this->m_bokehMidX - dx * m;
+			float v = this->m_bokehMidY - dy * m;
+			this->m_inputBokehProgram->readSampled(bokeh, u, v, COM_PS_NEAREST);
+			copy_v4_v4(&kernelBuffer[((pixelSize - dy) * kernelSize + (pixelSize - dx)) * COM_NUM_CHANNELS_COLOR], bokeh);
+
+			/* weights[j][i] is the sum of the samples before column i and row j */
+			const int i = dx + pixelSize + 1;
+			const int j = dy + pixelSize + 1;
+			float *weight = &weightsBuffer[(j * kernelSize + i) * COM_NUM_CHANNELS_COLOR];
+			add_v4_v4v4(weight, bokeh, weight - COM_NUM_CHANNELS_COLOR);
+			add_v4_v4(weight, weight - kernelSize * COM_NUM_CHANNELS_COLOR);
+			sub_v4_v4(weight, weight - (kernelSize + 1) * COM_NUM_CHANNELS_COLOR);
+		}
+	}
+
+	MemoryBuffer *result = new MemoryBuffer(COM_DT_COLOR, inputBuffer->getRect());
+	float *resultBuffer = result->getBuffer();
+	memset(resultBuffer, 0, sizeof(float) * width * height * COM_NUM_CHANNELS_COLOR);
+	FHT_convolve(resultBuffer, inputBuffer->getBuffer(), width, height,
+	             kernelBuffer, kernelSize, kernelSize, COM_NUM_CHANNELS_COLOR);
+
+	for (int y = 0; y < height; y++) {
+		const int y0 = max(-pixelSize, -y) + pixelSize;
+		const int y1 = min(pixelSize, height - y) + pixelSize;
+		for (int x = 0; x < width; x++) {
+			const int x0 = max(-pixelSize, -x) + pixelSize;
+			const int x1 = min(pixelSize, width - x) + pixelSize;
+			float multiplier_accum[4];
+			copy_v4_v4(multiplier_accum, &weightsBuffer[(y1 * kernelSize + x1) * COM_NUM_CHANNELS_COLOR]);
+			sub_v4_v4(multiplier_accum, &weightsBuffer[(y0 * kernelSize + x1) * COM_NUM_CHANNELS_COLOR]);
+			sub_v4_v4(multiplier_accum, &weightsBuffer[(y1 * kernelSize + x0) * COM_NUM_CHANNELS_COLOR]);
+			add_v4_v4(multiplier_accum, &weightsBuffer[(y0 * kernelSize + x0) * COM_NUM_CHANNELS_COLOR]);
+
+			float *color = &resultBuffer[(y * width + x) * COM_NUM_CHANNELS_COLOR];
+			for (int c = 0; c < COM_NUM_CHANNELS_COLOR; c++) {
+				color[c] = (multiplier_accum[c] != 0.0f) ? color[c] / multiplier_accum[c] : 0.0f;
+			}
+		}
+	}
+
+	delete kernel;
+	delete weights;
+	return result;
+}
+
 void BokehBlurOperation::initExecution()
 {
 	initMutex();
@@ -74,6 +153,12 @@ void BokehBlurOperation::initExecution()
 	this->m_bokehMidY = height / 2.0f;
 	this->m_bokehDimension = dimension / 2.0f;
 	QualityStepHelper::initExecution(COM_QH_INCREASE);
+
+	if (this->m_sizeavailable) {
+		const float max_dim = max(this->getWidth(), this->getHeight());
+		const int pixelSize = this->m_size * max_dim / 100.0f;
+		this->m_useConvolution = (pixelSize / getStep() >= COM_BOKEH_BLUR_FHT_RADIUS);
+	}
 }
 
 void BokehBlurOperation::executePixel(float output[4], int x, int y, void *data)
@@ -83,7 +168,10 @@ void BokehBlurOperation::executePixel(float output[4], int x, int y, void *data)
 	float bokeh[4];
 
 	this->m_inputBoundingBoxReader->readSampled(tempBoundingBox, x, y, COM_PS_NEAREST);
-	if (tempBoundingBox[0] > 0.0f) {
+	if (tempBoundingBox[0] > 0.0f && this->m_convolved) {
+		this->m_convolved->read(output, x, y);
+	}
+	else if (tempBoundingBox[0] > 0.0f) {
 		float multiplier_accum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
 		MemoryBuffer *inputBuffer = (MemoryBuffer *)data;
 		float *buffer = inputBuffer->getBuffer();
@@ -139,6 +227,10 @@ void BokehBlurOperation::executePixel(float output[4], int x, int y, void *data)
 void BokehBlurOperation::deinitExecution()
 {
 	deinitMutex();
+	if (this->m_convolved) {
+		delete this->m_convolved;
+		this->m_convolved = NULL;
+	}
 	this->m_inputProgram = NULL;
 	this->m_inputBokehProgram = NULL;
 	this->m_inputBoundingBoxReader = NULL;
@@ -150,7 +242,14 @@ bool BokehBlurOperation::determineDependingAreaOfInterest(rcti *input, ReadBuffe
 	rcti bokehInput;
 	const float max_dim = max(this->getWidth(), this->getHeight());
 
-	if (this->m_sizeavailable) {
+	if (this->m_useConvolution) {
+		NodeOperation *operation = getInputOperation(0);
+		newInput.xmax = operation->getWidth();
+		newInput.xmin = 0;
+		newInput.ymax = operation->getHeight();
+		newInput.ymin = 0;
+	}
+	else if (this->m_sizeavailable) {
 		newInput.xmax = input->xmax + (this->m_size * max_dim / 100.0f);
 		newInput.xmin = input->xmin - (this->m_size * max_dim / 100.0f);
 		newInput.ymax = input->ymax + (this->m_size * max_dim / 100.0f);
@@ -38,6 +38,14 @@ private:
 	float m_bokehMidY;
 	float m_bokehDimension;
 	bool m_extend_bounds;
+
+	/**
+	 * @brief the whole image convolved with the bokeh, used instead of sampling every pixel for big sizes
+	 * @note only used for a constant size, the whole input image is needed for the convolution
+	 */
+	bool m_useConvolution;
+	MemoryBuffer *m_convolved;
+	MemoryBuffer *createConvolved(MemoryBuffer *inputBuffer, int pixelSize);
 public:
 	BokehBlurOperation();
 
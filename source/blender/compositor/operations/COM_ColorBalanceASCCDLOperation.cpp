@@ -21,6 +21,7 @@
  */
 
 #include "COM_ColorBalanceASCCDLOperation.h"
+#include "COM_OpenCLDevice.h"
 #include "BLI_math.h"
 
 inline float colorbalance_cdl(float in, float offset, float power, float slope)
@@ -41,6 +42,7 @@ ColorBalanceASCCDLOperation::ColorBalanceASCCDLOperation() : NodeOperation()
 	this->m_inputValueOperation = NULL;
 	this->m_inputColorOperation = NULL;
 	this->setResolutionInputSocketIndex(1);
+	this->setOpenCL(true);
 }
 
 void ColorBalanceASCCDLOperation::initExecution()
@@ -68,6 +70,28 @@ void ColorBalanceASCCDLOperation::executePixelSampled(float output[4], float x,
 
 }
 
+void ColorBalanceASCCDLOperation::executeOpenCL(OpenCLDevice *device,
+                                                MemoryBuffer *outputMemoryBuffer, cl_mem clOutputBuffer,
+                                                MemoryBuffer **inputMemoryBuffers, list<cl_mem> *clMemToCleanUp,
+                                                list<cl_kernel> *clKernelsToCleanUp)
+{
+	cl_kernel colorBalanceKernel = device->COM_clCreateKernel("colorBalanceASCCDLKernel", clKernelsToCleanUp);
+	cl_float4 offset = {{this->m_offset[0], this->m_offset[1], this->m_offset[2], 0.0f}};
+	cl_float4 power = {{this->m_power[0], this->m_power[1], this->m_power[2], 0.0f}};
+	cl_float4 slope = {{this->m_slope[0], this->m_slope[1], this->m_slope[2], 0.0f}};
+
+	device->COM_clAttachInputToKernelParameter(colorBalanceKernel, 0, 1, clMemToCleanUp, clKernelsToCleanUp,
+	                                           inputMemoryBuffers, outputMemoryBuffer, this->m_inputValueOperation);
+	device->COM_clAttachInputToKernelParameter(colorBalanceKernel, 2, 3, clMemToCleanUp, clKernelsToCleanUp,
+	                                           inputMemoryBuffers, outputMemoryBuffer, this->m_inputColorOperation);
+	device->COM_clAttachOutputMemoryBufferToKernelParameter(colorBalanceKernel, 4, clOutputBuffer);
+	device->COM_clAttachMemoryBufferOffsetToKernelParameter(colorBalanceKernel, 5, outputMemoryBuffer);
+	clSetKernelArg(colorBalanceKernel, 6, sizeof(cl_float4), &offset);
+	clSetKernelArg(colorBalanceKernel, 7, sizeof(cl_float4), &power);
+	clSetKernelArg(colorBalanceKernel, 8, sizeof(cl_float4), &slope);
+	device->COM_clEnqueueRange(colorBalanceKernel, outputMemoryBuffer);
+}
+
 void ColorBalanceASCCDLOperation::deinitExecution()
 {
 	this->m_inputValueOperation = NULL;
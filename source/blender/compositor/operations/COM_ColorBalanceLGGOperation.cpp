@@ -21,6 +21,7 @@
  */
 
 #include "COM_ColorBalanceLGGOperation.h"
+#include "COM_OpenCLDevice.h"
 #include "BLI_math.h"
 
 
@@ -46,6 +47,7 @@ ColorBalanceLGGOperation::ColorBalanceLGGOperation() : NodeOperation()
 	this->m_inputValueOperation = NULL;
 	this->m_inputColorOperation = NULL;
 	this->setResolutionInputSocketIndex(1);
+	this->setOpenCL(true);
 }
 
 void ColorBalanceLGGOperation::initExecution()
@@ -73,6 +75,28 @@ void ColorBalanceLGGOperation::executePixelSampled(float output[4], float x, flo
 
 }
 
+void ColorBalanceLGGOperation::executeOpenCL(OpenCLDevice *device,
+                                             MemoryBuffer *outputMemoryBuffer, cl_mem clOutputBuffer,
+                                             MemoryBuffer **inputMemoryBuffers, list<cl_mem> *clMemToCleanUp,
+                                             list<cl_kernel> *clKernelsToCleanUp)
+{
+	cl_kernel colorBalanceKernel = device->COM_clCreateKernel("colorBalanceLGGKernel", clKernelsToCleanUp);
+	cl_float4 lift = {{this->m_lift[0], this->m_lift[1], this->m_lift[2], 0.0f}};
+	cl_float4 gammaInv = {{this->m_gamma_inv[0], this->m_gamma_inv[1], this->m_gamma_inv[2], 0.0f}};
+	cl_float4 gain = {{this->m_gain[0], this->m_gain[1], this->m_gain[2], 0.0f}};
+
+	device->COM_clAttachInputToKernelParameter(colorBalanceKernel, 0, 1, clMemToCleanUp, clKernelsToCleanUp,
+	                                           inputMemoryBuffers, outputMemoryBuffer, this->m_inputValueOperation);
+	device->COM_clAttachInputToKernelParameter(colorBalanceKernel, 2, 3, clMemToCleanUp, clKernelsToCleanUp,
+	                                           inputMemoryBuffers, outputMemoryBuffer, this->m_inputColorOperation);
+	device->COM_clAttachOutputMemoryBufferToKernelParameter(colorBalanceKernel, 4, clOutputBuffer);
+	device->COM_clAttachMemoryBufferOffsetToKernelParameter(colorBalanceKernel, 5, outputMemoryBuffer);
+	clSetKernelArg(colorBalanceKernel, 6, sizeof(cl_float4), &lift);
+	clSetKernelArg(colorBalanceKernel, 7, sizeof(cl_float4), &gammaInv);
+	clSetKernelArg(colorBalanceKernel, 8, sizeof(cl_float4), &gain);
+	device->COM_clEnqueueRange(colorBalanceKernel, outputMemoryBuffer);
+}
+
 void ColorBalanceLGGOperation::deinitExecution()
 {
 	this->m_inputValueOperation = NULL;
@@ -44,13 +44,9 @@ void ColorCorrectionOperation::initExecution()
 	this->m_inputMask = this->getInputSocketReader(1);
 }
 
-void ColorCorrectionOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+inline void ColorCorrectionOperation::correctPixel(float output[4], const float inputImageColor[4],
+                                                   const float inputMask[4])
 {
-	float inputImageColor[4];
-	float inputMask[4];
-	this->m_inputImage->readSampled(inputImageColor, x, y, sampler);
-	this->m_inputMask->readSampled(inputMask, x, y, sampler);
-	
 	float level = (inputImageColor[0] + inputImageColor[1] + inputImageColor[2]) / 3.0f;
 	float contrast = this->m_data->master.contrast;
 	float saturation = this->m_data->master.saturation;
@@ -139,6 +135,28 @@ void ColorCorrectionOperation::executePixelSampled(float output[4], float x, flo
 	output[3] = inputImageColor[3];
 }
 
+void ColorCorrectionOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+{
+	float inputImageColor[4];
+	float inputMask[4];
+	this->m_inputImage->readSampled(inputImageColor, x, y, sampler);
+	this->m_inputMask->readSampled(inputMask, x, y, sampler);
+
+	correctPixel(output, inputImageColor, inputMask);
+}
+
+void ColorCorrectionOperation::executeRowSampled(float *output, int x, int y, int width)
+{
+	float inputImageColor[COM_ROW_PIXELS * 4];
+	float inputMask[COM_ROW_PIXELS * 4];
+	this->m_inputImage->readRow(inputImageColor, x, y, width);
+	this->m_inputMask->readRow(inputMask, x, y, width);
+
+	for (int i = 0; i < width; i++) {
+		correctPixel(&output[i * 4], &inputImageColor[i * 4], &inputMask[i * 4]);
+	}
+}
+
 void ColorCorrectionOperation::deinitExecution()
 {
 	this->m_inputImage = NULL;
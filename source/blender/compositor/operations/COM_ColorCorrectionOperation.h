@@ -38,6 +38,8 @@ private:
 	bool m_greenChannelEnabled;
 	bool m_blueChannelEnabled;
 
+	inline void correctPixel(float output[4], const float inputImageColor[4], const float inputMask[4]);
+
 public:
 	ColorCorrectionOperation();
 	
@@ -45,6 +47,7 @@ public:
 	 * the inner loop of this program
 	 */
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRowSampled(float *output, int x, int y, int width);
 	
 	/**
 	 * Initialize the execution
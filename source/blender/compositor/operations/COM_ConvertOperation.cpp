@@ -58,6 +58,16 @@ void ConvertValueToColorOperation::executePixelSampled(float output[4], float x,
 	output[3] = 1.0f;
 }
 
+void ConvertValueToColorOperation::executeRowSampled(float *output, int x, int y, int width)
+{
+	this->m_inputOperation->readRow(output, x, y, width);
+	for (int i = 0; i < width; i++) {
+		float *out = &output[i * 4];
+		out[1] = out[2] = out[0];
+		out[3] = 1.0f;
+	}
+}
+
 
 /* ******** Color to Value ******** */
 
@@ -74,6 +84,15 @@ void ConvertColorToValueOperation::executePixelSampled(float output[4], float x,
 	output[0] = (inputColor[0] + inputColor[1] + inputColor[2]) / 3.0f;
 }
 
+void ConvertColorToValueOperation::executeRowSampled(float *output, int x, int y, int width)
+{
+	this->m_inputOperation->readRow(output, x, y, width);
+	for (int i = 0; i < width; i++) {
+		float *out = &output[i * 4];
+		out[0] = (out[0] + out[1] + out[2]) / 3.0f;
+	}
+}
+
 
 /* ******** Color to BW ******** */
 
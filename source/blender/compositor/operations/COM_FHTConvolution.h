@@ -0,0 +1,38 @@
+/*
+ * Copyright 2011, Blender Foundation.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor:
+ *		Jeroen Bakker
+ *		Monique Dewanchand
+ */
+
+#ifndef _COM_FHTConvolution_h
+#define _COM_FHTConvolution_h
+
+/**
+ * @brief convolve an image with a kernel using the 2D Fast Hartley Transform
+ *
+ * The image is split in blocks that are transformed, multiplied with the transformed kernel and
+ * added back together, this is much faster than brute force convolution for big kernels.
+ * Image, kernel and result have interleaved COM_NUM_CHANNELS_COLOR channels, of which the first
+ * numChannels are convolved. The kernel is centered at (kernelWidth / 2, kernelHeight / 2) and the
+ * result is added to dst, which has the size of the image.
+ */
+void FHT_convolve(float *dst, const float *image, unsigned int imageWidth, unsigned int imageHeight,
+                  const float *kernel, unsigned int kernelWidth, unsigned int kernelHeight, int numChannels);
+
+#endif
@@ -22,6 +22,7 @@
  */
 
 #include "COM_KeyingOperation.h"
+#include "COM_OpenCLDevice.h"
 
 #include "MEM_guardedalloc.h"
 
@@ -51,6 +52,8 @@ KeyingOperation::KeyingOperation() : NodeOperation()
 
 	this->m_pixelReader = NULL;
 	this->m_screenReader = NULL;
+
+	this->setOpenCL(true);
 }
 
 void KeyingOperation::initExecution()
@@ -107,3 +110,20 @@ void KeyingOperation::executePixelSampled(float output[4], float x, float y, Pix
 		}
 	}
 }
+
+void KeyingOperation::executeOpenCL(OpenCLDevice *device,
+                                    MemoryBuffer *outputMemoryBuffer, cl_mem clOutputBuffer,
+                                    MemoryBuffer **inputMemoryBuffers, list<cl_mem> *clMemToCleanUp,
+                                    list<cl_kernel> *clKernelsToCleanUp)
+{
+	cl_kernel keyingKernel = device->COM_clCreateKernel("keyingKernel", clKernelsToCleanUp);
+
+	device->COM_clAttachInputToKernelParameter(keyingKernel, 0, 1, clMemToCleanUp, clKernelsToCleanUp,
+	                                           inputMemoryBuffers, outputMemoryBuffer, this->m_pixelReader);
+	device->COM_clAttachInputToKernelParameter(keyingKernel, 2, 3, clMemToCleanUp, clKernelsToCleanUp,
+	                                           inputMemoryBuffers, outputMemoryBuffer, this->m_screenReader);
+	device->COM_clAttachOutputMemoryBufferToKernelParameter(keyingKernel, 4, clOutputBuffer);
+	device->COM_clAttachMemoryBufferOffsetToKernelParameter(keyingKernel, 5, outputMemoryBuffer);
+	clSetKernelArg(keyingKernel, 6, sizeof(cl_float), &this->m_screenBalance);
+	device->COM_clEnqueueRange(keyingKernel, outputMemoryBuffer);
+}
@@ -50,6 +50,11 @@ public:
 	void setScreenBalance(float value) {this->m_screenBalance = value;}
 
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+
+	void executeOpenCL(OpenCLDevice *device,
+	                   MemoryBuffer *outputMemoryBuffer, cl_mem clOutputBuffer,
+	                   MemoryBuffer **inputMemoryBuffers, list<cl_mem> *clMemToCleanUp,
+	                   list<cl_kernel> *clKernelsToCleanUp);
 };
 
 #endif
@@ -21,6 +21,7 @@
  */
 
 #include "COM_MixOperation.h"
+#include "COM_OpenCLDevice.h"
 
 extern "C" {
 #  include "BLI_math.h"
@@ -39,6 +40,7 @@ MixBaseOperation::MixBaseOperation() : NodeOperation()
 	this->m_inputColor2Operation = NULL;
 	this->setUseValueAlphaMultiply(false);
 	this->setUseClamp(false);
+	this->m_openCLMode = COM_MIX_CL_BLEND;
 }
 
 void MixBaseOperation::initExecution()
@@ -69,6 +71,44 @@ void MixBaseOperation::executePixelSampled(float output[4], float x, float y, Pi
 	output[3] = inputColor1[3];
 }
 
+void MixBaseOperation::executeOpenCL(OpenCLDevice *device,
+                                     MemoryBuffer *outputMemoryBuffer, cl_mem clOutputBuffer,
+                                     MemoryBuffer **inputMemoryBuffers, list<cl_mem> *clMemToCleanUp,
+                                     list<cl_kernel> *clKernelsToCleanUp)
+{
+	cl_kernel mixKernel = device->COM_clCreateKernel("mixKernel", clKernelsToCleanUp);
+
+	cl_int mode = this->m_openCLMode;
+	cl_int valueAlphaMultiply = this->m_valueAlphaMultiply;
+	cl_int useClamp = this->m_useClamp;
+
+	device->COM_clAttachInputToKernelParameter(mixKernel, 0, 1, clMemToCleanUp, clKernelsToCleanUp,
+	                                           inputMemoryBuffers, outputMemoryBuffer, this->m_inputValueOperation);
+	device->COM_clAttachInputToKernelParameter(mixKernel, 2, 3, clMemToCleanUp, clKernelsToCleanUp,
+	                                           inputMemoryBuffers, outputMemoryBuffer, this->m_inputColor1Operation);
+	device->COM_clAttachInputToKernelParameter(mixKernel, 4, 5, clMemToCleanUp, clKernelsToCleanUp,
+	                                           inputMemoryBuffers, outputMemoryBuffer, this->m_inputColor2Operation);
+	device->COM_clAttachOutputMemoryBufferToKernelParameter(mixKernel, 6, clOutputBuffer);
+	device->COM_clAttachMemoryBufferOffsetToKernelParameter(mixKernel, 7, outputMemoryBuffer);
+	clSetKernelArg(mixKernel, 8, sizeof(cl_int), &mode);
+	clSetKernelArg(mixKernel, 9, sizeof(cl_int), &valueAlphaMultiply);
+	clSetKernelArg(mixKernel, 10, sizeof(cl_int), &useClamp);
+	device->COM_clEnqueueRange(mixKernel, outputMemoryBuffer);
+}
+
+void MixBaseOperation::readInputRows(float *value, float *color1, float *color2, int x, int y, int width)
+{
+	this->m_inputValueOperation->readRow(value, x, y, width);
+	this->m_inputColor1Operation->readRow(color1, x, y, width);
+	this->m_inputColor2Operation->readRow(color2, x, y, width);
+
+	if (this->useValueAlphaMultiply()) {
+		for (int i = 0; i < width; i++) {
+			value[i * 4] *= color2[i * 4 + 3];
+		}
+	}
+}
+
 void MixBaseOperation::determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2])
 {
 	NodeOperationInput *socket;
@@ -104,7 +144,7 @@ void MixBaseOperation::deinitExecution()
 
 MixAddOperation::MixAddOperation() : MixBaseOperation()
 {
-	/* pass */
+	this->setOpenCLMode(COM_MIX_CL_ADD);
 }
 
 void MixAddOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
@@ -129,11 +169,31 @@ void MixAddOperation::executePixelSampled(float output[4], float x, float y, Pix
 	clampIfNeeded(output);
 }
 
+void MixAddOperation::executeRowSampled(float *output, int x, int y, int width)
+{
+	float inputValue[COM_ROW_PIXELS * 4];
+	float inputColor2[COM_ROW_PIXELS * 4];
+
+	/* the first color is read into the output, its alpha is kept */
+	readInputRows(inputValue, output, inputColor2, x, y, width);
+
+	for (int i = 0; i < width; i++) {
+		const float value = inputValue[i * 4];
+		const float *color2 = &inputColor2[i * 4];
+		float *out = &output[i * 4];
+		out[0] += value * color2[0];
+		out[1] += value * color2[1];
+		out[2] += value * color2[2];
+	}
+
+	clampRowIfNeeded(output, width);
+}
+
 /* ******** Mix Blend Operation ******** */
 
 MixBlendOperation::MixBlendOperation() : MixBaseOperation()
 {
-	/* pass */
+	this->setOpenCLMode(COM_MIX_CL_BLEND);
 }
 
 void MixBlendOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
@@ -160,6 +220,27 @@ void MixBlendOperation::executePixelSampled(float output[4], float x, float y, P
 	clampIfNeeded(output);
 }
 
+void MixBlendOperation::executeRowSampled(float *output, int x, int y, int width)
+{
+	float inputValue[COM_ROW_PIXELS * 4];
+	float inputColor2[COM_ROW_PIXELS * 4];
+
+	/* the first color is read into the output, its alpha is kept */
+	readInputRows(inputValue, output, inputColor2, x, y, width);
+
+	for (int i = 0; i < width; i++) {
+		const float value = inputValue[i * 4];
+		const float *color2 = &inputColor2[i * 4];
+		float *out = &output[i * 4];
+		const float valuem = 1.0f - value;
+		out[0] = valuem * out[0] + value * color2[0];
+		out[1] = valuem * out[1] + value * color2[1];
+		out[2] = valuem * out[2] + value * color2[2];
+	}
+
+	clampRowIfNeeded(output, width);
+}
+
 /* ******** Mix Burn Operation ******** */
 
 MixBurnOperation::MixBurnOperation() : MixBaseOperation()
@@ -274,7 +355,7 @@ void MixColorOperation::executePixelSampled(float output[4], float x, float y, P
 
 MixDarkenOperation::MixDarkenOperation() : MixBaseOperation()
 {
-	/* pass */
+	this->setOpenCLMode(COM_MIX_CL_DARKEN);
 }
 
 void MixDarkenOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
@@ -304,7 +385,7 @@ void MixDarkenOperation::executePixelSampled(float output[4], float x, float y,
 
 MixDifferenceOperation::MixDifferenceOperation() : MixBaseOperation()
 {
-	/* pass */
+	this->setOpenCLMode(COM_MIX_CL_DIFFERENCE);
 }
 
 void MixDifferenceOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
@@ -334,7 +415,7 @@ void MixDifferenceOperation::executePixelSampled(float output[4], float x, float
 
 MixDivideOperation::MixDivideOperation() : MixBaseOperation()
 {
-	/* pass */
+	this->setOpenCLMode(COM_MIX_CL_DIVIDE);
 }
 
 void MixDivideOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
@@ -522,7 +603,7 @@ void MixHueOperation::executePixelSampled(float output[4], float x, float y, Pix
 
 MixLightenOperation::MixLightenOperation() : MixBaseOperation()
 {
-	/* pass */
+	this->setOpenCLMode(COM_MIX_CL_LIGHTEN);
 }
 
 void MixLightenOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
@@ -597,7 +678,7 @@ void MixLinearLightOperation::executePixelSampled(float output[4], float x, floa
 
 MixMultiplyOperation::MixMultiplyOperation() : MixBaseOperation()
 {
-	/* pass */
+	this->setOpenCLMode(COM_MIX_CL_MULTIPLY);
 }
 
 void MixMultiplyOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
@@ -623,11 +704,32 @@ void MixMultiplyOperation::executePixelSampled(float output[4], float x, float y
 	clampIfNeeded(output);
 }
 
+void MixMultiplyOperation::executeRowSampled(float *output, int x, int y, int width)
+{
+	float inputValue[COM_ROW_PIXELS * 4];
+	float inputColor2[COM_ROW_PIXELS * 4];
+
+	/* the first color is read into the output, its alpha is kept */
+	readInputRows(inputValue, output, inputColor2, x, y, width);
+
+	for (int i = 0; i < width; i++) {
+		const float value = inputValue[i * 4];
+		const float *color2 = &inputColor2[i * 4];
+		float *out = &output[i * 4];
+		const float valuem = 1.0f - value;
+		out[0] *= valuem + value * color2[0];
+		out[1] *= valuem + value * color2[1];
+		out[2] *= valuem + value * color2[2];
+	}
+
+	clampRowIfNeeded(output, width);
+}
+
 /* ******** Mix Ovelray Operation ******** */
 
 MixOverlayOperation::MixOverlayOperation() : MixBaseOperation()
 {
-	/* pass */
+	this->setOpenCLMode(COM_MIX_CL_OVERLAY);
 }
 
 void MixOverlayOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
@@ -713,7 +815,7 @@ void MixSaturationOperation::executePixelSampled(float output[4], float x, float
 
 MixScreenOperation::MixScreenOperation() : MixBaseOperation()
 {
-	/* pass */
+	this->setOpenCLMode(COM_MIX_CL_SCREEN);
 }
 
 void MixScreenOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
@@ -781,7 +883,7 @@ void MixSoftLightOperation::executePixelSampled(float output[4], float x, float
 
 MixSubtractOperation::MixSubtractOperation() : MixBaseOperation()
 {
-	/* pass */
+	this->setOpenCLMode(COM_MIX_CL_SUBTRACT);
 }
 
 void MixSubtractOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
@@ -806,6 +908,26 @@ void MixSubtractOperation::executePixelSampled(float output[4], float x, float y
 	clampIfNeeded(output);
 }
 
+void MixSubtractOperation::executeRowSampled(float *output, int x, int y, int width)
+{
+	float inputValue[COM_ROW_PIXELS * 4];
+	float inputColor2[COM_ROW_PIXELS * 4];
+
+	/* the first color is read into the output, its alpha is kept */
+	readInputRows(inputValue, output, inputColor2, x, y, width);
+
+	for (int i = 0; i < width; i++) {
+		const float value = inputValue[i * 4];
+		const float *color2 = &inputColor2[i * 4];
+		float *out = &output[i * 4];
+		out[0] -= value * color2[0];
+		out[1] -= value * color2[1];
+		out[2] -= value * color2[2];
+	}
+
+	clampRowIfNeeded(output, width);
+}
+
 /* ******** Mix Value Operation ******** */
 
 MixValueOperation::MixValueOperation() : MixBaseOperation()
@@ -24,6 +24,21 @@
 #define _COM_MixBaseOperation_h
 #include "COM_NodeOperation.h"
 
+/**
+ * Blend modes of the OpenCL mix kernel, keep in sync with COM_OpenCLKernels.cl
+ */
+typedef enum MixOpenCLMode {
+	COM_MIX_CL_BLEND = 0,
+	COM_MIX_CL_ADD = 1,
+	COM_MIX_CL_MULTIPLY = 2,
+	COM_MIX_CL_SUBTRACT = 3,
+	COM_MIX_CL_SCREEN = 4,
+	COM_MIX_CL_DIVIDE = 5,
+	COM_MIX_CL_DIFFERENCE = 6,
+	COM_MIX_CL_DARKEN = 7,
+	COM_MIX_CL_LIGHTEN = 8,
+	COM_MIX_CL_OVERLAY = 9
+} MixOpenCLMode;
 
 /**
  * All this programs converts an input color to an output value.
@@ -40,6 +55,16 @@ protected:
 	SocketReader *m_inputColor2Operation;
 	bool m_valueAlphaMultiply;
 	bool m_useClamp;
+	MixOpenCLMode m_openCLMode;
+
+	/**
+	 * Execute this operation with the mix kernel, for blend modes that have one
+	 */
+	void setOpenCLMode(MixOpenCLMode mode)
+	{
+		this->m_openCLMode = mode;
+		this->setOpenCL(true);
+	}
 
 	inline void clampIfNeeded(float color[4])
 	{
@@ -50,6 +75,20 @@ protected:
 			CLAMP(color[3], 0.0f, 1.0f);
 		}
 	}
+
+	inline void clampRowIfNeeded(float *row, int width)
+	{
+		if (m_useClamp) {
+			for (int i = 0; i < width * 4; i++) {
+				CLAMP(row[i], 0.0f, 1.0f);
+			}
+		}
+	}
+
+	/**
+	 * Read a row of the three inputs for executeRowSampled, color1 may be the output row
+	 */
+	void readInputRows(float *value, float *color1, float *color2, int x, int y, int width);
 	
 public:
 	/**
@@ -61,6 +100,11 @@ public:
 	 * the inner loop of this program
 	 */
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+
+	void executeOpenCL(OpenCLDevice *device,
+	                   MemoryBuffer *outputMemoryBuffer, cl_mem clOutputBuffer,
+	                   MemoryBuffer **inputMemoryBuffers, list<cl_mem> *clMemToCleanUp,
+	                   list<cl_kernel> *clKernelsToCleanUp);
 	
 	/**
 	 * Initialize the execution
@@ -84,12 +128,14 @@ class MixAddOperation : public MixBaseOperation {
 public:
 	MixAddOperation();
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRowSampled(float *output, int x, int y, int width);
 };
 
 class MixBlendOperation : public MixBaseOperation {
 public:
 	MixBlendOperation();
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRowSampled(float *output, int x, int y, int width);
 };
 
 class MixBurnOperation : public MixBaseOperation {
@@ -156,6 +202,7 @@ class MixMultiplyOperation : public MixBaseOperation {
 public:
 	MixMultiplyOperation();
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRowSampled(float *output, int x, int y, int width);
 };
 
 class MixOverlayOperation : public MixBaseOperation {
@@ -186,6 +233,7 @@ class MixSubtractOperation : public MixBaseOperation {
 public:
 	MixSubtractOperation();
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRowSampled(float *output, int x, int y, int width);
 };
 
 class MixValueOperation : public MixBaseOperation {
@@ -313,3 +313,188 @@ __kernel void gaussianYBlurOperationKernel(__read_only image2d_t inputImage,
 
 	write_imagef(output, coords, color);
 }
+
+// KERNEL --- SET ---
+__kernel void setColorKernel(__write_only image2d_t output, float4 color)
+{
+	int2 coords = {get_global_id(0), get_global_id(1)};
+	write_imagef(output, coords, color);
+}
+
+// KERNEL --- MIX ---
+// modes must match MixOpenCLMode in COM_MixOperation.h
+#define MIX_BLEND      0
+#define MIX_ADD        1
+#define MIX_MULTIPLY   2
+#define MIX_SUBTRACT   3
+#define MIX_SCREEN     4
+#define MIX_DIVIDE     5
+#define MIX_DIFFERENCE 6
+#define MIX_DARKEN     7
+#define MIX_LIGHTEN    8
+#define MIX_OVERLAY    9
+
+__kernel void mixKernel(__read_only image2d_t inputValue, int2 offsetValue,
+                        __read_only image2d_t inputColor1, int2 offsetColor1,
+                        __read_only image2d_t inputColor2, int2 offsetColor2,
+                        __write_only image2d_t output, int2 offsetOutput,
+                        int mode, int useValueAlphaMultiply, int useClamp)
+{
+	int2 coords = {get_global_id(0), get_global_id(1)};
+	const int2 realCoordinate = coords + offsetOutput;
+	float value = read_imagef(inputValue, SAMPLER_NEAREST, realCoordinate - offsetValue).x;
+	const float4 color1 = read_imagef(inputColor1, SAMPLER_NEAREST, realCoordinate - offsetColor1);
+	const float4 color2 = read_imagef(inputColor2, SAMPLER_NEAREST, realCoordinate - offsetColor2);
+	float4 result = color1;
+
+	if (useValueAlphaMultiply) {
+		value *= color2.w;
+	}
+	const float valuem = 1.0f - value;
+
+	switch (mode) {
+		case MIX_ADD:
+			result.xyz = color1.xyz + value * color2.xyz;
+			break;
+		case MIX_MULTIPLY:
+			result.xyz = color1.xyz * (valuem + value * color2.xyz);
+			break;
+		case MIX_SUBTRACT:
+			result.xyz = color1.xyz - value * color2.xyz;
+			break;
+		case MIX_SCREEN:
+			result.xyz = 1.0f - (valuem + value * (1.0f - color2.xyz)) * (1.0f - color1.xyz);
+			break;
+		case MIX_DIVIDE:
+			result.xyz = select((float3)(0.0f), valuem * color1.xyz + value * color1.xyz / color2.xyz,
+			                    color2.xyz != 0.0f);
+			break;
+		case MIX_DIFFERENCE:
+			result.xyz = valuem * color1.xyz + value * fabs(color1.xyz - color2.xyz);
+			break;
+		case MIX_DARKEN:
+			result.xyz = fmin(color1.xyz, color2.xyz) * value + color1.xyz * valuem;
+			break;
+		case MIX_LIGHTEN:
+			result.xyz = fmax(value * color2.xyz, color1.xyz);
+			break;
+		case MIX_OVERLAY:
+			result.xyz = select(1.0f - (valuem + 2.0f * value * (1.0f - color2.xyz)) * (1.0f - color1.xyz),
+			                    color1.xyz * (valuem + 2.0f * value * color2.xyz),
+			                    color1.xyz < 0.5f);
+			break;
+		default: /* MIX_BLEND */
+			result.xyz = valuem * color1.xyz + value * color2.xyz;
+			break;
+	}
+
+	if (useClamp) {
+		result = clamp(result, 0.0f, 1.0f);
+	}
+
+	write_imagef(output, coords, result);
+}
+
+// KERNEL --- COLOR BALANCE ---
+float linearrgb_to_srgb(float c)
+{
+	if (c < 0.0031308f)
+		return (c < 0.0f) ? 0.0f : c * 12.92f;
+	else
+		return 1.055f * pow(c, 1.0f / 2.4f) - 0.055f;
+}
+
+float srgb_to_linearrgb(float c)
+{
+	if (c < 0.04045f)
+		return (c < 0.0f) ? 0.0f : c * (1.0f / 12.92f);
+	else
+		return pow((c + 0.055f) * (1.0f / 1.055f), 2.4f);
+}
+
+__kernel void colorBalanceLGGKernel(__read_only image2d_t inputValue, int2 offsetValue,
+                                    __read_only image2d_t inputColor, int2 offsetColor,
+                                    __write_only image2d_t output, int2 offsetOutput,
+                                    float4 lift, float4 gammaInv, float4 gain)
+{
+	int2 coords = {get_global_id(0), get_global_id(1)};
+	const int2 realCoordinate = coords + offsetOutput;
+	const float fac = min(1.0f, read_imagef(inputValue, SAMPLER_NEAREST, realCoordinate - offsetValue).x);
+	const float mfac = 1.0f - fac;
+	const float4 color = read_imagef(inputColor, SAMPLER_NEAREST, realCoordinate - offsetColor);
+	float4 result = color;
+
+	float3 x = (float3)(linearrgb_to_srgb(color.x), linearrgb_to_srgb(color.y), linearrgb_to_srgb(color.z));
+	x = fmax(((x - 1.0f) * lift.xyz + 1.0f) * gain.xyz, 0.0f);
+	x = (float3)(srgb_to_linearrgb(x.x), srgb_to_linearrgb(x.y), srgb_to_linearrgb(x.z));
+	result.xyz = mfac * color.xyz + fac * pow(x, gammaInv.xyz);
+
+	write_imagef(output, coords, result);
+}
+
+__kernel void colorBalanceASCCDLKernel(__read_only image2d_t inputValue, int2 offsetValue,
+                                       __read_only image2d_t inputColor, int2 offsetColor,
+                                       __write_only image2d_t output, int2 offsetOutput,
+                                       float4 offset, float4 power, float4 slope)
+{
+	int2 coords = {get_global_id(0), get_global_id(1)};
+	const int2 realCoordinate = coords + offsetOutput;
+	const float fac = min(1.0f, read_imagef(inputValue, SAMPLER_NEAREST, realCoordinate - offsetValue).x);
+	const float mfac = 1.0f - fac;
+	const float4 color = read_imagef(inputColor, SAMPLER_NEAREST, realCoordinate - offsetColor);
+	float4 result = color;
+
+	const float3 x = fmax(color.xyz * slope.xyz + offset.xyz, 0.0f);
+	result.xyz = mfac * color.xyz + fac * pow(x, power.xyz);
+
+	write_imagef(output, coords, result);
+}
+
+// KERNEL --- KEYING ---
+float keying_saturation(float4 pixel, int primary_channel, float screen_balance)
+{
+	const float p[3] = {pixel.x, pixel.y, pixel.z};
+	const int other_1 = (primary_channel + 1) % 3;
+	const int other_2 = (primary_channel + 2) % 3;
+	const int min_channel = min(other_1, other_2);
+	const int max_channel = max(other_1, other_2);
+	const float val = screen_balance * p[min_channel] + (1.0f - screen_balance) * p[max_channel];
+
+	return (p[primary_channel] - val) * fabs(1.0f - val);
+}
+
+__kernel void keyingKernel(__read_only image2d_t inputPixel, int2 offsetPixel,
+                           __read_only image2d_t inputScreen, int2 offsetScreen,
+                           __write_only image2d_t output, int2 offsetOutput,
+                           float screenBalance)
+{
+	int2 coords = {get_global_id(0), get_global_id(1)};
+	const int2 realCoordinate = coords + offsetOutput;
+	const float4 pixel = read_imagef(inputPixel, SAMPLER_NEAREST, realCoordinate - offsetPixel);
+	const float4 screen = read_imagef(inputScreen, SAMPLER_NEAREST, realCoordinate - offsetScreen);
+	const int primary_channel = (screen.x > screen.y) ? ((screen.x > screen.z) ? 0 : 2) :
+	                                                    ((screen.y > screen.z) ? 1 : 2);
+	const float p[3] = {pixel.x, pixel.y, pixel.z};
+	float alpha;
+
+	if (p[primary_channel] > 1.0f) {
+		/* overexposed pixels are treated as foreground */
+		alpha = 1.0f;
+	}
+	else {
+		const float saturation = keying_saturation(pixel, primary_channel, screenBalance);
+		const float screen_saturation = keying_saturation(screen, primary_channel, screenBalance);
+
+		if (saturation < 0.0f) {
+			alpha = 1.0f;
+		}
+		else if (saturation >= screen_saturation) {
+			alpha = 0.0f;
+		}
+		else {
+			alpha = 1.0f - saturation / screen_saturation;
+		}
+	}
+
+	write_imagef(output, coords, (float4)(alpha, 0.0f, 0.0f, 0.0f));
+}
@@ -74,6 +74,21 @@ void ReadBufferOperation::executePixelSampled(float output[4], float x, float y,
 	}
 }
 
+void ReadBufferOperation::executeRowSampled(float *output, int x, int y, int width)
+{
+	if (m_single_value) {
+		/* write buffer has a single value stored at (0,0) */
+		for (int i = 0; i < width; i++) {
+			m_buffer->read(&output[i * 4], 0, 0);
+		}
+	}
+	else {
+		for (int i = 0; i < width; i++) {
+			m_buffer->read(&output[i * 4], x + i, y);
+		}
+	}
+}
+
 void ReadBufferOperation::executePixelExtend(float output[4], float x, float y, PixelSampler sampler,
                                              MemoryBufferExtend extend_x, MemoryBufferExtend extend_y)
 {
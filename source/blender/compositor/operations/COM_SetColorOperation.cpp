@@ -21,9 +21,11 @@
  */
 
 #include "COM_SetColorOperation.h"
+#include "COM_OpenCLDevice.h"
 
 SetColorOperation::SetColorOperation() : NodeOperation()
 {
+	this->setOpenCL(true);
 	this->addOutputSocket(COM_DT_COLOR);
 }
 
@@ -34,6 +36,26 @@ void SetColorOperation::executePixelSampled(float output[4],
 	copy_v4_v4(output, this->m_color);
 }
 
+void SetColorOperation::executeRowSampled(float *output, int /*x*/, int /*y*/, int width)
+{
+	for (int i = 0; i < width; i++) {
+		copy_v4_v4(&output[i * 4], this->m_color);
+	}
+}
+
+void SetColorOperation::executeOpenCL(OpenCLDevice *device,
+                                      MemoryBuffer *outputMemoryBuffer, cl_mem clOutputBuffer,
+                                      MemoryBuffer ** /*inputMemoryBuffers*/, list<cl_mem> * /*clMemToCleanUp*/,
+                                      list<cl_kernel> *clKernelsToCleanUp)
+{
+	cl_kernel setKernel = device->COM_clCreateKernel("setColorKernel", clKernelsToCleanUp);
+	cl_float4 color = {{this->m_color[0], this->m_color[1], this->m_color[2], this->m_color[3]}};
+
+	device->COM_clAttachOutputMemoryBufferToKernelParameter(setKernel, 0, clOutputBuffer);
+	clSetKernelArg(setKernel, 1, sizeof(cl_float4), &color);
+	device->COM_clEnqueueRange(setKernel, outputMemoryBuffer);
+}
+
 void SetColorOperation::determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2])
 {
 	resolution[0] = preferredResolution[0];
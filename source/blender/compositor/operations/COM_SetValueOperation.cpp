@@ -21,9 +21,11 @@
  */
 
 #include "COM_SetValueOperation.h"
+#include "COM_OpenCLDevice.h"
 
 SetValueOperation::SetValueOperation() : NodeOperation()
 {
+	this->setOpenCL(true);
 	this->addOutputSocket(COM_DT_VALUE);
 }
 
@@ -34,6 +36,26 @@ void SetValueOperation::executePixelSampled(float output[4],
 	output[0] = this->m_value;
 }
 
+void SetValueOperation::executeRowSampled(float *output, int /*x*/, int /*y*/, int width)
+{
+	for (int i = 0; i < width; i++) {
+		output[i * 4] = this->m_value;
+	}
+}
+
+void SetValueOperation::executeOpenCL(OpenCLDevice *device,
+                                      MemoryBuffer *outputMemoryBuffer, cl_mem clOutputBuffer,
+                                      MemoryBuffer ** /*inputMemoryBuffers*/, list<cl_mem> * /*clMemToCleanUp*/,
+                                      list<cl_kernel> *clKernelsToCleanUp)
+{
+	cl_kernel setKernel = device->COM_clCreateKernel("setColorKernel", clKernelsToCleanUp);
+	cl_float4 color = {{this->m_value, 0.0f, 0.0f, 0.0f}};
+
+	device->COM_clAttachOutputMemoryBufferToKernelParameter(setKernel, 0, clOutputBuffer);
+	clSetKernelArg(setKernel, 1, sizeof(cl_float4), &color);
+	device->COM_clEnqueueRange(setKernel, outputMemoryBuffer);
+}
+
 void SetValueOperation::determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2])
 {
 	resolution[0] = preferredResolution[0];
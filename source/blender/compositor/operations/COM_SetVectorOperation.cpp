@@ -21,10 +21,12 @@
  */
 
 #include "COM_SetVectorOperation.h"
+#include "COM_OpenCLDevice.h"
 #include "COM_defines.h"
 
 SetVectorOperation::SetVectorOperation() : NodeOperation()
 {
+	this->setOpenCL(true);
 	this->addOutputSocket(COM_DT_VECTOR);
 }
 
@@ -37,6 +39,19 @@ void SetVectorOperation::executePixelSampled(float output[4],
 	output[2] = this->m_z;
 }
 
+void SetVectorOperation::executeOpenCL(OpenCLDevice *device,
+                                       MemoryBuffer *outputMemoryBuffer, cl_mem clOutputBuffer,
+                                       MemoryBuffer ** /*inputMemoryBuffers*/, list<cl_mem> * /*clMemToCleanUp*/,
+                                       list<cl_kernel> *clKernelsToCleanUp)
+{
+	cl_kernel setKernel = device->COM_clCreateKernel("setColorKernel", clKernelsToCleanUp);
+	cl_float4 color = {{this->m_x, this->m_y, this->m_z, 0.0f}};
+
+	device->COM_clAttachOutputMemoryBufferToKernelParameter(setKernel, 0, clOutputBuffer);
+	clSetKernelArg(setKernel, 1, sizeof(cl_float4), &color);
+	device->COM_clEnqueueRange(setKernel, outputMemoryBuffer);
+}
+
 void SetVectorOperation::determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2])
 {
 	resolution[0] = preferredResolution[0];
@@ -141,6 +141,18 @@ void VariableSizeBokehBlurOperation::executePixel(float output[4], int x, int y,
 		const int addXStepColor = addXStepValue * COM_NUM_CHANNELS_COLOR;
 
 		if (size_center > this->m_threshold) {
+			/* samples are clamped to the center size, so nothing further away than it can contribute,
+			 * skip those pixels while staying on the grid of the quality step */
+			const int radius = (int)size_center + 1;
+			if (y - radius > miny) {
+				miny += ((y - radius - miny) / addYStepValue) * addYStepValue;
+			}
+			if (x - radius > minx) {
+				minx += ((x - radius - minx) / addXStepValue) * addXStepValue;
+			}
+			maxy = min(maxy, y + radius);
+			maxx = min(maxx, x + radius);
+
 			for (int ny = miny; ny < maxy; ny += addYStepValue) {
 				float dy = ny - y;
 				int offsetValueNy = ny * inputSizeBuffer->getWidth();
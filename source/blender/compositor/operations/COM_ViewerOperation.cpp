@@ -96,23 +96,28 @@ void ViewerOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/)
 	const int offsetadd4 = offsetadd * 4;
 	int offset = (y1 * this->getWidth() + x1);
 	int offset4 = offset * 4;
-	float alpha[4], depth[4];
+	float row[COM_ROW_PIXELS * 4];
 	int x;
 	int y;
 	bool breaked = false;
 
 	for (y = y1; y < y2 && (!breaked); y++) {
-		for (x = x1; x < x2; x++) {
-			this->m_imageInput->readSampled(&(buffer[offset4]), x, y, COM_PS_NEAREST);
+		for (x = x1; x < x2; x += COM_ROW_PIXELS) {
+			const int width = (x2 - x < COM_ROW_PIXELS) ? x2 - x : COM_ROW_PIXELS;
+			this->m_imageInput->readRow(&(buffer[offset4]), x, y, width);
 			if (this->m_useAlphaInput) {
-				this->m_alphaInput->readSampled(alpha, x, y, COM_PS_NEAREST);
-				buffer[offset4 + 3] = alpha[0];
+				this->m_alphaInput->readRow(row, x, y, width);
+				for (int i = 0; i < width; i++) {
+					buffer[offset4 + i * 4 + 3] = row[i * 4];
+				}
+			}
+			this->m_depthInput->readRow(row, x, y, width);
+			for (int i = 0; i < width; i++) {
+				depthbuffer[offset + i] = row[i * 4];
 			}
-			this->m_depthInput->readSampled(depth, x, y, COM_PS_NEAREST);
-			depthbuffer[offset] = depth[0];
 
-			offset ++;
-			offset4 += 4;
+			offset += width;
+			offset4 += width * 4;
 		}
 		if (isBreaked()) {
 			breaked = true;
@@ -32,6 +32,10 @@ public:
 	WrapOperation(DataType datetype);
 	bool determineDependingAreaOfInterest(rcti *input, ReadBufferOperation *readOperation, rcti *output);
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	/* wrapped pixels are not a row of the read buffer, calculate them one by one */
+	void executeRowSampled(float *output, int x, int y, int width) {
+		SocketReader::executeRowSampled(output, x, y, width);
+	}
 
 	void setWrapping(int wrapping_type);
 	float getWrappedOriginalXPos(float x);
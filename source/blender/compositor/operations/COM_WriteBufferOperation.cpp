@@ -93,14 +93,26 @@ void WriteBufferOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/
 		int x2 = rect->xmax;
 		int y2 = rect->ymax;
 
+		/* calculate rows at once, operations with a row implementation then
+		 * loop over the pixels instead of a virtual call per pixel */
+		float row[COM_ROW_PIXELS * 4];
 		int x;
 		int y;
 		bool breaked = false;
 		for (y = y1; y < y2 && (!breaked); y++) {
-			int offset4 = (y * memoryBuffer->getWidth() + x1) * num_channels;
-			for (x = x1; x < x2; x++) {
-				this->m_input->readSampled(&(buffer[offset4]), x, y, COM_PS_NEAREST);
-				offset4 += num_channels;
+			int offset = (y * memoryBuffer->getWidth() + x1) * num_channels;
+			for (x = x1; x < x2; x += COM_ROW_PIXELS) {
+				const int width = (x2 - x < COM_ROW_PIXELS) ? x2 - x : COM_ROW_PIXELS;
+				if (num_channels == COM_NUM_CHANNELS_COLOR) {
+					this->m_input->readRow(&(buffer[offset]), x, y, width);
+				}
+				else {
+					this->m_input->readRow(row, x, y, width);
+					for (int i = 0; i < width; i++) {
+						memcpy(&(buffer[offset + i * num_channels]), &row[i * 4], sizeof(float) * num_channels);
+					}
+				}
+				offset += width * num_channels;
 			}
 			if (isBreaked()) {
 				breaked = true;
@@ -44,6 +44,7 @@ struct CacheFile;
 struct EffectorWeights;
 struct EvaluationContext;
 struct Group;
+struct ID;
 struct Main;
 struct ModifierData;
 struct Object;
@@ -68,6 +69,13 @@ void DEG_graph_tag_relations_update(struct Depsgraph *graph);
 /* Tag all relations in the database for update.*/
 void DEG_relations_tag_update(struct Main *bmain);
 
+/* Tag relations of the given ID for update. Allows graph to only rebuild
+ * nodes and relations of this ID and its direct neighbours, falling back
+ * to a full rebuild when the change can not be handled partially.
+ */
+void DEG_graph_id_tag_relations_update(struct Depsgraph *graph, struct ID *id);
+void DEG_id_relations_tag_update(struct Main *bmain, struct ID *id);
+
 /* Create new graph if didn't exist yet,
  * or update relations if graph was tagged for update.
  */
@@ -82,6 +82,15 @@ void DEG_stats_simple(const struct Depsgraph *graph,
                       size_t *r_operations,
                       size_t *r_relations);
 
+/* ------------------------------------------------ */
+
+/* Timing of the last evaluation (recorded when running with
+ * --debug-depsgraph-time). Return false if there is no timing recorded.
+ */
+bool DEG_debug_eval_profile_print(const struct Depsgraph *graph, FILE *stream);
+/* Write timing of all operations as Chrome trace JSON (chrome://tracing). */
+bool DEG_debug_eval_profile_write_trace(const struct Depsgraph *graph, FILE *stream);
+
 /* ************************************************ */
 /* Diagram-Based Graph Debugging */
 
@@ -67,6 +67,12 @@ struct Object *DEG_get_evaluated_object(struct Depsgraph *depsgraph, struct Obje
 /* Get evaluated version of given ID datablock. */
 struct ID *DEG_get_evaluated_id(struct Depsgraph *depsgraph, struct ID *id);
 
+/* Allocate memory owned by the evaluated version of given ID datablock (original or evaluated),
+ * it is released all at once when the depsgraph frees or updates that evaluated datablock.
+ * Can be used from multiple threads, the memory must never be freed with MEM_freeN().
+ */
+void *DEG_evaluated_id_arena_alloc(struct Depsgraph *depsgraph, const struct ID *id, size_t size);
+
 /* ************************ DAG iterators ********************* */
 
 enum {
@@ -36,6 +36,7 @@
 
 #include "BLI_utildefines.h"
 #include "BLI_ghash.h"
+#include "BLI_task.h"
 
 #include "intern/depsgraph.h"
 #include "intern/depsgraph_types.h"
@@ -43,17 +44,49 @@
 
 #include "DEG_depsgraph.h"
 
+#include "util/deg_util_foreach.h"
+
 namespace DEG {
 
+namespace {
+
+struct FinalizeBuildData {
+	Depsgraph *graph;
+	vector<IDDepsNode *> id_nodes;
+};
+
+void finalize_build_func(void *data_v, const int i)
+{
+	FinalizeBuildData *data = (FinalizeBuildData *)data_v;
+	data->id_nodes[i]->finalize_build(data->graph);
+}
+
+}  /* namespace */
+
 void deg_graph_build_finalize(Depsgraph *graph)
 {
-	/* Re-tag IDs for update if it was tagged before the relations
-	 * update tag.
+	/* Finalizing only touches components of the ID itself, so it's done for
+	 * all IDs in parallel.
 	 */
+	FinalizeBuildData data;
+	data.graph = graph;
+	data.id_nodes.reserve(BLI_ghash_size(graph->id_hash));
 	GHASH_FOREACH_BEGIN(IDDepsNode *, id_node, graph->id_hash)
 	{
+		data.id_nodes.push_back(id_node);
+	}
+	GHASH_FOREACH_END();
+	const int num_id_nodes = data.id_nodes.size();
+	BLI_task_parallel_range(0, num_id_nodes,
+	                        &data,
+	                        finalize_build_func,
+	                        num_id_nodes > 64);
+
+	/* Re-tag IDs for update if it was tagged before the relations
+	 * update tag.
+	 */
+	foreach (IDDepsNode *id_node, data.id_nodes) {
 		ID *id = id_node->id_orig;
-		id_node->finalize_build(graph);
 		if ((id->tag & LIB_TAG_ID_RECALC_ALL)) {
 			id_node->tag_update(graph);
 		}
@@ -67,7 +100,6 @@ void deg_graph_build_finalize(Depsgraph *graph)
 		DEG_id_tag_update_ex(graph->bmain, id_node->id_orig, DEG_TAG_COPY_ON_WRITE);
 #endif
 	}
-	GHASH_FOREACH_END();
 }
 
 }  // namespace DEG
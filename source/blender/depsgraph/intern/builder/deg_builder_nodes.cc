@@ -38,6 +38,7 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_blenlib.h"
+#include "BLI_flathash.h"
 #include "BLI_string.h"
 #include "BLI_utildefines.h"
 
@@ -194,6 +195,7 @@ IDDepsNode *DepsgraphNodeBuilder::add_id_node(ID *id, bool do_tag)
 		    function_bind(deg_evaluate_copy_on_write, _1, m_graph, id_node),
 		    DEG_OPCODE_COPY_ON_WRITE,
 		    "", -1);
+		op_cow->index = m_graph->operations.size();
 		m_graph->operations.push_back(op_cow);
 	}
 #else
@@ -230,6 +232,7 @@ OperationDepsNode *DepsgraphNodeBuilder::add_operation_node(
 	                                                      name_tag);
 	if (op_node == NULL) {
 		op_node = comp_node->add_operation(op, opcode, name, name_tag);
+		op_node->index = m_graph->operations.size();
 		m_graph->operations.push_back(op_node);
 	}
 	else {
@@ -377,7 +380,47 @@ void DepsgraphNodeBuilder::begin_build(Main *bmain) {
 	/* Make sure graph has no nodes left from previous state. */
 	m_graph->clear_all_nodes();
 	m_graph->operations.clear();
-	BLI_gset_clear(m_graph->entry_tags, NULL);
+	BLI_flatset_clear(m_graph->entry_tags, NULL);
+}
+
+void DepsgraphNodeBuilder::begin_partial_build(Main *bmain, GSet *id_nodes)
+{
+	/* Nodes of IDs which are kept in the graph are considered to be already
+	 * built, so builder only creates nodes for the IDs which are being rebuilt
+	 * and for the ones which were not in the graph yet.
+	 */
+	BKE_main_id_tag_all(bmain, LIB_TAG_DOIT, false);
+	FOREACH_NODETREE(bmain, nodetree, id)
+	{
+		if (id != (ID *)nodetree) {
+			nodetree->id.tag &= ~LIB_TAG_DOIT;
+		}
+	}
+	FOREACH_NODETREE_END;
+	GHASH_FOREACH_BEGIN(IDDepsNode *, id_node, m_graph->id_hash)
+	{
+		if (!BLI_gset_haskey(id_nodes, id_node)) {
+			id_node->id_orig->tag |= LIB_TAG_DOIT;
+		}
+	}
+	GHASH_FOREACH_END();
+
+#ifdef WITH_COPY_ON_WRITE
+	/* Keep copy-on-write datablocks of the rebuilt IDs, other datablocks
+	 * might be referencing them.
+	 */
+	m_cow_id_hash = BLI_ghash_ptr_new("Depsgraph id hash");
+	GSET_FOREACH_BEGIN(IDDepsNode *, id_node, id_nodes)
+	{
+		if (deg_copy_on_write_is_expanded(id_node->id_cow)) {
+			BLI_ghash_insert(m_cow_id_hash, id_node->id_orig, id_node->id_cow);
+			id_node->id_cow = NULL;
+		}
+	}
+	GSET_FOREACH_END();
+#endif
+
+	m_graph->remove_id_nodes(id_nodes);
 }
 
 void DepsgraphNodeBuilder::build_group(Scene *scene, Group *group)
@@ -36,6 +36,7 @@ struct CacheFile;
 struct bGPdata;
 struct ListBase;
 struct GHash;
+struct GSet;
 struct ID;
 struct Image;
 struct FCurve;
@@ -106,6 +107,10 @@ struct DepsgraphNodeBuilder {
 	}
 
 	void begin_build(Main *bmain);
+	/* Remove given ID nodes from the graph, so they can be built again, and
+	 * keep the rest of the graph as-is.
+	 */
+	void begin_partial_build(Main *bmain, GSet *id_nodes);
 
 	IDDepsNode *add_id_node(ID *id, bool do_tag = true);
 	TimeSourceDepsNode *add_time_source();
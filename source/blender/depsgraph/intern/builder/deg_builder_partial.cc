@@ -0,0 +1,375 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2017 Blender Foundation.
+ * All rights reserved.
+ *
+ * Contributor(s): None Yet
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file blender/depsgraph/intern/builder/deg_builder_partial.cc
+ *  \ingroup depsgraph
+ *
+ * Partial update of the graph's nodes and relations.
+ *
+ * Only IDs which relations were tagged for update and their direct neighbours
+ * are rebuilt. Everything else, including the evaluated state, is kept. The
+ * rebuilt IDs are removed from the graph and built again using the regular
+ * node and relation builders, which skip all the IDs which were kept.
+ *
+ * Relations between rebuilt and kept nodes are remembered prior to removal
+ * and restored afterwards, since they might have been created by builder of
+ * a kept ID. This might keep relation which is not needed anymore, which is
+ * harmless from the evaluation order point of view.
+ */
+
+#include "intern/builder/deg_builder_partial.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_utildefines.h"
+#include "BLI_ghash.h"
+
+extern "C" {
+#include "DNA_ID.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "BKE_global.h"
+} /* extern "C" */
+
+#include "DEG_depsgraph.h"
+
+#include "intern/builder/deg_builder.h"
+#include "intern/builder/deg_builder_cycle.h"
+#include "intern/builder/deg_builder_nodes.h"
+#include "intern/builder/deg_builder_relations.h"
+#include "intern/builder/deg_builder_transitive.h"
+#include "intern/nodes/deg_node.h"
+#include "intern/nodes/deg_node_component.h"
+#include "intern/nodes/deg_node_operation.h"
+#include "intern/depsgraph.h"
+#include "intern/depsgraph_types.h"
+#include "util/deg_util_foreach.h"
+
+namespace DEG {
+
+namespace {
+
+/* Relation between an operation of the rebuilt ID and a node which is kept in
+ * the graph. Operation is referenced by its key, since the node itself is
+ * freed and created again by the builder.
+ */
+struct ExternalRelation {
+	ID *id;
+	eDepsNode_Type component_type;
+	string component_name;
+	eDepsOperation_Code opcode;
+	string name;
+	int name_tag;
+	/* Node which is kept in the graph. */
+	DepsNode *node;
+	/* Relation goes from the kept node to the rebuilt operation. */
+	bool is_incoming;
+	const char *description;
+};
+
+typedef vector<ExternalRelation> ExternalRelations;
+
+IDDepsNode *relation_other_id_node(DepsNode *node)
+{
+	if (node->type != DEG_NODE_TYPE_OPERATION) {
+		return NULL;
+	}
+	OperationDepsNode *op_node = (OperationDepsNode *)node;
+	return op_node->owner->owner;
+}
+
+/* Check whether object can be rebuilt without rebuilding the whole scene. */
+bool object_can_build_partial(Object *object)
+{
+	/* Rigid body simulation creates operations for the objects from the scene
+	 * level, which is not rebuilt.
+	 */
+	if (object->rigidbody_object != NULL ||
+	    object->rigidbody_constraint != NULL)
+	{
+		return false;
+	}
+	return true;
+}
+
+void add_id_node_with_object_neighbours(GSet *id_nodes, IDDepsNode *id_node)
+{
+	BLI_gset_add(id_nodes, id_node);
+	GHASH_FOREACH_BEGIN(ComponentDepsNode *, comp_node, id_node->components)
+	{
+		foreach (OperationDepsNode *op_node, comp_node->operations) {
+			foreach (DepsRelation *rel, op_node->inlinks) {
+				IDDepsNode *other = relation_other_id_node(rel->from);
+				if (other != NULL && GS(other->id_orig->name) == ID_OB) {
+					BLI_gset_add(id_nodes, other);
+				}
+			}
+			foreach (DepsRelation *rel, op_node->outlinks) {
+				IDDepsNode *other = relation_other_id_node(rel->to);
+				if (other != NULL && GS(other->id_orig->name) == ID_OB) {
+					BLI_gset_add(id_nodes, other);
+				}
+			}
+		}
+	}
+	GHASH_FOREACH_END();
+}
+
+void add_external_relation(ExternalRelations *relations,
+                           OperationDepsNode *op_node,
+                           DepsNode *node,
+                           bool is_incoming,
+                           const char *description)
+{
+	ComponentDepsNode *comp_node = op_node->owner;
+	ExternalRelation relation;
+	relation.id = comp_node->owner->id_orig;
+	relation.component_type = comp_node->type;
+	relation.component_name = comp_node->name;
+	relation.opcode = op_node->opcode;
+	relation.name = op_node->name;
+	relation.name_tag = op_node->name_tag;
+	relation.node = node;
+	relation.is_incoming = is_incoming;
+	relation.description = description;
+	relations->push_back(relation);
+}
+
+void collect_external_relations(GSet *id_nodes, ExternalRelations *relations)
+{
+	GSET_FOREACH_BEGIN(IDDepsNode *, id_node, id_nodes)
+	{
+		GHASH_FOREACH_BEGIN(ComponentDepsNode *, comp_node, id_node->components)
+		{
+			foreach (OperationDepsNode *op_node, comp_node->operations) {
+				foreach (DepsRelation *rel, op_node->inlinks) {
+					IDDepsNode *other = relation_other_id_node(rel->from);
+					if (!BLI_gset_haskey(id_nodes, other)) {
+						add_external_relation(relations, op_node, rel->from, true, rel->name);
+					}
+				}
+				foreach (DepsRelation *rel, op_node->outlinks) {
+					IDDepsNode *other = relation_other_id_node(rel->to);
+					if (!BLI_gset_haskey(id_nodes, other)) {
+						add_external_relation(relations, op_node, rel->to, false, rel->name);
+					}
+				}
+			}
+		}
+		GHASH_FOREACH_END();
+	}
+	GSET_FOREACH_END();
+}
+
+/* Components of nodes which were kept in the graph are finalized, so it's
+ * possible to distinguish them from nodes which were just built.
+ */
+bool id_node_is_new(IDDepsNode *id_node)
+{
+	GHASH_FOREACH_BEGIN(ComponentDepsNode *, comp_node, id_node->components)
+	{
+		if (comp_node->operations_map == NULL) {
+			return false;
+		}
+	}
+	GHASH_FOREACH_END();
+	return true;
+}
+
+bool has_relation(DepsNode *from, DepsNode *to)
+{
+	foreach (DepsRelation *rel, from->outlinks) {
+		if (rel->to == to) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void restore_external_relations(Depsgraph *graph,
+                                const ExternalRelations &relations)
+{
+	foreach (const ExternalRelation &relation, relations) {
+		IDDepsNode *id_node = graph->find_id_node(relation.id);
+		if (id_node == NULL) {
+			continue;
+		}
+		ComponentDepsNode *comp_node =
+		        id_node->find_component(relation.component_type,
+		                                relation.component_name.c_str());
+		if (comp_node == NULL) {
+			continue;
+		}
+		/* Operation might be gone, in which case the relation is not needed
+		 * anymore.
+		 */
+		OperationDepsNode *op_node =
+		        comp_node->has_operation(relation.opcode,
+		                                 relation.name.c_str(),
+		                                 relation.name_tag);
+		if (op_node == NULL) {
+			continue;
+		}
+		DepsNode *from = relation.is_incoming ? relation.node : op_node;
+		DepsNode *to = relation.is_incoming ? op_node : relation.node;
+		/* Builder of the rebuilt ID might have created this relation already. */
+		if (has_relation(from, to)) {
+			continue;
+		}
+		if (from->type == DEG_NODE_TYPE_OPERATION) {
+			graph->add_new_relation((OperationDepsNode *)from,
+			                        (OperationDepsNode *)to,
+			                        relation.description);
+		}
+		else {
+			graph->add_new_relation(from, to, relation.description);
+		}
+	}
+}
+
+}  /* namespace */
+
+bool deg_graph_build_partial(Depsgraph *graph, Main *bmain, Scene *scene)
+{
+	/* Objects of the background scene are built for that scene, keep things
+	 * simple and rebuild everything in this case.
+	 */
+	if (scene->set != NULL) {
+		return false;
+	}
+
+	/* Collect IDs to be rebuilt. */
+	GSet *id_nodes = BLI_gset_ptr_new("Depsgraph partial build id_nodes");
+	bool can_build_partial = true;
+	GSET_FOREACH_BEGIN(ID *, id, graph->relations_tagged_ids)
+	{
+		IDDepsNode *id_node = graph->find_id_node(id);
+		if (id_node == NULL || GS(id->name) != ID_OB) {
+			can_build_partial = false;
+			break;
+		}
+		add_id_node_with_object_neighbours(id_nodes, id_node);
+	}
+	GSET_FOREACH_END();
+	if (can_build_partial) {
+		GSET_FOREACH_BEGIN(IDDepsNode *, id_node, id_nodes)
+		{
+			if (!object_can_build_partial((Object *)id_node->id_orig)) {
+				can_build_partial = false;
+				break;
+			}
+		}
+		GSET_FOREACH_END();
+	}
+	if (!can_build_partial) {
+		BLI_gset_free(id_nodes, NULL);
+		return false;
+	}
+
+	vector<Object *> objects;
+	GSET_FOREACH_BEGIN(IDDepsNode *, id_node, id_nodes)
+	{
+		objects.push_back((Object *)id_node->id_orig);
+	}
+	GSET_FOREACH_END();
+
+	ExternalRelations external_relations;
+	collect_external_relations(id_nodes, &external_relations);
+
+	/* 1) Remove old nodes and build new ones. */
+	DepsgraphNodeBuilder node_builder(bmain, graph);
+	node_builder.begin_partial_build(bmain, id_nodes);
+	foreach (Object *object, objects) {
+		node_builder.build_object(scene, object);
+	}
+
+	/* Collect nodes which were just built, including nodes of IDs which were
+	 * not in the graph before.
+	 */
+	BLI_gset_clear(id_nodes, NULL);
+	GHASH_FOREACH_BEGIN(IDDepsNode *, id_node, graph->id_hash)
+	{
+		if (id_node_is_new(id_node)) {
+			BLI_gset_add(id_nodes, id_node);
+		}
+	}
+	GHASH_FOREACH_END();
+
+	/* 2) Hook up relationships of the new nodes. */
+	DepsgraphRelationBuilder relation_builder(graph);
+	relation_builder.begin_partial_build(bmain, id_nodes);
+	foreach (Object *object, objects) {
+		relation_builder.build_object(bmain, scene, object);
+	}
+	restore_external_relations(graph, external_relations);
+#ifdef WITH_COPY_ON_WRITE
+	GSET_FOREACH_BEGIN(IDDepsNode *, id_node, id_nodes)
+	{
+		relation_builder.build_copy_on_write_relations(id_node);
+	}
+	GSET_FOREACH_END();
+#endif
+
+	/* Customdata mask of kept operations might have been changed by the
+	 * relations of rebuilt objects.
+	 */
+	foreach (OperationDepsNode *op_node, graph->operations) {
+		ID *id = op_node->owner->owner->id_orig;
+		if (GS(id->name) == ID_OB) {
+			Object *object = (Object *)id;
+			object->customdata_mask |= op_node->customdata_mask;
+		}
+	}
+
+	/* 3) Detect cycles and simplify the graph, same as full build. */
+	deg_graph_detect_cycles(graph);
+	if (G.debug_value == 799) {
+		deg_graph_transitive_reduction(graph);
+	}
+
+	/* 4) Finalize new nodes and tag them for update, the rest of the graph
+	 *    does not need to be re-evaluated. Kept nodes might also have got
+	 *    new components, so they are finalized as well.
+	 */
+	GHASH_FOREACH_BEGIN(IDDepsNode *, id_node, graph->id_hash)
+	{
+		id_node->finalize_build(graph);
+	}
+	GHASH_FOREACH_END();
+	GSET_FOREACH_BEGIN(IDDepsNode *, id_node, id_nodes)
+	{
+		id_node->tag_update(graph);
+#ifdef WITH_COPY_ON_WRITE
+		DEG_id_tag_update_ex(graph->bmain, id_node->id_orig, DEG_TAG_COPY_ON_WRITE);
+#endif
+	}
+	GSET_FOREACH_END();
+
+	BLI_gset_free(id_nodes, NULL);
+	return true;
+}
+
+}  // namespace DEG
@@ -0,0 +1,47 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2017 Blender Foundation.
+ * All rights reserved.
+ *
+ * Contributor(s): None Yet
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file blender/depsgraph/intern/builder/deg_builder_partial.h
+ *  \ingroup depsgraph
+ */
+
+#pragma once
+
+struct Main;
+struct Scene;
+
+namespace DEG {
+
+struct Depsgraph;
+
+/* Rebuild nodes and relations of the IDs which relations were tagged for
+ * update and of their direct neighbours, keeping the rest of the graph intact.
+ *
+ * Returns false if the change can not be handled partially. Graph is not
+ * modified in this case and is to be rebuilt from scratch.
+ */
+bool deg_graph_build_partial(Depsgraph *graph, Main *bmain, Scene *scene);
+
+}  // namespace DEG
@@ -388,6 +388,18 @@ void DepsgraphRelationBuilder::begin_build(Main *bmain)
 	} FOREACH_NODETREE_END
 }
 
+void DepsgraphRelationBuilder::begin_partial_build(Main *bmain, GSet *id_nodes)
+{
+	begin_build(bmain);
+	GHASH_FOREACH_BEGIN(IDDepsNode *, id_node, m_graph->id_hash)
+	{
+		if (!BLI_gset_haskey(id_nodes, id_node)) {
+			id_node->id_orig->tag |= LIB_TAG_DOIT;
+		}
+	}
+	GHASH_FOREACH_END();
+}
+
 void DepsgraphRelationBuilder::build_group(Main *bmain,
                                            Scene *scene,
                                            Object *object,
@@ -50,6 +50,7 @@ struct bGPdata;
 struct CacheFile;
 struct ListBase;
 struct GHash;
+struct GSet;
 struct ID;
 struct FCurve;
 struct Group;
@@ -170,6 +171,10 @@ struct DepsgraphRelationBuilder
 	DepsgraphRelationBuilder(Depsgraph *graph);
 
 	void begin_build(Main *bmain);
+	/* Only build relations for the given ID nodes, relations of other nodes
+	 * are already in the graph.
+	 */
+	void begin_partial_build(Main *bmain, GSet *id_nodes);
 
 	template <typename KeyFrom, typename KeyTo>
 	void add_relation(const KeyFrom& key_from,
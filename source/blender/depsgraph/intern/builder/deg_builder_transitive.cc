@@ -32,6 +32,10 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_utildefines.h"
+#include "BLI_stack.h"
+#include "BLI_task.h"
+
 #include "intern/nodes/deg_node.h"
 #include "intern/nodes/deg_node_component.h"
 #include "intern/nodes/deg_node_operation.h"
@@ -55,65 +59,156 @@ namespace DEG {
  *
  * Care has to be taken to make sure the algorithm can handle the cyclic case
  * too! (unless we can to prevent this case early on).
+ *
+ * Redundant relations of every target are found independently from each other,
+ * so this is done from multiple threads. Relations are only removed once all
+ * the targets are handled, since removal modifies the graph being traversed.
  */
 
-enum {
-	OP_VISITED = 1,
-	OP_REACHABLE = 2,
+namespace {
+
+typedef DepsNode::Relations Relations;
+
+struct TransitiveReductionData {
+	Depsgraph *graph;
+	int num_operations;
 };
 
-static void deg_graph_tag_paths_recursive(DepsNode *node)
+/* Per-thread storage. Nodes are addressed by their index in the graph, and
+ * marked with a unique per-target stamp, so there is no need to clear tags
+ * between targets.
+ */
+struct TransitiveReductionThreadData {
+	int *visited;
+	int *reachable;
+	BLI_Stack *stack;
+	Relations *redundant_relations;
+};
+
+void transitive_reduction_thread_data_ensure(
+        const TransitiveReductionData *data,
+        TransitiveReductionThreadData *thread_data)
 {
-	if (node->done & OP_VISITED) {
+	if (thread_data->visited != NULL) {
 		return;
 	}
-	node->done |= OP_VISITED;
-	foreach (DepsRelation *rel, node->inlinks) {
-		deg_graph_tag_paths_recursive(rel->from);
-		/* Do this only in inlinks loop, so the target node does not get
-		 * flagged.
-		 */
-		rel->from->done |= OP_REACHABLE;
-	}
+	thread_data->visited = (int *)MEM_callocN(
+	        sizeof(int) * data->num_operations, "transitive reduction visited");
+	thread_data->reachable = (int *)MEM_callocN(
+	        sizeof(int) * data->num_operations, "transitive reduction reachable");
+	thread_data->stack = BLI_stack_new(sizeof(OperationDepsNode *),
+	                                   "transitive reduction stack");
+	thread_data->redundant_relations = OBJECT_GUARDED_NEW(Relations);
 }
 
-void deg_graph_transitive_reduction(Depsgraph *graph)
+void transitive_reduction_push(TransitiveReductionThreadData *thread_data,
+                               OperationDepsNode *node,
+                               int stamp)
 {
-	foreach (OperationDepsNode *target, graph->operations) {
-		/* Clear tags. */
-		foreach (OperationDepsNode *node, graph->operations) {
-			node->done = 0;
-		}
+	if (thread_data->visited[node->tag] != stamp) {
+		thread_data->visited[node->tag] = stamp;
+		BLI_stack_push(thread_data->stack, &node);
+	}
+}
 
-		/* mark nodes from which we can reach the target
-		 * start with children, so the target node and direct children are not
-		 * flagged.
+void transitive_reduction_func(void *data_v,
+                               void *userdata_chunk,
+                               const int i,
+                               const int /*thread_id*/)
+{
+	TransitiveReductionData *data = (TransitiveReductionData *)data_v;
+	TransitiveReductionThreadData *thread_data =
+	        (TransitiveReductionThreadData *)userdata_chunk;
+	OperationDepsNode *target = data->graph->operations[i];
+	if (target->inlinks.size() < 2) {
+		/* Single relation can not be redundant. */
+		return;
+	}
+	transitive_reduction_thread_data_ensure(data, thread_data);
+	const int stamp = i + 1;
+	int *reachable = thread_data->reachable;
+
+	/* Mark nodes from which we can reach the target, start with children,
+	 * so the target node and direct children are not flagged.
+	 */
+	thread_data->visited[target->tag] = stamp;
+	foreach (DepsRelation *rel, target->inlinks) {
+		/* Time source nodes are not addressed by index, they never have
+		 * inlinks anyway.
 		 */
-		target->done |= OP_VISITED;
-		foreach (DepsRelation *rel, target->inlinks) {
-			deg_graph_tag_paths_recursive(rel->from);
+		if (rel->from->type == DEG_NODE_TYPE_OPERATION) {
+			transitive_reduction_push(thread_data,
+			                          (OperationDepsNode *)rel->from,
+			                          stamp);
 		}
-
-		/* Remove redundant paths to the target. */
-		for (DepsNode::Relations::const_iterator it_rel = target->inlinks.begin();
-		     it_rel != target->inlinks.end();
-		     )
-		{
-			DepsRelation *rel = *it_rel;
-			/* Increment in advance, so we can safely remove the relation. */
-			++it_rel;
-
-			if (rel->from->type == DEG_NODE_TYPE_TIMESOURCE) {
-				/* HACK: time source nodes don't get "done" flag set/cleared. */
-				/* TODO: there will be other types in future, so iterators above
-				 * need modifying.
-				 */
-			}
-			else if (rel->from->done & OP_REACHABLE) {
-				OBJECT_GUARDED_DELETE(rel, DepsRelation);
+	}
+	while (!BLI_stack_is_empty(thread_data->stack)) {
+		OperationDepsNode *node;
+		BLI_stack_pop(thread_data->stack, &node);
+		foreach (DepsRelation *rel, node->inlinks) {
+			if (rel->from->type == DEG_NODE_TYPE_OPERATION) {
+				OperationDepsNode *from = (OperationDepsNode *)rel->from;
+				reachable[from->tag] = stamp;
+				transitive_reduction_push(thread_data, from, stamp);
 			}
 		}
 	}
+
+	/* Remember redundant paths to the target. */
+	foreach (DepsRelation *rel, target->inlinks) {
+		if (rel->from->type != DEG_NODE_TYPE_OPERATION) {
+			/* HACK: time source nodes don't get "done" flag set/cleared. */
+			/* TODO: there will be other types in future, so iterators above
+			 * need modifying.
+			 */
+			continue;
+		}
+		OperationDepsNode *from = (OperationDepsNode *)rel->from;
+		if (reachable[from->tag] == stamp) {
+			thread_data->redundant_relations->push_back(rel);
+		}
+	}
+}
+
+void transitive_reduction_finalize(void * /*data_v*/, void *userdata_chunk)
+{
+	TransitiveReductionThreadData *thread_data =
+	        (TransitiveReductionThreadData *)userdata_chunk;
+	if (thread_data->visited == NULL) {
+		return;
+	}
+	/* All threads are done with traversal, safe to modify the graph now. */
+	foreach (DepsRelation *rel, *thread_data->redundant_relations) {
+		rel->unlink();
+		OBJECT_GUARDED_DELETE(rel, DepsRelation);
+	}
+	OBJECT_GUARDED_DELETE(thread_data->redundant_relations, Relations);
+	BLI_stack_free(thread_data->stack);
+	MEM_freeN(thread_data->visited);
+	MEM_freeN(thread_data->reachable);
+}
+
+}  /* namespace */
+
+void deg_graph_transitive_reduction(Depsgraph *graph)
+{
+	const int num_operations = graph->operations.size();
+	/* Index operations, so threads can store their tags separately. */
+	for (int i = 0; i < num_operations; ++i) {
+		graph->operations[i]->tag = i;
+	}
+	TransitiveReductionData data;
+	data.graph = graph;
+	data.num_operations = num_operations;
+	TransitiveReductionThreadData thread_data = {NULL};
+	BLI_task_parallel_range_finalize(0, num_operations,
+	                                 &data,
+	                                 &thread_data,
+	                                 sizeof(thread_data),
+	                                 transitive_reduction_func,
+	                                 transitive_reduction_finalize,
+	                                 num_operations > 256,
+	                                 true);
 }
 
 }  // namespace DEG
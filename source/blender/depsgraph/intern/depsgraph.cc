@@ -36,6 +36,7 @@
 
 #include "BLI_utildefines.h"
 #include "BLI_ghash.h"
+#include "BLI_flathash.h"
 #include "BLI_listbase.h"
 
 extern "C" {
@@ -49,11 +50,13 @@ extern "C" {
 #include "RNA_access.h"
 }
 
+#include <algorithm>
 #include <cstring>
 
 #include "DEG_depsgraph.h"
 
 #include "intern/eval/deg_eval_copy_on_write.h"
+#include "intern/eval/deg_eval_profile.h"
 
 #include "intern/nodes/deg_node.h"
 #include "intern/nodes/deg_node_component.h"
@@ -70,21 +73,27 @@ static DEG_EditorUpdateScenePreCb deg_editor_update_scene_pre_cb = NULL;
 
 Depsgraph::Depsgraph()
   : time_source(NULL),
-    need_update(false)
+    need_update(false),
+    profile(NULL)
 {
 	BLI_spin_init(&lock);
 	id_hash = BLI_ghash_ptr_new("Depsgraph id hash");
-	entry_tags = BLI_gset_ptr_new("Depsgraph entry_tags");
+	entry_tags = BLI_flatset_ptr_new("Depsgraph entry_tags");
+	relations_tagged_ids = BLI_gset_ptr_new("Depsgraph relations_tagged_ids");
 }
 
 Depsgraph::~Depsgraph()
 {
 	clear_id_nodes();
 	BLI_ghash_free(id_hash, NULL, NULL);
-	BLI_gset_free(entry_tags, NULL);
+	BLI_flatset_free(entry_tags, NULL);
+	BLI_gset_free(relations_tagged_ids, NULL);
 	if (time_source != NULL) {
 		OBJECT_GUARDED_DELETE(time_source, TimeSourceDepsNode);
 	}
+	if (profile != NULL) {
+		OBJECT_GUARDED_DELETE(profile, DepsgraphProfile);
+	}
 	BLI_spin_end(&lock);
 }
 
@@ -302,6 +311,52 @@ IDDepsNode *Depsgraph::add_id_node(ID *id, bool do_tag, ID *id_cow_hint)
 	return id_node;
 }
 
+void Depsgraph::remove_id_nodes(GSet *id_nodes)
+{
+	/* Remove operations from the graph-level storage. */
+	size_t num_operations = 0;
+	foreach (OperationDepsNode *op_node, operations) {
+		IDDepsNode *id_node = op_node->owner->owner;
+		if (!BLI_gset_haskey(id_nodes, id_node)) {
+			op_node->index = num_operations;
+			operations[num_operations++] = op_node;
+		}
+	}
+	operations.resize(num_operations);
+	/* Timing records are referencing operations which are to be freed. */
+	if (profile != NULL) {
+		OBJECT_GUARDED_DELETE(profile, DepsgraphProfile);
+		profile = NULL;
+	}
+	GSET_FOREACH_BEGIN(IDDepsNode *, id_node, id_nodes)
+	{
+		GHASH_FOREACH_BEGIN(ComponentDepsNode *, comp_node, id_node->components)
+		{
+			foreach (OperationDepsNode *op_node, comp_node->operations) {
+				BLI_flatset_remove(entry_tags, op_node, NULL);
+				/* Relation is removed from both nodes it connects, so there
+				 * is no double-free when relations are between nodes which
+				 * are both being removed.
+				 */
+				while (!op_node->inlinks.empty()) {
+					DepsRelation *rel = op_node->inlinks.back();
+					rel->unlink();
+					OBJECT_GUARDED_DELETE(rel, DepsRelation);
+				}
+				while (!op_node->outlinks.empty()) {
+					DepsRelation *rel = op_node->outlinks.back();
+					rel->unlink();
+					OBJECT_GUARDED_DELETE(rel, DepsRelation);
+				}
+			}
+		}
+		GHASH_FOREACH_END();
+		BLI_ghash_remove(id_hash, id_node->id_orig, NULL, NULL);
+		OBJECT_GUARDED_DELETE(id_node, IDDepsNode);
+	}
+	GSET_FOREACH_END();
+}
+
 void Depsgraph::clear_id_nodes()
 {
 #ifndef WITH_COPY_ON_WRITE
@@ -419,6 +474,21 @@ DepsRelation::~DepsRelation()
 	BLI_assert(this->from && this->to);
 }
 
+void DepsRelation::unlink()
+{
+	/* Sanity check. */
+	BLI_assert(this->from && this->to);
+	DepsNode::Relations::iterator it;
+	it = std::find(from->outlinks.begin(), from->outlinks.end(), this);
+	if (it != from->outlinks.end()) {
+		from->outlinks.erase(it);
+	}
+	it = std::find(to->inlinks.begin(), to->inlinks.end(), this);
+	if (it != to->inlinks.end()) {
+		to->inlinks.erase(it);
+	}
+}
+
 /* Low level tagging -------------------------------------- */
 
 /* Tag a specific node as needing updates. */
@@ -431,7 +501,7 @@ void Depsgraph::add_entry_tag(OperationDepsNode *node)
 	/* Add to graph-level set of directly modified nodes to start searching from.
 	 * NOTE: this is necessary since we have several thousand nodes to play with...
 	 */
-	BLI_gset_insert(entry_tags, node);
+	BLI_flatset_insert(entry_tags, node);
 }
 
 void Depsgraph::clear_all_nodes()
@@ -442,6 +512,10 @@ void Depsgraph::clear_all_nodes()
 		OBJECT_GUARDED_DELETE(time_source, TimeSourceDepsNode);
 		time_source = NULL;
 	}
+	if (profile != NULL) {
+		OBJECT_GUARDED_DELETE(profile, DepsgraphProfile);
+		profile = NULL;
+	}
 }
 
 ID *Depsgraph::get_cow_id(const ID *id_orig) const
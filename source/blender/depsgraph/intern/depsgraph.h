@@ -44,6 +44,7 @@ struct ID;
 struct GHash;
 struct Main;
 struct GSet;
+struct FlatSet;
 struct PointerRNA;
 struct PropertyRNA;
 struct Scene;
@@ -55,6 +56,7 @@ struct TimeSourceDepsNode;
 struct IDDepsNode;
 struct ComponentDepsNode;
 struct OperationDepsNode;
+struct DepsgraphProfile;
 
 /* *************************** */
 /* Relationships Between Nodes */
@@ -86,6 +88,11 @@ struct DepsRelation {
 	             const char *description);
 
 	~DepsRelation();
+
+	/* Remove relation from the nodes it connects, relation itself is not
+	 * freed.
+	 */
+	void unlink();
 };
 
 /* ********* */
@@ -115,6 +122,10 @@ struct Depsgraph {
 
 	IDDepsNode *find_id_node(const ID *id) const;
 	IDDepsNode *add_id_node(ID *id, bool do_tag = true, ID *id_cow_hint = NULL);
+	/* Remove given set of ID nodes from the graph, together with all the
+	 * relations they've got with the rest of the graph.
+	 */
+	void remove_id_nodes(GSet *id_nodes);
 	void clear_id_nodes();
 
 	/* Add new relationship between two nodes. */
@@ -149,10 +160,15 @@ struct Depsgraph {
 	/* Indicates whether relations needs to be updated. */
 	bool need_update;
 
+	/* IDs which relations were tagged for update. When the graph needs update
+	 * and this set is empty, the whole graph is to be rebuilt.
+	 */
+	GSet *relations_tagged_ids;
+
 	/* Quick-Access Temp Data ............. */
 
 	/* Nodes which have been tagged as "directly modified". */
-	GSet *entry_tags;
+	FlatSet *entry_tags;
 
 	/* Convenience Data ................... */
 
@@ -165,6 +181,11 @@ struct Depsgraph {
 	 */
 	SpinLock lock;
 
+	/* Timing of the last evaluation, only recorded with --debug-depsgraph-time.
+	 * Records point to operation nodes, so this is freed together with them.
+	 */
+	DepsgraphProfile *profile;
+
 	// XXX: additional stuff like eval contexts, mempools for allocating nodes from, etc.
 	Main *bmain;  /* XXX: For until depsgraph has proper ownership. */
 	Scene *scene; /* XXX: We really shouldn't do that, but it's required for shader preview. */
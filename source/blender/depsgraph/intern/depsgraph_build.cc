@@ -48,6 +48,7 @@ extern "C" {
 #include "DNA_scene_types.h"
 #include "DNA_object_force.h"
 
+#include "BKE_animsys.h"
 #include "BKE_main.h"
 #include "BKE_collision.h"
 #include "BKE_effect.h"
@@ -61,6 +62,7 @@ extern "C" {
 #include "builder/deg_builder.h"
 #include "builder/deg_builder_cycle.h"
 #include "builder/deg_builder_nodes.h"
+#include "builder/deg_builder_partial.h"
 #include "builder/deg_builder_relations.h"
 #include "builder/deg_builder_transitive.h"
 
@@ -205,6 +207,9 @@ void DEG_graph_build_from_scene(Depsgraph *graph, Main *bmain, Scene *scene)
 
 	DEG::Depsgraph *deg_graph = reinterpret_cast<DEG::Depsgraph *>(graph);
 
+	/* Paths resolved by animation might point to data of the old graph. */
+	BKE_animsys_rna_path_cache_invalidate();
+
 	/* 1) Generate all the nodes in the graph first */
 	DEG::DepsgraphNodeBuilder node_builder(bmain, deg_graph);
 	node_builder.begin_build(bmain);
@@ -252,6 +257,8 @@ void DEG_graph_tag_relations_update(Depsgraph *graph)
 {
 	DEG::Depsgraph *deg_graph = reinterpret_cast<DEG::Depsgraph *>(graph);
 	deg_graph->need_update = true;
+	BLI_gset_clear(deg_graph->relations_tagged_ids, NULL);
+	BKE_animsys_rna_path_cache_invalidate();
 }
 
 /* Tag all relations for update. */
@@ -268,6 +275,43 @@ void DEG_relations_tag_update(Main *bmain)
 	}
 }
 
+/* Tag relations of the given ID for update. */
+void DEG_graph_id_tag_relations_update(Depsgraph *graph, ID *id)
+{
+	DEG::Depsgraph *deg_graph = reinterpret_cast<DEG::Depsgraph *>(graph);
+	if (deg_graph->need_update &&
+	    BLI_gset_size(deg_graph->relations_tagged_ids) == 0)
+	{
+		/* Graph is already tagged for full rebuild. */
+		return;
+	}
+	if (deg_graph->find_id_node(id) == NULL) {
+		/* ID is not in the graph yet, it's not known what it is connected
+		 * to, so rebuild everything.
+		 */
+		DEG_graph_tag_relations_update(graph);
+		return;
+	}
+	deg_graph->need_update = true;
+	BLI_gset_add(deg_graph->relations_tagged_ids, id);
+	BKE_animsys_rna_path_cache_invalidate();
+}
+
+/* Tag relations of the given ID for update in all graphs. */
+void DEG_id_relations_tag_update(Main *bmain, ID *id)
+{
+	DEG_DEBUG_PRINTF("%s: Tagging relations of %s for update.\n",
+	                 __func__, id->name);
+	for (Scene *scene = (Scene *)bmain->scene.first;
+	     scene != NULL;
+	     scene = (Scene *)scene->id.next)
+	{
+		if (scene->depsgraph_legacy != NULL) {
+			DEG_graph_id_tag_relations_update(scene->depsgraph_legacy, id);
+		}
+	}
+}
+
 /* Create new graph if didn't exist yet,
  * or update relations if graph was tagged for update.
  */
@@ -286,11 +330,18 @@ void DEG_scene_relations_update(Main *bmain, Scene *scene)
 		return;
 	}
 
-	/* Build new nodes and relations. */
-	DEG_graph_build_from_scene(reinterpret_cast< ::Depsgraph * >(graph),
-	                           bmain,
-	                           scene);
+	/* Build new nodes and relations, only touching IDs which were tagged
+	 * for update when possible.
+	 */
+	if (BLI_gset_size(graph->relations_tagged_ids) == 0 ||
+	    !DEG::deg_graph_build_partial(graph, bmain, scene))
+	{
+		DEG_graph_build_from_scene(reinterpret_cast< ::Depsgraph * >(graph),
+		                           bmain,
+		                           scene);
+	}
 
+	BLI_gset_clear(graph->relations_tagged_ids, NULL);
 	graph->need_update = false;
 }
 
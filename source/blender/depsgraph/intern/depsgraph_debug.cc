@@ -42,6 +42,7 @@ extern "C" {
 #include "DEG_depsgraph_build.h"
 
 #include "intern/eval/deg_eval_debug.h"
+#include "intern/eval/deg_eval_profile.h"
 #include "intern/depsgraph_intern.h"
 #include "util/deg_util_foreach.h"
 
@@ -194,6 +195,28 @@ bool DEG_debug_consistency_check(Depsgraph *graph)
 
 /* ------------------------------------------------ */
 
+bool DEG_debug_eval_profile_print(const Depsgraph *graph, FILE *stream)
+{
+	const DEG::Depsgraph *deg_graph = reinterpret_cast<const DEG::Depsgraph *>(graph);
+	if (deg_graph->profile == NULL) {
+		return false;
+	}
+	deg_graph->profile->print_summary(stream);
+	return true;
+}
+
+bool DEG_debug_eval_profile_write_trace(const Depsgraph *graph, FILE *stream)
+{
+	const DEG::Depsgraph *deg_graph = reinterpret_cast<const DEG::Depsgraph *>(graph);
+	if (deg_graph->profile == NULL) {
+		return false;
+	}
+	deg_graph->profile->write_trace(stream);
+	return true;
+}
+
+/* ------------------------------------------------ */
+
 /**
  * Obtain simple statistics about the complexity of the depsgraph
  * \param[out] r_outer       The number of outer nodes in the graph
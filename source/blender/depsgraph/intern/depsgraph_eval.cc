@@ -34,6 +34,7 @@
 
 #include "BLI_utildefines.h"
 #include "BLI_ghash.h"
+#include "BLI_flathash.h"
 
 extern "C" {
 #include "BKE_scene.h"
@@ -123,5 +124,5 @@ void DEG_evaluate_on_framechange(EvaluationContext *eval_ctx,
 bool DEG_needs_eval(Depsgraph *graph)
 {
 	DEG::Depsgraph *deg_graph = reinterpret_cast<DEG::Depsgraph *>(graph);
-	return BLI_gset_size(deg_graph->entry_tags) != 0;
+	return BLI_flatset_size(deg_graph->entry_tags) != 0;
 }
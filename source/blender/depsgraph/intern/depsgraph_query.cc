@@ -116,6 +116,21 @@ ID *DEG_get_evaluated_id(struct Depsgraph *depsgraph, ID *id)
 	return id_node->id_cow;
 }
 
+void *DEG_evaluated_id_arena_alloc(struct Depsgraph *depsgraph, const ID *id, size_t size)
+{
+	DEG::Depsgraph *deg_graph = (DEG::Depsgraph *)depsgraph;
+	/* Copy-on-write datablocks are linked to their original one. */
+	if (id->tag & LIB_TAG_COPY_ON_WRITE) {
+		id = id->newid;
+	}
+	DEG::IDDepsNode *id_node = deg_graph->find_id_node(id);
+	BLI_assert(id_node != NULL);
+	if (id_node == NULL) {
+		return NULL;
+	}
+	return id_node->eval_arena_alloc(size);
+}
+
 /* ************************ DAG ITERATORS ********************* */
 
 #define BASE_FLUSH_FLAGS (BASE_FROM_SET | BASE_FROMDUPLI)
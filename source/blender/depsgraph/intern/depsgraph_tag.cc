@@ -45,6 +45,7 @@ extern "C" {
 #include "DNA_windowmanager_types.h"
 
 
+#include "BKE_animsys.h"
 #include "BKE_idcode.h"
 #include "BKE_library.h"
 #include "BKE_main.h"
@@ -375,6 +376,10 @@ void DEG_id_tag_update_ex(Main *bmain, ID *id, int flag)
 		return;
 	}
 	DEG_DEBUG_PRINTF("%s: id=%s flag=%d\n", __func__, id->name, flag);
+	/* Data may have been added or removed, so paths resolved by animation
+	 * can not be trusted anymore.
+	 */
+	BKE_animsys_rna_path_cache_invalidate();
 	DEG::deg_id_tag_update(bmain, id, flag);
 }
 
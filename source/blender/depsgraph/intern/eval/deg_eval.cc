@@ -32,11 +32,14 @@
 
 #include "intern/eval/deg_eval.h"
 
+#include <algorithm>
+
 #include "PIL_time.h"
 
 #include "BLI_utildefines.h"
 #include "BLI_task.h"
 #include "BLI_ghash.h"
+#include "BLI_flathash.h"
 
 #include "DNA_object_types.h"
 
@@ -47,6 +50,7 @@
 
 #include "intern/eval/deg_eval_debug.h"
 #include "intern/eval/deg_eval_flush.h"
+#include "intern/eval/deg_eval_profile.h"
 #include "intern/nodes/deg_node.h"
 #include "intern/nodes/deg_node_component.h"
 #include "intern/nodes/deg_node_operation.h"
@@ -54,8 +58,10 @@
 #include "intern/depsgraph_intern.h"
 #include "util/deg_util_foreach.h"
 
-/* Unfinished and unused, and takes quite some pre-processing time. */
-#undef USE_EVAL_PRIORITY
+/* Maximum number of ready children which are sorted by priority before being
+ * scheduled, the rest is pushed in batches of this size.
+ */
+#define MAX_READY_NODES_BATCH 64
 
 /* Use integrated debugger to keep track how much each of the nodes was
  * evaluating.
@@ -76,6 +82,8 @@ static void schedule_children(TaskPool *pool,
 struct DepsgraphEvalState {
 	EvaluationContext *eval_ctx;
 	Depsgraph *graph;
+	/* Only set when profiling is enabled. */
+	DepsgraphProfile *profile;
 };
 
 static void deg_task_run_func(TaskPool *pool,
@@ -111,7 +119,18 @@ static void deg_task_run_func(TaskPool *pool,
 #endif
 
 		/* Perform operation. */
-		node->evaluate(state->eval_ctx);
+		if (state->profile != NULL) {
+			const double start_time = PIL_check_seconds_timer();
+			node->evaluate(state->eval_ctx);
+			state->profile->add_record(node,
+			                           node->ready_time,
+			                           start_time,
+			                           PIL_check_seconds_timer(),
+			                           thread_id);
+		}
+		else {
+			node->evaluate(state->eval_ctx);
+		}
 
 			/* Note how long this took. */
 #ifdef USE_DEBUGGER
@@ -168,7 +187,11 @@ static void calculate_pending_parents(Depsgraph *graph)
 	                        do_threads);
 }
 
-#ifdef USE_EVAL_PRIORITY
+/* Priority of a node is the length of the longest path of operations which
+ * are to be evaluated after it (critical path). Scheduling nodes with longest
+ * paths first keeps long chains (such as bone chains of rigs) from starting
+ * last and delaying the whole evaluation.
+ */
 static void calculate_eval_priority(OperationDepsNode *node)
 {
 	if (node->done) {
@@ -179,28 +202,75 @@ static void calculate_eval_priority(OperationDepsNode *node)
 	if (node->flag & DEPSOP_FLAG_NEEDS_UPDATE) {
 		/* XXX standard cost of a node, could be estimated somewhat later on */
 		const float cost = 1.0f;
-		/* NOOP nodes have no cost */
-		node->eval_priority = node->is_noop() ? cost : 0.0f;
-
+		float max_child_priority = 0.0f;
 		foreach (DepsRelation *rel, node->outlinks) {
+			if (rel->flag & DEPSREL_FLAG_CYCLIC) {
+				continue;
+			}
 			OperationDepsNode *to = (OperationDepsNode *)rel->to;
 			BLI_assert(to->type == DEG_NODE_TYPE_OPERATION);
 			calculate_eval_priority(to);
-			node->eval_priority += to->eval_priority;
+			max_child_priority = std::max(max_child_priority, to->eval_priority);
 		}
+		/* NOOP nodes have no cost */
+		node->eval_priority = (node->is_noop() ? 0.0f : cost) + max_child_priority;
 	}
 	else {
 		node->eval_priority = 0.0f;
 	}
 }
-#endif
+
+static bool eval_priority_greater(const OperationDepsNode *a,
+                                  const OperationDepsNode *b)
+{
+	return a->eval_priority > b->eval_priority;
+}
+
+/* Push nodes which are ready for evaluation, most critical ones first.
+ *
+ * When pushing from a worker thread the first node will be picked up by the
+ * same thread right after the current one, the rest is available for other
+ * threads to steal in the same order.
+ */
+static void schedule_ready_nodes(TaskPool *pool,
+                                 OperationDepsNode **nodes,
+                                 const int num_nodes,
+                                 const int thread_id)
+{
+	DepsgraphEvalState *state =
+	        reinterpret_cast<DepsgraphEvalState *>(BLI_task_pool_userdata(pool));
+	std::sort(nodes, nodes + num_nodes, eval_priority_greater);
+	if (state->profile != NULL) {
+		const double ready_time = PIL_check_seconds_timer();
+		for (int i = 0; i < num_nodes; ++i) {
+			nodes[i]->ready_time = ready_time;
+		}
+	}
+	for (int i = 0; i < num_nodes; ++i) {
+		BLI_task_pool_push_from_thread(pool,
+		                               deg_task_run_func,
+		                               nodes[i],
+		                               false,
+		                               (i == 0) ? TASK_PRIORITY_HIGH
+		                                        : TASK_PRIORITY_LOW,
+		                               thread_id);
+	}
+}
+
+struct ReadyNodes {
+	OperationDepsNode *nodes[MAX_READY_NODES_BATCH];
+	int num_nodes;
+};
 
 /* Schedule a node if it needs evaluation.
  *   dec_parents: Decrement pending parents count, true when child nodes are
  *                scheduled after a task has been completed.
+ *   ready_nodes: Nodes which are ready for evaluation are collected here to
+ *                be pushed in the order of their priority.
  */
 static void schedule_node(TaskPool *pool, Depsgraph *graph,
                           OperationDepsNode *node, bool dec_parents,
+                          ReadyNodes *ready_nodes,
                           const int thread_id)
 {
 	if ((node->flag & DEPSOP_FLAG_NEEDS_UPDATE) != 0) {
@@ -219,12 +289,14 @@ static void schedule_node(TaskPool *pool, Depsgraph *graph,
 				}
 				else {
 					/* children are scheduled once this task is completed */
-					BLI_task_pool_push_from_thread(pool,
-					                               deg_task_run_func,
-					                               node,
-					                               false,
-					                               TASK_PRIORITY_HIGH,
-					                               thread_id);
+					if (ready_nodes->num_nodes == MAX_READY_NODES_BATCH) {
+						schedule_ready_nodes(pool,
+						                     ready_nodes->nodes,
+						                     ready_nodes->num_nodes,
+						                     thread_id);
+						ready_nodes->num_nodes = 0;
+					}
+					ready_nodes->nodes[ready_nodes->num_nodes++] = node;
 				}
 			}
 		}
@@ -233,9 +305,12 @@ static void schedule_node(TaskPool *pool, Depsgraph *graph,
 
 static void schedule_graph(TaskPool *pool, Depsgraph *graph)
 {
+	ReadyNodes ready_nodes;
+	ready_nodes.num_nodes = 0;
 	foreach (OperationDepsNode *node, graph->operations) {
-		schedule_node(pool, graph, node, false, 0);
+		schedule_node(pool, graph, node, false, &ready_nodes, 0);
 	}
+	schedule_ready_nodes(pool, ready_nodes.nodes, ready_nodes.num_nodes, 0);
 }
 
 static void schedule_children(TaskPool *pool,
@@ -243,6 +318,8 @@ static void schedule_children(TaskPool *pool,
                               OperationDepsNode *node,
                               const int thread_id)
 {
+	ReadyNodes ready_nodes;
+	ready_nodes.num_nodes = 0;
 	foreach (DepsRelation *rel, node->outlinks) {
 		OperationDepsNode *child = (OperationDepsNode *)rel->to;
 		BLI_assert(child->type == DEG_NODE_TYPE_OPERATION);
@@ -254,8 +331,10 @@ static void schedule_children(TaskPool *pool,
 		              graph,
 		              child,
 		              (rel->flag & DEPSREL_FLAG_CYCLIC) == 0,
+		              &ready_nodes,
 		              thread_id);
 	}
+	schedule_ready_nodes(pool, ready_nodes.nodes, ready_nodes.num_nodes, thread_id);
 }
 
 /**
@@ -272,7 +351,7 @@ void deg_evaluate_on_refresh(EvaluationContext *eval_ctx,
 	// TODO: this needs both main and scene access...
 
 	/* Nothing to update, early out. */
-	if (BLI_gset_size(graph->entry_tags) == 0) {
+	if (BLI_flatset_size(graph->entry_tags) == 0) {
 		return;
 	}
 
@@ -285,6 +364,7 @@ void deg_evaluate_on_refresh(EvaluationContext *eval_ctx,
 	DepsgraphEvalState state;
 	state.eval_ctx = eval_ctx;
 	state.graph = graph;
+	state.profile = NULL;
 
 	TaskScheduler *task_scheduler;
 	bool need_free_scheduler;
@@ -298,6 +378,14 @@ void deg_evaluate_on_refresh(EvaluationContext *eval_ctx,
 		need_free_scheduler = false;
 	}
 
+	if (G.debug & G_DEBUG_DEPSGRAPH_TIME) {
+		if (graph->profile == NULL) {
+			graph->profile = OBJECT_GUARDED_NEW(DepsgraphProfile);
+		}
+		state.profile = graph->profile;
+		state.profile->begin(BLI_task_scheduler_num_threads(task_scheduler));
+	}
+
 	TaskPool *task_pool = BLI_task_pool_create_suspended(task_scheduler, &state);
 
 	calculate_pending_parents(graph);
@@ -308,11 +396,9 @@ void deg_evaluate_on_refresh(EvaluationContext *eval_ctx,
 	}
 
 	/* Calculate priority for operation nodes. */
-#ifdef USE_EVAL_PRIORITY
 	foreach (OperationDepsNode *node, graph->operations) {
 		calculate_eval_priority(node);
 	}
-#endif
 
 	DepsgraphDebug::eval_begin(eval_ctx);
 
@@ -321,6 +407,11 @@ void deg_evaluate_on_refresh(EvaluationContext *eval_ctx,
 	BLI_task_pool_work_and_wait(task_pool);
 	BLI_task_pool_free(task_pool);
 
+	if (state.profile != NULL) {
+		state.profile->end();
+		state.profile->print_summary(stdout);
+	}
+
 	DepsgraphDebug::eval_end(eval_ctx);
 
 	/* Clear any uncleared tags - just in case. */
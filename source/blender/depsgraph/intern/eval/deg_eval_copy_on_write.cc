@@ -48,6 +48,7 @@
 #include "BKE_layer.h"
 #include "BKE_library.h"
 #include "BKE_main.h"
+#include "BKE_mesh.h"
 #include "BKE_scene.h"
 
 #include "DEG_depsgraph.h"
@@ -279,6 +280,40 @@ bool id_copy_no_main(const ID *id, ID **newid)
 	return result;
 }
 
+/* Similar to id_copy_no_main() but geometry arrays of the copied mesh are
+ * referencing the original ones instead of being duplicated.
+ *
+ * TODO(sergey): Get rid of this once T51804 is handled.
+ */
+bool mesh_copy_no_main(const Mesh *mesh, ID **newid)
+{
+	const ID *id_for_copy = &mesh->id;
+	Main temp_bmain = {0};
+	SpinLock lock;
+	temp_bmain.lock = (MainLock *)&lock;
+	BLI_spin_init(&lock);
+
+#ifdef NESTED_ID_NASTY_WORKAROUND
+	NestedIDHackTempStorage id_hack_storage;
+	id_for_copy = nested_id_hack_get_discarded_pointers(&id_hack_storage,
+	                                                    &mesh->id);
+#endif
+
+	Mesh *new_mesh = BKE_mesh_copy_ex(&temp_bmain,
+	                                  (const Mesh *)id_for_copy,
+	                                  true);
+	*newid = (ID *)new_mesh;
+
+#ifdef NESTED_ID_NASTY_WORKAROUND
+	if (new_mesh != NULL) {
+		nested_id_hack_restore_pointers(&mesh->id, *newid);
+	}
+#endif
+
+	BLI_spin_end(&lock);
+	return new_mesh != NULL;
+}
+
 void layer_collections_sync_flags(ListBase *layer_collections_dst,
                                   const ListBase *layer_collections_src)
 {
@@ -666,12 +701,10 @@ ID *deg_expand_copy_on_write_datablock(const Depsgraph *depsgraph,
 	 */
 	if (check_datablock_expanded(id_cow) && create_placeholders) {
 		deg_free_copy_on_write_datablock(id_cow);
+		id_node->eval_arena_clear();
 	}
 	// BLI_assert(check_datablock_expanded(id_cow) == false);
 	/* Copy data from original ID to a copied version. */
-	/* TODO(sergey): Avoid doing full ID copy somehow, make Mesh to reference
-	 * original geometry arrays for until those are modified.
-	 */
 	/* TODO(sergey): We do some trickery with temp bmain and extra ID pointer
 	 * just to be able to use existing API. Ideally we need to replace this with
 	 * in-place copy from existing datablock to a prepared memory.
@@ -702,9 +735,15 @@ ID *deg_expand_copy_on_write_datablock(const Depsgraph *depsgraph,
 		}
 		case ID_ME:
 		{
-			/* TODO(sergey): Ideally we want to handle meshes in a special
-			 * manner here to avoid initial copy of all the geometry arrays.
+			/* Geometry arrays are referenced from the original mesh, so we
+			 * avoid initial copy of all of them. Evaluation code duplicates
+			 * referenced layers before modifying them.
 			 */
+			if (mesh_copy_no_main((const Mesh *)id_orig, &newid)) {
+				const size_t size = BKE_libblock_get_alloc_info(ID_ME, NULL);
+				memcpy(id_cow, newid, size);
+				done = true;
+			}
 			break;
 		}
 	}
@@ -839,6 +878,7 @@ ID *deg_update_copy_on_write_datablock(const Depsgraph *depsgraph,
 		}
 	}
 	deg_free_copy_on_write_datablock(id_cow);
+	id_node->eval_arena_clear();
 	deg_expand_copy_on_write_datablock(depsgraph, id_node);
 	/* Restore GPU materials. */
 	if (gpumaterial_ptr != NULL) {
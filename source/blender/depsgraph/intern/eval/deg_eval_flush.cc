@@ -32,12 +32,13 @@
 
 #include "intern/eval/deg_eval_flush.h"
 
-// TODO(sergey): Use some sort of wrapper.
-#include <deque>
+#include "MEM_guardedalloc.h"
 
 #include "BLI_utildefines.h"
+#include "BLI_bitmap.h"
 #include "BLI_task.h"
 #include "BLI_ghash.h"
+#include "BLI_flathash.h"
 
 extern "C" {
 #include "DNA_object_types.h"
@@ -54,20 +55,20 @@ extern "C" {
 
 namespace DEG {
 
-typedef std::deque<OperationDepsNode *> FlushQueue;
+typedef vector<OperationDepsNode *> FlushQueue;
 
-static void flush_init_func(void *data_v, int i)
+/* Tag operation as visited by the flush, returns false if it was already
+ * visited before.
+ */
+BLI_INLINE bool flush_visit_operation(BLI_bitmap *visited_ops,
+                                      OperationDepsNode *node)
 {
-	/* ID node's done flag is used to avoid multiple editors update
-	 * for the same ID.
-	 */
-	Depsgraph *graph = (Depsgraph *)data_v;
-	OperationDepsNode *node = graph->operations[i];
-	ComponentDepsNode *comp_node = node->owner;
-	IDDepsNode *id_node = comp_node->owner;
-	id_node->done = 0;
-	comp_node->done = 0;
-	node->scheduled = false;
+	BLI_assert(node->index >= 0);
+	if (BLI_BITMAP_TEST(visited_ops, node->index)) {
+		return false;
+	}
+	BLI_BITMAP_ENABLE(visited_ops, node->index);
+	return true;
 }
 
 /* Flush updates from tagged nodes outwards until all affected nodes
@@ -81,39 +82,40 @@ void deg_graph_flush_updates(Main *bmain, Depsgraph *graph)
 	}
 
 	/* Nothing to update, early out. */
-	if (BLI_gset_size(graph->entry_tags) == 0) {
+	if (BLI_flatset_size(graph->entry_tags) == 0) {
 		return;
 	}
 
-	/* TODO(sergey): With a bit of flag magic we can get rid of this
-	 * extra loop.
+	/* Visited operations are stored in a bitmap indexed by the operation
+	 * index, so the flush does not need to visit every operation of the graph
+	 * to clear tags from the previous flush. Done flags of ID and component
+	 * nodes are only set by the flush, so they are cleared for the nodes
+	 * which were reached once it's finished.
 	 */
 	const int num_operations = graph->operations.size();
-	const bool do_threads = num_operations > 256;
-	BLI_task_parallel_range(0,
-	                        num_operations,
-	                        graph,
-	                        flush_init_func,
-	                        do_threads);
+	BLI_bitmap *visited_ops = BLI_BITMAP_NEW(num_operations, __func__);
+	vector<ComponentDepsNode *> flushed_components;
 
 	FlushQueue queue;
+	queue.reserve(BLI_flatset_size(graph->entry_tags));
 	/* Starting from the tagged "entry" nodes, flush outwards... */
 	/* NOTE: Also need to ensure that for each of these, there is a path back to
 	 *       root, or else they won't be done.
 	 * NOTE: Count how many nodes we need to handle - entry nodes may be
 	 *       component nodes which don't count for this purpose!
 	 */
-	GSET_FOREACH_BEGIN(OperationDepsNode *, op_node, graph->entry_tags)
+	FLATSET_FOREACH_BEGIN(OperationDepsNode *, op_node, graph->entry_tags)
 	{
-		queue.push_back(op_node);
-		op_node->scheduled = true;
+		if (flush_visit_operation(visited_ops, op_node)) {
+			queue.push_back(op_node);
+		}
 	}
-	GSET_FOREACH_END();
+	FLATSET_FOREACH_END();
 
 	int num_flushed_objects = 0;
 	while (!queue.empty()) {
-		OperationDepsNode *node = queue.front();
-		queue.pop_front();
+		OperationDepsNode *node = queue.back();
+		queue.pop_back();
 
 		for (;;) {
 			node->flag |= DEPSOP_FLAG_NEEDS_UPDATE;
@@ -200,19 +202,18 @@ void deg_graph_flush_updates(Main *bmain, Depsgraph *graph)
 				}
 			}
 
+			if (comp_node->done == 0) {
+				flushed_components.push_back(comp_node);
+			}
 			id_node->done = 1;
 			comp_node->done = 1;
 
-			/* Flush to nodes along links... */
-			/* TODO(sergey): This is mainly giving speedup due ot less queue pushes, which
-			 * reduces number of memory allocations.
-			 *
-			 * We should try solve the allocation issue instead of doing crazy things here.
+			/* Flush to nodes along links, continuing with the operation
+			 * directly when there is a single one to avoid queue round-trip.
 			 */
 			if (node->outlinks.size() == 1) {
 				OperationDepsNode *to_node = (OperationDepsNode *)node->outlinks[0]->to;
-				if (to_node->scheduled == false) {
-					to_node->scheduled = true;
+				if (flush_visit_operation(visited_ops, to_node)) {
 					node = to_node;
 				}
 				else {
@@ -222,15 +223,22 @@ void deg_graph_flush_updates(Main *bmain, Depsgraph *graph)
 			else {
 				foreach (DepsRelation *rel, node->outlinks) {
 					OperationDepsNode *to_node = (OperationDepsNode *)rel->to;
-					if (to_node->scheduled == false) {
-						queue.push_front(to_node);
-						to_node->scheduled = true;
+					if (flush_visit_operation(visited_ops, to_node)) {
+						queue.push_back(to_node);
 					}
 				}
 				break;
 			}
 		}
 	}
+
+	/* Reset done flags for the next flush. */
+	foreach (ComponentDepsNode *comp_node, flushed_components) {
+		comp_node->done = 0;
+		comp_node->owner->done = 0;
+	}
+	MEM_freeN(visited_ops);
+
 	DEG_DEBUG_PRINTF("Update flushed to %d objects\n", num_flushed_objects);
 }
 
@@ -250,7 +258,7 @@ void deg_graph_clear_tags(Depsgraph *graph)
 	const bool do_threads = num_operations > 256;
 	BLI_task_parallel_range(0, num_operations, graph, graph_clear_func, do_threads);
 	/* Clear any entry tags which haven't been flushed. */
-	BLI_gset_clear(graph->entry_tags, NULL);
+	BLI_flatset_clear(graph->entry_tags, NULL);
 }
 
 }  // namespace DEG
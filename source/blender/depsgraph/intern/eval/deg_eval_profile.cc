@@ -0,0 +1,163 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2017 Blender Foundation.
+ * All rights reserved.
+ *
+ * Contributor(s): None Yet
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+
+/** \file blender/depsgraph/intern/eval/deg_eval_profile.cc
+ *  \ingroup depsgraph
+ *
+ * Per-operation timing of depsgraph evaluation.
+ */
+
+#include "intern/eval/deg_eval_profile.h"
+
+#include <algorithm>
+
+#include "PIL_time.h"
+
+#include "BLI_utildefines.h"
+
+#include "intern/nodes/deg_node_operation.h"
+#include "util/deg_util_foreach.h"
+
+namespace DEG {
+
+/* Number of slowest operations listed in the summary. */
+#define PROFILE_SUMMARY_NUM_OPERATIONS 10
+
+DepsgraphProfile::DepsgraphProfile()
+  : eval_start_time(0.0),
+    eval_end_time(0.0)
+{
+}
+
+DepsgraphProfile::~DepsgraphProfile()
+{
+}
+
+void DepsgraphProfile::begin(int num_threads)
+{
+	thread_records.resize(num_threads);
+	for (int i = 0; i < num_threads; ++i) {
+		thread_records[i].clear();
+	}
+	eval_start_time = PIL_check_seconds_timer();
+	eval_end_time = eval_start_time;
+}
+
+void DepsgraphProfile::end()
+{
+	eval_end_time = PIL_check_seconds_timer();
+}
+
+static bool profile_record_slower(const DepsgraphProfileRecord *a,
+                                  const DepsgraphProfileRecord *b)
+{
+	return (a->end_time - a->start_time) > (b->end_time - b->start_time);
+}
+
+void DepsgraphProfile::print_summary(FILE *stream) const
+{
+	vector<const DepsgraphProfileRecord *> records;
+	double busy_time = 0.0, wait_time = 0.0;
+	foreach (const vector<DepsgraphProfileRecord> &records_thread, thread_records) {
+		foreach (const DepsgraphProfileRecord &record, records_thread) {
+			busy_time += record.end_time - record.start_time;
+			wait_time += record.start_time - record.ready_time;
+			records.push_back(&record);
+		}
+	}
+	const double eval_time = eval_end_time - eval_start_time;
+	const int num_threads = thread_records.size();
+	fprintf(stream,
+	        "Depsgraph evaluation: %d operations in %.3f ms, "
+	        "%.3f ms busy on %d threads (%.1f%% utilization), "
+	        "%.3f ms spent ready but waiting for a thread\n",
+	        (int)records.size(),
+	        eval_time * 1000.0,
+	        busy_time * 1000.0,
+	        num_threads,
+	        (eval_time > 0.0) ? busy_time / (eval_time * num_threads) * 100.0 : 0.0,
+	        wait_time * 1000.0);
+	const int num_slowest = std::min((int)records.size(),
+	                                 PROFILE_SUMMARY_NUM_OPERATIONS);
+	std::partial_sort(records.begin(),
+	                  records.begin() + num_slowest,
+	                  records.end(),
+	                  profile_record_slower);
+	for (int i = 0; i < num_slowest; ++i) {
+		const DepsgraphProfileRecord *record = records[i];
+		fprintf(stream,
+		        "  %8.3f ms (waited %.3f ms, thread %d): %s\n",
+		        (record->end_time - record->start_time) * 1000.0,
+		        (record->start_time - record->ready_time) * 1000.0,
+		        record->thread_id,
+		        record->node->full_identifier().c_str());
+	}
+}
+
+static void profile_write_json_string(FILE *stream, const string &str)
+{
+	fputc('"', stream);
+	foreach (char c, str) {
+		if (c == '"' || c == '\\') {
+			fputc('\\', stream);
+			fputc(c, stream);
+		}
+		else if ((unsigned char)c < 0x20) {
+			fprintf(stream, "\\u%04x", (int)c);
+		}
+		else {
+			fputc(c, stream);
+		}
+	}
+	fputc('"', stream);
+}
+
+void DepsgraphProfile::write_trace(FILE *stream) const
+{
+	bool is_first = true;
+	fprintf(stream, "{\"traceEvents\": [\n");
+	foreach (const vector<DepsgraphProfileRecord> &records_thread, thread_records) {
+		foreach (const DepsgraphProfileRecord &record, records_thread) {
+			if (!is_first) {
+				fprintf(stream, ",\n");
+			}
+			is_first = false;
+			/* Times are in microseconds relative to the evaluation start. */
+			fprintf(stream, "{\"name\": ");
+			profile_write_json_string(stream, record.node->full_identifier());
+			fprintf(stream,
+			        ", \"cat\": \"depsgraph\", \"ph\": \"X\", \"pid\": 0, \"tid\": %d, "
+			        "\"ts\": %.3f, \"dur\": %.3f, \"args\": {\"wait_us\": %.3f}}",
+			        record.thread_id,
+			        (record.start_time - eval_start_time) * 1e6,
+			        (record.end_time - record.start_time) * 1e6,
+			        (record.start_time - record.ready_time) * 1e6);
+		}
+	}
+	fprintf(stream, "\n], \"displayTimeUnit\": \"ms\"}\n");
+}
+
+}  // namespace DEG
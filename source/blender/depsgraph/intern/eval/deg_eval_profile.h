@@ -0,0 +1,92 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2017 Blender Foundation.
+ * All rights reserved.
+ *
+ * Contributor(s): None Yet
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+
+/** \file blender/depsgraph/intern/eval/deg_eval_profile.h
+ *  \ingroup depsgraph
+ *
+ * Per-operation timing of depsgraph evaluation.
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+#include "intern/depsgraph_types.h"
+
+namespace DEG {
+
+struct Depsgraph;
+struct OperationDepsNode;
+
+/* Timing of a single operation evaluation, times are in seconds. */
+struct DepsgraphProfileRecord {
+	const OperationDepsNode *node;
+	/* Time when operation became ready for evaluation (all its inputs were
+	 * evaluated) and was pushed to the task pool.
+	 */
+	double ready_time;
+	double start_time;
+	double end_time;
+	int thread_id;
+};
+
+/* Timing of the last graph evaluation. Every thread only appends to its own
+ * list of records, so no locks are needed while evaluating.
+ */
+struct DepsgraphProfile {
+	DepsgraphProfile();
+	~DepsgraphProfile();
+
+	/* Clear records of previous evaluation. */
+	void begin(int num_threads);
+	void end();
+
+	/* Record called from the thread which evaluated the operation. */
+	void add_record(const OperationDepsNode *node,
+	                double ready_time,
+	                double start_time,
+	                double end_time,
+	                int thread_id)
+	{
+		DepsgraphProfileRecord record;
+		record.node = node;
+		record.ready_time = ready_time;
+		record.start_time = start_time;
+		record.end_time = end_time;
+		record.thread_id = thread_id;
+		thread_records[thread_id].push_back(record);
+	}
+
+	/* Short summary and the slowest operations. */
+	void print_summary(FILE *stream) const;
+	/* Chrome trace event format, can be opened in chrome://tracing. */
+	void write_trace(FILE *stream) const;
+
+	double eval_start_time, eval_end_time;
+	vector< vector<DepsgraphProfileRecord> > thread_records;
+};
+
+}  // namespace DEG
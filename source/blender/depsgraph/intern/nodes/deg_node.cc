@@ -35,6 +35,7 @@
 
 #include "BLI_utildefines.h"
 #include "BLI_ghash.h"
+#include "BLI_memarena.h"
 
 extern "C" {
 #include "DNA_ID.h"
@@ -76,6 +77,8 @@ DepsNode::TypeInfo::TypeInfo(eDepsNode_Type type, const char *tname)
 DepsNode::DepsNode()
 {
 	name = "";
+	done = 0;
+	tag = 0;
 }
 
 DepsNode::~DepsNode()
@@ -169,6 +172,8 @@ void IDDepsNode::init(const ID *id, const char *UNUSED(subdata))
 	/* Store ID-pointer. */
 	id_orig = (ID *)id;
 	eval_flags = 0;
+	eval_arena = NULL;
+	BLI_spin_init(&eval_arena_lock);
 
 	components = BLI_ghash_new(id_deps_node_hash_key,
 	                           id_deps_node_hash_key_cmp,
@@ -230,10 +235,40 @@ void IDDepsNode::destroy()
 		              id_orig->name, id_orig, id_cow);
 	}
 #endif
+	if (eval_arena != NULL) {
+		BLI_memarena_free(eval_arena);
+		eval_arena = NULL;
+	}
+	BLI_spin_end(&eval_arena_lock);
 	/* Tag that the node is freed. */
 	id_orig = NULL;
 }
 
+/* Allocate memory which is freed together with the evaluated datablock,
+ * can be called from multiple threads at once.
+ */
+void *IDDepsNode::eval_arena_alloc(size_t size)
+{
+	void *data;
+	BLI_spin_lock(&eval_arena_lock);
+	if (eval_arena == NULL) {
+		eval_arena = BLI_memarena_new(BLI_MEMARENA_STD_BUFSIZE, "Depsgraph eval arena");
+	}
+	data = BLI_memarena_alloc(eval_arena, size);
+	BLI_spin_unlock(&eval_arena_lock);
+	return data;
+}
+
+/* Release all memory allocated for the evaluated datablock, keeping the
+ * arena buffers around for the next evaluation.
+ */
+void IDDepsNode::eval_arena_clear() const
+{
+	if (eval_arena != NULL) {
+		BLI_memarena_clear(eval_arena);
+	}
+}
+
 ComponentDepsNode *IDDepsNode::find_component(eDepsNode_Type type,
                                               const char *name) const
 {
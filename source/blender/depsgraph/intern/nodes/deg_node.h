@@ -33,9 +33,11 @@
 #include "intern/depsgraph_types.h"
 
 #include "BLI_utildefines.h"
+#include "BLI_threads.h"
 
 struct ID;
 struct GHash;
+struct MemArena;
 struct Scene;
 
 namespace DEG {
@@ -151,10 +153,20 @@ struct IDDepsNode : public DepsNode {
 
 	void finalize_build(Depsgraph *graph);
 
+	void *eval_arena_alloc(size_t size);
+	void eval_arena_clear() const;
+
 	/* ID Block referenced. */
 	ID *id_orig;
 	ID *id_cow;
 
+	/* Memory owned by the evaluated datablock, released all at once when
+	 * the copy-on-write datablock is freed or copied again from the original.
+	 * Created on first allocation.
+	 */
+	MemArena *eval_arena;
+	SpinLock eval_arena_lock;
+
 	/* Hash to make it faster to look up components. */
 	GHash *components;
 
@@ -161,7 +161,7 @@ string ComponentDepsNode::identifier() const
 
 OperationDepsNode *ComponentDepsNode::find_operation(OperationIDKey key) const
 {
-	OperationDepsNode *node = reinterpret_cast<OperationDepsNode *>(BLI_ghash_lookup(operations_map, &key));
+	OperationDepsNode *node = has_operation(key);
 	if (node != NULL) {
 		return node;
 	}
@@ -183,7 +183,21 @@ OperationDepsNode *ComponentDepsNode::find_operation(eDepsOperation_Code opcode,
 
 OperationDepsNode *ComponentDepsNode::has_operation(OperationIDKey key) const
 {
-	return reinterpret_cast<OperationDepsNode *>(BLI_ghash_lookup(operations_map, &key));
+	if (operations_map != NULL) {
+		return reinterpret_cast<OperationDepsNode *>(BLI_ghash_lookup(operations_map, &key));
+	}
+	/* Component was already finalized, this happens when partially rebuilding
+	 * the graph and looking up operations of IDs which were kept as-is.
+	 */
+	foreach (OperationDepsNode *op_node, operations) {
+		if (op_node->opcode == key.opcode &&
+		    op_node->name_tag == key.name_tag &&
+		    STREQ(op_node->name, key.name))
+		{
+			return op_node;
+		}
+	}
+	return NULL;
 }
 
 OperationDepsNode *ComponentDepsNode::has_operation(eDepsOperation_Code opcode,
@@ -199,6 +213,8 @@ OperationDepsNode *ComponentDepsNode::add_operation(const DepsEvalOperationCb& o
                                                     const char *name,
                                                     int name_tag)
 {
+	/* Operations can not be added to the finalized component. */
+	BLI_assert(operations_map != NULL);
 	OperationDepsNode *op_node = has_operation(opcode, name, name_tag);
 	if (!op_node) {
 		DepsNodeFactory *factory = deg_get_node_factory(DEG_NODE_TYPE_OPERATION);
@@ -221,6 +237,7 @@ OperationDepsNode *ComponentDepsNode::add_operation(const DepsEvalOperationCb& o
 	op_node->evaluate = op;
 	op_node->opcode = opcode;
 	op_node->name = name;
+	op_node->name_tag = name_tag;
 
 	return op_node;
 }
@@ -317,6 +334,10 @@ OperationDepsNode *ComponentDepsNode::get_exit_operation()
 
 void ComponentDepsNode::finalize_build(Depsgraph * /*graph*/)
 {
+	if (operations_map == NULL) {
+		/* Component was kept from the previous build of the graph. */
+		return;
+	}
 	operations.reserve(BLI_ghash_size(operations_map));
 	GHASH_FOREACH_BEGIN(OperationDepsNode *, op_node, operations_map)
 	{
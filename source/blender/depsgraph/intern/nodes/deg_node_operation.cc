@@ -45,7 +45,10 @@ namespace DEG {
 
 OperationDepsNode::OperationDepsNode() :
     eval_priority(0.0f),
+    ready_time(0.0),
+    name_tag(-1),
     flag(0),
+    index(-1),
     customdata_mask(0)
 {
 }
@@ -76,13 +76,22 @@ struct OperationDepsNode : public DepsNode {
 	uint32_t num_links_pending;
 	float eval_priority;
 	bool scheduled;
+	/* Time when the operation was scheduled, only used for profiling. */
+	double ready_time;
 
 	/* Identifier for the operation being performed. */
 	eDepsOperation_Code opcode;
+	/* Tag used together with the name to distinguish operations with the same
+	 * opcode, needed to look the operation up once its component is finalized.
+	 */
+	int name_tag;
 
 	/* (eDepsOperation_Flag) extra settings affecting evaluation. */
 	int flag;
 
+	/* Index of the operation in Depsgraph::operations. */
+	int index;
+
 	/* Extra customdata mask which needs to be evaluated for the object. */
 	uint64_t customdata_mask;
 
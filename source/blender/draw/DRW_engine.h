@@ -84,6 +84,13 @@ void DRW_draw_depth_loop(
         struct Depsgraph *graph,
         struct ARegion *ar, struct View3D *v3d);
 
+/* Profiling, see draw_manager_profiling.c */
+void DRW_stats_enable(bool enable);
+bool DRW_stats_is_enabled(void);
+int DRW_stats_timer_len(void);
+void DRW_stats_timer_get(int index, const char **r_name, int *r_lvl, double *r_time_ms);
+double DRW_stats_cache_time_get(int ob_type);
+
 /* This is here because GPUViewport needs it */
 void DRW_pass_free(struct DRWPass *pass);
 
@@ -61,6 +61,12 @@ extern char datatoc_clay_vert_glsl[];
 extern char datatoc_clay_particle_vert_glsl[];
 extern char datatoc_clay_particle_strand_frag_glsl[];
 extern char datatoc_ssao_alchemy_glsl[];
+extern char datatoc_common_armature_deform_lib_glsl[];
+extern char datatoc_gpu_shader_depth_only_frag_glsl[];
+
+#define DEFORM_SHADER_DEFINES \
+	"#define USE_DEFORM\n" \
+	"#define DEFORM_GROUP_MAX " STRINGIFY(DRW_DEFORM_GROUP_MAX) "\n"
 
 /* *********** LISTS *********** */
 
@@ -154,9 +160,11 @@ typedef struct CLAY_SceneLayerData {
 static struct {
 	/* Depth Pre Pass */
 	struct GPUShader *depth_sh;
+	struct GPUShader *depth_deform_sh;
 	/* Shading Pass */
 	struct GPUShader *clay_sh;
 	struct GPUShader *clay_flat_sh;
+	struct GPUShader *clay_deform_sh;
 	struct GPUShader *hair_sh;
 
 	/* Matcap textures */
@@ -372,7 +380,9 @@ static void CLAY_engine_init(void *vedata)
 
 	/* Depth prepass */
 	if (!e_data.depth_sh) {
-		e_data.depth_sh = DRW_shader_create_3D_depth_only();
+		e_data.depth_sh = DRW_shader_create(
+		        datatoc_clay_vert_glsl, NULL, datatoc_gpu_shader_depth_only_frag_glsl,
+		        "#define USE_INSTANCING\n");
 	}
 
 	/* Shading pass */
@@ -387,13 +397,32 @@ static void CLAY_engine_init(void *vedata)
 
 		e_data.clay_sh = DRW_shader_create(
 		        datatoc_clay_vert_glsl, NULL, matcap_with_ao,
-		        SHADER_DEFINES);
+		        SHADER_DEFINES
+		        "#define USE_INSTANCING\n");
 		e_data.clay_flat_sh = DRW_shader_create(
 		        datatoc_clay_vert_glsl, NULL, matcap_with_ao,
 		        SHADER_DEFINES
+		        "#define USE_INSTANCING\n"
 		        "#define USE_FLAT_NORMAL\n");
 
 		BLI_dynstr_free(ds);
+
+		/* Armature deformed meshes, skinned in the vertex shader. */
+		ds = BLI_dynstr_new();
+		BLI_dynstr_append(ds, datatoc_common_armature_deform_lib_glsl);
+		BLI_dynstr_append(ds, datatoc_clay_vert_glsl);
+		char *deform_vert = BLI_dynstr_get_cstring(ds);
+		BLI_dynstr_free(ds);
+
+		e_data.clay_deform_sh = DRW_shader_create(
+		        deform_vert, NULL, matcap_with_ao,
+		        SHADER_DEFINES
+		        DEFORM_SHADER_DEFINES);
+		e_data.depth_deform_sh = DRW_shader_create(
+		        deform_vert, NULL, datatoc_gpu_shader_depth_only_frag_glsl,
+		        DEFORM_SHADER_DEFINES);
+
+		MEM_freeN(deform_vert);
 		MEM_freeN(matcap_with_ao);
 	}
 
@@ -503,10 +532,10 @@ static void CLAY_engine_init(void *vedata)
 	}
 }
 
-static DRWShadingGroup *CLAY_shgroup_create(CLAY_Data *UNUSED(vedata), DRWPass *pass, int *material_id, bool use_flat)
+static DRWShadingGroup *CLAY_shgroup_create_ex(DRWPass *pass, int *material_id, struct GPUShader *sh)
 {
 	CLAY_SceneLayerData *sldata = CLAY_scene_layer_data_get();
-	DRWShadingGroup *grp = DRW_shgroup_create(use_flat ? e_data.clay_flat_sh : e_data.clay_sh, pass);
+	DRWShadingGroup *grp = DRW_shgroup_create(sh, pass);
 
 	DRW_shgroup_uniform_vec2(grp, "screenres", DRW_viewport_size_get(), 1);
 	DRW_shgroup_uniform_buffer(grp, "depthtex", &e_data.depth_dup);
@@ -524,6 +553,11 @@ static DRWShadingGroup *CLAY_shgroup_create(CLAY_Data *UNUSED(vedata), DRWPass *
 	return grp;
 }
 
+static DRWShadingGroup *CLAY_shgroup_create(CLAY_Data *UNUSED(vedata), DRWPass *pass, int *material_id, bool use_flat)
+{
+	return CLAY_shgroup_create_ex(pass, material_id, use_flat ? e_data.clay_flat_sh : e_data.clay_sh);
+}
+
 static DRWShadingGroup *CLAY_hair_shgroup_create(DRWPass *pass, int *material_id)
 {
 	DRWShadingGroup *grp = DRW_shgroup_create(e_data.hair_sh, pass);
@@ -708,6 +742,32 @@ static DRWShadingGroup *CLAY_hair_shgrp_get(Object *ob, CLAY_StorageList *stl, C
 	return hair_shgrps[hair_id];
 }
 
+/**
+ * Armature deformed objects need their own shading groups, since the bone matrices are per object.
+ */
+static void CLAY_object_deform_shgrps_get(
+        Object *ob, Object *ob_arm, CLAY_StorageList *stl, CLAY_PassList *psl, bool do_cull,
+        DRWShadingGroup **r_depth_shgrp, DRWShadingGroup **r_clay_shgrp)
+{
+	float **deform_mats = (float **)DRW_object_engine_data_get(ob, &draw_engine_clay_type, NULL);
+	if (*deform_mats == NULL) {
+		*deform_mats = MEM_mallocN(sizeof(float[4][4]) * DRW_DEFORM_GROUP_MAX, "Clay Deform Matrices");
+	}
+	DRW_object_armature_deform_matrices_calc(ob, ob_arm, (float (*)[4][4])*deform_mats);
+
+	CLAY_UBO_Material mat_ubo_test;
+	ubo_mat_from_object(ob, &mat_ubo_test);
+	int id = mat_in_ubo(stl->storage, &mat_ubo_test);
+
+	*r_depth_shgrp = DRW_shgroup_create(e_data.depth_deform_sh, do_cull ? psl->depth_pass_cull : psl->depth_pass);
+	DRW_shgroup_uniform_vec4(*r_depth_shgrp, "deformMatrices[0]", *deform_mats, DRW_DEFORM_GROUP_MAX * 4);
+
+	*r_clay_shgrp = CLAY_shgroup_create_ex(psl->clay_pass, &e_data.ubo_mat_idxs[id], e_data.clay_deform_sh);
+	DRW_shgroup_uniform_vec4(*r_clay_shgrp, "deformMatrices[0]", *deform_mats, DRW_DEFORM_GROUP_MAX * 4);
+	/* Not sharing the shader of the first shading group, bind the material UBO too. */
+	DRW_shgroup_uniform_block(*r_clay_shgrp, "material_block", stl->mat_ubo);
+}
+
 static DRWShadingGroup *CLAY_object_shgrp_default_mode_get(
         CLAY_Data *vedata, Object *ob, CLAY_StorageList *stl, CLAY_PassList *psl)
 {
@@ -727,25 +787,29 @@ static void CLAY_cache_init(void *vedata)
 
 	/* Depth Pass */
 	{
-		psl->depth_pass = DRW_pass_create("Depth Pass", DRW_STATE_WRITE_DEPTH | DRW_STATE_DEPTH_LESS);
+		psl->depth_pass = DRW_pass_create(
+		        "Depth Pass",
+		        DRW_STATE_WRITE_DEPTH | DRW_STATE_DEPTH_LESS | DRW_STATE_VIEW_CULLING);
 		stl->g_data->depth_shgrp = DRW_shgroup_create(e_data.depth_sh, psl->depth_pass);
 
 		psl->depth_pass_cull = DRW_pass_create(
 		        "Depth Pass Cull",
-		        DRW_STATE_WRITE_DEPTH | DRW_STATE_DEPTH_LESS | DRW_STATE_CULL_BACK);
+		        DRW_STATE_WRITE_DEPTH | DRW_STATE_DEPTH_LESS | DRW_STATE_CULL_BACK | DRW_STATE_VIEW_CULLING);
 		stl->g_data->depth_shgrp_cull = DRW_shgroup_create(e_data.depth_sh, psl->depth_pass_cull);
 	}
 
 	/* Clay Pass */
 	{
-		psl->clay_pass = DRW_pass_create("Clay Pass", DRW_STATE_WRITE_COLOR | DRW_STATE_DEPTH_EQUAL);
+		psl->clay_pass = DRW_pass_create(
+		        "Clay Pass", DRW_STATE_WRITE_COLOR | DRW_STATE_DEPTH_EQUAL | DRW_STATE_VIEW_CULLING);
 		stl->storage->ubo_current_id = 0;
 		memset(stl->storage->shgrps, 0, sizeof(DRWShadingGroup *) * MAX_CLAY_MAT);
 	}
 
 	/* Clay Pass (Flat) */
 	{
-		psl->clay_pass_flat = DRW_pass_create("Clay Pass Flat", DRW_STATE_WRITE_COLOR | DRW_STATE_DEPTH_EQUAL);
+		psl->clay_pass_flat = DRW_pass_create(
+		        "Clay Pass Flat", DRW_STATE_WRITE_COLOR | DRW_STATE_DEPTH_EQUAL | DRW_STATE_VIEW_CULLING);
 		memset(stl->storage->shgrps_flat, 0, sizeof(DRWShadingGroup *) * MAX_CLAY_MAT);
 	}
 
@@ -783,31 +847,41 @@ static void CLAY_cache_populate(void *vedata, Object *ob)
 		const bool do_cull = BKE_collection_engine_property_value_get_bool(ces_mode_ob, "show_backface_culling");
 		const bool is_sculpt_mode = is_active && (ob->mode & OB_MODE_SCULPT) != 0;
 		const bool is_default_mode_shader = is_sculpt_mode;
+		Object *ob_arm = is_sculpt_mode ? NULL : DRW_object_armature_deform_get(ob);
 
-		/* Depth Prepass */
-		{
-			DRWShadingGroup *depth_shgrp = do_cull ? stl->g_data->depth_shgrp_cull : stl->g_data->depth_shgrp;
-			if (is_sculpt_mode) {
-				DRW_shgroup_call_sculpt_add(depth_shgrp, ob, ob->obmat);
+		if (ob_arm) {
+			DRWShadingGroup *depth_shgrp;
+			geom = DRW_cache_mesh_surface_deform_get(ob);
+			CLAY_object_deform_shgrps_get(ob, ob_arm, stl, psl, do_cull, &depth_shgrp, &clay_shgrp);
+			DRW_shgroup_call_add(depth_shgrp, geom, ob->obmat);
+			DRW_shgroup_call_add(clay_shgrp, geom, ob->obmat);
+		}
+		else {
+			/* Depth Prepass */
+			{
+				DRWShadingGroup *depth_shgrp = do_cull ? stl->g_data->depth_shgrp_cull : stl->g_data->depth_shgrp;
+				if (is_sculpt_mode) {
+					DRW_shgroup_call_sculpt_add(depth_shgrp, ob, ob->obmat);
+				}
+				else {
+					DRW_shgroup_call_object_add(depth_shgrp, geom, ob);
+				}
+			}
+
+			/* Shading */
+			if (is_default_mode_shader) {
+				clay_shgrp = CLAY_object_shgrp_default_mode_get(vedata, ob, stl, psl);
 			}
 			else {
-				DRW_shgroup_call_object_add(depth_shgrp, geom, ob);
+				clay_shgrp = CLAY_object_shgrp_get(vedata, ob, stl, psl, false);
 			}
-		}
 
-		/* Shading */
-		if (is_default_mode_shader) {
-			clay_shgrp = CLAY_object_shgrp_default_mode_get(vedata, ob, stl, psl);
-		}
-		else {
-			clay_shgrp = CLAY_object_shgrp_get(vedata, ob, stl, psl, false);
-		}
-
-		if (is_sculpt_mode) {
-			DRW_shgroup_call_sculpt_add(clay_shgrp, ob, ob->obmat);
-		}
-		else {
-			DRW_shgroup_call_add(clay_shgrp, geom, ob->obmat);
+			if (is_sculpt_mode) {
+				DRW_shgroup_call_sculpt_add(clay_shgrp, ob, ob->obmat);
+			}
+			else {
+				DRW_shgroup_call_add(clay_shgrp, geom, ob->obmat);
+			}
 		}
 	}
 
@@ -841,8 +915,14 @@ static void CLAY_cache_populate(void *vedata, Object *ob)
 
 static void CLAY_cache_finish(void *vedata)
 {
+	CLAY_PassList *psl = ((CLAY_Data *)vedata)->psl;
 	CLAY_StorageList *stl = ((CLAY_Data *)vedata)->stl;
 
+	/* Depth tested opaque passes, order doesn't matter. */
+	DRW_pass_sort_shgroup_state(psl->depth_pass);
+	DRW_pass_sort_shgroup_state(psl->depth_pass_cull);
+	DRW_pass_sort_shgroup_state(psl->clay_pass);
+
 	DRW_uniformbuffer_update(stl->mat_ubo, &stl->storage->mat_storage);
 	DRW_uniformbuffer_update(stl->hair_mat_ubo, &stl->storage->hair_mat_storage);
 }
@@ -909,8 +989,11 @@ static void CLAY_scene_layer_settings_create(RenderEngine *UNUSED(engine), IDPro
 
 static void CLAY_engine_free(void)
 {
+	DRW_SHADER_FREE_SAFE(e_data.depth_sh);
 	DRW_SHADER_FREE_SAFE(e_data.clay_sh);
 	DRW_SHADER_FREE_SAFE(e_data.clay_flat_sh);
+	DRW_SHADER_FREE_SAFE(e_data.clay_deform_sh);
+	DRW_SHADER_FREE_SAFE(e_data.depth_deform_sh);
 	DRW_SHADER_FREE_SAFE(e_data.hair_sh);
 	DRW_TEXTURE_FREE_SAFE(e_data.matcap_array);
 }
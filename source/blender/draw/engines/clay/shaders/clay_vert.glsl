@@ -1,5 +1,13 @@
+#ifdef USE_INSTANCING
+uniform mat4 ViewProjectionMatrix;
+uniform mat4 ViewMatrix;
+
+/* Object matrix, so objects sharing a mesh get drawn in one call. */
+in mat4 InstanceModelMatrix;
+#else
 uniform mat4 ModelViewProjectionMatrix;
 uniform mat3 NormalMatrix;
+#endif
 
 in vec3 pos;
 in vec3 nor;
@@ -12,6 +20,18 @@ out vec3 normal;
 
 void main()
 {
+#ifdef USE_INSTANCING
+	mat4 ModelViewProjectionMatrix = ViewProjectionMatrix * InstanceModelMatrix;
+	mat3 NormalMatrix = transpose(inverse(mat3(ViewMatrix * InstanceModelMatrix)));
+#endif
+
+#ifdef USE_DEFORM
+	vec3 co = pos, no = nor;
+	armature_deform(co, no);
+	normal = normalize(NormalMatrix * no);
+	gl_Position = ModelViewProjectionMatrix * vec4(co, 1.0);
+#else
 	normal = normalize(NormalMatrix * nor);
 	gl_Position = ModelViewProjectionMatrix * vec4(pos, 1.0);
+#endif
 }
@@ -48,6 +48,8 @@ static void eevee_scene_layer_data_free(void *storage)
 	DRW_TEXTURE_FREE_SAFE(sldata->shadow_depth_cube_pool);
 	DRW_TEXTURE_FREE_SAFE(sldata->shadow_depth_map_pool);
 	DRW_TEXTURE_FREE_SAFE(sldata->shadow_depth_cascade_pool);
+	DRW_TEXTURE_FREE_SAFE(sldata->light_cluster_tx);
+	DRW_TEXTURE_FREE_SAFE(sldata->light_index_tx);
 	BLI_freelistN(&sldata->shadow_casters);
 
 	/* Probes */
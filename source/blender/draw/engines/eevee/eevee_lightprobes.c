@@ -50,6 +50,7 @@
 #define PROBE_RT_SIZE 512 /* Cube render target */
 #define PROBE_OCTAHEDRON_SIZE 1024
 #define IRRADIANCE_POOL_SIZE 1024
+#define PROBE_UPDATE_BUDGET 4 /* Max number of cubemap captures (probes or grid cells) per redraw */
 
 static struct {
 	struct GPUShader *probe_default_sh;
@@ -955,6 +956,7 @@ static void render_scene_to_probe(
 	EEVEE_LightProbesInfo *pinfo = sldata->probes;
 
 	float winmat[4][4], posmat[4][4], tmp_ao_dist, tmp_ao_samples;
+	int tmp_cluster_mode;
 
 	unit_m4(posmat);
 
@@ -965,6 +967,10 @@ static void render_scene_to_probe(
 	sldata->probes->specular_toggle = false;
 	sldata->probes->ssr_toggle = false;
 
+	/* Light clusters are built for the main view. */
+	tmp_cluster_mode = sldata->lamps->cluster_mode;
+	sldata->lamps->cluster_mode = LIGHT_CLUSTER_NONE;
+
 	/* Disable AO until we find a way to hide really bad discontinuities between cubefaces. */
 	tmp_ao_dist = stl->effects->ao_dist;
 	tmp_ao_samples = stl->effects->ao_samples;
@@ -1039,6 +1045,7 @@ static void render_scene_to_probe(
 
 	/* Restore */
 	sldata->probes->specular_toggle = true;
+	sldata->lamps->cluster_mode = tmp_cluster_mode;
 	txl->planar_pool = tmp_planar_pool;
 	stl->g_data->minzbuffer = tmp_minz;
 	txl->maxzbuffer = tmp_maxz;
@@ -1057,6 +1064,7 @@ static void render_scene_to_planar(
 
 	float viewinv[4][4];
 	float persinv[4][4];
+	int tmp_cluster_mode;
 
 	invert_m4_m4(viewinv, viewmat);
 	invert_m4_m4(persinv, persmat);
@@ -1072,6 +1080,10 @@ static void render_scene_to_planar(
 	/* TODO : Enable SSR in planar reflections? (Would be very heavy) */
 	sldata->probes->ssr_toggle = false;
 
+	/* Light clusters are built for the main view. */
+	tmp_cluster_mode = sldata->lamps->cluster_mode;
+	sldata->lamps->cluster_mode = LIGHT_CLUSTER_NONE;
+
 	/* Avoid using the texture attached to framebuffer when rendering. */
 	/* XXX */
 	GPUTexture *tmp_planar_pool = txl->planar_pool;
@@ -1110,6 +1122,7 @@ static void render_scene_to_planar(
 
 	/* Restore */
 	sldata->probes->ssr_toggle = true;
+	sldata->lamps->cluster_mode = tmp_cluster_mode;
 	txl->planar_pool = tmp_planar_pool;
 	txl->planar_depth = tmp_planar_depth;
 	DRW_viewport_matrix_override_unset(DRW_MAT_PERS);
@@ -1184,6 +1197,31 @@ static void lightprobe_cell_location_get(EEVEE_LightGrid *egrid, int cell_idx, f
 	add_v3_v3(r_pos, tmp);
 }
 
+/**
+ * Index of the probe needing an update nearest to \a co in \a probes_ref (starting at 1, 0 is the world),
+ * or -1 if all are up to date.
+ */
+static int lightprobe_nearest_update_get(Object **probes_ref, const int probes_len, const float co[3])
+{
+	Object *ob;
+	float dist_best = FLT_MAX;
+	int index_best = -1;
+
+	for (int i = 1; (i < probes_len) && (ob = probes_ref[i]); i++) {
+		EEVEE_LightProbeEngineData *ped = EEVEE_lightprobe_data_get(ob);
+
+		if (ped->need_update) {
+			const float dist = len_squared_v3v3(co, ob->obmat[3]);
+			if (dist < dist_best) {
+				dist_best = dist;
+				index_best = i;
+			}
+		}
+	}
+
+	return index_best;
+}
+
 void EEVEE_lightprobes_refresh(EEVEE_SceneLayerData *sldata, EEVEE_Data *vedata)
 {
 	EEVEE_TextureList *txl = vedata->txl;
@@ -1224,59 +1262,66 @@ void EEVEE_lightprobes_refresh(EEVEE_SceneLayerData *sldata, EEVEE_Data *vedata)
 			}
 		}
 
+		/* Update the probes nearest to the camera first. */
+		const float *camera_pos = rv3d->viewinv[3];
+		int budget = PROBE_UPDATE_BUDGET;
+
 		/* Reflection probes depend on diffuse lighting thus on irradiance grid */
 		const int max_bounce = 3;
 		while (pinfo->updated_bounce < max_bounce) {
 			pinfo->num_render_grid = pinfo->num_grid;
 
-			for (int i = 1; (ob = pinfo->probes_grid_ref[i]) && (i < MAX_GRID); i++) {
-				EEVEE_LightProbeEngineData *ped = EEVEE_lightprobe_data_get(ob);
+			int i = lightprobe_nearest_update_get(pinfo->probes_grid_ref, MAX_GRID, camera_pos);
 
-				if (ped->need_update) {
-					EEVEE_LightGrid *egrid = &pinfo->grid_data[i];
-					LightProbe *prb = (LightProbe *)ob->data;
-					int cell_id = ped->updated_cells;
+			if (i != -1) {
+				ob = pinfo->probes_grid_ref[i];
+				EEVEE_LightProbeEngineData *ped = EEVEE_lightprobe_data_get(ob);
+				EEVEE_LightGrid *egrid = &pinfo->grid_data[i];
+				LightProbe *prb = (LightProbe *)ob->data;
+				int cell_id = ped->updated_cells;
 
-					SWAP(GPUTexture *, sldata->irradiance_pool, sldata->irradiance_rt);
+				SWAP(GPUTexture *, sldata->irradiance_pool, sldata->irradiance_rt);
 
-					/* Temporary Remove all probes. */
-					int tmp_num_render_grid = pinfo->num_render_grid;
-					int tmp_num_render_cube = pinfo->num_render_cube;
-					int tmp_num_planar = pinfo->num_planar;
-					pinfo->num_render_cube = 0;
-					pinfo->num_planar = 0;
+				/* Temporary Remove all probes. */
+				int tmp_num_render_grid = pinfo->num_render_grid;
+				int tmp_num_render_cube = pinfo->num_render_cube;
+				int tmp_num_planar = pinfo->num_planar;
+				pinfo->num_render_cube = 0;
+				pinfo->num_planar = 0;
 
-					/* Use light from previous bounce when capturing radiance. */
-					if (pinfo->updated_bounce == 0) {
-						pinfo->num_render_grid = 0;
-					}
+				/* Use light from previous bounce when capturing radiance. */
+				if (pinfo->updated_bounce == 0) {
+					pinfo->num_render_grid = 0;
+				}
 
-					float pos[3];
-					lightprobe_cell_location_get(egrid, cell_id, pos);
+				float pos[3];
+				lightprobe_cell_location_get(egrid, cell_id, pos);
 
-					render_scene_to_probe(sldata, vedata, pos, prb->clipsta, prb->clipend);
-					diffuse_filter_probe(sldata, psl, egrid->offset + cell_id);
+				render_scene_to_probe(sldata, vedata, pos, prb->clipsta, prb->clipend);
+				diffuse_filter_probe(sldata, psl, egrid->offset + cell_id);
 
-					/* Restore */
-					pinfo->num_render_grid = tmp_num_render_grid;
-					pinfo->num_render_cube = tmp_num_render_cube;
-					pinfo->num_planar = tmp_num_planar;
+				/* Restore */
+				pinfo->num_render_grid = tmp_num_render_grid;
+				pinfo->num_render_cube = tmp_num_render_cube;
+				pinfo->num_planar = tmp_num_planar;
 
-					/* To see what is going on. */
-					SWAP(GPUTexture *, sldata->irradiance_pool, sldata->irradiance_rt);
+				/* To see what is going on. */
+				SWAP(GPUTexture *, sldata->irradiance_pool, sldata->irradiance_rt);
 
-					ped->updated_cells++;
-					if (ped->updated_cells >= ped->num_cell) {
-						ped->need_update = false;
-					}
+				ped->updated_cells++;
+				if (ped->updated_cells >= ped->num_cell) {
+					ped->need_update = false;
+				}
 #if 0
-					printf("Updated Grid %d : cell %d / %d, bounce %d / %d\n",
-						i, ped->updated_cells, ped->num_cell, pinfo->updated_bounce + 1, max_bounce);
+				printf("Updated Grid %d : cell %d / %d, bounce %d / %d\n",
+					i, ped->updated_cells, ped->num_cell, pinfo->updated_bounce + 1, max_bounce);
 #endif
-					/* Only do one probe per frame */
-					DRW_viewport_request_redraw();
+				/* Continue next redraw when out of budget. */
+				DRW_viewport_request_redraw();
+				if (--budget == 0) {
 					goto update_planar;
 				}
+				continue;
 			}
 
 			pinfo->updated_bounce++;
@@ -1284,7 +1329,7 @@ void EEVEE_lightprobes_refresh(EEVEE_SceneLayerData *sldata, EEVEE_Data *vedata)
 
 			if (pinfo->updated_bounce < max_bounce) {
 				/* Retag all grids to update for next bounce */
-				for (int i = 1; (ob = pinfo->probes_grid_ref[i]) && (i < MAX_GRID); i++) {
+				for (i = 1; (ob = pinfo->probes_grid_ref[i]) && (i < MAX_GRID); i++) {
 					EEVEE_LightProbeEngineData *ped = EEVEE_lightprobe_data_get(ob);
 					ped->need_update = true;
 					ped->updated_cells = 0;
@@ -1293,30 +1338,32 @@ void EEVEE_lightprobes_refresh(EEVEE_SceneLayerData *sldata, EEVEE_Data *vedata)
 			}
 		}
 
-		for (int i = 1; (ob = pinfo->probes_cube_ref[i]) && (i < MAX_PROBE); i++) {
-			EEVEE_LightProbeEngineData *ped = EEVEE_lightprobe_data_get(ob);
+		while (budget > 0) {
+			int i = lightprobe_nearest_update_get(pinfo->probes_cube_ref, MAX_PROBE, camera_pos);
 
-			if (ped->need_update) {
-				LightProbe *prb = (LightProbe *)ob->data;
+			if (i == -1) {
+				break;
+			}
 
-				render_scene_to_probe(sldata, vedata, ob->obmat[3], prb->clipsta, prb->clipend);
-				glossy_filter_probe(sldata, psl, i);
+			ob = pinfo->probes_cube_ref[i];
+			EEVEE_LightProbeEngineData *ped = EEVEE_lightprobe_data_get(ob);
+			LightProbe *prb = (LightProbe *)ob->data;
 
-				ped->need_update = false;
-				ped->probe_id = i;
+			render_scene_to_probe(sldata, vedata, ob->obmat[3], prb->clipsta, prb->clipend);
+			glossy_filter_probe(sldata, psl, i);
 
-				if (!ped->ready_to_shade) {
-					pinfo->num_render_cube++;
-					ped->ready_to_shade = true;
-				}
-#if 0
-				printf("Update Cubemap %d\n", i);
-#endif
-				DRW_viewport_request_redraw();
+			ped->need_update = false;
+			ped->probe_id = i;
 
-				/* Only do one probe per frame */
-				goto update_planar;
+			if (!ped->ready_to_shade) {
+				pinfo->num_render_cube++;
+				ped->ready_to_shade = true;
 			}
+#if 0
+			printf("Update Cubemap %d\n", i);
+#endif
+			DRW_viewport_request_redraw();
+			budget--;
 		}
 	}
 
@@ -138,9 +138,8 @@ void EEVEE_lights_cache_add(EEVEE_SceneLayerData *sldata, Object *ob)
 		Lamp *la = (Lamp *)ob->data;
 		EEVEE_LampEngineData *led = EEVEE_lamp_data_get(ob);
 
-		if ((ob->deg_update_flag & DEG_RUNTIME_DATA_UPDATE) != 0) {
-			led->need_update = true;
-		}
+		/* Lamp updates only tag the shadow for update when they affect it,
+		 * see eevee_shadow_cube_setup. */
 
 		MEM_SAFE_FREE(led->storage);
 
@@ -310,9 +309,6 @@ static void eevee_light_setup(Object *ob, EEVEE_LampsInfo *linfo, EEVEE_LampEngi
 	/* Color */
 	copy_v3_v3(evli->color, &la->r);
 
-	/* Influence Radius */
-	evli->dist = la->dist;
-
 	/* Vectors */
 	normalize_m4_m4_ex(mat, ob->obmat, scale);
 	copy_v3_v3(evli->forwardvec, mat[2]);
@@ -363,6 +359,25 @@ static void eevee_light_setup(Object *ob, EEVEE_LampsInfo *linfo, EEVEE_LampEngi
 	}
 	mul_v3_fl(evli->color, power * la->energy);
 
+	/* Influence Radius: distance where the lamp irradiance falls under LIGHT_INFLUENCE_THRESHOLD,
+	 * the shader fades the lamp out up to it, and light culling ignores the lamp past it. */
+	if (ELEM(la->type, LA_SUN, LA_HEMI)) {
+		evli->dist = -1.0f;
+	}
+	else {
+		float area, extent;
+		if (la->type == LA_AREA) {
+			area = 4.0f * evli->sizex * evli->sizey;
+			extent = sqrtf(evli->sizex * evli->sizex + evli->sizey * evli->sizey);
+		}
+		else {
+			area = evli->radius * evli->radius;
+			extent = evli->radius;
+		}
+		const float irradiance = max_fff(UNPACK3(evli->color)) * area * (float)M_1_PI;
+		evli->dist = sqrtf(irradiance / LIGHT_INFLUENCE_THRESHOLD) + extent;
+	}
+
 	/* Lamp Type */
 	evli->lamptype = (float)la->type;
 
@@ -370,6 +385,186 @@ static void eevee_light_setup(Object *ob, EEVEE_LampsInfo *linfo, EEVEE_LampEngi
 	evli->shadowid = -1.0f;
 }
 
+/* -------------------------------------------------------------------- */
+
+/** \name Light Culling
+ *
+ * Lights are sorted into a grid of view space clusters (screen tiles split in depth slices)
+ * so each fragment only loops over the lights that can reach it.
+ * \{ */
+
+/* View space corners of the cluster (x, y) on the near plane. */
+static void eevee_light_cluster_corners(
+        float wininv[4][4], float r_corners[LIGHT_CLUSTER_Y + 1][LIGHT_CLUSTER_X + 1][3])
+{
+	for (int y = 0; y <= LIGHT_CLUSTER_Y; y++) {
+		for (int x = 0; x <= LIGHT_CLUSTER_X; x++) {
+			float co[4] = {
+			    -1.0f + 2.0f * (float)x / (float)LIGHT_CLUSTER_X,
+			    -1.0f + 2.0f * (float)y / (float)LIGHT_CLUSTER_Y,
+			    -1.0f, 1.0f};
+			mul_m4_v4(wininv, co);
+			mul_v3_v3fl(r_corners[y][x], co, 1.0f / co[3]);
+		}
+	}
+}
+
+static float eevee_light_cluster_slice_depth(const EEVEE_LampsInfo *linfo, float near, float far, int z)
+{
+	const float fac = (float)z / (float)LIGHT_CLUSTER_Z;
+	if (linfo->cluster_mode == LIGHT_CLUSTER_PERSP) {
+		return near * powf(far / near, fac);
+	}
+	else {
+		return near + (far - near) * fac;
+	}
+}
+
+static void eevee_light_cluster_bounds(
+        const EEVEE_LampsInfo *linfo, float corners[LIGHT_CLUSTER_Y + 1][LIGHT_CLUSTER_X + 1][3],
+        int x, int y, float depth_min, float depth_max, float r_min[3], float r_max[3])
+{
+	INIT_MINMAX(r_min, r_max);
+
+	for (int i = 0; i < 4; i++) {
+		const float *co_near = corners[y + (i >> 1)][x + (i & 1)];
+		for (int j = 0; j < 2; j++) {
+			const float depth = (j == 0) ? depth_min : depth_max;
+			float co[3];
+			if (linfo->cluster_mode == LIGHT_CLUSTER_PERSP) {
+				mul_v3_v3fl(co, co_near, depth / -co_near[2]);
+			}
+			else {
+				co[0] = co_near[0];
+				co[1] = co_near[1];
+				co[2] = -depth;
+			}
+			minmax_v3v3_v3(r_min, r_max, co);
+		}
+	}
+}
+
+/* Build the light list of each cluster, for the current view. */
+static void eevee_lights_cluster_update(EEVEE_SceneLayerData *sldata)
+{
+	EEVEE_LampsInfo *linfo = sldata->lamps;
+	const DRWContextState *draw_ctx = DRW_context_state_get();
+	const int num_light = min_ii(linfo->num_light, MAX_LIGHT);
+	float (*cluster_data)[2] = MEM_callocN(sizeof(*cluster_data) * LIGHT_CLUSTER_LEN, __func__);
+	float *index_data = NULL;
+	int index_len = 0;
+
+	linfo->cluster_mode = LIGHT_CLUSTER_NONE;
+
+	if (draw_ctx->rv3d != NULL && num_light > 0) {
+		const float *viewport_size = DRW_viewport_size_get();
+		float winmat[4][4], wininv[4][4], viewmat[4][4];
+		float near, far, slice_scale, slice_bias;
+
+		DRW_viewport_matrix_get(winmat, DRW_MAT_WIN);
+		DRW_viewport_matrix_get(viewmat, DRW_MAT_VIEW);
+		invert_m4_m4(wininv, winmat);
+
+		if (DRW_viewport_is_persp_get()) {
+			linfo->cluster_mode = LIGHT_CLUSTER_PERSP;
+			near = winmat[3][2] / (winmat[2][2] - 1.0f);
+			far = winmat[3][2] / (winmat[2][2] + 1.0f);
+			slice_scale = (float)LIGHT_CLUSTER_Z / log2f(far / near);
+			slice_bias = -log2f(near) * slice_scale;
+		}
+		else {
+			linfo->cluster_mode = LIGHT_CLUSTER_ORTHO;
+			near = (winmat[3][2] + 1.0f) / winmat[2][2];
+			far = (winmat[3][2] - 1.0f) / winmat[2][2];
+			slice_scale = (float)LIGHT_CLUSTER_Z / (far - near);
+			slice_bias = -near * slice_scale;
+		}
+
+		linfo->cluster_params[0] = (float)LIGHT_CLUSTER_X / viewport_size[0];
+		linfo->cluster_params[1] = (float)LIGHT_CLUSTER_Y / viewport_size[1];
+		linfo->cluster_params[2] = slice_scale;
+		linfo->cluster_params[3] = slice_bias;
+
+		float corners[LIGHT_CLUSTER_Y + 1][LIGHT_CLUSTER_X + 1][3];
+		eevee_light_cluster_corners(wininv, corners);
+
+		float slices[LIGHT_CLUSTER_Z + 1];
+		for (int z = 0; z <= LIGHT_CLUSTER_Z; z++) {
+			slices[z] = eevee_light_cluster_slice_depth(linfo, near, far, z);
+		}
+
+		/* View space bounding sphere of each light, radius negative for lights reaching everything. */
+		float light_spheres[MAX_LIGHT][4];
+		for (int i = 0; i < num_light; i++) {
+			const EEVEE_Light *evli = &linfo->light_data[i];
+			mul_v3_m4v3(light_spheres[i], viewmat, evli->position);
+			light_spheres[i][3] = evli->dist;
+		}
+
+		/* Worst case: every light in every cluster, rounded to full rows of the index texture. */
+		const int index_len_alloc = LIGHT_CLUSTER_LEN * num_light;
+		const int index_rows = (index_len_alloc + LIGHT_CLUSTER_INDEX_WIDTH - 1) / LIGHT_CLUSTER_INDEX_WIDTH;
+		index_data = MEM_callocN(sizeof(float) * (size_t)(index_rows * LIGHT_CLUSTER_INDEX_WIDTH), __func__);
+
+		for (int z = 0; z < LIGHT_CLUSTER_Z; z++) {
+			for (int y = 0; y < LIGHT_CLUSTER_Y; y++) {
+				for (int x = 0; x < LIGHT_CLUSTER_X; x++) {
+					float *data = cluster_data[x + y * LIGHT_CLUSTER_X + z * LIGHT_CLUSTER_X * LIGHT_CLUSTER_Y];
+					float bmin[3], bmax[3];
+					bool has_bounds = false;
+
+					data[0] = (float)index_len;
+
+					for (int i = 0; i < num_light; i++) {
+						const float *sphere = light_spheres[i];
+
+						if (sphere[3] > 0.0f) {
+							/* Cheap depth rejection before computing the cluster bounds. */
+							const float depth = -sphere[2];
+							if (depth + sphere[3] < slices[z] || depth - sphere[3] > slices[z + 1]) {
+								continue;
+							}
+
+							if (!has_bounds) {
+								eevee_light_cluster_bounds(linfo, corners, x, y, slices[z], slices[z + 1], bmin, bmax);
+								has_bounds = true;
+							}
+
+							float dist_sq = 0.0f;
+							for (int k = 0; k < 3; k++) {
+								const float d = max_ff(max_ff(bmin[k] - sphere[k], sphere[k] - bmax[k]), 0.0f);
+								dist_sq += d * d;
+							}
+							if (dist_sq > sphere[3] * sphere[3]) {
+								continue;
+							}
+						}
+
+						index_data[index_len++] = (float)i;
+					}
+
+					data[1] = (float)index_len - data[0];
+				}
+			}
+		}
+	}
+
+	/* Textures have to be recreated to be updated, they are small. */
+	DRW_TEXTURE_FREE_SAFE(sldata->light_cluster_tx);
+	DRW_TEXTURE_FREE_SAFE(sldata->light_index_tx);
+
+	sldata->light_cluster_tx = DRW_texture_create_2D(
+	        LIGHT_CLUSTER_X * LIGHT_CLUSTER_Y, LIGHT_CLUSTER_Z, DRW_TEX_RG_32, 0, (float *)cluster_data);
+	sldata->light_index_tx = DRW_texture_create_2D(
+	        LIGHT_CLUSTER_INDEX_WIDTH, max_ii(1, (index_len + LIGHT_CLUSTER_INDEX_WIDTH - 1) / LIGHT_CLUSTER_INDEX_WIDTH),
+	        DRW_TEX_R_32, 0, index_data);
+
+	MEM_freeN(cluster_data);
+	MEM_SAFE_FREE(index_data);
+}
+
+/** \} */
+
 static void eevee_shadow_cube_setup(Object *ob, EEVEE_LampsInfo *linfo, EEVEE_LampEngineData *led)
 {
 	float projmat[4][4];
@@ -395,6 +590,20 @@ static void eevee_shadow_cube_setup(Object *ob, EEVEE_LampsInfo *linfo, EEVEE_La
 	evsh->exp = la->bleedexp;
 
 	evli->shadowid = (float)(evsmp->shadow_id);
+
+	/* Changing the color, energy or bias of a lamp doesn't need the shadow to be rendered again. */
+	EEVEE_ShadowCubeCache cache;
+	memset(&cache, 0, sizeof(cache));
+	copy_v3_v3(cache.position, ob->obmat[3]);
+	cache.clipsta = la->clipsta;
+	cache.clipend = la->clipend;
+	cache.exponent = la->bleedexp;
+	cache.layer = evsmp->shadow_id;
+
+	if (memcmp(&led->shadow_cube_cache, &cache, sizeof(cache)) != 0) {
+		led->shadow_cube_cache = cache;
+		led->need_update = true;
+	}
 }
 
 static void eevee_shadow_map_setup(Object *ob, EEVEE_LampsInfo *linfo, EEVEE_LampEngineData *led)
@@ -730,6 +939,8 @@ void EEVEE_lights_update(EEVEE_SceneLayerData *sldata)
 
 	DRW_uniformbuffer_update(sldata->light_ubo, &linfo->light_data);
 	DRW_uniformbuffer_update(sldata->shadow_ubo, &linfo->shadow_cube_data); /* Update all data at once */
+
+	eevee_lights_cluster_update(sldata);
 }
 
 /* this refresh lamps shadow buffers */
@@ -41,6 +41,14 @@ extern struct DrawEngineType draw_engine_eevee_type;
 #define MAX_CASCADE_NUM 4
 #define MAX_BLOOM_STEP 16
 
+/* Light culling grid: screen tiles times view depth slices. */
+#define LIGHT_CLUSTER_X 16
+#define LIGHT_CLUSTER_Y 8
+#define LIGHT_CLUSTER_Z 16
+#define LIGHT_CLUSTER_LEN (LIGHT_CLUSTER_X * LIGHT_CLUSTER_Y * LIGHT_CLUSTER_Z)
+#define LIGHT_CLUSTER_INDEX_WIDTH 1024 /* Width of the light index texture */
+#define LIGHT_INFLUENCE_THRESHOLD 0.01f /* Irradiance under which a lamp is ignored */
+
 /* Only define one of these. */
 // #define IRRADIANCE_SH_L2
 // #define IRRADIANCE_CUBEMAP
@@ -240,6 +248,9 @@ typedef struct EEVEE_LampsInfo {
 	struct EEVEE_ShadowCube    shadow_cube_data[MAX_SHADOW_CUBE];
 	struct EEVEE_ShadowMap     shadow_map_data[MAX_SHADOW_MAP];
 	struct EEVEE_ShadowCascade shadow_cascade_data[MAX_SHADOW_CASCADE];
+	/* Light culling */
+	int cluster_mode;
+	float cluster_params[4]; /* xy: tiles per pixel, z: slice scale, w: slice bias */
 } EEVEE_LampsInfo;
 
 /* EEVEE_LampsInfo->update_flag */
@@ -247,6 +258,13 @@ enum {
 	LIGHT_UPDATE_SHADOW_CUBE = (1 << 0),
 };
 
+/* EEVEE_LampsInfo->cluster_mode, must match lit_surface_frag.glsl */
+enum {
+	LIGHT_CLUSTER_NONE  = 0, /* Loop over all lights (views the clusters were not built for). */
+	LIGHT_CLUSTER_PERSP = 1, /* Logarithmic depth slices. */
+	LIGHT_CLUSTER_ORTHO = 2, /* Linear depth slices. */
+};
+
 /* ************ PROBE UBO ************* */
 typedef struct EEVEE_LightProbe {
 	float position[3], parallax_type;
@@ -395,6 +413,9 @@ typedef struct EEVEE_SceneLayerData {
 	struct GPUTexture *shadow_depth_map_pool;
 	struct GPUTexture *shadow_depth_cascade_pool;
 
+	struct GPUTexture *light_cluster_tx; /* (first, len) in light_index_tx for each cluster */
+	struct GPUTexture *light_index_tx;
+
 	struct ListBase shadow_casters; /* Shadow casters gathered during cache iteration */
 
 	/* Probes */
@@ -419,8 +440,18 @@ typedef struct EEVEE_SceneLayerData {
 } EEVEE_SceneLayerData;
 
 /* ************ OBJECT DATA ************ */
+
+/* What a shadow cube was rendered with, it only needs to be rendered again when this changes
+ * (or when one of its casters is updated). */
+typedef struct EEVEE_ShadowCubeCache {
+	float position[3];
+	float clipsta, clipend, exponent;
+	int layer;
+} EEVEE_ShadowCubeCache;
+
 typedef struct EEVEE_LampEngineData {
 	bool need_update;
+	struct EEVEE_ShadowCubeCache shadow_cube_cache;
 	struct ListBase shadow_caster_list;
 	void *storage; /* either EEVEE_LightData, EEVEE_ShadowCubeData, EEVEE_ShadowCascadeData */
 } EEVEE_LampEngineData;
@@ -78,6 +78,13 @@ float light_visibility(LightData ld, vec3 W, vec4 l_vector)
 {
 	float vis = 1.0;
 
+	/* Fade out up to the influence radius, past it the lamp is culled. */
+	if (ld.l_influence > 0.0) {
+		float fac = l_vector.w / ld.l_influence;
+		fac *= fac;
+		vis *= saturate(1.0 - fac * fac);
+	}
+
 	if (ld.l_type == SPOT) {
 		float z = dot(ld.l_forward, l_vector.xyz);
 		vec3 lL = l_vector.xyz / z;
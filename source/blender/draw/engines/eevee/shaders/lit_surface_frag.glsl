@@ -1,5 +1,9 @@
 
 uniform int light_count;
+uniform int lightClusterMode;
+uniform vec4 lightClusterParams; /* xy: tiles per pixel, z: slice scale, w: slice bias */
+uniform sampler2D lightClusters;
+uniform sampler2D lightIndices;
 uniform int probe_count;
 uniform int grid_count;
 uniform int planar_count;
@@ -23,6 +27,45 @@ in vec3 worldNormal;
 in vec3 viewNormal;
 #endif
 
+/* ----------- light culling -----------  */
+
+/* Match EEVEE_LampsInfo->cluster_mode */
+#define LIGHT_CLUSTER_NONE  0
+#define LIGHT_CLUSTER_PERSP 1
+
+/* Range of the light index list of the cluster containing the current fragment. */
+void light_cluster_range(out int first, out int len)
+{
+	if (lightClusterMode == LIGHT_CLUSTER_NONE) {
+		first = 0;
+		len = light_count;
+		return;
+	}
+
+	float depth = -viewPosition.z;
+	float slice = (lightClusterMode == LIGHT_CLUSTER_PERSP) ? log2(max(depth, 1e-8)) : depth;
+	slice = slice * lightClusterParams.z + lightClusterParams.w;
+
+	ivec3 cluster;
+	cluster.xy = ivec2(gl_FragCoord.xy * lightClusterParams.xy);
+	cluster.z = int(slice);
+	cluster = clamp(cluster, ivec3(0), ivec3(LIGHT_CLUSTER_X - 1, LIGHT_CLUSTER_Y - 1, LIGHT_CLUSTER_Z - 1));
+
+	vec2 data = texelFetch(lightClusters, ivec2(cluster.x + cluster.y * LIGHT_CLUSTER_X, cluster.z), 0).rg;
+	first = int(data.x);
+	len = int(data.y);
+}
+
+int light_cluster_light(int first, int i)
+{
+	if (lightClusterMode == LIGHT_CLUSTER_NONE) {
+		return i;
+	}
+
+	int index = first + i;
+	return int(texelFetch(lightIndices, ivec2(index % LIGHT_CLUSTER_INDEX_WIDTH, index / LIGHT_CLUSTER_INDEX_WIDTH), 0).r);
+}
+
 /* ----------- default -----------  */
 
 vec3 eevee_surface_lit(vec3 N, vec3 albedo, vec3 f0, float roughness, float ao, int ssr_id, out vec3 ssr_spec)
@@ -56,8 +99,10 @@ vec3 eevee_surface_lit(vec3 N, vec3 albedo, vec3 f0, float roughness, float ao,
 
 	vec3 diff = vec3(0.0);
 	vec3 spec = vec3(0.0);
-	for (int i = 0; i < MAX_LIGHT && i < light_count; ++i) {
-		LightData ld = lights_data[i];
+	int cl_first, cl_len;
+	light_cluster_range(cl_first, cl_len);
+	for (int i = 0; i < MAX_LIGHT && i < cl_len; ++i) {
+		LightData ld = lights_data[light_cluster_light(cl_first, i)];
 
 		vec4 l_vector; /* Non-Normalized Light Vector with length in last component. */
 		l_vector.xyz = ld.l_position - worldPosition;
@@ -193,8 +238,10 @@ vec3 eevee_surface_clearcoat_lit(
 
 	vec3 diff = vec3(0.0);
 	vec3 spec = vec3(0.0);
-	for (int i = 0; i < MAX_LIGHT && i < light_count; ++i) {
-		LightData ld = lights_data[i];
+	int cl_first, cl_len;
+	light_cluster_range(cl_first, cl_len);
+	for (int i = 0; i < MAX_LIGHT && i < cl_len; ++i) {
+		LightData ld = lights_data[light_cluster_light(cl_first, i)];
 
 		vec4 l_vector; /* Non-Normalized Light Vector with length in last component. */
 		l_vector.xyz = ld.l_position - worldPosition;
@@ -342,8 +389,10 @@ vec3 eevee_surface_diffuse_lit(vec3 N, vec3 albedo, float ao)
 #endif
 
 	vec3 diff = vec3(0.0);
-	for (int i = 0; i < MAX_LIGHT && i < light_count; ++i) {
-		LightData ld = lights_data[i];
+	int cl_first, cl_len;
+	light_cluster_range(cl_first, cl_len);
+	for (int i = 0; i < MAX_LIGHT && i < cl_len; ++i) {
+		LightData ld = lights_data[light_cluster_light(cl_first, i)];
 
 		vec4 l_vector; /* Non-Normalized Light Vector with length in last component. */
 		l_vector.xyz = ld.l_position - worldPosition;
@@ -422,8 +471,10 @@ vec3 eevee_surface_glossy_lit(vec3 N, vec3 f0, float roughness, float ao, int ss
 #endif
 
 	vec3 spec = vec3(0.0);
-	for (int i = 0; i < MAX_LIGHT && i < light_count; ++i) {
-		LightData ld = lights_data[i];
+	int cl_first, cl_len;
+	light_cluster_range(cl_first, cl_len);
+	for (int i = 0; i < MAX_LIGHT && i < cl_len; ++i) {
+		LightData ld = lights_data[light_cluster_light(cl_first, i)];
 
 		vec4 l_vector; /* Non-Normalized Light Vector with length in last component. */
 		l_vector.xyz = ld.l_position - worldPosition;
@@ -1,5 +1,6 @@
 #define MAX_STEP 256
 #define MAX_REFINE_STEP 32 /* Should be max allowed stride */
+#define HIZ_MAX_LEVEL 7 /* Last mip of the min/max pyramid (see EEVEE_create_minmax_buffer) */
 
 uniform vec4 ssrParameters;
 
@@ -118,10 +119,91 @@ void prepare_raycast(vec3 ray_origin, vec3 ray_dir, out vec4 ss_step, out vec4 s
 #define curr_delta  times_and_deltas.z
 #define prev_delta  times_and_deltas.w
 
+/* Ray time where the ray leaves the cell at \a cell_co of a pyramid level with \a cell_count cells.
+ * Offset a bit to be sure to land in the next cell. */
+float hiz_cell_exit_time(vec4 ss_start, vec4 ss_step, vec2 cell_co, vec2 cell_count)
+{
+	vec2 boundary = (cell_co + step(0.0, ss_step.xy)) / cell_count;
+	/* Avoid division by 0 for axis aligned rays. */
+	vec2 inv_step = 1.0 / max(abs(ss_step.xy), vec2(1e-8)) * sign(ss_step.xy + 1e-16);
+	vec2 times = (boundary - ss_start.xy) * inv_step;
+	return min(times.x, times.y) + 0.01;
+}
+
+/**
+ * Hierarchical-Z traversal of the min depth pyramid.
+ * Skip whole cells the ray passes in front of, going up one level each time,
+ * and go down one level when the ray may intersect the cell. Rough surfaces
+ * stop at a coarser level since their reflections get blurred anyway.
+ * Same output as raycast().
+ **/
+vec3 raycast_hiz(vec3 ray_origin, vec3 ray_dir, float ray_jitter, float roughness)
+{
+	vec4 ss_step, ss_start;
+	float max_time;
+	prepare_raycast(ray_origin, ray_dir, ss_step, ss_start, max_time);
+
+	float hit_level = floor(saturate(fast_sqrt(roughness) * 2.0 - 0.4) * 2.0);
+	float level = 0.0;
+	/* Minimum offset of 2 because we are using half res minmax zbuffer. */
+	float ray_time = mix(2.0, 4.0, ray_jitter);
+	float depth_sample = 1.0;
+	bool hit = false;
+
+	for (float iter = 0.0; !hit && (ray_time <= max_time) && (iter < MAX_STEP); iter++) {
+		vec2 cell_count = vec2(textureSize(minzBuffer, int(level)));
+		vec4 ss_ray = ss_start + ss_step * ray_time;
+		vec2 cell_co = floor(ss_ray.xy * cell_count);
+
+		float exit_time = min(hiz_cell_exit_time(ss_start, ss_step, cell_co, cell_count), max_time);
+		float cell_depth = texelFetch(minzBuffer, ivec2(cell_co), int(level)).r;
+		/* Farthest depth of the ray segment inside this cell. */
+		float ray_depth = max(ss_ray.z, ss_start.z + ss_step.z * exit_time);
+
+		if (ray_depth < cell_depth) {
+			/* Ray is in front of everything in this cell. */
+			ray_time = exit_time;
+			level = min(level + 1.0, float(HIZ_MAX_LEVEL));
+		}
+		else if (level <= hit_level) {
+			/* Move to the intersection with the cell depth if it's inside the segment. */
+			if (ss_ray.z < cell_depth) {
+				ray_time = clamp((cell_depth - ss_start.z) / ss_step.z, ray_time, exit_time);
+			}
+			depth_sample = cell_depth;
+			hit = true;
+		}
+		else {
+			level -= 1.0;
+		}
+	}
+
+	/* Clip to frustum. */
+	ray_time = min(ray_time, max_time - 0.5);
+
+	vec4 ss_ray = ss_start + ss_step * ray_time;
+	vec3 hit_pos = get_view_space_from_depth(ss_ray.xy, ss_ray.z);
+
+	/* Reject hit if not within threshold. */
+	if (hit) {
+		float z = get_view_z_from_depth(depth_sample);
+		hit = ((z - hit_pos.z - ssrThickness) <= ssrThickness);
+	}
+
+	/* Tag Z if ray failed. */
+	hit_pos.z *= (hit) ? 1.0 : -1.0;
+	return hit_pos;
+}
+
 // #define GROUPED_FETCHES
 /* Return the hit position, and negate the z component (making it positive) if not hit occured. */
 vec3 raycast(int index, vec3 ray_origin, vec3 ray_dir, float ray_jitter, float roughness)
 {
+	/* Planar depth buffers have no pyramid, only the screen buffer uses the hierarchical trace. */
+	if (index == -1) {
+		return raycast_hiz(ray_origin, ray_dir, ray_jitter, roughness);
+	}
+
 	vec4 ss_step, ss_start;
 	float max_time;
 	prepare_raycast(ray_origin, ray_dir, ss_step, ss_start, max_time);
@@ -257,6 +257,8 @@ typedef enum {
 	DRW_STATE_MULTIPLY      = (1 << 16),
 	DRW_STATE_TRANSMISSION  = (1 << 17),
 	DRW_STATE_CLIP_PLANES   = (1 << 18),
+	/* Not a GL state: skip object calls whose bounds are outside of the view frustum. */
+	DRW_STATE_VIEW_CULLING  = (1 << 19),
 
 	DRW_STATE_WRITE_STENCIL_SELECT = (1 << 27),
 	DRW_STATE_WRITE_STENCIL_ACTIVE = (1 << 28),
@@ -322,6 +324,7 @@ void DRW_shgroup_uniform_mat4(DRWShadingGroup *shgroup, const char *name, const
 DRWPass *DRW_pass_create(const char *name, DRWState state);
 void DRW_pass_foreach_shgroup(DRWPass *pass, void (*callback)(void *userData, DRWShadingGroup *shgrp), void *userData);
 void DRW_pass_sort_shgroup_z(DRWPass *pass);
+void DRW_pass_sort_shgroup_state(DRWPass *pass);
 
 /* Viewport */
 typedef enum {
@@ -360,6 +363,7 @@ void DRW_lamp_engine_data_free(struct LampEngineData *led);
 bool DRW_object_is_renderable(struct Object *ob);
 bool DRW_object_is_flat_normal(const struct Object *ob);
 int  DRW_object_is_mode_shade(const struct Object *ob);
+float DRW_object_screen_size_get(struct Object *ob);
 
 /* Draw commands */
 void DRW_draw_pass(DRWPass *pass);
@@ -31,12 +31,19 @@
 #include "DNA_particle_types.h"
 #include "DNA_modifier_types.h"
 #include "DNA_lattice_types.h"
+#include "DNA_armature_types.h"
+#include "DNA_action_types.h"
 
 #include "BLI_utildefines.h"
 #include "BLI_math.h"
+#include "BLI_listbase.h"
+
+#include "BKE_action.h"
 
 #include "GPU_batch.h"
 
+#include "DRW_render.h"
+
 #include "draw_cache.h"
 #include "draw_cache_impl.h"
 
@@ -506,11 +513,39 @@ Gwn_Batch *DRW_cache_object_wire_outline_get(Object *ob)
 	}
 }
 
+/* Approximate screen area in pixels per triangle of a mesh level of detail. */
+#define MESH_LOD_PIXELS_PER_TRI 4.0f
+
+/**
+ * Mesh to draw for \a ob in object mode, a decimated copy when it's small on screen.
+ * Selection, depth and image renders always use the full mesh.
+ */
+static Mesh *drw_cache_mesh_lod_get(Object *ob)
+{
+	Mesh *me = ob->data;
+
+	if ((ob->mode != OB_MODE_OBJECT) ||
+	    DRW_state_is_select() || DRW_state_is_depth() || DRW_state_is_image_render())
+	{
+		return me;
+	}
+
+	const float size = DRW_object_screen_size_get(ob);
+	if (size == FLT_MAX) {
+		return me;
+	}
+
+	const int tri_len_target = (int)((size * size) / MESH_LOD_PIXELS_PER_TRI);
+	Mesh *lod_me = DRW_mesh_batch_cache_lod_get(me, tri_len_target);
+
+	return (lod_me != NULL) ? lod_me : me;
+}
+
 Gwn_Batch *DRW_cache_object_surface_get(Object *ob)
 {
 	switch (ob->type) {
 		case OB_MESH:
-			return DRW_cache_mesh_surface_get(ob);
+			return DRW_mesh_batch_cache_get_triangles_with_normals(drw_cache_mesh_lod_get(ob));
 		case OB_CURVE:
 			return DRW_cache_curve_surface_get(ob);
 		case OB_SURF:
@@ -527,7 +562,8 @@ Gwn_Batch **DRW_cache_object_surface_material_get(
 {
 	switch (ob->type) {
 		case OB_MESH:
-			return DRW_cache_mesh_surface_shaded_get(ob, gpumat_array, gpumat_array_len);
+			return DRW_mesh_batch_cache_get_surface_shaded(
+			        drw_cache_mesh_lod_get(ob), gpumat_array, gpumat_array_len);
 		default:
 			return NULL;
 	}
@@ -2295,6 +2331,90 @@ void DRW_cache_mesh_sculpt_coords_ensure(Object *ob)
 	DRW_mesh_cache_sculpt_coords_ensure(me);
 }
 
+Gwn_Batch *DRW_cache_mesh_surface_deform_get(Object *ob)
+{
+	BLI_assert(ob->type == OB_MESH);
+
+	Mesh *me = ob->data;
+	return DRW_mesh_batch_cache_get_triangles_with_normals_and_deform_weights(me);
+}
+
+/**
+ * Return the armature deforming \a ob when the deformation can be done on the GPU
+ * (see #DRW_cache_mesh_surface_deform_get), NULL otherwise.
+ *
+ * Only a single, plain vertex group armature modifier is supported,
+ * since the original mesh is drawn, any other modifier would be ignored anyway.
+ */
+Object *DRW_object_armature_deform_get(Object *ob)
+{
+	if (ob->type != OB_MESH || (ob->mode & OB_MODE_EDIT)) {
+		return NULL;
+	}
+
+	ArmatureModifierData *amd = NULL;
+	for (ModifierData *md = ob->modifiers.first; md; md = md->next) {
+		if ((md->mode & eModifierMode_Realtime) == 0) {
+			continue;
+		}
+		if (md->type != eModifierType_Armature || amd != NULL) {
+			return NULL;
+		}
+		amd = (ArmatureModifierData *)md;
+	}
+
+	if (amd == NULL ||
+	    amd->object == NULL ||
+	    amd->object->type != OB_ARMATURE ||
+	    amd->object->pose == NULL ||
+	    amd->deformflag != ARM_DEF_VGROUP ||
+	    amd->defgrp_name[0] != '\0')
+	{
+		return NULL;
+	}
+
+	const int defbase_tot = BLI_listbase_count(&ob->defbase);
+	if (defbase_tot == 0 || defbase_tot > DRW_DEFORM_GROUP_MAX) {
+		return NULL;
+	}
+
+	for (bDeformGroup *dg = ob->defbase.first; dg; dg = dg->next) {
+		bPoseChannel *pchan = BKE_pose_channel_find_name(amd->object->pose, dg->name);
+		if (pchan && pchan->bone && (pchan->bone->flag & BONE_NO_DEFORM) == 0) {
+			if (pchan->bone->segments > 1 || (pchan->bone->flag & BONE_MULT_VG_ENV)) {
+				return NULL;
+			}
+		}
+	}
+
+	return amd->object;
+}
+
+/**
+ * Fill one matrix per vertex group of \a ob (#DRW_DEFORM_GROUP_MAX),
+ * mapping the rest position to the deformed position in object space,
+ * groups without a deforming bone get a zero matrix, so they don't contribute.
+ * Matches #armature_deform_verts for linear blending.
+ */
+void DRW_object_armature_deform_matrices_calc(Object *ob, Object *ob_arm, float (*r_mats)[4][4])
+{
+	float obinv[4][4], premat[4][4], postmat[4][4];
+
+	invert_m4_m4(obinv, ob->obmat);
+	mul_m4_m4m4(postmat, obinv, ob_arm->obmat);
+	invert_m4_m4(premat, postmat);
+
+	memset(r_mats, 0, sizeof(*r_mats) * DRW_DEFORM_GROUP_MAX);
+
+	int i = 0;
+	for (bDeformGroup *dg = ob->defbase.first; dg && i < DRW_DEFORM_GROUP_MAX; dg = dg->next, i++) {
+		bPoseChannel *pchan = BKE_pose_channel_find_name(ob_arm->pose, dg->name);
+		if (pchan && pchan->bone && (pchan->bone->flag & BONE_NO_DEFORM) == 0) {
+			mul_m4_series(r_mats[i], postmat, pchan->chan_mat, premat);
+		}
+	}
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -123,6 +123,13 @@ struct Gwn_Batch *DRW_cache_mesh_verts_weight_overlay_get(struct Object *ob);
 struct Gwn_Batch **DRW_cache_mesh_surface_shaded_get(
         struct Object *ob, struct GPUMaterial **gpumat_array, uint gpumat_array_len);
 struct Gwn_Batch **DRW_cache_mesh_surface_texpaint_get(struct Object *ob);
+
+/* GPU armature deform, matches 'DEFORM_GROUP_MAX' in 'common_armature_deform_lib.glsl'. */
+#define DRW_DEFORM_GROUP_MAX 32
+struct Gwn_Batch *DRW_cache_mesh_surface_deform_get(struct Object *ob);
+struct Object *DRW_object_armature_deform_get(struct Object *ob);
+void DRW_object_armature_deform_matrices_calc(
+        struct Object *ob, struct Object *ob_arm, float (*r_mats)[4][4]);
 struct Gwn_Batch *DRW_cache_mesh_surface_texpaint_single_get(struct Object *ob);
 
 void DRW_cache_mesh_sculpt_coords_ensure(struct Object *ob);
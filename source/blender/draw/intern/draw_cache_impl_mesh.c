@@ -36,6 +36,9 @@
 #include "BLI_math_bits.h"
 #include "BLI_string.h"
 #include "BLI_alloca.h"
+#include "BLI_task.h"
+
+#include "atomic_ops.h"
 
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
@@ -51,14 +54,19 @@
 #include "BKE_texture.h"
 
 #include "bmesh.h"
+#include "bmesh_tools.h"
 
 #include "GPU_batch.h"
 #include "GPU_draw.h"
 #include "GPU_material.h"
 
+#include "draw_cache.h"
 #include "draw_cache_impl.h"  /* own include */
 
 static void mesh_batch_cache_clear(Mesh *me);
+struct MeshLODCache;
+static void mesh_lod_cache_free(struct MeshLODCache *lod);
+static bool mesh_batch_cache_update_deform(Mesh *me);
 
 /* ---------------------------------------------------------------------- */
 
@@ -1410,6 +1418,79 @@ static void add_overlay_loose_vert(
 /** \} */
 
 
+/* ---------------------------------------------------------------------- */
+
+/** \name Threaded Buffer Extraction
+ *
+ * Buffers with 3 vertices per looptri are filled in parallel over ranges of triangles.
+ * Hidden triangles are skipped, so every triangle gets the offset of its first vertex up-front,
+ * which gives the same buffer contents as filling them in order.
+ * \{ */
+
+/* Don't use threads for small meshes. */
+#define MESH_EXTRACT_USE_THREADING(tri_len) ((tri_len) > BKE_MESH_OMP_LIMIT)
+
+/**
+ * \return the vertex offset of each looptri in a tri-aligned buffer (-1 for skipped triangles),
+ * or NULL when no triangles are skipped, in that case the offset is `tri_index * 3`.
+ *
+ * \param use_hide: Skip hidden triangles (always the case for edit-mode).
+ * \param r_vbo_len: The number of vertices used in the buffer.
+ */
+static int *mesh_render_data_looptri_vbo_offsets_create(
+        const MeshRenderData *rdata, const bool use_hide, int *r_vbo_len)
+{
+	const int tri_len = mesh_render_data_looptri_len_get(rdata);
+	int *vbo_offsets = NULL;
+	int vbo_len = 0;
+
+	for (int i = 0; i < tri_len; i++) {
+		bool is_hidden;
+		if (rdata->edit_bmesh) {
+			is_hidden = BM_elem_flag_test(rdata->edit_bmesh->looptris[i][0]->f, BM_ELEM_HIDDEN) != 0;
+		}
+		else {
+			is_hidden = use_hide && (rdata->mpoly[rdata->mlooptri[i].poly].flag & ME_HIDE);
+		}
+
+		if (is_hidden) {
+			if (vbo_offsets == NULL) {
+				vbo_offsets = MEM_mallocN(sizeof(*vbo_offsets) * (size_t)tri_len, __func__);
+				for (int j = 0; j < i; j++) {
+					vbo_offsets[j] = j * 3;
+				}
+			}
+			vbo_offsets[i] = -1;
+		}
+		else {
+			if (vbo_offsets) {
+				vbo_offsets[i] = vbo_len;
+			}
+			vbo_len += 3;
+		}
+	}
+
+	*r_vbo_len = vbo_len;
+	return vbo_offsets;
+}
+
+BLI_INLINE int mesh_extract_vbo_offset(const int *vbo_offsets, const int tri_index)
+{
+	return vbo_offsets ? vbo_offsets[tri_index] : tri_index * 3;
+}
+
+/**
+ * Raw access to vertex \a vert_index of an attribute,
+ * unlike #GWN_vertbuf_raw_step this doesn't modify \a raw so it can be shared between threads.
+ */
+BLI_INLINE void *mesh_extract_raw_elem(const Gwn_VertBufRaw *raw, const int vert_index)
+{
+	return raw->data_init + (size_t)raw->stride * (size_t)vert_index;
+}
+
+/** \} */
+
+
 /* ---------------------------------------------------------------------- */
 
 /** \name Mesh Gwn_Batch Cache
@@ -1432,6 +1513,7 @@ typedef struct MeshBatchCache {
 	Gwn_VertBuf *tri_aligned_vert_colors;
 	Gwn_VertBuf *tri_aligned_select_id;
 	Gwn_VertBuf *tri_aligned_uv;  /* Active UV layer (mloopuv) */
+	Gwn_VertBuf *tri_aligned_deform_weights;  /* Up to 4 vertex groups for GPU deform. */
 	Gwn_VertBuf *edge_pos_with_select_bool;
 	Gwn_VertBuf *pos_with_select_bool;
 	Gwn_Batch *triangles_with_normals;
@@ -1442,6 +1524,8 @@ typedef struct MeshBatchCache {
 	Gwn_Batch *triangles_with_vert_colors;
 	/* Always skip hidden */
 	Gwn_Batch *triangles_with_select_id;
+	/* 'pos_with_normals' and 'tri_aligned_deform_weights'. */
+	Gwn_Batch *triangles_with_deform_weights;
 
 	Gwn_Batch *points_with_normals;
 	Gwn_Batch *fancy_edges; /* owns its vertex buffer (not shared) */
@@ -1497,6 +1581,11 @@ typedef struct MeshBatchCache {
 
 	/* XXX, only keep for as long as sculpt mode uses shaded drawing. */
 	bool is_sculpt_points_tag;
+	/* Only positions and normals changed, see #mesh_batch_cache_update_deform. */
+	bool is_deform_tag;
+
+	/* Decimated copies, see DRW_mesh_batch_cache_lod_get. */
+	struct MeshLODCache *lod;
 } MeshBatchCache;
 
 /* Gwn_Batch cache management. */
@@ -1574,6 +1663,18 @@ static MeshBatchCache *mesh_batch_cache_get(Mesh *me)
 		mesh_batch_cache_clear(me);
 		mesh_batch_cache_init(me);
 	}
+	else if (((MeshBatchCache *)me->batch_cache)->is_deform_tag) {
+		MeshBatchCache *cache = me->batch_cache;
+		/* Decimated copies don't follow the deformation. */
+		if (cache->lod) {
+			mesh_lod_cache_free(cache->lod);
+			cache->lod = NULL;
+		}
+		if (!mesh_batch_cache_update_deform(me)) {
+			mesh_batch_cache_clear(me);
+			mesh_batch_cache_init(me);
+		}
+	}
 	return me->batch_cache;
 }
 
@@ -1609,6 +1710,9 @@ void DRW_mesh_batch_cache_dirty(Mesh *me, int mode)
 		case BKE_MESH_BATCH_DIRTY_SCULPT_COORDS:
 			cache->is_sculpt_points_tag = true;
 			break;
+		case BKE_MESH_BATCH_DIRTY_DEFORM:
+			cache->is_deform_tag = true;
+			break;
 		default:
 			BLI_assert(0);
 	}
@@ -1664,6 +1768,8 @@ static void mesh_batch_cache_clear(Mesh *me)
 	GWN_VERTBUF_DISCARD_SAFE(cache->tri_aligned_select_id);
 	GWN_VERTBUF_DISCARD_SAFE(cache->tri_aligned_uv);
 	GWN_BATCH_DISCARD_SAFE(cache->triangles_with_select_id);
+	GWN_VERTBUF_DISCARD_SAFE(cache->tri_aligned_deform_weights);
+	GWN_BATCH_DISCARD_SAFE(cache->triangles_with_deform_weights);
 
 	BATCH_DISCARD_ALL_SAFE(cache->fancy_edges);
 
@@ -1691,6 +1797,10 @@ static void mesh_batch_cache_clear(Mesh *me)
 
 	GWN_BATCH_DISCARD_SAFE(cache->texpaint_triangles_single);
 
+	if (cache->lod) {
+		mesh_lod_cache_free(cache->lod);
+		cache->lod = NULL;
+	}
 }
 
 void DRW_mesh_batch_cache_free(Mesh *me)
@@ -1699,12 +1809,235 @@ void DRW_mesh_batch_cache_free(Mesh *me)
 	MEM_SAFE_FREE(me->batch_cache);
 }
 
+/* ---------------------------------------------------------------------- */
+
+/** \name Mesh Level of Detail
+ *
+ * Decimated copies of dense meshes, drawn instead of the mesh when it is small on screen.
+ * The chain is built by a background task using the collapse decimator of the decimate
+ * modifier, each level can be drawn as soon as it is finished.
+ * \{ */
+
+#define MESH_LOD_LEN 3
+#define MESH_LOD_TRIS_MIN 20000 /* Don't bother with lighter meshes */
+
+/* Ratio of the original triangles kept by each level. */
+static const float mesh_lod_factors[MESH_LOD_LEN] = {0.5f, 0.2f, 0.05f};
+
+typedef struct MeshLODCache {
+	TaskPool *task_pool;
+	BMesh *bm; /* Decimated in place by the task */
+	Mesh levels[MESH_LOD_LEN];
+	uint32_t levels_ready; /* Levels the task finished, only access atomically */
+} MeshLODCache;
+
+static void mesh_lod_build_task(TaskPool *__restrict pool, void *taskdata, int UNUSED(threadid))
+{
+	MeshLODCache *lod = taskdata;
+	float factor_prev = 1.0f;
+
+	for (int i = 0; i < MESH_LOD_LEN; i++) {
+		if (BLI_task_pool_canceled(pool)) {
+			break;
+		}
+
+		/* Each level decimates the previous one. */
+		BM_mesh_decimate_collapse(lod->bm, mesh_lod_factors[i] / factor_prev, NULL, 0.0f, true, -1, 0.0f);
+		factor_prev = mesh_lod_factors[i];
+
+		BM_mesh_bm_to_me(lod->bm, &lod->levels[i], (&(struct BMeshToMeshParams){0}));
+
+		atomic_add_and_fetch_uint32(&lod->levels_ready, 1);
+	}
+
+	BM_mesh_free(lod->bm);
+	lod->bm = NULL;
+}
+
+static MeshLODCache *mesh_lod_cache_create(Mesh *me)
+{
+	MeshLODCache *lod = MEM_callocN(sizeof(*lod), __func__);
+	float loc[3], size[3];
+
+	/* Keep the texture space of the original mesh for generated coordinates. */
+	BKE_mesh_texspace_get(me, loc, NULL, size);
+
+	for (int i = 0; i < MESH_LOD_LEN; i++) {
+		Mesh *level = &lod->levels[i];
+		BKE_mesh_init(level);
+		level->totcol = me->totcol;
+		level->flag = me->flag;
+		level->smoothresh = me->smoothresh;
+		level->texflag = me->texflag & ~ME_AUTOSPACE;
+		copy_v3_v3(level->loc, loc);
+		copy_v3_v3(level->size, size);
+	}
+
+	/* Only the conversion runs here, it reads 'me' which may change once we return. */
+	lod->bm = BM_mesh_create(
+	        &bm_mesh_allocsize_default,
+	        &((struct BMeshCreateParams){.use_toolflags = false,}));
+	BM_mesh_bm_from_me(
+	        lod->bm, me, (&(struct BMeshFromMeshParams){
+	            .calc_face_normal = true,
+	        }));
+
+	lod->task_pool = BLI_task_pool_create_background(BLI_task_scheduler_get(), NULL);
+	BLI_task_pool_push(lod->task_pool, mesh_lod_build_task, lod, false, TASK_PRIORITY_LOW);
+
+	return lod;
+}
+
+static void mesh_lod_cache_free(MeshLODCache *lod)
+{
+	/* Waits for the level being decimated to finish. */
+	BLI_task_pool_cancel(lod->task_pool);
+	BLI_task_pool_free(lod->task_pool);
+
+	if (lod->bm) {
+		BM_mesh_free(lod->bm);
+	}
+
+	const uint32_t levels_ready = atomic_add_and_fetch_uint32(&lod->levels_ready, 0);
+	for (int i = 0; i < MESH_LOD_LEN; i++) {
+		if (i < levels_ready) {
+			BKE_mesh_free(&lod->levels[i]);
+		}
+	}
+
+	MEM_freeN(lod);
+}
+
+/**
+ * Coarsest decimated copy of \a me having at least \a tri_len_target triangles,
+ * or NULL to draw \a me itself. The chain is built in the background the first time
+ * a level would be used, so the full mesh is drawn until the levels are ready.
+ * The returned mesh is owned by the batch cache of \a me.
+ */
+Mesh *DRW_mesh_batch_cache_lod_get(Mesh *me, int tri_len_target)
+{
+	if (me->edit_btmesh != NULL) {
+		return NULL;
+	}
+
+	MeshBatchCache *cache = mesh_batch_cache_get(me);
+
+	if ((cache->tri_len < MESH_LOD_TRIS_MIN) ||
+	    (tri_len_target > (int)(cache->tri_len * mesh_lod_factors[0])))
+	{
+		return NULL;
+	}
+
+	if (cache->lod == NULL) {
+		cache->lod = mesh_lod_cache_create(me);
+		return NULL;
+	}
+
+	const uint32_t levels_ready = atomic_add_and_fetch_uint32(&cache->lod->levels_ready, 0);
+	Mesh *lod_me = NULL;
+
+	for (int i = 0; i < levels_ready; i++) {
+		Mesh *level = &cache->lod->levels[i];
+		if (mesh_render_looptri_len_get(level) < tri_len_target) {
+			break;
+		}
+		lod_me = level;
+	}
+
+	return lod_me;
+}
+
+/** \} */
+
 /* Gwn_Batch cache usage. */
 
+#define USE_COMP_MESH_DATA
+
+typedef struct MeshExtractTriShadingData {
+	const MeshRenderData *rdata;
+	int *vbo_offsets;
+	uint uv_len, tangent_len, vcol_len;
+	const Gwn_VertBufRaw *uv_step, *tangent_step, *vcol_step;
+} MeshExtractTriShadingData;
+
+static void mesh_extract_tri_shading_data_bm_cb(void *userdata, const int i)
+{
+	const MeshExtractTriShadingData *data = userdata;
+	const MeshRenderData *rdata = data->rdata;
+	const int vbo_index = mesh_extract_vbo_offset(data->vbo_offsets, i);
+
+	if (vbo_index == -1) {
+		return;
+	}
+
+	const BMLoop **bm_looptri = (const BMLoop **)rdata->edit_bmesh->looptris[i];
+
+	/* UVs */
+	for (uint j = 0; j < data->uv_len; j++) {
+		const uint layer_offset = rdata->cd.offset.uv[j];
+		for (uint t = 0; t < 3; t++) {
+			const float *elem = ((MLoopUV *)BM_ELEM_CD_GET_VOID_P(bm_looptri[t], layer_offset))->uv;
+			copy_v2_v2(mesh_extract_raw_elem(&data->uv_step[j], vbo_index + t), elem);
+		}
+	}
+	/* TANGENTs */
+	for (uint j = 0; j < data->tangent_len; j++) {
+		float (*layer_data)[4] = rdata->cd.layers.tangent[j];
+		for (uint t = 0; t < 3; t++) {
+			const float *elem = layer_data[BM_elem_index_get(bm_looptri[t])];
+			normal_float_to_short_v3(mesh_extract_raw_elem(&data->tangent_step[j], vbo_index + t), elem);
+		}
+	}
+	/* VCOLs */
+	for (uint j = 0; j < data->vcol_len; j++) {
+		const uint layer_offset = rdata->cd.offset.vcol[j];
+		for (uint t = 0; t < 3; t++) {
+			const uchar *elem = &((MLoopCol *)BM_ELEM_CD_GET_VOID_P(bm_looptri[t], layer_offset))->r;
+			copy_v3_v3_uchar(mesh_extract_raw_elem(&data->vcol_step[j], vbo_index + t), elem);
+		}
+	}
+}
+
+static void mesh_extract_tri_shading_data_cb(void *userdata, const int i)
+{
+	const MeshExtractTriShadingData *data = userdata;
+	const MeshRenderData *rdata = data->rdata;
+	const int vbo_index = mesh_extract_vbo_offset(data->vbo_offsets, i);
+	const MLoopTri *mlt = &rdata->mlooptri[i];
+
+	/* UVs */
+	for (uint j = 0; j < data->uv_len; j++) {
+		const MLoopUV *layer_data = rdata->cd.layers.uv[j];
+		for (uint t = 0; t < 3; t++) {
+			const float *elem = layer_data[mlt->tri[t]].uv;
+			copy_v2_v2(mesh_extract_raw_elem(&data->uv_step[j], vbo_index + t), elem);
+		}
+	}
+	/* TANGENTs */
+	for (uint j = 0; j < data->tangent_len; j++) {
+		float (*layer_data)[4] = rdata->cd.layers.tangent[j];
+		for (uint t = 0; t < 3; t++) {
+			const float *elem = layer_data[mlt->tri[t]];
+#ifdef USE_COMP_MESH_DATA
+			normal_float_to_short_v3(mesh_extract_raw_elem(&data->tangent_step[j], vbo_index + t), elem);
+#else
+			copy_v3_v3(mesh_extract_raw_elem(&data->tangent_step[j], vbo_index + t), elem);
+#endif
+		}
+	}
+	/* VCOLs */
+	for (uint j = 0; j < data->vcol_len; j++) {
+		const MLoopCol *layer_data = rdata->cd.layers.vcol[j];
+		for (uint t = 0; t < 3; t++) {
+			const uchar *elem = &layer_data[mlt->tri[t]].r;
+			copy_v3_v3_uchar(mesh_extract_raw_elem(&data->vcol_step[j], vbo_index + t), elem);
+		}
+	}
+}
+
 static Gwn_VertBuf *mesh_batch_cache_get_tri_shading_data(MeshRenderData *rdata, MeshBatchCache *cache)
 {
 	BLI_assert(rdata->types & (MR_DATATYPE_VERT | MR_DATATYPE_LOOPTRI | MR_DATATYPE_LOOP | MR_DATATYPE_POLY));
-#define USE_COMP_MESH_DATA
 
 	if (cache->shaded_triangles_data == NULL) {
 		const uint uv_len = rdata->cd.layers.uv_len;
@@ -1811,83 +2144,20 @@ static Gwn_VertBuf *mesh_batch_cache_get_tri_shading_data(MeshRenderData *rdata,
 
 		/* TODO deduplicate all verts and make use of Gwn_IndexBuf in
 		 * mesh_batch_cache_get_triangles_in_order_split_by_material. */
-		if (rdata->edit_bmesh) {
-			for (uint i = 0; i < tri_len; i++) {
-				const BMLoop **bm_looptri = (const BMLoop **)rdata->edit_bmesh->looptris[i];
-				if (BM_elem_flag_test(bm_looptri[0]->f, BM_ELEM_HIDDEN)) {
-					continue;
-				}
-				/* UVs */
-				for (uint j = 0; j < uv_len; j++) {
-					const uint layer_offset = rdata->cd.offset.uv[j];
-					for (uint t = 0; t < 3; t++) {
-						const float *elem = ((MLoopUV *)BM_ELEM_CD_GET_VOID_P(bm_looptri[t], layer_offset))->uv;
-						copy_v2_v2(GWN_vertbuf_raw_step(&uv_step[j]), elem);
-					}
-				}
-				/* TANGENTs */
-				for (uint j = 0; j < tangent_len; j++) {
-					float (*layer_data)[4] = rdata->cd.layers.tangent[j];
-					for (uint t = 0; t < 3; t++) {
-						const float *elem = layer_data[BM_elem_index_get(bm_looptri[t])];
-						normal_float_to_short_v3(GWN_vertbuf_raw_step(&tangent_step[j]), elem);
-					}
-				}
-				/* VCOLs */
-				for (uint j = 0; j < vcol_len; j++) {
-					const uint layer_offset = rdata->cd.offset.vcol[j];
-					for (uint t = 0; t < 3; t++) {
-						const uchar *elem = &((MLoopCol *)BM_ELEM_CD_GET_VOID_P(bm_looptri[t], layer_offset))->r;
-						copy_v3_v3_uchar(GWN_vertbuf_raw_step(&vcol_step[j]), elem);
-					}
-				}
-			}
-		}
-		else {
-			for (uint i = 0; i < tri_len; i++) {
-				const MLoopTri *mlt = &rdata->mlooptri[i];
-
-				/* UVs */
-				for (uint j = 0; j < uv_len; j++) {
-					const MLoopUV *layer_data = rdata->cd.layers.uv[j];
-					for (uint t = 0; t < 3; t++) {
-						const float *elem = layer_data[mlt->tri[t]].uv;
-						copy_v2_v2(GWN_vertbuf_raw_step(&uv_step[j]), elem);
-					}
-				}
-				/* TANGENTs */
-				for (uint j = 0; j < tangent_len; j++) {
-					float (*layer_data)[4] = rdata->cd.layers.tangent[j];
-					for (uint t = 0; t < 3; t++) {
-						const float *elem = layer_data[mlt->tri[t]];
-#ifdef USE_COMP_MESH_DATA
-						normal_float_to_short_v3(GWN_vertbuf_raw_step(&tangent_step[j]), elem);
-#else
-						copy_v3_v3(GWN_vertbuf_raw_step(&tangent_step[j]), elem);
-#endif
-					}
-				}
-				/* VCOLs */
-				for (uint j = 0; j < vcol_len; j++) {
-					const MLoopCol *layer_data = rdata->cd.layers.vcol[j];
-					for (uint t = 0; t < 3; t++) {
-						const uchar *elem = &layer_data[mlt->tri[t]].r;
-						copy_v3_v3_uchar(GWN_vertbuf_raw_step(&vcol_step[j]), elem);
-					}
-				}
-			}
-		}
+		MeshExtractTriShadingData data = {
+			.rdata = rdata,
+			.uv_len = uv_len, .tangent_len = tangent_len, .vcol_len = vcol_len,
+			.uv_step = uv_step, .tangent_step = tangent_step, .vcol_step = vcol_step,
+		};
+		/* Mesh data doesn't skip hidden faces. */
+		data.vbo_offsets = mesh_render_data_looptri_vbo_offsets_create(rdata, false, &vbo_len_used);
 
-		vbo_len_used = GWN_vertbuf_raw_used(&layers_combined_step[0]);
+		BLI_task_parallel_range(
+		        0, tri_len, &data,
+		        rdata->edit_bmesh ? mesh_extract_tri_shading_data_bm_cb : mesh_extract_tri_shading_data_cb,
+		        MESH_EXTRACT_USE_THREADING(tri_len));
 
-#ifndef NDEBUG
-		/* Check all layers are write aligned. */
-		if (layers_combined_len > 1) {
-			for (uint i = 1; i < layers_combined_len; i++) {
-				BLI_assert(vbo_len_used == GWN_vertbuf_raw_used(&layers_combined_step[i]));
-			}
-		}
-#endif
+		MEM_SAFE_FREE(data.vbo_offsets);
 
 		if (vbo_len_capacity != vbo_len_used) {
 			GWN_vertbuf_data_resize(vbo, vbo_len_used);
@@ -1899,6 +2169,22 @@ static Gwn_VertBuf *mesh_batch_cache_get_tri_shading_data(MeshRenderData *rdata,
 	return cache->shaded_triangles_data;
 }
 
+typedef struct MeshExtractTriUVData {
+	const MeshRenderData *rdata;
+	Gwn_VertBufRaw uv_step;
+} MeshExtractTriUVData;
+
+static void mesh_extract_tri_uv_active_cb(void *userdata, const int i)
+{
+	const MeshExtractTriUVData *data = userdata;
+	const MLoopTri *mlt = &data->rdata->mlooptri[i];
+	const MLoopUV *mloopuv = data->rdata->mloopuv;
+
+	for (uint t = 0; t < 3; t++) {
+		copy_v2_v2(mesh_extract_raw_elem(&data->uv_step, i * 3 + t), mloopuv[mlt->tri[t]].uv);
+	}
+}
+
 static Gwn_VertBuf *mesh_batch_cache_get_tri_uv_active(
         MeshRenderData *rdata, MeshBatchCache *cache)
 {
@@ -1906,8 +2192,6 @@ static Gwn_VertBuf *mesh_batch_cache_get_tri_uv_active(
 	BLI_assert(rdata->edit_bmesh == NULL);
 
 	if (cache->tri_aligned_uv == NULL) {
-		unsigned int vidx = 0;
-
 		static Gwn_VertFormat format = { 0 };
 		static struct { uint uv; } attr_id;
 		if (format.attrib_ct == 0) {
@@ -1922,15 +2206,13 @@ static Gwn_VertBuf *mesh_batch_cache_get_tri_uv_active(
 		int vbo_len_used = 0;
 		GWN_vertbuf_data_alloc(vbo, vbo_len_capacity);
 
-		const MLoopUV *mloopuv = rdata->mloopuv;
+		MeshExtractTriUVData data = {.rdata = rdata};
+		GWN_vertbuf_attr_get_raw_data(vbo, attr_id.uv, &data.uv_step);
 
-		for (int i = 0; i < tri_len; i++) {
-			const MLoopTri *mlt = &rdata->mlooptri[i];
-			GWN_vertbuf_attr_set(vbo, attr_id.uv, vidx++, mloopuv[mlt->tri[0]].uv);
-			GWN_vertbuf_attr_set(vbo, attr_id.uv, vidx++, mloopuv[mlt->tri[1]].uv);
-			GWN_vertbuf_attr_set(vbo, attr_id.uv, vidx++, mloopuv[mlt->tri[2]].uv);
-		}
-		vbo_len_used = vidx;
+		BLI_task_parallel_range(
+		        0, tri_len, &data, mesh_extract_tri_uv_active_cb,
+		        MESH_EXTRACT_USE_THREADING(tri_len));
+		vbo_len_used = tri_len * 3;
 
 		BLI_assert(vbo_len_capacity == vbo_len_used);
 		UNUSED_VARS_NDEBUG(vbo_len_used);
@@ -1939,112 +2221,151 @@ static Gwn_VertBuf *mesh_batch_cache_get_tri_uv_active(
 	return cache->tri_aligned_uv;
 }
 
-static Gwn_VertBuf *mesh_batch_cache_get_tri_pos_and_normals_ex(
-        MeshRenderData *rdata, const bool use_hide,
-        Gwn_VertBuf **r_vbo)
+typedef struct MeshExtractTriPosNorData {
+	const MeshRenderData *rdata;
+	int *vbo_offsets;
+	Gwn_VertBufRaw pos_step, nor_step;
+} MeshExtractTriPosNorData;
+
+static void mesh_extract_tri_pos_and_normals_bm_cb(void *userdata, const int i)
 {
-	BLI_assert(rdata->types & (MR_DATATYPE_VERT | MR_DATATYPE_LOOPTRI | MR_DATATYPE_LOOP | MR_DATATYPE_POLY));
+	const MeshExtractTriPosNorData *data = userdata;
+	const MeshRenderData *rdata = data->rdata;
+	const int vbo_index = mesh_extract_vbo_offset(data->vbo_offsets, i);
 
-	if (*r_vbo == NULL) {
-		static Gwn_VertFormat format = { 0 };
-		static struct { uint pos, nor; } attr_id;
-		if (format.attrib_ct == 0) {
-			attr_id.pos = GWN_vertformat_attr_add(&format, "pos", GWN_COMP_F32, 3, GWN_FETCH_FLOAT);
-			attr_id.nor = GWN_vertformat_attr_add(&format, "nor", GWN_COMP_I10, 3, GWN_FETCH_INT_TO_FLOAT_UNIT);
+	/* use_hide always for edit-mode */
+	if (vbo_index == -1) {
+		return;
+	}
+
+	const BMLoop **bm_looptri = (const BMLoop **)rdata->edit_bmesh->looptris[i];
+	const BMFace *bm_face = bm_looptri[0]->f;
+
+	if (BM_elem_flag_test(bm_face, BM_ELEM_SMOOTH)) {
+		for (uint t = 0; t < 3; t++) {
+			*((Gwn_PackedNormal *)mesh_extract_raw_elem(&data->nor_step, vbo_index + t)) =
+			        rdata->vert_normals_pack[BM_elem_index_get(bm_looptri[t]->v)];
 		}
+	}
+	else {
+		const Gwn_PackedNormal *snor_pack = &rdata->poly_normals_pack[BM_elem_index_get(bm_face)];
+		for (uint t = 0; t < 3; t++) {
+			*((Gwn_PackedNormal *)mesh_extract_raw_elem(&data->nor_step, vbo_index + t)) = *snor_pack;
+		}
+	}
 
-		const int tri_len = mesh_render_data_looptri_len_get(rdata);
+	for (uint t = 0; t < 3; t++) {
+		copy_v3_v3(mesh_extract_raw_elem(&data->pos_step, vbo_index + t), bm_looptri[t]->v->co);
+	}
+}
 
-		Gwn_VertBuf *vbo = *r_vbo = GWN_vertbuf_create_with_format(&format);
+static void mesh_extract_tri_pos_and_normals_cb(void *userdata, const int i)
+{
+	const MeshExtractTriPosNorData *data = userdata;
+	const MeshRenderData *rdata = data->rdata;
+	const int vbo_index = mesh_extract_vbo_offset(data->vbo_offsets, i);
 
-		const int vbo_len_capacity = tri_len * 3;
-		int vbo_len_used = 0;
-		GWN_vertbuf_data_alloc(vbo, vbo_len_capacity);
+	if (vbo_index == -1) {
+		return;
+	}
 
-		Gwn_VertBufRaw pos_step, nor_step;
-		GWN_vertbuf_attr_get_raw_data(vbo, attr_id.pos, &pos_step);
-		GWN_vertbuf_attr_get_raw_data(vbo, attr_id.nor, &nor_step);
+	const MLoopTri *mlt = &rdata->mlooptri[i];
+	const MPoly *mp = &rdata->mpoly[mlt->poly];
 
-		if (rdata->edit_bmesh) {
-			mesh_render_data_ensure_poly_normals_pack(rdata);
-			mesh_render_data_ensure_vert_normals_pack(rdata);
+	const uint vtri[3] = {
+		rdata->mloop[mlt->tri[0]].v,
+		rdata->mloop[mlt->tri[1]].v,
+		rdata->mloop[mlt->tri[2]].v,
+	};
+
+	if (mp->flag & ME_SMOOTH) {
+		for (uint t = 0; t < 3; t++) {
+			const MVert *mv = &rdata->mvert[vtri[t]];
+			*((Gwn_PackedNormal *)mesh_extract_raw_elem(&data->nor_step, vbo_index + t)) =
+			        GWN_normal_convert_i10_s3(mv->no);
+		}
+	}
+	else {
+		const Gwn_PackedNormal *pnors_pack = &rdata->poly_normals_pack[mlt->poly];
+		for (uint t = 0; t < 3; t++) {
+			*((Gwn_PackedNormal *)mesh_extract_raw_elem(&data->nor_step, vbo_index + t)) = *pnors_pack;
+		}
+	}
 
-			Gwn_PackedNormal *pnors_pack = rdata->poly_normals_pack;
-			Gwn_PackedNormal *vnors_pack = rdata->vert_normals_pack;
+	for (uint t = 0; t < 3; t++) {
+		const MVert *mv = &rdata->mvert[vtri[t]];
+		copy_v3_v3(mesh_extract_raw_elem(&data->pos_step, vbo_index + t), mv->co);
+	}
+}
 
-			for (int i = 0; i < tri_len; i++) {
-				const BMLoop **bm_looptri = (const BMLoop **)rdata->edit_bmesh->looptris[i];
-				const BMFace *bm_face = bm_looptri[0]->f;
+static const Gwn_VertFormat *mesh_tri_pos_and_normals_format(uint *r_pos_id, uint *r_nor_id)
+{
+	static Gwn_VertFormat format = { 0 };
+	static struct { uint pos, nor; } attr_id;
+	if (format.attrib_ct == 0) {
+		attr_id.pos = GWN_vertformat_attr_add(&format, "pos", GWN_COMP_F32, 3, GWN_FETCH_FLOAT);
+		attr_id.nor = GWN_vertformat_attr_add(&format, "nor", GWN_COMP_I10, 3, GWN_FETCH_INT_TO_FLOAT_UNIT);
+	}
+	*r_pos_id = attr_id.pos;
+	*r_nor_id = attr_id.nor;
+	return &format;
+}
 
-				/* use_hide always for edit-mode */
-				if (BM_elem_flag_test(bm_face, BM_ELEM_HIDDEN)) {
-					continue;
-				}
+/**
+ * Write positions and normals of the (visible) looptris into the allocated data of \a vbo.
+ *
+ * \return the number of vertices used, nothing is written when they don't fit in \a vbo.
+ */
+static int mesh_batch_cache_fill_tri_pos_and_normals(
+        MeshRenderData *rdata, const bool use_hide, Gwn_VertBuf *vbo)
+{
+	const int tri_len = mesh_render_data_looptri_len_get(rdata);
+	int vbo_len_used = 0;
 
-				const uint vtri[3] = {
-					BM_elem_index_get(bm_looptri[0]->v),
-					BM_elem_index_get(bm_looptri[1]->v),
-					BM_elem_index_get(bm_looptri[2]->v),
-				};
+	MeshExtractTriPosNorData data = {.rdata = rdata};
+	data.vbo_offsets = mesh_render_data_looptri_vbo_offsets_create(rdata, use_hide, &vbo_len_used);
 
-				if (BM_elem_flag_test(bm_face, BM_ELEM_SMOOTH)) {
-					for (uint t = 0; t < 3; t++) {
-						*((Gwn_PackedNormal *)GWN_vertbuf_raw_step(&nor_step)) = vnors_pack[vtri[t]];
-					}
-				}
-				else {
-					const Gwn_PackedNormal *snor_pack = &pnors_pack[BM_elem_index_get(bm_face)];
-					for (uint t = 0; t < 3; t++) {
-						*((Gwn_PackedNormal *)GWN_vertbuf_raw_step(&nor_step)) = *snor_pack;
-					}
-				}
+	if (vbo_len_used <= (int)vbo->vertex_ct) {
+		uint pos_id, nor_id;
+		mesh_tri_pos_and_normals_format(&pos_id, &nor_id);
+		GWN_vertbuf_attr_get_raw_data(vbo, pos_id, &data.pos_step);
+		GWN_vertbuf_attr_get_raw_data(vbo, nor_id, &data.nor_step);
 
-				for (uint t = 0; t < 3; t++) {
-					copy_v3_v3(GWN_vertbuf_raw_step(&pos_step), bm_looptri[t]->v->co);
-				}
-			}
+		/* Ensure lazily initialized data before threads read it. */
+		mesh_render_data_ensure_poly_normals_pack(rdata);
+		if (rdata->edit_bmesh) {
+			mesh_render_data_ensure_vert_normals_pack(rdata);
 		}
-		else {
 
-			/* Use normals from vertex */
-			mesh_render_data_ensure_poly_normals_pack(rdata);
+		BLI_task_parallel_range(
+		        0, tri_len, &data,
+		        rdata->edit_bmesh ? mesh_extract_tri_pos_and_normals_bm_cb : mesh_extract_tri_pos_and_normals_cb,
+		        MESH_EXTRACT_USE_THREADING(tri_len));
+	}
 
-			for (int i = 0; i < tri_len; i++) {
-				const MLoopTri *mlt = &rdata->mlooptri[i];
-				const MPoly *mp = &rdata->mpoly[mlt->poly];
+	MEM_SAFE_FREE(data.vbo_offsets);
 
-				if (use_hide && (mp->flag & ME_HIDE)) {
-					continue;
-				}
+	return vbo_len_used;
+}
+
+static Gwn_VertBuf *mesh_batch_cache_get_tri_pos_and_normals_ex(
+        MeshRenderData *rdata, const bool use_hide,
+        Gwn_VertBuf **r_vbo)
+{
+	BLI_assert(rdata->types & (MR_DATATYPE_VERT | MR_DATATYPE_LOOPTRI | MR_DATATYPE_LOOP | MR_DATATYPE_POLY));
 
-				const uint vtri[3] = {
-					rdata->mloop[mlt->tri[0]].v,
-					rdata->mloop[mlt->tri[1]].v,
-					rdata->mloop[mlt->tri[2]].v,
-				};
+	if (*r_vbo == NULL) {
+		uint pos_id, nor_id;
+		const Gwn_VertFormat *format = mesh_tri_pos_and_normals_format(&pos_id, &nor_id);
 
-				if (mp->flag & ME_SMOOTH) {
-					for (uint t = 0; t < 3; t++) {
-						const MVert *mv = &rdata->mvert[vtri[t]];
-						*((Gwn_PackedNormal *)GWN_vertbuf_raw_step(&nor_step)) = GWN_normal_convert_i10_s3(mv->no);
-					}
-				}
-				else {
-					const Gwn_PackedNormal *pnors_pack = &rdata->poly_normals_pack[mlt->poly];
-					for (uint t = 0; t < 3; t++) {
-						*((Gwn_PackedNormal *)GWN_vertbuf_raw_step(&nor_step)) = *pnors_pack;
-					}
-				}
+		const int tri_len = mesh_render_data_looptri_len_get(rdata);
 
-				for (uint t = 0; t < 3; t++) {
-					const MVert *mv = &rdata->mvert[vtri[t]];
-					copy_v3_v3(GWN_vertbuf_raw_step(&pos_step), mv->co);
-				}
-			}
-		}
+		Gwn_VertBuf *vbo = *r_vbo = GWN_vertbuf_create_with_format(format);
+
+		const int vbo_len_capacity = tri_len * 3;
+		GWN_vertbuf_data_alloc(vbo, vbo_len_capacity);
 
-		vbo_len_used = GWN_vertbuf_raw_used(&pos_step);
-		BLI_assert(vbo_len_used == GWN_vertbuf_raw_used(&nor_step));
+		const int vbo_len_used = mesh_batch_cache_fill_tri_pos_and_normals(rdata, use_hide, vbo);
 
 		if (vbo_len_capacity != vbo_len_used) {
 			GWN_vertbuf_data_resize(vbo, vbo_len_used);
@@ -2128,6 +2449,99 @@ static Gwn_VertBuf *mesh_batch_cache_get_tri_weights(
 	return cache->tri_aligned_weights;
 }
 
+typedef struct MeshExtractTriDeformWeightsData {
+	const MeshRenderData *rdata;
+	const uchar (*vert_groups)[4];
+	const float (*vert_weights)[4];
+	Gwn_VertBufRaw group_step, weight_step;
+} MeshExtractTriDeformWeightsData;
+
+static void mesh_extract_tri_deform_weights_cb(void *userdata, const int i)
+{
+	const MeshExtractTriDeformWeightsData *data = userdata;
+	const MLoopTri *mlt = &data->rdata->mlooptri[i];
+
+	for (uint t = 0; t < 3; t++) {
+		const uint v_index = data->rdata->mloop[mlt->tri[t]].v;
+		copy_v4_v4_uchar(mesh_extract_raw_elem(&data->group_step, i * 3 + t), data->vert_groups[v_index]);
+		copy_v4_v4(mesh_extract_raw_elem(&data->weight_step, i * 3 + t), data->vert_weights[v_index]);
+	}
+}
+
+/**
+ * The 4 vertex groups with the highest weights for each vertex, for GPU deform
+ * (see #DRW_object_armature_deform_get), unused slots have a zero weight.
+ * Only groups below #DRW_DEFORM_GROUP_MAX are used.
+ */
+static Gwn_VertBuf *mesh_batch_cache_get_tri_deform_weights(
+        MeshRenderData *rdata, MeshBatchCache *cache)
+{
+	BLI_assert(
+	        rdata->types &
+	        (MR_DATATYPE_VERT | MR_DATATYPE_LOOPTRI | MR_DATATYPE_LOOP | MR_DATATYPE_POLY | MR_DATATYPE_DVERT));
+	BLI_assert(rdata->edit_bmesh == NULL);
+
+	if (cache->tri_aligned_deform_weights == NULL) {
+		static Gwn_VertFormat format = { 0 };
+		static struct { uint group, weight; } attr_id;
+		if (format.attrib_ct == 0) {
+			attr_id.group = GWN_vertformat_attr_add(&format, "deformGroups", GWN_COMP_U8, 4, GWN_FETCH_INT);
+			attr_id.weight = GWN_vertformat_attr_add(&format, "deformWeights", GWN_COMP_F32, 4, GWN_FETCH_FLOAT);
+		}
+
+		const int tri_len = mesh_render_data_looptri_len_get(rdata);
+		const int vert_len = mesh_render_data_verts_len_get(rdata);
+
+		Gwn_VertBuf *vbo = cache->tri_aligned_deform_weights = GWN_vertbuf_create_with_format(&format);
+		GWN_vertbuf_data_alloc(vbo, tri_len * 3);
+
+		uchar (*vert_groups)[4] = MEM_callocN(sizeof(*vert_groups) * vert_len, __func__);
+		float (*vert_weights)[4] = MEM_callocN(sizeof(*vert_weights) * vert_len, __func__);
+
+		if (rdata->dvert) {
+			for (int i = 0; i < vert_len; i++) {
+				const MDeformVert *dv = &rdata->dvert[i];
+				for (int j = 0; j < dv->totweight; j++) {
+					const MDeformWeight *dw = &dv->dw[j];
+					if (dw->def_nr >= DRW_DEFORM_GROUP_MAX || dw->weight <= 0.0f) {
+						continue;
+					}
+					/* Insert sorted by weight, the lowest falls off the end. */
+					int k = 4;
+					while (k > 0 && vert_weights[i][k - 1] < dw->weight) {
+						if (k < 4) {
+							vert_weights[i][k] = vert_weights[i][k - 1];
+							vert_groups[i][k] = vert_groups[i][k - 1];
+						}
+						k--;
+					}
+					if (k < 4) {
+						vert_weights[i][k] = dw->weight;
+						vert_groups[i][k] = (uchar)dw->def_nr;
+					}
+				}
+			}
+		}
+
+		MeshExtractTriDeformWeightsData data = {
+			.rdata = rdata,
+			.vert_groups = (const uchar (*)[4])vert_groups,
+			.vert_weights = (const float (*)[4])vert_weights,
+		};
+		GWN_vertbuf_attr_get_raw_data(vbo, attr_id.group, &data.group_step);
+		GWN_vertbuf_attr_get_raw_data(vbo, attr_id.weight, &data.weight_step);
+
+		BLI_task_parallel_range(
+		        0, tri_len, &data, mesh_extract_tri_deform_weights_cb,
+		        MESH_EXTRACT_USE_THREADING(tri_len));
+
+		MEM_freeN(vert_groups);
+		MEM_freeN(vert_weights);
+	}
+
+	return cache->tri_aligned_deform_weights;
+}
+
 static Gwn_VertBuf *mesh_batch_cache_get_tri_vert_colors(
         MeshRenderData *rdata, MeshBatchCache *cache, bool use_hide)
 {
@@ -2248,44 +2662,68 @@ static Gwn_VertBuf *mesh_batch_cache_get_tri_select_id(
 	return cache->tri_aligned_select_id;
 }
 
+static const Gwn_VertFormat *mesh_vert_pos_and_nor_format(uint *r_pos_id, uint *r_nor_id)
+{
+	static Gwn_VertFormat format = { 0 };
+	static struct { uint pos, nor; } attr_id;
+	if (format.attrib_ct == 0) {
+		attr_id.pos = GWN_vertformat_attr_add(&format, "pos", GWN_COMP_F32, 3, GWN_FETCH_FLOAT);
+		attr_id.nor = GWN_vertformat_attr_add(&format, "nor", GWN_COMP_I16, 3, GWN_FETCH_INT_TO_FLOAT_UNIT);
+	}
+	*r_pos_id = attr_id.pos;
+	*r_nor_id = attr_id.nor;
+	return &format;
+}
+
+/**
+ * Write positions and normals of all vertices into the allocated data of \a vbo,
+ * which must hold one vertex for each mesh vertex.
+ */
+static void mesh_batch_cache_fill_vert_pos_and_nor_in_order(MeshRenderData *rdata, Gwn_VertBuf *vbo)
+{
+	const int vbo_len = mesh_render_data_verts_len_get(rdata);
+	uint pos_id, nor_id;
+	mesh_vert_pos_and_nor_format(&pos_id, &nor_id);
+
+	BLI_assert(vbo->vertex_ct == vbo_len);
+
+	if (rdata->edit_bmesh) {
+		BMesh *bm = rdata->edit_bmesh->bm;
+		BMIter iter;
+		BMVert *eve;
+		uint i;
+
+		BM_ITER_MESH_INDEX (eve, &iter, bm, BM_VERTS_OF_MESH, i) {
+			static short no_short[3];
+			normal_float_to_short_v3(no_short, eve->no);
+
+			GWN_vertbuf_attr_set(vbo, pos_id, i, eve->co);
+			GWN_vertbuf_attr_set(vbo, nor_id, i, no_short);
+		}
+		BLI_assert(i == vbo_len);
+	}
+	else {
+		for (int i = 0; i < vbo_len; ++i) {
+			GWN_vertbuf_attr_set(vbo, pos_id, i, rdata->mvert[i].co);
+			GWN_vertbuf_attr_set(vbo, nor_id, i, rdata->mvert[i].no);
+		}
+	}
+}
+
 static Gwn_VertBuf *mesh_batch_cache_get_vert_pos_and_nor_in_order(
         MeshRenderData *rdata, MeshBatchCache *cache)
 {
 	BLI_assert(rdata->types & MR_DATATYPE_VERT);
 
 	if (cache->pos_in_order == NULL) {
-		static Gwn_VertFormat format = { 0 };
-		static struct { uint pos, nor; } attr_id;
-		if (format.attrib_ct == 0) {
-			attr_id.pos = GWN_vertformat_attr_add(&format, "pos", GWN_COMP_F32, 3, GWN_FETCH_FLOAT);
-			attr_id.nor = GWN_vertformat_attr_add(&format, "nor", GWN_COMP_I16, 3, GWN_FETCH_INT_TO_FLOAT_UNIT);
-		}
+		uint pos_id, nor_id;
+		const Gwn_VertFormat *format = mesh_vert_pos_and_nor_format(&pos_id, &nor_id);
 
-		Gwn_VertBuf *vbo = cache->pos_in_order = GWN_vertbuf_create_with_format(&format);
+		Gwn_VertBuf *vbo = cache->pos_in_order = GWN_vertbuf_create_with_format(format);
 		const int vbo_len_capacity = mesh_render_data_verts_len_get(rdata);
 		GWN_vertbuf_data_alloc(vbo, vbo_len_capacity);
 
-		if (rdata->edit_bmesh) {
-			BMesh *bm = rdata->edit_bmesh->bm;
-			BMIter iter;
-			BMVert *eve;
-			uint i;
-
-			BM_ITER_MESH_INDEX (eve, &iter, bm, BM_VERTS_OF_MESH, i) {
-				static short no_short[3];
-				normal_float_to_short_v3(no_short, eve->no);
-
-				GWN_vertbuf_attr_set(vbo, attr_id.pos, i, eve->co);
-				GWN_vertbuf_attr_set(vbo, attr_id.nor, i, no_short);
-			}
-			BLI_assert(i == vbo_len_capacity);
-		}
-		else {
-			for (int i = 0; i < vbo_len_capacity; ++i) {
-				GWN_vertbuf_attr_set(vbo, attr_id.pos, i, rdata->mvert[i].co);
-				GWN_vertbuf_attr_set(vbo, attr_id.nor, i, rdata->mvert[i].no);
-			}
-		}
+		mesh_batch_cache_fill_vert_pos_and_nor_in_order(rdata, vbo);
 	}
 
 	return cache->pos_in_order;
@@ -2334,6 +2772,28 @@ static Gwn_VertFormat *edit_mesh_overlay_data_format(unsigned int *r_data_id)
 	return &format_flag;
 }
 
+typedef struct MeshExtractOverlayTriData {
+	MeshRenderData *rdata;
+	int *vbo_offsets;
+	Gwn_VertBuf *vbo_pos, *vbo_nor, *vbo_data;
+	uint pos_id, vnor_id, lnor_id, data_id;
+} MeshExtractOverlayTriData;
+
+static void mesh_extract_overlay_tri_cb(void *userdata, const int i)
+{
+	const MeshExtractOverlayTriData *data = userdata;
+	const int vbo_index = mesh_extract_vbo_offset(data->vbo_offsets, i);
+
+	if (vbo_index == -1) {
+		return;
+	}
+
+	add_overlay_tri(
+	        data->rdata, data->vbo_pos, data->vbo_nor, data->vbo_data,
+	        data->pos_id, data->vnor_id, data->lnor_id, data->data_id,
+	        (const BMLoop **)data->rdata->edit_bmesh->looptris[i], vbo_index);
+}
+
 static void mesh_batch_cache_create_overlay_tri_buffers(
         MeshRenderData *rdata, MeshBatchCache *cache)
 {
@@ -2369,17 +2829,18 @@ static void mesh_batch_cache_create_overlay_tri_buffers(
 		GWN_vertbuf_data_alloc(vbo_data, vbo_len_capacity);
 	}
 
-	for (int i = 0; i < tri_len; i++) {
-		const BMLoop **bm_looptri = (const BMLoop **)rdata->edit_bmesh->looptris[i];
-		if (!BM_elem_flag_test(bm_looptri[0]->f, BM_ELEM_HIDDEN)) {
-			add_overlay_tri(
-			        rdata, vbo_pos, vbo_nor, vbo_data,
-			        attr_id.pos, attr_id.vnor, attr_id.lnor, attr_id.data,
-			        bm_looptri, vbo_len_used);
+	MeshExtractOverlayTriData data = {
+		.rdata = rdata,
+		.vbo_pos = vbo_pos, .vbo_nor = vbo_nor, .vbo_data = vbo_data,
+		.pos_id = attr_id.pos, .vnor_id = attr_id.vnor, .lnor_id = attr_id.lnor, .data_id = attr_id.data,
+	};
+	data.vbo_offsets = mesh_render_data_looptri_vbo_offsets_create(rdata, true, &vbo_len_used);
 
-			vbo_len_used += 3;
-		}
-	}
+	BLI_task_parallel_range(
+	        0, tri_len, &data, mesh_extract_overlay_tri_cb,
+	        MESH_EXTRACT_USE_THREADING(tri_len));
+
+	MEM_SAFE_FREE(data.vbo_offsets);
 
 	/* Finish */
 	if (vbo_len_used != vbo_len_capacity) {
@@ -2994,6 +3455,33 @@ Gwn_Batch *DRW_mesh_batch_cache_get_triangles_with_normals_and_weights(Mesh *me,
 	return cache->triangles_with_weights;
 }
 
+/**
+ * Triangles with the vertex groups used for GPU deform, in object-mode only.
+ */
+Gwn_Batch *DRW_mesh_batch_cache_get_triangles_with_normals_and_deform_weights(Mesh *me)
+{
+	MeshBatchCache *cache = mesh_batch_cache_get(me);
+
+	BLI_assert(me->edit_btmesh == NULL);
+
+	if (cache->triangles_with_deform_weights == NULL) {
+		const int datatype =
+		        MR_DATATYPE_VERT | MR_DATATYPE_LOOPTRI | MR_DATATYPE_LOOP | MR_DATATYPE_POLY | MR_DATATYPE_DVERT;
+		MeshRenderData *rdata = mesh_render_data_create(me, datatype);
+
+		cache->triangles_with_deform_weights = GWN_batch_create(
+		        GWN_PRIM_TRIS, mesh_batch_cache_get_tri_pos_and_normals(rdata, cache), NULL);
+
+		GWN_batch_vertbuf_add(
+		        cache->triangles_with_deform_weights,
+		        mesh_batch_cache_get_tri_deform_weights(rdata, cache));
+
+		mesh_render_data_free(rdata);
+	}
+
+	return cache->triangles_with_deform_weights;
+}
+
 Gwn_Batch *DRW_mesh_batch_cache_get_triangles_with_normals_and_vert_colors(Mesh *me)
 {
 	MeshBatchCache *cache = mesh_batch_cache_get(me);
@@ -3439,6 +3927,58 @@ Gwn_Batch *DRW_mesh_batch_cache_get_weight_overlay_verts(Mesh *me)
 	return cache->overlay_weight_verts;
 }
 
+/**
+ * Rewrite the buffers holding positions and normals in place, keeping the GPU buffers
+ * (and the batches using them). Other buffers are kept as-is, except for the few
+ * that mix positions with other data which are freed and created again when needed.
+ *
+ * \return false when the buffers can't be updated (the cache needs to be rebuilt).
+ */
+static bool mesh_batch_cache_update_deform(Mesh *me)
+{
+	MeshBatchCache *cache = me->batch_cache;
+	bool ok = true;
+
+	cache->is_deform_tag = false;
+
+	/* Edit-mode overlays store positions in many buffers, rebuild instead. */
+	if (cache->is_editmode) {
+		return false;
+	}
+
+	const int datatype = MR_DATATYPE_VERT | MR_DATATYPE_LOOPTRI | MR_DATATYPE_LOOP | MR_DATATYPE_POLY;
+	MeshRenderData *rdata = mesh_render_data_create(me, datatype);
+
+	Gwn_VertBuf *vbo_tri_pos_nor[2] = {cache->pos_with_normals, cache->pos_with_normals_visible_only};
+	for (int i = 0; i < ARRAY_SIZE(vbo_tri_pos_nor); i++) {
+		Gwn_VertBuf *vbo = vbo_tri_pos_nor[i];
+		if (vbo) {
+			const bool use_hide = (vbo == cache->pos_with_normals_visible_only);
+			GWN_vertbuf_data_update_begin(vbo);
+			/* Hidden faces may have changed. */
+			if (mesh_batch_cache_fill_tri_pos_and_normals(rdata, use_hide, vbo) != (int)vbo->vertex_ct) {
+				ok = false;
+			}
+			GWN_vertbuf_data_update_end(vbo);
+		}
+	}
+
+	if (cache->pos_in_order) {
+		GWN_vertbuf_data_update_begin(cache->pos_in_order);
+		mesh_batch_cache_fill_vert_pos_and_nor_in_order(rdata, cache->pos_in_order);
+		GWN_vertbuf_data_update_end(cache->pos_in_order);
+	}
+
+	mesh_render_data_free(rdata);
+
+	/* Own their vertex buffers with positions. */
+	BATCH_DISCARD_ALL_SAFE(cache->fancy_edges);
+	BATCH_DISCARD_ALL_SAFE(cache->overlay_paint_edges);
+	cache->edge_pos_with_select_bool = NULL;
+
+	return ok;
+}
+
 /**
  * Needed for when we draw with shaded data.
  */
@@ -3451,15 +3991,12 @@ void DRW_mesh_cache_sculpt_coords_ensure(Mesh *me)
 			const int datatype = MR_DATATYPE_VERT | MR_DATATYPE_LOOPTRI | MR_DATATYPE_LOOP | MR_DATATYPE_POLY;
 			MeshRenderData *rdata = mesh_render_data_create(me, datatype);
 
-			Gwn_VertBuf *pos_with_normals = cache->pos_with_normals;
-			cache->pos_with_normals = NULL;
-			GWN_vertbuf_clear(pos_with_normals);
-			Gwn_VertBuf *vbo = mesh_batch_cache_get_tri_pos_and_normals(rdata, cache);
-			*pos_with_normals = *vbo;
-			GWN_vertformat_copy(&pos_with_normals->format, &vbo->format);
-
-			free(vbo);
-			cache->pos_with_normals = pos_with_normals;
+			Gwn_VertBuf *vbo = cache->pos_with_normals;
+			GWN_vertbuf_data_update_begin(vbo);
+			const int vbo_len_used = mesh_batch_cache_fill_tri_pos_and_normals(rdata, false, vbo);
+			BLI_assert(vbo_len_used == vbo->vertex_ct);
+			UNUSED_VARS_NDEBUG(vbo_len_used);
+			GWN_vertbuf_data_update_end(vbo);
 
 			mesh_render_data_free(rdata);
 		}
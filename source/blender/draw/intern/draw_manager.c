@@ -26,6 +26,7 @@
 #include <stdio.h>
 
 #include "BLI_dynstr.h"
+#include "BLI_jitter.h"
 #include "BLI_listbase.h"
 #include "BLI_rect.h"
 #include "BLI_string.h"
@@ -219,6 +220,8 @@ struct DRWInterface {
 	int orcotexfac;
 	int eye;
 	int clipplanes;
+	/* "InstanceModelMatrix" attrib location, when found calls of normal shading groups get instanced */
+	int instancemodelmatrix;
 	/* Textures */
 	int tex_bind; /* next texture binding point */
 	/* UBO */
@@ -227,6 +230,7 @@ struct DRWInterface {
 	Gwn_Batch *instance_batch; /* contains instances attributes */
 	GLuint instance_vbo; /* same as instance_batch but generated from DRWCalls */
 	int instance_count;
+	int instance_first; /* first instance of instance_vbo to draw */
 	Gwn_VertFormat vbo_format;
 };
 
@@ -255,6 +259,7 @@ typedef struct DRWCall {
 
 	Object *ob; /* Optional */
 	ID *ob_data; /* Optional. */
+	const BoundBox *bb; /* Optional, object space bounds used for view culling. */
 } DRWCall;
 
 typedef struct DRWCallGenerate {
@@ -323,15 +328,22 @@ enum {
 	STENCIL_ACTIVE          = (1 << 1),
 };
 
+#define MAX_BOUND_TEX_SLOTS 32
+
 /* Render State */
 static struct DRWGlobalState {
 	/* Rendering state */
 	GPUShader *shader;
 	ListBase bound_texs;
 	int tex_bind_id;
+	/* Texture bound to each slot in the current pass, indexed from the last slot down
+	 * (see DRWInterface.tex_bind), to skip redundant binds. */
+	GPUTexture *bound_tex_slots[MAX_BOUND_TEX_SLOTS];
 
 	/* Managed by `DRW_state_set`, `DRW_state_reset` */
 	DRWState state;
+	/* A generate callback ran, the GL state may not match 'state' anymore. */
+	bool state_external;
 
 	/* Per viewport */
 	GPUViewport *viewport;
@@ -346,6 +358,16 @@ static struct DRWGlobalState {
 	int num_clip_planes;
 	float clip_planes_eq[MAX_CLIP_PLANES][4];
 
+	/* View frustum of the pass being drawn, see DRW_STATE_VIEW_CULLING. */
+	bool use_view_culling;
+	float view_planes[6][4];
+
+	/* Temporal anti-aliasing, see drw_taa_view_jitter. */
+	int taa_sample; /* -1 if not accumulating */
+	bool taa_reset; /* Scene changed, previous samples are invalid */
+	bool taa_jittered;
+	float taa_winmat[4][4], taa_persmat[4][4], taa_persinv[4][4]; /* rv3d matrices backup */
+
 	struct {
 		unsigned int is_select : 1;
 		unsigned int is_depth : 1;
@@ -646,7 +668,9 @@ static DRWInterface *DRW_interface_create(GPUShader *shader)
 	interface->orcotexfac = GPU_shader_get_uniform(shader, "OrcoTexCoFactors[0]");
 	interface->eye = GPU_shader_get_uniform(shader, "eye");
 	interface->clipplanes = GPU_shader_get_uniform(shader, "ClipPlanes[0]");
+	interface->instancemodelmatrix = glGetAttribLocation(GPU_shader_get_program(shader), "InstanceModelMatrix");
 	interface->instance_count = 0;
+	interface->instance_first = 0;
 	interface->attribs_count = 0;
 	interface->attribs_stride = 0;
 	interface->instance_vbo = 0;
@@ -973,6 +997,7 @@ void DRW_shgroup_call_object_add(DRWShadingGroup *shgroup, Gwn_Batch *geom, Obje
 	copy_m4_m4(call->obmat, ob->obmat);
 	call->geometry = geom;
 	call->ob_data = ob->data;
+	call->bb = BKE_object_boundbox_get(ob);
 
 }
 
@@ -1430,6 +1455,50 @@ void DRW_pass_sort_shgroup_z(DRWPass *pass)
 	BLI_listbase_sort_r(&pass->shgroups, pass_shgroup_dist_sort, &zsortdata);
 }
 
+static const void *shgroup_first_texture(const DRWShadingGroup *shgroup)
+{
+	for (DRWUniform *uni = shgroup->interface->uniforms.first; uni; uni = uni->next) {
+		if (uni->type == DRW_UNIFORM_TEXTURE) {
+			return uni->value;
+		}
+	}
+	return NULL;
+}
+
+static int pass_shgroup_state_sort(const void *a, const void *b)
+{
+	const DRWShadingGroup *shgrp_a = (const DRWShadingGroup *)a;
+	const DRWShadingGroup *shgrp_b = (const DRWShadingGroup *)b;
+
+	if (shgrp_a->shader != shgrp_b->shader) {
+		return (shgrp_a->shader < shgrp_b->shader) ? -1 : 1;
+	}
+	if (shgrp_a->state_extra != shgrp_b->state_extra) {
+		return (shgrp_a->state_extra < shgrp_b->state_extra) ? -1 : 1;
+	}
+	if (shgrp_a->state_extra_disable != shgrp_b->state_extra_disable) {
+		return (shgrp_a->state_extra_disable < shgrp_b->state_extra_disable) ? -1 : 1;
+	}
+
+	const void *tex_a = shgroup_first_texture(shgrp_a);
+	const void *tex_b = shgroup_first_texture(shgrp_b);
+	if (tex_a != tex_b) {
+		return (tex_a < tex_b) ? -1 : 1;
+	}
+
+	return 0;
+}
+
+/**
+ * Sort shading groups by shader, state and textures, to reduce GL state changes.
+ * Only use this for passes where the drawing order doesn't matter (opaque, depth tested).
+ * The sort is stable, groups with the same state keep their order.
+ */
+void DRW_pass_sort_shgroup_state(DRWPass *pass)
+{
+	BLI_listbase_sort(&pass->shgroups, pass_shgroup_state_sort);
+}
+
 /** \} */
 
 
@@ -1821,9 +1890,9 @@ static void draw_geometry_execute(DRWShadingGroup *shgroup, Gwn_Batch *geom)
 		GWN_batch_draw_stupid_instanced_with_batch(geom, interface->instance_batch);
 	}
 	else if (interface->instance_vbo) {
-		GWN_batch_draw_stupid_instanced(
-		        geom, interface->instance_vbo, interface->instance_count, interface->attribs_count,
-		        interface->attribs_stride, interface->attribs_size, interface->attribs_loc);
+		GWN_batch_draw_stupid_instanced_ex(
+		        geom, interface->instance_vbo, interface->instance_first, interface->instance_count,
+		        interface->attribs_count, interface->attribs_stride, interface->attribs_size, interface->attribs_loc);
 	}
 	else {
 		GWN_batch_draw_stupid(geom);
@@ -1850,6 +1919,279 @@ static void draw_geometry(DRWShadingGroup *shgroup, Gwn_Batch *geom, const float
 	draw_geometry_execute(shgroup, geom);
 }
 
+/* -------------------------------------------------------------------- */
+
+/** \name View Culling
+ * \{ */
+
+static void draw_view_culling_init(DRWState pass_state)
+{
+	RegionView3D *rv3d = DST.draw_ctx.rv3d;
+	float (*persmat)[4];
+
+	DST.use_view_culling = false;
+
+	if ((pass_state & DRW_STATE_VIEW_CULLING) == 0) {
+		return;
+	}
+
+	if (viewport_matrix_override.override[DRW_MAT_PERS]) {
+		persmat = viewport_matrix_override.mat[DRW_MAT_PERS];
+	}
+	else if (rv3d != NULL) {
+		persmat = rv3d->persmat;
+	}
+	else {
+		return;
+	}
+
+	planes_from_projmat(persmat,
+	                    DST.view_planes[0], DST.view_planes[1], DST.view_planes[2],
+	                    DST.view_planes[3], DST.view_planes[4], DST.view_planes[5]);
+	DST.use_view_culling = true;
+}
+
+/**
+ * \return true if the bounds of \a call are entirely outside of one of the view planes.
+ */
+static bool draw_call_is_culled(const DRWCall *call)
+{
+	if (!DST.use_view_culling || call->head.type != DRW_CALL_SINGLE || call->bb == NULL) {
+		return false;
+	}
+
+	const BoundBox *bb = call->bb;
+	float co[8][3];
+
+	if (bb->flag & BOUNDBOX_DIRTY) {
+		return false;
+	}
+
+	for (int i = 0; i < 8; i++) {
+		mul_v3_m4v3(co[i], (float (*)[4])call->obmat, bb->vec[i]);
+	}
+
+	for (int p = 0; p < 6; p++) {
+		int i;
+		for (i = 0; i < 8; i++) {
+			if (plane_point_side_v3(DST.view_planes[p], co[i]) >= 0.0f) {
+				break;
+			}
+		}
+		if (i == 8) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/** \} */
+
+/**
+ * Upload the matrices of all calls of a #DRW_SHG_NORMAL shading group,
+ * for shaders reading them from the "InstanceModelMatrix" attrib.
+ *
+ * \return the number of calls.
+ */
+static int shgroup_calls_instance_matrices(DRWShadingGroup *shgroup)
+{
+	DRWInterface *interface = shgroup->interface;
+	int calls_len = 0;
+
+#ifdef USE_MEM_ITER
+	calls_len = BLI_memiter_count(shgroup->calls);
+#else
+	calls_len = BLI_listbase_count(&shgroup->calls);
+#endif
+
+	if (interface->instance_vbo) {
+		glDeleteBuffers(1, &interface->instance_vbo);
+		interface->instance_vbo = 0;
+	}
+
+	if (calls_len == 0) {
+		return 0;
+	}
+
+	float (*mats)[4][4] = MEM_mallocN(sizeof(*mats) * calls_len, "Call Instance Matrices");
+	int i = 0;
+
+#ifdef USE_MEM_ITER
+	BLI_memiter_handle calls_iter;
+	BLI_memiter_iter_init(shgroup->calls, &calls_iter);
+	for (DRWCall *call; (call = BLI_memiter_iter_step(&calls_iter)); i++)
+#else
+	for (DRWCall *call = shgroup->calls.first; call; call = call->head.next, i++)
+#endif
+	{
+		/* DRWCallGenerate.obmat is at the same offset. */
+		copy_m4_m4(mats[i], call->obmat);
+	}
+
+	interface->attribs_count = 1;
+	interface->attribs_stride = 16;
+	interface->attribs_size[0] = 16;
+	interface->attribs_loc[0] = interface->instancemodelmatrix;
+
+	glGenBuffers(1, &interface->instance_vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, interface->instance_vbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(*mats) * calls_len, mats, GL_STREAM_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	MEM_freeN(mats);
+
+	return calls_len;
+}
+
+typedef struct DRWCallInstanceRun {
+	Gwn_Batch *geometry;
+	ID *ob_data;
+	int first, len;
+	bool neg_scale;
+#ifdef USE_GPU_SELECT
+	int select_id;
+#endif
+} DRWCallInstanceRun;
+
+static void draw_shgroup_instance_run(DRWShadingGroup *shgroup, DRWCallInstanceRun *run)
+{
+	if (run->len == 0) {
+		return;
+	}
+
+	float unit_mat[4][4];
+	unit_m4(unit_mat);
+
+	if (run->neg_scale) {
+		glFrontFace(DST.backface);
+	}
+
+#ifdef USE_GPU_SELECT
+	if (G.f & G_PICKSEL) {
+		GPU_select_load_id(run->select_id);
+	}
+#endif
+
+	shgroup->interface->instance_first = run->first;
+	shgroup->interface->instance_count = run->len;
+	draw_geometry(shgroup, run->geometry, unit_mat, run->ob_data);
+
+	if (run->neg_scale) {
+		glFrontFace(DST.frontface);
+	}
+
+	run->len = 0;
+}
+
+/**
+ * Draw the calls of a #DRW_SHG_NORMAL shading group using instancing,
+ * consecutive calls of the same geometry are merged into a single draw.
+ */
+static void draw_shgroup_calls_instanced(DRWShadingGroup *shgroup)
+{
+	DRWInterface *interface = shgroup->interface;
+
+	if (shgroup_calls_instance_matrices(shgroup) == 0) {
+		return;
+	}
+
+	DRWCallInstanceRun run = {NULL};
+	int i = 0;
+
+#ifdef USE_MEM_ITER
+	BLI_memiter_handle calls_iter;
+	BLI_memiter_iter_init(shgroup->calls, &calls_iter);
+	for (DRWCall *call; (call = BLI_memiter_iter_step(&calls_iter)); i++)
+#else
+	for (DRWCall *call = shgroup->calls.first; call; call = call->head.next, i++)
+#endif
+	{
+		const bool neg_scale = is_negative_m4(call->obmat);
+
+		if (draw_call_is_culled(call)) {
+			draw_shgroup_instance_run(shgroup, &run);
+			continue;
+		}
+
+		if (call->head.type == DRW_CALL_SINGLE) {
+			if (run.len != 0 &&
+			    run.geometry == call->geometry &&
+			    run.ob_data == call->ob_data &&
+			    run.neg_scale == neg_scale
+#ifdef USE_GPU_SELECT
+			    && (((G.f & G_PICKSEL) == 0) || run.select_id == call->head.select_id)
+#endif
+			    )
+			{
+				run.len++;
+				continue;
+			}
+
+			draw_shgroup_instance_run(shgroup, &run);
+
+			run.geometry = call->geometry;
+			run.ob_data = call->ob_data;
+			run.first = i;
+			run.len = 1;
+			run.neg_scale = neg_scale;
+#ifdef USE_GPU_SELECT
+			run.select_id = call->head.select_id;
+#endif
+		}
+		else {
+			BLI_assert(call->head.type == DRW_CALL_GENERATE);
+			DRWCallGenerate *callgen = ((DRWCallGenerate *)call);
+			float unit_mat[4][4];
+			unit_m4(unit_mat);
+
+			draw_shgroup_instance_run(shgroup, &run);
+
+			if (neg_scale) {
+				glFrontFace(DST.backface);
+			}
+
+#ifdef USE_GPU_SELECT
+			if (G.f & G_PICKSEL) {
+				GPU_select_load_id(call->head.select_id);
+			}
+#endif
+
+			/* Every batch drawn by the callback uses this call matrix. */
+			interface->instance_first = i;
+			interface->instance_count = 1;
+			draw_geometry_prepare(shgroup, unit_mat, NULL, NULL);
+			callgen->geometry_fn(shgroup, draw_geometry_execute, callgen->user_data);
+			DST.state_external = true;
+
+			if (neg_scale) {
+				glFrontFace(DST.frontface);
+			}
+		}
+	}
+
+	draw_shgroup_instance_run(shgroup, &run);
+}
+
+static void draw_bind_texture(GPUTexture *tex, int bindloc)
+{
+	const int slot = GPU_max_textures() - 1 - bindloc;
+
+	if (slot >= 0 && slot < MAX_BOUND_TEX_SLOTS) {
+		if (DST.bound_tex_slots[slot] == tex) {
+			/* Already bound by a previous shading group of this pass. */
+			return;
+		}
+		DST.bound_tex_slots[slot] = tex;
+	}
+
+	GPU_texture_bind(tex, bindloc);
+
+	DRWBoundTexture *bound_tex = MEM_callocN(sizeof(DRWBoundTexture), "DRWBoundTexture");
+	bound_tex->tex = tex;
+	BLI_addtail(&DST.bound_texs, bound_tex);
+}
+
 static void draw_shgroup(DRWShadingGroup *shgroup, DRWState pass_state)
 {
 	BLI_assert(shgroup->shader);
@@ -1877,8 +2219,6 @@ static void draw_shgroup(DRWShadingGroup *shgroup, DRWState pass_state)
 	/* Binding Uniform */
 	/* Don't check anything, Interface should already contain the least uniform as possible */
 	for (DRWUniform *uni = interface->uniforms.first; uni; uni = uni->next) {
-		DRWBoundTexture *bound_tex;
-
 		switch (uni->type) {
 			case DRW_UNIFORM_SHORT_TO_INT:
 				val = (int)*((short *)uni->value);
@@ -1904,11 +2244,7 @@ static void draw_shgroup(DRWShadingGroup *shgroup, DRWState pass_state)
 			case DRW_UNIFORM_TEXTURE:
 				tex = (GPUTexture *)uni->value;
 				BLI_assert(tex);
-				GPU_texture_bind(tex, uni->bindloc);
-
-				bound_tex = MEM_callocN(sizeof(DRWBoundTexture), "DRWBoundTexture");
-				bound_tex->tex = tex;
-				BLI_addtail(&DST.bound_texs, bound_tex);
+				draw_bind_texture(tex, uni->bindloc);
 
 				GPU_shader_uniform_texture(shgroup->shader, uni->location, tex);
 				break;
@@ -1918,11 +2254,7 @@ static void draw_shgroup(DRWShadingGroup *shgroup, DRWState pass_state)
 				}
 				tex = *((GPUTexture **)uni->value);
 				BLI_assert(tex);
-				GPU_texture_bind(tex, uni->bindloc);
-
-				bound_tex = MEM_callocN(sizeof(DRWBoundTexture), "DRWBoundTexture");
-				bound_tex->tex = tex;
-				BLI_addtail(&DST.bound_texs, bound_tex);
+				draw_bind_texture(tex, uni->bindloc);
 
 				GPU_shader_uniform_texture(shgroup->shader, uni->location, tex);
 				break;
@@ -1982,6 +2314,9 @@ static void draw_shgroup(DRWShadingGroup *shgroup, DRWState pass_state)
 			}
 		}
 	}
+	else if (interface->instancemodelmatrix != -1) {
+		draw_shgroup_calls_instanced(shgroup);
+	}
 	else {
 #ifdef USE_MEM_ITER
 		BLI_memiter_handle calls_iter;
@@ -1991,6 +2326,10 @@ static void draw_shgroup(DRWShadingGroup *shgroup, DRWState pass_state)
 		for (DRWCall *call = shgroup->calls.first; call; call = call->head.next)
 #endif
 		{
+			if (draw_call_is_culled(call)) {
+				continue;
+			}
+
 			bool neg_scale = is_negative_m4(call->obmat);
 
 			/* Negative scale objects */
@@ -2008,6 +2347,7 @@ static void draw_shgroup(DRWShadingGroup *shgroup, DRWState pass_state)
 				DRWCallGenerate *callgen = ((DRWCallGenerate *)call);
 				draw_geometry_prepare(shgroup, callgen->obmat, NULL, NULL);
 				callgen->geometry_fn(shgroup, draw_geometry_execute, callgen->user_data);
+				DST.state_external = true;
 			}
 
 			/* Reset state */
@@ -2017,8 +2357,13 @@ static void draw_shgroup(DRWShadingGroup *shgroup, DRWState pass_state)
 		}
 	}
 
-	/* TODO: remove, (currently causes alpha issue with sculpt, need to investigate) */
-	DRW_state_reset();
+	/* Generate callbacks (sculpt) may change GL state behind our back,
+	 * other groups only change state through DRW_state_set. */
+	if (DST.state_external) {
+		DRW_state_reset();
+		memset(DST.bound_tex_slots, 0, sizeof(DST.bound_tex_slots));
+		DST.state_external = false;
+	}
 }
 
 static void DRW_draw_pass_ex(DRWPass *pass, DRWShadingGroup *start_group, DRWShadingGroup *end_group)
@@ -2029,9 +2374,12 @@ static void DRW_draw_pass_ex(DRWPass *pass, DRWShadingGroup *start_group, DRWSha
 
 	DRW_state_set(pass->state);
 	BLI_listbase_clear(&DST.bound_texs);
+	memset(DST.bound_tex_slots, 0, sizeof(DST.bound_tex_slots));
 
 	DRW_stats_query_start(pass->name);
 
+	draw_view_culling_init(pass->state);
+
 	for (DRWShadingGroup *shgroup = start_group; shgroup; shgroup = shgroup->next) {
 		draw_shgroup(shgroup, pass->state);
 		/* break if upper limit */
@@ -2046,12 +2394,16 @@ static void DRW_draw_pass_ex(DRWPass *pass, DRWShadingGroup *start_group, DRWSha
 	}
 	DST.tex_bind_id = 0;
 	BLI_freelistN(&DST.bound_texs);
+	memset(DST.bound_tex_slots, 0, sizeof(DST.bound_tex_slots));
 
 	if (DST.shader) {
 		GPU_shader_unbind();
 		DST.shader = NULL;
 	}
 
+	/* Leave the default state for whatever draws after the pass. */
+	DRW_state_reset();
+
 	DRW_stats_query_end();
 }
 
@@ -2190,6 +2542,34 @@ int DRW_object_is_mode_shade(const Object *ob)
 	return -1;
 }
 
+/**
+ * Approximate diameter in pixels of the bounding sphere of \a ob in the current view,
+ * FLT_MAX when the view is inside it or unknown. Used to pick a level of detail.
+ */
+float DRW_object_screen_size_get(Object *ob)
+{
+	RegionView3D *rv3d = DST.draw_ctx.rv3d;
+	BoundBox *bb = BKE_object_boundbox_get(ob);
+
+	if (rv3d == NULL || bb == NULL) {
+		return FLT_MAX;
+	}
+
+	float center[3];
+	mid_v3_v3v3(center, bb->vec[0], bb->vec[6]);
+	mul_m4_v3(ob->obmat, center);
+	const float radius = len_v3v3(bb->vec[0], bb->vec[6]) * 0.5f * mat4_to_scale(ob->obmat);
+
+	/* Distance to the view plane, 1.0 for orthographic views. */
+	const float w = mul_project_m4_v3_zfac(rv3d->persmat, center);
+
+	if (w <= radius) {
+		return FLT_MAX;
+	}
+
+	return radius * rv3d->winmat[1][1] * DST.size[1] / w;
+}
+
 /** \} */
 
 
@@ -2688,6 +3068,8 @@ static void DRW_engines_cache_init(void)
 
 static void DRW_engines_cache_populate(Object *ob)
 {
+	PROFILE_START(ob_stime);
+
 	for (LinkData *link = DST.enabled_engines.first; link; link = link->next) {
 		DrawEngineType *engine = link->data;
 		ViewportEngineData *data = DRW_viewport_engine_data_get(engine);
@@ -2699,6 +3081,12 @@ static void DRW_engines_cache_populate(Object *ob)
 
 		PROFILE_END_ACCUM(data->cache_time, stime);
 	}
+
+#ifdef USE_PROFILE
+	double ob_time = 0.0;
+	PROFILE_END_ACCUM(ob_time, ob_stime);
+	DRW_stats_cache_time_add(ob->type, ob_time);
+#endif
 }
 
 static void DRW_engines_cache_finish(void)
@@ -3085,7 +3473,12 @@ static void DRW_debug_gpu_stats(void)
 	draw_stat(&rect, 1, v++, stat_string, sizeof(stat_string));
 	sprintf(stat_string, "   |--> Textures");
 	draw_stat(&rect, 0, v, stat_string, sizeof(stat_string));
-	sprintf(stat_string, "%.2fMB", (double)tex_mem / 1000000.0);
+	if (U.texture_memory_limit != 0) {
+		sprintf(stat_string, "%.2fMB / %dMB", (double)tex_mem / 1000000.0, U.texture_memory_limit);
+	}
+	else {
+		sprintf(stat_string, "%.2fMB", (double)tex_mem / 1000000.0);
+	}
 	draw_stat(&rect, 1, v++, stat_string, sizeof(stat_string));
 	sprintf(stat_string, "   |--> Meshes");
 	draw_stat(&rect, 0, v, stat_string, sizeof(stat_string));
@@ -3100,6 +3493,94 @@ static void DRW_debug_gpu_stats(void)
 }
 
 
+/* -------------------------------------------------------------------- */
+
+/** \name Temporal Anti-Aliasing
+ *
+ * While the view is static, every redraw jitters the projection by a sub-pixel offset
+ * and averages the result with the previous ones in the viewport history buffer,
+ * until #UserDef.viewport_aa_samples samples are accumulated.
+ * \{ */
+
+#define TAA_MAX_SAMPLES 32
+
+static void drw_taa_view_jitter(void)
+{
+	static float jit_ofs[TAA_MAX_SAMPLES][2];
+	static int jit_len = 0;
+	RegionView3D *rv3d = DST.draw_ctx.rv3d;
+	const int samples_len = min_ii(U.viewport_aa_samples, TAA_MAX_SAMPLES);
+
+	DST.taa_sample = -1;
+
+	if ((samples_len < 2) || DST.options.is_image_render || (rv3d->rflag & RV3D_NAVIGATING)) {
+		GPU_viewport_history_reset(DST.viewport);
+		return;
+	}
+
+	int sample = GPU_viewport_history_samples_get(DST.viewport, rv3d->persmat);
+
+	/* Accumulation is done, something else requested this redraw: start over. */
+	if (sample >= samples_len) {
+		GPU_viewport_history_reset(DST.viewport);
+		sample = 0;
+	}
+
+	DST.taa_sample = sample;
+
+	/* First sample is not jittered so a single redraw looks like without accumulation. */
+	if (sample == 0) {
+		return;
+	}
+
+	if (jit_len != samples_len) {
+		BLI_jitter_init(jit_ofs, samples_len);
+		jit_len = samples_len;
+	}
+
+	copy_m4_m4(DST.taa_winmat, rv3d->winmat);
+	copy_m4_m4(DST.taa_persmat, rv3d->persmat);
+	copy_m4_m4(DST.taa_persinv, rv3d->persinv);
+
+	window_translate_m4(
+	        rv3d->winmat, rv3d->persmat,
+	        (jit_ofs[sample][0] * 2.0f) / DST.size[0],
+	        (jit_ofs[sample][1] * 2.0f) / DST.size[1]);
+	mul_m4_m4m4(rv3d->persmat, rv3d->winmat, rv3d->viewmat);
+	invert_m4_m4(rv3d->persinv, rv3d->persmat);
+
+	DST.taa_jittered = true;
+}
+
+static void drw_taa_accumulate(void)
+{
+	RegionView3D *rv3d = DST.draw_ctx.rv3d;
+
+	if (DST.taa_jittered) {
+		copy_m4_m4(rv3d->winmat, DST.taa_winmat);
+		copy_m4_m4(rv3d->persmat, DST.taa_persmat);
+		copy_m4_m4(rv3d->persinv, DST.taa_persinv);
+		DST.taa_jittered = false;
+	}
+
+	if (DST.taa_sample == -1) {
+		return;
+	}
+
+	if (DST.taa_reset) {
+		GPU_viewport_history_reset(DST.viewport);
+	}
+
+	GPU_viewport_history_accumulate(DST.viewport);
+
+	if (GPU_viewport_history_samples_get(DST.viewport, rv3d->persmat) < U.viewport_aa_samples) {
+		DRW_viewport_request_redraw();
+	}
+}
+
+/** \} */
+
+
 /* -------------------------------------------------------------------- */
 
 /** \name Main Draw Loops (DRW_draw)
@@ -3116,7 +3597,11 @@ void DRW_draw_view(const bContext *C)
 
 	/* Reset before using it. */
 	memset(&DST, 0x0, sizeof(DST));
+
+	/* Don't wait for images to load while navigating the viewport. */
+	GPU_set_image_async_load(true);
 	DRW_draw_render_loop_ex(graph, ar, v3d, C);
+	GPU_set_image_async_load(false);
 }
 
 /**
@@ -3149,6 +3634,8 @@ void DRW_draw_render_loop_ex(
 
 	DRW_viewport_var_init();
 
+	drw_taa_view_jitter();
+
 	/* Get list of enabled engines */
 	DRW_engines_enable(scene, sl);
 
@@ -3162,10 +3649,18 @@ void DRW_draw_render_loop_ex(
 	/* ideally only refresh when objects are added/removed */
 	/* or render properties / materials change */
 	if (cache_is_dirty) {
+		/* Before the shading groups reference image textures. */
+		if (!DST.options.is_image_render) {
+			GPU_free_images_over_limit();
+		}
+
 		DRW_engines_cache_init();
 
 		DEG_OBJECT_ITER(graph, ob, DEG_OBJECT_ITER_FLAG_ALL);
 		{
+			if (ob->deg_update_flag != 0) {
+				DST.taa_reset = true;
+			}
 			DRW_engines_cache_populate(ob);
 			/* XXX find a better place for this. maybe Depsgraph? */
 			ob->deg_update_flag = 0;
@@ -3195,6 +3690,16 @@ void DRW_draw_render_loop_ex(
 
 	DRW_state_reset();
 
+	/* Text and manipulators are drawn at full quality, after accumulation. */
+	drw_taa_accumulate();
+
+	/* The depth buffer now holds the whole scene, let the depth loop reuse it. */
+	GPU_viewport_depth_tag(
+	        DST.viewport,
+	        (!DST.options.is_image_render && scene->obedit == NULL) ? rv3d->persmat : NULL);
+
+	DRW_state_reset();
+
 	DRW_engines_draw_text();
 
 	if (DST.draw_ctx.evil_C) {
@@ -3240,8 +3745,9 @@ void DRW_draw_render_loop_offscreen(
 	/* backup */
 	void *backup_viewport = rv3d->viewport;
 	{
-		/* backup (_never_ use rv3d->viewport) */
-		rv3d->viewport = GPU_viewport_create_from_offscreen(ofs);
+		/* backup (_never_ use rv3d->viewport)
+		 * The offscreen owns its viewport so engines data survives between renders. */
+		rv3d->viewport = GPU_offscreen_viewport_ensure(ofs);
 	}
 
 	/* Reset before using it. */
@@ -3250,14 +3756,7 @@ void DRW_draw_render_loop_offscreen(
 	DRW_draw_render_loop_ex(graph, ar, v3d, NULL);
 
 	/* restore */
-	{
-		/* don't free data owned by 'ofs' */
-		GPU_viewport_clear_from_offscreen(rv3d->viewport);
-		GPU_viewport_free(rv3d->viewport);
-		MEM_freeN(rv3d->viewport);
-
-		rv3d->viewport = backup_viewport;
-	}
+	rv3d->viewport = backup_viewport;
 
 	/* we need to re-bind (annoying!) */
 	GPU_offscreen_bind(ofs, false);
@@ -3382,6 +3881,36 @@ void DRW_draw_select_loop(
 #endif  /* USE_GPU_SELECT */
 }
 
+/**
+ * Copy the depth of the last redraw instead of drawing the scene again,
+ * only valid when nothing changed since, see #GPU_viewport_depth_tag.
+ */
+static bool drw_draw_depth_from_viewport(Depsgraph *graph, ARegion *ar, GPUViewport *viewport)
+{
+	Scene *scene = DEG_get_evaluated_scene(graph);
+	RegionView3D *rv3d = ar->regiondata;
+	bool is_dirty = false;
+
+	if (viewport == NULL || scene->obedit != NULL) {
+		return false;
+	}
+
+	/* Objects evaluated since the last redraw are not in the depth buffer yet. */
+	DEG_OBJECT_ITER(graph, ob, DEG_OBJECT_ITER_FLAG_ALL)
+	{
+		if (ob->deg_update_flag != 0) {
+			is_dirty = true;
+		}
+	}
+	DEG_OBJECT_ITER_END
+
+	if (is_dirty) {
+		return false;
+	}
+
+	return GPU_viewport_depth_draw(viewport, rv3d->persmat, (const int[2]){ar->winx, ar->winy});
+}
+
 /**
  * object mode select-loop, see: ED_view3d_draw_depth_loop (legacy drawing).
  */
@@ -3393,6 +3922,10 @@ void DRW_draw_depth_loop(
 	SceneLayer *sl = DEG_get_evaluated_scene_layer(graph);
 	RegionView3D *rv3d = ar->regiondata;
 
+	if (drw_draw_depth_from_viewport(graph, ar, rv3d->viewport)) {
+		return;
+	}
+
 	/* backup (_never_ use rv3d->viewport) */
 	void *backup_viewport = rv3d->viewport;
 	rv3d->viewport = NULL;
@@ -23,6 +23,8 @@
  *  \ingroup draw
  */
 
+#include <string.h>
+
 #include "BLI_rect.h"
 #include "BLI_string.h"
 
@@ -30,19 +32,27 @@
 
 #include "BLF_api.h"
 
+#include "DNA_object_types.h"
+
 #include "MEM_guardedalloc.h"
 
 #include "GPU_glew.h"
 
+#include "RNA_access.h"
+#include "RNA_enum_types.h"
+
 #include "WM_api.h"
 #include "WM_types.h"
 
+#include "DRW_engine.h"
+
 #include "draw_manager_profiling.h"
 
 #define MAX_TIMER_NAME 32
 #define MAX_NESTED_TIMER 8
 #define CHUNK_SIZE 8
 #define GPU_TIMER_FALLOFF 0.1
+#define MAX_OB_TYPE (OB_ARMATURE + 1)
 
 typedef struct DRWTimer {
 	GLuint query[2];
@@ -60,6 +70,9 @@ static struct DRWTimerPool {
 	int end_increment;        /* Keep track of bad usage. */
 	bool is_recording;        /* Are we in the render loop? */
 	bool is_querying;         /* Keep track of bad usage. */
+	bool is_enabled;          /* Record without the debug overlay, see DRW_stats_enable. */
+	double cache_time[MAX_OB_TYPE];        /* CPU time (ms) of the last cache populate per object type. */
+	double cache_time_accum[MAX_OB_TYPE];  /* Current frame, moved to cache_time by DRW_stats_reset. */
 } DTP = {NULL};
 
 void DRW_stats_free(void)
@@ -76,7 +89,7 @@ void DRW_stats_free(void)
 
 void DRW_stats_begin(void)
 {
-	if (G.debug_value > 20) {
+	if (G.debug_value > 20 || DTP.is_enabled) {
 		DTP.is_recording = true;
 	}
 
@@ -175,16 +188,20 @@ void DRW_stats_reset(void)
 			BLI_assert(timer->lvl < MAX_NESTED_TIMER);
 
 			if (timer->is_query) {
-				GLuint64 time;
+				GLuint64 time = 1000000; /* 1ms default */
+				GLint available = 0;
+
+				/* Don't stall on the result, keep the previous average if the GPU is late. */
 				if (timer->query[0] != 0) {
+					glGetQueryObjectiv(timer->query[0], GL_QUERY_RESULT_AVAILABLE, &available);
+				}
+				if (available) {
 					glGetQueryObjectui64v(timer->query[0], GL_QUERY_RESULT, &time);
 				}
-				else {
-					time = 1000000000; /* 1ms default */
+				if (available || timer->query[0] == 0) {
+					timer->time_average = timer->time_average * (1.0 - GPU_TIMER_FALLOFF) + time * GPU_TIMER_FALLOFF;
+					timer->time_average = MIN2(timer->time_average, 1000000000);
 				}
-
-				timer->time_average = timer->time_average * (1.0 - GPU_TIMER_FALLOFF) + time * GPU_TIMER_FALLOFF;
-				timer->time_average = MIN2(timer->time_average, 1000000000);
 			}
 			else {
 				timer->time_average = lvl_time[timer->lvl + 1];
@@ -194,10 +211,70 @@ void DRW_stats_reset(void)
 			lvl_time[timer->lvl] += timer->time_average;
 		}
 
+		memcpy(DTP.cache_time, DTP.cache_time_accum, sizeof(DTP.cache_time));
+		memset(DTP.cache_time_accum, 0, sizeof(DTP.cache_time_accum));
+
 		DTP.is_recording = false;
 	}
 }
 
+/* CPU time spent populating the engines caches with an object of \a ob_type. */
+void DRW_stats_cache_time_add(int ob_type, double time_ms)
+{
+	if (ob_type >= 0 && ob_type < MAX_OB_TYPE) {
+		DTP.cache_time_accum[ob_type] += time_ms;
+	}
+}
+
+/* -------------------------------------------------------------------- */
+
+/** \name Public API (Python access)
+ * \{ */
+
+/**
+ * Record the timings of every redraw, not only with the debug overlay (debug value > 20).
+ */
+void DRW_stats_enable(bool enable)
+{
+	DTP.is_enabled = enable;
+}
+
+bool DRW_stats_is_enabled(void)
+{
+	return DTP.is_enabled;
+}
+
+/**
+ * Number of GPU timers recorded by the last redraw.
+ */
+int DRW_stats_timer_len(void)
+{
+	return (DTP.timers != NULL) ? DTP.timer_increment : 0;
+}
+
+/**
+ * GPU timer \a index of the last redraw, passes are nested in their engine (level 1).
+ */
+void DRW_stats_timer_get(int index, const char **r_name, int *r_lvl, double *r_time_ms)
+{
+	BLI_assert(index < DRW_stats_timer_len());
+	const DRWTimer *timer = &DTP.timers[index];
+
+	*r_name = timer->name;
+	*r_lvl = timer->lvl;
+	*r_time_ms = timer->time_average / 1000000.0;
+}
+
+/**
+ * CPU time (ms) the last redraw spent populating caches with objects of \a ob_type.
+ */
+double DRW_stats_cache_time_get(int ob_type)
+{
+	return (ob_type >= 0 && ob_type < MAX_OB_TYPE) ? DTP.cache_time[ob_type] : 0.0;
+}
+
+/** \} */
+
 void DRW_stats_draw(rcti *rect)
 {
 	char stat_string[64];
@@ -239,4 +316,22 @@ void DRW_stats_draw(rcti *rect)
 		BLF_draw_default_ascii(rect->xmin + (6 + timer->lvl) * U.widget_unit, rect->ymax - v * U.widget_unit, 0.0f, stat_string, sizeof(stat_string));
 		v++;
 	}
+	v++;
+
+	BLI_snprintf(stat_string, sizeof(stat_string), "CPU Cache Populate");
+	BLF_draw_default_ascii(rect->xmin + 1 * U.widget_unit, rect->ymax - v++ * U.widget_unit, 0.0f, stat_string, sizeof(stat_string));
+
+	for (int ob_type = 0; ob_type < MAX_OB_TYPE; ob_type++) {
+		const char *name;
+
+		if (DTP.cache_time[ob_type] == 0.0 || !RNA_enum_name(rna_enum_object_type_items, ob_type, &name)) {
+			continue;
+		}
+
+		BLI_snprintf(stat_string, sizeof(stat_string), "%.2fms", MIN2(DTP.cache_time[ob_type], 999.0));
+		BLF_draw_default_ascii(rect->xmin + 1 * U.widget_unit, rect->ymax - v * U.widget_unit, 0.0f, stat_string, sizeof(stat_string));
+		BLI_snprintf(stat_string, sizeof(stat_string), "%s", name);
+		BLF_draw_default_ascii(rect->xmin + 6 * U.widget_unit, rect->ymax - v * U.widget_unit, 0.0f, stat_string, sizeof(stat_string));
+		v++;
+	}
 }
\ No newline at end of file
@@ -38,6 +38,8 @@ void DRW_stats_group_end(void);
 void DRW_stats_query_start(const char *name);
 void DRW_stats_query_end(void);
 
+void DRW_stats_cache_time_add(int ob_type, double time_ms);
+
 void DRW_stats_draw(rcti *rect);
 
 #endif /* __DRAW_MANAGER_PROFILING_H__ */
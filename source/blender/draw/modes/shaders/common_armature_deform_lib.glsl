@@ -0,0 +1,38 @@
+
+/* Linear blend skinning, keep in sync with 'DRW_object_armature_deform_matrices_calc'. */
+
+/* Keep in sync with DRW_DEFORM_GROUP_MAX. */
+#ifndef DEFORM_GROUP_MAX
+#define DEFORM_GROUP_MAX 32
+#endif
+
+/* One 4x4 matrix (as 4 columns) per vertex group. */
+uniform vec4 deformMatrices[DEFORM_GROUP_MAX * 4];
+
+in ivec4 deformGroups;
+in vec4 deformWeights;
+
+mat4 deform_matrix_get(int group)
+{
+	return mat4(deformMatrices[group * 4 + 0],
+	            deformMatrices[group * 4 + 1],
+	            deformMatrices[group * 4 + 2],
+	            deformMatrices[group * 4 + 3]);
+}
+
+void armature_deform(inout vec3 co, inout vec3 no)
+{
+	mat4 mat = deform_matrix_get(deformGroups.x) * deformWeights.x +
+	           deform_matrix_get(deformGroups.y) * deformWeights.y +
+	           deform_matrix_get(deformGroups.z) * deformWeights.z +
+	           deform_matrix_get(deformGroups.w) * deformWeights.w;
+
+	/* Groups without a deforming bone have a zero matrix,
+	 * so this is the total weight of deforming bones. */
+	float contrib = mat[3][3];
+
+	if (contrib > 0.0001) {
+		co = (mat * vec4(co, 1.0)).xyz / contrib;
+		no = mat3(mat) * no;
+	}
+}
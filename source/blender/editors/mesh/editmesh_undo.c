@@ -116,11 +116,138 @@ static struct {
 
 } um_arraystore = {{NULL}};
 
+/**
+ * A single array to add to (or expand from) the store.
+ *
+ * Arrays are collected first, so arrays using different stores can be handled in parallel,
+ * each #BArrayStore is only ever accessed from one thread at a time.
+ */
+typedef struct UMArrayStoreLayer {
+	BArrayStore *bs;
+	void **data_p;
+	size_t data_len;
+	const BArrayState *state_reference;
+	BArrayState **state_p;
+} UMArrayStoreLayer;
+
+typedef struct UMArrayStoreLayers {
+	UMArrayStoreLayer *layers;
+	int layers_len;
+
+	/* unique stores used by 'layers', only for compacting */
+	BArrayStore **stores;
+	int stores_len;
+} UMArrayStoreLayers;
+
+static void um_arraystore_layers_init(UMArrayStoreLayers *data, const Mesh *me)
+{
+	const int layers_max =
+	        me->vdata.totlayer + me->edata.totlayer + me->ldata.totlayer + me->pdata.totlayer +
+	        (me->key ? me->key->totkey : 0) + 1;
+
+	data->layers = MEM_mallocN(sizeof(*data->layers) * (size_t)layers_max, __func__);
+	data->layers_len = 0;
+	data->stores = NULL;
+	data->stores_len = 0;
+}
+
+static void um_arraystore_layers_append(
+        UMArrayStoreLayers *data, BArrayStore *bs,
+        void **data_p, const size_t data_len,
+        const BArrayState *state_reference, BArrayState **state_p)
+{
+	UMArrayStoreLayer *layer = &data->layers[data->layers_len++];
+	layer->bs = bs;
+	layer->data_p = data_p;
+	layer->data_len = data_len;
+	layer->state_reference = state_reference;
+	layer->state_p = state_p;
+}
+
+static void um_arraystore_layers_free(UMArrayStoreLayers *data)
+{
+	MEM_freeN(data->layers);
+	MEM_SAFE_FREE(data->stores);
+}
+
+static void um_arraystore_compact_store_cb(void *userdata, const int index)
+{
+	UMArrayStoreLayers *data = userdata;
+	BArrayStore *bs = data->stores[index];
+
+	for (int i = 0; i < data->layers_len; i++) {
+		UMArrayStoreLayer *layer = &data->layers[i];
+		if (layer->bs == bs) {
+			*layer->state_p = BLI_array_store_state_add(
+			        bs, *layer->data_p, layer->data_len, layer->state_reference);
+			if (*layer->data_p) {
+				MEM_freeN(*layer->data_p);
+				*layer->data_p = NULL;
+			}
+		}
+	}
+}
+
+static void um_arraystore_layers_compact(UMArrayStoreLayers *data)
+{
+	data->stores = MEM_mallocN(sizeof(*data->stores) * (size_t)MAX2(data->layers_len, 1), __func__);
+	for (int i = 0; i < data->layers_len; i++) {
+		BArrayStore *bs = data->layers[i].bs;
+		int j;
+		for (j = 0; j < data->stores_len; j++) {
+			if (data->stores[j] == bs) {
+				break;
+			}
+		}
+		if (j == data->stores_len) {
+			data->stores[data->stores_len++] = bs;
+		}
+	}
+
+#ifdef USE_ARRAY_STORE_THREAD
+	BLI_task_parallel_range(
+	        0, data->stores_len, data, um_arraystore_compact_store_cb,
+	        data->stores_len > 1);
+#else
+	for (int i = 0; i < data->stores_len; i++) {
+		um_arraystore_compact_store_cb(data, i);
+	}
+#endif
+}
+
+static void um_arraystore_expand_layer_cb(void *userdata, const int index)
+{
+	UMArrayStoreLayers *data = userdata;
+	UMArrayStoreLayer *layer = &data->layers[index];
+	size_t state_len;
+
+	*layer->data_p = BLI_array_store_state_data_get_alloc(*layer->state_p, &state_len);
+	BLI_assert(layer->data_len == state_len);
+}
+
+static void um_arraystore_layers_expand(UMArrayStoreLayers *data)
+{
+#ifdef USE_ARRAY_STORE_THREAD
+	BLI_task_parallel_range(
+	        0, data->layers_len, data, um_arraystore_expand_layer_cb,
+	        data->layers_len > 1);
+#else
+	for (int i = 0; i < data->layers_len; i++) {
+		um_arraystore_expand_layer_cb(data, i);
+	}
+#endif
+}
+
+/**
+ * \param data: When creating, the layers to add to the store are appended here
+ * (their data is freed once they have been added).
+ */
 static void um_arraystore_cd_compact(
         struct CustomData *cdata, const size_t data_len,
         bool create,
         const BArrayCustomData *bcd_reference,
-        BArrayCustomData **r_bcd_first)
+        BArrayCustomData **r_bcd_first,
+        UMArrayStoreLayers *data)
 {
 	if (data_len == 0) {
 		if (create) {
@@ -188,15 +315,15 @@ static void um_arraystore_cd_compact(
 					BArrayState *state_reference =
 					        (bcd_reference_current && i < bcd_reference_current->states_len) ?
 					         bcd_reference_current->states[i] : NULL;
-					bcd->states[i] = BLI_array_store_state_add(
-					        bs, layer->data, (size_t)data_len * stride, state_reference);
+					um_arraystore_layers_append(
+					        data, bs, &layer->data, (size_t)data_len * stride,
+					        state_reference, &bcd->states[i]);
 				}
 				else {
 					bcd->states[i] = NULL;
 				}
 			}
-
-			if (layer->data) {
+			else if (layer->data) {
 				MEM_freeN(layer->data);
 				layer->data = NULL;
 			}
@@ -219,7 +346,8 @@ static void um_arraystore_cd_compact(
  * The layers and the states are stored together so this can be kept working.
  */
 static void um_arraystore_cd_expand(
-        const BArrayCustomData *bcd, struct CustomData *cdata, const size_t data_len)
+        BArrayCustomData *bcd, struct CustomData *cdata, const size_t data_len,
+        UMArrayStoreLayers *data)
 {
 	CustomDataLayer *layer = cdata->layers;
 	while (bcd) {
@@ -227,10 +355,9 @@ static void um_arraystore_cd_expand(
 		for (int i = 0; i < bcd->states_len; i++) {
 			BLI_assert(bcd->type == layer->type);
 			if (bcd->states[i]) {
-				size_t state_len;
-				layer->data = BLI_array_store_state_data_get_alloc(bcd->states[i], &state_len);
-				BLI_assert(stride * data_len == state_len);
-				UNUSED_VARS_NDEBUG(stride, data_len);
+				um_arraystore_layers_append(
+				        data, NULL, &layer->data, (size_t)data_len * stride,
+				        NULL, &bcd->states[i]);
 			}
 			else {
 				layer->data = NULL;
@@ -267,11 +394,14 @@ static void um_arraystore_compact_ex(
         bool create)
 {
 	Mesh *me = &um->me;
+	UMArrayStoreLayers data;
 
-	um_arraystore_cd_compact(&me->vdata, me->totvert, create, um_ref ? um_ref->store.vdata : NULL, &um->store.vdata);
-	um_arraystore_cd_compact(&me->edata, me->totedge, create, um_ref ? um_ref->store.edata : NULL, &um->store.edata);
-	um_arraystore_cd_compact(&me->ldata, me->totloop, create, um_ref ? um_ref->store.ldata : NULL, &um->store.ldata);
-	um_arraystore_cd_compact(&me->pdata, me->totpoly, create, um_ref ? um_ref->store.pdata : NULL, &um->store.pdata);
+	um_arraystore_layers_init(&data, me);
+
+	um_arraystore_cd_compact(&me->vdata, me->totvert, create, um_ref ? um_ref->store.vdata : NULL, &um->store.vdata, &data);
+	um_arraystore_cd_compact(&me->edata, me->totedge, create, um_ref ? um_ref->store.edata : NULL, &um->store.edata, &data);
+	um_arraystore_cd_compact(&me->ldata, me->totloop, create, um_ref ? um_ref->store.ldata : NULL, &um->store.ldata, &data);
+	um_arraystore_cd_compact(&me->pdata, me->totpoly, create, um_ref ? um_ref->store.pdata : NULL, &um->store.pdata, &data);
 
 	if (me->key && me->key->totkey) {
 		const size_t stride = me->key->elemsize;
@@ -285,12 +415,11 @@ static void um_arraystore_compact_ex(
 				BArrayState *state_reference =
 				        (um_ref && um_ref->me.key && (i < um_ref->me.key->totkey)) ?
 				         um_ref->store.keyblocks[i] : NULL;
-				um->store.keyblocks[i] = BLI_array_store_state_add(
-				        bs, keyblock->data, (size_t)keyblock->totelem * stride,
-				        state_reference);
+				um_arraystore_layers_append(
+				        &data, bs, &keyblock->data, (size_t)keyblock->totelem * stride,
+				        state_reference, &um->store.keyblocks[i]);
 			}
-
-			if (keyblock->data) {
+			else if (keyblock->data) {
 				MEM_freeN(keyblock->data);
 				keyblock->data = NULL;
 			}
@@ -303,19 +432,24 @@ static void um_arraystore_compact_ex(
 			BArrayState *state_reference = um_ref ? um_ref->store.mselect : NULL;
 			const size_t stride = sizeof(*me->mselect);
 			BArrayStore *bs = BLI_array_store_at_size_ensure(&um_arraystore.bs_stride, stride, ARRAY_CHUNK_SIZE);
-			um->store.mselect = BLI_array_store_state_add(
-			        bs, me->mselect, (size_t)me->totselect * stride, state_reference);
+			um_arraystore_layers_append(
+			        &data, bs, (void **)&me->mselect, (size_t)me->totselect * stride,
+			        state_reference, &um->store.mselect);
+		}
+		else {
+			MEM_freeN(me->mselect);
+			me->mselect = NULL;
 		}
-
 		/* keep me->totselect for validation */
-		MEM_freeN(me->mselect);
-		me->mselect = NULL;
 	}
 
 	if (create) {
+		um_arraystore_layers_compact(&data);
 		um_arraystore.users += 1;
 	}
 
+	um_arraystore_layers_free(&data);
+
 	BKE_mesh_update_customdata_pointers(me, false);
 }
 
@@ -390,33 +524,36 @@ static void um_arraystore_expand_clear(UndoMesh *um)
 static void um_arraystore_expand(UndoMesh *um)
 {
 	Mesh *me = &um->me;
+	UMArrayStoreLayers data;
+
+	um_arraystore_layers_init(&data, me);
 
-	um_arraystore_cd_expand(um->store.vdata, &me->vdata, me->totvert);
-	um_arraystore_cd_expand(um->store.edata, &me->edata, me->totedge);
-	um_arraystore_cd_expand(um->store.ldata, &me->ldata, me->totloop);
-	um_arraystore_cd_expand(um->store.pdata, &me->pdata, me->totpoly);
+	um_arraystore_cd_expand(um->store.vdata, &me->vdata, me->totvert, &data);
+	um_arraystore_cd_expand(um->store.edata, &me->edata, me->totedge, &data);
+	um_arraystore_cd_expand(um->store.ldata, &me->ldata, me->totloop, &data);
+	um_arraystore_cd_expand(um->store.pdata, &me->pdata, me->totpoly, &data);
 
 	if (um->store.keyblocks) {
 		const size_t stride = me->key->elemsize;
 		KeyBlock *keyblock = me->key->block.first;
 		for (int i = 0; i < me->key->totkey; i++, keyblock = keyblock->next) {
-			BArrayState *state = um->store.keyblocks[i];
-			size_t state_len;
-			keyblock->data = BLI_array_store_state_data_get_alloc(state, &state_len);
-			BLI_assert(keyblock->totelem == (state_len / stride));
-			UNUSED_VARS_NDEBUG(stride);
+			um_arraystore_layers_append(
+			        &data, NULL, &keyblock->data, (size_t)keyblock->totelem * stride,
+			        NULL, &um->store.keyblocks[i]);
 		}
 	}
 
 	if (um->store.mselect) {
 		const size_t stride = sizeof(*me->mselect);
-		BArrayState *state = um->store.mselect;
-		size_t state_len;
-		me->mselect = BLI_array_store_state_data_get_alloc(state, &state_len);
-		BLI_assert(me->totselect == (state_len / stride));
-		UNUSED_VARS_NDEBUG(stride);
+		um_arraystore_layers_append(
+		        &data, NULL, (void **)&me->mselect, (size_t)me->totselect * stride,
+		        NULL, &um->store.mselect);
 	}
 
+	/* decompress all arrays at once, the states are only read from */
+	um_arraystore_layers_expand(&data);
+	um_arraystore_layers_free(&data);
+
 	/* not essential, but prevents accidental dangling pointer access */
 	BKE_mesh_update_customdata_pointers(me, false);
 }
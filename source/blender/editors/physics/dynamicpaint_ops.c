@@ -30,6 +30,7 @@
 
 #include "BLI_blenlib.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BLT_translation.h"
@@ -342,7 +343,7 @@ static void dpaint_bake_endjob(void *customdata)
  * Do actual bake operation. Loop through to-be-baked frames.
  * Returns 0 on failure.
  */
-static void dynamicPaint_bakeImageSequence(DynamicPaintBakeJob *job)
+static void dynamicPaint_bakeImageSequence_frames(DynamicPaintBakeJob *job, TaskPool *save_pool)
 {
 	DynamicPaintSurface *surface = job->surface;
 	Object *cObject = job->ob;
@@ -396,6 +397,10 @@ static void dynamicPaint_bakeImageSequence(DynamicPaintBakeJob *job)
 			return;
 		}
 
+		/* images of the previous frame were written while calculating this one,
+		 * wait for them to keep the memory of at most one frame in flight */
+		BLI_task_pool_work_and_wait(save_pool);
+
 		/*
 		 * Save output images
 		 */
@@ -409,7 +414,7 @@ static void dynamicPaint_bakeImageSequence(DynamicPaintBakeJob *job)
 				BLI_path_frame(filename, frame, 4);
 
 				/* save image */
-				dynamicPaint_outputSurfaceImage(surface, filename, 0);
+				dynamicPaint_outputSurfaceImage(surface, filename, 0, save_pool);
 			}
 			/* secondary output */
 			if (surface->flags & MOD_DPAINT_OUT2 && surface->type == MOD_DPAINT_SURFACE_T_PAINT) {
@@ -418,7 +423,7 @@ static void dynamicPaint_bakeImageSequence(DynamicPaintBakeJob *job)
 				BLI_path_frame(filename, frame, 4);
 
 				/* save image */
-				dynamicPaint_outputSurfaceImage(surface, filename, 1);
+				dynamicPaint_outputSurfaceImage(surface, filename, 1, save_pool);
 			}
 		}
 	}
@@ -426,6 +431,17 @@ static void dynamicPaint_bakeImageSequence(DynamicPaintBakeJob *job)
 	scene->r.cfra = orig_frame;
 }
 
+static void dynamicPaint_bakeImageSequence(DynamicPaintBakeJob *job)
+{
+	TaskPool *save_pool = BLI_task_pool_create(BLI_task_scheduler_get(), NULL);
+
+	dynamicPaint_bakeImageSequence_frames(job, save_pool);
+
+	/* finish writing images, also when baking was stopped */
+	BLI_task_pool_work_and_wait(save_pool);
+	BLI_task_pool_free(save_pool);
+}
+
 static void dpaint_bake_startjob(void *customdata, short *stop, short *do_update, float *progress)
 {
 	DynamicPaintBakeJob *job = customdata;
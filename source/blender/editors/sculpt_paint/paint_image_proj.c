@@ -36,6 +36,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 #ifdef WIN32
 #  include "BLI_winstuff.h"
 #endif
@@ -316,7 +318,7 @@ typedef struct ProjPaintState {
 	int thread_tot;
 	int bucketMin[2];
 	int bucketMax[2];
-	int context_bucket_x, context_bucket_y; /* must lock threads while accessing these */
+	unsigned int context_bucket_index; /* offset of the next bucket within the brush bounds, only access atomically */
 
 	struct CurveMapping *cavity_curve;
 	BlurKernel *blurkernel;
@@ -4062,6 +4064,7 @@ static bool partial_redraw_array_merge(ImagePaintPartialRedraw *pr, ImagePaintPa
 static bool project_image_refresh_tagged(ProjPaintState *ps)
 {
 	ImagePaintPartialRedraw *pr;
+	ImagePaintPartialRedraw pr_image;
 	ProjPaintImage *projIma;
 	int a, i;
 	bool redraw = false;
@@ -4069,18 +4072,26 @@ static bool project_image_refresh_tagged(ProjPaintState *ps)
 
 	for (a = 0, projIma = ps->projImages; a < ps->image_tot; a++, projIma++) {
 		if (projIma->touch) {
+			/* Merge the bound cells into a single region, updating the GPU texture
+			 * for every cell would upload and regenerate mipmaps many times per step. */
+			partial_redraw_single_init(&pr_image);
+
 			/* look over each bound cell */
 			for (i = 0; i < PROJ_BOUNDBOX_SQUARED; i++) {
 				pr = &(projIma->partRedrawRect[i]);
 				if (pr->x2 != -1) { /* TODO - use 'enabled' ? */
-					set_imapaintpartial(pr);
-					imapaint_image_update(NULL, projIma->ima, projIma->ibuf, true);
-					redraw = 1;
+					partial_redraw_array_merge(&pr_image, pr, 1);
 				}
 
 				partial_redraw_single_init(pr);
 			}
 
+			if (pr_image.x2 != -1) {
+				set_imapaintpartial(&pr_image);
+				imapaint_image_update(NULL, projIma->ima, projIma->ibuf, true);
+				redraw = 1;
+			}
+
 			projIma->touch = 0; /* clear for reuse */
 		}
 	}
@@ -4112,8 +4123,7 @@ static bool project_bucket_iter_init(ProjPaintState *ps, const float mval_f[2])
 			return 0;
 		}
 
-		ps->context_bucket_x = ps->bucketMin[0];
-		ps->context_bucket_y = ps->bucketMin[1];
+		ps->context_bucket_index = 0;
 	}
 	else { /* reproject: PROJ_SRC_* */
 		ps->bucketMin[0] = 0;
@@ -4122,8 +4132,7 @@ static bool project_bucket_iter_init(ProjPaintState *ps, const float mval_f[2])
 		ps->bucketMax[0] = ps->buckets_x;
 		ps->bucketMax[1] = ps->buckets_y;
 
-		ps->context_bucket_x = 0;
-		ps->context_bucket_y = 0;
+		ps->context_bucket_index = 0;
 	}
 	return 1;
 }
@@ -4134,35 +4143,27 @@ static bool project_bucket_iter_next(
         rctf *bucket_bounds, const float mval[2])
 {
 	const int diameter = 2 * ps->brush_size;
+	const int bucket_range_x = ps->bucketMax[0] - ps->bucketMin[0];
+	const int bucket_range_tot = bucket_range_x * (ps->bucketMax[1] - ps->bucketMin[1]);
+	int i;
 
-	if (ps->thread_tot > 1)
-		BLI_lock_thread(LOCK_CUSTOM1);
-
-	//printf("%d %d\n", ps->context_bucket_x, ps->context_bucket_y);
-
-	for (; ps->context_bucket_y < ps->bucketMax[1]; ps->context_bucket_y++) {
-		for (; ps->context_bucket_x < ps->bucketMax[0]; ps->context_bucket_x++) {
-
-			/* use bucket_bounds for project_bucket_isect_circle and project_bucket_init*/
-			project_bucket_bounds(ps, ps->context_bucket_x, ps->context_bucket_y, bucket_bounds);
-
-			if ((ps->source != PROJ_SRC_VIEW) ||
-			    project_bucket_isect_circle(mval, (float)(diameter * diameter), bucket_bounds))
-			{
-				*bucket_index = ps->context_bucket_x + (ps->context_bucket_y * ps->buckets_x);
-				ps->context_bucket_x++;
+	/* each thread claims the next bucket with an atomic increment,
+	 * so threads don't serialize on a lock for every bucket */
+	while ((i = (int)atomic_fetch_and_add_u(&ps->context_bucket_index, 1)) < bucket_range_tot) {
+		const int bucket_x = ps->bucketMin[0] + (i % bucket_range_x);
+		const int bucket_y = ps->bucketMin[1] + (i / bucket_range_x);
 
-				if (ps->thread_tot > 1)
-					BLI_unlock_thread(LOCK_CUSTOM1);
+		/* use bucket_bounds for project_bucket_isect_circle and project_bucket_init*/
+		project_bucket_bounds(ps, bucket_x, bucket_y, bucket_bounds);
 
-				return 1;
-			}
+		if ((ps->source != PROJ_SRC_VIEW) ||
+		    project_bucket_isect_circle(mval, (float)(diameter * diameter), bucket_bounds))
+		{
+			*bucket_index = bucket_x + (bucket_y * ps->buckets_x);
+			return 1;
 		}
-		ps->context_bucket_x = ps->bucketMin[0];
 	}
 
-	if (ps->thread_tot > 1)
-		BLI_unlock_thread(LOCK_CUSTOM1);
 	return 0;
 }
 
@@ -814,10 +814,17 @@ static unsigned int vpaint_blend(VPaint *vp, unsigned int col, unsigned int colo
 }
 
 
+static int sample_backbuf_index_cmp(const void *a_, const void *b_)
+{
+	const int a = *(const int *)a_;
+	const int b = *(const int *)b_;
+	return (a > b) - (a < b);
+}
+
 static int sample_backbuf_area(const bContext *C, ViewContext *vc, int *indexar, int totpoly, int x, int y, float size)
 {
 	struct ImBuf *ibuf;
-	int a, tot = 0, index;
+	int tot = 0, index;
 	
 	/* brecht: disabled this because it obviously fails for
 	 * brushes with size > 64, why is this here? */
@@ -826,28 +833,28 @@ static int sample_backbuf_area(const bContext *C, ViewContext *vc, int *indexar,
 	ibuf = ED_view3d_backbuf_read(C, vc, x - size, y - size, x + size, y + size);
 	if (ibuf) {
 		unsigned int *rt = ibuf->rect;
+		/* Gather the indices while reading the buffer, clearing and scanning
+		 * an array of all faces on every step is slow on dense meshes. */
+		BLI_bitmap *index_tag = BLI_BITMAP_NEW(totpoly + 1, __func__);
 
-		memset(indexar, 0, sizeof(int) * (totpoly + 1));
-		
 		size = ibuf->x * ibuf->y;
 		while (size--) {
 				
 			if (*rt) {
 				index = *rt;
-				if (index > 0 && index <= totpoly) {
-					indexar[index] = 1;
+				if (index > 0 && index <= totpoly && !BLI_BITMAP_TEST(index_tag, index)) {
+					BLI_BITMAP_ENABLE(index_tag, index);
+					indexar[tot++] = index;
 				}
 			}
 		
 			rt++;
 		}
-		
-		for (a = 1; a <= totpoly; a++) {
-			if (indexar[a]) {
-				indexar[tot++] = a;
-			}
-		}
 
+		/* keep faces painted in index order */
+		qsort(indexar, tot, sizeof(int), sample_backbuf_index_cmp);
+
+		MEM_freeN(index_tag);
 		IMB_freeImBuf(ibuf);
 	}
 	
@@ -1252,6 +1252,16 @@ static float tex_strength(SculptSession *ss, Brush *br,
 	float rgba[4];
 	float point[3];
 
+	/* Falloff curve, front-face and mask don't depend on the texture,
+	 * skip sampling it for vertices which aren't affected at all. */
+	const float falloff = BKE_brush_curve_strength(br, len, cache->radius);
+	const float front = frontface(br, cache->view_normal, vno, fno);
+	const float mask_fac = 1.0f - mask;
+
+	if ((falloff == 0.0f) || (front == 0.0f) || (mask_fac == 0.0f)) {
+		return 0.0f;
+	}
+
 	sub_v3_v3v3(point, brush_point, cache->plane_offset);
 
 	if (!mtex->tex) {
@@ -1306,12 +1316,12 @@ static float tex_strength(SculptSession *ss, Brush *br,
 	}
 
 	/* Falloff curve */
-	avg *= BKE_brush_curve_strength(br, len, cache->radius);
+	avg *= falloff;
 
-	avg *= frontface(br, cache->view_normal, vno, fno);
+	avg *= front;
 
 	/* Paint mask */
-	avg *= 1.0f - mask;
+	avg *= mask_fac;
 
 	return avg;
 }
@@ -632,7 +632,12 @@ static bool sculpt_undo_cleanup(bContext *C, ListBase *lb)
 	return false;
 }
 
-SculptUndoNode *sculpt_undo_get_node(PBVHNode *node)
+/* PBVHNode -> SculptUndoNode map of the undo step being pushed,
+ * nodes are looked up on every stroke step so searching the list gets slow with many nodes.
+ * Only accessed with LOCK_CUSTOM1 held, since nodes are pushed from multiple threads. */
+static GHash *sculpt_undo_node_map = NULL;
+
+static SculptUndoNode *sculpt_undo_get_node_nolock(PBVHNode *node)
 {
 	ListBase *lb = undo_paint_push_get_list(UNDO_PAINT_MESH);
 
@@ -640,9 +645,24 @@ SculptUndoNode *sculpt_undo_get_node(PBVHNode *node)
 		return NULL;
 	}
 
+	if (node && sculpt_undo_node_map) {
+		return BLI_ghash_lookup(sculpt_undo_node_map, node);
+	}
+
 	return BLI_findptr(lb, node, offsetof(SculptUndoNode, node));
 }
 
+SculptUndoNode *sculpt_undo_get_node(PBVHNode *node)
+{
+	SculptUndoNode *unode;
+
+	BLI_lock_thread(LOCK_CUSTOM1);
+	unode = sculpt_undo_get_node_nolock(node);
+	BLI_unlock_thread(LOCK_CUSTOM1);
+
+	return unode;
+}
+
 static void sculpt_undo_alloc_and_store_hidden(PBVH *pbvh,
                                                SculptUndoNode *unode)
 {
@@ -721,6 +741,10 @@ static SculptUndoNode *sculpt_undo_alloc_node(Object *ob, PBVHNode *node,
 	
 	BLI_addtail(lb, unode);
 
+	if (node && sculpt_undo_node_map) {
+		BLI_ghash_insert(sculpt_undo_node_map, node, unode);
+	}
+
 	if (maxgrid) {
 		/* multires */
 		unode->maxgrid = maxgrid;
@@ -901,7 +925,7 @@ SculptUndoNode *sculpt_undo_push_node(Object *ob, PBVHNode *node,
 		BLI_unlock_thread(LOCK_CUSTOM1);
 		return unode;
 	}
-	else if ((unode = sculpt_undo_get_node(node))) {
+	else if ((unode = sculpt_undo_get_node_nolock(node))) {
 		BLI_unlock_thread(LOCK_CUSTOM1);
 		return unode;
 	}
@@ -950,10 +974,22 @@ SculptUndoNode *sculpt_undo_push_node(Object *ob, PBVHNode *node,
 	return unode;
 }
 
+static void sculpt_undo_node_map_free(void)
+{
+	if (sculpt_undo_node_map) {
+		BLI_ghash_free(sculpt_undo_node_map, NULL, NULL);
+		sculpt_undo_node_map = NULL;
+	}
+}
+
 void sculpt_undo_push_begin(const char *name)
 {
 	ED_undo_paint_push_begin(UNDO_PAINT_MESH, name,
 	                         sculpt_undo_restore, sculpt_undo_free, sculpt_undo_cleanup);
+
+	/* the new step starts out empty */
+	sculpt_undo_node_map_free();
+	sculpt_undo_node_map = BLI_ghash_ptr_new(__func__);
 }
 
 void sculpt_undo_push_end(const bContext *C)
@@ -972,6 +1008,8 @@ void sculpt_undo_push_end(const bContext *C)
 			BKE_pbvh_node_layer_disp_free(unode->node);
 	}
 
+	sculpt_undo_node_map_free();
+
 	ED_undo_paint_push_end(UNDO_PAINT_MESH);
 
 	WM_file_tag_modified(C);
@@ -1128,6 +1128,10 @@ void uiTemplateImageSettings(uiLayout *layout, PointerRNA *imfptr, int color_man
 	if (ELEM(imf->imtype, R_IMF_IMTYPE_OPENEXR, R_IMF_IMTYPE_MULTILAYER)) {
 		uiItemR(col, imfptr, "exr_codec", 0, NULL, ICON_NONE);
 	}
+
+	if (is_render_out && (imf->imtype == R_IMF_IMTYPE_MULTILAYER)) {
+		uiItemR(col, imfptr, "use_exr_multipart", 0, NULL, ICON_NONE);
+	}
 	
 	row = uiLayoutRow(col, false);
 	if (BKE_imtype_supports_zbuf(imf->imtype)) {
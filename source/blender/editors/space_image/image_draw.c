@@ -805,7 +805,14 @@ void draw_image_main(const bContext *C, ARegion *ar)
 			BKE_image_multiview_index(ima, &sima->iuser);
 	}
 
-	ibuf = ED_space_image_acquire_buffer(sima, &lock);
+	/* show the grid until the image is loaded in the background */
+	if (ima && BKE_image_load_async(ima, &sima->iuser)) {
+		ibuf = NULL;
+		lock = NULL;
+	}
+	else {
+		ibuf = ED_space_image_acquire_buffer(sima, &lock);
+	}
 
 	/* draw the image or grid */
 	if (ibuf == NULL) {
@@ -946,13 +946,15 @@ static void image_tools_region_draw(const bContext *C, ARegion *ar)
 {
 	SpaceImage *sima = CTX_wm_space_image(C);
 	Scene *scene = CTX_data_scene(C);
-	void *lock;
-	ImBuf *ibuf = ED_space_image_acquire_buffer(sima, &lock);
+	void *lock = NULL;
+	ImBuf *ibuf = NULL;
 	/* XXX performance regression if name of scopes category changes! */
 	PanelCategoryStack *category = UI_panel_category_active_find(ar, "Scopes");
 
-	/* only update scopes if scope category is active */
-	if (category) {
+	/* only update scopes if scope category is active, and the image isn't loading */
+	if (category && !(sima->image && BKE_image_load_async(sima->image, &sima->iuser))) {
+		ibuf = ED_space_image_acquire_buffer(sima, &lock);
+
 		if (ibuf) {
 			if (!sima->scopes.ok) {
 				BKE_histogram_update_sample_line(&sima->sample_line_hist, ibuf, &scene->view_settings, &scene->display_settings);
@@ -970,6 +970,16 @@ static void node_draw_basis(const bContext *C, ARegion *ar, SpaceNode *snode, bN
 	         (short)(iconofs - rct->xmin - 18.0f), (short)NODE_DY,
 	         NULL, 0, 0, 0, 0, "");
 
+	/* statistics of the last compositor execution, above the header */
+	if ((snode->flag & SNODE_SHOW_STATISTICS) && ntree->type == NTREE_COMPOSIT && node->exec_chunks > 0) {
+		char stats[128];
+		BLI_snprintf(stats, sizeof(stats), IFACE_("%.2f ms | %.1f MB | %d chunks"),
+		             node->exec_time * 1000.0f, node->exec_memory, node->exec_chunks);
+		uiDefBut(node->block, UI_BTYPE_LABEL, 0, stats,
+		         (int)rct->xmin, (int)rct->ymax, (short)BLI_rctf_size_x(rct), (short)NODE_DY,
+		         NULL, 0, 0, 0, 0, "");
+	}
+
 	/* body */
 	if (!nodeIsRegistered(node))
 		UI_GetThemeColor4fv(TH_REDALERT, color);	/* use warning color to indicate undefined types */
@@ -67,6 +67,7 @@
 #include "ED_mask.h"
 #include "ED_sequencer.h"
 #include "ED_screen.h"
+#include "ED_screen_types.h"
 #include "ED_space_api.h"
 
 #include "UI_interface.h"
@@ -74,6 +75,7 @@
 #include "UI_view2d.h"
 
 #include "WM_api.h"
+#include "WM_types.h"
 
 #include "MEM_guardedalloc.h"
 
@@ -891,6 +893,33 @@ void ED_sequencer_special_preview_clear(void)
 	sequencer_special_update_set(NULL);
 }
 
+/* Queue the frames following the displayed one in the playback direction,
+ * so the prefetch thread renders them while the current frame is shown. */
+static void sequencer_prefetch_request(struct Main *bmain, Scene *scene, const SeqRenderData *context,
+                                       int cfra, int chanshown)
+{
+	bScreen *screen = ED_screen_animation_playing(bmain->wm.first);
+	ScreenAnimData *sad;
+	int step, i;
+
+	if (screen == NULL || screen->animtimer == NULL) {
+		return;
+	}
+
+	sad = screen->animtimer->customdata;
+	step = (sad && (sad->flag & ANIMPLAY_FLAG_REVERSE)) ? -1 : 1;
+
+	for (i = 1; i <= U.prefetchframes; i++) {
+		int nfra = cfra + i * step;
+
+		if (nfra < PSFRA || nfra > PEFRA) {
+			break;
+		}
+
+		BKE_sequencer_give_ibuf_prefetch_request(context, nfra, chanshown);
+	}
+}
+
 ImBuf *sequencer_ibuf_get(struct Main *bmain, Scene *scene, SpaceSeq *sseq, int cfra, int frame_ofs, const char *viewname)
 {
 	SeqRenderData context;
@@ -928,11 +957,16 @@ ImBuf *sequencer_ibuf_get(struct Main *bmain, Scene *scene, SpaceSeq *sseq, int
 
 	if (special_seq_update)
 		ibuf = BKE_sequencer_give_ibuf_direct(&context, cfra + frame_ofs, special_seq_update);
-	else if (!U.prefetchframes) // XXX || (G.f & G_PLAYANIM) == 0) {
+	else if (!U.prefetchframes)
 		ibuf = BKE_sequencer_give_ibuf(&context, cfra + frame_ofs, sseq->chanshown);
-	else
+	else {
 		ibuf = BKE_sequencer_give_ibuf_threaded(&context, cfra + frame_ofs, sseq->chanshown);
 
+		if (frame_ofs == 0) {
+			sequencer_prefetch_request(bmain, scene, &context, cfra, sseq->chanshown);
+		}
+	}
+
 	/* restore state so real rendering would be canceled (if needed) */
 	G.is_break = is_break;
 
@@ -37,9 +37,12 @@
 #include "BLI_blenlib.h"
 #include "BLI_ghash.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 #include "BLI_timecode.h"
 #include "BLI_utildefines.h"
 
+#include "PIL_time.h"
+
 #include "BLT_translation.h"
 
 #include "DNA_scene_types.h"
@@ -143,22 +146,100 @@ static void proxy_freejob(void *pjv)
 	MEM_freeN(pj);
 }
 
+typedef struct ProxyBuildTask {
+	struct SeqIndexBuildContext *context;
+	short *stop;
+	short do_update;
+	float progress;
+	bool done;
+} ProxyBuildTask;
+
+static void proxy_build_task(TaskPool *__restrict UNUSED(pool), void *taskdata, int UNUSED(threadid))
+{
+	ProxyBuildTask *task = taskdata;
+
+	if (!*task->stop) {
+		BKE_sequencer_proxy_rebuild(task->context, task->stop, &task->do_update, &task->progress);
+	}
+
+	task->progress = 1.0f;
+	task->done = true;
+}
+
+/* Build the queued contexts from first on, returns the first context queued
+ * while building. */
+static LinkData *proxy_build_queue(ProxyJob *pj, LinkData *first, short *stop, short *do_update, float *progress)
+{
+	LinkData *link, *last = NULL;
+	ProxyBuildTask *tasks;
+	TaskPool *task_pool;
+	int num_tasks = 0;
+	int i;
+	bool done = false;
+
+	for (link = first; link; link = link->next) {
+		last = link;
+		num_tasks++;
+	}
+
+	tasks = MEM_callocN(sizeof(ProxyBuildTask) * num_tasks, "proxy build tasks");
+	task_pool = BLI_task_pool_create(BLI_task_scheduler_get(), pj);
+
+	/* Strips which can be built concurrently go to the task pool, the others
+	 * are built one after another on this thread meanwhile. */
+	for (link = first, i = 0; i < num_tasks; link = link->next, i++) {
+		tasks[i].context = link->data;
+		tasks[i].stop = stop;
+
+		if (BKE_sequencer_proxy_rebuild_supports_threads(tasks[i].context)) {
+			BLI_task_pool_push(task_pool, proxy_build_task, &tasks[i], false, TASK_PRIORITY_LOW);
+		}
+	}
+
+	for (i = 0; i < num_tasks; i++) {
+		if (!BKE_sequencer_proxy_rebuild_supports_threads(tasks[i].context)) {
+			proxy_build_task(task_pool, &tasks[i], 0);
+		}
+	}
+
+	while (!done) {
+		float total_progress = 0.0f;
+
+		done = true;
+		for (i = 0; i < num_tasks; i++) {
+			total_progress += tasks[i].progress;
+			done &= tasks[i].done;
+		}
+
+		*progress = total_progress / num_tasks;
+		*do_update = true;
+
+		if (!done) {
+			PIL_sleep_ms(50);
+		}
+	}
+
+	BLI_task_pool_work_and_wait(task_pool);
+	BLI_task_pool_free(task_pool);
+	MEM_freeN(tasks);
+
+	return last->next;
+}
+
 /* only this runs inside thread */
 static void proxy_startjob(void *pjv, short *stop, short *do_update, float *progress)
 {
 	ProxyJob *pj = pjv;
-	LinkData *link;
+	LinkData *link = pj->queue.first;
 
-	for (link = pj->queue.first; link; link = link->next) {
-		struct SeqIndexBuildContext *context = link->data;
+	/* strips can be queued while the job runs */
+	while (link && !*stop) {
+		link = proxy_build_queue(pj, link, stop, do_update, progress);
+	}
 
-		BKE_sequencer_proxy_rebuild(context, stop, do_update, progress);
-		
-		if (*stop) {
-			pj->stop = 1;
-			fprintf(stderr,  "Canceling proxy rebuild on users request...\n");
-			break;
-		}
+	if (*stop) {
+		pj->stop = 1;
+		fprintf(stderr,  "Canceling proxy rebuild on users request...\n");
 	}
 }
 
@@ -1669,6 +1669,7 @@ static void view3d_draw_objects(
 
 	if ((v3d->flag2 & V3D_RENDER_SHADOW) == 0) {
 		GPU_free_images_old();
+		GPU_free_images_over_limit();
 	}
 }
 
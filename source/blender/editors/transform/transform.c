@@ -54,6 +54,7 @@
 #include "BLI_ghash.h"
 #include "BLI_stackdefines.h"
 #include "BLI_memarena.h"
+#include "BLI_task.h"
 
 #include "BKE_nla.h"
 #include "BKE_editmesh.h"
@@ -4378,10 +4379,85 @@ static void headerTranslation(TransInfo *t, const float vec[3], char str[UI_MAX_
 	}
 }
 
+typedef struct TranslationValueData {
+	TransInfo *t;
+	const float *vec;
+	const float *pivot;
+	bool apply_snap_align_rotation;
+} TranslationValueData;
+
+static void applyTranslationValue_td(
+        TransInfo *t, TransData *td, const float vec[3],
+        const float pivot[3], const bool apply_snap_align_rotation)
+{
+	float tvec[3];
+	float rotate_offset[3] = {0};
+	bool use_rotate_offset = false;
+
+	/* handle snapping rotation before doing the translation */
+	if (apply_snap_align_rotation) {
+		float mat[3][3];
+
+		if (validSnappingNormal(t)) {
+			const float *original_normal;
+
+			/* In pose mode, we want to align normals with Y axis of bones... */
+			if (t->flag & T_POSE)
+				original_normal = td->axismtx[1];
+			else
+				original_normal = td->axismtx[2];
+
+			rotation_between_vecs_to_mat3(mat, original_normal, t->tsnap.snapNormal);
+		}
+		else {
+			unit_m3(mat);
+		}
+
+		ElementRotation_ex(t, td, mat, pivot);
+
+		if (td->loc) {
+			use_rotate_offset = true;
+			sub_v3_v3v3(rotate_offset, td->loc, td->iloc);
+		}
+	}
+
+	if (t->con.applyVec) {
+		float pvec[3];
+		t->con.applyVec(t, td, vec, tvec, pvec);
+	}
+	else {
+		copy_v3_v3(tvec, vec);
+	}
+
+	if (use_rotate_offset) {
+		add_v3_v3(tvec, rotate_offset);
+	}
+
+	mul_m3_v3(td->smtx, tvec);
+	mul_v3_fl(tvec, td->factor);
+
+	protectedTransBits(td->protectflag, tvec);
+
+	if (td->loc)
+		add_v3_v3v3(td->loc, td->iloc, tvec);
+
+	constraintTransLim(t, td);
+}
+
+static void applyTranslationValue_cb(void *userdata, const int i)
+{
+	TranslationValueData *data = userdata;
+	TransData *td = &data->t->data[i];
+
+	if (td->flag & TD_SKIP)
+		return;
+
+	applyTranslationValue_td(data->t, td, data->vec, data->pivot, data->apply_snap_align_rotation);
+}
+
 static void applyTranslationValue(TransInfo *t, const float vec[3])
 {
 	TransData *td = t->data;
-	float tvec[3];
 
 	/* The ideal would be "apply_snap_align_rotation" only when a snap point is found
 	 * so, maybe inside this function is not the best place to apply this rotation.
@@ -4397,6 +4473,23 @@ static void applyTranslationValue(TransInfo *t, const float vec[3])
 		}
 	}
 
+	/* Edit-mode data only depends on its own element, others may evaluate constraints. */
+	if ((t->flag & T_EDIT) && (t->total > TRANSFORM_THREAD_LIMIT)) {
+		int td_len = 0;
+		while ((td_len < t->total) && !(td[td_len].flag & TD_NOACTION)) {
+			td_len++;
+		}
+
+		TranslationValueData data = {
+			.t = t,
+			.vec = vec,
+			.pivot = pivot,
+			.apply_snap_align_rotation = apply_snap_align_rotation,
+		};
+		BLI_task_parallel_range(0, td_len, &data, applyTranslationValue_cb, true);
+		return;
+	}
+
 	for (int i = 0; i < t->total; i++, td++) {
 		if (td->flag & TD_NOACTION)
 			break;
@@ -4404,57 +4497,7 @@ static void applyTranslationValue(TransInfo *t, const float vec[3])
 		if (td->flag & TD_SKIP)
 			continue;
 
-		float rotate_offset[3] = {0};
-		bool use_rotate_offset = false;
-
-		/* handle snapping rotation before doing the translation */
-		if (apply_snap_align_rotation) {
-			float mat[3][3];
-
-			if (validSnappingNormal(t)) {
-				const float *original_normal;
-
-				/* In pose mode, we want to align normals with Y axis of bones... */
-				if (t->flag & T_POSE)
-					original_normal = td->axismtx[1];
-				else
-					original_normal = td->axismtx[2];
-
-				rotation_between_vecs_to_mat3(mat, original_normal, t->tsnap.snapNormal);
-			}
-			else {
-				unit_m3(mat);
-			}
-
-			ElementRotation_ex(t, td, mat, pivot);
-
-			if (td->loc) {
-				use_rotate_offset = true;
-				sub_v3_v3v3(rotate_offset, td->loc, td->iloc);
-			}
-		}
-
-		if (t->con.applyVec) {
-			float pvec[3];
-			t->con.applyVec(t, td, vec, tvec, pvec);
-		}
-		else {
-			copy_v3_v3(tvec, vec);
-		}
-
-		if (use_rotate_offset) {
-			add_v3_v3(tvec, rotate_offset);
-		}
-		
-		mul_m3_v3(td->smtx, tvec);
-		mul_v3_fl(tvec, td->factor);
-		
-		protectedTransBits(td->protectflag, tvec);
-		
-		if (td->loc)
-			add_v3_v3v3(td->loc, td->iloc, tvec);
-
-		constraintTransLim(t, td);
+		applyTranslationValue_td(t, td, vec, pivot, apply_snap_align_rotation);
 	}
 }
 
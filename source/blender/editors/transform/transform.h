@@ -490,6 +490,9 @@ typedef struct TransInfo {
 #define TRANS_CONFIRM	2
 #define TRANS_CANCEL	3
 
+/* minimum number of elements to create and transform TransData in parallel */
+#define TRANSFORM_THREAD_LIMIT 1000
+
 /* transinfo->flag */
 #define T_OBJECT		(1 << 0)
 #define T_EDIT			(1 << 1)
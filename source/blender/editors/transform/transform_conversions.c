@@ -60,6 +60,7 @@
 #include "BLI_string.h"
 #include "BLI_bitmap.h"
 #include "BLI_rect.h"
+#include "BLI_task.h"
 
 #include "BKE_DerivedMesh.h"
 #include "BKE_action.h"
@@ -2459,9 +2460,103 @@ static void VertsToTransData(TransInfo *t, TransData *td, TransDataExtension *tx
 	}
 }
 
+typedef struct TransEditVertsData {
+	TransInfo *t;
+	BMEditMesh *em;
+	TransDataExtension *tx;
+	/* vertex index of each TransData */
+	const int *verts_index;
+	int cd_vert_bweight_offset;
+	int prop_mode;
+	int mirror;
+	const float *dists;
+	const int *dists_index;
+	struct TransIslandData *island_info;
+	const int *island_vert_map;
+	float (*quats)[4];
+	float (*defmats)[3][3];
+	float (*mtx)[3];
+	float (*smtx)[3];
+} TransEditVertsData;
+
+static void createTransEditVerts_cb(void *userdata, const int i)
+{
+	TransEditVertsData *data = userdata;
+	TransInfo *t = data->t;
+	BMEditMesh *em = data->em;
+	const int a = data->verts_index[i];
+	BMVert *eve = BM_vert_at_index(em->bm, a);
+	TransData *tob = &t->data[i];
+	TransDataExtension *tx = data->tx ? &data->tx[i] : NULL;
+	struct TransIslandData *v_island = NULL;
+	float *bweight = (data->cd_vert_bweight_offset != -1) ?
+	                 BM_ELEM_CD_GET_VOID_P(eve, data->cd_vert_bweight_offset) : NULL;
+
+	if (data->island_info) {
+		const int connected_index = (data->dists_index && data->dists_index[a] != -1) ? data->dists_index[a] : a;
+		v_island = (data->island_vert_map[connected_index] != -1) ?
+		           &data->island_info[data->island_vert_map[connected_index]] : NULL;
+	}
+
+	VertsToTransData(t, tob, tx, em, eve, bweight, v_island);
+
+	/* selected */
+	if (BM_elem_flag_test(eve, BM_ELEM_SELECT))
+		tob->flag |= TD_SELECTED;
+
+	if (data->prop_mode) {
+		if (data->prop_mode & T_PROP_CONNECTED) {
+			tob->dist = data->dists[a];
+		}
+		else {
+			tob->flag |= TD_NOTCONNECTED;
+			tob->dist = FLT_MAX;
+		}
+	}
+
+	/* CrazySpace */
+	if (data->defmats || (data->quats && BM_elem_flag_test(eve, BM_ELEM_TAG))) {
+		float mat[3][3], qmat[3][3], imat[3][3];
+
+		/* use both or either quat and defmat correction */
+		if (data->quats && BM_elem_flag_test(eve, BM_ELEM_TAG)) {
+			quat_to_mat3(qmat, data->quats[BM_elem_index_get(eve)]);
+
+			if (data->defmats)
+				mul_m3_series(mat, data->defmats[a], qmat, data->mtx);
+			else
+				mul_m3_m3m3(mat, data->mtx, qmat);
+		}
+		else
+			mul_m3_m3m3(mat, data->mtx, data->defmats[a]);
+
+		invert_m3_m3(imat, mat);
+
+		copy_m3_m3(tob->smtx, imat);
+		copy_m3_m3(tob->mtx, mat);
+	}
+	else {
+		copy_m3_m3(tob->smtx, data->smtx);
+		copy_m3_m3(tob->mtx, data->mtx);
+	}
+
+	/* Mirror? */
+	if ((data->mirror > 0 && tob->iloc[0] > 0.0f) || (data->mirror < 0 && tob->iloc[0] < 0.0f)) {
+		BMVert *vmir = EDBM_verts_mirror_get(em, eve); //t->obedit, em, eve, tob->iloc, a);
+		if (vmir && vmir != eve) {
+			tob->extra = vmir;
+		}
+	}
+
+	if (data->mirror != 0) {
+		if (ABS(tob->loc[0]) <= 0.00001f) {
+			tob->flag |= TD_MIRROR_EDGE;
+		}
+	}
+}
+
 static void createTransEditVerts(TransInfo *t)
 {
-	TransData *tob = NULL;
 	TransDataExtension *tx = NULL;
 	EvaluationContext eval_ctx;
 	BMEditMesh *em = BKE_editmesh_from_object(t->obedit);
@@ -2472,7 +2567,8 @@ static void createTransEditVerts(TransInfo *t)
 	float (*mappedcos)[3] = NULL, (*quats)[4] = NULL;
 	float mtx[3][3], smtx[3][3], (*defmats)[3][3] = NULL, (*defcos)[3] = NULL;
 	float *dists = NULL;
-	int a;
+	int *verts_index;
+	int a, i;
 	const int prop_mode = (t->flag & T_PROP_EDIT) ? (t->flag & T_PROP_EDIT_ALL) : 0;
 	int mirror = 0;
 	int cd_vert_bweight_offset = -1;
@@ -2534,7 +2630,7 @@ static void createTransEditVerts(TransInfo *t)
 		t->total = bm->totvertsel;
 	}
 
-	tob = t->data = MEM_callocN(t->total * sizeof(TransData), "TransObData(Mesh EditMode)");
+	t->data = MEM_callocN(t->total * sizeof(TransData), "TransObData(Mesh EditMode)");
 	if (ELEM(t->mode, TFM_SKIN_RESIZE, TFM_SHRINKFATTEN)) {
 		/* warning, this is overkill, we only need 2 extra floats,
 		 * but this stores loads of extra stuff, for TFM_SHRINKFATTEN its even more overkill
@@ -2607,89 +2703,51 @@ static void createTransEditVerts(TransInfo *t)
 		}
 	}
 
-	BM_ITER_MESH_INDEX (eve, &iter, bm, BM_VERTS_OF_MESH, a) {
+	/* the vertex index of each TransData, filling them is done in parallel */
+	verts_index = MEM_mallocN(sizeof(*verts_index) * t->total, __func__);
+	a = 0;
+	BM_ITER_MESH_INDEX (eve, &iter, bm, BM_VERTS_OF_MESH, i) {
 		if (!BM_elem_flag_test(eve, BM_ELEM_HIDDEN)) {
 			if (prop_mode || BM_elem_flag_test(eve, BM_ELEM_SELECT)) {
-				struct TransIslandData *v_island = NULL;
-				float *bweight = (cd_vert_bweight_offset != -1) ? BM_ELEM_CD_GET_VOID_P(eve, cd_vert_bweight_offset) : NULL;
-
-				if (island_info) {
-					const int connected_index = (dists_index && dists_index[a] != -1) ? dists_index[a] : a;
-					v_island = (island_vert_map[connected_index] != -1) ?
-					           &island_info[island_vert_map[connected_index]] : NULL;
-				}
-
-
-				VertsToTransData(t, tob, tx, em, eve, bweight, v_island);
-				if (tx)
-					tx++;
-
-				/* selected */
-				if (BM_elem_flag_test(eve, BM_ELEM_SELECT))
-					tob->flag |= TD_SELECTED;
-
-				if (prop_mode) {
-					if (prop_mode & T_PROP_CONNECTED) {
-						tob->dist = dists[a];
-					}
-					else {
-						tob->flag |= TD_NOTCONNECTED;
-						tob->dist = FLT_MAX;
-					}
-				}
-
-				/* CrazySpace */
-				if (defmats || (quats && BM_elem_flag_test(eve, BM_ELEM_TAG))) {
-					float mat[3][3], qmat[3][3], imat[3][3];
-
-					/* use both or either quat and defmat correction */
-					if (quats && BM_elem_flag_test(eve, BM_ELEM_TAG)) {
-						quat_to_mat3(qmat, quats[BM_elem_index_get(eve)]);
-
-						if (defmats)
-							mul_m3_series(mat, defmats[a], qmat, mtx);
-						else
-							mul_m3_m3m3(mat, mtx, qmat);
-					}
-					else
-						mul_m3_m3m3(mat, mtx, defmats[a]);
-
-					invert_m3_m3(imat, mat);
-
-					copy_m3_m3(tob->smtx, imat);
-					copy_m3_m3(tob->mtx, mat);
-				}
-				else {
-					copy_m3_m3(tob->smtx, smtx);
-					copy_m3_m3(tob->mtx, mtx);
-				}
-
-				/* Mirror? */
-				if ((mirror > 0 && tob->iloc[0] > 0.0f) || (mirror < 0 && tob->iloc[0] < 0.0f)) {
-					BMVert *vmir = EDBM_verts_mirror_get(em, eve); //t->obedit, em, eve, tob->iloc, a);
-					if (vmir && vmir != eve) {
-						tob->extra = vmir;
-					}
-				}
-				tob++;
+				verts_index[a++] = i;
 			}
 		}
 	}
-	
+	BLI_assert(a == t->total);
+
+	BM_mesh_elem_table_ensure(bm, BM_VERT);
+
+	{
+		TransEditVertsData data = {
+			.t = t,
+			.em = em,
+			.tx = tx,
+			.verts_index = verts_index,
+			.cd_vert_bweight_offset = cd_vert_bweight_offset,
+			.prop_mode = prop_mode,
+			.mirror = mirror,
+			.dists = dists,
+			.dists_index = dists_index,
+			.island_info = island_info,
+			.island_vert_map = island_vert_map,
+			.quats = quats,
+			.defmats = defmats,
+			.mtx = mtx,
+			.smtx = smtx,
+		};
+
+		BLI_task_parallel_range(
+		        0, t->total, &data, createTransEditVerts_cb,
+		        t->total > TRANSFORM_THREAD_LIMIT);
+	}
+
+	MEM_freeN(verts_index);
+
 	if (island_info) {
 		MEM_freeN(island_info);
 		MEM_freeN(island_vert_map);
 	}
 
-	if (mirror != 0) {
-		tob = t->data;
-		for (a = 0; a < t->total; a++, tob++) {
-			if (ABS(tob->loc[0]) <= 0.00001f) {
-				tob->flag |= TD_MIRROR_EDGE;
-			}
-		}
-	}
-
 cleanup:
 	/* crazy space free */
 	if (quats)
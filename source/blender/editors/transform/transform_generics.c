@@ -777,7 +777,17 @@ static void recalcData_objects(TransInfo *t)
 
 			DEG_id_tag_update(t->obedit->data, 0);  /* sets recalc flags */
 			
-			EDBM_mesh_normals_update(em);
+			/* Without proportional editing, mirror or sliding only the selection moves,
+			 * so when it's a small part of the mesh only update the normals around it. */
+			if (((t->flag & (T_PROP_EDIT | T_MIRROR)) == 0) &&
+			    !ELEM(t->mode, TFM_EDGE_SLIDE, TFM_VERT_SLIDE) &&
+			    (em->bm->totvertsel < em->bm->totvert / 4))
+			{
+				BM_mesh_normals_update_tagged(em->bm, BM_ELEM_SELECT);
+			}
+			else {
+				EDBM_mesh_normals_update(em);
+			}
 			BKE_editmesh_tessface_calc(em);
 		}
 		else if (t->obedit->type == OB_ARMATURE) { /* no recalc flag, does pose */
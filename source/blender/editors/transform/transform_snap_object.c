@@ -712,6 +712,48 @@ static bool raycastEditMesh(
  *
  * \note Duplicate args here are documented at #snapObjectsRay
  */
+/**
+ * Cull an object by its bounds before its derived mesh is fetched.
+ *
+ * Only the bounds of evaluated objects are used, returns true when the object may be hit.
+ */
+static bool raycast_object_boundbox_test(
+        const float ray_start[3], const float ray_dir[3],
+        Object *ob, float obmat[4][4], const float ray_depth, const bool use_hit_list)
+{
+	BoundBox *bb = ob->bb;
+	if ((bb == NULL) || (bb->flag & BOUNDBOX_DIRTY)) {
+		return true;
+	}
+
+	float imat[4][4];
+	float ray_start_local[3], ray_normal_local[3];
+	float local_scale, len_diff;
+
+	invert_m4_m4(imat, obmat);
+
+	copy_v3_v3(ray_start_local, ray_start);
+	copy_v3_v3(ray_normal_local, ray_dir);
+
+	mul_m4_v3(imat, ray_start_local);
+	mul_mat3_m4_v3(imat, ray_normal_local);
+
+	local_scale = normalize_v3(ray_normal_local);
+
+	if (!isect_ray_aabb_v3_simple(
+	        ray_start_local, ray_normal_local, bb->vec[0], bb->vec[6], &len_diff, NULL))
+	{
+		return false;
+	}
+
+	/* the bounds are further away than the nearest hit so far */
+	if (!use_hit_list && (ray_depth != BVH_RAYCAST_DIST_MAX) && (len_diff > ray_depth * local_scale)) {
+		return false;
+	}
+
+	return true;
+}
+
 static bool raycastObj(
         const bContext *C, SnapObjectContext *sctx,
         const float ray_start[3], const float ray_dir[3],
@@ -740,7 +782,9 @@ static bool raycastObj(
 			        ob, em, obmat, ob_index,
 			        ray_depth, r_loc, r_no, r_index, r_hit_list);
 		}
-		else {
+		else if (raycast_object_boundbox_test(
+		             ray_start, ray_dir, ob, obmat, *ray_depth, r_hit_list != NULL))
+		{
 			/* in this case we want the mesh from the editmesh, avoids stale data. see: T45978.
 			 * still set the 'em' to NULL, since we only want the 'dm'. */
 			DerivedMesh *dm;
@@ -1949,6 +1993,43 @@ static bool snapEditMesh(
  *
  * \note Duplicate args here are documented at #snapObjectsRay
  */
+/**
+ * Cull an object by the screen-space distance to its bounds before its derived mesh is fetched.
+ *
+ * Only the bounds of evaluated objects are used, returns true when the object may be snapped to.
+ */
+static bool snap_object_boundbox_test(
+        SnapData *snapdata, Object *ob, float obmat[4][4], const float dist_px)
+{
+	BoundBox *bb = ob->bb;
+	if ((bb == NULL) || (bb->flag & BOUNDBOX_DIRTY)) {
+		return true;
+	}
+
+	float imat[4][4];
+	float lpmat[4][4];
+	float ray_org_local[3], ray_normal_local[3];
+	float local_scale, ray_min_dist;
+
+	invert_m4_m4(imat, obmat);
+
+	copy_v3_v3(ray_normal_local, snapdata->ray_dir);
+	mul_mat3_m4_v3(imat, ray_normal_local);
+	local_scale = normalize_v3(ray_normal_local);
+
+	mul_m4_m4m4(lpmat, snapdata->pmat, obmat);
+	ray_min_dist = snapdata->depth_range[0] * local_scale;
+
+	copy_v3_v3(ray_org_local, snapdata->ray_origin);
+	mul_m4_v3(imat, ray_org_local);
+
+	const float dist_px_sq = dist_squared_to_projected_aabb_simple(
+	        lpmat, snapdata->win_half, ray_min_dist, snapdata->mval,
+	        ray_org_local, ray_normal_local, bb->vec[0], bb->vec[6]);
+
+	return (dist_px_sq <= SQUARE(dist_px));
+}
+
 static bool snapObject(
         const bContext *C, SnapObjectContext *sctx, SnapData *snapdata,
         Object *ob, float obmat[4][4],
@@ -1974,7 +2055,7 @@ static bool snapObject(
 			        ray_depth, dist_px,
 			        r_loc, r_no);
 		}
-		else {
+		else if (snap_object_boundbox_test(snapdata, ob, obmat, *dist_px)) {
 			/* in this case we want the mesh from the editmesh, avoids stale data. see: T45978.
 			 * still set the 'em' to NULL, since we only want the 'dm'. */
 			DerivedMesh *dm;
@@ -55,6 +55,30 @@ static const Global &_global = G;
 
 using namespace std;
 
+// Occluders sharing a vertex with the face of a smooth edge are ignored. Gather the faces around the
+// (non-boundary) vertices of that face once per edge, instead of walking the vertex fans for every occluder.
+static void retrieveAdjacentFaces(const vector<WVertex*>& faceVertices, vector<WFace*>& oAdjacentFaces)
+{
+	oAdjacentFaces.clear();
+	for (vector<WVertex*>::const_iterator fv = faceVertices.begin(), fvend = faceVertices.end(); fv != fvend; ++fv) {
+		if ((*fv)->isBoundary())
+			continue;
+
+		WVertex::incoming_edge_iterator iebegin = (*fv)->incoming_edges_begin();
+		WVertex::incoming_edge_iterator ieend = (*fv)->incoming_edges_end();
+		for (WVertex::incoming_edge_iterator ie = iebegin; ie != ieend; ++ie) {
+			if ((*ie) == 0)
+				continue;
+			oAdjacentFaces.push_back((*ie)->GetbFace());
+		}
+	}
+}
+
+static inline bool isAdjacentFace(const vector<WFace*>& adjacentFaces, const WFace *oface)
+{
+	return find(adjacentFaces.begin(), adjacentFaces.end(), oface) != adjacentFaces.end();
+}
+
 template <typename G, typename I>
 static void findOccludee(FEdge *fe, G& /*grid*/, I& occluders, real epsilon, WFace **oaWFace,
                          Vec3r& u, Vec3r& A, Vec3r& origin, Vec3r& edgeDir, vector<WVertex*>& faceVertices)
@@ -65,9 +89,7 @@ static void findOccludee(FEdge *fe, G& /*grid*/, I& occluders, real epsilon, WFa
 		face = (WFace *)fes->face();
 	}
 	WFace *oface;
-	bool skipFace;
-
-	WVertex::incoming_edge_iterator ie;
+	vector<WFace*> adjacentFaces;
 
 	*oaWFace = NULL;
 	if (((fe)->getNature() & Nature::SILHOUETTE) || ((fe)->getNature() & Nature::BORDER)) {
@@ -76,6 +98,9 @@ static void findOccludee(FEdge *fe, G& /*grid*/, I& occluders, real epsilon, WFa
 		bool noIntersection = true;
 		real mint = FLT_MAX;
 
+		if (face)
+			retrieveAdjacentFaces(faceVertices, adjacentFaces);
+
 		for (occluders.initAfterTarget(); occluders.validAfterTarget(); occluders.nextOccludee()) {
 #if LOGGING
 			if (_global.debug & G_DEBUG_FREESTYLE) {
@@ -89,36 +114,13 @@ static void findOccludee(FEdge *fe, G& /*grid*/, I& occluders, real epsilon, WFa
 			real t, t_u, t_v;
 
 			if (0 != face) {
-				skipFace = false;
-
 				if (face == oface)
 					continue;
 
 				if (faceVertices.empty())
 					continue;
 
-				for (vector<WVertex*>::iterator fv = faceVertices.begin(), fvend = faceVertices.end();
-				     fv != fvend;
-				     ++fv)
-				{
-					if ((*fv)->isBoundary())
-						continue;
-					WVertex::incoming_edge_iterator iebegin = (*fv)->incoming_edges_begin();
-					WVertex::incoming_edge_iterator ieend = (*fv)->incoming_edges_end();
-					for (ie = iebegin; ie != ieend; ++ie) {
-						if ((*ie) == 0)
-							continue;
-
-						WFace *sface = (*ie)->GetbFace();
-						if (sface == oface) {
-							skipFace = true;
-							break;
-						}
-					}
-					if (skipFace)
-						break;
-				}
-				if (skipFace)
+				if (isAdjacentFace(adjacentFaces, oface))
 					continue;
 			}
 			else {
@@ -237,13 +239,14 @@ static int computeVisibility(ViewMap *viewMap, FEdge *fe, G& grid, real epsilon,
 		face = (WFace *)fes->face();
 	}
 	vector<WVertex*> faceVertices;
-	WVertex::incoming_edge_iterator ie;
+	vector<WFace*> adjacentFaces;
 
 	WFace *oface;
-	bool skipFace;
 
-	if (face)
+	if (face) {
 		face->RetrieveVertexList(faceVertices);
+		retrieveAdjacentFaces(faceVertices, adjacentFaces);
+	}
 
 	I occluders(grid, center, epsilon);
 
@@ -293,8 +296,6 @@ static int computeVisibility(ViewMap *viewMap, FEdge *fe, G& grid, real epsilon,
 				cout << "\t\tDetermining face adjacency...";
 			}
 #endif
-			skipFace = false;
-
 			if (face == oface) {
 #if LOGGING
 				if (_global.debug & G_DEBUG_FREESTYLE) {
@@ -304,29 +305,7 @@ static int computeVisibility(ViewMap *viewMap, FEdge *fe, G& grid, real epsilon,
 				continue;
 			}
 
-
-			for (vector<WVertex*>::iterator fv = faceVertices.begin(), fvend = faceVertices.end(); fv != fvend; ++fv) {
-				if ((*fv)->isBoundary())
-					continue;
-
-				WVertex::incoming_edge_iterator iebegin = (*fv)->incoming_edges_begin();
-				WVertex::incoming_edge_iterator ieend = (*fv)->incoming_edges_end();
-				for (ie = iebegin; ie != ieend; ++ie) {
-					if ((*ie) == 0)
-						continue;
-
-					WFace *sface = (*ie)->GetbFace();
-					//WFace *sfacea = (*ie)->GetaFace();
-					//if ((sface == oface) || (sfacea == oface))
-					if (sface == oface) {
-						skipFace = true;
-						break;
-					}
-				}
-				if (skipFace)
-					break;
-			}
-			if (skipFace) {
+			if (isAdjacentFace(adjacentFaces, oface)) {
 #if LOGGING
 				if (_global.debug & G_DEBUG_FREESTYLE) {
 					cout << "  Rejecting occluder for face adjacency." << endl;
@@ -1799,9 +1778,8 @@ void ViewMapBuilder::FindOccludee(FEdge *fe, Grid *iGrid, real epsilon, Polygon3
 	}
 	OccludersSet occluders;
 	WFace *oface;
-	bool skipFace;
+	vector<WFace*> adjacentFaces;
 
-	WVertex::incoming_edge_iterator ie;
 	OccludersSet::iterator p, pend;
 
 	*oaPolygon = NULL;
@@ -1811,6 +1789,9 @@ void ViewMapBuilder::FindOccludee(FEdge *fe, Grid *iGrid, real epsilon, Polygon3
 		Vec3r v(-u[0], -u[1], -u[2]);
 		iGrid->castInfiniteRay(A, v, occluders, timestamp);
 
+		if (face)
+			retrieveAdjacentFaces(faceVertices, adjacentFaces);
+
 		bool noIntersection = true;
 		real mint = FLT_MAX;
 		// we met some occluders, let us fill the aShape field with the first intersected occluder
@@ -1825,36 +1806,13 @@ void ViewMapBuilder::FindOccludee(FEdge *fe, Grid *iGrid, real epsilon, Polygon3
 			real t, t_u, t_v;
 
 			if (face) {
-				skipFace = false;
-
 				if (face == oface)
 					continue;
 
 				if (faceVertices.empty())
 					continue;
 
-				for (vector<WVertex*>::iterator fv = faceVertices.begin(), fvend = faceVertices.end();
-				     fv != fvend;
-				     ++fv)
-				{
-					if ((*fv)->isBoundary())
-						continue;
-					WVertex::incoming_edge_iterator iebegin = (*fv)->incoming_edges_begin();
-					WVertex::incoming_edge_iterator ieend = (*fv)->incoming_edges_end();
-					for (ie = iebegin; ie != ieend; ++ie) {
-						if ((*ie) == 0)
-							continue;
-
-						WFace *sface = (*ie)->GetbFace();
-						if (sface == oface) {
-							skipFace = true;
-							break;
-						}
-					}
-					if (skipFace)
-						break;
-				}
-				if (skipFace)
+				if (isAdjacentFace(adjacentFaces, oface))
 					continue;
 			}
 			else {
@@ -1979,13 +1937,14 @@ int ViewMapBuilder::ComputeRayCastingVisibility(FEdge *fe, Grid *iGrid, real eps
 		face = (WFace *)fes->face();
 	}
 	vector<WVertex *> faceVertices;
-	WVertex::incoming_edge_iterator ie;
+	vector<WFace *> adjacentFaces;
 
 	WFace *oface;
-	bool skipFace;
 	OccludersSet::iterator p, pend;
-	if (face)
+	if (face) {
 		face->RetrieveVertexList(faceVertices);
+		retrieveAdjacentFaces(faceVertices, adjacentFaces);
+	}
 
 	for (p = occluders.begin(), pend = occluders.end(); p != pend; p++) {
 		// If we're dealing with an exact silhouette, check whether we must take care of this occluder of not.
@@ -2017,8 +1976,6 @@ int ViewMapBuilder::ComputeRayCastingVisibility(FEdge *fe, Grid *iGrid, real eps
 				cout << "\t\tDetermining face adjacency...";
 			}
 #endif
-			skipFace = false;
-
 			if (face == oface) {
 #if LOGGING
 				if (_global.debug & G_DEBUG_FREESTYLE) {
@@ -2028,31 +1985,7 @@ int ViewMapBuilder::ComputeRayCastingVisibility(FEdge *fe, Grid *iGrid, real eps
 				continue;
 			}
 
-			for (vector<WVertex*>::iterator fv = faceVertices.begin(), fvend = faceVertices.end();
-			     fv != fvend;
-			     ++fv)
-			{
-				if ((*fv)->isBoundary())
-					continue;
-
-				WVertex::incoming_edge_iterator iebegin = (*fv)->incoming_edges_begin();
-				WVertex::incoming_edge_iterator ieend = (*fv)->incoming_edges_end();
-				for (ie = iebegin; ie != ieend; ++ie) {
-					if ((*ie) == 0)
-						continue;
-
-					WFace *sface = (*ie)->GetbFace();
-					//WFace *sfacea = (*ie)->GetaFace();
-					//if ((sface == oface) || (sfacea == oface)) {
-					if (sface == oface) {
-						skipFace = true;
-						break;
-					}
-				}
-				if (skipFace)
-					break;
-			}
-			if (skipFace) {
+			if (isAdjacentFace(adjacentFaces, oface)) {
 #if LOGGING
 				if (_global.debug & G_DEBUG_FREESTYLE) {
 					cout << "  Rejecting occluder for face adjacency." << endl;
@@ -125,6 +125,10 @@ float GPU_get_anisotropic(void);
 /* enable gpu mipmapping */
 void GPU_set_gpu_mipmapping(int gpu_mipmap);
 
+/* Images which aren't loaded yet are loaded in the background, without a
+ * texture until then. Only for interactive drawing, renders need them all. */
+void GPU_set_image_async_load(bool async_load);
+
 /* Image updates and free
  * - these deal with images bound as opengl textures */
 
@@ -145,6 +149,7 @@ void GPU_free_image(struct Image *ima);
 void GPU_free_images(void);
 void GPU_free_images_anim(void);
 void GPU_free_images_old(void);
+void GPU_free_images_over_limit(void);
 
 /* smoke drawing functions */
 void GPU_free_smoke(struct SmokeModifierData *smd);
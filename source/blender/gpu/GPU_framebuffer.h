@@ -95,6 +95,7 @@ int GPU_offscreen_color_texture(const GPUOffScreen *ofs);
 void GPU_offscreen_viewport_data_get(
         GPUOffScreen *ofs,
         GPUFrameBuffer **r_fb, struct GPUTexture **r_color, struct GPUTexture **r_depth);
+struct GPUViewport *GPU_offscreen_viewport_ensure(GPUOffScreen *ofs);
 
 #ifdef __cplusplus
 }
@@ -48,6 +48,8 @@ enum {
 	GPU_SHADER_FLAGS_NONE = 0,
 	GPU_SHADER_FLAGS_SPECIAL_OPENSUBDIV = (1 << 0),
 	GPU_SHADER_FLAGS_NEW_SHADING        = (1 << 1),
+	/* Store linked programs on disk, see GPU_generate_pass. */
+	GPU_SHADER_FLAGS_BINARY_CACHE       = (1 << 2),
 };
 
 GPUShader *GPU_shader_create(
@@ -106,6 +106,15 @@ GPUTexture *GPU_viewport_texture_pool_query(GPUViewport *viewport, void *engine,
 
 bool GPU_viewport_cache_validate(GPUViewport *viewport, unsigned int hash);
 
+/* Temporal accumulation */
+int GPU_viewport_history_samples_get(GPUViewport *viewport, const float persmat[4][4]);
+void GPU_viewport_history_reset(GPUViewport *viewport);
+void GPU_viewport_history_accumulate(GPUViewport *viewport);
+
+/* Depth reuse */
+void GPU_viewport_depth_tag(GPUViewport *viewport, const float persmat[4][4]);
+bool GPU_viewport_depth_draw(GPUViewport *viewport, const float persmat[4][4], const int size[2]);
+
 /* debug */
 bool GPU_viewport_debug_depth_create(GPUViewport *viewport, int width, int height, char err_out[256]);
 void GPU_viewport_debug_depth_free(GPUViewport *viewport);
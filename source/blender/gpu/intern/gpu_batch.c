@@ -128,44 +128,62 @@ static Gwn_Batch *batch_sphere_wire(int lat_res, int lon_res)
 	return GWN_batch_create(GWN_PRIM_LINES, vbo, NULL);
 }
 
+/* Spheres are created on first use, like the builtin shaders, to keep them out of startup. */
 Gwn_Batch *Batch_get_sphere(int lod)
 {
 	BLI_assert(lod >= 0 && lod <= 2);
 
-	if (lod == 0)
+	/* Hard coded resolution */
+	if (lod == 0) {
+		if (sphere_low == NULL)
+			sphere_low = batch_sphere(8, 16);
 		return sphere_low;
-	else if (lod == 1)
+	}
+	else if (lod == 1) {
+		if (sphere_med == NULL)
+			sphere_med = batch_sphere(16, 10);
 		return sphere_med;
-	else
+	}
+	else {
+		if (sphere_high == NULL)
+			sphere_high = batch_sphere(32, 24);
 		return sphere_high;
+	}
 }
 
 Gwn_Batch *Batch_get_sphere_wire(int lod)
 {
 	BLI_assert(lod >= 0 && lod <= 1);
 
-	if (lod == 0)
+	if (lod == 0) {
+		if (sphere_wire_low == NULL)
+			sphere_wire_low = batch_sphere_wire(6, 8);
 		return sphere_wire_low;
-	else
+	}
+	else {
+		if (sphere_wire_med == NULL)
+			sphere_wire_med = batch_sphere_wire(8, 16);
 		return sphere_wire_med;
+	}
 }
 
 void gpu_batch_init(void)
 {
-	/* Hard coded resolution */
-	sphere_low = batch_sphere(8, 16);
-	sphere_med = batch_sphere(16, 10);
-	sphere_high = batch_sphere(32, 24);
+}
 
-	sphere_wire_low = batch_sphere_wire(6, 8);
-	sphere_wire_med = batch_sphere_wire(8, 16);
+static void batch_discard_safe(Gwn_Batch **batch)
+{
+	if (*batch) {
+		GWN_batch_discard_all(*batch);
+		*batch = NULL;
+	}
 }
 
 void gpu_batch_exit(void)
 {
-	GWN_batch_discard_all(sphere_low);
-	GWN_batch_discard_all(sphere_med);
-	GWN_batch_discard_all(sphere_high);
-	GWN_batch_discard_all(sphere_wire_low);
-	GWN_batch_discard_all(sphere_wire_med);
+	batch_discard_safe(&sphere_low);
+	batch_discard_safe(&sphere_med);
+	batch_discard_safe(&sphere_high);
+	batch_discard_safe(&sphere_wire_low);
+	batch_discard_safe(&sphere_wire_med);
 }
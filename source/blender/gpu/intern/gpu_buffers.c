@@ -1017,6 +1017,41 @@ static void gpu_pbvh_batch_init(GPU_PBVH_Buffers *buffers)
 	}
 }
 
+/**
+ * Allocate the vertex buffer for \a vert_len vertices.
+ *
+ * While the vertex count of a node stays the same (the common case while sculpting),
+ * the existing buffer is re-uploaded in place instead of creating new buffers and batches.
+ *
+ * \return true when the buffer is reused, finish with #gpu_pbvh_vert_buf_data_end.
+ */
+static bool gpu_pbvh_vert_buf_data_begin(
+        GPU_PBVH_Buffers *buffers, const Gwn_VertFormat *format, uint vert_len)
+{
+	if (buffers->vert_buf && buffers->triangles &&
+	    (vert_len != 0) && (buffers->vert_buf->vertex_ct == vert_len))
+	{
+		GWN_vertbuf_data_update_begin(buffers->vert_buf);
+		return true;
+	}
+
+	GWN_VERTBUF_DISCARD_SAFE(buffers->vert_buf);
+	buffers->vert_buf = GWN_vertbuf_create_with_format(format);
+	GWN_vertbuf_data_alloc(buffers->vert_buf, vert_len);
+	return false;
+}
+
+static void gpu_pbvh_vert_buf_data_end(GPU_PBVH_Buffers *buffers, const bool reuse)
+{
+	if (reuse) {
+		/* the batches already reference this buffer */
+		GWN_vertbuf_data_update_end(buffers->vert_buf);
+	}
+	else {
+		gpu_pbvh_batch_init(buffers);
+	}
+}
+
 static float gpu_color_from_mask(float mask)
 {
 	return 1.0f - mask * 0.75f;
@@ -1078,15 +1113,13 @@ void GPU_pbvh_mesh_buffers_update(
 		rgba_float_to_uchar(diffuse_color_ub, diffuse_color);
 
 		/* Build VBO */
-		GWN_VERTBUF_DISCARD_SAFE(buffers->vert_buf);
 
 		/* match 'VertexBufferFormat' */
 		Gwn_VertFormat format = {0};
 		VertexBufferAttrID vbo_id;
 		gpu_pbvh_vert_format_init__gwn(&format, &vbo_id);
 
-		buffers->vert_buf = GWN_vertbuf_create_with_format(&format);
-		GWN_vertbuf_data_alloc(buffers->vert_buf, totelem);
+		const bool reuse = gpu_pbvh_vert_buf_data_begin(buffers, &format, totelem);
 
 		if (buffers->vert_buf->data) {
 			/* Vertex data is shared if smooth-shaded, but separate
@@ -1162,7 +1195,7 @@ void GPU_pbvh_mesh_buffers_update(
 				}
 			}
 
-			gpu_pbvh_batch_init(buffers);
+			gpu_pbvh_vert_buf_data_end(buffers, reuse);
 		}
 		else {
 			GWN_VERTBUF_DISCARD_SAFE(buffers->vert_buf);
@@ -1286,9 +1319,7 @@ void GPU_pbvh_grid_buffers_update(
 		gpu_pbvh_vert_format_init__gwn(&format, &vbo_id);
 
 		/* Build coord/normal VBO */
-		GWN_VERTBUF_DISCARD_SAFE(buffers->vert_buf);
-		buffers->vert_buf = GWN_vertbuf_create_with_format(&format);
-		GWN_vertbuf_data_alloc(buffers->vert_buf, totgrid * key->grid_area);
+		const bool reuse = gpu_pbvh_vert_buf_data_begin(buffers, &format, totgrid * key->grid_area);
 
 		uint vbo_index_offset = 0;
 		if (buffers->vert_buf->data) {
@@ -1357,7 +1388,7 @@ void GPU_pbvh_grid_buffers_update(
 				vbo_index_offset += key->grid_area;
 			}
 
-			gpu_pbvh_batch_init(buffers);
+			gpu_pbvh_vert_buf_data_end(buffers, reuse);
 		}
 		else {
 			GWN_VERTBUF_DISCARD_SAFE(buffers->vert_buf);
@@ -42,6 +42,7 @@
 #include "BLI_utildefines.h"
 #include "BLI_dynstr.h"
 #include "BLI_ghash.h"
+#include "BLI_hash_md5.h"
 
 #include "GPU_extensions.h"
 #include "GPU_glew.h"
@@ -2033,6 +2034,99 @@ static void gpu_nodes_prune(ListBase *nodes, GPUNodeLink *outlink)
 	}
 }
 
+/* -------------------------------------------------------------------- */
+
+/** \name Pass Shader Cache
+ *
+ * Materials with the same node graph generate the same code, since socket values
+ * are stored in the material UBO: let their passes share a single compiled shader.
+ * \{ */
+
+typedef struct GPUPassShader {
+	GPUShader *shader;
+	int users;
+	char key[33];
+} GPUPassShader;
+
+/* key: md5 of all shader sources (hex string), value: GPUPassShader */
+static GHash *g_pass_shader_cache = NULL;
+
+static void gpu_pass_shader_key(
+        const char *vertexcode, const char *geometrycode, const char *fragmentcode,
+        const char *libcode, const char *defines, const int flags, char r_key[33])
+{
+	DynStr *ds = BLI_dynstr_new();
+	unsigned char digest[16];
+
+	BLI_dynstr_appendf(ds, "%d\n", flags);
+	BLI_dynstr_append(ds, defines ? defines : "");
+	BLI_dynstr_append(ds, "\n//\n");
+	BLI_dynstr_append(ds, vertexcode ? vertexcode : "");
+	BLI_dynstr_append(ds, "\n//\n");
+	BLI_dynstr_append(ds, geometrycode ? geometrycode : "");
+	BLI_dynstr_append(ds, "\n//\n");
+	BLI_dynstr_append(ds, libcode ? libcode : "");
+	BLI_dynstr_append(ds, "\n//\n");
+	BLI_dynstr_append(ds, fragmentcode ? fragmentcode : "");
+
+	const int len = BLI_dynstr_get_len(ds);
+	char *str = BLI_dynstr_get_cstring(ds);
+	BLI_dynstr_free(ds);
+
+	BLI_hash_md5_buffer(str, (size_t)len, digest);
+	BLI_hash_md5_to_hexdigest(digest, r_key);
+	MEM_freeN(str);
+}
+
+/**
+ * Same as #GPU_shader_create_ex, but reuses the shader of an existing pass with the same code.
+ * Release with #gpu_pass_shader_release.
+ */
+static GPUPassShader *gpu_pass_shader_ensure(
+        const char *vertexcode, const char *geometrycode, const char *fragmentcode,
+        const char *libcode, const char *defines, const int flags)
+{
+	char key[33];
+	gpu_pass_shader_key(vertexcode, geometrycode, fragmentcode, libcode, defines, flags, key);
+
+	if (g_pass_shader_cache == NULL) {
+		g_pass_shader_cache = BLI_ghash_str_new(__func__);
+	}
+
+	GPUPassShader *pass_shader = BLI_ghash_lookup(g_pass_shader_cache, key);
+	if (pass_shader == NULL) {
+		GPUShader *shader = GPU_shader_create_ex(vertexcode, fragmentcode, geometrycode, libcode, defines, flags);
+		if (shader == NULL) {
+			return NULL;
+		}
+		pass_shader = MEM_callocN(sizeof(*pass_shader), __func__);
+		pass_shader->shader = shader;
+		BLI_strncpy(pass_shader->key, key, sizeof(pass_shader->key));
+		BLI_ghash_insert(g_pass_shader_cache, pass_shader->key, pass_shader);
+	}
+
+	pass_shader->users++;
+	return pass_shader;
+}
+
+static void gpu_pass_shader_release(GPUPassShader *pass_shader)
+{
+	BLI_assert(pass_shader->users > 0);
+
+	if (--pass_shader->users == 0) {
+		BLI_ghash_remove(g_pass_shader_cache, pass_shader->key, NULL, NULL);
+		GPU_shader_free(pass_shader->shader);
+		MEM_freeN(pass_shader);
+
+		if (BLI_ghash_size(g_pass_shader_cache) == 0) {
+			BLI_ghash_free(g_pass_shader_cache, NULL, NULL);
+			g_pass_shader_cache = NULL;
+		}
+	}
+}
+
+/** \} */
+
 GPUPass *GPU_generate_pass_new(
         struct GPUMaterial *material,
         ListBase *nodes, struct GPUNodeLink *frag_outlink,
@@ -2040,7 +2134,7 @@ GPUPass *GPU_generate_pass_new(
         const char *vert_code, const char *geom_code,
         const char *frag_lib, const char *defines)
 {
-	GPUShader *shader;
+	GPUPassShader *shader;
 	GPUPass *pass;
 	char *vertexgen, *fragmentgen, *tmp;
 	char *vertexcode, *geometrycode, *fragmentcode;
@@ -2065,11 +2159,12 @@ GPUPass *GPU_generate_pass_new(
 		geometrycode = NULL;
 	}
 
-	shader = GPU_shader_create(vertexcode,
-	                           fragmentcode,
-	                           geometrycode,
-	                           NULL,
-	                           defines);
+	shader = gpu_pass_shader_ensure(vertexcode,
+	                                geometrycode,
+	                                fragmentcode,
+	                                NULL,
+	                                defines,
+	                                GPU_SHADER_FLAGS_BINARY_CACHE);
 
 	MEM_freeN(tmp);
 
@@ -2089,7 +2184,8 @@ GPUPass *GPU_generate_pass_new(
 
 	/* create pass */
 	pass = MEM_callocN(sizeof(GPUPass), "GPUPass");
-	pass->shader = shader;
+	pass->shared_shader = shader;
+	pass->shader = shader->shader;
 	pass->fragmentcode = fragmentcode;
 	pass->geometrycode = geometrycode;
 	pass->vertexcode = vertexcode;
@@ -2112,7 +2208,7 @@ GPUPass *GPU_generate_pass(
         const bool use_opensubdiv,
         const bool use_new_shading)
 {
-	GPUShader *shader;
+	GPUPassShader *shader;
 	GPUPass *pass;
 	char *vertexcode, *geometrycode, *fragmentcode;
 
@@ -2141,12 +2237,12 @@ GPUPass *GPU_generate_pass(
 	if (use_new_shading) {
 		flags |= GPU_SHADER_FLAGS_NEW_SHADING;
 	}
-	shader = GPU_shader_create_ex(vertexcode,
-	                              fragmentcode,
-	                              geometrycode,
-	                              glsl_material_library,
-	                              NULL,
-	                              flags);
+	shader = gpu_pass_shader_ensure(vertexcode,
+	                                geometrycode,
+	                                fragmentcode,
+	                                glsl_material_library,
+	                                NULL,
+	                                flags | GPU_SHADER_FLAGS_BINARY_CACHE);
 
 	/* failed? */
 	if (!shader) {
@@ -2163,7 +2259,8 @@ GPUPass *GPU_generate_pass(
 	/* create pass */
 	pass = MEM_callocN(sizeof(GPUPass), "GPUPass");
 
-	pass->shader = shader;
+	pass->shared_shader = shader;
+	pass->shader = shader->shader;
 	pass->fragmentcode = fragmentcode;
 	pass->geometrycode = geometrycode;
 	pass->vertexcode = vertexcode;
@@ -2178,7 +2275,7 @@ GPUPass *GPU_generate_pass(
 
 void GPU_pass_free(GPUPass *pass)
 {
-	GPU_shader_free(pass->shader);
+	gpu_pass_shader_release(pass->shared_shader);
 	gpu_inputs_free(&pass->inputs);
 	if (pass->fragmentcode)
 		MEM_freeN(pass->fragmentcode);
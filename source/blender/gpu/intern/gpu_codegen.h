@@ -158,6 +158,8 @@ typedef struct GPUInput {
 struct GPUPass {
 	ListBase inputs;
 	struct GPUShader *shader;
+	/* owner of 'shader', shared by all passes with identical code */
+	struct GPUPassShader *shared_shader;
 	char *fragmentcode;
 	char *geometrycode;
 	char *vertexcode;
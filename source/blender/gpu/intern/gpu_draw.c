@@ -271,7 +271,10 @@ static struct GPUTextureState {
 	int alphablend;
 	float anisotropic;
 	int gpu_mipmap;
-} GTS = {0, 0, 0, 0, 0, 0, 0, 0, NULL, NULL, 1, 0, 0, -1, 1.0f, 0};
+
+	/* load images in the background instead of waiting for them */
+	bool async_load;
+} GTS = {0, 0, 0, 0, 0, 0, 0, 0, NULL, NULL, 1, 0, 0, -1, 1.0f, 0, false};
 
 /* Mipmap settings */
 
@@ -287,6 +290,11 @@ void GPU_set_gpu_mipmapping(int gpu_mipmap)
 	}
 }
 
+void GPU_set_image_async_load(bool async_load)
+{
+	GTS.async_load = async_load;
+}
+
 void GPU_set_mipmap(bool mipmap)
 {
 	if (GTS.domipmap != mipmap) {
@@ -518,6 +526,10 @@ int GPU_verify_image(
 	if (ima == NULL || ima->ok == 0)
 		return 0;
 
+	/* no texture until the image is loaded, drawing is updated afterwards */
+	if (GTS.async_load && BKE_image_load_async(ima, iuser))
+		return 0;
+
 	/* check if we have a valid image buffer */
 	ImBuf *ibuf = BKE_image_acquire_ibuf(ima, iuser, NULL);
 
@@ -1413,6 +1425,57 @@ void GPU_free_images_old(void)
 	}
 }
 
+static int gpu_image_lastused_cmp(const void *a_v, const void *b_v)
+{
+	const Image *a = *(const Image **)a_v;
+	const Image *b = *(const Image **)b_v;
+
+	return (a->lastused > b->lastused) - (a->lastused < b->lastused);
+}
+
+/**
+ * Free the GPU textures of the least recently used images
+ * until the texture memory is below #UserDef.texture_memory_limit.
+ * Images used in the last second are kept, even past the limit,
+ * so a working set larger than the limit doesn't re-upload every redraw.
+ */
+void GPU_free_images_over_limit(void)
+{
+	if (U.texture_memory_limit == 0 || G.is_rendering || G.main == NULL)
+		return;
+
+	const size_t limit = (size_t)U.texture_memory_limit * 1024 * 1024;
+
+	if (GPU_texture_memory_usage_get() <= limit)
+		return;
+
+	const int ctime = (int)PIL_check_seconds_timer();
+	int images_len = 0;
+
+	for (Image *ima = G.main->image.first; ima; ima = ima->id.next) {
+		images_len++;
+	}
+
+	Image **images = MEM_mallocN(sizeof(*images) * images_len, __func__);
+	images_len = 0;
+
+	for (Image *ima = G.main->image.first; ima; ima = ima->id.next) {
+		if ((ima->flag & IMA_NOCOLLECT) == 0 && ima->lastused < ctime - 1 &&
+		    (BKE_image_has_bindcode(ima) || ima->repbind))
+		{
+			images[images_len++] = ima;
+		}
+	}
+
+	qsort(images, images_len, sizeof(*images), gpu_image_lastused_cmp);
+
+	for (int i = 0; i < images_len && GPU_texture_memory_usage_get() > limit; i++) {
+		GPU_free_image(images[i]);
+	}
+
+	MEM_freeN(images);
+}
+
 
 /* OpenGL Materials */
 
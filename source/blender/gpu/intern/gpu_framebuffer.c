@@ -38,6 +38,7 @@
 #include "GPU_matrix.h"
 #include "GPU_shader.h"
 #include "GPU_texture.h"
+#include "GPU_viewport.h"
 
 static struct GPUFrameBufferGlobal {
 	GLuint currentfb;
@@ -605,6 +606,9 @@ struct GPUOffScreen {
 	GPUFrameBuffer *fb;
 	GPUTexture *color;
 	GPUTexture *depth;
+
+	/* Draw manager viewport wrapping this offscreen, owned. */
+	GPUViewport *viewport;
 };
 
 GPUOffScreen *GPU_offscreen_create(int width, int height, int samples, char err_out[256])
@@ -664,6 +668,12 @@ GPUOffScreen *GPU_offscreen_create(int width, int height, int samples, char err_
 
 void GPU_offscreen_free(GPUOffScreen *ofs)
 {
+	if (ofs->viewport) {
+		/* don't free data owned by 'ofs' twice */
+		GPU_viewport_clear_from_offscreen(ofs->viewport);
+		GPU_viewport_free(ofs->viewport);
+		MEM_freeN(ofs->viewport);
+	}
 	if (ofs->fb)
 		GPU_framebuffer_free(ofs->fb);
 	if (ofs->color)
@@ -793,3 +803,15 @@ void GPU_offscreen_viewport_data_get(
 	*r_color = ofs->color;
 	*r_depth = ofs->depth;
 }
+
+/**
+ * Viewport drawing into \a ofs, created on first use and kept until the offscreen is freed.
+ * This lets draw engines keep their buffers between renders (e.g. frames of an animation).
+ */
+GPUViewport *GPU_offscreen_viewport_ensure(GPUOffScreen *ofs)
+{
+	if (ofs->viewport == NULL) {
+		ofs->viewport = GPU_viewport_create_from_offscreen(ofs);
+	}
+	return ofs->viewport;
+}
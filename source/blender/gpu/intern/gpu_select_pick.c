@@ -56,6 +56,9 @@
 /* Z-depth of cleared depth buffer */
 #define DEPTH_MAX 0xffffffff
 
+/* Number of depth reads kept in flight before resolving the oldest one. */
+#define READBACK_LEN 8
+
 /* ----------------------------------------------------------------------------
  * SubRectStride
  */
@@ -258,6 +261,14 @@ typedef struct GPUPickState {
 		/* Set after first draw */
 		bool is_init;
 		unsigned int prev_id;
+
+		/* Depth reads are done into pixel buffers and resolved (in order) a few ID's later,
+		 * so reading the depth of one ID doesn't wait for the GPU to finish drawing it. */
+		struct {
+			GLuint pbo[READBACK_LEN];
+			unsigned int id[READBACK_LEN];
+			unsigned int first, len;
+		} readback;
 	} gl;
 
 	/* src: data stored in 'cache' and 'gl',
@@ -365,6 +376,15 @@ void gpu_select_pick_begin(
 
 		ps->gl.is_init = false;
 		ps->gl.prev_id = 0;
+
+		glGenBuffers(READBACK_LEN, ps->gl.readback.pbo);
+		for (unsigned int i = 0; i < READBACK_LEN; i++) {
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, ps->gl.readback.pbo[i]);
+			glBufferData(GL_PIXEL_PACK_BUFFER, sizeof(depth_t) * rect_len, NULL, GL_STREAM_READ);
+		}
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		ps->gl.readback.first = 0;
+		ps->gl.readback.len = 0;
 	}
 	else {
 		/* Using cache (ps->is_cached == true) */
@@ -478,43 +498,79 @@ static void gpu_select_load_id_pass_nearest(const DepthBufCache *rect_prev, cons
 }
 
 
-bool gpu_select_pick_load_id(unsigned int id)
+/**
+ * Resolve the oldest pending depth read, comparing it against the depth of the previous resolved one.
+ */
+static void gpu_select_pick_readback_resolve(void)
 {
 	GPUPickState *ps = &g_pick_state;
-	if (ps->gl.is_init) {
-		const unsigned int rect_len = ps->src.rect_len;
-		glReadPixels(UNPACK4(ps->gl.clip_readpixels), GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, ps->gl.rect_depth_test->buf);
-		/* perform initial check since most cases the array remains unchanged  */
+	const unsigned int rect_len = ps->src.rect_len;
+	const unsigned int slot = ps->gl.readback.first;
 
-		bool do_pass = false;
-		if (g_pick_state.mode == GPU_SELECT_PICK_ALL) {
-			if (depth_buf_rect_depth_any(ps->gl.rect_depth_test, rect_len)) {
-				ps->gl.rect_depth_test->id = ps->gl.prev_id;
-				gpu_select_load_id_pass_all(ps->gl.rect_depth_test);
-				do_pass = true;
-			}
+	BLI_assert(ps->gl.readback.len != 0);
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, ps->gl.readback.pbo[slot]);
+	const depth_t *buf = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, sizeof(depth_t) * rect_len, GL_MAP_READ_BIT);
+	if (buf != NULL) {
+		memcpy(ps->gl.rect_depth_test->buf, buf, sizeof(depth_t) * rect_len);
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	else {
+		/* Should never happen, don't add a pass for this ID. */
+		memcpy(ps->gl.rect_depth_test->buf, ps->gl.rect_depth->buf, sizeof(depth_t) * rect_len);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	ps->gl.readback.first = (slot + 1) % READBACK_LEN;
+	ps->gl.readback.len--;
+
+	/* perform initial check since most cases the array remains unchanged  */
+	bool do_pass = false;
+	if (g_pick_state.mode == GPU_SELECT_PICK_ALL) {
+		if (depth_buf_rect_depth_any(ps->gl.rect_depth_test, rect_len)) {
+			ps->gl.rect_depth_test->id = ps->gl.readback.id[slot];
+			gpu_select_load_id_pass_all(ps->gl.rect_depth_test);
+			do_pass = true;
 		}
-		else {
-			if (depth_buf_rect_depth_any_filled(ps->gl.rect_depth, ps->gl.rect_depth_test, rect_len)) {
-				ps->gl.rect_depth_test->id = ps->gl.prev_id;
-				gpu_select_load_id_pass_nearest(ps->gl.rect_depth, ps->gl.rect_depth_test);
-				do_pass = true;
-			}
+	}
+	else {
+		if (depth_buf_rect_depth_any_filled(ps->gl.rect_depth, ps->gl.rect_depth_test, rect_len)) {
+			ps->gl.rect_depth_test->id = ps->gl.readback.id[slot];
+			gpu_select_load_id_pass_nearest(ps->gl.rect_depth, ps->gl.rect_depth_test);
+			do_pass = true;
 		}
+	}
 
-		if (do_pass) {
-			/* Store depth in cache */
-			if (ps->use_cache) {
-				BLI_addtail(&ps->cache.bufs, ps->gl.rect_depth);
-				ps->gl.rect_depth = depth_buf_malloc(ps->src.rect_len);
-			}
+	if (do_pass) {
+		/* Store depth in cache */
+		if (ps->use_cache) {
+			BLI_addtail(&ps->cache.bufs, ps->gl.rect_depth);
+			ps->gl.rect_depth = depth_buf_malloc(ps->src.rect_len);
+		}
 
-			SWAP(DepthBufCache *, ps->gl.rect_depth, ps->gl.rect_depth_test);
+		SWAP(DepthBufCache *, ps->gl.rect_depth, ps->gl.rect_depth_test);
+	}
+}
 
-			if (g_pick_state.mode == GPU_SELECT_PICK_ALL) {
-				/* we want new depths every time */
-				glClear(GL_DEPTH_BUFFER_BIT);
-			}
+bool gpu_select_pick_load_id(unsigned int id)
+{
+	GPUPickState *ps = &g_pick_state;
+	if (ps->gl.is_init) {
+		if (ps->gl.readback.len == READBACK_LEN) {
+			gpu_select_pick_readback_resolve();
+		}
+
+		const unsigned int slot = (ps->gl.readback.first + ps->gl.readback.len) % READBACK_LEN;
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, ps->gl.readback.pbo[slot]);
+		glReadPixels(UNPACK4(ps->gl.clip_readpixels), GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, NULL);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		ps->gl.readback.id[slot] = ps->gl.prev_id;
+		ps->gl.readback.len++;
+
+		if (g_pick_state.mode == GPU_SELECT_PICK_ALL) {
+			/* we want new depths every time,
+			 * when nothing was drawn this clears an already cleared buffer */
+			glClear(GL_DEPTH_BUFFER_BIT);
 		}
 	}
 
@@ -538,6 +594,12 @@ unsigned int gpu_select_pick_end(void)
 			gpu_select_pick_load_id(ps->gl.prev_id);
 		}
 
+		while (ps->gl.readback.len != 0) {
+			gpu_select_pick_readback_resolve();
+		}
+		glDeleteBuffers(READBACK_LEN, ps->gl.readback.pbo);
+		memset(ps->gl.readback.pbo, 0, sizeof(ps->gl.readback.pbo));
+
 		gpuPopAttrib();
 		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 	}
@@ -28,9 +28,15 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_utildefines.h"
+#include "BLI_dynstr.h"
+#include "BLI_fileops.h"
+#include "BLI_hash_md5.h"
 #include "BLI_math_base.h"
 #include "BLI_math_vector.h"
+#include "BLI_path_util.h"
+#include "BLI_string.h"
 
+#include "BKE_appdir.h"
 #include "BKE_global.h"
 
 #include "GPU_compositing.h"
@@ -253,6 +259,135 @@ static void gpu_shader_standard_defines(char defines[MAX_DEFINE_LENGTH],
 	return;
 }
 
+/* -------------------------------------------------------------------- */
+
+/** \name Program Binary Cache
+ *
+ * Linked programs of generated (material) shaders are stored on disk,
+ * keyed by a hash of all their sources and of the GL driver,
+ * so the next time the same shader is needed (e.g. the next session) compiling is skipped.
+ * \{ */
+
+#define SHADER_CACHE_DIRNAME "blender_shader_cache"
+/* Bump when the file layout changes. */
+#define SHADER_CACHE_MAGIC 0x31434853 /* 'SHC1' */
+
+typedef struct ShaderCacheHeader {
+	unsigned int magic;
+	unsigned int format;
+	unsigned int len;
+} ShaderCacheHeader;
+
+static bool gpu_shader_binary_cache_supported(void)
+{
+	return (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary);
+}
+
+static void gpu_shader_binary_cache_path(
+        const char **sources, int sources_len, char r_path[FILE_MAX])
+{
+	DynStr *ds = BLI_dynstr_new();
+	unsigned char digest[16];
+	char hexdigest[33];
+	char filename[FILE_MAXFILE];
+
+	/* A binary is only valid for the driver that produced it. */
+	BLI_dynstr_append(ds, (const char *)glGetString(GL_VENDOR));
+	BLI_dynstr_append(ds, (const char *)glGetString(GL_RENDERER));
+	BLI_dynstr_append(ds, (const char *)glGetString(GL_VERSION));
+
+	for (int i = 0; i < sources_len; i++) {
+		/* Separate stages, so moving code between them changes the hash. */
+		BLI_dynstr_append(ds, "\n//\n");
+		if (sources[i]) {
+			BLI_dynstr_append(ds, sources[i]);
+		}
+	}
+
+	const int len = BLI_dynstr_get_len(ds);
+	char *str = BLI_dynstr_get_cstring(ds);
+	BLI_dynstr_free(ds);
+
+	BLI_hash_md5_buffer(str, (size_t)len, digest);
+	MEM_freeN(str);
+
+	BLI_snprintf(filename, sizeof(filename), "%s.bin", BLI_hash_md5_to_hexdigest(digest, hexdigest));
+	BLI_join_dirfile(r_path, FILE_MAX, BKE_tempdir_base(), SHADER_CACHE_DIRNAME);
+	BLI_path_append(r_path, FILE_MAX, filename);
+}
+
+/* Return true when the program was linked from the cached binary. */
+static bool gpu_shader_binary_cache_load(GLuint program, const char *filepath)
+{
+	FILE *fp = BLI_fopen(filepath, "rb");
+	ShaderCacheHeader header;
+	bool ok = false;
+
+	if (fp == NULL) {
+		return false;
+	}
+
+	if (fread(&header, sizeof(header), 1, fp) == 1 &&
+	    header.magic == SHADER_CACHE_MAGIC &&
+	    header.len != 0)
+	{
+		void *data = MEM_mallocN(header.len, __func__);
+		if (fread(data, header.len, 1, fp) == 1) {
+			GLint status;
+			glProgramBinary(program, header.format, data, (GLsizei)header.len);
+			glGetProgramiv(program, GL_LINK_STATUS, &status);
+			/* Drivers may reject binaries (e.g. after an update), compile normally then. */
+			ok = (status == GL_TRUE);
+		}
+		MEM_freeN(data);
+	}
+
+	fclose(fp);
+
+	return ok;
+}
+
+static void gpu_shader_binary_cache_save(GLuint program, const char *filepath)
+{
+	GLint len = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &len);
+	if (len <= 0) {
+		return;
+	}
+
+	char dirpath[FILE_MAX];
+	BLI_split_dir_part(filepath, dirpath, sizeof(dirpath));
+	if (!BLI_is_dir(dirpath) && !BLI_dir_create_recursive(dirpath)) {
+		return;
+	}
+
+	void *data = MEM_mallocN((size_t)len, __func__);
+	ShaderCacheHeader header = {SHADER_CACHE_MAGIC, 0, 0};
+	GLenum format;
+	GLsizei data_len = 0;
+
+	glGetProgramBinary(program, len, &data_len, &format, data);
+
+	if (data_len > 0) {
+		header.format = format;
+		header.len = (unsigned int)data_len;
+
+		FILE *fp = BLI_fopen(filepath, "wb");
+		if (fp) {
+			bool ok = (fwrite(&header, sizeof(header), 1, fp) == 1 &&
+			           fwrite(data, (size_t)data_len, 1, fp) == 1);
+			fclose(fp);
+			if (!ok) {
+				BLI_delete(filepath, false, false);
+			}
+		}
+	}
+
+	MEM_freeN(data);
+}
+
+/** \} */
+
 GPUShader *GPU_shader_create(const char *vertexcode,
                              const char *fragcode,
                              const char *geocode,
@@ -313,6 +448,24 @@ GPUShader *GPU_shader_create_ex(const char *vertexcode,
 	                            (flags & GPU_SHADER_FLAGS_NEW_SHADING) != 0);
 	gpu_shader_standard_extensions(standard_extensions);
 
+	/* Opensubdiv binds attribute locations before linking, not worth caching. */
+	const bool use_binary_cache = (flags & GPU_SHADER_FLAGS_BINARY_CACHE) && !use_opensubdiv &&
+	                              gpu_shader_binary_cache_supported();
+	char binary_cache_path[FILE_MAX];
+
+	if (use_binary_cache) {
+		const char *sources[] = {
+		    gpu_shader_version(), standard_extensions, standard_defines,
+		    defines, vertexcode, geocode, libcode, fragcode,
+		};
+		gpu_shader_binary_cache_path(sources, ARRAY_SIZE(sources), binary_cache_path);
+
+		if (gpu_shader_binary_cache_load(shader->program, binary_cache_path)) {
+			shader->interface = GWN_shaderinterface_create(shader->program);
+			return shader;
+		}
+	}
+
 	if (vertexcode) {
 		const char *source[5];
 		/* custom limit, may be too small, beware */
@@ -412,6 +565,10 @@ GPUShader *GPU_shader_create_ex(const char *vertexcode,
 	}
 #endif
 
+	if (use_binary_cache) {
+		glProgramParameteri(shader->program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+
 	glLinkProgram(shader->program);
 	glGetProgramiv(shader->program, GL_LINK_STATUS, &status);
 	if (!status) {
@@ -426,6 +583,10 @@ GPUShader *GPU_shader_create_ex(const char *vertexcode,
 		return NULL;
 	}
 
+	if (use_binary_cache) {
+		gpu_shader_binary_cache_save(shader->program, binary_cache_path);
+	}
+
 	shader->interface = GWN_shaderinterface_create(shader->program);
 
 #ifdef WITH_OPENSUBDIV
@@ -34,6 +34,7 @@
 #include "BLI_math_base.h"
 
 #include "BKE_global.h"
+#include "BKE_image.h"
 
 #include "GPU_debug.h"
 #include "GPU_draw.h"
@@ -529,6 +530,8 @@ GPUTexture *GPU_texture_from_blender(Image *ima, ImageUser *iuser, int textarget
 	/* this binds a texture, so that's why to restore it to 0 */
 	GLint bindcode = GPU_verify_image(ima, iuser, textarget, 0, 0, mipmap, is_data);
 	GPU_update_image_time(ima, time);
+	/* Access time of the GPU texture, see GPU_free_images_over_limit. */
+	BKE_image_tag_time(ima);
 
 	/* see GPUInput::textarget: it can take two values - GL_TEXTURE_2D and GL_TEXTURE_CUBE_MAP
 	 * these values are correct for glDisable, so textarget can be safely used in
@@ -569,11 +572,23 @@ GPUTexture *GPU_texture_from_blender(Image *ima, ImageUser *iuser, int textarget
 		else
 			gettarget = GL_TEXTURE_CUBE_MAP_POSITIVE_X;
 
+		GLint internal_format;
+
 		glBindTexture(textarget, tex->bindcode);
 		glGetTexLevelParameteriv(gettarget, 0, GL_TEXTURE_WIDTH, &w);
 		glGetTexLevelParameteriv(gettarget, 0, GL_TEXTURE_HEIGHT, &h);
+		glGetTexLevelParameteriv(gettarget, 0, GL_TEXTURE_INTERNAL_FORMAT, &internal_format);
 		tex->w = w;
 		tex->h = h;
+
+		/* Counted in the memory usage so GPU_free_images_over_limit can see images. */
+		switch (internal_format) {
+			case GL_RGBA16:
+			case GL_RGBA16F: tex->bytesize = 8; break;
+			case GL_RGBA32F: tex->bytesize = 16; break;
+			default: tex->bytesize = 4; break;
+		}
+		gpu_texture_memory_footprint_add(tex);
 	}
 
 	glBindTexture(textarget, 0);
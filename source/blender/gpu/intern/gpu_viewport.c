@@ -34,6 +34,7 @@
 #include <string.h>
 
 #include "BLI_listbase.h"
+#include "BLI_math_matrix.h"
 #include "BLI_rect.h"
 #include "BLI_string.h"
 
@@ -41,9 +42,12 @@
 
 #include "BKE_global.h"
 
+#include "GPU_compositing.h"
 #include "GPU_framebuffer.h"
 #include "GPU_glew.h"
 #include "GPU_immediate.h"
+#include "GPU_matrix.h"
+#include "GPU_shader.h"
 #include "GPU_texture.h"
 #include "GPU_viewport.h"
 
@@ -79,12 +83,23 @@ struct GPUViewport {
 	DefaultTextureList *txl;
 
 	ListBase tex_pool;  /* ViewportTempTexture list : Temporary textures shared across draw engines */
+
+	/* Temporal accumulation of the color buffer, see GPU_viewport_history_accumulate. */
+	GPUFrameBuffer *history_fb;
+	GPUTexture *history;
+	int history_samples;  /* Number of samples accumulated in history, 0 if invalid */
+	float history_persmat[4][4];  /* View of the accumulated samples */
+
+	/* Depth of the last redraw, see GPU_viewport_depth_draw. */
+	bool depth_valid;
+	float depth_persmat[4][4];  /* View of the depth buffer */
 };
 
 static void gpu_viewport_buffers_free(FramebufferList *fbl, int fbl_len, TextureList *txl, int txl_len);
 static void gpu_viewport_storage_free(StorageList *stl, int stl_len);
 static void gpu_viewport_passes_free(PassList *psl, int psl_len);
 static void gpu_viewport_texture_pool_free(GPUViewport *viewport);
+static void gpu_viewport_history_free(GPUViewport *viewport);
 
 GPUViewport *GPU_viewport_create(void)
 {
@@ -324,6 +339,8 @@ void GPU_viewport_bind(GPUViewport *viewport, const rcti *rect)
 			}
 
 			gpu_viewport_texture_pool_free(viewport);
+			gpu_viewport_history_free(viewport);
+			viewport->depth_valid = false;
 		}
 	}
 
@@ -497,6 +514,7 @@ void GPU_viewport_free(GPUViewport *viewport)
 	        (TextureList *)viewport->txl, default_txl_len);
 
 	gpu_viewport_texture_pool_free(viewport);
+	gpu_viewport_history_free(viewport);
 
 	MEM_freeN(viewport->fbl);
 	MEM_freeN(viewport->txl);
@@ -504,6 +522,213 @@ void GPU_viewport_free(GPUViewport *viewport)
 	GPU_viewport_debug_depth_free(viewport);
 }
 
+/****************** temporal accumulation ********************/
+
+static void gpu_viewport_history_free(GPUViewport *viewport)
+{
+	if (viewport->history_fb) {
+		GPU_framebuffer_free(viewport->history_fb);
+		viewport->history_fb = NULL;
+	}
+	if (viewport->history) {
+		GPU_texture_free(viewport->history);
+		viewport->history = NULL;
+	}
+	viewport->history_samples = 0;
+}
+
+/**
+ * Number of samples accumulated so far for the view \a persmat.
+ * Accumulation restarts from 0 when the view changed since the last call.
+ */
+int GPU_viewport_history_samples_get(GPUViewport *viewport, const float persmat[4][4])
+{
+	if (viewport->history == NULL || !equals_m4m4(viewport->history_persmat, persmat)) {
+		viewport->history_samples = 0;
+	}
+	copy_m4_m4(viewport->history_persmat, persmat);
+
+	return viewport->history_samples;
+}
+
+void GPU_viewport_history_reset(GPUViewport *viewport)
+{
+	viewport->history_samples = 0;
+}
+
+/* Fullscreen quad, expects identity matrices. */
+static void gpu_viewport_texture_draw(GPUTexture *tex)
+{
+	Gwn_VertFormat *format = immVertexFormat();
+	unsigned int texcoord = GWN_vertformat_attr_add(format, "texCoord", GWN_COMP_F32, 2, GWN_FETCH_FLOAT);
+	unsigned int pos = GWN_vertformat_attr_add(format, "pos", GWN_COMP_F32, 2, GWN_FETCH_FLOAT);
+
+	immBindBuiltinProgram(GPU_SHADER_3D_IMAGE_MODULATE_ALPHA);
+	GPU_texture_bind(tex, 0);
+
+	immUniform1i("image", 0); /* default GL_TEXTURE0 unit */
+	immUniform1f("alpha", 1.0f);
+
+	immBegin(GWN_PRIM_TRI_STRIP, 4);
+
+	immAttrib2f(texcoord, 0.0f, 0.0f);
+	immVertex2f(pos, -1.0f, -1.0f);
+
+	immAttrib2f(texcoord, 1.0f, 0.0f);
+	immVertex2f(pos, 1.0f, -1.0f);
+
+	immAttrib2f(texcoord, 0.0f, 1.0f);
+	immVertex2f(pos, -1.0f, 1.0f);
+
+	immAttrib2f(texcoord, 1.0f, 1.0f);
+	immVertex2f(pos, 1.0f, 1.0f);
+
+	immEnd();
+
+	GPU_texture_unbind(tex);
+
+	immUnbindProgram();
+}
+
+/**
+ * Add the viewport color buffer to the running average of the previous samples
+ * and replace the color buffer by the result. Leaves the default framebuffer bound.
+ */
+void GPU_viewport_history_accumulate(GPUViewport *viewport)
+{
+	DefaultFramebufferList *dfbl = viewport->fbl;
+	DefaultTextureList *dtxl = viewport->txl;
+
+	if (viewport->history == NULL) {
+		/* Half float so the average of many samples doesn't band. */
+		viewport->history = GPU_texture_create_2D_custom(
+		        GPU_texture_width(dtxl->color), GPU_texture_height(dtxl->color), 4, GPU_RGBA16F, NULL, NULL);
+		viewport->history_fb = GPU_framebuffer_create();
+
+		if (!viewport->history || !viewport->history_fb ||
+		    !GPU_framebuffer_texture_attach(viewport->history_fb, viewport->history, 0, 0))
+		{
+			gpu_viewport_history_free(viewport);
+			return;
+		}
+	}
+
+	/* The new sample weights 1 / (n + 1), first sample overwrites the history. */
+	const float weight = 1.0f / (float)(viewport->history_samples + 1);
+
+	gpuPushProjectionMatrix();
+	gpuLoadIdentityProjectionMatrix();
+	gpuPushMatrix();
+	gpuLoadIdentity();
+
+	glDisable(GL_DEPTH_TEST);
+	glDepthMask(GL_FALSE);
+
+	GPU_framebuffer_bind(viewport->history_fb);
+	glEnable(GL_BLEND);
+	glBlendColor(0.0f, 0.0f, 0.0f, weight);
+	glBlendFunc(GL_CONSTANT_ALPHA, GL_ONE_MINUS_CONSTANT_ALPHA);
+	gpu_viewport_texture_draw(dtxl->color);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glDisable(GL_BLEND);
+
+	GPU_framebuffer_bind(dfbl->default_fb);
+	gpu_viewport_texture_draw(viewport->history);
+
+	glDepthMask(GL_TRUE);
+
+	gpuPopMatrix();
+	gpuPopProjectionMatrix();
+
+	viewport->history_samples++;
+}
+
+/****************** depth reuse ********************/
+
+/**
+ * Mark the viewport depth buffer as a complete depth of the scene seen from \a persmat,
+ * pass NULL when the content of the depth buffer can't be reused.
+ */
+void GPU_viewport_depth_tag(GPUViewport *viewport, const float persmat[4][4])
+{
+	if (persmat) {
+		copy_m4_m4(viewport->depth_persmat, persmat);
+	}
+	viewport->depth_valid = (persmat != NULL);
+}
+
+/**
+ * Write the depth of the last redraw into the bound framebuffer,
+ * avoids redrawing the whole scene when only the depth is needed (picking, auto-depth).
+ *
+ * \return false when the depth is not from the \a persmat view or the size differs,
+ * nothing is drawn in this case.
+ */
+bool GPU_viewport_depth_draw(GPUViewport *viewport, const float persmat[4][4], const int size[2])
+{
+	DefaultTextureList *dtxl = viewport->txl;
+
+	if (!viewport->depth_valid || dtxl->depth == NULL ||
+	    viewport->size[0] != size[0] || viewport->size[1] != size[1] ||
+	    !equals_m4m4(viewport->depth_persmat, persmat))
+	{
+		return false;
+	}
+
+	GPUShader *shader = GPU_shader_get_builtin_fx_shader(GPU_SHADER_FX_DEPTH_RESOLVE, false);
+	if (shader == NULL) {
+		return false;
+	}
+
+	Gwn_VertFormat *format = immVertexFormat();
+	unsigned int uvs = GWN_vertformat_attr_add(format, "uvs", GWN_COMP_F32, 2, GWN_FETCH_FLOAT);
+	unsigned int pos = GWN_vertformat_attr_add(format, "pos", GWN_COMP_F32, 2, GWN_FETCH_FLOAT);
+
+	gpuPushProjectionMatrix();
+	gpuLoadIdentityProjectionMatrix();
+	gpuPushMatrix();
+	gpuLoadIdentity();
+
+	/* Depth only, always overwrite. */
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+	glEnable(GL_DEPTH_TEST);
+	glDepthFunc(GL_ALWAYS);
+	glDepthMask(GL_TRUE);
+
+	immBindProgram(GPU_shader_get_program(shader), GPU_shader_get_interface(shader));
+
+	GPU_texture_bind(dtxl->depth, 0);
+	immUniform1i("depthbuffer", 0);
+
+	immBegin(GWN_PRIM_TRI_STRIP, 4);
+
+	immAttrib2f(uvs, 0.0f, 0.0f);
+	immVertex2f(pos, -1.0f, -1.0f);
+
+	immAttrib2f(uvs, 1.0f, 0.0f);
+	immVertex2f(pos, 1.0f, -1.0f);
+
+	immAttrib2f(uvs, 0.0f, 1.0f);
+	immVertex2f(pos, -1.0f, 1.0f);
+
+	immAttrib2f(uvs, 1.0f, 1.0f);
+	immVertex2f(pos, 1.0f, 1.0f);
+
+	immEnd();
+
+	GPU_texture_unbind(dtxl->depth);
+
+	immUnbindProgram();
+
+	glDepthFunc(GL_LEQUAL);
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+	gpuPopMatrix();
+	gpuPopProjectionMatrix();
+
+	return true;
+}
+
 /****************** debug ********************/
 
 bool GPU_viewport_debug_depth_create(GPUViewport *viewport, int width, int height, char err_out[256])
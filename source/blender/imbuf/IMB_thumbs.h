@@ -87,6 +87,9 @@ void IMB_thumb_makedirs(void);
 ImBuf *IMB_thumb_load_blend(const char *blen_path, const char *blen_group, const char *blen_id);
 void   IMB_thumb_overlay_blend(unsigned int *thumb, int width, int height, float aspect);
 
+/* load an image to make a thumbnail from, decoded at a reduced resolution when the format allows */
+ImBuf *IMB_thumb_load_image(const char *filepath, size_t max_thumb_size, size_t *r_width, size_t *r_height);
+
 /* special function for previewing fonts */
 ImBuf *IMB_thumb_load_font(const char *filename, unsigned int x, unsigned int y);
 bool IMB_thumb_load_font_get_hash(char *r_hash);
@@ -43,6 +43,9 @@ typedef struct ImFileType {
 	int (*ftype)(const struct ImFileType *type, struct ImBuf *ibuf);
 	struct ImBuf *(*load)(const unsigned char *mem, size_t size, int flags, char colorspace[IM_MAX_SPACE]);
 	struct ImBuf *(*load_filepath)(const char *name, int flags, char colorspace[IM_MAX_SPACE]);
+	/* Optional, decode at a reduced resolution of at least max_thumb_size, returns the full size. */
+	struct ImBuf *(*load_thumbnail)(const unsigned char *mem, size_t size, int flags, size_t max_thumb_size,
+	                                char colorspace[IM_MAX_SPACE], size_t *r_width, size_t *r_height);
 	int (*save)(struct ImBuf *ibuf, const char *name, int flags);
 	void (*load_tile)(struct ImBuf *ibuf, const unsigned char *mem, size_t size, int tx, int ty, unsigned int *rect);
 
@@ -89,6 +92,8 @@ int imb_savejp2(struct ImBuf *ibuf, const char *name, int flags);
 int imb_is_a_jpeg(const unsigned char *mem);
 int imb_savejpeg(struct ImBuf *ibuf, const char *name, int flags);
 struct ImBuf *imb_load_jpeg(const unsigned char *buffer, size_t size, int flags, char colorspace[IM_MAX_SPACE]);
+struct ImBuf *imb_thumbnail_jpeg(const unsigned char *buffer, size_t size, int flags, size_t max_thumb_size,
+                                 char colorspace[IM_MAX_SPACE], size_t *r_width, size_t *r_height);
 
 /* bmp */
 int imb_is_a_bmp(const unsigned char *buf);
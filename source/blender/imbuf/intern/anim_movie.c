@@ -64,6 +64,7 @@
 #include "BLI_utildefines.h"
 #include "BLI_string.h"
 #include "BLI_path_util.h"
+#include "BLI_threads.h"
 
 #include "MEM_guardedalloc.h"
 
@@ -509,6 +510,12 @@ static int startffmpeg(struct anim *anim)
 
 	pCodecCtx->workaround_bugs = 1;
 
+	/* Decode with all threads, frame threading delays the output by a frame
+	 * per thread but the decoding loop below already handles delayed frames
+	 * for B-frames, and drains them at the end of the stream. */
+	pCodecCtx->thread_count = BLI_system_thread_count();
+	pCodecCtx->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+
 	if (avcodec_open2(pCodecCtx, pCodec, NULL) < 0) {
 		avformat_close_input(&pFormatCtx);
 		return -1;
@@ -130,6 +130,37 @@ static struct global_glsl_state {
 	struct OCIO_GLSLDrawState *transform_ocio_glsl_state;
 } global_glsl_state;
 
+/* Display transform baked into a 3D LUT, used for display buffers. */
+typedef struct DisplayLUT {
+	/* Settings of processor for comparison. */
+	char look[MAX_COLORSPACE_NAME];
+	char view[MAX_COLORSPACE_NAME];
+	char display[MAX_COLORSPACE_NAME];
+	float exposure, gamma;
+
+	/* False when the LUT is not accurate enough for these settings. */
+	bool valid;
+
+	/* RGB result for every lattice point, red varying fastest. */
+	float *table;
+
+	/* Number of display buffer updates using the LUT, it is only freed
+	 * once it's not used and has been replaced by a LUT for other settings.
+	 */
+	int users;
+} DisplayLUT;
+
+static DisplayLUT *global_display_lut = NULL;
+static pthread_mutex_t display_lut_lock = BLI_MUTEX_INITIALIZER;
+
+static void display_lut_free(DisplayLUT *lut)
+{
+	if (lut->table)
+		MEM_freeN(lut->table);
+
+	MEM_freeN(lut);
+}
+
 /*********************** Color managed cache *************************/
 
 /* Cache Implementation Notes
@@ -697,6 +728,11 @@ void colormanagement_exit(void)
 	if (global_glsl_state.transform_ocio_glsl_state)
 		OCIO_freeOGLState(global_glsl_state.transform_ocio_glsl_state);
 
+	if (global_display_lut) {
+		display_lut_free(global_display_lut);
+		global_display_lut = NULL;
+	}
+
 	colormanage_free_config();
 }
 
@@ -1246,10 +1282,314 @@ const char *IMB_colormanagement_get_rect_colorspace(ImBuf *ibuf)
 	}
 }
 
+/*********************** Baked display transform routines *************************/
+
+/* Display buffers are only drawn, so instead of running the OCIO processor for
+ * every pixel of them, the display transform is baked into a 3D LUT which is
+ * much cheaper to evaluate.
+ *
+ * Lattice points are spaced by log2(1 + x / toe), so black is exact, dark
+ * values are spaced linearly and bright values keep the same precision over
+ * many stops. There is a lattice point at 1.0 exactly, so view transforms which
+ * clip there are interpolated without error. Values outside of [0, ~147] are
+ * clamped. After baking
+ * the LUT is compared to the processor between lattice points, and only used
+ * when it matches to within half a byte step. Otherwise, as for view transforms
+ * which are close to linear, the processor is used as before.
+ *
+ * Baking costs about as much as transforming a quarter million pixels, so a
+ * LUT is only baked for big images, but once baked it is reused for all
+ * display buffers until the settings change.
+ */
+
+#define DISPLAY_LUT_SIZE 65
+#define DISPLAY_LUT_TOE (1.0f / 4096.0f)
+#define DISPLAY_LUT_COORD_ONE 40
+#define DISPLAY_LUT_TOLERANCE (0.5f / 255.0f)
+#define DISPLAY_LUT_VERIFY_STEP 4
+#define DISPLAY_LUT_MIN_PIXELS (1024 * 1024)
+
+BLI_INLINE float display_lut_shaper_scale(void)
+{
+	return DISPLAY_LUT_COORD_ONE / log2f(1.0f + 1.0f / DISPLAY_LUT_TOE);
+}
+
+/* Lattice coordinate of a scene linear value. */
+BLI_INLINE float display_lut_shaper(float value, float scale)
+{
+	/* Written to also catch NaN. */
+	if (!(value > 0.0f))
+		return 0.0f;
+
+	return min_ff(log2f(1.0f + value * (1.0f / DISPLAY_LUT_TOE)) * scale, (float)(DISPLAY_LUT_SIZE - 1));
+}
+
+/* Scene linear value of a lattice coordinate. */
+static float display_lut_shaper_inverse(float coord, float scale)
+{
+	return (exp2f(coord / scale) - 1.0f) * DISPLAY_LUT_TOE;
+}
+
+BLI_INLINE void display_lut_evaluate(const DisplayLUT *lut, float scale, float rgb[3])
+{
+	const size_t stride_g = 3 * DISPLAY_LUT_SIZE;
+	const size_t stride_b = stride_g * DISPLAY_LUT_SIZE;
+	const float *p;
+	float frac[3];
+	int index[3], c;
+
+	for (c = 0; c < 3; c++) {
+		float coord = display_lut_shaper(rgb[c], scale);
+
+		index[c] = min_ii((int)coord, DISPLAY_LUT_SIZE - 2);
+		frac[c] = coord - (float)index[c];
+	}
+
+	p = lut->table + index[2] * stride_b + index[1] * stride_g + index[0] * 3;
+
+	/* Trilinear interpolation. */
+	for (c = 0; c < 3; c++) {
+		const float *p0 = p + c, *p1 = p0 + stride_b;
+		float c00 = p0[0] + (p0[3] - p0[0]) * frac[0];
+		float c10 = p0[stride_g] + (p0[stride_g + 3] - p0[stride_g]) * frac[0];
+		float c01 = p1[0] + (p1[3] - p1[0]) * frac[0];
+		float c11 = p1[stride_g] + (p1[stride_g + 3] - p1[stride_g]) * frac[0];
+		float c0 = c00 + (c10 - c00) * frac[1];
+		float c1 = c01 + (c11 - c01) * frac[1];
+
+		rgb[c] = c0 + (c1 - c0) * frac[2];
+	}
+}
+
+/* Same as IMB_colormanagement_processor_apply_pixel, with the OCIO processor
+ * replaced by the LUT. */
+BLI_INLINE void display_lut_apply_pixel(const DisplayLUT *lut, ColormanageProcessor *cm_processor,
+                                        float scale, float *pixel, int channels, bool predivide)
+{
+	if (cm_processor->curve_mapping)
+		curve_mapping_apply_pixel(cm_processor->curve_mapping, pixel, channels);
+
+	if (channels == 4 && predivide && pixel[3] != 1.0f && pixel[3] != 0.0f) {
+		float alpha = pixel[3];
+
+		mul_v3_fl(pixel, 1.0f / alpha);
+		display_lut_evaluate(lut, scale, pixel);
+		mul_v3_fl(pixel, alpha);
+	}
+	else if (channels >= 3) {
+		display_lut_evaluate(lut, scale, pixel);
+	}
+}
+
+static void display_lut_apply(const DisplayLUT *lut, ColormanageProcessor *cm_processor,
+                              float *buffer, int width, int height, int channels, bool predivide)
+{
+	const float scale = display_lut_shaper_scale();
+	const size_t i_last = ((size_t)width) * height;
+	size_t i;
+	float *fp;
+
+	for (i = 0, fp = buffer; i != i_last; i++, fp += channels) {
+		display_lut_apply_pixel(lut, cm_processor, scale, fp, channels, predivide);
+	}
+}
+
+typedef struct DisplayLUTBakeData {
+	OCIO_ConstProcessorRcPtr *processor;
+	float *table;
+} DisplayLUTBakeData;
+
+static void display_lut_bake_thread_do(void *data_v, int start_scanline, int num_scanlines)
+{
+	DisplayLUTBakeData *data = (DisplayLUTBakeData *)data_v;
+	const float scale = display_lut_shaper_scale();
+	const size_t slice_size = 3 * DISPLAY_LUT_SIZE * DISPLAY_LUT_SIZE;
+	float *slice = data->table + start_scanline * slice_size;
+	float lattice[DISPLAY_LUT_SIZE];
+	OCIO_PackedImageDesc *img;
+	int r, g, b;
+	float *fp;
+
+	for (r = 0; r < DISPLAY_LUT_SIZE; r++) {
+		lattice[r] = display_lut_shaper_inverse((float)r, scale);
+	}
+
+	/* Every scanline is a slice of constant blue. */
+	for (b = start_scanline, fp = slice; b < start_scanline + num_scanlines; b++) {
+		for (g = 0; g < DISPLAY_LUT_SIZE; g++) {
+			for (r = 0; r < DISPLAY_LUT_SIZE; r++, fp += 3) {
+				fp[0] = lattice[r];
+				fp[1] = lattice[g];
+				fp[2] = lattice[b];
+			}
+		}
+	}
+
+	img = OCIO_createOCIO_PackedImageDesc(
+	        slice, DISPLAY_LUT_SIZE, DISPLAY_LUT_SIZE * num_scanlines, 3, sizeof(float),
+	        3 * sizeof(float), 3 * sizeof(float) * DISPLAY_LUT_SIZE);
+	OCIO_processorApply(data->processor, img);
+	OCIO_PackedImageDescRelease(img);
+}
+
+/* Check the LUT against the processor at the centers of lattice cells, where
+ * interpolation is least accurate. */
+static bool display_lut_verify(const DisplayLUT *lut, OCIO_ConstProcessorRcPtr *processor)
+{
+	const float scale = display_lut_shaper_scale();
+	const int num_steps = (DISPLAY_LUT_SIZE - 1) / DISPLAY_LUT_VERIFY_STEP;
+	const size_t num_samples = (size_t)num_steps * num_steps * num_steps;
+	float *samples = MEM_mallocN(2 * 3 * num_samples * sizeof(float), "display LUT verify samples");
+	float *expected = samples + 3 * num_samples;
+	float *fp;
+	OCIO_PackedImageDesc *img;
+	bool valid = true;
+	int r, g, b;
+	size_t i;
+
+	for (b = 0, fp = samples; b < num_steps; b++) {
+		for (g = 0; g < num_steps; g++) {
+			for (r = 0; r < num_steps; r++, fp += 3) {
+				fp[0] = display_lut_shaper_inverse(r * DISPLAY_LUT_VERIFY_STEP + 0.5f, scale);
+				fp[1] = display_lut_shaper_inverse(g * DISPLAY_LUT_VERIFY_STEP + 0.5f, scale);
+				fp[2] = display_lut_shaper_inverse(b * DISPLAY_LUT_VERIFY_STEP + 0.5f, scale);
+			}
+		}
+	}
+
+	memcpy(expected, samples, 3 * num_samples * sizeof(float));
+
+	img = OCIO_createOCIO_PackedImageDesc(
+	        expected, (long)num_samples, 1, 3, sizeof(float),
+	        3 * sizeof(float), 3 * sizeof(float) * num_samples);
+	OCIO_processorApply(processor, img);
+	OCIO_PackedImageDescRelease(img);
+
+	for (i = 0; i < 3 * num_samples; i += 3) {
+		display_lut_evaluate(lut, scale, samples + i);
+	}
+
+	for (i = 0; i < 3 * num_samples; i++) {
+		/* Written to also catch NaN. */
+		if (!(fabsf(samples[i] - expected[i]) <= DISPLAY_LUT_TOLERANCE)) {
+			valid = false;
+			break;
+		}
+	}
+
+	MEM_freeN(samples);
+
+	return valid;
+}
+
+static bool display_lut_matches(const DisplayLUT *lut,
+                                const ColorManagedViewSettings *view_settings,
+                                const ColorManagedDisplaySettings *display_settings)
+{
+	return STREQ(lut->look, view_settings->look) &&
+	       STREQ(lut->view, view_settings->view_transform) &&
+	       STREQ(lut->display, display_settings->display_device) &&
+	       lut->exposure == view_settings->exposure &&
+	       lut->gamma == view_settings->gamma;
+}
+
+static DisplayLUT *display_lut_bake(const ColorManagedViewSettings *view_settings,
+                                    const ColorManagedDisplaySettings *display_settings,
+                                    OCIO_ConstProcessorRcPtr *processor)
+{
+	DisplayLUT *lut = MEM_callocN(sizeof(DisplayLUT), "display LUT");
+	DisplayLUTBakeData data;
+
+	BLI_strncpy(lut->look, view_settings->look, MAX_COLORSPACE_NAME);
+	BLI_strncpy(lut->view, view_settings->view_transform, MAX_COLORSPACE_NAME);
+	BLI_strncpy(lut->display, display_settings->display_device, MAX_COLORSPACE_NAME);
+	lut->exposure = view_settings->exposure;
+	lut->gamma = view_settings->gamma;
+
+	lut->table = MEM_mallocN(sizeof(float) * 3 * DISPLAY_LUT_SIZE * DISPLAY_LUT_SIZE * DISPLAY_LUT_SIZE,
+	                         "display LUT table");
+
+	data.processor = processor;
+	data.table = lut->table;
+	IMB_processor_apply_threaded_scanlines(DISPLAY_LUT_SIZE, display_lut_bake_thread_do, &data);
+
+	lut->valid = display_lut_verify(lut, processor);
+
+	/* No need to keep the table around, all that matters is to not bake it
+	 * again for the same settings. */
+	if (!lut->valid) {
+		MEM_freeN(lut->table);
+		lut->table = NULL;
+	}
+
+	return lut;
+}
+
+/* Get LUT for display buffers of num_pixels pixels, baking it when needed and
+ * worth it. Returns NULL when the processor is to be used instead. */
+static DisplayLUT *display_lut_acquire(const ColorManagedViewSettings *view_settings,
+                                       const ColorManagedDisplaySettings *display_settings,
+                                       ColormanageProcessor *cm_processor,
+                                       size_t num_pixels)
+{
+	DisplayLUT *lut;
+
+	if (view_settings == NULL || cm_processor == NULL ||
+	    cm_processor->processor == NULL || cm_processor->is_data_result)
+	{
+		return NULL;
+	}
+
+	BLI_mutex_lock(&display_lut_lock);
+
+	lut = global_display_lut;
+
+	if (lut == NULL || !display_lut_matches(lut, view_settings, display_settings)) {
+		if (num_pixels < DISPLAY_LUT_MIN_PIXELS) {
+			BLI_mutex_unlock(&display_lut_lock);
+			return NULL;
+		}
+
+		/* LUT which is still in use is freed by its last user. */
+		if (lut && lut->users == 0)
+			display_lut_free(lut);
+
+		lut = display_lut_bake(view_settings, display_settings, cm_processor->processor);
+		global_display_lut = lut;
+	}
+
+	if (!lut->valid) {
+		lut = NULL;
+	}
+	else {
+		lut->users++;
+	}
+
+	BLI_mutex_unlock(&display_lut_lock);
+
+	return lut;
+}
+
+static void display_lut_release(DisplayLUT *lut)
+{
+	if (lut == NULL)
+		return;
+
+	BLI_mutex_lock(&display_lut_lock);
+
+	lut->users--;
+
+	if (lut->users == 0 && lut != global_display_lut)
+		display_lut_free(lut);
+
+	BLI_mutex_unlock(&display_lut_lock);
+}
+
 /*********************** Threaded display buffer transform routines *************************/
 
 typedef struct DisplayBufferThread {
 	ColormanageProcessor *cm_processor;
+	const DisplayLUT *display_lut;
 
 	const float *buffer;
 	unsigned char *byte_buffer;
@@ -1272,6 +1612,7 @@ typedef struct DisplayBufferThread {
 typedef struct DisplayBufferInitData {
 	ImBuf *ibuf;
 	ColormanageProcessor *cm_processor;
+	const DisplayLUT *display_lut;
 	const float *buffer;
 	unsigned char *byte_buffer;
 
@@ -1300,6 +1641,7 @@ static void display_buffer_init_handle(void *handle_v, int start_line, int tot_l
 	memset(handle, 0, sizeof(DisplayBufferThread));
 
 	handle->cm_processor = init_data->cm_processor;
+	handle->display_lut = init_data->display_lut;
 
 	if (init_data->buffer)
 		handle->buffer = init_data->buffer + offset;
@@ -1441,6 +1783,11 @@ static void *do_display_buffer_apply_thread(void *handle_v)
 			 * only generate byte buffers
 			 */
 		}
+		else if (handle->display_lut && display_buffer == NULL) {
+			/* only byte buffer is generated, LUT is accurate enough for that */
+			display_lut_apply(handle->display_lut, cm_processor, linear_buffer, width, height, channels,
+			                  predivide);
+		}
 		else {
 			/* apply processor */
 			IMB_colormanagement_processor_apply(cm_processor, linear_buffer, width, height, channels,
@@ -1479,12 +1826,14 @@ static void *do_display_buffer_apply_thread(void *handle_v)
 }
 
 static void display_buffer_apply_threaded(ImBuf *ibuf, float *buffer, unsigned char *byte_buffer, float *display_buffer,
-                                          unsigned char *display_buffer_byte, ColormanageProcessor *cm_processor)
+                                          unsigned char *display_buffer_byte, ColormanageProcessor *cm_processor,
+                                          const DisplayLUT *display_lut)
 {
 	DisplayBufferInitData init_data;
 
 	init_data.ibuf = ibuf;
 	init_data.cm_processor = cm_processor;
+	init_data.display_lut = display_lut;
 	init_data.buffer = buffer;
 	init_data.byte_buffer = byte_buffer;
 	init_data.display_buffer = display_buffer;
@@ -1531,9 +1880,11 @@ static bool is_ibuf_rect_in_display_space(ImBuf *ibuf, const ColorManagedViewSet
 
 static void colormanage_display_buffer_process_ex(ImBuf *ibuf, float *display_buffer, unsigned char *display_buffer_byte,
                                                   const ColorManagedViewSettings *view_settings,
-                                                  const ColorManagedDisplaySettings *display_settings)
+                                                  const ColorManagedDisplaySettings *display_settings,
+                                                  bool use_display_lut)
 {
 	ColormanageProcessor *cm_processor = NULL;
+	DisplayLUT *display_lut = NULL;
 	bool skip_transform = false;
 
 	/* if we're going to transform byte buffer, check whether transformation would
@@ -1548,8 +1899,15 @@ static void colormanage_display_buffer_process_ex(ImBuf *ibuf, float *display_bu
 	if (skip_transform == false)
 		cm_processor = IMB_colormanagement_display_processor_new(view_settings, display_settings);
 
+	if (use_display_lut && display_buffer == NULL) {
+		display_lut = display_lut_acquire(view_settings, display_settings, cm_processor,
+		                                  (size_t)ibuf->x * ibuf->y);
+	}
+
 	display_buffer_apply_threaded(ibuf, ibuf->rect_float, (unsigned char *) ibuf->rect,
-	                              display_buffer, display_buffer_byte, cm_processor);
+	                              display_buffer, display_buffer_byte, cm_processor, display_lut);
+
+	display_lut_release(display_lut);
 
 	if (cm_processor)
 		IMB_colormanagement_processor_free(cm_processor);
@@ -1559,7 +1917,7 @@ static void colormanage_display_buffer_process(ImBuf *ibuf, unsigned char *displ
                                                const ColorManagedViewSettings *view_settings,
                                                const ColorManagedDisplaySettings *display_settings)
 {
-	colormanage_display_buffer_process_ex(ibuf, NULL, display_buffer, view_settings, display_settings);
+	colormanage_display_buffer_process_ex(ibuf, NULL, display_buffer, view_settings, display_settings, true);
 }
 
 /*********************** Threaded processor transform routines *************************/
@@ -1952,7 +2310,7 @@ static void colormanagement_imbuf_make_display_space(ImBuf *ibuf, const ColorMan
 		imb_addrectImBuf(ibuf);
 
 	colormanage_display_buffer_process_ex(ibuf, ibuf->rect_float, (unsigned char *)ibuf->rect,
-	                                      view_settings, display_settings);
+	                                      view_settings, display_settings, false);
 }
 
 void IMB_colormanagement_imbuf_make_display_space(ImBuf *ibuf, const ColorManagedViewSettings *view_settings,
@@ -2769,6 +3127,7 @@ static void partial_buffer_update_rect(ImBuf *ibuf,
                                        int linear_stride,
                                        int linear_offset_x, int linear_offset_y,
                                        ColormanageProcessor *cm_processor,
+                                       const DisplayLUT *display_lut,
                                        const int xmin, const int ymin,
                                        const int xmax, const int ymax)
 {
@@ -2780,6 +3139,7 @@ static void partial_buffer_update_rect(ImBuf *ibuf,
 	const int width = xmax - xmin;
 	const int height = ymax - ymin;
 	bool is_data = (ibuf->colormanage_flag & IMB_COLORMANAGE_IS_DATA) != 0;
+	const float display_lut_scale = display_lut_shaper_scale();
 
 	if (dither != 0.0f) {
 		/* cm_processor is NULL in cases byte_buffer's space matches display
@@ -2823,7 +3183,13 @@ static void partial_buffer_update_rect(ImBuf *ibuf,
 					straight_to_premul_v4(pixel);
 				}
 
-				if (!is_data) {
+				if (is_data) {
+					/* pass */
+				}
+				else if (display_lut) {
+					display_lut_apply_pixel(display_lut, cm_processor, display_lut_scale, pixel, channels, true);
+				}
+				else {
 					IMB_colormanagement_processor_apply_pixel(cm_processor, pixel, channels);
 				}
 
@@ -2898,6 +3264,7 @@ typedef struct PartialThreadData {
 	int linear_stride;
 	int linear_offset_x, linear_offset_y;
 	ColormanageProcessor *cm_processor;
+	const DisplayLUT *display_lut;
 	int xmin, ymin, xmax;
 } PartialThreadData;
 
@@ -2916,6 +3283,7 @@ static void partial_buffer_update_rect_thread_do(void *data_v,
 	                           data->linear_offset_x,
 	                           data->linear_offset_y,
 	                           data->cm_processor,
+	                           data->display_lut,
 	                           data->xmin,
 	                           ymin,
 	                           data->xmax,
@@ -2979,6 +3347,7 @@ static void imb_partial_display_buffer_update_ex(ImBuf *ibuf,
 
 	if (display_buffer) {
 		ColormanageProcessor *cm_processor = NULL;
+		DisplayLUT *display_lut = NULL;
 		bool skip_transform = false;
 
 		/* Byte buffer is assumed to be in imbuf's rect space, so if byte buffer
@@ -2997,6 +3366,11 @@ static void imb_partial_display_buffer_update_ex(ImBuf *ibuf,
 		if (!skip_transform) {
 			cm_processor = IMB_colormanagement_display_processor_new(
 			        view_settings, display_settings);
+
+			/* Partial updates of one image happen many times, so decide
+			 * whether to bake a LUT by the size of the whole image. */
+			display_lut = display_lut_acquire(view_settings, display_settings, cm_processor,
+			                                  (size_t)ibuf->x * ibuf->y);
 		}
 
 		if (do_threads) {
@@ -3010,6 +3384,7 @@ static void imb_partial_display_buffer_update_ex(ImBuf *ibuf,
 			data.linear_offset_x = offset_x;
 			data.linear_offset_y = offset_y;
 			data.cm_processor = cm_processor;
+			data.display_lut = display_lut;
 			data.xmin = xmin;
 			data.ymin = ymin;
 			data.xmax = xmax;
@@ -3023,9 +3398,12 @@ static void imb_partial_display_buffer_update_ex(ImBuf *ibuf,
 			                           stride,
 			                           offset_x, offset_y,
 			                           cm_processor,
+			                           display_lut,
 			                           xmin, ymin, xmax, ymax);
 		}
 
+		display_lut_release(display_lut);
+
 		if (cm_processor) {
 			IMB_colormanagement_processor_free(cm_processor);
 		}
@@ -36,6 +36,7 @@
 #include "BLI_string.h"
 #include "BLI_fileops.h"
 #include "BLI_ghash.h"
+#include "BLI_threads.h"
 
 #include "IMB_indexer.h"
 #include "IMB_anim.h"
@@ -784,6 +785,11 @@ static IndexBuildContext *index_ffmpeg_create_context(struct anim *anim, IMB_Tim
 
 	context->iCodecCtx->workaround_bugs = 1;
 
+	/* Only slice threading, the seek positions of the index are assigned
+	 * assuming decoded frames come out at most one GOP late. */
+	context->iCodecCtx->thread_count = BLI_system_thread_count();
+	context->iCodecCtx->thread_type = FF_THREAD_SLICE;
+
 	if (avcodec_open2(context->iCodecCtx, context->iCodec, NULL) < 0) {
 		avformat_close_input(&context->iFormatCtx);
 		MEM_freeN(context);
@@ -62,7 +62,8 @@ static void skip_input_data(j_decompress_ptr cinfo, long num_bytes);
 static void term_source(j_decompress_ptr cinfo);
 static void memory_source(j_decompress_ptr cinfo, const unsigned char *buffer, size_t size);
 static boolean handle_app1(j_decompress_ptr cinfo);
-static ImBuf *ibJpegImageFromCinfo(struct jpeg_decompress_struct *cinfo, int flags);
+static ImBuf *ibJpegImageFromCinfo(struct jpeg_decompress_struct *cinfo, int flags, int max_size,
+                                   size_t *r_width, size_t *r_height);
 
 static const uchar jpeg_default_quality = 75;
 static uchar ibuf_quality;
@@ -271,7 +272,10 @@ static boolean handle_app1(j_decompress_ptr cinfo)
 }
 
 
-static ImBuf *ibJpegImageFromCinfo(struct jpeg_decompress_struct *cinfo, int flags)
+/* When max_size is positive, the image is decoded at the smallest size libjpeg can scale to
+ * that is still at least max_size along its largest side, and the full size is returned. */
+static ImBuf *ibJpegImageFromCinfo(struct jpeg_decompress_struct *cinfo, int flags, int max_size,
+                                   size_t *r_width, size_t *r_height)
 {
 	JSAMPARRAY row_pointer;
 	JSAMPLE *buffer = NULL;
@@ -289,14 +293,31 @@ static ImBuf *ibJpegImageFromCinfo(struct jpeg_decompress_struct *cinfo, int fla
 	jpeg_save_markers(cinfo, JPEG_COM, 0xffff);
 
 	if (jpeg_read_header(cinfo, false) == JPEG_HEADER_OK) {
-		x = cinfo->image_width;
-		y = cinfo->image_height;
 		depth = cinfo->num_components;
 
 		if (cinfo->jpeg_color_space == JCS_YCCK) cinfo->out_color_space = JCS_CMYK;
 
+		if (max_size > 0) {
+			const int size = MAX2(cinfo->image_width, cinfo->image_height);
+
+			*r_width = cinfo->image_width;
+			*r_height = cinfo->image_height;
+
+			/* the DCT can be scaled down to 1/2, 1/4 or 1/8, skipping most of the decoding work */
+			cinfo->scale_num = 1;
+			cinfo->scale_denom = 1;
+			while (cinfo->scale_denom < 8 && size / (int)(cinfo->scale_denom * 2) >= max_size) {
+				cinfo->scale_denom *= 2;
+			}
+			cinfo->dct_method = JDCT_IFAST;
+			cinfo->do_fancy_upsampling = false;
+		}
+
 		jpeg_start_decompress(cinfo);
 
+		x = cinfo->output_width;
+		y = cinfo->output_height;
+
 		if (flags & IB_test) {
 			jpeg_abort_decompress(cinfo);
 			ibuf = IMB_allocImBuf(x, y, 8 * depth, 0);
@@ -453,11 +474,38 @@ ImBuf *imb_load_jpeg(const unsigned char *buffer, size_t size, int flags, char c
 	jpeg_create_decompress(cinfo);
 	memory_source(cinfo, buffer, size);
 
-	ibuf = ibJpegImageFromCinfo(cinfo, flags);
+	ibuf = ibJpegImageFromCinfo(cinfo, flags, -1, NULL, NULL);
 	
 	return(ibuf);
 }
 
+ImBuf *imb_thumbnail_jpeg(const unsigned char *buffer, size_t size, int flags, size_t max_thumb_size,
+                          char colorspace[IM_MAX_SPACE], size_t *r_width, size_t *r_height)
+{
+	struct jpeg_decompress_struct _cinfo, *cinfo = &_cinfo;
+	struct my_error_mgr jerr;
+	ImBuf *ibuf;
+
+	if (!imb_is_a_jpeg(buffer)) return NULL;
+
+	colorspace_set_default_role(colorspace, IM_MAX_SPACE, COLOR_ROLE_DEFAULT_BYTE);
+
+	cinfo->err = jpeg_std_error(&jerr.pub);
+	jerr.pub.error_exit = jpeg_error;
+
+	if (setjmp(jerr.setjmp_buffer)) {
+		jpeg_destroy_decompress(cinfo);
+		return NULL;
+	}
+
+	jpeg_create_decompress(cinfo);
+	memory_source(cinfo, buffer, size);
+
+	ibuf = ibJpegImageFromCinfo(cinfo, flags, MAX2((int)max_thumb_size, 1), r_width, r_height);
+
+	return ibuf;
+}
+
 
 static void write_jpeg(struct jpeg_compress_struct *cinfo, struct ImBuf *ibuf)
 {
@@ -54,6 +54,7 @@
 #include <ImfCompressionAttribute.h>
 #include <ImfStringAttribute.h>
 #include <ImfStandardAttributes.h>
+#include <ImfPreviewImage.h>
 
 /* multiview/multipart */
 #include <ImfMultiView.h>
@@ -62,6 +63,7 @@
 #include <ImfOutputPart.h>
 #include <ImfMultiPartOutputFile.h>
 #include <ImfTiledOutputPart.h>
+#include <ImfTiledInputPart.h>
 #include <ImfPartType.h>
 #include <ImfPartHelper.h>
 
@@ -309,6 +311,23 @@ int imb_is_a_openexr(const unsigned char *mem)
 	return Imf::isImfMagic((const char *)mem);
 }
 
+/* The thread count can be overridden from the command line after the
+ * OpenEXR thread pool was created, keep the pool in sync before files are
+ * read or written. */
+static void openexr_thread_count_update(void)
+{
+	static ThreadMutex thread_count_lock = BLI_MUTEX_INITIALIZER;
+	const int num_threads = BLI_system_thread_count();
+
+	if (globalThreadCount() != num_threads) {
+		BLI_mutex_lock(&thread_count_lock);
+		if (globalThreadCount() != num_threads) {
+			setGlobalThreadCount(num_threads);
+		}
+		BLI_mutex_unlock(&thread_count_lock);
+	}
+}
+
 static void openexr_header_compression(Header *header, int compression)
 {
 	switch (compression) {
@@ -591,6 +610,8 @@ static bool imb_save_openexr_float(
 
 int imb_save_openexr(struct ImBuf *ibuf, const char *name, int flags)
 {
+	openexr_thread_count_update();
+
 	if (flags & IB_mem) {
 		printf("OpenEXR-save: Create EXR in memory CURRENTLY NOT SUPPORTED !\n");
 		imb_addencodedbufferImBuf(ibuf);
@@ -683,6 +704,7 @@ typedef struct ExrChannel {
 	struct ExrChannel *next, *prev;
 
 	char name[EXR_TOT_MAXNAME + 1];  /* full name with everything */
+	char layer[EXR_LAY_MAXNAME + 1]; /* render layer, used to split multipart files */
 	struct MultiViewChannelName *m;  /* struct to store all multipart channel info */
 	int xstride, ystride;            /* step to next pixel, to next scanline */
 	float *rect;                     /* first pointer to write in */
@@ -834,6 +856,10 @@ void IMB_exr_add_channel(void *handle,
 
 	echan->m->view.assign(viewname ? viewname : "");
 
+	if (layname) {
+		BLI_strncpy(echan->layer, layname, sizeof(echan->layer));
+	}
+
 	/* quick look up */
 	echan->view_id = std::max(0, imb_exr_get_multiView_id(*data->multiView, echan->m->view));
 
@@ -862,16 +888,22 @@ void IMB_exr_add_channel(void *handle,
 	BLI_addtail(&data->channels, echan);
 }
 
-/* used for output files (from RenderResult) (single and multilayer, single and multiview) */
-int IMB_exr_begin_write(void *handle, const char *filename, int width, int height, int compress, const StampData *stamp)
+/* used for output files (from RenderResult) (single and multilayer, single and multiview)
+ * multilayer files can be written with every layer in its own part, so readers can decode
+ * a single layer without decoding the channels of all others */
+int IMB_exr_begin_write(void *handle, const char *filename, int width, int height, int compress, bool multipart,
+                        const StampData *stamp)
 {
 	ExrHandle *data = (ExrHandle *)handle;
 	Header header(width, height);
+	std::vector<Header> headers;
 	ExrChannel *echan;
 
 	data->width = width;
 	data->height = height;
 
+	openexr_thread_count_update();
+
 	bool is_singlelayer, is_multilayer, is_multiview;
 
 	for (echan = (ExrChannel *)data->channels.first; echan; echan = echan->next) {
@@ -891,23 +923,57 @@ int IMB_exr_begin_write(void *handle, const char *filename, int width, int heigh
 	if (is_multiview)
 		addMultiView(header, *data->multiView);
 
+	/* views are stored in the channel names of a single part, only split layers without views */
+	if (multipart && is_multilayer && !is_multiview) {
+		StringVector part_names;
+
+		for (echan = (ExrChannel *)data->channels.first; echan; echan = echan->next) {
+			const std::string part_name(echan->layer[0] ? echan->layer : "Image");
+			size_t part;
+
+			for (part = 0; part < part_names.size(); part++) {
+				if (part_names[part] == part_name)
+					break;
+			}
+
+			if (part == part_names.size()) {
+				part_names.push_back(part_name);
+				headers.push_back(header);
+				headers[part].channels() = ChannelList();
+				headers[part].setName(part_name);
+				headers[part].setType(SCANLINEIMAGE);
+			}
+
+			headers[part].channels().insert(echan->name,
+			                                Channel(echan->use_half_float ? Imf::HALF : Imf::FLOAT));
+			echan->m->part_number = part;
+		}
+
+		data->parts = headers.size();
+	}
+
 	/* avoid crash/abort when we don't have permission to write here */
 	/* manually create ofstream, so we can handle utf-8 filepaths on windows */
 	try {
 		data->ofile_stream = new OFileStream(filename);
-		data->ofile = new OutputFile(*(data->ofile_stream), header);
+		if (headers.size())
+			data->mpofile = new MultiPartOutputFile(*(data->ofile_stream), &headers[0], headers.size());
+		else
+			data->ofile = new OutputFile(*(data->ofile_stream), header);
 	}
 	catch (const std::exception& exc) {
 		std::cerr << "IMB_exr_begin_write: ERROR: " << exc.what() << std::endl;
 
 		delete data->ofile;
+		delete data->mpofile;
 		delete data->ofile_stream;
 
 		data->ofile = NULL;
+		data->mpofile = NULL;
 		data->ofile_stream = NULL;
 	}
 
-	return (data->ofile != NULL);
+	return (data->ofile != NULL || data->mpofile != NULL);
 }
 
 /* only used for writing temp. render results (not image files)
@@ -925,6 +991,8 @@ void IMB_exrtile_begin_write(void *handle, const char *filename, int mipmap, int
 	data->height = height;
 	data->mipmap = mipmap;
 
+	openexr_thread_count_update();
+
 	header.setTileDescription(TileDescription(tilex, tiley, (mipmap) ? MIPMAP_LEVELS : ONE_LEVEL));
 	header.compression() = RLE_COMPRESSION;
 	header.setType(TILEDIMAGE);
@@ -978,6 +1046,8 @@ int IMB_exr_begin_read(void *handle, const char *filename, int *width, int *heig
 	ExrHandle *data = (ExrHandle *)handle;
 	ExrChannel *echan;
 
+	openexr_thread_count_update();
+
 	if (BLI_exists(filename) && BLI_file_size(filename) > 32) {   /* 32 is arbitrary, but zero length files crashes exr */
 		/* avoid crash/abort when we don't have permission to write here */
 		try {
@@ -1099,7 +1169,7 @@ void IMB_exr_clear_channels(void *handle)
 void IMB_exr_write_channels(void *handle)
 {
 	ExrHandle *data = (ExrHandle *)handle;
-	FrameBuffer frameBuffer;
+	std::vector<FrameBuffer> frameBuffers(data->mpofile ? data->parts : 1);
 	ExrChannel *echan;
 
 	if (data->channels.first) {
@@ -1113,6 +1183,8 @@ void IMB_exr_write_channels(void *handle)
 		}
 
 		for (echan = (ExrChannel *)data->channels.first; echan; echan = echan->next) {
+			FrameBuffer& frameBuffer = frameBuffers[data->mpofile ? echan->m->part_number : 0];
+
 			/* Writting starts from last scanline, stride negative. */
 			if (echan->use_half_float) {
 				float *rect = echan->rect;
@@ -1132,9 +1204,18 @@ void IMB_exr_write_channels(void *handle)
 			}
 		}
 
-		data->ofile->setFrameBuffer(frameBuffer);
 		try {
-			data->ofile->writePixels(data->height);
+			if (data->mpofile) {
+				for (int i = 0; i < data->parts; i++) {
+					OutputPart out(*data->mpofile, i);
+					out.setFrameBuffer(frameBuffers[i]);
+					out.writePixels(data->height);
+				}
+			}
+			else {
+				data->ofile->setFrameBuffer(frameBuffers[0]);
+				data->ofile->writePixels(data->height);
+			}
 		}
 		catch (const std::exception& exc) {
 			std::cerr << "OpenEXR-writePixels: ERROR: " << exc.what() << std::endl;
@@ -1257,6 +1338,7 @@ void IMB_exr_read_channels(void *handle)
 	int numparts = data->ifile->parts();
 	std::vector<FrameBuffer> frameBuffers(numparts);
 	std::vector<InputPart> inputParts;
+	std::vector<bool> readParts(numparts, false);
 
 	/* check if exr was saved with previous versions of blender which flipped images */
 	const StringAttribute *ta = data->ifile->header(0).findTypedAttribute <StringAttribute> ("BlenderMultiChannel");
@@ -1268,6 +1350,8 @@ void IMB_exr_read_channels(void *handle)
 		exr_printf("%d %-6s %-22s \"%s\"\n", echan->m->part_number, echan->m->view.c_str(), echan->m->name.c_str(), echan->m->internal_name.c_str());
 
 		if (echan->rect) {
+			readParts[echan->m->part_number] = true;
+
 			if (flip)
 				frameBuffers[echan->m->part_number].insert(echan->m->internal_name, Slice(Imf::FLOAT,  (char *)echan->rect,
 				                                      echan->xstride * sizeof(float), echan->ystride * sizeof(float)));
@@ -1287,10 +1371,13 @@ void IMB_exr_read_channels(void *handle)
 
 	try {
 		for (int i = 0; i < numparts; i++) {
+			/* only decode parts that have channels requested */
+			if (!readParts[i])
+				continue;
+
 			Header header = inputParts[i].header();
 			exr_printf("readPixels:readPixels[%d]: min.y: %d, max.y: %d\n", i, header.dataWindow().min.y, header.dataWindow().max.y);
 			inputParts[i].readPixels(header.dataWindow().min.y, header.dataWindow().max.y);
-			inputParts[i].readPixels(0, data->height - 1);
 		}
 	}
 	catch (const std::exception& exc) {
@@ -1929,6 +2016,119 @@ static bool imb_exr_is_multi(MultiPartInputFile& file)
 	return false;
 }
 
+/* Tiled single layer RGB images, of which tiles can be loaded on demand by the tile cache. */
+static bool imb_exr_is_tiled_texture(MultiPartInputFile& file)
+{
+	const Header& header = file.header(0);
+
+	if (!header.hasTileDescription() || file.parts() != 1)
+		return false;
+
+	LevelMode mode = header.tileDescription().mode;
+
+	return (mode == ONE_LEVEL || mode == MIPMAP_LEVELS) && exr_has_rgb(file);
+}
+
+/* Set up empty image and mipmap levels with tiles, instead of reading pixels. */
+static void imb_exr_begin_tilecache(struct ImBuf *ibuf, MultiPartInputFile& file)
+{
+	TiledInputPart in(file, 0);
+	const int numlevel = min_ii(in.numLevels(), IMB_MIPMAP_LEVELS + 1);
+
+	for (int level = 0; level < numlevel; level++) {
+		struct ImBuf *hbuf;
+
+		if (level > 0) {
+			hbuf = IMB_allocImBuf(in.levelWidth(level), in.levelHeight(level), ibuf->planes, 0);
+			hbuf->miplevel = level;
+			hbuf->ftype = ibuf->ftype;
+			ibuf->mipmap[level - 1] = hbuf;
+		}
+		else
+			hbuf = ibuf;
+
+		hbuf->flags |= IB_tilecache;
+
+		hbuf->tilex = in.tileXSize();
+		hbuf->tiley = in.tileYSize();
+
+		hbuf->xtiles = in.numXTiles(level);
+		hbuf->ytiles = (hbuf->y + hbuf->tiley - 1) / hbuf->tiley;
+
+		imb_addtilesImBuf(hbuf);
+
+		ibuf->miptot++;
+	}
+}
+
+/* Tiles of the cache are counted from the bottom of the image, so they only line
+ * up with EXR tiles horizontally. Read all EXR tile rows covering the cache tile. */
+void imb_loadtile_openexr(struct ImBuf *ibuf, const unsigned char *mem, size_t size, int tx, int ty, unsigned int *rect)
+{
+	Mem_IStream membuf((unsigned char *)mem, size);
+	float *pixels = NULL;
+
+	try
+	{
+		MultiPartInputFile file(membuf);
+		TiledInputPart in(file, 0);
+		const int level = ibuf->miplevel;
+		Box2i dw = in.dataWindowForLevel(level);
+
+		const int tilex = ibuf->tilex, tiley = ibuf->tiley;
+		const int width = min_ii(tilex, ibuf->x - tx * tilex);
+		const int height = min_ii(tiley, ibuf->y - ty * tiley);
+
+		/* Rows of the cache tile, relative to the top of the data window. */
+		const int row_top = ibuf->y - (ty * tiley + height);
+		const int row_bottom = ibuf->y - 1 - ty * tiley;
+		const int exr_ty_min = row_top / tiley, exr_ty_max = row_bottom / tiley;
+		const int exr_rows = (exr_ty_max - exr_ty_min + 1) * tiley;
+
+		if (width <= 0 || height <= 0 || level >= in.numLevels() ||
+		    ibuf->x != in.levelWidth(level) || ibuf->y != in.levelHeight(level))
+		{
+			printf("imb_loadtile_openexr: unexpected tile %d %d at mipmap level %d\n", tx, ty, level);
+			return;
+		}
+
+		pixels = (float *)MEM_mallocN(sizeof(float) * 4 * tilex * exr_rows, "exr tile pixels");
+		FrameBuffer frameBuffer;
+		const ptrdiff_t xstride = sizeof(float) * 4;
+		const ptrdiff_t ystride = xstride * tilex;
+
+		/* first pixel of the read tiles maps to the start of the buffer */
+		char *first = (char *)pixels -
+		              (ptrdiff_t)(dw.min.x + tx * tilex) * xstride -
+		              (ptrdiff_t)(dw.min.y + exr_ty_min * tiley) * ystride;
+
+		frameBuffer.insert(exr_rgba_channelname(file, "R"), Slice(Imf::FLOAT, first, xstride, ystride));
+		frameBuffer.insert(exr_rgba_channelname(file, "G"), Slice(Imf::FLOAT, first + sizeof(float), xstride, ystride));
+		frameBuffer.insert(exr_rgba_channelname(file, "B"), Slice(Imf::FLOAT, first + 2 * sizeof(float), xstride, ystride));
+		frameBuffer.insert(exr_rgba_channelname(file, "A"),
+		                   Slice(Imf::FLOAT, first + 3 * sizeof(float), xstride, ystride, 1, 1, 1.0f));
+
+		in.setFrameBuffer(frameBuffer);
+		in.readTiles(tx, tx, exr_ty_min, exr_ty_max, level);
+
+		/* flip rows into the byte tile, which is in the default byte color space */
+		for (int y = 0; y < height; y++) {
+			const int row = row_bottom - y - exr_ty_min * tiley;
+
+			IMB_buffer_byte_from_float((unsigned char *)(rect + y * tilex), pixels + 4 * row * tilex,
+			                           4, 0.0f, IB_PROFILE_SRGB, IB_PROFILE_LINEAR_RGB, true,
+			                           width, 1, tilex, tilex);
+		}
+	}
+	catch (const std::exception& exc)
+	{
+		std::cerr << exc.what() << std::endl;
+	}
+
+	if (pixels)
+		MEM_freeN(pixels);
+}
+
 struct ImBuf *imb_load_openexr(const unsigned char *mem, size_t size, int flags, char colorspace[IM_MAX_SPACE])
 {
 	struct ImBuf *ibuf = NULL;
@@ -1937,6 +2137,8 @@ struct ImBuf *imb_load_openexr(const unsigned char *mem, size_t size, int flags,
 
 	if (imb_is_a_openexr(mem) == 0) return(NULL);
 
+	openexr_thread_count_update();
+
 	colorspace_set_default_role(colorspace, IM_MAX_SPACE, COLOR_ROLE_DEFAULT_FLOAT);
 
 	try
@@ -1999,6 +2201,13 @@ struct ImBuf *imb_load_openexr(const unsigned char *mem, size_t size, int flags,
 						ibuf->userdata = handle;         /* potential danger, the caller has to check for this! */
 					}
 				}
+				else if ((flags & IB_tilecache) && imb_exr_is_tiled_texture(*file)) {
+					/* we don't read pixels but leave it to the cache to load tiles */
+					imb_exr_begin_tilecache(ibuf, *file);
+
+					delete membuf;
+					delete file;
+				}
 				else {
 					const bool has_rgb = exr_has_rgb(*file);
 					const bool has_luma = exr_has_luma(*file);
@@ -2103,6 +2312,70 @@ struct ImBuf *imb_load_openexr(const unsigned char *mem, size_t size, int flags,
 
 }
 
+/* Thumbnails use the preview image stored in the header when there is one, which avoids
+ * decoding the full float image. Files without one are loaded in full by the caller. */
+struct ImBuf *imb_thumbnail_openexr(const unsigned char *mem, size_t size, int UNUSED(flags),
+                                    size_t UNUSED(max_thumb_size), char colorspace[IM_MAX_SPACE], size_t *r_width, size_t *r_height)
+{
+	struct ImBuf *ibuf = NULL;
+	Mem_IStream *membuf = NULL;
+	MultiPartInputFile *file = NULL;
+
+	if (imb_is_a_openexr(mem) == 0) return(NULL);
+
+	try
+	{
+		membuf = new Mem_IStream((unsigned char *)mem, size);
+		file = new MultiPartInputFile(*membuf);
+
+		const Header & header = file->header(0);
+
+		if (header.hasPreviewImage()) {
+			const PreviewImage & preview = header.previewImage();
+			const PreviewRgba *pixels = preview.pixels();
+			const int width = preview.width();
+			const int height = preview.height();
+			Box2i dw = header.dataWindow();
+
+			ibuf = IMB_allocImBuf(width, height, 32, IB_rect);
+
+			if (ibuf) {
+				/* preview pixels are stored top to bottom */
+				for (int y = 0; y < height; y++) {
+					const PreviewRgba *src = pixels + (size_t)(height - 1 - y) * width;
+					unsigned char *dst = (unsigned char *)(ibuf->rect + (size_t)y * width);
+
+					for (int x = 0; x < width; x++, src++, dst += 4) {
+						dst[0] = src->r;
+						dst[1] = src->g;
+						dst[2] = src->b;
+						dst[3] = src->a;
+					}
+				}
+
+				ibuf->ftype = IMB_FTYPE_OPENEXR;
+
+				/* the preview is 8 bit and display referred */
+				colorspace_set_default_role(colorspace, IM_MAX_SPACE, COLOR_ROLE_DEFAULT_BYTE);
+
+				*r_width = dw.max.x - dw.min.x + 1;
+				*r_height = dw.max.y - dw.min.y + 1;
+			}
+		}
+	}
+	catch (const std::exception& exc)
+	{
+		std::cerr << exc.what() << std::endl;
+		if (ibuf) IMB_freeImBuf(ibuf);
+		ibuf = NULL;
+	}
+
+	delete file;
+	delete membuf;
+
+	return(ibuf);
+}
+
 void imb_initopenexr(void)
 {
 	int num_threads = BLI_system_thread_count();
@@ -47,6 +47,12 @@ int		imb_save_openexr			(struct ImBuf *ibuf, const char *name, int flags);
 
 struct ImBuf *imb_load_openexr		(const unsigned char *mem, size_t size, int flags, char *colorspace);
 
+struct ImBuf *imb_thumbnail_openexr	(const unsigned char *mem, size_t size, int flags, size_t max_thumb_size,
+							 char *colorspace, size_t *r_width, size_t *r_height);
+
+void		imb_loadtile_openexr		(struct ImBuf *ibuf, const unsigned char *mem, size_t size,
+							 int tx, int ty, unsigned int *rect);
+
 #ifdef __cplusplus
 }
 #endif
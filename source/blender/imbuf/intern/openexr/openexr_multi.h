@@ -59,7 +59,8 @@ void  IMB_exr_add_channel(void *handle,
                           bool use_half_float);
 
 int     IMB_exr_begin_read(void *handle, const char *filename, int *width, int *height);
-int     IMB_exr_begin_write(void *handle, const char *filename, int width, int height, int compress, const struct StampData *stamp);
+int     IMB_exr_begin_write(void *handle, const char *filename, int width, int height, int compress, bool multipart,
+                            const struct StampData *stamp);
 void    IMB_exrtile_begin_write(void *handle, const char *filename, int mipmap, int width, int height, int tilex, int tiley);
 
 void    IMB_exr_set_channel(void *handle, const char *layname, const char *passname, int xstride, int ystride, float *rect);
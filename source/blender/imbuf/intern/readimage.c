@@ -50,6 +50,7 @@
 #include "IMB_imbuf_types.h"
 #include "IMB_imbuf.h"
 #include "IMB_filetype.h"
+#include "IMB_thumbs.h"
 
 #include "IMB_colormanagement.h"
 #include "IMB_colormanagement_intern.h"
@@ -238,6 +239,67 @@ ImBuf *IMB_loadiffname(const char *filepath, int flags, char colorspace[IM_MAX_S
 	return ibuf;
 }
 
+/* Load an image to create a thumbnail from. File types which can decode at a reduced resolution
+ * do so, the result is then at least max_thumb_size along its largest side (unless the image is
+ * smaller). Other file types are loaded in full. The full image size is returned in r_width and
+ * r_height, for the thumbnail metadata. */
+ImBuf *IMB_thumb_load_image(const char *filepath, size_t max_thumb_size, size_t *r_width, size_t *r_height)
+{
+	ImBuf *ibuf = NULL;
+	const ImFileType *type;
+	const int flags = IB_rect | IB_metadata | IB_thumbnail;
+	char effective_colorspace[IM_MAX_SPACE] = "";
+	unsigned char *mem;
+	size_t size;
+	int file;
+
+	BLI_assert(!BLI_path_is_rel(filepath));
+
+	if (!imb_is_filepath_format(filepath)) {
+		file = BLI_open(filepath, O_BINARY | O_RDONLY, 0);
+		if (file == -1)
+			return NULL;
+
+		size = BLI_file_descriptor_size(file);
+
+		imb_mmap_lock();
+		mem = mmap(NULL, size, PROT_READ, MAP_SHARED, file, 0);
+		imb_mmap_unlock();
+
+		if (mem != (unsigned char *) -1) {
+			for (type = IMB_FILE_TYPES; type < IMB_FILE_TYPES_LAST; type++) {
+				if (type->load_thumbnail) {
+					ibuf = type->load_thumbnail(mem, size, flags, max_thumb_size, effective_colorspace,
+					                            r_width, r_height);
+					if (ibuf) {
+						imb_handle_alpha(ibuf, flags, NULL, effective_colorspace);
+						BLI_strncpy(ibuf->name, filepath, sizeof(ibuf->name));
+						break;
+					}
+				}
+			}
+
+			imb_mmap_lock();
+			if (munmap(mem, size))
+				fprintf(stderr, "%s: couldn't unmap file %s\n", __func__, filepath);
+			imb_mmap_unlock();
+		}
+
+		close(file);
+	}
+
+	/* no reduced resolution decoding for this file type, load the full image */
+	if (ibuf == NULL) {
+		ibuf = IMB_loadiffname(filepath, IB_rect | IB_metadata, NULL);
+		if (ibuf) {
+			*r_width = ibuf->x;
+			*r_height = ibuf->y;
+		}
+	}
+
+	return ibuf;
+}
+
 ImBuf *IMB_testiffname(const char *filepath, int flags)
 {
 	ImBuf *ibuf;
@@ -881,48 +881,45 @@ static bool q_scale_linear_interpolation(
 	return true;
 }
 
-static ImBuf *scaledownx(struct ImBuf *ibuf, int newx)
-{
-	const int do_rect = (ibuf->rect != NULL);
-	const int do_float = (ibuf->rect_float != NULL);
-	const size_t rect_size = ibuf->x * ibuf->y * 4;
+/* The scaling passes below work on independent rows or columns of the image,
+ * which are scaled in parallel, a line of the pass is a row or column. */
+typedef struct ScaleLinesData {
+	ImBuf *ibuf;
+	int newsize;
+	uchar *newrect;
+	float *newrectf;
+} ScaleLinesData;
 
-	uchar *rect, *_newrect, *newrect;
-	float *rectf, *_newrectf, *newrectf;
+static void scaledownx_lines(void *data_v, int start_line, int num_lines)
+{
+	ScaleLinesData *data = (ScaleLinesData *)data_v;
+	ImBuf *ibuf = data->ibuf;
+	const int newx = data->newsize;
+	const int do_rect = (data->newrect != NULL);
+	const int do_float = (data->newrectf != NULL);
+	const size_t line_size = (size_t)ibuf->x * 4;
+	const size_t newline_size = (size_t)newx * 4;
+
+	uchar *rect = NULL, *newrect = NULL;
+	float *rectf = NULL, *newrectf = NULL;
 	float sample, add, val[4], nval[4], valf[4], nvalf[4];
 	int x, y;
 
-	rectf = _newrectf = newrectf = NULL;
-	rect = _newrect = newrect = NULL;
 	nval[0] =  nval[1] = nval[2] = nval[3] = 0.0f;
 	nvalf[0] = nvalf[1] = nvalf[2] = nvalf[3] = 0.0f;
 
-	if (!do_rect && !do_float) return (ibuf);
-
-	if (do_rect) {
-		_newrect = MEM_mallocN(newx * ibuf->y * sizeof(uchar) * 4, "scaledownx");
-		if (_newrect == NULL) return(ibuf);
-	}
-	if (do_float) {
-		_newrectf = MEM_mallocN(newx * ibuf->y * sizeof(float) * 4, "scaledownxf");
-		if (_newrectf == NULL) {
-			if (_newrect) MEM_freeN(_newrect);
-			return(ibuf);
-		}
-	}
-
 	add = (ibuf->x - 0.01) / newx;
 
 	if (do_rect) {
-		rect = (uchar *) ibuf->rect;
-		newrect = _newrect;
+		rect = (uchar *) ibuf->rect + start_line * line_size;
+		newrect = data->newrect + start_line * newline_size;
 	}
 	if (do_float) {
-		rectf = ibuf->rect_float;
-		newrectf = _newrectf;
+		rectf = ibuf->rect_float + start_line * line_size;
+		newrectf = data->newrectf + start_line * newline_size;
 	}
-		
-	for (y = ibuf->y; y > 0; y--) {
+
+	for (y = num_lines; y > 0; y--) {
 		sample = 0.0f;
 		val[0] =  val[1] = val[2] = val[3] = 0.0f;
 		valf[0] = valf[1] = valf[2] = valf[3] = 0.0f;
@@ -990,68 +987,85 @@ static ImBuf *scaledownx(struct ImBuf *ibuf, int newx)
 		}
 	}
 
+	/* see bug [#26502] */
+	BLI_assert(!do_rect || (uchar *)rect - ((uchar *)ibuf->rect) == (start_line + num_lines) * line_size);
+	BLI_assert(!do_float || (rectf - ibuf->rect_float) == (start_line + num_lines) * line_size);
+	(void)line_size; /* UNUSED in release builds */
+}
+
+static ImBuf *scaledownx(struct ImBuf *ibuf, int newx)
+{
+	const int do_rect = (ibuf->rect != NULL);
+	const int do_float = (ibuf->rect_float != NULL);
+
+	ScaleLinesData data;
+	uchar *_newrect = NULL;
+	float *_newrectf = NULL;
+
+	if (!do_rect && !do_float) return (ibuf);
+
+	if (do_rect) {
+		_newrect = MEM_mallocN(newx * ibuf->y * sizeof(uchar) * 4, "scaledownx");
+		if (_newrect == NULL) return(ibuf);
+	}
+	if (do_float) {
+		_newrectf = MEM_mallocN(newx * ibuf->y * sizeof(float) * 4, "scaledownxf");
+		if (_newrectf == NULL) {
+			if (_newrect) MEM_freeN(_newrect);
+			return(ibuf);
+		}
+	}
+
+	data.ibuf = ibuf;
+	data.newsize = newx;
+	data.newrect = _newrect;
+	data.newrectf = _newrectf;
+	IMB_processor_apply_threaded_scanlines(ibuf->y, scaledownx_lines, &data);
+
 	if (do_rect) {
-		// printf("%ld %ld\n", (uchar *)rect - ((uchar *)ibuf->rect), rect_size);
-		BLI_assert((uchar *)rect - ((uchar *)ibuf->rect) == rect_size); /* see bug [#26502] */
 		imb_freerectImBuf(ibuf);
 		ibuf->mall |= IB_rect;
 		ibuf->rect = (unsigned int *) _newrect;
 	}
 	if (do_float) {
-		// printf("%ld %ld\n", rectf - ibuf->rect_float, rect_size);
-		BLI_assert((rectf - ibuf->rect_float) == rect_size); /* see bug [#26502] */
 		imb_freerectfloatImBuf(ibuf);
 		ibuf->mall |= IB_rectfloat;
 		ibuf->rect_float = _newrectf;
 	}
-	(void)rect_size; /* UNUSED in release builds */
-	
+
 	ibuf->x = newx;
 	return(ibuf);
 }
 
 
-static ImBuf *scaledowny(struct ImBuf *ibuf, int newy)
+static void scaledowny_lines(void *data_v, int start_line, int num_lines)
 {
-	const int do_rect = (ibuf->rect != NULL);
-	const int do_float = (ibuf->rect_float != NULL);
-	const size_t rect_size = ibuf->x * ibuf->y * 4;
+	ScaleLinesData *data = (ScaleLinesData *)data_v;
+	ImBuf *ibuf = data->ibuf;
+	const int newy = data->newsize;
+	const int do_rect = (data->newrect != NULL);
+	const int do_float = (data->newrectf != NULL);
+	const size_t rect_size = (size_t)ibuf->x * ibuf->y * 4;
 
-	uchar *rect, *_newrect, *newrect;
-	float *rectf, *_newrectf, *newrectf;
+	uchar *rect = NULL, *newrect = NULL;
+	float *rectf = NULL, *newrectf = NULL;
 	float sample, add, val[4], nval[4], valf[4], nvalf[4];
 	int x, y, skipx;
 
-	rectf = _newrectf = newrectf = NULL;
-	rect = _newrect = newrect = NULL;
 	nval[0] =  nval[1] = nval[2] = nval[3] = 0.0f;
 	nvalf[0] = nvalf[1] = nvalf[2] = nvalf[3] = 0.0f;
 
-	if (!do_rect && !do_float) return (ibuf);
-
-	if (do_rect) {
-		_newrect = MEM_mallocN(newy * ibuf->x * sizeof(uchar) * 4, "scaledowny");
-		if (_newrect == NULL) return(ibuf);
-	}
-	if (do_float) {
-		_newrectf = MEM_mallocN(newy * ibuf->x * sizeof(float) * 4, "scaledownyf");
-		if (_newrectf == NULL) {
-			if (_newrect) MEM_freeN(_newrect);
-			return(ibuf);
-		}
-	}
-
 	add = (ibuf->y - 0.01) / newy;
 	skipx = 4 * ibuf->x;
 
-	for (x = skipx - 4; x >= 0; x -= 4) {
+	for (x = 4 * start_line; x < 4 * (start_line + num_lines); x += 4) {
 		if (do_rect) {
 			rect = ((uchar *) ibuf->rect) + x;
-			newrect = _newrect + x;
+			newrect = data->newrect + x;
 		}
 		if (do_float) {
 			rectf = ibuf->rect_float + x;
-			newrectf = _newrectf + x;
+			newrectf = data->newrectf + x;
 		}
 		
 		sample = 0.0f;
@@ -1119,33 +1133,68 @@ static ImBuf *scaledowny(struct ImBuf *ibuf, int newy)
 			
 			sample -= 1.0f;
 		}
+
+		/* see bug [#26502] */
+		BLI_assert(!do_rect || (uchar *)rect - ((uchar *)ibuf->rect) == rect_size + x);
+		BLI_assert(!do_float || (rectf - ibuf->rect_float) == rect_size + x);
 	}
+	(void)rect_size; /* UNUSED in release builds */
+}
+
+static ImBuf *scaledowny(struct ImBuf *ibuf, int newy)
+{
+	const int do_rect = (ibuf->rect != NULL);
+	const int do_float = (ibuf->rect_float != NULL);
+
+	ScaleLinesData data;
+	uchar *_newrect = NULL;
+	float *_newrectf = NULL;
+
+	if (!do_rect && !do_float) return (ibuf);
+
+	if (do_rect) {
+		_newrect = MEM_mallocN(newy * ibuf->x * sizeof(uchar) * 4, "scaledowny");
+		if (_newrect == NULL) return(ibuf);
+	}
+	if (do_float) {
+		_newrectf = MEM_mallocN(newy * ibuf->x * sizeof(float) * 4, "scaledownyf");
+		if (_newrectf == NULL) {
+			if (_newrect) MEM_freeN(_newrect);
+			return(ibuf);
+		}
+	}
+
+	data.ibuf = ibuf;
+	data.newsize = newy;
+	data.newrect = _newrect;
+	data.newrectf = _newrectf;
+	IMB_processor_apply_threaded_scanlines(ibuf->x, scaledowny_lines, &data);
 
 	if (do_rect) {
-		// printf("%ld %ld\n", (uchar *)rect - ((uchar *)ibuf->rect), rect_size);
-		BLI_assert((uchar *)rect - ((uchar *)ibuf->rect) == rect_size); /* see bug [#26502] */
 		imb_freerectImBuf(ibuf);
 		ibuf->mall |= IB_rect;
 		ibuf->rect = (unsigned int *) _newrect;
 	}
 	if (do_float) {
-		// printf("%ld %ld\n", rectf - ibuf->rect_float, rect_size);
-		BLI_assert((rectf - ibuf->rect_float) == rect_size); /* see bug [#26502] */
 		imb_freerectfloatImBuf(ibuf);
 		ibuf->mall |= IB_rectfloat;
 		ibuf->rect_float = (float *) _newrectf;
 	}
-	(void)rect_size; /* UNUSED in release builds */
-	
+
 	ibuf->y = newy;
 	return(ibuf);
 }
 
 
-static ImBuf *scaleupx(struct ImBuf *ibuf, int newx)
+static void scaleupx_lines(void *data_v, int start_line, int num_lines)
 {
-	uchar *rect, *_newrect = NULL, *newrect;
-	float *rectf, *_newrectf = NULL, *newrectf;
+	ScaleLinesData *data = (ScaleLinesData *)data_v;
+	ImBuf *ibuf = data->ibuf;
+	const int newx = data->newsize;
+	const bool do_rect = (data->newrect != NULL);
+	const bool do_float = (data->newrectf != NULL);
+	uchar *rect = NULL, *newrect = NULL;
+	float *rectf = NULL, *newrectf = NULL;
 	float sample, add;
 	float val_a, nval_a, diff_a;
 	float val_b, nval_b, diff_b;
@@ -1156,41 +1205,22 @@ static ImBuf *scaleupx(struct ImBuf *ibuf, int newx)
 	float val_gf, nval_gf, diff_gf;
 	float val_rf, nval_rf, diff_rf;
 	int x, y;
-	bool do_rect = false, do_float = false;
 
 	val_a = nval_a = diff_a = val_b = nval_b = diff_b = 0;
 	val_g = nval_g = diff_g = val_r = nval_r = diff_r = 0;
 	val_af = nval_af = diff_af = val_bf = nval_bf = diff_bf = 0;
 	val_gf = nval_gf = diff_gf = val_rf = nval_rf = diff_rf = 0;
-	if (ibuf == NULL) return(NULL);
-	if (ibuf->rect == NULL && ibuf->rect_float == NULL) return (ibuf);
-
-	if (ibuf->rect) {
-		do_rect = true;
-		_newrect = MEM_mallocN(newx * ibuf->y * sizeof(int), "scaleupx");
-		if (_newrect == NULL) return(ibuf);
-	}
-	if (ibuf->rect_float) {
-		do_float = true;
-		_newrectf = MEM_mallocN(newx * ibuf->y * sizeof(float) * 4, "scaleupxf");
-		if (_newrectf == NULL) {
-			if (_newrect) MEM_freeN(_newrect);
-			return(ibuf);
-		}
-	}
 
 	add = (ibuf->x - 1.001) / (newx - 1.0);
 
-	rect = (uchar *) ibuf->rect;
-	rectf = (float *) ibuf->rect_float;
-	newrect = _newrect;
-	newrectf = _newrectf;
-
-	for (y = ibuf->y; y > 0; y--) {
+	for (y = start_line; y < start_line + num_lines; y++) {
 
 		sample = 0;
 		
 		if (do_rect) {
+			rect = (uchar *) ibuf->rect + (size_t)4 * ibuf->x * y;
+			newrect = data->newrect + (size_t)4 * newx * y;
+
 			val_a = rect[0];
 			nval_a = rect[4];
 			diff_a = nval_a - val_a;
@@ -1214,6 +1244,9 @@ static ImBuf *scaleupx(struct ImBuf *ibuf, int newx)
 			rect += 8;
 		}
 		if (do_float) {
+			rectf = ibuf->rect_float + (size_t)4 * ibuf->x * y;
+			newrectf = data->newrectf + (size_t)4 * newx * y;
+
 			val_af = rectf[0];
 			nval_af = rectf[4];
 			diff_af = nval_af - val_af;
@@ -1294,6 +1327,37 @@ static ImBuf *scaleupx(struct ImBuf *ibuf, int newx)
 			sample += add;
 		}
 	}
+}
+
+static ImBuf *scaleupx(struct ImBuf *ibuf, int newx)
+{
+	ScaleLinesData data;
+	uchar *_newrect = NULL;
+	float *_newrectf = NULL;
+	bool do_rect = false, do_float = false;
+
+	if (ibuf == NULL) return(NULL);
+	if (ibuf->rect == NULL && ibuf->rect_float == NULL) return (ibuf);
+
+	if (ibuf->rect) {
+		do_rect = true;
+		_newrect = MEM_mallocN(newx * ibuf->y * sizeof(int), "scaleupx");
+		if (_newrect == NULL) return(ibuf);
+	}
+	if (ibuf->rect_float) {
+		do_float = true;
+		_newrectf = MEM_mallocN(newx * ibuf->y * sizeof(float) * 4, "scaleupxf");
+		if (_newrectf == NULL) {
+			if (_newrect) MEM_freeN(_newrect);
+			return(ibuf);
+		}
+	}
+
+	data.ibuf = ibuf;
+	data.newsize = newx;
+	data.newrect = _newrect;
+	data.newrectf = _newrectf;
+	IMB_processor_apply_threaded_scanlines(ibuf->y, scaleupx_lines, &data);
 
 	if (do_rect) {
 		imb_freerectImBuf(ibuf);
@@ -1310,10 +1374,15 @@ static ImBuf *scaleupx(struct ImBuf *ibuf, int newx)
 	return(ibuf);
 }
 
-static ImBuf *scaleupy(struct ImBuf *ibuf, int newy)
+static void scaleupy_lines(void *data_v, int start_line, int num_lines)
 {
-	uchar *rect, *_newrect = NULL, *newrect;
-	float *rectf, *_newrectf = NULL, *newrectf;
+	ScaleLinesData *data = (ScaleLinesData *)data_v;
+	ImBuf *ibuf = data->ibuf;
+	const int newy = data->newsize;
+	const bool do_rect = (data->newrect != NULL);
+	const bool do_float = (data->newrectf != NULL);
+	uchar *rect = NULL, *newrect = NULL;
+	float *rectf = NULL, *newrectf = NULL;
 	float sample, add;
 	float val_a, nval_a, diff_a;
 	float val_b, nval_b, diff_b;
@@ -1324,43 +1393,21 @@ static ImBuf *scaleupy(struct ImBuf *ibuf, int newy)
 	float val_gf, nval_gf, diff_gf;
 	float val_rf, nval_rf, diff_rf;
 	int x, y, skipx;
-	bool do_rect = false, do_float = false;
 
 	val_a = nval_a = diff_a = val_b = nval_b = diff_b = 0;
 	val_g = nval_g = diff_g = val_r = nval_r = diff_r = 0;
 	val_af = nval_af = diff_af = val_bf = nval_bf = diff_bf = 0;
 	val_gf = nval_gf = diff_gf = val_rf = nval_rf = diff_rf = 0;
-	if (ibuf == NULL) return(NULL);
-	if (ibuf->rect == NULL && ibuf->rect_float == NULL) return (ibuf);
-
-	if (ibuf->rect) {
-		do_rect = true;
-		_newrect = MEM_mallocN(ibuf->x * newy * sizeof(int), "scaleupy");
-		if (_newrect == NULL) return(ibuf);
-	}
-	if (ibuf->rect_float) {
-		do_float = true;
-		_newrectf = MEM_mallocN(ibuf->x * newy * sizeof(float) * 4, "scaleupyf");
-		if (_newrectf == NULL) {
-			if (_newrect) MEM_freeN(_newrect);
-			return(ibuf);
-		}
-	}
 
 	add = (ibuf->y - 1.001) / (newy - 1.0);
 	skipx = 4 * ibuf->x;
 
-	rect = (uchar *) ibuf->rect;
-	rectf = (float *) ibuf->rect_float;
-	newrect = _newrect;
-	newrectf = _newrectf;
-
-	for (x = ibuf->x; x > 0; x--) {
+	for (x = start_line; x < start_line + num_lines; x++) {
 
 		sample = 0;
 		if (do_rect) {
-			rect = ((uchar *)ibuf->rect) + 4 * (x - 1);
-			newrect = _newrect + 4 * (x - 1);
+			rect = ((uchar *)ibuf->rect) + 4 * x;
+			newrect = data->newrect + 4 * x;
 
 			val_a = rect[0];
 			nval_a = rect[skipx];
@@ -1385,8 +1432,8 @@ static ImBuf *scaleupy(struct ImBuf *ibuf, int newy)
 			rect += 2 * skipx;
 		}
 		if (do_float) {
-			rectf = ibuf->rect_float + 4 * (x - 1);
-			newrectf = _newrectf + 4 * (x - 1);
+			rectf = ibuf->rect_float + 4 * x;
+			newrectf = data->newrectf + 4 * x;
 
 			val_af = rectf[0];
 			nval_af = rectf[skipx];
@@ -1469,6 +1516,37 @@ static ImBuf *scaleupy(struct ImBuf *ibuf, int newy)
 			sample += add;
 		}
 	}
+}
+
+static ImBuf *scaleupy(struct ImBuf *ibuf, int newy)
+{
+	ScaleLinesData data;
+	uchar *_newrect = NULL;
+	float *_newrectf = NULL;
+	bool do_rect = false, do_float = false;
+
+	if (ibuf == NULL) return(NULL);
+	if (ibuf->rect == NULL && ibuf->rect_float == NULL) return (ibuf);
+
+	if (ibuf->rect) {
+		do_rect = true;
+		_newrect = MEM_mallocN(ibuf->x * newy * sizeof(int), "scaleupy");
+		if (_newrect == NULL) return(ibuf);
+	}
+	if (ibuf->rect_float) {
+		do_float = true;
+		_newrectf = MEM_mallocN(ibuf->x * newy * sizeof(float) * 4, "scaleupyf");
+		if (_newrectf == NULL) {
+			if (_newrect) MEM_freeN(_newrect);
+			return(ibuf);
+		}
+	}
+
+	data.ibuf = ibuf;
+	data.newsize = newy;
+	data.newrect = _newrect;
+	data.newrectf = _newrectf;
+	IMB_processor_apply_threaded_scanlines(ibuf->x, scaleupy_lines, &data);
 
 	if (do_rect) {
 		imb_freerectImBuf(ibuf);
@@ -1579,16 +1657,61 @@ struct imbufRGBA {
 	float r, g, b, a;
 };
 
-struct ImBuf *IMB_scalefastImBuf(struct ImBuf *ibuf, unsigned int newx, unsigned int newy)
+typedef struct ScaleFastData {
+	ImBuf *ibuf;
+	unsigned int newx;
+	unsigned int *newrect;
+	struct imbufRGBA *newrectf;
+	size_t stepx, stepy;
+} ScaleFastData;
+
+static void scalefast_lines(void *data_v, int start_line, int num_lines)
 {
-	unsigned int *rect, *_newrect, *newrect;
-	struct imbufRGBA *rectf, *_newrectf, *newrectf;
+	ScaleFastData *data = (ScaleFastData *)data_v;
+	ImBuf *ibuf = data->ibuf;
+	const unsigned int newx = data->newx;
+	const size_t stepx = data->stepx, stepy = data->stepy;
+	unsigned int *rect, *newrect = NULL;
+	struct imbufRGBA *rectf, *newrectf = NULL;
+	size_t ofsx, ofsy;
 	int x, y;
-	bool do_float = false, do_rect = false;
-	size_t ofsx, ofsy, stepx, stepy;
 
-	rect = NULL; _newrect = NULL; newrect = NULL;
-	rectf = NULL; _newrectf = NULL; newrectf = NULL;
+	if (data->newrect)
+		newrect = data->newrect + (size_t)newx * start_line;
+	if (data->newrectf)
+		newrectf = data->newrectf + (size_t)newx * start_line;
+
+	ofsy = 32768 + stepy * start_line;
+
+	for (y = num_lines; y > 0; y--, ofsy += stepy) {
+		if (newrect) {
+			rect = ibuf->rect;
+			rect += (ofsy >> 16) * ibuf->x;
+			ofsx = 32768;
+
+			for (x = newx; x > 0; x--, ofsx += stepx) {
+				*newrect++ = rect[ofsx >> 16];
+			}
+		}
+
+		if (newrectf) {
+			rectf = (struct imbufRGBA *)ibuf->rect_float;
+			rectf += (ofsy >> 16) * ibuf->x;
+			ofsx = 32768;
+
+			for (x = newx; x > 0; x--, ofsx += stepx) {
+				*newrectf++ = rectf[ofsx >> 16];
+			}
+		}
+	}
+}
+
+struct ImBuf *IMB_scalefastImBuf(struct ImBuf *ibuf, unsigned int newx, unsigned int newy)
+{
+	unsigned int *_newrect = NULL;
+	struct imbufRGBA *_newrectf = NULL;
+	bool do_float = false, do_rect = false;
+	ScaleFastData data;
 
 	if (ibuf == NULL) return(NULL);
 	if (ibuf->rect) do_rect = true;
@@ -1600,7 +1723,6 @@ struct ImBuf *IMB_scalefastImBuf(struct ImBuf *ibuf, unsigned int newx, unsigned
 	if (do_rect) {
 		_newrect = MEM_mallocN(newx * newy * sizeof(int), "scalefastimbuf");
 		if (_newrect == NULL) return(ibuf);
-		newrect = _newrect;
 	}
 	
 	if (do_float) {
@@ -1609,34 +1731,15 @@ struct ImBuf *IMB_scalefastImBuf(struct ImBuf *ibuf, unsigned int newx, unsigned
 			if (_newrect) MEM_freeN(_newrect);
 			return(ibuf);
 		}
-		newrectf = _newrectf;
 	}
 
-	stepx = (65536.0 * (ibuf->x - 1.0) / (newx - 1.0)) + 0.5;
-	stepy = (65536.0 * (ibuf->y - 1.0) / (newy - 1.0)) + 0.5;
-	ofsy = 32768;
-
-	for (y = newy; y > 0; y--, ofsy += stepy) {
-		if (do_rect) {
-			rect = ibuf->rect;
-			rect += (ofsy >> 16) * ibuf->x;
-			ofsx = 32768;
-
-			for (x = newx; x > 0; x--, ofsx += stepx) {
-				*newrect++ = rect[ofsx >> 16];
-			}
-		}
-
-		if (do_float) {
-			rectf = (struct imbufRGBA *)ibuf->rect_float;
-			rectf += (ofsy >> 16) * ibuf->x;
-			ofsx = 32768;
-
-			for (x = newx; x > 0; x--, ofsx += stepx) {
-				*newrectf++ = rectf[ofsx >> 16];
-			}
-		}
-	}
+	data.ibuf = ibuf;
+	data.newx = newx;
+	data.newrect = _newrect;
+	data.newrectf = _newrectf;
+	data.stepx = (65536.0 * (ibuf->x - 1.0) / (newx - 1.0)) + 0.5;
+	data.stepy = (65536.0 * (ibuf->y - 1.0) / (newy - 1.0)) + 0.5;
+	IMB_processor_apply_threaded_scanlines(newy, scalefast_lines, &data);
 
 	if (do_rect) {
 		imb_freerectImBuf(ibuf);
@@ -324,6 +324,7 @@ static ImBuf *thumb_create_ex(
 	short tsize = 128;
 	short ex, ey;
 	float scaledx, scaledy;
+	size_t full_width = 0, full_height = 0;
 	BLI_stat_t info;
 
 	switch (size) {
@@ -366,7 +367,8 @@ static ImBuf *thumb_create_ex(
 				if (img == NULL) {
 					switch (source) {
 						case THB_SOURCE_IMAGE:
-							img = IMB_loadiffname(file_path, IB_rect | IB_metadata, NULL);
+							/* may be decoded at a reduced size, but the metadata stores the full size */
+							img = IMB_thumb_load_image(file_path, tsize, &full_width, &full_height);
 							break;
 						case THB_SOURCE_BLEND:
 							img = IMB_thumb_load_blend(file_path, blen_group, blen_id);
@@ -377,14 +379,22 @@ static ImBuf *thumb_create_ex(
 						default:
 							BLI_assert(0); /* This should never happen */
 					}
+					if (img != NULL && source != THB_SOURCE_IMAGE) {
+						full_width = img->x;
+						full_height = img->y;
+					}
+				}
+				else {
+					full_width = img->x;
+					full_height = img->y;
 				}
 
 				if (img != NULL) {
 					if (BLI_stat(file_path, &info) != -1) {
 						BLI_snprintf(mtime, sizeof(mtime), "%ld", (long int)info.st_mtime);
 					}
-					BLI_snprintf(cwidth, sizeof(cwidth), "%d", img->x);
-					BLI_snprintf(cheight, sizeof(cheight), "%d", img->y);
+					BLI_snprintf(cwidth, sizeof(cwidth), "%d", (int)full_width);
+					BLI_snprintf(cheight, sizeof(cheight), "%d", (int)full_height);
 				}
 			}
 			else if (THB_SOURCE_MOVIE == source) {
@@ -266,6 +266,20 @@ typedef enum eFMod_Stepped_Flags {
  *
  * Defines how to access a dependency needed for a driver variable.
  */
+/* Cached RNA Path
+ *
+ * Result of resolving an RNA path, kept around so the path doesn't have to be
+ * parsed again on every evaluation. Only valid for the pointer it was resolved
+ * from, until BKE_animsys_rna_path_cache_invalidate() is called (runtime only).
+ */
+typedef struct RNAPathCache {
+	void *owner_id, *owner_data;	/* pointer the path was resolved from */
+	void *id, *type, *data;			/* resolved PointerRNA */
+	void *prop;						/* resolved PropertyRNA */
+	int index;						/* array index, -1 for non-array access */
+	int generation;					/* 0 when not resolved yet */
+} RNAPathCache;
+
 typedef struct DriverTarget {
 	ID 	*id;				/* ID-block which owns the target, no user count */
 	
@@ -276,6 +290,8 @@ typedef struct DriverTarget {
 	
 	short flag;				/* flags for the validity of the target (NOTE: these get reset every time the types change) */
 	int idtype;				/* type of ID-block that this target can use */
+
+	RNAPathCache rna_cache;	/* resolved rna_path (runtime) */
 } DriverTarget;
 
 /* Driver Target flags */
@@ -413,6 +429,7 @@ typedef struct ChannelDriver {
 	 */
 	char expression[256];	/* expression to compile for evaluation */
 	void *expr_comp; 		/* PyObject - compiled expression, don't save this */
+	struct SimpleExprParsed *expr_simple;	/* expression parsed for evaluation without Python, don't save this */
 	
 	float curval;		/* result of previous evaluation */
 	float influence;	/* influence of driver on result */ // XXX to be implemented... this is like the constraint influence setting
@@ -499,6 +516,11 @@ typedef struct FCurve {
 	float color[3];			/* the last-color this curve took */
 
 	float prev_norm_factor, prev_offset;
+
+		/* runtime evaluation cache */
+	int last_segment;		/* keyframe ending the segment found when last evaluated, only used as a search hint */
+	int pad;
+	RNAPathCache rna_cache;	/* resolved rna_path */
 } FCurve;
 
 
@@ -93,9 +93,13 @@ int DNA_struct_find_nr_ex(const struct SDNA *sdna, const char *str, unsigned int
 int DNA_struct_find_nr(const struct SDNA *sdna, const char *str);
 void DNA_struct_switch_endian(const struct SDNA *oldsdna, int oldSDNAnr, char *data);
 const char *DNA_struct_get_compareflags(const struct SDNA *sdna, const struct SDNA *newsdna);
+
+typedef struct DNA_ReconstructInfo DNA_ReconstructInfo;
+DNA_ReconstructInfo *DNA_reconstruct_info_create(
+        const struct SDNA *oldsdna, const struct SDNA *newsdna, const char *compflags);
+void DNA_reconstruct_info_free(DNA_ReconstructInfo *reconstruct_info);
 void *DNA_struct_reconstruct(
-        const struct SDNA *newsdna, const struct SDNA *oldsdna,
-        const char *compflags, int oldSDNAnr, int blocks, const void *data);
+        const DNA_ReconstructInfo *reconstruct_info, int oldSDNAnr, int blocks, const void *data);
 
 int DNA_elem_array_size(const char *str);
 int DNA_elem_offset(struct SDNA *sdna, const char *stype, const char *vartype, const char *name);
@@ -1227,6 +1227,8 @@ typedef enum RemeshModifierMode {
 	MOD_REMESH_MASS_POINT     = 1,
 	/* keeps sharp edges */
 	MOD_REMESH_SHARP_FEATURES = 2,
+	/* level-set of a voxel grid */
+	MOD_REMESH_VOXEL          = 3,
 } RemeshModifierMode;
 
 typedef struct RemeshModifierData {
@@ -1246,6 +1248,10 @@ typedef struct RemeshModifierData {
 	char flag;
 	char mode;
 	char pad;
+
+	/* size of the voxels, in object space */
+	float voxel_size;
+	int pad1;
 } RemeshModifierData;
 
 /* Skin modifier */
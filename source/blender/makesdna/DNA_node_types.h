@@ -219,6 +219,12 @@ typedef struct bNode {
 
 	float ssr_id; /* XXX: eevee only, id of screen space reflection layer, needs to be a float to feed GPU_uniform. */
 	float pad3;
+
+	/* statistics of the last compositor execution (runtime) */
+	float exec_time;		/* seconds spent on the operations of the node */
+	float exec_memory;		/* megabytes of the buffers written by the node */
+	int exec_chunks;		/* number of chunks the operations of the node were executed for */
+	int pad4;
 } bNode;
 
 /* node->flag */
@@ -413,6 +419,7 @@ typedef struct bNodeTree {
 #define NTREE_COM_GROUPNODE_BUFFER	8	/* use groupnode buffers */
 #define NTREE_VIEWER_BORDER			16	/* use a border for viewer nodes */
 #define NTREE_IS_LOCALIZED			32	/* tree is localized copy, free when deleting node groups */
+#define NTREE_COM_HALF_CACHE		64	/* store cached compositor results as half floats */
 
 /* XXX not nice, but needed as a temporary flags
  * for group updates after library linking.
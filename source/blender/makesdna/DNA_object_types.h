@@ -307,6 +307,8 @@ typedef struct Object {
 
 	/* Runtime valuated curve-specific data, not stored in the file */
 	struct CurveCache *curve_cache;
+	/* Runtime intermediate result of the modifier stack, not stored in the file */
+	struct ModifierStackCache *modifier_cache;
 
 	ListBase gpulamp;		/* runtime, for glsl lamp display only */
 	ListBase pc_ids;
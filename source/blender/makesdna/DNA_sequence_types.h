@@ -225,6 +225,9 @@ typedef struct Editing {
 	int over_ofs, over_cfra;
 	int over_flag, proxy_storage;
 	rctf over_border;
+
+	char cache_dir[1024]; /* 1024 = FILE_MAX */
+	int cache_flag, pad;
 } Editing;
 
 /* ************* Effect Variable Structs ********* */
@@ -393,6 +396,9 @@ typedef struct SequencerScopes {
 /* store proxies in project directory */
 #define SEQ_EDIT_PROXY_DIR_STORAGE 1
 
+/* Editor->cache_flag */
+#define SEQ_CACHE_DISK 1
+
 /* SpeedControlVars->flags */
 #define SEQ_SPEED_INTEGRATE      1
 /* #define SEQ_SPEED_BLEND          2 */ /* DEPRECATED */
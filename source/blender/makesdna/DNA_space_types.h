@@ -1159,6 +1159,7 @@ typedef enum eSpaceNode_Flag {
 	SNODE_NEW_SHADERS    = (1 << 11),
 	SNODE_PIN            = (1 << 12),
 	SNODE_SKIP_INSOFFSET = (1 << 13), /* automatically offset following nodes in a chain on insertion */
+	SNODE_SHOW_STATISTICS = (1 << 14), /* draw the compositor statistics of the nodes */
 } eSpaceNode_Flag;
 
 /* snode->texfrom */
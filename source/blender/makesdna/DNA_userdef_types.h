@@ -498,7 +498,7 @@ typedef struct UserDef {
 	short tb_leftmouse, tb_rightmouse;
 	struct SolidLight light[3];
 	short manipulator_flag, manipulator_size;
-	int pad3;
+	int texture_memory_limit;	/* MB of image textures kept in GPU memory, 0 for no limit */
 	short textimeout, texcollectrate;
 	short wmdrawmethod; /* eWM_DrawMethod */
 	short dragthreshold;
@@ -546,7 +546,8 @@ typedef struct UserDef {
 	short autokey_mode;		/* eAutokey_Mode, autokeying mode */
 	short autokey_flag;		/* flags for autokeying */
 	
-	short text_render, pad9;		/* options for text rendering */
+	short text_render;		/* options for text rendering */
+	short viewport_aa_samples;	/* jittered samples accumulated by the 3D view when idle, < 2 disables */
 
 	struct ColorBand coba_weight;	/* from texture.h */
 
@@ -627,6 +628,7 @@ typedef enum eUserPref_Flag {
 	USER_NONEGFRAMES		= (1 << 24),
 	USER_TXT_TABSTOSPACES_DISABLE	= (1 << 25),
 	USER_TOOLTIPS_PYTHON    = (1 << 26),
+	USER_SAVE_BACKGROUND	= (1 << 27),
 } eUserPref_Flag;
 
 /* bPathCompare.flag */
@@ -747,85 +747,72 @@ static eSDNA_Type sdna_type_nr(const char *dna_type)
 }
 
 /**
- * Converts a value of one primitive type to another.
- * Note there is no optimization for the case where otype and ctype are the same:
+ * Converts values of one primitive type to another.
+ * Note there is no optimization for the case where old_type and new_type are the same:
  * assumption is that caller will handle this case.
  *
- * \param ctype  Name of type to convert to
- * \param otype  Name of type to convert from
- * \param name  Field name to extract array-size information
- * \param curdata  Where to put converted data
- * \param olddata  Data of type otype to convert
+ * \param old_type  Type to convert from
+ * \param new_type  Type to convert to
+ * \param array_len  Number of elements to convert
+ * \param old_data  Data of type old_type to convert
+ * \param new_data  Where to put converted data
  */
-static void cast_elem(
-        const char *ctype, const char *otype, const char *name,
-        char *curdata, const char *olddata)
+static void cast_primitive_type(
+        const eSDNA_Type old_type, const eSDNA_Type new_type, const int array_len,
+        const char *old_data, char *new_data)
 {
+	const int old_elem_size = DNA_elem_type_size(old_type);
+	const int new_elem_size = DNA_elem_type_size(new_type);
 	double val = 0.0;
-	int arrlen, curlen = 1, oldlen = 1;
+	int a;
 
-	eSDNA_Type ctypenr, otypenr;
-
-	arrlen = DNA_elem_array_size(name);
-
-	if ( (otypenr = sdna_type_nr(otype)) == -1 ||
-	     (ctypenr = sdna_type_nr(ctype)) == -1)
-	{
-		return;
-	}
-
-	/* define lengths */
-	oldlen = DNA_elem_type_size(otypenr);
-	curlen = DNA_elem_type_size(ctypenr);
-
-	while (arrlen > 0) {
-		switch (otypenr) {
+	for (a = 0; a < array_len; a++) {
+		switch (old_type) {
 			case SDNA_TYPE_CHAR:
-				val = *olddata; break;
+				val = *old_data; break;
 			case SDNA_TYPE_UCHAR:
-				val = *( (unsigned char *)olddata); break;
+				val = *( (unsigned char *)old_data); break;
 			case SDNA_TYPE_SHORT:
-				val = *( (short *)olddata); break;
+				val = *( (short *)old_data); break;
 			case SDNA_TYPE_USHORT:
-				val = *( (unsigned short *)olddata); break;
+				val = *( (unsigned short *)old_data); break;
 			case SDNA_TYPE_INT:
-				val = *( (int *)olddata); break;
+				val = *( (int *)old_data); break;
 			case SDNA_TYPE_FLOAT:
-				val = *( (float *)olddata); break;
+				val = *( (float *)old_data); break;
 			case SDNA_TYPE_DOUBLE:
-				val = *( (double *)olddata); break;
+				val = *( (double *)old_data); break;
 			case SDNA_TYPE_INT64:
-				val = *( (int64_t *)olddata); break;
+				val = *( (int64_t *)old_data); break;
 			case SDNA_TYPE_UINT64:
-				val = *( (uint64_t *)olddata); break;
+				val = *( (uint64_t *)old_data); break;
 		}
-		
-		switch (ctypenr) {
+
+		switch (new_type) {
 			case SDNA_TYPE_CHAR:
-				*curdata = val; break;
+				*new_data = val; break;
 			case SDNA_TYPE_UCHAR:
-				*( (unsigned char *)curdata) = val; break;
+				*( (unsigned char *)new_data) = val; break;
 			case SDNA_TYPE_SHORT:
-				*( (short *)curdata) = val; break;
+				*( (short *)new_data) = val; break;
 			case SDNA_TYPE_USHORT:
-				*( (unsigned short *)curdata) = val; break;
+				*( (unsigned short *)new_data) = val; break;
 			case SDNA_TYPE_INT:
-				*( (int *)curdata) = val; break;
+				*( (int *)new_data) = val; break;
 			case SDNA_TYPE_FLOAT:
-				if (otypenr < 2) val /= 255;
-				*( (float *)curdata) = val; break;
+				if (old_type < 2) val /= 255;
+				*( (float *)new_data) = val; break;
 			case SDNA_TYPE_DOUBLE:
-				if (otypenr < 2) val /= 255;
-				*( (double *)curdata) = val; break;
+				if (old_type < 2) val /= 255;
+				*( (double *)new_data) = val; break;
 			case SDNA_TYPE_INT64:
-				*( (int64_t *)curdata) = val; break;
+				*( (int64_t *)new_data) = val; break;
 			case SDNA_TYPE_UINT64:
-				*( (uint64_t *)curdata) = val; break;
+				*( (uint64_t *)new_data) = val; break;
 		}
 
-		olddata += oldlen;
-		curdata += curlen;
-		arrlen--;
+		old_data += old_elem_size;
+		new_data += new_elem_size;
 	}
 }
 
@@ -833,45 +820,25 @@ static void cast_elem(
  * Converts pointer values between different sizes. These are only used
  * as lookup keys to identify data blocks in the saved .blend file, not
  * as actual in-memory pointers.
- *
- * \param curlen  Pointer length to conver to
- * \param oldlen  Length of pointers in olddata
- * \param name  Field name to extract array-size information
- * \param curdata  Where to put converted data
- * \param olddata  Data to convert
  */
-static void cast_pointer(int curlen, int oldlen, const char *name, char *curdata, const char *olddata)
+static void cast_pointer_64_to_32(const int array_len, const int64_t *old_data, int32_t *new_data)
 {
-	int64_t lval;
-	int arrlen;
-	
-	arrlen = DNA_elem_array_size(name);
-	
-	while (arrlen > 0) {
-	
-		if (curlen == oldlen) {
-			memcpy(curdata, olddata, curlen);
-		}
-		else if (curlen == 4 && oldlen == 8) {
-			lval = *((int64_t *)olddata);
+	int a;
 
-			/* WARNING: 32-bit Blender trying to load file saved by 64-bit Blender,
-			 * pointers may lose uniqueness on truncation! (Hopefully this wont
-			 * happen unless/until we ever get to multi-gigabyte .blend files...) */
-			*((int *)curdata) = lval >> 3;
-		}
-		else if (curlen == 8 && oldlen == 4) {
-			*((int64_t *)curdata) = *((int *)olddata);
-		}
-		else {
-			/* for debug */
-			printf("errpr: illegal pointersize!\n");
-		}
-		
-		olddata += oldlen;
-		curdata += curlen;
-		arrlen--;
+	for (a = 0; a < array_len; a++) {
+		/* WARNING: 32-bit Blender trying to load file saved by 64-bit Blender,
+		 * pointers may lose uniqueness on truncation! (Hopefully this wont
+		 * happen unless/until we ever get to multi-gigabyte .blend files...) */
+		new_data[a] = (int32_t)(old_data[a] >> 3);
+	}
+}
+
+static void cast_pointer_32_to_64(const int array_len, const int32_t *old_data, int64_t *new_data)
+{
+	int a;
 
+	for (a = 0; a < array_len; a++) {
+		new_data[a] = old_data[a];
 	}
 }
 
@@ -941,210 +908,6 @@ static const char *find_elem(
 	return NULL;
 }
 
-/**
- * Converts the contents of a single field of a struct, of a non-struct type,
- * from oldsdna to newsdna format.
- *
- * \param newsdna  SDNA of current Blender
- * \param oldsdna  SDNA of Blender that saved file
- * \param type  current field type name
- * \param name  current field name
- * \param curdata  put field data converted to newsdna here
- * \param old  pointer to struct info in oldsdna
- * \param olddata  struct contents laid out according to oldsdna
- */
-static void reconstruct_elem(
-        const SDNA *newsdna,
-        const SDNA *oldsdna,
-        const char *type,
-        const char *name,
-        char *curdata,
-        const short *old,
-        const char *olddata)
-{
-	/* rules: test for NAME:
-	 *      - name equal:
-	 *          - cast type
-	 *      - name partially equal (array differs)
-	 *          - type equal: memcpy
-	 *          - types casten
-	 * (nzc 2-4-2001 I want the 'unsigned' bit to be parsed as well. Where
-	 * can I force this?)
-	 */
-	int a, elemcount, len, countpos, oldsize, cursize, mul;
-	const char *otype, *oname, *cp;
-	
-	/* is 'name' an array? */
-	cp = name;
-	countpos = 0;
-	while (*cp && *cp != '[') {
-		cp++; countpos++;
-	}
-	if (*cp != '[') countpos = 0;
-	
-	/* in old is the old struct */
-	elemcount = old[1];
-	old += 2;
-	for (a = 0; a < elemcount; a++, old += 2) {
-		otype = oldsdna->types[old[0]];
-		oname = oldsdna->names[old[1]];
-		len = elementsize(oldsdna, old[0], old[1]);
-		
-		if (strcmp(name, oname) == 0) { /* name equal */
-			
-			if (ispointer(name)) {  /* pointer of functionpointer afhandelen */
-				cast_pointer(newsdna->pointerlen, oldsdna->pointerlen, name, curdata, olddata);
-			}
-			else if (strcmp(type, otype) == 0) {    /* type equal */
-				memcpy(curdata, olddata, len);
-			}
-			else {
-				cast_elem(type, otype, name, curdata, olddata);
-			}
-
-			return;
-		}
-		else if (countpos != 0) {  /* name is an array */
-
-			if (oname[countpos] == '[' && strncmp(name, oname, countpos) == 0) {  /* basis equal */
-				
-				cursize = DNA_elem_array_size(name);
-				oldsize = DNA_elem_array_size(oname);
-
-				if (ispointer(name)) {  /* handle pointer or functionpointer */
-					cast_pointer(newsdna->pointerlen, oldsdna->pointerlen,
-					             cursize > oldsize ? oname : name,
-					             curdata, olddata);
-				}
-				else if (strcmp(type, otype) == 0) {  /* type equal */
-					mul = len / oldsize; /* size of single old array element */
-					mul *= (cursize < oldsize) ? cursize : oldsize; /* smaller of sizes of old and new arrays */
-					memcpy(curdata, olddata, mul);
-					
-					if (oldsize > cursize && strcmp(type, "char") == 0) {
-						/* string had to be truncated, ensure it's still null-terminated */
-						curdata[mul - 1] = '\0';
-					}
-				}
-				else {
-					cast_elem(type, otype,
-					          cursize > oldsize ? oname : name,
-					          curdata, olddata);
-				}
-				return;
-			}
-		}
-		olddata += len;
-	}
-}
-
-/**
- * Converts the contents of an entire struct from oldsdna to newsdna format.
- *
- * \param newsdna  SDNA of current Blender
- * \param oldsdna  SDNA of Blender that saved file
- * \param compflags
- *
- * Result from DNA_struct_get_compareflags to avoid needless conversions.
- * \param oldSDNAnr  Index of old struct definition in oldsdna
- * \param data  Struct contents laid out according to oldsdna
- * \param curSDNAnr  Index of current struct definition in newsdna
- * \param cur  Where to put converted struct contents
- */
-static void reconstruct_struct(
-        const SDNA *newsdna,
-        const SDNA *oldsdna,
-        const char *compflags,
-
-        int oldSDNAnr,
-        const char *data,
-        int curSDNAnr,
-        char *cur)
-{
-	/* Recursive!
-	 * Per element from cur_struct, read data from old_struct.
-	 * If element is a struct, call recursive.
-	 */
-	int a, elemcount, elen, eleno, mul, mulo, firststructtypenr;
-	const short *spo, *spc, *sppo;
-	const char *type;
-	const char *cpo;
-	char *cpc;
-	const char *name, *nameo;
-
-	unsigned int oldsdna_index_last = UINT_MAX;
-	unsigned int cursdna_index_last = UINT_MAX;
-
-
-	if (oldSDNAnr == -1) return;
-	if (curSDNAnr == -1) return;
-
-	if (compflags[oldSDNAnr] == SDNA_CMP_EQUAL) {
-		/* if recursive: test for equal */
-		spo = oldsdna->structs[oldSDNAnr];
-		elen = oldsdna->typelens[spo[0]];
-		memcpy(cur, data, elen);
-		
-		return;
-	}
-
-	firststructtypenr = *(newsdna->structs[0]);
-
-	spo = oldsdna->structs[oldSDNAnr];
-	spc = newsdna->structs[curSDNAnr];
-
-	elemcount = spc[1];
-
-	spc += 2;
-	cpc = cur;
-	for (a = 0; a < elemcount; a++, spc += 2) {  /* convert each field */
-		type = newsdna->types[spc[0]];
-		name = newsdna->names[spc[1]];
-		
-		elen = elementsize(newsdna, spc[0], spc[1]);
-
-		/* test: is type a struct? */
-		if (spc[0] >= firststructtypenr && !ispointer(name)) {
-			/* struct field type */
-			/* where does the old struct data start (and is there an old one?) */
-			cpo = (char *)find_elem(oldsdna, type, name, spo, data, &sppo);
-			
-			if (cpo) {
-				oldSDNAnr = DNA_struct_find_nr_ex(oldsdna, type, &oldsdna_index_last);
-				curSDNAnr = DNA_struct_find_nr_ex(newsdna, type, &cursdna_index_last);
-				
-				/* array! */
-				mul = DNA_elem_array_size(name);
-				nameo = oldsdna->names[sppo[1]];
-				mulo = DNA_elem_array_size(nameo);
-				
-				eleno = elementsize(oldsdna, sppo[0], sppo[1]);
-				
-				elen /= mul;
-				eleno /= mulo;
-				
-				while (mul--) {
-					reconstruct_struct(newsdna, oldsdna, compflags, oldSDNAnr, cpo, curSDNAnr, cpc);
-					cpo += eleno;
-					cpc += elen;
-					
-					/* new struct array larger than old */
-					mulo--;
-					if (mulo <= 0) break;
-				}
-			}
-			else {
-				cpc += elen;  /* skip field no longer present */
-			}
-		}
-		else {
-			/* non-struct field type */
-			reconstruct_elem(newsdna, oldsdna, type, name, cpc, spo, data);
-			cpc += elen;
-		}
-	}
-}
-
 /**
  * Does endian swapping on the fields of a struct value.
  *
@@ -1233,37 +996,448 @@ void DNA_struct_switch_endian(const SDNA *oldsdna, int oldSDNAnr, char *data)
 	}
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Struct Reconstruction
+ *
+ * Matching the fields of the old and new struct definitions by name is planned once
+ * for each struct of the old SDNA (see #DNA_reconstruct_info_create),
+ * each field gets a step that describes how its data is converted,
+ * so reconstructing many instances of a struct doesn't compare names for each of them.
+ *
+ * Rules for matching a field of the new struct with one of the old struct:
+ * - name equal:
+ *   - cast type
+ * - name partially equal (array differs)
+ *   - type equal: memcpy
+ *   - types casten
+ * \{ */
+
+typedef enum eReconstructStepType {
+	RECONSTRUCT_STEP_MEMCPY,
+	RECONSTRUCT_STEP_CAST_PRIMITIVE,
+	RECONSTRUCT_STEP_CAST_POINTER_TO_32,
+	RECONSTRUCT_STEP_CAST_POINTER_TO_64,
+	RECONSTRUCT_STEP_SUBSTRUCT,
+} eReconstructStepType;
+
+typedef struct ReconstructStep {
+	eReconstructStepType type;
+	int old_offset, new_offset;
+	union {
+		struct {
+			int size;
+			/* a string had to be truncated, ensure it's still null-terminated */
+			bool null_terminate;
+		} memcpy;
+		struct {
+			int array_len;
+			eSDNA_Type old_type, new_type;
+		} cast_primitive;
+		struct {
+			int array_len;
+		} cast_pointer;
+		struct {
+			int array_len;
+			int old_stride, new_stride;
+			int old_struct_nr, new_struct_nr;
+		} substruct;
+	} data;
+} ReconstructStep;
+
+struct DNA_ReconstructInfo {
+	const SDNA *oldsdna;
+	const SDNA *newsdna;
+	const char *compflags;
+
+	/* Per struct of 'oldsdna', only set for the ones that aren't equal. */
+	int *new_struct_nrs;
+	int *steps_len;
+	ReconstructStep **steps;
+};
+
 /**
- * \param newsdna  SDNA of current Blender
- * \param oldsdna  SDNA of Blender that saved file
- * \param compflags
+ * Add a step memory copying, merged with the previous step when the data is contiguous.
+ */
+static void reconstruct_steps_add_memcpy(
+        ReconstructStep *steps, int *steps_len,
+        const int old_offset, const int new_offset, const int size, const bool null_terminate)
+{
+	ReconstructStep *step;
+
+	if (size <= 0) {
+		return;
+	}
+
+	if (*steps_len != 0) {
+		step = &steps[*steps_len - 1];
+		if ((step->type == RECONSTRUCT_STEP_MEMCPY) &&
+		    (step->data.memcpy.null_terminate == false) &&
+		    (step->old_offset + step->data.memcpy.size == old_offset) &&
+		    (step->new_offset + step->data.memcpy.size == new_offset))
+		{
+			step->data.memcpy.size += size;
+			step->data.memcpy.null_terminate = null_terminate;
+			return;
+		}
+	}
+
+	step = &steps[(*steps_len)++];
+	step->type = RECONSTRUCT_STEP_MEMCPY;
+	step->old_offset = old_offset;
+	step->new_offset = new_offset;
+	step->data.memcpy.size = size;
+	step->data.memcpy.null_terminate = null_terminate;
+}
+
+static void reconstruct_steps_add_cast_pointer(
+        const SDNA *oldsdna, const SDNA *newsdna,
+        ReconstructStep *steps, int *steps_len,
+        const int old_offset, const int new_offset, const int array_len)
+{
+	ReconstructStep *step;
+
+	if (newsdna->pointerlen == oldsdna->pointerlen) {
+		reconstruct_steps_add_memcpy(steps, steps_len, old_offset, new_offset, array_len * newsdna->pointerlen, false);
+		return;
+	}
+	else if (newsdna->pointerlen == 4 && oldsdna->pointerlen == 8) {
+		step = &steps[(*steps_len)++];
+		step->type = RECONSTRUCT_STEP_CAST_POINTER_TO_32;
+	}
+	else if (newsdna->pointerlen == 8 && oldsdna->pointerlen == 4) {
+		step = &steps[(*steps_len)++];
+		step->type = RECONSTRUCT_STEP_CAST_POINTER_TO_64;
+	}
+	else {
+		/* for debug */
+		printf("errpr: illegal pointersize!\n");
+		return;
+	}
+
+	step->old_offset = old_offset;
+	step->new_offset = new_offset;
+	step->data.cast_pointer.array_len = array_len;
+}
+
+static void reconstruct_steps_add_cast_primitive(
+        ReconstructStep *steps, int *steps_len,
+        const char *otype, const char *type,
+        const int old_offset, const int new_offset, const int array_len)
+{
+	const eSDNA_Type old_type = sdna_type_nr(otype);
+	const eSDNA_Type new_type = sdna_type_nr(type);
+	ReconstructStep *step;
+
+	if (old_type == -1 || new_type == -1) {
+		return;
+	}
+
+	step = &steps[(*steps_len)++];
+	step->type = RECONSTRUCT_STEP_CAST_PRIMITIVE;
+	step->old_offset = old_offset;
+	step->new_offset = new_offset;
+	step->data.cast_primitive.array_len = array_len;
+	step->data.cast_primitive.old_type = old_type;
+	step->data.cast_primitive.new_type = new_type;
+}
+
+/**
+ * Add the step converting a single field of a struct, of a non-struct type.
+ *
+ * \param type  current field type name
+ * \param name  current field name
+ * \param new_offset  offset of the field in the current struct
+ * \param spo  pointer to struct info in oldsdna
+ */
+static void reconstruct_steps_add_elem(
+        const SDNA *newsdna, const SDNA *oldsdna,
+        ReconstructStep *steps, int *steps_len,
+        const char *type, const char *name, const int new_offset,
+        const short *spo)
+{
+	/* (nzc 2-4-2001 I want the 'unsigned' bit to be parsed as well. Where
+	 * can I force this?) */
+	int a, elemcount, len, countpos, oldsize, cursize, mul;
+	int old_offset = 0;
+	const char *otype, *oname, *cp;
+
+	/* is 'name' an array? */
+	cp = name;
+	countpos = 0;
+	while (*cp && *cp != '[') {
+		cp++; countpos++;
+	}
+	if (*cp != '[') countpos = 0;
+
+	/* in old is the old struct */
+	elemcount = spo[1];
+	spo += 2;
+	for (a = 0; a < elemcount; a++, spo += 2) {
+		otype = oldsdna->types[spo[0]];
+		oname = oldsdna->names[spo[1]];
+		len = elementsize(oldsdna, spo[0], spo[1]);
+
+		if (strcmp(name, oname) == 0) { /* name equal */
+
+			if (ispointer(name)) {  /* pointer of functionpointer afhandelen */
+				reconstruct_steps_add_cast_pointer(
+				        oldsdna, newsdna, steps, steps_len, old_offset, new_offset, DNA_elem_array_size(name));
+			}
+			else if (strcmp(type, otype) == 0) {    /* type equal */
+				reconstruct_steps_add_memcpy(steps, steps_len, old_offset, new_offset, len, false);
+			}
+			else {
+				reconstruct_steps_add_cast_primitive(
+				        steps, steps_len, otype, type, old_offset, new_offset, DNA_elem_array_size(name));
+			}
+
+			return;
+		}
+		else if (countpos != 0) {  /* name is an array */
+
+			if (oname[countpos] == '[' && strncmp(name, oname, countpos) == 0) {  /* basis equal */
+
+				cursize = DNA_elem_array_size(name);
+				oldsize = DNA_elem_array_size(oname);
+
+				if (ispointer(name)) {  /* handle pointer or functionpointer */
+					reconstruct_steps_add_cast_pointer(
+					        oldsdna, newsdna, steps, steps_len, old_offset, new_offset, MIN2(cursize, oldsize));
+				}
+				else if (strcmp(type, otype) == 0) {  /* type equal */
+					mul = len / oldsize; /* size of single old array element */
+					mul *= (cursize < oldsize) ? cursize : oldsize; /* smaller of sizes of old and new arrays */
+					reconstruct_steps_add_memcpy(
+					        steps, steps_len, old_offset, new_offset, mul,
+					        (oldsize > cursize && strcmp(type, "char") == 0));
+				}
+				else {
+					reconstruct_steps_add_cast_primitive(
+					        steps, steps_len, otype, type, old_offset, new_offset, MIN2(cursize, oldsize));
+				}
+				return;
+			}
+		}
+		old_offset += len;
+	}
+}
+
+/**
+ * Plan converting the contents of an entire struct from oldsdna to newsdna format.
  *
- * Result from DNA_struct_get_compareflags to avoid needless conversions
+ * \return the steps, at most one for each field of the current struct.
+ */
+static ReconstructStep *reconstruct_steps_create(
+        const SDNA *newsdna, const SDNA *oldsdna, const char *compflags,
+        const int oldSDNAnr, const int curSDNAnr, int *r_steps_len)
+{
+	const int firststructtypenr = *(newsdna->structs[0]);
+	const short *spo = oldsdna->structs[oldSDNAnr];
+	const short *spc = newsdna->structs[curSDNAnr];
+	const int elemcount = spc[1];
+	ReconstructStep *steps = MEM_mallocN(sizeof(*steps) * (size_t)MAX2(elemcount, 1), __func__);
+	int steps_len = 0;
+	int a, new_offset = 0;
+
+	spc += 2;
+	for (a = 0; a < elemcount; a++, spc += 2) {  /* convert each field */
+		const char *type = newsdna->types[spc[0]];
+		const char *name = newsdna->names[spc[1]];
+		const int elen = elementsize(newsdna, spc[0], spc[1]);
+
+		/* test: is type a struct? */
+		if (spc[0] >= firststructtypenr && !ispointer(name)) {
+			/* struct field type */
+			/* where does the old struct data start (and is there an old one?) */
+			const short *sppo = spo + 2;
+			int b, old_offset = 0;
+
+			for (b = 0; b < spo[1]; b++, sppo += 2) {
+				if (elem_strcmp(name, oldsdna->names[sppo[1]]) == 0) {  /* name equal */
+					if (strcmp(type, oldsdna->types[sppo[0]]) != 0) {  /* type differs */
+						b = spo[1];
+					}
+					break;
+				}
+				old_offset += elementsize(oldsdna, sppo[0], sppo[1]);
+			}
+
+			if (b < spo[1]) {
+				const int old_struct_nr = DNA_struct_find_nr(oldsdna, type);
+				const int new_struct_nr = DNA_struct_find_nr(newsdna, type);
+
+				if (old_struct_nr != -1 && new_struct_nr != -1) {
+					/* array! */
+					const int mul = DNA_elem_array_size(name);
+					const int mulo = DNA_elem_array_size(oldsdna->names[sppo[1]]);
+					const int new_stride = elen / mul;
+					const int old_stride = elementsize(oldsdna, sppo[0], sppo[1]) / mulo;
+					/* new struct array can be larger than old */
+					const int array_len = MIN2(mul, mulo);
+
+					if ((compflags[old_struct_nr] == SDNA_CMP_EQUAL) &&
+					    (old_stride == oldsdna->typelens[oldsdna->structs[old_struct_nr][0]]) &&
+					    (new_stride == old_stride))
+					{
+						reconstruct_steps_add_memcpy(
+						        steps, &steps_len, old_offset, new_offset, array_len * old_stride, false);
+					}
+					else {
+						ReconstructStep *step = &steps[steps_len++];
+						step->type = RECONSTRUCT_STEP_SUBSTRUCT;
+						step->old_offset = old_offset;
+						step->new_offset = new_offset;
+						step->data.substruct.array_len = array_len;
+						step->data.substruct.old_stride = old_stride;
+						step->data.substruct.new_stride = new_stride;
+						step->data.substruct.old_struct_nr = old_struct_nr;
+						step->data.substruct.new_struct_nr = new_struct_nr;
+					}
+				}
+			}
+			/* otherwise skip field no longer present */
+		}
+		else {
+			/* non-struct field type */
+			reconstruct_steps_add_elem(newsdna, oldsdna, steps, &steps_len, type, name, new_offset, spo);
+		}
+
+		new_offset += elen;
+	}
+
+	*r_steps_len = steps_len;
+	return steps;
+}
+
+/**
+ * Plan the conversion of all structs of \a oldsdna that differ from \a newsdna.
+ *
+ * \param compflags  Result from #DNA_struct_get_compareflags to avoid needless conversions,
+ * must stay valid while the result is used.
+ */
+DNA_ReconstructInfo *DNA_reconstruct_info_create(
+        const SDNA *oldsdna, const SDNA *newsdna, const char *compflags)
+{
+	DNA_ReconstructInfo *reconstruct_info = MEM_callocN(sizeof(*reconstruct_info), __func__);
+	int a;
+
+	reconstruct_info->oldsdna = oldsdna;
+	reconstruct_info->newsdna = newsdna;
+	reconstruct_info->compflags = compflags;
+	reconstruct_info->new_struct_nrs = MEM_mallocN(sizeof(int) * (size_t)oldsdna->nr_structs, __func__);
+	reconstruct_info->steps_len = MEM_callocN(sizeof(int) * (size_t)oldsdna->nr_structs, __func__);
+	reconstruct_info->steps = MEM_callocN(sizeof(ReconstructStep *) * (size_t)oldsdna->nr_structs, __func__);
+
+	for (a = 0; a < oldsdna->nr_structs; a++) {
+		const short *spo = oldsdna->structs[a];
+		const int curSDNAnr = DNA_struct_find_nr(newsdna, oldsdna->types[spo[0]]);
+
+		reconstruct_info->new_struct_nrs[a] = curSDNAnr;
+
+		if ((curSDNAnr != -1) && (compflags[a] != SDNA_CMP_EQUAL)) {
+			reconstruct_info->steps[a] = reconstruct_steps_create(
+			        newsdna, oldsdna, compflags, a, curSDNAnr, &reconstruct_info->steps_len[a]);
+		}
+	}
+
+	return reconstruct_info;
+}
+
+void DNA_reconstruct_info_free(DNA_ReconstructInfo *reconstruct_info)
+{
+	int a;
+
+	for (a = 0; a < reconstruct_info->oldsdna->nr_structs; a++) {
+		if (reconstruct_info->steps[a]) {
+			MEM_freeN(reconstruct_info->steps[a]);
+		}
+	}
+	MEM_freeN(reconstruct_info->steps);
+	MEM_freeN(reconstruct_info->steps_len);
+	MEM_freeN(reconstruct_info->new_struct_nrs);
+	MEM_freeN(reconstruct_info);
+}
+
+/**
+ * Converts the contents of an entire struct from oldsdna to newsdna format.
+ *
+ * \param oldSDNAnr  Index of old struct definition in oldsdna
+ * \param data  Struct contents laid out according to oldsdna
+ * \param cur  Where to put converted struct contents, zero initialized
+ */
+static void reconstruct_struct(
+        const DNA_ReconstructInfo *reconstruct_info,
+        const int oldSDNAnr,
+        const char *data,
+        char *cur)
+{
+	const ReconstructStep *step;
+	int a, b;
+
+	if (reconstruct_info->compflags[oldSDNAnr] == SDNA_CMP_EQUAL) {
+		/* if recursive: test for equal */
+		const SDNA *oldsdna = reconstruct_info->oldsdna;
+		memcpy(cur, data, oldsdna->typelens[oldsdna->structs[oldSDNAnr][0]]);
+		return;
+	}
+
+	step = reconstruct_info->steps[oldSDNAnr];
+	for (a = 0; a < reconstruct_info->steps_len[oldSDNAnr]; a++, step++) {
+		const char *old_data = data + step->old_offset;
+		char *new_data = cur + step->new_offset;
+
+		switch (step->type) {
+			case RECONSTRUCT_STEP_MEMCPY:
+				memcpy(new_data, old_data, (size_t)step->data.memcpy.size);
+				if (step->data.memcpy.null_terminate) {
+					new_data[step->data.memcpy.size - 1] = '\0';
+				}
+				break;
+			case RECONSTRUCT_STEP_CAST_PRIMITIVE:
+				cast_primitive_type(
+				        step->data.cast_primitive.old_type, step->data.cast_primitive.new_type,
+				        step->data.cast_primitive.array_len, old_data, new_data);
+				break;
+			case RECONSTRUCT_STEP_CAST_POINTER_TO_32:
+				cast_pointer_64_to_32(step->data.cast_pointer.array_len, (const int64_t *)old_data, (int32_t *)new_data);
+				break;
+			case RECONSTRUCT_STEP_CAST_POINTER_TO_64:
+				cast_pointer_32_to_64(step->data.cast_pointer.array_len, (const int32_t *)old_data, (int64_t *)new_data);
+				break;
+			case RECONSTRUCT_STEP_SUBSTRUCT:
+				for (b = 0; b < step->data.substruct.array_len; b++) {
+					reconstruct_struct(reconstruct_info, step->data.substruct.old_struct_nr, old_data, new_data);
+					old_data += step->data.substruct.old_stride;
+					new_data += step->data.substruct.new_stride;
+				}
+				break;
+		}
+	}
+}
+
+/**
+ * \param reconstruct_info  Result from #DNA_reconstruct_info_create
  * \param oldSDNAnr  Index of struct info within oldsdna
  * \param blocks  The number of array elements
  * \param data  Array of struct data
  * \return An allocated reconstructed struct
  */
 void *DNA_struct_reconstruct(
-        const SDNA *newsdna, const SDNA *oldsdna,
-        const char *compflags, int oldSDNAnr, int blocks, const void *data)
+        const DNA_ReconstructInfo *reconstruct_info, int oldSDNAnr, int blocks, const void *data)
 {
-	int a, curSDNAnr, curlen = 0, oldlen;
-	const short *spo, *spc;
+	const SDNA *oldsdna = reconstruct_info->oldsdna;
+	const SDNA *newsdna = reconstruct_info->newsdna;
+	const int curSDNAnr = reconstruct_info->new_struct_nrs[oldSDNAnr];
+	int a, curlen = 0, oldlen;
 	char *cur, *cpc;
 	const char *cpo;
-	const char *type;
-	
+
 	/* oldSDNAnr == structnr, we're looking for the corresponding 'cur' number */
-	spo = oldsdna->structs[oldSDNAnr];
-	type = oldsdna->types[spo[0]];
-	oldlen = oldsdna->typelens[spo[0]];
-	curSDNAnr = DNA_struct_find_nr(newsdna, type);
+	oldlen = oldsdna->typelens[oldsdna->structs[oldSDNAnr][0]];
 
 	/* init data and alloc */
 	if (curSDNAnr != -1) {
-		spc = newsdna->structs[curSDNAnr];
-		curlen = newsdna->typelens[spc[0]];
+		curlen = newsdna->typelens[newsdna->structs[curSDNAnr][0]];
 	}
 	if (curlen == 0) {
 		return NULL;
@@ -1273,7 +1447,7 @@ void *DNA_struct_reconstruct(
 	cpc = cur;
 	cpo = data;
 	for (a = 0; a < blocks; a++) {
-		reconstruct_struct(newsdna, oldsdna, compflags, oldSDNAnr, cpo, curSDNAnr, cpc);
+		reconstruct_struct(reconstruct_info, oldSDNAnr, cpo, cpc);
 		cpc += curlen;
 		cpo += oldlen;
 	}
@@ -1281,6 +1455,8 @@ void *DNA_struct_reconstruct(
 	return cur;
 }
 
+/** \} */
+
 /**
  * Returns the offset of the field with the specified name and type within the specified
  * struct type in sdna.
@@ -3598,6 +3598,20 @@ static int rna_property_array_length_all_dimensions(PointerRNA *ptr, PropertyRNA
 	return size;
 }
 
+/* Whether values can be converted between raw arrays directly, giving the same result as going
+ * through the RNA get/set functions. Chars are not handled since their signedness is unknown here,
+ * and integer items are only read since setting them goes through range checks. */
+static bool rna_raw_access_can_convert(RawPropertyType itemtype, RawPropertyType intype, int set)
+{
+	if (ELEM(PROP_RAW_CHAR, itemtype, intype) || ELEM(PROP_RAW_UNSET, itemtype, intype))
+		return false;
+
+	if (set && !ELEM(itemtype, PROP_RAW_FLOAT, PROP_RAW_DOUBLE))
+		return false;
+
+	return true;
+}
+
 static int rna_raw_access(ReportList *reports, PointerRNA *ptr, PropertyRNA *prop, const char *propname,
                           void *inarray, RawPropertyType intype, int inlen, int set)
 {
@@ -3656,6 +3670,14 @@ static int rna_raw_access(ReportList *reports, PointerRNA *ptr, PropertyRNA *pro
 
 				size = RNA_raw_type_sizeof(out.type) * arraylen;
 
+				if (out.stride == size) {
+					/* items are tightly packed, copy them all at once */
+					if (set) memcpy(outp, inp, (size_t)size * out.len);
+					else memcpy(inp, outp, (size_t)size * out.len);
+
+					return 1;
+				}
+
 				for (a = 0; a < out.len; a++) {
 					if (set) memcpy(outp, inp, size);
 					else memcpy(inp, outp, size);
@@ -3666,9 +3688,30 @@ static int rna_raw_access(ReportList *reports, PointerRNA *ptr, PropertyRNA *pro
 
 				return 1;
 			}
+			/* non-matching types, convert values without going through the RNA functions per item */
+			else if (rna_raw_access_can_convert(out.type, in.type, set)) {
+				RawArray item = out;
+				int a, j, i = 0;
 
-			/* could also be faster with non-matching types,
-			 * for now we just do slower loop .. */
+				for (a = 0; a < out.len; a++) {
+					item.array = (char *)out.array + (size_t)a * out.stride;
+
+					for (j = 0; j < arraylen; j++, i++) {
+						double value;
+
+						if (set) {
+							RAW_GET(double, value, in, i);
+							RAW_SET(double, item, j, value);
+						}
+						else {
+							RAW_GET(double, value, item, j);
+							RAW_SET(double, in, i, value);
+						}
+					}
+				}
+
+				return 1;
+			}
 		}
 	}
 
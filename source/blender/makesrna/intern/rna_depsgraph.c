@@ -131,6 +131,21 @@ static void rna_Depsgraph_debug_graphviz(Depsgraph *graph, const char *filename)
 	fclose(f);
 }
 
+static void rna_Depsgraph_debug_eval_trace(Depsgraph *graph, ReportList *reports, const char *filename)
+{
+	FILE *f = fopen(filename, "w");
+	if (f == NULL) {
+		BKE_reportf(reports, RPT_ERROR, "Cannot open file '%s' for writing", filename);
+		return;
+	}
+
+	if (!DEG_debug_eval_profile_write_trace(graph, f)) {
+		BKE_report(reports, RPT_WARNING, "No evaluation timing recorded, run with --debug-depsgraph-time");
+	}
+
+	fclose(f);
+}
+
 static void rna_Depsgraph_debug_rebuild(Depsgraph *UNUSED(graph), bContext *C)
 {
 	Main *bmain = CTX_data_main(C);
@@ -311,6 +326,14 @@ static void rna_def_depsgraph(BlenderRNA *brna)
 	                                "File in which to store graphviz debug output");
 	RNA_def_parameter_flags(parm, 0, PARM_REQUIRED);
 
+	func = RNA_def_function(srna, "debug_eval_trace", "rna_Depsgraph_debug_eval_trace");
+	RNA_def_function_ui_description(func, "Write timing of the last evaluation in Chrome trace format "
+	                                "(requires --debug-depsgraph-time)");
+	RNA_def_function_flag(func, FUNC_USE_REPORTS);
+	parm = RNA_def_string_file_path(func, "filename", NULL, FILE_MAX, "File Name",
+	                                "File in which to store the trace");
+	RNA_def_parameter_flags(parm, 0, PARM_REQUIRED);
+
 	func = RNA_def_function(srna, "debug_rebuild", "rna_Depsgraph_debug_rebuild");
 	RNA_def_function_flag(func, FUNC_USE_CONTEXT);
 
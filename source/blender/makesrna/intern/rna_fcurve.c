@@ -151,7 +151,7 @@ static void rna_ChannelDriver_update_expr(Main *bmain, Scene *scene, PointerRNA
 	ChannelDriver *driver = ptr->data;
 	
 	/* tag driver as needing to be recompiled */
-	driver->flag |= DRIVER_FLAG_RECOMPILE;
+	driver_invalidate_expression(driver, true, false);
 	
 	/* update_data() clears invalid flag and schedules for updates */
 	rna_ChannelDriver_update_data(bmain, scene, ptr);
@@ -181,11 +181,19 @@ static void rna_DriverTarget_update_data(Main *bmain, Scene *scene, PointerRNA *
 
 static void rna_DriverTarget_update_name(Main *bmain, Scene *scene, PointerRNA *ptr)
 {
-	ChannelDriver *driver = ptr->data;
-	rna_DriverTarget_update_data(bmain, scene, ptr);
+	DriverVar *dvar = ptr->data;
+	AnimData *adt = BKE_animdata_from_id(ptr->id.data);
+	FCurve *fcu;
 
-	driver->flag |= DRIVER_FLAG_RENAMEVAR;
+	rna_DriverTarget_update_data(bmain, scene, ptr);
 
+	/* this is called for the variable, find the driver it belongs to */
+	for (fcu = adt->drivers.first; fcu; fcu = fcu->next) {
+		if (fcu->driver && BLI_findindex(&fcu->driver->variables, dvar) != -1) {
+			driver_invalidate_expression(fcu->driver, false, true);
+			break;
+		}
+	}
 }
 
 /* ----------- */
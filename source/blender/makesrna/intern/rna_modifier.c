@@ -3831,6 +3831,8 @@ static void rna_def_modifier_remesh(BlenderRNA *brna)
 		{MOD_REMESH_MASS_POINT, "SMOOTH", 0, "Smooth", "Output a smooth surface with no sharp-features detection"},
 		{MOD_REMESH_SHARP_FEATURES, "SHARP", 0, "Sharp",
 		                            "Output a surface that reproduces sharp edges and corners from the input mesh"},
+		{MOD_REMESH_VOXEL, "VOXEL", 0, "Voxel",
+		                   "Output a smooth surface from a voxel grid, fast on dense meshes, the mesh should be closed"},
 		{0, NULL, 0, NULL, NULL}
 	};
 
@@ -3869,6 +3871,13 @@ static void rna_def_modifier_remesh(BlenderRNA *brna)
 	RNA_def_property_ui_text(prop, "Octree Depth", "Resolution of the octree; higher values give finer details");
 	RNA_def_property_update(prop, 0, "rna_Modifier_update");
 
+	prop = RNA_def_property(srna, "voxel_size", PROP_FLOAT, PROP_DISTANCE);
+	RNA_def_property_range(prop, 0.0001f, FLT_MAX);
+	RNA_def_property_ui_range(prop, 0.0001, 2, 0.1, 4);
+	RNA_def_property_ui_text(prop, "Voxel Size",
+	                         "Size of the voxels in object space; smaller values give finer details");
+	RNA_def_property_update(prop, 0, "rna_Modifier_update");
+
 	prop = RNA_def_property(srna, "sharpness", PROP_FLOAT, PROP_NONE);
 	RNA_def_property_float_sdna(prop, NULL, "hermite_num");
 	RNA_def_property_ui_range(prop, 0, 2, 0.1, 3);
@@ -7823,6 +7823,25 @@ static void rna_def_node(BlenderRNA *brna)
 	RNA_def_property_ui_text(prop, "Show Texture", "Draw node in viewport textured draw mode");
 	RNA_def_property_update(prop, 0, "rna_Node_update");
 
+	/* compositor statistics */
+	prop = RNA_def_property(srna, "execution_time", PROP_FLOAT, PROP_NONE);
+	RNA_def_property_float_sdna(prop, NULL, "exec_time");
+	RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+	RNA_def_property_ui_text(prop, "Execution Time",
+	                         "Seconds the last compositor execution spent on this node");
+
+	prop = RNA_def_property(srna, "execution_memory", PROP_FLOAT, PROP_NONE);
+	RNA_def_property_float_sdna(prop, NULL, "exec_memory");
+	RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+	RNA_def_property_ui_text(prop, "Execution Memory",
+	                         "Megabytes of the buffers written for this node in the last compositor execution");
+
+	prop = RNA_def_property(srna, "execution_chunks", PROP_INT, PROP_NONE);
+	RNA_def_property_int_sdna(prop, NULL, "exec_chunks");
+	RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+	RNA_def_property_ui_text(prop, "Execution Chunks",
+	                         "Number of chunks executed for this node in the last compositor execution");
+
 	/* generic property update function */
 	func = RNA_def_function(srna, "socket_value_update", "rna_Node_socket_value_update");
 	RNA_def_function_ui_description(func, "Update after property changes");
@@ -8311,6 +8330,11 @@ static void rna_def_composite_nodetree(BlenderRNA *brna)
 	RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_COM_GROUPNODE_BUFFER);
 	RNA_def_property_ui_text(prop, "Buffer Groups", "Enable buffering of group nodes");
 
+	prop = RNA_def_property(srna, "use_half_cache", PROP_BOOLEAN, PROP_NONE);
+	RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_COM_HALF_CACHE);
+	RNA_def_property_ui_text(prop, "Half Float Cache", "Keep cached color results of unchanged nodes as half floats "
+	                                                   "while editing, using less memory at the cost of precision");
+
 	prop = RNA_def_property(srna, "use_two_pass", PROP_BOOLEAN, PROP_NONE);
 	RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_TWO_PASS);
 	RNA_def_property_ui_text(prop, "Two Pass", "Use two pass execution during editing: first calculate fast nodes, "
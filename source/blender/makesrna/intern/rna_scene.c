@@ -7403,6 +7403,12 @@ static void rna_def_scene_image_format_data(BlenderRNA *brna)
 	RNA_def_property_ui_text(prop, "Preview", "When rendering animations, save JPG preview images in same directory");
 	RNA_def_property_update(prop, NC_SCENE | ND_RENDER_OPTIONS, NULL);
 
+	prop = RNA_def_property(srna, "use_exr_multipart", PROP_BOOLEAN, PROP_NONE);
+	RNA_def_property_boolean_sdna(prop, NULL, "flag", R_IMF_FLAG_EXR_MULTIPART);
+	RNA_def_property_ui_text(prop, "Multipart", "Store every render layer in a separate part of the file, "
+	                         "so single layers can be read without decoding the others (needs OpenEXR 2.0)");
+	RNA_def_property_update(prop, NC_SCENE | ND_RENDER_OPTIONS, NULL);
+
 	/* format specific */
 
 #ifdef WITH_OPENEXR
@@ -1660,6 +1660,19 @@ static void rna_def_editor(BlenderRNA *brna)
 	RNA_def_property_string_sdna(prop, NULL, "proxy_dir");
 	RNA_def_property_ui_text(prop, "Proxy Directory", "");
 	RNA_def_property_update(prop, NC_SPACE | ND_SPACE_SEQUENCER, "rna_SequenceEditor_update_cache");
+
+	prop = RNA_def_property(srna, "use_cache_disk", PROP_BOOLEAN, PROP_NONE);
+	RNA_def_property_boolean_sdna(prop, NULL, "cache_flag", SEQ_CACHE_DISK);
+	RNA_def_property_ui_text(prop, "Disk Cache",
+	                         "Store rendered frames on disk, so they are not rendered again after reloading the file");
+	RNA_def_property_update(prop, NC_SPACE | ND_SPACE_SEQUENCER, NULL);
+
+	prop = RNA_def_property(srna, "cache_directory", PROP_STRING, PROP_DIRPATH);
+	RNA_def_property_string_sdna(prop, NULL, "cache_dir");
+	RNA_def_property_ui_text(prop, "Cache Directory",
+	                         "Directory to store cached frames in, a sequencer_cache directory next to the "
+	                         "blend file when empty");
+	RNA_def_property_update(prop, NC_SPACE | ND_SPACE_SEQUENCER, NULL);
 }
 
 static void rna_def_filter_video(StructRNA *srna)
@@ -4095,6 +4095,13 @@ static void rna_def_userdef_system(BlenderRNA *brna)
 	                         "Time since last access of a GL texture in seconds after which it is freed "
 	                         "(set to 0 to keep textures allocated)");
 
+	prop = RNA_def_property(srna, "texture_memory_limit", PROP_INT, PROP_NONE);
+	RNA_def_property_int_sdna(prop, NULL, "texture_memory_limit");
+	RNA_def_property_range(prop, 0, 65536);
+	RNA_def_property_ui_text(prop, "Texture Memory Limit",
+	                         "Maximum GPU memory in MB used by textures, least recently drawn images are freed "
+	                         "past this limit (set to 0 for no limit)");
+
 	prop = RNA_def_property(srna, "texture_collection_rate", PROP_INT, PROP_NONE);
 	RNA_def_property_int_sdna(prop, NULL, "texcollectrate");
 	RNA_def_property_range(prop, 1, 3600);
@@ -4171,6 +4178,14 @@ static void rna_def_userdef_system(BlenderRNA *brna)
 	RNA_def_property_ui_text(prop, "MultiSample",
 	                         "Enable OpenGL multi-sampling, only for systems that support it, requires restart");
 
+	prop = RNA_def_property(srna, "viewport_aa_samples", PROP_INT, PROP_NONE);
+	RNA_def_property_int_sdna(prop, NULL, "viewport_aa_samples");
+	RNA_def_property_range(prop, 0, 32);
+	RNA_def_property_ui_text(prop, "Viewport Anti-Aliasing Samples",
+	                         "Number of jittered redraws accumulated by the 3D View while the view is static "
+	                         "(0 or 1 to disable)");
+	RNA_def_property_update(prop, 0, "rna_userdef_update");
+
 	prop = RNA_def_property(srna, "use_region_overlap", PROP_BOOLEAN, PROP_NONE);
 	RNA_def_property_boolean_sdna(prop, NULL, "uiflag2", USER_REGION_OVERLAP);
 	RNA_def_property_ui_text(prop, "Region Overlap",
@@ -4481,6 +4496,12 @@ static void rna_def_userdef_filepaths(BlenderRNA *brna)
 	RNA_def_property_boolean_sdna(prop, NULL, "flag", USER_FILECOMPRESS);
 	RNA_def_property_ui_text(prop, "Compress File", "Enable file compression when saving .blend files");
 
+	prop = RNA_def_property(srna, "use_save_background", PROP_BOOLEAN, PROP_NONE);
+	RNA_def_property_boolean_sdna(prop, NULL, "flag", USER_SAVE_BACKGROUND);
+	RNA_def_property_ui_text(prop, "Save in Background",
+	                         "Compress and write .blend files in the background when saving and auto-saving "
+	                         "(uses extra memory while the file is written)");
+
 	prop = RNA_def_property(srna, "use_load_ui", PROP_BOOLEAN, PROP_NONE);
 	RNA_def_property_boolean_negative_sdna(prop, NULL, "flag", USER_FILENOUI);
 	RNA_def_property_ui_text(prop, "Load UI", "Load user interface setup when loading .blend files");
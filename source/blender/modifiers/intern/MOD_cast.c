@@ -38,6 +38,7 @@
 
 #include "BLI_math.h"
 #include "BLI_utildefines.h"
+#include "BLI_task.h"
 
 
 #include "BKE_deform.h"
@@ -115,10 +116,86 @@ static void updateDepsgraph(ModifierData *md,
 	}
 }
 
+typedef struct CastUserdata {
+	/*const*/ CastModifierData *cmd;
+	MDeformVert *dvert;
+	int defgrp_index;
+	float (*vertexCos)[3];
+	bool use_ctrl_ob;
+	bool has_radius;
+	short flag, type;
+	float len;
+	float center[3];
+	float mat[4][4], imat[4][4];
+	float bb[8][3];
+} CastUserdata;
+
+static void sphere_do_task(void *userdata, const int i)
+{
+	CastUserdata *data = userdata;
+	const CastModifierData *cmd = data->cmd;
+	const short flag = data->flag;
+	const float len = data->len;
+	float fac = cmd->fac;
+	float facm = 1.0f - fac;
+	float vec[3];
+	float tmp_co[3];
+
+	copy_v3_v3(tmp_co, data->vertexCos[i]);
+	if (data->use_ctrl_ob) {
+		if (flag & MOD_CAST_USE_OB_TRANSFORM) {
+			mul_m4_v3(data->mat, tmp_co);
+		}
+		else {
+			sub_v3_v3(tmp_co, data->center);
+		}
+	}
+
+	copy_v3_v3(vec, tmp_co);
+
+	if (data->type == MOD_CAST_TYPE_CYLINDER)
+		vec[2] = 0.0f;
+
+	if (data->has_radius) {
+		if (len_v3(vec) > cmd->radius) return;
+	}
+
+	if (data->dvert) {
+		const float weight = defvert_find_weight(&data->dvert[i], data->defgrp_index);
+		if (weight == 0.0f) {
+			return;
+		}
+
+		fac = cmd->fac * weight;
+		facm = 1.0f - fac;
+	}
+
+	normalize_v3(vec);
+
+	if (flag & MOD_CAST_X)
+		tmp_co[0] = fac * vec[0] * len + facm * tmp_co[0];
+	if (flag & MOD_CAST_Y)
+		tmp_co[1] = fac * vec[1] * len + facm * tmp_co[1];
+	if (flag & MOD_CAST_Z)
+		tmp_co[2] = fac * vec[2] * len + facm * tmp_co[2];
+
+	if (data->use_ctrl_ob) {
+		if (flag & MOD_CAST_USE_OB_TRANSFORM) {
+			mul_m4_v3(data->imat, tmp_co);
+		}
+		else {
+			add_v3_v3(tmp_co, data->center);
+		}
+	}
+
+	copy_v3_v3(data->vertexCos[i], tmp_co);
+}
+
 static void sphere_do(
         CastModifierData *cmd, Object *ob, DerivedMesh *dm,
         float (*vertexCos)[3], int numVerts)
 {
+	CastUserdata data = {NULL};
 	MDeformVert *dvert = NULL;
 
 	Object *ctrl_ob = NULL;
@@ -127,10 +204,7 @@ static void sphere_do(
 	bool has_radius = false;
 	short flag, type;
 	float len = 0.0f;
-	float fac = cmd->fac;
-	float facm = 1.0f - fac;
-	const float fac_orig = fac;
-	float vec[3], center[3] = {0.0f, 0.0f, 0.0f};
+	float center[3] = {0.0f, 0.0f, 0.0f};
 	float mat[4][4], imat[4][4];
 
 	flag = cmd->flag;
@@ -145,14 +219,16 @@ static void sphere_do(
 	 * space), by default, but if the user defined a control object,
 	 * we use its location, transformed to ob's local space */
 	if (ctrl_ob) {
+		float obimat[4][4];
+
 		if (flag & MOD_CAST_USE_OB_TRANSFORM) {
 			invert_m4_m4(imat, ctrl_ob->obmat);
 			mul_m4_m4m4(mat, imat, ob->obmat);
 			invert_m4_m4(imat, mat);
 		}
 
-		invert_m4_m4(ob->imat, ob->obmat);
-		mul_v3_m4v3(center, ob->imat, ctrl_ob->obmat[3]);
+		invert_m4_m4(obimat, ob->obmat);
+		mul_v3_m4v3(center, obimat, ctrl_ob->obmat[3]);
 	}
 
 	/* now we check which options the user wants */
@@ -182,73 +258,138 @@ static void sphere_do(
 		if (len == 0.0f) len = 10.0f;
 	}
 
-	for (i = 0; i < numVerts; i++) {
-		float tmp_co[3];
-
-		copy_v3_v3(tmp_co, vertexCos[i]);
-		if (ctrl_ob) {
-			if (flag & MOD_CAST_USE_OB_TRANSFORM) {
-				mul_m4_v3(mat, tmp_co);
-			}
-			else {
-				sub_v3_v3(tmp_co, center);
-			}
-		}
+	data.cmd = cmd;
+	data.dvert = dvert;
+	data.defgrp_index = defgrp_index;
+	data.vertexCos = vertexCos;
+	data.use_ctrl_ob = (ctrl_ob != NULL);
+	data.has_radius = has_radius;
+	data.flag = flag;
+	data.type = type;
+	data.len = len;
+	copy_v3_v3(data.center, center);
+	if (ctrl_ob && (flag & MOD_CAST_USE_OB_TRANSFORM)) {
+		copy_m4_m4(data.mat, mat);
+		copy_m4_m4(data.imat, imat);
+	}
 
-		copy_v3_v3(vec, tmp_co);
+	BLI_task_parallel_range(0, numVerts, &data, sphere_do_task, numVerts > 1024);
+}
 
-		if (type == MOD_CAST_TYPE_CYLINDER)
-			vec[2] = 0.0f;
+static void cuboid_do_task(void *userdata, const int i)
+{
+	CastUserdata *data = userdata;
+	const CastModifierData *cmd = data->cmd;
+	const short flag = data->flag;
+	int octant, coord;
+	float d[3], dmax, apex[3], fbb;
+	float tmp_co[3];
+	float fac = cmd->fac;
+	float facm = 1.0f - fac;
 
-		if (has_radius) {
-			if (len_v3(vec) > cmd->radius) continue;
+	copy_v3_v3(tmp_co, data->vertexCos[i]);
+	if (data->use_ctrl_ob) {
+		if (flag & MOD_CAST_USE_OB_TRANSFORM) {
+			mul_m4_v3(data->mat, tmp_co);
 		}
+		else {
+			sub_v3_v3(tmp_co, data->center);
+		}
+	}
 
-		if (dvert) {
-			const float weight = defvert_find_weight(&dvert[i], defgrp_index);
-			if (weight == 0.0f) {
-				continue;
-			}
+	if (data->has_radius) {
+		if (fabsf(tmp_co[0]) > cmd->radius ||
+		    fabsf(tmp_co[1]) > cmd->radius ||
+		    fabsf(tmp_co[2]) > cmd->radius)
+		{
+			return;
+		}
+	}
 
-			fac = fac_orig * weight;
-			facm = 1.0f - fac;
+	if (data->dvert) {
+		const float weight = defvert_find_weight(&data->dvert[i], data->defgrp_index);
+		if (weight == 0.0f) {
+			return;
 		}
 
-		normalize_v3(vec);
+		fac = cmd->fac * weight;
+		facm = 1.0f - fac;
+	}
 
-		if (flag & MOD_CAST_X)
-			tmp_co[0] = fac * vec[0] * len + facm * tmp_co[0];
-		if (flag & MOD_CAST_Y)
-			tmp_co[1] = fac * vec[1] * len + facm * tmp_co[1];
-		if (flag & MOD_CAST_Z)
-			tmp_co[2] = fac * vec[2] * len + facm * tmp_co[2];
+	/* The algo used to project the vertices to their
+	 * bounding box (bb) is pretty simple:
+	 * for each vertex v:
+	 * 1) find in which octant v is in;
+	 * 2) find which outer "wall" of that octant is closer to v;
+	 * 3) calculate factor (var fbb) to project v to that wall;
+	 * 4) project. */
+
+	/* find in which octant this vertex is in */
+	octant = 0;
+	if (tmp_co[0] > 0.0f) octant += 1;
+	if (tmp_co[1] > 0.0f) octant += 2;
+	if (tmp_co[2] > 0.0f) octant += 4;
+
+	/* apex is the bb's vertex at the chosen octant */
+	copy_v3_v3(apex, data->bb[octant]);
+
+	/* find which bb plane is closest to this vertex ... */
+	d[0] = tmp_co[0] / apex[0];
+	d[1] = tmp_co[1] / apex[1];
+	d[2] = tmp_co[2] / apex[2];
+
+	/* ... (the closest has the higher (closer to 1) d value) */
+	dmax = d[0];
+	coord = 0;
+	if (d[1] > dmax) {
+		dmax = d[1];
+		coord = 1;
+	}
+	if (d[2] > dmax) {
+		/* dmax = d[2]; */ /* commented, we don't need it */
+		coord = 2;
+	}
 
-		if (ctrl_ob) {
-			if (flag & MOD_CAST_USE_OB_TRANSFORM) {
-				mul_m4_v3(imat, tmp_co);
-			}
-			else {
-				add_v3_v3(tmp_co, center);
-			}
-		}
+	/* ok, now we know which coordinate of the vertex to use */
+
+	if (fabsf(tmp_co[coord]) < FLT_EPSILON) /* avoid division by zero */
+		return;
+
+	/* finally, this is the factor we wanted, to project the vertex
+	 * to its bounding box (bb) */
+	fbb = apex[coord] / tmp_co[coord];
+
+	/* calculate the new vertex position */
+	if (flag & MOD_CAST_X)
+		tmp_co[0] = facm * tmp_co[0] + fac * tmp_co[0] * fbb;
+	if (flag & MOD_CAST_Y)
+		tmp_co[1] = facm * tmp_co[1] + fac * tmp_co[1] * fbb;
+	if (flag & MOD_CAST_Z)
+		tmp_co[2] = facm * tmp_co[2] + fac * tmp_co[2] * fbb;
 
-		copy_v3_v3(vertexCos[i], tmp_co);
+	if (data->use_ctrl_ob) {
+		if (flag & MOD_CAST_USE_OB_TRANSFORM) {
+			mul_m4_v3(data->imat, tmp_co);
+		}
+		else {
+			add_v3_v3(tmp_co, data->center);
+		}
 	}
+
+	copy_v3_v3(data->vertexCos[i], tmp_co);
 }
 
 static void cuboid_do(
         CastModifierData *cmd, Object *ob, DerivedMesh *dm,
         float (*vertexCos)[3], int numVerts)
 {
+	CastUserdata data = {NULL};
 	MDeformVert *dvert = NULL;
 	Object *ctrl_ob = NULL;
 
 	int i, defgrp_index;
 	bool has_radius = false;
 	short flag;
-	float fac = cmd->fac;
-	float facm = 1.0f - fac;
-	const float fac_orig = fac;
 	float min[3], max[3], bb[8][3];
 	float center[3] = {0.0f, 0.0f, 0.0f};
 	float mat[4][4], imat[4][4];
@@ -269,14 +410,16 @@ static void cuboid_do(
 	modifier_get_vgroup(ob, dm, cmd->defgrp_name, &dvert, &defgrp_index);
 
 	if (ctrl_ob) {
+		float obimat[4][4];
+
 		if (flag & MOD_CAST_USE_OB_TRANSFORM) {
 			invert_m4_m4(imat, ctrl_ob->obmat);
 			mul_m4_m4m4(mat, imat, ob->obmat);
 			invert_m4_m4(imat, mat);
 		}
 
-		invert_m4_m4(ob->imat, ob->obmat);
-		mul_v3_m4v3(center, ob->imat, ctrl_ob->obmat[3]);
+		invert_m4_m4(obimat, ob->obmat);
+		mul_v3_m4v3(center, obimat, ctrl_ob->obmat[3]);
 	}
 
 	if ((flag & MOD_CAST_SIZE_FROM_RADIUS) && has_radius) {
@@ -334,103 +477,22 @@ static void cuboid_do(
 	bb[0][2] = bb[1][2] = bb[2][2] = bb[3][2] = min[2];
 	bb[4][2] = bb[5][2] = bb[6][2] = bb[7][2] = max[2];
 
-	/* ready to apply the effect, one vertex at a time */
-	for (i = 0; i < numVerts; i++) {
-		int octant, coord;
-		float d[3], dmax, apex[3], fbb;
-		float tmp_co[3];
-
-		copy_v3_v3(tmp_co, vertexCos[i]);
-		if (ctrl_ob) {
-			if (flag & MOD_CAST_USE_OB_TRANSFORM) {
-				mul_m4_v3(mat, tmp_co);
-			}
-			else {
-				sub_v3_v3(tmp_co, center);
-			}
-		}
-
-		if (has_radius) {
-			if (fabsf(tmp_co[0]) > cmd->radius ||
-			    fabsf(tmp_co[1]) > cmd->radius ||
-			    fabsf(tmp_co[2]) > cmd->radius)
-			{
-				continue;
-			}
-		}
-
-		if (dvert) {
-			const float weight = defvert_find_weight(&dvert[i], defgrp_index);
-			if (weight == 0.0f) {
-				continue;
-			}
-
-			fac = fac_orig * weight;
-			facm = 1.0f - fac;
-		}
-
-		/* The algo used to project the vertices to their
-		 * bounding box (bb) is pretty simple:
-		 * for each vertex v:
-		 * 1) find in which octant v is in;
-		 * 2) find which outer "wall" of that octant is closer to v;
-		 * 3) calculate factor (var fbb) to project v to that wall;
-		 * 4) project. */
-
-		/* find in which octant this vertex is in */
-		octant = 0;
-		if (tmp_co[0] > 0.0f) octant += 1;
-		if (tmp_co[1] > 0.0f) octant += 2;
-		if (tmp_co[2] > 0.0f) octant += 4;
-
-		/* apex is the bb's vertex at the chosen octant */
-		copy_v3_v3(apex, bb[octant]);
-
-		/* find which bb plane is closest to this vertex ... */
-		d[0] = tmp_co[0] / apex[0];
-		d[1] = tmp_co[1] / apex[1];
-		d[2] = tmp_co[2] / apex[2];
-
-		/* ... (the closest has the higher (closer to 1) d value) */
-		dmax = d[0];
-		coord = 0;
-		if (d[1] > dmax) {
-			dmax = d[1];
-			coord = 1;
-		}
-		if (d[2] > dmax) {
-			/* dmax = d[2]; */ /* commented, we don't need it */
-			coord = 2;
-		}
-
-		/* ok, now we know which coordinate of the vertex to use */
-
-		if (fabsf(tmp_co[coord]) < FLT_EPSILON) /* avoid division by zero */
-			continue;
-
-		/* finally, this is the factor we wanted, to project the vertex
-		 * to its bounding box (bb) */
-		fbb = apex[coord] / tmp_co[coord];
-
-		/* calculate the new vertex position */
-		if (flag & MOD_CAST_X)
-			tmp_co[0] = facm * tmp_co[0] + fac * tmp_co[0] * fbb;
-		if (flag & MOD_CAST_Y)
-			tmp_co[1] = facm * tmp_co[1] + fac * tmp_co[1] * fbb;
-		if (flag & MOD_CAST_Z)
-			tmp_co[2] = facm * tmp_co[2] + fac * tmp_co[2] * fbb;
-
-		if (ctrl_ob) {
-			if (flag & MOD_CAST_USE_OB_TRANSFORM) {
-				mul_m4_v3(imat, tmp_co);
-			}
-			else {
-				add_v3_v3(tmp_co, center);
-			}
-		}
-
-		copy_v3_v3(vertexCos[i], tmp_co);
+	data.cmd = cmd;
+	data.dvert = dvert;
+	data.defgrp_index = defgrp_index;
+	data.vertexCos = vertexCos;
+	data.use_ctrl_ob = (ctrl_ob != NULL);
+	data.has_radius = has_radius;
+	data.flag = flag;
+	copy_v3_v3(data.center, center);
+	if (ctrl_ob && (flag & MOD_CAST_USE_OB_TRANSFORM)) {
+		copy_m4_m4(data.mat, mat);
+		copy_m4_m4(data.imat, imat);
 	}
+	memcpy(data.bb, bb, sizeof(data.bb));
+
+	/* ready to apply the effect, one vertex at a time */
+	BLI_task_parallel_range(0, numVerts, &data, cuboid_do_task, numVerts > 1024);
 }
 
 static void deformVerts(ModifierData *md, struct EvaluationContext *UNUSED(eval_ctx),
@@ -26,12 +26,18 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_buffer.h"
 #include "BLI_math_base.h"
+#include "BLI_math_geom.h"
 #include "BLI_math_vector.h"
+#include "BLI_sort_utils.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
+#include "BKE_bvhutils.h"
 #include "BKE_cdderivedmesh.h"
 #include "BKE_DerivedMesh.h"
+#include "BKE_modifier.h"
 
 #include "DNA_meshdata_types.h"
 #include "DNA_modifier_types.h"
@@ -57,6 +63,7 @@ static void initData(ModifierData *md)
 	rmd->flag = MOD_REMESH_FLOOD_FILL;
 	rmd->mode = MOD_REMESH_SHARP_FEATURES;
 	rmd->threshold = 1;
+	rmd->voxel_size = 0.1f;
 }
 
 static void copyData(ModifierData *md, ModifierData *target)
@@ -68,6 +75,387 @@ static void copyData(ModifierData *md, ModifierData *target)
 	modifier_copyData_generic(md, target);
 }
 
+/* -------------------------------------------------------------------- */
+/* Voxel remesh
+ *
+ * Samples a signed distance field of the mesh on a regular grid and extracts
+ * its zero level-set as surface nets: one vertex for every cell the surface
+ * crosses, one quad for every grid edge it crosses. The distance comes from
+ * the nearest triangle and the sign from the parity of ray hits along the
+ * X axis, so the input is expected to be closed. All passes are threaded
+ * over slices of the grid. */
+
+/* Empty voxels around the bounds, so no surface crosses the grid boundary. */
+#define VOXEL_PAD 2
+/* Upper limit for the number of grid samples, against tiny voxel sizes. */
+#define VOXEL_SAMPLES_MAX (1 << 28)
+
+typedef struct VoxelGrid {
+	int dims[3];
+	float min[3];
+	float voxel_size;
+	/* Signed distance per grid point, negative inside. */
+	float *field;
+} VoxelGrid;
+
+BLI_INLINE int voxel_point_index(const VoxelGrid *grid, const int x, const int y, const int z)
+{
+	return (z * grid->dims[1] + y) * grid->dims[0] + x;
+}
+
+BLI_INLINE int voxel_cell_index(const VoxelGrid *grid, const int x, const int y, const int z)
+{
+	return (z * (grid->dims[1] - 1) + y) * (grid->dims[0] - 1) + x;
+}
+
+typedef struct VoxelFieldData {
+	VoxelGrid *grid;
+	BVHTreeFromMesh *treedata;
+	struct IsectRayPrecalc isect_precalc;
+} VoxelFieldData;
+
+typedef struct VoxelRayData {
+	const VoxelFieldData *data;
+	BLI_Buffer *hits;
+} VoxelRayData;
+
+static void voxel_ray_hit_cb(void *userdata, int index, const BVHTreeRay *ray, BVHTreeRayHit *UNUSED(hit))
+{
+	VoxelRayData *ray_data = userdata;
+	const BVHTreeFromMesh *treedata = ray_data->data->treedata;
+	const MLoopTri *lt = &treedata->looptri[index];
+	float dist;
+
+	/* Watertight, so rays through shared edges are counted once. */
+	if (isect_ray_tri_watertight_v3(
+	        ray->origin, &ray_data->data->isect_precalc,
+	        treedata->vert[treedata->loop[lt->tri[0]].v].co,
+	        treedata->vert[treedata->loop[lt->tri[1]].v].co,
+	        treedata->vert[treedata->loop[lt->tri[2]].v].co,
+	        &dist, NULL))
+	{
+		BLI_buffer_append(ray_data->hits, float, dist);
+	}
+}
+
+/* Fill one row of the field along X. */
+static void voxel_field_row_task(void *userdata, const int row)
+{
+	const VoxelFieldData *data = userdata;
+	VoxelGrid *grid = data->grid;
+	const float voxel_size = grid->voxel_size;
+	const int y = row % grid->dims[1];
+	const int z = row / grid->dims[1];
+	float *field = &grid->field[voxel_point_index(grid, 0, y, z)];
+	const float dir[3] = {1.0f, 0.0f, 0.0f};
+	float co[3];
+	float dist_prev = 0.0f;
+	const float *hit_depths;
+	int x, hit_index = 0;
+
+	BLI_buffer_declare_static(float, hits, BLI_BUFFER_NOP, 64);
+	VoxelRayData ray_data = {data, &hits};
+
+	co[0] = grid->min[0];
+	co[1] = grid->min[1] + (float)y * voxel_size;
+	co[2] = grid->min[2] + (float)z * voxel_size;
+
+	BLI_bvhtree_ray_cast_all(data->treedata->tree, co, dir, 0.0f, BVH_RAYCAST_DIST_MAX,
+	                         voxel_ray_hit_cb, &ray_data);
+	if (hits.count > 1) {
+		qsort(hits.data, hits.count, sizeof(float), BLI_sortutil_cmp_float);
+	}
+	hit_depths = hits.data;
+
+	for (x = 0; x < grid->dims[0]; x++) {
+		const float depth = (float)x * voxel_size;
+		BVHTreeNearest nearest;
+		float dist;
+
+		co[0] = grid->min[0] + depth;
+
+		/* The distance changes at most by one voxel between neighbors,
+		 * bound the search with that. */
+		nearest.index = -1;
+		nearest.dist_sq = (x == 0) ? FLT_MAX : pow2f((dist_prev + voxel_size) * 1.001f);
+		BLI_bvhtree_find_nearest(data->treedata->tree, co, &nearest,
+		                         data->treedata->nearest_callback, data->treedata);
+		if (UNLIKELY(nearest.index == -1)) {
+			nearest.dist_sq = FLT_MAX;
+			BLI_bvhtree_find_nearest(data->treedata->tree, co, &nearest,
+			                         data->treedata->nearest_callback, data->treedata);
+		}
+		dist = sqrtf(nearest.dist_sq);
+		dist_prev = dist;
+
+		while (hit_index < (int)hits.count && hit_depths[hit_index] < depth) {
+			hit_index++;
+		}
+
+		field[x] = (hit_index & 1) ? -dist : dist;
+	}
+
+	BLI_buffer_free(&hits);
+}
+
+static const int voxel_cell_corners[8][3] = {
+	{0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {1, 1, 0},
+	{0, 0, 1}, {1, 0, 1}, {0, 1, 1}, {1, 1, 1},
+};
+
+static const int voxel_cell_edges[12][2] = {
+	{0, 1}, {2, 3}, {4, 5}, {6, 7},
+	{0, 2}, {1, 3}, {4, 6}, {5, 7},
+	{0, 4}, {1, 5}, {2, 6}, {3, 7},
+};
+
+typedef struct VoxelMeshData {
+	const VoxelGrid *grid;
+	/* Vertex per cell, -1 for cells the surface doesn't cross. */
+	int *cell_vert;
+	/* Number of vertices and quads per slice, then the offsets of the slices. */
+	int *slice_vert_tot;
+	int *slice_quad_tot;
+	MVert *mvert;
+	MLoop *mloop;
+	MPoly *mpoly;
+} VoxelMeshData;
+
+/* Return true if the surface crosses the cell, and optionally its vertex. */
+static bool voxel_cell_vert(const VoxelGrid *grid, const int x, const int y, const int z, float r_co[3])
+{
+	float f[8];
+	int i, inside = 0, num_crossings = 0;
+
+	for (i = 0; i < 8; i++) {
+		f[i] = grid->field[voxel_point_index(
+		        grid, x + voxel_cell_corners[i][0], y + voxel_cell_corners[i][1], z + voxel_cell_corners[i][2])];
+		if (f[i] < 0.0f) {
+			inside++;
+		}
+	}
+
+	if (ELEM(inside, 0, 8)) {
+		return false;
+	}
+	else if (r_co == NULL) {
+		return true;
+	}
+
+	/* Average of the edge crossings. */
+	zero_v3(r_co);
+	for (i = 0; i < 12; i++) {
+		const int c0 = voxel_cell_edges[i][0], c1 = voxel_cell_edges[i][1];
+		if ((f[c0] < 0.0f) != (f[c1] < 0.0f)) {
+			const float t = f[c0] / (f[c0] - f[c1]);
+			int j;
+			for (j = 0; j < 3; j++) {
+				r_co[j] += (float)voxel_cell_corners[c0][j] +
+				           t * (float)(voxel_cell_corners[c1][j] - voxel_cell_corners[c0][j]);
+			}
+			num_crossings++;
+		}
+	}
+	mul_v3_fl(r_co, 1.0f / (float)num_crossings);
+
+	r_co[0] = grid->min[0] + ((float)x + r_co[0]) * grid->voxel_size;
+	r_co[1] = grid->min[1] + ((float)y + r_co[1]) * grid->voxel_size;
+	r_co[2] = grid->min[2] + ((float)z + r_co[2]) * grid->voxel_size;
+	return true;
+}
+
+static void voxel_verts_count_task(void *userdata, const int z)
+{
+	VoxelMeshData *data = userdata;
+	const VoxelGrid *grid = data->grid;
+	int x, y, tot = 0;
+
+	for (y = 0; y < grid->dims[1] - 1; y++) {
+		for (x = 0; x < grid->dims[0] - 1; x++) {
+			if (voxel_cell_vert(grid, x, y, z, NULL)) {
+				tot++;
+			}
+		}
+	}
+	data->slice_vert_tot[z] = tot;
+}
+
+static void voxel_verts_fill_task(void *userdata, const int z)
+{
+	VoxelMeshData *data = userdata;
+	const VoxelGrid *grid = data->grid;
+	int x, y, index = data->slice_vert_tot[z];
+
+	for (y = 0; y < grid->dims[1] - 1; y++) {
+		for (x = 0; x < grid->dims[0] - 1; x++) {
+			const int cell = voxel_cell_index(grid, x, y, z);
+			if (voxel_cell_vert(grid, x, y, z, data->mvert[index].co)) {
+				data->cell_vert[cell] = index++;
+			}
+			else {
+				data->cell_vert[cell] = -1;
+			}
+		}
+	}
+}
+
+/* Count or fill the quads of the crossed grid edges starting at points of slice \a z. */
+static int voxel_quads_slice(VoxelMeshData *data, const int z, int quad)
+{
+	const VoxelGrid *grid = data->grid;
+	const int quad_start = quad;
+	int p[3], axis;
+
+	p[2] = z;
+	for (p[1] = 0; p[1] < grid->dims[1]; p[1]++) {
+		for (p[0] = 0; p[0] < grid->dims[0]; p[0]++) {
+			const bool inside = grid->field[voxel_point_index(grid, UNPACK3(p))] < 0.0f;
+
+			for (axis = 0; axis < 3; axis++) {
+				/* viewed from the positive axis, u points right and v up */
+				const int u = (axis + 1) % 3, v = (axis + 2) % 3;
+				int q[3];
+
+				if ((p[axis] + 1 >= grid->dims[axis]) ||
+				    (p[u] < 1 || p[u] > grid->dims[u] - 2) ||
+				    (p[v] < 1 || p[v] > grid->dims[v] - 2))
+				{
+					continue;
+				}
+
+				copy_v3_v3_int(q, p);
+				q[axis]++;
+				if (inside == (grid->field[voxel_point_index(grid, UNPACK3(q))] < 0.0f)) {
+					continue;
+				}
+
+				if (data->mpoly) {
+					static const int quad_uv[4][2] = {{-1, -1}, {0, -1}, {0, 0}, {-1, 0}};
+					MLoop *ml = &data->mloop[quad * 4];
+					int i;
+
+					data->mpoly[quad].loopstart = quad * 4;
+					data->mpoly[quad].totloop = 4;
+
+					for (i = 0; i < 4; i++) {
+						/* counter-clockwise when the normal points along the axis */
+						const int corner = inside ? i : 3 - i;
+						int c[3];
+						copy_v3_v3_int(c, p);
+						c[u] += quad_uv[corner][0];
+						c[v] += quad_uv[corner][1];
+						ml[i].v = (unsigned int)data->cell_vert[voxel_cell_index(grid, UNPACK3(c))];
+					}
+				}
+				quad++;
+			}
+		}
+	}
+
+	return quad - quad_start;
+}
+
+static void voxel_quads_count_task(void *userdata, const int z)
+{
+	VoxelMeshData *data = userdata;
+	data->slice_quad_tot[z] = voxel_quads_slice(data, z, 0);
+}
+
+static void voxel_quads_fill_task(void *userdata, const int z)
+{
+	VoxelMeshData *data = userdata;
+	voxel_quads_slice(data, z, data->slice_quad_tot[z]);
+}
+
+/* Turn the element counts per slice into offsets, return the total. */
+static int voxel_slice_offsets(int *slice_tot, const int slices_num)
+{
+	int i, tot = 0;
+	for (i = 0; i < slices_num; i++) {
+		const int slice = slice_tot[i];
+		slice_tot[i] = tot;
+		tot += slice;
+	}
+	return tot;
+}
+
+static DerivedMesh *remesh_voxel(ModifierData *md, DerivedMesh *dm)
+{
+	RemeshModifierData *rmd = (RemeshModifierData *)md;
+	BVHTreeFromMesh treedata = {NULL};
+	VoxelGrid grid;
+	VoxelFieldData field_data;
+	VoxelMeshData mesh_data = {NULL};
+	DerivedMesh *result;
+	float min[3], max[3];
+	int totvert, totquad, i;
+	double samples_num = 1.0;
+
+	if (rmd->voxel_size <= 0.0f || dm->getNumLoopTri(dm) == 0) {
+		return dm;
+	}
+
+	INIT_MINMAX(min, max);
+	dm->getMinMax(dm, min, max);
+
+	grid.voxel_size = rmd->voxel_size;
+	for (i = 0; i < 3; i++) {
+		const double dim = ceil((double)(max[i] - min[i]) / grid.voxel_size) + 1 + 2 * VOXEL_PAD;
+		samples_num *= dim;
+		grid.dims[i] = (int)MIN2(dim, VOXEL_SAMPLES_MAX);
+		grid.min[i] = min[i] - VOXEL_PAD * grid.voxel_size;
+	}
+
+	if (samples_num > VOXEL_SAMPLES_MAX) {
+		modifier_setError(md, "Voxel size is too small for the size of the mesh");
+		return dm;
+	}
+
+	bvhtree_from_mesh_looptri(&treedata, dm, 0.0f, 2, 6);
+	if (treedata.tree == NULL) {
+		return dm;
+	}
+
+	grid.field = MEM_mallocN(sizeof(*grid.field) * (size_t)samples_num, __func__);
+
+	field_data.grid = &grid;
+	field_data.treedata = &treedata;
+	isect_ray_tri_watertight_v3_precalc(&field_data.isect_precalc, (const float[3]){1.0f, 0.0f, 0.0f});
+
+	BLI_task_parallel_range(0, grid.dims[1] * grid.dims[2], &field_data, voxel_field_row_task, true);
+
+	free_bvhtree_from_mesh(&treedata);
+
+	/* Surface nets. */
+	mesh_data.grid = &grid;
+	mesh_data.cell_vert = MEM_mallocN(
+	        sizeof(*mesh_data.cell_vert) * (size_t)(grid.dims[0] - 1) * (size_t)(grid.dims[1] - 1) *
+	        (size_t)(grid.dims[2] - 1), __func__);
+	mesh_data.slice_vert_tot = MEM_mallocN(sizeof(*mesh_data.slice_vert_tot) * (size_t)grid.dims[2], __func__);
+	mesh_data.slice_quad_tot = MEM_mallocN(sizeof(*mesh_data.slice_quad_tot) * (size_t)grid.dims[2], __func__);
+
+	BLI_task_parallel_range(0, grid.dims[2] - 1, &mesh_data, voxel_verts_count_task, true);
+	BLI_task_parallel_range(0, grid.dims[2], &mesh_data, voxel_quads_count_task, true);
+	totvert = voxel_slice_offsets(mesh_data.slice_vert_tot, grid.dims[2] - 1);
+	totquad = voxel_slice_offsets(mesh_data.slice_quad_tot, grid.dims[2]);
+
+	result = CDDM_new(totvert, 0, 0, totquad * 4, totquad);
+	mesh_data.mvert = CDDM_get_verts(result);
+	mesh_data.mloop = CDDM_get_loops(result);
+	mesh_data.mpoly = CDDM_get_polys(result);
+
+	/* Quads need the vertex of every cell. */
+	BLI_task_parallel_range(0, grid.dims[2] - 1, &mesh_data, voxel_verts_fill_task, true);
+	BLI_task_parallel_range(0, grid.dims[2], &mesh_data, voxel_quads_fill_task, true);
+
+	MEM_freeN(mesh_data.slice_quad_tot);
+	MEM_freeN(mesh_data.slice_vert_tot);
+	MEM_freeN(mesh_data.cell_vert);
+	MEM_freeN(grid.field);
+
+	return result;
+}
+
 #ifdef WITH_MOD_REMESH
 
 static void init_dualcon_mesh(DualConInput *mesh, DerivedMesh *dm)
@@ -142,21 +530,14 @@ static void dualcon_add_quad(void *output_v, const int vert_indices[4])
 	output->curface++;
 }
 
-static DerivedMesh *applyModifier(ModifierData *md,
-                                  struct EvaluationContext *UNUSED(eval_ctx),
-                                  Object *UNUSED(ob),
-                                  DerivedMesh *dm,
-                                  ModifierApplyFlag UNUSED(flag))
+static DerivedMesh *remesh_dualcon(RemeshModifierData *rmd, DerivedMesh *dm)
 {
-	RemeshModifierData *rmd;
 	DualConOutput *output;
 	DualConInput input;
 	DerivedMesh *result;
 	DualConFlags flags = 0;
 	DualConMode mode = 0;
 
-	rmd = (RemeshModifierData *)md;
-
 	init_dualcon_mesh(&input, dm);
 
 	if (rmd->flag & MOD_REMESH_FLOOD_FILL)
@@ -187,6 +568,37 @@ static DerivedMesh *applyModifier(ModifierData *md,
 	result = output->dm;
 	MEM_freeN(output);
 
+	return result;
+}
+
+#endif /* WITH_MOD_REMESH */
+
+static DerivedMesh *applyModifier(ModifierData *md,
+                                  struct EvaluationContext *UNUSED(eval_ctx),
+                                  Object *UNUSED(ob),
+                                  DerivedMesh *dm,
+                                  ModifierApplyFlag UNUSED(flag))
+{
+	RemeshModifierData *rmd;
+	DerivedMesh *result;
+
+	rmd = (RemeshModifierData *)md;
+
+	if (rmd->mode == MOD_REMESH_VOXEL) {
+		result = remesh_voxel(md, dm);
+	}
+	else {
+#ifdef WITH_MOD_REMESH
+		result = remesh_dualcon(rmd, dm);
+#else
+		result = dm;
+#endif
+	}
+
+	if (result == dm) {
+		return dm;
+	}
+
 	if (rmd->flag & MOD_REMESH_SMOOTH_SHADING) {
 		MPoly *mpoly = CDDM_get_polys(result);
 		int i, totpoly = result->getNumPolys(result);
@@ -202,19 +614,6 @@ static DerivedMesh *applyModifier(ModifierData *md,
 	return result;
 }
 
-#else /* !WITH_MOD_REMESH */
-
-static DerivedMesh *applyModifier(ModifierData *UNUSED(md),
-                                  struct EvaluationContext *UNUSED(eval_ctx),
-                                  Object *UNUSED(ob),
-                                  DerivedMesh *derivedData,
-                                  ModifierApplyFlag UNUSED(flag))
-{
-	return derivedData;
-}
-
-#endif /* !WITH_MOD_REMESH */
-
 ModifierTypeInfo modifierType_Remesh = {
 	/* name */              "Remesh",
 	/* structName */        "RemeshModifierData",
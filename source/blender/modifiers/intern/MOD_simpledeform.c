@@ -38,6 +38,7 @@
 
 #include "BLI_math.h"
 #include "BLI_utildefines.h"
+#include "BLI_task.h"
 
 #include "BKE_cdderivedmesh.h"
 #include "BKE_library_query.h"
@@ -139,11 +140,61 @@ static void simpleDeform_bend(const float factor, const float dcut[3], float r_c
 
 
 /* simple deform modifier */
-static void SimpleDeformModifier_do(SimpleDeformModifierData *smd, struct Object *ob, struct DerivedMesh *dm,
-                                    float (*vertexCos)[3], int numVerts)
+typedef struct SimpleDeformUserdata {
+	/*const*/ SimpleDeformModifierData *smd;
+	const SpaceTransform *transf;
+	void (*simpleDeform_callback)(const float factor, const float dcut[3], float co[3]);
+	MDeformVert *dvert;
+	int vgroup;
+	bool invert_vgroup;
+	int limit_axis;
+	float smd_limit[2], smd_factor;
+	float (*vertexCos)[3];
+} SimpleDeformUserdata;
+
+static void simpleDeform_do_task(void *userdata, const int i)
 {
 	static const float lock_axis[2] = {0.0f, 0.0f};
 
+	const SimpleDeformUserdata *data = userdata;
+	const SimpleDeformModifierData *smd = data->smd;
+	const SpaceTransform *transf = data->transf;
+	float (*vertexCos)[3] = data->vertexCos;
+	float weight = defvert_array_find_weight_safe(data->dvert, i, data->vgroup);
+
+	if (data->invert_vgroup) {
+		weight = 1.0f - weight;
+	}
+
+	if (weight != 0.0f) {
+		float co[3], dcut[3] = {0.0f, 0.0f, 0.0f};
+
+		if (transf) {
+			BLI_space_transform_apply(transf, vertexCos[i]);
+		}
+
+		copy_v3_v3(co, vertexCos[i]);
+
+		/* Apply axis limits */
+		if (smd->mode != MOD_SIMPLEDEFORM_MODE_BEND) { /* Bend mode shoulnt have any lock axis */
+			if (smd->axis & MOD_SIMPLEDEFORM_LOCK_AXIS_X) axis_limit(0, lock_axis, co, dcut);
+			if (smd->axis & MOD_SIMPLEDEFORM_LOCK_AXIS_Y) axis_limit(1, lock_axis, co, dcut);
+		}
+		axis_limit(data->limit_axis, data->smd_limit, co, dcut);
+
+		data->simpleDeform_callback(data->smd_factor, dcut, co);  /* apply deform */
+		interp_v3_v3v3(vertexCos[i], vertexCos[i], co, weight);  /* Use vertex weight has coef of linear interpolation */
+
+		if (transf) {
+			BLI_space_transform_invert(transf, vertexCos[i]);
+		}
+	}
+}
+
+static void SimpleDeformModifier_do(SimpleDeformModifierData *smd, struct Object *ob, struct DerivedMesh *dm,
+                                    float (*vertexCos)[3], int numVerts)
+{
+	SimpleDeformUserdata data;
 	int i;
 	int limit_axis = 0;
 	float smd_limit[2], smd_factor;
@@ -213,37 +264,18 @@ static void SimpleDeformModifier_do(SimpleDeformModifierData *smd, struct Object
 	modifier_get_vgroup(ob, dm, smd->vgroup_name, &dvert, &vgroup);
 	const bool invert_vgroup = (smd->flag & MOD_SIMPLEDEFORM_FLAG_INVERT_VGROUP) != 0;
 
-	for (i = 0; i < numVerts; i++) {
-		float weight = defvert_array_find_weight_safe(dvert, i, vgroup);
-
-		if (invert_vgroup) {
-			weight = 1.0f - weight;
-		}
-
-		if (weight != 0.0f) {
-			float co[3], dcut[3] = {0.0f, 0.0f, 0.0f};
-
-			if (transf) {
-				BLI_space_transform_apply(transf, vertexCos[i]);
-			}
-
-			copy_v3_v3(co, vertexCos[i]);
-
-			/* Apply axis limits */
-			if (smd->mode != MOD_SIMPLEDEFORM_MODE_BEND) { /* Bend mode shoulnt have any lock axis */
-				if (smd->axis & MOD_SIMPLEDEFORM_LOCK_AXIS_X) axis_limit(0, lock_axis, co, dcut);
-				if (smd->axis & MOD_SIMPLEDEFORM_LOCK_AXIS_Y) axis_limit(1, lock_axis, co, dcut);
-			}
-			axis_limit(limit_axis, smd_limit, co, dcut);
-
-			simpleDeform_callback(smd_factor, dcut, co);  /* apply deform */
-			interp_v3_v3v3(vertexCos[i], vertexCos[i], co, weight);  /* Use vertex weight has coef of linear interpolation */
-
-			if (transf) {
-				BLI_space_transform_invert(transf, vertexCos[i]);
-			}
-		}
-	}
+	data.smd = smd;
+	data.transf = transf;
+	data.simpleDeform_callback = simpleDeform_callback;
+	data.dvert = dvert;
+	data.vgroup = vgroup;
+	data.invert_vgroup = invert_vgroup;
+	data.limit_axis = limit_axis;
+	copy_v2_v2(data.smd_limit, smd_limit);
+	data.smd_factor = smd_factor;
+	data.vertexCos = vertexCos;
+
+	BLI_task_parallel_range(0, numVerts, &data, simpleDeform_do_task, numVerts > 1024);
 }
 
 
@@ -37,6 +37,7 @@
 
 #include "BLI_math.h"
 #include "BLI_utildefines.h"
+#include "BLI_task.h"
 
 #include "MEM_guardedalloc.h"
 
@@ -91,16 +92,58 @@ static CustomDataMask requiredDataMask(Object *UNUSED(ob), ModifierData *md)
 	return dataMask;
 }
 
+typedef struct SmoothUserdata {
+	MDeformVert *dvert;
+	int defgrp_index;
+	short flag;
+	float fac;
+	const float *ftmp;
+	const unsigned char *uctmp;
+	float (*vertexCos)[3];
+} SmoothUserdata;
+
+/* Blend every vertex towards the average of its edge midpoints, the sums are
+ * gathered serially over the edges beforehand. */
+static void smoothModifier_do_task(void *userdata, const int i)
+{
+	const SmoothUserdata *data = userdata;
+	const short flag = data->flag;
+	const float *fp = &data->ftmp[i * 3];
+	float *v = data->vertexCos[i];
+	float f = data->fac, fm, facw;
+
+	if (data->dvert) {
+		const float weight = defvert_find_weight(&data->dvert[i], data->defgrp_index);
+		if (weight <= 0.0f) return;
+
+		f *= weight;
+	}
+	fm = 1.0f - f;
+
+	/* fp is the sum of uctmp[i] verts, so must be averaged */
+	facw = 0.0f;
+	if (data->uctmp[i])
+		facw = f / (float)data->uctmp[i];
+
+	if (flag & MOD_SMOOTH_X)
+		v[0] = fm * v[0] + facw * fp[0];
+	if (flag & MOD_SMOOTH_Y)
+		v[1] = fm * v[1] + facw * fp[1];
+	if (flag & MOD_SMOOTH_Z)
+		v[2] = fm * v[2] + facw * fp[2];
+}
+
 static void smoothModifier_do(
         SmoothModifierData *smd, Object *ob, DerivedMesh *dm,
         float (*vertexCos)[3], int numVerts)
 {
+	SmoothUserdata data;
 	MDeformVert *dvert = NULL;
 	MEdge *medges = NULL;
 
 	int i, j, numDMEdges, defgrp_index;
 	unsigned char *uctmp;
-	float *ftmp, fac, facm;
+	float *ftmp;
 
 	ftmp = (float *)MEM_callocN(3 * sizeof(float) * numVerts,
 	                            "smoothmodifier_f");
@@ -112,9 +155,6 @@ static void smoothModifier_do(
 		return;
 	}
 
-	fac = smd->fac;
-	facm = 1 - fac;
-
 	if (dm->getNumVerts(dm) == numVerts) {
 		medges = dm->getEdgeArray(dm);
 		numDMEdges = dm->getNumEdges(dm);
@@ -126,8 +166,14 @@ static void smoothModifier_do(
 
 	modifier_get_vgroup(ob, dm, smd->defgrp_name, &dvert, &defgrp_index);
 
-	/* NOTICE: this can be optimized a little bit by moving the
-	 * if (dvert) out of the loop, if needed */
+	data.dvert = dvert;
+	data.defgrp_index = defgrp_index;
+	data.flag = smd->flag;
+	data.fac = smd->fac;
+	data.ftmp = ftmp;
+	data.uctmp = uctmp;
+	data.vertexCos = vertexCos;
+
 	for (j = 0; j < smd->repeat; j++) {
 		for (i = 0; i < numDMEdges; i++) {
 			float fvec[3];
@@ -155,57 +201,7 @@ static void smoothModifier_do(
 			}
 		}
 
-		if (dvert) {
-			MDeformVert *dv = dvert;
-			for (i = 0; i < numVerts; i++, dv++) {
-				float f, fm, facw, *fp, *v;
-				short flag = smd->flag;
-
-				v = vertexCos[i];
-				fp = &ftmp[i * 3];
-
-
-				f = defvert_find_weight(dv, defgrp_index);
-				if (f <= 0.0f) continue;
-
-				f *= fac;
-				fm = 1.0f - f;
-
-				/* fp is the sum of uctmp[i] verts, so must be averaged */
-				facw = 0.0f;
-				if (uctmp[i]) 
-					facw = f / (float)uctmp[i];
-
-				if (flag & MOD_SMOOTH_X)
-					v[0] = fm * v[0] + facw * fp[0];
-				if (flag & MOD_SMOOTH_Y)
-					v[1] = fm * v[1] + facw * fp[1];
-				if (flag & MOD_SMOOTH_Z)
-					v[2] = fm * v[2] + facw * fp[2];
-			}
-		}
-		else { /* no vertex group */
-			for (i = 0; i < numVerts; i++) {
-				float facw, *fp, *v;
-				short flag = smd->flag;
-
-				v = vertexCos[i];
-				fp = &ftmp[i * 3];
-
-				/* fp is the sum of uctmp[i] verts, so must be averaged */
-				facw = 0.0f;
-				if (uctmp[i]) 
-					facw = fac / (float)uctmp[i];
-
-				if (flag & MOD_SMOOTH_X)
-					v[0] = facm * v[0] + facw * fp[0];
-				if (flag & MOD_SMOOTH_Y)
-					v[1] = facm * v[1] + facw * fp[1];
-				if (flag & MOD_SMOOTH_Z)
-					v[2] = facm * v[2] + facw * fp[2];
-			}
-
-		}
+		BLI_task_parallel_range(0, numVerts, &data, smoothModifier_do_task, numVerts > 1024);
 
 		memset(ftmp, 0, 3 * sizeof(float) * numVerts);
 		memset(uctmp, 0, sizeof(unsigned char) * numVerts);
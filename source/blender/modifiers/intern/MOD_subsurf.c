@@ -149,16 +149,14 @@ static DerivedMesh *applyModifier(ModifierData *md, EvaluationContext *UNUSED(ev
 	result = subsurf_make_derived_from_derived(derivedData, smd, NULL, subsurf_flags);
 	result->cd_flag = derivedData->cd_flag;
 
-	{
+	/* The GPU backend keeps the subdivided geometry in OpenSubdiv's vertex
+	 * buffers only, copying it into a CDDM would lose it. */
+	if (do_cddm_convert || (subsurf_flags & SUBSURF_USE_GPU_BACKEND) == 0) {
 		DerivedMesh *cddm = CDDM_copy(result);
 		result->release(result);
 		result = cddm;
 	}
 
-#ifndef WITH_OPESUBDIV
-	(void) do_cddm_convert;
-#endif
-
 	return result;
 }
 
@@ -129,9 +129,70 @@ static void localize(bNodeTree *UNUSED(localtree), bNodeTree *ntree)
 	}
 }
 
+static void node_stats_clear(bNodeTree *ntree)
+{
+	bNode *node;
+	
+	for (node = ntree->nodes.first; node; node = node->next) {
+		node->exec_time = 0.0f;
+		node->exec_memory = 0.0f;
+		node->exec_chunks = 0;
+		if (node->type == NODE_GROUP && node->id)
+			node_stats_clear((bNodeTree *)node->id);
+	}
+}
+
+static void node_stats_add(bNode *node, const bNode *from)
+{
+	node->exec_time += from->exec_time;
+	node->exec_memory += from->exec_memory;
+	node->exec_chunks += from->exec_chunks;
+}
+
+/* group nodes show the statistics of all nodes inside of them */
+static void local_stats_group_totals(bNodeTree *localtree)
+{
+	bNode *lnode, *lgroupnode;
+	
+	for (lgroupnode = localtree->nodes.first; lgroupnode; lgroupnode = lgroupnode->next) {
+		if (lgroupnode->type == NODE_GROUP && lgroupnode->id) {
+			local_stats_group_totals((bNodeTree *)lgroupnode->id);
+			
+			lgroupnode->exec_time = 0.0f;
+			lgroupnode->exec_memory = 0.0f;
+			lgroupnode->exec_chunks = 0;
+			for (lnode = ((bNodeTree *)lgroupnode->id)->nodes.first; lnode; lnode = lnode->next)
+				node_stats_add(lgroupnode, lnode);
+		}
+	}
+}
+
+/* nodes of groups add up the statistics of all instances of the group */
+static void local_stats_merge(bNodeTree *localtree, bNodeTree *ntree)
+{
+	bNode *lnode;
+	
+	for (lnode = localtree->nodes.first; lnode; lnode = lnode->next) {
+		bNode *node = lnode->original;
+		if (node && ntreeNodeExists(ntree, node)) {
+			node_stats_add(node, lnode);
+			if (lnode->type == NODE_GROUP && lnode->id && node->id)
+				local_stats_merge((bNodeTree *)lnode->id, (bNodeTree *)node->id);
+		}
+	}
+}
+
+static void local_sync_stats(bNodeTree *localtree, bNodeTree *ntree)
+{
+	local_stats_group_totals(localtree);
+	node_stats_clear(ntree);
+	local_stats_merge(localtree, ntree);
+}
+
 static void local_sync(bNodeTree *localtree, bNodeTree *ntree)
 {
 	BKE_node_preview_sync_tree(ntree, localtree);
+	local_sync_stats(localtree, ntree);
 }
 
 static void local_merge(bNodeTree *localtree, bNodeTree *ntree)
@@ -141,6 +202,7 @@ static void local_merge(bNodeTree *localtree, bNodeTree *ntree)
 	
 	/* move over the compbufs and previews */
 	BKE_node_preview_merge_tree(ntree, localtree, true);
+	local_sync_stats(localtree, ntree);
 	
 	for (lnode = localtree->nodes.first; lnode; lnode = lnode->next) {
 		if (ntreeNodeExists(ntree, lnode->new_node)) {
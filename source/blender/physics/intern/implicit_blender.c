@@ -43,6 +43,7 @@
 
 #include "BLI_math.h"
 #include "BLI_linklist.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_cloth.h"
@@ -56,9 +57,7 @@
 #  pragma GCC diagnostic ignored "-Wtype-limits"
 #endif
 
-#ifdef _OPENMP
-#  define CLOTH_OPENMP_LIMIT 512
-#endif
+#define CLOTH_THREADED_LIMIT 512
 
 //#define DEBUG_TIME
 
@@ -204,7 +203,7 @@ DO_INLINE float dot_lfvector(float (*fLongVectorA)[3], float (*fLongVectorB)[3],
 // due to non-commutative nature of floating point ops this makes the sim give
 // different results each time you run it!
 // schedule(guided, 2)
-//#pragma omp parallel for reduction(+: temp) if (verts > CLOTH_OPENMP_LIMIT)
+//#pragma omp parallel for reduction(+: temp) if (verts > CLOTH_THREADED_LIMIT)
 	for (i = 0; i < (long)verts; i++) {
 		temp += dot_v3v3(fLongVectorA[i], fLongVectorB[i]);
 	}
@@ -585,31 +584,52 @@ DO_INLINE void initdiag_bfmatrix(fmatrix3x3 *matrix, float m3[3][3])
 	}
 }
 
+typedef struct MulBFMatrixData {
+	float (*to)[3];
+	lfVector *temp;
+	fmatrix3x3 *from;
+	lfVector *fLongVector;
+} MulBFMatrixData;
+
+/* each half of the symmetric product writes its own vector, so both can run at once */
+static void mul_bfmatrix_lfvector_cb(void *userdata, const int section)
+{
+	MulBFMatrixData *data = userdata;
+	fmatrix3x3 *from = data->from;
+	lfVector *fLongVector = data->fLongVector;
+	unsigned int i;
+
+	if (section == 0) {
+		float (*to)[3] = data->to;
+		for (i = from[0].vcount; i < from[0].vcount+from[0].scount; i++) {
+			muladd_fmatrix_fvector(to[from[i].c], from[i].m, fLongVector[from[i].r]);
+		}
+	}
+	else {
+		lfVector *temp = data->temp;
+		for (i = 0; i < from[0].vcount+from[0].scount; i++) {
+			muladd_fmatrix_fvector(temp[from[i].r], from[i].m, fLongVector[from[i].c]);
+		}
+	}
+}
+
 /* SPARSE SYMMETRIC multiply big matrix with long vector*/
 /* STATUS: verified */
 DO_INLINE void mul_bfmatrix_lfvector( float (*to)[3], fmatrix3x3 *from, lfVector *fLongVector)
 {
-	unsigned int i = 0;
 	unsigned int vcount = from[0].vcount;
 	lfVector *temp = create_lfvector(vcount);
+	MulBFMatrixData data = {
+		.to = to,
+		.temp = temp,
+		.from = from,
+		.fLongVector = fLongVector,
+	};
 	
 	zero_lfvector(to, vcount);
 
-#pragma omp parallel sections private(i) if (vcount > CLOTH_OPENMP_LIMIT)
-	{
-#pragma omp section
-		{
-			for (i = from[0].vcount; i < from[0].vcount+from[0].scount; i++) {
-				muladd_fmatrix_fvector(to[from[i].c], from[i].m, fLongVector[from[i].r]);
-			}
-		}
-#pragma omp section
-		{
-			for (i = 0; i < from[0].vcount+from[0].scount; i++) {
-				muladd_fmatrix_fvector(temp[from[i].r], from[i].m, fLongVector[from[i].c]);
-			}
-		}
-	}
+	BLI_task_parallel_range(0, 2, &data, mul_bfmatrix_lfvector_cb, vcount > CLOTH_THREADED_LIMIT);
+
 	add_lfvector_lfvector(to, to, temp, from[0].vcount);
 	
 	del_lfvector(temp);
@@ -747,6 +767,48 @@ DO_INLINE void filter(lfVector *V, fmatrix3x3 *S)
 	}
 }
 
+typedef struct BlockJacobiData {
+	fmatrix3x3 *lA;
+	fmatrix3x3 *Pinv;
+	lfVector *to;
+	lfVector *from;
+} BlockJacobiData;
+
+static void block_jacobi_build_cb(void *userdata, const int i)
+{
+	BlockJacobiData *data = userdata;
+
+	/* diagonal blocks include the vertex mass, fall back to no preconditioning if degenerate */
+	if (!invert_m3_m3(data->Pinv[i].m, data->lA[i].m)) {
+		unit_m3(data->Pinv[i].m);
+	}
+}
+
+static void block_jacobi_apply_cb(void *userdata, const int i)
+{
+	BlockJacobiData *data = userdata;
+
+	mul_fmatrix_fvector(data->to[i], data->Pinv[i].m, data->from[i]);
+}
+
+/* block diagonal preconditioner, Pinv holds the inverse of the diagonal blocks of lA */
+static void block_jacobi_build(fmatrix3x3 *lA, fmatrix3x3 *Pinv)
+{
+	BlockJacobiData data = {.lA = lA, .Pinv = Pinv};
+	const unsigned int numverts = lA[0].vcount;
+
+	BLI_task_parallel_range(0, numverts, &data, block_jacobi_build_cb, numverts > CLOTH_THREADED_LIMIT);
+}
+
+/* to = Pinv * from */
+static void block_jacobi_apply(lfVector *to, fmatrix3x3 *Pinv, lfVector *from)
+{
+	BlockJacobiData data = {.Pinv = Pinv, .to = to, .from = from};
+	const unsigned int numverts = Pinv[0].vcount;
+
+	BLI_task_parallel_range(0, numverts, &data, block_jacobi_apply_cb, numverts > CLOTH_THREADED_LIMIT);
+}
+
 #if 0 /* this version of the CG algorithm does not work very well with partial constraints (where S has non-zero elements) */
 static int  cg_filtered(lfVector *ldV, fmatrix3x3 *lA, lfVector *lB, lfVector *z, fmatrix3x3 *S)
 {
@@ -814,7 +876,7 @@ static int  cg_filtered(lfVector *ldV, fmatrix3x3 *lA, lfVector *lB, lfVector *z
 }
 #endif
 
-static int cg_filtered(lfVector *ldV, fmatrix3x3 *lA, lfVector *lB, lfVector *z, fmatrix3x3 *S, ImplicitSolverResult *result)
+static int cg_filtered(lfVector *ldV, fmatrix3x3 *lA, lfVector *lB, lfVector *z, fmatrix3x3 *S, fmatrix3x3 *Pinv, ImplicitSolverResult *result)
 {
 	// Solves for unknown X in equation AX=B
 	unsigned int conjgrad_loopcount=0, conjgrad_looplimit=100;
@@ -831,10 +893,13 @@ static int cg_filtered(lfVector *ldV, fmatrix3x3 *lA, lfVector *lB, lfVector *z,
 	
 	cp_lfvector(ldV, z, numverts);
 	
-	/* d0 = filter(B)^T * P * filter(B) */
+	block_jacobi_build(lA, Pinv);
+	
+	/* d0 = filter(B)^T * P^-1 * filter(B) */
 	cp_lfvector(fB, lB, numverts);
 	filter(fB, S);
-	bnorm2 = dot_lfvector(fB, fB, numverts);
+	block_jacobi_apply(AdV, Pinv, fB);
+	bnorm2 = dot_lfvector(fB, AdV, numverts);
 	delta_target = conjgrad_epsilon*conjgrad_epsilon * bnorm2;
 	
 	/* r = filter(B - A * dV) */
@@ -843,7 +908,7 @@ static int cg_filtered(lfVector *ldV, fmatrix3x3 *lA, lfVector *lB, lfVector *z,
 	filter(r, S);
 	
 	/* c = filter(P^-1 * r) */
-	cp_lfvector(c, r, numverts);
+	block_jacobi_apply(c, Pinv, r);
 	filter(c, S);
 	
 	/* delta = r^T * c */
@@ -871,7 +936,7 @@ static int cg_filtered(lfVector *ldV, fmatrix3x3 *lA, lfVector *lB, lfVector *z,
 		add_lfvector_lfvectorS(r, r, q, -alpha, numverts);
 		
 		/* s = P^-1 * r */
-		cp_lfvector(s, r, numverts);
+		block_jacobi_apply(s, Pinv, r);
 		delta_old = delta_new;
 		delta_new = dot_lfvector(r, s, numverts);
 		
@@ -909,7 +974,7 @@ DO_INLINE void BuildPPinv(fmatrix3x3 *lA, fmatrix3x3 *P, fmatrix3x3 *Pinv)
 	unsigned int i = 0;
 	
 	// Take only the diagonal blocks of A
-// #pragma omp parallel for private(i) if (lA[0].vcount > CLOTH_OPENMP_LIMIT)
+// #pragma omp parallel for private(i) if (lA[0].vcount > CLOTH_THREADED_LIMIT)
 	for (i = 0; i<lA[0].vcount; i++) {
 		// block diagonalizer
 		cp_fmatrix(P[i].m, lA[i].m);
@@ -1117,7 +1182,7 @@ bool BPH_mass_spring_solve_velocities(Implicit_Data *data, float dt, ImplicitSol
 	double start = PIL_check_seconds_timer();
 #endif
 
-	cg_filtered(data->dV, data->A, data->B, data->z, data->S, result); /* conjugate gradient algorithm to solve Ax=b */
+	cg_filtered(data->dV, data->A, data->B, data->z, data->S, data->Pinv, result); /* conjugate gradient algorithm to solve Ax=b */
 	// cg_filtered_pre(id->dV, id->A, id->B, id->z, id->S, id->P, id->Pinv, id->bigI);
 
 #ifdef DEBUG_TIME
@@ -43,6 +43,7 @@
 #include "BLI_utildefines.h"
 
 #include "RNA_access.h"
+#include "RNA_enum_types.h"
 
 #include "bpy_rna.h"
 
@@ -50,6 +51,8 @@
 
 #include "GPU_material.h"
 
+#include "DRW_engine.h"
+
 #include "gpu.h"
 
 #define PY_MODULE_ADD_CONSTANT(module, name) PyModule_AddIntConstant(module, # name, name)
@@ -316,6 +319,81 @@ static PyMethodDef meth_export_shader[] = {
 	{"export_shader", (PyCFunction)GPU_export_shader, METH_VARARGS | METH_KEYWORDS, GPU_export_shader_doc}
 };
 
+/* -------------------------------------------------------------------- */
+/* Draw Statistics */
+
+PyDoc_STRVAR(GPU_draw_stats_enable_doc,
+"draw_stats_enable(enable)\n"
+"\n"
+"   Record the timings of every 3D viewport redraw, see :func:`draw_stats`.\n"
+"\n"
+"   :arg enable: Enable or disable recording.\n"
+"   :type enable: bool\n"
+);
+static PyObject *GPU_draw_stats_enable(PyObject *UNUSED(self), PyObject *value)
+{
+	int enable = PyObject_IsTrue(value);
+
+	if (enable == -1) {
+		return NULL;
+	}
+
+	DRW_stats_enable(enable);
+
+	Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(GPU_draw_stats_doc,
+"draw_stats()\n"
+"\n"
+"   Timings of the last recorded 3D viewport redraw.\n"
+"\n"
+"   :return: A dictionary with ``\"passes\"``, a list of (name, level, GPU time in ms) tuples\n"
+"      for each engine (level 0) and pass (level 1), and ``\"cache\"``, a dictionary of the CPU time\n"
+"      in ms spent populating the engine caches per object type.\n"
+"   :rtype: dict\n"
+);
+static PyObject *GPU_draw_stats(PyObject *UNUSED(self))
+{
+	PyObject *result = PyDict_New();
+	PyObject *passes, *cache, *val;
+	const int timer_len = DRW_stats_timer_len();
+
+	passes = PyList_New(timer_len);
+	for (int i = 0; i < timer_len; i++) {
+		const char *name;
+		int lvl;
+		double time_ms;
+
+		DRW_stats_timer_get(i, &name, &lvl, &time_ms);
+		PyList_SET_ITEM(passes, i, Py_BuildValue("(sid)", name, lvl, time_ms));
+	}
+	PyDict_SetItemString(result, "passes", passes);
+	Py_DECREF(passes);
+
+	cache = PyDict_New();
+	for (const EnumPropertyItem *item = rna_enum_object_type_items; item->identifier; item++) {
+		if (item->identifier[0] == '\0') {
+			continue;
+		}
+		val = PyFloat_FromDouble(DRW_stats_cache_time_get(item->value));
+		PyDict_SetItemString(cache, item->identifier, val);
+		Py_DECREF(val);
+	}
+	PyDict_SetItemString(result, "cache", cache);
+	Py_DECREF(cache);
+
+	return result;
+}
+
+static PyMethodDef meth_draw_stats_enable[] = {
+	{"draw_stats_enable", (PyCFunction)GPU_draw_stats_enable, METH_O, GPU_draw_stats_enable_doc}
+};
+
+static PyMethodDef meth_draw_stats[] = {
+	{"draw_stats", (PyCFunction)GPU_draw_stats, METH_NOARGS, GPU_draw_stats_doc}
+};
+
 /* -------------------------------------------------------------------- */
 /* Initialize Module */
 
@@ -328,6 +406,8 @@ PyObject *GPU_initPython(void)
 	module = PyInit_gpu();
 
 	PyModule_AddObject(module, "export_shader", (PyObject *)PyCFunction_New(meth_export_shader, NULL));
+	PyModule_AddObject(module, "draw_stats_enable", (PyObject *)PyCFunction_New(meth_draw_stats_enable, NULL));
+	PyModule_AddObject(module, "draw_stats", (PyObject *)PyCFunction_New(meth_draw_stats, NULL));
 
 	/* gpu.offscreen */
 	PyModule_AddObject(module, "offscreen", (submodule = BPyInit_gpu_offscreen()));
@@ -43,6 +43,7 @@
 #include "BLI_path_util.h"
 #include "BLI_rect.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 
 #include "BKE_image.h"
@@ -199,6 +200,36 @@ static void set_pass_full_name(char *fullname, const char *name, int channel, co
 
 /********************************** New **************************************/
 
+/* Passes are filled in rows of this many floats, below which threading isn't worth it. */
+#define PASS_FILL_CHUNK_SIZE (1 << 16)
+
+typedef struct PassFillData {
+	float *rect;
+	size_t rectsize;
+	float value;
+} PassFillData;
+
+static void render_pass_fill_cb(void *__restrict userdata, const int chunk)
+{
+	PassFillData *data = userdata;
+	const size_t start = (size_t)chunk * PASS_FILL_CHUNK_SIZE;
+	const size_t end = MIN2(start + PASS_FILL_CHUNK_SIZE, data->rectsize);
+
+	for (size_t x = start; x < end; x++) {
+		data->rect[x] = data->value;
+	}
+}
+
+/* Full resolution passes of big renders hold hundreds of millions of floats,
+ * so initialize them in parallel. Tiles stay single threaded. */
+static void render_pass_fill(float *rect, size_t rectsize, float value)
+{
+	PassFillData data = {rect, rectsize, value};
+	const int chunks = (int)((rectsize + PASS_FILL_CHUNK_SIZE - 1) / PASS_FILL_CHUNK_SIZE);
+
+	BLI_task_parallel_range(0, chunks, &data, render_pass_fill_cb, chunks > 4);
+}
+
 static RenderPass *render_layer_add_pass(RenderResult *rr, RenderLayer *rl, int channels, const char *name, const char *viewname, const char *chan_id)
 {
 	const int view_id = BLI_findstringindex(&rr->views, viewname, offsetof(RenderView, name));
@@ -223,9 +254,6 @@ static RenderPass *render_layer_add_pass(RenderResult *rr, RenderLayer *rl, int
 		}
 	}
 	else {
-		float *rect;
-		int x;
-		
 		rpass->rect = MEM_mapallocN(sizeof(float) * rectsize, name);
 		if (rpass->rect == NULL) {
 			MEM_freeN(rpass);
@@ -234,14 +262,10 @@ static RenderPass *render_layer_add_pass(RenderResult *rr, RenderLayer *rl, int
 		
 		if (STREQ(rpass->name, RE_PASSNAME_VECTOR)) {
 			/* initialize to max speed */
-			rect = rpass->rect;
-			for (x = rectsize - 1; x >= 0; x--)
-				rect[x] = PASS_VECTOR_MAX;
+			render_pass_fill(rpass->rect, rectsize, PASS_VECTOR_MAX);
 		}
 		else if (STREQ(rpass->name, RE_PASSNAME_Z)) {
-			rect = rpass->rect;
-			for (x = rectsize - 1; x >= 0; x--)
-				rect[x] = 10e10;
+			render_pass_fill(rpass->rect, rectsize, 10e10);
 		}
 	}
 
@@ -835,6 +859,7 @@ bool RE_WriteRenderResult(ReportList *reports, RenderResult *rr, const char *fil
 	int a, nr;
 	const char *chan_view = NULL;
 	int compress = (imf ? imf->exr_codec : 0);
+	const bool multipart = (imf != NULL) ? (imf->flag & R_IMF_FLAG_EXR_MULTIPART) != 0 : false;
 	size_t width, height;
 
 	const bool is_mono = view && !multiview;
@@ -923,7 +948,7 @@ bool RE_WriteRenderResult(ReportList *reports, RenderResult *rr, const char *fil
 
 	BLI_make_existing_file(filename);
 
-	if (IMB_exr_begin_write(exrhandle, filename, width, height, compress, rr->stamp_data)) {
+	if (IMB_exr_begin_write(exrhandle, filename, width, height, compress, multipart, rr->stamp_data)) {
 		IMB_exr_write_channels(exrhandle);
 		success = true;
 	}
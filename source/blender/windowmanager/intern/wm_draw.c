@@ -47,6 +47,7 @@
 #include "BIF_gl.h"
 
 #include "BKE_context.h"
+#include "BKE_global.h"
 #include "BKE_image.h"
 
 #include "GHOST_C-api.h"
@@ -482,17 +483,50 @@ void wm_triple_draw_textures(wmWindow *win, wmDrawTriple *triple, float alpha)
 		glActiveTexture(GL_TEXTURE0);
 }
 
-static void wm_triple_copy_textures(wmWindow *win, wmDrawTriple *triple)
+/* Only copy the part of the window covered by the redrawn regions (dirty_rect),
+ * the rest of the back buffer was just drawn from the texture itself. */
+static void wm_triple_copy_textures(wmWindow *win, wmDrawTriple *triple, const rcti *dirty_rect)
 {
-	const int sizex = WM_window_pixels_x(win);
-	const int sizey = WM_window_pixels_y(win);
+	rcti win_rect, rect;
+
+	BLI_rcti_init(&win_rect, 0, WM_window_pixels_x(win) - 1, 0, WM_window_pixels_y(win) - 1);
+
+	if (!BLI_rcti_isect(&win_rect, dirty_rect, &rect)) {
+		return;
+	}
+
+	const int sizex = BLI_rcti_size_x(&rect) + 1;
+	const int sizey = BLI_rcti_size_y(&rect) + 1;
+
+	if (G.debug & G_DEBUG_WM) {
+		printf("%s: copying %dx%d of %dx%d pixels\n", __func__,
+		       sizex, sizey, BLI_rcti_size_x(&win_rect) + 1, BLI_rcti_size_y(&win_rect) + 1);
+	}
 
 	glBindTexture(triple->target, triple->bind);
 	/* what is GL_READ_BUFFER right now? */
-	glCopyTexSubImage2D(triple->target, 0, 0, 0, 0, 0, sizex, sizey);
+	glCopyTexSubImage2D(triple->target, 0, rect.xmin, rect.ymin, rect.xmin, rect.ymin, sizex, sizey);
 	glBindTexture(triple->target, 0);
 }
 
+/* Freshly generated textures have no content yet, the whole window needs copying. */
+static void wm_triple_dirty_rect_all(wmWindow *win, rcti *dirty_rect, bool *r_is_dirty)
+{
+	BLI_rcti_init(dirty_rect, 0, WM_window_pixels_x(win) - 1, 0, WM_window_pixels_y(win) - 1);
+	*r_is_dirty = true;
+}
+
+static void wm_triple_dirty_rect_add(rcti *dirty_rect, bool *r_is_dirty, const ARegion *ar)
+{
+	if (*r_is_dirty) {
+		BLI_rcti_union(dirty_rect, &ar->winrct);
+	}
+	else {
+		*dirty_rect = ar->winrct;
+		*r_is_dirty = true;
+	}
+}
+
 static void wm_draw_region_blend(wmWindow *win, ARegion *ar, wmDrawTriple *triple)
 {
 	float fac = ED_region_blend_factor(ar);
@@ -516,6 +550,7 @@ static void wm_method_draw_triple(bContext *C, wmWindow *win)
 	bScreen *screen = WM_window_get_active_screen(win);
 	ScrArea *sa;
 	ARegion *ar;
+	rcti dirty_rect;
 	bool copytex = false;
 
 	if (drawdata && drawdata->triple) {
@@ -541,6 +576,8 @@ static void wm_method_draw_triple(bContext *C, wmWindow *win)
 			wm_draw_triple_fail(C, win);
 			return;
 		}
+
+		wm_triple_dirty_rect_all(win, &dirty_rect, &copytex);
 	}
 
 	/* it means stereo was just turned off */
@@ -566,7 +603,7 @@ static void wm_method_draw_triple(bContext *C, wmWindow *win)
 					ED_region_do_draw(C, ar);
 					ar->do_draw = false;
 					CTX_wm_region_set(C, NULL);
-					copytex = true;
+					wm_triple_dirty_rect_add(&dirty_rect, &copytex, ar);
 				}
 			}
 		}
@@ -578,7 +615,7 @@ static void wm_method_draw_triple(bContext *C, wmWindow *win)
 	if (copytex) {
 		wmSubWindowSet(win, screen->mainwin);
 
-		wm_triple_copy_textures(win, triple);
+		wm_triple_copy_textures(win, triple, &dirty_rect);
 	}
 
 	if (wm->paintcursors.first) {
@@ -651,7 +688,8 @@ static void wm_method_draw_triple_multiview(bContext *C, wmWindow *win, StereoVi
 	bScreen *screen = WM_window_get_active_screen(win);
 	ScrArea *sa;
 	ARegion *ar;
-	int copytex = false;
+	rcti dirty_rect;
+	bool copytex = false;
 	int id;
 
 	/* we store the triple_data in sequence to triple_all */
@@ -683,6 +721,8 @@ static void wm_method_draw_triple_multiview(bContext *C, wmWindow *win, StereoVi
 				wm_draw_triple_fail(C, win);
 				return;
 			}
+
+			wm_triple_dirty_rect_all(win, &dirty_rect, &copytex);
 		}
 	}
 
@@ -737,7 +777,7 @@ static void wm_method_draw_triple_multiview(bContext *C, wmWindow *win, StereoVi
 						ar->do_draw = false;
 
 					CTX_wm_region_set(C, NULL);
-					copytex = true;
+					wm_triple_dirty_rect_add(&dirty_rect, &copytex, ar);
 				}
 			}
 		}
@@ -749,7 +789,7 @@ static void wm_method_draw_triple_multiview(bContext *C, wmWindow *win, StereoVi
 	if (copytex) {
 		wmSubWindowSet(win, screen->mainwin);
 
-		wm_triple_copy_textures(win, triple_data);
+		wm_triple_copy_textures(win, triple_data, &dirty_rect);
 	}
 
 	if (wm->paintcursors.first) {
@@ -816,9 +856,10 @@ static void wm_method_draw_triple_multiview(bContext *C, wmWindow *win, StereoVi
 		wm_drags_draw(C, win, NULL);
 	}
 
-	/* copy the ui + overlays */
+	/* copy the ui + overlays, these are redrawn every time so copy the whole window */
 	wmSubWindowSet(win, screen->mainwin);
-	wm_triple_copy_textures(win, triple_all);
+	wm_triple_dirty_rect_all(win, &dirty_rect, &copytex);
+	wm_triple_copy_textures(win, triple_all, &dirty_rect);
 }
 
 /****************** main update call **********************/
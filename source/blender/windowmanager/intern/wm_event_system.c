@@ -54,6 +54,7 @@
 #include "BKE_context.h"
 #include "BKE_idprop.h"
 #include "BKE_global.h"
+#include "BKE_image.h"
 #include "BKE_layer.h"
 #include "BKE_main.h"
 #include "BKE_report.h"
@@ -69,6 +70,8 @@
 #include "ED_view3d.h"
 #include "ED_util.h"
 
+#include "GPU_draw.h"
+
 #include "RNA_access.h"
 
 #include "UI_interface.h"
@@ -270,11 +273,18 @@ void wm_event_do_notifiers(bContext *C)
 	wmWindowManager *wm = CTX_wm_manager(C);
 	wmNotifier *note, *next;
 	wmWindow *win;
+	struct Image *ima;
 	uint64_t win_combine_v3d_datamask = 0;
 	
 	if (wm == NULL)
 		return;
 	
+	/* images loaded in the background need new textures and a redraw */
+	while ((ima = BKE_image_async_load_pop_finished())) {
+		GPU_free_image(ima);
+		WM_main_add_notifier(NC_IMAGE | NA_EDITED, ima);
+	}
+
 	/* cache & catch WM level notifiers, such as frame change, scene/screen set */
 	for (win = wm->windows.first; win; win = win->next) {
 		Scene *scene = WM_window_get_active_scene(win);
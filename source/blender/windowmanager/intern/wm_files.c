@@ -89,6 +89,7 @@
 #include "BKE_workspace.h"
 
 #include "BLO_readfile.h"
+#include "BLO_undofile.h"
 #include "BLO_writefile.h"
 
 #include "RNA_access.h"
@@ -1078,6 +1079,115 @@ bool write_crash_blend(void)
 	}
 }
 
+/** \name Background Saving
+ *
+ * With #USER_SAVE_BACKGROUND the file is written into a #MemFile on the main thread,
+ * compressing and writing it to disk is done by a job, so saving large files doesn't block the interface.
+ * \{ */
+
+typedef struct FileSaveJob {
+	MemFile memfile;
+	char filepath[FILE_MAX];
+	int fileflags;
+	/* Written once the file exists, see #wm_file_write. */
+	ImBuf *ibuf_thumb;
+	ReportList reports;
+	bool done, success;
+} FileSaveJob;
+
+static void wm_file_save_job_write(FileSaveJob *fsj)
+{
+	fsj->success = BLO_memfile_write_file(&fsj->memfile, fsj->filepath, fsj->fileflags, &fsj->reports);
+	BLO_memfile_free(&fsj->memfile);
+	fsj->done = true;
+}
+
+static void wm_file_save_job_startjob(void *customdata, short *UNUSED(stop), short *UNUSED(do_update), float *UNUSED(progress))
+{
+	/* the stop flag is ignored, once the data is taken the file must be written */
+	wm_file_save_job_write(customdata);
+}
+
+static void wm_file_save_job_endjob(void *customdata)
+{
+	FileSaveJob *fsj = customdata;
+	Report *report;
+
+	for (report = fsj->reports.list.first; report; report = report->next) {
+		WM_report(report->type, report->message);
+	}
+
+	if (fsj->success && fsj->ibuf_thumb) {
+		IMB_thumb_delete(fsj->filepath, THB_FAIL); /* without this a failed thumb overrides */
+		fsj->ibuf_thumb = IMB_thumb_create(fsj->filepath, THB_LARGE, THB_SOURCE_BLEND, fsj->ibuf_thumb);
+	}
+}
+
+static void wm_file_save_job_free(void *customdata)
+{
+	FileSaveJob *fsj = customdata;
+
+	/* A job killed while waiting for an earlier save to finish (when quitting for example)
+	 * never ran, don't lose the file. */
+	if (!fsj->done) {
+		wm_file_save_job_write(fsj);
+		BKE_reports_print(&fsj->reports, RPT_ERROR);
+	}
+
+	if (fsj->ibuf_thumb) {
+		IMB_freeImBuf(fsj->ibuf_thumb);
+	}
+	BKE_reports_clear(&fsj->reports);
+	MEM_freeN(fsj);
+}
+
+static bool wm_file_write_use_background(void)
+{
+	return (U.flag & USER_SAVE_BACKGROUND) && (G.background == false);
+}
+
+/**
+ * Take a copy of the file data and write it from a job.
+ *
+ * \param r_ibuf_thumb: Thumbnail to write once the file is saved, ownership is taken by the job.
+ * 
+eturn Success creating the copy, errors writing the file are reported when the job ends.
+ */
+static bool wm_file_write_background(
+        wmWindowManager *wm, Main *bmain, const char *filepath, int fileflags,
+        ReportList *reports, const BlendThumbnail *thumb, ImBuf **r_ibuf_thumb)
+{
+	FileSaveJob *fsj = MEM_callocN(sizeof(*fsj), __func__);
+	wmJob *wm_job;
+
+	if (!BLO_write_file_to_memfile(bmain, filepath, fileflags, &fsj->memfile, thumb)) {
+		BKE_reportf(reports, RPT_ERROR, "Cannot save blend file '%s'", filepath);
+		BLO_memfile_free(&fsj->memfile);
+		MEM_freeN(fsj);
+		return false;
+	}
+
+	BLI_strncpy(fsj->filepath, filepath, sizeof(fsj->filepath));
+	fsj->fileflags = fileflags;
+	BKE_reports_init(&fsj->reports, RPT_STORE);
+	if (r_ibuf_thumb) {
+		fsj->ibuf_thumb = *r_ibuf_thumb;
+		*r_ibuf_thumb = NULL;
+	}
+
+	/* Each save is its own job (owned by its data), a save started while another one is
+	 * being written waits for it, instead of replacing it. */
+	wm_job = WM_jobs_get(wm, NULL, fsj, "Saving", 0, WM_JOB_TYPE_FILE_SAVE);
+	WM_jobs_customdata_set(wm_job, fsj, wm_file_save_job_free);
+	WM_jobs_timer(wm_job, 0.1, 0, 0);
+	WM_jobs_callbacks(wm_job, wm_file_save_job_startjob, NULL, NULL, wm_file_save_job_endjob);
+	WM_jobs_start(wm, wm_job);
+
+	return true;
+}
+
+/** \} */
+
 /**
  * \see #wm_homefile_write_exec wraps #BLO_write_file in a similar way.
  */
@@ -1152,7 +1262,10 @@ static int wm_file_write(bContext *C, const char *filepath, int fileflags, Repor
 	/* XXX temp solution to solve bug, real fix coming (ton) */
 	G.main->recovered = 0;
 	
-	if (BLO_write_file(CTX_data_main(C), filepath, fileflags, reports, thumb)) {
+	if (wm_file_write_use_background() ?
+	    wm_file_write_background(CTX_wm_manager(C), CTX_data_main(C), filepath, fileflags, reports, thumb, &ibuf_thumb) :
+	    BLO_write_file(CTX_data_main(C), filepath, fileflags, reports, thumb))
+	{
 		const bool do_history = (G.background == false) && (CTX_wm_manager(C)->op_undo_depth == 0);
 
 		if (!(fileflags & G_FILE_SAVE_COPY)) {
@@ -1163,6 +1276,8 @@ static int wm_file_write(bContext *C, const char *filepath, int fileflags, Repor
 		}
 
 		BKE_BIT_TEST_SET(G.fileflags, fileflags & G_FILE_COMPRESS, G_FILE_COMPRESS);
+		BKE_BIT_TEST_SET(G.fileflags, fileflags & G_FILE_COMPRESS_FAST, G_FILE_COMPRESS_FAST);
+		BKE_BIT_TEST_SET(G.fileflags, fileflags & G_FILE_BLOCK_HASH, G_FILE_BLOCK_HASH);
 		BKE_BIT_TEST_SET(G.fileflags, fileflags & G_FILE_AUTOPLAY, G_FILE_AUTOPLAY);
 
 		/* prevent background mode scripts from clobbering history */
@@ -1262,7 +1377,16 @@ void wm_autosave_timer(const bContext *C, wmWindowManager *wm, wmTimer *UNUSED(w
 
 	wm_autosave_location(filepath);
 
-	if (U.uiflag & USER_GLOBALUNDO) {
+	if (wm_file_write_use_background()) {
+		/* save as regular blend file, written in the background */
+		int fileflags = G.fileflags & ~(G_FILE_COMPRESS | G_FILE_AUTOPLAY | G_FILE_HISTORY);
+
+		ED_editors_flush_edits(C, false);
+
+		/* Error reporting when the job ends */
+		wm_file_write_background(wm, CTX_data_main(C), filepath, fileflags, NULL, NULL, NULL);
+	}
+	else if (U.uiflag & USER_GLOBALUNDO) {
 		/* fast save of last undobuffer, now with UI */
 		BKE_undo_save_file(filepath);
 	}
@@ -2015,6 +2139,16 @@ static void save_set_compress(wmOperator *op)
 			RNA_property_boolean_set(op->ptr, prop, (U.flag & USER_FILECOMPRESS) != 0);
 		}
 	}
+
+	prop = RNA_struct_find_property(op->ptr, "compress_fast");
+	if (!RNA_property_is_set(op->ptr, prop)) {
+		RNA_property_boolean_set(op->ptr, prop, G.save_over && (G.fileflags & G_FILE_COMPRESS_FAST) != 0);
+	}
+
+	prop = RNA_struct_find_property(op->ptr, "block_hashes");
+	if (!RNA_property_is_set(op->ptr, prop)) {
+		RNA_property_boolean_set(op->ptr, prop, G.save_over && (G.fileflags & G_FILE_BLOCK_HASH) != 0);
+	}
 }
 
 static void save_set_filepath(wmOperator *op)
@@ -2070,6 +2204,10 @@ static int wm_save_as_mainfile_exec(bContext *C, wmOperator *op)
 	/* set compression flag */
 	BKE_BIT_TEST_SET(fileflags, RNA_boolean_get(op->ptr, "compress"),
 	                 G_FILE_COMPRESS);
+	BKE_BIT_TEST_SET(fileflags, RNA_boolean_get(op->ptr, "compress_fast"),
+	                 G_FILE_COMPRESS_FAST);
+	BKE_BIT_TEST_SET(fileflags, RNA_boolean_get(op->ptr, "block_hashes"),
+	                 G_FILE_BLOCK_HASH);
 	BKE_BIT_TEST_SET(fileflags, RNA_boolean_get(op->ptr, "relative_remap"),
 	                 G_FILE_RELATIVE_REMAP);
 	BKE_BIT_TEST_SET(fileflags,
@@ -2126,6 +2264,11 @@ void WM_OT_save_as_mainfile(wmOperatorType *ot)
 	        ot, FILE_TYPE_FOLDER | FILE_TYPE_BLENDER, FILE_BLENDER, FILE_SAVE,
 	        WM_FILESEL_FILEPATH, FILE_DEFAULTDISPLAY, FILE_SORT_ALPHA);
 	RNA_def_boolean(ot->srna, "compress", false, "Compress", "Write compressed .blend file");
+	RNA_def_boolean(ot->srna, "compress_fast", false, "Fast Compression",
+	                "Compress using fast, multi-threaded compression instead of gzip "
+	                "(files can't be opened by older versions)");
+	RNA_def_boolean(ot->srna, "block_hashes", false, "Block Hashes",
+	                "Store a content hash of every block, so files can be compared without loading them");
 	RNA_def_boolean(ot->srna, "relative_remap", true, "Remap Relative",
 	                "Remap relative paths when saving in a different directory");
 	prop = RNA_def_boolean(ot->srna, "copy", false, "Save Copy",
@@ -2192,6 +2335,11 @@ void WM_OT_save_mainfile(wmOperatorType *ot)
 	        ot, FILE_TYPE_FOLDER | FILE_TYPE_BLENDER, FILE_BLENDER, FILE_SAVE,
 	        WM_FILESEL_FILEPATH, FILE_DEFAULTDISPLAY, FILE_SORT_ALPHA);
 	RNA_def_boolean(ot->srna, "compress", false, "Compress", "Write compressed .blend file");
+	RNA_def_boolean(ot->srna, "compress_fast", false, "Fast Compression",
+	                "Compress using fast, multi-threaded compression instead of gzip "
+	                "(files can't be opened by older versions)");
+	RNA_def_boolean(ot->srna, "block_hashes", false, "Block Hashes",
+	                "Store a content hash of every block, so files can be compared without loading them");
 	RNA_def_boolean(ot->srna, "relative_remap", false, "Remap Relative",
 	                "Remap relative paths when saving in a different directory");
 }
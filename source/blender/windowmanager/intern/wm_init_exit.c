@@ -52,6 +52,8 @@
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
+#include "PIL_time.h"
+
 #include "BLO_writefile.h"
 
 #include "BKE_blender.h"
@@ -150,10 +152,22 @@ static void wm_undo_kill_callback(bContext *C)
 
 bool wm_start_with_console = false; /* used in creator.c */
 
+/* Print the time spent in a startup stage with '--debug', to find what slows down startup. */
+static void wm_init_time_report(const char *stage, double *r_time)
+{
+	if (G.debug & G_DEBUG) {
+		const double time = PIL_check_seconds_timer();
+		printf("startup: %-24s %8.3f ms\n", stage, (time - *r_time) * 1000.0);
+		*r_time = time;
+	}
+}
+
 /* only called once, for startup */
 void WM_init(bContext *C, int argc, const char **argv)
 {
-	
+	const double time_start = PIL_check_seconds_timer();
+	double time_stage = time_start;
+
 	if (!G.background) {
 		wm_ghost_init(C);   /* note: it assigns C to ghost! */
 		wm_init_cursor_data();
@@ -181,6 +195,8 @@ void WM_init(bContext *C, int argc, const char **argv)
 	                          ED_render_scene_update,
 	                          ED_render_scene_update_pre);
 	
+	wm_init_time_report("types", &time_stage);
+
 	ED_spacetypes_init();   /* editors/space_api/spacetype.c */
 	
 	ED_file_init();         /* for fsmenu */
@@ -189,6 +205,8 @@ void WM_init(bContext *C, int argc, const char **argv)
 	BLF_init(); /* Please update source/gamengine/GamePlayer/GPG_ghost.cpp if you change this */
 	BLT_lang_init();
 
+	wm_init_time_report("editors and fonts", &time_stage);
+
 	/* Enforce loading the UI for the initial homefile */
 	G.fileflags &= ~G_FILE_NO_UI;
 
@@ -199,6 +217,7 @@ void WM_init(bContext *C, int argc, const char **argv)
 	/* get the default database, plus a wm */
 	wm_homefile_read(C, NULL, G.factory_startup, false, NULL, NULL);
 	
+	wm_init_time_report("startup file", &time_stage);
 
 	BLT_lang_set(NULL);
 
@@ -230,6 +249,7 @@ void WM_init(bContext *C, int argc, const char **argv)
 		BKE_icons_init(1);
 	}
 
+	wm_init_time_report("GPU and UI", &time_stage);
 
 	ED_spacemacros_init();
 
@@ -246,6 +266,8 @@ void WM_init(bContext *C, int argc, const char **argv)
 	BPY_python_start(argc, argv);
 
 	BPY_python_reset(C);
+
+	wm_init_time_report("Python and add-ons", &time_stage);
 #else
 	(void)argc; /* unused */
 	(void)argv; /* unused */
@@ -261,6 +283,10 @@ void WM_init(bContext *C, int argc, const char **argv)
 
 	wm_history_file_read();
 
+	if (G.debug & G_DEBUG) {
+		printf("startup: %-24s %8.3f ms\n", "total", (PIL_check_seconds_timer() - time_start) * 1000.0);
+	}
+
 	/* allow a path of "", this is what happens when making a new file */
 #if 0
 	if (G.main->name[0] == 0)
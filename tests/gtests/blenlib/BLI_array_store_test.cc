@@ -644,6 +644,9 @@ TEST(array_store, TestData_Stride12_Chunk48_Mutate2) { random_data_mutate_helper
 TEST(array_store, TestData_Stride32_Chunk64_Mutate1) { random_data_mutate_helper(0,   256,  200, 32,  64,  3112, 1); }
 TEST(array_store, TestData_Stride32_Chunk64_Mutate8) { random_data_mutate_helper(0,   256,  200, 32,  64,  7117, 8); }
 
+/* Large enough to hash in parallel. */
+TEST(array_store, TestData_Large_Stride4_Chunk64_Mutate8) { random_data_mutate_helper(40000, 50000, 16, 4, 64, 4223, 8); }
+
 
 /* -------------------------------------------------------------------- */
 /* Randomized Chunks Test */
@@ -721,6 +724,9 @@ TEST(array_store, TestChunk_Rand32_Stride1_Chunk64)  { random_chunk_mutate_helpe
 TEST(array_store, TestChunk_Rand64_Stride8_Chunk32)  { random_chunk_mutate_helper(64, 100,  8, 32, 2772); }
 TEST(array_store, TestChunk_Rand31_Stride11_Chunk21) { random_chunk_mutate_helper(31, 100, 11, 21, 7117); }
 
+/* Large enough to hash in parallel. */
+TEST(array_store, TestChunk_Rand2048_Stride4_Chunk64) { random_chunk_mutate_helper(2048, 8,  4, 64, 5113); }
+
 
 #if 0
 /* -------------------------------------------------------------------- */
@@ -0,0 +1,589 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_edgehash.h"
+#include "BLI_ghash.h"
+#include "BLI_heap.h"
+#include "BLI_kdopbvh.h"
+#include "BLI_kdtree.h"
+#include "BLI_math.h"
+#include "BLI_mempool.h"
+#include "BLI_polyfill2d.h"
+#include "BLI_rand.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
+#include "PIL_time.h"
+}
+
+/* Micro-benchmarks for blenlib containers and math.
+ *
+ * Datasets are generated from fixed seeds, so runs on different builds can be compared.
+ * Each benchmark is repeated, the fastest and average time are reported.
+ *
+ * Options:
+ * - `--benchmark_json=<path>` writes all results to a JSON file.
+ * - `--benchmark_scale=<factor>` scales the size of all datasets.
+ * - `--benchmark_repeat=<count>` number of runs for each benchmark.
+ */
+
+DEFINE_string(benchmark_json, "", "Write the benchmark results to this file as JSON.");
+DEFINE_double(benchmark_scale, 1.0, "Scale the size of all benchmark datasets.");
+DEFINE_int32(benchmark_repeat, 5, "Number of runs for each benchmark, the fastest is reported.");
+
+/* -------------------------------------------------------------------- */
+/** \name Benchmark Utilities
+ * \{ */
+
+typedef void (*BenchmarkFn)(void *data);
+
+typedef struct BenchmarkResult {
+	std::string id;
+	size_t items;
+	double time_min;
+	double time_avg;
+} BenchmarkResult;
+
+static std::vector<BenchmarkResult> benchmark_results;
+
+static void benchmark_run(const char *id, const size_t items, BenchmarkFn fn, void *data)
+{
+	const int repeat = max_ii(FLAGS_benchmark_repeat, 1);
+	double time_min = DBL_MAX, time_sum = 0.0;
+
+	for (int i = 0; i < repeat; i++) {
+		const double time_start = PIL_check_seconds_timer();
+		fn(data);
+		const double time = PIL_check_seconds_timer() - time_start;
+		time_min = MIN2(time_min, time);
+		time_sum += time;
+	}
+
+	BenchmarkResult result;
+	result.id = id;
+	result.items = items;
+	result.time_min = time_min;
+	result.time_avg = time_sum / repeat;
+	benchmark_results.push_back(result);
+
+	printf("%-40s %10u items, min %.6fs, avg %.6fs (%.2f ns/item)\n",
+	       id, (unsigned int)items, time_min, result.time_avg,
+	       items ? (time_min * 1e9) / (double)items : 0.0);
+	fflush(stdout);
+}
+
+static unsigned int benchmark_size(const unsigned int size)
+{
+	return MAX2((unsigned int)((double)size * FLAGS_benchmark_scale), 1u);
+}
+
+static void benchmark_results_write_json(const char *filepath)
+{
+	FILE *fp = fopen(filepath, "w");
+	if (fp == NULL) {
+		printf("ERROR: could not write benchmark results to '%s'\n", filepath);
+		return;
+	}
+
+	fprintf(fp, "{\n\t\"scale\": %f,\n\t\"repeat\": %d,\n\t\"threads\": %d,\n\t\"results\": [\n",
+	        FLAGS_benchmark_scale, FLAGS_benchmark_repeat, BLI_system_thread_count());
+	for (size_t i = 0; i < benchmark_results.size(); i++) {
+		const BenchmarkResult &result = benchmark_results[i];
+		fprintf(fp, "\t\t{\"id\": \"%s\", \"items\": %u, \"time_min\": %.9f, \"time_avg\": %.9f}%s\n",
+		        result.id.c_str(), (unsigned int)result.items, result.time_min, result.time_avg,
+		        (i + 1 != benchmark_results.size()) ? "," : "");
+	}
+	fprintf(fp, "\t]\n}\n");
+	fclose(fp);
+}
+
+class BenchmarkEnvironment : public ::testing::Environment {
+public:
+	virtual void SetUp()
+	{
+		BLI_threadapi_init();
+	}
+
+	virtual void TearDown()
+	{
+		if (!FLAGS_benchmark_json.empty()) {
+			benchmark_results_write_json(FLAGS_benchmark_json.c_str());
+		}
+		BLI_threadapi_exit();
+	}
+};
+
+static ::testing::Environment *const benchmark_env =
+        ::testing::AddGlobalTestEnvironment(new BenchmarkEnvironment);
+
+static unsigned int *benchmark_keys_random(const unsigned int keys_len, const unsigned int seed)
+{
+	unsigned int *keys = (unsigned int *)MEM_mallocN(sizeof(*keys) * keys_len, __func__);
+	RNG *rng = BLI_rng_new(seed);
+	for (unsigned int i = 0; i < keys_len; i++) {
+		keys[i] = BLI_rng_get_uint(rng);
+	}
+	BLI_rng_free(rng);
+	return keys;
+}
+
+static float (*benchmark_points_random(const unsigned int points_len, const unsigned int seed))[3]
+{
+	float (*points)[3] = (float (*)[3])MEM_mallocN(sizeof(*points) * points_len, __func__);
+	RNG *rng = BLI_rng_new(seed);
+	for (unsigned int i = 0; i < points_len; i++) {
+		for (int j = 0; j < 3; j++) {
+			points[i][j] = BLI_rng_get_float(rng) * 2.0f - 1.0f;
+		}
+	}
+	BLI_rng_free(rng);
+	return points;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name GHash & EdgeHash
+ * \{ */
+
+typedef struct HashData {
+	unsigned int *keys;
+	unsigned int keys_len;
+	GHash *ghash;
+	EdgeHash *ehash;
+} HashData;
+
+static void ghash_insert_fn(void *userdata)
+{
+	HashData *data = (HashData *)userdata;
+	GHash *ghash = BLI_ghash_int_new(__func__);
+	for (unsigned int i = 0; i < data->keys_len; i++) {
+		BLI_ghash_reinsert(ghash, SET_UINT_IN_POINTER(data->keys[i]), SET_UINT_IN_POINTER(i), NULL, NULL);
+	}
+	BLI_ghash_free(ghash, NULL, NULL);
+}
+
+static void ghash_lookup_fn(void *userdata)
+{
+	HashData *data = (HashData *)userdata;
+	uintptr_t sum = 0;
+	for (unsigned int i = 0; i < data->keys_len; i++) {
+		sum += (uintptr_t)BLI_ghash_lookup(data->ghash, SET_UINT_IN_POINTER(data->keys[i]));
+	}
+	EXPECT_NE(sum, (uintptr_t)0);
+}
+
+static void edgehash_insert_fn(void *userdata)
+{
+	HashData *data = (HashData *)userdata;
+	EdgeHash *ehash = BLI_edgehash_new(__func__);
+	for (unsigned int i = 0; i + 1 < data->keys_len; i++) {
+		BLI_edgehash_reinsert(ehash, data->keys[i], data->keys[i + 1], SET_UINT_IN_POINTER(i));
+	}
+	BLI_edgehash_free(ehash, NULL);
+}
+
+static void edgehash_lookup_fn(void *userdata)
+{
+	HashData *data = (HashData *)userdata;
+	uintptr_t sum = 0;
+	for (unsigned int i = 0; i + 1 < data->keys_len; i++) {
+		sum += (uintptr_t)BLI_edgehash_lookup(data->ehash, data->keys[i + 1], data->keys[i]);
+	}
+	EXPECT_NE(sum, (uintptr_t)0);
+}
+
+TEST(benchmark, GHash)
+{
+	HashData data = {NULL};
+	data.keys_len = benchmark_size(1000000);
+	data.keys = benchmark_keys_random(data.keys_len, 1);
+
+	benchmark_run("ghash_int_insert", data.keys_len, ghash_insert_fn, &data);
+
+	data.ghash = BLI_ghash_int_new(__func__);
+	for (unsigned int i = 0; i < data.keys_len; i++) {
+		BLI_ghash_reinsert(data.ghash, SET_UINT_IN_POINTER(data.keys[i]), SET_UINT_IN_POINTER(i), NULL, NULL);
+	}
+	benchmark_run("ghash_int_lookup", data.keys_len, ghash_lookup_fn, &data);
+	BLI_ghash_free(data.ghash, NULL, NULL);
+
+	MEM_freeN(data.keys);
+}
+
+TEST(benchmark, EdgeHash)
+{
+	HashData data = {NULL};
+	data.keys_len = benchmark_size(1000000);
+	data.keys = benchmark_keys_random(data.keys_len, 2);
+
+	benchmark_run("edgehash_insert", data.keys_len - 1, edgehash_insert_fn, &data);
+
+	data.ehash = BLI_edgehash_new(__func__);
+	for (unsigned int i = 0; i + 1 < data.keys_len; i++) {
+		BLI_edgehash_reinsert(data.ehash, data.keys[i], data.keys[i + 1], SET_UINT_IN_POINTER(i));
+	}
+	benchmark_run("edgehash_lookup", data.keys_len - 1, edgehash_lookup_fn, &data);
+	BLI_edgehash_free(data.ehash, NULL);
+
+	MEM_freeN(data.keys);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name BLI_mempool & BLI_heap
+ * \{ */
+
+typedef struct ElemData {
+	unsigned int elems_len;
+	unsigned int *keys;
+	void **elems;
+} ElemData;
+
+static void mempool_alloc_fn(void *userdata)
+{
+	ElemData *data = (ElemData *)userdata;
+	BLI_mempool *pool = BLI_mempool_create(sizeof(float[4]), 0, 512, BLI_MEMPOOL_NOP);
+	for (unsigned int i = 0; i < data->elems_len; i++) {
+		data->elems[i] = BLI_mempool_alloc(pool);
+	}
+	/* free in a scattered order, then re-use the free-list. */
+	for (unsigned int i = 0; i < data->elems_len; i++) {
+		const unsigned int j = data->keys[i] % data->elems_len;
+		if (data->elems[j]) {
+			BLI_mempool_free(pool, data->elems[j]);
+			data->elems[j] = NULL;
+		}
+	}
+	for (unsigned int i = 0; i < data->elems_len; i++) {
+		if (data->elems[i] == NULL) {
+			data->elems[i] = BLI_mempool_alloc(pool);
+		}
+	}
+	BLI_mempool_destroy(pool);
+}
+
+static void heap_fn(void *userdata)
+{
+	ElemData *data = (ElemData *)userdata;
+	Heap *heap = BLI_heap_new_ex(data->elems_len);
+	for (unsigned int i = 0; i < data->elems_len; i++) {
+		BLI_heap_insert(heap, (float)data->keys[i], SET_UINT_IN_POINTER(i));
+	}
+	while (!BLI_heap_is_empty(heap)) {
+		BLI_heap_popmin(heap);
+	}
+	BLI_heap_free(heap, NULL);
+}
+
+TEST(benchmark, Mempool)
+{
+	ElemData data = {0};
+	data.elems_len = benchmark_size(1000000);
+	data.keys = benchmark_keys_random(data.elems_len, 3);
+	data.elems = (void **)MEM_mallocN(sizeof(*data.elems) * data.elems_len, __func__);
+
+	benchmark_run("mempool_alloc_free", data.elems_len, mempool_alloc_fn, &data);
+
+	MEM_freeN(data.elems);
+	MEM_freeN(data.keys);
+}
+
+TEST(benchmark, Heap)
+{
+	ElemData data = {0};
+	data.elems_len = benchmark_size(1000000);
+	data.keys = benchmark_keys_random(data.elems_len, 4);
+
+	benchmark_run("heap_insert_popmin", data.elems_len, heap_fn, &data);
+
+	MEM_freeN(data.keys);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name BVHTree & KDTree
+ * \{ */
+
+typedef struct TreeData {
+	float (*points)[3];
+	unsigned int points_len;
+	float (*queries)[3];
+	unsigned int queries_len;
+	BVHTree *bvhtree;
+	KDTree *kdtree;
+} TreeData;
+
+static BVHTree *bvhtree_from_points(const float (*points)[3], const unsigned int points_len)
+{
+	BVHTree *tree = BLI_bvhtree_new((int)points_len, 0.0f, 2, 6);
+	for (unsigned int i = 0; i < points_len; i++) {
+		BLI_bvhtree_insert(tree, (int)i, points[i], 1);
+	}
+	BLI_bvhtree_balance(tree);
+	return tree;
+}
+
+static KDTree *kdtree_from_points(const float (*points)[3], const unsigned int points_len)
+{
+	KDTree *tree = BLI_kdtree_new(points_len);
+	for (unsigned int i = 0; i < points_len; i++) {
+		BLI_kdtree_insert(tree, (int)i, points[i]);
+	}
+	BLI_kdtree_balance(tree);
+	return tree;
+}
+
+static void bvhtree_build_fn(void *userdata)
+{
+	TreeData *data = (TreeData *)userdata;
+	BLI_bvhtree_free(bvhtree_from_points(data->points, data->points_len));
+}
+
+static void bvhtree_find_nearest_fn(void *userdata)
+{
+	TreeData *data = (TreeData *)userdata;
+	for (unsigned int i = 0; i < data->queries_len; i++) {
+		BVHTreeNearest nearest;
+		nearest.index = -1;
+		nearest.dist_sq = FLT_MAX;
+		BLI_bvhtree_find_nearest(data->bvhtree, data->queries[i], &nearest, NULL, NULL);
+	}
+}
+
+static void bvhtree_find_nearest_array_fn(void *userdata)
+{
+	TreeData *data = (TreeData *)userdata;
+	BVHTreeNearest *nearest = (BVHTreeNearest *)MEM_mallocN(sizeof(*nearest) * data->queries_len, __func__);
+	for (unsigned int i = 0; i < data->queries_len; i++) {
+		nearest[i].index = -1;
+		nearest[i].dist_sq = FLT_MAX;
+	}
+	BLI_bvhtree_find_nearest_array(data->bvhtree, data->queries, (int)data->queries_len, nearest, NULL, NULL);
+	MEM_freeN(nearest);
+}
+
+static void kdtree_build_fn(void *userdata)
+{
+	TreeData *data = (TreeData *)userdata;
+	BLI_kdtree_free(kdtree_from_points(data->points, data->points_len));
+}
+
+static void kdtree_find_nearest_fn(void *userdata)
+{
+	TreeData *data = (TreeData *)userdata;
+	for (unsigned int i = 0; i < data->queries_len; i++) {
+		KDTreeNearest nearest;
+		BLI_kdtree_find_nearest(data->kdtree, data->queries[i], &nearest);
+	}
+}
+
+static void kdtree_find_nearest_array_fn(void *userdata)
+{
+	TreeData *data = (TreeData *)userdata;
+	KDTreeNearest *nearest = (KDTreeNearest *)MEM_mallocN(sizeof(*nearest) * data->queries_len, __func__);
+	BLI_kdtree_find_nearest_array(data->kdtree, data->queries, (int)data->queries_len, nearest);
+	MEM_freeN(nearest);
+}
+
+static void tree_data_init(TreeData *data)
+{
+	memset(data, 0, sizeof(*data));
+	data->points_len = benchmark_size(500000);
+	data->points = benchmark_points_random(data->points_len, 5);
+	data->queries_len = benchmark_size(200000);
+	data->queries = benchmark_points_random(data->queries_len, 6);
+}
+
+static void tree_data_free(TreeData *data)
+{
+	MEM_freeN(data->points);
+	MEM_freeN(data->queries);
+}
+
+TEST(benchmark, BVHTree)
+{
+	TreeData data;
+	tree_data_init(&data);
+
+	benchmark_run("bvhtree_build", data.points_len, bvhtree_build_fn, &data);
+
+	data.bvhtree = bvhtree_from_points(data.points, data.points_len);
+	benchmark_run("bvhtree_find_nearest", data.queries_len, bvhtree_find_nearest_fn, &data);
+	benchmark_run("bvhtree_find_nearest_array", data.queries_len, bvhtree_find_nearest_array_fn, &data);
+	BLI_bvhtree_free(data.bvhtree);
+
+	tree_data_free(&data);
+}
+
+TEST(benchmark, KDTree)
+{
+	TreeData data;
+	tree_data_init(&data);
+
+	benchmark_run("kdtree_build", data.points_len, kdtree_build_fn, &data);
+
+	data.kdtree = kdtree_from_points(data.points, data.points_len);
+	benchmark_run("kdtree_find_nearest", data.queries_len, kdtree_find_nearest_fn, &data);
+	benchmark_run("kdtree_find_nearest_array", data.queries_len, kdtree_find_nearest_array_fn, &data);
+	BLI_kdtree_free(data.kdtree);
+
+	tree_data_free(&data);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Polyfill 2D
+ * \{ */
+
+typedef struct PolyfillData {
+	float (*coords)[2];
+	unsigned int coords_len;
+	unsigned int (*tris)[3];
+} PolyfillData;
+
+static void polyfill_fn(void *userdata)
+{
+	PolyfillData *data = (PolyfillData *)userdata;
+	BLI_polyfill_calc(data->coords, data->coords_len, 0, data->tris);
+}
+
+TEST(benchmark, Polyfill2D)
+{
+	PolyfillData data;
+	data.coords_len = benchmark_size(20000);
+	data.coords = (float (*)[2])MEM_mallocN(sizeof(*data.coords) * data.coords_len, __func__);
+	data.tris = (unsigned int (*)[3])MEM_mallocN(sizeof(*data.tris) * (data.coords_len - 2), __func__);
+
+	/* a star shape, so every other corner is concave. */
+	for (unsigned int i = 0; i < data.coords_len; i++) {
+		const float angle = ((float)i / (float)data.coords_len) * (float)(M_PI * 2.0);
+		const float radius = (i % 2) ? 0.5f : 1.0f;
+		data.coords[i][0] = cosf(angle) * radius;
+		data.coords[i][1] = sinf(angle) * radius;
+	}
+
+	benchmark_run("polyfill2d_star", data.coords_len, polyfill_fn, &data);
+
+	MEM_freeN(data.coords);
+	MEM_freeN(data.tris);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name BLI_task_parallel_range
+ * \{ */
+
+typedef struct TaskData {
+	int iter_len;
+	float *values;
+} TaskData;
+
+static void task_range_cb(void *userdata, const int iter)
+{
+	TaskData *data = (TaskData *)userdata;
+	data->values[iter] += 1.0f;
+}
+
+static void task_range_threaded_fn(void *userdata)
+{
+	TaskData *data = (TaskData *)userdata;
+	BLI_task_parallel_range(0, data->iter_len, data, task_range_cb, true);
+}
+
+static void task_range_serial_fn(void *userdata)
+{
+	TaskData *data = (TaskData *)userdata;
+	BLI_task_parallel_range(0, data->iter_len, data, task_range_cb, false);
+}
+
+static void task_range_small_fn(void *userdata)
+{
+	/* overhead of starting a parallel loop, for many small loops. */
+	TaskData *data = (TaskData *)userdata;
+	for (int i = 0; i < 1000; i++) {
+		BLI_task_parallel_range(0, 64, data, task_range_cb, true);
+	}
+}
+
+TEST(benchmark, TaskParallelRange)
+{
+	TaskData data;
+	data.iter_len = (int)benchmark_size(4000000);
+	data.values = (float *)MEM_callocN(sizeof(*data.values) * (size_t)data.iter_len, __func__);
+
+	benchmark_run("task_parallel_range_serial", (size_t)data.iter_len, task_range_serial_fn, &data);
+	benchmark_run("task_parallel_range_threaded", (size_t)data.iter_len, task_range_threaded_fn, &data);
+	benchmark_run("task_parallel_range_small_x1000", 1000, task_range_small_fn, &data);
+
+	MEM_freeN(data.values);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Math Batch Functions
+ * \{ */
+
+typedef struct MathData {
+	float (*vecs)[3];
+	unsigned int vecs_len;
+	float mat[4][4];
+} MathData;
+
+static void math_mul_m4_v3_fn(void *userdata)
+{
+	MathData *data = (MathData *)userdata;
+	for (unsigned int i = 0; i < data->vecs_len; i++) {
+		mul_m4_v3(data->mat, data->vecs[i]);
+	}
+}
+
+static void math_mul_m4_v3_array_fn(void *userdata)
+{
+	MathData *data = (MathData *)userdata;
+	mul_m4_v3_array(data->mat, data->vecs, (int)data->vecs_len);
+}
+
+static void math_normalize_v3_fn(void *userdata)
+{
+	MathData *data = (MathData *)userdata;
+	for (unsigned int i = 0; i < data->vecs_len; i++) {
+		normalize_v3(data->vecs[i]);
+	}
+}
+
+static void math_normalize_v3_array_fn(void *userdata)
+{
+	MathData *data = (MathData *)userdata;
+	normalize_v3_array(data->vecs, (int)data->vecs_len);
+}
+
+TEST(benchmark, MathBatch)
+{
+	MathData data;
+	data.vecs_len = benchmark_size(4000000);
+	data.vecs = benchmark_points_random(data.vecs_len, 7);
+	/* close to identity, so repeated runs don't overflow. */
+	const float loc[3] = {0.001f, 0.0f, -0.001f}, eul[3] = {0.1f, 0.2f, 0.3f}, size[3] = {1.0f, 1.0f, 1.0f};
+	loc_eul_size_to_mat4(data.mat, loc, eul, size);
+
+	benchmark_run("math_mul_m4_v3", data.vecs_len, math_mul_m4_v3_fn, &data);
+	benchmark_run("math_mul_m4_v3_array", data.vecs_len, math_mul_m4_v3_array_fn, &data);
+	benchmark_run("math_normalize_v3", data.vecs_len, math_normalize_v3_fn, &data);
+	benchmark_run("math_normalize_v3_array", data.vecs_len, math_normalize_v3_array_fn, &data);
+
+	MEM_freeN(data.vecs);
+}
+
+/** \} */
@@ -0,0 +1,236 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#define GHASH_INTERNAL_API
+
+extern "C" {
+#include "BLI_utildefines.h"
+#include "BLI_flathash.h"
+#include "BLI_rand.h"
+}
+
+#define TESTCASE_SIZE 10000
+
+/* Note: for pure-hash testing, nature of the keys and data have absolutely no importance! So here we just use mere
+ *       random integers stored in pointers. */
+
+static void init_keys(unsigned int keys[TESTCASE_SIZE], const int seed)
+{
+	RNG *rng = BLI_rng_new(seed);
+	unsigned int *k;
+	int i;
+
+	for (i = 0, k = keys; i < TESTCASE_SIZE; ) {
+		/* Risks of collision are low, but they do exist.
+		 * And we cannot use a FlatSet, since we test that here! */
+		int j;
+		unsigned int t = BLI_rng_get_uint(rng);
+		for (j = i; j--; ) {
+			if (keys[j] == t) {
+				break;
+			}
+		}
+		if (j >= 0) {
+			continue;
+		}
+		*k = t;
+		i++;
+		k++;
+	}
+	BLI_rng_free(rng);
+}
+
+/* All keys fall into a handful of groups, forcing long probe sequences. */
+static unsigned int flathash_tests_badhash_p(const void *p)
+{
+	return GET_UINT_FROM_POINTER(p) % 7;
+}
+
+/* Here we simply insert and then lookup all keys, ensuring we do get back the expected stored 'data'. */
+TEST(flathash, InsertLookup)
+{
+	FlatHash *fh = BLI_flathash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+	unsigned int keys[TESTCASE_SIZE], *k;
+	int i;
+
+	init_keys(keys, 0);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		BLI_flathash_insert(fh, SET_UINT_IN_POINTER(*k), SET_UINT_IN_POINTER(*k));
+	}
+
+	EXPECT_EQ(BLI_flathash_size(fh), TESTCASE_SIZE);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		void *v = BLI_flathash_lookup(fh, SET_UINT_IN_POINTER(*k));
+		EXPECT_EQ(GET_UINT_FROM_POINTER(v), *k);
+	}
+
+	BLI_flathash_free(fh, NULL, NULL);
+}
+
+/* Insert and then remove all keys, removed keys are not to be found anymore. */
+TEST(flathash, InsertRemove)
+{
+	FlatHash *fh = BLI_flathash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+	unsigned int keys[TESTCASE_SIZE], *k;
+	int i;
+
+	init_keys(keys, 10);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		BLI_flathash_insert(fh, SET_UINT_IN_POINTER(*k), SET_UINT_IN_POINTER(*k));
+	}
+
+	EXPECT_EQ(BLI_flathash_size(fh), TESTCASE_SIZE);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		EXPECT_TRUE(BLI_flathash_remove(fh, SET_UINT_IN_POINTER(*k), NULL, NULL));
+		EXPECT_FALSE(BLI_flathash_haskey(fh, SET_UINT_IN_POINTER(*k)));
+	}
+
+	EXPECT_EQ(BLI_flathash_size(fh), 0);
+	EXPECT_FALSE(BLI_flathash_remove(fh, SET_UINT_IN_POINTER(keys[0]), NULL, NULL));
+
+	BLI_flathash_free(fh, NULL, NULL);
+}
+
+/* Interleave insertions and removals with a bad hash, so tombstones are reused and purged. */
+TEST(flathash, InsertRemoveCollisions)
+{
+	FlatHash *fh = BLI_flathash_new(flathash_tests_badhash_p, BLI_ghashutil_intcmp, __func__);
+	unsigned int keys[TESTCASE_SIZE], *k;
+	int i;
+
+	init_keys(keys, 20);
+
+	for (i = 0, k = keys; i < TESTCASE_SIZE; i++, k++) {
+		BLI_flathash_insert(fh, SET_UINT_IN_POINTER(*k), SET_UINT_IN_POINTER(*k));
+		if (i % 3 == 2) {
+			EXPECT_TRUE(BLI_flathash_remove(fh, SET_UINT_IN_POINTER(keys[i - 1]), NULL, NULL));
+		}
+	}
+
+	EXPECT_EQ(BLI_flathash_size(fh), TESTCASE_SIZE - TESTCASE_SIZE / 3);
+
+	for (i = 0, k = keys; i < TESTCASE_SIZE; i++, k++) {
+		void **v_p = BLI_flathash_lookup_p(fh, SET_UINT_IN_POINTER(*k));
+		if (i % 3 == 1 && i + 1 < TESTCASE_SIZE) {
+			EXPECT_EQ(v_p, (void **)NULL);
+		}
+		else {
+			ASSERT_NE(v_p, (void **)NULL);
+			EXPECT_EQ(GET_UINT_FROM_POINTER(*v_p), *k);
+		}
+	}
+
+	BLI_flathash_free(fh, NULL, NULL);
+}
+
+/* Check reinsert and ensure. */
+TEST(flathash, ReinsertEnsure)
+{
+	FlatHash *fh = BLI_flathash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+	unsigned int keys[TESTCASE_SIZE], *k;
+	int i;
+
+	init_keys(keys, 30);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		void **v_p;
+		EXPECT_FALSE(BLI_flathash_ensure_p(fh, SET_UINT_IN_POINTER(*k), &v_p));
+		*v_p = SET_UINT_IN_POINTER(*k);
+	}
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		void **v_p;
+		EXPECT_TRUE(BLI_flathash_ensure_p(fh, SET_UINT_IN_POINTER(*k), &v_p));
+		EXPECT_EQ(GET_UINT_FROM_POINTER(*v_p), *k);
+	}
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		EXPECT_FALSE(BLI_flathash_reinsert(fh, SET_UINT_IN_POINTER(*k), SET_UINT_IN_POINTER(*k + 1), NULL, NULL));
+	}
+
+	EXPECT_EQ(BLI_flathash_size(fh), TESTCASE_SIZE);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		void *v = BLI_flathash_lookup(fh, SET_UINT_IN_POINTER(*k));
+		EXPECT_EQ(GET_UINT_FROM_POINTER(v), *k + 1);
+	}
+
+	BLI_flathash_free(fh, NULL, NULL);
+}
+
+/* Iteration visits every entry exactly once. */
+TEST(flathash, Iterate)
+{
+	FlatHash *fh = BLI_flathash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+	FlatHashIterator fh_iter;
+	unsigned int keys[TESTCASE_SIZE], *k;
+	unsigned int num_iter = 0;
+	int i;
+
+	init_keys(keys, 40);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		BLI_flathash_insert(fh, SET_UINT_IN_POINTER(*k), SET_INT_IN_POINTER(0));
+	}
+
+	FLATHASH_ITER (fh_iter, fh) {
+		void **v_p = BLI_flathashIterator_getValue_p(&fh_iter);
+		EXPECT_EQ(*v_p, SET_INT_IN_POINTER(0));
+		*v_p = SET_INT_IN_POINTER(1);
+		num_iter++;
+	}
+
+	EXPECT_EQ(num_iter, TESTCASE_SIZE);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		EXPECT_EQ(BLI_flathash_lookup(fh, SET_UINT_IN_POINTER(*k)), SET_INT_IN_POINTER(1));
+	}
+
+	BLI_flathash_clear(fh, NULL, NULL);
+	EXPECT_EQ(BLI_flathash_size(fh), 0);
+
+	BLI_flathashIterator_init(&fh_iter, fh);
+	EXPECT_TRUE(BLI_flathashIterator_done(&fh_iter));
+
+	BLI_flathash_free(fh, NULL, NULL);
+}
+
+/* Check set API. */
+TEST(flathash, Set)
+{
+	FlatSet *fs = BLI_flatset_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+	unsigned int keys[TESTCASE_SIZE], *k;
+	unsigned int num_iter = 0;
+	int i;
+
+	init_keys(keys, 50);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		EXPECT_TRUE(BLI_flatset_add(fs, SET_UINT_IN_POINTER(*k)));
+	}
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		EXPECT_FALSE(BLI_flatset_add(fs, SET_UINT_IN_POINTER(*k)));
+	}
+
+	EXPECT_EQ(BLI_flatset_size(fs), TESTCASE_SIZE);
+
+	FLATSET_FOREACH_BEGIN (void *, key, fs)
+	{
+		EXPECT_TRUE(BLI_flatset_haskey(fs, key));
+		num_iter++;
+	}
+	FLATSET_FOREACH_END();
+
+	EXPECT_EQ(num_iter, TESTCASE_SIZE);
+
+	for (i = TESTCASE_SIZE / 2, k = keys; i--; k++) {
+		EXPECT_TRUE(BLI_flatset_remove(fs, SET_UINT_IN_POINTER(*k), NULL));
+	}
+
+	EXPECT_EQ(BLI_flatset_size(fs), TESTCASE_SIZE - TESTCASE_SIZE / 2);
+
+	BLI_flatset_free(fs, NULL);
+}
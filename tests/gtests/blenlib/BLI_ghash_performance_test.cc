@@ -9,6 +9,7 @@ extern "C" {
 #include "MEM_guardedalloc.h"
 #include "BLI_utildefines.h"
 #include "BLI_ghash.h"
+#include "BLI_flathash.h"
 #include "BLI_rand.h"
 #include "BLI_string.h"
 #include "PIL_time_utildefines.h"
@@ -38,6 +39,17 @@ extern "C" {
 	       BLI_ghash_size(_gh), q, var, lf, pempty * 100.0, poverloaded * 100.0, bigb); \
 } void (0)
 
+#define PRINTF_FLATHASH_STATS(_fh) \
+{ \
+	double q, lf, ptomb; \
+	int longest; \
+	q = BLI_flathash_calc_quality_ex((_fh), &lf, &ptomb, &longest); \
+	printf("FlatHash stats (%u entries):\n\t" \
+	       "Average probed groups (the lower the better): %f\n\tLoad: %f\n\t" \
+	       "Tombstones: %.2f%%\n\tLongest probe: %d groups\n", \
+	       BLI_flathash_size(_fh), q, lf, ptomb * 100.0, longest); \
+} void (0)
+
 /* Str: whole text, lines and words from a 'corpus' text. */
 
 static void str_ghash_tests(GHash *ghash, const char *id)
@@ -163,6 +175,78 @@ TEST(ghash, TextMurmur2a)
 	str_ghash_tests(ghash, "StrGHash - Murmur");
 }
 
+/* Same as above for FlatHash, words only. */
+
+static void str_flathash_tests(FlatHash *fh, const char *id)
+{
+	printf("\n========== STARTING %s ==========\n", id);
+
+	char *data_w = BLI_strdup(words10k);
+	char *data_bis = BLI_strdup(words10k);
+
+	{
+		char *w, *c_w;
+
+		TIMEIT_START(string_insert);
+
+#ifdef GHASH_RESERVE
+		BLI_flathash_reserve(fh, strlen(data_w) / 32);  /* rough estimation... */
+#endif
+
+		for (w = c_w = data_w; *c_w; c_w++) {
+			if (ELEM(*c_w, ' ', '.')) {
+				*c_w = '\0';
+				if (!BLI_flathash_haskey(fh, w)) {
+					BLI_flathash_insert(fh, w, SET_INT_IN_POINTER(w[0]));
+				}
+				w = c_w + 1;
+			}
+		}
+
+		TIMEIT_END(string_insert);
+	}
+
+	PRINTF_FLATHASH_STATS(fh);
+
+	{
+		char *w, *c;
+		void *v;
+
+		TIMEIT_START(string_lookup);
+
+		for (w = c = data_bis; *c; c++) {
+			if (ELEM(*c, ' ', '.')) {
+				*c = '\0';
+				v = BLI_flathash_lookup(fh, w);
+				EXPECT_EQ(GET_INT_FROM_POINTER(v), w[0]);
+				w = c + 1;
+			}
+		}
+
+		TIMEIT_END(string_lookup);
+	}
+
+	BLI_flathash_free(fh, NULL, NULL);
+	MEM_freeN(data_w);
+	MEM_freeN(data_bis);
+
+	printf("========== ENDED %s ==========\n\n", id);
+}
+
+TEST(flathash, TextFlatHash)
+{
+	FlatHash *fh = BLI_flathash_new(BLI_ghashutil_strhash_p, BLI_ghashutil_strcmp, __func__);
+
+	str_flathash_tests(fh, "StrFlatHash - GHash");
+}
+
+TEST(flathash, TextMurmur2a)
+{
+	FlatHash *fh = BLI_flathash_new(BLI_ghashutil_strhash_p_murmur, BLI_ghashutil_strcmp, __func__);
+
+	str_flathash_tests(fh, "StrFlatHash - Murmur");
+}
+
 
 /* Int: uniform 100M first integers. */
 
@@ -253,6 +337,82 @@ TEST(ghash, IntMurmur2a100000000)
 }
 #endif
 
+static void int_flathash_tests(FlatHash *fh, const char *id, const unsigned int nbr)
+{
+	printf("\n========== STARTING %s ==========\n", id);
+
+	{
+		unsigned int i = nbr;
+
+		TIMEIT_START(int_insert);
+
+#ifdef GHASH_RESERVE
+		BLI_flathash_reserve(fh, nbr);
+#endif
+
+		while (i--) {
+			BLI_flathash_insert(fh, SET_UINT_IN_POINTER(i), SET_UINT_IN_POINTER(i));
+		}
+
+		TIMEIT_END(int_insert);
+	}
+
+	PRINTF_FLATHASH_STATS(fh);
+
+	{
+		unsigned int i = nbr;
+
+		TIMEIT_START(int_lookup);
+
+		while (i--) {
+			void *v = BLI_flathash_lookup(fh, SET_UINT_IN_POINTER(i));
+			EXPECT_EQ(GET_UINT_FROM_POINTER(v), i);
+		}
+
+		TIMEIT_END(int_lookup);
+	}
+
+	{
+		unsigned int i = nbr;
+
+		TIMEIT_START(int_remove);
+
+		while (i--) {
+			EXPECT_TRUE(BLI_flathash_remove(fh, SET_UINT_IN_POINTER(i), NULL, NULL));
+		}
+
+		TIMEIT_END(int_remove);
+	}
+	EXPECT_EQ(BLI_flathash_size(fh), 0);
+
+	BLI_flathash_free(fh, NULL, NULL);
+
+	printf("========== ENDED %s ==========\n\n", id);
+}
+
+TEST(flathash, IntFlatHash12000)
+{
+	FlatHash *fh = BLI_flathash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+
+	int_flathash_tests(fh, "IntFlatHash - GHash - 12000", 12000);
+}
+
+#ifdef GHASH_RUN_BIG
+TEST(flathash, IntFlatHash100000000)
+{
+	FlatHash *fh = BLI_flathash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+
+	int_flathash_tests(fh, "IntFlatHash - GHash - 100000000", 100000000);
+}
+#endif
+
+TEST(flathash, IntMurmur2a12000)
+{
+	FlatHash *fh = BLI_flathash_new(BLI_ghashutil_inthash_p_murmur, BLI_ghashutil_intcmp, __func__);
+
+	int_flathash_tests(fh, "IntFlatHash - Murmur - 12000", 12000);
+}
+
 /* Int: random 50M integers. */
 
 static void randint_ghash_tests(GHash *ghash, const char *id, const unsigned int nbr)
@@ -335,6 +495,79 @@ TEST(ghash, IntRandMurmur2a50000000)
 }
 #endif
 
+static void randint_flathash_tests(FlatHash *fh, const char *id, const unsigned int nbr)
+{
+	printf("\n========== STARTING %s ==========\n", id);
+
+	unsigned int *data = (unsigned int *)MEM_mallocN(sizeof(*data) * (size_t)nbr, __func__);
+	unsigned int *dt;
+	unsigned int i;
+
+	{
+		RNG *rng = BLI_rng_new(0);
+		for (i = nbr, dt = data; i--; dt++) {
+			*dt = BLI_rng_get_uint(rng);
+		}
+		BLI_rng_free(rng);
+	}
+
+	{
+		TIMEIT_START(int_insert);
+
+#ifdef GHASH_RESERVE
+		BLI_flathash_reserve(fh, nbr);
+#endif
+
+		/* Random data may contain duplicates. */
+		for (i = nbr, dt = data; i--; dt++) {
+			BLI_flathash_reinsert(fh, SET_UINT_IN_POINTER(*dt), SET_UINT_IN_POINTER(*dt), NULL, NULL);
+		}
+
+		TIMEIT_END(int_insert);
+	}
+
+	PRINTF_FLATHASH_STATS(fh);
+
+	{
+		TIMEIT_START(int_lookup);
+
+		for (i = nbr, dt = data; i--; dt++) {
+			void *v = BLI_flathash_lookup(fh, SET_UINT_IN_POINTER(*dt));
+			EXPECT_EQ(GET_UINT_FROM_POINTER(v), *dt);
+		}
+
+		TIMEIT_END(int_lookup);
+	}
+
+	BLI_flathash_free(fh, NULL, NULL);
+	MEM_freeN(data);
+
+	printf("========== ENDED %s ==========\n\n", id);
+}
+
+TEST(flathash, IntRandFlatHash12000)
+{
+	FlatHash *fh = BLI_flathash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+
+	randint_flathash_tests(fh, "RandIntFlatHash - GHash - 12000", 12000);
+}
+
+#ifdef GHASH_RUN_BIG
+TEST(flathash, IntRandFlatHash50000000)
+{
+	FlatHash *fh = BLI_flathash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+
+	randint_flathash_tests(fh, "RandIntFlatHash - GHash - 50000000", 50000000);
+}
+#endif
+
+TEST(flathash, IntRandMurmur2a12000)
+{
+	FlatHash *fh = BLI_flathash_new(BLI_ghashutil_inthash_p_murmur, BLI_ghashutil_intcmp, __func__);
+
+	randint_flathash_tests(fh, "RandIntFlatHash - Murmur - 12000", 12000);
+}
+
 static unsigned int ghashutil_tests_nohash_p(const void *p)
 {
 	return GET_UINT_FROM_POINTER(p);
@@ -361,6 +594,13 @@ TEST(ghash, Int4NoHash50000000)
 }
 #endif
 
+TEST(flathash, Int4NoHash12000)
+{
+	FlatHash *fh = BLI_flathash_new(ghashutil_tests_nohash_p, ghashutil_tests_cmp_p, __func__);
+
+	randint_flathash_tests(fh, "RandIntFlatHash - No Hash - 12000", 12000);
+}
+
 /* Int_v4: 20M of randomly-generated integer vectors. */
 
 static void int4_ghash_tests(GHash *ghash, const char *id, const unsigned int nbr)
@@ -534,3 +774,66 @@ TEST(ghash, MultiRandIntMurmur2a200000)
 
 	multi_small_ghash_tests(ghash, "MultiSmall RandIntGHash - Murmur2a - 200000", 200000);
 }
+
+static void multi_small_flathash_tests_one(FlatHash *fh, RNG *rng, const unsigned int nbr)
+{
+	unsigned int *data = (unsigned int *)MEM_mallocN(sizeof(*data) * (size_t)nbr, __func__);
+	unsigned int *dt;
+	unsigned int i;
+
+	for (i = nbr, dt = data; i--; dt++) {
+		*dt = BLI_rng_get_uint(rng);
+	}
+
+#ifdef GHASH_RESERVE
+	BLI_flathash_reserve(fh, nbr);
+#endif
+
+	for (i = nbr, dt = data; i--; dt++) {
+		BLI_flathash_reinsert(fh, SET_UINT_IN_POINTER(*dt), SET_UINT_IN_POINTER(*dt), NULL, NULL);
+	}
+
+	for (i = nbr, dt = data; i--; dt++) {
+		void *v = BLI_flathash_lookup(fh, SET_UINT_IN_POINTER(*dt));
+		EXPECT_EQ(GET_UINT_FROM_POINTER(v), *dt);
+	}
+
+	BLI_flathash_clear(fh, NULL, NULL);
+	MEM_freeN(data);
+}
+
+static void multi_small_flathash_tests(FlatHash *fh, const char *id, const unsigned int nbr)
+{
+	printf("\n========== STARTING %s ==========\n", id);
+
+	RNG *rng = BLI_rng_new(0);
+
+	TIMEIT_START(multi_small_flathash);
+
+	unsigned int i = nbr;
+	while (i--) {
+		const int nbr = 1 + (BLI_rng_get_int(rng) % TESTCASE_SIZE_SMALL) * (!(i % 100) ? 100 : (!(i % 10) ? 10 : 1));
+		multi_small_flathash_tests_one(fh, rng, nbr);
+	}
+
+	TIMEIT_END(multi_small_flathash);
+
+	BLI_flathash_free(fh, NULL, NULL);
+	BLI_rng_free(rng);
+
+	printf("========== ENDED %s ==========\n\n", id);
+}
+
+TEST(flathash, MultiRandIntFlatHash2000)
+{
+	FlatHash *fh = BLI_flathash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+
+	multi_small_flathash_tests(fh, "MultiSmall RandIntFlatHash - GHash - 2000", 2000);
+}
+
+TEST(flathash, MultiRandIntFlatHash200000)
+{
+	FlatHash *fh = BLI_flathash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+
+	multi_small_flathash_tests(fh, "MultiSmall RandIntFlatHash - GHash - 200000", 200000);
+}
@@ -93,3 +93,132 @@ static void find_nearest_points_test(int points_len, float scale, int round, int
 TEST(kdopbvh, FindNearest_1)		{ find_nearest_points_test(1, 1.0, 1000, 1234); }
 TEST(kdopbvh, FindNearest_2)		{ find_nearest_points_test(2, 1.0, 1000, 123); }
 TEST(kdopbvh, FindNearest_500)		{ find_nearest_points_test(500, 1.0, 1000, 12); }
+TEST(kdopbvh, FindNearest_20000)	{ find_nearest_points_test(20000, 1.0, 100000, 1); }
+
+/**
+ * Move all points and refit the tree, nearest lookups must keep finding the moved points.
+ */
+static void update_tree_points_test(int points_len, float scale, int round, int random_seed)
+{
+	struct RNG *rng = BLI_rng_new(random_seed);
+	BVHTree *tree = BLI_bvhtree_new(points_len, 0.0, 4, 8);
+
+	void *mem = MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+	float (*points)[3] = (float (*)[3])mem;
+
+	for (int i = 0; i < points_len; i++) {
+		rng_v3_round(points[i], 3, rng, round, scale);
+		BLI_bvhtree_insert(tree, i, points[i], 1);
+	}
+	BLI_bvhtree_balance(tree);
+
+	/* mirror the points, the tree structure stays the same but all the bounds change */
+	for (int i = 0; i < points_len; i++) {
+		negate_v3(points[i]);
+		BLI_bvhtree_update_node(tree, i, points[i], NULL, 1);
+	}
+	BLI_bvhtree_update_tree(tree);
+
+	for (int i = 0; i < points_len; i++) {
+		const int j = BLI_bvhtree_find_nearest(tree, points[i], NULL, NULL, NULL);
+		EXPECT_GE(j, 0);
+		EXPECT_LT(j, points_len);
+		EXPECT_EQ_ARRAY(points[i], points[j], 3);
+	}
+	BLI_bvhtree_free(tree);
+	BLI_rng_free(rng);
+	MEM_freeN(points);
+}
+
+TEST(kdopbvh, UpdateTree_500)		{ update_tree_points_test(500, 1.0, 1000, 12); }
+TEST(kdopbvh, UpdateTree_20000)		{ update_tree_points_test(20000, 1.0, 100000, 1); }
+
+/**
+ * Batched queries must give the same results as the single ones.
+ */
+static void find_nearest_array_test(int points_len, int queries_len, float scale, int round, int random_seed)
+{
+	struct RNG *rng = BLI_rng_new(random_seed);
+	BVHTree *tree = BLI_bvhtree_new(points_len, 0.0, 8, 8);
+
+	float (*points)[3] = (float (*)[3])MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+	float (*queries)[3] = (float (*)[3])MEM_mallocN(sizeof(float[3]) * queries_len, __func__);
+	BVHTreeNearest *nearest = (BVHTreeNearest *)MEM_mallocN(sizeof(*nearest) * queries_len, __func__);
+
+	for (int i = 0; i < points_len; i++) {
+		rng_v3_round(points[i], 3, rng, round, scale);
+		BLI_bvhtree_insert(tree, i, points[i], 1);
+	}
+	BLI_bvhtree_balance(tree);
+
+	for (int i = 0; i < queries_len; i++) {
+		rng_v3_round(queries[i], 3, rng, round, scale);
+		nearest[i].index = -1;
+		nearest[i].dist_sq = FLT_MAX;
+	}
+	BLI_bvhtree_find_nearest_array(tree, queries, queries_len, nearest, NULL, NULL);
+
+	for (int i = 0; i < queries_len; i++) {
+		BVHTreeNearest nearest_single;
+		nearest_single.index = -1;
+		nearest_single.dist_sq = FLT_MAX;
+		BLI_bvhtree_find_nearest(tree, queries[i], &nearest_single, NULL, NULL);
+		EXPECT_EQ(nearest_single.index, nearest[i].index);
+		EXPECT_EQ(nearest_single.dist_sq, nearest[i].dist_sq);
+	}
+	BLI_bvhtree_free(tree);
+	BLI_rng_free(rng);
+	MEM_freeN(points);
+	MEM_freeN(queries);
+	MEM_freeN(nearest);
+}
+
+TEST(kdopbvh, FindNearestArray_10)		{ find_nearest_array_test(500, 10, 1.0, 1000, 4); }
+TEST(kdopbvh, FindNearestArray_10000)	{ find_nearest_array_test(5000, 10000, 1.0, 1000, 5); }
+
+static void ray_cast_array_test(int points_len, int rays_len, float scale, int round, int random_seed)
+{
+	struct RNG *rng = BLI_rng_new(random_seed);
+	BVHTree *tree = BLI_bvhtree_new(points_len, 0.0, 8, 8);
+
+	float (*points)[3] = (float (*)[3])MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+	float (*co)[3] = (float (*)[3])MEM_mallocN(sizeof(float[3]) * rays_len, __func__);
+	float (*dir)[3] = (float (*)[3])MEM_mallocN(sizeof(float[3]) * rays_len, __func__);
+	BVHTreeRayHit *hit = (BVHTreeRayHit *)MEM_mallocN(sizeof(*hit) * rays_len, __func__);
+
+	for (int i = 0; i < points_len; i++) {
+		rng_v3_round(points[i], 3, rng, round, scale);
+		BLI_bvhtree_insert(tree, i, points[i], 1);
+	}
+	BLI_bvhtree_balance(tree);
+
+	for (int i = 0; i < rays_len; i++) {
+		rng_v3_round(co[i], 3, rng, round, scale);
+		/* aim at a point, so most rays hit something */
+		sub_v3_v3v3(dir[i], points[i % points_len], co[i]);
+		if (normalize_v3(dir[i]) == 0.0f) {
+			dir[i][2] = 1.0f;
+		}
+		hit[i].index = -1;
+		hit[i].dist = BVH_RAYCAST_DIST_MAX;
+	}
+	BLI_bvhtree_ray_cast_array(tree, co, dir, rays_len, 0.0f, hit, NULL, NULL);
+
+	for (int i = 0; i < rays_len; i++) {
+		BVHTreeRayHit hit_single;
+		hit_single.index = -1;
+		hit_single.dist = BVH_RAYCAST_DIST_MAX;
+		BLI_bvhtree_ray_cast(tree, co[i], dir[i], 0.0f, &hit_single, NULL, NULL);
+		EXPECT_EQ(hit_single.index, hit[i].index);
+		EXPECT_EQ(hit_single.dist, hit[i].dist);
+	}
+	BLI_bvhtree_free(tree);
+	BLI_rng_free(rng);
+	MEM_freeN(points);
+	MEM_freeN(co);
+	MEM_freeN(dir);
+	MEM_freeN(hit);
+}
+
+TEST(kdopbvh, RayCastArray_10)		{ ray_cast_array_test(500, 10, 1.0, 1000, 6); }
+TEST(kdopbvh, RayCastArray_10000)	{ ray_cast_array_test(5000, 10000, 1.0, 1000, 7); }
@@ -0,0 +1,162 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+extern "C" {
+#include "BLI_utildefines.h"
+#include "BLI_kdtree.h"
+#include "BLI_rand.h"
+#include "BLI_math_vector.h"
+#include "MEM_guardedalloc.h"
+}
+
+/* -------------------------------------------------------------------- */
+/* Helper Functions */
+
+static KDTree *kdtree_random_points(float (*points)[3], int points_len, struct RNG *rng)
+{
+	KDTree *tree = BLI_kdtree_new((unsigned int)points_len);
+
+	for (int i = 0; i < points_len; i++) {
+		points[i][0] = BLI_rng_get_float(rng);
+		points[i][1] = BLI_rng_get_float(rng);
+		points[i][2] = BLI_rng_get_float(rng);
+		BLI_kdtree_insert(tree, i, points[i]);
+	}
+	BLI_kdtree_balance(tree);
+	return tree;
+}
+
+static int find_nearest_brute_force(const float (*points)[3], int points_len, const float co[3])
+{
+	int nearest = -1;
+	float nearest_dist_sq = FLT_MAX;
+
+	for (int i = 0; i < points_len; i++) {
+		const float dist_sq = len_squared_v3v3(points[i], co);
+		if (dist_sq < nearest_dist_sq) {
+			nearest_dist_sq = dist_sq;
+			nearest = i;
+		}
+	}
+	return nearest;
+}
+
+/* -------------------------------------------------------------------- */
+/* Tests */
+
+TEST(kdtree, Empty)
+{
+	KDTree *tree = BLI_kdtree_new(0);
+	const float co[3] = {0.0f, 0.0f, 0.0f};
+	KDTreeNearest nearest;
+
+	BLI_kdtree_balance(tree);
+	EXPECT_EQ(-1, BLI_kdtree_find_nearest(tree, co, NULL));
+	BLI_kdtree_find_nearest_array(tree, &co, 1, &nearest);
+	EXPECT_EQ(-1, nearest.index);
+	BLI_kdtree_free(tree);
+}
+
+static void find_nearest_test(int points_len, int queries_len, int random_seed)
+{
+	struct RNG *rng = BLI_rng_new(random_seed);
+	float (*points)[3] = (float (*)[3])MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+	float (*queries)[3] = (float (*)[3])MEM_mallocN(sizeof(float[3]) * queries_len, __func__);
+	KDTreeNearest *nearest = (KDTreeNearest *)MEM_mallocN(sizeof(*nearest) * queries_len, __func__);
+	KDTree *tree = kdtree_random_points(points, points_len, rng);
+
+	for (int i = 0; i < queries_len; i++) {
+		queries[i][0] = BLI_rng_get_float(rng);
+		queries[i][1] = BLI_rng_get_float(rng);
+		queries[i][2] = BLI_rng_get_float(rng);
+	}
+	BLI_kdtree_find_nearest_array(tree, queries, queries_len, nearest);
+
+	for (int i = 0; i < queries_len; i++) {
+		const int index = find_nearest_brute_force(points, points_len, queries[i]);
+		EXPECT_EQ(index, BLI_kdtree_find_nearest(tree, queries[i], NULL));
+		EXPECT_EQ(index, nearest[i].index);
+	}
+
+	BLI_kdtree_free(tree);
+	BLI_rng_free(rng);
+	MEM_freeN(points);
+	MEM_freeN(queries);
+	MEM_freeN(nearest);
+}
+
+TEST(kdtree, FindNearest_1)			{ find_nearest_test(1, 10, 1); }
+TEST(kdtree, FindNearest_100)		{ find_nearest_test(100, 100, 2); }
+TEST(kdtree, FindNearest_50000)		{ find_nearest_test(50000, 2000, 3); }
+
+TEST(kdtree, FindNearestN)
+{
+	const int points_len = 20000, n = 8;
+	struct RNG *rng = BLI_rng_new(4);
+	float (*points)[3] = (float (*)[3])MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+	KDTreeNearest *nearest = (KDTreeNearest *)MEM_mallocN(sizeof(*nearest) * points_len * n, __func__);
+	int *found = (int *)MEM_mallocN(sizeof(*found) * points_len, __func__);
+	KDTree *tree = kdtree_random_points(points, points_len, rng);
+
+	BLI_kdtree_find_nearest_n_array(tree, points, points_len, nearest, found, n);
+
+	for (int i = 0; i < points_len; i += 97) {
+		KDTreeNearest nearest_single[n];
+		EXPECT_EQ(n, found[i]);
+		EXPECT_EQ(n, BLI_kdtree_find_nearest_n(tree, points[i], nearest_single, n));
+		/* each point is its own nearest */
+		EXPECT_EQ(i, nearest[i * n].index);
+		for (int j = 0; j < n; j++) {
+			EXPECT_EQ(nearest_single[j].index, nearest[i * n + j].index);
+		}
+	}
+
+	BLI_kdtree_free(tree);
+	BLI_rng_free(rng);
+	MEM_freeN(points);
+	MEM_freeN(nearest);
+	MEM_freeN(found);
+}
+
+typedef struct RangeSearchData {
+	const float (*points)[3];
+	int *count;
+} RangeSearchData;
+
+static bool range_search_count_cb(void *user_data, int co_index, int index, const float co[3], float dist_sq)
+{
+	RangeSearchData *data = (RangeSearchData *)user_data;
+	EXPECT_TRUE(equals_v3v3(data->points[index], co));
+	EXPECT_FLOAT_EQ(len_squared_v3v3(data->points[co_index], co), dist_sq);
+	data->count[co_index]++;
+	return true;
+}
+
+TEST(kdtree, RangeSearch)
+{
+	const int points_len = 20000;
+	const float range = 0.02f;
+	struct RNG *rng = BLI_rng_new(5);
+	float (*points)[3] = (float (*)[3])MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+	int *count = (int *)MEM_callocN(sizeof(*count) * points_len, __func__);
+	KDTree *tree = kdtree_random_points(points, points_len, rng);
+	RangeSearchData data = {points, count};
+
+	BLI_kdtree_range_search_array_cb(tree, points, points_len, range, range_search_count_cb, &data);
+
+	for (int i = 0; i < points_len; i += 97) {
+		KDTreeNearest *nearest;
+		const int found = BLI_kdtree_range_search(tree, points[i], &nearest, range);
+		EXPECT_GE(count[i], 1);
+		EXPECT_EQ(found, count[i]);
+		if (nearest) {
+			MEM_freeN(nearest);
+		}
+	}
+
+	BLI_kdtree_free(tree);
+	BLI_rng_free(rng);
+	MEM_freeN(points);
+	MEM_freeN(count);
+}
@@ -0,0 +1,92 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+extern "C" {
+#include "BLI_math.h"
+#include "BLI_rand.h"
+}
+
+/* Odd size, so the 4 wide code-path and the remainder are both used. */
+#define VEC_NUM 1003
+
+static void vec_array_random(float (*vec_arr)[3], const int vec_num, const unsigned int seed)
+{
+	RNG *rng = BLI_rng_new(seed);
+	for (int i = 0; i < vec_num; i++) {
+		for (int j = 0; j < 3; j++) {
+			vec_arr[i][j] = (BLI_rng_get_float(rng) - 0.5f) * 100.0f;
+		}
+	}
+	BLI_rng_free(rng);
+}
+
+#define EXPECT_V3_FLOAT_EQ(a, b) { \
+	EXPECT_FLOAT_EQ(a[0], b[0]); \
+	EXPECT_FLOAT_EQ(a[1], b[1]); \
+	EXPECT_FLOAT_EQ(a[2], b[2]); \
+} (void)0
+
+TEST(math_vector, NormalizeArray)
+{
+	static float vec_arr[VEC_NUM][3], vec_test[VEC_NUM][3];
+	vec_array_random(vec_arr, VEC_NUM, 1);
+	/* zero length vectors are zeroed, as with normalize_v3 */
+	zero_v3(vec_arr[5]);
+	copy_v3_fl(vec_arr[6], 1e-20f);
+	memcpy(vec_test, vec_arr, sizeof(vec_arr));
+
+	normalize_v3_array(vec_arr, VEC_NUM);
+	for (int i = 0; i < VEC_NUM; i++) {
+		normalize_v3(vec_test[i]);
+		EXPECT_V3_FLOAT_EQ(vec_arr[i], vec_test[i]);
+	}
+	EXPECT_TRUE(is_zero_v3(vec_arr[5]));
+	EXPECT_TRUE(is_zero_v3(vec_arr[6]));
+}
+
+TEST(math_vector, DotCrossArray)
+{
+	static float vec_a[VEC_NUM][3], vec_b[VEC_NUM][3], vec_cross[VEC_NUM][3];
+	static float vec_dot[VEC_NUM];
+	vec_array_random(vec_a, VEC_NUM, 2);
+	vec_array_random(vec_b, VEC_NUM, 3);
+
+	dot_v3v3_array(vec_dot, vec_a, vec_b, VEC_NUM);
+	cross_v3_v3v3_array(vec_cross, vec_a, vec_b, VEC_NUM);
+	for (int i = 0; i < VEC_NUM; i++) {
+		float cross[3];
+		cross_v3_v3v3(cross, vec_a[i], vec_b[i]);
+		EXPECT_FLOAT_EQ(vec_dot[i], dot_v3v3(vec_a[i], vec_b[i]));
+		EXPECT_V3_FLOAT_EQ(vec_cross[i], cross);
+	}
+}
+
+TEST(math_vector, MulMatrixArray)
+{
+	static float vec_arr[VEC_NUM][3], vec_r[VEC_NUM][3], vec_test[VEC_NUM][3];
+	float mat[4][4];
+	vec_array_random(vec_arr, VEC_NUM, 4);
+	loc_eul_size_to_mat4(mat, (const float[3]){1.0f, -2.0f, 3.0f}, (const float[3]){0.3f, 0.2f, 0.1f}, (const float[3]){2.0f, 1.0f, 0.5f});
+
+	mul_v3_m4v3_array(vec_r, mat, vec_arr, VEC_NUM);
+	for (int i = 0; i < VEC_NUM; i++) {
+		float r[3];
+		mul_v3_m4v3(r, mat, vec_arr[i]);
+		EXPECT_V3_FLOAT_EQ(vec_r[i], r);
+	}
+
+	memcpy(vec_test, vec_arr, sizeof(vec_arr));
+	mul_mat3_m4_v3_array(mat, vec_test, VEC_NUM);
+	for (int i = 0; i < VEC_NUM; i++) {
+		float r[3];
+		mul_v3_mat3_m4v3(r, mat, vec_arr[i]);
+		EXPECT_V3_FLOAT_EQ(vec_test[i], r);
+	}
+
+	/* in-place */
+	mul_m4_v3_array(mat, vec_arr, VEC_NUM);
+	for (int i = 0; i < VEC_NUM; i++) {
+		EXPECT_V3_FLOAT_EQ(vec_arr[i], vec_r[i]);
+	}
+}
@@ -0,0 +1,79 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#include "BLI_utildefines.h"
+#include "BLI_mempool.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
+};
+
+#define NUM_THREADS 4
+#define NUM_TASKS 64
+#define NUM_ELEMS 1000
+
+typedef struct TestElem {
+	int task;
+	int index;
+} TestElem;
+
+/* *** Thread caches: allocate, check and free from many tasks at once *** */
+
+static void task_mempool_run(TaskPool *__restrict pool, void *taskdata, int UNUSED(threadid))
+{
+	BLI_mempool *mempool = (BLI_mempool *)BLI_task_pool_userdata(pool);
+	const int task = GET_INT_FROM_POINTER(taskdata);
+	BLI_mempool_threadcache *cache = BLI_mempool_threadcache_create(mempool);
+	TestElem *elems[NUM_ELEMS];
+
+	for (int i = 0; i < NUM_ELEMS; i++) {
+		elems[i] = (TestElem *)BLI_mempool_threadcache_alloc(cache);
+		elems[i]->task = task;
+		elems[i]->index = i;
+	}
+	/* free every other element, then allocate them again */
+	for (int i = 0; i < NUM_ELEMS; i += 2) {
+		BLI_mempool_threadcache_free(cache, elems[i]);
+	}
+	for (int i = 0; i < NUM_ELEMS; i += 2) {
+		elems[i] = (TestElem *)BLI_mempool_threadcache_calloc(cache);
+		EXPECT_EQ(0, elems[i]->task);
+		elems[i]->task = task;
+		elems[i]->index = i;
+	}
+	for (int i = 0; i < NUM_ELEMS; i++) {
+		EXPECT_EQ(task, elems[i]->task);
+		EXPECT_EQ(i, elems[i]->index);
+		BLI_mempool_threadcache_free(cache, elems[i]);
+	}
+
+	BLI_mempool_threadcache_destroy(cache);
+}
+
+TEST(mempool, ThreadCache)
+{
+	BLI_threadapi_init();
+	TaskScheduler *scheduler = BLI_task_scheduler_create(NUM_THREADS);
+	BLI_mempool *mempool = BLI_mempool_create(sizeof(TestElem), 0, 64,
+	                                          BLI_MEMPOOL_ALLOW_ITER | BLI_MEMPOOL_ALLOW_THREADS);
+
+	TaskPool *pool = BLI_task_pool_create(scheduler, mempool);
+	for (int i = 0; i < NUM_TASKS; i++) {
+		BLI_task_pool_push(pool, task_mempool_run, SET_INT_IN_POINTER(i + 1), false, TASK_PRIORITY_LOW);
+	}
+	BLI_task_pool_work_and_wait(pool);
+	BLI_task_pool_free(pool);
+
+	EXPECT_EQ(0, BLI_mempool_count(mempool));
+
+	/* the pool is still usable directly once all caches are destroyed */
+	TestElem *elem = (TestElem *)BLI_mempool_alloc(mempool);
+	EXPECT_EQ(1, BLI_mempool_count(mempool));
+	BLI_mempool_free(mempool, elem);
+
+	BLI_mempool_destroy(mempool);
+	BLI_task_scheduler_free(scheduler);
+}
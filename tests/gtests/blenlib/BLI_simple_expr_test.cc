@@ -0,0 +1,82 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+extern "C" {
+#include "BLI_simple_expr.h"
+#include "BLI_math.h"
+};
+
+#define EXPECT_EVAL(expr, result) \
+	{ \
+		const char *names[] = {"x", "y"}; \
+		double params[] = {2.0, 3.0}; \
+		double value; \
+		SimpleExprParsed *parsed = BLI_simple_expr_parse(expr, 2, names); \
+		EXPECT_EQ(BLI_simple_expr_evaluate(parsed, params, 2, &value), SIMPLE_EXPR_SUCCESS); \
+		EXPECT_DOUBLE_EQ(value, result); \
+		BLI_simple_expr_free(parsed); \
+	} (void)0
+
+#define EXPECT_STATUS(expr, status) \
+	{ \
+		const char *names[] = {"x", "y"}; \
+		double params[] = {2.0, 3.0}; \
+		double value; \
+		SimpleExprParsed *parsed = BLI_simple_expr_parse(expr, 2, names); \
+		EXPECT_EQ(BLI_simple_expr_evaluate(parsed, params, 2, &value), status); \
+		BLI_simple_expr_free(parsed); \
+	} (void)0
+
+TEST(simple_expr, Arithmetic)
+{
+	EXPECT_EVAL("x * 2 + 0.5", 4.5);
+	EXPECT_EVAL("(x + y) * 2", 10.0);
+	EXPECT_EVAL("x - y - 1", -2.0);
+	EXPECT_EVAL("y / x", 1.5);
+	EXPECT_EVAL("-x ** 2", -4.0);
+	EXPECT_EVAL("x ** -1", 0.5);
+	EXPECT_EVAL("x ** y ** 2", 512.0);
+	EXPECT_EVAL("+x", 2.0);
+	EXPECT_EVAL("1.5e1 + .5", 15.5);
+}
+
+TEST(simple_expr, Logic)
+{
+	EXPECT_EVAL("x < y", 1.0);
+	EXPECT_EVAL("x >= y", 0.0);
+	EXPECT_EVAL("x == 2 and y != 2", 1.0);
+	EXPECT_EVAL("x or y", 2.0);
+	EXPECT_EVAL("0 or y", 3.0);
+	EXPECT_EVAL("x and 0", 0.0);
+	EXPECT_EVAL("not x", 0.0);
+	EXPECT_EVAL("True + True", 2.0);
+	EXPECT_EVAL("x if y > 2 else 7", 2.0);
+	EXPECT_EVAL("x if y < 2 else 7", 7.0);
+	EXPECT_EVAL("1 if 0 else 2 if 0 else 3", 3.0);
+}
+
+TEST(simple_expr, Functions)
+{
+	EXPECT_EVAL("sin(pi / 2)", 1.0);
+	EXPECT_EVAL("log(8, 2)", 3.0);
+	EXPECT_EVAL("abs(-x)", 2.0);
+	EXPECT_EVAL("min(x, y, 1)", 1.0);
+	EXPECT_EVAL("max(x, y)", 3.0);
+	EXPECT_EVAL("degrees(pi)", 180.0);
+}
+
+TEST(simple_expr, Errors)
+{
+	EXPECT_STATUS("x / 0", SIMPLE_EXPR_MATH_ERROR);
+	EXPECT_STATUS("sqrt(-1)", SIMPLE_EXPR_MATH_ERROR);
+	EXPECT_STATUS("", SIMPLE_EXPR_INVALID);
+	EXPECT_STATUS("z + 1", SIMPLE_EXPR_INVALID);
+	EXPECT_STATUS("x < y < 3", SIMPLE_EXPR_INVALID);
+	EXPECT_STATUS("x.real", SIMPLE_EXPR_INVALID);
+	EXPECT_STATUS("x % 2", SIMPLE_EXPR_INVALID);
+	EXPECT_STATUS("010", SIMPLE_EXPR_INVALID);
+	EXPECT_STATUS("1j", SIMPLE_EXPR_INVALID);
+	EXPECT_STATUS("min(x)", SIMPLE_EXPR_INVALID);
+	EXPECT_STATUS("(x + 1", SIMPLE_EXPR_INVALID);
+}
@@ -0,0 +1,235 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "atomic_ops.h"
+
+extern "C" {
+#include "DNA_listBase.h"
+#include "BLI_utildefines.h"
+#include "BLI_listbase.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
+};
+
+#define NUM_THREADS 4
+#define NUM_TASKS 64
+#define NUM_CHILD_TASKS 16
+
+/* *** Task pool, tasks spawned from worker threads *** */
+
+static void task_child_run(TaskPool *__restrict pool, void *UNUSED(taskdata), int UNUSED(threadid))
+{
+	unsigned int *counter = (unsigned int *)BLI_task_pool_userdata(pool);
+	atomic_add_and_fetch_u(counter, 1);
+}
+
+static void task_parent_run(TaskPool *__restrict pool, void *UNUSED(taskdata), int threadid)
+{
+	unsigned int *counter = (unsigned int *)BLI_task_pool_userdata(pool);
+	for (int i = 0; i < NUM_CHILD_TASKS; i++) {
+		BLI_task_pool_push_from_thread(pool, task_child_run, NULL, false, TASK_PRIORITY_LOW, threadid);
+	}
+	atomic_add_and_fetch_u(counter, 1);
+}
+
+TEST(task, PoolPushFromThread)
+{
+	BLI_threadapi_init();
+	TaskScheduler *scheduler = BLI_task_scheduler_create(NUM_THREADS);
+	unsigned int counter = 0;
+
+	TaskPool *pool = BLI_task_pool_create(scheduler, &counter);
+	for (int i = 0; i < NUM_TASKS; i++) {
+		BLI_task_pool_push(pool, task_parent_run, NULL, false, TASK_PRIORITY_LOW);
+	}
+	BLI_task_pool_work_and_wait(pool);
+	BLI_task_pool_free(pool);
+
+	EXPECT_EQ(NUM_TASKS * (NUM_CHILD_TASKS + 1), counter);
+
+	BLI_task_scheduler_free(scheduler);
+}
+
+/* *** Task pool created and waited from within a task *** */
+
+typedef struct NestedPoolData {
+	TaskScheduler *scheduler;
+	unsigned int counter;
+} NestedPoolData;
+
+static void task_nested_parent_run(TaskPool *__restrict pool, void *UNUSED(taskdata), int UNUSED(threadid))
+{
+	NestedPoolData *data = (NestedPoolData *)BLI_task_pool_userdata(pool);
+	unsigned int counter = 0;
+
+	TaskPool *nested_pool = BLI_task_pool_create(data->scheduler, &counter);
+	for (int i = 0; i < NUM_CHILD_TASKS; i++) {
+		BLI_task_pool_push(nested_pool, task_child_run, NULL, false, TASK_PRIORITY_LOW);
+	}
+	BLI_task_pool_work_and_wait(nested_pool);
+	BLI_task_pool_free(nested_pool);
+
+	atomic_add_and_fetch_u(&data->counter, counter);
+}
+
+TEST(task, PoolNested)
+{
+	BLI_threadapi_init();
+	NestedPoolData data;
+	data.scheduler = BLI_task_scheduler_create(NUM_THREADS);
+	data.counter = 0;
+
+	TaskPool *pool = BLI_task_pool_create(data.scheduler, &data);
+	for (int i = 0; i < NUM_TASKS; i++) {
+		BLI_task_pool_push(pool, task_nested_parent_run, NULL, false, TASK_PRIORITY_LOW);
+	}
+	BLI_task_pool_work_and_wait(pool);
+	BLI_task_pool_free(pool);
+
+	EXPECT_EQ(NUM_TASKS * NUM_CHILD_TASKS, data.counter);
+
+	BLI_task_scheduler_free(data.scheduler);
+}
+
+/* *** Parallel range called from within pool tasks *** */
+
+#define NESTED_RANGE_SIZE 10000
+
+static void task_range_iter_func(void *userdata, const int iter)
+{
+	int *data = (int *)userdata;
+	data[iter] += 1;
+}
+
+static void task_nested_range_run(TaskPool *__restrict UNUSED(pool), void *taskdata, int UNUSED(threadid))
+{
+	BLI_task_parallel_range(0, NESTED_RANGE_SIZE, taskdata, task_range_iter_func, true);
+}
+
+TEST(task, ParallelRangeNested)
+{
+	BLI_threadapi_init();
+	BLI_system_num_threads_override_set(NUM_THREADS);
+	TaskScheduler *scheduler = BLI_task_scheduler_get();
+	int *data[NUM_CHILD_TASKS];
+
+	TaskPool *pool = BLI_task_pool_create(scheduler, NULL);
+	for (int i = 0; i < NUM_CHILD_TASKS; i++) {
+		data[i] = (int *)MEM_callocN(sizeof(int) * NESTED_RANGE_SIZE, __func__);
+		BLI_task_pool_push(pool, task_nested_range_run, data[i], false, TASK_PRIORITY_LOW);
+	}
+	BLI_task_pool_work_and_wait(pool);
+	BLI_task_pool_free(pool);
+
+	for (int i = 0; i < NUM_CHILD_TASKS; i++) {
+		for (int j = 0; j < NESTED_RANGE_SIZE; j++) {
+			EXPECT_EQ(1, data[i][j]);
+		}
+		MEM_freeN(data[i]);
+	}
+
+	BLI_system_num_threads_override_set(0);
+}
+
+/* *** Adaptive (dynamic) scheduling of parallel range and listbase *** */
+
+#define RANGE_SIZE 100000
+
+static void task_range_sum_func(void *UNUSED(userdata), void *userdata_chunk, const int iter, const int UNUSED(thread_id))
+{
+	int64_t *chunk_sum = (int64_t *)userdata_chunk;
+	*chunk_sum += iter;
+}
+
+static void task_range_sum_finalize(void *userdata, void *userdata_chunk)
+{
+	int64_t *sum = (int64_t *)userdata;
+	*sum += *(int64_t *)userdata_chunk;
+}
+
+TEST(task, ParallelRangeDynamicFinalize)
+{
+	BLI_threadapi_init();
+	BLI_system_num_threads_override_set(NUM_THREADS);
+
+	for (int size = 1; size <= RANGE_SIZE; size *= 10) {
+		int64_t sum = 0, chunk_sum = 0;
+		BLI_task_parallel_range_finalize(0, size, &sum, &chunk_sum, sizeof(chunk_sum),
+		                                 task_range_sum_func, task_range_sum_finalize,
+		                                 true, true);
+		EXPECT_EQ((int64_t)size * (size - 1) / 2, sum);
+	}
+
+	BLI_system_num_threads_override_set(0);
+}
+
+static void task_listbase_func(void *UNUSED(userdata), Link *item, int index)
+{
+	LinkData *link = (LinkData *)item;
+	int *value = (int *)link->data;
+	*value += index;
+}
+
+TEST(task, ParallelListbase)
+{
+	BLI_threadapi_init();
+	BLI_system_num_threads_override_set(NUM_THREADS);
+
+	ListBase list = {NULL, NULL};
+	int *values = (int *)MEM_callocN(sizeof(int) * RANGE_SIZE, __func__);
+	for (int i = 0; i < RANGE_SIZE; i++) {
+		BLI_addtail(&list, BLI_genericNodeN(&values[i]));
+	}
+
+	BLI_task_parallel_listbase(&list, NULL, task_listbase_func, true);
+
+	for (int i = 0; i < RANGE_SIZE; i++) {
+		EXPECT_EQ(i, values[i]);
+	}
+
+	BLI_freelistN(&list);
+	MEM_freeN(values);
+	BLI_system_num_threads_override_set(0);
+}
+
+/* *** Parallel range reduction *** */
+
+#define HISTOGRAM_SIZE 1024
+
+static void task_range_histogram_func(void *UNUSED(userdata), void *userdata_chunk, const int iter, const int UNUSED(thread_id))
+{
+	int *histogram = (int *)userdata_chunk;
+	histogram[iter % HISTOGRAM_SIZE]++;
+}
+
+static void task_range_histogram_reduce(void *UNUSED(userdata), void *__restrict chunk_join, void *__restrict chunk)
+{
+	int *histogram_join = (int *)chunk_join;
+	const int *histogram = (const int *)chunk;
+	for (int i = 0; i < HISTOGRAM_SIZE; i++) {
+		histogram_join[i] += histogram[i];
+	}
+}
+
+TEST(task, ParallelRangeReduce)
+{
+	BLI_threadapi_init();
+	BLI_system_num_threads_override_set(NUM_THREADS);
+
+	for (int use_dynamic_scheduling = 0; use_dynamic_scheduling < 2; use_dynamic_scheduling++) {
+		for (int use_threading = 0; use_threading < 2; use_threading++) {
+			int histogram[HISTOGRAM_SIZE] = {0};
+			BLI_task_parallel_range_reduce(0, HISTOGRAM_SIZE * 100, NULL, histogram, sizeof(histogram),
+			                               task_range_histogram_func, task_range_histogram_reduce,
+			                               use_threading, use_dynamic_scheduling);
+			for (int i = 0; i < HISTOGRAM_SIZE; i++) {
+				EXPECT_EQ(100, histogram[i]);
+			}
+		}
+	}
+
+	BLI_system_num_threads_override_set(0);
+}
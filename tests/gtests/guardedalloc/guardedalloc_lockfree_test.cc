@@ -0,0 +1,96 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+extern "C" {
+#include "BLI_utildefines.h"
+}
+
+#include "MEM_guardedalloc.h"
+
+#ifndef WIN32
+#  include <pthread.h>
+#endif
+
+#define NUM_BLOCKS 10000
+#define NUM_THREADS 4
+
+namespace {
+
+/* Allocate blocks of all small sizes, check their contents stay intact and free them. */
+void DoAllocFreeChecks(const int seed)
+{
+	unsigned char **blocks = (unsigned char **)malloc(sizeof(*blocks) * NUM_BLOCKS);
+
+	for (int i = 0; i < NUM_BLOCKS; i++) {
+		const size_t len = (size_t)((i * 7 + seed) % 300);
+		blocks[i] = (unsigned char *)((i % 2) ? MEM_callocN(len, "test") : MEM_mallocN(len, "test"));
+		EXPECT_GE(MEM_allocN_len(blocks[i]), len);
+		EXPECT_EQ((size_t)blocks[i] % 8, 0);
+		memset(blocks[i], (unsigned char)(i + seed), MEM_allocN_len(blocks[i]));
+	}
+	/* free every other block and reuse them */
+	for (int i = 0; i < NUM_BLOCKS; i += 2) {
+		MEM_freeN(blocks[i]);
+		blocks[i] = (unsigned char *)MEM_callocN(16, "test");
+		EXPECT_EQ(blocks[i][0], 0);
+		EXPECT_EQ(blocks[i][15], 0);
+		memset(blocks[i], (unsigned char)(i + seed), MEM_allocN_len(blocks[i]));
+	}
+	for (int i = 0; i < NUM_BLOCKS; i++) {
+		const size_t len = MEM_allocN_len(blocks[i]);
+		for (size_t j = 0; j < len; j++) {
+			if (blocks[i][j] != (unsigned char)(i + seed)) {
+				ADD_FAILURE() << "block " << i << " overwritten";
+				break;
+			}
+		}
+		blocks[i] = (unsigned char *)MEM_reallocN(blocks[i], len + 100);
+		if (len != 0) {
+			EXPECT_EQ(blocks[i][0], (unsigned char)(i + seed));
+		}
+		MEM_freeN(blocks[i]);
+	}
+
+	free(blocks);
+}
+
+#ifndef WIN32
+void *alloc_free_thread(void *data)
+{
+	DoAllocFreeChecks(GET_INT_FROM_POINTER(data));
+	return NULL;
+}
+#endif
+
+}  // namespace
+
+TEST(guardedalloc, LockfreeSmallBlocks)
+{
+	const unsigned int blocks_in_use = MEM_get_memory_blocks_in_use();
+	const size_t memory_in_use = MEM_get_memory_in_use();
+
+	DoAllocFreeChecks(0);
+
+	EXPECT_EQ(blocks_in_use, MEM_get_memory_blocks_in_use());
+	EXPECT_EQ(memory_in_use, MEM_get_memory_in_use());
+}
+
+#ifndef WIN32
+TEST(guardedalloc, LockfreeSmallBlocksThreaded)
+{
+	const unsigned int blocks_in_use = MEM_get_memory_blocks_in_use();
+	const size_t memory_in_use = MEM_get_memory_in_use();
+	pthread_t threads[NUM_THREADS];
+
+	for (int i = 0; i < NUM_THREADS; i++) {
+		pthread_create(&threads[i], NULL, alloc_free_thread, SET_INT_IN_POINTER(i + 1));
+	}
+	for (int i = 0; i < NUM_THREADS; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	EXPECT_EQ(blocks_in_use, MEM_get_memory_blocks_in_use());
+	EXPECT_EQ(memory_in_use, MEM_get_memory_in_use());
+}
+#endif